@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Endian.h>
 #include <AK/Optional.h>
 #include <AK/Stream.h>
 
@@ -74,11 +75,14 @@ public:
             }
 
             if (m_next_byte.has_value()) {
-                auto const bit = (m_next_byte.value() >> m_bit_offset) & 1;
-                result |= bit << nread;
-                ++nread;
-
-                if (m_bit_offset++ == 7)
+                // Take as many bits as are needed, or as are left in the current byte, all at once.
+                auto const bits_to_take = min<size_t>(8 - m_bit_offset, count - nread);
+                auto const bits = (m_next_byte.value() >> m_bit_offset) & ((1u << bits_to_take) - 1);
+                result |= static_cast<u64>(bits) << nread;
+                nread += bits_to_take;
+
+                m_bit_offset += bits_to_take;
+                if (m_bit_offset == 8)
                     m_next_byte.clear();
             } else {
                 m_stream >> m_next_byte;
@@ -147,6 +151,8 @@ private:
     InputStream& m_stream;
 };
 
+// Bits are collected in a 64-bit buffer, and the bytes that fall out of it are handed to the underlying stream in
+// batches, so that writing a few bits costs neither a loop over every bit nor a (virtual) stream write.
 class OutputBitStream final : public OutputStream {
 public:
     explicit OutputBitStream(OutputStream& stream)
@@ -154,6 +160,12 @@ public:
     {
     }
 
+    ~OutputBitStream()
+    {
+        // Only complete bytes are written out here, a partial byte needs an explicit align_to_byte_boundary().
+        flush_whole_bytes();
+    }
+
     // WARNING: write aligns to the next byte boundary before writing, if unaligned writes are needed this should be rewritten
     size_t write(ReadonlyBytes bytes) override
     {
@@ -174,40 +186,23 @@ public:
         return true;
     }
 
-    void write_bits(u32 bits, size_t count)
+    ALWAYS_INLINE void write_bits(u32 bits, size_t count)
     {
         VERIFY(count <= 32);
 
-        if (count == 32 && !m_next_byte.has_value()) { // fast path for aligned 32 bit writes
-            m_stream << bits;
-            return;
-        }
-
-        size_t n_written = 0;
-        while (n_written < count) {
-            if (m_stream.has_any_error()) {
-                set_fatal_error();
-                return;
-            }
-
-            if (m_next_byte.has_value()) {
-                m_next_byte.value() |= ((bits >> n_written) & 1) << m_bit_offset;
-                ++n_written;
-
-                if (m_bit_offset++ == 7) {
-                    m_stream << m_next_byte.value();
-                    m_next_byte.clear();
-                }
-            } else if (count - n_written >= 16) { // fast path for aligned 16 bit writes
-                m_stream << (u16)((bits >> n_written) & 0xFFFF);
-                n_written += 16;
-            } else if (count - n_written >= 8) { // fast path for aligned 8 bit writes
-                m_stream << (u8)((bits >> n_written) & 0xFF);
-                n_written += 8;
-            } else {
-                m_bit_offset = 0;
-                m_next_byte = 0;
-            }
+        if (count < 32)
+            bits &= (1u << count) - 1;
+        m_bit_buffer |= static_cast<u64>(bits) << m_bit_count;
+        m_bit_count += count;
+
+        if (m_bit_count >= 32) {
+            LittleEndian<u32> word = static_cast<u32>(m_bit_buffer);
+            __builtin_memcpy(&m_byte_buffer[m_byte_count], &word, sizeof(word));
+            m_byte_count += sizeof(word);
+            m_bit_buffer >>= 32;
+            m_bit_count -= 32;
+            if (m_byte_count > sizeof(m_byte_buffer) - sizeof(word))
+                flush_byte_buffer();
         }
     }
 
@@ -218,22 +213,39 @@ public:
 
     void align_to_byte_boundary()
     {
-        if (m_next_byte.has_value()) {
-            if (!m_stream.write_or_error(ReadonlyBytes { &m_next_byte.value(), 1 })) {
-                set_fatal_error();
-            }
-            m_next_byte.clear();
-        }
+        if (m_bit_count % 8 != 0)
+            m_bit_count += 8 - m_bit_count % 8;
+        flush_whole_bytes();
     }
 
     [[nodiscard]] size_t bit_offset() const
     {
-        return m_bit_offset;
+        return m_bit_count % 8;
     }
 
 private:
-    Optional<u8> m_next_byte;
-    size_t m_bit_offset { 0 };
+    void flush_byte_buffer()
+    {
+        if (m_byte_count == 0)
+            return;
+        if (!m_stream.write_or_error({ m_byte_buffer, m_byte_count }))
+            set_fatal_error();
+        m_byte_count = 0;
+    }
+
+    void flush_whole_bytes()
+    {
+        for (; m_bit_count >= 8; m_bit_count -= 8) {
+            m_byte_buffer[m_byte_count++] = static_cast<u8>(m_bit_buffer);
+            m_bit_buffer >>= 8;
+        }
+        flush_byte_buffer();
+    }
+
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 }; // whenever this reaches 32, those bits are moved to the byte buffer
+    u8 m_byte_buffer[256];
+    size_t m_byte_count { 0 };
     OutputStream& m_stream;
 };
 
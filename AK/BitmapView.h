@@ -228,10 +228,11 @@ public:
             }
             if (bitmap[bucket_index] == 0x0) {
                 // Skip over completely empty bucket of size bit_size.
+                // NOTE: The first bucket may only be partially viewed if the search starts in the middle of it.
                 if (free_chunks == 0) {
-                    *start_of_free_chunks = bucket_index * bit_size;
+                    *start_of_free_chunks = bucket_index * bit_size + start_bucket_bit;
                 }
-                free_chunks += bit_size;
+                free_chunks += bit_size - start_bucket_bit;
                 if (free_chunks >= max_length) {
                     return max_length;
                 }
@@ -279,16 +280,21 @@ public:
         if (free_chunks < min_length) {
             size_t first_trailing_bit = (m_size / bit_size) * bit_size;
             size_t trailing_bits = size() % bit_size;
-            for (size_t i = 0; i < trailing_bits; ++i) {
+            size_t first_trailing_bit_to_view = from > first_trailing_bit ? from - first_trailing_bit : 0;
+            for (size_t i = first_trailing_bit_to_view; i < trailing_bits; ++i) {
                 if (!get(first_trailing_bit + i)) {
                     if (free_chunks == 0)
                         *start_of_free_chunks = first_trailing_bit + i;
-                    if (++free_chunks >= min_length)
-                        return min(free_chunks, max_length);
+                    if (++free_chunks >= max_length)
+                        return max_length;
                 } else {
+                    if (free_chunks >= min_length)
+                        return free_chunks;
                     free_chunks = 0;
                 }
             }
+            if (free_chunks >= min_length)
+                return free_chunks;
             return {};
         }
 
@@ -34,8 +34,9 @@ public:
     Buffered(Buffered&& other)
         : m_stream(move(other.m_stream))
     {
-        other.buffer().copy_to(buffer());
+        other.buffered_bytes().copy_to(buffer());
         m_buffered = exchange(other.m_buffered, 0);
+        other.m_offset = 0;
     }
 
     bool has_recoverable_error() const override { return m_stream.has_recoverable_error(); }
@@ -54,15 +55,16 @@ public:
         if (has_any_error())
             return 0;
 
-        auto nread = buffer().trim(m_buffered).copy_trimmed_to(bytes);
+        // NOTE: The buffered bytes are not moved to the front after every read, as that gets expensive for large buffers.
+        auto nread = buffered_bytes().copy_trimmed_to(bytes);
 
+        m_offset += nread;
         m_buffered -= nread;
-        if (m_buffered > 0)
-            buffer().slice(nread, m_buffered).copy_to(buffer());
 
         if (nread < bytes.size()) {
             nread += m_stream.read(bytes.slice(nread));
 
+            m_offset = 0;
             m_buffered = m_stream.read(buffer());
         }
 
@@ -86,6 +88,7 @@ public:
         if (m_buffered > 0)
             return false;
 
+        m_offset = 0;
         m_buffered = m_stream.read(buffer());
 
         return m_buffered == 0;
@@ -93,14 +96,20 @@ public:
 
     bool discard_or_error(size_t count) override
     {
-        size_t ndiscarded = 0;
-        while (ndiscarded < count) {
-            u8 dummy[Size];
-
-            if (!read_or_error({ dummy, min(Size, count - ndiscarded) }))
-                return false;
-
-            ndiscarded += min(Size, count - ndiscarded);
+        while (count > 0) {
+            if (m_buffered == 0) {
+                m_offset = 0;
+                m_buffered = m_stream.read(buffer());
+                if (m_buffered == 0) {
+                    set_fatal_error();
+                    return false;
+                }
+            }
+
+            auto ndiscarded = min(m_buffered, count);
+            m_offset += ndiscarded;
+            m_buffered -= ndiscarded;
+            count -= ndiscarded;
         }
 
         return true;
@@ -112,9 +121,11 @@ public:
 
 private:
     Bytes buffer() const { return { m_buffer, Size }; }
+    Bytes buffered_bytes() const { return { m_buffer + m_offset, m_buffered }; }
 
     mutable StreamType m_stream;
     mutable u8 m_buffer[Size];
+    mutable size_t m_offset { 0 };
     mutable size_t m_buffered { 0 };
 };
 
@@ -44,10 +44,13 @@ public:
         if (has_any_error())
             return 0;
 
-        auto const nread = min(bytes.size(), m_queue.size());
-
-        for (size_t idx = 0; idx < nread; ++idx)
-            bytes[idx] = m_queue.dequeue();
+        size_t nread = 0;
+        while (nread < bytes.size() && !eof()) {
+            auto const chunk = peek_contiguous_bytes().trim(bytes.size() - nread);
+            chunk.copy_to(bytes.slice(nread));
+            discard(chunk.size());
+            nread += chunk.size();
+        }
 
         return nread;
     }
@@ -87,12 +90,16 @@ public:
             return false;
         }
 
-        for (size_t idx = 0; idx < count; ++idx)
-            m_queue.dequeue();
-
+        discard(count);
         return true;
     }
 
+    // The oldest bytes in the stream that are stored back to back, to be consumed with discard_or_error() once done.
+    ReadonlyBytes peek_contiguous_bytes() const
+    {
+        return { m_queue.m_storage + m_queue.head_index(), min(m_queue.size(), Capacity - m_queue.head_index()) };
+    }
+
     bool unreliable_eof() const override { return eof(); }
     bool eof() const { return m_queue.size() == 0; }
 
@@ -114,6 +121,13 @@ public:
     }
 
 private:
+    void discard(size_t count)
+    {
+        // Bytes don't need to be destructed, so they can all be dropped at once.
+        m_queue.m_head = (m_queue.m_head + count) % Capacity;
+        m_queue.m_size -= count;
+    }
+
     CircularQueue<u8, Capacity> m_queue;
     size_t m_total_written { 0 };
 };
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Assertions.h>
+#include <AK/NumericLimits.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// A Bloom filter that supports removal, by keeping a small counter per bucket instead of a single bit.
+// Each hash picks two buckets from its lower 2 * KeyBits bits, so callers should pass well-mixed hashes.
+// Counters that overflow stick at their maximum value, which can only cause more false positives.
+template<size_t KeyBits = 12>
+class CountingBloomFilter {
+public:
+    static constexpr size_t bucket_count = 1 << KeyBits;
+
+    void add(u32 hash)
+    {
+        increment(m_buckets[first_bucket(hash)]);
+        increment(m_buckets[second_bucket(hash)]);
+    }
+
+    void remove(u32 hash)
+    {
+        decrement(m_buckets[first_bucket(hash)]);
+        decrement(m_buckets[second_bucket(hash)]);
+    }
+
+    // False positives are possible, false negatives are not.
+    bool may_contain(u32 hash) const
+    {
+        return m_buckets[first_bucket(hash)] && m_buckets[second_bucket(hash)];
+    }
+
+    void clear() { m_buckets.fill(0); }
+
+private:
+    static constexpr u32 key_mask = bucket_count - 1;
+
+    static size_t first_bucket(u32 hash) { return hash & key_mask; }
+    static size_t second_bucket(u32 hash) { return (hash >> KeyBits) & key_mask; }
+
+    static void increment(u8& bucket)
+    {
+        if (bucket != NumericLimits<u8>::max())
+            ++bucket;
+    }
+
+    static void decrement(u8& bucket)
+    {
+        VERIFY(bucket != 0);
+        // NOTE: A saturated bucket doesn't know how many hashes it holds anymore, so it has to stay that way.
+        if (bucket != NumericLimits<u8>::max())
+            --bucket;
+    }
+
+    Array<u8, bucket_count> m_buckets {};
+};
+
+}
+
+using AK::CountingBloomFilter;
@@ -59,6 +59,10 @@ FlyString::FlyString(StringView string)
 {
     if (string.is_null())
         return;
+    if (string.length() == 1) {
+        m_impl = StringImpl::the_single_byte_stringimpl(string[0]);
+        return;
+    }
     auto it = fly_impls().find(string.hash(), [&](auto& candidate) {
         return string == candidate;
     });
@@ -7,6 +7,7 @@
 #include <AK/CharacterTypes.h>
 #include <AK/Format.h>
 #include <AK/GenericLexer.h>
+#include <AK/IntegerToString.h>
 #include <AK/IntegralMath.h>
 #include <AK/StringBuilder.h>
 #include <AK/kstdio.h>
@@ -45,36 +46,6 @@ namespace {
 
 static constexpr size_t use_next_index = NumericLimits<size_t>::max();
 
-// The worst case is that we have the largest 64-bit value formatted as binary number, this would take
-// 65 bytes. Choosing a larger power of two won't hurt and is a bit of mitigation against out-of-bounds accesses.
-static constexpr size_t convert_unsigned_to_string(u64 value, Array<u8, 128>& buffer, u8 base, bool upper_case)
-{
-    VERIFY(base >= 2 && base <= 16);
-
-    constexpr char const* lowercase_lookup = "0123456789abcdef";
-    constexpr char const* uppercase_lookup = "0123456789ABCDEF";
-
-    if (value == 0) {
-        buffer[0] = '0';
-        return 1;
-    }
-
-    size_t used = 0;
-    while (value > 0) {
-        if (upper_case)
-            buffer[used++] = uppercase_lookup[value % base];
-        else
-            buffer[used++] = lowercase_lookup[value % base];
-
-        value /= base;
-    }
-
-    for (size_t i = 0; i < used / 2; ++i)
-        swap(buffer[i], buffer[used - i - 1]);
-
-    return used;
-}
-
 ErrorOr<void> vformat_impl(TypeErasedFormatParams& params, FormatBuilder& builder, FormatParser& parser)
 {
     auto const literal = parser.consume_literal();
@@ -250,9 +221,9 @@ ErrorOr<void> FormatBuilder::put_u64(
     if (align == Align::Default)
         align = Align::Right;
 
-    Array<u8, 128> buffer;
+    Array<u8, max_unsigned_digits> buffer;
 
-    auto const used_by_digits = convert_unsigned_to_string(value, buffer, base, upper_case);
+    auto const used_by_digits = convert_unsigned_to_string(value, buffer.data(), base, upper_case);
 
     size_t used_by_prefix = 0;
     if (align == Align::Right && zero_pad) {
@@ -303,9 +274,7 @@ ErrorOr<void> FormatBuilder::put_u64(
     };
 
     auto const put_digits = [&]() -> ErrorOr<void> {
-        for (size_t i = 0; i < used_by_digits; ++i)
-            TRY(m_builder.try_append(buffer[i]));
-        return {};
+        return m_builder.try_append(StringView { buffer.data(), used_by_digits });
     };
 
     if (align == Align::Left) {
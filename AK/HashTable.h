@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Concepts.h>
 #include <AK/Error.h>
 #include <AK/Forward.h>
@@ -15,6 +16,10 @@
 #include <AK/Types.h>
 #include <AK/kmalloc.h>
 
+#ifdef __SSE2__
+#    include <AK/SIMD.h>
+#endif
+
 namespace AK {
 
 enum class HashSetResult {
@@ -28,28 +33,59 @@ enum class HashSetExistingEntryBehavior {
     Replace
 };
 
-// Upper nibble determines state class:
-// - 0: unused bucket
-// - 1: used bucket
-// - F: end bucket
-// Lower nibble determines state within a class.
-enum class BucketState : u8 {
-    Free = 0x00,
-    Used = 0x10,
-    Deleted = 0x01,
-    Rehashed = 0x12,
-    End = 0xFF,
-};
+namespace Detail {
 
-// Note that because there's the end state, used and free are not 100% opposites!
-constexpr bool is_used_bucket(BucketState state)
+// Every bucket of a HashTable has a control byte, which is either empty_control_byte or seven bits of the hash of what
+// the bucket holds. Probing compares a whole group of control bytes at once, so most buckets that can't hold what's
+// being looked for are skipped without touching their contents.
+static constexpr u8 empty_control_byte = 0x80;
+static constexpr size_t control_group_size = 16;
+
+#ifndef __SSE2__
+// Without vector instructions, groups are checked eight control bytes at a time. This turns the top bit of each byte
+// of a word into one bit of the result.
+ALWAYS_INLINE u32 gather_top_bits(u64 word)
 {
-    return (static_cast<u8>(state) & 0xf0) == 0x10;
+    return ((word >> 7) * 0x0102040810204080ull) >> 56;
+}
+#endif
+
+// Bit i of the result is set if the control byte at control[i] is equal to value.
+ALWAYS_INLINE u32 match_control_group(u8 const* control, u8 value)
+{
+#ifdef __SSE2__
+    AK::SIMD::c8x16 group;
+    __builtin_memcpy(&group, control, sizeof(group));
+    return __builtin_ia32_pmovmskb128((AK::SIMD::c8x16)(group == static_cast<char>(value)));
+#else
+    auto match_word = [&](size_t offset) {
+        u64 word;
+        __builtin_memcpy(&word, control + offset, sizeof(word));
+        // Bytes equal to value become zero, and then only those keep their top bit.
+        word ^= 0x0101010101010101ull * value;
+        return gather_top_bits(~(((word & 0x7f7f7f7f7f7f7f7full) + 0x7f7f7f7f7f7f7f7full) | word | 0x7f7f7f7f7f7f7f7full));
+    };
+    return match_word(0) | (match_word(8) << 8);
+#endif
 }
 
-constexpr bool is_free_bucket(BucketState state)
+// Bit i of the result is set if the bucket belonging to control[i] is empty.
+ALWAYS_INLINE u32 match_empty_control_group(u8 const* control)
 {
-    return (static_cast<u8>(state) & 0xf0) == 0x00;
+#ifdef __SSE2__
+    // Only the empty control byte has its top bit set.
+    AK::SIMD::c8x16 group;
+    __builtin_memcpy(&group, control, sizeof(group));
+    return __builtin_ia32_pmovmskb128(group);
+#else
+    u64 low;
+    u64 high;
+    __builtin_memcpy(&low, control, sizeof(low));
+    __builtin_memcpy(&high, control + sizeof(low), sizeof(high));
+    return gather_top_bits(low & 0x8080808080808080ull) | (gather_top_bits(high & 0x8080808080808080ull) << 8);
+#endif
+}
+
 }
 
 template<typename HashTableType, typename T, typename BucketType>
@@ -70,19 +106,24 @@ private:
             return;
         do {
             ++m_bucket;
-            if (m_bucket->state == BucketState::Used)
+            ++m_control;
+            if (m_control == m_control_end) {
+                m_bucket = nullptr;
                 return;
-        } while (m_bucket->state != BucketState::End);
-        if (m_bucket->state == BucketState::End)
-            m_bucket = nullptr;
+            }
+        } while (*m_control == Detail::empty_control_byte);
     }
 
-    explicit HashTableIterator(BucketType* bucket)
+    explicit HashTableIterator(BucketType* bucket, u8 const* control = nullptr, u8 const* control_end = nullptr)
         : m_bucket(bucket)
+        , m_control(control)
+        , m_control_end(control_end)
     {
     }
 
     BucketType* m_bucket { nullptr };
+    u8 const* m_control { nullptr };
+    u8 const* m_control_end { nullptr };
 };
 
 template<typename OrderedHashTableType, typename T, typename BucketType>
@@ -108,10 +149,12 @@ private:
 
 template<typename T, typename TraitsForT, bool IsOrdered>
 class HashTable {
-    static constexpr size_t load_factor_in_percent = 60;
+    // Note: Entries are kept in the first empty bucket at or after their home bucket, which stays fast up to a fairly
+    //       high load as long as probing checks a whole group of buckets at a time.
+    static constexpr size_t load_factor_in_percent = 80;
+    static constexpr size_t minimum_capacity = 8;
 
     struct Bucket {
-        BucketState state;
         alignas(T) u8 storage[sizeof(T)];
 
         T* slot() { return reinterpret_cast<T*>(storage); }
@@ -121,7 +164,6 @@ class HashTable {
     struct OrderedBucket {
         OrderedBucket* previous;
         OrderedBucket* next;
-        BucketState state;
         alignas(T) u8 storage[sizeof(T)];
         T* slot() { return reinterpret_cast<T*>(storage); }
         const T* slot() const { return reinterpret_cast<const T*>(storage); }
@@ -148,9 +190,11 @@ public:
         if (!m_buckets)
             return;
 
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                m_buckets[i].slot()->~T();
+        if constexpr (!Detail::IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (is_used_bucket(i))
+                    m_buckets[i].slot()->~T();
+            }
         }
 
         kfree_sized(m_buckets, size_in_bytes(m_capacity));
@@ -175,11 +219,9 @@ public:
         , m_collection_data(other.m_collection_data)
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
-        , m_deleted_count(other.m_deleted_count)
     {
         other.m_size = 0;
         other.m_capacity = 0;
-        other.m_deleted_count = 0;
         other.m_buckets = nullptr;
         if constexpr (IsOrdered)
             other.m_collection_data = { nullptr, nullptr };
@@ -197,7 +239,6 @@ public:
         swap(a.m_buckets, b.m_buckets);
         swap(a.m_size, b.m_size);
         swap(a.m_capacity, b.m_capacity);
-        swap(a.m_deleted_count, b.m_deleted_count);
 
         if constexpr (IsOrdered)
             swap(a.m_collection_data, b.m_collection_data);
@@ -223,13 +264,13 @@ public:
     void ensure_capacity(size_t capacity)
     {
         VERIFY(capacity >= size());
-        rehash(capacity * 2);
+        rehash(capacity_for_size(capacity));
     }
 
     ErrorOr<void> try_ensure_capacity(size_t capacity)
     {
         VERIFY(capacity >= size());
-        return try_rehash(capacity * 2);
+        return try_rehash(capacity_for_size(capacity));
     }
 
     [[nodiscard]] bool contains(T const& value) const
@@ -253,8 +294,8 @@ public:
             return Iterator(m_collection_data.head);
 
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                return Iterator(&m_buckets[i]);
+            if (is_used_bucket(i))
+                return iterator_at<Iterator>(&m_buckets[i]);
         }
         return end();
     }
@@ -274,8 +315,8 @@ public:
             return ConstIterator(m_collection_data.head);
 
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (is_used_bucket(m_buckets[i].state))
-                return ConstIterator(&m_buckets[i]);
+            if (is_used_bucket(i))
+                return iterator_at<ConstIterator>(&m_buckets[i]);
         }
         return end();
     }
@@ -294,24 +335,25 @@ public:
         if (m_capacity == 0)
             return;
         if constexpr (!Detail::IsTriviallyDestructible<T>) {
-            for (auto* bucket : *this)
-                bucket->~T();
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (is_used_bucket(i))
+                    m_buckets[i].slot()->~T();
+            }
         }
-        __builtin_memset(m_buckets, 0, size_in_bytes(capacity()));
+        __builtin_memset(control_bytes(), Detail::empty_control_byte, control_byte_count(m_capacity));
         m_size = 0;
-        m_deleted_count = 0;
 
         if constexpr (IsOrdered)
             m_collection_data = { nullptr, nullptr };
-        else
-            m_buckets[m_capacity].state = BucketState::End;
     }
 
     template<typename U = T>
     ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
     {
-        auto* bucket = TRY(try_lookup_for_writing(value));
-        if (is_used_bucket(bucket->state)) {
+        auto hash = TraitsForT::hash(value);
+        auto* bucket = TRY(try_lookup_for_writing(value, hash));
+        auto index = bucket - m_buckets;
+        if (is_used_bucket(index)) {
             if (existing_entry_behavior == HashSetExistingEntryBehavior::Keep)
                 return HashSetResult::KeptExistingEntry;
             (*bucket->slot()) = forward<U>(value);
@@ -319,19 +361,9 @@ public:
         }
 
         new (bucket->slot()) T(forward<U>(value));
-        if (bucket->state == BucketState::Deleted)
-            --m_deleted_count;
-        bucket->state = BucketState::Used;
-
-        if constexpr (IsOrdered) {
-            if (!m_collection_data.head) [[unlikely]] {
-                m_collection_data.head = bucket;
-            } else {
-                bucket->previous = m_collection_data.tail;
-                m_collection_data.tail->next = bucket;
-            }
-            m_collection_data.tail = bucket;
-        }
+        set_control_byte(index, hash_bits(hash));
+        if constexpr (IsOrdered)
+            append_to_order(*bucket);
 
         ++m_size;
         return HashSetResult::InsertedNewEntry;
@@ -345,7 +377,7 @@ public:
     template<typename TUnaryPredicate>
     [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
     {
-        return Iterator(lookup_with_hash(hash, move(predicate)));
+        return iterator_at<Iterator>(lookup_with_hash(hash, move(predicate)));
     }
 
     [[nodiscard]] Iterator find(T const& value)
@@ -356,7 +388,7 @@ public:
     template<typename TUnaryPredicate>
     [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
     {
-        return ConstIterator(lookup_with_hash(hash, move(predicate)));
+        return iterator_at<ConstIterator>(lookup_with_hash(hash, move(predicate)));
     }
 
     [[nodiscard]] ConstIterator find(T const& value) const
@@ -410,92 +442,144 @@ public:
         return false;
     }
 
+    // Note: Removing an entry can move others into its place, so this invalidates all iterators.
     void remove(Iterator iterator)
     {
         VERIFY(iterator.m_bucket);
-        auto& bucket = *iterator.m_bucket;
-        VERIFY(is_used_bucket(bucket.state));
-
-        delete_bucket(bucket);
-        --m_size;
-        ++m_deleted_count;
+        auto index = iterator.m_bucket - m_buckets;
+        VERIFY(is_used_bucket(index));
 
-        rehash_in_place_if_needed();
+        delete_bucket(index);
     }
 
     template<typename TUnaryPredicate>
     bool remove_all_matching(TUnaryPredicate const& predicate)
     {
+        if (is_empty())
+            return false;
+
+        // Going through the buckets starting after an empty one means that entries only ever move back into the
+        // bucket that was just looked at, which is why that bucket is looked at again after removing something.
+        size_t start = 0;
+        while (is_used_bucket(start))
+            ++start;
+
         size_t removed_count = 0;
-        for (size_t i = 0; i < m_capacity; ++i) {
-            auto& bucket = m_buckets[i];
-            if (is_used_bucket(bucket.state) && predicate(*bucket.slot())) {
-                delete_bucket(bucket);
+        for (size_t offset = 1; offset <= m_capacity;) {
+            auto index = (start + offset) & (m_capacity - 1);
+            if (is_used_bucket(index) && predicate(*m_buckets[index].slot())) {
+                delete_bucket(index);
                 ++removed_count;
+                continue;
             }
+            ++offset;
         }
-        if (removed_count) {
-            m_deleted_count += removed_count;
-            m_size -= removed_count;
-        }
-        rehash_in_place_if_needed();
         return removed_count;
     }
 
 private:
     void insert_during_rehash(T&& value)
     {
-        auto& bucket = lookup_for_writing(value);
-        new (bucket.slot()) T(move(value));
-        bucket.state = BucketState::Used;
-
-        if constexpr (IsOrdered) {
-            if (!m_collection_data.head) [[unlikely]] {
-                m_collection_data.head = &bucket;
-            } else {
-                bucket.previous = m_collection_data.tail;
-                m_collection_data.tail->next = &bucket;
+        auto hash = TraitsForT::hash(value);
+        auto index = home_index(hash);
+        for (;;) {
+            if (auto empty = Detail::match_empty_control_group(control_bytes() + index)) {
+                index = (index + count_trailing_zeroes(empty)) & (m_capacity - 1);
+                break;
             }
-            m_collection_data.tail = &bucket;
+            index = (index + Detail::control_group_size) & (m_capacity - 1);
         }
+
+        auto& bucket = m_buckets[index];
+        new (bucket.slot()) T(move(value));
+        set_control_byte(index, hash_bits(hash));
+        if constexpr (IsOrdered)
+            append_to_order(bucket);
+    }
+
+    [[nodiscard]] static constexpr size_t control_byte_count(size_t capacity)
+    {
+        // The control bytes of the first buckets are repeated after the last one, so that a group starting at any
+        // bucket can be read in one go.
+        return capacity + Detail::control_group_size - 1;
     }
 
     [[nodiscard]] static constexpr size_t size_in_bytes(size_t capacity)
+    {
+        return sizeof(BucketType) * capacity + control_byte_count(capacity);
+    }
+
+    [[nodiscard]] static constexpr size_t capacity_for_size(size_t size)
+    {
+        size_t capacity = minimum_capacity;
+        while (size * 100 >= capacity * load_factor_in_percent)
+            capacity *= 2;
+        return capacity;
+    }
+
+    [[nodiscard]] u8* control_bytes() const { return reinterpret_cast<u8*>(m_buckets + m_capacity); }
+    [[nodiscard]] bool is_used_bucket(size_t index) const { return control_bytes()[index] != Detail::empty_control_byte; }
+
+    // The hash is spread over all 64 bits first, so the top ones to pick the home bucket with are worth using even
+    // when only the lowest bits of the hash vary. The control byte is made of the bits right below those.
+    [[nodiscard]] static constexpr u64 spread_hash(unsigned hash) { return static_cast<u64>(hash) * 0x9E3779B97F4A7C15ull; }
+    [[nodiscard]] size_t capacity_bits() const { return count_trailing_zeroes(m_capacity); }
+    [[nodiscard]] size_t home_index(unsigned hash) const { return spread_hash(hash) >> (64 - capacity_bits()); }
+    [[nodiscard]] u8 hash_bits(unsigned hash) const { return (spread_hash(hash) >> (57 - capacity_bits())) & 0x7f; }
+
+    void set_control_byte(size_t index, u8 value)
+    {
+        auto* control = control_bytes();
+        for (auto i = index; i < control_byte_count(m_capacity); i += m_capacity)
+            control[i] = value;
+    }
+
+    template<typename IteratorType>
+    [[nodiscard]] IteratorType iterator_at(BucketType* bucket) const
     {
         if constexpr (IsOrdered) {
-            return sizeof(BucketType) * capacity;
+            return IteratorType(bucket);
         } else {
-            return sizeof(BucketType) * (capacity + 1);
+            if (!bucket)
+                return IteratorType(nullptr);
+            return IteratorType(bucket, control_bytes() + (bucket - m_buckets), control_bytes() + m_capacity);
         }
     }
 
+    void append_to_order(BucketType& bucket)
+    {
+        bucket.previous = m_collection_data.tail;
+        bucket.next = nullptr;
+        if (!m_collection_data.head) [[unlikely]]
+            m_collection_data.head = &bucket;
+        else
+            m_collection_data.tail->next = &bucket;
+        m_collection_data.tail = &bucket;
+    }
+
     ErrorOr<void> try_rehash(size_t new_capacity)
     {
-        if (new_capacity == m_capacity && new_capacity >= 4) {
-            rehash_in_place();
+        new_capacity = max(new_capacity, minimum_capacity);
+        if (!is_power_of_two(new_capacity))
+            new_capacity = static_cast<size_t>(1) << (sizeof(size_t) * 8 - count_leading_zeroes(new_capacity));
+        if (new_capacity == m_capacity)
             return {};
-        }
-
-        new_capacity = max(new_capacity, static_cast<size_t>(4));
-        new_capacity = kmalloc_good_size(new_capacity * sizeof(BucketType)) / sizeof(BucketType);
+        VERIFY(m_size * 100 < new_capacity * load_factor_in_percent);
 
         auto* old_buckets = m_buckets;
         auto old_capacity = m_capacity;
         Iterator old_iter = begin();
 
-        auto* new_buckets = kcalloc(1, size_in_bytes(new_capacity));
+        auto* new_buckets = kmalloc(size_in_bytes(new_capacity));
         if (!new_buckets)
             return Error::from_errno(ENOMEM);
 
         m_buckets = (BucketType*)new_buckets;
-
         m_capacity = new_capacity;
-        m_deleted_count = 0;
+        __builtin_memset(control_bytes(), Detail::empty_control_byte, control_byte_count(m_capacity));
 
         if constexpr (IsOrdered)
             m_collection_data = { nullptr, nullptr };
-        else
-            m_buckets[m_capacity].state = BucketState::End;
 
         if (!old_buckets)
             return {};
@@ -513,193 +597,84 @@ private:
         MUST(try_rehash(new_capacity));
     }
 
-    void rehash_in_place()
-    {
-        // FIXME: This implementation takes two loops over the entire bucket array, but avoids re-allocation.
-        //        Please benchmark your new implementation before you replace this.
-        //        The reason is that because of collisions, we use the special "rehashed" bucket state to mark already-rehashed used buckets.
-        //        Because we of course want to write into old used buckets, but already rehashed data shall not be touched.
-
-        // FIXME: Find a way to reduce the cognitive complexity of this function.
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            auto& bucket = m_buckets[i];
-
-            // FIXME: Bail out when we have handled every filled bucket.
-
-            if (bucket.state == BucketState::Rehashed || bucket.state == BucketState::End || bucket.state == BucketState::Free)
-                continue;
-            if (bucket.state == BucketState::Deleted) {
-                bucket.state = BucketState::Free;
-                continue;
-            }
-
-            auto const new_hash = TraitsForT::hash(*bucket.slot());
-            if (new_hash % m_capacity == i) {
-                bucket.state = BucketState::Rehashed;
-                continue;
-            }
-
-            auto target_hash = new_hash;
-            auto const to_move_hash = i;
-            BucketType* target_bucket = &m_buckets[target_hash % m_capacity];
-            BucketType* bucket_to_move = &m_buckets[i];
-
-            // Try to move the bucket to move into its correct spot.
-            // During the procedure, we might re-hash or actually change the bucket to move.
-            while (!is_free_bucket(bucket_to_move->state)) {
-
-                // If we're targeting ourselves, there's nothing to do.
-                if (to_move_hash == target_hash % m_capacity) {
-                    bucket_to_move->state = BucketState::Rehashed;
-                    break;
-                }
-
-                if (is_free_bucket(target_bucket->state)) {
-                    // We can just overwrite the target bucket and bail out.
-                    new (target_bucket->slot()) T(move(*bucket_to_move->slot()));
-                    target_bucket->state = BucketState::Rehashed;
-                    bucket_to_move->state = BucketState::Free;
-
-                    if constexpr (IsOrdered) {
-                        swap(bucket_to_move->previous, target_bucket->previous);
-                        swap(bucket_to_move->next, target_bucket->next);
-
-                        if (target_bucket->previous)
-                            target_bucket->previous->next = target_bucket;
-                        else
-                            m_collection_data.head = target_bucket;
-                        if (target_bucket->next)
-                            target_bucket->next->previous = target_bucket;
-                        else
-                            m_collection_data.tail = target_bucket;
-                    }
-                } else if (target_bucket->state == BucketState::Rehashed) {
-                    // If the target bucket is already re-hashed, we do normal probing.
-                    target_hash = double_hash(target_hash);
-                    target_bucket = &m_buckets[target_hash % m_capacity];
-                } else {
-                    VERIFY(target_bucket->state != BucketState::End);
-                    // The target bucket is a used bucket that hasn't been re-hashed.
-                    // Swap the data into the target; now the target's data resides in the bucket to move again.
-                    // (That's of course what we want, how neat!)
-                    swap(*bucket_to_move->slot(), *target_bucket->slot());
-                    bucket_to_move->state = target_bucket->state;
-                    target_bucket->state = BucketState::Rehashed;
-
-                    if constexpr (IsOrdered) {
-                        // Update state for the target bucket, we'll do the bucket to move later.
-                        swap(bucket_to_move->previous, target_bucket->previous);
-                        swap(bucket_to_move->next, target_bucket->next);
-
-                        if (target_bucket->previous)
-                            target_bucket->previous->next = target_bucket;
-                        else
-                            m_collection_data.head = target_bucket;
-                        if (target_bucket->next)
-                            target_bucket->next->previous = target_bucket;
-                        else
-                            m_collection_data.tail = target_bucket;
-                    }
-
-                    target_hash = TraitsForT::hash(*bucket_to_move->slot());
-                    target_bucket = &m_buckets[target_hash % m_capacity];
-
-                    // The data is already in the correct location: Adjust the pointers
-                    if (target_hash % m_capacity == to_move_hash) {
-                        bucket_to_move->state = BucketState::Rehashed;
-                        if constexpr (IsOrdered) {
-                            // Update state for the bucket to move as it's not actually moved anymore.
-                            if (bucket_to_move->previous)
-                                bucket_to_move->previous->next = bucket_to_move;
-                            else
-                                m_collection_data.head = bucket_to_move;
-                            if (bucket_to_move->next)
-                                bucket_to_move->next->previous = bucket_to_move;
-                            else
-                                m_collection_data.tail = bucket_to_move;
-                        }
-                        break;
-                    }
-                }
-            }
-            // After this, the bucket_to_move either contains data that rehashes to itself, or it contains nothing as we were able to move the last thing.
-            if (bucket_to_move->state == BucketState::Deleted)
-                bucket_to_move->state = BucketState::Free;
-        }
-
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].state == BucketState::Rehashed)
-                m_buckets[i].state = BucketState::Used;
-        }
-
-        m_deleted_count = 0;
-    }
-
-    void rehash_in_place_if_needed()
-    {
-        // This signals a "thrashed" hash table with many deleted slots.
-        if (m_deleted_count >= m_size && should_grow())
-            rehash_in_place();
-    }
-
     template<typename TUnaryPredicate>
     [[nodiscard]] BucketType* lookup_with_hash(unsigned hash, TUnaryPredicate predicate) const
     {
         if (is_empty())
             return nullptr;
 
+        auto index = home_index(hash);
+        auto bits = hash_bits(hash);
         for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (is_used_bucket(bucket.state) && predicate(*bucket.slot()))
-                return &bucket;
+            auto const* control = control_bytes() + index;
+            for (auto matches = Detail::match_control_group(control, bits); matches; matches &= matches - 1) {
+                auto& bucket = m_buckets[(index + count_trailing_zeroes(matches)) & (m_capacity - 1)];
+                if (predicate(*bucket.slot()))
+                    return &bucket;
+            }
 
-            if (bucket.state != BucketState::Used && bucket.state != BucketState::Deleted)
+            // An entry is never stored past an empty bucket that comes after its home bucket.
+            if (Detail::match_empty_control_group(control))
                 return nullptr;
 
-            hash = double_hash(hash);
+            index = (index + Detail::control_group_size) & (m_capacity - 1);
         }
     }
 
-    ErrorOr<BucketType*> try_lookup_for_writing(T const& value)
+    ErrorOr<BucketType*> try_lookup_for_writing(T const& value, unsigned hash)
     {
         // FIXME: Maybe overrun the "allowed" load factor to avoid OOM
         //        If we are allowed to do that, separate that logic from
         //        the normal lookup_for_writing
         if (should_grow())
-            TRY(try_rehash(capacity() * 2));
-        auto hash = TraitsForT::hash(value);
-        BucketType* first_empty_bucket = nullptr;
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (is_used_bucket(bucket.state) && TraitsForT::equals(*bucket.slot(), value))
-                return &bucket;
+            TRY(try_rehash(m_capacity * 2));
 
-            if (!is_used_bucket(bucket.state)) {
-                if (!first_empty_bucket)
-                    first_empty_bucket = &bucket;
-
-                if (bucket.state != BucketState::Deleted)
-                    return const_cast<BucketType*>(first_empty_bucket);
+        auto index = home_index(hash);
+        auto bits = hash_bits(hash);
+        for (;;) {
+            auto const* control = control_bytes() + index;
+            for (auto matches = Detail::match_control_group(control, bits); matches; matches &= matches - 1) {
+                auto& bucket = m_buckets[(index + count_trailing_zeroes(matches)) & (m_capacity - 1)];
+                if (TraitsForT::equals(*bucket.slot(), value))
+                    return &bucket;
             }
 
-            hash = double_hash(hash);
+            if (auto empty = Detail::match_empty_control_group(control))
+                return &m_buckets[(index + count_trailing_zeroes(empty)) & (m_capacity - 1)];
+
+            index = (index + Detail::control_group_size) & (m_capacity - 1);
         }
     }
-    [[nodiscard]] BucketType& lookup_for_writing(T const& value)
+
+    [[nodiscard]] bool should_grow() const { return ((m_size + 1) * 100) >= (m_capacity * load_factor_in_percent); }
+
+    void move_bucket(size_t from_index, size_t to_index)
     {
-        return *MUST(try_lookup_for_writing(value));
-    }
+        auto& from = m_buckets[from_index];
+        auto& to = m_buckets[to_index];
+        new (to.slot()) T(move(*from.slot()));
+        from.slot()->~T();
+        set_control_byte(to_index, control_bytes()[from_index]);
 
-    [[nodiscard]] size_t used_bucket_count() const { return m_size + m_deleted_count; }
-    [[nodiscard]] bool should_grow() const { return ((used_bucket_count() + 1) * 100) >= (m_capacity * load_factor_in_percent); }
+        if constexpr (IsOrdered) {
+            to.previous = from.previous;
+            to.next = from.next;
+            if (to.previous)
+                to.previous->next = &to;
+            else
+                m_collection_data.head = &to;
+            if (to.next)
+                to.next->previous = &to;
+            else
+                m_collection_data.tail = &to;
+        }
+    }
 
-    void delete_bucket(auto& bucket)
+    void delete_bucket(size_t index)
     {
+        auto& bucket = m_buckets[index];
         bucket.slot()->~T();
-        bucket.state = BucketState::Deleted;
+        --m_size;
 
         if constexpr (IsOrdered) {
             if (bucket.previous)
@@ -710,9 +685,20 @@ private:
                 bucket.next->previous = bucket.previous;
             else
                 m_collection_data.tail = bucket.previous;
-            bucket.previous = nullptr;
-            bucket.next = nullptr;
         }
+
+        // Instead of leaving a marker behind that lookups would have to probe past, the entries after the hole are
+        // moved back into it, unless that would put them in front of their home bucket.
+        auto mask = m_capacity - 1;
+        auto hole = index;
+        for (auto next = (hole + 1) & mask; is_used_bucket(next); next = (next + 1) & mask) {
+            auto home = home_index(TraitsForT::hash(*m_buckets[next].slot()));
+            if (((next - home) & mask) < ((next - hole) & mask))
+                continue;
+            move_bucket(next, hole);
+            hole = next;
+        }
+        set_control_byte(hole, Detail::empty_control_byte);
     }
 
     BucketType* m_buckets { nullptr };
@@ -720,7 +706,6 @@ private:
     [[no_unique_address]] CollectionDataType m_collection_data;
     size_t m_size { 0 };
     size_t m_capacity { 0 };
-    size_t m_deleted_count { 0 };
 };
 }
 
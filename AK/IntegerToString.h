@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// The largest 64-bit value formatted as a binary number.
+constexpr size_t max_unsigned_digits = 64;
+
+// Writes the digits of `value` in `base` to the start of `buffer`, which has to have room for max_unsigned_digits
+// characters, and returns how many there are. This is the number formatting core of both AK::Format and printf().
+template<typename CharType>
+constexpr size_t convert_unsigned_to_string(u64 value, CharType* buffer, u8 base, bool upper_case)
+{
+    VERIFY(base >= 2 && base <= 16);
+
+    constexpr char const* lowercase_lookup = "0123456789abcdef";
+    constexpr char const* uppercase_lookup = "0123456789ABCDEF";
+    auto const* lookup = upper_case ? uppercase_lookup : lowercase_lookup;
+
+    if (base == 10) {
+        // Counting the digits first lets us write them from the back, and then peeling off two of them per
+        // division halves the number of (multiplicative) divisions.
+        constexpr char const* pairs_lookup
+            = "00010203040506070809"
+              "10111213141516171819"
+              "20212223242526272829"
+              "30313233343536373839"
+              "40414243444546474849"
+              "50515253545556575859"
+              "60616263646566676869"
+              "70717273747576777879"
+              "80818283848586878889"
+              "90919293949596979899";
+
+        size_t digits = 1;
+        for (u64 power = 10; digits < 20 && value >= power; power *= 10)
+            ++digits;
+
+        auto* end = buffer + digits;
+        while (value >= 100) {
+            auto pair = (value % 100) * 2;
+            value /= 100;
+            *--end = pairs_lookup[pair + 1];
+            *--end = pairs_lookup[pair];
+        }
+        if (value >= 10) {
+            *--end = pairs_lookup[value * 2 + 1];
+            *--end = pairs_lookup[value * 2];
+        } else {
+            *--end = '0' + value;
+        }
+        return digits;
+    }
+
+    if ((base & (base - 1)) == 0) {
+        // Powers of two don't need divisions at all.
+        auto bits_per_digit = count_trailing_zeroes(base);
+        auto bits = value == 0 ? 1 : 64 - count_leading_zeroes(value);
+        size_t digits = (bits + bits_per_digit - 1) / bits_per_digit;
+        u64 mask = base - 1;
+        for (size_t i = digits; i > 0; --i) {
+            buffer[i - 1] = lookup[value & mask];
+            value >>= bits_per_digit;
+        }
+        return digits;
+    }
+
+    size_t digits = 1;
+    for (u64 rest = value / base; rest > 0; rest /= base)
+        ++digits;
+    for (size_t i = digits; i > 0; --i) {
+        buffer[i - 1] = lookup[value % base];
+        value /= base;
+    }
+    return digits;
+}
+
+}
+
+using AK::convert_unsigned_to_string;
+using AK::max_unsigned_digits;
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/CharacterTypes.h>
+#include <AK/JsonParser.h>
+#include <AK/JsonReader.h>
+#include <AK/SIMD.h>
+#include <AK/StringBuilder.h>
+
+namespace AK {
+
+static constexpr bool is_space(int ch)
+{
+    return ch == '\t' || ch == '\n' || ch == '\r' || ch == ' ';
+}
+
+static constexpr bool ends_string_run(char ch)
+{
+    return ch == '"' || ch == '\\' || is_ascii_c0_control(ch);
+}
+
+// Finds the first quote, backslash or control character, which are the only characters that can end a
+// run of plain string contents. Strings make up most of a typical document, so this looks at 16 (or 8)
+// bytes at a time.
+static char const* find_end_of_string_run(char const* position, char const* end)
+{
+#ifdef __SSE2__
+    using namespace AK::SIMD;
+    while (end - position >= 16) {
+        u8x16 bytes;
+        __builtin_memcpy(&bytes, position, sizeof(bytes));
+        auto matches = (bytes == (u8)'"') | (bytes == (u8)'\\') | (bytes < (u8)0x20);
+        auto mask = static_cast<u32>(__builtin_ia32_pmovmskb128((c8x16)matches));
+        if (mask != 0)
+            return position + count_trailing_zeroes(mask);
+        position += 16;
+    }
+#else
+    static constexpr u64 low_bits = 0x7f7f7f7f7f7f7f7fULL;
+    // Sets the top bit of exactly those bytes of `word` that are zero.
+    auto zero_bytes = [](u64 word) {
+        return ~(((word & low_bits) + low_bits) | word | low_bits);
+    };
+    while (end - position >= 8) {
+        u64 word;
+        __builtin_memcpy(&word, position, sizeof(word));
+        auto matches = zero_bytes(word ^ 0x2222222222222222ULL)
+            | zero_bytes(word ^ 0x5c5c5c5c5c5c5c5cULL)
+            | zero_bytes(word & 0xe0e0e0e0e0e0e0e0ULL);
+        if (matches != 0)
+            return position + count_trailing_zeroes(matches) / 8;
+        position += 8;
+    }
+#endif
+    while (position < end && !ends_string_run(*position))
+        ++position;
+    return position;
+}
+
+bool JsonReader::Token::is_value() const
+{
+    switch (type) {
+    case TokenType::ObjectStart:
+    case TokenType::ArrayStart:
+    case TokenType::String:
+    case TokenType::Number:
+    case TokenType::True:
+    case TokenType::False:
+    case TokenType::Null:
+        return true;
+    default:
+        return false;
+    }
+}
+
+ErrorOr<String> JsonReader::Token::to_string() const
+{
+    VERIFY(type == TokenType::Key || type == TokenType::String);
+    if (!has_escapes)
+        return String(text);
+    return unescape(text);
+}
+
+Optional<u64> JsonReader::Token::to_u64() const
+{
+    if (type != TokenType::Number)
+        return {};
+    return text.to_uint<u64>();
+}
+
+Optional<i64> JsonReader::Token::to_i64() const
+{
+    if (type != TokenType::Number)
+        return {};
+    return text.to_int<i64>();
+}
+
+#ifndef KERNEL
+Optional<double> JsonReader::Token::to_double() const
+{
+    if (type != TokenType::Number)
+        return {};
+    return text.to_double(TrimWhitespace::No);
+}
+#endif
+
+ErrorOr<String> JsonReader::unescape(StringView input)
+{
+    GenericLexer lexer(input);
+    StringBuilder builder(input.length());
+    while (!lexer.is_eof()) {
+        builder.append(lexer.consume_until('\\'));
+        if (!lexer.consume_specific('\\'))
+            break;
+        switch (lexer.consume()) {
+        case '"':
+            builder.append('"');
+            break;
+        case '\\':
+            builder.append('\\');
+            break;
+        case '/':
+            builder.append('/');
+            break;
+        case 'n':
+            builder.append('\n');
+            break;
+        case 'r':
+            builder.append('\r');
+            break;
+        case 't':
+            builder.append('\t');
+            break;
+        case 'b':
+            builder.append('\b');
+            break;
+        case 'f':
+            builder.append('\f');
+            break;
+        case 'u': {
+            if (lexer.tell_remaining() < 4)
+                return Error::from_string_literal("JsonReader: EOF while parsing Unicode escape");
+            auto code_point = AK::StringUtils::convert_to_uint_from_hex(lexer.consume(4));
+            if (!code_point.has_value())
+                return Error::from_string_literal("JsonReader: Error while parsing Unicode escape");
+            builder.append_code_point(code_point.value());
+            break;
+        }
+        default:
+            return Error::from_string_literal("JsonReader: Error while parsing string");
+        }
+    }
+    return builder.to_string();
+}
+
+ErrorOr<StringView> JsonReader::consume_string(bool& has_escapes)
+{
+    if (!consume_specific('"'))
+        return Error::from_string_literal("JsonReader: Expected '\"'");
+
+    has_escapes = false;
+    auto start = tell();
+    char const* input_start = m_input.characters_without_null_termination();
+    char const* input_end = input_start + m_input.length();
+    for (;;) {
+        auto const* position = find_end_of_string_run(input_start + m_index, input_end);
+        m_index = position - input_start;
+        if (is_eof())
+            return Error::from_string_literal("JsonReader: EOF while parsing string");
+
+        auto ch = peek();
+        if (ch == '"')
+            break;
+        if (ch != '\\')
+            return Error::from_string_literal("JsonReader: Error while parsing string");
+
+        // Only validate the escape here, it is decoded by unescape() if anyone asks for it.
+        has_escapes = true;
+        ignore();
+        if (is_eof())
+            return Error::from_string_literal("JsonReader: EOF while parsing string");
+        switch (consume()) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'n':
+        case 'r':
+        case 't':
+        case 'b':
+        case 'f':
+            break;
+        case 'u':
+            if (tell_remaining() < 4)
+                return Error::from_string_literal("JsonReader: EOF while parsing Unicode escape");
+            if (!AK::StringUtils::convert_to_uint_from_hex(consume(4)).has_value())
+                return Error::from_string_literal("JsonReader: Error while parsing Unicode escape");
+            break;
+        default:
+            return Error::from_string_literal("JsonReader: Error while parsing string");
+        }
+    }
+
+    auto contents = m_input.substring_view(start, tell() - start);
+    ignore();
+    return contents;
+}
+
+ErrorOr<StringView> JsonReader::consume_number()
+{
+    auto start = tell();
+    consume_specific('-');
+
+    if (peek() == '0') {
+        ignore();
+        if (is_ascii_digit(peek()))
+            return Error::from_string_literal("JsonReader: Cannot have leading zeros");
+    } else if (is_ascii_digit(peek())) {
+        ignore_while(is_ascii_digit);
+    } else {
+        return Error::from_string_literal("JsonReader: Unexpected '-' without further digits");
+    }
+
+    if (consume_specific('.')) {
+        if (!is_ascii_digit(peek()))
+            return Error::from_string_literal("JsonReader: Must have digits after decimal point");
+        ignore_while(is_ascii_digit);
+    }
+
+    if (peek() == 'e' || peek() == 'E') {
+        ignore();
+        if (peek() == '+' || peek() == '-')
+            ignore();
+        if (!is_ascii_digit(peek()))
+            return Error::from_string_literal("JsonReader: Must have digits after exponent with an optional sign inbetween");
+        ignore_while(is_ascii_digit);
+    }
+
+    return m_input.substring_view(start, tell() - start);
+}
+
+ErrorOr<JsonReader::Token> JsonReader::consume_value()
+{
+    Token token;
+    switch (peek()) {
+    case '{':
+        ignore();
+        TRY(m_containers.try_append(Container::Object));
+        m_state = State::FirstKeyOrObjectEnd;
+        token.type = TokenType::ObjectStart;
+        return token;
+    case '[':
+        ignore();
+        TRY(m_containers.try_append(Container::Array));
+        m_state = State::FirstValueOrArrayEnd;
+        token.type = TokenType::ArrayStart;
+        return token;
+    case '"':
+        token.type = TokenType::String;
+        token.text = TRY(consume_string(token.has_escapes));
+        break;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        token.type = TokenType::Number;
+        token.text = TRY(consume_number());
+        break;
+    case 't':
+        if (!consume_specific("true"sv))
+            return Error::from_string_literal("JsonReader: Expected 'true'");
+        token.type = TokenType::True;
+        break;
+    case 'f':
+        if (!consume_specific("false"sv))
+            return Error::from_string_literal("JsonReader: Expected 'false'");
+        token.type = TokenType::False;
+        break;
+    case 'n':
+        if (!consume_specific("null"sv))
+            return Error::from_string_literal("JsonReader: Expected 'null'");
+        token.type = TokenType::Null;
+        break;
+    default:
+        return Error::from_string_literal("JsonReader: Unexpected character");
+    }
+    did_finish_value();
+    return token;
+}
+
+ErrorOr<JsonReader::Token> JsonReader::consume_key()
+{
+    Token token;
+    token.type = TokenType::Key;
+    token.text = TRY(consume_string(token.has_escapes));
+    ignore_while(is_space);
+    if (!consume_specific(':'))
+        return Error::from_string_literal("JsonReader: Expected ':'");
+    m_state = State::Value;
+    return token;
+}
+
+ErrorOr<JsonReader::Token> JsonReader::end_container(Container container, TokenType type)
+{
+    VERIFY(!m_containers.is_empty() && m_containers.last() == container);
+    ignore();
+    m_containers.take_last();
+    did_finish_value();
+    Token token;
+    token.type = type;
+    return token;
+}
+
+ErrorOr<JsonReader::Token> JsonReader::next()
+{
+    for (;;) {
+        ignore_while(is_space);
+        switch (m_state) {
+        case State::Value:
+            return consume_value();
+        case State::FirstKeyOrObjectEnd:
+            if (peek() == '}')
+                return end_container(Container::Object, TokenType::ObjectEnd);
+            return consume_key();
+        case State::Key:
+            if (peek() != '"')
+                return Error::from_string_literal("JsonReader: Expected object property name");
+            return consume_key();
+        case State::FirstValueOrArrayEnd:
+            if (peek() == ']')
+                return end_container(Container::Array, TokenType::ArrayEnd);
+            return consume_value();
+        case State::CommaOrEnd: {
+            auto container = m_containers.last();
+            if (container == Container::Object && peek() == '}')
+                return end_container(Container::Object, TokenType::ObjectEnd);
+            if (container == Container::Array && peek() == ']')
+                return end_container(Container::Array, TokenType::ArrayEnd);
+            if (!consume_specific(','))
+                return Error::from_string_literal("JsonReader: Expected ','");
+            m_state = container == Container::Object ? State::Key : State::Value;
+            continue;
+        }
+        case State::Done:
+            if (!is_eof())
+                return Error::from_string_literal("JsonReader: Didn't consume all input");
+            return Token {};
+        }
+        VERIFY_NOT_REACHED();
+    }
+}
+
+ErrorOr<void> JsonReader::skip_value(Token const& token)
+{
+    if (!token.is_value())
+        return Error::from_string_literal("JsonReader: Expected a value");
+    if (token.type != TokenType::ObjectStart && token.type != TokenType::ArrayStart)
+        return {};
+
+    auto target_depth = depth() - 1;
+    while (depth() > target_depth) {
+        auto next_token = TRY(next());
+        if (next_token.type == TokenType::EndOfInput)
+            return Error::from_string_literal("JsonReader: Unexpected end of input");
+    }
+    return {};
+}
+
+ErrorOr<void> JsonReader::skip_value()
+{
+    auto token = TRY(next());
+    return skip_value(token);
+}
+
+ErrorOr<JsonValue> JsonReader::read_value()
+{
+    // Get to where the value starts, which may mean stepping over the ',' that separates it from the previous one.
+    ignore_while(is_space);
+    if (m_state == State::CommaOrEnd && !m_containers.is_empty() && m_containers.last() == Container::Array) {
+        if (!consume_specific(','))
+            return Error::from_string_literal("JsonReader: Expected ','");
+        m_state = State::Value;
+        ignore_while(is_space);
+    }
+    if (m_state != State::Value && !(m_state == State::FirstValueOrArrayEnd && peek() != ']'))
+        return Error::from_string_literal("JsonReader: Expected a value");
+
+    auto start = tell();
+    TRY(skip_value());
+    return JsonParser(m_input.substring_view(start, tell() - start)).parse();
+}
+
+}
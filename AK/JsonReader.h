@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/GenericLexer.h>
+#include <AK/JsonValue.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+// A pull parser that walks a JSON document one token at a time, without building a tree of JsonValues.
+// Strings and numbers are handed out as views into the input, so reading a document allocates nothing
+// beyond the container stack. Use JsonParser instead if you want the whole document as a JsonValue.
+//
+//     JsonReader reader(input);
+//     auto token = TRY(reader.next()); // ObjectStart
+//     token = TRY(reader.next());      // Key "name"
+//     token = TRY(reader.next());      // String "value"
+class JsonReader : private GenericLexer {
+public:
+    enum class TokenType {
+        ObjectStart,
+        ObjectEnd,
+        ArrayStart,
+        ArrayEnd,
+        Key,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        EndOfInput,
+    };
+
+    struct Token {
+        TokenType type { TokenType::EndOfInput };
+        // The characters between the quotes for keys and strings (with escapes left in place), or the number as written.
+        StringView text;
+        bool has_escapes { false };
+
+        bool is_value() const;
+
+        // Keys and strings without escapes can be compared directly against `text`.
+        bool text_equals(StringView other) const { return !has_escapes && text == other; }
+
+        ErrorOr<String> to_string() const;
+        Optional<u64> to_u64() const;
+        Optional<i64> to_i64() const;
+#ifndef KERNEL
+        Optional<double> to_double() const;
+#endif
+    };
+
+    explicit JsonReader(StringView input)
+        : GenericLexer(input)
+    {
+    }
+
+    ErrorOr<Token> next();
+
+    // Skips the value whose first token is `token` (an ObjectStart or ArrayStart skips the whole container).
+    ErrorOr<void> skip_value(Token const& token);
+    // Skips the next value, which must start at the current position.
+    ErrorOr<void> skip_value();
+
+    // Builds a JsonValue for the next value only, leaving the rest of the document unparsed.
+    ErrorOr<JsonValue> read_value();
+
+    // Calls `callback` with the key of each member of the object whose ObjectStart was just read.
+    // The callback has to consume the member's value, for example with next() or skip_value().
+    template<typename Callback>
+    ErrorOr<void> for_each_member(Callback callback)
+    {
+        for (;;) {
+            auto token = TRY(next());
+            if (token.type == TokenType::ObjectEnd)
+                return {};
+            if (token.type != TokenType::Key)
+                return Error::from_string_literal("JsonReader: Expected object property name");
+            TRY(callback(token));
+        }
+    }
+
+    // Calls `callback` with the first token of each element of the array whose ArrayStart was just read.
+    // For nested objects and arrays, the callback has to consume the rest of the element.
+    template<typename Callback>
+    ErrorOr<void> for_each_element(Callback callback)
+    {
+        for (;;) {
+            auto token = TRY(next());
+            if (token.type == TokenType::ArrayEnd)
+                return {};
+            if (!token.is_value())
+                return Error::from_string_literal("JsonReader: Expected a value");
+            TRY(callback(token));
+        }
+    }
+
+    size_t depth() const { return m_containers.size(); }
+
+    // Replaces the escape sequences in the contents of a JSON string.
+    static ErrorOr<String> unescape(StringView);
+
+private:
+    enum class Container : u8 {
+        Object,
+        Array,
+    };
+
+    enum class State : u8 {
+        Value,
+        FirstKeyOrObjectEnd,
+        Key,
+        FirstValueOrArrayEnd,
+        CommaOrEnd,
+        Done,
+    };
+
+    ErrorOr<Token> consume_value();
+    ErrorOr<Token> consume_key();
+    ErrorOr<StringView> consume_string(bool& has_escapes);
+    ErrorOr<StringView> consume_number();
+    ErrorOr<Token> end_container(Container, TokenType);
+    void did_finish_value() { m_state = m_containers.is_empty() ? State::Done : State::CommaOrEnd; }
+
+    Vector<Container, 16> m_containers;
+    State m_state { State::Value };
+};
+
+}
+
+using AK::JsonReader;
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Format.h>
+#include <AK/IntegerToString.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 #include <stdarg.h>
@@ -27,36 +28,15 @@ namespace PrintfImplementation {
 template<typename PutChFunc, typename T, typename CharType>
 ALWAYS_INLINE int print_hex(PutChFunc putch, CharType*& bufptr, T number, bool upper_case, bool alternate_form, bool left_pad, bool zero_pad, u32 field_width, bool has_precision, u32 precision)
 {
-    constexpr char const* printf_hex_digits_lower = "0123456789abcdef";
-    constexpr char const* printf_hex_digits_upper = "0123456789ABCDEF";
-
-    u32 digits = 0;
-    for (T n = number; n > 0; n >>= 4)
-        ++digits;
-    if (digits == 0)
-        digits = 1;
-
     bool not_zero = number != 0;
 
-    char buf[16];
+    char buf[max_unsigned_digits];
     char* p = buf;
 
     if (!(has_precision && precision == 0 && !not_zero)) {
-        if (number == 0) {
-            (*p++) = '0';
-            if (precision > 0)
-                precision--;
-        } else {
-            u8 shift_count = digits * 4;
-            while (shift_count) {
-                shift_count -= 4;
-                (*p++) = upper_case
-                    ? printf_hex_digits_upper[(number >> shift_count) & 0x0f]
-                    : printf_hex_digits_lower[(number >> shift_count) & 0x0f];
-                if (precision > 0)
-                    precision--;
-            }
-        }
+        auto digits = convert_unsigned_to_string(static_cast<u64>(number), p, 16, upper_case);
+        p += digits;
+        precision = precision > digits ? precision - digits : 0;
     }
 
     size_t numlen = p - buf;
@@ -102,27 +82,13 @@ ALWAYS_INLINE int print_hex(PutChFunc putch, CharType*& bufptr, T number, bool u
 template<typename PutChFunc, typename CharType>
 ALWAYS_INLINE int print_decimal(PutChFunc putch, CharType*& bufptr, u64 number, bool sign, bool always_sign, bool left_pad, bool zero_pad, u32 field_width, bool has_precision, u32 precision)
 {
-    u64 divisor = 10000000000000000000LLU;
-    char ch;
-    char padding = 1;
-    char buf[21];
+    char buf[max_unsigned_digits];
     char* p = buf;
 
     if (!(has_precision && precision == 0 && number == 0)) {
-        for (;;) {
-            ch = '0' + (number / divisor);
-            number %= divisor;
-            if (ch != '0')
-                padding = 0;
-            if (!padding || divisor == 1) {
-                *(p++) = ch;
-                if (precision > 0)
-                    precision--;
-            }
-            if (divisor == 1)
-                break;
-            divisor /= 10;
-        }
+        auto digits = convert_unsigned_to_string(number, p, 10, false);
+        p += digits;
+        precision = precision > digits ? precision - digits : 0;
     }
 
     size_t numlen = p - buf;
@@ -216,10 +182,7 @@ ALWAYS_INLINE int print_double(PutChFunc putch, CharType*& bufptr, double number
 template<typename PutChFunc, typename CharType>
 ALWAYS_INLINE int print_octal_number(PutChFunc putch, CharType*& bufptr, u64 number, bool alternate_form, bool left_pad, bool zero_pad, u32 field_width, bool has_precision, u32 precision)
 {
-    u32 divisor = 134217728;
-    char ch;
-    char padding = 1;
-    char buf[32];
+    char buf[max_unsigned_digits + 1];
     char* p = buf;
 
     if (alternate_form) {
@@ -229,20 +192,9 @@ ALWAYS_INLINE int print_octal_number(PutChFunc putch, CharType*& bufptr, u64 num
     }
 
     if (!(has_precision && precision == 0 && number == 0)) {
-        for (;;) {
-            ch = '0' + (number / divisor);
-            number %= divisor;
-            if (ch != '0')
-                padding = 0;
-            if (!padding || divisor == 1) {
-                *(p++) = ch;
-                if (precision > 0)
-                    precision--;
-            }
-            if (divisor == 1)
-                break;
-            divisor /= 8;
-        }
+        auto digits = convert_unsigned_to_string(number, p, 8, false);
+        p += digits;
+        precision = precision > digits ? precision - digits : 0;
     }
 
     size_t numlen = p - buf;
@@ -402,7 +354,15 @@ struct PrintfImpl {
 #endif
     ALWAYS_INLINE int format_o(ModifierState const& state, ArgumentListRefT ap) const
     {
-        return print_octal_number(m_putch, m_bufptr, NextArgument<u32>()(ap), state.alternate_form, state.left_pad, state.zero_pad, state.field_width, state.has_precision, state.precision);
+        u64 number = [&]() -> u64 {
+            if (state.long_qualifiers >= 2)
+                return NextArgument<unsigned long long int>()(ap);
+            if (state.long_qualifiers == 1)
+                return NextArgument<unsigned long int>()(ap);
+            return NextArgument<unsigned int>()(ap);
+        }();
+
+        return print_octal_number(m_putch, m_bufptr, number, state.alternate_form, state.left_pad, state.zero_pad, state.field_width, state.has_precision, state.precision);
     }
     ALWAYS_INLINE int format_unsigned_hex(ModifierState const& state, ArgumentListRefT ap, bool uppercase) const
     {
@@ -226,6 +226,8 @@ String String::repeated(char ch, size_t count)
 {
     if (!count)
         return empty();
+    if (count == 1)
+        return StringImpl::the_single_byte_stringimpl(ch);
     char* buffer;
     auto impl = StringImpl::create_uninitialized(count, buffer);
     memset(buffer, ch, count);
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/CharacterTypes.h>
 #include <AK/FlyString.h>
 #include <AK/HashTable.h>
@@ -15,17 +16,31 @@
 
 namespace AK {
 
-static StringImpl* s_the_empty_stringimpl = nullptr;
-
 StringImpl& StringImpl::the_empty_stringimpl()
 {
-    if (!s_the_empty_stringimpl) {
+    // NOTE: Function-local statics are initialized exactly once, even if several threads get here at the same time.
+    static StringImpl* s_the_empty_stringimpl = [] {
         void* slot = kmalloc(sizeof(StringImpl) + sizeof(char));
-        s_the_empty_stringimpl = new (slot) StringImpl(ConstructTheEmptyStringImpl);
-    }
+        return new (slot) StringImpl(ConstructTheEmptyStringImpl);
+    }();
     return *s_the_empty_stringimpl;
 }
 
+// One-byte strings are common enough (separators, single letters, digits) that they are all shared,
+// like the empty string. They are never freed, and count as interned for FlyString.
+StringImpl& StringImpl::the_single_byte_stringimpl(char byte)
+{
+    static Array<StringImpl*, 256> const s_single_byte_stringimpls = [] {
+        Array<StringImpl*, 256> stringimpls;
+        for (size_t i = 0; i < stringimpls.size(); ++i) {
+            void* slot = kmalloc(allocation_size_for_stringimpl(1));
+            stringimpls[i] = new (slot) StringImpl(ConstructTheSingleByteStringImpl, static_cast<char>(i));
+        }
+        return stringimpls;
+    }();
+    return *s_single_byte_stringimpls[static_cast<u8>(byte)];
+}
+
 StringImpl::StringImpl(ConstructWithInlineBufferTag, size_t length)
     : m_length(length)
 {
@@ -65,6 +80,8 @@ RefPtr<StringImpl> StringImpl::create(char const* cstring, size_t length, Should
 
     if (!length)
         return the_empty_stringimpl();
+    if (length == 1)
+        return the_single_byte_stringimpl(cstring[0]);
 
     char* buffer;
     auto new_stringimpl = create_uninitialized(length, buffer);
@@ -95,6 +112,8 @@ RefPtr<StringImpl> StringImpl::create_lowercased(char const* cstring, size_t len
         return nullptr;
     if (!length)
         return the_empty_stringimpl();
+    if (length == 1)
+        return the_single_byte_stringimpl((char)to_ascii_lowercase(cstring[0]));
     char* buffer;
     auto impl = create_uninitialized(length, buffer);
     for (size_t i = 0; i < length; ++i)
@@ -108,6 +127,8 @@ RefPtr<StringImpl> StringImpl::create_uppercased(char const* cstring, size_t len
         return nullptr;
     if (!length)
         return the_empty_stringimpl();
+    if (length == 1)
+        return the_single_byte_stringimpl((char)to_ascii_uppercase(cstring[0]));
     char* buffer;
     auto impl = create_uninitialized(length, buffer);
     for (size_t i = 0; i < length; ++i)
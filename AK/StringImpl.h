@@ -40,6 +40,22 @@ public:
     }
 
     static StringImpl& the_empty_stringimpl();
+    static StringImpl& the_single_byte_stringimpl(char);
+
+    // NOTE: The shared empty and single-byte impls are used by every thread at once, and the reference count isn't
+    //       atomic. So they don't keep one at all, and are never freed.
+    ALWAYS_INLINE void ref() const
+    {
+        if (!m_is_immortal)
+            RefCounted::ref();
+    }
+
+    ALWAYS_INLINE bool unref() const
+    {
+        if (m_is_immortal)
+            return false;
+        return RefCounted::unref();
+    }
 
     ~StringImpl();
 
@@ -86,8 +102,23 @@ private:
     };
     explicit StringImpl(ConstructTheEmptyStringImplTag)
         : m_fly(true)
+        , m_is_immortal(true)
     {
         m_inline_buffer[0] = '\0';
+        compute_hash();
+    }
+
+    enum ConstructTheSingleByteStringImplTag {
+        ConstructTheSingleByteStringImpl
+    };
+    StringImpl(ConstructTheSingleByteStringImplTag, char byte)
+        : m_length(1)
+        , m_fly(true)
+        , m_is_immortal(true)
+    {
+        m_inline_buffer[0] = byte;
+        m_inline_buffer[1] = '\0';
+        compute_hash();
     }
 
     enum ConstructWithInlineBufferTag {
@@ -101,6 +132,7 @@ private:
     mutable unsigned m_hash { 0 };
     mutable bool m_has_hash { false };
     mutable bool m_fly { false };
+    bool m_is_immortal { false };
     char m_inline_buffer[0];
 };
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// An I/O ring lets a process queue up many I/O operations with a single syscall, and collect their results
+// without making another one. Both queues live in memory that is shared between the process and the kernel,
+// which is mapped by calling mmap() on the ring's file descriptor with io_ring_mapping_size(entries) bytes.
+//
+// Userspace writes submissions to the submission queue and advances submission_tail, then calls
+// io_ring_enter() to have the kernel consume them. Operations that can complete right away post their
+// completion immediately, everything else completes asynchronously as soon as its file becomes ready.
+// The ring's file descriptor becomes readable while there are completions waiting in the completion queue.
+//
+// NOTE: Asynchronous operations are carried out by a kernel task once their file description is ready.
+//       Use non-blocking descriptions so that losing a race for the data to another reader can't stall it.
+
+enum class IORingOperation : u8 {
+    Nop,
+    // Reads up to `length` bytes into `address`, at `offset` (or the current file offset if it's io_ring_current_offset).
+    Read,
+    // Writes `length` bytes from `address`, at `offset` (or the current file offset if it's io_ring_current_offset).
+    Write,
+    // Waits until the file becomes ready for any of the `poll_events`, and completes with the ready ones.
+    Poll,
+    // Accepts a connection on a listening socket, and completes with the new file descriptor.
+    Accept,
+    // Connects a socket to the `length` bytes long sockaddr at `address`.
+    Connect,
+};
+
+static constexpr u64 io_ring_current_offset = ~0ull;
+
+struct IORingSubmission {
+    IORingOperation operation;
+    u8 reserved;
+    u16 poll_events;
+    i32 fd;
+    u64 offset;
+    u64 address;
+    u32 length;
+    // For Accept, SOCK_NONBLOCK and SOCK_CLOEXEC.
+    u32 flags;
+    // Passed back as-is in the completion.
+    u64 user_data;
+};
+static_assert(sizeof(IORingSubmission) == 40);
+
+struct IORingCompletion {
+    u64 user_data;
+    // A non-negative result on success, or a negated errno value.
+    i32 result;
+    u32 reserved;
+};
+static_assert(sizeof(IORingCompletion) == 16);
+
+struct IORingHeader {
+    // The kernel consumes submissions at the head, userspace produces them at the tail.
+    u32 submission_head;
+    u32 submission_tail;
+    u32 submission_entries;
+    // Userspace consumes completions at the head, the kernel produces them at the tail.
+    u32 completion_head;
+    u32 completion_tail;
+    u32 completion_entries;
+    // Completions that were thrown away because the completion queue was full.
+    u32 dropped_completions;
+    u32 reserved;
+};
+
+static constexpr u32 io_ring_max_entries = 4096;
+
+// There are twice as many completion slots as submission slots, since operations that were submitted
+// in one go don't necessarily complete in one go.
+constexpr size_t io_ring_completion_entries(u32 submission_entries)
+{
+    return 2 * submission_entries;
+}
+
+constexpr size_t io_ring_submissions_offset()
+{
+    return sizeof(IORingHeader);
+}
+
+constexpr size_t io_ring_completions_offset(u32 submission_entries)
+{
+    return io_ring_submissions_offset() + submission_entries * sizeof(IORingSubmission);
+}
+
+constexpr size_t io_ring_mapping_size(u32 submission_entries)
+{
+    constexpr size_t page_size = 4096;
+    auto size = io_ring_completions_offset(submission_entries) + io_ring_completion_entries(submission_entries) * sizeof(IORingCompletion);
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+}
@@ -33,10 +33,19 @@ enum {
     PERF_EVENT_SYSCALL = 16384,
     PERF_EVENT_SIGNPOST = 32768,
     PERF_EVENT_READ = 65536,
+    PERF_EVENT_LOCK_WAIT = 131072,
+    PERF_EVENT_CPU_CYCLES = 262144,
+    PERF_EVENT_INSTRUCTIONS_RETIRED = 524288,
+    PERF_EVENT_CACHE_MISSES = 1048576,
+    PERF_EVENT_BRANCH_MISSES = 2097152,
 };
 
 #define PERF_EVENT_MASK_ALL (~0ull)
 
+// Passing this instead of a PID to profiling_enable(), profiling_disable() and profiling_free_buffer() controls the
+// continuous profiler, which samples all processors at a low rate. Its samples are drained from /sys/kernel/continuous_profile.
+#define PROFILING_CONTINUOUS_PID -2
+
 #define THREAD_PRIORITY_MIN 1
 #define THREAD_PRIORITY_LOW 10
 #define THREAD_PRIORITY_NORMAL 30
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2020, Nico Weber <thakis@chromium.org>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    POSIX_SPAWN_RESETIDS = 1 << 0,
+    POSIX_SPAWN_SETPGROUP = 1 << 1,
+
+    POSIX_SPAWN_SETSCHEDPARAM = 1 << 2,
+    POSIX_SPAWN_SETSCHEDULER = 1 << 3,
+
+    POSIX_SPAWN_SETSIGDEF = 1 << 4,
+    POSIX_SPAWN_SETSIGMASK = 1 << 5,
+
+    POSIX_SPAWN_SETSID = 1 << 6,
+
+    // Makes the child's process group the foreground process group of a terminal (like glibc's extension).
+    POSIX_SPAWN_TCSETPGROUP = 1 << 7,
+};
+
+#define POSIX_SPAWN_SETSID POSIX_SPAWN_SETSID
+#define POSIX_SPAWN_TCSETPGROUP POSIX_SPAWN_TCSETPGROUP
+
+#ifdef __cplusplus
+}
+#endif
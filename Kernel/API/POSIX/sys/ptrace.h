@@ -26,6 +26,7 @@ extern "C" {
 #define PT_POKEDEBUG 10
 #define PT_PEEKDEBUG 11
 #define PT_PEEKBUF 12
+#define PT_SYSCALL_TRACE_BUFFER 13
 
 #define PT_READ_I PT_PEEK
 #define PT_READ_D PT_PEEK
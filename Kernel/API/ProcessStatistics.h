@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// /sys/kernel/processes is a ProcessStatisticsHeader, followed by one entry per process until the end of the file.
+// A process entry is a ProcessStatisticsRecord, its strings (name, executable, tty, pledge and veil, in that order
+// and without terminators), and then `thread_count` thread entries. A thread entry is a ThreadStatisticsRecord,
+// followed by the thread's name and state.
+//
+// Records are packed, so they can't be accessed in place and have to be copied out of the buffer.
+// New fields are only ever added to the end of a record, and the header says how large each record is, so readers
+// that know fewer fields can skip the rest. Anything else that changes the layout bumps the version.
+
+static constexpr u32 process_statistics_magic = 0x53435250; // "PRCS"
+static constexpr u16 process_statistics_version = 1;
+
+struct [[gnu::packed]] ProcessStatisticsHeader {
+    u32 magic;
+    u16 version;
+    u16 header_size;
+    u16 process_record_size;
+    u16 thread_record_size;
+    u64 total_time;
+    u64 total_time_kernel;
+};
+static_assert(sizeof(ProcessStatisticsHeader) == 28);
+
+struct [[gnu::packed]] ProcessStatisticsRecord {
+    i32 pid;
+    i32 pgid;
+    i32 pgp;
+    i32 sid;
+    u32 uid;
+    u32 gid;
+    i32 ppid;
+    u32 nfds;
+    u8 kernel;
+    u8 dumpable;
+    u16 reserved;
+    u32 thread_count;
+    u64 amount_virtual;
+    u64 amount_resident;
+    u64 amount_dirty_private;
+    u64 amount_clean_inode;
+    u64 amount_shared;
+    u64 amount_purgeable_volatile;
+    u64 amount_purgeable_nonvolatile;
+    u32 name_length;
+    u32 executable_length;
+    u32 tty_length;
+    u32 pledge_length;
+    u32 veil_length;
+};
+static_assert(sizeof(ProcessStatisticsRecord) == 116);
+
+struct [[gnu::packed]] ThreadStatisticsRecord {
+    i32 tid;
+    u32 times_scheduled;
+    u64 time_user;
+    u64 time_kernel;
+    u32 cpu;
+    u32 priority;
+    u32 syscall_count;
+    u32 inode_faults;
+    u32 zero_faults;
+    u32 cow_faults;
+    u32 file_read_bytes;
+    u32 file_write_bytes;
+    u32 unix_socket_read_bytes;
+    u32 unix_socket_write_bytes;
+    u32 ipv4_socket_read_bytes;
+    u32 ipv4_socket_write_bytes;
+    u32 name_length;
+    u32 state_length;
+};
+static_assert(sizeof(ThreadStatisticsRecord) == 80);
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// A syscall trace buffer lets a tracer follow the syscalls of its tracee without stopping it for every one of them.
+// It's created with ptrace(PT_SYSCALL_TRACE_BUFFER, tid, (void*)record_count, 0), which returns a file descriptor
+// that is mapped by calling mmap() on it with syscall_trace_mapping_size(record_count) bytes.
+//
+// Every thread of the tracee appends one record to the ring as it returns from a syscall, without taking any locks.
+// A thread first claims a slot by incrementing `head`, then fills in the record, and finally publishes it by setting
+// its `sequence` to the record's index + 1. The kernel never waits for the tracer, so records that the tracer doesn't
+// read in time are overwritten by newer ones, which the tracer notices by their sequence numbers.
+//
+// NOTE: Syscalls that never return to the tracee, like exit() or a successful execve(), don't leave a record.
+
+struct SyscallTraceRecord {
+    // The record's index + 1 once it's complete, or its index while the kernel is still writing it.
+    u32 sequence;
+    u32 function;
+    u32 tid;
+    u32 reserved;
+    // Monotonic time at which the syscall was entered, in nanoseconds.
+    u64 entry_time_ns;
+    u64 duration_ns;
+    u64 arguments[4];
+    // The value returned to the tracee, which is a negated errno value on failure.
+    i64 result;
+};
+static_assert(sizeof(SyscallTraceRecord) == 72);
+
+struct SyscallTraceHeader {
+    // The index of the next record the kernel will claim. Only the low bits are used to find its slot.
+    u32 head;
+    u32 record_count;
+    u32 reserved[2];
+};
+
+static constexpr u32 syscall_trace_max_records = 65536;
+
+constexpr size_t syscall_trace_records_offset()
+{
+    return sizeof(SyscallTraceHeader);
+}
+
+constexpr size_t syscall_trace_mapping_size(u32 record_count)
+{
+    constexpr size_t page_size = 4096;
+    auto size = syscall_trace_records_offset() + record_count * sizeof(SyscallTraceRecord);
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+}
@@ -21,10 +21,31 @@ inline bool time_page_supports(clockid_t clock_id)
     return clock_id == CLOCK_REALTIME_COARSE || clock_id == CLOCK_MONOTONIC_COARSE;
 }
 
+// These clocks can only be read from the time page if the kernel has published TSC parameters (see below).
+inline bool time_page_supports_with_tsc(clockid_t clock_id)
+{
+    return clock_id == CLOCK_REALTIME || clock_id == CLOCK_MONOTONIC;
+}
+
 struct TimePage {
     volatile u32 update1;
     struct timespec clocks[CLOCK_ID_COUNT];
+    // If tsc_is_usable is set, the precise clocks are the values in `clocks` plus the time that has passed
+    // since the time stamp counter read `tsc_at_update`, i.e. ((tsc - tsc_at_update) * multiplier) >> shift.
+    // Their values in `clocks` are what they read at the moment the time stamp counter read `tsc_at_update`.
+    u64 tsc_at_update;
+    u32 tsc_to_ns_multiplier;
+    u8 tsc_to_ns_shift;
+    bool tsc_is_usable;
     volatile u32 update2;
 };
 
+inline u64 time_page_tsc_delta_to_ns(TimePage const& page, u64 tsc_delta)
+{
+    // NOTE: The multiplication is split up so that it can't overflow, no matter how large the delta is.
+    u64 multiplier = page.tsc_to_ns_multiplier;
+    u8 shift = page.tsc_to_ns_shift;
+    return (((tsc_delta >> 32) * multiplier) << (32 - shift)) + (((tsc_delta & 0xffffffff) * multiplier) >> shift);
+}
+
 }
@@ -8,6 +8,11 @@
 
 #include <AK/Types.h>
 
+// Optional argument of VIRGL_IOCTL_CREATE_CONTEXT. Without it, a context gets a 1 MiB transfer region.
+struct VirGLContextSpec {
+    size_t transfer_region_size;
+};
+
 struct VirGL3DResourceSpec {
     u32 target;
     u32 format;
@@ -36,3 +41,18 @@ struct VirGLTransferDescriptor {
     size_t num_bytes;
     int direction;
 };
+
+// Puts a 3D resource of the context on the display that display_connector_fd is open on, in place of its framebuffer.
+// A resource_id of 0 gives the display back to the framebuffer, as does destroying the resource or the context.
+struct VirGLScanoutDescriptor {
+    int display_connector_fd;
+    u32 resource_id;
+};
+
+struct VirGLFlushDescriptor {
+    u32 resource_id;
+    u32 x;
+    u32 y;
+    u32 width;
+    u32 height;
+};
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Types.h>
+#include <Kernel/API/POSIX/serenity.h>
+
+namespace Kernel {
+
+struct RegisterState;
+
+// Samples the processors' hardware performance counters: every time one of them has counted a
+// fixed number of events, the counter overflows and an event of its type is recorded for the current thread.
+class PerformanceCounters {
+public:
+    static constexpr u64 event_mask = PERF_EVENT_CPU_CYCLES | PERF_EVENT_INSTRUCTIONS_RETIRED | PERF_EVENT_CACHE_MISSES | PERF_EVENT_BRANCH_MISSES;
+
+    static bool is_supported(u64 event_mask);
+
+    // Starts counting the events in event_mask on all processors. This nests like the profile timer,
+    // but everyone profiling at the same time has to ask for the same events.
+    static ErrorOr<void> enable(u64 event_mask);
+    static void disable();
+
+    // Called for every non-maskable interrupt, returns whether it was caused by a counter overflow.
+    static bool handle_overflow(RegisterState const&);
+};
+
+}
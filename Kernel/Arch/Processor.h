@@ -9,6 +9,7 @@
 
 #include <AK/Function.h>
 #include <Kernel/Arch/DeferredCallEntry.h>
+#include <Kernel/VirtualAddress.h>
 
 namespace Kernel {
 
@@ -21,6 +22,11 @@ enum class InterruptsState {
 InterruptsState processor_interrupts_state();
 void restore_processor_interrupts_state(InterruptsState);
 
+struct TLBFlushRange {
+    VirtualAddress vaddr;
+    size_t page_count;
+};
+
 }
 
 #if ARCH(X86_64) || ARCH(I386)
@@ -39,6 +45,10 @@ class PageDirectory;
 
 struct ProcessorMessageEntry;
 struct ProcessorMessage {
+    // A single shootdown message can carry several ranges, so that e.g. a munmap()
+    // spanning multiple regions only interrupts the other processors once.
+    static constexpr size_t max_tlb_flush_ranges = 8;
+
     using CallbackFunction = Function<void()>;
 
     enum Type {
@@ -52,8 +62,11 @@ struct ProcessorMessage {
         alignas(CallbackFunction) u8 callback_storage[sizeof(CallbackFunction)];
         struct {
             Memory::PageDirectory const* page_directory;
-            u8* ptr;
-            size_t page_count;
+            size_t range_count;
+            struct {
+                u8* ptr;
+                size_t page_count;
+            } ranges[max_tlb_flush_ranges];
         } flush_tlb;
     };
 
@@ -8,6 +8,7 @@
 #include <AK/Types.h>
 
 #include <Kernel/Arch/Delay.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Process.h>
 #include <Kernel/Sections.h>
 #include <Kernel/kstdio.h>
@@ -42,6 +43,31 @@ void microseconds_delay(u32)
 
 }
 
+// PerformanceCounters.cpp
+namespace Kernel {
+
+bool PerformanceCounters::is_supported(u64)
+{
+    return false;
+}
+
+ErrorOr<void> PerformanceCounters::enable(u64)
+{
+    return ENOTSUP;
+}
+
+void PerformanceCounters::disable()
+{
+    TODO_AARCH64();
+}
+
+bool PerformanceCounters::handle_overflow(RegisterState const&)
+{
+    return false;
+}
+
+}
+
 // Initializer.cpp
 namespace Kernel::PCI {
 
@@ -63,7 +63,8 @@ public:
     bool is_user_allowed() const { TODO_AARCH64(); }
     void set_user_allowed(bool) { }
 
-    bool is_huge() const { TODO_AARCH64(); }
+    // NOTE: We don't create block mappings, so there's never a huge page to split.
+    bool is_huge() const { return false; }
     void set_huge(bool) { }
 
     bool is_writable() const { TODO_AARCH64(); }
@@ -128,6 +129,9 @@ public:
     bool is_cache_disabled() const { TODO_AARCH64(); }
     void set_cache_disabled(bool) { }
 
+    bool is_accessed() const { TODO_AARCH64(); }
+    void set_accessed(bool) { }
+
     bool is_global() const { TODO_AARCH64(); }
     void set_global(bool) { }
 
@@ -54,6 +54,13 @@ void Processor::flush_tlb(Memory::PageDirectory const*, VirtualAddress vaddr, si
     flush_tlb_local(vaddr, page_count);
 }
 
+void Processor::flush_tlb(Memory::PageDirectory const*, Span<TLBFlushRange const> ranges)
+{
+    // flush_tlb_local() drops the whole TLB anyway.
+    if (!ranges.is_empty())
+        flush_tlb_local(ranges[0].vaddr, ranges[0].page_count);
+}
+
 u32 Processor::clear_critical()
 {
     TODO_AARCH64();
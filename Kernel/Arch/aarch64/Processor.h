@@ -61,6 +61,11 @@ public:
         TODO_AARCH64();
     }
 
+    static bool is_idle(u32)
+    {
+        return false;
+    }
+
     ALWAYS_INLINE static void pause()
     {
         TODO_AARCH64();
@@ -89,6 +94,7 @@ public:
 
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void flush_tlb(Memory::PageDirectory const*, Span<TLBFlushRange const>);
 
     ALWAYS_INLINE u32 id() const
     {
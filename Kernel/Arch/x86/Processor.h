@@ -106,6 +106,10 @@ class Processor {
     bool m_in_scheduler;
     Atomic<bool> m_halt_requested;
 
+    // The page directory currently loaded on this processor. Shootdowns for user
+    // addresses are only sent to processors that have the address space loaded.
+    Atomic<FlatPtr> m_active_cr3;
+
     DeferredCallEntry* m_pending_deferred_calls; // in reverse order
     DeferredCallEntry* m_free_deferred_call_pool_entry;
     DeferredCallEntry m_deferred_call_pool[5];
@@ -123,6 +127,7 @@ class Processor {
     bool smp_enqueue_message(ProcessorMessage&);
     static void smp_unicast_message(u32 cpu, ProcessorMessage& msg, bool async);
     static void smp_broadcast_message(ProcessorMessage& msg);
+    static bool smp_multicast_message(u64 cpu_mask, ProcessorMessage& msg);
     static void smp_broadcast_wait_sync(ProcessorMessage& msg);
     static void smp_broadcast_halt();
 
@@ -151,7 +156,21 @@ public:
 
     void idle_end() const
     {
-        s_idle_cpu_mask.fetch_and(~(1u << m_cpu), AK::MemoryOrder::memory_order_relaxed);
+        // NOTE: This has to be ordered before anything we look at after waking up, as RCU treats idle processors
+        //       as not looking at any RCU-protected data.
+        s_idle_cpu_mask.fetch_and(~(1u << m_cpu), AK::MemoryOrder::memory_order_seq_cst);
+    }
+
+    static bool is_idle(u32 cpu)
+    {
+        return (s_idle_cpu_mask.load(AK::MemoryOrder::memory_order_seq_cst) & (1u << cpu)) != 0;
+    }
+
+    static bool are_other_processors_idle()
+    {
+        u32 all_processors_mask = count() >= 32 ? NumericLimits<u32>::max() : (1u << count()) - 1;
+        u32 other_processors_mask = all_processors_mask & ~(1u << current_id());
+        return (s_idle_cpu_mask.load(AK::MemoryOrder::memory_order_seq_cst) & other_processors_mask) == other_processors_mask;
     }
 
     static Processor& by_id(u32);
@@ -187,8 +206,19 @@ public:
         write_cr3(read_cr3());
     }
 
+    // Loads a new page directory on this processor. All cr3 writes for a thread's
+    // address space must go through this so that TLB shootdowns can find us.
+    static void activate_cr3(FlatPtr cr3)
+    {
+        // This must be visible before we may start caching translations of the new
+        // address space, otherwise we could miss a concurrent shootdown.
+        current().m_active_cr3.store(cr3, AK::MemoryOrder::memory_order_seq_cst);
+        write_cr3(cr3);
+    }
+
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void flush_tlb(Memory::PageDirectory const*, Span<TLBFlushRange const>);
 
     Descriptor& get_gdt_entry(u16 selector);
     void flush_gdt();
@@ -381,7 +411,7 @@ public:
     bool smp_process_pending_messages();
 
     static void smp_unicast(u32 cpu, Function<void()>, bool async);
-    static void smp_broadcast_flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void smp_broadcast_flush_tlb(Memory::PageDirectory const*, Span<TLBFlushRange const>);
     static u32 smp_wake_n_idle_processors(u32 wake_count);
 
     static void deferred_call_queue(Function<void()> callback);
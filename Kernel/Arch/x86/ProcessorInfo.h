@@ -35,6 +35,8 @@ public:
     u32 stepping() const { return m_stepping; }
     u32 type() const { return m_type; }
     u32 apic_id() const { return m_apic_id; }
+    // The ID the firmware knows this processor by, as opposed to the logical one we may assign to its APIC.
+    u32 physical_apic_id() const { return m_physical_apic_id; }
     Optional<Cache> const& l1_data_cache() const { return m_l1_data_cache; }
     Optional<Cache> const& l1_instruction_cache() const { return m_l1_instruction_cache; }
     Optional<Cache> const& l2_cache() const { return m_l2_cache; }
@@ -63,6 +65,7 @@ private:
     u32 m_stepping { 0 };
     u32 m_type { 0 };
     u32 m_apic_id { 0 };
+    u32 m_physical_apic_id { 0 };
 
     Optional<Cache> m_l1_data_cache;
     Optional<Cache> m_l1_instruction_cache;
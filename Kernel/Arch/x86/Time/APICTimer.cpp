@@ -141,6 +141,25 @@ void APICTimer::disable_local_timer()
     APIC::the().setup_local_timer(0, APIC::TimerMode::OneShot, false);
 }
 
+void APICTimer::arm_local_timer(Time delay)
+{
+    VERIFY(m_timer_mode == APIC::TimerMode::OneShot);
+    // m_timer_period is the number of bus clock cycles in one of our ticks.
+    u64 bus_cycles_per_second = static_cast<u64>(m_timer_period) * m_frequency;
+    u64 delay_ns = clamp(delay.to_nanoseconds(), 1, 1'000'000'000);
+    auto& apic = APIC::the();
+    auto count = max<u64>(1, delay_ns * bus_cycles_per_second / 1'000'000'000 / apic.get_timer_divisor());
+    apic.set_local_timer_initial_count(static_cast<u32>(min<u64>(count, NumericLimits<u32>::max())));
+}
+
+Time APICTimer::local_time_until_interrupt() const
+{
+    auto& apic = APIC::the();
+    u64 bus_cycles_per_second = static_cast<u64>(m_timer_period) * m_frequency;
+    u64 remaining_cycles = static_cast<u64>(apic.get_timer_current_count()) * apic.get_timer_divisor();
+    return Time::from_nanoseconds(remaining_cycles * 1'000'000'000 / bus_cycles_per_second);
+}
+
 size_t APICTimer::ticks_per_second() const
 {
     return m_frequency;
@@ -148,13 +167,16 @@ size_t APICTimer::ticks_per_second() const
 
 void APICTimer::set_periodic()
 {
-    // FIXME: Implement it...
-    VERIFY_NOT_REACHED();
+    m_timer_mode = APIC::TimerMode::Periodic;
+    enable_local_timer();
 }
+
 void APICTimer::set_non_periodic()
 {
-    // FIXME: Implement it...
-    VERIFY_NOT_REACHED();
+    // NOTE: This only switches the mode of the current processor's timer right away, the others
+    //       switch over when they enable their local timer.
+    m_timer_mode = APIC::TimerMode::OneShot;
+    enable_local_timer();
 }
 
 void APICTimer::reset_to_default_ticks_per_second()
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <Kernel/Arch/x86/common/Interrupts/APIC.h>
 #include <Kernel/Interrupts/GenericInterruptHandler.h>
@@ -35,6 +36,11 @@ public:
     void enable_local_timer();
     void disable_local_timer();
 
+    // In one-shot mode, the timer of each processor only fires once it has been armed, after the given delay.
+    void arm_local_timer(Time delay);
+    Time local_time_until_interrupt() const;
+    Time tick_period() const { return Time::from_nanoseconds(1'000'000'000 / m_frequency); }
+
 private:
     explicit APICTimer(u8, Function<void(RegisterState const&)>);
 
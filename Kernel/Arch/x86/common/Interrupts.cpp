@@ -27,6 +27,7 @@
 
 #include <Kernel/Arch/CPU.h>
 #include <Kernel/Arch/PageFault.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/Processor.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Arch/SafeMem.h>
@@ -407,6 +408,16 @@ void page_fault_handler(TrapFrame* trap)
     }
 }
 
+EH_ENTRY_NO_CODE(2, non_maskable_interrupt);
+void non_maskable_interrupt_handler(TrapFrame* trap)
+{
+    clac();
+    if (PerformanceCounters::handle_overflow(*trap->regs))
+        return;
+    dbgln("Unknown error");
+    PANIC("cr0={:08x} cr2={:08x} cr3={:08x} cr4={:08x}", read_cr0(), read_cr2(), read_cr3(), read_cr4());
+}
+
 EH_ENTRY_NO_CODE(1, debug);
 void debug_handler(TrapFrame* trap)
 {
@@ -452,7 +463,6 @@ void breakpoint_handler(TrapFrame* trap)
         PANIC("cr0={:08x} cr2={:08x} cr3={:08x} cr4={:08x}", read_cr0(), read_cr2(), read_cr3(), read_cr4()); \
     }
 
-EH(2, "Unknown error")
 EH(4, "Overflow")
 EH(5, "Bounds check")
 EH(8, "Double fault")
@@ -641,7 +651,7 @@ UNMAP_AFTER_INIT void initialize_interrupts()
 
     register_interrupt_handler(0x00, divide_error_asm_entry);
     register_user_callable_interrupt_handler(0x01, debug_asm_entry);
-    register_interrupt_handler(0x02, _exception2);
+    register_interrupt_handler(0x02, non_maskable_interrupt_asm_entry);
     register_user_callable_interrupt_handler(0x03, breakpoint_asm_entry);
     register_interrupt_handler(0x04, _exception4);
     register_interrupt_handler(0x05, _exception5);
@@ -514,6 +514,16 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
     write_register(APIC_REG_TPR, 0);
 }
 
+void APIC::enable_performance_counter_nmi()
+{
+    write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(0, ICRReg::NMI));
+}
+
+void APIC::disable_performance_counter_nmi()
+{
+    write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(0, 0) | APIC_LVT_MASKED);
+}
+
 Thread* APIC::get_idle_thread(u32 cpu) const
 {
     VERIFY(cpu > 0);
@@ -627,10 +637,16 @@ void APIC::setup_local_timer(u32 ticks, TimerMode timer_mode, bool enable)
     }
     write_register(APIC_REG_TIMER_CONFIGURATION, config);
 
-    if (timer_mode == TimerMode::Periodic)
+    if (timer_mode != TimerMode::TSCDeadline)
         write_register(APIC_REG_TIMER_INITIAL_COUNT, ticks / get_timer_divisor());
 }
 
+void APIC::set_local_timer_initial_count(u32 count)
+{
+    // NOTE: In one-shot mode, writing the initial count (re)starts the countdown.
+    write_register(APIC_REG_TIMER_INITIAL_COUNT, count);
+}
+
 u32 APIC::get_timer_current_count()
 {
     return read_register(APIC_REG_TIMER_CURRENT_COUNT);
@@ -44,9 +44,15 @@ public:
         TSCDeadline
     };
     void setup_local_timer(u32, TimerMode, bool);
+    void set_local_timer_initial_count(u32);
     u32 get_timer_current_count();
     u32 get_timer_divisor();
 
+    // Delivers overflows of the current processor's performance counters as NMIs.
+    // The local APIC masks the interrupt after every delivery, so this has to be called again to unmask it.
+    void enable_performance_counter_nmi();
+    void disable_performance_counter_nmi();
+
 private:
     struct ICRReg {
         enum DeliveryMode {
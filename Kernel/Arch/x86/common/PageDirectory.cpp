@@ -46,7 +46,7 @@ void activate_kernel_page_directory(PageDirectory const& pgd)
 void activate_page_directory(PageDirectory const& pgd, Thread* current_thread)
 {
     current_thread->regs().cr3 = pgd.cr3();
-    write_cr3(pgd.cr3());
+    Processor::activate_cr3(pgd.cr3());
 }
 
 }
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <Kernel/Arch/PerformanceCounters.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Arch/x86/CPUID.h>
+#include <Kernel/Arch/x86/MSR.h>
+#include <Kernel/Arch/x86/common/Interrupts/APIC.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/PerformanceManager.h>
+
+namespace Kernel {
+
+// This uses the architectural performance monitoring of Intel processors (version 2 and up),
+// see the Intel SDM, Volume 3, Chapter 18.2.
+
+#define IA32_PMC0 0xc1
+#define IA32_PERFEVTSEL0 0x186
+#define IA32_PERF_GLOBAL_STATUS 0x38e
+#define IA32_PERF_GLOBAL_CTRL 0x38f
+#define IA32_PERF_GLOBAL_OVF_CTRL 0x390
+
+#define PERFEVTSEL_USR (1 << 16)
+#define PERFEVTSEL_OS (1 << 17)
+#define PERFEVTSEL_INT (1 << 20)
+#define PERFEVTSEL_EN (1 << 22)
+
+struct ArchitecturalEvent {
+    int type;
+    u8 event_select;
+    u8 unit_mask;
+    // The bit in EBX of CPUID leaf 0xA that is set if the processor can't count this event.
+    u8 unavailable_bit;
+    // The number of events between two samples.
+    u64 period;
+};
+
+static constexpr Array<ArchitecturalEvent, 4> s_architectural_events { {
+    { PERF_EVENT_CPU_CYCLES, 0x3c, 0x00, 0, 2'000'000 },
+    { PERF_EVENT_INSTRUCTIONS_RETIRED, 0xc0, 0x00, 1, 2'000'000 },
+    { PERF_EVENT_CACHE_MISSES, 0x2e, 0x41, 4, 10'000 },
+    { PERF_EVENT_BRANCH_MISSES, 0xc5, 0x00, 6, 10'000 },
+} };
+
+static Spinlock s_lock { LockRank::None };
+static u32 s_enable_count;
+static u64 s_enabled_events;
+
+// These are only written while the counters are stopped, the NMI handler reads them.
+static Array<ArchitecturalEvent, s_architectural_events.size()> s_counters;
+static Atomic<size_t> s_counter_count;
+
+static u32 general_purpose_counter_count()
+{
+    if (CPUID(0).eax() < 0xa)
+        return 0;
+    CPUID perfmon(0xa);
+    u8 version = perfmon.eax() & 0xff;
+    // Version 1 doesn't have the global control and overflow status registers.
+    if (version < 2)
+        return 0;
+    return (perfmon.eax() >> 8) & 0xff;
+}
+
+static bool is_event_available(ArchitecturalEvent const& event)
+{
+    CPUID perfmon(0xa);
+    u8 event_count = (perfmon.eax() >> 24) & 0xff;
+    return event.unavailable_bit < event_count && (perfmon.ebx() & (1 << event.unavailable_bit)) == 0;
+}
+
+bool PerformanceCounters::is_supported(u64 event_mask)
+{
+    u32 available_counters = general_purpose_counter_count();
+    for (auto const& event : s_architectural_events) {
+        if ((event_mask & event.type) == 0)
+            continue;
+        if (available_counters == 0 || !is_event_available(event))
+            return false;
+        --available_counters;
+    }
+    return true;
+}
+
+static void start_counters_on_current_processor()
+{
+    u64 enabled_counters = 0;
+    for (size_t i = 0; i < s_counter_count; ++i) {
+        auto const& counter = s_counters[i];
+        MSR(IA32_PERFEVTSEL0 + i).set(0);
+        // The counter interrupts when it overflows, so it starts `period` events away from that.
+        // Only the lower 32 bits of a counter can be written, they are sign extended into the rest.
+        MSR(IA32_PMC0 + i).set(-counter.period);
+        MSR(IA32_PERFEVTSEL0 + i).set(counter.event_select | (counter.unit_mask << 8) | PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_INT | PERFEVTSEL_EN);
+        enabled_counters |= 1ull << i;
+    }
+    MSR(IA32_PERF_GLOBAL_OVF_CTRL).set(enabled_counters);
+    APIC::the().enable_performance_counter_nmi();
+    MSR(IA32_PERF_GLOBAL_CTRL).set(enabled_counters);
+}
+
+static void stop_counters_on_current_processor()
+{
+    MSR(IA32_PERF_GLOBAL_CTRL).set(0);
+    APIC::the().disable_performance_counter_nmi();
+    for (size_t i = 0; i < s_counter_count; ++i)
+        MSR(IA32_PERFEVTSEL0 + i).set(0);
+}
+
+static void for_each_processor(void (*callback)())
+{
+    ScopedCritical critical;
+    for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+        if (cpu == Processor::current_id())
+            callback();
+        else
+            Processor::smp_unicast(cpu, [callback] { callback(); }, false);
+    }
+}
+
+ErrorOr<void> PerformanceCounters::enable(u64 event_mask)
+{
+    event_mask &= PerformanceCounters::event_mask;
+    VERIFY(event_mask != 0);
+
+    SpinlockLocker lock(s_lock);
+    if (s_enable_count > 0) {
+        if (event_mask != s_enabled_events)
+            return EBUSY;
+        ++s_enable_count;
+        return {};
+    }
+
+    if (!is_supported(event_mask))
+        return ENOTSUP;
+
+    size_t counter_count = 0;
+    for (auto const& event : s_architectural_events) {
+        if ((event_mask & event.type) != 0)
+            s_counters[counter_count++] = event;
+    }
+    s_counter_count = counter_count;
+    s_enabled_events = event_mask;
+    s_enable_count = 1;
+    for_each_processor(start_counters_on_current_processor);
+    return {};
+}
+
+void PerformanceCounters::disable()
+{
+    SpinlockLocker lock(s_lock);
+    VERIFY(s_enable_count > 0);
+    if (--s_enable_count > 0)
+        return;
+    for_each_processor(stop_counters_on_current_processor);
+    s_counter_count = 0;
+    s_enabled_events = 0;
+}
+
+bool PerformanceCounters::handle_overflow(RegisterState const& regs)
+{
+    size_t counter_count = s_counter_count;
+    if (counter_count == 0)
+        return false;
+
+    u64 overflowed = MSR(IA32_PERF_GLOBAL_STATUS).get() & ((1ull << counter_count) - 1);
+    if (overflowed == 0)
+        return false;
+
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < counter_count; ++i) {
+        if ((overflowed & (1ull << i)) == 0)
+            continue;
+        auto const& counter = s_counters[i];
+        MSR(IA32_PMC0 + i).set(-counter.period);
+        if (current_thread)
+            PerformanceManager::add_performance_counter_event(*current_thread, regs, counter.type, counter.period);
+    }
+    MSR(IA32_PERF_GLOBAL_OVF_CTRL).set(overflowed);
+    APIC::the().enable_performance_counter_nmi();
+    return true;
+}
+
+}
@@ -624,6 +624,7 @@ UNMAP_AFTER_INIT void Processor::early_initialize(u32 cpu)
     m_info = nullptr;
 
     m_halt_requested = false;
+    m_active_cr3 = read_cr3();
     if (cpu == 0) {
         s_smp_enabled = false;
         g_total_processors.store(1u, AK::MemoryOrder::memory_order_release);
@@ -1002,6 +1003,14 @@ void Processor::check_invoke_scheduler()
 
 void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 {
+    // Past a certain size, reloading cr3 is cheaper than invalidating page by page.
+    // This doesn't drop global (kernel) translations, so only do it for user ranges.
+    static constexpr size_t full_flush_threshold = 64;
+    if (page_count > full_flush_threshold && Memory::is_user_address(vaddr)) {
+        flush_entire_tlb_local();
+        return;
+    }
+
     auto ptr = vaddr.as_ptr();
     while (page_count > 0) {
         // clang-format off
@@ -1017,10 +1026,22 @@ void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 
 void Processor::flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
 {
-    if (s_smp_enabled && (!Memory::is_user_address(vaddr) || Process::current().thread_count() > 1))
-        smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
-    else
-        flush_tlb_local(vaddr, page_count);
+    TLBFlushRange range { vaddr, page_count };
+    flush_tlb(page_directory, { &range, 1 });
+}
+
+void Processor::flush_tlb(Memory::PageDirectory const* page_directory, Span<TLBFlushRange const> ranges)
+{
+    if (ranges.is_empty())
+        return;
+
+    if (s_smp_enabled) {
+        smp_broadcast_flush_tlb(page_directory, ranges);
+        return;
+    }
+
+    for (auto const& range : ranges)
+        flush_tlb_local(range.vaddr, range.page_count);
 }
 
 void Processor::smp_return_to_pool(ProcessorMessage& msg)
@@ -1180,16 +1201,20 @@ bool Processor::smp_process_pending_messages()
                 msg->invoke_callback();
                 break;
             case ProcessorMessage::FlushTlb:
-                if (Memory::is_user_address(VirtualAddress(msg->flush_tlb.ptr))) {
-                    // We assume that we don't cross into kernel land!
-                    VERIFY(Memory::is_user_range(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count * PAGE_SIZE));
-                    if (read_cr3() != msg->flush_tlb.page_directory->cr3()) {
-                        // This processor isn't using this page directory right now, we can ignore this request
-                        dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} pages at {}", current_id(), msg->flush_tlb.page_count, VirtualAddress(msg->flush_tlb.ptr));
-                        break;
+                for (size_t i = 0; i < msg->flush_tlb.range_count; ++i) {
+                    auto vaddr = VirtualAddress(msg->flush_tlb.ranges[i].ptr);
+                    auto page_count = msg->flush_tlb.ranges[i].page_count;
+                    if (Memory::is_user_address(vaddr)) {
+                        // We assume that we don't cross into kernel land!
+                        VERIFY(Memory::is_user_range(vaddr, page_count * PAGE_SIZE));
+                        if (read_cr3() != msg->flush_tlb.page_directory->cr3()) {
+                            // This processor has switched away from this page directory since the request was sent, we can ignore it
+                            dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} pages at {}", current_id(), page_count, vaddr);
+                            continue;
+                        }
                     }
+                    flush_tlb_local(vaddr, page_count);
                 }
-                flush_tlb_local(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count);
                 break;
             }
 
@@ -1259,6 +1284,27 @@ void Processor::smp_broadcast_message(ProcessorMessage& msg)
         APIC::the().broadcast_ipi();
 }
 
+bool Processor::smp_multicast_message(u64 cpu_mask, ProcessorMessage& msg)
+{
+    auto& current_processor = Processor::current();
+    cpu_mask &= ~(1ull << current_processor.id());
+    if (cpu_mask == 0)
+        return false;
+
+    dbgln_if(SMP_DEBUG, "SMP[{}]: Multicast message {} to cpu mask {:#x}", current_processor.id(), VirtualAddress(&msg), cpu_mask);
+
+    msg.refs.store(popcount(cpu_mask), AK::MemoryOrder::memory_order_release);
+    for_each(
+        [&](Processor& proc) {
+            if (!(cpu_mask & (1ull << proc.id())))
+                return;
+            // Only interrupt processors that didn't already have messages pending.
+            if (proc.smp_enqueue_message(msg))
+                APIC::the().send_ipi(proc.id());
+        });
+    return true;
+}
+
 void Processor::smp_broadcast_wait_sync(ProcessorMessage& msg)
 {
     auto& cur_proc = Processor::current();
@@ -1317,19 +1363,64 @@ void Processor::smp_unicast(u32 cpu, Function<void()> callback, bool async)
     smp_unicast_message(cpu, msg, async);
 }
 
-void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
+void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_directory, Span<TLBFlushRange const> ranges)
 {
-    auto& msg = smp_get_from_pool();
-    msg.async = false;
-    msg.type = ProcessorMessage::FlushTlb;
-    msg.flush_tlb.page_directory = page_directory;
-    msg.flush_tlb.ptr = vaddr.as_ptr();
-    msg.flush_tlb.page_count = page_count;
-    smp_broadcast_message(msg);
-    // While the other processors handle this request, we'll flush ours
-    flush_tlb_local(vaddr, page_count);
-    // Now wait until everybody is done as well
-    smp_broadcast_wait_sync(msg);
+    // Kernel mappings are shared by every page directory, so those have to be flushed everywhere.
+    // A batch never mixes kernel and user ranges.
+    bool is_user = Memory::is_user_address(ranges[0].vaddr);
+    for (auto const& range : ranges)
+        VERIFY(Memory::is_user_address(range.vaddr) == is_user);
+
+    u64 cpu_mask = 0;
+    bool flush_local = true;
+    if (is_user) {
+        // Make sure our page table updates are visible before looking at which
+        // processors have this page directory loaded. A processor that loads it
+        // after this point will not have any stale translations cached.
+        atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+        auto cr3 = page_directory->cr3();
+        for_each(
+            [&](Processor& proc) {
+                if (proc.m_active_cr3.load(AK::MemoryOrder::memory_order_seq_cst) == cr3)
+                    cpu_mask |= 1ull << proc.id();
+            });
+        flush_local = cpu_mask & (1ull << current_id());
+    } else {
+        for_each(
+            [&](Processor& proc) {
+                cpu_mask |= 1ull << proc.id();
+            });
+    }
+
+    while (!ranges.is_empty()) {
+        auto batch = ranges.trim(ProcessorMessage::max_tlb_flush_ranges);
+        ranges = ranges.slice(batch.size());
+
+        auto& msg = smp_get_from_pool();
+        msg.async = false;
+        msg.type = ProcessorMessage::FlushTlb;
+        msg.flush_tlb.page_directory = page_directory;
+        msg.flush_tlb.range_count = batch.size();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            msg.flush_tlb.ranges[i].ptr = bit_cast<u8*>(batch[i].vaddr.get());
+            msg.flush_tlb.ranges[i].page_count = batch[i].page_count;
+        }
+        bool did_send = smp_multicast_message(cpu_mask, msg);
+
+        // While the other processors handle this request, we'll flush ours
+        if (flush_local) {
+            for (auto const& range : batch)
+                flush_tlb_local(range.vaddr, range.page_count);
+        }
+
+        // Now wait until everybody is done as well
+        if (did_send) {
+            smp_broadcast_wait_sync(msg);
+        } else {
+            smp_cleanup_message(msg);
+            smp_return_to_pool(msg);
+        }
+    }
 }
 
 void Processor::smp_broadcast_halt()
@@ -1621,7 +1712,7 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
 #endif
 
     if (from_regs.cr3 != to_regs.cr3)
-        write_cr3(to_regs.cr3);
+        Processor::activate_cr3(to_regs.cr3);
 
     to_thread->set_cpu(processor.id());
 
@@ -37,6 +37,14 @@ ProcessorInfo::ProcessorInfo(Processor const& processor)
         m_display_model = model;
     }
 
+    // NOTE: The initial APIC ID in CPUID 01 is only 8 bits wide, the x2APIC topology leaf has all of it.
+    m_physical_apic_id = cpuid.ebx() >> 24;
+    if (CPUID(0).eax() >= 0xb) {
+        CPUID topology(0xb);
+        if (topology.ebx() != 0)
+            m_physical_apic_id = topology.edx();
+    }
+
     // NOTE: Intel exposes detailed CPU's cache information in CPUID 04. On the
     // other hand, AMD uses CPUID's extended function set.
     if (m_vendor_id_string->view() == s_amd_vendor_id)
@@ -56,7 +56,11 @@
 #include <Kernel/TTY/PTYMultiplexer.h>
 #include <Kernel/TTY/VirtualConsole.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/IORingTask.h>
+#include <Kernel/Tasks/MemoryCompressionTask.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
 #include <Kernel/Tasks/SyncTask.h>
+#include <Kernel/Tasks/WriteBackTask.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/WorkQueue.h>
 #include <Kernel/kstdio.h>
@@ -230,6 +234,7 @@ extern "C" [[noreturn]] UNMAP_AFTER_INIT void init(BootInfo const& boot_info)
 
     InterruptManagement::initialize();
     ACPI::initialize();
+    MM.initialize_numa_topology();
 
     // Initialize TimeManagement before using randomness!
     TimeManagement::initialize(0);
@@ -300,8 +305,6 @@ void init_stage2(void*)
     // The colonel process gets away without having to do this because it never exits.
     Process::register_new(Process::current());
 
-    WorkQueue::initialize();
-
     if (kernel_command_line().is_smp_enabled() && APIC::initialized() && APIC::the().enabled_processor_count() > 1) {
         // We can't start the APs until we have a scheduler up and running.
         // We need to be able to process ICI messages, otherwise another
@@ -310,6 +313,9 @@ void init_stage2(void*)
         APIC::the().boot_aps();
     }
 
+    // NOTE: The work queues have a pool of workers for every processor, so they have to wait until all of them are up.
+    WorkQueue::initialize();
+
     // Initialize the PCI Bus as early as possible, for early boot (PCI based) serial logging
     PCI::initialize();
     if (!PCI::Access::is_disabled()) {
@@ -331,7 +337,11 @@ void init_stage2(void*)
     ConsoleManagement::the().initialize();
 
     SyncTask::spawn();
+    WriteBackTask::spawn();
     FinalizerTask::spawn();
+    IORingTask::spawn();
+    PageZeroingTask::spawn();
+    MemoryCompressionTask::spawn();
 
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
 
@@ -316,4 +316,33 @@ UNMAP_AFTER_INIT size_t CommandLine::switch_to_tty() const
     }
     PANIC("Invalid default tty value: {}", default_tty);
 }
+
+UNMAP_AFTER_INIT size_t CommandLine::fault_around_pages() const
+{
+    auto const value = lookup("fault_around_pages"sv).value_or("16"sv);
+    auto pages = value.to_uint();
+    if (pages.has_value() && pages.value() >= 1 && pages.value() <= 64 && is_power_of_two(pages.value()))
+        return pages.value();
+    PANIC("Invalid fault_around_pages value: {}", value);
+}
+
+size_t CommandLine::plan9fs_attribute_timeout_ms() const
+{
+    // Note: This is not UNMAP_AFTER_INIT, as 9P file systems are mounted long after boot.
+    auto const value = lookup("plan9fs_attribute_timeout_ms"sv).value_or("1000"sv);
+    if (auto milliseconds = value.to_uint(); milliseconds.has_value())
+        return milliseconds.value();
+    dmesgln("Invalid plan9fs_attribute_timeout_ms value: {}, using the default", value);
+    return 1000;
+}
+
+UNMAP_AFTER_INIT NUMAPolicy CommandLine::numa_policy() const
+{
+    auto const numa_policy = lookup("numa_policy"sv).value_or("first-touch"sv);
+    if (numa_policy == "first-touch"sv)
+        return NUMAPolicy::FirstTouch;
+    if (numa_policy == "interleave"sv)
+        return NUMAPolicy::Interleave;
+    PANIC("Unknown NUMAPolicy: {}", numa_policy);
+}
 }
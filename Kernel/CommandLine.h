@@ -43,6 +43,11 @@ enum class AHCIResetMode {
     Aggressive,
 };
 
+enum class NUMAPolicy {
+    FirstTouch,
+    Interleave,
+};
+
 class CommandLine {
 
 public:
@@ -94,6 +99,9 @@ public:
     [[nodiscard]] StringView root_device() const;
     [[nodiscard]] bool is_nvme_polling_enabled() const;
     [[nodiscard]] size_t switch_to_tty() const;
+    [[nodiscard]] size_t fault_around_pages() const;
+    [[nodiscard]] size_t plan9fs_attribute_timeout_ms() const;
+    [[nodiscard]] NUMAPolicy numa_policy() const;
 
 private:
     CommandLine(StringView);
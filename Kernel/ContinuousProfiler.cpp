@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Optional.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Singleton.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Arch/RegisterState.h>
+#include <Kernel/ContinuousProfiler.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/PerformanceEventBuffer.h>
+#include <Kernel/Process.h>
+#include <Kernel/Scheduler.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Thread.h>
+
+namespace Kernel {
+
+// Room for the process_create, thread_create and mmap events of all processes that are alive while draining.
+static constexpr size_t process_events_buffer_size = 4 * MiB;
+
+struct ProcessorSamples {
+    // Taken by the processor's timer interrupt, so it must never be held for long.
+    Spinlock lock { LockRank::None };
+    OwnPtr<PerformanceEventBuffer> samples;
+    // Swapped with the samples while draining, so that we can serialize them without holding the lock.
+    OwnPtr<PerformanceEventBuffer> drained_samples;
+    u32 ticks_until_sample { ContinuousProfiler::scheduler_ticks_per_sample };
+};
+
+struct ContinuousProfilerState {
+    // Serializes enabling, disabling, freeing and draining.
+    Mutex control_lock { "ContinuousProfiler"sv };
+    Array<ProcessorSamples, KERNEL_MAX_CPU_COUNT> processors;
+};
+
+static Singleton<ContinuousProfilerState> s_state;
+static Atomic<bool> s_enabled { false };
+
+bool ContinuousProfiler::is_enabled()
+{
+    return s_enabled.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+ErrorOr<void> ContinuousProfiler::enable()
+{
+    MutexLocker locker(s_state->control_lock);
+    if (is_enabled())
+        return EBUSY;
+
+    for (u32 i = 0; i < Processor::count(); ++i) {
+        auto& processor = s_state->processors[i];
+        if (processor.samples) {
+            SpinlockLocker lock(processor.lock);
+            processor.samples->clear();
+            processor.drained_samples->clear();
+            continue;
+        }
+
+        auto samples = PerformanceEventBuffer::try_create_with_size(buffer_size_per_processor, PerformanceEventBuffer::WhenFull::OverwriteOldest);
+        auto drained_samples = PerformanceEventBuffer::try_create_with_size(buffer_size_per_processor, PerformanceEventBuffer::WhenFull::OverwriteOldest);
+        if (!samples || !drained_samples)
+            return ENOMEM;
+
+        SpinlockLocker lock(processor.lock);
+        processor.samples = move(samples);
+        processor.drained_samples = move(drained_samples);
+    }
+
+    // The process events are only generated while draining, but they are subject to the event mask as well.
+    g_profiling_event_mask = PERF_EVENT_SAMPLE | PERF_EVENT_PROCESS_CREATE | PERF_EVENT_THREAD_CREATE | PERF_EVENT_MMAP;
+    s_enabled.store(true, AK::MemoryOrder::memory_order_release);
+    return {};
+}
+
+ErrorOr<void> ContinuousProfiler::disable()
+{
+    MutexLocker locker(s_state->control_lock);
+    if (!is_enabled())
+        return EINVAL;
+    s_enabled.store(false, AK::MemoryOrder::memory_order_release);
+    return {};
+}
+
+ErrorOr<void> ContinuousProfiler::free_buffers()
+{
+    MutexLocker locker(s_state->control_lock);
+    if (is_enabled())
+        return EINVAL;
+
+    for (u32 i = 0; i < Processor::count(); ++i) {
+        auto& processor = s_state->processors[i];
+        OwnPtr<PerformanceEventBuffer> samples;
+        OwnPtr<PerformanceEventBuffer> drained_samples;
+        {
+            SpinlockLocker lock(processor.lock);
+            samples = move(processor.samples);
+            drained_samples = move(processor.drained_samples);
+        }
+    }
+    return {};
+}
+
+void ContinuousProfiler::timer_tick(Thread& current_thread, RegisterState const& regs)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    if (!is_enabled())
+        return;
+
+    auto& processor = s_state->processors[Processor::current_id()];
+    if (--processor.ticks_until_sample != 0)
+        return;
+    processor.ticks_until_sample = scheduler_ticks_per_sample;
+
+    // FIXME: Like the regular profiler, we don't collect samples while idle.
+    if (current_thread.is_idle_thread() || current_thread.is_profiling_suppressed())
+        return;
+
+    SpinlockLocker lock(processor.lock);
+    if (!processor.samples)
+        return;
+    [[maybe_unused]] auto rc = processor.samples->append_with_ip_and_bp(
+        current_thread.pid(), current_thread.tid(), regs, PERF_EVENT_SAMPLE, 0, 0, 0, {});
+}
+
+ErrorOr<void> ContinuousProfiler::drain(KBufferBuilder& builder)
+{
+    MutexLocker locker(s_state->control_lock);
+    auto& processors = s_state->processors;
+    if (!processors[0].samples)
+        return ENOENT;
+
+    size_t sample_count = 0;
+    for (u32 i = 0; i < Processor::count(); ++i) {
+        SpinlockLocker lock(processors[i].lock);
+        swap(processors[i].samples, processors[i].drained_samples);
+        sample_count += processors[i].drained_samples->count();
+    }
+    ScopeGuard clear_drained_samples = [&] {
+        for (u32 i = 0; i < Processor::count(); ++i)
+            processors[i].drained_samples->clear();
+    };
+
+    auto events = PerformanceEventBuffer::try_create_with_size(process_events_buffer_size + sample_count * sizeof(PerformanceEvent));
+    if (!events)
+        return ENOMEM;
+
+    // The samples only refer to processes by their ID, so we describe the processes as they are now. This means that
+    // samples from processes that have exited in the meantime can't be symbolicated, but it keeps the ring buffers
+    // from ever having to hold on to the (much less frequent) process events.
+    // If there are too many of them, we rather have a profile with a few unsymbolicated samples than none at all.
+    (void)events->add_process(*Scheduler::colonel(), ProcessEventType::Create);
+    TRY(Process::for_each_in_same_jail([&](auto& process) -> ErrorOr<void> {
+        (void)events->add_process(process, ProcessEventType::Create);
+        return {};
+    }));
+
+    // Every processor's samples are already in order, so we merge them by their timestamp.
+    Array<size_t, KERNEL_MAX_CPU_COUNT> next_sample_index {};
+    while (true) {
+        Optional<u32> processor_with_oldest_sample;
+        u64 oldest_timestamp = 0;
+        for (u32 i = 0; i < Processor::count(); ++i) {
+            auto const& samples = *processors[i].drained_samples;
+            if (next_sample_index[i] >= samples.count())
+                continue;
+            auto timestamp = samples.at(next_sample_index[i]).timestamp;
+            if (!processor_with_oldest_sample.has_value() || timestamp < oldest_timestamp) {
+                processor_with_oldest_sample = i;
+                oldest_timestamp = timestamp;
+            }
+        }
+        if (!processor_with_oldest_sample.has_value())
+            break;
+
+        auto i = processor_with_oldest_sample.value();
+        auto const& samples = *processors[i].drained_samples;
+        TRY(events->append_event(samples.at(next_sample_index[i]++)));
+    }
+
+    return events->to_json(builder);
+}
+
+}
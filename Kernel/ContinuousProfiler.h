@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+class KBufferBuilder;
+class Thread;
+struct RegisterState;
+
+// Samples every processor at a low rate into a ring buffer per processor, so that there always is a record of
+// the last few minutes of what the system was doing. Userspace drains it by reading /sys/kernel/continuous_profile.
+class ContinuousProfiler {
+public:
+    // The scheduler timer ticks at OPTIMAL_TICKS_PER_SECOND_RATE (250 Hz), so this samples each processor at 25 Hz.
+    static constexpr u32 scheduler_ticks_per_sample = 10;
+    // About four and a half minutes of samples.
+    static constexpr size_t buffer_size_per_processor = 4 * MiB;
+
+    static bool is_enabled();
+    static ErrorOr<void> enable();
+    static ErrorOr<void> disable();
+    static ErrorOr<void> free_buffers();
+
+    // Called on every processor from the scheduler timer interrupt.
+    static void timer_tick(Thread& current_thread, RegisterState const&);
+
+    // Writes the samples taken since the last drain as perfcore JSON, preceded by the processes that are alive now.
+    static ErrorOr<void> drain(KBufferBuilder&);
+};
+
+}
@@ -21,6 +21,8 @@
 #include <LibELF/Core.h>
 
 #define INCLUDE_USERSPACE_HEAP_MEMORY_IN_COREDUMPS 0
+#define INCLUDE_FILE_BACKED_READ_ONLY_MEMORY_IN_COREDUMPS 0
+#define INCLUDE_VOLATILE_MEMORY_IN_COREDUMPS 0
 
 namespace Kernel {
 
@@ -29,6 +31,24 @@ bool Coredump::FlatRegionData::looks_like_userspace_heap_region() const
     return name().starts_with("LibJS:"sv) || name().starts_with("malloc:"sv);
 }
 
+// Regions like this still get a program header and show up in the notes, they just have no data in the file.
+bool Coredump::FlatRegionData::should_omit_contents() const
+{
+#if !INCLUDE_FILE_BACKED_READ_ONLY_MEMORY_IN_COREDUMPS
+    // The text and read-only data of executables and libraries can be read back from their files.
+    if (m_is_inode_backed && !m_is_writable)
+        return true;
+#endif
+
+#if !INCLUDE_VOLATILE_MEMORY_IN_COREDUMPS
+    // The process has already agreed to lose the contents of volatile memory at any time.
+    if (m_is_volatile)
+        return true;
+#endif
+
+    return false;
+}
+
 bool Coredump::FlatRegionData::is_consistent_with_region(Memory::Region const& region) const
 {
     if (m_access != region.access())
@@ -99,7 +119,8 @@ ErrorOr<NonnullLockRefPtr<OpenFileDescription>> Coredump::try_create_target_file
         Process::current().credentials(),
         KLexicalPath::basename(output_path),
         O_CREAT | O_WRONLY | O_EXCL,
-        S_IFREG, // We will enable reading from userspace when we finish generating the coredump file
+        // CrashDaemon can start compressing while we write, and knows that we're done once the file becomes writable.
+        S_IFREG | 0400,
         *dump_directory,
         UidAndGid { process_credentials->uid(), process_credentials->gid() }));
 }
@@ -174,7 +195,7 @@ ErrorOr<void> Coredump::write_program_headers(size_t notes_size)
         phdr.p_vaddr = region.vaddr().get();
         phdr.p_paddr = 0;
 
-        phdr.p_filesz = region.page_count() * PAGE_SIZE;
+        phdr.p_filesz = region.should_omit_contents() ? 0 : region.page_count() * PAGE_SIZE;
         phdr.p_memsz = region.page_count() * PAGE_SIZE;
         phdr.p_align = 0;
 
@@ -208,6 +229,10 @@ ErrorOr<void> Coredump::write_regions()
 {
     u8 zero_buffer[PAGE_SIZE] = {};
 
+    // Regions are copied and written a few pages at a time, so that even huge ones don't need a kernel buffer of their size.
+    constexpr size_t pages_per_write = 16;
+    auto buffer = TRY(KBuffer::try_create_with_size("Coredump Region Copy Buffer"sv, pages_per_write * PAGE_SIZE));
+
     for (auto& region : m_regions) {
         VERIFY(!region.is_kernel());
 
@@ -219,39 +244,49 @@ ErrorOr<void> Coredump::write_regions()
         if (region.access() == Memory::Region::Access::None)
             continue;
 
-        auto buffer = TRY(KBuffer::try_create_with_size("Coredump Region Copy Buffer"sv, region.page_count() * PAGE_SIZE));
-
-        TRY(m_process->address_space().with([&](auto& space) -> ErrorOr<void> {
-            auto* real_region = space->region_tree().regions().find(region.vaddr().get());
-
-            if (!real_region)
-                return Error::from_string_view("Failed to find matching region in the process"sv);
+        if (region.should_omit_contents())
+            continue;
 
-            if (!region.is_consistent_with_region(*real_region))
-                return Error::from_string_view("Found region does not match stored metadata"sv);
+        for (size_t first_page = 0; first_page < region.page_count(); first_page += pages_per_write) {
+            auto page_count = min(pages_per_write, region.page_count() - first_page);
+
+            TRY(m_process->address_space().with([&](auto& space) -> ErrorOr<void> {
+                auto* real_region = space->region_tree().regions().find(region.vaddr().get());
+
+                if (!real_region)
+                    return Error::from_string_view("Failed to find matching region in the process"sv);
+
+                if (!region.is_consistent_with_region(*real_region))
+                    return Error::from_string_view("Found region does not match stored metadata"sv);
+
+                // If we crashed in the middle of mapping in Regions, they do not have a page directory yet, and will crash on a remap() call
+                if (!real_region->is_mapped()) {
+                    memset(buffer->data(), 0, page_count * PAGE_SIZE);
+                    return {};
+                }
+
+                if (first_page == 0) {
+                    real_region->set_readable(true);
+                    real_region->remap();
+                }
+
+                for (size_t i = 0; i < page_count; i++) {
+                    auto page_index = first_page + i;
+                    auto page = real_region->physical_page(page_index);
+                    auto src_buffer = [&]() -> ErrorOr<UserOrKernelBuffer> {
+                        if (page || real_region->is_page_compressed(page_index))
+                            return UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region.vaddr().as_ptr() + (page_index * PAGE_SIZE))), PAGE_SIZE);
+                        // If the current page is not backed by a physical page, we zero it in the coredump file.
+                        return UserOrKernelBuffer::for_kernel_buffer(zero_buffer);
+                    }();
+                    TRY(src_buffer.value().read(buffer->bytes().slice(i * PAGE_SIZE, PAGE_SIZE)));
+                }
 
-            // If we crashed in the middle of mapping in Regions, they do not have a page directory yet, and will crash on a remap() call
-            if (!real_region->is_mapped())
                 return {};
+            }));
 
-            real_region->set_readable(true);
-            real_region->remap();
-
-            for (size_t i = 0; i < region.page_count(); i++) {
-                auto page = real_region->physical_page(i);
-                auto src_buffer = [&]() -> ErrorOr<UserOrKernelBuffer> {
-                    if (page)
-                        return UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region.vaddr().as_ptr() + (i * PAGE_SIZE))), PAGE_SIZE);
-                    // If the current page is not backed by a physical page, we zero it in the coredump file.
-                    return UserOrKernelBuffer::for_kernel_buffer(zero_buffer);
-                }();
-                TRY(src_buffer.value().read(buffer->bytes().slice(i * PAGE_SIZE, PAGE_SIZE)));
-            }
-
-            return {};
-        }));
-
-        TRY(m_description->write(UserOrKernelBuffer::for_kernel_buffer(buffer->data()), buffer->size()));
+            TRY(m_description->write(UserOrKernelBuffer::for_kernel_buffer(buffer->data()), page_count * PAGE_SIZE));
+        }
     }
 
     return {};
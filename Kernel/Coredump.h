@@ -11,6 +11,7 @@
 #include <AK/Vector.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/Region.h>
 
 namespace Kernel {
@@ -28,8 +29,10 @@ private:
         explicit FlatRegionData(Memory::Region const& region, NonnullOwnPtr<KString> name)
             : m_access(region.access())
             , m_is_executable(region.is_executable())
+            , m_is_inode_backed(region.vmobject().is_inode())
             , m_is_kernel(region.is_kernel())
             , m_is_readable(region.is_readable())
+            , m_is_volatile(region.vmobject().is_anonymous() && static_cast<Memory::AnonymousVMObject const&>(region.vmobject()).is_volatile())
             , m_is_writable(region.is_writable())
             , m_name(move(name))
             , m_page_count(region.page_count())
@@ -49,13 +52,16 @@ private:
         auto vaddr() const { return m_vaddr; }
 
         bool looks_like_userspace_heap_region() const;
+        bool should_omit_contents() const;
         bool is_consistent_with_region(Memory::Region const& region) const;
 
     private:
         Memory::Region::Access m_access;
         bool m_is_executable;
+        bool m_is_inode_backed;
         bool m_is_kernel;
         bool m_is_readable;
+        bool m_is_volatile;
         bool m_is_writable;
         NonnullOwnPtr<KString> m_name;
         size_t m_page_count;
@@ -72,7 +72,19 @@ public:
         start();
     }
 
+    // This is for requests that are carried out as part of another request, instead of being started themselves.
+    // Whoever started the other request has to complete this one as well.
+    [[nodiscard]] bool mark_as_started()
+    {
+        SpinlockLocker lock(m_lock);
+        if (is_completed_result(m_result))
+            return false;
+        m_result = Started;
+        return true;
+    }
+
     void complete(RequestResult result);
+    RequestResult get_request_result() const;
 
     void set_private(void* priv)
     {
@@ -120,8 +132,6 @@ public:
 protected:
     AsyncDeviceRequest(Device&);
 
-    RequestResult get_request_result() const;
-
 private:
     void sub_request_finished(AsyncDeviceRequest&);
     void request_finished();
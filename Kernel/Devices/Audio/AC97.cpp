@@ -198,6 +198,26 @@ ErrorOr<u32> AC97::get_pcm_output_sample_rate(size_t channel_index)
     return m_sample_rate;
 }
 
+ErrorOr<void> AC97::set_pcm_output_buffer_count(size_t channel_index, u32 buffer_count)
+{
+    if (channel_index != 0)
+        return ENODEV;
+    // With a single buffer, the DMA engine would run dry every time we refill it.
+    if (buffer_count < 2 || buffer_count > m_output_buffer_page_count)
+        return EINVAL;
+
+    InterruptDisabler disabler;
+    m_output_buffer_queue_limit = buffer_count;
+    return {};
+}
+
+ErrorOr<u32> AC97::get_pcm_output_buffer_count(size_t channel_index)
+{
+    if (channel_index != 0)
+        return Error::from_errno(ENODEV);
+    return m_output_buffer_queue_limit;
+}
+
 ErrorOr<size_t> AC97::write(size_t channel_index, UserOrKernelBuffer const& data, size_t length)
 {
     if (channel_index != 0)
@@ -248,7 +268,7 @@ ErrorOr<void> AC97::write_single_buffer(UserOrKernelBuffer const& data, size_t o
             }
 
             // There is room for our data
-            if (head_distance < m_output_buffer_page_count)
+            if (head_distance < m_output_buffer_queue_limit)
                 break;
 
             dbgln_if(AC97_DEBUG, "AC97 @ {}: waiting on interrupt - status: {:#05b} CI: {} LVI: {}", pci_address(), pcm_out_status, current_index, last_valid_index);
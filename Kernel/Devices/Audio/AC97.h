@@ -168,6 +168,8 @@ private:
     virtual void detect_hardware_audio_channels(Badge<AudioManagement>) override;
     virtual ErrorOr<void> set_pcm_output_sample_rate(size_t channel_index, u32 samples_per_second_rate) override;
     virtual ErrorOr<u32> get_pcm_output_sample_rate(size_t channel_index) override;
+    virtual ErrorOr<void> set_pcm_output_buffer_count(size_t channel_index, u32 buffer_count) override;
+    virtual ErrorOr<u32> get_pcm_output_buffer_count(size_t channel_index) override;
 
     OwnPtr<Memory::Region> m_buffer_descriptor_list;
     u8 m_buffer_descriptor_list_index { 0 };
@@ -179,6 +181,8 @@ private:
     OwnPtr<Memory::Region> m_output_buffer;
     u8 m_output_buffer_page_count { 4 };
     u8 m_output_buffer_page_index { 0 };
+    // How many of the output buffer pages may be queued for playback at once.
+    u8 m_output_buffer_queue_limit { 4 };
     NonnullOwnPtr<AC97Channel> m_pcm_out_channel;
     u32 m_sample_rate { 0 };
     bool m_variable_rate_pcm_supported { false };
@@ -45,6 +45,16 @@ ErrorOr<void> AudioChannel::ioctl(OpenFileDescription&, unsigned request, Usersp
         TRY(controller->set_pcm_output_sample_rate(m_channel_index, sample_rate));
         return {};
     }
+    case SOUNDCARD_IOCTL_GET_OUTPUT_BUFFER_COUNT: {
+        auto output = static_ptr_cast<u32*>(arg);
+        u32 buffer_count = TRY(controller->get_pcm_output_buffer_count(m_channel_index));
+        return copy_to_user(output, &buffer_count);
+    }
+    case SOUNDCARD_IOCTL_SET_OUTPUT_BUFFER_COUNT: {
+        auto buffer_count = static_cast<u32>(arg.ptr());
+        TRY(controller->set_pcm_output_buffer_count(m_channel_index, buffer_count));
+        return {};
+    }
     default:
         return EINVAL;
     }
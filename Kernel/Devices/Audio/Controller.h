@@ -39,6 +39,11 @@ public:
     // Note: The return value is rate of samples per second
     virtual ErrorOr<u32> get_pcm_output_sample_rate(size_t channel_index) = 0;
 
+    // The number of buffers (i.e. write() calls of up to a page each) that the device queues up for playback before
+    // writes block. Fewer buffers mean lower latency, at the risk of underruns if the writer can't keep up.
+    virtual ErrorOr<void> set_pcm_output_buffer_count(size_t channel_index, u32 buffer_count) = 0;
+    virtual ErrorOr<u32> get_pcm_output_buffer_count(size_t channel_index) = 0;
+
 private:
     IntrusiveListNode<AudioController, LockRefPtr<AudioController>> m_node;
 };
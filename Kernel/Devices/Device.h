@@ -56,16 +56,17 @@ public:
     ErrorOr<NonnullLockRefPtr<AsyncRequestType>> try_make_request(Args&&... args)
     {
         auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
-        SpinlockLocker lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
-        TRY(m_requests.try_append(request));
-        if (was_empty)
-            request->do_start(move(lock));
+        TRY(queue_request(request));
         return request;
     }
 
 protected:
     Device(MajorNumber major, MinorNumber minor);
+
+    // By default, requests are started one after another in the order they were made.
+    // Devices that know better can override these two to pick the order themselves.
+    virtual ErrorOr<void> queue_request(NonnullLockRefPtr<AsyncDeviceRequest>);
+    virtual void start_next_queued_request(AsyncDeviceRequest const& finished_request);
     void set_uid(UserID uid) { m_uid = uid; }
     void set_gid(GroupID gid) { m_gid = gid; }
 
@@ -5,9 +5,14 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Process.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/WorkQueue.h>
 
 namespace Kernel {
 
@@ -16,96 +21,386 @@ struct CacheEntry {
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_hashed { false };
+    u64 dirtied_at_ms { 0 };
+};
+
+// Cache blocks are allocated (and released) in segments, which lets every shard
+// of the cache grow and shrink along with the amount of free physical memory.
+struct DiskCacheSegment {
+    static constexpr size_t EntryCount = 256;
+
+    explicit DiskCacheSegment(NonnullOwnPtr<KBuffer> block_data)
+        : block_data(move(block_data))
+    {
+    }
+
+    NonnullOwnPtr<KBuffer> block_data;
+    CacheEntry entries[EntryCount];
 };
 
 class DiskCache {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
+    static constexpr size_t ShardCount = 8;
+    // Neighboring blocks are kept in the same shard, so that flushing a shard
+    // can write out contiguous runs of blocks.
+    static constexpr u64 BlocksPerShardStripe = 64;
+    static constexpr size_t MaxSegmentsPerShard = 32;
+
+    // Dirty blocks older than this are written back by the write-back task.
+    static constexpr u64 DirtyExpireMs = 1000;
+    // The write-back task starts writing back blocks early once this percentage of a shard is dirty.
+    static constexpr size_t BackgroundDirtyPercent = 10;
+    // Writers have to write back blocks themselves once this percentage of a shard is dirty,
+    // until it's down to BackgroundDirtyPercent again.
+    static constexpr size_t ThrottleDirtyPercent = 40;
+    // The longest run of contiguous blocks that is read or written with a single device request.
+    static constexpr size_t MaxRunLength = 16;
+
+    struct Shard {
+        mutable Mutex lock { "DiskCacheShard"sv };
+        // Ordered from least to most recently dirtied.
+        IntrusiveList<&CacheEntry::list_node> dirty_list;
+        size_t dirty_count { 0 };
+        // Ordered from most to least recently used.
+        IntrusiveList<&CacheEntry::list_node> clean_list;
+        HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> hash;
+        Vector<NonnullOwnPtr<DiskCacheSegment>> segments;
+        // Bounce buffer for reading and writing runs of contiguous blocks.
+        OwnPtr<KBuffer> run_buffer;
+        u64 hits { 0 };
+        u64 misses { 0 };
+
+        size_t capacity() const { return segments.size() * DiskCacheSegment::EntryCount; }
+        size_t dirty_limit(size_t percent) const { return capacity() * percent / 100; }
+    };
+
+    explicit DiskCache(BlockBasedFileSystem& fs)
         : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->block_size();
-            m_clean_list.append(entries()[i]);
-        }
     }
 
     ~DiskCache() = default;
 
-    bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+    ErrorOr<void> initialize()
+    {
+        for (auto& shard : m_shards)
+            TRY(grow(shard));
+        return {};
+    }
 
-    void mark_all_clean()
+    Shard& shard_for(BlockBasedFileSystem::BlockIndex block_index) const
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+        return m_shards[(block_index.value() / BlocksPerShardStripe) % ShardCount];
     }
 
-    void mark_dirty(CacheEntry& entry)
+    template<typename Callback>
+    void for_each_shard(Callback callback) const
     {
-        m_dirty_list.prepend(entry);
+        for (auto& shard : m_shards)
+            callback(shard);
     }
 
-    void mark_clean(CacheEntry& entry)
+    static bool entry_is_dirty(Shard& shard, CacheEntry const& entry) { return shard.dirty_list.contains(entry); }
+
+    static void mark_dirty(Shard& shard, CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        VERIFY(shard.lock.is_locked());
+        // NOTE: Re-dirtying an entry doesn't make it any younger, it still has to be written back on time.
+        if (entry_is_dirty(shard, entry))
+            return;
+        entry.dirtied_at_ms = TimeManagement::the().uptime_ms();
+        shard.dirty_list.append(entry);
+        ++shard.dirty_count;
     }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    static void mark_clean(Shard& shard, CacheEntry& entry)
     {
-        auto it = m_hash.find(block_index);
-        if (it == m_hash.end())
+        VERIFY(shard.lock.is_locked());
+        VERIFY(entry_is_dirty(shard, entry));
+        shard.clean_list.prepend(entry);
+        --shard.dirty_count;
+    }
+
+    static CacheEntry* get(Shard& shard, BlockBasedFileSystem::BlockIndex block_index)
+    {
+        VERIFY(shard.lock.is_locked());
+        auto it = shard.hash.find(block_index);
+        if (it == shard.hash.end())
             return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
+        auto& entry = *it->value;
         VERIFY(entry.block_index == block_index);
         return &entry;
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
+    ErrorOr<CacheEntry*> ensure(Shard& shard, BlockBasedFileSystem::BlockIndex block_index) const
     {
-        if (auto* entry = get(block_index))
+        VERIFY(shard.lock.is_locked());
+        if (auto* entry = get(shard, block_index)) {
+            ++shard.hits;
+            // Keep the clean list in LRU order. Dirty entries stay put until they're flushed.
+            if (!entry_is_dirty(shard, *entry))
+                shard.clean_list.prepend(*entry);
             return entry;
+        }
+        ++shard.misses;
+
+        // Unused entries sit at the end of the clean list, so if the least recently used entry
+        // holds data, the shard is full. Try to grow it before evicting anything.
+        auto* victim = shard.clean_list.last();
+        if ((!victim || victim->has_data) && can_grow(shard)) {
+            if (!grow(shard).is_error())
+                victim = shard.clean_list.last();
+        }
+
+        if (!victim) {
+            // Not a single clean entry! Flush this shard's writes and try again.
+            flush_shard(shard);
+            return ensure(shard, block_index);
+        }
+
+        shard.clean_list.prepend(*victim);
+        unhash(shard, *victim);
+        TRY(shard.hash.try_set(block_index, victim));
+        victim->is_hashed = true;
+        victim->block_index = block_index;
+        victim->has_data = false;
+        return victim;
+    }
+
+    // Pulls the given blocks into the cache, reading runs of contiguous uncached blocks with a single request each.
+    void read_ahead(Shard& shard, Span<BlockBasedFileSystem::BlockIndex const> blocks) const
+    {
+        VERIFY(shard.lock.is_locked());
+        Vector<CacheEntry*, MaxRunLength> run;
+        auto read_pending_run = [&] {
+            if (!run.is_empty())
+                read_run(shard, run.span());
+            run.clear_with_capacity();
+        };
+
+        for (auto block_index : blocks) {
+            if (auto* entry = get(shard, block_index); entry && entry->has_data) {
+                read_pending_run();
+                continue;
+            }
+            if (!run.is_empty() && (run.size() == MaxRunLength || run.last()->block_index.value() + 1 != block_index.value()))
+                read_pending_run();
+            auto entry_or_error = ensure(shard, block_index);
+            if (entry_or_error.is_error())
+                break;
+            run.append(entry_or_error.value());
+        }
+        read_pending_run();
+    }
+
+    void flush_shard(Shard& shard) const
+    {
+        VERIFY(shard.lock.is_locked());
+        write_back(shard, shard.dirty_count, NumericLimits<u64>::max());
+    }
 
-        if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
-            return ensure(block_index);
+    // Writes back the oldest `count` dirty entries of a shard, along with every other entry that was
+    // dirtied before `expired_before_ms`. Returns the number of blocks that were written back.
+    size_t write_back(Shard& shard, size_t count, u64 expired_before_ms) const
+    {
+        VERIFY(shard.lock.is_locked());
+
+        Vector<CacheEntry*> batch;
+        for (auto& entry : shard.dirty_list) {
+            if (batch.size() >= count && entry.dirtied_at_ms >= expired_before_ms)
+                break;
+            if (batch.try_append(&entry).is_error())
+                break;
+        }
+        if (batch.is_empty())
+            return 0;
+
+        // Sort by block index, so that we can write contiguous runs of blocks with a single write.
+        quick_sort(batch, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+
+        size_t run_start = 0;
+        while (run_start < batch.size()) {
+            size_t run_length = 1;
+            while (run_start + run_length < batch.size()
+                && run_length < MaxRunLength
+                && batch[run_start + run_length]->block_index.value() == batch[run_start]->block_index.value() + run_length)
+                ++run_length;
+            write_back_run(shard, batch.span().slice(run_start, run_length));
+            run_start += run_length;
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
+        for (auto* entry : batch)
+            mark_clean(shard, *entry);
+        return batch.size();
+    }
 
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
+    // Writes back dirty entries of a shard that are too old, or as many as needed to get it back below the background limit.
+    size_t write_back_in_background(Shard& shard) const
+    {
+        VERIFY(shard.lock.is_locked());
+        auto background_limit = shard.dirty_limit(BackgroundDirtyPercent);
+        auto excess = shard.dirty_count > background_limit ? shard.dirty_count - background_limit : 0;
+        auto now = TimeManagement::the().uptime_ms();
+        auto expired_before_ms = now > DirtyExpireMs ? now - DirtyExpireMs : 0;
+        return write_back(shard, excess, expired_before_ms);
+    }
 
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+    // Makes writers pay for the write-back themselves once a shard gets too dirty.
+    void throttle_writer_if_needed(Shard& shard) const
+    {
+        VERIFY(shard.lock.is_locked());
+        if (shard.dirty_count <= shard.dirty_limit(ThrottleDirtyPercent))
+            return;
+        write_back(shard, shard.dirty_count - shard.dirty_limit(BackgroundDirtyPercent), 0);
+    }
 
-        return &new_entry;
+    void flush_block_if_dirty(Shard& shard, BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        auto* entry = get(shard, block_index);
+        if (!entry || !entry_is_dirty(shard, *entry))
+            return;
+        auto base_offset = entry->block_index.value() * m_fs->block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+        (void)m_fs->file_description().write(base_offset, entry_data_buffer, m_fs->block_size());
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    // Gives the most recently grown segment of a shard back to the system.
+    // The shard must not have any dirty entries.
+    bool shrink(Shard& shard) const
+    {
+        VERIFY(shard.lock.is_locked());
+        VERIFY(shard.dirty_list.is_empty());
+        if (shard.segments.size() <= 1)
+            return false;
+        auto segment = shard.segments.take_last();
+        for (auto& entry : segment->entries) {
+            unhash(shard, entry);
+            entry.list_node.remove();
+        }
+        return true;
+    }
 
-    template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    BlockBasedFileSystem::CacheStatistics statistics() const
+    {
+        BlockBasedFileSystem::CacheStatistics statistics;
+        for (auto& shard : m_shards) {
+            MutexLocker locker(shard.lock);
+            statistics.hits += shard.hits;
+            statistics.misses += shard.misses;
+            statistics.cached_blocks += shard.hash.size();
+            statistics.capacity_blocks += shard.segments.size() * DiskCacheSegment::EntryCount;
+            statistics.dirty_blocks += shard.dirty_count;
+        }
+        return statistics;
+    }
+
+    static bool has_plenty_of_free_memory()
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        auto info = MM.get_system_memory_info();
+        auto committed_or_used = info.physical_pages_used + info.physical_pages_committed;
+        if (committed_or_used >= info.physical_pages)
+            return false;
+        // Always leave a quarter of physical memory to everyone else.
+        return info.physical_pages - committed_or_used > info.physical_pages / 4;
+    }
+
+    static bool is_low_on_memory()
+    {
+        auto info = MM.get_system_memory_info();
+        auto committed_or_used = info.physical_pages_used + info.physical_pages_committed;
+        if (committed_or_used >= info.physical_pages)
+            return true;
+        return info.physical_pages - committed_or_used < info.physical_pages / 16;
     }
 
 private:
+    void write_back_run(Shard& shard, Span<CacheEntry*> run) const
+    {
+        auto block_size = m_fs->block_size();
+        auto base_offset = run[0]->block_index.value() * block_size;
+
+        if (run.size() == 1 || !ensure_run_buffer(shard)) {
+            for (auto* entry : run) {
+                auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+                [[maybe_unused]] auto rc = m_fs->file_description().write(entry->block_index.value() * block_size, entry_data_buffer, block_size);
+            }
+            return;
+        }
+
+        // Gather the blocks into one buffer, so that the device sees a single large write.
+        for (size_t i = 0; i < run.size(); ++i)
+            memcpy(shard.run_buffer->data() + i * block_size, run[i]->data, block_size);
+        auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(shard.run_buffer->data());
+        [[maybe_unused]] auto rc = m_fs->file_description().write(base_offset, run_buffer, run.size() * block_size);
+    }
+
+    void read_run(Shard& shard, Span<CacheEntry*> run) const
+    {
+        auto block_size = m_fs->block_size();
+
+        if (run.size() == 1 || !ensure_run_buffer(shard)) {
+            for (auto* entry : run) {
+                auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+                auto nread_or_error = m_fs->file_description().read(entry_data_buffer, entry->block_index.value() * block_size, block_size);
+                if (nread_or_error.is_error() || nread_or_error.value() != block_size)
+                    return;
+                entry->has_data = true;
+            }
+            return;
+        }
+
+        // Read the whole run with a single request, then scatter it into the cache entries.
+        auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(shard.run_buffer->data());
+        auto nread_or_error = m_fs->file_description().read(run_buffer, run[0]->block_index.value() * block_size, run.size() * block_size);
+        if (nread_or_error.is_error() || nread_or_error.value() != run.size() * block_size)
+            return;
+        for (size_t i = 0; i < run.size(); ++i) {
+            memcpy(run[i]->data, shard.run_buffer->data() + i * block_size, block_size);
+            run[i]->has_data = true;
+        }
+    }
+
+    bool ensure_run_buffer(Shard& shard) const
+    {
+        if (shard.run_buffer)
+            return true;
+        auto buffer_or_error = KBuffer::try_create_with_size("BlockBasedFS: Run buffer"sv, MaxRunLength * m_fs->block_size());
+        if (buffer_or_error.is_error())
+            return false;
+        shard.run_buffer = buffer_or_error.release_value();
+        return true;
+    }
+
+    static void unhash(Shard& shard, CacheEntry& entry)
+    {
+        if (!entry.is_hashed)
+            return;
+        shard.hash.remove(entry.block_index);
+        entry.is_hashed = false;
+    }
+
+    static bool can_grow(Shard const& shard)
+    {
+        return shard.segments.size() < MaxSegmentsPerShard && has_plenty_of_free_memory();
+    }
+
+    ErrorOr<void> grow(Shard& shard) const
+    {
+        auto block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCacheSegment::EntryCount * m_fs->block_size()));
+        auto segment = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCacheSegment(move(block_data))));
+        TRY(shard.segments.try_ensure_capacity(shard.segments.size() + 1));
+        for (size_t i = 0; i < DiskCacheSegment::EntryCount; ++i) {
+            auto& entry = segment->entries[i];
+            entry.data = segment->block_data->data() + i * m_fs->block_size();
+            shard.clean_list.append(entry);
+        }
+        shard.segments.unchecked_append(move(segment));
+        return {};
+    }
+
     mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-    NonnullOwnPtr<KBuffer> m_entries;
+    mutable Array<Shard, ShardCount> m_shards;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -129,9 +424,8 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this)));
+    TRY(disk_cache->initialize());
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -152,28 +446,44 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
+        auto& shard = cache->shard_for(index);
+        MutexLocker locker(shard.lock);
+
         if (!allow_cache) {
-            flush_specific_block_if_needed(index);
+            cache->flush_block_if_dirty(shard, index);
             u64 base_offset = index.value() * block_size() + offset;
             auto nwritten = TRY(file_description().write(base_offset, data, count));
             VERIFY(nwritten == count);
             return {};
         }
 
-        auto entry = TRY(cache->ensure(index));
+        auto entry = TRY(cache->ensure(shard, index));
         if (count < block_size()) {
             // Fill the cache first.
-            TRY(read_block(index, nullptr, block_size()));
+            TRY(fill_cache_entry(*entry));
         }
         memcpy(entry->data + offset, buffered_data.data(), count);
 
-        cache->mark_dirty(*entry);
+        DiskCache::mark_dirty(shard, *entry);
         entry->has_data = true;
+        cache->throttle_writer_if_needed(shard);
         return {};
     });
 }
 
+ErrorOr<void> BlockBasedFileSystem::fill_cache_entry(CacheEntry& entry) const
+{
+    if (entry.has_data)
+        return {};
+    auto base_offset = entry.block_index.value() * block_size();
+    auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+    auto nread = TRY(file_description().read(entry_data_buffer, base_offset, block_size()));
+    VERIFY(nread == block_size());
+    entry.has_data = true;
+    return {};
+}
+
 ErrorOr<void> BlockBasedFileSystem::raw_read(BlockIndex index, UserOrKernelBuffer& buffer)
 {
     auto base_offset = index.value() * m_logical_block_size;
@@ -226,23 +536,20 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
+        auto& shard = cache->shard_for(index);
+        MutexLocker locker(shard.lock);
+
         if (!allow_cache) {
-            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
+            cache->flush_block_if_dirty(shard, index);
             u64 base_offset = index.value() * block_size() + offset;
             auto nread = TRY(file_description().read(*buffer, base_offset, count));
             VERIFY(nread == count);
             return {};
         }
 
-        auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, block_size()));
-            VERIFY(nread == block_size());
-            entry->has_data = true;
-        }
+        auto* entry = TRY(cache->ensure(shard, index));
+        TRY(fill_cache_entry(*entry));
         if (buffer)
             TRY(buffer->write(entry->data + offset, count));
         return {};
@@ -265,36 +572,72 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
-void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+void BlockBasedFileSystem::read_ahead(Vector<BlockIndex> blocks) const
 {
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        auto* entry = cache->get(index);
-        if (!entry)
-            return;
-        if (!cache->entry_is_dirty(*entry))
-            return;
-        size_t base_offset = entry->block_index.value() * block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, block_size());
+    if (blocks.is_empty())
+        return;
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_ahead {}, count={}", blocks.first(), blocks.size());
+
+    // NOTE: Read-ahead is only ever a hint, so if we can't queue it, we simply don't do it.
+    [[maybe_unused]] auto rc = g_io_work->try_queue([fs = NonnullRefPtr<BlockBasedFileSystem const>(*this), blocks = move(blocks)] {
+        fs->m_cache.with_shared([&](auto& cache) {
+            if (!cache)
+                return;
+            // Blocks that share a stripe live in the same shard, so hand them over in per-shard batches.
+            size_t batch_start = 0;
+            for (size_t i = 1; i <= blocks.size(); ++i) {
+                auto& shard = cache->shard_for(blocks[batch_start]);
+                if (i < blocks.size() && &cache->shard_for(blocks[i]) == &shard)
+                    continue;
+                MutexLocker locker(shard.lock);
+                cache->read_ahead(shard, blocks.span().slice(batch_start, i - batch_start));
+                batch_start = i;
+            }
+        });
     });
 }
 
 void BlockBasedFileSystem::flush_writes_impl()
 {
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
-            ++count;
+    size_t released_segments = 0;
+    m_cache.with_shared([&](auto& cache) {
+        bool should_shrink = DiskCache::is_low_on_memory();
+        cache->for_each_shard([&](auto& shard) {
+            MutexLocker locker(shard.lock);
+            count += shard.dirty_count;
+            cache->flush_shard(shard);
+            // If memory is getting tight, give back what this shard grew into while it was plentiful.
+            if (should_shrink && cache->shrink(shard))
+                ++released_segments;
         });
-        cache->mark_all_clean();
+    });
+    if (count > 0)
         dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+    if (released_segments > 0)
+        dbgln("{}: Released {} cache segments due to memory pressure", class_name(), released_segments);
+}
+
+void BlockBasedFileSystem::write_back_dirty_blocks()
+{
+    size_t count = 0;
+    m_cache.with_shared([&](auto& cache) {
+        if (!cache)
+            return;
+        cache->for_each_shard([&](auto& shard) {
+            MutexLocker locker(shard.lock);
+            count += cache->write_back_in_background(shard);
+        });
+    });
+    dbgln_if(BBFS_DEBUG, "{}: Wrote back {} blocks", class_name(), count);
+}
+
+BlockBasedFileSystem::CacheStatistics BlockBasedFileSystem::cache_statistics() const
+{
+    return m_cache.with_shared([&](auto& cache) -> CacheStatistics {
+        if (!cache)
+            return {};
+        return cache->statistics();
     });
 }
 
@@ -11,6 +11,8 @@
 
 namespace Kernel {
 
+struct CacheEntry;
+
 class BlockBasedFileSystem : public FileBackedFileSystem {
 public:
     AK_TYPEDEF_DISTINCT_ORDERED_ID(u64, BlockIndex);
@@ -22,6 +24,17 @@ public:
     virtual void flush_writes() override;
     void flush_writes_impl();
 
+    virtual void write_back_dirty_blocks() override;
+
+    struct CacheStatistics {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        size_t cached_blocks { 0 };
+        size_t capacity_blocks { 0 };
+        size_t dirty_blocks { 0 };
+    };
+    CacheStatistics cache_statistics() const;
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -30,6 +43,9 @@ protected:
     ErrorOr<void> read_block(BlockIndex, UserOrKernelBuffer*, size_t count, u64 offset = 0, bool allow_cache = true) const;
     ErrorOr<void> read_blocks(BlockIndex, unsigned count, UserOrKernelBuffer&, bool allow_cache = true) const;
 
+    // Asynchronously pulls the given blocks into the disk cache.
+    void read_ahead(Vector<BlockIndex>) const;
+
     ErrorOr<void> raw_read(BlockIndex, UserOrKernelBuffer&);
     ErrorOr<void> raw_write(BlockIndex, UserOrKernelBuffer const&);
 
@@ -44,8 +60,9 @@ protected:
     void remove_disk_cache_before_last_unmount();
 
 private:
-    DiskCache& cache() const;
-    void flush_specific_block_if_needed(BlockIndex index);
+    virtual bool is_block_based() const override { return true; }
+
+    ErrorOr<void> fill_cache_entry(CacheEntry&) const;
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
 };
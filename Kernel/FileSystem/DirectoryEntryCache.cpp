@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
+#include <AK/Singleton.h>
+#include <AK/StringHash.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
+#include <Kernel/FileSystem/FileSystem.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Locking/RCU.h>
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+// Every name hashes to one bucket, which holds a few of them. Lookups read the buckets under RCU without taking any
+// lock, so they neither block nor wait for each other or for changes. Cached entries are never changed in place:
+// They are replaced with new ones under the bucket's lock, and the old ones are freed after a grace period.
+static constexpr size_t bucket_count = 1024;
+static constexpr size_t entries_per_bucket = 4;
+
+// Evicted entries are freed in batches, so that filling the cache doesn't wait for a grace period on every miss.
+static constexpr size_t max_retired_entries = 64;
+
+struct CachedEntry {
+    FileSystemID fsid;
+    InodeIndex parent_index;
+    u32 hash { 0 };
+    u8 name_length { 0 };
+    char name[DirectoryEntryCache::max_name_length];
+    DirectoryEntryCache::Entry entry;
+    CachedEntry* next_retired { nullptr };
+
+    bool matches(InodeIdentifier parent, u32 name_hash, StringView name_to_match) const
+    {
+        return hash == name_hash && fsid == parent.fsid() && parent_index == parent.index()
+            && StringView { name, name_length } == name_to_match;
+    }
+};
+
+struct Bucket {
+    // Only taken by changes, which are serialized with each other.
+    Spinlock lock { LockRank::None };
+    Atomic<DirectoryEntryCache::Generation> generation { 0 };
+    u8 next_victim { 0 };
+    Array<Atomic<CachedEntry*>, entries_per_bucket> entries {};
+};
+
+struct DirectoryEntryCacheState {
+    Array<Bucket, bucket_count> buckets;
+
+    Spinlock retired_lock { LockRank::None };
+    CachedEntry* retired { nullptr };
+    size_t retired_count { 0 };
+};
+
+static Singleton<DirectoryEntryCacheState> s_state;
+
+static u32 hash_for(InodeIdentifier parent, StringView name)
+{
+    auto seed = pair_int_hash(parent.fsid().value(), u64_hash(parent.index().value()));
+    return string_hash(name.characters_without_null_termination(), name.length(), seed);
+}
+
+static Bucket& bucket_for(u32 hash)
+{
+    return s_state->buckets[hash % bucket_count];
+}
+
+// NOTE: Freeing an entry may drop the last reference to its inode, so this must not be called with any spinlock held.
+static void free_after_grace_period(CachedEntry* entries)
+{
+    if (!entries)
+        return;
+    RCU::synchronize();
+    while (entries) {
+        auto* next = entries->next_retired;
+        delete entries;
+        entries = next;
+    }
+}
+
+static void retire(CachedEntry* entry)
+{
+    if (!entry)
+        return;
+    CachedEntry* entries_to_free = nullptr;
+    {
+        SpinlockLocker locker(s_state->retired_lock);
+        entry->next_retired = s_state->retired;
+        s_state->retired = entry;
+        if (++s_state->retired_count < max_retired_entries)
+            return;
+        entries_to_free = exchange(s_state->retired, nullptr);
+        s_state->retired_count = 0;
+    }
+    free_after_grace_period(entries_to_free);
+}
+
+bool DirectoryEntryCache::is_cacheable(Inode const& parent, StringView name)
+{
+    return parent.fs().supports_directory_entry_cache() && name.length() <= max_name_length;
+}
+
+Optional<DirectoryEntryCache::Entry> DirectoryEntryCache::lookup(Inode const& parent, StringView name, Generation& generation)
+{
+    auto identifier = parent.identifier();
+    auto hash = hash_for(identifier, name);
+    auto& bucket = bucket_for(hash);
+
+    // NOTE: The generation is read first, so that any change that the search below misses makes insert() drop its entry.
+    generation = bucket.generation.load(AK::MemoryOrder::memory_order_acquire);
+
+    // NOTE: The cached entry holds a reference to the inode until after the grace period, so it's safe to take another one here.
+    RCU::ReadLocker locker;
+    for (auto& slot : bucket.entries) {
+        auto const* cached = slot.load(AK::MemoryOrder::memory_order_consume);
+        if (cached && cached->matches(identifier, hash, name))
+            return cached->entry;
+    }
+    return {};
+}
+
+void DirectoryEntryCache::insert(Inode const& parent, StringView name, Generation generation, Entry entry)
+{
+    VERIFY(is_cacheable(parent, name));
+    auto identifier = parent.identifier();
+    auto hash = hash_for(identifier, name);
+    auto& bucket = bucket_for(hash);
+
+    // It's only a cache, so there's nothing to do if there's no memory for the entry.
+    auto* new_entry = new (nothrow) CachedEntry;
+    if (!new_entry)
+        return;
+    new_entry->fsid = identifier.fsid();
+    new_entry->parent_index = identifier.index();
+    new_entry->hash = hash;
+    new_entry->name_length = name.length();
+    memcpy(new_entry->name, name.characters_without_null_termination(), name.length());
+    new_entry->entry = move(entry);
+
+    CachedEntry* evicted = nullptr;
+    {
+        SpinlockLocker locker(bucket.lock);
+        if (bucket.generation.load(AK::MemoryOrder::memory_order_relaxed) != generation) {
+            evicted = new_entry;
+        } else {
+            Atomic<CachedEntry*>* slot = nullptr;
+            for (auto& candidate : bucket.entries) {
+                auto* cached = candidate.load(AK::MemoryOrder::memory_order_relaxed);
+                if (!cached || cached->matches(identifier, hash, name)) {
+                    slot = &candidate;
+                    break;
+                }
+            }
+            if (!slot) {
+                slot = &bucket.entries[bucket.next_victim];
+                bucket.next_victim = (bucket.next_victim + 1) % entries_per_bucket;
+            }
+            // Publishes the entry only once it's all written.
+            evicted = slot->exchange(new_entry, AK::MemoryOrder::memory_order_acq_rel);
+        }
+    }
+    // Nobody has seen an entry that was never published, so that one can be freed right away.
+    if (evicted == new_entry) {
+        delete new_entry;
+        return;
+    }
+    retire(evicted);
+}
+
+void DirectoryEntryCache::invalidate(Inode const& parent, StringView name)
+{
+    if (!is_cacheable(parent, name))
+        return;
+    auto identifier = parent.identifier();
+    auto hash = hash_for(identifier, name);
+    auto& bucket = bucket_for(hash);
+
+    CachedEntry* evicted = nullptr;
+    {
+        SpinlockLocker locker(bucket.lock);
+        // This also makes lookups that are still running on the old state drop their results.
+        bucket.generation.fetch_add(1, AK::MemoryOrder::memory_order_release);
+        for (auto& slot : bucket.entries) {
+            auto* cached = slot.load(AK::MemoryOrder::memory_order_relaxed);
+            if (cached && cached->matches(identifier, hash, name)) {
+                slot.store(nullptr, AK::MemoryOrder::memory_order_release);
+                evicted = cached;
+                break;
+            }
+        }
+    }
+    // NOTE: This isn't batched with the evictions, as the entry may keep an unlinked inode (and its blocks) alive.
+    free_after_grace_period(evicted);
+}
+
+void DirectoryEntryCache::invalidate_all()
+{
+    CachedEntry* evicted = nullptr;
+    for (auto& bucket : s_state->buckets) {
+        SpinlockLocker locker(bucket.lock);
+        bucket.generation.fetch_add(1, AK::MemoryOrder::memory_order_release);
+        for (auto& slot : bucket.entries) {
+            auto* cached = slot.exchange(nullptr, AK::MemoryOrder::memory_order_acq_rel);
+            if (!cached)
+                continue;
+            cached->next_retired = evicted;
+            evicted = cached;
+        }
+    }
+    {
+        SpinlockLocker locker(s_state->retired_lock);
+        while (auto* retired = s_state->retired) {
+            s_state->retired = retired->next_retired;
+            retired->next_retired = evicted;
+            evicted = retired;
+        }
+        s_state->retired_count = 0;
+    }
+    free_after_grace_period(evicted);
+}
+
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <Kernel/Library/LockRefPtr.h>
+
+namespace Kernel {
+
+class Inode;
+
+// Remembers what the names in a directory resolve to, including names that don't exist, so that resolving a path
+// doesn't have to ask the file system (and then the mount table) for every component again.
+// Only file systems whose inodes report every change to their directories through Inode::did_add_child() and
+// Inode::did_remove_child() are cached, and any change to the mount table drops everything.
+class DirectoryEntryCache {
+public:
+    // Longer names are too rare to be worth the space.
+    static constexpr size_t max_name_length = 39;
+
+    struct Entry {
+        // Null for names that are known not to exist.
+        LockRefPtr<Inode> inode;
+        // Set if something is mounted on the name, inode is then the root of what is mounted.
+        Optional<int> mount_flags;
+    };
+
+    // Taken from the cache when a lookup misses, an insertion is dropped if the cache changed in the meantime.
+    using Generation = u32;
+
+    static bool is_cacheable(Inode const& parent, StringView name);
+    static Optional<Entry> lookup(Inode const& parent, StringView name, Generation&);
+    static void insert(Inode const& parent, StringView name, Generation, Entry);
+
+    static void invalidate(Inode const& parent, StringView name);
+    static void invalidate_all();
+};
+
+}
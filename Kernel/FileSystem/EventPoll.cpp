@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KString.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+ErrorOr<NonnullLockRefPtr<EventPoll>> EventPoll::try_create()
+{
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) EventPoll);
+}
+
+EventPoll::~EventPoll()
+{
+    (void)close();
+}
+
+ErrorOr<NonnullLockRefPtr<EventPoll::Interest>> EventPoll::Interest::try_create(EventPoll& event_poll, NonnullLockRefPtr<OpenFileDescription> description, epoll_event const& event)
+{
+    auto weak_event_poll = TRY(event_poll.try_make_weak_ptr<EventPoll>());
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) Interest(move(weak_event_poll), move(description), event));
+}
+
+EventPoll::Interest::Interest(LockWeakPtr<EventPoll> event_poll, NonnullLockRefPtr<OpenFileDescription> description, epoll_event const& event)
+    : m_event_poll(move(event_poll))
+    , m_description(move(description))
+    , m_event(event)
+{
+}
+
+void EventPoll::Interest::file_readiness_may_have_changed()
+{
+    if (auto event_poll = m_event_poll.strong_ref())
+        event_poll->interest_may_have_become_ready(*this);
+}
+
+u32 EventPoll::Interest::ready_events(u32 requested_events) const
+{
+    auto block_flags = BlockFlags::None;
+    if (requested_events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (requested_events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+
+    // FIXME: Report EPOLLERR and EPOLLHUP once OpenFileDescription::should_unblock() knows about them.
+    auto unblocked_flags = m_description->should_unblock(block_flags);
+    u32 ready_events = 0;
+    if (has_flag(unblocked_flags, BlockFlags::Read))
+        ready_events |= EPOLLIN;
+    if (has_flag(unblocked_flags, BlockFlags::Write))
+        ready_events |= EPOLLOUT;
+    return ready_events;
+}
+
+ErrorOr<void> EventPoll::add_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // FIXME: Allow nesting event polls once we can detect cycles between them, which would keep each other alive.
+    if (description.is_event_poll())
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    if (auto it = m_interests.find(fd); it != m_interests.end()) {
+        if (&it->value->description() == &description)
+            return EEXIST;
+        // NOTE: The file descriptor was closed and reused without removing it first, so the old interest is stale.
+        disarm_and_unwatch(*it->value);
+        m_interests.remove(it);
+    }
+
+    auto interest = TRY(Interest::try_create(*this, description, event));
+    TRY(m_interests.try_set(fd, interest));
+    description.blocker_set().add_readiness_watcher(*interest);
+
+    // The file may be ready already, in which case we would never hear about it otherwise.
+    interest_may_have_become_ready(*interest);
+    return {};
+}
+
+ErrorOr<void> EventPoll::modify_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_interests.find(fd);
+    if (it == m_interests.end() || &it->value->description() != &description)
+        return ENOENT;
+
+    auto& interest = *it->value;
+    {
+        SpinlockLocker lock(m_ready_lock);
+        interest.m_event = event;
+        interest.m_is_armed = true;
+    }
+    interest_may_have_become_ready(interest);
+    return {};
+}
+
+ErrorOr<void> EventPoll::remove_interest(int fd)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_interests.find(fd);
+    if (it == m_interests.end())
+        return ENOENT;
+    disarm_and_unwatch(*it->value);
+    m_interests.remove(it);
+    return {};
+}
+
+void EventPoll::disarm_and_unwatch(Interest& interest)
+{
+    VERIFY(m_lock.is_locked());
+    {
+        SpinlockLocker lock(m_ready_lock);
+        interest.m_is_armed = false;
+        if (interest.m_ready_list_node.is_in_list()) {
+            m_ready_interests.remove(interest);
+            --m_ready_interest_count;
+        }
+    }
+    interest.description().blocker_set().remove_readiness_watcher(interest);
+}
+
+bool EventPoll::enqueue_ready_interest_locked(Interest& interest)
+{
+    VERIFY(m_ready_lock.is_locked());
+    if (!interest.m_is_armed || interest.m_ready_list_node.is_in_list())
+        return false;
+    m_ready_interests.append(interest);
+    ++m_ready_interest_count;
+    return true;
+}
+
+void EventPoll::interest_may_have_become_ready(Interest& interest)
+{
+    bool did_enqueue;
+    {
+        SpinlockLocker lock(m_ready_lock);
+        did_enqueue = enqueue_ready_interest_locked(interest);
+    }
+    if (!did_enqueue)
+        return;
+    m_wait_queue.wake_all();
+    evaluate_block_conditions();
+}
+
+size_t EventPoll::collect_ready_events(Span<epoll_event> events)
+{
+    size_t candidate_count;
+    {
+        SpinlockLocker lock(m_ready_lock);
+        candidate_count = m_ready_interest_count;
+    }
+
+    // NOTE: Each candidate is taken off the ready list before we look at its file, and the readiness of a file
+    //       can't be looked at under a spinlock. If it changes after we looked, the interest is simply queued again.
+    size_t event_count = 0;
+    for (; candidate_count > 0 && event_count < events.size(); --candidate_count) {
+        LockRefPtr<Interest> interest;
+        epoll_event requested_event;
+        {
+            SpinlockLocker lock(m_ready_lock);
+            if (m_ready_interests.is_empty())
+                break;
+            interest = m_ready_interests.take_first();
+            --m_ready_interest_count;
+            requested_event = interest->m_event;
+        }
+
+        auto ready_events = interest->ready_events(requested_event.events);
+        if (ready_events == 0)
+            continue;
+
+        SpinlockLocker lock(m_ready_lock);
+        // The interest was removed or disarmed while we were looking at it.
+        if (!interest->m_is_armed)
+            continue;
+        events[event_count++] = { ready_events, requested_event.data };
+        if (requested_event.events & EPOLLONESHOT)
+            interest->m_is_armed = false;
+        else if (!(requested_event.events & EPOLLET))
+            (void)enqueue_ready_interest_locked(*interest);
+    }
+    return event_count;
+}
+
+ErrorOr<size_t> EventPoll::wait(Span<epoll_event> events, Thread::BlockTimeout const& timeout)
+{
+    VERIFY(!events.is_empty());
+    for (;;) {
+        if (auto event_count = collect_ready_events(events); event_count > 0)
+            return event_count;
+
+        // NOTE: If an interest became ready after we looked, the wait queue remembers the wake-up and we won't block.
+        auto result = m_wait_queue.wait_on(timeout, "EventPoll"sv);
+        if (result.was_interrupted())
+            return EINTR;
+        if (result == Thread::BlockResult::InterruptedByTimeout)
+            return collect_ready_events(events);
+    }
+}
+
+bool EventPoll::can_read(OpenFileDescription const&, u64) const
+{
+    SpinlockLocker lock(m_ready_lock);
+    return m_ready_interest_count > 0;
+}
+
+ErrorOr<void> EventPoll::close()
+{
+    MutexLocker locker(m_lock);
+    for (auto& it : m_interests)
+        disarm_and_unwatch(*it.value);
+    m_interests.clear();
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::formatted("EventPoll:({})", m_interests.size());
+}
+
+}
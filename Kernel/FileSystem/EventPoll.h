@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/LockWeakPtr.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+// A persistent set of file descriptions that a process is interested in, as used by the epoll API.
+// Instead of re-scanning every description on each wait like poll() does, each interest watches the
+// blocker set of its file, and puts itself on a ready list whenever the file's readiness may have changed.
+// Waiting then only has to look at the interests on that list.
+class EventPoll final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<EventPoll>> try_create();
+    virtual ~EventPoll() override;
+
+    ErrorOr<void> add_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove_interest(int fd);
+
+    // Fills in events for interests that are ready, waiting for one to become ready if there are none.
+    ErrorOr<size_t> wait(Span<epoll_event>, Thread::BlockTimeout const&);
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EventPoll"sv; }
+    virtual bool is_event_poll() const override { return true; }
+
+private:
+    EventPoll() = default;
+
+    class Interest final : public FileReadinessWatcher {
+    public:
+        static ErrorOr<NonnullLockRefPtr<Interest>> try_create(EventPoll&, NonnullLockRefPtr<OpenFileDescription>, epoll_event const&);
+
+        virtual void file_readiness_may_have_changed() override;
+
+        // Returns the requested events that the file is currently ready for.
+        u32 ready_events(u32 requested_events) const;
+
+        OpenFileDescription& description() { return *m_description; }
+
+    private:
+        friend class EventPoll;
+
+        Interest(LockWeakPtr<EventPoll>, NonnullLockRefPtr<OpenFileDescription>, epoll_event const&);
+
+        LockWeakPtr<EventPoll> m_event_poll;
+        NonnullLockRefPtr<OpenFileDescription> m_description;
+
+        // Protected by the event poll's ready lock.
+        epoll_event m_event;
+        bool m_is_armed { true };
+        IntrusiveListNode<Interest, NonnullLockRefPtr<Interest>> m_ready_list_node;
+    };
+
+    void interest_may_have_become_ready(Interest&);
+    bool enqueue_ready_interest_locked(Interest&);
+    size_t collect_ready_events(Span<epoll_event>);
+    void disarm_and_unwatch(Interest&);
+
+    // Protects the interest set against concurrent changes.
+    mutable Mutex m_lock { "EventPoll"sv };
+    HashMap<int, NonnullLockRefPtr<Interest>> m_interests;
+
+    mutable Spinlock m_ready_lock { LockRank::None };
+    IntrusiveList<&Interest::m_ready_list_node> m_ready_interests;
+    size_t m_ready_interest_count { 0 };
+
+    WaitQueue m_wait_queue;
+};
+
+}
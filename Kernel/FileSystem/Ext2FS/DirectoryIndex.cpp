@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/BitCast.h>
+#include <Kernel/FileSystem/Ext2FS/Definitions.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
+
+namespace Kernel {
+
+// These have to match the hashes of the Linux ext3/ext4 drivers bit for bit, including the quirk that
+// the "signed" variants sign extend every byte of the name, as `char` is signed on x86.
+
+static constexpr u32 rotate_left(u32 value, u32 bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+template<bool is_signed>
+static u32 extend_byte(char c)
+{
+    if constexpr (is_signed)
+        return static_cast<u32>(static_cast<i32>(bit_cast<i8>(c)));
+    else
+        return static_cast<u8>(c);
+}
+
+template<bool is_signed>
+static u32 legacy_hash(StringView name)
+{
+    u32 hash0 = 0x12a3fe2d;
+    u32 hash1 = 0x37abe8f9;
+    for (auto c : name) {
+        u32 hash = hash1 + (hash0 ^ (extend_byte<is_signed>(c) * 7152373));
+        if (hash & 0x80000000)
+            hash -= 0x7fffffff;
+        hash1 = hash0;
+        hash0 = hash;
+    }
+    return hash0 << 1;
+}
+
+// Packs the next (up to) 4 * words.size() bytes of the name into words, padding them with the length of the name.
+template<bool is_signed>
+static void pack_name(StringView name, Span<u32> words)
+{
+    u32 padding = name.length() | (name.length() << 8);
+    padding |= padding << 16;
+
+    size_t length = min(name.length(), words.size() * 4);
+    size_t word = 0;
+    u32 value = padding;
+    for (size_t i = 0; i < length; ++i) {
+        value = extend_byte<is_signed>(name[i]) + (value << 8);
+        if (i % 4 == 3) {
+            words[word++] = value;
+            value = padding;
+        }
+    }
+    if (word < words.size())
+        words[word++] = value;
+    while (word < words.size())
+        words[word++] = padding;
+}
+
+static void half_md4_transform(Array<u32, 4>& state, Array<u32, 8> const& in)
+{
+    auto f = [](u32 x, u32 y, u32 z) { return z ^ (x & (y ^ z)); };
+    auto g = [](u32 x, u32 y, u32 z) { return (x & y) + ((x ^ y) & z); };
+    auto h = [](u32 x, u32 y, u32 z) { return x ^ y ^ z; };
+    constexpr u32 k2 = 0x5a827999;
+    constexpr u32 k3 = 0x6ed9eba1;
+
+    u32 a = state[0], b = state[1], c = state[2], d = state[3];
+    auto round = [](auto function, u32& w, u32 x, u32 y, u32 z, u32 input, u32 shift) {
+        w = rotate_left(w + function(x, y, z) + input, shift);
+    };
+
+    round(f, a, b, c, d, in[0], 3);
+    round(f, d, a, b, c, in[1], 7);
+    round(f, c, d, a, b, in[2], 11);
+    round(f, b, c, d, a, in[3], 19);
+    round(f, a, b, c, d, in[4], 3);
+    round(f, d, a, b, c, in[5], 7);
+    round(f, c, d, a, b, in[6], 11);
+    round(f, b, c, d, a, in[7], 19);
+
+    round(g, a, b, c, d, in[1] + k2, 3);
+    round(g, d, a, b, c, in[3] + k2, 5);
+    round(g, c, d, a, b, in[5] + k2, 9);
+    round(g, b, c, d, a, in[7] + k2, 13);
+    round(g, a, b, c, d, in[0] + k2, 3);
+    round(g, d, a, b, c, in[2] + k2, 5);
+    round(g, c, d, a, b, in[4] + k2, 9);
+    round(g, b, c, d, a, in[6] + k2, 13);
+
+    round(h, a, b, c, d, in[3] + k3, 3);
+    round(h, d, a, b, c, in[7] + k3, 9);
+    round(h, c, d, a, b, in[2] + k3, 11);
+    round(h, b, c, d, a, in[6] + k3, 15);
+    round(h, a, b, c, d, in[1] + k3, 3);
+    round(h, d, a, b, c, in[5] + k3, 9);
+    round(h, c, d, a, b, in[0] + k3, 11);
+    round(h, b, c, d, a, in[4] + k3, 15);
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+static void tea_transform(Array<u32, 4>& state, Array<u32, 4> const& in)
+{
+    constexpr u32 delta = 0x9e3779b9;
+    u32 sum = 0;
+    u32 b0 = state[0], b1 = state[1];
+    for (size_t i = 0; i < 16; ++i) {
+        sum += delta;
+        b0 += ((b1 << 4) + in[0]) ^ (b1 + sum) ^ ((b1 >> 5) + in[1]);
+        b1 += ((b0 << 4) + in[2]) ^ (b0 + sum) ^ ((b0 >> 5) + in[3]);
+    }
+    state[0] += b0;
+    state[1] += b1;
+}
+
+template<bool is_signed>
+static u32 half_md4_hash(StringView name, Array<u32, 4> state)
+{
+    Array<u32, 8> in;
+    while (!name.is_empty()) {
+        pack_name<is_signed>(name, in.span());
+        half_md4_transform(state, in);
+        name = name.substring_view(min<size_t>(32, name.length()));
+    }
+    return state[1];
+}
+
+template<bool is_signed>
+static u32 tea_hash(StringView name, Array<u32, 4> state)
+{
+    Array<u32, 4> in;
+    while (!name.is_empty()) {
+        pack_name<is_signed>(name, in.span());
+        tea_transform(state, in);
+        name = name.substring_view(min<size_t>(16, name.length()));
+    }
+    return state[0];
+}
+
+bool is_supported_ext2_directory_hash_version(u8 hash_version)
+{
+    return hash_version <= EXT2_HASH_TEA_UNSIGNED;
+}
+
+u32 ext2_directory_hash(StringView name, u8 hash_version, u32 const seed[4])
+{
+    VERIFY(is_supported_ext2_directory_hash_version(hash_version));
+
+    // A seed of all zeroes means that the file system was created without one, so the MD4 one is used.
+    Array<u32, 4> state { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    if (seed[0] != 0 || seed[1] != 0 || seed[2] != 0 || seed[3] != 0)
+        state = { seed[0], seed[1], seed[2], seed[3] };
+
+    u32 hash = 0;
+    switch (hash_version) {
+    case EXT2_HASH_LEGACY:
+        hash = legacy_hash<true>(name);
+        break;
+    case EXT2_HASH_HALF_MD4:
+        hash = half_md4_hash<true>(name, state);
+        break;
+    case EXT2_HASH_TEA:
+        hash = tea_hash<true>(name, state);
+        break;
+    case EXT2_HASH_LEGACY_UNSIGNED:
+        hash = legacy_hash<false>(name);
+        break;
+    case EXT2_HASH_HALF_MD4_UNSIGNED:
+        hash = half_md4_hash<false>(name, state);
+        break;
+    case EXT2_HASH_TEA_UNSIGNED:
+        hash = tea_hash<false>(name, state);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    // The lowest bit is used to mark continued hashes in the index, and the largest hash marks the end of a directory.
+    hash &= ~ext2_directory_index_hash_continued;
+    if (hash == 0xfffffffe)
+        hash = 0xfffffffc;
+    return hash;
+}
+
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// Directories with EXT2_INDEX_FL set are hashed B-trees ("htree"s): the first block holds "." and ".."
+// followed by the root of the index, which maps hashes of names to the leaf blocks holding those names.
+// Leaves are regular directory blocks and index nodes are disguised as empty ones, so the directory
+// can still be read as a linear list of entries.
+
+// The "." and ".." entries and the dx_root_info that follows them.
+static constexpr size_t ext2_directory_index_root_info_offset = 24;
+// The fake, empty directory entry before the entries of an index node.
+static constexpr size_t ext2_directory_index_node_entries_offset = 8;
+// There can be up to two levels of index nodes below the root.
+static constexpr size_t ext2_directory_index_max_levels = 3;
+
+// Only the low 28 bits of a dx_entry's block are the block number.
+static constexpr u32 ext2_directory_index_block_mask = 0x0fffffff;
+// Set in the hash of an index entry if its leaf continues a run of names with the same hash from the previous leaf.
+static constexpr u32 ext2_directory_index_hash_continued = 1;
+
+bool is_supported_ext2_directory_hash_version(u8 hash_version);
+
+// The hash of a name in a directory index. hash_version is one of EXT2_HASH_*, including the unsigned variants.
+u32 ext2_directory_hash(StringView name, u8 hash_version, u32 const seed[4]);
+
+}
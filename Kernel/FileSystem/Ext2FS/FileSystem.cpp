@@ -223,9 +223,137 @@ ErrorOr<void> Ext2FS::write_ext2_inode(InodeIndex inode, ext2_inode const& e2ino
     return write_block(block_index, buffer, inode_size(), offset);
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> ErrorOr<Vector<BlockIndex>>
+// How many blocks past the end of an appended-to file we try to keep free for it.
+static constexpr size_t block_reservation_window = 128;
+
+auto Ext2FS::first_block_in_group(GroupIndex group_index) const -> BlockIndex
+{
+    return (group_index.value() - 1) * blocks_per_group() + first_block_index().value();
+}
+
+size_t Ext2FS::blocks_in_group() const
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
+    return min(blocks_per_group(), super_block().s_blocks_count);
+}
+
+size_t Ext2FS::unreserved_run_length(BlockIndex start, size_t length, InodeIndex owner) const
+{
+    VERIFY(m_lock.is_locked());
+    u64 end = start.value() + length;
+    for (auto const& it : m_block_reservations) {
+        if (it.key == owner)
+            continue;
+        auto const& reservation = it.value;
+        if (reservation.end() <= start.value() || reservation.start.value() >= end)
+            continue;
+        if (reservation.start <= start)
+            return 0;
+        end = reservation.start.value();
+    }
+    return end - start.value();
+}
+
+void Ext2FS::update_block_reservation(InodeIndex owner, BlockIndex next_block)
+{
+    VERIFY(m_lock.is_locked());
+    auto it = m_block_reservations.find(owner);
+    if (it == m_block_reservations.end())
+        return;
+    auto& reservation = it->value;
+    if (!reservation.contains(next_block)) {
+        // The inode has either used up its window, or it's not growing into it anymore.
+        m_block_reservations.remove(it);
+        return;
+    }
+    reservation.length = reservation.end() - next_block.value();
+    reservation.start = next_block;
+}
+
+void Ext2FS::discard_block_reservation(InodeIndex owner)
+{
+    MutexLocker locker(m_lock);
+    m_block_reservations.remove(owner);
+}
+
+ErrorOr<size_t> Ext2FS::allocate_blocks_at(BlockIndex goal, size_t count, InodeIndex owner, Vector<BlockIndex>& blocks)
+{
+    VERIFY(m_lock.is_locked());
+    if (goal < first_block_index() || goal.value() >= super_block().s_blocks_count)
+        return 0;
+
+    auto group_index = group_index_from_block_index(goal);
+    auto const& bgd = group_descriptor(group_index);
+    if (!bgd.bg_free_blocks_count)
+        return 0;
+
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    auto block_bitmap = cached_bitmap->bitmap(blocks_in_group());
+
+    // Runs never cross into another group, and stop at the first block that is either in use or set aside for someone else.
+    size_t bit_index = goal.value() - first_block_in_group(group_index).value();
+    count = unreserved_run_length(goal, min(count, blocks_in_group() - bit_index), owner);
+
+    size_t allocated = 0;
+    for (; allocated < count && !block_bitmap.get(bit_index + allocated); ++allocated) {
+        BlockIndex block_index = goal.value() + allocated;
+        TRY(set_block_allocation_state(block_index, true));
+        blocks.unchecked_append(block_index);
+    }
+    return allocated;
+}
+
+auto Ext2FS::find_free_run_in_group(GroupIndex group_index, size_t wanted, InodeIndex owner, bool respect_reservations) -> ErrorOr<BlockRun>
+{
+    VERIFY(m_lock.is_locked());
+    auto const& bgd = group_descriptor(group_index);
+    if (!bgd.bg_free_blocks_count)
+        return BlockRun {};
+
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    auto block_bitmap = cached_bitmap->bitmap(blocks_in_group());
+    auto first_block = first_block_in_group(group_index);
+
+    // Take the first run that's long enough, or the longest one if there's no such run.
+    BlockRun longest_run;
+    size_t from = 0;
+    while (from < block_bitmap.size()) {
+        auto length = block_bitmap.find_next_range_of_unset_bits(from, 1, wanted);
+        if (!length.has_value())
+            break;
+        BlockIndex start = first_block.value() + from;
+        auto usable_length = respect_reservations ? unreserved_run_length(start, length.value(), owner) : length.value();
+        if (usable_length > longest_run.length)
+            longest_run = { start, usable_length };
+        if (usable_length >= wanted)
+            break;
+        from += length.value();
+    }
+    return longest_run;
+}
+
+auto Ext2FS::find_free_run(GroupIndex preferred_group_index, size_t wanted, InodeIndex owner) -> ErrorOr<BlockRun>
+{
+    VERIFY(m_lock.is_locked());
+    BlockRun longest_run;
+    for (auto respect_reservations : { true, false }) {
+        for (u64 i = 0; i < m_block_group_count; ++i) {
+            GroupIndex group_index = (preferred_group_index.value() - 1 + i) % m_block_group_count + 1;
+            auto run = TRY(find_free_run_in_group(group_index, wanted, owner, respect_reservations));
+            if (run.length > longest_run.length)
+                longest_run = run;
+            if (longest_run.length >= wanted)
+                return longest_run;
+        }
+        // Only dip into other inodes' reservations if there is nothing else left.
+        if (longest_run.length)
+            break;
+    }
+    return longest_run;
+}
+
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, InodeIndex owner, BlockIndex goal) -> ErrorOr<Vector<BlockIndex>>
+{
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, owner {}, goal {})", preferred_group_index, count, owner, goal);
     if (count == 0)
         return Vector<BlockIndex> {};
 
@@ -233,45 +361,51 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     TRY(blocks.try_ensure_capacity(count));
 
     MutexLocker locker(m_lock);
-    auto group_index = preferred_group_index;
-
-    if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
-        group_index = 1;
-    }
+    if (count > super_block().s_free_blocks_count)
+        return ENOSPC;
+    if (!preferred_group_index || preferred_group_index.value() > m_block_group_count)
+        preferred_group_index = 1;
 
     while (blocks.size() < count) {
-        bool found_a_group = false;
-        if (group_descriptor(group_index).bg_free_blocks_count) {
-            found_a_group = true;
-        } else {
-            if (group_index == preferred_group_index)
-                group_index = 1;
-            for (; group_index <= m_block_group_count; group_index = GroupIndex { group_index.value() + 1 }) {
-                if (group_descriptor(group_index).bg_free_blocks_count) {
-                    found_a_group = true;
-                    break;
-                }
+        auto remaining = count - blocks.size();
+
+        // First try to continue right where the inode's data ends, which is also where its reservation window starts.
+        if (goal.value() != 0) {
+            auto allocated = TRY(allocate_blocks_at(goal, remaining, owner, blocks));
+            if (allocated) {
+                dbgln_if(EXT2_DEBUG, "Ext2FS: allocated {} blocks at goal {}", allocated, goal);
+                goal = goal.value() + allocated;
+                if (owner.value())
+                    update_block_reservation(owner, goal);
+                continue;
             }
         }
 
-        VERIFY(found_a_group);
-        auto const& bgd = group_descriptor(group_index);
-
-        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
-
-        int blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
-        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
+        // Otherwise, find a new contiguous run of free blocks. Inodes that are being appended to
+        // ask for a whole reservation window, so their following writes can land right after this one.
+        auto group_index = preferred_group_index;
+        if (auto goal_group_index = group_index_from_block_index(goal); goal_group_index.value() && goal_group_index.value() <= m_block_group_count)
+            group_index = goal_group_index;
+        size_t wanted = owner.value() ? max(remaining, block_reservation_window) : remaining;
+        auto run = TRY(find_free_run(group_index, wanted, owner));
+        if (!run.length) {
+            dmesgln("Ext2FS: allocate_blocks: no free blocks left, even though the superblock claims there are");
+            return ENOSPC;
+        }
 
-        BlockIndex first_block_in_group = (group_index.value() - 1) * blocks_per_group() + first_block_index().value();
-        size_t free_region_size = 0;
-        auto first_unset_bit_index = block_bitmap.find_longest_range_of_unset_bits(count - blocks.size(), free_region_size);
-        VERIFY(first_unset_bit_index.has_value());
-        dbgln_if(EXT2_DEBUG, "Ext2FS: allocating free region of size: {} [{}]", free_region_size, group_index);
-        for (size_t i = 0; i < free_region_size; ++i) {
-            BlockIndex block_index = (first_unset_bit_index.value() + i) + first_block_in_group.value();
+        auto allocated = min(run.length, remaining);
+        dbgln_if(EXT2_DEBUG, "Ext2FS: allocating free region of size: {} at {}", allocated, run.start);
+        for (size_t i = 0; i < allocated; ++i) {
+            BlockIndex block_index = run.start.value() + i;
             TRY(set_block_allocation_state(block_index, true));
             blocks.unchecked_append(block_index);
-            dbgln_if(EXT2_DEBUG, "  allocated > {}", block_index);
+        }
+        goal = run.start.value() + allocated;
+
+        if (owner.value()) {
+            m_block_reservations.remove(owner);
+            if (run.length > allocated)
+                TRY(m_block_reservations.try_set(owner, { goal, run.length - allocated }));
         }
     }
 
@@ -343,7 +477,7 @@ Ext2FS::GroupIndex Ext2FS::group_index_from_block_index(BlockIndex block_index)
 {
     if (!block_index)
         return 0;
-    return (block_index.value() - 1) / blocks_per_group() + 1;
+    return (block_index.value() - first_block_index().value()) / blocks_per_group() + 1;
 }
 
 auto Ext2FS::group_index_from_inode(InodeIndex inode) const -> GroupIndex
@@ -506,6 +640,7 @@ void Ext2FS::uncache_inode(InodeIndex index)
 {
     MutexLocker locker(m_lock);
     m_inode_cache.remove(index);
+    m_block_reservations.remove(index);
 }
 
 unsigned Ext2FS::total_block_count() const
@@ -552,6 +687,8 @@ ErrorOr<void> Ext2FS::free_inode(Ext2FSInode& inode)
     VERIFY(inode.m_raw_inode.i_links_count == 0);
     dbgln_if(EXT2_DEBUG, "Ext2FS[{}]::free_inode(): Inode {} has no more links, time to delete!", fsid(), inode.index());
 
+    m_block_reservations.remove(inode.index());
+
     // Mark all blocks used by this inode as free.
     {
         auto blocks = TRY(inode.compute_block_list_with_meta_blocks());
@@ -37,6 +37,7 @@ public:
     virtual unsigned free_inode_count() const override;
 
     virtual bool supports_watchers() const override { return true; }
+    virtual bool supports_directory_entry_cache() const override { return true; }
 
     virtual u8 internal_file_type_to_directory_entry_type(DirectoryEntryView const& entry) const override;
 
@@ -78,7 +79,8 @@ private:
 
     BlockIndex first_block_index() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, InodeIndex owner = 0, BlockIndex goal = 0);
+    void discard_block_reservation(InodeIndex);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
 
@@ -121,10 +123,34 @@ private:
         Bitmap bitmap(u32 blocks_per_group) { return Bitmap { buffer->data(), blocks_per_group }; }
     };
 
+    // A window of free blocks set aside (in memory only) for an inode that's being appended to,
+    // so that its data stays contiguous even if other files grow at the same time.
+    struct BlockReservation {
+        BlockIndex start { 0 };
+        size_t length { 0 };
+
+        u64 end() const { return start.value() + length; }
+        bool contains(BlockIndex block_index) const { return block_index >= start && block_index.value() < end(); }
+    };
+
+    struct BlockRun {
+        BlockIndex start { 0 };
+        size_t length { 0 };
+    };
+
+    BlockIndex first_block_in_group(GroupIndex) const;
+    size_t blocks_in_group() const;
+    size_t unreserved_run_length(BlockIndex start, size_t length, InodeIndex owner) const;
+    void update_block_reservation(InodeIndex owner, BlockIndex next_block);
+    ErrorOr<size_t> allocate_blocks_at(BlockIndex goal, size_t count, InodeIndex owner, Vector<BlockIndex>&);
+    ErrorOr<BlockRun> find_free_run_in_group(GroupIndex, size_t wanted, InodeIndex owner, bool respect_reservations);
+    ErrorOr<BlockRun> find_free_run(GroupIndex preferred_group_index, size_t wanted, InodeIndex owner);
+
     ErrorOr<CachedBitmap*> get_bitmap_block(BlockIndex);
     ErrorOr<void> update_bitmap_block(BlockIndex bitmap_block, size_t bit_index, bool new_state, u32& super_block_counter, u16& group_descriptor_counter);
 
     Vector<OwnPtr<CachedBitmap>> m_cached_bitmaps;
+    HashMap<InodeIndex, BlockReservation> m_block_reservations;
     LockRefPtr<Ext2FSInode> m_root_inode;
 };
 
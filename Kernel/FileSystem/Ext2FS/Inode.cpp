@@ -6,6 +6,7 @@
  */
 
 #include <AK/MemoryStream.h>
+#include <AK/QuickSort.h>
 #include <Kernel/API/POSIX/errno.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Ext2FS/Inode.h>
@@ -16,6 +17,10 @@ namespace Kernel {
 
 static constexpr size_t max_inline_symlink_length = 60;
 
+// The read-ahead window starts out small and doubles with every sequential read, up to a maximum.
+static constexpr size_t min_read_ahead_blocks = 4;
+static constexpr size_t max_read_ahead_blocks = 32;
+
 static u8 to_ext2_file_type(mode_t mode)
 {
     if (is_regular_file(mode))
@@ -35,6 +40,93 @@ static u8 to_ext2_file_type(mode_t mode)
     return EXT2_FT_UNKNOWN;
 }
 
+struct DirectoryBlockEntry {
+    StringView name;
+    InodeIndex inode;
+    u8 file_type { 0 };
+    u32 hash { 0 };
+};
+
+// Calls callback for the entries of a directory block until it returns IterationDecision::Break.
+// Returns false if the block is malformed.
+template<typename Callback>
+static bool for_each_entry_in_directory_block(Bytes block, Callback callback)
+{
+    size_t offset = 0;
+    while (offset < block.size()) {
+        if (offset + EXT2_DIR_REC_LEN(0) > block.size())
+            return false;
+        auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(block.data() + offset);
+        if (entry.rec_len < EXT2_DIR_REC_LEN(0) || entry.rec_len % 4 != 0 || offset + entry.rec_len > block.size() || EXT2_DIR_REC_LEN(entry.name_len) > entry.rec_len)
+            return false;
+        if (callback(offset, entry) == IterationDecision::Break)
+            return true;
+        offset += entry.rec_len;
+    }
+    return true;
+}
+
+static Optional<size_t> find_entry_in_directory_block(Bytes block, StringView name)
+{
+    Optional<size_t> found;
+    for_each_entry_in_directory_block(block, [&](size_t offset, auto& entry) {
+        if (entry.inode != 0 && StringView { entry.name, entry.name_len } == name) {
+            found = offset;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    return found;
+}
+
+static void write_entry_into_directory_block(Bytes record, StringView name, InodeIndex inode, u8 file_type)
+{
+    VERIFY(record.size() >= EXT2_DIR_REC_LEN(name.length()));
+    auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(record.data());
+    entry.inode = inode.value();
+    entry.rec_len = record.size();
+    entry.name_len = name.length();
+    entry.file_type = file_type;
+    if (!name.is_empty())
+        memcpy(entry.name, name.characters_without_null_termination(), name.length());
+    memset(entry.name + name.length(), 0, record.size() - EXT2_DIR_REC_LEN(0) - name.length());
+}
+
+// Puts an entry into the free space of a directory block, returns false if there isn't enough of it.
+static bool insert_entry_into_directory_block(Bytes block, StringView name, InodeIndex inode, u8 file_type)
+{
+    size_t needed = EXT2_DIR_REC_LEN(name.length());
+    bool inserted = false;
+    for_each_entry_in_directory_block(block, [&](size_t offset, auto& entry) {
+        size_t used = entry.inode != 0 ? EXT2_DIR_REC_LEN(entry.name_len) : 0;
+        if (entry.rec_len - used < needed)
+            return IterationDecision::Continue;
+        size_t record_length = entry.rec_len - used;
+        if (used != 0)
+            entry.rec_len = used;
+        write_entry_into_directory_block(block.slice(offset + used, record_length), name, inode, file_type);
+        inserted = true;
+        return IterationDecision::Break;
+    });
+    return inserted;
+}
+
+// Lays out the entries back to back, with the last one taking up the rest of the block.
+static void fill_directory_block(Bytes block, Span<DirectoryBlockEntry const> entries)
+{
+    if (entries.is_empty()) {
+        write_entry_into_directory_block(block, {}, 0, EXT2_FT_UNKNOWN);
+        return;
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto const& entry = entries[i];
+        size_t record_length = i + 1 < entries.size() ? EXT2_DIR_REC_LEN(entry.name.length()) : block.size() - offset;
+        write_entry_into_directory_block(block.slice(offset, record_length), entry.name, entry.inode, entry.file_type);
+        offset += record_length;
+    }
+}
+
 ErrorOr<void> Ext2FSInode::write_indirect_block(BlockBasedFileSystem::BlockIndex block, Span<BlockBasedFileSystem::BlockIndex> blocks_indices)
 {
     auto const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
@@ -588,9 +680,54 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         nread += num_bytes_to_copy;
     }
 
+    if (allow_cache)
+        read_ahead_if_sequential(offset, nread);
+
     return nread;
 }
 
+void Ext2FSInode::read_ahead_if_sequential(off_t offset, size_t nread) const
+{
+    VERIFY(m_inode_lock.is_locked());
+
+    // NOTE: Concurrent readers may race on these, but the worst that can happen is a mispredicted read-ahead.
+    u64 end_offset = offset + nread;
+    auto expected_offset = m_next_sequential_read_offset.exchange(end_offset, AK::MemoryOrder::memory_order_relaxed);
+    if (static_cast<u64>(offset) != expected_offset) {
+        m_read_ahead_window.store(0, AK::MemoryOrder::memory_order_relaxed);
+        m_read_ahead_end.store(0, AK::MemoryOrder::memory_order_relaxed);
+        return;
+    }
+
+    u64 next_block = ceil_div(end_offset, static_cast<u64>(fs().block_size()));
+    if (next_block >= m_block_list.size())
+        return;
+
+    size_t window = clamp(m_read_ahead_window.load(AK::MemoryOrder::memory_order_relaxed) * 2, min_read_ahead_blocks, max_read_ahead_blocks);
+    m_read_ahead_window.store(window, AK::MemoryOrder::memory_order_relaxed);
+
+    // Don't issue more read-ahead until the reader has made it halfway through the previous window.
+    u64 read_ahead_end = m_read_ahead_end.load(AK::MemoryOrder::memory_order_relaxed);
+    if (next_block + window / 2 < read_ahead_end)
+        return;
+
+    u64 first_block = max(next_block, read_ahead_end);
+    u64 last_block = min(next_block + window, static_cast<u64>(m_block_list.size()));
+    if (first_block >= last_block)
+        return;
+
+    Vector<BlockBasedFileSystem::BlockIndex> blocks;
+    if (blocks.try_ensure_capacity(last_block - first_block).is_error())
+        return;
+    for (auto i = first_block; i < last_block; ++i) {
+        // Holes have nothing to read.
+        if (m_block_list[i].value() != 0)
+            blocks.unchecked_append(m_block_list[i]);
+    }
+    m_read_ahead_end.store(last_block, AK::MemoryOrder::memory_order_relaxed);
+    fs().read_ahead(move(blocks));
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     auto old_size = size();
@@ -619,9 +756,18 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         m_block_list = TRY(compute_block_list());
 
     if (blocks_needed_after > blocks_needed_before) {
-        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before));
+        // Aim for the block right after the current end of the file, so that appends stay contiguous.
+        BlockBasedFileSystem::BlockIndex goal = 0;
+        for (auto it = m_block_list.rbegin(); it != m_block_list.rend(); ++it) {
+            if (it->value() != 0) {
+                goal = it->value() + 1;
+                break;
+            }
+        }
+        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before, index(), goal));
         TRY(m_block_list.try_extend(move(blocks)));
     } else if (blocks_needed_after < blocks_needed_before) {
+        fs().discard_block_reservation(index());
         if constexpr (EXT2_VERY_DEBUG) {
             dbgln("Ext2FSInode[{}]::resize(): Shrinking inode, old block list is {} entries:", identifier(), m_block_list.size());
             for (auto block_index : m_block_list) {
@@ -763,6 +909,11 @@ ErrorOr<void> Ext2FSInode::traverse_as_directory(Function<ErrorOr<void>(FileSyst
 ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries)
 {
     MutexLocker locker(m_inode_lock);
+    if (TRY(write_indexed_directory(entries)))
+        return {};
+
+    // The directory is written as a plain list of entries, which any index it had wouldn't match anymore.
+    m_raw_inode.i_flags &= ~EXT2_INDEX_FL;
     auto block_size = fs().block_size();
 
     // Calculate directory size and record length of entries so that
@@ -834,6 +985,15 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_child(): Adding inode {} with name '{}' and mode {:o} to directory {}", identifier(), child.index(), name, mode, index());
 
+    if (TRY(add_child_to_directory_index(child, name, to_ext2_file_type(mode)))) {
+        if (!m_lookup_cache.is_empty()) {
+            auto cache_entry_name = TRY(KString::try_create(name));
+            TRY(m_lookup_cache.try_set(move(cache_entry_name), child.index()));
+        }
+        did_add_child(child.identifier(), name);
+        return {};
+    }
+
     Vector<Ext2FSDirectoryEntry> entries;
     TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
         if (name == entry.name)
@@ -863,28 +1023,34 @@ ErrorOr<void> Ext2FSInode::remove_child(StringView name)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::remove_child(): Removing '{}'", identifier(), name);
     VERIFY(is_directory());
 
-    TRY(populate_lookup_cache());
-
-    auto it = m_lookup_cache.find(name);
-    if (it == m_lookup_cache.end())
-        return ENOENT;
-    auto child_inode_index = (*it).value;
+    InodeIndex child_inode_index;
+    if (auto removed_index = TRY(remove_child_from_directory_index(name)); removed_index.has_value()) {
+        child_inode_index = removed_index.value();
+        if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end())
+            m_lookup_cache.remove(it);
+    } else {
+        TRY(populate_lookup_cache());
 
-    InodeIdentifier child_id { fsid(), child_inode_index };
+        auto it = m_lookup_cache.find(name);
+        if (it == m_lookup_cache.end())
+            return ENOENT;
+        child_inode_index = (*it).value;
 
-    Vector<Ext2FSDirectoryEntry> entries;
-    TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
-        if (name != entry.name) {
-            auto entry_name = TRY(KString::try_create(entry.name));
-            TRY(entries.try_append({ move(entry_name), entry.inode.index(), entry.file_type }));
-        }
-        return {};
-    }));
+        Vector<Ext2FSDirectoryEntry> entries;
+        TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
+            if (name != entry.name) {
+                auto entry_name = TRY(KString::try_create(entry.name));
+                TRY(entries.try_append({ move(entry_name), entry.inode.index(), entry.file_type }));
+            }
+            return {};
+        }));
 
-    TRY(write_directory(entries));
+        TRY(write_directory(entries));
 
-    m_lookup_cache.remove(it);
+        m_lookup_cache.remove(it);
+    }
 
+    InodeIdentifier child_id { fsid(), child_inode_index };
     auto child_inode = TRY(fs().get_inode(child_id));
     TRY(child_inode->decrement_link_count());
 
@@ -910,6 +1076,373 @@ ErrorOr<void> Ext2FSInode::populate_lookup_cache()
     return {};
 }
 
+bool Ext2FSInode::can_use_directory_index() const
+{
+    auto const& super_block = fs().super_block();
+    // FIXME: Support the checksums that metadata_csum file systems add to index nodes.
+    return (super_block.s_feature_compat & EXT2_FEATURE_COMPAT_DIR_INDEX) != 0
+        && (super_block.s_feature_ro_compat & EXT4_FEATURE_RO_COMPAT_METADATA_CSUM) == 0;
+}
+
+bool Ext2FSInode::is_indexed_directory() const
+{
+    return is_directory() && (m_raw_inode.i_flags & EXT2_INDEX_FL) != 0 && can_use_directory_index();
+}
+
+u8 Ext2FSInode::effective_directory_hash_version(u8 hash_version) const
+{
+    // Whether names are hashed as signed or unsigned characters is recorded in the super block, not in the index.
+    if (hash_version <= EXT2_HASH_TEA && (fs().super_block().s_flags & EXT2_FLAGS_UNSIGNED_HASH) != 0)
+        return hash_version + EXT2_HASH_LEGACY_UNSIGNED;
+    return hash_version;
+}
+
+ErrorOr<void> Ext2FSInode::read_directory_block(u32 block, Bytes data) const
+{
+    VERIFY(data.size() == fs().block_size());
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(data.data());
+    auto nread = TRY(read_bytes(static_cast<u64>(block) * data.size(), data.size(), buffer, nullptr));
+    if (nread != data.size())
+        return EIO;
+    return {};
+}
+
+ErrorOr<void> Ext2FSInode::write_directory_block(u32 block, Bytes data)
+{
+    VERIFY(data.size() == fs().block_size());
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(data.data());
+    auto nwritten = TRY(write_bytes(static_cast<u64>(block) * data.size(), data.size(), buffer, nullptr));
+    if (nwritten != data.size())
+        return EIO;
+    return {};
+}
+
+ErrorOr<Optional<Ext2FSInode::DirectoryIndexPath>> Ext2FSInode::probe_directory_index(StringView name) const
+{
+    VERIFY(is_indexed_directory());
+    auto block_size = fs().block_size();
+    auto block_count = size() / block_size;
+
+    auto data = TRY(ByteBuffer::create_uninitialized(block_size));
+    TRY(read_directory_block(0, data.bytes()));
+
+    auto const& info = *reinterpret_cast<ext2_dx_root_info const*>(data.data() + ext2_directory_index_root_info_offset);
+    if (info.reserved_zero != 0 || info.info_length < sizeof(ext2_dx_root_info) || info.indirect_levels >= ext2_directory_index_max_levels || !is_supported_ext2_directory_hash_version(info.hash_version)) {
+        dbgln("Ext2FSInode[{}]::probe_directory_index(): Unsupported directory index, falling back to a linear search", identifier());
+        return Optional<DirectoryIndexPath> {};
+    }
+
+    DirectoryIndexPath path;
+    path.hash_version = effective_directory_hash_version(info.hash_version);
+    path.hash = ext2_directory_hash(name, path.hash_version, fs().super_block().s_hash_seed);
+
+    u8 indirect_levels = info.indirect_levels;
+    u32 block = 0;
+    size_t entries_offset = ext2_directory_index_root_info_offset + info.info_length;
+    for (size_t level = 0; level <= indirect_levels; ++level) {
+        DirectoryIndexLevel index_level { block, move(data), entries_offset, 0 };
+        auto [limit, count] = index_level.count_and_limit();
+        if (count == 0 || count > limit || entries_offset + limit * sizeof(ext2_dx_entry) > block_size) {
+            dbgln("Ext2FSInode[{}]::probe_directory_index(): Corrupted index block {}, falling back to a linear search", identifier(), block);
+            return Optional<DirectoryIndexPath> {};
+        }
+
+        // The first entry has no hash, as its place is taken by the count and limit; it covers everything below the second one.
+        auto* entries = index_level.entries();
+        size_t low = 1;
+        size_t high = count;
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (entries[middle].hash > path.hash)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        index_level.position = low - 1;
+
+        block = index_level.child_block();
+        if (block == 0 || block >= block_count) {
+            dbgln("Ext2FSInode[{}]::probe_directory_index(): Index points to block {} of {}, falling back to a linear search", identifier(), block, block_count);
+            return Optional<DirectoryIndexPath> {};
+        }
+        TRY(path.levels.try_append(move(index_level)));
+
+        if (level < indirect_levels) {
+            data = TRY(ByteBuffer::create_uninitialized(block_size));
+            TRY(read_directory_block(block, data.bytes()));
+            entries_offset = ext2_directory_index_node_entries_offset;
+        }
+    }
+    return Optional<DirectoryIndexPath> { move(path) };
+}
+
+ErrorOr<bool> Ext2FSInode::advance_directory_index(DirectoryIndexPath& path) const
+{
+    // Names with the same hash can be spread over several leaves. The index entries of
+    // all but the first of those leaves have the hash with its lowest bit set.
+    size_t level = path.levels.size();
+    while (level > 0 && path.levels[level - 1].position + 1 >= path.levels[level - 1].count_and_limit().count)
+        --level;
+    if (level == 0)
+        return false;
+
+    auto& advanced_level = path.levels[level - 1];
+    ++advanced_level.position;
+    if ((advanced_level.entries()[advanced_level.position].hash & ~ext2_directory_index_hash_continued) != path.hash)
+        return false;
+
+    auto block_count = size() / fs().block_size();
+    for (; level < path.levels.size(); ++level) {
+        auto& parent = path.levels[level - 1];
+        auto& index_level = path.levels[level];
+        index_level.block = parent.child_block();
+        index_level.position = 0;
+        if (index_level.block == 0 || index_level.block >= block_count)
+            return EIO;
+        TRY(read_directory_block(index_level.block, index_level.data.bytes()));
+        auto [limit, count] = index_level.count_and_limit();
+        if (count == 0 || count > limit)
+            return EIO;
+    }
+    if (path.leaf_block() == 0 || path.leaf_block() >= block_count)
+        return EIO;
+    return true;
+}
+
+ErrorOr<Optional<Ext2FSInode::IndexedDirectoryEntry>> Ext2FSInode::find_in_directory_index(StringView name) const
+{
+    auto data = TRY(ByteBuffer::create_uninitialized(fs().block_size()));
+
+    // "." and ".." aren't part of the index, they are in front of its root.
+    if (name == "."sv || name == ".."sv) {
+        TRY(read_directory_block(0, data.bytes()));
+        auto offset = find_entry_in_directory_block(data.bytes(), name);
+        if (!offset.has_value())
+            return ENOENT;
+        return Optional<IndexedDirectoryEntry> { { 0, move(data), offset.value() } };
+    }
+
+    auto path = TRY(probe_directory_index(name));
+    if (!path.has_value())
+        return Optional<IndexedDirectoryEntry> {};
+
+    do {
+        auto block = path->leaf_block();
+        TRY(read_directory_block(block, data.bytes()));
+        if (auto offset = find_entry_in_directory_block(data.bytes(), name); offset.has_value())
+            return Optional<IndexedDirectoryEntry> { { block, move(data), offset.value() } };
+    } while (TRY(advance_directory_index(*path)));
+    return ENOENT;
+}
+
+ErrorOr<bool> Ext2FSInode::add_child_to_directory_index(Inode& child, StringView name, u8 file_type)
+{
+    VERIFY(m_inode_lock.is_exclusively_locked_by_current_thread());
+    if (!is_indexed_directory() || name == "."sv || name == ".."sv)
+        return false;
+
+    auto existing_entry = find_in_directory_index(name);
+    if (existing_entry.is_error()) {
+        if (existing_entry.error().code() != ENOENT)
+            return existing_entry.release_error();
+    } else if (existing_entry.value().has_value()) {
+        return EEXIST;
+    } else {
+        return false;
+    }
+
+    auto maybe_path = TRY(probe_directory_index(name));
+    if (!maybe_path.has_value())
+        return false;
+    auto& path = maybe_path.value();
+
+    auto block_size = fs().block_size();
+    auto leaf_block = path.leaf_block();
+    auto leaf = TRY(ByteBuffer::create_uninitialized(block_size));
+    TRY(read_directory_block(leaf_block, leaf.bytes()));
+
+    if (insert_entry_into_directory_block(leaf.bytes(), name, child.index(), file_type)) {
+        TRY(child.increment_link_count());
+        TRY(write_directory_block(leaf_block, leaf.bytes()));
+        return true;
+    }
+
+    // The leaf is full, so it is split in two by hash and the upper half moves to a new block.
+    // FIXME: Split index nodes as well. Until then, the caller rebuilds the directory when they fill up.
+    auto& parent = path.levels.last();
+    if (parent.count_and_limit().count >= parent.count_and_limit().limit)
+        return false;
+    u32 new_block = size() / block_size;
+    if (new_block > ext2_directory_index_block_mask)
+        return false;
+
+    Vector<DirectoryBlockEntry> entries;
+    TRY(entries.try_ensure_capacity(block_size / EXT2_DIR_REC_LEN(1) + 1));
+    bool is_valid = for_each_entry_in_directory_block(leaf.bytes(), [&](size_t, auto& entry) {
+        if (entry.inode == 0)
+            return IterationDecision::Continue;
+        StringView entry_name { entry.name, entry.name_len };
+        entries.unchecked_append({ entry_name, entry.inode, entry.file_type, ext2_directory_hash(entry_name, path.hash_version, fs().super_block().s_hash_seed) });
+        return IterationDecision::Continue;
+    });
+    if (!is_valid)
+        return EIO;
+    entries.unchecked_append({ name, child.index(), file_type, path.hash });
+    quick_sort(entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    size_t total_length = 0;
+    for (auto const& entry : entries)
+        total_length += EXT2_DIR_REC_LEN(entry.name.length());
+    size_t split = 0;
+    size_t lower_length = 0;
+    while (split + 1 < entries.size() && lower_length + EXT2_DIR_REC_LEN(entries[split].name.length()) <= total_length / 2)
+        lower_length += EXT2_DIR_REC_LEN(entries[split++].name.length());
+    if (split == 0)
+        split = 1;
+
+    u32 split_hash = entries[split].hash;
+    if (entries[split - 1].hash == split_hash)
+        split_hash |= ext2_directory_index_hash_continued;
+
+    TRY(child.increment_link_count());
+    TRY(resize(static_cast<u64>(new_block + 1) * block_size));
+
+    auto upper_leaf = TRY(ByteBuffer::create_uninitialized(block_size));
+    fill_directory_block(upper_leaf.bytes(), entries.span().slice(split));
+    TRY(write_directory_block(new_block, upper_leaf.bytes()));
+
+    // The names of the entries point into the old leaf, so the lower half is laid out in a separate buffer.
+    auto lower_leaf = TRY(ByteBuffer::create_uninitialized(block_size));
+    fill_directory_block(lower_leaf.bytes(), entries.span().slice(0, split));
+    TRY(write_directory_block(leaf_block, lower_leaf.bytes()));
+
+    auto& count = parent.count_and_limit().count;
+    auto* index_entries = parent.entries();
+    auto insert_at = parent.position + 1;
+    memmove(&index_entries[insert_at + 1], &index_entries[insert_at], (count - insert_at) * sizeof(ext2_dx_entry));
+    index_entries[insert_at] = { split_hash, new_block };
+    ++count;
+    TRY(write_directory_block(parent.block, parent.data.bytes()));
+    return true;
+}
+
+ErrorOr<Optional<InodeIndex>> Ext2FSInode::remove_child_from_directory_index(StringView name)
+{
+    VERIFY(m_inode_lock.is_exclusively_locked_by_current_thread());
+    // Removing "." or ".." would disturb the root of the index, so those go through a rewrite.
+    if (!is_indexed_directory() || name == "."sv || name == ".."sv)
+        return Optional<InodeIndex> {};
+
+    auto maybe_entry = TRY(find_in_directory_index(name));
+    if (!maybe_entry.has_value())
+        return Optional<InodeIndex> {};
+    auto& indexed_entry = maybe_entry.value();
+
+    auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(indexed_entry.data.data() + indexed_entry.offset);
+    InodeIndex child_index = entry.inode;
+
+    // The previous entry in the block absorbs the removed one, unless it's the first one, which is only marked as unused.
+    ext2_dir_entry_2* previous_entry = nullptr;
+    for_each_entry_in_directory_block(indexed_entry.data.bytes(), [&](size_t offset, auto& candidate) {
+        if (offset + candidate.rec_len != indexed_entry.offset)
+            return IterationDecision::Continue;
+        previous_entry = &candidate;
+        return IterationDecision::Break;
+    });
+    if (previous_entry)
+        previous_entry->rec_len += entry.rec_len;
+    else
+        entry.inode = 0;
+
+    TRY(write_directory_block(indexed_entry.block, indexed_entry.data.bytes()));
+    return Optional<InodeIndex> { child_index };
+}
+
+ErrorOr<bool> Ext2FSInode::write_indexed_directory(Vector<Ext2FSDirectoryEntry>& entries)
+{
+    if (!can_use_directory_index())
+        return false;
+    if (entries.size() < 2 || entries[0].name->view() != "."sv || entries[1].name->view() != ".."sv)
+        return false;
+
+    // Directories that fit into a single block are cheap enough to scan, they only get an index once they outgrow it.
+    auto block_size = fs().block_size();
+    size_t total_length = 0;
+    for (auto const& entry : entries)
+        total_length += EXT2_DIR_REC_LEN(entry.name->length());
+    if (total_length <= block_size)
+        return false;
+
+    auto const& super_block = fs().super_block();
+    u8 hash_version = super_block.s_def_hash_version;
+    if (hash_version > EXT2_HASH_TEA)
+        hash_version = EXT2_HASH_HALF_MD4;
+    auto effective_hash_version = effective_directory_hash_version(hash_version);
+
+    Vector<DirectoryBlockEntry> sorted_entries;
+    TRY(sorted_entries.try_ensure_capacity(entries.size() - 2));
+    for (size_t i = 2; i < entries.size(); ++i) {
+        auto name = entries[i].name->view();
+        sorted_entries.unchecked_append({ name, entries[i].inode_index, entries[i].file_type, ext2_directory_hash(name, effective_hash_version, super_block.s_hash_seed) });
+    }
+    quick_sort(sorted_entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    // Leaves are filled completely, later insertions split them as needed.
+    Vector<size_t> leaf_starts;
+    size_t space_in_leaf = 0;
+    for (size_t i = 0; i < sorted_entries.size(); ++i) {
+        size_t length = EXT2_DIR_REC_LEN(sorted_entries[i].name.length());
+        if (length > space_in_leaf) {
+            TRY(leaf_starts.try_append(i));
+            space_in_leaf = block_size;
+        }
+        space_in_leaf -= length;
+    }
+
+    size_t entries_offset = ext2_directory_index_root_info_offset + sizeof(ext2_dx_root_info);
+    size_t limit = (block_size - entries_offset) / sizeof(ext2_dx_entry);
+    if (leaf_starts.size() > limit)
+        return false;
+
+    auto directory_data = TRY(ByteBuffer::create_zeroed((leaf_starts.size() + 1) * block_size));
+    auto root = directory_data.bytes().slice(0, block_size);
+    Array<DirectoryBlockEntry, 2> dot_entries { {
+        { entries[0].name->view(), entries[0].inode_index, entries[0].file_type, 0 },
+        { entries[1].name->view(), entries[1].inode_index, entries[1].file_type, 0 },
+    } };
+    fill_directory_block(root, dot_entries.span());
+
+    auto& info = *reinterpret_cast<ext2_dx_root_info*>(root.data() + ext2_directory_index_root_info_offset);
+    info = { 0, hash_version, sizeof(ext2_dx_root_info), 0, 0 };
+    auto& count_and_limit = *reinterpret_cast<ext2_dx_countlimit*>(root.data() + entries_offset);
+    count_and_limit = { static_cast<u16>(limit), static_cast<u16>(leaf_starts.size()) };
+    auto* index_entries = reinterpret_cast<ext2_dx_entry*>(root.data() + entries_offset);
+    index_entries[0].block = 1;
+
+    for (size_t leaf = 0; leaf < leaf_starts.size(); ++leaf) {
+        auto start = leaf_starts[leaf];
+        auto end = leaf + 1 < leaf_starts.size() ? leaf_starts[leaf + 1] : sorted_entries.size();
+        if (leaf > 0) {
+            auto hash = sorted_entries[start].hash;
+            if (sorted_entries[start - 1].hash == hash)
+                hash |= ext2_directory_index_hash_continued;
+            index_entries[leaf] = { hash, static_cast<u32>(leaf + 1) };
+        }
+        fill_directory_block(directory_data.bytes().slice((leaf + 1) * block_size, block_size), sorted_entries.span().slice(start, end - start));
+    }
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_indexed_directory(): Writing {} entries into {} leaves", identifier(), entries.size(), leaf_starts.size());
+
+    TRY(resize(directory_data.size()));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(directory_data.data());
+    auto nwritten = TRY(write_bytes(0, directory_data.size(), buffer, nullptr));
+    if (nwritten != directory_data.size())
+        return EIO;
+    m_raw_inode.i_flags |= EXT2_INDEX_FL;
+    set_metadata_dirty(true);
+    return true;
+}
+
 ErrorOr<NonnullLockRefPtr<Inode>> Ext2FSInode::lookup(StringView name)
 {
     VERIFY(is_directory());
@@ -918,13 +1451,22 @@ ErrorOr<NonnullLockRefPtr<Inode>> Ext2FSInode::lookup(StringView name)
     InodeIndex inode_index;
     {
         MutexLocker locker(m_inode_lock);
-        TRY(populate_lookup_cache());
-        auto it = m_lookup_cache.find(name);
-        if (it == m_lookup_cache.end()) {
-            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
-            return ENOENT;
+        // Large indexed directories only need a few of their blocks read to find a name, instead of all of them.
+        Optional<IndexedDirectoryEntry> indexed_entry;
+        if (m_lookup_cache.is_empty() && is_indexed_directory())
+            indexed_entry = TRY(find_in_directory_index(name));
+
+        if (indexed_entry.has_value()) {
+            inode_index = reinterpret_cast<ext2_dir_entry_2 const*>(indexed_entry->data.data() + indexed_entry->offset)->inode;
+        } else {
+            TRY(populate_lookup_cache());
+            auto it = m_lookup_cache.find(name);
+            if (it == m_lookup_cache.end()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            inode_index = it->value;
         }
-        inode_index = it->value;
     }
 
     return fs().get_inode({ fsid(), inode_index });
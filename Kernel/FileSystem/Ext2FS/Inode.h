@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
+#include <AK/ByteBuffer.h>
 #include <AK/HashMap.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
 #include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/UnixTypes.h>
@@ -46,6 +49,45 @@ private:
 
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> populate_lookup_cache();
+
+    struct DirectoryIndexLevel {
+        // The logical block in the directory, which is 0 for the root.
+        u32 block { 0 };
+        ByteBuffer data;
+        size_t entries_offset { 0 };
+        // The entry that covers the hash that is being looked for.
+        size_t position { 0 };
+
+        ext2_dx_countlimit& count_and_limit() { return *reinterpret_cast<ext2_dx_countlimit*>(data.data() + entries_offset); }
+        ext2_dx_entry* entries() { return reinterpret_cast<ext2_dx_entry*>(data.data() + entries_offset); }
+        u32 child_block() { return entries()[position].block & ext2_directory_index_block_mask; }
+    };
+
+    struct DirectoryIndexPath {
+        u8 hash_version { 0 };
+        u32 hash { 0 };
+        Vector<DirectoryIndexLevel, ext2_directory_index_max_levels> levels;
+
+        u32 leaf_block() { return levels.last().child_block(); }
+    };
+
+    struct IndexedDirectoryEntry {
+        u32 block { 0 };
+        ByteBuffer data;
+        size_t offset { 0 };
+    };
+
+    bool can_use_directory_index() const;
+    bool is_indexed_directory() const;
+    u8 effective_directory_hash_version(u8 hash_version) const;
+    ErrorOr<void> read_directory_block(u32 block, Bytes) const;
+    ErrorOr<void> write_directory_block(u32 block, Bytes);
+    ErrorOr<Optional<DirectoryIndexPath>> probe_directory_index(StringView name) const;
+    ErrorOr<bool> advance_directory_index(DirectoryIndexPath&) const;
+    ErrorOr<Optional<IndexedDirectoryEntry>> find_in_directory_index(StringView name) const;
+    ErrorOr<bool> add_child_to_directory_index(Inode& child, StringView name, u8 file_type);
+    ErrorOr<Optional<InodeIndex>> remove_child_from_directory_index(StringView name);
+    ErrorOr<bool> write_indexed_directory(Vector<Ext2FSDirectoryEntry>&);
     ErrorOr<void> resize(u64);
     ErrorOr<void> write_indirect_block(BlockBasedFileSystem::BlockIndex, Span<BlockBasedFileSystem::BlockIndex>);
     ErrorOr<void> grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
@@ -54,6 +96,8 @@ private:
     ErrorOr<void> shrink_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
     ErrorOr<void> flush_block_list();
 
+    void read_ahead_if_sequential(off_t offset, size_t nread) const;
+
     ErrorOr<void> compute_block_list_with_exclusive_locking();
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
@@ -69,6 +113,12 @@ private:
     ext2_inode m_raw_inode {};
 
     Mutex m_block_list_lock { "BlockList"sv };
+
+    // Sequential read detection, used to drive read-ahead.
+    mutable Atomic<u64> m_next_sequential_read_offset { 0 };
+    mutable Atomic<size_t> m_read_ahead_window { 0 };
+    // Logical index of the block after the last one we've issued read-ahead for.
+    mutable Atomic<u64> m_read_ahead_end { 0 };
 };
 
 inline Ext2FS& Ext2FSInode::fs()
@@ -42,64 +42,100 @@ FATInode::FATInode(FATFS& fs, FATEntry entry, NonnullOwnPtr<KString> filename)
     };
 }
 
-ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> FATInode::compute_block_list()
+ErrorOr<Vector<FATInode::ClusterRun>> FATInode::compute_cluster_runs()
 {
     VERIFY(m_inode_lock.is_locked());
 
-    dbgln_if(FAT_DEBUG, "FATFS: computing block list for inode {}", index());
+    dbgln_if(FAT_DEBUG, "FATFS: computing cluster runs for inode {}", index());
 
     u32 cluster = first_cluster();
+    u8 sectors_per_cluster = fs().boot_record()->sectors_per_cluster;
 
-    Vector<BlockBasedFileSystem::BlockIndex> block_list;
+    Vector<ClusterRun> cluster_runs;
+    u64 blocks_in_file = 0;
 
     auto fat_sector = TRY(KBuffer::try_create_with_size("FATFS: FAT read buffer"sv, fs().m_logical_block_size));
     auto fat_sector_buffer = UserOrKernelBuffer::for_kernel_buffer(fat_sector->data());
+    Optional<u32> fat_sector_in_buffer;
 
-    while (cluster < no_more_clusters) {
+    // Empty files don't have any clusters at all.
+    while (cluster >= FATFS::first_data_cluster && cluster < no_more_clusters) {
         dbgln_if(FAT_DEBUG, "FATFS: Appending cluster {} to inode {}'s cluster chain", cluster, index());
 
         BlockBasedFileSystem::BlockIndex first_block = fs().first_block_of_cluster(cluster);
-        for (u8 i = 0; i < fs().boot_record()->sectors_per_cluster; i++)
-            block_list.append(BlockBasedFileSystem::BlockIndex { first_block.value() + i });
+        if (!cluster_runs.is_empty() && cluster_runs.last().first_block.value() + cluster_runs.last().block_count == first_block.value()) {
+            cluster_runs.last().block_count += sectors_per_cluster;
+        } else {
+            TRY(cluster_runs.try_append({ blocks_in_file, first_block, sectors_per_cluster }));
+        }
+        blocks_in_file += sectors_per_cluster;
 
         u32 fat_offset = cluster * sizeof(u32);
         u32 fat_sector_index = fs().boot_record()->reserved_sector_count + (fat_offset / fs().m_logical_block_size);
         u32 entry_offset = fat_offset % fs().m_logical_block_size;
 
-        TRY(fs().raw_read(fat_sector_index, fat_sector_buffer));
+        // Consecutive clusters usually have their entries in the same FAT sector.
+        if (fat_sector_in_buffer != fat_sector_index) {
+            TRY(fs().raw_read(fat_sector_index, fat_sector_buffer));
+            fat_sector_in_buffer = fat_sector_index;
+        }
 
         cluster = *reinterpret_cast<u32*>(&fat_sector->data()[entry_offset]);
         cluster &= cluster_number_mask;
     }
 
-    return block_list;
+    return cluster_runs;
 }
 
-ErrorOr<NonnullOwnPtr<KBuffer>> FATInode::read_block_list()
+ErrorOr<void> FATInode::ensure_cluster_runs()
 {
     VERIFY(m_inode_lock.is_locked());
+    MutexLocker locker(m_cluster_runs_lock);
+    if (m_cluster_runs_computed)
+        return {};
+    m_cluster_runs = TRY(compute_cluster_runs());
+    m_cluster_runs_computed = true;
+    return {};
+}
 
-    dbgln_if(FAT_DEBUG, "FATFS: reading block list for inode {} ({} blocks)", index(), m_block_list.size());
+u64 FATInode::allocated_block_count() const
+{
+    VERIFY(m_cluster_runs_computed);
+    if (m_cluster_runs.is_empty())
+        return 0;
+    return m_cluster_runs.last().first_block_in_file + m_cluster_runs.last().block_count;
+}
 
-    if (m_block_list.is_empty())
-        m_block_list = TRY(compute_block_list());
+size_t FATInode::cluster_run_index_for_block(u64 block_in_file) const
+{
+    VERIFY(block_in_file < allocated_block_count());
+    size_t low = 0;
+    size_t high = m_cluster_runs.size();
+    while (high - low > 1) {
+        size_t middle = low + (high - low) / 2;
+        if (m_cluster_runs[middle].first_block_in_file <= block_in_file)
+            low = middle;
+        else
+            high = middle;
+    }
+    return low;
+}
 
-    auto builder = TRY(KBufferBuilder::try_create());
+ErrorOr<NonnullOwnPtr<KBuffer>> FATInode::read_block_list()
+{
+    VERIFY(m_inode_lock.is_locked());
 
-    u8 buffer[512];
-    VERIFY(fs().m_logical_block_size <= sizeof(buffer));
-    auto buf = UserOrKernelBuffer::for_kernel_buffer(buffer);
+    TRY(ensure_cluster_runs());
+    dbgln_if(FAT_DEBUG, "FATFS: reading block list for inode {} ({} blocks)", index(), allocated_block_count());
 
-    for (BlockBasedFileSystem::BlockIndex block : m_block_list) {
-        dbgln_if(FAT_DEBUG, "FATFS: reading block: {}", block);
-        TRY(fs().raw_read(block, buf));
-        TRY(builder.append((char const*)buffer, fs().m_logical_block_size));
+    auto blocks = TRY(KBuffer::try_create_with_size("FATFS: Block list"sv, max(allocated_block_count(), 1u) * fs().m_logical_block_size));
+    auto out = UserOrKernelBuffer::for_kernel_buffer(blocks->data());
+    for (auto& run : m_cluster_runs) {
+        dbgln_if(FAT_DEBUG, "FATFS: reading {} blocks starting at block {}", run.block_count, run.first_block);
+        TRY(fs().raw_read_blocks(run.first_block, run.block_count, out));
+        out = out.offset(run.block_count * fs().m_logical_block_size);
     }
-
-    auto blocks = builder.build();
-    if (!blocks)
-        return ENOMEM;
-    return blocks.release_nonnull();
+    return blocks;
 }
 
 ErrorOr<LockRefPtr<FATInode>> FATInode::traverse(Function<ErrorOr<bool>(LockRefPtr<FATInode>)> callback)
@@ -189,13 +225,44 @@ u32 FATInode::first_cluster() const
 
 ErrorOr<size_t> FATInode::read_bytes_locked(off_t offset, size_t size, UserOrKernelBuffer& buffer, OpenFileDescription*) const
 {
+    VERIFY(m_inode_lock.is_locked());
     dbgln_if(FAT_DEBUG, "FATFS: Reading inode {}: size: {} offset: {}", identifier().index(), size, offset);
 
-    // FIXME: Read only the needed blocks instead of the whole file
-    auto blocks = TRY(const_cast<FATInode&>(*this).read_block_list());
-    TRY(buffer.write(blocks->data() + offset, min(size, m_block_list.size() * fs().m_logical_block_size - offset)));
+    auto& inode = const_cast<FATInode&>(*this);
+    TRY(inode.ensure_cluster_runs());
+
+    // Directories have no size of their own, so they go up to the end of their last cluster.
+    size_t block_size = fs().m_logical_block_size;
+    u64 end = allocated_block_count() * block_size;
+    if (!has_flag(m_entry.attributes, FATAttributes::Directory))
+        end = min(end, static_cast<u64>(m_entry.file_size));
+    if (static_cast<u64>(offset) >= end)
+        return 0;
+
+    size_t total_bytes = min(static_cast<u64>(size), end - offset);
+    u64 block_in_file = offset / block_size;
+    size_t offset_into_block = offset % block_size;
+    size_t run_index = cluster_run_index_for_block(block_in_file);
+
+    size_t nread = 0;
+    while (nread != total_bytes) {
+        auto& run = m_cluster_runs[run_index];
+        if (block_in_file >= run.first_block_in_file + run.block_count) {
+            ++run_index;
+            continue;
+        }
+
+        auto block = BlockBasedFileSystem::BlockIndex { run.first_block.value() + (block_in_file - run.first_block_in_file) };
+        size_t bytes_to_read = min(total_bytes - nread, block_size - offset_into_block);
+        auto buffer_offset = buffer.offset(nread);
+        TRY(fs().read_block(block, &buffer_offset, bytes_to_read, offset_into_block));
+
+        nread += bytes_to_read;
+        offset_into_block = 0;
+        ++block_in_file;
+    }
 
-    return min(size, m_block_list.size() * fs().m_logical_block_size - offset);
+    return nread;
 }
 
 InodeMetadata FATInode::metadata() const
@@ -47,7 +47,17 @@ private:
     static StringView byte_terminated_string(StringView, u8);
     static time_t fat_date_time(FATPackedDate date, FATPackedTime time);
 
-    ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list();
+    // A stretch of the file that lies in consecutive blocks on the disk.
+    struct ClusterRun {
+        u64 first_block_in_file { 0 };
+        BlockBasedFileSystem::BlockIndex first_block;
+        u64 block_count { 0 };
+    };
+
+    ErrorOr<void> ensure_cluster_runs();
+    ErrorOr<Vector<ClusterRun>> compute_cluster_runs();
+    u64 allocated_block_count() const;
+    size_t cluster_run_index_for_block(u64 block_in_file) const;
     ErrorOr<NonnullOwnPtr<KBuffer>> read_block_list();
     ErrorOr<LockRefPtr<FATInode>> traverse(Function<ErrorOr<bool>(LockRefPtr<FATInode>)> callback);
     u32 first_cluster() const;
@@ -66,7 +76,11 @@ private:
     virtual ErrorOr<void> chown(UserID, GroupID) override;
     virtual ErrorOr<void> flush_metadata() override;
 
-    Vector<BlockBasedFileSystem::BlockIndex> m_block_list;
+    // Built from the cluster chain on first use, and never changed afterwards. Reads only hold
+    // m_inode_lock shared, so building them takes a lock of its own.
+    Mutex m_cluster_runs_lock { "FATInode::m_cluster_runs"sv };
+    Vector<ClusterRun> m_cluster_runs;
+    bool m_cluster_runs_computed { false };
     FATEntry m_entry;
     NonnullOwnPtr<KString> m_filename;
     InodeMetadata m_metadata;
@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,10 +22,35 @@ namespace Kernel {
 
 class File;
 
+// Gets told whenever the readiness of a file may have changed, without having to block a thread on it.
+class FileReadinessWatcher : public AtomicRefCounted<FileReadinessWatcher> {
+public:
+    virtual ~FileReadinessWatcher() = default;
+
+    virtual void file_readiness_may_have_changed() = 0;
+
+private:
+    friend class FileBlockerSet;
+    IntrusiveListNode<FileReadinessWatcher> m_blocker_set_list_node;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
 
+    // NOTE: Watchers have to be removed again before their last reference goes away.
+    void add_readiness_watcher(FileReadinessWatcher& watcher)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_watchers.append(watcher);
+    }
+
+    void remove_readiness_watcher(FileReadinessWatcher& watcher)
+    {
+        SpinlockLocker lock(m_lock);
+        m_readiness_watchers.remove(watcher);
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -34,13 +60,24 @@ public:
 
     void unblock_all_blockers_whose_conditions_are_met()
     {
-        SpinlockLocker lock(m_lock);
-        BlockerSet::unblock_all_blockers_whose_conditions_are_met_locked([&](auto& b, void* data, bool&) {
-            VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
-            auto& blocker = static_cast<Thread::FileBlocker&>(b);
-            return blocker.unblock_if_conditions_are_met(false, data);
-        });
+        Vector<NonnullLockRefPtr<FileReadinessWatcher>, 4> readiness_watchers;
+        {
+            SpinlockLocker lock(m_lock);
+            BlockerSet::unblock_all_blockers_whose_conditions_are_met_locked([&](auto& b, void* data, bool&) {
+                VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
+                auto& blocker = static_cast<Thread::FileBlocker&>(b);
+                return blocker.unblock_if_conditions_are_met(false, data);
+            });
+            for (auto& watcher : m_readiness_watchers)
+                readiness_watchers.append(watcher);
+        }
+        // NOTE: Watchers are told without holding our lock, since they will want to look at the file's readiness.
+        for (auto& watcher : readiness_watchers)
+            watcher->file_readiness_may_have_changed();
     }
+
+private:
+    IntrusiveList<&FileReadinessWatcher::m_blocker_set_list_node> m_readiness_watchers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -90,7 +127,7 @@ public:
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) = 0;
     virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) = 0;
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg);
-    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared);
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, OpenFileDescription&, Memory::VirtualRange const&, u64& offset, bool shared);
     virtual ErrorOr<struct stat> stat() const { return EBADF; }
 
     // Although this might be better described "name" or "description", these terms already have other meanings.
@@ -114,6 +151,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_io_ring() const { return false; }
+    virtual bool is_event_poll() const { return false; }
 
     virtual FileBlockerSet& blocker_set() { return m_blocker_set; }
 
@@ -33,6 +33,9 @@ public:
     virtual StringView class_name() const = 0;
     virtual Inode& root_inode() = 0;
     virtual bool supports_watchers() const { return false; }
+    // Only for file systems that report every change to a directory through Inode::did_add_child() and
+    // Inode::did_remove_child(), or that never change.
+    virtual bool supports_directory_entry_cache() const { return false; }
 
     bool is_readonly() const { return m_readonly; }
 
@@ -52,11 +55,14 @@ public:
     };
 
     virtual void flush_writes() { }
+    // Called periodically by the write-back task to get old dirty data to disk without a full sync.
+    virtual void write_back_dirty_blocks() { }
 
     u64 block_size() const { return m_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
     virtual bool is_file_backed() const { return false; }
+    virtual bool is_block_based() const { return false; }
 
     // Converts file types that are used internally by the filesystem to DT_* types
     virtual u8 internal_file_type_to_directory_entry_type(DirectoryEntryView const& entry) const { return entry.file_type; }
@@ -19,6 +19,9 @@ struct ISO9660FSDirectoryEntry final : public AtomicRefCounted<ISO9660FSDirector
     //       We need it as an OwnPtr to default-construct this struct.
     OwnPtr<KBuffer> blocks;
 
+    // NOTE: This is guarded by the directory entry cache lock of the filesystem.
+    u64 last_used { 0 };
+
     static ErrorOr<NonnullLockRefPtr<ISO9660FSDirectoryEntry>> try_create(u32 extent, u32 length, OwnPtr<KBuffer> blocks)
     {
         return adopt_nonnull_lock_ref_or_enomem(new (nothrow) ISO9660FSDirectoryEntry(extent, length, move(blocks)));
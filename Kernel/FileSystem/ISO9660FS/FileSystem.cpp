@@ -15,6 +15,7 @@ namespace Kernel {
 constexpr u32 first_data_area_block = 16;
 constexpr u32 logical_sector_size = 2048;
 constexpr u32 max_cached_directory_entries = 128;
+constexpr size_t max_cached_directory_entries_size = 4 * MiB;
 
 ErrorOr<NonnullLockRefPtr<FileSystem>> ISO9660FS::try_create(OpenFileDescription& description)
 {
@@ -230,33 +231,69 @@ ErrorOr<NonnullLockRefPtr<ISO9660FSDirectoryEntry>> ISO9660FS::directory_entry_f
     u32 data_length = LittleEndian { record->data_length.little };
 
     auto key = calculate_directory_entry_cache_key(*record);
-    auto it = m_directory_entry_cache.find(key);
-    if (it != m_directory_entry_cache.end()) {
-        dbgln_if(ISO9660_DEBUG, "Cache hit for dirent @ {}", extent_location);
-        return it->value;
+    {
+        SpinlockLocker locker(m_directory_entry_cache_lock);
+        auto it = m_directory_entry_cache.find(key);
+        if (it != m_directory_entry_cache.end()) {
+            dbgln_if(ISO9660_DEBUG, "Cache hit for dirent @ {}", extent_location);
+            it->value->last_used = ++m_directory_entry_cache_clock;
+            return it->value;
+        }
     }
     dbgln_if(ISO9660_DEBUG, "Cache miss for dirent @ {} :^(", extent_location);
 
-    if (m_directory_entry_cache.size() == max_cached_directory_entries) {
-        // FIXME: A smarter algorithm would probably be nicer.
-        m_directory_entry_cache.remove(m_directory_entry_cache.begin());
-    }
-
     if (!(data_length % logical_block_size() == 0)) {
         dbgln_if(ISO9660_DEBUG, "Found a directory with non-logical block size aligned data length!");
         return EIO;
     }
 
+    // NOTE: We don't hold the lock while reading, so someone else might read and cache the same directory
+    //       in the meantime, in which case we use theirs.
     auto blocks = TRY(KBuffer::try_create_with_size("ISO9660FS: Directory traversal buffer"sv, data_length, Memory::Region::Access::Read | Memory::Region::Access::Write));
     auto blocks_buffer = UserOrKernelBuffer::for_kernel_buffer(blocks->data());
     TRY(raw_read_blocks(BlockBasedFileSystem::BlockIndex { extent_location }, data_length / logical_block_size(), blocks_buffer));
     auto entry = TRY(ISO9660FSDirectoryEntry::try_create(extent_location, data_length, move(blocks)));
-    m_directory_entry_cache.set(key, entry);
+
+    // The entries that are evicted might be the last references, which have to be dropped without holding the lock.
+    Vector<NonnullLockRefPtr<ISO9660FSDirectoryEntry>> evicted_entries;
+    TRY(evicted_entries.try_ensure_capacity(max_cached_directory_entries));
+    SpinlockLocker locker(m_directory_entry_cache_lock);
+    if (auto it = m_directory_entry_cache.find(key); it != m_directory_entry_cache.end()) {
+        it->value->last_used = ++m_directory_entry_cache_clock;
+        return it->value;
+    }
+
+    // Directories that are larger than the whole cache are simply not cached.
+    if (data_length > max_cached_directory_entries_size)
+        return entry;
+    while (m_directory_entry_cache.size() >= max_cached_directory_entries || m_directory_entry_cache_size + data_length > max_cached_directory_entries_size)
+        evicted_entries.unchecked_append(evict_least_recently_used_directory_entry());
+
+    TRY(m_directory_entry_cache.try_set(key, entry));
+    entry->last_used = ++m_directory_entry_cache_clock;
+    m_directory_entry_cache_size += data_length;
 
     dbgln_if(ISO9660_DEBUG, "Cached dirent @ {}", extent_location);
     return entry;
 }
 
+NonnullLockRefPtr<ISO9660FSDirectoryEntry> ISO9660FS::evict_least_recently_used_directory_entry()
+{
+    VERIFY(m_directory_entry_cache_lock.is_locked());
+    VERIFY(!m_directory_entry_cache.is_empty());
+
+    auto least_recently_used = m_directory_entry_cache.begin();
+    for (auto it = m_directory_entry_cache.begin(); it != m_directory_entry_cache.end(); ++it) {
+        if (it->value->last_used < least_recently_used->value->last_used)
+            least_recently_used = it;
+    }
+    dbgln_if(ISO9660_DEBUG, "Evicting dirent @ {}", least_recently_used->value->extent);
+    NonnullLockRefPtr<ISO9660FSDirectoryEntry> entry = least_recently_used->value;
+    m_directory_entry_cache_size -= entry->length;
+    m_directory_entry_cache.remove(least_recently_used);
+    return entry;
+}
+
 u32 ISO9660FS::calculate_directory_entry_cache_key(ISO::DirectoryRecordHeader const& record)
 {
     return LittleEndian { record.extent_location.little };
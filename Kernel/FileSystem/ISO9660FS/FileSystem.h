@@ -18,6 +18,7 @@
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
+#include <Kernel/Locking/Spinlock.h>
 
 namespace Kernel {
 
@@ -33,6 +34,7 @@ public:
 
     virtual ~ISO9660FS() override;
     virtual StringView class_name() const override { return "ISO9660FS"sv; }
+    virtual bool supports_directory_entry_cache() const override { return true; }
     virtual Inode& root_inode() override;
 
     virtual unsigned total_block_count() const override;
@@ -61,8 +63,14 @@ private:
     OwnPtr<ISO::PrimaryVolumeDescriptor> m_primary_volume;
     LockRefPtr<ISO9660Inode> m_root_inode;
 
+    NonnullLockRefPtr<ISO9660FSDirectoryEntry> evict_least_recently_used_directory_entry();
+
     mutable u32 m_cached_inode_count { 0 };
+
+    Spinlock m_directory_entry_cache_lock { LockRank::None };
     HashMap<u32, NonnullLockRefPtr<ISO9660FSDirectoryEntry>> m_directory_entry_cache;
+    size_t m_directory_entry_cache_size { 0 };
+    u64 m_directory_entry_cache_clock { 0 };
 };
 
 }
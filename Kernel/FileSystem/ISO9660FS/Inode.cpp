@@ -20,31 +20,51 @@ ErrorOr<size_t> ISO9660Inode::read_bytes_locked(off_t offset, size_t size, UserO
     if (static_cast<u64>(offset) >= data_length)
         return 0;
 
-    auto block = TRY(KBuffer::try_create_with_size("ISO9660FS: Inode read buffer"sv, fs().m_logical_block_size));
-    auto block_buffer = UserOrKernelBuffer::for_kernel_buffer(block->data());
+    // NOTE: Files are a single extent, so we can go straight to the blocks we need. These go
+    //       through the block cache, which is sized in block_size() units rather than logical blocks.
+    size_t block_size = fs().block_size();
+    u64 extent_start = static_cast<u64>(extent_location) * fs().logical_block_size();
+    u64 position = extent_start + offset;
 
     size_t total_bytes = min(size, data_length - offset);
     size_t nread = 0;
-    size_t blocks_already_read = offset / fs().m_logical_block_size;
-    size_t initial_offset = offset % fs().m_logical_block_size;
-
-    auto current_block_index = BlockBasedFileSystem::BlockIndex { extent_location + blocks_already_read };
     while (nread != total_bytes) {
-        size_t bytes_to_read = min(total_bytes - nread, fs().logical_block_size() - initial_offset);
+        auto block_index = BlockBasedFileSystem::BlockIndex { position / block_size };
+        size_t offset_into_block = position % block_size;
+        size_t bytes_to_read = min(total_bytes - nread, block_size - offset_into_block);
         auto buffer_offset = buffer.offset(nread);
-        dbgln_if(ISO9660_VERY_DEBUG, "ISO9660Inode::read_bytes: Reading {} bytes into buffer offset {}/{}, logical block index: {}", bytes_to_read, nread, total_bytes, current_block_index.value());
+        dbgln_if(ISO9660_VERY_DEBUG, "ISO9660Inode::read_bytes: Reading {} bytes into buffer offset {}/{}, block index: {}", bytes_to_read, nread, total_bytes, block_index.value());
 
-        TRY(const_cast<ISO9660FS&>(fs()).raw_read(current_block_index, block_buffer));
-        TRY(buffer_offset.write(block->data() + initial_offset, bytes_to_read));
+        TRY(fs().read_block(block_index, &buffer_offset, bytes_to_read, offset_into_block));
 
         nread += bytes_to_read;
-        initial_offset = 0;
-        current_block_index = BlockBasedFileSystem::BlockIndex { current_block_index.value() + 1 };
+        position += bytes_to_read;
     }
 
+    // If this read continues where the previous one stopped, the next blocks are probably wanted as well.
+    if (static_cast<u64>(offset) == m_sequential_read_end)
+        read_ahead(position, extent_start + data_length);
+    m_sequential_read_end = offset + nread;
+
     return nread;
 }
 
+void ISO9660Inode::read_ahead(u64 position, u64 extent_end) const
+{
+    size_t block_size = fs().block_size();
+    u64 first_block = ceil_div(position, static_cast<u64>(block_size));
+    u64 end_block = min(ceil_div(extent_end, static_cast<u64>(block_size)), first_block + max_read_ahead_blocks);
+    if (first_block >= end_block)
+        return;
+
+    Vector<BlockBasedFileSystem::BlockIndex> blocks;
+    if (blocks.try_ensure_capacity(end_block - first_block).is_error())
+        return;
+    for (auto block = first_block; block < end_block; ++block)
+        blocks.unchecked_append(BlockBasedFileSystem::BlockIndex { block });
+    fs().read_ahead(move(blocks));
+}
+
 InodeMetadata ISO9660Inode::metadata() const
 {
     return m_metadata;
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <Kernel/FileSystem/ISO9660FS/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
 
@@ -39,10 +40,14 @@ private:
     // without any problems, so let's allow it anyway.
     static constexpr size_t max_file_identifier_length = 256 - sizeof(ISO::DirectoryRecordHeader);
 
+    static constexpr size_t max_read_ahead_blocks = 16;
+
     // ^Inode
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const override;
     virtual ErrorOr<size_t> write_bytes_locked(off_t, size_t, UserOrKernelBuffer const& buffer, OpenFileDescription*) override;
 
+    void read_ahead(u64 position, u64 extent_end) const;
+
     ISO9660Inode(ISO9660FS&, ISO::DirectoryRecordHeader const& record, StringView name);
     static ErrorOr<NonnullLockRefPtr<ISO9660Inode>> try_create_from_directory_record(ISO9660FS&, ISO::DirectoryRecordHeader const& record, StringView name);
 
@@ -54,6 +59,9 @@ private:
 
     InodeMetadata m_metadata;
     ISO::DirectoryRecordHeader m_record;
+
+    // Where the last read stopped. Reads only hold m_inode_lock shared, and this is only a hint.
+    mutable Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_sequential_read_end { 0 };
 };
 
 }
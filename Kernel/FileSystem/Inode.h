@@ -69,6 +69,8 @@ public:
     virtual ErrorOr<void> chmod(mode_t) = 0;
     virtual ErrorOr<void> chown(UserID, GroupID) = 0;
     virtual ErrorOr<void> truncate(u64) { return {}; }
+    // Makes sure that the range is backed by storage, growing the inode if it ends past its size.
+    virtual ErrorOr<void> fallocate(u64 offset, u64 length);
 
     ErrorOr<NonnullRefPtr<Custody>> resolve_as_link(Credentials const&, Custody& base, RefPtr<Custody>* out_parent, int options, int symlink_recursion_level) const;
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/CommandLine.h>
 #include <Kernel/FileSystem/Plan9FS/FileSystem.h>
 #include <Kernel/FileSystem/Plan9FS/Inode.h>
 #include <Kernel/Process.h>
@@ -17,6 +18,7 @@ ErrorOr<NonnullLockRefPtr<FileSystem>> Plan9FS::try_create(OpenFileDescription&
 
 Plan9FS::Plan9FS(OpenFileDescription& file_description)
     : FileBackedFileSystem(file_description)
+    , m_attribute_cache_timeout(Time::from_milliseconds(kernel_command_line().plan9fs_attribute_timeout_ms()))
     , m_completion_blocker(*this)
 {
 }
@@ -279,10 +281,21 @@ ErrorOr<void> Plan9FS::post_message_and_explicitly_ignore_reply(Plan9FSMessage&
 
 ErrorOr<void> Plan9FS::post_message_and_wait_for_a_reply(Plan9FSMessage& message)
 {
-    auto request_type = message.type();
-    auto tag = message.tag();
-    auto completion = adopt_lock_ref(*new ReceiveCompletion(tag));
+    auto completion = TRY(post_message_expecting_a_reply(message));
+    return wait_for_a_reply(message, move(completion));
+}
+
+ErrorOr<NonnullLockRefPtr<Plan9FS::ReceiveCompletion>> Plan9FS::post_message_expecting_a_reply(Plan9FSMessage& message)
+{
+    auto completion = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) ReceiveCompletion(message.tag())));
     TRY(post_message(message, completion));
+    return completion;
+}
+
+ErrorOr<void> Plan9FS::wait_for_a_reply(Plan9FSMessage& message, NonnullLockRefPtr<ReceiveCompletion> completion)
+{
+    // The reply only replaces the request once we block on it, even if it has arrived already.
+    auto request_type = message.type();
     if (Thread::current()->block<Plan9FS::Blocker>({}, *this, message, completion).was_interrupted())
         return EINTR;
 
@@ -117,6 +117,9 @@ private:
     ErrorOr<void> do_read(u8* buffer, size_t);
     ErrorOr<void> read_and_dispatch_one_message();
     ErrorOr<void> post_message_and_wait_for_a_reply(Plan9FSMessage&);
+    // These split up post_message_and_wait_for_a_reply(), so that several requests can be in flight at once.
+    ErrorOr<NonnullLockRefPtr<ReceiveCompletion>> post_message_expecting_a_reply(Plan9FSMessage&);
+    ErrorOr<void> wait_for_a_reply(Plan9FSMessage&, NonnullLockRefPtr<ReceiveCompletion>);
     ErrorOr<void> post_message_and_explicitly_ignore_reply(Plan9FSMessage&);
 
     ProtocolVersion parse_protocol_version(StringView) const;
@@ -130,7 +133,13 @@ private:
     Atomic<u32> m_next_fid { 1 };
 
     ProtocolVersion m_remote_protocol_version { ProtocolVersion::v9P2000 };
-    size_t m_max_message_size { 4 * KiB };
+    // The server may well settle for less than this.
+    static constexpr size_t preferred_max_message_size = 512 * KiB;
+    size_t m_max_message_size { preferred_max_message_size };
+    // How many reads or writes a single large I/O keeps in flight.
+    static constexpr size_t max_outstanding_requests = 4;
+
+    Time m_attribute_cache_timeout;
 
     Mutex m_send_lock { "Plan9FS send"sv };
     Plan9FSBlockerSet m_completion_blocker;
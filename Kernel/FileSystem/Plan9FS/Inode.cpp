@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <Kernel/FileSystem/Plan9FS/Inode.h>
 #include <Kernel/Process.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -68,67 +70,177 @@ ErrorOr<size_t> Plan9FSInode::read_bytes_locked(off_t offset, size_t size, UserO
 {
     TRY(const_cast<Plan9FSInode&>(*this).ensure_open_for_mode(O_RDONLY));
 
-    size = fs().adjust_buffer_size(size);
-
-    Plan9FSMessage message { fs(), Plan9FSMessage::Type::Treadlink };
-    StringView data;
-
     // Try readlink first.
-    bool readlink_succeeded = false;
     if (fs().m_remote_protocol_version >= Plan9FS::ProtocolVersion::v9P2000L && offset == 0) {
+        Plan9FSMessage message { fs(), Plan9FSMessage::Type::Treadlink };
         message << fid();
         if (auto result = fs().post_message_and_wait_for_a_reply(message); !result.is_error()) {
-            readlink_succeeded = true;
+            StringView data;
             message >> data;
+            size_t nread = min(data.length(), fs().adjust_buffer_size(size));
+            TRY(buffer.write(data.characters_without_null_termination(), nread));
+            return nread;
         }
     }
 
-    if (!readlink_succeeded) {
-        message = Plan9FSMessage { fs(), Plan9FSMessage::Type::Tread };
-        message << fid() << (u64)offset << (u32)size;
-        TRY(fs().post_message_and_wait_for_a_reply(message));
-        data = message.read_data();
-    }
+    // A read that doesn't fit into a single message is split up into several, which are all sent
+    // before waiting for the first reply, so that we don't pay for one round trip per chunk.
+    struct PendingRead {
+        NonnullOwnPtr<Plan9FSMessage> message;
+        NonnullLockRefPtr<Plan9FS::ReceiveCompletion> completion;
+        size_t buffer_offset;
+        size_t size;
+    };
+    Vector<PendingRead, Plan9FS::max_outstanding_requests> pending_reads;
+
+    auto post_read = [&](size_t buffer_offset) -> ErrorOr<size_t> {
+        size_t chunk_size = fs().adjust_buffer_size(size - buffer_offset);
+        auto message = TRY(try_make<Plan9FSMessage>(fs(), Plan9FSMessage::Type::Tread));
+        *message << fid() << (u64)(offset + buffer_offset) << (u32)chunk_size;
+        auto completion = TRY(fs().post_message_expecting_a_reply(*message));
+        TRY(pending_reads.try_append({ move(message), move(completion), buffer_offset, chunk_size }));
+        return chunk_size;
+    };
+
+    size_t nrequested = 0;
+    size_t nread = 0;
+    while (nread < size) {
+        while (nrequested < size && pending_reads.size() < Plan9FS::max_outstanding_requests) {
+            auto result = post_read(nrequested);
+            if (result.is_error()) {
+                if (pending_reads.is_empty())
+                    return nread > 0 ? ErrorOr<size_t> { nread } : result.release_error();
+                // Make do with what is already in flight.
+                size = nrequested;
+                break;
+            }
+            nrequested += result.value();
+        }
+
+        // Replies to requests we no longer wait for are dropped once they arrive.
+        auto read = pending_reads.take_first();
+        auto result = fs().wait_for_a_reply(*read.message, move(read.completion));
+        if (result.is_error()) {
+            if (nread > 0)
+                return nread;
+            return result.release_error();
+        }
+
+        StringView data = read.message->read_data();
+        // Guard against the server returning more data than requested.
+        size_t chunk_nread = min(data.length(), read.size);
+        TRY(buffer.write(data.characters_without_null_termination(), read.buffer_offset, chunk_nread));
+        nread += chunk_nread;
 
-    // Guard against the server returning more data than requested.
-    size_t nread = min(data.length(), size);
-    TRY(buffer.write(data.characters_without_null_termination(), nread));
+        // A short read means we've reached the end of the file.
+        if (chunk_nread < read.size)
+            break;
+    }
     return nread;
 }
 
 ErrorOr<size_t> Plan9FSInode::write_bytes_locked(off_t offset, size_t size, UserOrKernelBuffer const& data, OpenFileDescription*)
 {
     TRY(ensure_open_for_mode(O_WRONLY));
-    size = fs().adjust_buffer_size(size);
+    ScopeGuard invalidate_metadata = [this] { invalidate_cached_metadata(); };
+
+    // Like reads, large writes keep several messages in flight.
+    struct PendingWrite {
+        NonnullOwnPtr<Plan9FSMessage> message;
+        NonnullLockRefPtr<Plan9FS::ReceiveCompletion> completion;
+        size_t size;
+    };
+    Vector<PendingWrite, Plan9FS::max_outstanding_requests> pending_writes;
+
+    auto post_write = [&](size_t data_offset) -> ErrorOr<size_t> {
+        size_t chunk_size = fs().adjust_buffer_size(size - data_offset);
+        auto data_copy = TRY(data.offset(data_offset).try_copy_into_kstring(chunk_size)); // FIXME: this seems ugly
+        auto message = TRY(try_make<Plan9FSMessage>(fs(), Plan9FSMessage::Type::Twrite));
+        *message << fid() << (u64)(offset + data_offset);
+        message->append_data(data_copy->view());
+        auto completion = TRY(fs().post_message_expecting_a_reply(*message));
+        TRY(pending_writes.try_append({ move(message), move(completion), chunk_size }));
+        return chunk_size;
+    };
+
+    size_t nrequested = 0;
+    size_t nwritten = 0;
+    while (nwritten < size) {
+        while (nrequested < size && pending_writes.size() < Plan9FS::max_outstanding_requests) {
+            auto result = post_write(nrequested);
+            if (result.is_error()) {
+                if (pending_writes.is_empty())
+                    return nwritten > 0 ? ErrorOr<size_t> { nwritten } : result.release_error();
+                size = nrequested;
+                break;
+            }
+            nrequested += result.value();
+        }
 
-    auto data_copy = TRY(data.try_copy_into_kstring(size)); // FIXME: this seems ugly
+        auto write = pending_writes.take_first();
+        auto result = fs().wait_for_a_reply(*write.message, move(write.completion));
+        if (result.is_error()) {
+            if (nwritten > 0)
+                return nwritten;
+            return result.release_error();
+        }
 
-    Plan9FSMessage message { fs(), Plan9FSMessage::Type::Twrite };
-    message << fid() << (u64)offset;
-    message.append_data(data_copy->view());
-    TRY(fs().post_message_and_wait_for_a_reply(message));
+        u32 chunk_nwritten;
+        *write.message >> chunk_nwritten;
+        nwritten += min<size_t>(chunk_nwritten, write.size);
 
-    u32 nwritten;
-    message >> nwritten;
+        // The server wouldn't take all of it, so report what it did take, even if
+        // some of the later chunks that are still in flight do make it to the file.
+        if (chunk_nwritten < write.size)
+            break;
+    }
     return nwritten;
 }
 
 InodeMetadata Plan9FSInode::metadata() const
 {
-    InodeMetadata metadata;
-    metadata.inode = identifier();
+    auto timeout = fs().m_attribute_cache_timeout;
+    if (!timeout.is_zero()) {
+        SpinlockLocker locker(m_cached_metadata_lock);
+        if (m_cached_metadata.has_value() && TimeManagement::the().monotonic_time() < m_cached_metadata_expiry)
+            return m_cached_metadata.value();
+    }
 
-    // 9P2000.L; TODO: 9P2000 & 9P2000.u
-    Plan9FSMessage message { fs(), Plan9FSMessage::Type::Tgetattr };
-    message << fid() << (u64)GetAttrMask::Basic;
-    auto result = fs().post_message_and_wait_for_a_reply(message);
-    if (result.is_error()) {
+    auto metadata_or_error = fetch_metadata();
+    if (metadata_or_error.is_error()) {
         // Just return blank metadata; hopefully that's enough to result in an
         // error at some upper layer. Ideally, there would be a way for
         // Inode::metadata() to return failure.
+        InodeMetadata metadata;
+        metadata.inode = identifier();
         return metadata;
     }
 
+    auto metadata = metadata_or_error.release_value();
+    if (!timeout.is_zero()) {
+        SpinlockLocker locker(m_cached_metadata_lock);
+        m_cached_metadata = metadata;
+        m_cached_metadata_expiry = TimeManagement::the().monotonic_time() + timeout;
+    }
+    return metadata;
+}
+
+void Plan9FSInode::invalidate_cached_metadata()
+{
+    SpinlockLocker locker(m_cached_metadata_lock);
+    m_cached_metadata.clear();
+}
+
+ErrorOr<InodeMetadata> Plan9FSInode::fetch_metadata() const
+{
+    InodeMetadata metadata;
+    metadata.inode = identifier();
+
+    // 9P2000.L; TODO: 9P2000 & 9P2000.u
+    Plan9FSMessage message { fs(), Plan9FSMessage::Type::Tgetattr };
+    message << fid() << (u64)GetAttrMask::Basic;
+    TRY(fs().post_message_and_wait_for_a_reply(message));
+
     u64 valid;
     Plan9FSQIdentifier qid;
     u32 mode;
@@ -280,6 +392,7 @@ ErrorOr<void> Plan9FSInode::chown(UserID, GroupID)
 
 ErrorOr<void> Plan9FSInode::truncate(u64 new_size)
 {
+    ScopeGuard invalidate_metadata = [this] { invalidate_cached_metadata(); };
     if (fs().m_remote_protocol_version >= Plan9FS::ProtocolVersion::v9P2000L) {
         Plan9FSMessage message { fs(), Plan9FSMessage::Type::Tsetattr };
         SetAttrMask valid = SetAttrMask::Size;
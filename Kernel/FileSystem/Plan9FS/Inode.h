@@ -11,6 +11,7 @@
 #include <Kernel/FileSystem/Plan9FS/FileSystem.h>
 #include <Kernel/FileSystem/Plan9FS/Message.h>
 #include <Kernel/KBufferBuilder.h>
+#include <Kernel/Locking/Spinlock.h>
 
 namespace Kernel {
 
@@ -79,6 +80,14 @@ private:
     int m_open_mode { 0 };
     ErrorOr<void> ensure_open_for_mode(int mode);
 
+    ErrorOr<InodeMetadata> fetch_metadata() const;
+    void invalidate_cached_metadata();
+
+    // Every metadata() call would otherwise take a round trip to the server.
+    mutable Spinlock m_cached_metadata_lock { LockRank::None };
+    mutable Optional<InodeMetadata> m_cached_metadata;
+    mutable Time m_cached_metadata_expiry;
+
     Plan9FS& fs() { return reinterpret_cast<Plan9FS&>(Inode::fs()); }
     Plan9FS& fs() const
     {
@@ -4,10 +4,14 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObjectSerializer.h>
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/Access.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Devices/Storage/DeviceAttribute.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Storage/StorageDevice.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -21,6 +25,10 @@ StringView StorageDeviceAttributeSysFSComponent::name() const
         return "sector_size"sv;
     case Type::CommandSet:
         return "command_set"sv;
+    case Type::QueueDepth:
+        return "queue_depth"sv;
+    case Type::Latency:
+        return "latency"sv;
     default:
         VERIFY_NOT_REACHED();
     }
@@ -50,6 +58,45 @@ ErrorOr<size_t> StorageDeviceAttributeSysFSComponent::read_bytes(off_t offset, s
     return nread;
 }
 
+ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_generate_io_statistics_buffer() const
+{
+    auto statistics = m_device->io_scheduler().statistics();
+    auto builder = TRY(KBufferBuilder::try_create());
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    // Each bucket counts the values below its limit, except for the last one, which counts all the rest.
+    auto add_histogram = [&](StringView name, Span<u64 const> counts, auto bucket_limit) -> ErrorOr<void> {
+        auto histogram = TRY(json.add_array(name));
+        for (size_t i = 0; i < counts.size(); ++i) {
+            auto bucket = TRY(histogram.add_object());
+            if (i + 1 < counts.size())
+                TRY(bucket.add("below"sv, bucket_limit(i)));
+            TRY(bucket.add("count"sv, counts[i]));
+            TRY(bucket.finish());
+        }
+        TRY(histogram.finish());
+        return {};
+    };
+    switch (m_type) {
+    case Type::QueueDepth:
+        TRY(json.add("current"sv, statistics.queue_depth));
+        TRY(json.add("hardware"sv, statistics.hardware_queue_depth));
+        TRY(json.add("merged_requests"sv, statistics.merged_requests));
+        TRY(add_histogram("histogram"sv, statistics.queue_depths.span(), IOScheduler::Statistics::queue_depth_bucket_limit));
+        break;
+    case Type::Latency:
+        TRY(add_histogram("reads_us"sv, statistics.read_latencies.span(), IOScheduler::Statistics::latency_bucket_limit_in_microseconds));
+        TRY(add_histogram("writes_us"sv, statistics.write_latencies.span(), IOScheduler::Statistics::latency_bucket_limit_in_microseconds));
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    TRY(json.finish());
+    auto buffer = builder.build();
+    if (!buffer)
+        return ENOMEM;
+    return buffer.release_nonnull();
+}
+
 ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_generate_buffer() const
 {
     OwnPtr<KString> value;
@@ -63,6 +110,9 @@ ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_gen
     case Type::CommandSet:
         value = TRY(KString::formatted("{}", m_device->command_set_to_string_view()));
         break;
+    case Type::QueueDepth:
+    case Type::Latency:
+        return try_to_generate_io_statistics_buffer();
     default:
         VERIFY_NOT_REACHED();
     }
@@ -18,6 +18,8 @@ public:
         EndLBA,
         SectorSize,
         CommandSet,
+        QueueDepth,
+        Latency,
     };
 
 public:
@@ -30,6 +32,7 @@ public:
 
 protected:
     ErrorOr<NonnullOwnPtr<KBuffer>> try_to_generate_buffer() const;
+    ErrorOr<NonnullOwnPtr<KBuffer>> try_to_generate_io_statistics_buffer() const;
     StorageDeviceAttributeSysFSComponent(StorageDeviceSysFSDirectory const& device, Type);
     NonnullLockRefPtr<StorageDevice> m_device;
     Type const m_type { Type::EndLBA };
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/CompressedMemory.h>
+#include <Kernel/Memory/CompressedPageStore.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSCompressedMemory::SysFSCompressedMemory(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSCompressedMemory> SysFSCompressedMemory::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) SysFSCompressedMemory(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSCompressedMemory::try_generate(KBufferBuilder& builder)
+{
+    auto statistics = Memory::CompressedPageStore::statistics();
+
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("stored_pages"sv, statistics.stored_pages));
+    TRY(json.add("stored_bytes"sv, statistics.stored_bytes));
+    TRY(json.add("pages_compressed"sv, statistics.pages_compressed));
+    TRY(json.add("pages_decompressed"sv, statistics.pages_decompressed));
+    TRY(json.add("pages_rejected"sv, statistics.pages_rejected));
+    TRY(json.finish());
+    return {};
+}
+
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/ContinuousProfiler.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/ContinuousProfile.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSContinuousProfile::SysFSContinuousProfile(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSContinuousProfile> SysFSContinuousProfile::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) SysFSContinuousProfile(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSContinuousProfile::try_generate(KBufferBuilder& builder)
+{
+    return ContinuousProfiler::drain(builder);
+}
+
+mode_t SysFSContinuousProfile::permissions() const
+{
+    return S_IRUSR;
+}
+
+}
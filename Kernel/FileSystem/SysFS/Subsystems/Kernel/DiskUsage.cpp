@@ -5,6 +5,7 @@
  */
 
 #include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskUsage.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
@@ -46,6 +47,15 @@ ErrorOr<void> SysFSDiskUsage::try_generate(KBufferBuilder& builder)
             TRY(fs_object.add("source"sv, "none"));
         }
 
+        if (fs.is_block_based()) {
+            auto cache_statistics = static_cast<BlockBasedFileSystem const&>(fs).cache_statistics();
+            TRY(fs_object.add("cache_hits"sv, cache_statistics.hits));
+            TRY(fs_object.add("cache_misses"sv, cache_statistics.misses));
+            TRY(fs_object.add("cached_blocks"sv, cache_statistics.cached_blocks));
+            TRY(fs_object.add("cache_capacity_blocks"sv, cache_statistics.capacity_blocks));
+            TRY(fs_object.add("dirty_blocks"sv, cache_statistics.dirty_blocks));
+        }
+
         TRY(fs_object.finish());
         return {};
     }));
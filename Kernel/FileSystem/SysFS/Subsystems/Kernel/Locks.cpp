@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Locks.h>
+#include <Kernel/KSyms.h>
+#include <Kernel/Locking/LockStatistics.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSLocks::SysFSLocks(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSLocks> SysFSLocks::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) SysFSLocks(parent_directory)).release_nonnull();
+}
+
+static ErrorOr<NonnullOwnPtr<KString>> symbolicate_call_site(FlatPtr address)
+{
+    if (auto const* symbol = symbolicate_kernel_address(address))
+        return KString::formatted("{}+{:#x}", symbol->name, address - symbol->address);
+    return KString::formatted("{:p}", address);
+}
+
+ErrorOr<void> SysFSLocks::try_generate(KBufferBuilder& builder)
+{
+    // Note: Spinlock addresses and call sites would help defeat KASLR.
+    auto current_process_credentials = Process::current().credentials();
+    if (!current_process_credentials->is_superuser())
+        return EPERM;
+
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("enabled"sv, LockStatistics::is_enabled()));
+    TRY(json.add("untracked_classes"sv, LockStatistics::untracked_class_count()));
+    auto array = TRY(json.add_array("classes"sv));
+
+    ErrorOr<void> result; // FIXME: Make this nicer
+    LockStatistics::for_each_lock_class([&array, &result](auto const& lock_class) {
+        if (result.is_error())
+            return;
+        result = ([&]() -> ErrorOr<void> {
+            auto obj = TRY(array.add_object());
+            TRY(obj.add("type"sv, lock_class.is_spinlock ? "spinlock"sv : "mutex"sv));
+            if (lock_class.is_spinlock) {
+                TRY(obj.add("address"sv, lock_class.spinlock_address));
+                TRY(obj.add("rank"sv, static_cast<int>(lock_class.rank)));
+            } else {
+                TRY(obj.add("name"sv, lock_class.name));
+            }
+            TRY(obj.add("acquire_count"sv, lock_class.acquire_count));
+            TRY(obj.add("contended_count"sv, lock_class.contended_count));
+            TRY(obj.add("total_wait_time_ns"sv, lock_class.total_wait_time_ns));
+            TRY(obj.add("max_wait_time_ns"sv, lock_class.max_wait_time_ns));
+            if (!lock_class.is_spinlock)
+                TRY(obj.add("max_hold_time_ns"sv, lock_class.max_hold_time_ns));
+
+            auto waiters = TRY(obj.add_array("top_waiters"sv));
+            for (auto const& waiter : lock_class.top_waiters) {
+                if (waiter.address == 0)
+                    continue;
+                auto waiter_object = TRY(waiters.add_object());
+                auto call_site = TRY(symbolicate_call_site(waiter.address));
+                TRY(waiter_object.add("call_site"sv, call_site->view()));
+                TRY(waiter_object.add("contended_count"sv, waiter.contended_count));
+                TRY(waiter_object.finish());
+            }
+            TRY(waiters.finish());
+            TRY(obj.add("other_waiters_contended_count"sv, lock_class.other_waiters_contended_count));
+            TRY(obj.finish());
+            return {};
+        })();
+    });
+    TRY(result);
+    TRY(array.finish());
+    TRY(json.finish());
+    return {};
+}
+
+mode_t SysFSLocks::permissions() const
+{
+    return S_IRUSR;
+}
+
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/GlobalInformation.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Library/LockRefPtr.h>
+#include <Kernel/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+class SysFSLocks final : public SysFSGlobalInformation {
+public:
+    virtual StringView name() const override { return "locks"sv; }
+
+    static NonnullLockRefPtr<SysFSLocks> must_create(SysFSDirectory const& parent_directory);
+
+private:
+    explicit SysFSLocks(SysFSDirectory const& parent_directory);
+
+    virtual mode_t permissions() const override;
+
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override;
+};
+
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/JsonArraySerializer.h>
 #include <AK/JsonObjectSerializer.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/MemoryStatus.h>
 #include <Kernel/Memory/MemoryManager.h>
@@ -37,6 +38,23 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    TRY(json.add("kmalloc_magazine_hits"sv, stats.kmalloc_magazine_hits));
+    TRY(json.add("kmalloc_magazine_misses"sv, stats.kmalloc_magazine_misses));
+    TRY(json.add("kfree_magazine_hits"sv, stats.kfree_magazine_hits));
+    TRY(json.add("kfree_magazine_misses"sv, stats.kfree_magazine_misses));
+    auto numa_nodes = TRY(json.add_array("numa_nodes"sv));
+    auto numa_node_info = MM.get_numa_node_info();
+    for (size_t i = 0; i < numa_node_info.size(); ++i) {
+        auto& node_info = numa_node_info[i];
+        auto node = TRY(numa_nodes.add_object());
+        TRY(node.add("node"sv, i));
+        TRY(node.add("physical_pages"sv, node_info.physical_pages));
+        TRY(node.add("physical_allocated"sv, node_info.physical_pages_used));
+        TRY(node.add("allocation_hits"sv, node_info.allocation_hits));
+        TRY(node.add("allocation_misses"sv, node_info.allocation_misses));
+        TRY(node.finish());
+    }
+    TRY(numa_nodes.finish());
     TRY(json.finish());
     return {};
 }
@@ -25,7 +25,7 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSNetworkARPStats> SysFSNetworkARPStats::m
 ErrorOr<void> SysFSNetworkARPStats::try_generate(KBufferBuilder& builder)
 {
     auto array = TRY(JsonArraySerializer<>::try_create(builder));
-    TRY(arp_table().with([&](auto const& table) -> ErrorOr<void> {
+    TRY(arp_table().with_shared([&](auto const& table) -> ErrorOr<void> {
         for (auto& it : table) {
             auto obj = TRY(array.add_object());
             auto mac_address = TRY(it.value.to_string());
@@ -24,21 +24,24 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSNetworkRouteStats> SysFSNetworkRouteStat
 ErrorOr<void> SysFSNetworkRouteStats::try_generate(KBufferBuilder& builder)
 {
     auto array = TRY(JsonArraySerializer<>::try_create(builder));
-    TRY(routing_table().with([&](auto const& table) -> ErrorOr<void> {
-        for (auto& it : table) {
-            auto obj = TRY(array.add_object());
-            auto destination = TRY(it.destination.to_string());
-            TRY(obj.add("destination"sv, destination->view()));
-            auto gateway = TRY(it.gateway.to_string());
-            TRY(obj.add("gateway"sv, gateway->view()));
-            auto netmask = TRY(it.netmask.to_string());
-            TRY(obj.add("genmask"sv, netmask->view()));
-            TRY(obj.add("flags"sv, it.flags));
-            TRY(obj.add("interface"sv, it.adapter->name()));
-            TRY(obj.finish());
-        }
-        return {};
+    // NOTE: Take a snapshot of the table first, so that we don't serialize it inside an RCU read-side critical section.
+    auto table = TRY(routing_table().with_read([&](auto const& table) -> ErrorOr<Route::RouteList> {
+        Route::RouteList copy;
+        TRY(copy.try_extend(table));
+        return copy;
     }));
+    for (auto& it : table) {
+        auto obj = TRY(array.add_object());
+        auto destination = TRY(it->destination.to_string());
+        TRY(obj.add("destination"sv, destination->view()));
+        auto gateway = TRY(it->gateway.to_string());
+        TRY(obj.add("gateway"sv, gateway->view()));
+        auto netmask = TRY(it->netmask.to_string());
+        TRY(obj.add("genmask"sv, netmask->view()));
+        TRY(obj.add("flags"sv, it->flags));
+        TRY(obj.add("interface"sv, it->adapter->name()));
+        TRY(obj.finish());
+    }
     TRY(array.finish());
     return {};
 }
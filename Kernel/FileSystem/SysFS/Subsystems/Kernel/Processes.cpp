@@ -4,8 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/JsonObjectSerializer.h>
 #include <AK/Try.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Processes.h>
 #include <Kernel/Process.h>
 #include <Kernel/Scheduler.h>
@@ -24,136 +24,144 @@ UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSOverallProcesses> SysFSOverallProcesses:
     return adopt_lock_ref_if_nonnull(new (nothrow) SysFSOverallProcesses(parent_directory)).release_nonnull();
 }
 
-ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
+template<typename Record>
+static ErrorOr<void> append_record(KBufferBuilder& builder, Record const& record)
 {
-    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    return builder.append_bytes({ &record, sizeof(record) });
+}
 
-    // Keep this in sync with CProcessStatistics.
-    auto build_process = [&](JsonArraySerializer<KBufferBuilder>& array, Process const& process) -> ErrorOr<void> {
-        auto process_object = TRY(array.add_object());
+ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
+{
+    // See Kernel/API/ProcessStatistics.h for the layout, and keep this in sync with Core::ProcessStatisticsReader.
+    auto build_process = [&](Process const& process) -> ErrorOr<void> {
+        ProcessStatisticsRecord record {};
 
+        StringBuilder pledge_builder;
+        StringView veil;
         if (process.is_user_process()) {
-            StringBuilder pledge_builder;
-
 #define __ENUMERATE_PLEDGE_PROMISE(promise)    \
     if (process.has_promised(Pledge::promise)) \
         TRY(pledge_builder.try_append(#promise " "sv));
             ENUMERATE_PLEDGE_PROMISES
 #undef __ENUMERATE_PLEDGE_PROMISE
 
-            TRY(process_object.add("pledge"sv, pledge_builder.string_view()));
-
             switch (process.veil_state()) {
             case VeilState::None:
-                TRY(process_object.add("veil"sv, "None"));
+                veil = "None"sv;
                 break;
             case VeilState::Dropped:
-                TRY(process_object.add("veil"sv, "Dropped"));
+                veil = "Dropped"sv;
                 break;
             case VeilState::Locked:
-                TRY(process_object.add("veil"sv, "Locked"));
+                veil = "Locked"sv;
                 break;
             }
-        } else {
-            TRY(process_object.add("pledge"sv, ""sv));
-            TRY(process_object.add("veil"sv, ""sv));
         }
 
-        TRY(process_object.add("pid"sv, process.pid().value()));
-        TRY(process_object.add("pgid"sv, process.tty() ? process.tty()->pgid().value() : 0));
-        TRY(process_object.add("pgp"sv, process.pgid().value()));
-        TRY(process_object.add("sid"sv, process.sid().value()));
+        record.pid = process.pid().value();
+        record.pgid = process.tty() ? process.tty()->pgid().value() : 0;
+        record.pgp = process.pgid().value();
+        record.sid = process.sid().value();
         auto credentials = process.credentials();
-        TRY(process_object.add("uid"sv, credentials->uid().value()));
-        TRY(process_object.add("gid"sv, credentials->gid().value()));
-        TRY(process_object.add("ppid"sv, process.ppid().value()));
-        if (process.tty()) {
-            auto tty_pseudo_name = TRY(process.tty()->pseudo_name());
-            TRY(process_object.add("tty"sv, tty_pseudo_name->view()));
-        } else {
-            TRY(process_object.add("tty"sv, ""));
-        }
-        TRY(process_object.add("nfds"sv, process.fds().with_shared([](auto& fds) { return fds.open_count(); })));
-        TRY(process_object.add("name"sv, process.name()));
-        TRY(process_object.add("executable"sv, process.executable() ? TRY(process.executable()->try_serialize_absolute_path())->view() : ""sv));
-
-        size_t amount_virtual = 0;
-        size_t amount_resident = 0;
-        size_t amount_dirty_private = 0;
-        size_t amount_clean_inode = 0;
-        size_t amount_shared = 0;
-        size_t amount_purgeable_volatile = 0;
-        size_t amount_purgeable_nonvolatile = 0;
+        record.uid = credentials->uid().value();
+        record.gid = credentials->gid().value();
+        record.ppid = process.ppid().value();
+        record.nfds = process.fds().with_shared([](auto& fds) { return fds.open_count(); });
+        record.kernel = process.is_kernel_process();
+        record.dumpable = process.is_dumpable();
+
+        OwnPtr<KString> tty_pseudo_name;
+        if (process.tty())
+            tty_pseudo_name = TRY(process.tty()->pseudo_name());
+        OwnPtr<KString> executable_path;
+        if (process.executable())
+            executable_path = TRY(process.executable()->try_serialize_absolute_path());
 
         TRY(process.address_space().with([&](auto& space) -> ErrorOr<void> {
-            amount_virtual = space->amount_virtual();
-            amount_resident = space->amount_resident();
-            amount_dirty_private = space->amount_dirty_private();
-            amount_clean_inode = TRY(space->amount_clean_inode());
-            amount_shared = space->amount_shared();
-            amount_purgeable_volatile = space->amount_purgeable_volatile();
-            amount_purgeable_nonvolatile = space->amount_purgeable_nonvolatile();
+            record.amount_virtual = space->amount_virtual();
+            record.amount_resident = space->amount_resident();
+            record.amount_dirty_private = space->amount_dirty_private();
+            record.amount_clean_inode = TRY(space->amount_clean_inode());
+            record.amount_shared = space->amount_shared();
+            record.amount_purgeable_volatile = space->amount_purgeable_volatile();
+            record.amount_purgeable_nonvolatile = space->amount_purgeable_nonvolatile();
             return {};
         }));
 
-        TRY(process_object.add("amount_virtual"sv, amount_virtual));
-        TRY(process_object.add("amount_resident"sv, amount_resident));
-        TRY(process_object.add("amount_dirty_private"sv, amount_dirty_private));
-        TRY(process_object.add("amount_clean_inode"sv, amount_clean_inode));
-        TRY(process_object.add("amount_shared"sv, amount_shared));
-        TRY(process_object.add("amount_purgeable_volatile"sv, amount_purgeable_volatile));
-        TRY(process_object.add("amount_purgeable_nonvolatile"sv, amount_purgeable_nonvolatile));
-        TRY(process_object.add("dumpable"sv, process.is_dumpable()));
-        TRY(process_object.add("kernel"sv, process.is_kernel_process()));
-        auto thread_array = TRY(process_object.add_array("threads"sv));
-        TRY(process.try_for_each_thread([&](const Thread& thread) -> ErrorOr<void> {
-            SpinlockLocker locker(thread.get_lock());
-            auto thread_object = TRY(thread_array.add_object());
-#if LOCK_DEBUG
-            TRY(thread_object.add("lock_count"sv, thread.lock_count()));
-#endif
-            TRY(thread_object.add("tid"sv, thread.tid().value()));
-            TRY(thread_object.add("name"sv, thread.name()));
-            TRY(thread_object.add("times_scheduled"sv, thread.times_scheduled()));
-            TRY(thread_object.add("time_user"sv, thread.time_in_user()));
-            TRY(thread_object.add("time_kernel"sv, thread.time_in_kernel()));
-            TRY(thread_object.add("state"sv, thread.state_string()));
-            TRY(thread_object.add("cpu"sv, thread.cpu()));
-            TRY(thread_object.add("priority"sv, thread.priority()));
-            TRY(thread_object.add("syscall_count"sv, thread.syscall_count()));
-            TRY(thread_object.add("inode_faults"sv, thread.inode_faults()));
-            TRY(thread_object.add("zero_faults"sv, thread.zero_faults()));
-            TRY(thread_object.add("cow_faults"sv, thread.cow_faults()));
-            TRY(thread_object.add("file_read_bytes"sv, thread.file_read_bytes()));
-            TRY(thread_object.add("file_write_bytes"sv, thread.file_write_bytes()));
-            TRY(thread_object.add("unix_socket_read_bytes"sv, thread.unix_socket_read_bytes()));
-            TRY(thread_object.add("unix_socket_write_bytes"sv, thread.unix_socket_write_bytes()));
-            TRY(thread_object.add("ipv4_socket_read_bytes"sv, thread.ipv4_socket_read_bytes()));
-            TRY(thread_object.add("ipv4_socket_write_bytes"sv, thread.ipv4_socket_write_bytes()));
-
-            TRY(thread_object.finish());
+        // The threads are written after the process record, which says how many there are.
+        Vector<NonnullLockRefPtr<Thread const>, 16> threads;
+        TRY(process.try_for_each_thread([&](Thread const& thread) -> ErrorOr<void> {
+            TRY(threads.try_append(thread));
             return {};
         }));
-        TRY(thread_array.finish());
-        TRY(process_object.finish());
+        record.thread_count = threads.size();
+
+        auto name = process.name();
+        auto executable = executable_path ? executable_path->view() : ""sv;
+        auto tty = tty_pseudo_name ? tty_pseudo_name->view() : ""sv;
+        auto pledge = pledge_builder.string_view();
+        record.name_length = name.length();
+        record.executable_length = executable.length();
+        record.tty_length = tty.length();
+        record.pledge_length = pledge.length();
+        record.veil_length = veil.length();
+
+        TRY(append_record(builder, record));
+        TRY(builder.append(name));
+        TRY(builder.append(executable));
+        TRY(builder.append(tty));
+        TRY(builder.append(pledge));
+        TRY(builder.append(veil));
+
+        for (auto& thread : threads) {
+            SpinlockLocker locker(thread->get_lock());
+            ThreadStatisticsRecord thread_record {};
+            thread_record.tid = thread->tid().value();
+            thread_record.times_scheduled = thread->times_scheduled();
+            thread_record.time_user = thread->time_in_user();
+            thread_record.time_kernel = thread->time_in_kernel();
+            thread_record.cpu = thread->cpu();
+            thread_record.priority = thread->priority();
+            thread_record.syscall_count = thread->syscall_count();
+            thread_record.inode_faults = thread->inode_faults();
+            thread_record.zero_faults = thread->zero_faults();
+            thread_record.cow_faults = thread->cow_faults();
+            thread_record.file_read_bytes = thread->file_read_bytes();
+            thread_record.file_write_bytes = thread->file_write_bytes();
+            thread_record.unix_socket_read_bytes = thread->unix_socket_read_bytes();
+            thread_record.unix_socket_write_bytes = thread->unix_socket_write_bytes();
+            thread_record.ipv4_socket_read_bytes = thread->ipv4_socket_read_bytes();
+            thread_record.ipv4_socket_write_bytes = thread->ipv4_socket_write_bytes();
+
+            auto thread_name = thread->name();
+            auto state = thread->state_string();
+            thread_record.name_length = thread_name.length();
+            thread_record.state_length = state.length();
+
+            TRY(append_record(builder, thread_record));
+            TRY(builder.append(thread_name));
+            TRY(builder.append(state));
+        }
         return {};
     };
 
-    {
-        auto array = TRY(json.add_array("processes"sv));
-        // FIXME: Do we actually want to expose the colonel process in a Jail environment?
-        TRY(build_process(array, *Scheduler::colonel()));
-        TRY(Process::for_each_in_same_jail([&](Process& process) -> ErrorOr<void> {
-            TRY(build_process(array, process));
-            return {};
-        }));
-        TRY(array.finish());
-    }
-
     auto total_time_scheduled = Scheduler::get_total_time_scheduled();
-    TRY(json.add("total_time"sv, total_time_scheduled.total));
-    TRY(json.add("total_time_kernel"sv, total_time_scheduled.total_kernel));
-    TRY(json.finish());
+    ProcessStatisticsHeader header {};
+    header.magic = process_statistics_magic;
+    header.version = process_statistics_version;
+    header.header_size = sizeof(ProcessStatisticsHeader);
+    header.process_record_size = sizeof(ProcessStatisticsRecord);
+    header.thread_record_size = sizeof(ThreadStatisticsRecord);
+    header.total_time = total_time_scheduled.total;
+    header.total_time_kernel = total_time_scheduled.total_kernel;
+    TRY(append_record(builder, header));
+
+    // FIXME: Do we actually want to expose the colonel process in a Jail environment?
+    TRY(build_process(*Scheduler::colonel()));
+    TRY(Process::for_each_in_same_jail([&](Process& process) -> ErrorOr<void> {
+        TRY(build_process(process));
+        return {};
+    }));
     return {};
 }
 
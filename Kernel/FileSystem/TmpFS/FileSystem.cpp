@@ -7,6 +7,7 @@
 
 #include <Kernel/FileSystem/TmpFS/FileSystem.h>
 #include <Kernel/FileSystem/TmpFS/Inode.h>
+#include <Kernel/Memory/MemoryManager.h>
 
 namespace Kernel {
 
@@ -30,6 +31,29 @@ Inode& TmpFS::root_inode()
     return *m_root_inode;
 }
 
+ErrorOr<NonnullOwnPtr<Memory::Region>> TmpFS::take_mapping_region()
+{
+    auto cached_region = m_mapping_regions.with([](auto& regions) -> OwnPtr<Memory::Region> {
+        if (regions.is_empty())
+            return {};
+        return regions.take_last();
+    });
+    if (cached_region)
+        return cached_region.release_nonnull();
+    // The region doesn't need any memory of its own, it only ever shows the data blocks.
+    return MM.allocate_kernel_region(TmpFSInode::DataBlock::block_size, "TmpFSInode Mapping Region"sv, Memory::Region::Access::ReadWrite, AllocationStrategy::None);
+}
+
+void TmpFS::return_mapping_region(NonnullOwnPtr<Memory::Region> region)
+{
+    // Regions that don't fit into the cache have to be freed without holding its lock.
+    OwnPtr<Memory::Region> region_to_free = move(region);
+    m_mapping_regions.with([&](auto& regions) {
+        if (regions.size() < max_cached_mapping_regions)
+            regions.unchecked_append(region_to_free.release_nonnull());
+    });
+}
+
 unsigned TmpFS::next_inode_index()
 {
     MutexLocker locker(m_lock);
@@ -10,6 +10,8 @@
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Forward.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/Region.h>
 
 namespace Kernel {
 
@@ -24,6 +26,7 @@ public:
     virtual StringView class_name() const override { return "TmpFS"sv; }
 
     virtual bool supports_watchers() const override { return true; }
+    virtual bool supports_directory_entry_cache() const override { return true; }
 
     virtual Inode& root_inode() override;
 
@@ -34,6 +37,14 @@ private:
 
     unsigned m_next_inode_index { 1 };
     unsigned next_inode_index();
+
+    // File contents are accessed through a kernel region that is pointed at one data block after another.
+    // Allocating such a region is a lot more expensive than that, so a few are kept around for reuse.
+    ErrorOr<NonnullOwnPtr<Memory::Region>> take_mapping_region();
+    void return_mapping_region(NonnullOwnPtr<Memory::Region>);
+
+    static constexpr size_t max_cached_mapping_regions = 16;
+    SpinlockProtected<Vector<NonnullOwnPtr<Memory::Region>, max_cached_mapping_regions>> m_mapping_regions { LockRank::None };
 };
 
 }
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <Kernel/FileSystem/TmpFS/Inode.h>
 #include <Kernel/Process.h>
 
@@ -62,7 +63,9 @@ ErrorOr<void> TmpFSInode::traverse_as_directory(Function<ErrorOr<void>(FileSyste
 
 ErrorOr<NonnullOwnPtr<TmpFSInode::DataBlock>> TmpFSInode::DataBlock::create()
 {
-    auto data_block_buffer_vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(DataBlock::block_size, AllocationStrategy::AllocateNow));
+    // The memory is committed now, but the pages are only allocated (and zeroed) when something touches them.
+    // That way, small files don't cost a whole block of physical memory.
+    auto data_block_buffer_vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(DataBlock::block_size, AllocationStrategy::Reserve));
     return TRY(adopt_nonnull_own_or_enomem(new (nothrow) DataBlock(move(data_block_buffer_vmobject))));
 }
 
@@ -100,7 +103,9 @@ ErrorOr<size_t> TmpFSInode::read_bytes_from_content_space(size_t offset, size_t
     VERIFY(m_metadata.size >= 0);
     if (static_cast<size_t>(m_metadata.size) < offset)
         return 0;
-    auto mapping_region = TRY(MM.allocate_kernel_region(DataBlock::block_size, "TmpFSInode Mapping Region"sv, Memory::Region::Access::Read, AllocationStrategy::Reserve));
+    auto& fs = const_cast<TmpFS&>(this->fs());
+    auto mapping_region = TRY(fs.take_mapping_region());
+    ScopeGuard return_mapping_region = [&] { fs.return_mapping_region(move(mapping_region)); };
     return const_cast<TmpFSInode&>(*this).do_io_on_content_space(*mapping_region, offset, io_size, buffer, false);
 }
 
@@ -114,7 +119,8 @@ ErrorOr<size_t> TmpFSInode::read_bytes_locked(off_t offset, size_t size, UserOrK
 ErrorOr<size_t> TmpFSInode::write_bytes_to_content_space(size_t offset, size_t io_size, UserOrKernelBuffer const& buffer)
 {
     VERIFY(m_inode_lock.is_locked());
-    auto mapping_region = TRY(MM.allocate_kernel_region(DataBlock::block_size, "TmpFSInode Mapping Region"sv, Memory::Region::Access::Write, AllocationStrategy::Reserve));
+    auto mapping_region = TRY(fs().take_mapping_region());
+    ScopeGuard return_mapping_region = [&] { fs().return_mapping_region(move(mapping_region)); };
     return do_io_on_content_space(*mapping_region, offset, io_size, const_cast<UserOrKernelBuffer&>(buffer), true);
 }
 
@@ -179,9 +185,7 @@ ErrorOr<size_t> TmpFSInode::do_io_on_content_space(Memory::Region& mapping_regio
             return Error::from_errno(EIO);
         }
 
-        NonnullLockRefPtr<Memory::AnonymousVMObject> block_vmobject = block->vmobject();
-        mapping_region.set_vmobject(block_vmobject);
-        mapping_region.remap();
+        map_block(mapping_region, *block);
         if (write)
             TRY(current_buffer.read(mapping_region.vaddr().offset(offset_in_block).as_ptr(), 0, current_io_size));
         else
@@ -198,6 +202,17 @@ ErrorOr<size_t> TmpFSInode::do_io_on_content_space(Memory::Region& mapping_regio
     return nio;
 }
 
+void TmpFSInode::map_block(Memory::Region& mapping_region, DataBlock& block)
+{
+    // Remapping has to flush the TLBs of all processors, which is worth avoiding for the common
+    // case of a file being read or written in small pieces, which hit the same block over and over.
+    if (&mapping_region.vmobject() == &block.vmobject())
+        return;
+    NonnullLockRefPtr<Memory::AnonymousVMObject> block_vmobject = block.vmobject();
+    mapping_region.set_vmobject(block_vmobject);
+    mapping_region.remap();
+}
+
 ErrorOr<void> TmpFSInode::truncate_to_block_index(size_t block_index)
 {
     VERIFY(m_inode_lock.is_locked());
@@ -340,11 +355,9 @@ ErrorOr<void> TmpFSInode::truncate(u64 size)
 
     u64 last_possible_block_index = size / DataBlock::block_size;
     if ((size % DataBlock::block_size != 0) && m_blocks[last_possible_block_index]) {
-        auto mapping_region = TRY(MM.allocate_kernel_region(DataBlock::block_size, "TmpFSInode Mapping Region"sv, Memory::Region::Access::Write, AllocationStrategy::Reserve));
-        VERIFY(m_blocks[last_possible_block_index]);
-        NonnullLockRefPtr<Memory::AnonymousVMObject> block_vmobject = m_blocks[last_possible_block_index]->vmobject();
-        mapping_region->set_vmobject(block_vmobject);
-        mapping_region->remap();
+        auto mapping_region = TRY(fs().take_mapping_region());
+        ScopeGuard return_mapping_region = [&] { fs().return_mapping_region(move(mapping_region)); };
+        map_block(*mapping_region, *m_blocks[last_possible_block_index]);
         memset(mapping_region->vaddr().offset(size % DataBlock::block_size).as_ptr(), 0, DataBlock::block_size - (size % DataBlock::block_size));
     }
     m_metadata.size = size;
@@ -352,6 +365,25 @@ ErrorOr<void> TmpFSInode::truncate(u64 size)
     return {};
 }
 
+ErrorOr<void> TmpFSInode::fallocate(u64 offset, u64 length)
+{
+    MutexLocker locker(m_inode_lock);
+    VERIFY(!is_directory());
+
+    // Once the blocks exist, their memory is committed, so writing into them can't fail for lack of it.
+    if (auto result = ensure_allocated_blocks(offset, length); result.is_error()) {
+        if (result.error().code() == ENOMEM)
+            return ENOSPC;
+        return result.release_error();
+    }
+
+    if (static_cast<u64>(m_metadata.size) < offset + length) {
+        m_metadata.size = offset + length;
+        set_metadata_dirty(true);
+    }
+    return {};
+}
+
 ErrorOr<void> TmpFSInode::update_timestamps(Optional<time_t> atime, Optional<time_t> ctime, Optional<time_t> mtime)
 {
     MutexLocker locker(m_inode_lock);
@@ -33,6 +33,7 @@ public:
     virtual ErrorOr<void> chmod(mode_t) override;
     virtual ErrorOr<void> chown(UserID, GroupID) override;
     virtual ErrorOr<void> truncate(u64) override;
+    virtual ErrorOr<void> fallocate(u64 offset, u64 length) override;
     virtual ErrorOr<void> update_timestamps(Optional<time_t> atime, Optional<time_t> ctime, Optional<time_t> mtime) override;
 
 private:
@@ -83,6 +84,8 @@ private:
         NonnullLockRefPtr<Memory::AnonymousVMObject> m_content_buffer_vmobject;
     };
 
+    void map_block(Memory::Region& mapping_region, DataBlock&);
+
     DataBlock::List m_blocks;
     Child::List m_children;
 };
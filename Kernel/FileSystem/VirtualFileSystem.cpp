@@ -63,7 +63,7 @@ bool VirtualFileSystem::mount_point_exists_at_inode(InodeIdentifier inode_identi
 ErrorOr<void> VirtualFileSystem::mount(FileSystem& fs, Custody& mount_point, int flags)
 {
     auto new_mount = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Mount(fs, &mount_point, flags)));
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    TRY(m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
         auto& inode = mount_point.inode();
         dbgln("VirtualFileSystem: FileSystemID {}, Mounting {} at inode {} with flags {}",
             fs.fsid(),
@@ -80,13 +80,16 @@ ErrorOr<void> VirtualFileSystem::mount(FileSystem& fs, Custody& mount_point, int
         });
         mounts.append(move(new_mount));
         return {};
-    });
+    }));
+    // Names that resolved to the mount point now resolve to what is mounted on it.
+    DirectoryEntryCache::invalidate_all();
+    return {};
 }
 
 ErrorOr<void> VirtualFileSystem::bind_mount(Custody& source, Custody& mount_point, int flags)
 {
     auto new_mount = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Mount(source.inode(), mount_point, flags)));
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    TRY(m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
         auto& inode = mount_point.inode();
         dbgln("VirtualFileSystem: Bind-mounting inode {} at inode {}", source.inode().identifier(), inode.identifier());
         if (mount_point_exists_at_inode(inode.identifier())) {
@@ -96,7 +99,10 @@ ErrorOr<void> VirtualFileSystem::bind_mount(Custody& source, Custody& mount_poin
         }
         mounts.append(move(new_mount));
         return {};
-    });
+    }));
+    // Names that resolved to the mount point now resolve to what is mounted on it.
+    DirectoryEntryCache::invalidate_all();
+    return {};
 }
 
 ErrorOr<void> VirtualFileSystem::remount(Custody& mount_point, int new_flags)
@@ -108,6 +114,7 @@ ErrorOr<void> VirtualFileSystem::remount(Custody& mount_point, int new_flags)
         return ENODEV;
 
     mount->set_flags(new_flags);
+    DirectoryEntryCache::invalidate_all();
     return {};
 }
 
@@ -123,6 +130,18 @@ void VirtualFileSystem::sync_filesystems()
         fs.flush_writes();
 }
 
+void VirtualFileSystem::write_back_filesystems()
+{
+    NonnullLockRefPtrVector<FileSystem, 32> file_systems;
+    m_file_systems_list.with([&](auto const& list) {
+        for (auto& fs : list)
+            file_systems.append(fs);
+    });
+
+    for (auto& fs : file_systems)
+        fs.write_back_dirty_blocks();
+}
+
 void VirtualFileSystem::lock_all_filesystems()
 {
     NonnullLockRefPtrVector<FileSystem, 32> file_systems;
@@ -141,7 +160,10 @@ ErrorOr<void> VirtualFileSystem::unmount(Custody& mountpoint_custody)
     auto custody_path = TRY(mountpoint_custody.try_serialize_absolute_path());
     dbgln("VirtualFileSystem: unmount called with inode {} on mountpoint {}", guest_inode.identifier(), custody_path->view());
 
-    return m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
+    // The cache holds references to inodes, which would keep the file system busy.
+    DirectoryEntryCache::invalidate_all();
+
+    TRY(m_mounts.with([&](auto& mounts) -> ErrorOr<void> {
         for (size_t i = 0; i < mounts.size(); ++i) {
             auto& mount = mounts[i];
             if (&mount->guest() != &guest_inode)
@@ -175,7 +197,10 @@ ErrorOr<void> VirtualFileSystem::unmount(Custody& mountpoint_custody)
         }
         dbgln("VirtualFileSystem: Nothing mounted on inode {}", guest_inode.identifier());
         return ENODEV;
-    });
+    }));
+    // Lookups that ran while unmounting could have cached the mount point.
+    DirectoryEntryCache::invalidate_all();
+    return {};
 }
 
 ErrorOr<void> VirtualFileSystem::mount_root(FileSystem& fs)
@@ -965,6 +990,40 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path(Credentials cons
     return custody;
 }
 
+ErrorOr<DirectoryEntryCache::Entry> VirtualFileSystem::lookup_directory_entry(Inode& parent, StringView name)
+{
+    bool is_cacheable = DirectoryEntryCache::is_cacheable(parent, name);
+    DirectoryEntryCache::Generation generation = 0;
+    if (is_cacheable) {
+        if (auto cached = DirectoryEntryCache::lookup(parent, name, generation); cached.has_value()) {
+            if (!cached->inode)
+                return ENOENT;
+            return cached.release_value();
+        }
+    }
+
+    auto child_or_error = parent.lookup(name);
+    if (child_or_error.is_error()) {
+        if (is_cacheable && child_or_error.error().code() == ENOENT)
+            DirectoryEntryCache::insert(parent, name, generation, {});
+        return child_or_error.release_error();
+    }
+
+    DirectoryEntryCache::Entry entry;
+    entry.inode = child_or_error.release_value();
+
+    // See if there's something mounted on the child; in that case
+    // we would need to return the guest inode, not the host inode.
+    if (auto mount = find_mount_for_host(entry.inode->identifier())) {
+        entry.inode = mount->guest();
+        entry.mount_flags = mount->flags();
+    }
+
+    if (is_cacheable)
+        DirectoryEntryCache::insert(parent, name, generation, entry);
+    return entry;
+}
+
 static bool safe_to_follow_symlink(Credentials const& credentials, Inode const& inode, InodeMetadata const& parent_metadata)
 {
     auto metadata = inode.metadata();
@@ -1019,26 +1078,19 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(Cre
         }
 
         // Okay, let's look up this part.
-        auto child_or_error = parent.inode().lookup(part);
-        if (child_or_error.is_error()) {
+        auto entry_or_error = lookup_directory_entry(parent.inode(), part);
+        if (entry_or_error.is_error()) {
             if (out_parent) {
                 // ENOENT with a non-null parent custody signals to caller that
                 // we found the immediate parent of the file, but the file itself
                 // does not exist yet.
                 *out_parent = have_more_parts ? nullptr : &parent;
             }
-            return child_or_error.release_error();
-        }
-        auto child_inode = child_or_error.release_value();
-
-        int mount_flags_for_child = parent.mount_flags();
-
-        // See if there's something mounted on the child; in that case
-        // we would need to return the guest inode, not the host inode.
-        if (auto mount = find_mount_for_host(child_inode->identifier())) {
-            child_inode = mount->guest();
-            mount_flags_for_child = mount->flags();
+            return entry_or_error.release_error();
         }
+        auto entry = entry_or_error.release_value();
+        NonnullLockRefPtr<Inode> child_inode = entry.inode.release_nonnull();
+        int mount_flags_for_child = entry.mount_flags.value_or(parent.mount_flags());
 
         custody = TRY(Custody::try_create(&parent, part, *child_inode, mount_flags_for_child));
 
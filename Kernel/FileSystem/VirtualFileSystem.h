@@ -13,6 +13,7 @@
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/InodeIdentifier.h>
@@ -78,6 +79,7 @@ public:
     InodeIdentifier root_inode_id() const;
 
     void sync_filesystems();
+    void write_back_filesystems();
     void lock_all_filesystems();
 
     static void sync();
@@ -99,6 +101,9 @@ private:
 
     bool mount_point_exists_at_inode(InodeIdentifier inode);
 
+    // Looks up a name in a directory, and the root of whatever is mounted on it.
+    ErrorOr<DirectoryEntryCache::Entry> lookup_directory_entry(Inode& parent, StringView name);
+
     // FIXME: These functions are totally unsafe as someone could unmount the returned Mount underneath us.
     Mount* find_mount_for_host(InodeIdentifier);
     Mount* find_mount_for_guest(InodeIdentifier);
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/CommandLine.h>
+#include <Kernel/Debug.h>
+#include <Kernel/Firmware/ACPI/Definitions.h>
+#include <Kernel/Firmware/ACPI/SRAT.h>
+#include <Kernel/Memory/TypedMapping.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel::ACPI {
+
+static constexpr u32 srat_entry_enabled = 1 << 0;
+
+UNMAP_AFTER_INIT ErrorOr<NUMATopology> parse_system_resource_affinity_table()
+{
+    if (kernel_command_line().acpi_feature_level() == AcpiFeatureLevel::Disabled)
+        return ENOENT;
+
+    auto rsdp = StaticParsing::find_rsdp();
+    if (!rsdp.has_value())
+        return ENOENT;
+    auto srat_address = StaticParsing::find_table(rsdp.value(), "SRAT"sv);
+    if (!srat_address.has_value())
+        return ENOENT;
+
+    size_t table_length = TRY(Memory::map_typed<Structures::SDTHeader>(srat_address.value()))->length;
+    if (table_length < sizeof(Structures::SRAT))
+        return EINVAL;
+    auto srat = TRY(Memory::map_typed<Structures::SRAT>(srat_address.value(), table_length));
+
+    NUMATopology topology;
+    size_t entries_length = table_length - sizeof(Structures::SRAT);
+    auto* entry = srat->entries;
+    while (entries_length >= sizeof(Structures::SRATEntryHeader)) {
+        size_t entry_length = entry->length;
+        if (entry_length < sizeof(Structures::SRATEntryHeader) || entry_length > entries_length)
+            return EINVAL;
+
+        if (entry->type == (u8)Structures::SRATEntryType::ProcessorLocalAPICAffinity && entry_length >= sizeof(Structures::SRATEntries::ProcessorLocalAPICAffinity)) {
+            auto* affinity = (const Structures::SRATEntries::ProcessorLocalAPICAffinity*)entry;
+            if (affinity->flags & srat_entry_enabled) {
+                u32 proximity_domain = affinity->proximity_domain_low
+                    | (affinity->proximity_domain_high[0] << 8)
+                    | (affinity->proximity_domain_high[1] << 16)
+                    | (affinity->proximity_domain_high[2] << 24);
+                dbgln_if(ACPI_DEBUG, "SRAT: APIC ID {} is in proximity domain {}", affinity->apic_id, proximity_domain);
+                TRY(topology.processors.try_append({ affinity->apic_id, proximity_domain }));
+            }
+        } else if (entry->type == (u8)Structures::SRATEntryType::ProcessorLocalX2APICAffinity && entry_length >= sizeof(Structures::SRATEntries::ProcessorLocalX2APICAffinity)) {
+            auto* affinity = (const Structures::SRATEntries::ProcessorLocalX2APICAffinity*)entry;
+            if (affinity->flags & srat_entry_enabled) {
+                dbgln_if(ACPI_DEBUG, "SRAT: x2APIC ID {} is in proximity domain {}", affinity->x2apic_id, affinity->proximity_domain);
+                TRY(topology.processors.try_append({ affinity->x2apic_id, affinity->proximity_domain }));
+            }
+        } else if (entry->type == (u8)Structures::SRATEntryType::MemoryAffinity && entry_length >= sizeof(Structures::SRATEntries::MemoryAffinity)) {
+            auto* affinity = (const Structures::SRATEntries::MemoryAffinity*)entry;
+            if (affinity->flags & srat_entry_enabled) {
+                auto base = PhysicalAddress(((u64)affinity->base_address_high << 32) | affinity->base_address_low);
+                u64 length = ((u64)affinity->length_high << 32) | affinity->length_low;
+                dbgln_if(ACPI_DEBUG, "SRAT: Memory {} - {} is in proximity domain {}", base, base.offset(length), affinity->proximity_domain);
+                TRY(topology.memory_ranges.try_append({ base, length, affinity->proximity_domain }));
+            }
+        }
+
+        entry = (Structures::SRATEntryHeader*)(VirtualAddress(entry).offset(entry_length).get());
+        entries_length -= entry_length;
+    }
+    return topology;
+}
+
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <Kernel/PhysicalAddress.h>
+
+namespace Kernel::ACPI {
+
+struct NUMAMemoryRange {
+    PhysicalAddress base;
+    u64 length { 0 };
+    u32 proximity_domain { 0 };
+};
+
+struct NUMAProcessor {
+    u32 apic_id { 0 };
+    u32 proximity_domain { 0 };
+};
+
+struct NUMATopology {
+    Vector<NUMAMemoryRange> memory_ranges;
+    Vector<NUMAProcessor> processors;
+};
+
+// Collects the enabled processor and memory affinity entries of the System Resource Affinity Table.
+// Returns ENOENT if the firmware doesn't provide one.
+ErrorOr<NUMATopology> parse_system_resource_affinity_table();
+
+}
@@ -23,8 +23,10 @@ class File;
 class FATInode;
 class OpenFileDescription;
 class DisplayConnector;
+class EventPoll;
 class FileSystem;
 class FutexQueue;
+class IORing;
 class IPv4Socket;
 class Inode;
 class InodeIdentifier;
@@ -58,6 +60,7 @@ class SysFSBusDirectory;
 class SysFSDevicesDirectory;
 class SysFSDirectoryInode;
 class SysFSInode;
+class SyscallTraceBuffer;
 class TCPSocket;
 class TTY;
 class Thread;
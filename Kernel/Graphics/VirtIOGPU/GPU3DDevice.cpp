@@ -10,6 +10,7 @@
 #include <Kernel/Graphics/VirtIOGPU/GPU3DDevice.h>
 #include <Kernel/Graphics/VirtIOGPU/GraphicsAdapter.h>
 #include <Kernel/Graphics/VirtIOGPU/Protocol.h>
+#include <Kernel/Process.h>
 #include <Kernel/Random.h>
 #include <LibC/sys/ioctl_numbers.h>
 
@@ -44,10 +45,37 @@ VirtIOGPU3DDevice::VirtIOGPU3DDevice(VirtIOGraphicsAdapter const& graphics_adapt
 
 void VirtIOGPU3DDevice::detach(OpenFileDescription& description)
 {
+    if (auto per_context_state = m_context_state_lookup.get(&description); per_context_state.has_value()) {
+        SpinlockLocker locker(m_graphics_adapter->operation_lock());
+        for (auto resource_id : per_context_state.value()->resources())
+            destroy_resource(*per_context_state.value(), resource_id);
+        per_context_state.value()->resources().clear();
+        m_graphics_adapter->delete_context(per_context_state.value()->context_id());
+    }
     m_context_state_lookup.remove(&description);
     CharacterDevice::detach(description);
 }
 
+void VirtIOGPU3DDevice::destroy_resource(PerContextState& per_context_state, Graphics::VirtIOGPU::ResourceID resource_id)
+{
+    VERIFY(m_graphics_adapter->operation_lock().is_locked());
+    m_graphics_adapter->release_scanouts_of_3d_resource(resource_id);
+    m_graphics_adapter->detach_resource_from_context(resource_id, per_context_state.context_id());
+    m_graphics_adapter->detach_backing_storage(resource_id);
+    m_graphics_adapter->delete_resource(resource_id);
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> VirtIOGPU3DDevice::vmobject_for_mmap(Process&, OpenFileDescription& description, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    // Mapping the transfer region lets userspace fill it (or read it back) without going through VIRGL_IOCTL_TRANSFER_DATA
+    if (!shared)
+        return ENOTSUP;
+    if (offset != 0)
+        return ENOTSUP;
+    auto per_context_state = TRY(get_context_for_description(description));
+    return per_context_state->transfer_buffer_region().vmobject();
+}
+
 ErrorOr<LockRefPtr<VirtIOGPU3DDevice::PerContextState>> VirtIOGPU3DDevice::get_context_for_description(OpenFileDescription& description)
 {
     auto res = m_context_state_lookup.get(&description);
@@ -58,30 +86,49 @@ ErrorOr<LockRefPtr<VirtIOGPU3DDevice::PerContextState>> VirtIOGPU3DDevice::get_c
 
 ErrorOr<void> VirtIOGPU3DDevice::ioctl(OpenFileDescription& description, unsigned request, Userspace<void*> arg)
 {
-    // TODO: We really should have ioctls for destroying resources as well
     switch (request) {
     case VIRGL_IOCTL_CREATE_CONTEXT: {
         if (m_context_state_lookup.contains(&description))
             return EEXIST;
+        size_t transfer_region_size = NUM_TRANSFER_REGION_PAGES * PAGE_SIZE;
+        if (arg.ptr()) {
+            auto context_spec = TRY(copy_typed_from_user(static_ptr_cast<VirGLContextSpec const*>(arg)));
+            if (context_spec.transfer_region_size == 0 || context_spec.transfer_region_size > MAX_TRANSFER_REGION_SIZE)
+                return EINVAL;
+            transfer_region_size = TRY(Memory::page_round_up(context_spec.transfer_region_size));
+        }
+        auto transfer_buffer_region = TRY(MM.allocate_kernel_region(
+            transfer_region_size,
+            "VIRGL3D userspace upload buffer"sv,
+            Memory::Region::Access::ReadWrite,
+            AllocationStrategy::AllocateNow));
         SpinlockLocker locker(m_graphics_adapter->operation_lock());
-        // TODO: Delete the context if it fails to be set in m_context_state_lookup
         auto context_id = m_graphics_adapter->create_context();
-        LockRefPtr<PerContextState> per_context_state = TRY(PerContextState::try_create(context_id));
-        TRY(m_context_state_lookup.try_set(&description, per_context_state));
+        auto per_context_state_or_error = PerContextState::try_create(context_id, move(transfer_buffer_region));
+        if (per_context_state_or_error.is_error()) {
+            m_graphics_adapter->delete_context(context_id);
+            return per_context_state_or_error.release_error();
+        }
+        if (auto result = m_context_state_lookup.try_set(&description, per_context_state_or_error.release_value()); result.is_error()) {
+            m_graphics_adapter->delete_context(context_id);
+            return result.release_error();
+        }
         return {};
     }
     case VIRGL_IOCTL_TRANSFER_DATA: {
         auto& transfer_buffer_region = TRY(get_context_for_description(description))->transfer_buffer_region();
         auto user_transfer_descriptor = static_ptr_cast<VirGLTransferDescriptor const*>(arg);
         auto transfer_descriptor = TRY(copy_typed_from_user(user_transfer_descriptor));
+        if (Checked<size_t>::addition_would_overflow(transfer_descriptor.offset_in_region, transfer_descriptor.num_bytes))
+            return EOVERFLOW;
         if (transfer_descriptor.direction == VIRGL_DATA_DIR_GUEST_TO_HOST) {
-            if (transfer_descriptor.offset_in_region + transfer_descriptor.num_bytes > NUM_TRANSFER_REGION_PAGES * PAGE_SIZE) {
+            if (transfer_descriptor.offset_in_region + transfer_descriptor.num_bytes > transfer_buffer_region.size()) {
                 return EOVERFLOW;
             }
             auto target = transfer_buffer_region.vaddr().offset(transfer_descriptor.offset_in_region).as_ptr();
             return copy_from_user(target, transfer_descriptor.data, transfer_descriptor.num_bytes);
         } else if (transfer_descriptor.direction == VIRGL_DATA_DIR_HOST_TO_GUEST) {
-            if (transfer_descriptor.offset_in_region + transfer_descriptor.num_bytes > NUM_TRANSFER_REGION_PAGES * PAGE_SIZE) {
+            if (transfer_descriptor.offset_in_region + transfer_descriptor.num_bytes > transfer_buffer_region.size()) {
                 return EOVERFLOW;
             }
             auto source = transfer_buffer_region.vaddr().offset(transfer_descriptor.offset_in_region).as_ptr();
@@ -121,13 +168,59 @@ ErrorOr<void> VirtIOGPU3DDevice::ioctl(OpenFileDescription& description, unsigne
             .flags = spec.flags,
             .padding = 0,
         };
+        TRY(per_context_state->resources().try_ensure_capacity(per_context_state->resources().size() + 1));
         SpinlockLocker locker(m_graphics_adapter->operation_lock());
-        auto resource_id = m_graphics_adapter->create_3d_resource(resource_spec).value();
+        auto resource_id = m_graphics_adapter->create_3d_resource(resource_spec);
         m_graphics_adapter->attach_resource_to_context(resource_id, per_context_state->context_id());
-        m_graphics_adapter->ensure_backing_storage(resource_id, per_context_state->transfer_buffer_region(), 0, NUM_TRANSFER_REGION_PAGES * PAGE_SIZE);
-        spec.created_resource_id = resource_id;
-        // FIXME: We should delete the resource we just created if we fail to copy the resource id out
-        return copy_to_user(static_ptr_cast<VirGL3DResourceSpec*>(arg), &spec);
+        m_graphics_adapter->ensure_backing_storage(resource_id, per_context_state->transfer_buffer_region(), 0, per_context_state->transfer_buffer_region().size());
+        MUST(per_context_state->resources().try_set(resource_id));
+        spec.created_resource_id = resource_id.value();
+        if (auto result = copy_to_user(static_ptr_cast<VirGL3DResourceSpec*>(arg), &spec); result.is_error()) {
+            per_context_state->resources().remove(resource_id);
+            destroy_resource(*per_context_state, resource_id);
+            return result.release_error();
+        }
+        return {};
+    }
+    case VIRGL_IOCTL_DESTROY_RESOURCE: {
+        auto per_context_state = TRY(get_context_for_description(description));
+        Graphics::VirtIOGPU::ResourceID resource_id = static_cast<u32>(arg.ptr());
+        SpinlockLocker locker(m_graphics_adapter->operation_lock());
+        if (!per_context_state->resources().remove(resource_id))
+            return ENOENT;
+        destroy_resource(*per_context_state, resource_id);
+        return {};
+    }
+    case VIRGL_IOCTL_SET_SCANOUT: {
+        auto per_context_state = TRY(get_context_for_description(description));
+        auto scanout_descriptor = TRY(copy_typed_from_user(static_ptr_cast<VirGLScanoutDescriptor const*>(arg)));
+        auto display_connector_description = TRY(Process::current().open_file_description(scanout_descriptor.display_connector_fd));
+        Graphics::VirtIOGPU::ResourceID resource_id = scanout_descriptor.resource_id;
+        SpinlockLocker locker(m_graphics_adapter->operation_lock());
+        auto scanout_id = TRY(m_graphics_adapter->scanout_id_for_display_connector(display_connector_description->file()));
+        if (resource_id.value() == 0) {
+            auto displayed_resource_id = m_graphics_adapter->m_scanouts[scanout_id.value()].resource_3d_id;
+            if (displayed_resource_id.value() == 0)
+                return {};
+            if (!per_context_state->resources().contains(displayed_resource_id))
+                return EPERM;
+            m_graphics_adapter->release_scanouts_of_3d_resource(displayed_resource_id);
+            return {};
+        }
+        if (!per_context_state->resources().contains(resource_id))
+            return ENOENT;
+        m_graphics_adapter->set_scanout_3d_resource(scanout_id, resource_id);
+        return {};
+    }
+    case VIRGL_IOCTL_FLUSH_RESOURCE: {
+        auto per_context_state = TRY(get_context_for_description(description));
+        auto flush_descriptor = TRY(copy_typed_from_user(static_ptr_cast<VirGLFlushDescriptor const*>(arg)));
+        Graphics::VirtIOGPU::ResourceID resource_id = flush_descriptor.resource_id;
+        SpinlockLocker locker(m_graphics_adapter->operation_lock());
+        if (!per_context_state->resources().contains(resource_id))
+            return ENOENT;
+        m_graphics_adapter->flush_displayed_image(resource_id, { .x = flush_descriptor.x, .y = flush_descriptor.y, .width = flush_descriptor.width, .height = flush_descriptor.height });
+        return {};
     }
     }
     return EINVAL;
@@ -7,8 +7,10 @@
 #pragma once
 
 #include <AK/DistinctNumeric.h>
+#include <AK/HashTable.h>
 #include <Kernel/Devices/CharacterDevice.h>
 #include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Graphics/VirtIOGPU/GraphicsAdapter.h>
 #include <Kernel/Graphics/VirtIOGPU/Protocol.h>
 
 namespace Kernel::Graphics::VirtIOGPU {
@@ -102,23 +104,21 @@ private:
 
     class PerContextState final : public AtomicRefCounted<PerContextState> {
     public:
-        static ErrorOr<LockRefPtr<PerContextState>> try_create(Graphics::VirtIOGPU::ContextID context_id)
+        static ErrorOr<LockRefPtr<PerContextState>> try_create(Graphics::VirtIOGPU::ContextID context_id, NonnullOwnPtr<Memory::Region> transfer_buffer_region)
         {
-            auto region_result = TRY(MM.allocate_kernel_region(
-                NUM_TRANSFER_REGION_PAGES * PAGE_SIZE,
-                "VIRGL3D userspace upload buffer"sv,
-                Memory::Region::Access::ReadWrite,
-                AllocationStrategy::AllocateNow));
-            return TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) PerContextState(context_id, move(region_result))));
+            return TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) PerContextState(context_id, move(transfer_buffer_region))));
         }
         Graphics::VirtIOGPU::ContextID context_id() { return m_context_id; }
         Memory::Region& transfer_buffer_region() { return *m_transfer_buffer_region; }
+        HashTable<Graphics::VirtIOGPU::ResourceID>& resources() { return m_resources; }
 
     private:
         PerContextState() = delete;
         explicit PerContextState(Graphics::VirtIOGPU::ContextID context_id, OwnPtr<Memory::Region> transfer_buffer_region);
         Graphics::VirtIOGPU::ContextID m_context_id;
         OwnPtr<Memory::Region> m_transfer_buffer_region;
+        // The resources created by this context, which are destroyed along with it
+        HashTable<Graphics::VirtIOGPU::ResourceID> m_resources;
     };
 
     virtual bool can_read(OpenFileDescription const&, u64) const override { return true; }
@@ -128,10 +128,12 @@ private:
     virtual StringView class_name() const override { return "virgl3d"sv; }
 
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, OpenFileDescription&, Memory::VirtualRange const&, u64& offset, bool shared) override;
     virtual void detach(OpenFileDescription&) override;
 
 private:
     ErrorOr<LockRefPtr<PerContextState>> get_context_for_description(OpenFileDescription&);
+    void destroy_resource(PerContextState&, Graphics::VirtIOGPU::ResourceID);
 
     NonnullLockRefPtr<VirtIOGraphicsAdapter> m_graphics_adapter;
     // Context used for kernel operations (e.g. flushing resources to scanout)
@@ -140,6 +142,8 @@ private:
     // Memory management for backing buffers
     NonnullOwnPtr<Memory::Region> m_transfer_buffer_region;
     constexpr static size_t NUM_TRANSFER_REGION_PAGES = 256;
+    // Large enough for a whole frame at the highest resolution a scanout supports
+    constexpr static size_t MAX_TRANSFER_REGION_SIZE = MAX_VIRTIOGPU_RESOLUTION_WIDTH * MAX_VIRTIOGPU_RESOLUTION_HEIGHT * sizeof(u32);
 };
 
 }
@@ -98,6 +98,9 @@ ErrorOr<void> VirtIOGraphicsAdapter::attach_physical_range_to_framebuffer(VirtIO
     Scanout::PhysicalBuffer& buffer = main_buffer ? m_scanouts[connector.scanout_id().value()].main_buffer : m_scanouts[connector.scanout_id().value()].back_buffer;
     buffer.framebuffer_offset = framebuffer_offset;
 
+    // Setting the scanout below takes it back from any 3D resource that was displayed on it
+    m_scanouts[connector.scanout_id().value()].resource_3d_id = 0;
+
     // 1. Create BUFFER using VIRTIO_GPU_CMD_RESOURCE_CREATE_2D
     if (buffer.resource_id.value() != 0)
         delete_resource(buffer.resource_id);
@@ -517,4 +520,66 @@ void VirtIOGraphicsAdapter::attach_resource_to_context(Graphics::VirtIOGPU::Reso
     VERIFY(response.type == to_underlying(Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_RESP_OK_NODATA));
 }
 
+void VirtIOGraphicsAdapter::delete_context(Graphics::VirtIOGPU::ContextID context_id)
+{
+    VERIFY(m_operation_lock.is_locked());
+    auto writer = create_scratchspace_writer();
+    auto& request = writer.append_structure<Graphics::VirtIOGPU::Protocol::ControlHeader>();
+    auto& response = writer.append_structure<Graphics::VirtIOGPU::Protocol::ControlHeader>();
+    populate_virtio_gpu_request_header(request, Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_CMD_CTX_DESTROY, 0);
+    request.context_id = context_id.value();
+
+    synchronous_virtio_gpu_command(start_of_scratch_space(), sizeof(request), sizeof(response));
+
+    VERIFY(response.type == to_underlying(Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_RESP_OK_NODATA));
+}
+
+void VirtIOGraphicsAdapter::detach_resource_from_context(Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::ContextID context_id)
+{
+    VERIFY(m_operation_lock.is_locked());
+    auto writer = create_scratchspace_writer();
+    auto& request = writer.append_structure<Graphics::VirtIOGPU::Protocol::ContextDetachResource>();
+    auto& response = writer.append_structure<Graphics::VirtIOGPU::Protocol::ControlHeader>();
+    populate_virtio_gpu_request_header(request.header, Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_CMD_CTX_DETACH_RESOURCE, 0);
+    request.header.context_id = context_id.value();
+    request.resource_id = resource_id.value();
+
+    synchronous_virtio_gpu_command(start_of_scratch_space(), sizeof(request), sizeof(response));
+
+    VERIFY(response.type == to_underlying(Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_RESP_OK_NODATA));
+}
+
+ErrorOr<Graphics::VirtIOGPU::ScanoutID> VirtIOGraphicsAdapter::scanout_id_for_display_connector(File const& file) const
+{
+    for (size_t index = 0; index < m_num_scanouts; index++) {
+        if (m_scanouts[index].display_connector.ptr() == &file)
+            return Graphics::VirtIOGPU::ScanoutID(index);
+    }
+    return Error::from_errno(ENODEV);
+}
+
+void VirtIOGraphicsAdapter::set_scanout_3d_resource(Graphics::VirtIOGPU::ScanoutID scanout, Graphics::VirtIOGPU::ResourceID resource_id)
+{
+    VERIFY(m_operation_lock.is_locked());
+    VERIFY(scanout < VIRTIO_GPU_MAX_SCANOUTS);
+    auto display_info = m_scanouts[scanout.value()].display_connector->display_information({});
+    set_scanout_resource(scanout, resource_id, display_info.rect);
+    m_scanouts[scanout.value()].resource_3d_id = resource_id;
+}
+
+void VirtIOGraphicsAdapter::release_scanouts_of_3d_resource(Graphics::VirtIOGPU::ResourceID resource_id)
+{
+    VERIFY(m_operation_lock.is_locked());
+    for (size_t index = 0; index < m_num_scanouts; index++) {
+        auto& scanout = m_scanouts[index];
+        if (scanout.resource_3d_id != resource_id)
+            continue;
+        // Give the scanout back to the framebuffer, so that the display doesn't keep showing a resource that's gone
+        auto display_info = scanout.display_connector->display_information({});
+        set_scanout_resource(index, scanout.main_buffer.resource_id, display_info.rect);
+        flush_displayed_image(scanout.main_buffer.resource_id, display_info.rect);
+        scanout.resource_3d_id = 0;
+    }
+}
+
 }
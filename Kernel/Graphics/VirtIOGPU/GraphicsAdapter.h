@@ -66,6 +66,8 @@ private:
         LockRefPtr<VirtIODisplayConnector> display_connector;
         PhysicalBuffer main_buffer;
         PhysicalBuffer back_buffer;
+        // A 3D resource that userspace has put on this scanout in place of the framebuffer, if any
+        Graphics::VirtIOGPU::ResourceID resource_3d_id { 0 };
     };
 
     VirtIOGraphicsAdapter(PCI::DeviceIdentifier const&, NonnullOwnPtr<Memory::Region> scratch_space_region);
@@ -86,7 +88,12 @@ private:
 
     // 3D Command stuff
     Graphics::VirtIOGPU::ContextID create_context();
+    void delete_context(Graphics::VirtIOGPU::ContextID context_id);
     void attach_resource_to_context(Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::ContextID context_id);
+    void detach_resource_from_context(Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::ContextID context_id);
+    ErrorOr<Graphics::VirtIOGPU::ScanoutID> scanout_id_for_display_connector(File const&) const;
+    void set_scanout_3d_resource(Graphics::VirtIOGPU::ScanoutID scanout, Graphics::VirtIOGPU::ResourceID resource_id);
+    void release_scanouts_of_3d_resource(Graphics::VirtIOGPU::ResourceID resource_id);
     void submit_command_buffer(Graphics::VirtIOGPU::ContextID, Function<size_t(Bytes)> buffer_writer);
     Graphics::VirtIOGPU::Protocol::TextureFormat get_framebuffer_format() const { return Graphics::VirtIOGPU::Protocol::TextureFormat::VIRTIO_GPU_FORMAT_B8G8R8X8_UNORM; }
 
@@ -283,6 +283,13 @@ struct ContextAttachResource {
     u32 padding;
 };
 
+// No equivalent in specification
+struct ContextDetachResource {
+    ControlHeader header;
+    u32 resource_id;
+    u32 padding;
+};
+
 // No equivalent in specification
 struct CommandSubmit {
     ControlHeader header;
@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/MemoryManager.h>
@@ -204,6 +205,8 @@ private:
     KmallocSlabBlock::List m_full_blocks;
 };
 
+static constexpr size_t KMALLOC_SLABHEAP_COUNT = 6;
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -392,7 +395,7 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[KMALLOC_SLABHEAP_COUNT] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -405,6 +408,142 @@ static size_t g_kfree_call_count;
 static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
+// Each processor keeps a magazine of free slabs per slabheap size class, so that the
+// common kmalloc() and kfree_sized() of small objects don't have to take s_lock.
+// When a magazine runs empty (or full), a whole batch of slabs is moved between it
+// and the slabheap under a single acquisition of s_lock.
+struct KmallocMagazine {
+    static constexpr size_t capacity = 32;
+    static constexpr size_t batch_size = capacity / 2;
+
+    size_t count { 0 };
+    void* slabs[capacity];
+};
+
+// NOTE: A processor's cache is only ever touched by that processor with interrupts
+//       disabled, except for the statistics, which are read by get_kmalloc_stats().
+struct KmallocProcessorCache {
+    KmallocMagazine magazines[KMALLOC_SLABHEAP_COUNT];
+    size_t nested_kfree_calls { 0 };
+
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> kmalloc_hits { 0 };
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> kmalloc_misses { 0 };
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> kfree_hits { 0 };
+    Atomic<size_t, AK::MemoryOrder::memory_order_relaxed> kfree_misses { 0 };
+};
+
+// Thread affinity masks are 32 bits wide, so we never schedule on more processors than this.
+static constexpr size_t KMALLOC_MAX_PROCESSOR_CACHES = 32;
+static KmallocProcessorCache s_processor_caches[KMALLOC_MAX_PROCESSOR_CACHES];
+
+static KmallocProcessorCache* current_processor_cache()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    if (!Processor::is_initialized())
+        return nullptr;
+    auto id = Processor::current_id();
+    if (id >= KMALLOC_MAX_PROCESSOR_CACHES)
+        return nullptr;
+    return &s_processor_caches[id];
+}
+
+static Optional<size_t> slabheap_index_for_size(size_t size)
+{
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+        if (size <= g_kmalloc_global->slabheaps[i].slab_size())
+            return i;
+    }
+    return {};
+}
+
+static void add_kmalloc_perf_event(size_t size, void* ptr)
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    if (current_thread) {
+        // FIXME: By the time we check this, we have already allocated above.
+        //        This means that in the case of an infinite recursion, we can't catch it this way.
+        VERIFY(current_thread->is_allocation_enabled());
+        PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
+    }
+}
+
+static void add_kfree_perf_event(void* ptr)
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    if (current_thread) {
+        VERIFY(current_thread->is_allocation_enabled());
+        PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+    }
+}
+
+static void* try_allocate_from_magazine(size_t size)
+{
+    auto slabheap_index = slabheap_index_for_size(size);
+    if (!slabheap_index.has_value())
+        return nullptr;
+
+    InterruptDisabler disabler;
+    auto* cache = current_processor_cache();
+    if (!cache)
+        return nullptr;
+
+    auto& slabheap = g_kmalloc_global->slabheaps[slabheap_index.value()];
+    auto& magazine = cache->magazines[slabheap_index.value()];
+    if (magazine.count == 0) {
+        cache->kmalloc_misses++;
+        SpinlockLocker lock(s_lock);
+        ++g_kmalloc_call_count;
+        while (magazine.count < KmallocMagazine::batch_size)
+            magazine.slabs[magazine.count++] = slabheap.allocate();
+    } else {
+        cache->kmalloc_hits++;
+    }
+
+    auto* ptr = magazine.slabs[--magazine.count];
+    memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+    return ptr;
+}
+
+static bool try_deallocate_to_magazine(void* ptr, size_t size)
+{
+    auto slabheap_index = slabheap_index_for_size(size);
+    if (!slabheap_index.has_value())
+        return false;
+
+    InterruptDisabler disabler;
+    auto* cache = current_processor_cache();
+    if (!cache)
+        return false;
+
+    VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+
+    if (cache->nested_kfree_calls == 0) {
+        TemporaryChange nested_change(cache->nested_kfree_calls, cache->nested_kfree_calls + 1);
+        add_kfree_perf_event(ptr);
+    }
+
+    auto& slabheap = g_kmalloc_global->slabheaps[slabheap_index.value()];
+    auto& magazine = cache->magazines[slabheap_index.value()];
+    memset(ptr, KFREE_SCRUB_BYTE, slabheap.slab_size());
+
+    if (magazine.count == KmallocMagazine::capacity) {
+        cache->kfree_misses++;
+        SpinlockLocker lock(s_lock);
+        ++g_kfree_call_count;
+        while (magazine.count > KmallocMagazine::capacity - KmallocMagazine::batch_size)
+            slabheap.deallocate(magazine.slabs[--magazine.count]);
+    } else {
+        cache->kfree_hits++;
+    }
+
+    magazine.slabs[magazine.count++] = ptr;
+    return true;
+}
+
 void kmalloc_enable_expand()
 {
     g_kmalloc_global->enable_expansion();
@@ -426,6 +565,13 @@ void* kmalloc(size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    if (!g_dump_kmalloc_stacks) {
+        if (auto* ptr = try_allocate_from_magazine(size)) {
+            add_kmalloc_perf_event(size, ptr);
+            return ptr;
+        }
+    }
+
     SpinlockLocker lock(s_lock);
     ++g_kmalloc_call_count;
 
@@ -435,17 +581,7 @@ void* kmalloc(size_t size)
     }
 
     void* ptr = g_kmalloc_global->allocate(size);
-
-    Thread* current_thread = Thread::current();
-    if (!current_thread)
-        current_thread = Processor::idle_thread();
-    if (current_thread) {
-        // FIXME: By the time we check this, we have already allocated above.
-        //        This means that in the case of an infinite recursion, we can't catch it this way.
-        VERIFY(current_thread->is_allocation_enabled());
-        PerformanceManager::add_kmalloc_perf_event(*current_thread, size, (FlatPtr)ptr);
-    }
-
+    add_kmalloc_perf_event(size, ptr);
     return ptr;
 }
 
@@ -473,19 +609,15 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    if (try_deallocate_to_magazine(ptr, size))
+        return;
+
     SpinlockLocker lock(s_lock);
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
-        Thread* current_thread = Thread::current();
-        if (!current_thread)
-            current_thread = Processor::idle_thread();
-        if (current_thread) {
-            VERIFY(current_thread->is_allocation_enabled());
-            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
-        }
-    }
+    if (g_nested_kfree_calls == 1)
+        add_kfree_perf_event(ptr);
 
     g_kmalloc_global->deallocate(ptr, size);
     --g_nested_kfree_calls;
@@ -587,4 +719,24 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = g_kmalloc_global->free_bytes();
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+    stats.kmalloc_magazine_hits = 0;
+    stats.kmalloc_magazine_misses = 0;
+    stats.kfree_magazine_hits = 0;
+    stats.kfree_magazine_misses = 0;
+
+    for (auto const& cache : s_processor_caches) {
+        size_t bytes_cached = 0;
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i)
+            bytes_cached += cache.magazines[i].count * g_kmalloc_global->slabheaps[i].slab_size();
+        stats.bytes_allocated -= bytes_cached;
+        stats.bytes_free += bytes_cached;
+
+        // NOTE: Misses already went through the global call counters above.
+        stats.kmalloc_call_count += cache.kmalloc_hits;
+        stats.kfree_call_count += cache.kfree_hits;
+        stats.kmalloc_magazine_hits += cache.kmalloc_hits;
+        stats.kmalloc_magazine_misses += cache.kmalloc_misses;
+        stats.kfree_magazine_hits += cache.kfree_hits;
+        stats.kfree_magazine_misses += cache.kfree_misses;
+    }
 }
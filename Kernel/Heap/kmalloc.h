@@ -47,6 +47,10 @@ struct kmalloc_stats {
     size_t bytes_free;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    size_t kmalloc_magazine_hits;
+    size_t kmalloc_magazine_misses;
+    size_t kfree_magazine_hits;
+    size_t kfree_magazine_misses;
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/API/POSIX/errno.h>
+#include <Kernel/API/POSIX/poll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/IORing.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+// Lets io_ring_enter() and close() wake the IORing task up while it's waiting for pending operations to become ready.
+class IORingTaskWakeup final : public File {
+public:
+    IORingTaskWakeup() = default;
+
+    void wake()
+    {
+        m_woken.store(true, AK::MemoryOrder::memory_order_release);
+        evaluate_block_conditions();
+    }
+    void clear() { m_woken.store(false, AK::MemoryOrder::memory_order_release); }
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override { return m_woken.load(AK::MemoryOrder::memory_order_acquire); }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return ENOTSUP; }
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override { return KString::try_create(":io-ring-task-wakeup:"sv); }
+    virtual StringView class_name() const override { return "IORingTaskWakeup"sv; }
+
+private:
+    Atomic<bool> m_woken { false };
+};
+
+static Singleton<IORingTaskWakeup> s_task_wakeup;
+
+// The rings that have operations waiting for their file to become ready. These are serviced by the IORing task.
+static Singleton<SpinlockProtected<Vector<NonnullLockRefPtr<IORing>>>> s_rings_with_pending_operations;
+
+// Only ever used by the IORing task, but it's too big to live on its stack.
+static Thread::SelectBlocker::FDVector s_task_fds;
+static LockRefPtr<OpenFileDescription> s_task_wakeup_description;
+
+static i32 result_from(ErrorOr<size_t> result)
+{
+    if (result.is_error())
+        return -result.error().code();
+    return static_cast<i32>(min(result.value(), static_cast<size_t>(NumericLimits<i32>::max())));
+}
+
+static BlockFlags block_flags_for_poll_events(u16 events)
+{
+    auto block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp;
+    if (events & POLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & POLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & POLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & POLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (events & POLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+static i32 poll_events_for_block_flags(BlockFlags block_flags)
+{
+    i32 events = 0;
+    if (has_flag(block_flags, BlockFlags::Read))
+        events |= POLLIN;
+    if (has_flag(block_flags, BlockFlags::Write))
+        events |= POLLOUT;
+    return events;
+}
+
+ErrorOr<NonnullLockRefPtr<IORing>> IORing::try_create(Process& process, u32 submission_entries)
+{
+    if (submission_entries == 0 || submission_entries > io_ring_max_entries || !is_power_of_two(submission_entries))
+        return EINVAL;
+
+    auto size = io_ring_mapping_size(submission_entries);
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "IORing"sv, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) IORing(process, submission_entries, move(vmobject), move(region)));
+}
+
+IORing::IORing(Process& process, u32 submission_entries, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> kernel_region)
+    : m_submission_entries(submission_entries)
+    , m_vmobject(move(vmobject))
+    , m_kernel_region(move(kernel_region))
+{
+    m_process = process;
+    header().submission_entries = m_submission_entries;
+    header().completion_entries = io_ring_completion_entries(m_submission_entries);
+}
+
+IORing::~IORing() = default;
+
+IORingSubmission const& IORing::submission_at(u32 index) const
+{
+    auto* submissions = reinterpret_cast<IORingSubmission const*>(m_kernel_region->vaddr().offset(io_ring_submissions_offset()).as_ptr());
+    return submissions[index & (m_submission_entries - 1)];
+}
+
+IORingCompletion& IORing::completion_at(u32 index) const
+{
+    auto* completions = reinterpret_cast<IORingCompletion*>(m_kernel_region->vaddr().offset(io_ring_completions_offset(m_submission_entries)).as_ptr());
+    return completions[index & (io_ring_completion_entries(m_submission_entries) - 1)];
+}
+
+u32 IORing::available_completions() const
+{
+    // NOTE: The head is written by userspace, so we can't trust it to be anywhere near the tail.
+    auto head = AK::atomic_load(&header().completion_head, AK::MemoryOrder::memory_order_acquire);
+    return min<u32>(m_completion_tail - head, io_ring_completion_entries(m_submission_entries));
+}
+
+bool IORing::can_read(OpenFileDescription const&, u64) const
+{
+    return available_completions() > 0;
+}
+
+void IORing::post_completion(u64 user_data, i32 result)
+{
+    {
+        SpinlockLocker locker(m_completion_lock);
+        auto head = AK::atomic_load(&header().completion_head, AK::MemoryOrder::memory_order_acquire);
+        if (m_completion_tail - head >= io_ring_completion_entries(m_submission_entries)) {
+            AK::atomic_fetch_add(&header().dropped_completions, 1u, AK::MemoryOrder::memory_order_relaxed);
+            return;
+        }
+        completion_at(m_completion_tail) = { .user_data = user_data, .result = result, .reserved = 0 };
+        ++m_completion_tail;
+        AK::atomic_store(&header().completion_tail, m_completion_tail, AK::MemoryOrder::memory_order_release);
+    }
+    evaluate_block_conditions();
+    m_completion_wait_queue.wake_all();
+}
+
+ErrorOr<size_t> IORing::enter(Process& process, u32 to_submit, u32 min_complete)
+{
+    // Asynchronous operations are carried out in the address space of the process that created the ring.
+    if (m_process.strong_ref().ptr() != &process)
+        return EPERM;
+
+    size_t submitted = 0;
+    {
+        MutexLocker locker(m_lock);
+        auto tail = AK::atomic_load(&header().submission_tail, AK::MemoryOrder::memory_order_acquire);
+        submitted = min(min(to_submit, tail - m_submission_head), m_submission_entries);
+        for (size_t i = 0; i < submitted; ++i) {
+            // NOTE: Copy the submission out of shared memory so userspace can't change it under our feet.
+            IORingSubmission submission = submission_at(m_submission_head++);
+            submit(process, submission);
+        }
+        AK::atomic_store(&header().submission_head, m_submission_head, AK::MemoryOrder::memory_order_release);
+
+        if (!m_pending_operations.is_empty())
+            queue_for_task();
+    }
+
+    min_complete = min<u32>(min_complete, io_ring_completion_entries(m_submission_entries));
+    while (available_completions() < min_complete) {
+        if (m_completion_wait_queue.wait_on({}, "IORing"sv).was_interrupted()) {
+            if (submitted)
+                return submitted;
+            return EINTR;
+        }
+    }
+    return submitted;
+}
+
+void IORing::submit(Process& process, IORingSubmission const& submission)
+{
+    if (submission.operation == IORingOperation::Nop) {
+        post_completion(submission.user_data, 0);
+        return;
+    }
+
+    auto description_or_error = process.open_file_description(submission.fd);
+    if (description_or_error.is_error()) {
+        post_completion(submission.user_data, -description_or_error.error().code());
+        return;
+    }
+    auto description = description_or_error.release_value();
+
+    auto fail = [&](ErrnoCode error) {
+        post_completion(submission.user_data, -error);
+    };
+
+    BlockFlags block_flags = BlockFlags::None;
+    switch (submission.operation) {
+    case IORingOperation::Read:
+        if (!description->is_readable())
+            return fail(EBADF);
+        block_flags = BlockFlags::Read;
+        break;
+    case IORingOperation::Write:
+        if (!description->is_writable())
+            return fail(EBADF);
+        block_flags = BlockFlags::Write;
+        break;
+    case IORingOperation::Poll:
+        block_flags = block_flags_for_poll_events(submission.poll_events);
+        break;
+    case IORingOperation::Accept:
+        if (!description->is_socket())
+            return fail(ENOTSOCK);
+        block_flags = BlockFlags::Accept;
+        break;
+    case IORingOperation::Connect: {
+        if (!description->is_socket())
+            return fail(ENOTSOCK);
+        // NOTE: Connecting has to look at the address in our own address space, so we start it right away.
+        //       On a non-blocking socket, the rest of the connection setup then happens asynchronously.
+        auto& socket = *description->socket();
+        auto result = socket.connect(process.credentials(), *description, Userspace<sockaddr const*>(submission.address), submission.length);
+        if (!result.is_error())
+            return post_completion(submission.user_data, 0);
+        if (result.error().code() != EINPROGRESS)
+            return post_completion(submission.user_data, -result.error().code());
+        block_flags = BlockFlags::Connect;
+        break;
+    }
+    default:
+        return fail(EINVAL);
+    }
+
+    PendingOperation operation { submission, move(description), block_flags };
+    if (auto result = try_perform(process, operation); result.has_value()) {
+        post_completion(submission.user_data, result.value());
+        return;
+    }
+    if (auto result = m_pending_operations.try_append(move(operation)); result.is_error())
+        fail(ENOMEM);
+}
+
+Optional<i32> IORing::try_perform(Process& process, PendingOperation& operation)
+{
+    auto const& submission = operation.submission;
+    auto& description = *operation.description;
+
+    auto unblocked_flags = description.should_unblock(operation.block_flags);
+    if (unblocked_flags == BlockFlags::None)
+        return {};
+
+    switch (submission.operation) {
+    case IORingOperation::Read: {
+        auto buffer_or_error = UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length);
+        if (buffer_or_error.is_error())
+            return -EFAULT;
+        auto buffer = buffer_or_error.release_value();
+        if (submission.offset == io_ring_current_offset)
+            return result_from(description.read(buffer, submission.length));
+        return result_from(description.read(buffer, submission.offset, submission.length));
+    }
+    case IORingOperation::Write: {
+        auto buffer_or_error = UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length);
+        if (buffer_or_error.is_error())
+            return -EFAULT;
+        auto buffer = buffer_or_error.release_value();
+        if (submission.offset == io_ring_current_offset)
+            return result_from(description.write(buffer, submission.length));
+        return result_from(description.write(submission.offset, buffer, submission.length));
+    }
+    case IORingOperation::Poll:
+        return poll_events_for_block_flags(unblocked_flags);
+    case IORingOperation::Accept: {
+        auto accepted_socket = description.socket()->accept();
+        // Someone else got to the connection first, so keep waiting.
+        if (!accepted_socket)
+            return {};
+        auto fd_or_error = install_accepted_socket(process, *accepted_socket, submission.flags);
+        if (fd_or_error.is_error())
+            return -fd_or_error.error().code();
+        return fd_or_error.value();
+    }
+    case IORingOperation::Connect:
+        // FIXME: Report the actual reason the connection attempt failed.
+        if (!description.socket()->is_connected())
+            return -ECONNREFUSED;
+        return 0;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+ErrorOr<i32> IORing::install_accepted_socket(Process& process, Socket& accepted_socket, u32 flags)
+{
+    auto description = TRY(OpenFileDescription::try_create(accepted_socket));
+    description->set_readable(true);
+    description->set_writable(true);
+    if (flags & SOCK_NONBLOCK)
+        description->set_blocking(false);
+    int fd_flags = 0;
+    if (flags & SOCK_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    auto fd = TRY(process.fds().with_exclusive([&](auto& fds) -> ErrorOr<i32> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description), fd_flags);
+        return fd_allocation.fd;
+    }));
+
+    // NOTE: Moving this state to Completed is what causes connect() to unblock on the client side.
+    accepted_socket.set_setup_state(Socket::SetupState::Completed);
+    return fd;
+}
+
+void IORing::add_to_task_queue()
+{
+    s_rings_with_pending_operations->with([&](auto& rings) {
+        if (m_is_queued_for_task)
+            return;
+        // FIXME: If this fails, our pending operations will hang around until the ring is closed.
+        if (rings.try_append(*this).is_error())
+            return;
+        m_is_queued_for_task = true;
+    });
+}
+
+void IORing::queue_for_task()
+{
+    add_to_task_queue();
+    s_task_wakeup->wake();
+}
+
+void IORing::perform_ready_operations()
+{
+    auto process = m_process.strong_ref();
+    MutexLocker locker(m_lock);
+    if (!process) {
+        m_pending_operations.clear();
+        return;
+    }
+
+    ScopedAddressSpaceSwitcher switcher(*process);
+    m_pending_operations.remove_all_matching([&](auto& operation) {
+        auto result = try_perform(*process, operation);
+        if (!result.has_value())
+            return false;
+        post_completion(operation.submission.user_data, result.value());
+        return true;
+    });
+}
+
+bool IORing::append_pending_operations_to(Thread::SelectBlocker::FDVector& fds)
+{
+    MutexLocker locker(m_lock);
+    for (auto& operation : m_pending_operations) {
+        // If we can't wait for all of them, we'll just go around one more time.
+        if (fds.try_append({ operation.description, operation.block_flags }).is_error())
+            break;
+    }
+    return !m_pending_operations.is_empty();
+}
+
+void IORing::service_pending_operations(Badge<IORingTask>)
+{
+    if (!s_task_wakeup_description) {
+        auto description_or_error = OpenFileDescription::try_create(*s_task_wakeup);
+        if (description_or_error.is_error()) {
+            (void)Thread::current()->sleep(Time::from_milliseconds(100));
+            return;
+        }
+        s_task_wakeup_description = description_or_error.release_value();
+    }
+
+    // NOTE: Anything that gets submitted after this point will wake us right back up.
+    s_task_wakeup->clear();
+    auto rings = s_rings_with_pending_operations->with([](auto& rings) {
+        for (auto& ring : rings)
+            ring->m_is_queued_for_task = false;
+        return move(rings);
+    });
+
+    s_task_fds.clear_with_capacity();
+    s_task_fds.unchecked_append({ s_task_wakeup_description, BlockFlags::Read });
+    for (auto& ring : rings) {
+        ring->perform_ready_operations();
+        if (ring->append_pending_operations_to(s_task_fds))
+            ring->add_to_task_queue();
+    }
+
+    (void)Thread::current()->block<Thread::SelectBlocker>({}, s_task_fds);
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> IORing::vmobject_for_mmap(Process&, OpenFileDescription&, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    if (offset != 0 || !shared)
+        return EINVAL;
+    return m_vmobject;
+}
+
+ErrorOr<void> IORing::close()
+{
+    if (attach_count() > 0)
+        return {};
+
+    // Drop the pending operations, and with that the references they hold to their file descriptions.
+    MutexLocker locker(m_lock);
+    if (!m_pending_operations.is_empty()) {
+        m_pending_operations.clear();
+        s_task_wakeup->wake();
+    }
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::formatted("IORing:({})", m_submission_entries);
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Badge.h>
+#include <AK/Vector.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/LockWeakPtr.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Thread.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+class IORingTask;
+
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<IORing>> try_create(Process&, u32 submission_entries);
+    virtual ~IORing() override;
+
+    // Consumes up to the given number of submissions, then waits for at least `min_complete` completions.
+    // Returns the number of submissions that were consumed.
+    ErrorOr<size_t> enter(Process&, u32 to_submit, u32 min_complete);
+
+    // Carries out the pending operations that became ready, then waits until more of them might be.
+    static void service_pending_operations(Badge<IORingTask>);
+
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, OpenFileDescription&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+    virtual ErrorOr<void> close() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return ENOTSUP; }
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual bool is_io_ring() const override { return true; }
+
+private:
+    IORing(Process&, u32 submission_entries, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>);
+
+    struct PendingOperation {
+        IORingSubmission submission;
+        NonnullLockRefPtr<OpenFileDescription> description;
+        Thread::FileBlocker::BlockFlags block_flags;
+    };
+
+    IORingHeader& header() const { return *reinterpret_cast<IORingHeader*>(m_kernel_region->vaddr().as_ptr()); }
+    IORingSubmission const& submission_at(u32 index) const;
+    IORingCompletion& completion_at(u32 index) const;
+    u32 available_completions() const;
+
+    void submit(Process&, IORingSubmission const&);
+    Optional<i32> try_perform(Process&, PendingOperation&);
+    static ErrorOr<i32> install_accepted_socket(Process&, Socket&, u32 flags);
+    void post_completion(u64 user_data, i32 result);
+
+    void add_to_task_queue();
+    void queue_for_task();
+    void perform_ready_operations();
+    bool append_pending_operations_to(Thread::SelectBlocker::FDVector&);
+
+    LockWeakPtr<Process> m_process;
+    u32 const m_submission_entries { 0 };
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_kernel_region;
+
+    // Protects consuming submissions and the list of pending operations.
+    mutable Mutex m_lock { "IORing"sv };
+    u32 m_submission_head { 0 };
+    Vector<PendingOperation> m_pending_operations;
+
+    // Protected by the lock of the list of rings with pending operations.
+    bool m_is_queued_for_task { false };
+
+    // Protects producing completions, which may happen from the IORing task at any time.
+    // NOTE: We keep our own copies of the indices we own, since userspace can write to the header.
+    mutable Spinlock m_completion_lock { LockRank::None };
+    u32 m_completion_tail { 0 };
+    WaitQueue m_completion_wait_queue;
+};
+
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashFunctions.h>
+#include <AK/StringHash.h>
+#include <Kernel/Locking/LockStatistics.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+Atomic<bool> LockStatistics::s_enabled { false };
+
+static constexpr size_t max_lock_classes = 256;
+
+// NOTE: Statistics are recorded from within spinlocks, with interrupts disabled, and possibly from an interrupt
+//       handler that interrupted someone who was recording statistics on the same processor. So everything in
+//       here has to be lock-free, and nobody may ever wait for somebody else to finish.
+struct TrackedCallSite {
+    Atomic<FlatPtr> address { 0 };
+    Atomic<u64> contended_count { 0 };
+};
+
+struct TrackedLockClass {
+    enum class State : u8 {
+        Free,
+        Claiming,
+        Ready,
+    };
+
+    Atomic<State> state { State::Free };
+
+    // Only written while claiming the class, immutable afterwards.
+    u32 hash { 0 };
+    bool is_spinlock { false };
+    LockRank rank { LockRank::None };
+    FlatPtr spinlock_address { 0 };
+    char name[LockStatistics::max_name_length] {};
+    size_t name_length { 0 };
+
+    Atomic<u64> acquire_count { 0 };
+    Atomic<u64> contended_count { 0 };
+    Atomic<u64> total_wait_time_ns { 0 };
+    Atomic<u64> max_wait_time_ns { 0 };
+    Atomic<u64> max_hold_time_ns { 0 };
+    TrackedCallSite top_waiters[LockStatistics::max_call_sites_per_class];
+    Atomic<u64> other_waiters_contended_count { 0 };
+
+    StringView name_view() const { return { name, name_length }; }
+};
+
+static TrackedLockClass s_lock_classes[max_lock_classes];
+static Atomic<u64> s_untracked_class_count { 0 };
+
+template<typename MatchesCallback, typename InitializeCallback>
+static TrackedLockClass* find_or_claim_lock_class(u32 hash, MatchesCallback matches, InitializeCallback initialize)
+{
+    for (size_t probe = 0; probe < max_lock_classes; ++probe) {
+        auto& lock_class = s_lock_classes[(hash + probe) % max_lock_classes];
+        auto state = lock_class.state.load(AK::MemoryOrder::memory_order_acquire);
+        if (state == TrackedLockClass::State::Free) {
+            if (lock_class.state.compare_exchange_strong(state, TrackedLockClass::State::Claiming, AK::MemoryOrder::memory_order_acq_rel)) {
+                lock_class.hash = hash;
+                initialize(lock_class);
+                lock_class.state.store(TrackedLockClass::State::Ready, AK::MemoryOrder::memory_order_release);
+                return &lock_class;
+            }
+        }
+        // NOTE: If someone else is claiming this slot right now, we simply move on instead of waiting for them.
+        //       In the rare case that they are claiming it for the same class, it will show up twice.
+        if (state == TrackedLockClass::State::Ready && lock_class.hash == hash && matches(lock_class))
+            return &lock_class;
+    }
+    ++s_untracked_class_count;
+    return nullptr;
+}
+
+static TrackedLockClass* find_or_claim_mutex_class(StringView name)
+{
+    auto tracked_name = name.substring_view(0, min(name.length(), LockStatistics::max_name_length));
+    auto hash = string_hash(tracked_name.characters_without_null_termination(), tracked_name.length());
+    return find_or_claim_lock_class(
+        hash,
+        [&](auto& lock_class) { return !lock_class.is_spinlock && lock_class.name_view() == tracked_name; },
+        [&](auto& lock_class) {
+            lock_class.is_spinlock = false;
+            memcpy(lock_class.name, tracked_name.characters_without_null_termination(), tracked_name.length());
+            lock_class.name_length = tracked_name.length();
+        });
+}
+
+static TrackedLockClass* find_or_claim_spinlock_class(void const* lock, LockRank rank)
+{
+    return find_or_claim_lock_class(
+        ptr_hash(lock),
+        [&](auto& lock_class) { return lock_class.is_spinlock && lock_class.spinlock_address == FlatPtr(lock); },
+        [&](auto& lock_class) {
+            lock_class.is_spinlock = true;
+            lock_class.rank = rank;
+            lock_class.spinlock_address = FlatPtr(lock);
+        });
+}
+
+static void update_maximum(Atomic<u64>& maximum, u64 value)
+{
+    auto current = maximum.load(AK::MemoryOrder::memory_order_relaxed);
+    while (value > current && !maximum.compare_exchange_strong(current, value, AK::MemoryOrder::memory_order_relaxed)) {
+    }
+}
+
+static void record_waiter(TrackedLockClass& lock_class, FlatPtr call_site)
+{
+    for (auto& waiter : lock_class.top_waiters) {
+        auto address = waiter.address.load(AK::MemoryOrder::memory_order_relaxed);
+        if (address == 0) {
+            if (!waiter.address.compare_exchange_strong(address, call_site, AK::MemoryOrder::memory_order_relaxed) && address != call_site)
+                continue;
+        } else if (address != call_site) {
+            continue;
+        }
+        ++waiter.contended_count;
+        return;
+    }
+    // FIXME: Replace the least contended call site once this one overtakes it.
+    ++lock_class.other_waiters_contended_count;
+}
+
+static void record_contention(TrackedLockClass& lock_class, FlatPtr call_site, u64 wait_time_ns)
+{
+    ++lock_class.contended_count;
+    lock_class.total_wait_time_ns += wait_time_ns;
+    update_maximum(lock_class.max_wait_time_ns, wait_time_ns);
+    record_waiter(lock_class, call_site);
+}
+
+void LockStatistics::set_enabled(bool enabled)
+{
+    s_enabled.store(enabled, AK::MemoryOrder::memory_order_relaxed);
+}
+
+u64 LockStatistics::timestamp()
+{
+    if (!TimeManagement::is_initialized())
+        return 0;
+    return TimeManagement::the().monotonic_time(TimePrecision::Precise).to_nanoseconds();
+}
+
+u64 LockStatistics::timestamp_if_enabled()
+{
+    if (!is_enabled())
+        return 0;
+    return timestamp();
+}
+
+u64 LockStatistics::nanoseconds_since(u64 timestamp)
+{
+    auto now = LockStatistics::timestamp();
+    // NOTE: The clock might not look exactly the same from every processor.
+    return now > timestamp ? now - timestamp : 0;
+}
+
+void LockStatistics::record_mutex_acquire(StringView name)
+{
+    if (auto* lock_class = find_or_claim_mutex_class(name))
+        ++lock_class->acquire_count;
+}
+
+void LockStatistics::record_mutex_contention(StringView name, FlatPtr call_site, u64 wait_time_ns)
+{
+    if (auto* lock_class = find_or_claim_mutex_class(name))
+        record_contention(*lock_class, call_site, wait_time_ns);
+}
+
+void LockStatistics::record_mutex_release(StringView name, u64 acquired_at)
+{
+    if (acquired_at == 0)
+        return;
+    if (auto* lock_class = find_or_claim_mutex_class(name))
+        update_maximum(lock_class->max_hold_time_ns, nanoseconds_since(acquired_at));
+}
+
+void LockStatistics::record_spinlock_contention(void const* lock, LockRank rank, FlatPtr call_site, u64 wait_time_ns)
+{
+    auto* lock_class = find_or_claim_spinlock_class(lock, rank);
+    if (!lock_class)
+        return;
+    // NOTE: Uncontended spinlock acquisitions aren't tracked, so this counts the contended ones only.
+    ++lock_class->acquire_count;
+    record_contention(*lock_class, call_site, wait_time_ns);
+}
+
+u64 LockStatistics::untracked_class_count()
+{
+    return s_untracked_class_count.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+void LockStatistics::for_each_lock_class(Function<void(LockClass const&)> callback)
+{
+    for (auto& tracked_class : s_lock_classes) {
+        if (tracked_class.state.load(AK::MemoryOrder::memory_order_acquire) != TrackedLockClass::State::Ready)
+            continue;
+        LockClass lock_class;
+        lock_class.name = tracked_class.name_view();
+        lock_class.is_spinlock = tracked_class.is_spinlock;
+        lock_class.rank = tracked_class.rank;
+        lock_class.spinlock_address = tracked_class.spinlock_address;
+        lock_class.acquire_count = tracked_class.acquire_count.load(AK::MemoryOrder::memory_order_relaxed);
+        lock_class.contended_count = tracked_class.contended_count.load(AK::MemoryOrder::memory_order_relaxed);
+        lock_class.total_wait_time_ns = tracked_class.total_wait_time_ns.load(AK::MemoryOrder::memory_order_relaxed);
+        lock_class.max_wait_time_ns = tracked_class.max_wait_time_ns.load(AK::MemoryOrder::memory_order_relaxed);
+        lock_class.max_hold_time_ns = tracked_class.max_hold_time_ns.load(AK::MemoryOrder::memory_order_relaxed);
+        for (size_t i = 0; i < max_call_sites_per_class; ++i) {
+            lock_class.top_waiters[i].address = tracked_class.top_waiters[i].address.load(AK::MemoryOrder::memory_order_relaxed);
+            lock_class.top_waiters[i].contended_count = tracked_class.top_waiters[i].contended_count.load(AK::MemoryOrder::memory_order_relaxed);
+        }
+        lock_class.other_waiters_contended_count = tracked_class.other_waiters_contended_count.load(AK::MemoryOrder::memory_order_relaxed);
+        callback(lock_class);
+    }
+}
+
+}
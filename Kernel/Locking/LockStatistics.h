@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <Kernel/Locking/LockRank.h>
+
+namespace Kernel {
+
+// Contention statistics for every class of lock, as shown in /sys/kernel/locks.
+// All mutexes with the same name belong to the same class. Spinlocks don't have a name, so every spinlock that
+// was ever contended is a class of its own. Spinlocks that never were contended aren't tracked at all.
+// Nothing is recorded unless enabled through /sys/kernel/variables/lock_statistics. Even then, an acquisition
+// only costs a few atomic operations, and only contended acquisitions and mutex releases look at the clock.
+class LockStatistics {
+public:
+    static constexpr size_t max_call_sites_per_class = 4;
+    static constexpr size_t max_name_length = 32;
+
+    struct CallSite {
+        FlatPtr address { 0 };
+        u64 contended_count { 0 };
+    };
+
+    struct LockClass {
+        StringView name;
+        bool is_spinlock { false };
+        LockRank rank { LockRank::None };
+        FlatPtr spinlock_address { 0 };
+        u64 acquire_count { 0 };
+        u64 contended_count { 0 };
+        u64 total_wait_time_ns { 0 };
+        u64 max_wait_time_ns { 0 };
+        u64 max_hold_time_ns { 0 };
+        // The call sites that most often had to wait for a lock of this class, and how often the others had to.
+        Array<CallSite, max_call_sites_per_class> top_waiters;
+        u64 other_waiters_contended_count { 0 };
+    };
+
+    [[nodiscard]] static ALWAYS_INLINE bool is_enabled() { return s_enabled.load(AK::MemoryOrder::memory_order_relaxed); }
+    static void set_enabled(bool);
+
+    // The current time in nanoseconds for measuring how long a lock was waited for or held, or 0 if we can't tell yet.
+    [[nodiscard]] static u64 timestamp();
+    // Same as timestamp(), but returns 0 if statistics are disabled.
+    [[nodiscard]] static u64 timestamp_if_enabled();
+    [[nodiscard]] static u64 nanoseconds_since(u64 timestamp);
+
+    static void record_mutex_acquire(StringView name);
+    static void record_mutex_contention(StringView name, FlatPtr call_site, u64 wait_time_ns);
+    static void record_mutex_release(StringView name, u64 acquired_at);
+    static void record_spinlock_contention(void const* lock, LockRank, FlatPtr call_site, u64 wait_time_ns);
+
+    // The number of lock classes that couldn't be tracked because there were too many of them.
+    [[nodiscard]] static u64 untracked_class_count();
+    static void for_each_lock_class(Function<void(LockClass const&)>);
+
+private:
+    static Atomic<bool> s_enabled;
+};
+
+}
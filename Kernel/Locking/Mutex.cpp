@@ -8,8 +8,10 @@
 #include <Kernel/Debug.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Locking/LockLocation.h>
+#include <Kernel/Locking/LockStatistics.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/Spinlock.h>
+#include <Kernel/PerformanceManager.h>
 #include <Kernel/Thread.h>
 
 extern bool g_in_early_boot;
@@ -28,6 +30,9 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     }
     VERIFY(mode != Mode::Unlocked);
     auto* current_thread = Thread::current();
+    auto call_site = FlatPtr(__builtin_return_address(0));
+    if (LockStatistics::is_enabled())
+        LockStatistics::record_mutex_acquire(m_name);
 
     SpinlockLocker lock(m_lock);
     bool did_block = false;
@@ -40,6 +45,7 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
         VERIFY(m_shared_holders == 0);
         if (mode == Mode::Exclusive) {
             m_holder = current_thread;
+            m_acquired_at = LockStatistics::timestamp_if_enabled();
         } else {
             VERIFY(mode == Mode::Shared);
             ++m_shared_holders;
@@ -60,7 +66,7 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     case Mode::Exclusive: {
         VERIFY(m_holder);
         if (m_holder != current_thread) {
-            block(*current_thread, mode, lock, 1);
+            block(*current_thread, mode, lock, 1, call_site);
             did_block = true;
             // If we blocked then m_mode should have been updated to what we requested
             VERIFY(m_mode == mode);
@@ -106,7 +112,7 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
             // and is asking to upgrade the lock to be exclusive without first releasing the shared lock. We have no
             // allocation-free way to detect such a scenario, so if you suspect that this is the cause of your deadlock,
             // try turning on LOCK_SHARED_UPGRADE_DEBUG.
-            block(*current_thread, mode, lock, 1);
+            block(*current_thread, mode, lock, 1, call_site);
             did_block = true;
             VERIFY(m_mode == mode);
         }
@@ -177,8 +183,10 @@ void Mutex::unlock()
     case Mode::Exclusive:
         VERIFY(m_holder == current_thread);
         VERIFY(m_shared_holders == 0);
-        if (m_times_locked == 0)
+        if (m_times_locked == 0) {
             m_holder = nullptr;
+            LockStatistics::record_mutex_release(m_name, exchange(m_acquired_at, 0));
+        }
         break;
     case Mode::Shared: {
         VERIFY(!m_holder);
@@ -211,7 +219,7 @@ void Mutex::unlock()
     }
 }
 
-void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock>& lock, u32 requested_locks)
+void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock>& lock, u32 requested_locks, FlatPtr call_site)
 {
     if constexpr (LOCK_IN_CRITICAL_DEBUG) {
         // There are no interrupts enabled in early boot.
@@ -230,10 +238,23 @@ void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock>& l
             append_to_list(lists.list_for_mode(mode));
     });
 
+    bool const should_measure_wait = LockStatistics::is_enabled() || PerformanceManager::wants_lock_wait_events();
+    auto wait_started_at = should_measure_wait ? LockStatistics::timestamp() : 0;
+
     dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}) waiting...", this, m_name);
     current_thread.block(*this, lock, requested_locks);
     dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}) waited", this, m_name);
 
+    if (wait_started_at != 0) {
+        auto wait_time_ns = LockStatistics::nanoseconds_since(wait_started_at);
+        if (LockStatistics::is_enabled()) {
+            LockStatistics::record_mutex_contention(m_name, call_site, wait_time_ns);
+            if (m_mode == Mode::Exclusive)
+                m_acquired_at = LockStatistics::timestamp();
+        }
+        PerformanceManager::add_lock_wait_event(current_thread, *this, wait_time_ns);
+    }
+
     m_blocked_thread_lists.with([&](auto& lists) {
         auto remove_from_list = [&]<typename L>(L& list) {
             VERIFY(list.contains(current_thread));
@@ -341,7 +362,7 @@ void Mutex::restore_exclusive_lock(u32 lock_count, [[maybe_unused]] LockLocation
     SpinlockLocker lock(m_lock);
     [[maybe_unused]] auto previous_mode = m_mode;
     if (m_mode == Mode::Exclusive && m_holder != current_thread) {
-        block(*current_thread, Mode::Exclusive, lock, lock_count);
+        block(*current_thread, Mode::Exclusive, lock, lock_count, FlatPtr(__builtin_return_address(0)));
         did_block = true;
         // If we blocked then m_mode should have been updated to what we requested
         VERIFY(m_mode == Mode::Exclusive);
@@ -82,7 +82,7 @@ private:
     // FIXME: remove this after annihilating Process::m_big_lock
     using BigLockBlockedThreadList = IntrusiveList<&Thread::m_big_lock_blocked_threads_list_node>;
 
-    void block(Thread&, Mode, SpinlockLocker<Spinlock>&, u32);
+    void block(Thread&, Mode, SpinlockLocker<Spinlock>&, u32, FlatPtr call_site);
     void unblock_waiters(Mode);
 
     StringView m_name;
@@ -103,6 +103,9 @@ private:
     LockRefPtr<Thread> m_holder;
     size_t m_shared_holders { 0 };
 
+    // When the lock was acquired exclusively, for lock statistics. 0 if we didn't look at the clock.
+    u64 m_acquired_at { 0 };
+
     struct BlockedThreadLists {
         BlockedThreadList exclusive;
         BlockedThreadList shared;
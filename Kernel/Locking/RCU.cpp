@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <Kernel/Locking/RCU.h>
+#include <Kernel/Thread.h>
+
+namespace Kernel {
+
+// NOTE: Processors are tracked in masks of 32 bits elsewhere as well (e.g. thread affinity and the idle mask).
+static constexpr size_t max_processors = 32;
+
+// How often each processor went through a quiescent state.
+static Array<Atomic<u64>, max_processors> s_quiescent_state_counts;
+
+void RCU::note_quiescent_state()
+{
+    auto processor_id = Processor::current_id();
+    if (processor_id < max_processors)
+        s_quiescent_state_counts[processor_id].fetch_add(1, AK::MemoryOrder::memory_order_release);
+}
+
+void RCU::synchronize()
+{
+    // We would otherwise wait for ourselves to leave the read-side critical section, forever.
+    VERIFY(!Processor::in_critical());
+
+    auto processor_count = min<size_t>(Processor::count(), max_processors);
+    if (processor_count == 1)
+        return;
+
+    // Make sure that everyone who looks at the data after we're done looking at the processors sees what the
+    // caller published before calling us.
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+
+    Array<u64, max_processors> counts_at_start;
+    for (size_t i = 0; i < processor_count; ++i)
+        counts_at_start[i] = s_quiescent_state_counts[i].load(AK::MemoryOrder::memory_order_acquire);
+
+    for (;;) {
+        bool grace_period_is_over = true;
+        // NOTE: The processor we're running on can't be in a read-side critical section, as we're running instead.
+        auto current_processor_id = Processor::current_id();
+        for (size_t i = 0; i < processor_count; ++i) {
+            if (i == current_processor_id || Processor::is_idle(i))
+                continue;
+            if (s_quiescent_state_counts[i].load(AK::MemoryOrder::memory_order_acquire) != counts_at_start[i])
+                continue;
+            grace_period_is_over = false;
+            break;
+        }
+        if (grace_period_is_over)
+            return;
+        (void)Thread::current()->sleep(Time::from_milliseconds(1));
+    }
+}
+
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Locking/Mutex.h>
+
+namespace Kernel {
+
+// Read-copy-update: Readers look at shared data without taking any lock, so they never wait for each other or for
+// writers. Writers publish an updated copy instead of changing the data in place, and wait for a "grace period"
+// before destroying the old copy. A grace period is over once every processor went through a quiescent state,
+// i.e. did a context switch, ran userspace code or was idle, so none of them can still be looking at the old copy.
+// Read-side critical sections therefore simply keep the current thread from being scheduled away. They must not
+// block, and can't be used from IRQ handlers.
+class RCU {
+public:
+    ALWAYS_INLINE static void read_lock()
+    {
+        VERIFY(!Processor::current_in_irq());
+        Processor::enter_critical();
+    }
+
+    ALWAYS_INLINE static void read_unlock()
+    {
+        Processor::leave_critical();
+    }
+
+    // Waits until every read-side critical section that was in progress when this was called has ended.
+    static void synchronize();
+
+    // Called by the scheduler whenever the current processor can't be in a read-side critical section.
+    static void note_quiescent_state();
+
+    class ReadLocker {
+        AK_MAKE_NONCOPYABLE(ReadLocker);
+        AK_MAKE_NONMOVABLE(ReadLocker);
+
+    public:
+        ReadLocker() { read_lock(); }
+        ~ReadLocker() { read_unlock(); }
+    };
+};
+
+// A value that readers look at using RCU, and that writers replace with an updated copy.
+template<typename T>
+class RCUProtected {
+    AK_MAKE_NONCOPYABLE(RCUProtected);
+    AK_MAKE_NONMOVABLE(RCUProtected);
+
+public:
+    RCUProtected()
+        : m_value(new T)
+    {
+    }
+
+    ~RCUProtected()
+    {
+        delete m_value.load(AK::MemoryOrder::memory_order_relaxed);
+    }
+
+    template<typename Callback>
+    decltype(auto) with_read(Callback callback) const
+    {
+        RCU::ReadLocker locker;
+        return callback(*m_value.load(AK::MemoryOrder::memory_order_consume));
+    }
+
+    // The callback gets the current value and returns the value that replaces it. Updates are serialized, and
+    // wait for a grace period before the previous value is destroyed, so this may block.
+    template<typename Callback>
+    ErrorOr<void> update(Callback callback)
+    {
+        MutexLocker locker(m_update_lock);
+        auto* old_value = m_value.load(AK::MemoryOrder::memory_order_relaxed);
+        NonnullOwnPtr<T> new_value = TRY(callback(static_cast<T const&>(*old_value)));
+        m_value.store(new_value.leak_ptr(), AK::MemoryOrder::memory_order_release);
+        RCU::synchronize();
+        delete old_value;
+        return {};
+    }
+
+private:
+    Atomic<T*> m_value;
+    Mutex m_update_lock { "RCUProtected"sv };
+};
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+template<typename T>
+class RWSpinlockProtected {
+    AK_MAKE_NONCOPYABLE(RWSpinlockProtected);
+    AK_MAKE_NONMOVABLE(RWSpinlockProtected);
+
+private:
+    class SharedLocker {
+        AK_MAKE_NONCOPYABLE(SharedLocker);
+        AK_MAKE_NONMOVABLE(SharedLocker);
+
+    public:
+        explicit SharedLocker(RWSpinlock& spinlock)
+            : m_spinlock(spinlock)
+            , m_previous_interrupts_state(spinlock.lock_read())
+        {
+        }
+        ~SharedLocker() { m_spinlock.unlock_read(m_previous_interrupts_state); }
+
+    private:
+        RWSpinlock& m_spinlock;
+        InterruptsState m_previous_interrupts_state;
+    };
+
+    class ExclusiveLocker {
+        AK_MAKE_NONCOPYABLE(ExclusiveLocker);
+        AK_MAKE_NONMOVABLE(ExclusiveLocker);
+
+    public:
+        explicit ExclusiveLocker(RWSpinlock& spinlock)
+            : m_spinlock(spinlock)
+            , m_previous_interrupts_state(spinlock.lock_write())
+        {
+        }
+        ~ExclusiveLocker() { m_spinlock.unlock_write(m_previous_interrupts_state); }
+
+    private:
+        RWSpinlock& m_spinlock;
+        InterruptsState m_previous_interrupts_state;
+    };
+
+public:
+    template<typename... Args>
+    RWSpinlockProtected(LockRank rank, Args&&... args)
+        : m_value(forward<Args>(args)...)
+        , m_spinlock(rank)
+    {
+    }
+
+    template<typename Callback>
+    decltype(auto) with_shared(Callback callback) const
+    {
+        SharedLocker locker(m_spinlock);
+        return callback(const_cast<T const&>(m_value));
+    }
+
+    template<typename Callback>
+    decltype(auto) with_exclusive(Callback callback)
+    {
+        ExclusiveLocker locker(m_spinlock);
+        return callback(m_value);
+    }
+
+    template<typename Callback>
+    void for_each_shared(Callback callback) const
+    {
+        with_shared([&](auto const& value) {
+            for (auto& item : value)
+                callback(item);
+        });
+    }
+
+private:
+    T m_value;
+    RWSpinlock mutable m_spinlock;
+};
+
+}
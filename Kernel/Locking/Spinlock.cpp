@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Locking/LockStatistics.h>
 #include <Kernel/Locking/Spinlock.h>
 
 namespace Kernel {
@@ -13,8 +14,14 @@ InterruptsState Spinlock::lock()
     InterruptsState previous_interrupts_state = processor_interrupts_state();
     Processor::enter_critical();
     Processor::disable_interrupts();
-    while (m_lock.exchange(1, AK::memory_order_acquire) != 0)
-        Processor::wait_check();
+    if (m_lock.exchange(1, AK::memory_order_acquire) != 0) {
+        auto wait_started_at = LockStatistics::timestamp_if_enabled();
+        do {
+            Processor::wait_check();
+        } while (m_lock.exchange(1, AK::memory_order_acquire) != 0);
+        if (wait_started_at != 0)
+            LockStatistics::record_spinlock_contention(this, m_rank, FlatPtr(__builtin_return_address(0)), LockStatistics::nanoseconds_since(wait_started_at));
+    }
     track_lock_acquire(m_rank);
     return previous_interrupts_state;
 }
@@ -37,12 +44,17 @@ InterruptsState RecursiveSpinlock::lock()
     auto& proc = Processor::current();
     FlatPtr cpu = FlatPtr(&proc);
     FlatPtr expected = 0;
+    u64 wait_started_at = 0;
     while (!m_lock.compare_exchange_strong(expected, cpu, AK::memory_order_acq_rel)) {
         if (expected == cpu)
             break;
+        if (wait_started_at == 0)
+            wait_started_at = LockStatistics::timestamp_if_enabled();
         Processor::wait_check();
         expected = 0;
     }
+    if (wait_started_at != 0)
+        LockStatistics::record_spinlock_contention(this, m_rank, FlatPtr(__builtin_return_address(0)), LockStatistics::nanoseconds_since(wait_started_at));
     if (m_recursions == 0)
         track_lock_acquire(m_rank);
     m_recursions++;
@@ -63,4 +75,78 @@ void RecursiveSpinlock::unlock(InterruptsState previous_interrupts_state)
     restore_processor_interrupts_state(previous_interrupts_state);
 }
 
+InterruptsState RWSpinlock::lock_read()
+{
+    InterruptsState previous_interrupts_state = processor_interrupts_state();
+    Processor::enter_critical();
+    Processor::disable_interrupts();
+    u64 wait_started_at = 0;
+    auto state = m_state.load(AK::memory_order_relaxed);
+    for (;;) {
+        if ((state & (writer_bit | writer_waiting_bit)) == 0) {
+            VERIFY((state & reader_count_mask) != reader_count_mask);
+            if (m_state.compare_exchange_strong(state, state + 1, AK::memory_order_acquire))
+                break;
+            continue;
+        }
+        if (wait_started_at == 0)
+            wait_started_at = LockStatistics::timestamp_if_enabled();
+        Processor::wait_check();
+        state = m_state.load(AK::memory_order_relaxed);
+    }
+    if (wait_started_at != 0)
+        LockStatistics::record_spinlock_contention(this, m_rank, FlatPtr(__builtin_return_address(0)), LockStatistics::nanoseconds_since(wait_started_at));
+    track_lock_acquire(m_rank);
+    return previous_interrupts_state;
+}
+
+void RWSpinlock::unlock_read(InterruptsState previous_interrupts_state)
+{
+    VERIFY((m_state.load(AK::memory_order_relaxed) & reader_count_mask) != 0);
+    track_lock_release(m_rank);
+    m_state.fetch_sub(1, AK::memory_order_release);
+
+    Processor::leave_critical();
+    restore_processor_interrupts_state(previous_interrupts_state);
+}
+
+InterruptsState RWSpinlock::lock_write()
+{
+    InterruptsState previous_interrupts_state = processor_interrupts_state();
+    Processor::enter_critical();
+    Processor::disable_interrupts();
+    u64 wait_started_at = 0;
+    auto state = m_state.load(AK::memory_order_relaxed);
+    for (;;) {
+        if ((state & (writer_bit | reader_count_mask)) == 0) {
+            // NOTE: This also clears the waiting bit. Any other waiting writer sets it again on its next attempt.
+            if (m_state.compare_exchange_strong(state, writer_bit, AK::memory_order_acquire))
+                break;
+            continue;
+        }
+        if ((state & writer_waiting_bit) == 0) {
+            if (!m_state.compare_exchange_strong(state, state | writer_waiting_bit, AK::memory_order_relaxed))
+                continue;
+        }
+        if (wait_started_at == 0)
+            wait_started_at = LockStatistics::timestamp_if_enabled();
+        Processor::wait_check();
+        state = m_state.load(AK::memory_order_relaxed);
+    }
+    if (wait_started_at != 0)
+        LockStatistics::record_spinlock_contention(this, m_rank, FlatPtr(__builtin_return_address(0)), LockStatistics::nanoseconds_since(wait_started_at));
+    track_lock_acquire(m_rank);
+    return previous_interrupts_state;
+}
+
+void RWSpinlock::unlock_write(InterruptsState previous_interrupts_state)
+{
+    VERIFY(is_locked_for_writing());
+    track_lock_release(m_rank);
+    m_state.fetch_and(~writer_bit, AK::memory_order_release);
+
+    Processor::leave_critical();
+    restore_processor_interrupts_state(previous_interrupts_state);
+}
+
 }
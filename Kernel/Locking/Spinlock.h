@@ -75,6 +75,44 @@ private:
     const LockRank m_rank;
 };
 
+// A spinlock that can be held by any number of readers at once, or by a single writer.
+// Waiting writers keep new readers from taking the lock, so that a steady stream of readers can't starve them.
+// NOTE: Unlike RecursiveSpinlock, neither side may be taken recursively.
+class RWSpinlock {
+    AK_MAKE_NONCOPYABLE(RWSpinlock);
+    AK_MAKE_NONMOVABLE(RWSpinlock);
+
+public:
+    RWSpinlock(LockRank rank)
+        : m_rank(rank)
+    {
+    }
+
+    InterruptsState lock_read();
+    void unlock_read(InterruptsState);
+
+    InterruptsState lock_write();
+    void unlock_write(InterruptsState);
+
+    [[nodiscard]] ALWAYS_INLINE bool is_locked() const
+    {
+        return (m_state.load(AK::memory_order_relaxed) & ~writer_waiting_bit) != 0;
+    }
+
+    [[nodiscard]] ALWAYS_INLINE bool is_locked_for_writing() const
+    {
+        return (m_state.load(AK::memory_order_relaxed) & writer_bit) != 0;
+    }
+
+private:
+    static constexpr u32 writer_bit = 1u << 31;
+    static constexpr u32 writer_waiting_bit = 1u << 30;
+    static constexpr u32 reader_count_mask = writer_waiting_bit - 1;
+
+    Atomic<u32> m_state { 0 };
+    const LockRank m_rank;
+};
+
 template<typename LockType>
 class [[nodiscard]] SpinlockLocker {
     AK_MAKE_NONCOPYABLE(SpinlockLocker);
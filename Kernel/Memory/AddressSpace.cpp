@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <Kernel/API/MemoryLayout.h>
 #include <Kernel/Arch/CPU.h>
 #include <Kernel/Locking/Spinlock.h>
@@ -73,7 +74,13 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         // Remove the old region from our regions tree, since were going to add another region
         // with the exact same start address.
         auto region = take_region(*old_region);
-        region->unmap();
+        region->unmap(ShouldFlushTLB::No);
+
+        // The old region's pages must stay alive until every processor has dropped its translations,
+        // so this runs before `region` goes away. Flushing once at the end also covers the remapping below.
+        ScopeGuard flush_tlb_guard = [&] {
+            MemoryManager::flush_tlb(m_page_directory.ptr(), region->vaddr(), region->page_count());
+        };
 
         auto new_regions = TRY(try_split_region_around_range(*region, range_to_unmap));
 
@@ -81,7 +88,7 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         for (auto* new_region : new_regions) {
             // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
             // leaves the caller in an undefined state.
-            TRY(new_region->map(page_directory()));
+            TRY(new_region->map(page_directory(), ShouldFlushTLB::No));
         }
 
         PerformanceManager::add_unmap_perf_event(Process::current(), range_to_unmap);
@@ -103,20 +110,32 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
 
     Vector<Region*, 2> new_regions;
 
+    // Rather than sending a TLB shootdown for every region, we unmap all of them first and
+    // flush everything in one go. The old regions (and thus their pages) have to stay alive
+    // until then, so the guard is declared after (and runs before destroying) `old_regions`.
+    Vector<NonnullOwnPtr<Region>, 2> old_regions;
+    Vector<TLBFlushRange, ProcessorMessage::max_tlb_flush_ranges> ranges_to_flush;
+    TRY(old_regions.try_ensure_capacity(regions.size()));
+    TRY(ranges_to_flush.try_ensure_capacity(regions.size()));
+    ScopeGuard flush_tlb_guard = [&] {
+        MemoryManager::flush_tlb(m_page_directory.ptr(), ranges_to_flush.span());
+    };
+
     for (auto* old_region : regions) {
-        // If it's a full match we can remove the entire old region.
-        if (old_region->range().intersect(range_to_unmap).size() == old_region->size()) {
-            deallocate_region(*old_region);
-            continue;
-        }
+        ranges_to_flush.unchecked_append({ old_region->vaddr(), old_region->page_count() });
 
-        // Remove the old region from our regions tree, since were going to add another region
-        // with the exact same start address.
-        auto region = take_region(*old_region);
-        region->unmap();
+        // Remove the old region from our regions tree. If it's only partially covered, we're going
+        // to add another region with the exact same start address.
+        old_regions.unchecked_append(take_region(*old_region));
+        auto& region = *old_regions.last();
+        region.unmap(ShouldFlushTLB::No);
+
+        // If it's a full match we're done with the entire old region.
+        if (region.range().intersect(range_to_unmap).size() == region.size())
+            continue;
 
         // Otherwise, split the regions and collect them for future mapping.
-        auto split_regions = TRY(try_split_region_around_range(*region, range_to_unmap));
+        auto split_regions = TRY(try_split_region_around_range(region, range_to_unmap));
         TRY(new_regions.try_extend(split_regions));
     }
 
@@ -124,7 +143,7 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
     for (auto* new_region : new_regions) {
         // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
         // leaves the caller in an undefined state.
-        TRY(new_region->map(page_directory()));
+        TRY(new_region->map(page_directory(), ShouldFlushTLB::No));
     }
 
     PerformanceManager::add_unmap_perf_event(Process::current(), range_to_unmap);
@@ -143,6 +162,7 @@ ErrorOr<Region*> AddressSpace::try_allocate_split_region(Region const& source_re
     new_region->set_syscall_region(source_region.is_syscall_region());
     new_region->set_mmap(source_region.is_mmap(), source_region.mmapped_from_readable(), source_region.mmapped_from_writable());
     new_region->set_stack(source_region.is_stack());
+    new_region->set_wants_huge_pages(source_region.wants_huge_pages());
     size_t page_offset_in_source_region = (offset_in_vmobject - source_region.offset_in_vmobject()) / PAGE_SIZE;
     for (size_t i = 0; i < new_region->page_count(); ++i) {
         if (source_region.should_cow(page_offset_in_source_region + i))
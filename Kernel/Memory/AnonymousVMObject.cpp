@@ -34,7 +34,8 @@ ErrorOr<NonnullLockRefPtr<VMObject>> AnonymousVMObject::try_clone()
     // non-volatile memory available.
     size_t new_cow_pages_needed = 0;
     for (auto const& page : m_physical_pages) {
-        if (!page->is_shared_zero_page())
+        // NOTE: Compressed pages are counted too, since the clone would lose them otherwise.
+        if (!page || !page->is_shared_zero_page())
             ++new_cow_pages_needed;
     }
 
@@ -55,6 +56,16 @@ ErrorOr<NonnullLockRefPtr<VMObject>> AnonymousVMObject::try_clone()
     auto new_physical_pages = TRY(this->try_clone_physical_pages());
     auto clone = TRY(try_create_with_shared_cow(*this, *new_shared_committed_cow_pages, move(new_physical_pages)));
 
+    // The clone gets its own copy of everything we've compressed.
+    if (!m_compressed_pages.is_empty()) {
+        auto compressed_pages = TRY(FixedArray<OwnPtr<CompressedPage>>::try_create(page_count()));
+        for (size_t i = 0; i < page_count(); ++i) {
+            if (m_compressed_pages[i])
+                compressed_pages[i] = TRY(m_compressed_pages[i]->try_clone());
+        }
+        clone->m_compressed_pages.swap(compressed_pages);
+    }
+
     // Both original and clone become COW. So create a COW map for ourselves
     // or reset all pages to be copied again if we were previously cloned
     TRY(ensure_or_reset_cow_map());
@@ -143,6 +154,7 @@ ErrorOr<NonnullLockRefPtr<AnonymousVMObject>> AnonymousVMObject::try_create_with
 AnonymousVMObject::AnonymousVMObject(FixedArray<RefPtr<PhysicalPage>>&& new_physical_pages, AllocationStrategy strategy, Optional<CommittedPhysicalPageSet> committed_pages)
     : VMObject(move(new_physical_pages))
     , m_unused_committed_pages(move(committed_pages))
+    , m_compressible(true)
 {
     if (strategy == AllocationStrategy::AllocateNow) {
         // Allocate all pages right now. We know we can get all because we committed the amount needed
@@ -173,6 +185,7 @@ AnonymousVMObject::AnonymousVMObject(LockWeakPtr<AnonymousVMObject> other, Nonnu
     , m_cow_parent(move(other))
     , m_shared_committed_cow_pages(move(shared_committed_cow_pages))
     , m_purgeable(m_cow_parent.strong_ref()->m_purgeable)
+    , m_compressible(m_cow_parent.strong_ref()->m_compressible)
 {
 }
 
@@ -197,8 +210,14 @@ size_t AnonymousVMObject::purge()
 
     size_t total_pages_purged = 0;
 
-    for (auto& page : m_physical_pages) {
-        VERIFY(page);
+    for (size_t i = 0; i < page_count(); ++i) {
+        auto& page = m_physical_pages[i];
+        if (!page) {
+            // A compressed page doesn't hold on to any physical memory, but it has to go all the same.
+            m_compressed_pages[i] = nullptr;
+            page = MM.shared_zero_page();
+            continue;
+        }
         if (page->is_shared_zero_page())
             continue;
         page = MM.shared_zero_page();
@@ -214,6 +233,38 @@ size_t AnonymousVMObject::purge()
     return total_pages_purged;
 }
 
+size_t AnonymousVMObject::release_pages(size_t first_page_index, size_t page_count)
+{
+    VERIFY(first_page_index + page_count <= this->page_count());
+
+    size_t total_pages_released = 0;
+    {
+        SpinlockLocker lock(m_lock);
+        for (size_t i = first_page_index; i < first_page_index + page_count; ++i) {
+            auto& page = m_physical_pages[i];
+            if (!page) {
+                m_compressed_pages[i] = nullptr;
+                page = MM.shared_zero_page();
+                continue;
+            }
+            // NOTE: We leave lazily committed pages alone, since there's nothing backing them yet.
+            if (page->is_shared_zero_page() || page->is_lazy_committed_page())
+                continue;
+            page = MM.shared_zero_page();
+            ++total_pages_released;
+        }
+    }
+
+    for_each_region([&](Region& region) {
+        auto region_first = max(first_page_index, region.first_page_index());
+        auto region_end = min(first_page_index + page_count, region.first_page_index() + region.page_count());
+        if (region_first < region_end && region.is_mapped())
+            (void)region.remap_vmobject_page_range(region_first, region_end - region_first);
+    });
+
+    return total_pages_released;
+}
+
 ErrorOr<void> AnonymousVMObject::set_volatile(bool is_volatile, bool& was_purged)
 {
     VERIFY(is_purgeable());
@@ -248,8 +299,7 @@ ErrorOr<void> AnonymousVMObject::set_volatile(bool is_volatile, bool& was_purged
     // If that fails, we return false to indicate that memory allocation failed.
     size_t committed_pages_needed = 0;
     for (auto& page : m_physical_pages) {
-        VERIFY(page);
-        if (page->is_shared_zero_page())
+        if (page && page->is_shared_zero_page())
             ++committed_pages_needed;
     }
 
@@ -261,7 +311,7 @@ ErrorOr<void> AnonymousVMObject::set_volatile(bool is_volatile, bool& was_purged
     m_unused_committed_pages = TRY(MM.commit_physical_pages(committed_pages_needed));
 
     for (auto& page : m_physical_pages) {
-        if (page->is_shared_zero_page())
+        if (page && page->is_shared_zero_page())
             page = MM.lazy_committed_page();
     }
 
@@ -276,6 +326,36 @@ NonnullRefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(Badge<Reg
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::try_install_huge_page(Badge<Region>, size_t first_page_index, NonnullRefPtrVector<PhysicalPage> const& pages)
+{
+    SpinlockLocker locker(m_lock);
+
+    // Purging works on individual pages, which would break the huge page up anyway.
+    if (m_purgeable)
+        return false;
+    if (first_page_index + pages.size() > page_count())
+        return false;
+
+    size_t lazy_committed_page_count = 0;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto& page = m_physical_pages[first_page_index + i];
+        if (!page)
+            return false;
+        if (page->is_lazy_committed_page())
+            ++lazy_committed_page_count;
+        else if (!page->is_shared_zero_page())
+            return false;
+    }
+
+    for (size_t i = 0; i < pages.size(); ++i)
+        m_physical_pages[first_page_index + i] = pages[i];
+
+    // The huge page didn't come out of our committed pages, so give back what these slots had reserved.
+    for (size_t i = 0; i < lazy_committed_page_count; ++i)
+        m_unused_committed_pages->uncommit_one();
+    return true;
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
@@ -381,6 +461,168 @@ PageFaultResponse AnonymousVMObject::handle_cow_fault(size_t page_index, Virtual
     return PageFaultResponse::Continue;
 }
 
+bool AnonymousVMObject::can_compress_pages()
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+
+    // Volatile memory is better off getting purged.
+    if (!m_compressible || is_volatile())
+        return false;
+
+    // Only pages that userspace is going to fault back in can be evicted. The kernel expects
+    // its own memory to stay put, and a huge page would have to be split up first.
+    bool has_regions = false;
+    bool all_regions_allow_compression = true;
+    for_each_region([&](Region& region) {
+        has_regions = true;
+        if (!region.is_user() || region.wants_huge_pages())
+            all_regions_allow_compression = false;
+    });
+    return has_regions && all_regions_allow_compression;
+}
+
+bool AnonymousVMObject::try_compress_page(size_t page_index, CompressedPageStore::Workspace& workspace)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+
+    // Shared pages would have to be compressed in every VMObject that has them, so leave them alone.
+    auto& page = m_physical_pages[page_index];
+    if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page() || page->ref_count() != 1)
+        return false;
+    if (!m_cow_map.is_null() && m_cow_map.get(page_index))
+        return false;
+
+    // Give pages that were used since we last came by another chance.
+    bool was_accessed = false;
+    for_each_region([&](Region& region) {
+        if (region.test_and_clear_accessed(page_index))
+            was_accessed = true;
+    });
+    if (was_accessed)
+        return false;
+
+    // Unmap the page first, so it can't change under us while we compress it.
+    for_each_region([&](Region& region) {
+        region.unmap_vmobject_page(page_index);
+    });
+
+    size_t compressed_size = 0;
+    {
+        u8* page_data = MM.quickmap_page(*page);
+        compressed_size = CompressedPageStore::compress(workspace, { page_data, PAGE_SIZE });
+        MM.unquickmap_page();
+    }
+
+    OwnPtr<CompressedPage> compressed_page;
+    if (compressed_size != 0) {
+        auto compressed_page_or_error = CompressedPage::try_create({ workspace.output, compressed_size });
+        if (!compressed_page_or_error.is_error())
+            compressed_page = compressed_page_or_error.release_value();
+    } else {
+        CompressedPageStore::did_reject_page();
+    }
+
+    if (!compressed_page) {
+        for_each_region([&](Region& region) {
+            if (region.is_mapped())
+                (void)region.remap_vmobject_page(page_index, *page);
+        });
+        return false;
+    }
+
+    dbgln_if(PAGE_FAULT_DEBUG, "Compressed page {} of {:p} ({}) to {} bytes", page_index, this, page->paddr(), compressed_size);
+    m_compressed_pages[page_index] = move(compressed_page);
+    page = nullptr;
+    return true;
+}
+
+size_t AnonymousVMObject::compress_cold_pages(Badge<CompressedPageStore>, CompressedPageStore::Workspace& workspace, size_t max_page_count)
+{
+    {
+        SpinlockLocker locker(m_lock);
+        if (!can_compress_pages())
+            return 0;
+    }
+
+    if (m_compressed_pages.is_empty()) {
+        auto compressed_pages_or_error = FixedArray<OwnPtr<CompressedPage>>::try_create(page_count());
+        if (compressed_pages_or_error.is_error())
+            return 0;
+        auto compressed_pages = compressed_pages_or_error.release_value();
+        SpinlockLocker locker(m_lock);
+        if (m_compressed_pages.is_empty())
+            m_compressed_pages.swap(compressed_pages);
+    }
+
+    // Don't scan through huge VMObjects in one go, so others get their turn too.
+    auto pages_to_scan = min(page_count(), max_page_count * 4);
+
+    size_t compressed_page_count = 0;
+    for (size_t i = 0; i < pages_to_scan && compressed_page_count < max_page_count; ++i) {
+        // NOTE: We take the lock for each page, since compressing one takes a while.
+        SpinlockLocker locker(m_lock);
+        if (!can_compress_pages())
+            break;
+        auto page_index = m_compression_cursor;
+        m_compression_cursor = (m_compression_cursor + 1) % page_count();
+        if (try_compress_page(page_index, workspace))
+            ++compressed_page_count;
+    }
+    return compressed_page_count;
+}
+
+bool AnonymousVMObject::is_page_compressed(size_t page_index) const
+{
+    SpinlockLocker locker(m_lock);
+    return !m_compressed_pages.is_empty() && m_compressed_pages[page_index];
+}
+
+PageFaultResponse AnonymousVMObject::handle_compressed_page_fault(Region& region, size_t page_index)
+{
+    auto new_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+    if (new_page_or_error.is_error()) {
+        dmesgln("MM: handle_compressed_page_fault was unable to allocate a physical page");
+        return PageFaultResponse::OutOfMemory;
+    }
+    auto new_page = new_page_or_error.release_value();
+
+    SpinlockLocker locker(m_lock);
+    auto& page_slot = m_physical_pages[page_index];
+
+    // If someone else already brought the page back, we just map theirs.
+    if (!page_slot) {
+        if (m_compressed_pages.is_empty() || !m_compressed_pages[page_index]) {
+            dbgln("BUG! Page {} of {:p} is neither resident nor compressed", page_index, this);
+            return PageFaultResponse::ShouldCrash;
+        }
+        auto compressed_page = m_compressed_pages[page_index].release_nonnull();
+
+        bool success = false;
+        {
+            u8* page_data = MM.quickmap_page(*new_page);
+            success = compressed_page->decompress_into({ page_data, PAGE_SIZE });
+            MM.unquickmap_page();
+        }
+        // We produced this data ourselves, so it can only be corrupt if kernel memory is.
+        VERIFY(success);
+
+        dbgln_if(PAGE_FAULT_DEBUG, "      >> DECOMPRESSED page {} of {:p} into {}", page_index, this, new_page->paddr());
+        page_slot = move(new_page);
+        CompressedPageStore::did_decompress_page();
+    }
+
+    if (!region.remap_vmobject_page(page_index, *page_slot))
+        return PageFaultResponse::OutOfMemory;
+    return PageFaultResponse::Continue;
+}
+
+void AnonymousVMObject::drop_compressed_page(Badge<Region>, size_t page_index)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    if (!m_compressed_pages.is_empty())
+        m_compressed_pages[page_index] = nullptr;
+}
+
 AnonymousVMObject::SharedCommittedCowPages::SharedCommittedCowPages(CommittedPhysicalPageSet&& committed_pages)
     : m_committed_pages(move(committed_pages))
 {
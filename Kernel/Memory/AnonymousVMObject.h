@@ -7,6 +7,7 @@
 #pragma once
 
 #include <Kernel/Memory/AllocationStrategy.h>
+#include <Kernel/Memory/CompressedPageStore.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/PageFaultResponse.h>
 #include <Kernel/Memory/VMObject.h>
@@ -26,6 +27,9 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalPage> allocate_committed_page(Badge<Region>);
+    // Puts a huge page worth of physical pages into the slots starting at first_page_index,
+    // if none of them have been faulted in yet. Returns false and changes nothing otherwise.
+    bool try_install_huge_page(Badge<Region>, size_t first_page_index, NonnullRefPtrVector<PhysicalPage> const&);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
@@ -38,6 +42,15 @@ public:
 
     size_t purge();
 
+    // Frees the physical pages backing the given range right away. The range reads back as zeroes afterwards.
+    size_t release_pages(size_t first_page_index, size_t page_count);
+
+    // Pages evicted to the compressed page store leave an empty slot behind, and are brought back on the next fault.
+    size_t compress_cold_pages(Badge<CompressedPageStore>, CompressedPageStore::Workspace&, size_t max_page_count);
+    bool is_page_compressed(size_t page_index) const;
+    PageFaultResponse handle_compressed_page_fault(Region&, size_t page_index);
+    void drop_compressed_page(Badge<Region>, size_t page_index);
+
 private:
     class SharedCommittedCowPages;
 
@@ -59,9 +72,16 @@ private:
     ErrorOr<void> ensure_cow_map();
     ErrorOr<void> ensure_or_reset_cow_map();
 
+    bool can_compress_pages();
+    bool try_compress_page(size_t page_index, CompressedPageStore::Workspace&);
+
     Optional<CommittedPhysicalPageSet> m_unused_committed_pages;
     Bitmap m_cow_map;
 
+    // Allocated the first time a page of this VMObject gets compressed.
+    FixedArray<OwnPtr<CompressedPage>> m_compressed_pages;
+    size_t m_compression_cursor { 0 };
+
     // AnonymousVMObject shares committed COW pages with cloned children (happens on fork)
     class SharedCommittedCowPages final : public AtomicRefCounted<SharedCommittedCowPages> {
         AK_MAKE_NONCOPYABLE(SharedCommittedCowPages);
@@ -88,6 +108,7 @@ private:
     bool m_purgeable { false };
     bool m_volatile { false };
     bool m_was_purged { false };
+    bool m_compressible { false };
 };
 
 }
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/CompressedPageStore.h>
+#include <Kernel/Memory/MemoryManager.h>
+
+namespace Kernel::Memory {
+
+static Atomic<u64> s_stored_pages;
+static Atomic<u64> s_stored_bytes;
+static Atomic<u64> s_pages_compressed;
+static Atomic<u64> s_pages_decompressed;
+static Atomic<u64> s_pages_rejected;
+
+// Where the next pass of compress_cold_pages() picks up in the list of VMObjects.
+static size_t s_next_vmobject_index;
+
+// Pages that don't compress to at most this size are left alone.
+static constexpr size_t max_compressed_page_size = PAGE_SIZE * 3 / 4;
+
+// LZ4 block format constraints: a match is at least 4 bytes long, the last match has to
+// start at least 12 bytes before the end, and the last 5 bytes are always literals.
+static constexpr size_t min_match_length = 4;
+static constexpr size_t match_search_limit = 12;
+static constexpr size_t last_literals = 5;
+static constexpr u16 empty_hash_slot = 0xffff;
+static_assert(PAGE_SIZE <= empty_hash_slot);
+
+ErrorOr<NonnullOwnPtr<CompressedPage>> CompressedPage::try_create(ReadonlyBytes compressed_data)
+{
+    auto data = TRY(FixedArray<u8>::try_create(compressed_data));
+    return adopt_nonnull_own_or_enomem(new (nothrow) CompressedPage(move(data)));
+}
+
+CompressedPage::CompressedPage(FixedArray<u8>&& data)
+    : m_data(move(data))
+{
+    s_stored_pages.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    s_stored_bytes.fetch_add(m_data.size(), AK::MemoryOrder::memory_order_relaxed);
+}
+
+CompressedPage::~CompressedPage()
+{
+    s_stored_pages.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+    s_stored_bytes.fetch_sub(m_data.size(), AK::MemoryOrder::memory_order_relaxed);
+}
+
+ErrorOr<NonnullOwnPtr<CompressedPage>> CompressedPage::try_clone() const
+{
+    return try_create(m_data.span());
+}
+
+bool CompressedPage::decompress_into(Bytes page) const
+{
+    return CompressedPageStore::decompress(m_data.span(), page);
+}
+
+static u32 read_u32(u8 const* ptr)
+{
+    u32 value;
+    __builtin_memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static size_t hash_sequence(u32 sequence)
+{
+    return (sequence * 2654435761u) >> (32 - CompressedPageStore::Workspace::hash_table_bits);
+}
+
+static bool write_length(Bytes output, size_t& out, size_t length)
+{
+    while (length >= 255) {
+        if (out >= output.size())
+            return false;
+        output[out++] = 255;
+        length -= 255;
+    }
+    if (out >= output.size())
+        return false;
+    output[out++] = static_cast<u8>(length);
+    return true;
+}
+
+static bool write_sequence(Bytes output, size_t& out, ReadonlyBytes literals, size_t offset, size_t match_length)
+{
+    if (out >= output.size())
+        return false;
+    auto& token = output[out++];
+    token = min(literals.size(), 15u) << 4;
+    if (literals.size() >= 15 && !write_length(output, out, literals.size() - 15))
+        return false;
+    if (out + literals.size() > output.size())
+        return false;
+    literals.copy_to(output.slice(out));
+    out += literals.size();
+
+    // The last sequence consists of nothing but literals.
+    if (match_length == 0)
+        return true;
+
+    if (out + 2 > output.size())
+        return false;
+    output[out++] = offset & 0xff;
+    output[out++] = offset >> 8;
+    match_length -= min_match_length;
+    token |= min(match_length, 15u);
+    if (match_length >= 15 && !write_length(output, out, match_length - 15))
+        return false;
+    return true;
+}
+
+size_t CompressedPageStore::compress(Workspace& workspace, ReadonlyBytes page)
+{
+    VERIFY(page.size() == PAGE_SIZE);
+
+    Bytes output { workspace.output, max_compressed_page_size };
+    __builtin_memset(workspace.hash_table, 0xff, sizeof(workspace.hash_table));
+
+    size_t out = 0;
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position + match_search_limit < page.size()) {
+        auto sequence = read_u32(page.offset_pointer(position));
+        auto& slot = workspace.hash_table[hash_sequence(sequence)];
+        size_t candidate = slot;
+        slot = position;
+
+        if (candidate == empty_hash_slot || read_u32(page.offset_pointer(candidate)) != sequence) {
+            ++position;
+            continue;
+        }
+
+        size_t match_length = min_match_length;
+        while (position + match_length < page.size() - last_literals && page[candidate + match_length] == page[position + match_length])
+            ++match_length;
+
+        if (!write_sequence(output, out, page.slice(anchor, position - anchor), position - candidate, match_length))
+            return 0;
+        position += match_length;
+        anchor = position;
+    }
+
+    if (!write_sequence(output, out, page.slice(anchor), 0, 0))
+        return 0;
+    return out;
+}
+
+bool CompressedPageStore::decompress(ReadonlyBytes input, Bytes page)
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    auto read_length = [&](size_t& length) {
+        u8 byte;
+        do {
+            if (in >= input.size())
+                return false;
+            byte = input[in++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (in < input.size()) {
+        u8 token = input[in++];
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !read_length(literal_length))
+            return false;
+        if (in + literal_length > input.size() || out + literal_length > page.size())
+            return false;
+        input.slice(in, literal_length).copy_to(page.slice(out));
+        in += literal_length;
+        out += literal_length;
+
+        // The last sequence has no match part.
+        if (in == input.size())
+            break;
+
+        if (in + 2 > input.size())
+            return false;
+        size_t offset = input[in] | (input[in + 1] << 8);
+        in += 2;
+        if (offset == 0 || offset > out)
+            return false;
+
+        size_t match_length = token & 0xf;
+        if (match_length == 15 && !read_length(match_length))
+            return false;
+        match_length += min_match_length;
+        if (out + match_length > page.size())
+            return false;
+
+        // NOTE: The match may overlap with the bytes it produces, so this has to go byte by byte.
+        for (size_t i = 0; i < match_length; ++i, ++out)
+            page[out] = page[out - offset];
+    }
+
+    return out == page.size();
+}
+
+size_t CompressedPageStore::compress_cold_pages(Workspace& workspace, size_t max_page_count)
+{
+    // Grab a batch of anonymous VMObjects so we don't have to hold the list lock while compressing.
+    static constexpr size_t vmobjects_per_pass = 64;
+    Vector<NonnullLockRefPtr<AnonymousVMObject>, vmobjects_per_pass> vmobjects;
+
+    size_t index = 0;
+    bool reached_end = true;
+    MM.for_each_vmobject([&](VMObject& vmobject) {
+        if (index++ < s_next_vmobject_index)
+            return IterationDecision::Continue;
+        if (vmobjects.size() == vmobjects_per_pass) {
+            reached_end = false;
+            return IterationDecision::Break;
+        }
+        if (vmobject.is_anonymous())
+            vmobjects.unchecked_append(static_cast<AnonymousVMObject&>(vmobject));
+        return IterationDecision::Continue;
+    });
+    s_next_vmobject_index = reached_end ? 0 : index - 1;
+
+    size_t compressed_page_count = 0;
+    for (auto& vmobject : vmobjects) {
+        if (compressed_page_count >= max_page_count)
+            break;
+        compressed_page_count += vmobject->compress_cold_pages({}, workspace, max_page_count - compressed_page_count);
+    }
+    s_pages_compressed.fetch_add(compressed_page_count, AK::MemoryOrder::memory_order_relaxed);
+    return compressed_page_count;
+}
+
+CompressedPageStore::Statistics CompressedPageStore::statistics()
+{
+    return {
+        .stored_pages = s_stored_pages.load(AK::MemoryOrder::memory_order_relaxed),
+        .stored_bytes = s_stored_bytes.load(AK::MemoryOrder::memory_order_relaxed),
+        .pages_compressed = s_pages_compressed.load(AK::MemoryOrder::memory_order_relaxed),
+        .pages_decompressed = s_pages_decompressed.load(AK::MemoryOrder::memory_order_relaxed),
+        .pages_rejected = s_pages_rejected.load(AK::MemoryOrder::memory_order_relaxed),
+    };
+}
+
+void CompressedPageStore::did_decompress_page()
+{
+    s_pages_decompressed.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+void CompressedPageStore::did_reject_page()
+{
+    s_pages_rejected.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/FixedArray.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+
+namespace Kernel::Memory {
+
+// The contents of an anonymous page that was evicted to the compressed page store.
+// These live in kmalloc memory, and are owned by the AnonymousVMObject slot they came from.
+class CompressedPage {
+    AK_MAKE_NONCOPYABLE(CompressedPage);
+    AK_MAKE_NONMOVABLE(CompressedPage);
+
+public:
+    static ErrorOr<NonnullOwnPtr<CompressedPage>> try_create(ReadonlyBytes compressed_data);
+    ~CompressedPage();
+
+    ErrorOr<NonnullOwnPtr<CompressedPage>> try_clone() const;
+
+    size_t size() const { return m_data.size(); }
+
+    // Returns false if the compressed data is corrupt.
+    [[nodiscard]] bool decompress_into(Bytes page) const;
+
+private:
+    explicit CompressedPage(FixedArray<u8>&&);
+
+    FixedArray<u8> m_data;
+};
+
+class CompressedPageStore {
+public:
+    struct Workspace {
+        static constexpr size_t hash_table_bits = 12;
+        u16 hash_table[1 << hash_table_bits];
+        u8 output[PAGE_SIZE];
+    };
+
+    // Compresses a page with an LZ4-style block compressor into the workspace's output buffer.
+    // Returns the compressed size, or 0 if the page doesn't compress well enough to be worth keeping.
+    static size_t compress(Workspace&, ReadonlyBytes page);
+    static bool decompress(ReadonlyBytes compressed_data, Bytes page);
+
+    // Looks for cold pages in anonymous memory and moves up to the given number of them into the store.
+    static size_t compress_cold_pages(Workspace&, size_t max_page_count);
+
+    struct Statistics {
+        u64 stored_pages { 0 };
+        u64 stored_bytes { 0 };
+        u64 pages_compressed { 0 };
+        u64 pages_decompressed { 0 };
+        u64 pages_rejected { 0 };
+    };
+    static Statistics statistics();
+
+    static void did_decompress_page();
+    static void did_reject_page();
+};
+
+}
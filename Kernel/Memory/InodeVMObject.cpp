@@ -4,11 +4,19 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NonnullRefPtrVector.h>
+#include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/InodeVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/WorkQueue.h>
 
 namespace Kernel::Memory {
 
+// Background read-ahead is done in chunks of at most this many pages.
+static constexpr size_t max_read_ahead_pages = 64;
+
 InodeVMObject::InodeVMObject(Inode& inode, FixedArray<RefPtr<PhysicalPage>>&& new_physical_pages, Bitmap dirty_pages)
     : VMObject(move(new_physical_pages))
     , m_inode(inode)
@@ -86,6 +94,100 @@ int InodeVMObject::try_release_clean_pages(int page_amount)
     return count;
 }
 
+size_t InodeVMObject::release_clean_pages_in_range(size_t first_page_index, size_t page_count)
+{
+    VERIFY(first_page_index + page_count <= this->page_count());
+    SpinlockLocker locker(m_lock);
+
+    size_t count = 0;
+    for (size_t i = first_page_index; i < first_page_index + page_count; ++i) {
+        if (!m_dirty_pages.get(i) && m_physical_pages[i]) {
+            m_physical_pages[i] = nullptr;
+            ++count;
+        }
+    }
+    if (count) {
+        for_each_region([](auto& region) {
+            region.remap();
+        });
+    }
+    return count;
+}
+
+ErrorOr<void> InodeVMObject::read_pages(size_t first_page_index, size_t page_count, NonnullRefPtrVector<PhysicalPage>& pages)
+{
+    TRY(pages.try_ensure_capacity(page_count));
+    for (size_t i = 0; i < page_count; ++i)
+        pages.unchecked_append(TRY(MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No)));
+
+    // Map the new pages contiguously so the whole run can be read with a single call into the file system.
+    auto vmobject = TRY(AnonymousVMObject::try_create_with_physical_pages(pages.span()));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, page_count * PAGE_SIZE, "Inode read"sv, Region::Access::ReadWrite));
+
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(region->vaddr().as_ptr());
+    auto nread = TRY(m_inode->read_bytes(first_page_index * PAGE_SIZE, page_count * PAGE_SIZE, buffer, nullptr));
+
+    // Drop the pages past the end of the file, and zero out the rest of a partially read last page
+    // to avoid leaking uninitialized data.
+    auto pages_read = ceil_div(nread, static_cast<size_t>(PAGE_SIZE));
+    if (nread % PAGE_SIZE)
+        memset(region->vaddr().offset(nread).as_ptr(), 0, pages_read * PAGE_SIZE - nread);
+    pages.shrink(pages_read);
+    return {};
+}
+
+void InodeVMObject::install_pages(size_t first_page_index, NonnullRefPtrVector<PhysicalPage> const& pages)
+{
+    VERIFY(first_page_index + pages.size() <= page_count());
+    SpinlockLocker locker(m_lock);
+
+    // If someone else brought in any of these pages while we were reading from the inode,
+    // we keep theirs. No harm done (other than some duplicate work).
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto& slot = m_physical_pages[first_page_index + i];
+        if (slot.is_null())
+            slot = pages[i];
+    }
+}
+
+ErrorOr<void> InodeVMObject::read_ahead(size_t first_page_index, size_t page_count)
+{
+    VERIFY(first_page_index + page_count <= this->page_count());
+
+    NonnullLockRefPtr<InodeVMObject> vmobject = *this;
+    return g_io_work->try_queue([vmobject = move(vmobject), first_page_index, page_count]() mutable {
+        auto end = first_page_index + page_count;
+        auto index = first_page_index;
+        while (index < end) {
+            size_t run_first = 0;
+            size_t run_end = 0;
+            {
+                SpinlockLocker locker(vmobject->m_lock);
+                auto physical_pages = vmobject->physical_pages();
+                while (index < end && !physical_pages[index].is_null())
+                    ++index;
+                run_first = index;
+                while (index < end && index - run_first < max_read_ahead_pages && physical_pages[index].is_null())
+                    ++index;
+                run_end = index;
+            }
+            if (run_first == run_end)
+                return;
+
+            NonnullRefPtrVector<PhysicalPage> pages;
+            if (auto result = vmobject->read_pages(run_first, run_end - run_first, pages); result.is_error()) {
+                dbgln_if(PAGE_FAULT_DEBUG, "InodeVMObject: Read-ahead of {} page(s) at {} failed: {}", run_end - run_first, run_first, result.error());
+                return;
+            }
+            vmobject->install_pages(run_first, pages);
+
+            // We've reached the end of the file.
+            if (pages.size() < run_end - run_first)
+                return;
+        }
+    });
+}
+
 u32 InodeVMObject::writable_mappings() const
 {
     u32 count = 0;
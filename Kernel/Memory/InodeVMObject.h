@@ -24,6 +24,17 @@ public:
 
     int release_all_clean_pages();
     int try_release_clean_pages(int page_amount);
+    size_t release_clean_pages_in_range(size_t first_page_index, size_t page_count);
+
+    // Reads the given pages from the inode into newly allocated physical pages.
+    // Pages past the end of the file are left out, so fewer pages than requested may be returned.
+    ErrorOr<void> read_pages(size_t first_page_index, size_t page_count, NonnullRefPtrVector<PhysicalPage>&);
+
+    // Puts pages returned by read_pages() into their slots, unless someone else got there first.
+    void install_pages(size_t first_page_index, NonnullRefPtrVector<PhysicalPage> const&);
+
+    // Reads the pages in the given range that aren't resident yet in the background.
+    ErrorOr<void> read_ahead(size_t first_page_index, size_t page_count);
 
     u32 writable_mappings() const;
 
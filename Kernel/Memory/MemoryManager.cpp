@@ -13,7 +13,9 @@
 #include <Kernel/Arch/PageFault.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/BootInfo.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Firmware/ACPI/SRAT.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
@@ -28,6 +30,9 @@
 #include <Kernel/Process.h>
 #include <Kernel/Sections.h>
 #include <Kernel/StdLib.h>
+#if ARCH(I386) || ARCH(X86_64)
+#    include <Kernel/Arch/x86/ProcessorInfo.h>
+#endif
 
 extern u8 start_of_kernel_image[];
 extern u8 end_of_kernel_image[];
@@ -108,6 +113,12 @@ UNMAP_AFTER_INIT MemoryManager::MemoryManager()
     // By using a tag we don't have to query the VMObject for every page
     // whether it was committed or not
     m_lazy_committed_page = committed_pages.take_one();
+
+    m_fault_around_pages = kernel_command_line().fault_around_pages();
+
+    m_global_data.with([&](auto& global_data) {
+        MUST(global_data.zeroed_pages.try_ensure_capacity(zeroed_page_pool_capacity));
+    });
 }
 
 UNMAP_AFTER_INIT MemoryManager::~MemoryManager() = default;
@@ -145,11 +156,13 @@ UNMAP_AFTER_INIT void MemoryManager::protect_readonly_after_init_memory()
 {
     SpinlockLocker page_lock(kernel_page_directory().get_lock());
     // Disable writing to the .ro_after_init section
-    for (auto i = (FlatPtr)&start_of_ro_after_init; i < (FlatPtr)&end_of_ro_after_init; i += PAGE_SIZE) {
+    auto start = (FlatPtr)&start_of_ro_after_init;
+    auto end = (FlatPtr)&end_of_ro_after_init;
+    for (auto i = start; i < end; i += PAGE_SIZE) {
         auto& pte = *ensure_pte(kernel_page_directory(), VirtualAddress(i));
         pte.set_writable(false);
-        flush_tlb(&kernel_page_directory(), VirtualAddress(i));
     }
+    flush_tlb(&kernel_page_directory(), VirtualAddress(start), ceil_div(end - start, static_cast<FlatPtr>(PAGE_SIZE)));
 }
 
 void MemoryManager::unmap_text_after_init()
@@ -163,8 +176,8 @@ void MemoryManager::unmap_text_after_init()
     for (auto i = start; i < end; i += PAGE_SIZE) {
         auto& pte = *ensure_pte(kernel_page_directory(), VirtualAddress(i));
         pte.clear();
-        flush_tlb(&kernel_page_directory(), VirtualAddress(i));
     }
+    flush_tlb(&kernel_page_directory(), VirtualAddress(start), (end - start) / PAGE_SIZE);
 
     dmesgln("Unmapped {} KiB of kernel text after init! :^)", (end - start) / KiB);
 }
@@ -179,8 +192,8 @@ UNMAP_AFTER_INIT void MemoryManager::protect_ksyms_after_init()
     for (auto i = start; i < end; i += PAGE_SIZE) {
         auto& pte = *ensure_pte(kernel_page_directory(), VirtualAddress(i));
         pte.set_writable(false);
-        flush_tlb(&kernel_page_directory(), VirtualAddress(i));
     }
+    flush_tlb(&kernel_page_directory(), VirtualAddress(start), (end - start) / PAGE_SIZE);
 
     dmesgln("Write-protected kernel symbols after init.");
 }
@@ -564,6 +577,11 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     if (!pde.is_present())
         return nullptr;
 
+    if (pde.is_huge()) {
+        auto* page_table = split_huge_page(page_directory, page_directory_table_index, page_directory_index);
+        return page_table ? &page_table[page_table_index] : nullptr;
+    }
+
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
 
@@ -577,6 +595,10 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
+    if (pde.is_present() && pde.is_huge()) {
+        auto* page_table = split_huge_page(page_directory, page_directory_table_index, page_directory_index);
+        return page_table ? &page_table[page_table_index] : nullptr;
+    }
     if (pde.is_present())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
@@ -619,7 +641,16 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
     if (pde.is_present()) {
-        auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
+        auto* page_table = pde.is_huge()
+            ? split_huge_page(page_directory, page_directory_table_index, page_directory_index)
+            : quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
+        if (!page_table) {
+            // FIXME: We couldn't allocate a page table to split the huge page, so all we can do is unmap it entirely.
+            //        This is fine as long as huge pages only back anonymous memory that is being unmapped anyway.
+            dbgln("MM: Unable to split huge page to release {}", vaddr);
+            pde.clear();
+            return;
+        }
         auto& pte = page_table[page_table_index];
         pte.clear();
 
@@ -641,6 +672,129 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+void MemoryManager::write_protect_range(PageDirectory& page_directory, VirtualAddress vaddr, size_t page_count)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.is_page_aligned());
+
+    auto start = vaddr;
+    auto end = vaddr.offset(page_count * PAGE_SIZE);
+    while (vaddr < end) {
+        u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+        u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+        auto next_page_table = VirtualAddress { (vaddr.get() & ~(huge_page_size - 1)) + huge_page_size };
+        auto chunk_end = min(next_page_table, end);
+
+        auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+        auto& pde = pd[page_directory_index];
+        if (!pde.is_present()) {
+            vaddr = chunk_end;
+            continue;
+        }
+        if (pde.is_huge()) {
+            // NOTE: A huge page always belongs to a single region, so all of it is in the range.
+            pde.set_writable(false);
+            vaddr = chunk_end;
+            continue;
+        }
+
+        auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
+        for (; vaddr < chunk_end; vaddr = vaddr.offset(PAGE_SIZE)) {
+            auto& pte = page_table[(vaddr.get() >> 12) & 0x1ff];
+            if (pte.is_present())
+                pte.set_writable(false);
+        }
+    }
+
+    flush_tlb(&page_directory, start, page_count);
+}
+
+void MemoryManager::map_huge_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, bool writable, bool executable)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % huge_page_size == 0);
+    VERIFY(paddr.get() % huge_page_size == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (pde.is_present() && !pde.is_huge())
+        get_physical_page_entry(PhysicalAddress { pde.page_table_base() }).allocated.physical_page.unref();
+
+    pde.clear();
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_user_allowed(is_user_address(vaddr));
+    pde.set_writable(writable);
+    if (Processor::current().has_nx())
+        pde.set_execute_disabled(!executable);
+    pde.set_present(true);
+
+    flush_tlb(&page_directory, vaddr, pages_per_huge_page);
+}
+
+bool MemoryManager::release_huge_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!pde.is_present() || !pde.is_huge())
+        return false;
+    pde.clear();
+    return true;
+}
+
+PageTableEntry* MemoryManager::split_huge_page(PageDirectory& page_directory, u32 page_directory_table_index, u32 page_directory_index)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+
+    auto page_table_or_error = allocate_physical_page(ShouldZeroFill::No);
+    if (page_table_or_error.is_error()) {
+        dbgln("MM: Unable to allocate page table to split huge page");
+        return nullptr;
+    }
+    auto page_table = page_table_or_error.release_value();
+
+    // Allocating may have used the quickmap slots, so look up the entry again.
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    VERIFY(pde.is_present() && pde.is_huge());
+
+    auto huge_page_base = pde.page_table_base();
+    auto* ptes = quickmap_pt(page_table->paddr());
+    for (size_t i = 0; i < pages_per_huge_page; ++i) {
+        auto& pte = ptes[i];
+        pte.clear();
+        pte.set_physical_page_base(huge_page_base + i * PAGE_SIZE);
+        pte.set_user_allowed(pde.is_user_allowed());
+        pte.set_writable(pde.is_writable());
+        pte.set_cache_disabled(pde.is_cache_disabled());
+        pte.set_global(pde.is_global());
+        pte.set_execute_disabled(pde.is_execute_disabled());
+        pte.set_present(true);
+    }
+
+    // The page table maps the same memory with the same permissions, so nothing needs to be flushed.
+    pde.set_huge(false);
+    pde.set_page_table_base(page_table->paddr().get());
+    pde.set_user_allowed(true);
+    pde.set_writable(true);
+    pde.set_execute_disabled(false);
+
+    // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
+    (void)page_table.leak_ref();
+
+    return ptes;
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     ProcessorSpecific<MemoryManagerData>::initialize();
@@ -648,7 +802,120 @@ UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
     if (cpu == 0) {
         new MemoryManager;
         kmalloc_enable_expand();
+    } else {
+        get_data().m_numa_node = MM.numa_node_of_current_processor();
+    }
+}
+
+template<typename GlobalData>
+static u8 numa_node_of_physical_page(GlobalData& global_data, PhysicalAddress paddr)
+{
+    for (auto& region : global_data.physical_regions) {
+        if (region.contains(paddr))
+            return region.numa_node_of(paddr);
+    }
+    VERIFY_NOT_REACHED();
+}
+
+UNMAP_AFTER_INIT void MemoryManager::initialize_numa_topology()
+{
+    m_interleave_numa_allocations = kernel_command_line().numa_policy() == NUMAPolicy::Interleave;
+
+    if (auto result = parse_numa_topology(); result.is_error())
+        dmesgln("MM: No NUMA topology available ({}), all memory is in a single node", result.error());
+
+    m_global_data.with([&](auto& global_data) {
+        if (m_numa_node_count > 1) {
+            for (auto& region : global_data.physical_regions)
+                region.assign_numa_nodes([&](PhysicalAddress paddr) { return numa_node_for_physical_address(paddr); });
+        }
+
+        // Redo the per-node accounting, now that pages that were handed out so far have a node.
+        global_data.numa_nodes = {};
+        for (auto& region : global_data.physical_regions) {
+            region.for_each_zone([&](PhysicalZone const& zone) {
+                auto& node_info = global_data.numa_nodes[zone.numa_node()];
+                node_info.physical_pages += zone.page_count();
+                node_info.physical_pages_used += zone.page_count() - zone.available();
+            });
+        }
+        // Pages in the zeroed page pool have been taken out of their zone, but are still free.
+        for (auto& page : global_data.zeroed_pages)
+            --global_data.numa_nodes[numa_node_of_physical_page(global_data, page->paddr())].physical_pages_used;
+
+        for (size_t i = 0; i < m_numa_node_count; ++i)
+            dmesgln("MM: NUMA node {}: {} MiB", i, global_data.numa_nodes[i].physical_pages * PAGE_SIZE / MiB);
+    });
+
+    get_data().m_numa_node = numa_node_of_current_processor();
+}
+
+UNMAP_AFTER_INIT ErrorOr<void> MemoryManager::parse_numa_topology()
+{
+    auto topology = TRY(ACPI::parse_system_resource_affinity_table());
+
+    // Proximity domains don't have to be numbered contiguously, so we map them to node numbers in the order we see them.
+    Vector<u32, max_numa_nodes> proximity_domains;
+    auto numa_node_for_proximity_domain = [&](u32 proximity_domain) -> u8 {
+        for (size_t i = 0; i < proximity_domains.size(); ++i) {
+            if (proximity_domains[i] == proximity_domain)
+                return i;
+        }
+        if (proximity_domains.size() == max_numa_nodes) {
+            dmesgln("MM: Too many NUMA nodes, merging proximity domain {} into node {}", proximity_domain, max_numa_nodes - 1);
+            return max_numa_nodes - 1;
+        }
+        proximity_domains.unchecked_append(proximity_domain);
+        return proximity_domains.size() - 1;
+    };
+
+    for (auto& range : topology.memory_ranges)
+        TRY(m_numa_memory_ranges.try_append({ range.base, range.length, numa_node_for_proximity_domain(range.proximity_domain) }));
+    for (auto& processor : topology.processors)
+        TRY(m_numa_processors.try_append({ processor.apic_id, numa_node_for_proximity_domain(processor.proximity_domain) }));
+    m_numa_node_count = max(proximity_domains.size(), 1u);
+    return {};
+}
+
+u8 MemoryManager::numa_node_for_physical_address(PhysicalAddress paddr) const
+{
+    for (auto& range : m_numa_memory_ranges) {
+        if (paddr >= range.base && paddr.get() - range.base.get() < range.length)
+            return range.numa_node;
     }
+    return 0;
+}
+
+u8 MemoryManager::numa_node_of_current_processor() const
+{
+#if ARCH(I386) || ARCH(X86_64)
+    auto apic_id = Processor::current().info().physical_apic_id();
+    for (auto& processor : m_numa_processors) {
+        if (processor.apic_id == apic_id)
+            return processor.numa_node;
+    }
+#endif
+    return 0;
+}
+
+u8 MemoryManager::preferred_numa_node()
+{
+    if (m_numa_node_count == 1)
+        return 0;
+    if (m_interleave_numa_allocations)
+        return m_next_interleaved_numa_node.fetch_add(1, AK::MemoryOrder::memory_order_relaxed) % m_numa_node_count;
+    // First touch: Pages are allocated when they're faulted in, so memory ends up local to whoever touches it first.
+    return get_data().m_numa_node;
+}
+
+Vector<MemoryManager::NUMANodeInfo, max_numa_nodes> MemoryManager::get_numa_node_info()
+{
+    return m_global_data.with([&](auto& global_data) {
+        Vector<NUMANodeInfo, max_numa_nodes> numa_nodes;
+        for (size_t i = 0; i < m_numa_node_count; ++i)
+            numa_nodes.unchecked_append(global_data.numa_nodes[i]);
+        return numa_nodes;
+    });
 }
 
 Region* MemoryManager::kernel_region_from_vaddr(VirtualAddress address)
@@ -716,7 +983,9 @@ Region* MemoryManager::find_region_from_vaddr(VirtualAddress vaddr)
     if (!page_directory)
         return nullptr;
     VERIFY(page_directory->address_space());
-    return find_user_region_from_vaddr(*page_directory->address_space(), vaddr);
+    // NOTE: This is on the page fault path, so we look the region up without taking the address space lock.
+    //       That way, threads faulting in different regions of the same process don't serialize on it.
+    return page_directory->address_space()->region_tree().find_region_containing_lockless(vaddr);
 }
 
 PageFaultResponse MemoryManager::handle_page_fault(PageFault const& fault)
@@ -890,6 +1159,7 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
 
             region.return_page(paddr);
             --global_data.system_memory_info.physical_pages_used;
+            --global_data.numa_nodes[region.numa_node_of(paddr)].physical_pages_used;
 
             // Always return pages to the uncommitted pool. Pages that were
             // committed and allocated are only freed upon request. Once
@@ -901,9 +1171,24 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
     });
 }
 
-RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed)
+static RefPtr<PhysicalPage> take_free_page_from_regions(NonnullOwnPtrVector<PhysicalRegion>& physical_regions, u8 preferred_numa_node)
+{
+    // Look for memory in the preferred node first, and settle for whatever is free after that.
+    for (auto& region : physical_regions) {
+        if (region.has_free_pages_in_numa_node(preferred_numa_node))
+            return region.take_free_page(preferred_numa_node);
+    }
+    for (auto& region : physical_regions) {
+        if (auto page = region.take_free_page(preferred_numa_node))
+            return page;
+    }
+    return nullptr;
+}
+
+RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed, ShouldZeroFill should_zero_fill, bool* page_is_zeroed)
 {
     RefPtr<PhysicalPage> page;
+    auto preferred_numa_node = this->preferred_numa_node();
     m_global_data.with([&](auto& global_data) {
         if (committed) {
             // Draw from the committed pages pool. We should always have these pages available
@@ -915,22 +1200,79 @@ RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed)
                 return;
             global_data.system_memory_info.physical_pages_uncommitted--;
         }
-        for (auto& region : global_data.physical_regions) {
-            page = region.take_free_page();
-            if (!page.is_null()) {
-                ++global_data.system_memory_info.physical_pages_used;
-                break;
-            }
+
+        // NOTE: Pages in the zeroed page pool are still accounted as free, so we may have to
+        //       fall back to the pool even if the caller doesn't care about the contents.
+        if (should_zero_fill == ShouldZeroFill::Yes && !global_data.zeroed_pages.is_empty()) {
+            page = global_data.zeroed_pages.take_last();
+            if (page_is_zeroed)
+                *page_is_zeroed = true;
+        } else {
+            page = take_free_page_from_regions(global_data.physical_regions, preferred_numa_node);
+            if (page.is_null() && !global_data.zeroed_pages.is_empty())
+                page = global_data.zeroed_pages.take_last();
+        }
+        if (!page.is_null()) {
+            ++global_data.system_memory_info.physical_pages_used;
+            auto numa_node = numa_node_of_physical_page(global_data, page->paddr());
+            auto& node_info = global_data.numa_nodes[numa_node];
+            ++node_info.physical_pages_used;
+            if (numa_node == preferred_numa_node)
+                ++node_info.allocation_hits;
+            else
+                ++node_info.allocation_misses;
         }
     });
     VERIFY(!page.is_null());
     return page;
 }
 
+static void zero_page_non_temporal(u8* ptr)
+{
+#if ARCH(X86_64)
+    // Pages from the zeroed page pool are typically not touched again until much later,
+    // so write around the caches rather than evicting something useful.
+    auto* qwords = bit_cast<u64*>(ptr);
+    for (size_t i = 0; i < PAGE_SIZE / sizeof(u64); ++i)
+        asm volatile("movnti %1, %0"
+                     : "=m"(qwords[i])
+                     : "r"(0ull));
+    asm volatile("sfence" ::
+                     : "memory");
+#else
+    memset(ptr, 0, PAGE_SIZE);
+#endif
+}
+
+size_t MemoryManager::refill_zeroed_page_pool(size_t max_page_count)
+{
+    size_t added_page_count = 0;
+    while (added_page_count < max_page_count) {
+        // NOTE: We zero one page at a time so that we don't hold the lock for too long.
+        bool did_add_page = m_global_data.with([&](auto& global_data) {
+            if (global_data.zeroed_pages.size() >= zeroed_page_pool_capacity)
+                return false;
+            auto page = take_free_page_from_regions(global_data.physical_regions, 0);
+            if (page.is_null())
+                return false;
+            auto* ptr = quickmap_page(*page);
+            zero_page_non_temporal(ptr);
+            unquickmap_page();
+            global_data.zeroed_pages.unchecked_append(page.release_nonnull());
+            return true;
+        });
+        if (!did_add_page)
+            break;
+        ++added_page_count;
+    }
+    return added_page_count;
+}
+
 NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill should_zero_fill)
 {
-    auto page = find_free_physical_page(true);
-    if (should_zero_fill == ShouldZeroFill::Yes) {
+    bool page_is_zeroed = false;
+    auto page = find_free_physical_page(true, should_zero_fill, &page_is_zeroed);
+    if (should_zero_fill == ShouldZeroFill::Yes && !page_is_zeroed) {
         InterruptDisabler disabler;
         auto* ptr = quickmap_page(*page);
         memset(ptr, 0, PAGE_SIZE);
@@ -942,7 +1284,8 @@ NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_physical_page(Badg
 ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
     return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalPage>> {
-        auto page = find_free_physical_page(false);
+        bool page_is_zeroed = false;
+        auto page = find_free_physical_page(false, should_zero_fill, &page_is_zeroed);
         bool purged_pages = false;
 
         if (!page) {
@@ -956,7 +1299,7 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
                     return IterationDecision::Continue;
                 if (auto purged_page_count = anonymous_vmobject.purge()) {
                     dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                    page = find_free_physical_page(false);
+                    page = find_free_physical_page(false, should_zero_fill, &page_is_zeroed);
                     purged_pages = true;
                     VERIFY(page);
                     return IterationDecision::Break;
@@ -972,7 +1315,7 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
                 auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
                 if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
                     dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
-                    page = find_free_physical_page(false);
+                    page = find_free_physical_page(false, should_zero_fill, &page_is_zeroed);
                     VERIFY(page);
                     return IterationDecision::Break;
                 }
@@ -984,7 +1327,7 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
             return ENOMEM;
         }
 
-        if (should_zero_fill == ShouldZeroFill::Yes) {
+        if (should_zero_fill == ShouldZeroFill::Yes && !page_is_zeroed) {
             auto* ptr = quickmap_page(*page);
             memset(ptr, 0, PAGE_SIZE);
             unquickmap_page();
@@ -1011,6 +1354,8 @@ ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_contiguous_ph
             if (!physical_pages.is_empty()) {
                 global_data.system_memory_info.physical_pages_uncommitted -= page_count;
                 global_data.system_memory_info.physical_pages_used += page_count;
+                for (auto& page : physical_pages)
+                    ++global_data.numa_nodes[physical_region.numa_node_of(page.paddr())].physical_pages_used;
                 return physical_pages;
             }
         }
@@ -1025,6 +1370,40 @@ ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_contiguous_ph
     return physical_pages;
 }
 
+ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_huge_physical_page()
+{
+    auto physical_pages = TRY(m_global_data.with([&](auto& global_data) -> ErrorOr<NonnullRefPtrVector<PhysicalPage>> {
+        // We need to make sure we don't touch pages that we have committed to
+        if (global_data.system_memory_info.physical_pages_uncommitted < pages_per_huge_page)
+            return ENOMEM;
+
+        for (auto& physical_region : global_data.physical_regions) {
+            // Zone blocks are aligned to their size relative to the start of the region,
+            // so only regions that start on a huge page boundary can give us aligned ones.
+            if (physical_region.lower().get() % huge_page_size != 0)
+                continue;
+            auto physical_pages = physical_region.take_contiguous_free_pages(pages_per_huge_page);
+            if (!physical_pages.is_empty()) {
+                VERIFY(physical_pages[0].paddr().get() % huge_page_size == 0);
+                global_data.system_memory_info.physical_pages_uncommitted -= pages_per_huge_page;
+                global_data.system_memory_info.physical_pages_used += pages_per_huge_page;
+                for (auto& page : physical_pages)
+                    ++global_data.numa_nodes[physical_region.numa_node_of(page.paddr())].physical_pages_used;
+                return physical_pages;
+            }
+        }
+        return ENOMEM;
+    }));
+
+    for (auto& page : physical_pages) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return physical_pages;
+}
+
 void MemoryManager::enter_process_address_space(Process& process)
 {
     process.address_space().with([](auto& space) {
@@ -1049,6 +1428,11 @@ void MemoryManager::flush_tlb(PageDirectory const* page_directory, VirtualAddres
     Processor::flush_tlb(page_directory, vaddr, page_count);
 }
 
+void MemoryManager::flush_tlb(PageDirectory const* page_directory, Span<TLBFlushRange const> ranges)
+{
+    Processor::flush_tlb(page_directory, ranges);
+}
+
 PageDirectoryEntry* MemoryManager::quickmap_pd(PageDirectory& directory, size_t pdpt_index)
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/Concepts.h>
 #include <AK/HashTable.h>
@@ -32,6 +33,10 @@ namespace Kernel::Memory {
 
 ErrorOr<FlatPtr> page_round_up(FlatPtr x);
 
+// A huge page is mapped by a single page directory entry instead of a whole page table.
+constexpr size_t huge_page_size = 2 * MiB;
+constexpr size_t pages_per_huge_page = huge_page_size / PAGE_SIZE;
+
 constexpr FlatPtr page_round_down(FlatPtr x)
 {
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
@@ -91,6 +96,9 @@ struct MemoryManagerData {
 
     Spinlock m_quickmap_in_use { LockRank::None };
     InterruptsState m_quickmap_previous_interrupts_state;
+
+    // The NUMA node this processor belongs to.
+    u8 m_numa_node { 0 };
 };
 
 // This class represents a set of committed physical pages.
@@ -126,6 +134,7 @@ private:
 };
 
 class MemoryManager {
+    friend class AddressSpace;
     friend class PageDirectory;
     friend class AnonymousVMObject;
     friend class Region;
@@ -169,6 +178,8 @@ public:
     NonnullRefPtr<PhysicalPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_contiguous_physical_pages(size_t size);
+    // Returns pages_per_huge_page zeroed pages, physically contiguous and aligned to huge_page_size.
+    ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_huge_physical_page();
     void deallocate_physical_page(PhysicalAddress);
 
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
@@ -191,6 +202,20 @@ public:
 
     SystemMemoryInfo get_system_memory_info();
 
+    struct NUMANodeInfo {
+        PhysicalSize physical_pages { 0 };
+        PhysicalSize physical_pages_used { 0 };
+        // Pages handed out from this node when it was the preferred one, and when another node was.
+        u64 allocation_hits { 0 };
+        u64 allocation_misses { 0 };
+    };
+
+    Vector<NUMANodeInfo, max_numa_nodes> get_numa_node_info();
+
+    // Reads the NUMA topology from the ACPI SRAT, if there is one, and tags physical memory with its node.
+    void initialize_numa_topology();
+    size_t numa_node_count() const { return m_numa_node_count; }
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -239,6 +264,14 @@ public:
 
     IterationDecision for_each_physical_memory_range(Function<IterationDecision(PhysicalMemoryRange const&)>);
 
+    // How many pages around a faulting file-backed page we try to bring in at once.
+    size_t fault_around_pages() const { return m_fault_around_pages; }
+
+    // Zero-filled allocations are served from a pool of pre-zeroed pages when possible.
+    // The pool is kept filled in the background by the PageZeroingTask.
+    static constexpr size_t zeroed_page_pool_capacity = 512;
+    size_t refill_zeroed_page_pool(size_t max_page_count);
+
 private:
     MemoryManager();
     ~MemoryManager();
@@ -252,12 +285,18 @@ private:
     void parse_memory_map();
     static void flush_tlb_local(VirtualAddress, size_t page_count = 1);
     static void flush_tlb(PageDirectory const*, VirtualAddress, size_t page_count = 1);
+    static void flush_tlb(PageDirectory const*, Span<TLBFlushRange const>);
 
     static Region* kernel_region_from_vaddr(VirtualAddress);
 
     static Region* find_region_from_vaddr(VirtualAddress);
 
-    RefPtr<PhysicalPage> find_free_physical_page(bool);
+    RefPtr<PhysicalPage> find_free_physical_page(bool committed, ShouldZeroFill = ShouldZeroFill::No, bool* page_is_zeroed = nullptr);
+
+    ErrorOr<void> parse_numa_topology();
+    u8 preferred_numa_node();
+    u8 numa_node_of_current_processor() const;
+    u8 numa_node_for_physical_address(PhysicalAddress) const;
 
     ALWAYS_INLINE u8* quickmap_page(PhysicalPage& page)
     {
@@ -276,6 +315,17 @@ private:
         No
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
+    // Takes write access away from whatever is mapped in the range. Unlike going through ensure_pte(), this skips
+    // over the parts that have no page table, and leaves huge pages in one piece.
+    void write_protect_range(PageDirectory&, VirtualAddress, size_t page_count);
+
+    // Maps the huge_page_size bytes at vaddr with a single entry, replacing the page table that was there.
+    // The caller must own everything that page table mapped.
+    void map_huge_page(PageDirectory&, VirtualAddress, PhysicalAddress, bool writable, bool executable);
+    // Clears the entry for vaddr if it maps a huge page. Returns false if it's a regular page table instead.
+    bool release_huge_page(PageDirectory&, VirtualAddress);
+    // Replaces a huge page with a page table that maps the same memory, so that its pages can be changed one by one.
+    PageTableEntry* split_huge_page(PageDirectory&, u32 page_directory_table_index, u32 page_directory_index);
 
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
@@ -289,6 +339,25 @@ private:
     PhysicalPageEntry* m_physical_page_entries { nullptr };
     size_t m_physical_page_entries_count { 0 };
 
+    size_t m_fault_around_pages { 1 };
+
+    struct NUMAMemoryRange {
+        PhysicalAddress base;
+        u64 length { 0 };
+        u8 numa_node { 0 };
+    };
+    struct NUMAProcessor {
+        u32 apic_id { 0 };
+        u8 numa_node { 0 };
+    };
+
+    // NOTE: These are filled in by initialize_numa_topology() before the APs are started, and then never change.
+    size_t m_numa_node_count { 1 };
+    bool m_interleave_numa_allocations { false };
+    Vector<NUMAMemoryRange> m_numa_memory_ranges;
+    Vector<NUMAProcessor> m_numa_processors;
+    Atomic<u32> m_next_interleaved_numa_node { 0 };
+
     struct GlobalData {
         GlobalData();
 
@@ -297,6 +366,11 @@ private:
         NonnullOwnPtrVector<PhysicalRegion> physical_regions;
         OwnPtr<PhysicalRegion> physical_pages_region;
 
+        Array<NUMANodeInfo, max_numa_nodes> numa_nodes;
+
+        // NOTE: These pages are taken out of the physical regions, but still accounted as free.
+        Vector<NonnullRefPtr<PhysicalPage>> zeroed_pages;
+
         RegionTree region_tree;
 
         Vector<UsedMemoryRange> used_memory_ranges;
@@ -47,7 +47,7 @@ void PhysicalRegion::initialize_zones()
         while (remaining_pages >= pages_per_zone) {
             m_zones.append(adopt_nonnull_own_or_enomem(new (nothrow) PhysicalZone(base_address, pages_per_zone)).release_value_but_fixme_should_propagate_errors());
             base_address = base_address.offset(pages_per_zone * PAGE_SIZE);
-            m_usable_zones.append(m_zones.last());
+            m_usable_zones[0].append(m_zones.last());
             remaining_pages -= pages_per_zone;
             ++zone_count;
         }
@@ -63,6 +63,17 @@ void PhysicalRegion::initialize_zones()
     make_zones(small_zone_size);
 }
 
+void PhysicalRegion::assign_numa_nodes(Function<u8(PhysicalAddress)> numa_node_for_address)
+{
+    for (auto& zone : m_zones) {
+        auto numa_node = numa_node_for_address(zone.base());
+        VERIFY(numa_node < max_numa_nodes);
+        zone.set_numa_node(numa_node);
+        if (!m_full_zones.contains(zone))
+            m_usable_zones[numa_node].append(zone);
+    }
+}
+
 OwnPtr<PhysicalRegion> PhysicalRegion::try_take_pages_from_beginning(unsigned page_count)
 {
     VERIFY(page_count > 0);
@@ -81,15 +92,19 @@ NonnullRefPtrVector<PhysicalPage> PhysicalRegion::take_contiguous_free_pages(siz
     auto order = count_trailing_zeroes(rounded_page_count);
 
     Optional<PhysicalAddress> page_base;
-    for (auto& zone : m_usable_zones) {
-        page_base = zone.allocate_block(order);
-        if (page_base.has_value()) {
-            if (zone.is_empty()) {
-                // We've exhausted this zone, move it to the full zones list.
-                m_full_zones.append(zone);
+    for (auto& usable_zones : m_usable_zones) {
+        for (auto& zone : usable_zones) {
+            page_base = zone.allocate_block(order);
+            if (page_base.has_value()) {
+                if (zone.is_empty()) {
+                    // We've exhausted this zone, move it to the full zones list.
+                    m_full_zones.append(zone);
+                }
+                break;
             }
-            break;
         }
+        if (page_base.has_value())
+            break;
     }
 
     if (!page_base.has_value())
@@ -103,12 +118,22 @@ NonnullRefPtrVector<PhysicalPage> PhysicalRegion::take_contiguous_free_pages(siz
     return physical_pages;
 }
 
-RefPtr<PhysicalPage> PhysicalRegion::take_free_page()
+RefPtr<PhysicalPage> PhysicalRegion::take_free_page(u8 preferred_numa_node)
 {
-    if (m_usable_zones.is_empty())
-        return nullptr;
+    auto* usable_zones = &m_usable_zones[preferred_numa_node];
+    if (usable_zones->is_empty()) {
+        usable_zones = nullptr;
+        for (auto& other_usable_zones : m_usable_zones) {
+            if (!other_usable_zones.is_empty()) {
+                usable_zones = &other_usable_zones;
+                break;
+            }
+        }
+        if (!usable_zones)
+            return nullptr;
+    }
 
-    auto& zone = *m_usable_zones.first();
+    auto& zone = *usable_zones->first();
     auto page = zone.allocate_block(0);
     VERIFY(page.has_value());
 
@@ -120,7 +145,7 @@ RefPtr<PhysicalPage> PhysicalRegion::take_free_page()
     return PhysicalPage::create(page.value());
 }
 
-void PhysicalRegion::return_page(PhysicalAddress paddr)
+PhysicalZone& PhysicalRegion::zone_for(PhysicalAddress paddr)
 {
     auto large_zone_base = lower().get();
     auto small_zone_base = lower().get() + (m_large_zones * large_zone_size);
@@ -133,9 +158,15 @@ void PhysicalRegion::return_page(PhysicalAddress paddr)
 
     auto& zone = m_zones[zone_index];
     VERIFY(zone.contains(paddr));
+    return zone;
+}
+
+void PhysicalRegion::return_page(PhysicalAddress paddr)
+{
+    auto& zone = zone_for(paddr);
     zone.deallocate_block(paddr, 0);
     if (m_full_zones.contains(zone))
-        m_usable_zones.append(zone);
+        m_usable_zones[zone.numa_node()].append(zone);
 }
 
 }
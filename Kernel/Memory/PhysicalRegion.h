@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Function.h>
 #include <AK/OwnPtr.h>
 #include <Kernel/Memory/PhysicalPage.h>
 #include <Kernel/Memory/PhysicalZone.h>
@@ -33,13 +35,29 @@ public:
 
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(unsigned);
 
-    RefPtr<PhysicalPage> take_free_page();
+    // Tags each zone with the NUMA node its memory belongs to. Must be called after initialize_zones().
+    void assign_numa_nodes(Function<u8(PhysicalAddress)> numa_node_for_address);
+    u8 numa_node_of(PhysicalAddress paddr) const { return zone_for(paddr).numa_node(); }
+    bool has_free_pages_in_numa_node(u8 numa_node) const { return !m_usable_zones[numa_node].is_empty(); }
+
+    template<typename Callback>
+    void for_each_zone(Callback callback) const
+    {
+        for (auto& zone : m_zones)
+            callback(zone);
+    }
+
+    // Prefers memory in the given NUMA node, but falls back to any other node.
+    RefPtr<PhysicalPage> take_free_page(u8 preferred_numa_node = 0);
     NonnullRefPtrVector<PhysicalPage> take_contiguous_free_pages(size_t count);
     void return_page(PhysicalAddress);
 
 private:
     PhysicalRegion(PhysicalAddress lower, PhysicalAddress upper);
 
+    PhysicalZone& zone_for(PhysicalAddress);
+    PhysicalZone const& zone_for(PhysicalAddress paddr) const { return const_cast<PhysicalRegion&>(*this).zone_for(paddr); }
+
     static constexpr size_t large_zone_size = 16 * MiB;
     static constexpr size_t small_zone_size = 1 * MiB;
 
@@ -47,7 +65,7 @@ private:
 
     size_t m_large_zones { 0 };
 
-    PhysicalZone::List m_usable_zones;
+    Array<PhysicalZone::List, max_numa_nodes> m_usable_zones;
     PhysicalZone::List m_full_zones;
 
     PhysicalAddress m_lower;
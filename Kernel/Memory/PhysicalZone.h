@@ -11,6 +11,9 @@
 
 namespace Kernel::Memory {
 
+// The most NUMA nodes we keep track of. Memory in any node beyond that is lumped in with the last one.
+static constexpr size_t max_numa_nodes = 8;
+
 // A PhysicalZone is an allocator that manages a sub-area of a PhysicalRegion.
 // Its total size is always a power of two.
 // You allocate chunks at a time. One chunk is PAGE_SIZE/2, and the minimum allocation size is 2 chunks.
@@ -35,6 +38,11 @@ public:
     bool is_empty() const { return available() == 0; }
 
     PhysicalAddress base() const { return m_base_address; }
+    size_t page_count() const { return m_page_count; }
+
+    u8 numa_node() const { return m_numa_node; }
+    void set_numa_node(u8 numa_node) { m_numa_node = numa_node; }
+
     bool contains(PhysicalAddress paddr) const
     {
         return paddr >= m_base_address && paddr < m_base_address.offset(m_page_count * PAGE_SIZE);
@@ -84,6 +92,7 @@ private:
     PhysicalAddress m_base_address { 0 };
     size_t m_page_count { 0 };
     size_t m_used_chunks { 0 };
+    u8 m_numa_node { 0 };
 
     IntrusiveListNode<PhysicalZone> m_list_node;
 
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Memory.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <AK/StringView.h>
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Arch/PageFault.h>
@@ -23,6 +24,9 @@
 
 namespace Kernel::Memory {
 
+// How much further than usual we read ahead on faults in regions that are accessed sequentially.
+static constexpr size_t sequential_fault_around_multiplier = 4;
+
 Region::Region()
     : m_range(VirtualRange({}, 0))
 {
@@ -118,8 +122,14 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
     auto vmobject_clone = TRY(vmobject().try_clone());
 
     // Set up a COW region. The parent (this) region becomes COW as well!
-    if (is_writable())
-        remap();
+    if (is_writable()) {
+        // Every page of an anonymous VMObject is COW now, so it's enough to take write access away from the
+        // pages that are actually mapped. The others are mapped read-only whenever they get faulted in.
+        if (vmobject().is_anonymous() && !static_cast<AnonymousVMObject const&>(vmobject()).is_volatile())
+            write_protect_mapped_pages();
+        else
+            remap();
+    }
 
     OwnPtr<KString> clone_region_name;
     if (m_name)
@@ -134,6 +144,8 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
     }
     clone_region->set_syscall_region(is_syscall_region());
     clone_region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
+    clone_region->set_wants_huge_pages(m_wants_huge_pages);
+    clone_region->set_access_pattern(m_access_pattern);
     return clone_region;
 }
 
@@ -249,6 +261,70 @@ bool Region::map_individual_page_impl(size_t page_index)
     return map_individual_page_impl(page_index, page);
 }
 
+bool Region::remap_vmobject_page_range(size_t first_page_index_in_vmobject, size_t page_count)
+{
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+
+    size_t first_page_index_in_region = first_page_index_in_vmobject;
+    if (!translate_vmobject_page(first_page_index_in_region))
+        return false;
+    VERIFY(first_page_index_in_region + page_count <= this->page_count());
+
+    bool success = true;
+    for (size_t i = 0; i < page_count; ++i) {
+        RefPtr<PhysicalPage> page;
+        {
+            SpinlockLocker vmobject_locker(vmobject().m_lock);
+            page = physical_page(first_page_index_in_region + i);
+        }
+        // Pages that aren't resident will fault in on their own.
+        if (!page)
+            continue;
+        if (!map_individual_page_impl(first_page_index_in_region + i, page)) {
+            success = false;
+            break;
+        }
+    }
+    MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(first_page_index_in_region), page_count);
+    return success;
+}
+
+bool Region::test_and_clear_accessed(size_t page_index)
+{
+    if (!m_page_directory)
+        return false;
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+
+    // NOTE: `page_index` is a VMObject page index, so first we convert it to a Region page index.
+    if (!translate_vmobject_page(page_index))
+        return false;
+
+    auto* pte = MM.pte(*m_page_directory, vaddr_from_page_index(page_index));
+    if (!pte || !pte->is_accessed())
+        return false;
+
+    // NOTE: We don't flush the TLB here. Until the entry gets evicted, accesses through it won't
+    //       set the bit again, but that only makes the page look colder than it is for a little while.
+    pte->set_accessed(false);
+    return true;
+}
+
+void Region::unmap_vmobject_page(size_t page_index)
+{
+    if (!m_page_directory)
+        return;
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+
+    // NOTE: `page_index` is a VMObject page index, so first we convert it to a Region page index.
+    if (!translate_vmobject_page(page_index))
+        return;
+
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    if (auto* pte = MM.pte(*m_page_directory, page_vaddr))
+        pte->clear();
+    MemoryManager::flush_tlb(m_page_directory, page_vaddr);
+}
+
 bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalPage> physical_page)
 {
     SpinlockLocker page_lock(m_page_directory->get_lock());
@@ -277,6 +353,11 @@ void Region::unmap_with_locks_held(ShouldFlushTLB should_flush_tlb, SpinlockLock
     size_t count = page_count();
     for (size_t i = 0; i < count; ++i) {
         auto vaddr = vaddr_from_page_index(i);
+        // Huge pages that we cover entirely can go away without being split first.
+        if (vaddr.get() % huge_page_size == 0 && i + pages_per_huge_page <= count && MM.release_huge_page(*m_page_directory, vaddr)) {
+            i += pages_per_huge_page - 1;
+            continue;
+        }
         MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No);
     }
     if (should_flush_tlb == ShouldFlushTLB::Yes)
@@ -315,6 +396,24 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     return ENOMEM;
 }
 
+ErrorOr<void> Region::map_on_demand(PageDirectory& page_directory)
+{
+    // Only these know how to bring in a page that was never mapped, see handle_fault().
+    if (!vmobject().is_anonymous() && !vmobject().is_inode())
+        return map(page_directory, ShouldFlushTLB::No);
+
+    SpinlockLocker page_lock(page_directory.get_lock());
+    set_page_directory(page_directory);
+    return {};
+}
+
+void Region::write_protect_mapped_pages()
+{
+    VERIFY(m_page_directory);
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    MM.write_protect_range(*m_page_directory, vaddr(), page_count());
+}
+
 void Region::remap()
 {
     VERIFY(m_page_directory);
@@ -341,9 +440,10 @@ void Region::clear_to_zero()
     SpinlockLocker locker(vmobject().m_lock);
     for (auto i = 0u; i < page_count(); ++i) {
         auto& page = physical_page_slot(i);
-        VERIFY(page);
-        if (page->is_shared_zero_page())
+        if (page && page->is_shared_zero_page())
             continue;
+        if (!page)
+            static_cast<AnonymousVMObject&>(vmobject()).drop_compressed_page({}, translate_to_vmobject_page(i));
         page = MM.shared_zero_page();
     }
 }
@@ -367,6 +467,11 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
 
         SpinlockLocker vmobject_locker(vmobject().m_lock);
         auto& page_slot = physical_page_slot(page_index_in_region);
+        if (!page_slot && vmobject().is_anonymous()) {
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(compressed) fault in Region({})[{}]", this, page_index_in_region);
+            vmobject_locker.unlock();
+            return static_cast<AnonymousVMObject&>(vmobject()).handle_compressed_page_fault(*this, translate_to_vmobject_page(page_index_in_region));
+        }
         if (page_slot->is_lazy_committed_page()) {
             auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
             VERIFY(m_vmobject->is_anonymous());
@@ -375,14 +480,19 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
-        dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
-        dbgln("     - Physical page slot pointer: {:p}", page_slot.ptr());
-        if (page_slot) {
-            dbgln("     - Physical page: {}", page_slot->paddr());
-            dbgln("     - Lazy committed: {}", page_slot->is_lazy_committed_page());
-            dbgln("     - Shared zero: {}", page_slot->is_shared_zero_page());
+        // Either the page was unmapped while being considered for compression and has been put back since,
+        // or the region was mapped on demand (like after fork()) and nothing has touched the page yet.
+        NonnullRefPtr<PhysicalPage> page = *page_slot;
+        if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), page))
+            return PageFaultResponse::OutOfMemory;
+        vmobject_locker.unlock();
+        // A write would just fault again to get its own copy of the page, so save it the trip.
+        if (fault.is_write() && should_cow(page_index_in_region)) {
+            if (page->is_shared_zero_page())
+                return handle_zero_fault(page_index_in_region, *page);
+            return handle_cow_fault(page_index_in_region);
         }
-        return PageFaultResponse::ShouldCrash;
+        return PageFaultResponse::Continue;
     }
     VERIFY(fault.type() == PageFault::Type::ProtectionViolation);
     if (fault.access() == PageFault::Access::Write && is_writable() && should_cow(page_index_in_region)) {
@@ -408,6 +518,9 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (m_wants_huge_pages && try_handle_huge_zero_fault(page_index_in_region))
+        return PageFaultResponse::Continue;
+
     RefPtr<PhysicalPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -446,6 +559,48 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+bool Region::try_handle_huge_zero_fault(size_t page_index_in_region)
+{
+#if ARCH(X86_64)
+    if (!is_user() || !is_writable() || !m_cacheable || m_write_combine || m_shared)
+        return false;
+
+    // The whole huge page has to fit inside this region, since we're going to map it all at once.
+    auto huge_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(huge_page_size - 1) };
+    if (huge_page_vaddr < vaddr() || huge_page_vaddr.offset(huge_page_size) > range().end())
+        return false;
+    auto first_page_index_in_region = page_index_from_address(huge_page_vaddr);
+
+    // Don't bother if someone already faulted in a page here. We'd only end up splitting it again.
+    {
+        SpinlockLocker locker(vmobject().m_lock);
+        for (size_t i = 0; i < pages_per_huge_page; ++i) {
+            auto& page = physical_page_slot(first_page_index_in_region + i);
+            if (!page || (!page->is_shared_zero_page() && !page->is_lazy_committed_page()))
+                return false;
+        }
+    }
+
+    // If there's no contiguous memory left, regular pages will have to do.
+    auto pages_or_error = MM.allocate_huge_physical_page();
+    if (pages_or_error.is_error())
+        return false;
+    auto pages = pages_or_error.release_value();
+
+    if (!static_cast<AnonymousVMObject&>(vmobject()).try_install_huge_page({}, translate_to_vmobject_page(first_page_index_in_region), pages))
+        return false;
+
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED HUGE PAGE {} for {}", pages[0].paddr(), huge_page_vaddr);
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    MM.map_huge_page(*m_page_directory, huge_page_vaddr, pages[0].paddr(), true, is_executable());
+    return true;
+#else
+    (void)page_index_in_region;
+    return false;
+#endif
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
@@ -472,76 +627,107 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
     auto& vmobject_physical_page_slot = inode_vmobject.physical_pages()[page_index_in_vmobject];
 
+    // Fault-around: Instead of bringing in just the faulting page, we look at an aligned window
+    // of pages around it (clamped to this region). The run of missing pages around the faulting
+    // one is read from the inode in one go, and everything in the window that's resident afterwards
+    // gets mapped, so that we don't take a separate fault for each neighbor.
+    auto window_size = MM.fault_around_pages();
+    auto window_base = page_index_in_vmobject & ~(window_size - 1);
+    if (m_access_pattern == AccessPattern::Random) {
+        // The neighbors are unlikely to be needed any time soon, so don't bother with them.
+        window_size = 1;
+        window_base = page_index_in_vmobject;
+    } else if (m_access_pattern == AccessPattern::Sequential) {
+        // The pages will be touched front to back, so read further ahead of the fault instead of around it.
+        window_size *= sequential_fault_around_multiplier;
+        window_base = page_index_in_vmobject;
+    }
+    auto window_first = max(first_page_index(), window_base);
+    auto window_end = min(first_page_index() + page_count(), window_base + window_size);
+    auto read_first = page_index_in_vmobject;
+    auto read_end = page_index_in_vmobject + 1;
+
     {
         // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
         SpinlockLocker locker(inode_vmobject.m_lock);
         if (!vmobject_physical_page_slot.is_null()) {
-            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else before reading, remapping.");
-            if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
+            // The page was faulted in by someone else, or read ahead. Either way, its neighbors may be resident as well.
+            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page is already resident, remapping.");
+            if (!remap_vmobject_page_range(window_first, window_end - window_first))
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
+
+        auto physical_pages = inode_vmobject.physical_pages();
+        while (read_first > window_first && physical_pages[read_first - 1].is_null())
+            --read_first;
+        while (read_end < window_end && physical_pages[read_end].is_null())
+            ++read_end;
     }
 
-    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}", name(), page_index_in_region);
+    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}, reading {} page(s) from {}", name(), page_index_in_region, read_end - read_first, read_first);
 
     auto current_thread = Thread::current();
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
-    auto& inode = inode_vmobject.inode();
-
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
-
-    if (result.is_error()) {
-        dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
-        return PageFaultResponse::ShouldCrash;
+    NonnullRefPtrVector<PhysicalPage> new_physical_pages;
+    if (read_end - read_first > 1) {
+        auto result = inode_vmobject.read_pages(read_first, read_end - read_first, new_physical_pages);
+        if (result.is_error()) {
+            // We couldn't set up for a clustered read, fall back to reading just the page we need.
+            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Clustered read failed ({}), falling back to a single page", result.error());
+            new_physical_pages.clear();
+            read_first = page_index_in_vmobject;
+            read_end = page_index_in_vmobject + 1;
+        }
     }
 
-    auto nread = result.value();
-    // Note: If we received 0, it means we are at the end of file or after it,
-    // which means we should return bus error.
-    if (nread == 0)
-        return PageFaultResponse::BusError;
+    if (new_physical_pages.is_empty()) {
+        u8 page_buffer[PAGE_SIZE];
+        auto& inode = inode_vmobject.inode();
 
-    if (nread < PAGE_SIZE) {
-        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
-    }
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
+        auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
 
-    // Allocate a new physical page, and copy the read inode contents into it.
-    auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
-    if (new_physical_page_or_error.is_error()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
-    }
-    auto new_physical_page = new_physical_page_or_error.release_value();
-    {
-        InterruptDisabler disabler;
-        u8* dest_ptr = MM.quickmap_page(*new_physical_page);
-        memcpy(dest_ptr, page_buffer, PAGE_SIZE);
-        MM.unquickmap_page();
-    }
+        if (result.is_error()) {
+            dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
+            return PageFaultResponse::ShouldCrash;
+        }
 
-    {
-        // NOTE: The VMObject lock is required when manipulating the VMObject's physical page slot.
-        SpinlockLocker locker(inode_vmobject.m_lock);
+        auto nread = result.value();
+        // Note: If we received 0, it means we are at the end of file or after it,
+        // which means we should return bus error.
+        if (nread == 0)
+            return PageFaultResponse::BusError;
 
-        if (!vmobject_physical_page_slot.is_null()) {
-            // Someone else faulted in this page while we were reading from the inode.
-            // No harm done (other than some duplicate work), remap the page here and return.
-            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
-            if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
-                return PageFaultResponse::OutOfMemory;
-            return PageFaultResponse::Continue;
+        if (nread < PAGE_SIZE) {
+            // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
+            memset(page_buffer + nread, 0, PAGE_SIZE - nread);
         }
 
-        vmobject_physical_page_slot = new_physical_page;
+        // Allocate a new physical page, and copy the read inode contents into it.
+        auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+        if (new_physical_page_or_error.is_error()) {
+            dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
+            return PageFaultResponse::OutOfMemory;
+        }
+        auto new_physical_page = new_physical_page_or_error.release_value();
+        {
+            InterruptDisabler disabler;
+            u8* dest_ptr = MM.quickmap_page(*new_physical_page);
+            memcpy(dest_ptr, page_buffer, PAGE_SIZE);
+            MM.unquickmap_page();
+        }
+        new_physical_pages.append(move(new_physical_page));
+    } else if (page_index_in_vmobject - read_first >= new_physical_pages.size()) {
+        // The faulting page is at or after the end of the file.
+        return PageFaultResponse::BusError;
     }
 
-    if (!remap_vmobject_page(page_index_in_vmobject, *vmobject_physical_page_slot))
+    inode_vmobject.install_pages(read_first, new_physical_pages);
+
+    if (!remap_vmobject_page_range(window_first, window_end - window_first))
         return PageFaultResponse::OutOfMemory;
 
     return PageFaultResponse::Continue;
@@ -554,6 +740,14 @@ RefPtr<PhysicalPage> Region::physical_page(size_t index) const
     return vmobject().physical_pages()[first_page_index() + index];
 }
 
+bool Region::is_page_compressed(size_t index) const
+{
+    VERIFY(index < page_count());
+    if (!vmobject().is_anonymous())
+        return false;
+    return static_cast<AnonymousVMObject const&>(vmobject()).is_page_compressed(first_page_index() + index);
+}
+
 RefPtr<PhysicalPage>& Region::physical_page_slot(size_t index)
 {
     VERIFY(vmobject().m_lock.is_locked_by_current_processor());
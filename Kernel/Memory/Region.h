@@ -32,6 +32,7 @@ enum class ShouldFlushTLB {
 class Region final
     : public LockWeakable<Region> {
     friend class AddressSpace;
+    friend class AnonymousVMObject;
     friend class MemoryManager;
     friend class RegionTree;
 
@@ -88,6 +89,19 @@ public:
     [[nodiscard]] bool is_stack() const { return m_stack; }
     void set_stack(bool stack) { m_stack = stack; }
 
+    // Whether zero faults may back whole huge_page_size blocks of this region at once.
+    [[nodiscard]] bool wants_huge_pages() const { return m_wants_huge_pages; }
+    void set_wants_huge_pages(bool wants_huge_pages) { m_wants_huge_pages = wants_huge_pages; }
+
+    // How userspace told us (via madvise) that it's going to access the region. This steers fault-around.
+    enum class AccessPattern : u8 {
+        Normal,
+        Sequential,
+        Random,
+    };
+    [[nodiscard]] AccessPattern access_pattern() const { return m_access_pattern; }
+    void set_access_pattern(AccessPattern access_pattern) { m_access_pattern = access_pattern; }
+
     [[nodiscard]] bool is_mmap() const { return m_mmap; }
 
     void set_mmap(bool mmap, bool description_was_readable, bool description_was_writable)
@@ -160,6 +174,7 @@ public:
 
     RefPtr<PhysicalPage> physical_page(size_t index) const;
     RefPtr<PhysicalPage>& physical_page_slot(size_t index);
+    [[nodiscard]] bool is_page_compressed(size_t index) const;
 
     [[nodiscard]] size_t offset_in_vmobject() const
     {
@@ -188,10 +203,13 @@ public:
 
     void set_page_directory(PageDirectory&);
     ErrorOr<void> map(PageDirectory&, ShouldFlushTLB = ShouldFlushTLB::Yes);
+    // Like map(), but the pages are only mapped once they're accessed, if the VMObject allows for that.
+    ErrorOr<void> map_on_demand(PageDirectory&);
     void unmap(ShouldFlushTLB = ShouldFlushTLB::Yes);
     void unmap_with_locks_held(ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock>& pd_locker);
 
     void remap();
+    void write_protect_mapped_pages();
 
     [[nodiscard]] bool is_mapped() const { return m_page_directory != nullptr; }
 
@@ -209,6 +227,11 @@ private:
     Region(VirtualRange const&, NonnullLockRefPtr<VMObject>, size_t offset_in_vmobject, OwnPtr<KString>, Region::Access access, Cacheable, bool shared);
 
     [[nodiscard]] bool remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalPage>);
+    [[nodiscard]] bool remap_vmobject_page_range(size_t first_page_index, size_t page_count);
+
+    // These take a VMObject page index, and are used to find and evict cold pages.
+    [[nodiscard]] bool test_and_clear_accessed(size_t page_index);
+    void unmap_vmobject_page(size_t page_index);
 
     void set_access_bit(Access access, bool b)
     {
@@ -221,6 +244,7 @@ private:
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalPage& page_in_slot_at_time_of_fault);
+    [[nodiscard]] bool try_handle_huge_zero_fault(size_t page_index);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage>);
@@ -239,6 +263,8 @@ private:
     bool m_write_combine : 1 { false };
     bool m_mmapped_from_readable : 1 { false };
     bool m_mmapped_from_writable : 1 { false };
+    bool m_wants_huge_pages : 1 { false };
+    AccessPattern m_access_pattern { AccessPattern::Normal };
 
     IntrusiveRedBlackTreeNode<FlatPtr, Region, RawPtr<Region>> m_tree_node;
     IntrusiveListNode<Region> m_vmobject_list_node;
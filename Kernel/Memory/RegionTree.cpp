@@ -5,6 +5,9 @@
  */
 
 #include <AK/Format.h>
+#include <AK/ScopeGuard.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Arch/ScopedCritical.h>
 #include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/RegionTree.h>
@@ -22,11 +25,34 @@ void RegionTree::delete_all_regions_assuming_they_are_unmapped()
     // FIXME: This could definitely be done in a more efficient manner.
     while (!m_regions.is_empty()) {
         auto& region = *m_regions.begin();
+        begin_modification();
         m_regions.remove(region.vaddr().get());
+        end_modification();
+        wait_for_lockless_readers();
         delete &region;
     }
 }
 
+void RegionTree::begin_modification()
+{
+    m_sequence.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+}
+
+void RegionTree::end_modification()
+{
+    m_sequence.fetch_add(1, AK::MemoryOrder::memory_order_release);
+}
+
+void RegionTree::wait_for_lockless_readers()
+{
+    // Readers that arrive after this point can no longer see the removed region,
+    // so we only need to wait for the ones in the previous epoch to leave.
+    auto previous_epoch = m_reader_epoch.fetch_add(1) & 1;
+    while (m_lockless_readers[previous_epoch].load() != 0)
+        Processor::wait_check();
+}
+
 ErrorOr<VirtualRange> RegionTree::allocate_range_anywhere(size_t size, size_t alignment)
 {
     if (!size)
@@ -153,7 +179,9 @@ ErrorOr<void> RegionTree::place_anywhere(Region& region, RandomizeVirtualAddress
 {
     auto range = TRY(randomize_virtual_address == RandomizeVirtualAddress::Yes ? allocate_range_randomized(size, alignment) : allocate_range_anywhere(size, alignment));
     region.m_range = range;
+    begin_modification();
     m_regions.insert(region.vaddr().get(), region);
+    end_modification();
     return {};
 }
 
@@ -161,13 +189,21 @@ ErrorOr<void> RegionTree::place_specifically(Region& region, VirtualRange const&
 {
     auto allocated_range = TRY(allocate_range_specific(range.base(), range.size()));
     region.m_range = allocated_range;
+    begin_modification();
     m_regions.insert(region.vaddr().get(), region);
+    end_modification();
     return {};
 }
 
 bool RegionTree::remove(Region& region)
 {
-    return m_regions.remove(region.range().base().get());
+    begin_modification();
+    auto did_remove = m_regions.remove(region.range().base().get());
+    end_modification();
+    // The caller is about to free the region, so make sure nobody is still looking at it.
+    if (did_remove)
+        wait_for_lockless_readers();
+    return did_remove;
 }
 
 Region* RegionTree::find_region_containing(VirtualAddress address)
@@ -186,4 +222,30 @@ Region* RegionTree::find_region_containing(VirtualRange range)
     return region;
 }
 
+Region* RegionTree::find_region_containing_lockless(VirtualAddress address)
+{
+    // Don't get preempted while registered as a reader, as that would stall removals.
+    ScopedCritical critical;
+
+    auto epoch = m_reader_epoch.load() & 1;
+    m_lockless_readers[epoch].fetch_add(1);
+    ScopeGuard unregister_reader = [&] { m_lockless_readers[epoch].fetch_sub(1); };
+
+    for (;;) {
+        auto sequence = m_sequence.load(AK::MemoryOrder::memory_order_acquire);
+        if (sequence & 1) {
+            Processor::wait_check();
+            continue;
+        }
+
+        auto* region = m_regions.find_largest_not_above(address.get());
+        if (region && !region->contains(address))
+            region = nullptr;
+
+        AK::atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+        if (m_sequence.load(AK::MemoryOrder::memory_order_relaxed) == sequence)
+            return region;
+    }
+}
+
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Error.h>
 #include <AK/IntrusiveRedBlackTree.h>
 #include <Kernel/Locking/Spinlock.h>
@@ -50,13 +51,30 @@ public:
     Region* find_region_containing(VirtualAddress);
     Region* find_region_containing(VirtualRange);
 
+    // Looks up a region without holding the lock that protects the tree, so that concurrent page faults
+    // don't serialize on it. Lookups that raced with a modification of the tree are retried.
+    // NOTE: Modifications must still be serialized by the owner of the tree.
+    Region* find_region_containing_lockless(VirtualAddress);
+
 private:
     ErrorOr<VirtualRange> allocate_range_anywhere(size_t size, size_t alignment = PAGE_SIZE);
     ErrorOr<VirtualRange> allocate_range_specific(VirtualAddress base, size_t size);
     ErrorOr<VirtualRange> allocate_range_randomized(size_t size, size_t alignment = PAGE_SIZE);
 
+    void begin_modification();
+    void end_modification();
+    void wait_for_lockless_readers();
+
     IntrusiveRedBlackTree<&Region::m_tree_node> m_regions;
     VirtualRange const m_total_range;
+
+    // Odd while the tree is being modified.
+    Atomic<u32> m_sequence { 0 };
+
+    // Lockless readers register themselves in the slot of the current epoch, so that a removal
+    // only has to wait for the readers that may have seen the removed region before it is freed.
+    Atomic<u32> m_reader_epoch { 0 };
+    Atomic<u32> m_lockless_readers[2] {};
 };
 
 }
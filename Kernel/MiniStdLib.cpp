@@ -13,29 +13,29 @@ void* memcpy(void* dest_ptr, void const* src_ptr, size_t n)
 #if ARCH(I386) || ARCH(X86_64)
     size_t dest = (size_t)dest_ptr;
     size_t src = (size_t)src_ptr;
-    // FIXME: Support starting at an unaligned address.
-    if (!(dest & 0x3) && !(src & 0x3) && n >= 12) {
+    if (n >= 2 * sizeof(size_t)) {
+        // Copy up to the first aligned destination address bytewise. Unaligned loads are cheap,
+        // but stores that straddle cache lines aren't.
+        size_t head = -dest & (sizeof(size_t) - 1);
+        n -= head;
+        asm volatile(
+            "rep movsb\n"
+            : "+S"(src), "+D"(dest), "+c"(head)::"memory");
         size_t size_ts = n / sizeof(size_t);
 #    if ARCH(I386)
         asm volatile(
             "rep movsl\n"
-            : "=S"(src), "=D"(dest)
-            : "S"(src), "D"(dest), "c"(size_ts)
-            : "memory");
+            : "+S"(src), "+D"(dest), "+c"(size_ts)::"memory");
 #    else
         asm volatile(
             "rep movsq\n"
-            : "=S"(src), "=D"(dest)
-            : "S"(src), "D"(dest), "c"(size_ts)
-            : "memory");
+            : "+S"(src), "+D"(dest), "+c"(size_ts)::"memory");
 #    endif
-        n -= size_ts * sizeof(size_t);
-        if (n == 0)
-            return dest_ptr;
+        n %= sizeof(size_t);
     }
     asm volatile(
-        "rep movsb\n" ::"S"(src), "D"(dest), "c"(n)
-        : "memory");
+        "rep movsb\n"
+        : "+S"(src), "+D"(dest), "+c"(n)::"memory");
 #else
     u8* pd = (u8*)dest_ptr;
     u8 const* ps = (u8 const*)src_ptr;
@@ -61,31 +61,36 @@ void* memset(void* dest_ptr, int c, size_t n)
 {
 #if ARCH(I386) || ARCH(X86_64)
     size_t dest = (size_t)dest_ptr;
-    // FIXME: Support starting at an unaligned address.
-    if (!(dest & 0x3) && n >= 12) {
+    if (n >= 2 * sizeof(size_t)) {
+        // Like in memcpy(), fill bytewise up to the first aligned address.
+        size_t head = -dest & (sizeof(size_t) - 1);
+        n -= head;
+        asm volatile(
+            "rep stosb\n"
+            : "+D"(dest), "+c"(head)
+            : "a"(c)
+            : "memory");
         size_t size_ts = n / sizeof(size_t);
         size_t expanded_c = explode_byte((u8)c);
 #    if ARCH(I386)
         asm volatile(
             "rep stosl\n"
-            : "=D"(dest)
-            : "D"(dest), "c"(size_ts), "a"(expanded_c)
+            : "+D"(dest), "+c"(size_ts)
+            : "a"(expanded_c)
             : "memory");
 #    else
         asm volatile(
             "rep stosq\n"
-            : "=D"(dest)
-            : "D"(dest), "c"(size_ts), "a"(expanded_c)
+            : "+D"(dest), "+c"(size_ts)
+            : "a"(expanded_c)
             : "memory");
 #    endif
-        n -= size_ts * sizeof(size_t);
-        if (n == 0)
-            return dest_ptr;
+        n %= sizeof(size_t);
     }
     asm volatile(
         "rep stosb\n"
-        : "=D"(dest), "=c"(n)
-        : "0"(dest), "1"(n), "a"(c)
+        : "+D"(dest), "+c"(n)
+        : "a"(c)
         : "memory");
 #else
     u8* pd = (u8*)dest_ptr;
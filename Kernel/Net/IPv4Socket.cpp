@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/StringBuilder.h>
 #include <Kernel/API/POSIX/errno.h>
@@ -49,7 +50,7 @@ ErrorOr<NonnullLockRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
     if (type == SOCK_DGRAM)
         return TRY(UDPSocket::try_create(protocol, move(receive_buffer)));
     if (type == SOCK_RAW) {
-        auto raw_socket = adopt_lock_ref_if_nonnull(new (nothrow) IPv4Socket(type, protocol, move(receive_buffer), {}));
+        auto raw_socket = adopt_lock_ref_if_nonnull(new (nothrow) IPv4Socket(type, protocol, move(receive_buffer)));
         if (raw_socket)
             return raw_socket.release_nonnull();
         return ENOMEM;
@@ -57,16 +58,12 @@ ErrorOr<NonnullLockRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
     return EINVAL;
 }
 
-IPv4Socket::IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer)
+IPv4Socket::IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
     : Socket(AF_INET, type, protocol)
     , m_receive_buffer(move(receive_buffer))
-    , m_scratch_buffer(move(optional_scratch_buffer))
 {
     dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}) created with type={}, protocol={}", this, type, protocol);
     m_buffer_mode = type == SOCK_STREAM ? BufferMode::Bytes : BufferMode::Packets;
-    if (m_buffer_mode == BufferMode::Bytes) {
-        VERIFY(m_scratch_buffer);
-    }
 
     all_sockets().with_exclusive([&](auto& table) {
         table.append(*this);
@@ -289,6 +286,9 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 {
     MutexLocker locker(mutex());
     ReceivedPacket taken_packet;
+    ScopeGuard release_taken_packet = [&] {
+        release_received_packet(taken_packet);
+    };
     ReceivedPacket* packet { nullptr };
     {
         if (m_receive_queue.is_empty()) {
@@ -312,7 +312,7 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 
             dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): recvfrom without blocking {} bytes, packets in queue: {}",
                 this,
-                packet->data->size(),
+                packet->data.size(),
                 m_receive_queue.size());
         }
     }
@@ -349,10 +349,10 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 
         dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): recvfrom with blocking {} bytes, packets in queue: {}",
             this,
-            packet->data->size(),
+            packet->data.size(),
             m_receive_queue.size());
     }
-    VERIFY(packet->data);
+    VERIFY(packet->frame);
 
     packet_timestamp = packet->timestamp;
 
@@ -372,12 +372,23 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
     }
 
     if (type() == SOCK_RAW) {
-        size_t bytes_written = min(packet->data->size(), buffer_length);
-        SOCKET_TRY(buffer.write(packet->data->data(), bytes_written));
+        size_t bytes_written = min(packet->data.size(), buffer_length);
+        SOCKET_TRY(buffer.write(packet->data.data(), bytes_written));
         return bytes_written;
     }
 
-    return protocol_receive(packet->data->bytes(), buffer, buffer_length, flags);
+    return protocol_receive(packet->data, buffer, buffer_length, flags);
+}
+
+void IPv4Socket::release_received_packet(ReceivedPacket& packet)
+{
+    if (!packet.frame)
+        return;
+    // Unless another socket has it queued up as well, the frame goes back to the adapter it came from, for another packet to go into.
+    if (auto adapter = packet.adapter.strong_ref())
+        adapter->release_packet_buffer(*packet.frame);
+    packet.frame = nullptr;
+    packet.data = {};
 }
 
 ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*> user_addr, Userspace<socklen_t*> user_addr_length, Time& packet_timestamp, bool blocking)
@@ -413,7 +424,7 @@ ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKer
     return total_nreceived;
 }
 
-bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port, ReadonlyBytes packet, Time const& packet_timestamp)
+bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port, ReadonlyBytes packet, NetworkAdapter& adapter, PacketWithTimestamp& frame)
 {
     MutexLocker locker(mutex());
 
@@ -431,11 +442,12 @@ bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port,
             VERIFY(m_can_read);
             return false;
         }
-        auto scratch_buffer = UserOrKernelBuffer::for_kernel_buffer(m_scratch_buffer->data());
-        auto nreceived_or_error = protocol_receive(packet, scratch_buffer, m_scratch_buffer->size(), 0);
-        if (nreceived_or_error.is_error())
+        // The payload comes last, so it can go straight from the frame into the receive buffer.
+        auto payload_size_or_error = protocol_size(packet);
+        if (payload_size_or_error.is_error())
             return false;
-        auto nwritten_or_error = m_receive_buffer->write(scratch_buffer, nreceived_or_error.value());
+        auto payload = packet.slice(packet.size() - payload_size_or_error.value());
+        auto nwritten_or_error = m_receive_buffer->write(UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(payload.data())), payload.size());
         if (nwritten_or_error.is_error())
             return false;
         set_can_read(!m_receive_buffer->is_empty());
@@ -444,12 +456,7 @@ bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port,
             dbgln("IPv4Socket({}): did_receive refusing packet since queue is full.", this);
             return false;
         }
-        auto data_or_error = KBuffer::try_create_with_bytes("IPv4Socket: Packet buffer"sv, packet);
-        if (data_or_error.is_error()) {
-            dbgln("IPv4Socket: did_receive unable to allocate storage for incoming packet.");
-            return false;
-        }
-        auto result = m_receive_queue.try_append({ source_address, source_port, packet_timestamp, data_or_error.release_value() });
+        auto result = m_receive_queue.try_append({ source_address, source_port, frame.timestamp, packet, frame, adapter });
         if (result.is_error()) {
             dbgln("IPv4Socket: Dropped incoming packet because appending to the receive queue failed.");
             return false;
@@ -807,7 +814,7 @@ ErrorOr<void> IPv4Socket::ioctl(OpenFileDescription&, unsigned request, Userspac
             readable = static_cast<int>(m_receive_buffer->immediately_readable());
         } else {
             if (m_receive_queue.size() != 0u) {
-                readable = static_cast<int>(TRY(protocol_size(m_receive_queue.first().data->bytes())));
+                readable = static_cast<int>(TRY(protocol_size(m_receive_queue.first().data)));
             }
         }
 
@@ -842,4 +849,9 @@ void IPv4Socket::drop_receive_buffer()
     m_receive_buffer = nullptr;
 }
 
+size_t IPv4Socket::receive_buffer_space() const
+{
+    return m_receive_buffer ? m_receive_buffer->space_for_writing() : 0;
+}
+
 }
@@ -9,10 +9,10 @@
 #include <AK/HashMap.h>
 #include <AK/SinglyLinkedListWithCount.h>
 #include <Kernel/DoubleBuffer.h>
-#include <Kernel/KBuffer.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/IPv4SocketTuple.h>
+#include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/Socket.h>
 
 namespace Kernel {
@@ -46,7 +46,9 @@ public:
 
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
 
-    bool did_receive(IPv4Address const& peer_address, u16 peer_port, ReadonlyBytes, Time const&);
+    // The bytes are the IPv4 packet within the frame that came in on the adapter. Sockets that queue up
+    // packets keep a reference to the frame rather than a copy of it.
+    bool did_receive(IPv4Address const& peer_address, u16 peer_port, ReadonlyBytes, NetworkAdapter&, PacketWithTimestamp&);
 
     IPv4Address const& local_address() const { return m_local_address; }
     u16 local_port() const { return m_local_port; }
@@ -73,7 +75,7 @@ public:
     BufferMode buffer_mode() const { return m_buffer_mode; }
 
 protected:
-    IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer);
+    IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
     virtual StringView class_name() const override { return "IPv4Socket"sv; }
 
     PortAllocationResult allocate_local_port_if_needed();
@@ -94,6 +96,7 @@ protected:
 
     static ErrorOr<NonnullOwnPtr<DoubleBuffer>> try_create_receive_buffer();
     void drop_receive_buffer();
+    size_t receive_buffer_space() const;
 
 private:
     virtual bool is_ipv4() const override { return true; }
@@ -113,9 +116,14 @@ private:
         IPv4Address peer_address;
         u16 peer_port;
         Time timestamp;
-        OwnPtr<KBuffer> data;
+        // The IPv4 packet, which lives in the frame we got from the adapter.
+        ReadonlyBytes data;
+        LockRefPtr<PacketWithTimestamp> frame;
+        LockWeakPtr<NetworkAdapter> adapter;
     };
 
+    void release_received_packet(ReceivedPacket&);
+
     SinglyLinkedListWithCount<ReceivedPacket> m_receive_queue;
 
     OwnPtr<DoubleBuffer> m_receive_buffer;
@@ -132,8 +140,6 @@ private:
 
     BufferMode m_buffer_mode { BufferMode::Packets };
 
-    OwnPtr<KBuffer> m_scratch_buffer;
-
     IntrusiveListNode<IPv4Socket> m_list_node;
 
 public:
@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Net/Intel/E1000NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -78,9 +79,25 @@ namespace Kernel {
 #define CMD_IC (1 << 2)   // Insert Checksum
 #define CMD_RS (1 << 3)   // Report Status
 #define CMD_RPS (1 << 4)  // Report Packet Sent
+#define CMD_TSE (1 << 2)  // TCP Segmentation Enable (replaces IC in extended descriptors)
+#define CMD_DEXT (1 << 5) // Descriptor Extension
 #define CMD_VLE (1 << 6)  // VLAN Packet Enable
 #define CMD_IDE (1 << 7)  // Interrupt Delay Enable
 
+// Extended Transmit Descriptors (Section 3.3.6 of the manual)
+
+#define DTYP_CONTEXT (0 << 20) // TCP/IP Context Descriptor
+#define DTYP_DATA (1 << 20)    // TCP/IP Data Descriptor
+#define TUCMD_TCP (1 << 0)     // Packet Type is TCP (rather than UDP)
+#define TUCMD_IP (1 << 1)      // Packet Type is IPv4 (rather than IPv6)
+#define TUCMD_TSE (1 << 2)     // TCP Segmentation Enable
+#define TUCMD_DEXT (1 << 5)    // Descriptor Extension
+#define POPTS_IXSM (1 << 0)    // Insert IP Checksum
+#define POPTS_TXSM (1 << 1)    // Insert TCP/UDP Checksum
+
+#define IPV4_CHECKSUM_OFFSET 10
+#define TCP_CHECKSUM_OFFSET 16
+
 // TCTL Register
 
 #define TCTL_EN (1 << 1)      // Transmit Enable
@@ -121,6 +138,9 @@ namespace Kernel {
 #define INTERRUPT_TXD_LOW (1 << 15)
 #define INTERRUPT_SRPD (1 << 16)
 
+// These are masked while the network task is polling the receive ring.
+#define RECEIVE_INTERRUPTS (INTERRUPT_RXT0 | INTERRUPT_RXO)
+
 // https://www.intel.com/content/dam/doc/manual/pci-pci-x-family-gbe-controllers-software-dev-manual.pdf Section 5.2
 UNMAP_AFTER_INIT static bool is_valid_device_id(u16 device_id)
 {
@@ -187,8 +207,10 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_link()
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_interrupts()
 {
-    out32(REG_INTERRUPT_RATE, 6000); // Interrupt rate of 1.536 milliseconds
-    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_RXT0 | INTERRUPT_RXO);
+    // The throttling interval is in units of 256 nanoseconds, so this is at most 8000 interrupts per second.
+    // Since the network task drains the whole receive ring per interrupt, we don't need more than that.
+    out32(REG_INTERRUPT_RATE, 488);
+    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | RECEIVE_INTERRUPTS);
     in32(REG_INTERRUPT_CAUSE_READ);
     enable_irq();
 }
@@ -250,8 +272,10 @@ bool E1000NetworkAdapter::handle_irq(RegisterState const&)
     if (status & INTERRUPT_RXO) {
         dbgln_if(E1000_DEBUG, "E1000: RX buffer overrun");
     }
-    if (status & INTERRUPT_RXT0) {
-        receive();
+    if (status & RECEIVE_INTERRUPTS) {
+        // Leave the receive ring to the network task, and don't interrupt us again until it's empty.
+        out32(REG_INTERRUPT_MASK_CLEAR, RECEIVE_INTERRUPTS);
+        schedule_receive_poll();
     }
 
     m_wait_queue.wake_all();
@@ -336,14 +360,14 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
 {
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
 
-    constexpr auto tx_buffer_size = 8192;
     constexpr auto tx_buffer_page_count = tx_buffer_size / PAGE_SIZE;
     m_tx_buffer_region = MM.allocate_contiguous_kernel_region(tx_buffer_size * number_of_tx_descriptors, "E1000 TX buffers"sv, Memory::Region::Access::ReadWrite).release_value();
 
     for (size_t i = 0; i < number_of_tx_descriptors; ++i) {
         auto& descriptor = tx_descriptors[i];
         m_tx_buffers[i] = m_tx_buffer_region->vaddr().as_ptr() + tx_buffer_size * i;
-        descriptor.addr = m_tx_buffer_region->physical_page(tx_buffer_page_count * i)->paddr().get();
+        m_tx_buffer_physical_addresses[i] = m_tx_buffer_region->physical_page(tx_buffer_page_count * i)->paddr().get();
+        descriptor.addr = m_tx_buffer_physical_addresses[i];
         descriptor.cmd = 0;
     }
 
@@ -393,6 +417,12 @@ u32 E1000NetworkAdapter::in32(u16 address)
     return m_registers_io_window->read32(address);
 }
 
+TransmitOffload E1000NetworkAdapter::supported_transmit_offloads() const
+{
+    // All of the 8254x that we know about can do this, section 3.5 of the manual.
+    return TransmitOffload::IPv4Checksum | TransmitOffload::TCPChecksum | TransmitOffload::TCPSegmentation;
+}
+
 void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
 {
     disable_irq();
@@ -400,34 +430,98 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     dbgln_if(E1000_DEBUG, "E1000: Sending packet ({} bytes)", payload.size());
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
     auto& descriptor = tx_descriptors[tx_current];
-    VERIFY(payload.size() <= 8192);
+    VERIFY(payload.size() <= tx_buffer_size);
     auto* vptr = (void*)m_tx_buffers[tx_current];
     memcpy(vptr, payload.data(), payload.size());
+    descriptor.addr = m_tx_buffer_physical_addresses[tx_current];
     descriptor.length = payload.size();
+    descriptor.cso = 0;
+    descriptor.css = 0;
+    descriptor.special = 0;
     descriptor.status = 0;
     descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
     dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
     tx_current = (tx_current + 1) % number_of_tx_descriptors;
+    transmit_and_wait(tx_current, descriptor.status);
+}
+
+void E1000NetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, PacketOffload const& offload)
+{
+    // Only TCP over IPv4 ever asks for offloads.
+    size_t ipv4_start = layer3_payload_offset();
+    auto& ipv4_packet = *reinterpret_cast<IPv4Packet const*>(payload.data() + ipv4_start);
+    size_t tcp_start = ipv4_start + ipv4_packet.internet_header_length() * sizeof(u32);
+    auto& tcp_packet = *reinterpret_cast<TCPPacket const*>(payload.data() + tcp_start);
+    size_t headers_size = tcp_start + tcp_packet.header_size();
+    bool is_segmenting = has_flag(offload.offloads, TransmitOffload::TCPSegmentation);
+
+    // The packet is spread over as many transmit buffers as it takes, after one descriptor for the context.
+    size_t data_descriptor_count = ceil_div(payload.size(), tx_buffer_size);
+    VERIFY(data_descriptor_count < number_of_tx_descriptors);
+
+    disable_irq();
+    size_t tx_current = in32(REG_TXDESCTAIL) % number_of_tx_descriptors;
+    dbgln_if(E1000_DEBUG, "E1000: Sending packet with offloads ({} bytes, {} descriptors, segment size {})", payload.size(), data_descriptor_count, offload.segment_size);
+    auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
+
+    auto& context = *reinterpret_cast<e1000_tx_context_desc*>(&tx_descriptors[tx_current]);
+    context.ipcss = ipv4_start;
+    context.ipcso = ipv4_start + IPV4_CHECKSUM_OFFSET;
+    context.ipcse = tcp_start - 1;
+    context.tucss = tcp_start;
+    context.tucso = tcp_start + TCP_CHECKSUM_OFFSET;
+    // Zero means the TCP checksum covers everything up to the end of the packet.
+    context.tucse = 0;
+    u32 payload_length = is_segmenting ? payload.size() - headers_size : 0;
+    u32 context_command = TUCMD_DEXT | TUCMD_IP | TUCMD_TCP | (is_segmenting ? TUCMD_TSE : 0);
+    context.paylen_and_command = payload_length | DTYP_CONTEXT | (context_command << 24);
+    context.status = 0;
+    context.hdrlen = headers_size;
+    context.mss = offload.segment_size;
+    tx_current = (tx_current + 1) % number_of_tx_descriptors;
+
+    u8 packet_options = (has_flag(offload.offloads, TransmitOffload::IPv4Checksum) ? POPTS_IXSM : 0)
+        | (has_flag(offload.offloads, TransmitOffload::TCPChecksum) ? POPTS_TXSM : 0);
+    e1000_tx_data_desc* descriptor = nullptr;
+    for (size_t offset = 0; offset < payload.size(); offset += tx_buffer_size) {
+        size_t length = min(tx_buffer_size, payload.size() - offset);
+        bool is_last = offset + length == payload.size();
+        memcpy(m_tx_buffers[tx_current], payload.data() + offset, length);
+        descriptor = reinterpret_cast<e1000_tx_data_desc*>(&tx_descriptors[tx_current]);
+        descriptor->addr = m_tx_buffer_physical_addresses[tx_current];
+        u32 command = CMD_DEXT | CMD_IFCS | (is_segmenting ? CMD_TSE : 0) | (is_last ? CMD_EOP | CMD_RS : 0);
+        descriptor->length_and_command = length | DTYP_DATA | (command << 24);
+        descriptor->status = 0;
+        descriptor->popts = packet_options;
+        descriptor->special = 0;
+        tx_current = (tx_current + 1) % number_of_tx_descriptors;
+    }
+    VERIFY(descriptor);
+    transmit_and_wait(tx_current, descriptor->status);
+}
+
+void E1000NetworkAdapter::transmit_and_wait(size_t tx_tail, u8 volatile const& last_descriptor_status)
+{
     Processor::disable_interrupts();
     enable_irq();
-    out32(REG_TXDESCTAIL, tx_current);
+    out32(REG_TXDESCTAIL, tx_tail);
     for (;;) {
-        if (descriptor.status) {
+        if (last_descriptor_status) {
             Processor::enable_interrupts();
             break;
         }
         m_wait_queue.wait_forever("E1000NetworkAdapter"sv);
     }
-    dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
+    dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)last_descriptor_status);
 }
 
-void E1000NetworkAdapter::receive()
+size_t E1000NetworkAdapter::poll_receive(size_t budget)
 {
-    auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
-    u32 rx_current;
-    for (;;) {
-        rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
-        rx_current = (rx_current + 1) % number_of_rx_descriptors;
+    auto* rx_descriptors = (e1000_rx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
+    u32 rx_tail = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
+    size_t received = 0;
+    while (received < budget) {
+        u32 rx_current = (rx_tail + 1) % number_of_rx_descriptors;
         if (!(rx_descriptors[rx_current].status & 1))
             break;
         auto* buffer = m_rx_buffers[rx_current];
@@ -436,8 +530,18 @@ void E1000NetworkAdapter::receive()
         dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
         did_receive({ buffer, length });
         rx_descriptors[rx_current].status = 0;
-        out32(REG_RXDESCTAIL, rx_current);
+        rx_tail = rx_current;
+        ++received;
     }
+    // Hand the whole batch of descriptors back to the card at once.
+    if (received > 0)
+        out32(REG_RXDESCTAIL, rx_tail);
+    return received;
+}
+
+void E1000NetworkAdapter::enable_receive_interrupts()
+{
+    out32(REG_INTERRUPT_MASK_SET, RECEIVE_INTERRUPTS);
 }
 
 i32 E1000NetworkAdapter::link_speed()
@@ -27,6 +27,8 @@ public:
     virtual ~E1000NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) override;
+    virtual TransmitOffload supported_transmit_offloads() const override;
     virtual bool link_up() override { return m_link_up; };
     virtual i32 link_speed() override;
     virtual bool link_full_duplex() override;
@@ -60,6 +62,31 @@ protected:
         volatile uint16_t special { 0 };
     };
 
+    // Tells the card where the headers of the packet in the data descriptors that follow are, and which checksums to fill in.
+    struct [[gnu::packed]] e1000_tx_context_desc {
+        volatile uint8_t ipcss { 0 };
+        volatile uint8_t ipcso { 0 };
+        volatile uint16_t ipcse { 0 };
+        volatile uint8_t tucss { 0 };
+        volatile uint8_t tucso { 0 };
+        volatile uint16_t tucse { 0 };
+        volatile uint32_t paylen_and_command { 0 };
+        volatile uint8_t status { 0 };
+        volatile uint8_t hdrlen { 0 };
+        volatile uint16_t mss { 0 };
+    };
+
+    struct [[gnu::packed]] e1000_tx_data_desc {
+        volatile uint64_t addr { 0 };
+        volatile uint32_t length_and_command { 0 };
+        volatile uint8_t status { 0 };
+        volatile uint8_t popts { 0 };
+        volatile uint16_t special { 0 };
+    };
+
+    static_assert(sizeof(e1000_tx_context_desc) == sizeof(e1000_tx_desc));
+    static_assert(sizeof(e1000_tx_data_desc) == sizeof(e1000_tx_desc));
+
     virtual void detect_eeprom();
     virtual u32 read_eeprom(u8 address);
     void read_mac_address();
@@ -69,6 +96,7 @@ protected:
 
     void initialize_rx_descriptors();
     void initialize_tx_descriptors();
+    void transmit_and_wait(size_t tx_tail, u8 volatile const& last_descriptor_status);
 
     void out8(u16 address, u8);
     void out16(u16 address, u16);
@@ -77,10 +105,12 @@ protected:
     u16 in16(u16 address);
     u32 in32(u16 address);
 
-    void receive();
+    virtual size_t poll_receive(size_t budget) override;
+    virtual void enable_receive_interrupts() override;
 
     static constexpr size_t number_of_rx_descriptors = 256;
     static constexpr size_t number_of_tx_descriptors = 256;
+    static constexpr size_t tx_buffer_size = 8192;
 
     NonnullOwnPtr<IOWindow> m_registers_io_window;
 
@@ -90,6 +120,8 @@ protected:
     OwnPtr<Memory::Region> m_tx_buffer_region;
     Array<void*, number_of_rx_descriptors> m_rx_buffers;
     Array<void*, number_of_tx_descriptors> m_tx_buffers;
+    // Descriptors that held a context descriptor need their buffer address back before they get used for data again.
+    Array<u64, number_of_tx_descriptors> m_tx_buffer_physical_addresses;
     bool m_has_eeprom { false };
     bool m_link_up { false };
     EntropySource m_entropy_source;
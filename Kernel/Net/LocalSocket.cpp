@@ -45,8 +45,8 @@ ErrorOr<void> LocalSocket::try_for_each(Function<ErrorOr<void>(LocalSocket const
 
 ErrorOr<NonnullLockRefPtr<LocalSocket>> LocalSocket::try_create(int type)
 {
-    auto client_buffer = TRY(DoubleBuffer::try_create("LocalSocket: Client buffer"sv));
-    auto server_buffer = TRY(DoubleBuffer::try_create("LocalSocket: Server buffer"sv));
+    auto client_buffer = TRY(LocalSocketBuffer::try_create("LocalSocket: Client buffer"sv));
+    auto server_buffer = TRY(LocalSocketBuffer::try_create("LocalSocket: Server buffer"sv));
     return adopt_nonnull_lock_ref_or_enomem(new (nothrow) LocalSocket(type, move(client_buffer), move(server_buffer)));
 }
 
@@ -67,7 +67,7 @@ ErrorOr<SocketPair> LocalSocket::try_create_connected_pair(int type)
     return SocketPair { move(description1), move(description2) };
 }
 
-LocalSocket::LocalSocket(int type, NonnullOwnPtr<DoubleBuffer> client_buffer, NonnullOwnPtr<DoubleBuffer> server_buffer)
+LocalSocket::LocalSocket(int type, NonnullOwnPtr<LocalSocketBuffer> client_buffer, NonnullOwnPtr<LocalSocketBuffer> server_buffer)
     : Socket(AF_LOCAL, type, 0)
     , m_for_client(move(client_buffer))
     , m_for_server(move(server_buffer))
@@ -314,7 +314,7 @@ ErrorOr<size_t> LocalSocket::sendto(OpenFileDescription& description, UserOrKern
     return nwritten_or_error;
 }
 
-DoubleBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
+LocalSocketBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
 {
     auto role = this->role(description);
     if (role == Role::Accepted)
@@ -324,7 +324,7 @@ DoubleBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
     return nullptr;
 }
 
-DoubleBuffer* LocalSocket::send_buffer_for(OpenFileDescription& description)
+LocalSocketBuffer* LocalSocket::send_buffer_for(OpenFileDescription& description)
 {
     auto role = this->role(description);
     if (role == Role::Connected)
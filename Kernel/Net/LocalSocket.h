@@ -7,7 +7,7 @@
 #pragma once
 
 #include <AK/IntrusiveList.h>
-#include <Kernel/DoubleBuffer.h>
+#include <Kernel/Net/LocalSocketBuffer.h>
 #include <Kernel/Net/Socket.h>
 
 namespace Kernel {
@@ -53,12 +53,12 @@ public:
     virtual ErrorOr<void> chmod(Credentials const&, OpenFileDescription&, mode_t) override;
 
 private:
-    explicit LocalSocket(int type, NonnullOwnPtr<DoubleBuffer> client_buffer, NonnullOwnPtr<DoubleBuffer> server_buffer);
+    explicit LocalSocket(int type, NonnullOwnPtr<LocalSocketBuffer> client_buffer, NonnullOwnPtr<LocalSocketBuffer> server_buffer);
     virtual StringView class_name() const override { return "LocalSocket"sv; }
     virtual bool is_local() const override { return true; }
     bool has_attached_peer(OpenFileDescription const&) const;
-    DoubleBuffer* receive_buffer_for(OpenFileDescription&);
-    DoubleBuffer* send_buffer_for(OpenFileDescription&);
+    LocalSocketBuffer* receive_buffer_for(OpenFileDescription&);
+    LocalSocketBuffer* send_buffer_for(OpenFileDescription&);
     NonnullLockRefPtrVector<OpenFileDescription>& sendfd_queue_for(OpenFileDescription const&);
     NonnullLockRefPtrVector<OpenFileDescription>& recvfd_queue_for(OpenFileDescription const&);
 
@@ -97,8 +97,8 @@ private:
     bool m_accept_side_fd_open { false };
     OwnPtr<KString> m_path;
 
-    NonnullOwnPtr<DoubleBuffer> m_for_client;
-    NonnullOwnPtr<DoubleBuffer> m_for_server;
+    NonnullOwnPtr<LocalSocketBuffer> m_for_client;
+    NonnullOwnPtr<LocalSocketBuffer> m_for_server;
 
     NonnullLockRefPtrVector<OpenFileDescription> m_fds_for_client;
     NonnullLockRefPtrVector<OpenFileDescription> m_fds_for_server;
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/LocalSocketBuffer.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullOwnPtr<LocalSocketBuffer>> LocalSocketBuffer::try_create(StringView name, size_t capacity)
+{
+    VERIFY(is_power_of_two(capacity));
+    auto storage = TRY(KBuffer::try_create_with_size(name, capacity, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_own_or_enomem(new (nothrow) LocalSocketBuffer(capacity, move(storage)));
+}
+
+LocalSocketBuffer::LocalSocketBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage)
+    : m_storage(move(storage))
+    , m_capacity(capacity)
+{
+}
+
+ErrorOr<size_t> LocalSocketBuffer::write(UserOrKernelBuffer const& data, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_write_lock);
+
+    // Nobody but us moves the write position.
+    auto write_position = m_write_position.load(AK::memory_order_relaxed);
+    auto read_position = m_read_position.load(AK::memory_order_acquire);
+    size_t bytes_to_write = min(size, m_capacity - static_cast<size_t>(write_position - read_position));
+    if (bytes_to_write == 0)
+        return 0;
+
+    auto offset = offset_of(write_position);
+    auto first_chunk_size = min(bytes_to_write, m_capacity - offset);
+    TRY(data.read(m_storage->data() + offset, 0, first_chunk_size));
+    if (first_chunk_size < bytes_to_write)
+        TRY(data.read(m_storage->data(), first_chunk_size, bytes_to_write - first_chunk_size));
+
+    m_write_position.store(write_position + bytes_to_write, AK::memory_order_seq_cst);
+
+    // The reader only ever waits after finding the ring empty. Either it sees what we've just written when it looks again,
+    // or we see here that it had read everything there was before we got to publish more.
+    if (m_unblock_callback && m_read_position.load(AK::memory_order_seq_cst) == write_position)
+        m_unblock_callback();
+    return bytes_to_write;
+}
+
+ErrorOr<size_t> LocalSocketBuffer::read(UserOrKernelBuffer& data, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_read_lock);
+
+    // Nobody but us moves the read position.
+    auto read_position = m_read_position.load(AK::memory_order_relaxed);
+    auto write_position = m_write_position.load(AK::memory_order_acquire);
+    size_t bytes_to_read = min(size, static_cast<size_t>(write_position - read_position));
+    if (bytes_to_read == 0)
+        return 0;
+
+    auto offset = offset_of(read_position);
+    auto first_chunk_size = min(bytes_to_read, m_capacity - offset);
+    TRY(data.write(m_storage->data() + offset, 0, first_chunk_size));
+    if (first_chunk_size < bytes_to_read)
+        TRY(data.write(m_storage->data(), first_chunk_size, bytes_to_read - first_chunk_size));
+
+    m_read_position.store(read_position + bytes_to_read, AK::memory_order_seq_cst);
+
+    // Same as in write(), but the other way around: the writer only ever waits after finding the ring full.
+    if (m_unblock_callback && m_write_position.load(AK::memory_order_seq_cst) - read_position == m_capacity)
+        m_unblock_callback();
+    return bytes_to_read;
+}
+
+}
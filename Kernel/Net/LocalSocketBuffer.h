@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/Types.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+// The bytes going one way through a LocalSocket, in a ring that the writing side and the reading side each have their own
+// end of. The two sides never wait for each other, all they share are the positions they've written and read up to.
+// There's a lock for each side, which only matters if more than one thread reads (or writes) the same socket at once.
+// Whoever's waiting is woken only when the ring goes from empty to not empty (or from full to not full), rather than for every write.
+class LocalSocketBuffer {
+public:
+    static constexpr size_t default_capacity = 128 * KiB;
+
+    static ErrorOr<NonnullOwnPtr<LocalSocketBuffer>> try_create(StringView name, size_t capacity = default_capacity);
+
+    ErrorOr<size_t> write(UserOrKernelBuffer const&, size_t);
+    ErrorOr<size_t> read(UserOrKernelBuffer&, size_t);
+
+    bool is_empty() const { return immediately_readable() == 0; }
+    size_t space_for_writing() const { return m_capacity - immediately_readable(); }
+    size_t immediately_readable() const
+    {
+        // The read position is loaded first, so it can only look further behind than it is, never ahead of what was written.
+        auto read_position = m_read_position.load(AK::memory_order_acquire);
+        auto write_position = m_write_position.load(AK::memory_order_acquire);
+        return min<u64>(write_position - read_position, m_capacity);
+    }
+
+    void set_unblock_callback(Function<void()> callback)
+    {
+        VERIFY(!m_unblock_callback);
+        m_unblock_callback = move(callback);
+    }
+
+private:
+    LocalSocketBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage);
+
+    size_t offset_of(u64 position) const { return position & (m_capacity - 1); }
+
+    NonnullOwnPtr<KBuffer> m_storage;
+    size_t m_capacity { 0 };
+    Function<void()> m_unblock_callback;
+
+    // These only ever go up, the offset into the ring is what's left over after dividing by the capacity.
+    Atomic<u64> m_write_position { 0 };
+    Atomic<u64> m_read_position { 0 };
+
+    Mutex m_write_lock { "LocalSocketBuffer write"sv };
+    Mutex m_read_lock { "LocalSocketBuffer read"sv };
+};
+
+}
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Singleton.h>
+#include <Kernel/Debug.h>
 #include <Kernel/Net/LoopbackAdapter.h>
 
 namespace Kernel {
@@ -30,10 +31,21 @@ LoopbackAdapter::LoopbackAdapter(NonnullOwnPtr<KString> interface_name)
 
 LoopbackAdapter::~LoopbackAdapter() = default;
 
+TransmitOffload LoopbackAdapter::supported_transmit_offloads() const
+{
+    // Nothing we send ever leaves the machine, and nobody checks checksums on the way in, so there's no point in computing them.
+    return TransmitOffload::IPv4Checksum | TransmitOffload::TCPChecksum;
+}
+
 void LoopbackAdapter::send_raw(ReadonlyBytes payload)
 {
-    dbgln("LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
+    dbgln_if(LOOPBACK_ADAPTER_DEBUG, "LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
     did_receive(payload);
 }
 
+void LoopbackAdapter::send_raw_with_offload(ReadonlyBytes payload, PacketOffload const&)
+{
+    send_raw(payload);
+}
+
 }
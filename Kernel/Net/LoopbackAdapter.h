@@ -19,10 +19,14 @@ public:
     virtual ~LoopbackAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual TransmitOffload supported_transmit_offloads() const override;
     virtual StringView class_name() const override { return "LoopbackAdapter"sv; }
     virtual bool link_up() override { return true; }
     virtual bool link_full_duplex() override { return true; }
     virtual int link_speed() override { return 1000; }
+
+protected:
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) override;
 };
 
 }
@@ -9,6 +9,9 @@
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/Routing.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Process.h>
 #include <Kernel/StdLib.h>
 
@@ -21,11 +24,66 @@ NetworkAdapter::NetworkAdapter(NonnullOwnPtr<KString> interface_name)
 
 NetworkAdapter::~NetworkAdapter() = default;
 
-void NetworkAdapter::send_packet(ReadonlyBytes packet)
+void NetworkAdapter::send_packet(ReadonlyBytes packet, PacketOffload const& offload)
 {
+    MutexLocker locker(m_transmit_lock);
     m_packets_out++;
     m_bytes_out += packet.size();
-    send_raw(packet);
+    if (offload.is_empty()) {
+        send_raw(packet);
+        return;
+    }
+    if ((supported_transmit_offloads() & offload.offloads) == offload.offloads) {
+        send_raw_with_offload(packet, offload);
+        return;
+    }
+    send_with_software_offload(packet, offload);
+}
+
+void NetworkAdapter::send_with_software_offload(ReadonlyBytes packet, PacketOffload const& offload)
+{
+    // This happens when a packet that was meant for another adapter gets retransmitted through us after a route change.
+    auto& ipv4_packet = *reinterpret_cast<IPv4Packet const*>(packet.data() + layer3_payload_offset());
+    VERIFY(ipv4_packet.protocol() == (u8)IPv4Protocol::TCP);
+    auto& tcp_packet = *static_cast<TCPPacket const*>(ipv4_packet.payload());
+    size_t headers_size = ipv4_payload_offset() + tcp_packet.header_size();
+    VERIFY(packet.size() >= headers_size);
+    size_t payload_size = packet.size() - headers_size;
+
+    bool is_segmenting = has_flag(offload.offloads, TransmitOffload::TCPSegmentation);
+    size_t segment_size = is_segmenting ? offload.segment_size : payload_size;
+    VERIFY(segment_size > 0 || payload_size == 0);
+
+    // The packet itself stays as it is, since it may get retransmitted through an adapter that can do the work itself.
+    size_t offset = 0;
+    do {
+        size_t segment_payload_size = min(segment_size, payload_size - offset);
+        bool is_last_segment = offset + segment_payload_size == payload_size;
+        auto segment = acquire_packet_buffer(headers_size + segment_payload_size);
+        if (!segment) {
+            // TCP will notice that the rest is missing, and send it again.
+            dbgln("Dropping TCP segment as there is not enough memory to buffer it");
+            return;
+        }
+        memcpy(segment->buffer->data(), packet.data(), headers_size);
+        memcpy(segment->buffer->data() + headers_size, packet.data() + headers_size + offset, segment_payload_size);
+
+        auto& segment_ipv4_packet = *reinterpret_cast<IPv4Packet*>(segment->buffer->data() + layer3_payload_offset());
+        segment_ipv4_packet.set_length(segment->buffer->size() - layer3_payload_offset());
+        segment_ipv4_packet.set_checksum(0);
+        segment_ipv4_packet.set_checksum(segment_ipv4_packet.compute_checksum());
+
+        auto& segment_tcp_packet = *static_cast<TCPPacket*>(segment_ipv4_packet.payload());
+        segment_tcp_packet.set_sequence_number(tcp_packet.sequence_number() + offset);
+        if (!is_last_segment)
+            segment_tcp_packet.set_flags(tcp_packet.flags() & ~(TCPFlags::PSH | TCPFlags::FIN));
+        segment_tcp_packet.set_checksum(0);
+        segment_tcp_packet.set_checksum(TCPSocket::compute_tcp_checksum(ipv4_packet.source(), ipv4_packet.destination(), segment_tcp_packet, segment_payload_size));
+
+        send_raw(segment->bytes());
+        release_packet_buffer(*segment);
+        offset += segment_payload_size;
+    } while (offset < payload_size);
 }
 
 void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet)
@@ -47,7 +105,11 @@ void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet
 void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Address const& source_ipv4, MACAddress const& destination_mac, IPv4Address const& destination_ipv4, IPv4Protocol protocol, size_t payload_size, u8 type_of_service, u8 ttl)
 {
     size_t ipv4_packet_size = sizeof(IPv4Packet) + payload_size;
-    VERIFY(ipv4_packet_size <= mtu());
+    // Packets that are going to be segmented only need to fit into the IPv4 length field, the segments will fit the MTU.
+    if (has_flag(packet.offload.offloads, TransmitOffload::TCPSegmentation))
+        VERIFY(ipv4_packet_size <= maximum_segmentation_offload_size);
+    else
+        VERIFY(ipv4_packet_size <= mtu());
 
     size_t ethernet_frame_size = ipv4_payload_offset() + payload_size;
     VERIFY(packet.buffer->size() == ethernet_frame_size);
@@ -66,7 +128,8 @@ void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Addres
     ipv4.set_length(sizeof(IPv4Packet) + payload_size);
     ipv4.set_ident(1);
     ipv4.set_ttl(ttl);
-    ipv4.set_checksum(ipv4.compute_checksum());
+    if (!has_flag(packet.offload.offloads, TransmitOffload::IPv4Checksum))
+        ipv4.set_checksum(ipv4.compute_checksum());
 }
 
 void NetworkAdapter::did_receive(ReadonlyBytes payload)
@@ -95,44 +158,59 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
         on_receive();
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp)
+void NetworkAdapter::schedule_receive_poll()
+{
+    m_receive_poll_scheduled = true;
+    if (on_receive_poll_scheduled)
+        on_receive_poll_scheduled();
+}
+
+bool NetworkAdapter::run_receive_poll(size_t budget)
+{
+    m_receive_poll_scheduled = false;
+    if (poll_receive(budget) < budget) {
+        enable_receive_interrupts();
+        // Packets that arrived while the interrupts were masked may not raise one by themselves,
+        // so take another look now that any new arrival will.
+        if (poll_receive(budget) < budget)
+            return false;
+    }
+    m_receive_poll_scheduled = true;
+    return true;
+}
+
+LockRefPtr<PacketWithTimestamp> NetworkAdapter::dequeue_packet()
 {
     InterruptDisabler disabler;
     if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
+        return {};
     m_packet_queue_size--;
-    packet_timestamp = packet_with_timestamp->timestamp;
-    auto& packet_buffer = packet_with_timestamp->buffer;
-    size_t packet_size = packet_buffer->size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet_buffer->data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
-    return packet_size;
+    return m_packet_queue.take_first();
 }
 
 LockRefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
 {
     auto packet = m_unused_packets.with([size](auto& unused_packets) -> LockRefPtr<PacketWithTimestamp> {
-        if (unused_packets.is_empty())
-            return nullptr;
-
-        auto unused_packet = unused_packets.take_first();
-
-        if (unused_packet->buffer->capacity() >= size)
-            return unused_packet;
-
-        unused_packets.append(*unused_packet);
+        for (auto& unused_packet : unused_packets) {
+            if (unused_packet.buffer->capacity() < size)
+                continue;
+            LockRefPtr<PacketWithTimestamp> packet = unused_packet;
+            unused_packets.remove(unused_packet);
+            return packet;
+        }
         return nullptr;
     });
 
     if (packet) {
         packet->timestamp = kgettimeofday();
+        packet->offload = {};
         packet->buffer->set_size(size);
         return packet;
     }
 
-    auto buffer_or_error = KBuffer::try_create_with_size("NetworkAdapter: Packet buffer"sv, size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
+    // Any buffer we make should be able to take a whole frame, so that the pool doesn't fill up with ones that only fit an ACK.
+    auto capacity = max(size, layer3_payload_offset() + mtu());
+    auto buffer_or_error = KBuffer::try_create_with_size("NetworkAdapter: Packet buffer"sv, capacity, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
     if (buffer_or_error.is_error())
         return {};
     packet = adopt_lock_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
@@ -144,6 +222,9 @@ LockRefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t siz
 
 void NetworkAdapter::release_packet_buffer(PacketWithTimestamp& packet)
 {
+    // Sockets may still have the packet queued up, in which case it just goes away once they're done with it.
+    if (packet.ref_count() > 1)
+        return;
     m_unused_packets.with([&packet](auto& unused_packets) {
         unused_packets.append(packet);
     });
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/ByteBuffer.h>
+#include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/MACAddress.h>
@@ -16,6 +18,7 @@
 #include <Kernel/KBuffer.h>
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Library/LockWeakable.h>
+#include <Kernel/Locking/Mutex.h>
 #include <Kernel/Net/ARP.h>
 #include <Kernel/Net/EthernetFrameHeader.h>
 #include <Kernel/Net/ICMP.h>
@@ -28,6 +31,27 @@ class NetworkAdapter;
 
 using NetworkByteBuffer = AK::Detail::ByteBuffer<1500>;
 
+// Work on an outgoing packet that's left for the adapter to do.
+enum class TransmitOffload : u8 {
+    None = 0,
+    // The IPv4 header checksum is left zeroed.
+    IPv4Checksum = 1 << 0,
+    // The TCP checksum field holds the sum of the pseudo header, leaving out the TCP length if the packet is to be segmented.
+    TCPChecksum = 1 << 1,
+    // The packet is a TCP segment of more than the MSS, to be split up into segments of at most `segment_size` bytes of payload.
+    // Each of the segments gets its own sequence number and checksums, and only the last one keeps PSH and FIN.
+    TCPSegmentation = 1 << 2,
+};
+
+AK_ENUM_BITWISE_OPERATORS(TransmitOffload);
+
+struct PacketOffload {
+    TransmitOffload offloads { TransmitOffload::None };
+    u16 segment_size { 0 };
+
+    bool is_empty() const { return offloads == TransmitOffload::None; }
+};
+
 struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp> {
     PacketWithTimestamp(NonnullOwnPtr<KBuffer> buffer, Time timestamp)
         : buffer(move(buffer))
@@ -39,6 +63,8 @@ struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp>
 
     NonnullOwnPtr<KBuffer> buffer;
     Time timestamp;
+    // What the adapter is asked to do when sending the packet. This stays with the packet, so that it's sent the same way when it's retransmitted.
+    PacketOffload offload;
     IntrusiveListNode<PacketWithTimestamp, LockRefPtr<PacketWithTimestamp>> packet_node;
 };
 
@@ -71,7 +97,8 @@ public:
     void send(MACAddress const&, ARPPacket const&);
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, IPv4Protocol, size_t, u8 type_of_service, u8 ttl);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp);
+    // The packet stays valid for as long as someone holds on to it, so sockets can queue it up as it is.
+    LockRefPtr<PacketWithTimestamp> dequeue_packet();
 
     bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
 
@@ -83,6 +110,9 @@ public:
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
 
+    // Packet buffers come from a pool that every adapter keeps for itself, so that sending and receiving don't
+    // have to allocate once the pool has grown large enough. A packet that someone else still holds on to isn't
+    // put back into the pool, it's up to whoever lets go of it last to release it.
     LockRefPtr<PacketWithTimestamp> acquire_packet_buffer(size_t);
     void release_packet_buffer(PacketWithTimestamp&);
 
@@ -91,15 +121,40 @@ public:
 
     Function<void()> on_receive;
 
-    void send_packet(ReadonlyBytes);
+    // Drivers that support polling mask their receive interrupts and call schedule_receive_poll()
+    // instead of draining the receive ring from their interrupt handler. The network task then calls
+    // run_receive_poll() until the ring is empty, and the receive interrupts get unmasked again.
+    bool is_receive_poll_scheduled() const { return m_receive_poll_scheduled; }
+    // Returns true if the budget was exhausted, and there may be more packets waiting.
+    bool run_receive_poll(size_t budget);
+    Function<void()> on_receive_poll_scheduled;
+
+    // Adapters that can do some of the work on outgoing packets themselves override this, and send_raw_with_offload().
+    // Whatever is asked of an adapter that it can't do is done in software instead.
+    virtual TransmitOffload supported_transmit_offloads() const { return TransmitOffload::None; }
+    // The IPv4 length field limits how large a TCP segment that's handed to the adapter for segmentation can get.
+    static constexpr size_t maximum_segmentation_offload_size = NumericLimits<u16>::max();
+
+    // Packets may be sent by any number of threads at once, but drivers only ever see one at a time.
+    void send_packet(ReadonlyBytes, PacketOffload const& = {});
 
 protected:
     NetworkAdapter(NonnullOwnPtr<KString>);
     void set_mac_address(MACAddress const& mac_address) { m_mac_address = mac_address; }
     void did_receive(ReadonlyBytes);
     virtual void send_raw(ReadonlyBytes) = 0;
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) { VERIFY_NOT_REACHED(); }
+
+    void schedule_receive_poll();
+    // Passes up to `budget` packets from the receive ring to did_receive(), and returns how many there were.
+    virtual size_t poll_receive([[maybe_unused]] size_t budget) { return 0; }
+    virtual void enable_receive_interrupts() { }
 
 private:
+    void send_with_software_offload(ReadonlyBytes, PacketOffload const&);
+
+    Mutex m_transmit_lock { "NetworkAdapter transmit"sv };
+
     MACAddress m_mac_address;
     IPv4Address m_ipv4_address;
     IPv4Address m_ipv4_netmask;
@@ -118,6 +173,7 @@ private:
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
+    Atomic<bool> m_receive_poll_scheduled { false };
 };
 
 }
@@ -4,6 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CircularQueue.h>
+#include <AK/HashFunctions.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/MutexProtected.h>
@@ -25,20 +28,51 @@
 
 namespace Kernel {
 
+// Received packets are spread over one worker per processor, by hashing the addresses and ports they're sent from and to,
+// so that all packets of a connection are handled by the same worker, in the order they came in.
+// The network task itself is the first worker. It's also the only one that takes packets from the adapters.
+struct ReceiveWorker {
+    struct QueuedFrame {
+        LockRefPtr<NetworkAdapter> adapter;
+        LockRefPtr<PacketWithTimestamp> packet;
+    };
+
+    Thread* thread { nullptr };
+    SpinlockProtected<CircularQueue<QueuedFrame, 256>> queue { LockRank::None };
+    WaitQueue wait_queue;
+    // Only ever touched by the worker itself.
+    HashTable<LockRefPtr<TCPSocket>> delayed_ack_sockets;
+};
+
+// The frame that's being handled, the adapter it came in on, and the worker handling it.
+// Sockets that queue up packets hold on to the frame rather than copying it.
+struct ReceivedFrame {
+    NetworkAdapter& adapter;
+    PacketWithTimestamp& packet;
+    ReceiveWorker& worker;
+};
+
+static void handle_frame(ReceivedFrame const&);
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size);
-static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, Time const& packet_timestamp);
-static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, Time const& packet_timestamp);
-static void handle_udp(IPv4Packet const&, Time const& packet_timestamp);
-static void handle_tcp(IPv4Packet const&, Time const& packet_timestamp);
-static void send_delayed_tcp_ack(LockRefPtr<TCPSocket> socket);
+static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, ReceivedFrame const&);
+static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, ReceivedFrame const&);
+static void handle_udp(IPv4Packet const&, ReceivedFrame const&);
+static void handle_tcp(IPv4Packet const&, ReceivedFrame const&);
+static void send_delayed_tcp_ack(ReceiveWorker&, LockRefPtr<TCPSocket> socket);
 static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, LockRefPtr<NetworkAdapter> adapter);
-static void flush_delayed_tcp_acks();
+static void flush_delayed_tcp_acks(ReceiveWorker&);
 static void retransmit_tcp_packets();
 
-static Thread* network_task = nullptr;
-static HashTable<LockRefPtr<TCPSocket>>* delayed_ack_sockets;
+// How many packets we take from an adapter's receive ring before giving the others a turn.
+static constexpr size_t receive_poll_budget = 64;
+
+static constexpr size_t maximum_receive_workers = 8;
+
+static Array<ReceiveWorker*, maximum_receive_workers> s_receive_workers;
+static size_t s_receive_worker_count = 0;
 
 [[noreturn]] static void NetworkTask_main(void*);
+[[noreturn]] static void receive_worker_main(ReceiveWorker&);
 
 void NetworkTask::spawn()
 {
@@ -46,21 +80,93 @@ void NetworkTask::spawn()
     auto name = KString::try_create("Network Task"sv);
     if (name.is_error())
         TODO();
-    (void)Process::create_kernel_process(thread, name.release_value(), NetworkTask_main, nullptr);
-    network_task = thread;
+
+    // With only one processor, there's nobody to hand packets off to, and the network task handles all of them itself.
+    s_receive_worker_count = min<size_t>(Processor::count(), maximum_receive_workers);
+    for (size_t i = 0; i < s_receive_worker_count; ++i)
+        s_receive_workers[i] = new ReceiveWorker;
+
+    // The network task is worker 0, so it's pinned to the first processor just like the others are to theirs.
+    (void)Process::create_kernel_process(thread, name.release_value(), NetworkTask_main, nullptr, 1u << 0);
+    s_receive_workers[0]->thread = thread;
+
+    for (size_t i = 1; i < s_receive_worker_count; ++i) {
+        auto& worker = *s_receive_workers[i];
+        LockRefPtr<Thread> worker_thread;
+        auto worker_name = KString::formatted("Network Task #{}", i);
+        if (worker_name.is_error())
+            TODO();
+        (void)Process::create_kernel_process(
+            worker_thread, worker_name.release_value(), [&worker] { receive_worker_main(worker); }, 1u << i);
+        worker.thread = worker_thread;
+    }
 }
 
 bool NetworkTask::is_current()
 {
-    return Thread::current() == network_task;
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < s_receive_worker_count; ++i) {
+        if (s_receive_workers[i]->thread == current_thread)
+            return true;
+    }
+    return false;
+}
+
+// Packets that don't belong to a connection (ARP, and anything that isn't IPv4) are all handled by the network task.
+static size_t receive_worker_index_for(PacketWithTimestamp const& packet)
+{
+    if (s_receive_worker_count == 1)
+        return 0;
+
+    auto bytes = packet.buffer->bytes();
+    if (bytes.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return 0;
+    auto& eth = *(EthernetFrameHeader const*)bytes.data();
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+
+    auto& ipv4_packet = *(IPv4Packet const*)eth.payload();
+    auto hash = pair_int_hash(ipv4_packet.source().to_u32(), ipv4_packet.destination().to_u32());
+
+    // Fragments other than the first one don't have the ports in them, so no fragment gets to use them.
+    auto protocol = (IPv4Protocol)ipv4_packet.protocol();
+    auto ports_offset = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
+    if ((protocol == IPv4Protocol::TCP || protocol == IPv4Protocol::UDP) && !ipv4_packet.is_a_fragment() && bytes.size() >= ports_offset + sizeof(u32)) {
+        // Both TCP and UDP start with the source and destination port.
+        u32 ports;
+        __builtin_memcpy(&ports, bytes.offset(ports_offset), sizeof(ports));
+        hash = pair_int_hash(hash, ports);
+    }
+    return hash % s_receive_worker_count;
+}
+
+void receive_worker_main(ReceiveWorker& worker)
+{
+    for (;;) {
+        flush_delayed_tcp_acks(worker);
+        auto frame = worker.queue.with([](auto& queue) -> Optional<ReceiveWorker::QueuedFrame> {
+            if (queue.is_empty())
+                return {};
+            return queue.dequeue();
+        });
+        if (!frame.has_value()) {
+            auto timeout_time = Time::from_milliseconds(500);
+            auto timeout = Thread::BlockTimeout { false, &timeout_time };
+            [[maybe_unused]] auto result = worker.wait_queue.wait_on(timeout, "NetworkTask"sv);
+            continue;
+        }
+        handle_frame({ *frame->adapter, *frame->packet, worker });
+        frame->adapter->release_packet_buffer(*frame->packet);
+    }
 }
 
 void NetworkTask_main(void*)
 {
-    delayed_ack_sockets = new HashTable<LockRefPtr<TCPSocket>>;
+    auto& worker = *s_receive_workers[0];
 
     WaitQueue packet_wait_queue;
     int pending_packets = 0;
+    Atomic<bool> receive_poll_pending { false };
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -73,60 +179,97 @@ void NetworkTask_main(void*)
             pending_packets++;
             packet_wait_queue.wake_all();
         };
+        adapter.on_receive_poll_scheduled = [&]() {
+            receive_poll_pending = true;
+            packet_wait_queue.wake_all();
+        };
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, Time& packet_timestamp) -> size_t {
+    auto run_receive_polls = [&receive_poll_pending]() {
+        if (!receive_poll_pending.exchange(false))
+            return false;
+        NetworkingManagement::the().for_each([&](auto& adapter) {
+            if (adapter.is_receive_poll_scheduled() && adapter.run_receive_poll(receive_poll_budget))
+                receive_poll_pending = true;
+        });
+        return true;
+    };
+
+    LockRefPtr<NetworkAdapter> receiving_adapter;
+    auto dequeue_packet = [&pending_packets, &receiving_adapter]() -> LockRefPtr<PacketWithTimestamp> {
         if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
+            return {};
+        LockRefPtr<PacketWithTimestamp> packet;
         NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
+            if (packet || !adapter.has_queued_packets())
                 return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
+            packet = adapter.dequeue_packet();
+            receiving_adapter = adapter;
             pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet ? packet->buffer->size() : 0);
         });
-        return packet_size;
+        return packet;
     };
 
-    size_t buffer_size = 64 * KiB;
-    auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
-    if (region_or_error.is_error())
-        TODO();
-    auto buffer_region = region_or_error.release_value();
-    auto buffer = (u8*)buffer_region->vaddr().get();
-    Time packet_timestamp;
-
     for (;;) {
-        flush_delayed_tcp_acks();
+        flush_delayed_tcp_acks(worker);
         retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
+        auto packet = dequeue_packet();
+        // Only go back to the adapters once we're done with what we already took from them.
+        if (!packet && run_receive_polls())
+            packet = dequeue_packet();
+        if (!packet) {
             auto timeout_time = Time::from_milliseconds(500);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
             [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
             continue;
         }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
+        auto worker_index = receive_worker_index_for(*packet);
+        if (worker_index != 0) {
+            auto& other_worker = *s_receive_workers[worker_index];
+            bool was_queued = other_worker.queue.with([&](auto& queue) {
+                if (queue.size() == queue.capacity())
+                    return false;
+                queue.enqueue(ReceiveWorker::QueuedFrame { receiving_adapter, move(packet) });
+                return true;
+            });
+            if (was_queued) {
+                other_worker.wait_queue.wake_one();
+                continue;
+            }
+            // The worker can't keep up, so the packet is dropped just like it would have been had the receive ring overflowed.
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dropping packet from {}, worker #{} is busy", receiving_adapter->name(), worker_index);
+            receiving_adapter->release_packet_buffer(*packet);
             continue;
         }
-        auto& eth = *(EthernetFrameHeader const*)buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
-            break;
-        case EtherType::IPv6:
-            // ignore
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
-        }
+        // The packet is handled right where the adapter put it.
+        handle_frame({ *receiving_adapter, *packet, worker });
+        receiving_adapter->release_packet_buffer(*packet);
+    }
+}
+
+void handle_frame(ReceivedFrame const& frame)
+{
+    size_t frame_size = frame.packet.buffer->size();
+    if (frame_size < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", frame_size);
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)frame.packet.buffer->data();
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), frame_size);
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, frame_size);
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, frame_size, frame);
+        break;
+    case EtherType::IPv6:
+        // ignore
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
     }
 }
 
@@ -178,7 +321,7 @@ void handle_arp(EthernetFrameHeader const& eth, size_t frame_size)
     }
 }
 
-void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, Time const& packet_timestamp)
+void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, ReceivedFrame const& frame)
 {
     constexpr size_t minimum_ipv4_frame_size = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
     if (frame_size < minimum_ipv4_frame_size) {
@@ -212,18 +355,18 @@ void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, Time const&
 
     switch ((IPv4Protocol)packet.protocol()) {
     case IPv4Protocol::ICMP:
-        return handle_icmp(eth, packet, packet_timestamp);
+        return handle_icmp(eth, packet, frame);
     case IPv4Protocol::UDP:
-        return handle_udp(packet, packet_timestamp);
+        return handle_udp(packet, frame);
     case IPv4Protocol::TCP:
-        return handle_tcp(packet, packet_timestamp);
+        return handle_tcp(packet, frame);
     default:
         dbgln_if(IPV4_DEBUG, "handle_ipv4: Unhandled protocol {:#02x}", packet.protocol());
         break;
     }
 }
 
-void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
+void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet, ReceivedFrame const& frame)
 {
     auto& icmp_header = *static_cast<ICMPHeader const*>(ipv4_packet.payload());
     dbgln_if(ICMP_DEBUG, "handle_icmp: source={}, destination={}, type={:#02x}, code={:#02x}", ipv4_packet.source().to_string(), ipv4_packet.destination().to_string(), icmp_header.type(), icmp_header.code());
@@ -237,7 +380,7 @@ void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet,
             }
         });
         for (auto& socket : icmp_sockets)
-            socket.did_receive(ipv4_packet.source(), 0, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+            socket.did_receive(ipv4_packet.source(), 0, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, frame.adapter, frame.packet);
     }
 
     auto adapter = NetworkingManagement::the().from_ipv4_address(ipv4_packet.destination());
@@ -274,7 +417,7 @@ void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet,
     }
 }
 
-void handle_udp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
+void handle_udp(IPv4Packet const& ipv4_packet, ReceivedFrame const& frame)
 {
     if (ipv4_packet.payload_size() < sizeof(UDPPacket)) {
         dbgln("handle_udp: Packet too small ({}, need {})", ipv4_packet.payload_size(), sizeof(UDPPacket));
@@ -299,10 +442,10 @@ void handle_udp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
     auto& destination = ipv4_packet.destination();
 
     if (destination == IPv4Address(255, 255, 255, 255) || NetworkingManagement::the().from_ipv4_address(destination) || socket->multicast_memberships().contains_slow(destination))
-        socket->did_receive(ipv4_packet.source(), udp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+        socket->did_receive(ipv4_packet.source(), udp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, frame.adapter, frame.packet);
 }
 
-void send_delayed_tcp_ack(LockRefPtr<TCPSocket> socket)
+void send_delayed_tcp_ack(ReceiveWorker& worker, LockRefPtr<TCPSocket> socket)
 {
     VERIFY(socket->mutex().is_locked());
     if (!socket->should_delay_next_ack()) {
@@ -310,13 +453,14 @@ void send_delayed_tcp_ack(LockRefPtr<TCPSocket> socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    worker.delayed_ack_sockets.set(move(socket));
 }
 
-void flush_delayed_tcp_acks()
+void flush_delayed_tcp_acks(ReceiveWorker& worker)
 {
+    auto& delayed_ack_sockets = worker.delayed_ack_sockets;
     Vector<LockRefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : delayed_ack_sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(socket));
@@ -325,12 +469,12 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
+    if (remaining_sockets.size() != delayed_ack_sockets.size()) {
+        delayed_ack_sockets.clear();
         if (remaining_sockets.size() > 0)
             dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
         for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
+            delayed_ack_sockets.set(move(socket));
     }
 }
 
@@ -368,7 +512,7 @@ void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, Lo
     routing_decision.adapter->release_packet_buffer(*packet);
 }
 
-void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
+void handle_tcp(IPv4Packet const& ipv4_packet, ReceivedFrame const& frame)
 {
     if (ipv4_packet.payload_size() < sizeof(TCPPacket)) {
         dbgln("handle_tcp: IPv4 payload is too small to be a TCP packet ({}, need {})", ipv4_packet.payload_size(), sizeof(TCPPacket));
@@ -459,6 +603,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->apply_syn_options(tcp_packet);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
             return;
@@ -472,11 +617,13 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
         switch (tcp_packet.flags()) {
         case TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->apply_syn_options(tcp_packet);
             (void)socket->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             socket->set_state(TCPSocket::State::SynReceived);
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->apply_syn_options(tcp_packet);
             (void)socket->send_ack(true);
             socket->set_state(TCPSocket::State::Established);
             socket->set_setup_state(Socket::SetupState::Completed);
@@ -484,7 +631,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
             return;
         case TCPFlags::ACK | TCPFlags::FIN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
-            send_delayed_tcp_ack(socket);
+            send_delayed_tcp_ack(frame.worker, socket);
             socket->set_state(TCPSocket::State::Closed);
             socket->set_error(TCPSocket::Error::FINDuringConnect);
             socket->set_setup_state(Socket::SetupState::Completed);
@@ -633,21 +780,21 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
 
         if (tcp_packet.has_fin()) {
             if (payload_size != 0)
-                socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+                socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, frame.adapter, frame.packet);
 
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
-            send_delayed_tcp_ack(socket);
+            send_delayed_tcp_ack(frame.worker, socket);
             socket->set_state(TCPSocket::State::CloseWait);
             socket->set_connected(false);
             return;
         }
 
         if (payload_size) {
-            if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp)) {
+            if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, frame.adapter, frame.packet)) {
                 socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
                 dbgln_if(TCP_DEBUG, "Got packet with ack_no={}, seq_no={}, payload_size={}, acking it with new ack_no={}, seq_no={}",
                     tcp_packet.ack_number(), tcp_packet.sequence_number(), payload_size, socket->ack_number(), socket->sequence_number());
-                send_delayed_tcp_ack(socket);
+                send_delayed_tcp_ack(frame.worker, socket);
             }
         }
     }
@@ -82,6 +82,9 @@ namespace Kernel {
 #define INT_RX_FIFO_OVERFLOW 0x40
 #define INT_SYS_ERR 0x8000
 
+// These are masked while the network task is polling the receive ring.
+#define RECEIVE_INTERRUPTS (INT_RXOK | INT_RX_OVERFLOW | INT_RX_FIFO_OVERFLOW)
+
 #define CFG9346_NONE 0x00
 #define CFG9346_EEM0 0x40
 #define CFG9346_EEM1 0x80
@@ -393,12 +396,13 @@ void RTL8168NetworkAdapter::startup()
     start_hardware();
 
     // re-enable interrupts
-    auto enabled_interrupts = INT_RXOK | INT_RXERR | INT_TXOK | INT_TXERR | INT_RX_OVERFLOW | INT_LINK_CHANGE | INT_SYS_ERR;
+    m_enabled_interrupts = INT_RXOK | INT_RXERR | INT_TXOK | INT_TXERR | INT_RX_OVERFLOW | INT_LINK_CHANGE | INT_SYS_ERR;
     if (m_version == ChipVersion::Version1) {
-        enabled_interrupts |= INT_RX_FIFO_OVERFLOW;
-        enabled_interrupts &= ~INT_RX_OVERFLOW;
+        m_enabled_interrupts |= INT_RX_FIFO_OVERFLOW;
+        m_enabled_interrupts &= ~INT_RX_OVERFLOW;
     }
-    out16(REG_IMR, enabled_interrupts);
+    out16(REG_IMR, m_enabled_interrupts);
+    m_receive_interrupts_masked = false;
 
     // update link status
     m_link_up = (in8(REG_PHYSTATUS) & PHY_LINK_STATUS) != 0;
@@ -1139,13 +1143,16 @@ bool RTL8168NetworkAdapter::handle_irq(RegisterState const&)
 
         dbgln_if(RTL8168_DEBUG, "RTL8168: handle_irq status={:#04x}", status);
 
+        // The status bits of masked interrupts still get set, but we're not supposed to act on them.
+        if (m_receive_interrupts_masked)
+            status &= ~RECEIVE_INTERRUPTS;
+
         if ((status & (INT_RXOK | INT_RXERR | INT_TXOK | INT_TXERR | INT_RX_OVERFLOW | INT_LINK_CHANGE | INT_RX_FIFO_OVERFLOW | INT_SYS_ERR)) == 0)
             break;
 
         was_handled = true;
         if (status & INT_RXOK) {
             dbgln_if(RTL8168_DEBUG, "RTL8168: RX ready");
-            receive();
         }
         if (status & INT_RXERR) {
             dbgln_if(RTL8168_DEBUG, "RTL8168: RX error - invalid packet");
@@ -1159,7 +1166,6 @@ bool RTL8168NetworkAdapter::handle_irq(RegisterState const&)
         }
         if (status & INT_RX_OVERFLOW) {
             dmesgln("RTL8168: RX descriptor unavailable (packet lost)");
-            receive();
         }
         if (status & INT_LINK_CHANGE) {
             m_link_up = (in8(REG_PHYSTATUS) & PHY_LINK_STATUS) != 0;
@@ -1167,11 +1173,16 @@ bool RTL8168NetworkAdapter::handle_irq(RegisterState const&)
         }
         if (status & INT_RX_FIFO_OVERFLOW) {
             dmesgln("RTL8168: RX FIFO overflow");
-            receive();
         }
         if (status & INT_SYS_ERR) {
             dmesgln("RTL8168: Fatal system error");
         }
+        if (status & RECEIVE_INTERRUPTS) {
+            // Leave the receive ring to the network task, and don't interrupt us again until it's empty.
+            m_receive_interrupts_masked = true;
+            out16(REG_IMR, m_enabled_interrupts & ~RECEIVE_INTERRUPTS);
+            schedule_receive_poll();
+        }
     }
     return was_handled;
 }
@@ -1222,17 +1233,16 @@ void RTL8168NetworkAdapter::send_raw(ReadonlyBytes payload)
     out8(REG_TXSTART, TXSTART_START); // FIXME: this shouldn't be done so often, we should look into doing this using the watchdog timer
 }
 
-void RTL8168NetworkAdapter::receive()
+size_t RTL8168NetworkAdapter::poll_receive(size_t budget)
 {
     auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
-    for (u16 i = 0; i < number_of_rx_descriptors; ++i) {
-        auto descriptor_index = (m_rx_free_index + i) % number_of_rx_descriptors;
+    size_t received = 0;
+    for (; received < budget; ++received) {
+        auto descriptor_index = m_rx_free_index;
         auto& descriptor = rx_descriptors[descriptor_index];
 
-        if ((descriptor.flags & RXDescriptor::Ownership) != 0) {
-            m_rx_free_index = descriptor_index;
+        if ((descriptor.flags & RXDescriptor::Ownership) != 0)
             break;
-        }
 
         u16 flags = descriptor.flags;
         u16 length = descriptor.buffer_size & 0x3FFF;
@@ -1254,7 +1264,15 @@ void RTL8168NetworkAdapter::receive()
         if (descriptor_index == number_of_rx_descriptors - 1)
             flags |= RXDescriptor::EndOfRing;
         descriptor.flags = flags; // let the NIC know it can use this descriptor again
+        m_rx_free_index = (descriptor_index + 1) % number_of_rx_descriptors;
     }
+    return received;
+}
+
+void RTL8168NetworkAdapter::enable_receive_interrupts()
+{
+    m_receive_interrupts_masked = false;
+    out16(REG_IMR, m_enabled_interrupts);
 }
 
 void RTL8168NetworkAdapter::out8(u16 address, u8 data)
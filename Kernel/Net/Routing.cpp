@@ -16,8 +16,8 @@
 
 namespace Kernel {
 
-static Singleton<SpinlockProtected<HashMap<IPv4Address, MACAddress>>> s_arp_table;
-static Singleton<SpinlockProtected<Route::RouteList>> s_routing_table;
+static Singleton<RWSpinlockProtected<HashMap<IPv4Address, MACAddress>>> s_arp_table;
+static Singleton<RCUProtected<Route::RouteList>> s_routing_table;
 
 class ARPTableBlocker final : public Thread::Blocker {
 public:
@@ -71,7 +71,7 @@ protected:
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::Routing);
         auto& blocker = static_cast<ARPTableBlocker&>(b);
-        auto maybe_mac_address = arp_table().with([&](auto const& table) -> auto{
+        auto maybe_mac_address = arp_table().with_shared([&](auto const& table) -> auto{
             return table.get(blocker.ip_address());
         });
         if (!maybe_mac_address.has_value())
@@ -95,7 +95,7 @@ bool ARPTableBlocker::setup_blocker()
 
 void ARPTableBlocker::will_unblock_immediately_without_blocking(UnblockImmediatelyReason)
 {
-    auto addr = arp_table().with([&](auto const& table) -> auto{
+    auto addr = arp_table().with_shared([&](auto const& table) -> auto{
         return table.get(ip_address());
     });
 
@@ -106,23 +106,29 @@ void ARPTableBlocker::will_unblock_immediately_without_blocking(UnblockImmediate
     }
 }
 
-SpinlockProtected<HashMap<IPv4Address, MACAddress>>& arp_table()
+RWSpinlockProtected<HashMap<IPv4Address, MACAddress>>& arp_table()
 {
     return *s_arp_table;
 }
 
 void update_arp_table(IPv4Address const& ip_addr, MACAddress const& addr, UpdateTable update)
 {
-    arp_table().with([&](auto& table) {
-        if (update == UpdateTable::Set)
-            table.set(ip_addr, addr);
-        if (update == UpdateTable::Delete)
-            table.remove(ip_addr);
+    // NOTE: Most updates are ARP replies confirming an entry we already have, for which the write lock isn't needed.
+    bool is_up_to_date = update == UpdateTable::Set && arp_table().with_shared([&](auto const& table) {
+        return table.get(ip_addr) == addr;
     });
+    if (!is_up_to_date) {
+        arp_table().with_exclusive([&](auto& table) {
+            if (update == UpdateTable::Set)
+                table.set(ip_addr, addr);
+            if (update == UpdateTable::Delete)
+                table.remove(ip_addr);
+        });
+    }
     s_arp_table_blocker_set->unblock_blockers_waiting_for_ipv4_address(ip_addr, addr);
 
     if constexpr (ARP_DEBUG) {
-        arp_table().with([&](auto const& table) {
+        arp_table().with_shared([&](auto const& table) {
             dmesgln("ARP table ({} entries):", table.size());
             for (auto& it : table)
                 dmesgln("{} :: {}", it.value.to_string(), it.key.to_string());
@@ -130,7 +136,7 @@ void update_arp_table(IPv4Address const& ip_addr, MACAddress const& addr, Update
     }
 }
 
-SpinlockProtected<Route::RouteList>& routing_table()
+RCUProtected<Route::RouteList>& routing_table()
 {
     return *s_routing_table;
 }
@@ -143,29 +149,34 @@ ErrorOr<void> update_routing_table(IPv4Address const& destination, IPv4Address c
     if (!route_entry)
         return ENOMEM;
 
-    TRY(routing_table().with([&](auto& table) -> ErrorOr<void> {
+    return routing_table().update([&](auto const& table) -> ErrorOr<NonnullOwnPtr<Route::RouteList>> {
+        auto new_table = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Route::RouteList));
         if (update == UpdateTable::Set) {
             for (auto const& route : table) {
-                if (route == *route_entry)
+                if (*route == *route_entry)
                     return EEXIST;
             }
-            table.append(*route_entry);
+            TRY(new_table->try_ensure_capacity(table.size() + 1));
+            new_table->unchecked_append(table.data(), table.size());
+            new_table->unchecked_append(route_entry.release_nonnull());
         }
         if (update == UpdateTable::Delete) {
-            for (auto& route : table) {
-                dbgln_if(ROUTING_DEBUG, "candidate: {} {} {} {} {}", route.destination, route.gateway, route.netmask, route.flags, route.adapter);
-                if (route.matches(*route_entry)) {
-                    // FIXME: Remove all entries, not only the first one.
-                    table.remove(route);
-                    return {};
+            TRY(new_table->try_ensure_capacity(table.size()));
+            bool did_remove = false;
+            for (auto const& route : table) {
+                dbgln_if(ROUTING_DEBUG, "candidate: {} {} {} {} {}", route->destination, route->gateway, route->netmask, route->flags, route->adapter);
+                // FIXME: Remove all entries, not only the first one.
+                if (!did_remove && route->matches(*route_entry)) {
+                    did_remove = true;
+                    continue;
                 }
+                new_table->unchecked_append(route);
             }
-            return ESRCH;
+            if (!did_remove)
+                return ESRCH;
         }
-        return {};
-    }));
-
-    return {};
+        return new_table;
+    });
 }
 
 bool RoutingDecision::is_zero() const
@@ -223,34 +234,37 @@ RoutingDecision route_to(IPv4Address const& target, IPv4Address const& source, L
     });
 
     u32 longest_prefix_match = 0;
-    routing_table().for_each([&target_addr, &matches, &longest_prefix_match, &chosen_route](auto& route) {
-        auto route_addr = route.destination.to_u32();
-        auto route_mask = route.netmask.to_u32();
-
-        if (route_addr == 0 && matches(*route.adapter)) {
-            dbgln_if(ROUTING_DEBUG, "Resorting to default route found for adapter: {}", route.adapter->name());
-            chosen_route = route;
-        }
+    routing_table().with_read([&](auto const& table) {
+        for (auto const& route_ptr : table) {
+            auto& route = *route_ptr;
+            auto route_addr = route.destination.to_u32();
+            auto route_mask = route.netmask.to_u32();
+
+            if (route_addr == 0 && matches(*route.adapter)) {
+                dbgln_if(ROUTING_DEBUG, "Resorting to default route found for adapter: {}", route.adapter->name());
+                chosen_route = route;
+            }
 
-        // We have a direct match and we can exit the routing table earlier.
-        if (target_addr == route_addr) {
-            dbgln_if(ROUTING_DEBUG, "Target address has a direct match in the routing table");
-            chosen_route = route;
-            return;
-        }
+            // We have a direct match and we can exit the routing table earlier.
+            if (target_addr == route_addr) {
+                dbgln_if(ROUTING_DEBUG, "Target address has a direct match in the routing table");
+                chosen_route = route;
+                continue;
+            }
 
-        if ((target_addr & route_mask) == (route_addr & route_mask) && (route_addr != 0)) {
-            auto prefix = (target_addr & (route_addr & route_mask));
+            if ((target_addr & route_mask) == (route_addr & route_mask) && (route_addr != 0)) {
+                auto prefix = (target_addr & (route_addr & route_mask));
 
-            if (chosen_route && prefix == longest_prefix_match) {
-                chosen_route = (route.netmask.to_u32() > chosen_route->netmask.to_u32()) ? route : chosen_route;
-                dbgln_if(ROUTING_DEBUG, "Found a matching prefix match. Using longer netmask: {}", chosen_route->netmask);
-            }
+                if (chosen_route && prefix == longest_prefix_match) {
+                    chosen_route = (route.netmask.to_u32() > chosen_route->netmask.to_u32()) ? route : chosen_route;
+                    dbgln_if(ROUTING_DEBUG, "Found a matching prefix match. Using longer netmask: {}", chosen_route->netmask);
+                }
 
-            if (prefix > longest_prefix_match) {
-                dbgln_if(ROUTING_DEBUG, "Found a longer prefix match - route: {}, netmask: {}", route.destination.to_string(), route.netmask);
-                longest_prefix_match = prefix;
-                chosen_route = route;
+                if (prefix > longest_prefix_match) {
+                    dbgln_if(ROUTING_DEBUG, "Found a longer prefix match - route: {}, netmask: {}", route.destination.to_string(), route.netmask);
+                    longest_prefix_match = prefix;
+                    chosen_route = route;
+                }
             }
         }
     });
@@ -301,7 +315,7 @@ RoutingDecision route_to(IPv4Address const& target, IPv4Address const& source, L
         return { adapter, multicast_ethernet_address(target) };
 
     {
-        auto addr = arp_table().with([&](auto const& table) -> auto{
+        auto addr = arp_table().with_shared([&](auto const& table) -> auto{
             return table.get(next_hop_ip);
         });
         if (addr.has_value()) {
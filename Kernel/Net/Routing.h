@@ -7,8 +7,11 @@
 #pragma once
 
 #include <AK/IPv4Address.h>
+#include <AK/Vector.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/RCU.h>
+#include <Kernel/Locking/RWSpinlockProtected.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Thread.h>
 
@@ -40,8 +43,7 @@ struct Route final : public AtomicRefCounted<Route> {
     const u16 flags;
     NonnullLockRefPtr<NetworkAdapter> adapter;
 
-    IntrusiveListNode<Route, LockRefPtr<Route>> route_list_node {};
-    using RouteList = IntrusiveList<&Route::route_list_node>;
+    using RouteList = Vector<NonnullLockRefPtr<Route>>;
 };
 
 struct RoutingDecision {
@@ -66,7 +68,9 @@ enum class AllowUsingGateway {
 
 RoutingDecision route_to(IPv4Address const& target, IPv4Address const& source, LockRefPtr<NetworkAdapter> const through = nullptr, AllowUsingGateway = AllowUsingGateway::Yes);
 
-SpinlockProtected<HashMap<IPv4Address, MACAddress>>& arp_table();
-SpinlockProtected<Route::RouteList>& routing_table();
+// NOTE: Both tables are looked at for every packet we send, but rarely change.
+//       The routing table is protected by RCU, so looking at it never has to wait for anyone.
+RWSpinlockProtected<HashMap<IPv4Address, MACAddress>>& arp_table();
+RCUProtected<Route::RouteList>& routing_table();
 
 }
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/HashFunctions.h>
+#include <AK/Traits.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/RCU.h>
+
+namespace Kernel {
+
+// A map from addresses to sockets that's looked up for every incoming packet.
+// Lookups don't take any lock. They walk the buckets under RCU, so packets for different connections never wait for
+// each other, nor for a socket being created or destroyed somewhere else. Changes are made under a lock per shard.
+// A removed entry is only freed after a grace period, so a lookup that's still looking at it never sees freed memory.
+// Anything that has to be looked at as a whole, like the list of sockets in /proc/net, goes through the shards one by one.
+template<typename K, typename V, size_t ShardCount = 64, size_t BucketsPerShard = 16>
+class SocketTable {
+    AK_MAKE_NONCOPYABLE(SocketTable);
+    AK_MAKE_NONMOVABLE(SocketTable);
+
+public:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+    class Shard {
+        AK_MAKE_NONCOPYABLE(Shard);
+        AK_MAKE_NONMOVABLE(Shard);
+
+    public:
+        Shard() = default;
+
+        ~Shard()
+        {
+            for (auto& bucket : m_buckets) {
+                for (auto* node = bucket.load(AK::MemoryOrder::memory_order_relaxed); node;) {
+                    auto* next = node->next.load(AK::MemoryOrder::memory_order_relaxed);
+                    delete node;
+                    node = next;
+                }
+            }
+        }
+
+        bool contains(K const& key) const { return find(key) != nullptr; }
+
+        V const* find(K const& key) const
+        {
+            for (auto* node = bucket_for(key).load(AK::MemoryOrder::memory_order_consume); node; node = node->next.load(AK::MemoryOrder::memory_order_consume)) {
+                if (Traits<K>::equals(node->entry.key, key))
+                    return &node->entry.value;
+            }
+            return nullptr;
+        }
+
+        ErrorOr<void> try_set(K const& key, V value)
+        {
+            VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+            auto* node = new (nothrow) Node { { key, move(value) }, {} };
+            if (!node)
+                return ENOMEM;
+            (void)remove(key);
+            auto& bucket = bucket_for(key);
+            node->next.store(bucket.load(AK::MemoryOrder::memory_order_relaxed), AK::MemoryOrder::memory_order_relaxed);
+            // Publishes the entry only once it's all written.
+            bucket.store(node, AK::MemoryOrder::memory_order_release);
+            return {};
+        }
+
+        void set(K const& key, V value) { MUST(try_set(key, move(value))); }
+
+        // NOTE: This waits for a grace period before freeing the entry, so it may block.
+        bool remove(K const& key)
+        {
+            VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+            Atomic<Node*>* link = &bucket_for(key);
+            for (auto* node = link->load(AK::MemoryOrder::memory_order_relaxed); node; node = link->load(AK::MemoryOrder::memory_order_relaxed)) {
+                if (Traits<K>::equals(node->entry.key, key)) {
+                    link->store(node->next.load(AK::MemoryOrder::memory_order_relaxed), AK::MemoryOrder::memory_order_release);
+                    RCU::synchronize();
+                    delete node;
+                    return true;
+                }
+                link = &node->next;
+            }
+            return false;
+        }
+
+        template<typename Callback>
+        void for_each(Callback callback) const
+        {
+            for (auto& bucket : m_buckets) {
+                for (auto* node = bucket.load(AK::MemoryOrder::memory_order_acquire); node; node = node->next.load(AK::MemoryOrder::memory_order_acquire))
+                    callback(node->entry);
+            }
+        }
+
+        template<typename Callback>
+        ErrorOr<void> try_for_each(Callback callback) const
+        {
+            for (auto& bucket : m_buckets) {
+                for (auto* node = bucket.load(AK::MemoryOrder::memory_order_acquire); node; node = node->next.load(AK::MemoryOrder::memory_order_acquire))
+                    TRY(callback(node->entry));
+            }
+            return {};
+        }
+
+    private:
+        friend class SocketTable;
+
+        struct Node {
+            Entry entry;
+            Atomic<Node*> next;
+        };
+
+        Atomic<Node*>& bucket_for(K const& key) { return m_buckets[bucket_index_for(key)]; }
+        Atomic<Node*> const& bucket_for(K const& key) const { return m_buckets[bucket_index_for(key)]; }
+
+        Array<Atomic<Node*>, BucketsPerShard> m_buckets {};
+        mutable Mutex m_lock { "SocketTable"sv };
+    };
+
+    SocketTable() = default;
+
+    // Looks up the key without taking any lock, and calls the callback with its value, or nullptr if there's none.
+    // The callback runs in an RCU read-side critical section, so it must not block. The socket may be in the middle
+    // of being destroyed, so anything that's kept past the callback needs a reference taken with try_ref().
+    template<typename Callback>
+    decltype(auto) with_read(K const& key, Callback callback) const
+    {
+        RCU::ReadLocker locker;
+        return callback(shard_for(key).find(key));
+    }
+
+    // Changes are serialized with each other (and the walks below) per shard, and may block.
+    template<typename Callback>
+    decltype(auto) with_exclusive(K const& key, Callback callback, LockLocation const& location = LockLocation::current())
+    {
+        auto& shard = shard_for(key);
+        MutexLocker locker(shard.m_lock, Mutex::Mode::Exclusive, location);
+        return callback(shard);
+    }
+
+    // NOTE: The walks hold the lock of the shard they're in, so no entry in it can be removed (and its socket can't go
+    //       away) while the callback looks at it, and the callback may block.
+    template<typename Callback>
+    void for_each(Callback callback) const
+    {
+        for (auto& shard : m_shards) {
+            MutexLocker locker(shard.m_lock);
+            shard.for_each(callback);
+        }
+    }
+
+    template<typename Callback>
+    ErrorOr<void> try_for_each(Callback callback) const
+    {
+        for (auto& shard : m_shards) {
+            MutexLocker locker(shard.m_lock);
+            TRY(shard.try_for_each(callback));
+        }
+        return {};
+    }
+
+private:
+    Shard& shard_for(K const& key) { return m_shards[shard_index_for(key)]; }
+    Shard const& shard_for(K const& key) const { return m_shards[shard_index_for(key)]; }
+
+    // The key's hash is mixed again, so that keys that only differ in a few bits still end up spread over everything.
+    static u32 mixed_hash_for(K const& key) { return int_hash(Traits<K>::hash(key)); }
+    static size_t shard_index_for(K const& key) { return mixed_hash_for(key) % ShardCount; }
+    static size_t bucket_index_for(K const& key) { return (mixed_hash_for(key) / ShardCount) % BucketsPerShard; }
+
+    Array<Shard, ShardCount> m_shards;
+};
+
+}
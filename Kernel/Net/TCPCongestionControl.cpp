@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create_default(size_t mss)
+{
+    return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPNewReno(mss)));
+}
+
+TCPCongestionControl::TCPCongestionControl(size_t mss)
+{
+    reset(mss);
+}
+
+void TCPCongestionControl::reset(size_t mss)
+{
+    m_mss = mss;
+    // RFC 6928: The initial window is min(10 * MSS, max(2 * MSS, 14600)).
+    m_congestion_window = min(10 * mss, max(2 * mss, static_cast<size_t>(14600)));
+    m_slow_start_threshold = NumericLimits<size_t>::max();
+}
+
+static size_t slow_start_threshold_after_loss(size_t bytes_in_flight, size_t mss)
+{
+    // RFC 5681 (4): ssthresh = max(FlightSize / 2, 2 * SMSS)
+    return max(bytes_in_flight / 2, 2 * mss);
+}
+
+void TCPNewReno::on_ack(size_t bytes_acked)
+{
+    if (m_congestion_window < m_slow_start_threshold) {
+        // Slow start: Grow by at most one segment for every ACK (RFC 5681 (2)).
+        m_congestion_window += min(bytes_acked, m_mss);
+        return;
+    }
+
+    // Congestion avoidance: Grow by one segment for every window's worth of acknowledged data (RFC 5681 3.1).
+    m_bytes_acked_in_congestion_avoidance += bytes_acked;
+    if (m_bytes_acked_in_congestion_avoidance >= m_congestion_window) {
+        m_bytes_acked_in_congestion_avoidance -= m_congestion_window;
+        m_congestion_window += m_mss;
+    }
+}
+
+void TCPNewReno::on_enter_fast_recovery(size_t bytes_in_flight)
+{
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, m_mss);
+    // The three duplicate ACKs mean that three segments have left the network.
+    m_congestion_window = m_slow_start_threshold + 3 * m_mss;
+    m_bytes_acked_in_congestion_avoidance = 0;
+}
+
+void TCPNewReno::on_duplicate_ack_in_recovery()
+{
+    m_congestion_window += m_mss;
+}
+
+void TCPNewReno::on_partial_ack(size_t bytes_acked)
+{
+    // RFC 6582 3.2 (5): Deflate the window by the amount of new data acknowledged, then add back one segment.
+    m_congestion_window -= min(m_congestion_window, bytes_acked);
+    if (bytes_acked >= m_mss)
+        m_congestion_window += m_mss;
+    m_congestion_window = max(m_congestion_window, m_mss);
+}
+
+void TCPNewReno::on_exit_fast_recovery(size_t bytes_in_flight)
+{
+    // RFC 6582 3.2 (6): Deflate the window, but avoid a burst of data.
+    m_congestion_window = min(m_slow_start_threshold, max(bytes_in_flight, m_mss) + m_mss);
+}
+
+void TCPNewReno::on_retransmit_timeout(size_t bytes_in_flight)
+{
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, m_mss);
+    // RFC 5681 (4): The loss window is one segment.
+    m_congestion_window = m_mss;
+    m_bytes_acked_in_congestion_avoidance = 0;
+}
+
+}
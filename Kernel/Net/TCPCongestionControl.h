@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/OwnPtr.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// Decides how much data a TCPSocket may have in flight. The socket takes care of detecting
+// loss and retransmitting, and tells the algorithm about it through these hooks.
+class TCPCongestionControl {
+public:
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create_default(size_t mss);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual StringView name() const = 0;
+
+    // New data has been acknowledged outside of fast recovery.
+    virtual void on_ack(size_t bytes_acked) = 0;
+    // Three duplicate ACKs have been received, and the first unacknowledged segment is being retransmitted.
+    virtual void on_enter_fast_recovery(size_t bytes_in_flight) = 0;
+    // Another duplicate ACK has arrived while in fast recovery.
+    virtual void on_duplicate_ack_in_recovery() = 0;
+    // Some, but not all of the data that was outstanding when fast recovery started has been acknowledged.
+    virtual void on_partial_ack(size_t bytes_acked) = 0;
+    // All the data that was outstanding when fast recovery started has been acknowledged.
+    virtual void on_exit_fast_recovery(size_t bytes_in_flight) = 0;
+    // The retransmission timer expired.
+    virtual void on_retransmit_timeout(size_t bytes_in_flight) = 0;
+
+    size_t congestion_window() const { return m_congestion_window; }
+    size_t slow_start_threshold() const { return m_slow_start_threshold; }
+    size_t mss() const { return m_mss; }
+
+    // Starts over with the initial window for the given segment size, e.g. once the MSS has been negotiated.
+    void reset(size_t mss);
+
+protected:
+    explicit TCPCongestionControl(size_t mss);
+
+    size_t m_mss { 0 };
+    size_t m_congestion_window { 0 };
+    size_t m_slow_start_threshold { 0 };
+};
+
+// RFC 5681 slow start and congestion avoidance, with the RFC 6582 fast recovery modifications.
+class TCPNewReno final : public TCPCongestionControl {
+public:
+    explicit TCPNewReno(size_t mss)
+        : TCPCongestionControl(mss)
+    {
+    }
+
+    virtual StringView name() const override { return "newreno"sv; }
+
+    virtual void on_ack(size_t bytes_acked) override;
+    virtual void on_enter_fast_recovery(size_t bytes_in_flight) override;
+    virtual void on_duplicate_ack_in_recovery() override;
+    virtual void on_partial_ack(size_t bytes_acked) override;
+    virtual void on_exit_fast_recovery(size_t bytes_in_flight) override;
+    virtual void on_retransmit_timeout(size_t bytes_in_flight) override;
+
+private:
+    size_t m_bytes_acked_in_congestion_avoidance { 0 };
+};
+
+}
@@ -22,25 +22,29 @@
 
 namespace Kernel {
 
+// Sequence numbers wrap around, so they have to be compared relative to each other.
+static bool sequence_number_is_at_or_before(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) <= 0;
+}
+
 void TCPSocket::for_each(Function<void(TCPSocket const&)> callback)
 {
-    sockets_by_tuple().for_each_shared([&](auto const& it) {
+    sockets_by_tuple().for_each([&](auto const& it) {
         callback(*it.value);
     });
 }
 
 ErrorOr<void> TCPSocket::try_for_each(Function<ErrorOr<void>(TCPSocket const&)> callback)
 {
-    return sockets_by_tuple().with_shared([&](auto const& sockets) -> ErrorOr<void> {
-        for (auto& it : sockets)
-            TRY(callback(*it.value));
-        return {};
+    return sockets_by_tuple().try_for_each([&](auto const& it) -> ErrorOr<void> {
+        return callback(*it.value);
     });
 }
 
 bool TCPSocket::unref() const
 {
-    bool did_hit_zero = sockets_by_tuple().with_exclusive([&](auto& table) {
+    bool did_hit_zero = sockets_by_tuple().with_exclusive(tuple(), [&](auto& table) {
         if (deref_base())
             return false;
         table.remove(tuple());
@@ -76,7 +80,7 @@ void TCPSocket::set_state(State new_state)
     }
 
     if (new_state == State::Closed) {
-        closing_sockets().with_exclusive([&](auto& table) {
+        closing_sockets().with_exclusive(tuple(), [&](auto& table) {
             table.remove(tuple());
         });
 
@@ -88,44 +92,44 @@ void TCPSocket::set_state(State new_state)
         evaluate_block_conditions();
 }
 
-static Singleton<MutexProtected<HashMap<IPv4SocketTuple, LockRefPtr<TCPSocket>>>> s_socket_closing;
+static Singleton<SocketTable<IPv4SocketTuple, LockRefPtr<TCPSocket>>> s_socket_closing;
 
-MutexProtected<HashMap<IPv4SocketTuple, LockRefPtr<TCPSocket>>>& TCPSocket::closing_sockets()
+SocketTable<IPv4SocketTuple, LockRefPtr<TCPSocket>>& TCPSocket::closing_sockets()
 {
     return *s_socket_closing;
 }
 
-static Singleton<MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>> s_socket_tuples;
+static Singleton<SocketTable<IPv4SocketTuple, TCPSocket*>> s_socket_tuples;
 
-MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& TCPSocket::sockets_by_tuple()
+SocketTable<IPv4SocketTuple, TCPSocket*>& TCPSocket::sockets_by_tuple()
 {
     return *s_socket_tuples;
 }
 
 LockRefPtr<TCPSocket> TCPSocket::from_tuple(IPv4SocketTuple const& tuple)
 {
-    return sockets_by_tuple().with_shared([&](auto const& table) -> LockRefPtr<TCPSocket> {
-        auto exact_match = table.get(tuple);
-        if (exact_match.has_value())
-            return { *exact_match.value() };
+    auto find = [](IPv4SocketTuple const& tuple) {
+        return sockets_by_tuple().with_read(tuple, [&](TCPSocket* const* match) -> LockRefPtr<TCPSocket> {
+            // NOTE: The socket may be on its way out, in which case unref() is waiting for us to be done to remove it.
+            if (!match || !(*match)->try_ref())
+                return {};
+            return adopt_lock_ref(**match);
+        });
+    };
 
-        auto address_tuple = IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0);
-        auto address_match = table.get(address_tuple);
-        if (address_match.has_value())
-            return { *address_match.value() };
+    if (auto exact_match = find(tuple))
+        return exact_match;
 
-        auto wildcard_tuple = IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0);
-        auto wildcard_match = table.get(wildcard_tuple);
-        if (wildcard_match.has_value())
-            return { *wildcard_match.value() };
+    // Nobody's connected from there yet, so it has to be for someone who's listening.
+    if (auto address_match = find(IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0)))
+        return address_match;
 
-        return {};
-    });
+    return find(IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0));
 }
 ErrorOr<NonnullLockRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const& new_local_address, u16 new_local_port, IPv4Address const& new_peer_address, u16 new_peer_port)
 {
     auto tuple = IPv4SocketTuple(new_local_address, new_local_port, new_peer_address, new_peer_port);
-    return sockets_by_tuple().with_exclusive([&](auto& table) -> ErrorOr<NonnullLockRefPtr<TCPSocket>> {
+    return sockets_by_tuple().with_exclusive(tuple, [&](auto& table) -> ErrorOr<NonnullLockRefPtr<TCPSocket>> {
         if (table.contains(tuple))
             return EEXIST;
 
@@ -162,8 +166,9 @@ void TCPSocket::release_for_accept(NonnullLockRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer)
-    : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
+    : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer))
+    , m_congestion_control(move(congestion_control))
 {
     m_last_retransmit_time = kgettimeofday();
 }
@@ -177,9 +182,8 @@ TCPSocket::~TCPSocket()
 
 ErrorOr<NonnullLockRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
 {
-    // Note: Scratch buffer is only used for SOCK_STREAM sockets.
-    auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
-    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer)));
+    auto congestion_control = TRY(TCPCongestionControl::try_create_default(default_mss));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(congestion_control)));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -205,8 +209,18 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), bound_interface());
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-    data_length = min(data_length, mss);
+    auto mss = send_mss(routing_decision);
+    data_length = min(data_length, maximum_segment_size_for_sending(routing_decision));
+
+    // Don't put more on the wire than the peer and the network can take. With nothing in flight,
+    // we send a segment regardless, which doubles as a probe for a closed window.
+    auto in_flight = m_unacked_packets.with_shared([](auto const& unacked_packets) { return bytes_in_flight(unacked_packets); });
+    auto send_window = effective_send_window();
+    if (in_flight > 0 && in_flight < send_window)
+        data_length = min(data_length, send_window - in_flight);
+    else if (in_flight == 0)
+        data_length = min(data_length, max(mss, send_window));
+
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
@@ -226,13 +240,33 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    bool const has_mss_option = flags == TCPFlags::SYN;
-    const size_t options_size = has_mss_option ? sizeof(TCPOptionMSS) : 0;
+    // When initiating a connection we offer window scaling and SACK, and when accepting one
+    // we only agree to them if the peer offered them first.
+    bool const is_syn = flags & TCPFlags::SYN;
+    bool const is_initial_syn = is_syn && !(flags & TCPFlags::ACK);
+    bool const has_mss_option = is_syn;
+    bool const has_window_scale_option = is_syn && (is_initial_syn || m_window_scaling_enabled);
+    bool const has_sack_permitted_option = is_syn && (is_initial_syn || m_sack_permitted);
+    if (has_window_scale_option)
+        m_receive_window_scale = receive_window_scale_for_syn();
+
+    const size_t options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0)
+        + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0)
+        + (has_sack_permitted_option ? sizeof(TCPOptionSACKPermitted) : 0);
     const size_t tcp_header_size = sizeof(TCPPacket) + options_size;
     const size_t buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
     if (!packet)
         return set_so_error(ENOMEM);
+    auto supported_offloads = routing_decision.adapter->supported_transmit_offloads();
+    if (payload_size > send_mss(routing_decision)) {
+        VERIFY(has_flag(supported_offloads, TransmitOffload::TCPSegmentation));
+        packet->offload = { TransmitOffload::IPv4Checksum | TransmitOffload::TCPChecksum | TransmitOffload::TCPSegmentation, static_cast<u16>(send_mss(routing_decision)) };
+    } else if (has_flag(supported_offloads, TransmitOffload::TCPChecksum)) {
+        packet->offload.offloads = TransmitOffload::TCPChecksum;
+        if (has_flag(supported_offloads, TransmitOffload::IPv4Checksum))
+            packet->offload.offloads |= TransmitOffload::IPv4Checksum;
+    }
     routing_decision.adapter->fill_in_ipv4_header(*packet, local_address(),
         routing_decision.next_hop, peer_address(), IPv4Protocol::TCP,
         buffer_size - ipv4_payload_offset, type_of_service(), ttl());
@@ -241,7 +275,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
     tcp_packet.set_destination_port(peer_port());
-    tcp_packet.set_window_size(NumericLimits<u16>::max());
+    tcp_packet.set_window_size(advertised_window(is_syn));
     tcp_packet.set_sequence_number(m_sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
@@ -259,26 +293,47 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         tcp_packet.set_ack_number(m_ack_number);
     }
 
+    auto sequence_number = m_sequence_number;
     if (flags & TCPFlags::SYN) {
         ++m_sequence_number;
     } else {
         m_sequence_number += payload_size;
     }
 
+    VERIFY(packet->buffer->size() >= ipv4_payload_offset + tcp_header_size);
+    auto* options = packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket);
     if (has_mss_option) {
         u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
         TCPOptionMSS mss_option { mss };
-        VERIFY(packet->buffer->size() >= ipv4_payload_offset + sizeof(TCPPacket) + sizeof(mss_option));
-        memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
+        memcpy(options, &mss_option, sizeof(mss_option));
+        options += sizeof(mss_option);
+    }
+    if (has_window_scale_option) {
+        TCPOptionWindowScale window_scale_option { m_receive_window_scale };
+        memcpy(options, &window_scale_option, sizeof(window_scale_option));
+        options += sizeof(window_scale_option);
+    }
+    if (has_sack_permitted_option) {
+        TCPOptionSACKPermitted sack_permitted_option;
+        memcpy(options, &sack_permitted_option, sizeof(sack_permitted_option));
     }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    if (has_flag(packet->offload.offloads, TransmitOffload::TCPChecksum)) {
+        // Adapters that segment the packet put in the length of each segment themselves.
+        u16 tcp_length = has_flag(packet->offload.offloads, TransmitOffload::TCPSegmentation) ? 0 : tcp_header_size + payload_size;
+        tcp_packet.set_checksum(compute_tcp_pseudo_header_sum(local_address(), peer_address(), tcp_length));
+    } else {
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    }
 
     bool expect_ack { tcp_packet.has_syn() || payload_size > 0 };
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            // RFC 6298 5.1: Start the retransmission timer if it isn't running already.
+            if (unacked_packets.packets.is_empty())
+                m_last_retransmit_time = kgettimeofday();
+            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter, 0, sequence_number, payload_size });
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
@@ -293,7 +348,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     m_packets_out++;
     m_bytes_out += buffer_size;
-    routing_decision.adapter->send_packet(packet->bytes());
+    routing_decision.adapter->send_packet(packet->bytes(), packet->offload);
     if (!expect_ack)
         routing_decision.adapter->release_packet_buffer(*packet);
 
@@ -302,44 +357,225 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
 void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
-    if (packet.has_ack()) {
-        u32 ack_number = packet.ack_number();
+    if (packet.has_ack())
+        process_ack(packet, size - packet.header_size());
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+    m_packets_in++;
+    m_bytes_in += packet.header_size() + size;
+}
+
+void TCPSocket::process_ack(TCPPacket const& packet, size_t payload_size)
+{
+    u32 ack_number = packet.ack_number();
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+
+    // RFC 7323 2.2: The window field in a SYN segment is never scaled.
+    auto old_send_window_size = m_send_window_size;
+    m_send_window_size = packet.has_syn() ? packet.window_size() : static_cast<u32>(packet.window_size()) << m_send_window_scale;
+    bool should_evaluate_block_conditions = m_send_window_size > old_send_window_size;
+
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (m_sack_permitted)
+            mark_sacked_packets(unacked_packets, packet);
+
+        // RFC 5681 2: An ACK only counts as a duplicate if it carries nothing else.
+        bool is_duplicate_ack = !unacked_packets.packets.is_empty()
+            && payload_size == 0
+            && !packet.has_syn()
+            && !packet.has_fin()
+            && m_send_window_size == old_send_window_size
+            && ack_number == unacked_packets.packets.first().sequence_number;
 
         int removed = 0;
-        m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            while (!unacked_packets.packets.is_empty()) {
-                auto& packet = unacked_packets.packets.first();
-
-                dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
-
-                if (packet.ack_number <= ack_number) {
-                    auto old_adapter = packet.adapter.strong_ref();
-                    if (old_adapter)
-                        old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
-                    unacked_packets.packets.take_first();
-                    removed++;
+        size_t bytes_acked = 0;
+        while (!unacked_packets.packets.is_empty()) {
+            auto& packet = unacked_packets.packets.first();
+
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
+
+            if (!sequence_number_is_at_or_before(packet.ack_number, ack_number))
+                break;
+
+            auto old_adapter = packet.adapter.strong_ref();
+            if (old_adapter)
+                old_adapter->release_packet_buffer(*packet.buffer);
+            unacked_packets.size -= packet.payload_size;
+            bytes_acked += packet.payload_size;
+            unacked_packets.packets.take_first();
+            removed++;
+        }
+
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+
+        if (removed > 0) {
+            should_evaluate_block_conditions = true;
+            m_duplicate_acks_received = 0;
+            // RFC 6298 5.3: Restart the retransmission timer whenever new data is acknowledged.
+            m_retransmit_attempts = 0;
+            m_last_retransmit_time = kgettimeofday();
+
+            if (m_in_fast_recovery) {
+                if (sequence_number_is_at_or_before(m_recovery_point, ack_number)) {
+                    m_in_fast_recovery = false;
+                    m_congestion_control->on_exit_fast_recovery(unacked_packets.size);
                 } else {
-                    break;
+                    // RFC 6582 3.2: A partial ACK means the segment after it got lost as well.
+                    m_congestion_control->on_partial_ack(bytes_acked);
+                    if (!unacked_packets.packets.is_empty() && !unacked_packets.packets.first().sacked)
+                        unacked_packets.packets.first().lost = true;
+                }
+            } else if (bytes_acked > 0) {
+                m_congestion_control->on_ack(bytes_acked);
+            }
+        } else if (is_duplicate_ack) {
+            ++m_duplicate_acks_received;
+            if (m_in_fast_recovery) {
+                m_congestion_control->on_duplicate_ack_in_recovery();
+                should_evaluate_block_conditions = true;
+            } else if (m_duplicate_acks_received == fast_retransmit_threshold) {
+                dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) entering fast recovery at {}", this, ack_number);
+                m_in_fast_recovery = true;
+                m_recovery_point = m_sequence_number;
+                m_congestion_control->on_enter_fast_recovery(unacked_packets.size);
+
+                // The first unacknowledged packet is lost for sure. With SACK, so is every packet
+                // that didn't make it while a later one did (RFC 6675).
+                OutgoingPacket* last_sacked_packet = nullptr;
+                for (auto& outgoing_packet : unacked_packets.packets) {
+                    if (outgoing_packet.sacked)
+                        last_sacked_packet = &outgoing_packet;
+                }
+                for (auto& outgoing_packet : unacked_packets.packets) {
+                    if (&outgoing_packet == last_sacked_packet)
+                        break;
+                    if (!outgoing_packet.sacked)
+                        outgoing_packet.lost = true;
+                    if (!last_sacked_packet)
+                        break;
                 }
             }
+        }
+
+        if (unacked_packets.packets.is_empty()) {
+            m_retransmit_attempts = 0;
+            dequeue_for_retransmit();
+        } else {
+            retransmit_lost_packets(unacked_packets);
+        }
+    });
+
+    if (should_evaluate_block_conditions)
+        evaluate_block_conditions();
+}
 
-            if (unacked_packets.packets.is_empty()) {
-                m_retransmit_attempts = 0;
-                dequeue_for_retransmit();
+void TCPSocket::mark_sacked_packets(UnackedPackets& unacked_packets, TCPPacket const& packet)
+{
+    packet.for_each_option([&](TCPOptionKind kind, ReadonlyBytes data) {
+        if (kind != TCPOptionKind::SACK)
+            return;
+        for (size_t offset = 0; offset + sizeof(TCPSACKBlock) <= data.size(); offset += sizeof(TCPSACKBlock)) {
+            TCPSACKBlock block;
+            memcpy(&block, data.offset_pointer(offset), sizeof(block));
+            u32 left_edge = block.left_edge;
+            u32 right_edge = block.right_edge;
+            for (auto& outgoing_packet : unacked_packets.packets) {
+                if (outgoing_packet.payload_size == 0)
+                    continue;
+                if (sequence_number_is_at_or_before(left_edge, outgoing_packet.sequence_number) && sequence_number_is_at_or_before(outgoing_packet.ack_number, right_edge)) {
+                    outgoing_packet.sacked = true;
+                    outgoing_packet.lost = false;
+                }
             }
+        }
+    });
+}
 
-            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
-        });
+size_t TCPSocket::bytes_in_flight(UnackedPackets const& unacked_packets)
+{
+    // RFC 6675 calls this the pipe: Packets the peer already has, or that we consider lost, don't count.
+    size_t in_flight = unacked_packets.size;
+    for (auto const& packet : unacked_packets.packets) {
+        if (packet.sacked || packet.lost)
+            in_flight -= packet.payload_size;
     }
+    return in_flight;
+}
 
-    m_packets_in++;
-    m_bytes_in += packet.header_size() + size;
+size_t TCPSocket::effective_send_window() const
+{
+    return min<size_t>(m_send_window_size, m_congestion_control->congestion_window());
+}
+
+size_t TCPSocket::send_mss(RoutingDecision const& routing_decision) const
+{
+    size_t adapter_mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    return min<size_t>(adapter_mss, m_send_mss);
+}
+
+size_t TCPSocket::maximum_segment_size_for_sending(RoutingDecision const& routing_decision) const
+{
+    auto mss = send_mss(routing_decision);
+    if (!has_flag(routing_decision.adapter->supported_transmit_offloads(), TransmitOffload::TCPSegmentation))
+        return mss;
+    // Adapters that can segment get handed as much as fits into one IPv4 packet, in whole segments.
+    auto maximum_payload_size = NetworkAdapter::maximum_segmentation_offload_size - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    return max(mss, maximum_payload_size - maximum_payload_size % mss);
+}
+
+u8 TCPSocket::receive_window_scale_for_syn() const
+{
+    // Pick the smallest shift that lets us advertise the whole receive buffer.
+    u8 scale = 0;
+    auto space = receive_buffer_space();
+    while (scale < 14 && (space >> scale) > NumericLimits<u16>::max())
+        ++scale;
+    return scale;
+}
+
+u16 TCPSocket::advertised_window(bool for_syn) const
+{
+    auto space = receive_buffer_space();
+    if (!for_syn && m_window_scaling_enabled)
+        space >>= m_receive_window_scale;
+    return min<size_t>(space, NumericLimits<u16>::max());
+}
+
+void TCPSocket::apply_syn_options(TCPPacket const& packet)
+{
+    VERIFY(packet.has_syn());
+
+    u16 mss = default_mss;
+    Optional<u8> window_scale;
+    bool sack_permitted = false;
+    packet.for_each_option([&](TCPOptionKind kind, ReadonlyBytes data) {
+        switch (kind) {
+        case TCPOptionKind::MSS:
+            if (data.size() == 2 && (data[0] | data[1]) != 0)
+                mss = (data[0] << 8) | data[1];
+            break;
+        case TCPOptionKind::WindowScale:
+            if (data.size() == 1)
+                window_scale = data[0];
+            break;
+        case TCPOptionKind::SACKPermitted:
+            sack_permitted = true;
+            break;
+        default:
+            break;
+        }
+    });
+
+    m_send_mss = mss;
+    m_window_scaling_enabled = window_scale.has_value();
+    // RFC 7323 2.3: Shift counts larger than 14 must be treated as 14.
+    m_send_window_scale = m_window_scaling_enabled ? min(window_scale.value(), static_cast<u8>(14)) : 0;
+    if (!m_window_scaling_enabled)
+        m_receive_window_scale = 0;
+    m_sack_permitted = sack_permitted;
+    m_congestion_control->reset(m_send_mss);
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) peer options: mss={}, window_scale={}, sack_permitted={}", this, m_send_mss, window_scale, m_sack_permitted);
 }
 
 bool TCPSocket::should_delay_next_ack() const
@@ -358,7 +594,7 @@ bool TCPSocket::should_delay_next_ack() const
     return true;
 }
 
-NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+static u32 sum_of_tcp_pseudo_header(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length)
 {
     struct [[gnu::packed]] PseudoHeader {
         IPv4Address source;
@@ -368,7 +604,7 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
         NetworkOrdered<u16> payload_size;
     };
 
-    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, packet.header_size() + payload_size };
+    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, tcp_length };
 
     u32 checksum = 0;
     auto raw_pseudo_header = bit_cast<u16*>(&pseudo_header);
@@ -377,6 +613,18 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
         if (checksum > 0xffff)
             checksum = (checksum >> 16) + (checksum & 0xffff);
     }
+    return checksum;
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_pseudo_header_sum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length)
+{
+    // Unlike the checksum, this is not complemented, as the adapter adds the rest of the packet to it.
+    return sum_of_tcp_pseudo_header(source, destination, tcp_length);
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+{
+    u32 checksum = sum_of_tcp_pseudo_header(source, destination, packet.header_size() + payload_size);
     auto raw_packet = bit_cast<u16*>(&packet);
     for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
         checksum += AK::convert_between_host_and_network_endian(raw_packet[i]);
@@ -413,7 +661,7 @@ ErrorOr<void> TCPSocket::protocol_bind()
 ErrorOr<void> TCPSocket::protocol_listen(bool did_allocate_port)
 {
     if (!did_allocate_port) {
-        bool ok = sockets_by_tuple().with_exclusive([&](auto& table) -> bool {
+        bool ok = sockets_by_tuple().with_exclusive(tuple(), [&](auto& table) -> bool {
             if (table.contains(tuple()))
                 return false;
             table.set(tuple(), this);
@@ -480,24 +728,26 @@ ErrorOr<u16> TCPSocket::protocol_allocate_local_port()
     constexpr u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
     u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-    return sockets_by_tuple().with_exclusive([&](auto& table) -> ErrorOr<u16> {
-        for (u16 port = first_scan_port;;) {
-            IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
+    for (u16 port = first_scan_port;;) {
+        IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
 
-            auto it = table.find(proposed_tuple);
-            if (it == table.end()) {
-                set_local_port(port);
-                table.set(proposed_tuple, this);
-                return port;
-            }
-            ++port;
-            if (port > last_ephemeral_port)
-                port = first_ephemeral_port;
-            if (port == first_scan_port)
-                break;
-        }
-        return set_so_error(EADDRINUSE);
-    });
+        bool did_claim_port = sockets_by_tuple().with_exclusive(proposed_tuple, [&](auto& table) {
+            if (table.contains(proposed_tuple))
+                return false;
+            set_local_port(port);
+            table.set(proposed_tuple, this);
+            return true;
+        });
+        if (did_claim_port)
+            return port;
+
+        ++port;
+        if (port > last_ephemeral_port)
+            port = first_ephemeral_port;
+        if (port == first_scan_port)
+            break;
+    }
+    return set_so_error(EADDRINUSE);
 }
 
 bool TCPSocket::protocol_is_disconnected() const
@@ -538,7 +788,7 @@ ErrorOr<void> TCPSocket::close()
     }
 
     if (state() != State::Closed && state() != State::Listen)
-        closing_sockets().with_exclusive([&](auto& table) {
+        closing_sockets().with_exclusive(tuple(), [&](auto& table) {
             table.set(tuple(), *this);
         });
     return result;
@@ -590,46 +840,75 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
-    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
-    if (routing_decision.is_zero())
-        return;
-
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        m_congestion_control->on_retransmit_timeout(unacked_packets.size);
+        m_in_fast_recovery = false;
+        m_duplicate_acks_received = 0;
+        // RFC 2018 8: The peer is allowed to drop data it has SACKed, so after a timeout, start over from the first packet.
         for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
-
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+            packet.sacked = false;
+            packet.lost = true;
+        }
+        retransmit_lost_packets(unacked_packets);
+    });
+}
 
-            auto packet_buffer = packet.buffer->bytes();
+void TCPSocket::retransmit_lost_packets(UnackedPackets& unacked_packets)
+{
+    if (!unacked_packets.packets.find_if([](auto const& packet) { return packet.lost; }).is_end()) {
+        auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+        if (routing_decision.is_zero())
+            return;
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+        // Retransmissions are bound by the congestion window too, but one of them always gets through.
+        auto in_flight = bytes_in_flight(unacked_packets);
+        auto send_window = effective_send_window();
+        for (auto& packet : unacked_packets.packets) {
+            if (!packet.lost)
+                continue;
+            if (in_flight > 0 && in_flight + packet.payload_size > send_window)
+                break;
+            packet.lost = false;
+            in_flight += packet.payload_size;
+            resend_packet(packet, routing_decision);
         }
-    });
+    }
+}
+
+void TCPSocket::resend_packet(OutgoingPacket& packet, RoutingDecision& routing_decision)
+{
+    packet.tx_counter++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer, packet.buffer->offload);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
 }
 
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
@@ -644,7 +923,7 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
         return true;
 
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        return bytes_in_flight(unacked_packets) < effective_send_window();
     });
 }
 }
@@ -13,6 +13,8 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/SocketTable.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 
 namespace Kernel {
 
@@ -143,12 +145,15 @@ public:
     ErrorOr<void> send_tcp_packet(u16 flags, UserOrKernelBuffer const* = nullptr, size_t = 0, RoutingDecision* = nullptr);
     void receive_tcp_packet(TCPPacket const&, u16 size);
 
+    // Picks up the MSS, window scale and SACK options from the peer's SYN.
+    void apply_syn_options(TCPPacket const&);
+
     bool should_delay_next_ack() const;
 
-    static MutexProtected<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
+    static SocketTable<IPv4SocketTuple, TCPSocket*>& sockets_by_tuple();
     static LockRefPtr<TCPSocket> from_tuple(IPv4SocketTuple const& tuple);
 
-    static MutexProtected<HashMap<IPv4SocketTuple, LockRefPtr<TCPSocket>>>& closing_sockets();
+    static SocketTable<IPv4SocketTuple, LockRefPtr<TCPSocket>>& closing_sockets();
 
     ErrorOr<NonnullLockRefPtr<TCPSocket>> try_create_client(IPv4Address const& local_address, u16 local_port, IPv4Address const& peer_address, u16 peer_port);
     void set_originator(TCPSocket& originator) { m_originator = originator; }
@@ -163,12 +168,14 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override;
 
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
+    // What goes into the checksum field of packets whose checksum is left for the adapter to compute.
+    static NetworkOrdered<u16> compute_tcp_pseudo_header_sum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length);
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -185,6 +192,20 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    struct UnackedPackets;
+    struct OutgoingPacket;
+
+    size_t send_mss(RoutingDecision const&) const;
+    size_t maximum_segment_size_for_sending(RoutingDecision const&) const;
+    size_t effective_send_window() const;
+    static size_t bytes_in_flight(UnackedPackets const&);
+    void process_ack(TCPPacket const&, size_t payload_size);
+    void mark_sacked_packets(UnackedPackets&, TCPPacket const&);
+    void retransmit_lost_packets(UnackedPackets&);
+    void resend_packet(OutgoingPacket&, RoutingDecision&);
+    u8 receive_window_scale_for_syn() const;
+    u16 advertised_window(bool for_syn) const;
+
     LockWeakPtr<TCPSocket> m_originator;
     HashMap<IPv4SocketTuple, NonnullLockRefPtr<TCPSocket>> m_pending_release_for_accept;
     Direction m_direction { Direction::Unspecified };
@@ -199,11 +220,18 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        // The sequence number right after this packet, i.e. the ACK number that acknowledges it.
         u32 ack_number { 0 };
         LockRefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
         int tx_counter { 0 };
+        u32 sequence_number { 0 };
+        size_t payload_size { 0 };
+        // The peer told us it received this packet, even though it can't acknowledge it yet.
+        bool sacked { false };
+        // We believe this packet got lost, and it's waiting for the congestion window to let it be sent again.
+        bool lost { false };
     };
 
     struct UnackedPackets {
@@ -223,9 +251,26 @@ private:
     Time m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
 
-    // FIXME: Parse window size TCP option from the peer
+    // The window the peer advertised in its latest segment, already scaled.
     u32 m_send_window_size { 64 * KiB };
 
+    // RFC 879: The MSS we have to assume if the peer doesn't tell us otherwise.
+    static constexpr u16 default_mss = 536;
+    u16 m_send_mss { default_mss };
+    // RFC 7323: Window scaling is only in effect if both sides sent the option in their SYN.
+    bool m_window_scaling_enabled { false };
+    u8 m_send_window_scale { 0 };
+    u8 m_receive_window_scale { 0 };
+    bool m_sack_permitted { false };
+
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+    // Duplicate ACKs received from the peer, as opposed to m_duplicate_acks, which counts the ones we've sent.
+    u32 m_duplicate_acks_received { 0 };
+    static constexpr u32 fast_retransmit_threshold = 3;
+    bool m_in_fast_recovery { false };
+    // Fast recovery is over once everything up to this point has been acknowledged.
+    u32 m_recovery_point { 0 };
+
     IntrusiveListNode<TCPSocket> m_retransmit_list_node;
 
 public:
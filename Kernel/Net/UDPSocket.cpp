@@ -17,45 +17,43 @@ namespace Kernel {
 
 void UDPSocket::for_each(Function<void(UDPSocket const&)> callback)
 {
-    sockets_by_port().for_each_shared([&](auto const& socket) {
+    sockets_by_port().for_each([&](auto const& socket) {
         callback(*socket.value);
     });
 }
 
 ErrorOr<void> UDPSocket::try_for_each(Function<ErrorOr<void>(UDPSocket const&)> callback)
 {
-    return sockets_by_port().with_shared([&](auto const& sockets) -> ErrorOr<void> {
-        for (auto& socket : sockets)
-            TRY(callback(*socket.value));
-        return {};
+    return sockets_by_port().try_for_each([&](auto const& socket) -> ErrorOr<void> {
+        return callback(*socket.value);
     });
 }
 
-static Singleton<MutexProtected<HashMap<u16, UDPSocket*>>> s_map;
+static Singleton<SocketTable<u16, UDPSocket*>> s_map;
 
-MutexProtected<HashMap<u16, UDPSocket*>>& UDPSocket::sockets_by_port()
+SocketTable<u16, UDPSocket*>& UDPSocket::sockets_by_port()
 {
     return *s_map;
 }
 
 LockRefPtr<UDPSocket> UDPSocket::from_port(u16 port)
 {
-    return sockets_by_port().with_shared([&](auto const& table) -> LockRefPtr<UDPSocket> {
-        auto it = table.find(port);
-        if (it == table.end())
+    return sockets_by_port().with_read(port, [&](UDPSocket* const* socket) -> LockRefPtr<UDPSocket> {
+        // NOTE: The socket may already be in its destructor, waiting for us to be done to remove itself.
+        if (!socket || !(*socket)->try_ref())
             return {};
-        return (*it).value;
+        return adopt_lock_ref(**socket);
     });
 }
 
 UDPSocket::UDPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
-    : IPv4Socket(SOCK_DGRAM, protocol, move(receive_buffer), {})
+    : IPv4Socket(SOCK_DGRAM, protocol, move(receive_buffer))
 {
 }
 
 UDPSocket::~UDPSocket()
 {
-    sockets_by_port().with_exclusive([&](auto& table) {
+    sockets_by_port().with_exclusive(local_port(), [&](auto& table) {
         table.remove(local_port());
     });
 }
@@ -119,27 +117,29 @@ ErrorOr<u16> UDPSocket::protocol_allocate_local_port()
     constexpr u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
     u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-    return sockets_by_port().with_exclusive([&](auto& table) -> ErrorOr<u16> {
-        for (u16 port = first_scan_port;;) {
-            auto it = table.find(port);
-            if (it == table.end()) {
-                set_local_port(port);
-                table.set(port, this);
-                return port;
-            }
-            ++port;
-            if (port > last_ephemeral_port)
-                port = first_ephemeral_port;
-            if (port == first_scan_port)
-                break;
-        }
-        return set_so_error(EADDRINUSE);
-    });
+    for (u16 port = first_scan_port;;) {
+        bool did_claim_port = sockets_by_port().with_exclusive(port, [&](auto& table) {
+            if (table.contains(port))
+                return false;
+            set_local_port(port);
+            table.set(port, this);
+            return true;
+        });
+        if (did_claim_port)
+            return port;
+
+        ++port;
+        if (port > last_ephemeral_port)
+            port = first_ephemeral_port;
+        if (port == first_scan_port)
+            break;
+    }
+    return set_so_error(EADDRINUSE);
 }
 
 ErrorOr<void> UDPSocket::protocol_bind()
 {
-    return sockets_by_port().with_exclusive([&](auto& table) -> ErrorOr<void> {
+    return sockets_by_port().with_exclusive(local_port(), [&](auto& table) -> ErrorOr<void> {
         if (table.contains(local_port()))
             return set_so_error(EADDRINUSE);
         table.set(local_port(), this);
@@ -17,8 +17,9 @@
 
 namespace Kernel {
 
-PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer)
+PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer, WhenFull when_full)
     : m_buffer(move(buffer))
+    , m_when_full(when_full)
 {
 }
 
@@ -74,7 +75,7 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
 ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, ThreadID tid,
     FlatPtr ip, FlatPtr bp, int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, StringView arg3, FlatPtr arg4, u64 arg5, ErrorOr<FlatPtr> arg6)
 {
-    if (count() >= capacity())
+    if (count() >= capacity() && m_when_full == WhenFull::Fail)
         return ENOBUFS;
 
     if ((g_profiling_event_mask & type) == 0)
@@ -165,6 +166,19 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
         event.data.read.start_timestamp = arg5;
         event.data.read.success = !arg6.is_error();
         break;
+    case PERF_EVENT_LOCK_WAIT:
+        event.data.lock_wait.lock = arg1;
+        event.data.lock_wait.wait_time_ns = arg5;
+        memset(event.data.lock_wait.name, 0, sizeof(event.data.lock_wait.name));
+        if (!arg3.is_empty())
+            memcpy(event.data.lock_wait.name, arg3.characters_without_null_termination(), min(arg3.length(), sizeof(event.data.lock_wait.name) - 1));
+        break;
+    case PERF_EVENT_CPU_CYCLES:
+    case PERF_EVENT_INSTRUCTIONS_RETIRED:
+    case PERF_EVENT_CACHE_MISSES:
+    case PERF_EVENT_BRANCH_MISSES:
+        event.data.performance_counter.period = arg5;
+        break;
     default:
         return EINVAL;
     }
@@ -176,6 +190,17 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
     event.pid = pid.value();
     event.tid = tid.value();
     event.timestamp = TimeManagement::the().uptime_ms();
+    return append_event(event);
+}
+
+ErrorOr<void> PerformanceEventBuffer::append_event(PerformanceEvent const& event)
+{
+    if (count() >= capacity()) {
+        if (m_when_full == WhenFull::Fail || capacity() == 0)
+            return ENOBUFS;
+        m_first = (m_first + 1) % capacity();
+        --m_count;
+    }
     at(m_count++) = event;
     return {};
 }
@@ -184,7 +209,7 @@ PerformanceEvent& PerformanceEventBuffer::at(size_t index)
 {
     VERIFY(index < capacity());
     auto* events = reinterpret_cast<PerformanceEvent*>(m_buffer->data());
-    return events[index];
+    return events[(m_first + index) % capacity()];
 }
 
 template<typename Serializer>
@@ -296,6 +321,28 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
             TRY(event_object.add("start_timestamp"sv, event.data.read.start_timestamp));
             TRY(event_object.add("success"sv, event.data.read.success));
             break;
+        case PERF_EVENT_LOCK_WAIT:
+            TRY(event_object.add("type"sv, "lock_wait"));
+            TRY(event_object.add("lock"sv, show_kernel_addresses ? event.data.lock_wait.lock : 0xdeadc0de));
+            TRY(event_object.add("wait_time_ns"sv, event.data.lock_wait.wait_time_ns));
+            TRY(event_object.add("name"sv, event.data.lock_wait.name));
+            break;
+        case PERF_EVENT_CPU_CYCLES:
+            TRY(event_object.add("type"sv, "cpu_cycles"));
+            TRY(event_object.add("period"sv, event.data.performance_counter.period));
+            break;
+        case PERF_EVENT_INSTRUCTIONS_RETIRED:
+            TRY(event_object.add("type"sv, "instructions_retired"));
+            TRY(event_object.add("period"sv, event.data.performance_counter.period));
+            break;
+        case PERF_EVENT_CACHE_MISSES:
+            TRY(event_object.add("type"sv, "cache_misses"));
+            TRY(event_object.add("period"sv, event.data.performance_counter.period));
+            break;
+        case PERF_EVENT_BRANCH_MISSES:
+            TRY(event_object.add("type"sv, "branch_misses"));
+            TRY(event_object.add("period"sv, event.data.performance_counter.period));
+            break;
         }
         TRY(event_object.add("pid"sv, event.pid));
         TRY(event_object.add("tid"sv, event.tid));
@@ -324,12 +371,12 @@ ErrorOr<void> PerformanceEventBuffer::to_json(KBufferBuilder& builder) const
     return to_json_impl(object);
 }
 
-OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_with_size(size_t buffer_size)
+OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_with_size(size_t buffer_size, WhenFull when_full)
 {
     auto buffer_or_error = KBuffer::try_create_with_size("Performance events"sv, buffer_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow);
     if (buffer_or_error.is_error())
         return {};
-    return adopt_own_if_nonnull(new (nothrow) PerformanceEventBuffer(buffer_or_error.release_value()));
+    return adopt_own_if_nonnull(new (nothrow) PerformanceEventBuffer(buffer_or_error.release_value(), when_full));
 }
 
 ErrorOr<void> PerformanceEventBuffer::add_process(Process const& process, ProcessEventType event_type)
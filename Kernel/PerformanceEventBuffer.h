@@ -76,6 +76,16 @@ struct [[gnu::packed]] ReadPerformanceEvent {
     bool success;
 };
 
+struct [[gnu::packed]] LockWaitPerformanceEvent {
+    FlatPtr lock;
+    u64 wait_time_ns;
+    char name[32];
+};
+
+struct [[gnu::packed]] PerformanceCounterPerformanceEvent {
+    u64 period;
+};
+
 struct [[gnu::packed]] PerformanceEvent {
     u32 type { 0 };
     u8 stack_size { 0 };
@@ -96,6 +106,8 @@ struct [[gnu::packed]] PerformanceEvent {
         KFreePerformanceEvent kfree;
         SignpostPerformanceEvent signpost;
         ReadPerformanceEvent read;
+        LockWaitPerformanceEvent lock_wait;
+        PerformanceCounterPerformanceEvent performance_counter;
     } data;
     static constexpr size_t max_stack_frame_count = 64;
     FlatPtr stack[max_stack_frame_count];
@@ -108,7 +120,13 @@ enum class ProcessEventType {
 
 class PerformanceEventBuffer {
 public:
-    static OwnPtr<PerformanceEventBuffer> try_create_with_size(size_t buffer_size);
+    enum class WhenFull {
+        Fail,
+        // Keeps the most recent events, which is what the continuous profiler wants.
+        OverwriteOldest,
+    };
+
+    static OwnPtr<PerformanceEventBuffer> try_create_with_size(size_t buffer_size, WhenFull = WhenFull::Fail);
 
     ErrorOr<void> append(int type, FlatPtr arg1, FlatPtr arg2, StringView arg3, Thread* current_thread = Thread::current(), FlatPtr arg4 = 0, u64 arg5 = 0, ErrorOr<FlatPtr> arg6 = 0);
     ErrorOr<void> append_with_ip_and_bp(ProcessID pid, ThreadID tid, FlatPtr eip, FlatPtr ebp,
@@ -116,8 +134,11 @@ public:
     ErrorOr<void> append_with_ip_and_bp(ProcessID pid, ThreadID tid, RegisterState const& regs,
         int type, u32 lost_samples, FlatPtr arg1, FlatPtr arg2, StringView arg3, FlatPtr arg4 = 0, u64 arg5 = {}, ErrorOr<FlatPtr> arg6 = 0);
 
+    ErrorOr<void> append_event(PerformanceEvent const&);
+
     void clear()
     {
+        m_first = 0;
         m_count = 0;
     }
 
@@ -135,15 +156,18 @@ public:
     ErrorOr<FlatPtr> register_string(NonnullOwnPtr<KString>);
 
 private:
-    explicit PerformanceEventBuffer(NonnullOwnPtr<KBuffer>);
+    PerformanceEventBuffer(NonnullOwnPtr<KBuffer>, WhenFull);
 
     template<typename Serializer>
     ErrorOr<void> to_json_impl(Serializer&) const;
 
     PerformanceEvent& at(size_t index);
 
+    // The events are stored in a ring, the oldest one is at m_first.
+    size_t m_first { 0 };
     size_t m_count { 0 };
     NonnullOwnPtr<KBuffer> m_buffer;
+    WhenFull m_when_full { WhenFull::Fail };
 
     HashMap<NonnullOwnPtr<KString>, size_t> m_strings;
 };
@@ -66,6 +66,16 @@ public:
         }
     }
 
+    inline static void add_performance_counter_event(Thread& current_thread, RegisterState const& regs, int type, u64 period)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto rc = event_buffer->append_with_ip_and_bp(
+                current_thread.pid(), current_thread.tid(), regs, type, 0, 0, 0, {}, 0, period);
+        }
+    }
+
     inline static void add_mmap_perf_event(Process& current_process, Memory::Region const& region)
     {
         if (auto* event_buffer = current_process.current_perf_events_buffer()) {
@@ -161,6 +171,20 @@ public:
         [[maybe_unused]] auto rc = event_buffer->append(PERF_EVENT_READ, fd, size, {}, &thread, filepath_string_index, start_timestamp, result); // wrong arguments
     }
 
+    inline static bool wants_lock_wait_events()
+    {
+        return (g_profiling_event_mask & PERF_EVENT_LOCK_WAIT) != 0;
+    }
+
+    inline static void add_lock_wait_event(Thread& thread, Mutex const& mutex, u64 wait_time_ns)
+    {
+        if (thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto rc = event_buffer->append(PERF_EVENT_LOCK_WAIT, FlatPtr(&mutex), 0, mutex.name(), &thread, 0, wait_time_ns);
+        }
+    }
+
     inline static void timer_tick(RegisterState const& regs)
     {
         static Time last_wakeup;
@@ -5,12 +5,15 @@
  */
 
 #include <AK/BuiltinWrappers.h>
+#include <AK/Optional.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
 #include <Kernel/Arch/TrapFrame.h>
+#include <Kernel/ContinuousProfiler.h>
 #include <Kernel/Debug.h>
 #include <Kernel/InterruptDisabler.h>
+#include <Kernel/Locking/RCU.h>
 #include <Kernel/Panic.h>
 #include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
@@ -44,9 +47,83 @@ struct ThreadReadyQueues {
     u32 mask {};
     static constexpr size_t count = sizeof(mask) * 8;
     Array<ThreadReadyQueue, count> queues;
+    u32 thread_count { 0 };
+
+    Thread* find_runnable_thread(u32 affinity_mask)
+    {
+        auto priority_mask = mask;
+        while (priority_mask != 0) {
+            auto priority = bit_scan_forward(priority_mask);
+            VERIFY(priority > 0);
+            auto& ready_queue = queues[--priority];
+            for (auto& thread : ready_queue.thread_list) {
+                VERIFY(thread.m_runnable_priority == (int)priority);
+                if (thread.is_active())
+                    continue;
+                if (!(thread.affinity() & affinity_mask))
+                    continue;
+                return &thread;
+            }
+            priority_mask &= ~(1u << priority);
+        }
+        return nullptr;
+    }
+
+    void append(Thread& thread, u32 priority, u32 processor)
+    {
+        VERIFY(thread.m_runnable_priority < 0);
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_processor = processor;
+        auto& ready_queue = queues[priority];
+        bool was_empty = ready_queue.thread_list.is_empty();
+        ready_queue.thread_list.append(thread);
+        if (was_empty)
+            mask |= (1u << priority);
+        thread_count++;
+    }
+
+    void remove(Thread& thread)
+    {
+        auto priority = thread.m_runnable_priority;
+        VERIFY(priority >= 0);
+        VERIFY(mask & (1u << priority));
+        auto& ready_queue = queues[priority];
+        thread.m_runnable_priority = -1;
+        ready_queue.thread_list.remove(thread);
+        if (ready_queue.thread_list.is_empty())
+            mask &= ~(1u << priority);
+        VERIFY(thread_count > 0);
+        thread_count--;
+    }
+};
+
+// Thread affinity masks are 32 bits wide, so that's the most processors we can schedule on.
+static constexpr size_t max_scheduled_processors = sizeof(u32) * 8;
+
+// How many timer ticks pass between load balancing runs on each processor.
+static constexpr u32 load_balance_interval = 25;
+
+struct ProcessorReadyQueues {
+    SpinlockProtected<ThreadReadyQueues> ready_queues { LockRank::None };
+
+    // These mirror ready_queues->mask and ready_queues->thread_count so that other
+    // processors can look for work to steal without taking our lock.
+    Atomic<u32> mask_hint { 0 };
+    Atomic<u32> thread_count_hint { 0 };
+
+    // Only ever touched by the owning processor.
+    u32 ticks_until_load_balance { load_balance_interval };
+
+    void update_hints(ThreadReadyQueues const& queues)
+    {
+        mask_hint.store(queues.mask, AK::MemoryOrder::memory_order_relaxed);
+        thread_count_hint.store(queues.thread_count, AK::MemoryOrder::memory_order_relaxed);
+    }
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues>> g_ready_queues;
+static Singleton<Array<ProcessorReadyQueues, max_scheduled_processors>> g_ready_queues;
+static Atomic<u32> s_online_processors_mask { 0 };
 
 static SpinlockProtected<TotalTimeScheduled> g_total_time_scheduled { LockRank::None };
 
@@ -55,7 +132,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into ThreadReadyQueues::queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -64,71 +141,129 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static inline ProcessorReadyQueues& ready_queues_for(u32 processor)
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    VERIFY(processor < max_scheduled_processors);
+    return (*g_ready_queues)[processor];
+}
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
-        return *Processor::idle_thread();
+static Thread* take_runnable_thread_from(u32 processor, u32 affinity_mask)
+{
+    auto& processor_queues = ready_queues_for(processor);
+    return processor_queues.ready_queues.with([&](auto& ready_queues) -> Thread* {
+        auto* thread = ready_queues.find_runnable_thread(affinity_mask);
+        if (!thread)
+            return nullptr;
+        ready_queues.remove(*thread);
+        processor_queues.update_hints(ready_queues);
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread->set_active(true);
+        return thread;
     });
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+// Returns the processor whose queue holds the most urgent work, ignoring our own queue.
+// Ties are broken in favor of the longest queue. This only looks at the lock-free hints,
+// so the answer may be stale by the time the caller takes that processor's lock.
+static Optional<u32> find_busiest_processor(u32 current_id, u32 better_than_mask)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
+    Optional<u32> busiest;
+    u32 busiest_priority = ThreadReadyQueues::count;
+    u32 busiest_thread_count = 0;
+    for (u32 i = 1; i < max_scheduled_processors; i++) {
+        // Start with our neighbor so that not every idle processor picks on the same victim.
+        auto processor = (current_id + i) % max_scheduled_processors;
+        auto& processor_queues = ready_queues_for(processor);
+        auto mask = processor_queues.mask_hint.load(AK::MemoryOrder::memory_order_relaxed);
+        if (mask == 0)
+            continue;
+        u32 priority = bit_scan_forward(mask) - 1;
+        if (better_than_mask != 0 && priority >= (u32)bit_scan_forward(better_than_mask) - 1)
+            continue;
+        auto thread_count = processor_queues.thread_count_hint.load(AK::MemoryOrder::memory_order_relaxed);
+        if (priority < busiest_priority || (priority == busiest_priority && thread_count > busiest_thread_count)) {
+            busiest = processor;
+            busiest_priority = priority;
+            busiest_thread_count = thread_count;
         }
+    }
+    return busiest;
+}
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
+static Thread* steal_runnable_thread(u32 current_id, u32 affinity_mask, u32 better_than_mask)
+{
+    // The hints may be stale or the busiest queue may only contain threads we're not
+    // allowed to run, so fall back to trying everyone else before giving up.
+    if (auto busiest = find_busiest_processor(current_id, better_than_mask); busiest.has_value()) {
+        if (auto* thread = take_runnable_thread_from(busiest.value(), affinity_mask))
+            return thread;
+    }
+    if (better_than_mask != 0)
         return nullptr;
+    for (u32 i = 1; i < max_scheduled_processors; i++) {
+        auto processor = (current_id + i) % max_scheduled_processors;
+        if (ready_queues_for(processor).thread_count_hint.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+            continue;
+        if (auto* thread = take_runnable_thread_from(processor, affinity_mask))
+            return thread;
+    }
+    return nullptr;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto current_id = Processor::current_id();
+    auto affinity_mask = 1u << current_id;
+    auto local_mask = ready_queues_for(current_id).mask_hint.load(AK::MemoryOrder::memory_order_relaxed);
+
+    // Keep the priority semantics of a single global queue: if another processor has
+    // more urgent work queued than we do, run that instead of our own threads.
+    if (local_mask != 0) {
+        if (auto* thread = steal_runnable_thread(current_id, affinity_mask, local_mask))
+            return *thread;
+    }
+    if (auto* thread = take_runnable_thread_from(current_id, affinity_mask))
+        return *thread;
+    if (auto* thread = steal_runnable_thread(current_id, affinity_mask, 0))
+        return *thread;
+    return *Processor::idle_thread();
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    auto current_id = Processor::current_id();
+    auto affinity_mask = 1u << current_id;
+
+    auto* thread = ready_queues_for(current_id).ready_queues.with([&](auto& ready_queues) {
+        return ready_queues.find_runnable_thread(affinity_mask);
     });
+    if (thread)
+        return thread;
+
+    for (u32 i = 1; i < max_scheduled_processors; i++) {
+        auto& processor_queues = ready_queues_for((current_id + i) % max_scheduled_processors);
+        if (processor_queues.thread_count_hint.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+            continue;
+        thread = processor_queues.ready_queues.with([&](auto& ready_queues) {
+            return ready_queues.find_runnable_thread(affinity_mask);
+        });
+        if (thread)
+            return thread;
+    }
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled.
+    return nullptr;
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
@@ -136,9 +271,17 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
+    // NOTE: Threads only move between ready queues while the scheduler lock is held,
+    //       so m_runnable_processor is stable here.
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    if (thread.m_runnable_priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
+
+    auto& processor_queues = ready_queues_for(thread.m_runnable_processor);
+    return processor_queues.ready_queues.with([&](auto& ready_queues) {
+        if (thread.m_runnable_priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
             return false;
         }
@@ -146,35 +289,105 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
         if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
             return false;
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
+        ready_queues.remove(thread);
+        processor_queues.update_hints(ready_queues);
         return true;
     });
 }
 
+static u32 select_processor_for(Thread const& thread)
+{
+    auto affinity = thread.affinity();
+    VERIFY(affinity != 0);
+
+    // Prefer the processor the thread last ran on, since its caches are probably still warm,
+    // then the current processor. Idle processors will steal the thread if they get to it first.
+    auto last_processor = thread.cpu();
+    if (last_processor < max_scheduled_processors && (affinity & (1u << last_processor)))
+        return last_processor;
+    auto current_id = Processor::current_id();
+    if (affinity & (1u << current_id))
+        return current_id;
+    return bit_scan_forward(affinity) - 1;
+}
+
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
     VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
+    auto priority = thread_priority_to_priority_index(thread.effective_priority());
+    auto processor = select_processor_for(thread);
 
-    g_ready_queues->with([&](auto& ready_queues) {
-        VERIFY(thread.m_runnable_priority < 0);
-        thread.m_runnable_priority = (int)priority;
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        auto& ready_queue = ready_queues.queues[priority];
-        bool was_empty = ready_queue.thread_list.is_empty();
-        ready_queue.thread_list.append(thread);
-        if (was_empty)
-            ready_queues.mask |= (1u << priority);
+    auto& processor_queues = ready_queues_for(processor);
+    processor_queues.ready_queues.with([&](auto& ready_queues) {
+        ready_queues.append(thread, priority, processor);
+        processor_queues.update_hints(ready_queues);
     });
 }
 
+void Scheduler::balance_load()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+
+    // Idle processors steal work on their own, so all that's left to do here is to
+    // push threads away from a processor whose queue is clearly longer than another's.
+    auto current_id = Processor::current_id();
+    auto& local_queues = ready_queues_for(current_id);
+    auto local_thread_count = local_queues.thread_count_hint.load(AK::MemoryOrder::memory_order_relaxed);
+    if (local_thread_count <= 1)
+        return;
+
+    SpinlockLocker scheduler_lock(g_scheduler_lock);
+
+    Optional<u32> least_loaded;
+    u32 least_loaded_thread_count = local_thread_count;
+    for (u32 processor = 0; processor < max_scheduled_processors; processor++) {
+        if (processor == current_id)
+            continue;
+        // Don't push work to processors that never came online.
+        if (!(s_online_processors_mask.load(AK::MemoryOrder::memory_order_relaxed) & (1u << processor)))
+            continue;
+        auto thread_count = ready_queues_for(processor).thread_count_hint.load(AK::MemoryOrder::memory_order_relaxed);
+        if (thread_count < least_loaded_thread_count) {
+            least_loaded = processor;
+            least_loaded_thread_count = thread_count;
+        }
+    }
+    if (!least_loaded.has_value() || local_thread_count - least_loaded_thread_count < 2)
+        return;
+
+    auto target = least_loaded.value();
+    auto* thread = local_queues.ready_queues.with([&](auto& ready_queues) -> Thread* {
+        auto* thread = ready_queues.find_runnable_thread(1u << target);
+        if (!thread)
+            return nullptr;
+        ready_queues.remove(*thread);
+        local_queues.update_hints(ready_queues);
+        return thread;
+    });
+    if (!thread)
+        return;
+
+    dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Migrating {} to processor {}", current_id, *thread, target);
+    auto priority = thread_priority_to_priority_index(thread->effective_priority());
+    auto& target_queues = ready_queues_for(target);
+    target_queues.ready_queues.with([&](auto& ready_queues) {
+        ready_queues.append(*thread, priority, target);
+        target_queues.update_hints(ready_queues);
+    });
+    Processor::smp_wake_n_idle_processors(1);
+}
+
+bool Scheduler::has_runnable_threads()
+{
+    for (u32 processor = 0; processor < max_scheduled_processors; processor++) {
+        if (ready_queues_for(processor).thread_count_hint.load(AK::MemoryOrder::memory_order_relaxed) != 0)
+            return true;
+    }
+    return false;
+}
+
 UNMAP_AFTER_INIT void Scheduler::start()
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -261,6 +474,9 @@ void Scheduler::context_switch(Thread* thread)
     auto* from_thread = Thread::current();
     VERIFY(from_thread);
 
+    // NOTE: Threads can't give up the processor while inside an RCU read-side critical section.
+    RCU::note_quiescent_state();
+
     if (from_thread == thread)
         return;
 
@@ -383,6 +599,7 @@ UNMAP_AFTER_INIT void Scheduler::set_idle_thread(Thread* idle_thread)
 {
     idle_thread->set_idle_thread();
     Processor::current().set_idle_thread(*idle_thread);
+    s_online_processors_mask.fetch_or(1u << Processor::current_id(), AK::MemoryOrder::memory_order_relaxed);
     Processor::set_current_thread(*idle_thread);
 }
 
@@ -420,6 +637,11 @@ void Scheduler::timer_tick(RegisterState const& regs)
     VERIFY(current_thread->current_trap());
     VERIFY(current_thread->current_trap()->regs == &regs);
 
+    if (current_thread->previous_mode() == Thread::PreviousMode::UserMode)
+        RCU::note_quiescent_state();
+
+    ContinuousProfiler::timer_tick(*current_thread, regs);
+
     if (current_thread->process().is_kernel_process()) {
         // Because the previous mode when entering/exiting kernel threads never changes
         // we never update the time scheduled. So we need to update it manually on the
@@ -435,6 +657,12 @@ void Scheduler::timer_tick(RegisterState const& regs)
         return;
     }
 
+    auto& local_queues = ready_queues_for(Processor::current_id());
+    if (--local_queues.ticks_until_load_balance == 0) {
+        local_queues.ticks_until_load_balance = load_balance_interval;
+        balance_load();
+    }
+
     if (current_thread->tick())
         return;
 
@@ -479,9 +707,22 @@ void Scheduler::idle_loop(void*)
 
     for (;;) {
         proc.idle_begin();
+#if ARCH(I386) || ARCH(X86_64)
+        // NOTE: With the tick stopped, only an interrupt can wake us up again. Interrupts are only
+        //       enabled right before halting ("sti; hlt" is atomic), so an IPI telling us about new
+        //       work can't slip in between looking for work and halting.
+        Processor::disable_interrupts();
+        bool did_stop_tick = !has_runnable_threads() && TimeManagement::the().stop_tick_for_idle();
+        asm volatile("sti; hlt");
+
+        proc.idle_end();
+        if (did_stop_tick)
+            TimeManagement::the().restart_tick_after_idle();
+#else
         asm("hlt");
 
         proc.idle_end();
+#endif
         VERIFY_INTERRUPTS_ENABLED();
         yield();
     }
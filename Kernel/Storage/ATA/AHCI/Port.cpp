@@ -38,14 +38,7 @@ ErrorOr<void> AHCIPort::allocate_resources_and_initialize_ports()
 
     m_fis_receive_page = TRY(MM.allocate_physical_page());
 
-    for (size_t index = 0; index < 1; index++) {
-        auto dma_page = TRY(MM.allocate_physical_page());
-        m_dma_buffers.append(move(dma_page));
-    }
-    for (size_t index = 0; index < 1; index++) {
-        auto command_table_page = TRY(MM.allocate_physical_page());
-        m_command_table_pages.append(move(command_table_page));
-    }
+    TRY(allocate_command_slot_resources(1));
 
     m_command_list_region = TRY(MM.allocate_dma_buffer_page("AHCI Port Command List"sv, Memory::Region::Access::ReadWrite, m_command_list_page));
 
@@ -55,6 +48,20 @@ ErrorOr<void> AHCIPort::allocate_resources_and_initialize_ports()
     return {};
 }
 
+ErrorOr<void> AHCIPort::allocate_command_slot_resources(size_t command_slots_count)
+{
+    VERIFY(command_slots_count <= AHCI::Limits::MaxCommands);
+    TRY(m_dma_buffers.try_ensure_capacity(command_slots_count));
+    TRY(m_command_table_pages.try_ensure_capacity(command_slots_count));
+    while (m_command_table_pages.size() < command_slots_count) {
+        auto dma_page = TRY(MM.allocate_physical_page());
+        auto command_table_page = TRY(MM.allocate_physical_page());
+        m_dma_buffers.unchecked_append(move(dma_page));
+        m_command_table_pages.unchecked_append(move(command_table_page));
+    }
+    return {};
+}
+
 UNMAP_AFTER_INIT AHCIPort::AHCIPort(AHCIController const& controller, NonnullRefPtr<Memory::PhysicalPage> identify_buffer_page, AHCI::HBADefinedCapabilities hba_capabilities, volatile AHCI::PortRegisters& registers, u32 port_index)
     : m_port_index(port_index)
     , m_hba_capabilities(hba_capabilities)
@@ -86,20 +93,14 @@ void AHCIPort::handle_interrupt()
             auto work_item_creation_result = g_io_work->try_queue([this]() {
                 m_connected_device.clear();
             });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            }
+            if (work_item_creation_result.is_error())
+                fail_all_commands();
         } else {
             auto work_item_creation_result = g_io_work->try_queue([this]() {
                 reset();
             });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            }
+            if (work_item_creation_result.is_error())
+                fail_all_commands();
         }
         return;
     }
@@ -112,60 +113,40 @@ void AHCIPort::handle_interrupt()
         auto work_item_creation_result = g_io_work->try_queue([this]() {
             reset();
         });
-        if (work_item_creation_result.is_error()) {
-            auto current_request = m_current_request;
-            m_current_request.clear();
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-        }
+        if (work_item_creation_result.is_error())
+            fail_all_commands();
         return;
     }
     if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::IF) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::TFE) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::HBD) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::HBF)) {
         auto work_item_creation_result = g_io_work->try_queue([this]() {
             recover_from_fatal_error();
         });
-        if (work_item_creation_result.is_error()) {
-            auto current_request = m_current_request;
-            m_current_request.clear();
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-        }
+        if (work_item_creation_result.is_error())
+            fail_all_commands();
         return;
     }
-    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS)) {
-        m_wait_for_completion = false;
+    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::SDB)) {
+        u32 finished_command_slots = 0;
+        {
+            SpinlockLocker lock(m_hard_lock);
+            // Note: A command is done once the HBA cleared its bit in PxCI, and in case it was queued,
+            // once the device cleared its bit in PxSACT as well.
+            finished_command_slots = m_issued_command_slots & ~(m_port_registers.ci | m_port_registers.sact);
+            m_issued_command_slots &= ~finished_command_slots;
+            m_finished_command_slots |= finished_command_slots;
+        }
 
         // Now schedule reading/writing the buffer as soon as we leave the irq handler.
         // This is important so that we can safely access the buffers, which could
         // trigger page faults
-        if (!m_current_request) {
+        if (finished_command_slots == 0) {
             dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled, probably identify request", representative_port_index());
         } else {
             auto work_item_creation_result = g_io_work->try_queue([this]() {
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled", representative_port_index());
-                MutexLocker locker(m_lock);
-                VERIFY(m_current_request);
-                VERIFY(m_current_scatter_list);
-                if (!m_connected_device) {
-                    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                    complete_current_request(AsyncDeviceRequest::Failure);
-                    return;
-                }
-                if (m_current_request->request_type() == AsyncBlockDeviceRequest::Read) {
-                    if (auto result = m_current_request->write_to_buffer(m_current_request->buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * m_current_request->block_count()); result.is_error()) {
-                        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
-                        m_current_scatter_list = nullptr;
-                        complete_current_request(AsyncDeviceRequest::MemoryFault);
-                        return;
-                    }
-                }
-                m_current_scatter_list = nullptr;
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                complete_current_request(AsyncDeviceRequest::Success);
+                complete_finished_commands();
             });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            }
+            if (work_item_creation_result.is_error())
+                fail_all_commands();
         }
     }
 
@@ -180,18 +161,22 @@ bool AHCIPort::is_interrupts_enabled() const
 void AHCIPort::recover_from_fatal_error()
 {
     MutexLocker locker(m_lock);
-    SpinlockLocker lock(m_hard_lock);
-    LockRefPtr<AHCIController> controller = m_parent_controller.strong_ref();
-    if (!controller) {
-        dmesgln("AHCI Port {}: fatal error, controller not available", representative_port_index());
-        return;
-    }
+    {
+        SpinlockLocker lock(m_hard_lock);
+        LockRefPtr<AHCIController> controller = m_parent_controller.strong_ref();
+        if (!controller) {
+            dmesgln("AHCI Port {}: fatal error, controller not available", representative_port_index());
+            return;
+        }
 
-    dmesgln("{}: AHCI Port {} fatal error, shutting down!", controller->pci_address(), representative_port_index());
-    dmesgln("{}: AHCI Port {} fatal error, SError {}", controller->pci_address(), representative_port_index(), (u32)m_port_registers.serr);
-    stop_command_list_processing();
-    stop_fis_receiving();
-    m_interrupt_enable.clear();
+        dmesgln("{}: AHCI Port {} fatal error, shutting down!", controller->pci_address(), representative_port_index());
+        dmesgln("{}: AHCI Port {} fatal error, SError {}", controller->pci_address(), representative_port_index(), (u32)m_port_registers.serr);
+        stop_command_list_processing();
+        stop_fis_receiving();
+        m_interrupt_enable.clear();
+    }
+    // The port is shut down now, so none of the commands it still had are going to finish.
+    fail_all_commands();
 }
 
 void AHCIPort::eject()
@@ -362,6 +347,8 @@ bool AHCIPort::initialize()
                 return false;
             }
             m_connected_device = ATADiskDevice::create(*controller, { m_port_index, 0 }, 0, logical_sector_size, max_addressable_sector);
+            configure_command_queuing(*identify_block);
+            m_connected_device->set_hardware_queue_depth(m_command_slots_count);
         } else {
             dbgln("AHCI Port {}: Ignoring ATAPI devices for now as we don't currently support them.", representative_port_index());
         }
@@ -369,6 +356,30 @@ bool AHCIPort::initialize()
     return true;
 }
 
+void AHCIPort::configure_command_queuing(ATAIdentifyBlock const& identify_block)
+{
+    VERIFY(m_lock.is_locked());
+    m_native_command_queuing = false;
+    m_command_slots_count = 1;
+
+    // Word 76 bit 8 tells whether the device supports native command queuing, and word 75 how many
+    // commands it can queue, minus one.
+    if (!m_hba_capabilities.native_command_queuing_supported || !(identify_block.serial_ata_capabilities & (1 << 8)))
+        return;
+    size_t device_queue_depth = (identify_block.queue_depth & 0x1f) + 1;
+    size_t command_slots_count = min(device_queue_depth, m_hba_capabilities.max_command_list_entries_count);
+    if (command_slots_count <= 1)
+        return;
+
+    if (auto result = allocate_command_slot_resources(command_slots_count); result.is_error()) {
+        dmesgln("AHCI Port {}: Failed to allocate resources for native command queuing: {}", representative_port_index(), result.error());
+        return;
+    }
+    m_native_command_queuing = true;
+    m_command_slots_count = command_slots_count;
+    dmesgln("AHCI Port {}: Using native command queuing, queue depth {}", representative_port_index(), m_command_slots_count);
+}
+
 char const* AHCIPort::try_disambiguate_sata_status()
 {
     switch (m_port_registers.ssts & 0xf) {
@@ -488,28 +499,40 @@ size_t AHCIPort::calculate_descriptors_count(size_t block_count) const
 {
     VERIFY(m_connected_device);
     size_t needed_dma_regions_count = Memory::page_round_up((block_count * m_connected_device->block_size())).value() / PAGE_SIZE;
-    VERIFY(needed_dma_regions_count <= m_dma_buffers.size());
+    // Note: Every command slot has a single DMA buffer page of its own.
+    VERIFY(needed_dma_regions_count <= 1);
     return needed_dma_regions_count;
 }
 
-Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request)
+Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(u8 slot, AsyncBlockDeviceRequest& request)
 {
     VERIFY(m_lock.is_locked());
     VERIFY(request.block_count() > 0);
 
     NonnullRefPtrVector<Memory::PhysicalPage> allocated_dma_regions;
-    for (size_t index = 0; index < calculate_descriptors_count(request.block_count()); index++) {
-        allocated_dma_regions.append(m_dma_buffers.at(index));
-    }
+    if (calculate_descriptors_count(request.block_count()) > 0)
+        allocated_dma_regions.append(m_dma_buffers.at(slot));
 
-    m_current_scatter_list = Memory::ScatterGatherList::try_create(request, allocated_dma_regions.span(), m_connected_device->block_size());
-    if (!m_current_scatter_list)
+    auto scatter_list = Memory::ScatterGatherList::try_create(request, allocated_dma_regions.span(), m_connected_device->block_size());
+    if (!scatter_list)
         return AsyncDeviceRequest::Failure;
     if (request.request_type() == AsyncBlockDeviceRequest::Write) {
-        if (auto result = request.read_from_buffer(request.buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count()); result.is_error()) {
+        if (auto result = request.read_from_buffer(request.buffer(), scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count()); result.is_error()) {
             return AsyncDeviceRequest::MemoryFault;
         }
     }
+    SpinlockLocker lock(m_hard_lock);
+    m_command_slots[slot].scatter_list = move(scatter_list);
+    return {};
+}
+
+Optional<u8> AHCIPort::try_to_find_unused_command_slot() const
+{
+    VERIFY(m_hard_lock.is_locked());
+    for (u8 slot = 0; slot < m_command_slots_count; slot++) {
+        if (!(m_used_command_slots & (1u << slot)))
+            return slot;
+    }
     return {};
 }
 
@@ -517,34 +540,105 @@ void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
 {
     MutexLocker locker(m_lock);
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request start", representative_port_index());
-    VERIFY(!m_current_request);
-    VERIFY(!m_current_scatter_list);
 
-    m_current_request = request;
+    u8 slot = 0;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        // Note: The I/O scheduler never has more requests in flight than we have command slots.
+        auto unused_slot = try_to_find_unused_command_slot();
+        VERIFY(unused_slot.has_value());
+        slot = unused_slot.value();
+        m_used_command_slots |= 1u << slot;
+        m_command_slots[slot].request = request;
+    }
 
-    auto result = prepare_and_set_scatter_list(request);
+    auto result = prepare_and_set_scatter_list(slot, request);
     if (result.has_value()) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
         locker.unlock();
-        complete_current_request(result.value());
+        complete_command_slot(slot, result.value());
         return;
     }
 
-    auto success = access_device(request.request_type(), request.block_index(), request.block_count());
+    auto success = access_device(slot, request.request_type(), request.block_index(), request.block_count());
     if (!success) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
         locker.unlock();
-        complete_current_request(AsyncDeviceRequest::Failure);
+        complete_command_slot(slot, AsyncDeviceRequest::Failure);
         return;
     }
 }
 
-void AHCIPort::complete_current_request(AsyncDeviceRequest::RequestResult result)
+void AHCIPort::complete_command_slot(u8 slot, AsyncDeviceRequest::RequestResult result)
+{
+    LockRefPtr<AsyncBlockDeviceRequest> request;
+    LockRefPtr<Memory::ScatterGatherList> scatter_list;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        // Note: The command might have been failed in the meantime.
+        if (!(m_used_command_slots & (1u << slot)))
+            return;
+        request = move(m_command_slots[slot].request);
+        scatter_list = move(m_command_slots[slot].scatter_list);
+        m_used_command_slots &= ~(1u << slot);
+    }
+    VERIFY(request);
+    request->complete(result);
+}
+
+void AHCIPort::complete_finished_commands()
+{
+    MutexLocker locker(m_lock);
+    u32 finished_command_slots = 0;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        finished_command_slots = exchange(m_finished_command_slots, 0);
+    }
+
+    for (u8 slot = 0; slot < AHCI::Limits::MaxCommands; slot++) {
+        if (!(finished_command_slots & (1u << slot)))
+            continue;
+        LockRefPtr<AsyncBlockDeviceRequest> request;
+        LockRefPtr<Memory::ScatterGatherList> scatter_list;
+        {
+            SpinlockLocker lock(m_hard_lock);
+            request = m_command_slots[slot].request;
+            scatter_list = m_command_slots[slot].scatter_list;
+        }
+        if (!request)
+            continue;
+        VERIFY(scatter_list);
+
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request in slot {} handled", representative_port_index(), slot);
+        if (!m_connected_device) {
+            complete_command_slot(slot, AsyncDeviceRequest::Failure);
+            continue;
+        }
+        if (request->request_type() == AsyncBlockDeviceRequest::Read) {
+            if (auto result = request->write_to_buffer(request->buffer(), scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request->block_count()); result.is_error()) {
+                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
+                complete_command_slot(slot, AsyncDeviceRequest::MemoryFault);
+                continue;
+            }
+        }
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
+        complete_command_slot(slot, AsyncDeviceRequest::Success);
+    }
+}
+
+void AHCIPort::fail_all_commands()
 {
-    VERIFY(m_current_request);
-    auto current_request = m_current_request;
-    m_current_request.clear();
-    current_request->complete(result);
+    u32 used_command_slots = 0;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        used_command_slots = m_used_command_slots;
+        m_issued_command_slots = 0;
+        m_finished_command_slots = 0;
+    }
+    for (u8 slot = 0; slot < AHCI::Limits::MaxCommands; slot++) {
+        if (used_command_slots & (1u << slot))
+            complete_command_slot(slot, AsyncDeviceRequest::Failure);
+    }
 }
 
 bool AHCIPort::spin_until_ready() const
@@ -563,35 +657,35 @@ bool AHCIPort::spin_until_ready() const
     return true;
 }
 
-bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
+bool AHCIPort::access_device(u8 slot, AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
 {
     VERIFY(m_connected_device);
     VERIFY(is_operable());
     VERIFY(m_lock.is_locked());
-    VERIFY(m_current_scatter_list);
     SpinlockLocker lock(m_hard_lock);
+    auto& scatter_list = m_command_slots[slot].scatter_list;
+    VERIFY(scatter_list);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count);
-    if (!spin_until_ready())
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}, slot {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, slot);
+    // Note: Queued commands don't have to wait for the ones the device is still busy with.
+    if (!m_native_command_queuing && !spin_until_ready())
         return false;
 
-    auto unused_command_header = try_to_find_unused_command_header();
-    VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
-    command_list_entries[unused_command_header.value()].ctbau = 0;
-    command_list_entries[unused_command_header.value()].prdbc = 0;
-    command_list_entries[unused_command_header.value()].prdtl = m_current_scatter_list->scatters_count();
+    command_list_entries[slot].ctba = m_command_table_pages[slot].paddr().get();
+    command_list_entries[slot].ctbau = 0;
+    command_list_entries[slot].prdbc = 0;
+    command_list_entries[slot].prdtl = scatter_list->scatters_count();
 
     // Note: we must set the correct Dword count in this register. Real hardware
     // AHCI controllers do care about this field! QEMU doesn't care if we don't
     // set the correct CFL field in this register, real hardware will set an
     // handshake error bit in PxSERR register if CFL is incorrect.
-    command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
+    command_list_entries[slot].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[unused_command_header.value()].ctba, (u32)command_list_entries[unused_command_header.value()].ctbau, (u32)command_list_entries[unused_command_header.value()].prdbc, (u16)command_list_entries[unused_command_header.value()].prdtl, (u16)command_list_entries[unused_command_header.value()].attributes);
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[slot].ctba, (u32)command_list_entries[slot].ctbau, (u32)command_list_entries[slot].prdbc, (u16)command_list_entries[slot].prdtl, (u16)command_list_entries[slot].attributes);
 
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), Memory::page_round_up(sizeof(AHCI::CommandTable)).value(), "AHCI Command Table"sv, Memory::Region::Access::ReadWrite, Memory::Region::Cacheable::No).release_value();
+    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[slot].paddr().page_base(), Memory::page_round_up(sizeof(AHCI::CommandTable)).value(), "AHCI Command Table"sv, Memory::Region::Access::ReadWrite, Memory::Region::Cacheable::No).release_value();
     auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
 
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Allocated command table at {}", representative_port_index(), command_table_region->vaddr());
@@ -600,7 +694,7 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
 
     size_t scatter_entry_index = 0;
     size_t data_transfer_count = (block_count * m_connected_device->block_size());
-    for (auto scatter_page : m_current_scatter_list->vmobject().physical_pages()) {
+    for (auto scatter_page : scatter_list->vmobject().physical_pages()) {
         VERIFY(data_transfer_count != 0);
         VERIFY(scatter_page);
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Add a transfer scatter entry @ {}", representative_port_index(), scatter_page->paddr());
@@ -624,6 +718,11 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     if (is_atapi_attached()) {
         fis.command = ATA_CMD_PACKET;
         TODO();
+    } else if (m_native_command_queuing) {
+        if (direction == AsyncBlockDeviceRequest::RequestType::Write)
+            fis.command = ATA_CMD_WRITE_FPDMA_QUEUED;
+        else
+            fis.command = ATA_CMD_READ_FPDMA_QUEUED;
     } else {
         if (direction == AsyncBlockDeviceRequest::RequestType::Write)
             fis.command = ATA_CMD_WRITE_DMA_EXT;
@@ -642,17 +741,27 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     fis.lba_low[0] = lba & 0xff;
     fis.lba_low[1] = (lba >> 8) & 0xff;
     fis.lba_low[2] = (lba >> 16) & 0xff;
-    fis.count = (block_count);
+    if (m_native_command_queuing) {
+        // Note: Queued commands take the sector count in the features field, and their tag in the count field.
+        fis.features_low = block_count;
+        fis.features_high = 0;
+        fis.count = slot << 3;
+    } else {
+        fis.count = (block_count);
 
-    // The below loop waits until the port is no longer busy before issuing a new command
-    if (!spin_until_ready())
-        return false;
+        // The below loop waits until the port is no longer busy before issuing a new command
+        if (!spin_until_ready())
+            return false;
+    }
 
     full_memory_barrier();
-    mark_command_header_ready_to_process(unused_command_header.value());
+    if (m_native_command_queuing)
+        m_port_registers.sact = 1u << slot;
+    m_issued_command_slots |= 1u << slot;
+    mark_command_header_ready_to_process(slot);
     full_memory_barrier();
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[0].paddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[slot].paddr());
     return true;
 }
 
@@ -782,8 +891,6 @@ void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index) con
     VERIFY(m_lock.is_locked());
     VERIFY(m_hard_lock.is_locked());
     VERIFY(is_operable());
-    VERIFY(!m_wait_for_completion);
-    m_wait_for_completion = true;
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Marking command header at index {} as ready to process.", representative_port_index(), command_header_index);
     m_port_registers.ci = 1 << command_header_index;
 }
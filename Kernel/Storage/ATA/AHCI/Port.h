@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
@@ -74,10 +75,16 @@ private:
     ALWAYS_INLINE void power_on() const;
 
     void start_request(AsyncBlockDeviceRequest&);
-    void complete_current_request(AsyncDeviceRequest::RequestResult);
-    bool access_device(AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
+    void complete_command_slot(u8 slot, AsyncDeviceRequest::RequestResult);
+    void complete_finished_commands();
+    void fail_all_commands();
+    bool access_device(u8 slot, AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
     size_t calculate_descriptors_count(size_t block_count) const;
-    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request);
+    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(u8 slot, AsyncBlockDeviceRequest& request);
+
+    ErrorOr<void> allocate_command_slot_resources(size_t command_slots_count);
+    void configure_command_queuing(ATAIdentifyBlock const&);
+    Optional<u8> try_to_find_unused_command_slot() const;
 
     ALWAYS_INLINE bool is_interrupts_enabled() const;
 
@@ -106,11 +113,23 @@ private:
     // Data members
 
     EntropySource m_entropy_source;
-    LockRefPtr<AsyncBlockDeviceRequest> m_current_request;
     Spinlock m_hard_lock { LockRank::None };
     Mutex m_lock { "AHCIPort"sv };
 
-    mutable bool m_wait_for_completion { false };
+    struct CommandSlot {
+        LockRefPtr<AsyncBlockDeviceRequest> request;
+        LockRefPtr<Memory::ScatterGatherList> scatter_list;
+    };
+
+    // Note: Without native command queuing only slot 0 is used, with it every slot has its own
+    // command table and DMA buffer, so that all of them can be carried out at once.
+    Array<CommandSlot, AHCI::Limits::MaxCommands> m_command_slots;
+    size_t m_command_slots_count { 1 };
+    bool m_native_command_queuing { false };
+    // These are guarded by m_hard_lock.
+    u32 m_used_command_slots { 0 };
+    u32 m_issued_command_slots { 0 };
+    u32 m_finished_command_slots { 0 };
 
     NonnullRefPtrVector<Memory::PhysicalPage> m_dma_buffers;
     NonnullRefPtrVector<Memory::PhysicalPage> m_command_table_pages;
@@ -133,7 +152,6 @@ private:
     AHCI::PortInterruptStatusBitField m_interrupt_status;
     AHCI::PortInterruptEnableBitField m_interrupt_enable;
 
-    LockRefPtr<Memory::ScatterGatherList> m_current_scatter_list;
     bool m_disabled_by_firmware { false };
 };
 }
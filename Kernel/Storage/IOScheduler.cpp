@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/Storage/IOScheduler.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+IOScheduler::IOScheduler(BlockDevice& device, size_t max_blocks_per_request)
+    : m_device(device)
+    , m_max_blocks_per_request(max_blocks_per_request)
+{
+    // This way, we never have to allocate while starting requests.
+    m_in_flight.ensure_capacity(max_queue_depth);
+}
+
+ErrorOr<void> IOScheduler::try_allocate_merge_buffer()
+{
+    auto buffer = TRY(KBuffer::try_create_with_size("IOScheduler: Merged request buffer"sv, m_max_blocks_per_request * m_device.block_size(), Memory::Region::Access::ReadWrite));
+    SpinlockLocker lock(m_lock);
+    m_merge_buffer = move(buffer);
+    return {};
+}
+
+void IOScheduler::set_hardware_queue_depth(size_t queue_depth)
+{
+    VERIFY(queue_depth > 0);
+    SpinlockLocker lock(m_lock);
+    m_hardware_queue_depth = min(queue_depth, max_queue_depth);
+}
+
+static Time now()
+{
+    return TimeManagement::the().monotonic_time(TimePrecision::Precise);
+}
+
+ErrorOr<void> IOScheduler::queue_request(NonnullLockRefPtr<AsyncBlockDeviceRequest> request)
+{
+    auto queued_at = now();
+    SpinlockLocker lock(m_lock);
+
+    size_t queue_depth = m_queues[0].size() + m_queues[1].size() + m_in_flight.size() + m_merged_requests.size();
+    size_t bucket = 0;
+    while (bucket + 1 < queue_depth_bucket_count && queue_depth >= Statistics::queue_depth_bucket_limit(bucket))
+        ++bucket;
+    ++m_statistics.queue_depths[bucket];
+
+    // Requests for the same blocks stay in the order in which they were made.
+    auto& queue = queue_for(request->request_type());
+    size_t index = queue.size();
+    while (index > 0 && queue[index - 1].request->block_index() > request->block_index())
+        --index;
+    TRY(queue.try_insert(index, { move(request), queued_at }));
+
+    start_next_requests(move(lock));
+    return {};
+}
+
+bool IOScheduler::is_past_deadline(QueuedRequest const& queued_request, Time now) const
+{
+    auto deadline = queued_request.request->request_type() == AsyncBlockDeviceRequest::Read ? read_deadline : write_deadline;
+    return now - queued_request.queued_at > deadline;
+}
+
+size_t IOScheduler::oldest_request_index(Queue const& queue)
+{
+    size_t oldest = 0;
+    for (size_t i = 1; i < queue.size(); ++i) {
+        if (queue[i].queued_at < queue[oldest].queued_at)
+            oldest = i;
+    }
+    return oldest;
+}
+
+Optional<AsyncBlockDeviceRequest::RequestType> IOScheduler::pick_request_type(Time now)
+{
+    auto& reads = queue_for(AsyncBlockDeviceRequest::Read);
+    auto& writes = queue_for(AsyncBlockDeviceRequest::Write);
+    if (writes.is_empty()) {
+        if (reads.is_empty())
+            return {};
+        return AsyncBlockDeviceRequest::Read;
+    }
+
+    bool writes_are_due = reads.is_empty()
+        || m_times_writes_were_passed_over >= max_times_writes_are_passed_over
+        || is_past_deadline(writes[oldest_request_index(writes)], now);
+    if (writes_are_due) {
+        m_times_writes_were_passed_over = 0;
+        return AsyncBlockDeviceRequest::Write;
+    }
+    ++m_times_writes_were_passed_over;
+    return AsyncBlockDeviceRequest::Read;
+}
+
+size_t IOScheduler::pick_first_request(Queue const& queue, Time now) const
+{
+    VERIFY(!queue.is_empty());
+    auto oldest = oldest_request_index(queue);
+    if (is_past_deadline(queue[oldest], now))
+        return oldest;
+
+    // Otherwise, keep sweeping across the disk from where the previous request ended.
+    for (size_t i = 0; i < queue.size(); ++i) {
+        if (queue[i].request->block_index() >= m_next_block_index)
+            return i;
+    }
+    return 0;
+}
+
+bool IOScheduler::can_be_merged(AsyncBlockDeviceRequest const& request) const
+{
+    // Copying into and out of user buffers could fault, and we can't handle that without failing every request we merged.
+    return m_merge_buffer && !m_merged_request && request.buffer().is_kernel_buffer() && request.block_count() < m_max_blocks_per_request;
+}
+
+void IOScheduler::start_next_requests(SpinlockLocker<Spinlock>&& lock)
+{
+    while (in_flight_count() < m_hardware_queue_depth) {
+        auto time = now();
+        auto request_type = pick_request_type(time);
+        if (!request_type.has_value())
+            return;
+        auto& queue = queue_for(*request_type);
+        size_t first = pick_first_request(queue, time);
+        auto& first_request = *queue[first].request;
+
+        size_t count = 1;
+        u64 block_count = first_request.block_count();
+        if (can_be_merged(first_request)) {
+            while (first + count < queue.size() && count < max_merged_requests) {
+                auto& request = *queue[first + count].request;
+                if (!can_be_merged(request) || request.block_index() != first_request.block_index() + block_count)
+                    break;
+                if (block_count + request.block_count() > m_max_blocks_per_request)
+                    break;
+                block_count += request.block_count();
+                ++count;
+            }
+        }
+
+        LockRefPtr<AsyncBlockDeviceRequest> merged_request;
+        if (count > 1) {
+            auto buffer = UserOrKernelBuffer::for_kernel_buffer(m_merge_buffer->data());
+            merged_request = adopt_lock_ref_if_nonnull(new (nothrow) AsyncBlockDeviceRequest(m_device, *request_type, first_request.block_index(), block_count, buffer, block_count * m_device.block_size()));
+            // The requests can still go one by one.
+            if (!merged_request)
+                count = 1;
+        }
+
+        m_next_block_index = first_request.block_index() + (merged_request ? block_count : first_request.block_count());
+
+        if (!merged_request) {
+            NonnullLockRefPtr<AsyncBlockDeviceRequest> request = first_request;
+            m_in_flight.unchecked_append(move(queue[first]));
+            queue.remove(first);
+            request->do_start(move(lock));
+            lock.lock();
+            continue;
+        }
+
+        dbgln_if(STORAGE_DEVICE_DEBUG, "IOScheduler: Merging {} requests into blocks {}-{}", count, merged_request->block_index(), merged_request->block_index() + block_count - 1);
+        m_statistics.merged_requests += count;
+        for (size_t i = 0; i < count; ++i)
+            m_merged_requests.unchecked_append(move(queue[first + i]));
+        queue.remove(first, count);
+
+        size_t offset = 0;
+        for (auto& queued_request : m_merged_requests) {
+            auto& request = *queued_request.request;
+            bool was_started = request.mark_as_started();
+            VERIFY(was_started);
+            size_t size = request.block_count() * m_device.block_size();
+            if (*request_type == AsyncBlockDeviceRequest::Write)
+                MUST(request.read_from_buffer(request.buffer(), m_merge_buffer->data() + offset, size));
+            offset += size;
+        }
+
+        m_merged_request = merged_request;
+        merged_request->do_start(move(lock));
+        lock.lock();
+    }
+}
+
+void IOScheduler::record_latency(QueuedRequest const& queued_request, Time now)
+{
+    auto microseconds = (now - queued_request.queued_at).to_microseconds();
+    size_t bucket = 0;
+    while (bucket + 1 < latency_bucket_count && static_cast<u64>(microseconds) >= Statistics::latency_bucket_limit_in_microseconds(bucket))
+        ++bucket;
+    if (queued_request.request->request_type() == AsyncBlockDeviceRequest::Read)
+        ++m_statistics.read_latencies[bucket];
+    else
+        ++m_statistics.write_latencies[bucket];
+}
+
+void IOScheduler::request_finished(AsyncDeviceRequest const& finished_request)
+{
+    Vector<QueuedRequest, max_merged_requests> merged_requests;
+    auto result = AsyncDeviceRequest::Success;
+    {
+        SpinlockLocker lock(m_lock);
+        auto time = now();
+        if (&finished_request == m_merged_request.ptr()) {
+            for (auto& queued_request : m_merged_requests)
+                record_latency(queued_request, time);
+
+            result = m_merged_request->get_request_result();
+            if (result != AsyncDeviceRequest::Success && result != AsyncDeviceRequest::MemoryFault)
+                result = AsyncDeviceRequest::Failure;
+
+            if (result == AsyncDeviceRequest::Success && m_merged_request->request_type() == AsyncBlockDeviceRequest::Read) {
+                size_t offset = 0;
+                for (auto& queued_request : m_merged_requests) {
+                    auto& request = *queued_request.request;
+                    size_t size = request.block_count() * m_device.block_size();
+                    MUST(request.write_to_buffer(request.buffer(), m_merge_buffer->data() + offset, size));
+                    offset += size;
+                }
+            }
+            merged_requests = move(m_merged_requests);
+            m_merged_requests.clear();
+            m_merged_request.clear();
+        } else {
+            size_t index = 0;
+            while (index < m_in_flight.size() && m_in_flight[index].request.ptr() != &finished_request)
+                ++index;
+            // Requests that were merged into another one are completed below, which brings us back here.
+            if (index == m_in_flight.size())
+                return;
+            record_latency(m_in_flight[index], time);
+            m_in_flight.remove(index);
+        }
+
+        start_next_requests(move(lock));
+    }
+
+    for (auto& queued_request : merged_requests)
+        queued_request.request->complete(result);
+}
+
+IOScheduler::Statistics IOScheduler::statistics() const
+{
+    SpinlockLocker lock(m_lock);
+    auto statistics = m_statistics;
+    statistics.queue_depth = m_queues[0].size() + m_queues[1].size() + m_in_flight.size() + m_merged_requests.size();
+    statistics.hardware_queue_depth = m_hardware_queue_depth;
+    return statistics;
+}
+
+}
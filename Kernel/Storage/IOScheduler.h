@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Library/NonnullLockRefPtr.h>
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+// Decides in which order the requests queued on a storage device are sent to the hardware. By default, that
+// happens one at a time, devices that can carry out several requests at once raise the queue depth.
+//
+// Reads and writes are queued separately, both sorted by block index. Requests are normally taken in
+// ascending block order, continuing from where the previous one ended, and reads are preferred over
+// writes, so that a flood of write-back doesn't hold up readers. Each request has a deadline though,
+// and once the oldest request in a queue is past it, that request goes next. Writes are also never
+// passed over more than a few times in a row.
+//
+// Requests for adjacent blocks that are next to each other in a queue are merged into a single one,
+// but only as long as they fit into a page, which is what all of our drivers can handle at once.
+// Only one merged request is in flight at a time, as they all need the same buffer.
+class IOScheduler {
+public:
+    static constexpr size_t latency_bucket_count = 16;
+    static constexpr size_t queue_depth_bucket_count = 8;
+    static constexpr size_t max_queue_depth = 32;
+
+    struct Statistics {
+        size_t queue_depth { 0 };
+        size_t hardware_queue_depth { 1 };
+        // Bucket i holds the latencies below 2^(i + 6) microseconds, the last one holds the rest.
+        Array<u64, latency_bucket_count> read_latencies {};
+        Array<u64, latency_bucket_count> write_latencies {};
+        // Bucket i holds the requests that found less than 2^i others queued ahead of them, the last one holds the rest.
+        Array<u64, queue_depth_bucket_count> queue_depths {};
+        u64 merged_requests { 0 };
+
+        static u64 latency_bucket_limit_in_microseconds(size_t bucket) { return 1ull << (bucket + 6); }
+        static size_t queue_depth_bucket_limit(size_t bucket) { return 1u << bucket; }
+    };
+
+    IOScheduler(BlockDevice&, size_t max_blocks_per_request);
+
+    ErrorOr<void> try_allocate_merge_buffer();
+    void set_hardware_queue_depth(size_t);
+
+    ErrorOr<void> queue_request(NonnullLockRefPtr<AsyncBlockDeviceRequest>);
+    void request_finished(AsyncDeviceRequest const&);
+
+    Statistics statistics() const;
+
+private:
+    // A merged request can't be made up of more requests than there are sectors in a page.
+    static constexpr size_t max_merged_requests = PAGE_SIZE / 512;
+
+    static constexpr Time read_deadline = Time::from_milliseconds(500);
+    static constexpr Time write_deadline = Time::from_seconds(5);
+    static constexpr size_t max_times_writes_are_passed_over = 2;
+
+    struct QueuedRequest {
+        NonnullLockRefPtr<AsyncBlockDeviceRequest> request;
+        Time queued_at;
+    };
+    using Queue = Vector<QueuedRequest>;
+
+    Queue& queue_for(AsyncBlockDeviceRequest::RequestType type) { return m_queues[type == AsyncBlockDeviceRequest::Read ? 0 : 1]; }
+    bool is_past_deadline(QueuedRequest const&, Time now) const;
+    static size_t oldest_request_index(Queue const&);
+
+    Optional<AsyncBlockDeviceRequest::RequestType> pick_request_type(Time now);
+    size_t pick_first_request(Queue const&, Time now) const;
+    bool can_be_merged(AsyncBlockDeviceRequest const&) const;
+
+    size_t in_flight_count() const { return m_in_flight.size() + (m_merged_request ? 1 : 0); }
+    void start_next_requests(SpinlockLocker<Spinlock>&&);
+    void record_latency(QueuedRequest const&, Time now);
+
+    BlockDevice& m_device;
+    size_t const m_max_blocks_per_request;
+
+    mutable Spinlock m_lock { LockRank::None };
+    Array<Queue, 2> m_queues;
+    OwnPtr<KBuffer> m_merge_buffer;
+
+    size_t m_hardware_queue_depth { 1 };
+    Vector<QueuedRequest> m_in_flight;
+    // The request that is carried out instead of the ones that were merged into it.
+    LockRefPtr<AsyncBlockDeviceRequest> m_merged_request;
+    Vector<QueuedRequest, max_merged_requests> m_merged_requests;
+
+    u64 m_next_block_index { 0 };
+    size_t m_times_writes_were_passed_over { 0 };
+    Statistics m_statistics;
+};
+
+}
@@ -35,8 +35,6 @@ UNMAP_AFTER_INIT NVMeController::NVMeController(const PCI::DeviceIdentifier& dev
 
 UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
 {
-    // Nr of queues = one queue per core
-    auto nr_of_queues = Processor::count();
     auto irq = is_queue_polled ? Optional<u8> {} : m_pci_device_id.interrupt_line().value();
 
     PCI::enable_memory_space(m_pci_device_id.address());
@@ -59,10 +57,14 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
     VERIFY(IO_QUEUE_SIZE < MQES(caps));
     dbgln_if(NVME_DEBUG, "NVMe: IO queue depth is: {}", IO_QUEUE_SIZE);
 
-    // Create an IO queue per core
-    for (u32 cpuid = 0; cpuid < nr_of_queues; ++cpuid) {
+    // Ask for an IO queue per core, but the controller may give us fewer than that.
+    // In that case, processors share queues (see NVMeNameSpace::start_request).
+    auto nr_of_queues = TRY(request_io_queue_count(Processor::count()));
+    dbgln_if(NVME_DEBUG, "NVMe: Using {} IO queue(s) for {} processor(s)", nr_of_queues, Processor::count());
+
+    for (u32 queue_index = 0; queue_index < nr_of_queues; ++queue_index) {
         // qid is zero is used for admin queue
-        TRY(create_io_queue(cpuid + 1, irq));
+        TRY(create_io_queue(queue_index + 1, irq));
     }
     TRY(identify_and_init_namespaces());
     return {};
@@ -295,6 +297,30 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_admin_queue(Optional<u8> i
     return {};
 }
 
+UNMAP_AFTER_INIT ErrorOr<u32> NVMeController::request_io_queue_count(u32 desired_count)
+{
+    VERIFY(desired_count > 0);
+    // The queue IDs have to fit into a u8 (see create_io_queue), and qid 0 is the admin queue.
+    desired_count = min(desired_count, static_cast<u32>(NumericLimits<u8>::max()));
+
+    NVMeSubmission sub {};
+    sub.op = OP_ADMIN_SET_FEATURES;
+    sub.generic.cdw10 = NVMe_FEATURE_NUMBER_OF_QUEUES;
+    // Both the requested submission (15:0) and completion (31:16) queue counts are 0 based
+    sub.generic.cdw11 = ((desired_count - 1) << 16) | (desired_count - 1);
+
+    u32 allocated = 0;
+    if (auto status = submit_admin_command(sub, true, &allocated); status) {
+        // Not being able to negotiate is not fatal, every controller has at least one IO queue pair.
+        dmesgln("NVMe: Failed to set the number of IO queues (status {:#x}), using a single queue", status);
+        return 1;
+    }
+
+    u32 submission_queues = (allocated & 0xffff) + 1;
+    u32 completion_queues = (allocated >> 16) + 1;
+    return min(desired_count, min(submission_queues, completion_queues));
+}
+
 UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, Optional<u8> irq)
 {
     OwnPtr<Memory::Region> cq_dma_region;
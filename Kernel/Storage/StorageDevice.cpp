@@ -25,6 +25,7 @@ StorageDevice::StorageDevice(LUNAddress logical_unit_number_address, u32 hardwar
     , m_hardware_relative_controller_id(hardware_relative_controller_id)
     , m_max_addressable_block(max_addressable_block)
     , m_blocks_per_page(PAGE_SIZE / block_size())
+    , m_io_scheduler(*this, m_blocks_per_page)
 {
 }
 
@@ -34,11 +35,15 @@ StorageDevice::StorageDevice(Badge<RamdiskDevice>, LUNAddress logical_unit_numbe
     , m_hardware_relative_controller_id(hardware_relative_controller_id)
     , m_max_addressable_block(max_addressable_block)
     , m_blocks_per_page(PAGE_SIZE / block_size())
+    , m_io_scheduler(*this, m_blocks_per_page)
 {
 }
 
 void StorageDevice::after_inserting()
 {
+    // Without it, requests are simply never merged.
+    if (auto result = m_io_scheduler.try_allocate_merge_buffer(); result.is_error())
+        dmesgln("StorageDevice: Failed to allocate a buffer for merging requests: {}", result.error());
     after_inserting_add_to_device_management();
     auto sysfs_storage_device_directory = StorageDeviceSysFSDirectory::create(SysFSStorageDirectory::the(), *this);
     m_sysfs_device_directory = sysfs_storage_device_directory;
@@ -63,6 +68,17 @@ StringView StorageDevice::class_name() const
     return "StorageDevice"sv;
 }
 
+ErrorOr<void> StorageDevice::queue_request(NonnullLockRefPtr<AsyncDeviceRequest> request)
+{
+    // Nothing but block device requests are ever made on a storage device.
+    return m_io_scheduler.queue_request(static_ptr_cast<AsyncBlockDeviceRequest>(move(request)));
+}
+
+void StorageDevice::start_next_queued_request(AsyncDeviceRequest const& finished_request)
+{
+    m_io_scheduler.request_finished(finished_request);
+}
+
 StringView StorageDevice::command_set_to_string_view() const
 {
     switch (command_set()) {
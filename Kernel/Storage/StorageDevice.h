@@ -11,6 +11,7 @@
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Storage/DiskPartition.h>
+#include <Kernel/Storage/IOScheduler.h>
 #include <Kernel/Storage/StorageController.h>
 
 namespace Kernel {
@@ -74,6 +75,10 @@ public:
 
     StringView command_set_to_string_view() const;
 
+    IOScheduler const& io_scheduler() const { return m_io_scheduler; }
+    // For devices that can carry out more than one request at a time.
+    void set_hardware_queue_depth(size_t queue_depth) { m_io_scheduler.set_hardware_queue_depth(queue_depth); }
+
     // ^File
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) final;
 
@@ -87,6 +92,10 @@ protected:
     // ^DiskDevice
     virtual StringView class_name() const override;
 
+    // ^Device
+    virtual ErrorOr<void> queue_request(NonnullLockRefPtr<AsyncDeviceRequest>) override;
+    virtual void start_next_queued_request(AsyncDeviceRequest const& finished_request) override;
+
 private:
     virtual void after_inserting() override;
     virtual void will_be_destroyed() override;
@@ -105,6 +114,8 @@ private:
 
     u64 m_max_addressable_block { 0 };
     size_t m_blocks_per_page { 0 };
+
+    IOScheduler m_io_scheduler;
 };
 
 }
@@ -14,7 +14,9 @@
 #include <Kernel/Process.h>
 #include <Kernel/Scheduler.h>
 #include <Kernel/Sections.h>
+#include <Kernel/SyscallTraceBuffer.h>
 #include <Kernel/ThreadTracer.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -213,12 +215,20 @@ NEVER_INLINE void syscall_handler(TrapFrame* trap)
     FlatPtr arg4;
     regs.capture_syscall_params(function, arg1, arg2, arg3, arg4);
 
+    // NOTE: We hold on to the buffer for the duration of the syscall, since the tracer may detach while we're in it.
+    LockRefPtr<SyscallTraceBuffer> trace_buffer;
+    if (auto* tracer = process.tracer())
+        trace_buffer = tracer->syscall_trace_buffer();
+    u64 entry_time_ns = trace_buffer ? TimeManagement::the().monotonic_time(TimePrecision::Precise).to_nanoseconds() : 0;
+
     auto result = Syscall::handle(regs, function, arg1, arg2, arg3, arg4);
 
-    if (result.is_error()) {
-        regs.set_return_reg(-result.error().code());
-    } else {
-        regs.set_return_reg(result.value());
+    FlatPtr return_value = result.is_error() ? static_cast<FlatPtr>(-result.error().code()) : result.value();
+    regs.set_return_reg(return_value);
+
+    if (trace_buffer) {
+        u64 exit_time_ns = TimeManagement::the().monotonic_time(TimePrecision::Precise).to_nanoseconds();
+        trace_buffer->append(current_thread->tid(), function, arg1, arg2, arg3, arg4, return_value, entry_time_ns, exit_time_ns - entry_time_ns);
     }
 
     if (auto* tracer = process.tracer(); tracer && tracer->is_tracing_syscalls()) {
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/SyscallTraceBuffer.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullLockRefPtr<SyscallTraceBuffer>> SyscallTraceBuffer::try_create(u32 record_count)
+{
+    if (record_count == 0 || record_count > syscall_trace_max_records || !is_power_of_two(record_count))
+        return EINVAL;
+
+    auto size = syscall_trace_mapping_size(record_count);
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "SyscallTraceBuffer"sv, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) SyscallTraceBuffer(record_count, move(vmobject), move(region)));
+}
+
+SyscallTraceBuffer::SyscallTraceBuffer(u32 record_count, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> kernel_region)
+    : m_record_count(record_count)
+    , m_vmobject(move(vmobject))
+    , m_kernel_region(move(kernel_region))
+{
+    header().record_count = m_record_count;
+}
+
+SyscallTraceBuffer::~SyscallTraceBuffer() = default;
+
+SyscallTraceRecord& SyscallTraceBuffer::record_at(u32 index) const
+{
+    auto* records = reinterpret_cast<SyscallTraceRecord*>(m_kernel_region->vaddr().offset(syscall_trace_records_offset()).as_ptr());
+    return records[index & (m_record_count - 1)];
+}
+
+void SyscallTraceBuffer::append(ThreadID tid, FlatPtr function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3, FlatPtr arg4, FlatPtr result, u64 entry_time_ns, u64 duration_ns)
+{
+    // NOTE: The head lives in memory the tracer can write to, but we only ever use it to pick a slot within the ring,
+    //       so scribbling over it can't hurt anyone but the tracer itself.
+    auto index = AK::atomic_fetch_add(&header().head, 1u, AK::MemoryOrder::memory_order_relaxed);
+    auto& record = record_at(index);
+
+    // Mark the slot as being written before touching anything else in it, so that a tracer that is reading the
+    // record from the previous lap around the ring sees its sequence number change.
+    AK::atomic_store(&record.sequence, index, AK::MemoryOrder::memory_order_relaxed);
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+
+    record.function = function;
+    record.tid = tid.value();
+    record.reserved = 0;
+    record.entry_time_ns = entry_time_ns;
+    record.duration_ns = duration_ns;
+    record.arguments[0] = arg1;
+    record.arguments[1] = arg2;
+    record.arguments[2] = arg3;
+    record.arguments[3] = arg4;
+    record.result = static_cast<i64>(static_cast<ssize_t>(result));
+
+    AK::atomic_store(&record.sequence, index + 1, AK::MemoryOrder::memory_order_release);
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> SyscallTraceBuffer::vmobject_for_mmap(Process&, OpenFileDescription&, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    if (offset != 0 || !shared)
+        return EINVAL;
+    return m_vmobject;
+}
+
+ErrorOr<NonnullOwnPtr<KString>> SyscallTraceBuffer::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::formatted("SyscallTraceBuffer:({})", m_record_count);
+}
+
+}
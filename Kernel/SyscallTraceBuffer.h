@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/API/SyscallTrace.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+class SyscallTraceBuffer final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<SyscallTraceBuffer>> try_create(u32 record_count);
+    virtual ~SyscallTraceBuffer() override;
+
+    // Called by the traced thread on its way back to userspace. This may run on any number of threads at once.
+    void append(ThreadID, FlatPtr function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3, FlatPtr arg4, FlatPtr result, u64 entry_time_ns, u64 duration_ns);
+
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, OpenFileDescription&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override { return false; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return ENOTSUP; }
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "SyscallTraceBuffer"sv; }
+
+private:
+    SyscallTraceBuffer(u32 record_count, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>);
+
+    SyscallTraceHeader& header() const { return *reinterpret_cast<SyscallTraceHeader*>(m_kernel_region->vaddr().as_ptr()); }
+    SyscallTraceRecord& record_at(u32 index) const;
+
+    u32 const m_record_count { 0 };
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_kernel_region;
+};
+
+}
@@ -548,6 +548,7 @@ ErrorOr<void> Process::do_exec(NonnullLockRefPtr<OpenFileDescription> main_progr
 
     // We make sure to enter the new address space before destroying the old one.
     // This ensures that the process always has a valid page directory.
+    // NOTE: When spawning a child, this is the parent's thread, which the caller moves back to the parent's address space.
     Memory::MemoryManager::enter_address_space(*load_result.space);
 
     m_space.with([&](auto& space) { space = load_result.space.release_nonnull(); });
@@ -571,7 +572,12 @@ ErrorOr<void> Process::do_exec(NonnullLockRefPtr<OpenFileDescription> main_progr
     });
 
     auto* current_thread = Thread::current();
-    current_thread->reset_signals_for_exec();
+    if (&current_thread->process() == this) {
+        current_thread->reset_signals_for_exec();
+    } else {
+        // NOTE: When spawning a child, we're running on the parent's thread, which has to keep its signal state.
+        for_each_thread([](auto& thread) { thread.reset_signals_for_exec(); });
+    }
 
     clear_signal_handlers_for_exec();
 
@@ -872,6 +878,24 @@ ErrorOr<void> Process::exec(NonnullOwnPtr<KString> path, NonnullOwnPtrVector<KSt
     return do_exec(move(description), move(arguments), move(environment), move(interpreter_description), new_main_thread, prev_flags, *main_program_header);
 }
 
+ErrorOr<void> Process::copy_user_string_list(Syscall::StringListArgument const& list, NonnullOwnPtrVector<KString>& output)
+{
+    if (!list.length)
+        return {};
+    Checked<size_t> size = sizeof(*list.strings);
+    size *= list.length;
+    if (size.has_overflow())
+        return EOVERFLOW;
+    Vector<Syscall::StringArgument, 32> strings;
+    TRY(strings.try_resize(list.length));
+    TRY(copy_from_user(strings.data(), list.strings, size.value()));
+    for (size_t i = 0; i < list.length; ++i) {
+        auto string = TRY(try_copy_kstring_from_user(strings[i]));
+        TRY(output.try_append(move(string)));
+    }
+    return {};
+}
+
 ErrorOr<FlatPtr> Process::sys$execve(Userspace<Syscall::SC_execve_params const*> user_params)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
@@ -897,28 +921,11 @@ ErrorOr<FlatPtr> Process::sys$execve(Userspace<Syscall::SC_execve_params const*>
 
         auto path = TRY(get_syscall_path_argument(params.path));
 
-        auto copy_user_strings = [](auto const& list, auto& output) -> ErrorOr<void> {
-            if (!list.length)
-                return {};
-            Checked<size_t> size = sizeof(*list.strings);
-            size *= list.length;
-            if (size.has_overflow())
-                return EOVERFLOW;
-            Vector<Syscall::StringArgument, 32> strings;
-            TRY(strings.try_resize(list.length));
-            TRY(copy_from_user(strings.data(), list.strings, size.value()));
-            for (size_t i = 0; i < list.length; ++i) {
-                auto string = TRY(try_copy_kstring_from_user(strings[i]));
-                TRY(output.try_append(move(string)));
-            }
-            return {};
-        };
-
         NonnullOwnPtrVector<KString> arguments;
-        TRY(copy_user_strings(params.arguments, arguments));
+        TRY(copy_user_string_list(params.arguments, arguments));
 
         NonnullOwnPtrVector<KString> environment;
-        TRY(copy_user_strings(params.environment, environment));
+        TRY(copy_user_string_list(params.environment, environment));
 
         TRY(exec(move(path), move(arguments), move(environment), new_main_thread, prev_flags));
     }
@@ -13,20 +13,8 @@
 
 namespace Kernel {
 
-ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
+ErrorOr<NonnullLockRefPtr<Process>> Process::try_create_child(LockRefPtr<Thread>& child_first_thread)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
-    TRY(require_promise(Pledge::proc));
-    LockRefPtr<Thread> child_first_thread;
-
-    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
-        SpinlockLocker lock(g_scheduler_lock);
-        if (child_first_thread) {
-            child_first_thread->detach();
-            child_first_thread->set_state(Thread::State::Dying);
-        }
-    };
-
     auto child_name = TRY(m_name->try_clone());
     auto credentials = this->credentials();
     auto child = TRY(Process::try_create(child_first_thread, move(child_name), credentials->uid(), credentials->gid(), pid(), m_is_kernel_process, current_directory(), executable(), m_tty, this));
@@ -84,8 +72,6 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
         });
     });
 
-    dbgln_if(FORK_DEBUG, "fork: child={}", child);
-
     // A child created via fork(2) inherits a copy of its parent's signal mask
     child_first_thread->update_signal_mask(Thread::current()->signal_mask());
 
@@ -93,6 +79,27 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
     child_first_thread->m_alternative_signal_stack = Thread::current()->m_alternative_signal_stack;
     child_first_thread->m_alternative_signal_stack_size = Thread::current()->m_alternative_signal_stack_size;
 
+    return child;
+}
+
+ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::proc));
+    LockRefPtr<Thread> child_first_thread;
+
+    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
+        SpinlockLocker lock(g_scheduler_lock);
+        if (child_first_thread) {
+            child_first_thread->detach();
+            child_first_thread->set_state(Thread::State::Dying);
+        }
+    };
+
+    auto child = TRY(try_create_child(child_first_thread));
+
+    dbgln_if(FORK_DEBUG, "fork: child={}", child);
+
 #if ARCH(I386)
     auto& child_regs = child_first_thread->m_regs;
     child_regs.eax = 0; // fork() returns 0 in the child :^)
@@ -148,7 +155,8 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
             for (auto& region : parent_space->region_tree().regions()) {
                 dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
                 auto region_clone = TRY(region.try_clone());
-                TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
+                // NOTE: The child's pages get mapped as it touches them, as it's likely to exec() before touching most of them.
+                TRY(region_clone->map_on_demand(child_space->page_directory()));
                 TRY(child_space->region_tree().place_specifically(*region_clone, region.range()));
                 auto* child_region = region_clone.leak_ptr();
 
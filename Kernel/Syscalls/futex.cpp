@@ -15,6 +15,50 @@ namespace Kernel {
 
 static Singleton<SpinlockProtected<HashMap<GlobalFutexKey, NonnullLockRefPtr<FutexQueue>>>> s_global_futex_queues;
 
+// A thread that waits for a priority-inheriting futex, and lends its priority to the thread that owns it.
+struct PriorityInheritingFutexWaiter {
+    Thread& thread;
+    Process& process;
+    FlatPtr user_address { 0 };
+    // Whom we lend our priority to. It's 0 between the owner unlocking the futex and the next one taking it.
+    ThreadID owner { 0 };
+
+    IntrusiveListNode<PriorityInheritingFutexWaiter> list_node {};
+};
+using PriorityInheritingFutexWaiterList = IntrusiveList<&PriorityInheritingFutexWaiter::list_node>;
+static Singleton<SpinlockProtected<PriorityInheritingFutexWaiterList>> s_priority_inheriting_futex_waiters;
+
+// An owner inherits the highest priority of everyone waiting for any of the priority-inheriting futexes it owns,
+// so this has to be done whenever one of them starts or stops waiting, or a futex changes hands.
+static void update_inherited_priority(PriorityInheritingFutexWaiterList const& waiters, Process& process, ThreadID owner_tid)
+{
+    if (owner_tid == 0)
+        return;
+    // NOTE: We only lend our priority to threads of our own process, so that nobody can boost arbitrary threads.
+    auto owner = Thread::from_tid(owner_tid);
+    if (!owner || &owner->process() != &process)
+        return;
+    u32 priority = 0;
+    for (auto& waiter : waiters) {
+        if (&waiter.process == &process && waiter.owner == owner_tid)
+            priority = max(priority, waiter.thread.effective_priority());
+    }
+    owner->set_inherited_priority(priority);
+}
+
+// Hands the waiters of a futex over to its new owner, or to nobody if it has none right now.
+static void set_priority_inheriting_futex_owner(Process& process, FlatPtr user_address, ThreadID previous_owner_tid, ThreadID new_owner_tid)
+{
+    s_priority_inheriting_futex_waiters->with([&](auto& waiters) {
+        for (auto& waiter : waiters) {
+            if (&waiter.process == &process && waiter.user_address == user_address)
+                waiter.owner = new_owner_tid;
+        }
+        update_inherited_priority(waiters, process, previous_owner_tid);
+        update_inherited_priority(waiters, process, new_owner_tid);
+    });
+}
+
 void Process::clear_futex_queues_on_exec()
 {
     s_global_futex_queues->with([this](auto& queues) {
@@ -106,12 +150,13 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     switch (cmd) {
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
-    case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_LOCK_PI: {
+        // NOTE: FUTEX_REQUEUE and FUTEX_CMP_REQUEUE don't take a timeout, they use the same field for val2 instead.
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
             bool is_absolute = cmd != FUTEX_WAIT;
-            clockid_t clock_id = use_realtime_clock ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
+            // The timeout of FUTEX_LOCK_PI is always measured against CLOCK_REALTIME.
+            clockid_t clock_id = use_realtime_clock || cmd == FUTEX_LOCK_PI ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
             timeout = Thread::BlockTimeout(is_absolute, &timeout_time, nullptr, clock_id);
         }
         if (cmd == FUTEX_WAIT_BITSET && params.val3 == FUTEX_BITSET_MATCH_ANY)
@@ -169,7 +214,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     auto user_address = FlatPtr(params.userspace_address);
     auto user_address2 = FlatPtr(params.userspace_address2);
 
-    auto do_wait = [&](u32 bitset) -> ErrorOr<FlatPtr> {
+    auto do_wait = [&](u32 expected_value, u32 bitset) -> ErrorOr<FlatPtr> {
         bool did_create;
         LockRefPtr<FutexQueue> futex_queue;
         auto futex_key = TRY(get_futex_key(user_address, shared));
@@ -177,8 +222,8 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
             auto user_value = user_atomic_load_relaxed(params.userspace_address);
             if (!user_value.has_value())
                 return EFAULT;
-            if (user_value.value() != params.val) {
-                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, params.val);
+            if (user_value.value() != expected_value) {
+                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, expected_value);
                 return EAGAIN;
             }
             atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
@@ -238,9 +283,92 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         return woken_or_requeued;
     };
 
+    auto* current_thread = Thread::current();
+    u32 current_tid = current_thread->tid().value();
+
+    auto do_lock_pi = [&]() -> ErrorOr<FlatPtr> {
+        u32 locked_value = current_tid;
+        for (;;) {
+            u32 owner_value = 0;
+            auto did_lock = user_atomic_compare_exchange_relaxed(params.userspace_address, owner_value, locked_value);
+            if (!did_lock.has_value())
+                return EFAULT;
+            if (did_lock.value()) {
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                // Whoever is still waiting lends their priority to us now.
+                if (locked_value & FUTEX_WAITERS)
+                    set_priority_inheriting_futex_owner(*this, user_address, 0, current_tid);
+                return 0;
+            }
+            if ((owner_value & FUTEX_TID_MASK) == current_tid)
+                return EDEADLK;
+
+            // Make sure the owner has to go through FUTEX_UNLOCK_PI, which wakes us up again.
+            if (!(owner_value & FUTEX_WAITERS)) {
+                u32 expected_value = owner_value;
+                auto did_mark = user_atomic_compare_exchange_relaxed(params.userspace_address, expected_value, owner_value | FUTEX_WAITERS);
+                if (!did_mark.has_value())
+                    return EFAULT;
+                if (!did_mark.value())
+                    continue;
+            }
+
+            // NOTE: The boost takes effect the next time the owner is put on a run queue.
+            PriorityInheritingFutexWaiter waiter { *current_thread, *this, user_address, owner_value & FUTEX_TID_MASK };
+            s_priority_inheriting_futex_waiters->with([&](auto& waiters) {
+                waiters.append(waiter);
+                update_inherited_priority(waiters, *this, waiter.owner);
+            });
+
+            auto result = do_wait(owner_value | FUTEX_WAITERS, FUTEX_BITSET_MATCH_ANY);
+
+            // However we stopped waiting, whoever owns the futex now doesn't get our priority anymore.
+            s_priority_inheriting_futex_waiters->with([&](auto& waiters) {
+                waiters.remove(waiter);
+                update_inherited_priority(waiters, *this, waiter.owner);
+            });
+
+            if (result.is_error() && result.error().code() != EAGAIN)
+                return result.release_error();
+
+            // There may be more threads waiting behind us, so whoever owns the futex next has to wake them.
+            locked_value = current_tid | FUTEX_WAITERS;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value())
+            return EFAULT;
+        if ((user_value.value() & FUTEX_TID_MASK) != current_tid)
+            return EPERM;
+
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        if (!user_atomic_store_relaxed(params.userspace_address, 0))
+            return EFAULT;
+        // We keep what we inherited through the other priority-inheriting futexes we still own.
+        set_priority_inheriting_futex_owner(*this, user_address, current_tid, 0);
+        TRY(do_wake(user_address, 1, {}));
+        return 0;
+    };
+
+    auto do_trylock_pi = [&]() -> ErrorOr<FlatPtr> {
+        u32 owner_value = 0;
+        auto did_lock = user_atomic_compare_exchange_relaxed(params.userspace_address, owner_value, current_tid);
+        if (!did_lock.has_value())
+            return EFAULT;
+        if (did_lock.value()) {
+            atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+            return 0;
+        }
+        if ((owner_value & FUTEX_TID_MASK) == current_tid)
+            return EDEADLK;
+        return EAGAIN;
+    };
+
     switch (cmd) {
     case FUTEX_WAIT:
-        return do_wait(0);
+        return do_wait(params.val, 0);
 
     case FUTEX_WAKE:
         return TRY(do_wake(user_address, params.val, {}));
@@ -317,13 +445,22 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAIT
         if (params.val3 == 0)
             return EINVAL;
-        return do_wait(params.val3);
+        return do_wait(params.val, params.val3);
 
     case FUTEX_WAKE_BITSET:
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAKE
         if (params.val3 == 0)
             return EINVAL;
         return TRY(do_wake(user_address, params.val, params.val3));
+
+    case FUTEX_LOCK_PI:
+        return do_lock_pi();
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
+    case FUTEX_TRYLOCK_PI:
+        return do_trylock_pi();
     }
     return ENOSYS;
 }
@@ -169,10 +169,15 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
     bool map_noreserve = flags & MAP_NORESERVE;
     bool map_randomized = flags & MAP_RANDOMIZED;
     bool map_fixed_noreplace = flags & MAP_FIXED_NOREPLACE;
+    bool map_huge_page = flags & MAP_HUGEPAGE;
+    bool map_no_huge_page = flags & MAP_NOHUGEPAGE;
 
     if (map_shared && map_private)
         return EINVAL;
 
+    if (map_huge_page && map_no_huge_page)
+        return EINVAL;
+
     if (!map_shared && !map_private)
         return EINVAL;
 
@@ -190,6 +195,15 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
         requested_range = { {}, rounded_size };
     }
 
+    // Private anonymous memory that is large enough gets huge pages, unless the caller opts out.
+    // MAP_HUGEPAGE asks for them even when it's a bit smaller, so that at least part of it can use one.
+    bool wants_huge_pages = map_anonymous && map_private && !map_stack && !map_no_huge_page
+        && !(flags & MAP_PURGEABLE) && (map_huge_page || rounded_size >= Memory::huge_page_size);
+    if (wants_huge_pages && rounded_size >= Memory::huge_page_size && requested_range.base().is_null() && alignment < Memory::huge_page_size && Memory::huge_page_size % alignment == 0) {
+        // Without proper alignment, the first and last huge page worth of the mapping would be wasted.
+        alignment = Memory::huge_page_size;
+    }
+
     Memory::Region* region = nullptr;
 
     LockRefPtr<OpenFileDescription> description;
@@ -254,6 +268,8 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
             region->set_shared(true);
         if (map_stack)
             region->set_stack(true);
+        if (wants_huge_pages)
+            region->set_wants_huge_pages(true);
         if (name)
             region->set_name(move(name));
 
@@ -409,12 +425,12 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
         return EFAULT;
 
     return address_space().with([&](auto& space) -> ErrorOr<FlatPtr> {
-        auto* region = space->find_region_from_range(range_to_madvise);
-        if (!region)
-            return EINVAL;
-        if (!region->is_mmap())
-            return EPERM;
         if (advice == MADV_SET_VOLATILE || advice == MADV_SET_NONVOLATILE) {
+            auto* region = space->find_region_from_range(range_to_madvise);
+            if (!region)
+                return EINVAL;
+            if (!region->is_mmap())
+                return EPERM;
             if (!region->vmobject().is_anonymous())
                 return EINVAL;
             auto& vmobject = static_cast<Memory::AnonymousVMObject&>(region->vmobject());
@@ -424,7 +440,44 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
             TRY(vmobject.set_volatile(advice == MADV_SET_VOLATILE, was_purged));
             return was_purged ? 1 : 0;
         }
-        return EINVAL;
+
+        // The standard advice values may be given for any part of a region.
+        // FIXME: Support ranges that span multiple regions.
+        auto* region = space->find_region_containing(range_to_madvise);
+        if (!region)
+            return ENOMEM;
+        if (!region->is_mmap())
+            return EPERM;
+
+        auto first_page_index = region->translate_to_vmobject_page(region->page_index_from_address(range_to_madvise.base()));
+        auto page_count = range_to_madvise.size() / PAGE_SIZE;
+
+        switch (advice) {
+        case MADV_NORMAL:
+            region->set_access_pattern(Memory::Region::AccessPattern::Normal);
+            return 0;
+        case MADV_SEQUENTIAL:
+            region->set_access_pattern(Memory::Region::AccessPattern::Sequential);
+            return 0;
+        case MADV_RANDOM:
+            region->set_access_pattern(Memory::Region::AccessPattern::Random);
+            return 0;
+        case MADV_WILLNEED:
+            if (region->vmobject().is_inode())
+                TRY(static_cast<Memory::InodeVMObject&>(region->vmobject()).read_ahead(first_page_index, page_count));
+            return 0;
+        case MADV_DONTNEED:
+            // NOTE: Shared mappings keep their contents, as other mappings of the same memory may still need them.
+            if (region->is_shared())
+                return 0;
+            if (region->vmobject().is_anonymous())
+                static_cast<Memory::AnonymousVMObject&>(region->vmobject()).release_pages(first_page_index, page_count);
+            else if (region->vmobject().is_inode())
+                static_cast<Memory::InodeVMObject&>(region->vmobject()).release_clean_pages_in_range(first_page_index, page_count);
+            return 0;
+        default:
+            return EINVAL;
+        }
     });
 }
 
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Checked.h>
+#include <AK/ScopeGuard.h>
+#include <Kernel/API/POSIX/spawn.h>
+#include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Net/LocalSocket.h>
+#include <Kernel/PerformanceManager.h>
+#include <Kernel/Process.h>
+#include <Kernel/ProcessGroup.h>
+#include <Kernel/Scheduler.h>
+#include <Kernel/TTY/TTY.h>
+#include <LibC/sys/ioctl_numbers.h>
+
+namespace Kernel {
+
+ErrorOr<void> Process::do_spawn_attributes(Syscall::SC_posix_spawn_params const& params, Thread& first_thread)
+{
+    if (params.flags & POSIX_SPAWN_SETSIGDEF) {
+        for (size_t signal = 1; signal < NSIG; ++signal) {
+            if (params.sigdefault & (1 << (signal - 1)))
+                m_signal_action_data[signal] = {};
+        }
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSIGMASK)
+        first_thread.update_signal_mask(params.sigmask);
+
+    if (params.flags & POSIX_SPAWN_SETSID) {
+        m_pg = TRY(ProcessGroup::try_create(ProcessGroupID(pid().value())));
+        m_tty = nullptr;
+        with_mutable_protected_data([&](auto& protected_data) {
+            protected_data.sid = pid().value();
+        });
+    }
+
+    if (params.flags & POSIX_SPAWN_SETPGROUP) {
+        if (params.pgroup < 0)
+            return EINVAL;
+        if (is_session_leader())
+            return EPERM;
+        ProcessGroupID new_pgid = params.pgroup ? ProcessGroupID(params.pgroup) : pid().value();
+        SessionID new_sid = get_sid_from_pgid(new_pgid);
+        if (new_sid != -1 && new_sid != sid()) {
+            // Can't move a process between sessions.
+            return EPERM;
+        }
+        if (new_sid == -1 && new_pgid != pid().value()) {
+            // The process group doesn't exist, and is not the one the child would be the leader of.
+            return EPERM;
+        }
+        m_pg = TRY(ProcessGroup::try_find_or_create(new_pgid));
+    }
+
+    return {};
+}
+
+ErrorOr<void> Process::do_spawn_file_action(Syscall::SC_posix_spawn_file_action const& action, KString const* path)
+{
+    switch (action.type) {
+    case Syscall::SpawnFileActionType::Close: {
+        // NOTE: Closing a file descriptor that isn't open is not an error here, it simply won't be inherited.
+        auto description_or_error = open_file_description(action.fd);
+        if (description_or_error.is_error())
+            return {};
+        auto result = description_or_error.value()->close();
+        m_fds.with_exclusive([&](auto& fds) { fds[action.fd] = {}; });
+        return result;
+    }
+    case Syscall::SpawnFileActionType::Dup2:
+        return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
+            auto description = TRY(fds.open_file_description(action.fd));
+            if (action.fd == action.new_fd) {
+                // dup2() onto itself leaves the descriptor open across the exec, even if it was FD_CLOEXEC.
+                fds[action.fd].set_flags(fds[action.fd].flags() & ~FD_CLOEXEC);
+                return {};
+            }
+            if (action.new_fd < 0 || static_cast<size_t>(action.new_fd) >= OpenFileDescriptions::max_open())
+                return EBADF;
+            if (!fds.m_fds_metadatas[action.new_fd].is_allocated())
+                fds.m_fds_metadatas[action.new_fd].allocate();
+            fds[action.new_fd].set(move(description));
+            return {};
+        });
+    case Syscall::SpawnFileActionType::Open: {
+        VERIFY(path);
+        if (action.fd < 0 || static_cast<size_t>(action.fd) >= OpenFileDescriptions::max_open())
+            return EBADF;
+        if (action.options & (O_NOFOLLOW_NOERROR | O_UNLINK_INTERNAL))
+            return EINVAL;
+        auto description = TRY(VirtualFileSystem::the().open(credentials(), path->view(), action.options, (action.mode & 0777) & ~umask(), current_directory()));
+        if (description->inode() && description->inode()->bound_socket())
+            return ENXIO;
+        return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
+            if (!fds.m_fds_metadatas[action.fd].is_allocated())
+                fds.m_fds_metadatas[action.fd].allocate();
+            u32 fd_flags = (action.options & O_CLOEXEC) ? FD_CLOEXEC : 0;
+            fds[action.fd].set(move(description), fd_flags);
+            return {};
+        });
+    }
+    case Syscall::SpawnFileActionType::Chdir: {
+        VERIFY(path);
+        RefPtr<Custody> new_directory = TRY(VirtualFileSystem::the().open_directory(credentials(), path->view(), current_directory()));
+        m_current_directory.with([&](auto& current_directory) {
+            // NOTE: We use swap() here to avoid manipulating the ref counts while holding the lock.
+            swap(current_directory, new_directory);
+        });
+        return {};
+    }
+    case Syscall::SpawnFileActionType::Fchdir: {
+        auto description = TRY(open_file_description(action.fd));
+        if (!description->is_directory())
+            return ENOTDIR;
+        if (!description->metadata().may_execute(credentials()))
+            return EACCES;
+        m_current_directory.with([&](auto& current_directory) {
+            current_directory = description->custody();
+        });
+        return {};
+    }
+    }
+    return EINVAL;
+}
+
+ErrorOr<FlatPtr> Process::sys$posix_spawn(Userspace<Syscall::SC_posix_spawn_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::proc));
+    TRY(require_promise(Pledge::exec));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.arguments.length > ARG_MAX || params.environment.length > ARG_MAX)
+        return E2BIG;
+
+    // NOTE: The caller is expected to always pass at least one argument by convention,
+    //       the program path that was passed as params.path.
+    if (params.arguments.length == 0)
+        return EINVAL;
+
+    if (params.flags & ~(POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSID | POSIX_SPAWN_TCSETPGROUP))
+        return EINVAL;
+
+    auto path = TRY(get_syscall_path_argument(params.path));
+
+    NonnullOwnPtrVector<KString> arguments;
+    TRY(copy_user_string_list(params.arguments, arguments));
+
+    NonnullOwnPtrVector<KString> environment;
+    TRY(copy_user_string_list(params.environment, environment));
+
+    // NOTE: Everything has to be copied out of our address space up front, exec() leaves us in the child's.
+    Vector<Syscall::SC_posix_spawn_file_action, 8> file_actions;
+    Vector<OwnPtr<KString>, 8> file_action_paths;
+    if (params.file_action_count) {
+        Checked<size_t> size = sizeof(*params.file_actions);
+        size *= params.file_action_count;
+        if (size.has_overflow())
+            return EOVERFLOW;
+        TRY(file_actions.try_resize(params.file_action_count));
+        TRY(file_action_paths.try_resize(params.file_action_count));
+        TRY(copy_from_user(file_actions.data(), params.file_actions, size.value()));
+        for (size_t i = 0; i < file_actions.size(); ++i) {
+            auto type = file_actions[i].type;
+            if (type == Syscall::SpawnFileActionType::Open || type == Syscall::SpawnFileActionType::Chdir)
+                file_action_paths[i] = TRY(get_syscall_path_argument(file_actions[i].path));
+        }
+    }
+
+    LockRefPtr<Thread> child_first_thread;
+
+    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
+        SpinlockLocker lock(g_scheduler_lock);
+        if (child_first_thread) {
+            child_first_thread->detach();
+            child_first_thread->set_state(Thread::State::Dying);
+        }
+    };
+
+    auto child = TRY(try_create_child(child_first_thread));
+
+    TRY(child->do_spawn_attributes(params, *child_first_thread));
+    for (size_t i = 0; i < file_actions.size(); ++i)
+        TRY(child->do_spawn_file_action(file_actions[i], file_action_paths[i].ptr()));
+
+    // NOTE: Unlike fork(), the child never gets a copy of our address space, exec() builds a new one for it.
+    Thread* new_main_thread = nullptr;
+    u32 prev_flags = 0;
+    auto result = child->exec(move(path), move(arguments), move(environment), new_main_thread, prev_flags);
+
+    // exec() enters the child's address space to set up its stack, so we have to come back before returning to userspace.
+    Memory::MemoryManager::enter_process_address_space(*this);
+    if (result.is_error())
+        return result.release_error();
+
+    if (prev_flags & 0x200)
+        sti();
+    Processor::leave_critical();
+
+    thread_finalizer_guard.disarm();
+
+    Process::register_new(*child);
+
+    PerformanceManager::add_process_created_event(*child);
+
+    if (params.flags & POSIX_SPAWN_TCSETPGROUP) {
+        // NOTE: This happens before the child gets to run, so it can't be stopped by reading from the terminal too early.
+        //       Failing to do so is not fatal though, the child has been created and the caller might not even have a terminal.
+        if (auto description_or_error = open_file_description(params.tty_fd); !description_or_error.is_error()) {
+            auto description = description_or_error.release_value();
+            (void)description->file().ioctl(*description, TIOCSPGRP, Userspace<void*>(static_cast<FlatPtr>(child->pgid().value())));
+        }
+    }
+
+    SpinlockLocker lock(g_scheduler_lock);
+    new_main_thread->set_affinity(Thread::current()->affinity());
+    new_main_thread->set_state(Thread::State::Runnable);
+
+    return child->pid().value();
+}
+
+}
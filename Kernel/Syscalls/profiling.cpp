@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/PerformanceCounters.h>
+#include <Kernel/ContinuousProfiler.h>
 #include <Kernel/Coredump.h>
 #include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
@@ -16,6 +18,19 @@ bool g_profiling_all_threads;
 PerformanceEventBuffer* g_global_perf_events;
 u64 g_profiling_event_mask;
 
+static bool s_profiling_all_threads_performance_counters;
+
+static bool is_any_process_being_profiled()
+{
+    return Process::all_instances().with([](auto const& list) {
+        for (auto const& process : list) {
+            if (process.is_profiling())
+                return true;
+        }
+        return false;
+    });
+}
+
 // NOTE: event_mask needs to be passed as a pointer as u64
 //       does not fit into a register on 32bit architectures.
 ErrorOr<FlatPtr> Process::sys$profiling_enable(pid_t pid, Userspace<u64 const*> userspace_event_mask)
@@ -32,6 +47,23 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
 
+    if (pid == PROFILING_CONTINUOUS_PID) {
+        auto credentials = this->credentials();
+        if (!credentials->is_superuser())
+            return EPERM;
+        // The continuous profiler only collects samples, the process events are generated when draining.
+        if (event_mask != PERF_EVENT_SAMPLE)
+            return EINVAL;
+        // All kinds of profiling share the event mask, so the continuous profiler can't run alongside the others.
+        if (g_profiling_all_threads || is_any_process_being_profiled())
+            return EBUSY;
+        TRY(ContinuousProfiler::enable());
+        return 0;
+    }
+
+    if (ContinuousProfiler::is_enabled())
+        return EBUSY;
+
     if (pid == -1) {
         auto credentials = this->credentials();
         if (!credentials->is_superuser())
@@ -49,8 +81,21 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
         }
 
         SpinlockLocker lock(g_profiling_lock);
-        if (!TimeManagement::the().enable_profile_timer())
+        if (s_profiling_all_threads_performance_counters) {
+            PerformanceCounters::disable();
+            s_profiling_all_threads_performance_counters = false;
+        }
+        if ((event_mask & PerformanceCounters::event_mask) != 0) {
+            TRY(PerformanceCounters::enable(event_mask));
+            s_profiling_all_threads_performance_counters = true;
+        }
+        if (!TimeManagement::the().enable_profile_timer()) {
+            if (s_profiling_all_threads_performance_counters) {
+                PerformanceCounters::disable();
+                s_profiling_all_threads_performance_counters = false;
+            }
             return ENOTSUP;
+        }
         g_profiling_all_threads = true;
         PerformanceManager::add_process_created_event(*Scheduler::colonel());
         TRY(Process::for_each_in_same_jail([](auto& process) -> ErrorOr<void> {
@@ -78,7 +123,22 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
         return ENOMEM;
     }
     g_profiling_event_mask = event_mask;
+    if (process->is_profiling_performance_counters()) {
+        PerformanceCounters::disable();
+        process->set_profiling_performance_counters(false);
+    }
+    if ((event_mask & PerformanceCounters::event_mask) != 0) {
+        if (auto result = PerformanceCounters::enable(event_mask); result.is_error()) {
+            process->set_profiling(false);
+            return result.release_error();
+        }
+        process->set_profiling_performance_counters(true);
+    }
     if (!TimeManagement::the().enable_profile_timer()) {
+        if (process->is_profiling_performance_counters()) {
+            PerformanceCounters::disable();
+            process->set_profiling_performance_counters(false);
+        }
         process->set_profiling(false);
         return ENOTSUP;
     }
@@ -90,6 +150,14 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_no_promises());
 
+    if (pid == PROFILING_CONTINUOUS_PID) {
+        auto credentials = this->credentials();
+        if (!credentials->is_superuser())
+            return EPERM;
+        TRY(ContinuousProfiler::disable());
+        return 0;
+    }
+
     if (pid == -1) {
         auto credentials = this->credentials();
         if (!credentials->is_superuser())
@@ -97,6 +165,10 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
         ScopedCritical critical;
         if (!TimeManagement::the().disable_profile_timer())
             return ENOTSUP;
+        if (s_profiling_all_threads_performance_counters) {
+            PerformanceCounters::disable();
+            s_profiling_all_threads_performance_counters = false;
+        }
         g_profiling_all_threads = false;
         return 0;
     }
@@ -114,6 +186,10 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     // FIXME: If we enabled the profile timer and it's not supported, how do we disable it now?
     if (!TimeManagement::the().disable_profile_timer())
         return ENOTSUP;
+    if (process->is_profiling_performance_counters()) {
+        PerformanceCounters::disable();
+        process->set_profiling_performance_counters(false);
+    }
     process->set_profiling(false);
     return 0;
 }
@@ -123,6 +199,14 @@ ErrorOr<FlatPtr> Process::sys$profiling_free_buffer(pid_t pid)
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
     TRY(require_no_promises());
 
+    if (pid == PROFILING_CONTINUOUS_PID) {
+        auto credentials = this->credentials();
+        if (!credentials->is_superuser())
+            return EPERM;
+        TRY(ContinuousProfiler::free_buffers());
+        return 0;
+    }
+
     if (pid == -1) {
         auto credentials = this->credentials();
         if (!credentials->is_superuser())
@@ -6,12 +6,14 @@
  */
 
 #include <AK/ScopeGuard.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/Memory/PrivateInodeVMObject.h>
 #include <Kernel/Memory/Region.h>
 #include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Process.h>
 #include <Kernel/Scheduler.h>
+#include <Kernel/SyscallTraceBuffer.h>
 #include <Kernel/ThreadTracer.h>
 
 namespace Kernel {
@@ -151,6 +153,21 @@ static ErrorOr<FlatPtr> handle_ptrace(Kernel::Syscall::SC_ptrace_params const& p
     case PT_POKEDEBUG:
         TRY(peer->poke_debug_register(reinterpret_cast<uintptr_t>(params.addr), params.data));
         return 0;
+
+    case PT_SYSCALL_TRACE_BUFFER: {
+        // NOTE: The buffer is shared by every thread of the process, and replaces the one the tracer had before, if any.
+        auto buffer = TRY(SyscallTraceBuffer::try_create(static_cast<u32>(reinterpret_cast<FlatPtr>(params.addr))));
+        auto description = TRY(OpenFileDescription::try_create(*buffer));
+        description->set_readable(true);
+
+        auto fd = TRY(caller.fds().with_exclusive([&](auto& fds) -> ErrorOr<int> {
+            auto new_fd = TRY(fds.allocate());
+            fds[new_fd.fd].set(move(description), FD_CLOEXEC);
+            return new_fd.fd;
+        }));
+        tracer->set_syscall_trace_buffer(move(buffer));
+        return fd;
+    }
     default:
         return EINVAL;
     }
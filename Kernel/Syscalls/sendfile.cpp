@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// The file is moved through a kernel buffer of (at most) this size at a time.
+static constexpr size_t sendfile_chunk_size = 64 * KiB;
+
+// NOTE: The offset is passed by pointer because off_t is 64bit,
+// hence it can't be passed by register on 32bit platforms.
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> userspace_offset, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    if (count == 0)
+        return 0;
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+    // NOTE: Reading from the input must never block, so only regular files (and the like) are supported.
+    if (!in_description->file().is_seekable())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    off_t offset = 0;
+    if (userspace_offset) {
+        offset = TRY(copy_typed_from_user(userspace_offset));
+        if (offset < 0)
+            return EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", out_fd, in_fd, offset, count);
+
+    // The data goes straight from the file (and thereby the disk cache) into a kernel buffer, and
+    // from there into the output, without ever making a round-trip through userspace.
+    auto chunk_size = min(count, sendfile_chunk_size);
+    auto chunk = TRY(KBuffer::try_create_with_size("sendfile"sv, chunk_size));
+    auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(chunk->data());
+
+    size_t total_sent = 0;
+    Optional<Error> error;
+    while (total_sent < count) {
+        auto nread_or_error = in_description->read(chunk_buffer, offset + total_sent, min(count - total_sent, chunk_size));
+        if (nread_or_error.is_error()) {
+            error = nread_or_error.release_error();
+            break;
+        }
+        auto nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, chunk_buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            error = nwritten_or_error.release_error();
+            break;
+        }
+        total_sent += nwritten_or_error.value();
+        if (nwritten_or_error.value() < nread)
+            break;
+    }
+
+    // Like pread(), sendfile() with an explicit offset doesn't touch the file offset of the input.
+    if (userspace_offset) {
+        off_t new_offset = offset + total_sent;
+        TRY(copy_to_user(userspace_offset, &new_offset));
+    } else {
+        TRY(in_description->seek(offset + total_sent, SEEK_SET));
+    }
+
+    if (error.has_value() && total_sent == 0)
+        return error.release_value();
+    return total_sent;
+}
+
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/IORing.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/IORingTask.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT void IORingTask::spawn()
+{
+    LockRefPtr<Thread> io_ring_thread;
+    (void)Process::create_kernel_process(io_ring_thread, KString::must_create("IORing Task"sv), [] {
+        dbgln("IORingTask is running");
+        for (;;)
+            IORing::service_pending_operations({});
+    });
+}
+
+}
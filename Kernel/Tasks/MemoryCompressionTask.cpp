@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Memory/CompressedPageStore.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Process.h>
+#include <Kernel/Scheduler.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/MemoryCompressionTask.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+// How many pages we try to compress at a time while memory is running low.
+static constexpr size_t pages_per_pass = 256;
+
+static bool is_memory_running_low()
+{
+    auto info = MM.get_system_memory_info();
+    return info.physical_pages - info.physical_pages_used < info.physical_pages / 8;
+}
+
+UNMAP_AFTER_INIT void MemoryCompressionTask::spawn()
+{
+    LockRefPtr<Thread> memory_compression_thread;
+    (void)Process::create_kernel_process(memory_compression_thread, KString::must_create("Memory Compression Task"sv), [] {
+        dbgln("MemoryCompressionTask is running");
+        Thread::current()->set_priority(THREAD_PRIORITY_LOW);
+
+        auto* workspace = static_cast<Memory::CompressedPageStore::Workspace*>(kmalloc(sizeof(Memory::CompressedPageStore::Workspace)));
+        VERIFY(workspace);
+
+        for (;;) {
+            if (is_memory_running_low())
+                Memory::CompressedPageStore::compress_cold_pages(*workspace, pages_per_pass);
+            (void)Thread::current()->sleep(Time::from_milliseconds(250));
+        }
+    });
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Process.h>
+#include <Kernel/Scheduler.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT void PageZeroingTask::spawn()
+{
+    LockRefPtr<Thread> page_zeroing_thread;
+    (void)Process::create_kernel_process(page_zeroing_thread, KString::must_create("Page Zeroing Task"sv), [] {
+        dbgln("PageZeroingTask is running");
+        // NOTE: We only want to run when there's nothing better to do.
+        Thread::current()->set_priority(THREAD_PRIORITY_MIN);
+        for (;;) {
+            // Refill in small batches, giving way to anyone else who wants to run in between.
+            if (MM.refill_zeroed_page_pool(16) > 0) {
+                Scheduler::yield();
+                continue;
+            }
+            // The pool is full (or there's no free memory), check back later.
+            (void)Thread::current()->sleep(Time::from_milliseconds(50));
+        }
+    });
+}
+
+}
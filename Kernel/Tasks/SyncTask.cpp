@@ -19,7 +19,9 @@ UNMAP_AFTER_INIT void SyncTask::spawn()
         dbgln("VFS SyncTask is running");
         for (;;) {
             VirtualFileSystem::sync();
-            (void)Thread::current()->sleep(Time::from_seconds(1));
+            // NOTE: Dirty blocks are written back continuously by the WriteBackTask,
+            //       so this only has to pick up filesystem metadata and stragglers.
+            (void)Thread::current()->sleep(Time::from_seconds(5));
         }
     });
 }
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/WriteBackTask.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT void WriteBackTask::spawn()
+{
+    LockRefPtr<Thread> write_back_thread;
+    (void)Process::create_kernel_process(write_back_thread, KString::must_create("VFS Write-back Task"sv), [] {
+        dbgln("VFS WriteBackTask is running");
+        Thread::current()->set_priority(THREAD_PRIORITY_LOW);
+        for (;;) {
+            VirtualFileSystem::the().write_back_filesystems();
+            (void)Thread::current()->sleep(Time::from_milliseconds(250));
+        }
+    });
+}
+
+}
@@ -136,6 +136,7 @@ class Thread
     friend class Process;
     friend class Scheduler;
     friend struct ThreadReadyQueue;
+    friend struct ThreadReadyQueues;
 
 public:
     inline static Thread* current()
@@ -155,6 +156,11 @@ public:
     void set_priority(u32 p) { m_priority = p; }
     u32 priority() const { return m_priority; }
 
+    // The priority the scheduler actually uses. It is raised above our own priority while we own
+    // a priority-inheriting futex that a thread with a higher priority is waiting for.
+    u32 effective_priority() const { return max(m_priority, m_inherited_priority.load(AK::MemoryOrder::memory_order_relaxed)); }
+    void set_inherited_priority(u32 priority) { m_inherited_priority.store(priority, AK::MemoryOrder::memory_order_relaxed); }
+
     void detach()
     {
         SpinlockLocker lock(m_lock);
@@ -1172,6 +1178,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_processor { 0 };
 
     friend class WaitQueue;
 
@@ -1306,6 +1313,7 @@ private:
     State m_state { Thread::State::Invalid };
     NonnullOwnPtr<KString> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    Atomic<u32> m_inherited_priority { 0 };
 
     State m_stop_state { Thread::State::Invalid };
 
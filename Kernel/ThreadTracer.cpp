@@ -5,6 +5,7 @@
  */
 
 #include <Kernel/Arch/RegisterState.h>
+#include <Kernel/SyscallTraceBuffer.h>
 #include <Kernel/ThreadTracer.h>
 
 namespace Kernel {
@@ -14,6 +15,18 @@ ThreadTracer::ThreadTracer(ProcessID tracer_pid)
 {
 }
 
+ThreadTracer::~ThreadTracer() = default;
+
+LockRefPtr<SyscallTraceBuffer> ThreadTracer::syscall_trace_buffer() const
+{
+    return m_syscall_trace_buffer;
+}
+
+void ThreadTracer::set_syscall_trace_buffer(LockRefPtr<SyscallTraceBuffer> buffer)
+{
+    m_syscall_trace_buffer = move(buffer);
+}
+
 void ThreadTracer::set_regs(RegisterState const& regs)
 {
     PtraceRegisters r {};
@@ -10,6 +10,7 @@
 #include <AK/OwnPtr.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Forward.h>
+#include <Kernel/Library/LockRefPtr.h>
 #include <LibC/sys/arch/i386/regs.h>
 
 namespace Kernel {
@@ -17,6 +18,7 @@ namespace Kernel {
 class ThreadTracer {
 public:
     static ErrorOr<NonnullOwnPtr<ThreadTracer>> try_create(ProcessID tracer) { return adopt_nonnull_own_or_enomem(new (nothrow) ThreadTracer(tracer)); }
+    ~ThreadTracer();
 
     ProcessID tracer_pid() const { return m_tracer_pid; }
     bool has_pending_signal(u32 signal) const { return (m_pending_signals & (1 << (signal - 1))) != 0; }
@@ -26,6 +28,9 @@ public:
     bool is_tracing_syscalls() const { return m_trace_syscalls; }
     void set_trace_syscalls(bool val) { m_trace_syscalls = val; }
 
+    LockRefPtr<SyscallTraceBuffer> syscall_trace_buffer() const;
+    void set_syscall_trace_buffer(LockRefPtr<SyscallTraceBuffer>);
+
     void set_regs(RegisterState const& regs);
     void set_regs(PtraceRegisters const& regs) { m_regs = regs; }
     bool has_regs() const { return m_regs.has_value(); }
@@ -46,6 +51,7 @@ private:
     u32 m_pending_signals { 0 };
 
     bool m_trace_syscalls { false };
+    LockRefPtr<SyscallTraceBuffer> m_syscall_trace_buffer;
     Optional<PtraceRegisters> m_regs;
 };
 
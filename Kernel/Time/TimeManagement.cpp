@@ -189,6 +189,12 @@ UNMAP_AFTER_INIT void TimeManagement::initialize([[maybe_unused]] u32 cpu)
             if (auto* apic_timer = APIC::the().initialize_timers(*s_the->m_system_timer)) {
                 dmesgln("Time: Using APIC timer as system timer");
                 s_the->set_system_timer(*apic_timer);
+                // Arming the timer for individual events only makes sense if we can tell precisely when they are due.
+                if (s_the->m_can_query_precise_time) {
+                    dmesgln("Time: Using APIC timers in one-shot mode for tickless idle and high-resolution timers");
+                    apic_timer->set_non_periodic();
+                    s_the->m_one_shot_apic_timer = apic_timer;
+                }
             }
         }
     } else {
@@ -365,6 +371,9 @@ UNMAP_AFTER_INIT bool TimeManagement::probe_and_set_x86_non_legacy_hardware_time
     m_can_query_precise_time = true;
     m_time_ticks_per_second = HPET::the().frequency();
 
+    // Only an invariant TSC ticks at a fixed rate, regardless of power states and frequency scaling.
+    m_can_calibrate_tsc = Processor::current().has_feature(CPUFeature::TSC) && Processor::current().has_feature(CPUFeature::CONSTANT_TSC);
+
     m_system_timer->try_to_set_frequency(m_system_timer->calculate_nearest_possible_frequency(OPTIMAL_TICKS_PER_SECOND_RATE));
 
     // We don't need an interrupt for time keeping purposes because we
@@ -435,8 +444,47 @@ void TimeManagement::increment_time_since_boot_hpet()
 
     m_update1.store(update_iteration + 1, AK::MemoryOrder::memory_order_release);
 
+    calibrate_tsc_for_time_page();
     update_time_page();
 }
+
+void TimeManagement::calibrate_tsc_for_time_page()
+{
+    // How long we measure the TSC against the HPET before trusting its frequency.
+    static constexpr u64 calibration_period_ns = 1'000'000'000;
+
+    if (!m_can_calibrate_tsc || m_tsc_is_calibrated)
+        return;
+
+    auto now_ns = static_cast<u64>(monotonic_time(TimePrecision::Coarse).to_nanoseconds());
+    auto tsc = read_tsc();
+    if (m_tsc_calibration_start_tsc == 0) {
+        m_tsc_calibration_start_tsc = tsc;
+        m_tsc_calibration_start_ns = now_ns;
+        return;
+    }
+
+    auto elapsed_ns = now_ns - m_tsc_calibration_start_ns;
+    if (elapsed_ns < calibration_period_ns)
+        return;
+    auto elapsed_tsc = tsc - m_tsc_calibration_start_tsc;
+    if (elapsed_tsc == 0) {
+        m_can_calibrate_tsc = false;
+        return;
+    }
+
+    // Use the largest shift for which the multiplier still fits into 32 bits, to keep as much precision as possible.
+    u8 shift = 32;
+    u64 multiplier = (elapsed_ns << shift) / elapsed_tsc;
+    while (multiplier > NumericLimits<u32>::max()) {
+        multiplier >>= 1;
+        --shift;
+    }
+    m_tsc_to_ns_multiplier = static_cast<u32>(multiplier);
+    m_tsc_to_ns_shift = shift;
+    m_tsc_is_calibrated = true;
+    dmesgln("Time: TSC runs at {} kHz, precise time can be read from the time page", elapsed_tsc * 1'000'000 / elapsed_ns);
+}
 #elif ARCH(AARCH64)
 UNMAP_AFTER_INIT bool TimeManagement::probe_and_set_aarch64_hardware_timers()
 {
@@ -510,6 +558,76 @@ void TimeManagement::system_timer_tick(RegisterState const& regs)
         TimerQueue::the().fire();
     }
     Scheduler::timer_tick(regs);
+    the().arm_next_timer_event(false);
+}
+
+#if ARCH(I386) || ARCH(X86_64)
+// Arming the timer for a deadline that has already passed still has to leave us some time to return from the interrupt.
+static constexpr Time minimum_timer_event_delay = Time::from_microseconds(10);
+#endif
+
+void TimeManagement::arm_next_timer_event([[maybe_unused]] bool for_idle)
+{
+#if ARCH(I386) || ARCH(X86_64)
+    // How long an idle processor may sleep if there is no timer due before then.
+    static constexpr Time maximum_idle_period = Time::from_seconds(1);
+
+    if (!m_one_shot_apic_timer)
+        return;
+    auto delay = for_idle ? maximum_idle_period : m_one_shot_apic_timer->tick_period();
+    if (auto time_until_deadline = TimerQueue::the().time_until_next_deadline(); time_until_deadline.has_value())
+        delay = min(delay, max(time_until_deadline.value(), minimum_timer_event_delay));
+    m_one_shot_apic_timer->arm_local_timer(delay);
+#endif
+}
+
+bool TimeManagement::stop_tick_for_idle()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+#if ARCH(I386) || ARCH(X86_64)
+    if (!m_one_shot_apic_timer)
+        return false;
+    if (Processor::is_bootstrap_processor()) {
+        // NOTE: Whoever leaves idle after we checked sees the flag, see restart_tick_after_idle().
+        m_bootstrap_processor_tick_stopped.store(true, AK::MemoryOrder::memory_order_seq_cst);
+        if (!Processor::are_other_processors_idle()) {
+            m_bootstrap_processor_tick_stopped.store(false, AK::MemoryOrder::memory_order_relaxed);
+            return false;
+        }
+    }
+    arm_next_timer_event(true);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TimeManagement::restart_tick_after_idle()
+{
+#if ARCH(I386) || ARCH(X86_64)
+    VERIFY(m_one_shot_apic_timer);
+    InterruptDisabler disabler;
+    if (Processor::is_bootstrap_processor()) {
+        m_bootstrap_processor_tick_stopped.store(false, AK::MemoryOrder::memory_order_relaxed);
+    } else {
+        // The time only moves on while the bootstrap processor ticks, so wake it up if it's sleeping.
+        AK::atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+        if (m_bootstrap_processor_tick_stopped.exchange(false, AK::MemoryOrder::memory_order_relaxed))
+            APIC::the().send_ipi(0);
+    }
+    arm_next_timer_event(false);
+#endif
+}
+
+void TimeManagement::timer_deadline_added([[maybe_unused]] Time const& time_until_deadline)
+{
+#if ARCH(I386) || ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    if (!m_one_shot_apic_timer)
+        return;
+    if (time_until_deadline < m_one_shot_apic_timer->local_time_until_interrupt())
+        m_one_shot_apic_timer->arm_local_timer(max(time_until_deadline, minimum_timer_event_delay));
+#endif
 }
 
 bool TimeManagement::enable_profile_timer()
@@ -534,8 +652,26 @@ void TimeManagement::update_time_page()
 {
     auto& page = time_page();
     u32 update_iteration = AK::atomic_fetch_add(&page.update2, 1u, AK::MemoryOrder::memory_order_acquire);
+    auto coarse_monotonic_time = monotonic_time(TimePrecision::Coarse);
     page.clocks[CLOCK_REALTIME_COARSE] = m_epoch_time;
-    page.clocks[CLOCK_MONOTONIC_COARSE] = monotonic_time(TimePrecision::Coarse).to_timespec();
+    page.clocks[CLOCK_MONOTONIC_COARSE] = coarse_monotonic_time.to_timespec();
+#if ARCH(I386) || ARCH(X86_64)
+    if (m_tsc_is_calibrated) {
+        // NOTE: Userspace adds the time since tsc_at_update to the precise clocks, so they have to be what the clocks
+        //       read at that very moment, not at the last tick. Reading the HPET takes a while, so we take the TSC
+        //       from halfway through it.
+        auto tsc_before = read_tsc();
+        auto precise_monotonic_time = monotonic_time(TimePrecision::Precise);
+        auto tsc_after = read_tsc();
+        auto time_since_tick = precise_monotonic_time - coarse_monotonic_time;
+        page.clocks[CLOCK_REALTIME] = (Time::from_timespec(m_epoch_time) + time_since_tick).to_timespec();
+        page.clocks[CLOCK_MONOTONIC] = precise_monotonic_time.to_timespec();
+        page.tsc_at_update = tsc_before + (tsc_after - tsc_before) / 2;
+        page.tsc_to_ns_multiplier = m_tsc_to_ns_multiplier;
+        page.tsc_to_ns_shift = m_tsc_to_ns_shift;
+        page.tsc_is_usable = true;
+    }
+#endif
     AK::atomic_store(&page.update1, update_iteration + 1u, AK::MemoryOrder::memory_order_release);
 }
 
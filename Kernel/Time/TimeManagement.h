@@ -24,6 +24,9 @@ namespace Kernel {
 #define OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE 1000
 
 class HardwareTimerBase;
+#if ARCH(I386) || ARCH(X86_64)
+class APICTimer;
+#endif
 
 enum class TimePrecision {
     Coarse = 0,
@@ -75,6 +78,13 @@ public:
 
     bool can_query_precise_time() const { return m_can_query_precise_time; }
 
+    // When the system timer of each processor can be armed for individual events, processors don't tick
+    // while they are idle, and timers fire at their actual deadline instead of on the next tick.
+    // Must be called with interrupts disabled. Returns whether the tick of the current processor was stopped.
+    bool stop_tick_for_idle();
+    void restart_tick_after_idle();
+    void timer_deadline_added(Time const& time_until_deadline);
+
     Memory::VMObject& time_page_vmobject();
 
 private:
@@ -85,6 +95,7 @@ private:
     bool probe_and_set_x86_legacy_hardware_timers();
     bool probe_and_set_x86_non_legacy_hardware_timers();
     void increment_time_since_boot_hpet();
+    void calibrate_tsc_for_time_page();
     static void update_time(RegisterState const&);
 #elif ARCH(AARCH64)
     bool probe_and_set_aarch64_hardware_timers();
@@ -96,6 +107,7 @@ private:
     NonnullLockRefPtrVector<HardwareTimerBase> m_hardware_timers;
     void set_system_timer(HardwareTimerBase&);
     static void system_timer_tick(RegisterState const&);
+    void arm_next_timer_event(bool for_idle);
 
     static u64 scheduling_current_time(bool);
 
@@ -113,6 +125,22 @@ private:
     bool m_can_query_precise_time { false };
     bool m_updating_time { false }; // may only be accessed from the BSP!
 
+#if ARCH(I386) || ARCH(X86_64)
+    // The TSC is calibrated against the HPET, so that userspace can extrapolate precise time from the time page.
+    // These may only be accessed from the BSP!
+    bool m_can_calibrate_tsc { false };
+    bool m_tsc_is_calibrated { false };
+    u64 m_tsc_calibration_start_tsc { 0 };
+    u64 m_tsc_calibration_start_ns { 0 };
+    u32 m_tsc_to_ns_multiplier { 0 };
+    u8 m_tsc_to_ns_shift { 0 };
+
+    // Set if the local APIC timers run in one-shot mode, see stop_tick_for_idle().
+    APICTimer* m_one_shot_apic_timer { nullptr };
+    // The bootstrap processor keeps the time, so it only stops its tick while all other processors are idle.
+    Atomic<bool> m_bootstrap_processor_tick_stopped { false };
+#endif
+
     LockRefPtr<HardwareTimerBase> m_system_timer;
     LockRefPtr<HardwareTimerBase> m_time_keeper_timer;
 
@@ -21,26 +21,20 @@ Time Timer::remaining() const
     return m_remaining;
 }
 
-Time Timer::now(bool is_firing) const
+Time Timer::now() const
 {
-    // NOTE: If is_firing is true then TimePrecision::Precise isn't really useful here.
-    // We already have a quite precise time stamp because we just updated the time in the
-    // interrupt handler. In those cases, just use coarse timestamps.
+    // NOTE: Timers may fire from an interrupt that was armed for their exact deadline, which might not
+    //       be a regular tick. So the coarse time may not have caught up yet, and we need precise time.
     auto clock_id = m_clock_id;
-    if (is_firing) {
-        switch (clock_id) {
-        case CLOCK_MONOTONIC:
-            clock_id = CLOCK_MONOTONIC_COARSE;
-            break;
-        case CLOCK_MONOTONIC_RAW:
-            // TODO: use a special CLOCK_MONOTONIC_RAW_COARSE like mechanism here
-            break;
-        case CLOCK_REALTIME:
-            clock_id = CLOCK_REALTIME_COARSE;
-            break;
-        default:
-            break;
-        }
+    switch (clock_id) {
+    case CLOCK_MONOTONIC_COARSE:
+        clock_id = CLOCK_MONOTONIC;
+        break;
+    case CLOCK_REALTIME_COARSE:
+        clock_id = CLOCK_REALTIME;
+        break;
+    default:
+        break;
     }
     return TimeManagement::the().current_time(clock_id);
 }
@@ -113,6 +107,30 @@ void TimerQueue::add_timer_locked(NonnullLockRefPtr<Timer> timer)
             queue.list.append(timer.leak_ref());
         }
     }
+
+    // The new timer might be due before this processor is going to be interrupted next.
+    if (queue.list.first()->m_expires == timer_expiration) {
+        auto now = queue.list.first()->now();
+        TimeManagement::the().timer_deadline_added(timer_expiration > now ? timer_expiration - now : Time::zero());
+    }
+}
+
+Optional<Time> TimerQueue::time_until_next_deadline()
+{
+    SpinlockLocker lock(g_timerqueue_lock);
+    Optional<Time> time_until_deadline;
+    auto consider_queue = [&](Queue& queue) {
+        auto* timer = queue.list.first();
+        if (!timer)
+            return;
+        auto now = timer->now();
+        auto time_until_timer = timer->m_expires > now ? timer->m_expires - now : Time::zero();
+        if (!time_until_deadline.has_value() || time_until_timer < time_until_deadline.value())
+            time_until_deadline = time_until_timer;
+    };
+    consider_queue(m_timer_queue_monotonic);
+    consider_queue(m_timer_queue_realtime);
+    return time_until_deadline;
 }
 
 bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
@@ -162,7 +180,7 @@ void TimerQueue::remove_timer_locked(Queue& queue, Timer& timer)
 {
     bool was_next_timer = (queue.list.first() == &timer);
     queue.list.remove(timer);
-    auto now = timer.now(false);
+    auto now = timer.now();
     if (timer.m_expires > now)
         timer.m_remaining = timer.m_expires - now;
 
@@ -183,7 +201,7 @@ void TimerQueue::fire()
         VERIFY(timer);
         VERIFY(queue.next_timer_due == timer->m_expires);
 
-        while (timer && timer->now(true) > timer->m_expires) {
+        while (timer && timer->now() >= timer->m_expires) {
             queue.list.remove(*timer);
 
             m_timers_executing.append(*timer);
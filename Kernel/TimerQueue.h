@@ -71,7 +71,7 @@ private:
     void clear_callback_finished() { m_callback_finished.store(false, AK::memory_order_release); }
     void set_callback_finished() { m_callback_finished.store(true, AK::memory_order_release); }
 
-    Time now(bool) const;
+    Time now() const;
 
     bool is_queued() const { return m_list_node.is_in_list(); }
 
@@ -92,6 +92,8 @@ public:
     bool cancel_timer(Timer& timer, bool* was_in_use = nullptr);
     void fire();
 
+    Optional<Time> time_until_next_deadline();
+
 private:
     struct Queue {
         Timer::List list;
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Process.h>
 #include <Kernel/Sections.h>
 #include <Kernel/WaitQueue.h>
@@ -15,46 +16,197 @@ namespace Kernel {
 WorkQueue* g_io_work;
 WorkQueue* g_ata_work;
 
+// A pool never grows beyond this many workers, no matter how many of them are stuck.
+static constexpr u32 max_workers_per_pool = 8;
+// How often the manager looks at pools that have pending items but no idle workers.
+static constexpr u64 stall_check_interval_ms = 10;
+// Workers that were spawned on demand exit again after being idle for this long.
+static constexpr u64 spawned_worker_idle_timeout_ms = 5000;
+
 UNMAP_AFTER_INIT void WorkQueue::initialize()
 {
-    g_io_work = new WorkQueue("IO WorkQueue Task"sv);
-    g_ata_work = new WorkQueue("ATA WorkQueue Task"sv);
+    g_io_work = new WorkQueue("IO WorkQueue Task"sv, Concurrency::PerProcessor);
+    // NOTE: The ATA work has to be done in order, as each item drives the port through the next step of a request.
+    g_ata_work = new WorkQueue("ATA WorkQueue Task"sv, Concurrency::Ordered);
 }
 
-UNMAP_AFTER_INIT WorkQueue::WorkQueue(StringView name)
+UNMAP_AFTER_INIT WorkQueue::WorkQueue(StringView name, Concurrency concurrency)
+    : m_name(KString::must_create(name))
+    , m_concurrency(concurrency)
 {
+    // NOTE: Workers are bound to their processor through the thread affinity mask, which limits how many pools we can have.
+    auto pool_count = concurrency == Concurrency::PerProcessor ? min<u32>(Processor::count(), sizeof(u32) * 8) : 1;
+    for (u32 processor_id = 0; processor_id < pool_count; ++processor_id)
+        m_pools.append(MUST(adopt_nonnull_own_or_enomem(new (nothrow) Pool(*this, processor_id))));
+
     LockRefPtr<Thread> thread;
-    auto name_kstring = KString::try_create(name);
-    if (name_kstring.is_error())
-        TODO();
-    (void)Process::create_kernel_process(thread, name_kstring.release_value(), [this] {
-        for (;;) {
-            WorkItem* item;
-            bool have_more;
-            m_items.with([&](auto& items) {
-                item = items.take_first();
-                have_more = !items.is_empty();
-            });
-            if (item) {
-                item->function();
-                delete item;
-
-                if (have_more)
-                    continue;
-            }
-            [[maybe_unused]] auto result = m_wait_queue.wait_on({});
-        }
-    });
+    if (concurrency == Concurrency::Ordered) {
+        m_pools.first()->worker_count = 1;
+        m_process = Process::create_kernel_process(thread, KString::must_create(name), [this] {
+            run_worker(*m_pools.first(), false);
+        });
+    } else {
+        m_process = Process::create_kernel_process(thread, KString::must_create(name), [this] {
+            run_manager();
+        });
+    }
     // If we can't create the thread we're in trouble...
     m_thread = thread.release_nonnull();
+
+    if (concurrency == Concurrency::PerProcessor) {
+        for (auto& pool : m_pools)
+            MUST(spawn_worker(*pool, true));
+    }
+}
+
+WorkQueue::Pool& WorkQueue::pool_for_current_processor()
+{
+    if (m_pools.size() == 1)
+        return *m_pools.first();
+    auto processor_id = Processor::current_id();
+    if (processor_id >= m_pools.size())
+        return *m_pools.first();
+    return *m_pools[processor_id];
+}
+
+bool WorkQueue::has_pending_items(Pool& pool)
+{
+    return pool.items.with([](auto& items) { return !items.is_empty(); });
+}
+
+WorkQueue::WorkItem* WorkQueue::take_item(Pool& pool)
+{
+    if (auto* item = pool.items.with([](auto& items) { return items.take_first(); }))
+        return item;
+    if (m_concurrency == Concurrency::Ordered)
+        return nullptr;
+
+    // Our own pool is empty, so help out pools whose workers are all busy. Items of pools with idle workers are
+    // left alone, as they are about to be picked up by a worker that is running on the processor that queued them.
+    for (auto& other_pool : m_pools) {
+        if (other_pool.ptr() == &pool || other_pool->idle_worker_count.load() > 0)
+            continue;
+        if (auto* item = other_pool->items.with([](auto& items) { return items.take_first(); }))
+            return item;
+    }
+    return nullptr;
+}
+
+bool WorkQueue::wake_idle_worker_of_other_pool(Pool const& pool)
+{
+    for (auto& other_pool : m_pools) {
+        if (other_pool.ptr() == &pool || other_pool->idle_worker_count.load() == 0)
+            continue;
+        other_pool->wait_queue.wake_one();
+        return true;
+    }
+    return false;
+}
+
+ErrorOr<void> WorkQueue::spawn_worker(Pool& pool, bool is_bound)
+{
+    VERIFY(m_concurrency == Concurrency::PerProcessor);
+    auto name = TRY(KString::formatted("{} #{}", m_name->view(), pool.processor_id));
+    auto affinity = is_bound ? (1u << pool.processor_id) : THREAD_AFFINITY_DEFAULT;
+    auto entry = is_bound
+        ? +[](void* pool) { static_cast<Pool*>(pool)->queue.run_worker(*static_cast<Pool*>(pool), true); }
+        : +[](void* pool) { static_cast<Pool*>(pool)->queue.run_worker(*static_cast<Pool*>(pool), false); };
+
+    ++pool.worker_count;
+    auto thread = m_process->create_kernel_thread(entry, &pool, THREAD_PRIORITY_NORMAL, move(name), affinity, false);
+    if (!thread) {
+        --pool.worker_count;
+        return ENOMEM;
+    }
+    return {};
+}
+
+void WorkQueue::run_worker(Pool& pool, bool is_bound)
+{
+    // NOTE: Only workers that were spawned because their pool got stuck ever exit, the first worker of a pool stays around.
+    bool may_exit = m_concurrency == Concurrency::PerProcessor && !is_bound;
+    for (;;) {
+        if (auto* item = take_item(pool)) {
+            item->function();
+            delete item;
+            ++pool.completed_item_count;
+            continue;
+        }
+
+        // NOTE: We announce that we're idle before looking for work one last time, so anyone who queues an item
+        //       after that either sees us as idle and wakes us up, or the item is found by us right here.
+        ++pool.idle_worker_count;
+        if (has_pending_items(pool)) {
+            --pool.idle_worker_count;
+            continue;
+        }
+
+        auto result = [&] {
+            if (!may_exit)
+                return pool.wait_queue.wait_on({});
+            auto timeout_time = Time::from_milliseconds(spawned_worker_idle_timeout_ms);
+            Thread::BlockTimeout timeout(false, &timeout_time);
+            return pool.wait_queue.wait_on(timeout);
+        }();
+        --pool.idle_worker_count;
+
+        if (may_exit && result == Thread::BlockResult::InterruptedByTimeout && !has_pending_items(pool)) {
+            --pool.worker_count;
+            return;
+        }
+    }
+}
+
+void WorkQueue::run_manager()
+{
+    VERIFY(m_concurrency == Concurrency::PerProcessor);
+    for (;;) {
+        bool should_check_again = false;
+        for (auto& pool : m_pools) {
+            auto completed_item_count = pool->completed_item_count.load();
+            if (pool->idle_worker_count.load() > 0 || !has_pending_items(*pool)) {
+                pool->completed_item_count_at_last_check = completed_item_count;
+                continue;
+            }
+
+            should_check_again = true;
+            if (completed_item_count != pool->completed_item_count_at_last_check) {
+                // The workers of this pool are busy, but still making progress.
+                pool->completed_item_count_at_last_check = completed_item_count;
+                continue;
+            }
+
+            // No worker of this pool finished an item since we last looked, so they are all blocked (or stuck in
+            // a long item). Let someone else pick up the pending items.
+            if (wake_idle_worker_of_other_pool(*pool))
+                continue;
+            if (pool->worker_count.load() >= max_workers_per_pool)
+                continue;
+            if (auto result = spawn_worker(*pool, false); result.is_error())
+                dbgln("WorkQueue: Failed to spawn a worker for {}: {}", m_name->view(), result.error());
+        }
+
+        if (should_check_again) {
+            auto timeout_time = Time::from_milliseconds(stall_check_interval_ms);
+            Thread::BlockTimeout timeout(false, &timeout_time);
+            [[maybe_unused]] auto result = m_manager_wait_queue.wait_on(timeout);
+        } else {
+            [[maybe_unused]] auto result = m_manager_wait_queue.wait_on({});
+        }
+    }
 }
 
 void WorkQueue::do_queue(WorkItem& item)
 {
-    m_items.with([&](auto& items) {
+    auto& pool = pool_for_current_processor();
+    pool.items.with([&](auto& items) {
         items.append(item);
     });
-    m_wait_queue.wake_one();
+    pool.wait_queue.wake_one();
+
+    // All workers of the pool are busy, so the manager has to keep an eye on whether they are making progress.
+    if (m_concurrency == Concurrency::PerProcessor && pool.idle_worker_count.load() == 0)
+        m_manager_wait_queue.wake_one();
 }
 
 }
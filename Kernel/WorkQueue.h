@@ -7,9 +7,13 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Error.h>
 #include <AK/IntrusiveList.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
 #include <Kernel/Forward.h>
+#include <Kernel/KString.h>
 #include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/WaitQueue.h>
 
@@ -23,6 +27,15 @@ class WorkQueue {
     AK_MAKE_NONMOVABLE(WorkQueue);
 
 public:
+    enum class Concurrency {
+        // All items are run one after another by a single worker, in the order they were queued.
+        Ordered,
+        // Every processor has its own pool of workers, and items are run by the pool of the processor that queued them.
+        // Whenever all workers of a pool are stuck in an item, idle workers of other pools help out, and more workers
+        // are spawned if there are none.
+        PerProcessor,
+    };
+
     static void initialize();
 
     ErrorOr<void> try_queue(void (*function)(void*), void* data = nullptr, void (*free_data)(void*) = nullptr)
@@ -51,7 +64,7 @@ public:
     }
 
 private:
-    explicit WorkQueue(StringView);
+    WorkQueue(StringView, Concurrency);
 
     struct WorkItem {
     public:
@@ -59,11 +72,41 @@ private:
         Function<void()> function;
     };
 
+    struct Pool {
+        Pool(WorkQueue& queue, u32 processor_id)
+            : queue(queue)
+            , processor_id(processor_id)
+        {
+        }
+
+        WorkQueue& queue;
+        u32 processor_id { 0 };
+        SpinlockProtected<IntrusiveList<&WorkItem::m_node>> items { LockRank::None };
+        WaitQueue wait_queue;
+        Atomic<u32> worker_count { 0 };
+        Atomic<u32> idle_worker_count { 0 };
+        Atomic<u64> completed_item_count { 0 };
+
+        // Only used by the manager of the work queue.
+        u64 completed_item_count_at_last_check { 0 };
+    };
+
     void do_queue(WorkItem&);
+    Pool& pool_for_current_processor();
+    WorkItem* take_item(Pool&);
+    bool has_pending_items(Pool&);
+    bool wake_idle_worker_of_other_pool(Pool const&);
+
+    ErrorOr<void> spawn_worker(Pool&, bool is_bound);
+    void run_worker(Pool&, bool is_bound);
+    void run_manager();
 
+    NonnullOwnPtr<KString> m_name;
+    Concurrency m_concurrency;
+    Vector<NonnullOwnPtr<Pool>> m_pools;
+    LockRefPtr<Process> m_process;
     LockRefPtr<Thread> m_thread;
-    WaitQueue m_wait_queue;
-    SpinlockProtected<IntrusiveList<&WorkItem::m_node>> m_items { LockRank::None };
+    WaitQueue m_manager_wait_queue;
 };
 
 }
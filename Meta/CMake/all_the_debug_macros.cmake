@@ -78,8 +78,10 @@ set(HIGHLIGHT_FOCUSED_FRAME_DEBUG ON)
 set(HPET_COMPARATOR_DEBUG ON)
 set(HPET_DEBUG ON)
 set(HTML_SCRIPT_DEBUG ON)
+set(HTTP2_DEBUG ON)
 set(HTTPJOB_DEBUG ON)
 set(HTTPSJOB_DEBUG ON)
+set(HTTP_CACHE_DEBUG ON)
 set(HUNKS_DEBUG ON)
 set(ICMP_DEBUG ON)
 set(ICO_DEBUG ON)
@@ -89,6 +91,7 @@ set(INTEL_GRAPHICS_DEBUG ON)
 set(INTERRUPT_DEBUG ON)
 set(IOAPIC_DEBUG ON)
 set(IO_DEBUG ON)
+set(IPC_STATISTICS_DEBUG ON)
 set(IPV4_DEBUG ON)
 set(IPV4_SOCKET_DEBUG ON)
 set(IRQ_DEBUG ON)
@@ -98,6 +101,7 @@ set(ITEM_RECTS_DEBUG ON)
 set(JOB_DEBUG ON)
 set(JPG_DEBUG ON)
 set(JS_BYTECODE_DEBUG ON)
+set(JS_JIT_DEBUG ON)
 set(JS_MODULE_DEBUG ON)
 set(KEYBOARD_DEBUG ON)
 set(KEYBOARD_SHORTCUTS_DEBUG ON)
@@ -110,6 +114,7 @@ set(LOCAL_SOCKET_DEBUG ON)
 set(LOCK_DEBUG ON)
 set(LOCK_IN_CRITICAL_DEBUG ON)
 set(LOCK_RANK_ENFORCEMENT ON)
+set(LOOPBACK_ADAPTER_DEBUG ON)
 set(LOCK_RESTORE_DEBUG ON)
 set(LOCK_SHARED_UPGRADE_DEBUG ON)
 set(LOCK_TRACE_DEBUG ON)
@@ -189,6 +194,7 @@ set(TERMCAP_DEBUG ON)
 set(TERMINAL_DEBUG ON)
 set(TEXTEDITOR_DEBUG ON)
 set(THREAD_DEBUG ON)
+set(TILE_CACHE_DEBUG ON)
 set(TIME_ZONE_DEBUG ON)
 set(TLS_DEBUG ON)
 set(TLS_SSL_KEYLOG_DEBUG ON)
@@ -42,6 +42,8 @@ static String pascal_case(String const& identifier)
 struct Message {
     String name;
     bool is_synchronous { false };
+    // The handler gets a promise to resolve with the response later, instead of returning it.
+    bool has_async_reply { false };
     Vector<Parameter> inputs;
     Vector<Parameter> outputs;
 
@@ -151,6 +153,23 @@ Vector<Endpoint> parse(ByteBuffer const& file_contents)
     auto parse_message = [&] {
         Message message;
         consume_whitespace();
+        if (lexer.consume_specific('[')) {
+            for (;;) {
+                consume_whitespace();
+                if (lexer.consume_specific(']'))
+                    break;
+                if (lexer.consume_specific(','))
+                    continue;
+                auto attribute = lexer.consume_until([](char ch) { return isspace(ch) || ch == ']' || ch == ','; });
+                if (attribute == "AsyncReply"sv) {
+                    message.has_async_reply = true;
+                } else {
+                    warnln("Unknown message attribute '{}'", attribute);
+                    VERIFY_NOT_REACHED();
+                }
+            }
+            consume_whitespace();
+        }
         message.name = lexer.consume_until([](char ch) { return isspace(ch) || ch == '('; });
         consume_whitespace();
         assert_specific('(');
@@ -173,6 +192,9 @@ Vector<Endpoint> parse(ByteBuffer const& file_contents)
             assert_specific('(');
             parse_parameters(message.outputs);
             assert_specific(')');
+        } else if (message.has_async_reply) {
+            warnln("Message '{}' has no reply, so it can't have an asynchronous one", message.name);
+            VERIFY_NOT_REACHED();
         }
 
         consume_whitespace();
@@ -686,7 +708,13 @@ public:
             message_generator.set("arguments", argument_generator.to_string());
             message_generator.appendln(R"~~~(
         case (int)Messages::@endpoint.name@::MessageID::@message.pascal_name@: {)~~~");
-            if (returns_something) {
+            if (returns_something && message.has_async_reply) {
+                message_generator.set("arguments", String::formatted("{}{}IPC::ResponsePromise<Messages::{}::{}> {{ response_connection() }}", argument_generator.string_view(), parameters.is_empty() ? "" : ", ", endpoint.name, message.response_name()));
+                message_generator.appendln(R"~~~(
+            [[maybe_unused]] auto& request = static_cast<const Messages::@endpoint.name@::@message.pascal_name@&>(message);
+            @handler_name@(@arguments@);
+            return {};)~~~");
+            } else if (returns_something) {
                 if (message.outputs.is_empty()) {
                     message_generator.appendln(R"~~~(
             [[maybe_unused]] auto& request = static_cast<const Messages::@endpoint.name@::@message.pascal_name@&>(message);
@@ -723,7 +751,7 @@ public:
 
         auto do_handle_message_decl = [&](String const& name, Vector<Parameter> const& parameters, bool is_response) {
             String return_type = "void";
-            if (message.is_synchronous && !message.outputs.is_empty() && !is_response)
+            if (message.is_synchronous && !message.outputs.is_empty() && !is_response && !message.has_async_reply)
                 return_type = message_name(endpoint.name, message.name, true);
             message_generator.set("message.complex_return_type", return_type);
 
@@ -753,6 +781,14 @@ public:
                     argument_generator.append(", ");
             }
 
+            if (message.has_async_reply && !is_response) {
+                auto argument_generator = message_generator.fork();
+                argument_generator.set("response_type", message_name(endpoint.name, message.name, true));
+                if (!parameters.is_empty())
+                    argument_generator.append(", ");
+                argument_generator.append("IPC::ResponsePromise<@response_type@>");
+            }
+
             if (is_response) {
                 message_generator.append(") { };");
             } else {
@@ -795,6 +831,7 @@ void build(StringBuilder& builder, Vector<Endpoint> const& endpoints)
 #include <LibIPC/Encoder.h>
 #include <LibIPC/File.h>
 #include <LibIPC/Message.h>
+#include <LibIPC/ResponsePromise.h>
 #include <LibIPC/Stub.h>
 
 #if defined(AK_COMPILER_CLANG)
@@ -830,6 +867,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             for (auto& message : endpoint.messages) {
                 warnln("  Message: '{}'", message.name);
                 warnln("    Sync: {}", message.is_synchronous);
+                warnln("    Async reply: {}", message.has_async_reply);
                 warnln("    Inputs:");
                 for (auto& parameter : message.inputs)
                     warnln("      Parameter: {} ({})", parameter.name, parameter.type);
@@ -10,6 +10,7 @@
 #include <AK/CharacterTypes.h>
 #include <AK/Find.h>
 #include <AK/HashMap.h>
+#include <AK/NumericLimits.h>
 #include <AK/Optional.h>
 #include <AK/QuickSort.h>
 #include <AK/SourceGenerator.h>
@@ -787,6 +788,140 @@ Optional<Locale> locale_from_string(StringView locale);
     return {};
 }
 
+static constexpr u32 code_point_count = 0x110000;
+
+// A value for every code point, split into a two-stage lookup table: The code points are split into chunks, and the
+// first stage maps each chunk to one of the unique chunks that make up the second stage. Most chunks are the same as
+// some other chunk (unassigned code points, or ones that all have the same script or block), so this takes up far
+// less space than a value per code point while still being a constant time lookup.
+struct CodePointTables {
+    size_t chunk_shift { 0 };
+    Vector<u32> stage1;
+    Vector<u32> stage2;
+};
+
+static size_t size_of_table_type(u32 largest_value)
+{
+    if (largest_value <= NumericLimits<u8>::max())
+        return sizeof(u8);
+    if (largest_value <= NumericLimits<u16>::max())
+        return sizeof(u16);
+    return sizeof(u32);
+}
+
+static StringView table_type(u32 largest_value)
+{
+    switch (size_of_table_type(largest_value)) {
+    case sizeof(u8):
+        return "u8"sv;
+    case sizeof(u16):
+        return "u16"sv;
+    default:
+        return "u32"sv;
+    }
+}
+
+static CodePointTables create_code_point_tables(Vector<u32> const& values)
+{
+    VERIFY(values.size() == code_point_count);
+
+    auto table_size = [](Vector<u32> const& table) {
+        u32 largest_value = 0;
+        for (auto value : table)
+            largest_value = max(largest_value, value);
+        return table.size() * size_of_table_type(largest_value);
+    };
+
+    // How large the chunks should be depends a lot on the data, so just pick whichever chunk size works out smallest.
+    Optional<CodePointTables> smallest_tables;
+    size_t smallest_size = 0;
+
+    for (size_t chunk_shift = 5; chunk_shift <= 10; ++chunk_shift) {
+        size_t chunk_size = 1u << chunk_shift;
+        CodePointTables tables { chunk_shift, {}, {} };
+        HashMap<String, u32> unique_chunks;
+
+        for (size_t first = 0; first < code_point_count; first += chunk_size) {
+            auto chunk = values.span().slice(first, chunk_size);
+            String key { ReadonlyBytes { chunk.data(), chunk.size() * sizeof(u32) } };
+
+            auto chunk_index = unique_chunks.ensure(key, [&]() -> u32 {
+                auto index = tables.stage2.size() >> chunk_shift;
+                tables.stage2.append(chunk.data(), chunk.size());
+                return index;
+            });
+            tables.stage1.append(chunk_index);
+        }
+
+        auto size = table_size(tables.stage1) + table_size(tables.stage2);
+        if (!smallest_tables.has_value() || size < smallest_size) {
+            smallest_tables = move(tables);
+            smallest_size = size;
+        }
+    }
+
+    return smallest_tables.release_value();
+}
+
+// The set of properties of every code point, as an index into `unique_property_sets`.
+static Vector<u32> code_point_property_sets(PropList const& property_list, Vector<String> const& property_names, Vector<Vector<size_t>>& unique_property_sets)
+{
+    struct Boundary {
+        u32 code_point { 0 };
+        size_t property { 0 };
+        bool is_start { false };
+    };
+
+    Vector<Boundary> boundaries;
+    for (size_t property = 0; property < property_names.size(); ++property) {
+        for (auto const& range : property_list.get(property_names[property]).value()) {
+            boundaries.append({ range.first, property, true });
+            if (range.last + 1 < code_point_count)
+                boundaries.append({ range.last + 1, property, false });
+        }
+    }
+    quick_sort(boundaries, [](auto const& a, auto const& b) { return a.code_point < b.code_point; });
+
+    // Ranges of a single property may overlap, so count how many ranges of each property the current code point is in.
+    Vector<size_t> range_counts;
+    range_counts.resize(property_names.size());
+
+    HashMap<String, u32> set_indices;
+    unique_property_sets.clear();
+    unique_property_sets.append({});
+    set_indices.set(String::empty(), 0);
+
+    Vector<u32> sets;
+    sets.ensure_capacity(code_point_count);
+
+    size_t boundary = 0;
+    u32 current_set = 0;
+
+    for (u32 code_point = 0; code_point < code_point_count; ++code_point) {
+        if (boundary < boundaries.size() && boundaries[boundary].code_point == code_point) {
+            for (; boundary < boundaries.size() && boundaries[boundary].code_point == code_point; ++boundary) {
+                auto& range_count = range_counts[boundaries[boundary].property];
+                range_count = boundaries[boundary].is_start ? range_count + 1 : range_count - 1;
+            }
+
+            Vector<size_t> set;
+            for (size_t property = 0; property < range_counts.size(); ++property) {
+                if (range_counts[property] > 0)
+                    set.append(property);
+            }
+
+            current_set = set_indices.ensure(String::join(',', set), [&]() -> u32 {
+                unique_property_sets.append(move(set));
+                return unique_property_sets.size() - 1;
+            });
+        }
+
+        sets.unchecked_append(current_set);
+    }
+
+    return sets;
+}
+
 static ErrorOr<void> generate_unicode_data_implementation(Core::Stream::BufferedFile& file, UnicodeData const& unicode_data)
 {
     StringBuilder builder;
@@ -870,14 +1005,6 @@ struct CodePointAbbreviation {
     @string_index_type@ abbreviation { 0 };
 };
 
-template<typename MappingType>
-struct CodePointComparator {
-    constexpr int operator()(u32 code_point, MappingType const& mapping)
-    {
-        return code_point - mapping.code_point;
-    }
-};
-
 struct CodePointRangeComparator {
     constexpr int operator()(u32 code_point, CodePointRange const& range)
     {
@@ -908,7 +1035,69 @@ struct CodePointNameComparator : public CodePointRangeComparator {
         return CodePointRangeComparator::operator()(code_point, name.code_point_range);
     }
 };
+
+static constexpr u32 s_code_point_count = 0x110000;
+
+// The first stage maps every chunk of code points to a chunk in the second stage, which holds the value for each
+// code point in the chunk. The code point must be below s_code_point_count.
+template<size_t ChunkShift, typename Stage1, typename Stage2>
+static constexpr u32 lookup_code_point_table(Stage1 const& stage1, Stage2 const& stage2, u32 code_point)
+{
+    constexpr u32 chunk_mask = (1u << ChunkShift) - 1;
+    size_t chunk = stage1[code_point >> ChunkShift];
+    return stage2[(chunk << ChunkShift) | (code_point & chunk_mask)];
+}
+)~~~");
+
+    auto append_values = [&](auto const& values, StringView format) {
+        constexpr size_t max_values_per_row = 32;
+        size_t values_in_current_row = 0;
+
+        for (auto value : values) {
+            if (values_in_current_row++ > 0)
+                generator.append(" ");
+
+            generator.append(String::formatted(format, value));
+            generator.append(",");
+
+            if (values_in_current_row == max_values_per_row) {
+                values_in_current_row = 0;
+                generator.append("\n    ");
+            }
+        }
+    };
+
+    auto append_code_point_tables = [&](StringView name, CodePointTables const& tables) {
+        u32 largest_chunk_index = 0;
+        for (auto chunk_index : tables.stage1)
+            largest_chunk_index = max(largest_chunk_index, chunk_index);
+        u32 largest_value = 0;
+        for (auto value : tables.stage2)
+            largest_value = max(largest_value, value);
+
+        generator.set("name", name);
+        generator.set("chunk_shift", String::number(tables.chunk_shift));
+        generator.set("stage1_type", table_type(largest_chunk_index));
+        generator.set("stage1_size", String::number(tables.stage1.size()));
+        generator.set("stage2_type", table_type(largest_value));
+        generator.set("stage2_size", String::number(tables.stage2.size()));
+
+        generator.append(R"~~~(
+static constexpr size_t s_@name@_chunk_shift = @chunk_shift@;
+
+static constexpr Array<@stage1_type@, @stage1_size@> s_@name@_stage1 { {
+    )~~~");
+        append_values(tables.stage1, "{}"sv);
+        generator.append(R"~~~(
+} };
+
+static constexpr Array<@stage2_type@, @stage2_size@> s_@name@_stage2 { {
+    )~~~");
+        append_values(tables.stage2, "{}"sv);
+        generator.append(R"~~~(
+} };
 )~~~");
+    };
 
     generator.set("decomposition_mappings_size", String::number(unicode_data.decomposition_mappings.size()));
     generator.append("\nstatic constexpr Array<u32, @decomposition_mappings_size@> s_decomposition_mappings_data { ");
@@ -927,6 +1116,11 @@ static constexpr Array<@mapping_type@, @size@> s_@name@_mappings { {
         constexpr size_t max_mappings_per_row = 20;
         size_t mappings_in_current_row = 0;
 
+        // Where each code point's mapping is, plus one, so that 0 means it doesn't have one.
+        Vector<u32> mapping_indices;
+        mapping_indices.resize(code_point_count);
+        u32 mapping_count = 0;
+
         for (auto const& data : unicode_data.code_point_data) {
             auto mapping = mapping_getter(data);
 
@@ -938,6 +1132,8 @@ static constexpr Array<@mapping_type@, @size@> s_@name@_mappings { {
                     continue;
             }
 
+            mapping_indices[data.code_point] = ++mapping_count;
+
             if (mappings_in_current_row++ > 0)
                 generator.append(" ");
 
@@ -964,6 +1160,23 @@ static constexpr Array<@mapping_type@, @size@> s_@name@_mappings { {
         }
         generator.append(R"~~~(
 } };
+)~~~");
+
+        auto tables_name = String::formatted("{}_mapping", name);
+        append_code_point_tables(tables_name, create_code_point_tables(mapping_indices));
+
+        generator.set("name", name);
+        generator.set("tables_name", tables_name);
+        generator.set("mapping_type", mapping_type);
+        generator.append(R"~~~(
+static @mapping_type@ const* find_@name@_mapping(u32 code_point)
+{
+    if (code_point >= s_code_point_count)
+        return nullptr;
+
+    auto index = lookup_code_point_table<s_@tables_name@_chunk_shift>(s_@tables_name@_stage1, s_@tables_name@_stage2, code_point);
+    return index != 0 ? &s_@name@_mappings[index - 1] : nullptr;
+}
 )~~~");
     };
 
@@ -983,68 +1196,50 @@ static constexpr Array<@mapping_type@, @size@> s_@name@_mappings { {
             return data.decomposition_mapping;
         });
 
-    auto append_code_point_range_list = [&](String name, Vector<CodePointRange> const& ranges) {
-        generator.set("name", name);
-        generator.set("size", String::number(ranges.size()));
-        generator.append(R"~~~(
-static constexpr Array<CodePointRange, @size@> @name@ { {
-    )~~~");
-
-        constexpr size_t max_ranges_per_row = 20;
-        size_t ranges_in_current_row = 0;
-
-        for (auto const& range : ranges) {
-            if (ranges_in_current_row++ > 0)
-                generator.append(" ");
+    auto append_prop_list = [&](StringView name, PropList const& property_list) {
+        auto property_names = property_list.keys();
+        quick_sort(property_names);
 
-            generator.set("first", String::formatted("{:#x}", range.first));
-            generator.set("last", String::formatted("{:#x}", range.last));
-            generator.append("{ @first@, @last@ },");
+        Vector<Vector<size_t>> unique_property_sets;
+        auto property_sets = code_point_property_sets(property_list, property_names, unique_property_sets);
+        append_code_point_tables(name, create_code_point_tables(property_sets));
 
-            if (ranges_in_current_row == max_ranges_per_row) {
-                ranges_in_current_row = 0;
-                generator.append("\n    ");
-            }
-        }
+        // Each set is stored as a bitmap, with a bit for every property.
+        size_t words_per_set = ceil_div(property_names.size(), static_cast<size_t>(64));
 
+        generator.set("name", name);
+        generator.set("words_per_set", String::number(words_per_set));
+        generator.set("size", String::number(unique_property_sets.size() * words_per_set));
         generator.append(R"~~~(
-} };
-)~~~");
-    };
-
-    auto append_prop_list = [&](StringView collection_name, StringView property_format, PropList const& property_list) {
-        for (auto const& property : property_list) {
-            auto name = String::formatted(property_format, property.key);
-            append_code_point_range_list(move(name), property.value);
-        }
-
-        auto property_names = property_list.keys();
-        quick_sort(property_names);
+static constexpr size_t s_@name@_words_per_set = @words_per_set@;
 
-        generator.set("name", collection_name);
-        generator.set("size", String::number(property_names.size()));
-        generator.append(R"~~~(
-static constexpr Array<Span<CodePointRange const>, @size@> @name@ { {)~~~");
+static constexpr Array<u64, @size@> s_@name@_sets { {
+    )~~~");
 
-        for (auto const& property_name : property_names) {
-            generator.set("name", String::formatted(property_format, property_name));
-            generator.append(R"~~~(
-    @name@.span(),)~~~");
+        Vector<u64> words;
+        words.ensure_capacity(unique_property_sets.size() * words_per_set);
+        for (auto const& property_set : unique_property_sets) {
+            size_t first_word = words.size();
+            for (size_t i = 0; i < words_per_set; ++i)
+                words.unchecked_append(0);
+            for (auto property : property_set)
+                words[first_word + property / 64] |= 1ull << (property % 64);
         }
+        append_values(words, "{:#x}"sv);
 
         generator.append(R"~~~(
 } };
 )~~~");
     };
 
-    append_prop_list("s_general_categories"sv, "s_general_category_{}"sv, unicode_data.general_categories);
-    append_prop_list("s_properties"sv, "s_property_{}"sv, unicode_data.prop_list);
-    append_prop_list("s_scripts"sv, "s_script_{}"sv, unicode_data.script_list);
-    append_prop_list("s_script_extensions"sv, "s_script_extension_{}"sv, unicode_data.script_extensions);
-    append_prop_list("s_blocks"sv, "s_block_{}"sv, unicode_data.block_list);
-    append_prop_list("s_grapheme_break_properties"sv, "s_grapheme_break_property_{}"sv, unicode_data.grapheme_break_props);
-    append_prop_list("s_word_break_properties"sv, "s_word_break_property_{}"sv, unicode_data.word_break_props);
-    append_prop_list("s_sentence_break_properties"sv, "s_sentence_break_property_{}"sv, unicode_data.sentence_break_props);
+    append_prop_list("general_category"sv, unicode_data.general_categories);
+    append_prop_list("property"sv, unicode_data.prop_list);
+    append_prop_list("script"sv, unicode_data.script_list);
+    append_prop_list("script_extension"sv, unicode_data.script_extensions);
+    append_prop_list("block"sv, unicode_data.block_list);
+    append_prop_list("grapheme_break_property"sv, unicode_data.grapheme_break_props);
+    append_prop_list("word_break_property"sv, unicode_data.word_break_props);
+    append_prop_list("sentence_break_property"sv, unicode_data.sentence_break_props);
 
     auto append_code_point_display_names = [&](StringView type, StringView name, auto const& display_names) {
         constexpr size_t max_values_per_row = 30;
@@ -1119,27 +1314,32 @@ Optional<String> code_point_display_name(u32 code_point)
 }
 )~~~");
 
-    auto append_code_point_mapping_search = [&](StringView method, StringView mappings, StringView fallback) {
+    auto append_code_point_mapping_search = [&](StringView method, StringView mappings, StringView ascii_fallback, StringView fallback) {
         generator.set("method", method);
         generator.set("mappings", mappings);
+        generator.set("ascii_fallback", ascii_fallback);
         generator.set("fallback", fallback);
         generator.append(R"~~~(
 u32 @method@(u32 code_point)
 {
-    auto const* mapping = binary_search(@mappings@, code_point, nullptr, CodePointComparator<CodePointMapping> {});
+    // Most text is largely ASCII, which is simple enough to not need a lookup at all.
+    if (is_ascii(code_point))
+        return @ascii_fallback@;
+
+    auto const* mapping = find_@mappings@_mapping(code_point);
     return mapping ? mapping->mapping : @fallback@;
 }
 )~~~");
     };
 
-    append_code_point_mapping_search("canonical_combining_class"sv, "s_combining_class_mappings"sv, "0"sv);
-    append_code_point_mapping_search("to_unicode_uppercase"sv, "s_uppercase_mappings"sv, "code_point"sv);
-    append_code_point_mapping_search("to_unicode_lowercase"sv, "s_lowercase_mappings"sv, "code_point"sv);
+    append_code_point_mapping_search("canonical_combining_class"sv, "combining_class"sv, "0"sv, "0"sv);
+    append_code_point_mapping_search("to_unicode_uppercase"sv, "uppercase"sv, "to_ascii_uppercase(code_point)"sv, "code_point"sv);
+    append_code_point_mapping_search("to_unicode_lowercase"sv, "lowercase"sv, "to_ascii_lowercase(code_point)"sv, "code_point"sv);
 
     generator.append(R"~~~(
 Span<SpecialCasing const* const> special_case_mapping(u32 code_point)
 {
-    auto const* mapping = binary_search(s_special_case_mappings, code_point, nullptr, CodePointComparator<SpecialCaseMapping> {});
+    auto const* mapping = find_special_case_mapping(code_point);
     if (mapping == nullptr)
         return {};
 
@@ -1148,7 +1348,7 @@ Span<SpecialCasing const* const> special_case_mapping(u32 code_point)
 
 Optional<StringView> code_point_abbreviation(u32 code_point)
 {
-    auto const* mapping = binary_search(s_abbreviation_mappings, code_point, nullptr, CodePointComparator<CodePointAbbreviation> {});
+    auto const* mapping = find_abbreviation_mapping(code_point);
     if (mapping == nullptr)
         return {};
     if (mapping->abbreviation == 0)
@@ -1159,7 +1359,7 @@ Optional<StringView> code_point_abbreviation(u32 code_point)
 
 Optional<CodePointDecomposition const> code_point_decomposition(u32 code_point)
 {
-    auto const* mapping = binary_search(s_decomposition_mappings, code_point, nullptr, CodePointComparator<CodePointDecompositionRaw> {});
+    auto const* mapping = find_decomposition_mapping(code_point);
     if (mapping == nullptr)
         return {};
     return CodePointDecomposition { mapping->code_point, mapping->tag, Span<u32 const> { s_decomposition_mappings_data.data() + mapping->decomposition_index, mapping->decomposition_count } };
@@ -1174,18 +1374,20 @@ Optional<CodePointDecomposition const> code_point_decomposition_by_index(size_t
 }
 )~~~");
 
-    auto append_prop_search = [&](StringView enum_title, StringView enum_snake, StringView collection_name) {
+    auto append_prop_search = [&](StringView enum_title, StringView enum_snake) {
         generator.set("enum_title", enum_title);
         generator.set("enum_snake", enum_snake);
-        generator.set("collection_name", collection_name);
         generator.append(R"~~~(
 bool code_point_has_@enum_snake@(u32 code_point, @enum_title@ @enum_snake@)
 {
-    auto index = static_cast<@enum_title@UnderlyingType>(@enum_snake@);
-    auto const& ranges = @collection_name@.at(index);
+    if (code_point >= s_code_point_count)
+        return false;
+
+    size_t index = static_cast<@enum_title@UnderlyingType>(@enum_snake@);
+    size_t set = lookup_code_point_table<s_@enum_snake@_chunk_shift>(s_@enum_snake@_stage1, s_@enum_snake@_stage2, code_point);
 
-    auto const* range = binary_search(ranges, code_point, nullptr, CodePointRangeComparator {});
-    return range != nullptr;
+    auto word = s_@enum_snake@_sets[set * s_@enum_snake@_words_per_set + index / 64];
+    return (word >> (index % 64)) & 1;
 }
 )~~~");
     };
@@ -1213,22 +1415,22 @@ bool code_point_has_@enum_snake@(u32 code_point, @enum_title@ @enum_snake@)
 
     append_from_string("Locale"sv, "locale"sv, unicode_data.locales, {});
 
-    append_prop_search("GeneralCategory"sv, "general_category"sv, "s_general_categories"sv);
+    append_prop_search("GeneralCategory"sv, "general_category"sv);
     append_from_string("GeneralCategory"sv, "general_category"sv, unicode_data.general_categories, unicode_data.general_category_aliases);
 
-    append_prop_search("Property"sv, "property"sv, "s_properties"sv);
+    append_prop_search("Property"sv, "property"sv);
     append_from_string("Property"sv, "property"sv, unicode_data.prop_list, unicode_data.prop_aliases);
 
-    append_prop_search("Script"sv, "script"sv, "s_scripts"sv);
-    append_prop_search("Script"sv, "script_extension"sv, "s_script_extensions"sv);
+    append_prop_search("Script"sv, "script"sv);
+    append_prop_search("Script"sv, "script_extension"sv);
     append_from_string("Script"sv, "script"sv, unicode_data.script_list, unicode_data.script_aliases);
 
-    append_prop_search("Block"sv, "block"sv, "s_blocks"sv);
+    append_prop_search("Block"sv, "block"sv);
     append_from_string("Block"sv, "block"sv, unicode_data.block_list, unicode_data.block_aliases);
 
-    append_prop_search("GraphemeBreakProperty"sv, "grapheme_break_property"sv, "s_grapheme_break_properties"sv);
-    append_prop_search("WordBreakProperty"sv, "word_break_property"sv, "s_word_break_properties"sv);
-    append_prop_search("SentenceBreakProperty"sv, "sentence_break_property"sv, "s_sentence_break_properties"sv);
+    append_prop_search("GraphemeBreakProperty"sv, "grapheme_break_property"sv);
+    append_prop_search("WordBreakProperty"sv, "word_break_property"sv);
+    append_prop_search("SentenceBreakProperty"sv, "sentence_break_property"sv);
 
     generator.append(R"~~~(
 }
@@ -5,6 +5,8 @@ set -e
 wheel_gid=1
 phys_gid=3
 utmp_gid=5
+lookup_uid=10
+lookup_gid=10
 window_uid=13
 window_gid=13
 
@@ -134,6 +136,12 @@ chmod 700 mnt/mod
 chmod 1777 mnt/tmp
 echo "done"
 
+printf "creating LookupServer cache folder... "
+mkdir -p mnt/var/cache/LookupServer
+chown $lookup_uid:$lookup_gid mnt/var/cache/LookupServer
+chmod 700 mnt/var/cache/LookupServer
+echo "done"
+
 printf "creating utmp file... "
 echo "{}" > mnt/var/run/utmp
 chown 0:$utmp_gid mnt/var/run/utmp
@@ -194,6 +194,36 @@ TEST_CASE(find_first_fit)
     }
 }
 
+TEST_CASE(find_next_range_of_unset_bits_from_middle_of_bucket)
+{
+    {
+        auto bitmap = Bitmap::must_create(256, false);
+        size_t from = 8;
+        auto length = bitmap.find_next_range_of_unset_bits(from, 1, 16);
+        EXPECT_EQ(length.has_value(), true);
+        EXPECT_EQ(from, 8u);
+        EXPECT_EQ(length.value(), 16u);
+    }
+    {
+        auto bitmap = Bitmap::must_create(256, false);
+        size_t from = 8;
+        auto length = bitmap.find_next_range_of_unset_bits(from);
+        EXPECT_EQ(length.has_value(), true);
+        EXPECT_EQ(from, 8u);
+        EXPECT_EQ(length.value(), 248u);
+    }
+    {
+        auto bitmap = Bitmap::must_create(100, true);
+        bitmap.set_range(66, 2, false);
+        bitmap.set_range(96, 4, false);
+        size_t from = 80;
+        auto length = bitmap.find_next_range_of_unset_bits(from);
+        EXPECT_EQ(length.has_value(), true);
+        EXPECT_EQ(from, 96u);
+        EXPECT_EQ(length.value(), 4u);
+    }
+}
+
 TEST_CASE(find_longest_range_of_unset_bits_edge)
 {
     auto bitmap = Bitmap::must_create(36, true);
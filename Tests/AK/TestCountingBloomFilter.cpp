@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/CountingBloomFilter.h>
+#include <AK/StringHash.h>
+
+TEST_CASE(add_and_remove)
+{
+    CountingBloomFilter<> filter;
+    auto hash = string_hash("foo", 3);
+    EXPECT(!filter.may_contain(hash));
+
+    filter.add(hash);
+    EXPECT(filter.may_contain(hash));
+
+    filter.add(hash);
+    filter.remove(hash);
+    EXPECT(filter.may_contain(hash));
+
+    filter.remove(hash);
+    EXPECT(!filter.may_contain(hash));
+}
+
+TEST_CASE(no_false_negatives)
+{
+    CountingBloomFilter<> filter;
+    for (u32 i = 0; i < 100; ++i)
+        filter.add(int_hash(i));
+    for (u32 i = 0; i < 100; ++i)
+        EXPECT(filter.may_contain(int_hash(i)));
+
+    for (u32 i = 0; i < 50; ++i)
+        filter.remove(int_hash(i));
+    for (u32 i = 50; i < 100; ++i)
+        EXPECT(filter.may_contain(int_hash(i)));
+}
+
+TEST_CASE(saturated_buckets_stay_set)
+{
+    CountingBloomFilter<4> filter;
+    for (size_t i = 0; i < 300; ++i)
+        filter.add(0);
+    for (size_t i = 0; i < 300; ++i)
+        filter.remove(0);
+    EXPECT(filter.may_contain(0));
+
+    filter.clear();
+    EXPECT(!filter.may_contain(0));
+}
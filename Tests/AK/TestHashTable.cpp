@@ -9,6 +9,7 @@
 #include <AK/HashTable.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 
 TEST_CASE(construct)
 {
@@ -180,6 +181,51 @@ TEST_CASE(space_reuse)
     EXPECT_EQ(strings.capacity(), capacity);
 }
 
+TEST_CASE(remove_from_collisions)
+{
+    struct IntCollisionTraits : public GenericTraits<int> {
+        static unsigned hash(int value) { return value % 3; }
+    };
+
+    HashTable<int, IntCollisionTraits> table;
+    for (int i = 0; i < 300; ++i)
+        table.set(i);
+
+    // Removing entries moves the ones that collided with them back, which must keep all of them reachable.
+    EXPECT_EQ(table.remove_all_matching([](int value) { return value % 2 == 0; }), true);
+    EXPECT_EQ(table.size(), 150u);
+    for (int i = 0; i < 300; ++i)
+        EXPECT_EQ(table.contains(i), i % 2 == 1);
+
+    for (int i = 1; i < 300; i += 4)
+        EXPECT_EQ(table.remove(i), true);
+    EXPECT_EQ(table.size(), 75u);
+    for (int i = 0; i < 300; ++i)
+        EXPECT_EQ(table.contains(i), i % 4 == 3);
+}
+
+TEST_CASE(ordered_remove_keeps_order)
+{
+    struct IntCollisionTraits : public GenericTraits<int> {
+        static unsigned hash(int) { return 0; }
+    };
+
+    OrderedHashTable<int, IntCollisionTraits> table;
+    for (int i = 0; i < 20; ++i)
+        table.set(i);
+    for (int i = 0; i < 20; i += 3)
+        table.remove(i);
+
+    int expected = 0;
+    for (auto value : table) {
+        if (expected % 3 == 0)
+            ++expected;
+        EXPECT_EQ(value, expected);
+        ++expected;
+    }
+    EXPECT_EQ(table.size(), 13u);
+}
+
 TEST_CASE(basic_remove)
 {
     HashTable<int> table;
@@ -315,3 +361,59 @@ TEST_CASE(clear_with_capacity_when_empty)
     map.set(1);
     VERIFY(map.size() == 2);
 }
+
+BENCHMARK_CASE(benchmark_insert)
+{
+    for (int round = 0; round < 10; ++round) {
+        HashTable<int> table;
+        for (int i = 0; i < 1'000'000; ++i)
+            table.set(i * 7);
+        EXPECT_EQ(table.size(), 1'000'000u);
+    }
+}
+
+BENCHMARK_CASE(benchmark_lookup)
+{
+    HashTable<int> table;
+    for (int i = 0; i < 100'000; ++i)
+        table.set(i * 7);
+
+    size_t found = 0;
+    for (int round = 0; round < 100; ++round) {
+        // Every seventh value is in the table, so this looks up hits and misses alike.
+        for (int i = 0; i < 100'000; ++i)
+            found += table.contains(i);
+    }
+    EXPECT_EQ(found, 100u * 14'286);
+}
+
+BENCHMARK_CASE(benchmark_string_lookup)
+{
+    HashTable<String> table;
+    Vector<String> strings;
+    for (int i = 0; i < 10'000; ++i) {
+        strings.append(String::number(i));
+        table.set(strings.last());
+    }
+
+    size_t found = 0;
+    for (int round = 0; round < 500; ++round) {
+        for (auto& string : strings)
+            found += table.contains(string);
+    }
+    EXPECT_EQ(found, 500u * 10'000);
+}
+
+BENCHMARK_CASE(benchmark_erase)
+{
+    for (int round = 0; round < 10; ++round) {
+        HashTable<int> table;
+        for (int i = 0; i < 1'000'000; ++i)
+            table.set(i);
+        for (int i = 0; i < 1'000'000; i += 2)
+            table.remove(i);
+        for (int i = 1; i < 1'000'000; i += 2)
+            table.remove(i);
+        EXPECT(table.is_empty());
+    }
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
+#include <AK/JsonReader.h>
+#include <AK/StringBuilder.h>
+#include <AK/Vector.h>
+
+using TokenType = JsonReader::TokenType;
+
+static Vector<TokenType> token_types(StringView input)
+{
+    JsonReader reader(input);
+    Vector<TokenType> types;
+    for (;;) {
+        auto token = reader.next();
+        EXPECT(!token.is_error());
+        if (token.is_error())
+            return types;
+        if (token.value().type == TokenType::EndOfInput)
+            return types;
+        types.append(token.value().type);
+    }
+}
+
+static bool is_valid(StringView input)
+{
+    JsonReader reader(input);
+    for (;;) {
+        auto token = reader.next();
+        if (token.is_error())
+            return false;
+        if (token.value().type == TokenType::EndOfInput)
+            return true;
+    }
+}
+
+TEST_CASE(tokens)
+{
+    EXPECT_EQ(token_types(R"({"a": [1, "two", true, false, null, {}], "b": -1.5e3})"sv),
+        (Vector<TokenType> {
+            TokenType::ObjectStart,
+            TokenType::Key,
+            TokenType::ArrayStart,
+            TokenType::Number,
+            TokenType::String,
+            TokenType::True,
+            TokenType::False,
+            TokenType::Null,
+            TokenType::ObjectStart,
+            TokenType::ObjectEnd,
+            TokenType::ArrayEnd,
+            TokenType::Key,
+            TokenType::Number,
+            TokenType::ObjectEnd,
+        }));
+
+    EXPECT_EQ(token_types("  42  "sv), Vector<TokenType> { TokenType::Number });
+    EXPECT_EQ(token_types("[]"sv), (Vector<TokenType> { TokenType::ArrayStart, TokenType::ArrayEnd }));
+}
+
+TEST_CASE(strings_are_views_into_the_input)
+{
+    auto input = R"(["plain", "with \"escapes\" and \u00e9", "a somewhat longer string that spans several blocks"])"sv;
+    JsonReader reader(input);
+    EXPECT_EQ(reader.next().value().type, TokenType::ArrayStart);
+
+    auto plain = reader.next().value();
+    EXPECT_EQ(plain.text, "plain"sv);
+    EXPECT(!plain.has_escapes);
+    EXPECT(plain.text.characters_without_null_termination() > input.characters_without_null_termination());
+    EXPECT(plain.text.characters_without_null_termination() < input.characters_without_null_termination() + input.length());
+    EXPECT(plain.text_equals("plain"sv));
+
+    auto escaped = reader.next().value();
+    EXPECT(escaped.has_escapes);
+    EXPECT_EQ(escaped.text, R"(with \"escapes\" and \u00e9)"sv);
+    EXPECT_EQ(escaped.to_string().value(), "with \"escapes\" and \xc3\xa9");
+    EXPECT(!escaped.text_equals("with \"escapes\" and \xc3\xa9"sv));
+
+    auto long_string = reader.next().value();
+    EXPECT_EQ(long_string.text, "a somewhat longer string that spans several blocks"sv);
+
+    EXPECT_EQ(reader.next().value().type, TokenType::ArrayEnd);
+    EXPECT_EQ(reader.next().value().type, TokenType::EndOfInput);
+}
+
+TEST_CASE(string_special_characters_at_every_offset)
+{
+    // Put the closing quote or an escape at every position within and across the scanner's blocks.
+    for (size_t length = 0; length < 40; ++length) {
+        StringBuilder builder;
+        builder.append('"');
+        builder.append(String::repeated('x', length));
+        builder.append("\\n\""sv);
+        auto input = builder.to_string();
+
+        JsonReader reader(input);
+        auto token = reader.next().value();
+        EXPECT_EQ(token.type, TokenType::String);
+        EXPECT(token.has_escapes);
+        EXPECT_EQ(token.text.length(), length + 2);
+        EXPECT_EQ(token.to_string().value(), String::formatted("{}\n", String::repeated('x', length)));
+
+        auto with_control_character = String::formatted("\"{}\x01\"", String::repeated('x', length));
+        EXPECT(!is_valid(with_control_character));
+    }
+}
+
+TEST_CASE(numbers)
+{
+    JsonReader reader("[0, -12, 18446744073709551615, 3.25, 1e2]"sv);
+    EXPECT_EQ(reader.next().value().type, TokenType::ArrayStart);
+    EXPECT_EQ(reader.next().value().to_u64(), 0u);
+    EXPECT_EQ(reader.next().value().to_i64(), -12);
+    EXPECT_EQ(reader.next().value().to_u64(), NumericLimits<u64>::max());
+    auto fraction = reader.next().value();
+    EXPECT(!fraction.to_u64().has_value());
+    EXPECT_EQ(fraction.to_double(), 3.25);
+    EXPECT_EQ(reader.next().value().to_double(), 100.0);
+}
+
+TEST_CASE(invalid_documents)
+{
+    EXPECT(!is_valid(""sv));
+    EXPECT(!is_valid("{"sv));
+    EXPECT(!is_valid("[1,]"sv));
+    EXPECT(!is_valid(R"({"a": 1,})"sv));
+    EXPECT(!is_valid(R"({"a" 1})"sv));
+    EXPECT(!is_valid(R"({1: 1})"sv));
+    EXPECT(!is_valid("[1 2]"sv));
+    EXPECT(!is_valid("[1]]"sv));
+    EXPECT(!is_valid("[1] 2"sv));
+    EXPECT(!is_valid("01"sv));
+    EXPECT(!is_valid("-"sv));
+    EXPECT(!is_valid("1."sv));
+    EXPECT(!is_valid("1e"sv));
+    EXPECT(!is_valid("tru"sv));
+    EXPECT(!is_valid(R"("unterminated)"sv));
+    EXPECT(!is_valid(R"("bad \x escape")"sv));
+    EXPECT(!is_valid(R"("bad \u12 escape")"sv));
+    EXPECT(!is_valid(R"("trailing backslash\)"sv));
+}
+
+TEST_CASE(skip_and_read_values)
+{
+    JsonReader reader(R"({"skipped": {"deep": [1, [2, {"x": 3}]]}, "wanted": {"name": "yes", "list": [1, 2]}, "after": [4, 5]})"sv);
+    EXPECT_EQ(reader.next().value().type, TokenType::ObjectStart);
+
+    EXPECT(reader.next().value().text_equals("skipped"sv));
+    EXPECT(!reader.skip_value().is_error());
+    EXPECT_EQ(reader.depth(), 1u);
+
+    EXPECT(reader.next().value().text_equals("wanted"sv));
+    auto wanted = reader.read_value().value();
+    EXPECT(wanted.is_object());
+    EXPECT_EQ(wanted.as_object().get("name"sv).as_string(), "yes");
+    EXPECT_EQ(wanted.as_object().get("list"sv).as_array().size(), 2u);
+
+    EXPECT(reader.next().value().text_equals("after"sv));
+    EXPECT_EQ(reader.next().value().type, TokenType::ArrayStart);
+    EXPECT_EQ(reader.read_value().value().to_u32(), 4u);
+    EXPECT_EQ(reader.read_value().value().to_u32(), 5u);
+    EXPECT_EQ(reader.next().value().type, TokenType::ArrayEnd);
+    EXPECT_EQ(reader.next().value().type, TokenType::ObjectEnd);
+    EXPECT_EQ(reader.next().value().type, TokenType::EndOfInput);
+}
+
+// A long array of small objects, which is what the bigger JSON files in /sys look like.
+static String process_list_json()
+{
+    StringBuilder builder;
+    builder.append("{\"processes\":["sv);
+    for (size_t i = 0; i < 2000; ++i) {
+        if (i != 0)
+            builder.append(',');
+        builder.appendff(R"({{"pid":{},"name":"process-{}","executable":"/usr/bin/process","tty":"","pledge":"stdio rpath","threads":[{{"tid":{},"name":"main","state":"Running","time_user":123456,"time_kernel":7890}}]}})", i, i, i);
+    }
+    builder.append("]}"sv);
+    return builder.to_string();
+}
+
+BENCHMARK_CASE(benchmark_read_process_list)
+{
+    auto input = process_list_json();
+
+    for (size_t iteration = 0; iteration < 50; ++iteration) {
+        JsonReader reader(input);
+        size_t values = 0;
+        for (;;) {
+            auto token = reader.next().release_value();
+            if (token.type == TokenType::EndOfInput)
+                break;
+            values += token.is_value();
+        }
+        EXPECT_EQ(values, 2u + 2000 * 13);
+    }
+}
+
+BENCHMARK_CASE(benchmark_parse_process_list)
+{
+    auto input = process_list_json();
+
+    for (size_t iteration = 0; iteration < 50; ++iteration) {
+        auto json = JsonParser(input).parse().release_value();
+        EXPECT_EQ(json.as_object().get("processes"sv).as_array().size(), 2000u);
+    }
+}
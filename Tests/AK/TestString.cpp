@@ -162,6 +162,36 @@ TEST_CASE(flystring)
     }
 }
 
+TEST_CASE(single_byte_strings_are_shared)
+{
+    String a = "x";
+    String b = String::repeated('x', 1);
+    String c = String("AXB").substring(1, 1).to_lowercase();
+    EXPECT_EQ(a.impl(), b.impl());
+    EXPECT_EQ(a.impl(), c.impl());
+    EXPECT_EQ(a, "x");
+    EXPECT_EQ(a.length(), 1u);
+    EXPECT_EQ(a.characters()[1], '\0');
+
+    FlyString fly_from_view("x"sv);
+    FlyString fly_from_string = a;
+    EXPECT_EQ(fly_from_view.impl(), a.impl());
+    EXPECT_EQ(fly_from_string, fly_from_view);
+
+    EXPECT_EQ(String("\xff", 1).length(), 1u);
+    EXPECT_EQ(static_cast<u8>(String("\xff", 1)[0]), 0xffu);
+
+    // Every thread uses these, so they don't count references, which aren't atomic.
+    auto ref_count = a.impl()->ref_count();
+    {
+        Vector<String> copies;
+        for (size_t i = 0; i < 10; ++i)
+            copies.append(a);
+        EXPECT_EQ(a.impl()->ref_count(), ref_count);
+    }
+    EXPECT_EQ(a.impl()->ref_count(), ref_count);
+}
+
 TEST_CASE(replace)
 {
     String test_string = "Well, hello Friends!";
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Format.h>
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibTest/TestCase.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Maps region_count regions of region_size bytes each, and touches all of their pages.
+static Vector<u8*> map_touched_regions(size_t region_count, size_t region_size)
+{
+    Vector<u8*> regions;
+    for (size_t i = 0; i < region_count; ++i) {
+        auto* region = static_cast<u8*>(mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0));
+        VERIFY(region != MAP_FAILED);
+        memset(region, static_cast<int>(i), region_size);
+        regions.append(region);
+    }
+    return regions;
+}
+
+static void unmap_regions(Vector<u8*> const& regions, size_t region_size)
+{
+    for (auto* region : regions)
+        munmap(region, region_size);
+}
+
+// The child leaves right away, like it would when it's going to exec() something else.
+static void measure_fork_latency(size_t region_count, size_t region_size, size_t iteration_count)
+{
+    auto regions = map_touched_regions(region_count, region_size);
+
+    Core::ElapsedTimer timer(true);
+    timer.start();
+    for (size_t i = 0; i < iteration_count; ++i) {
+        auto pid = fork();
+        VERIFY(pid >= 0);
+        if (pid == 0)
+            _exit(0);
+        waitpid(pid, nullptr, 0);
+        // Write to one page in every region, so that the parent has to take its COW faults as well.
+        for (auto* region : regions)
+            region[0] = static_cast<u8>(i);
+    }
+    auto elapsed = timer.elapsed_time();
+
+    unmap_regions(regions, region_size);
+
+    auto microseconds_per_fork = static_cast<double>(elapsed.to_microseconds()) / iteration_count;
+    outln("{} regions of {} KiB: {:.2} us per fork", region_count, region_size / KiB, microseconds_per_fork);
+}
+
+TEST_CASE(child_sees_memory_of_the_parent)
+{
+    constexpr size_t region_size = 64 * KiB;
+    auto regions = map_touched_regions(16, region_size);
+
+    auto pid = fork();
+    EXPECT(pid >= 0);
+    if (pid == 0) {
+        for (size_t i = 0; i < regions.size(); ++i) {
+            for (size_t offset = 0; offset < region_size; offset += PAGE_SIZE) {
+                if (regions[i][offset] != static_cast<u8>(i))
+                    _exit(1);
+            }
+            // Writing has to leave the parent's copy alone.
+            memset(regions[i], 0xff, region_size);
+        }
+        _exit(0);
+    }
+
+    int wstatus = 0;
+    EXPECT_EQ(waitpid(pid, &wstatus, 0), pid);
+    EXPECT(WIFEXITED(wstatus));
+    EXPECT_EQ(WEXITSTATUS(wstatus), 0);
+    for (size_t i = 0; i < regions.size(); ++i)
+        EXPECT_EQ(regions[i][region_size - 1], static_cast<u8>(i));
+
+    unmap_regions(regions, region_size);
+}
+
+BENCHMARK_CASE(fork_latency_by_region_count)
+{
+    for (size_t region_count : { 16, 256, 1024 })
+        measure_fork_latency(region_count, 16 * KiB, 100);
+}
+
+BENCHMARK_CASE(fork_latency_with_a_large_region)
+{
+    // Like a process with a big heap, where nearly all of the work is in the page tables.
+    measure_fork_latency(1, 64 * MiB, 20);
+}
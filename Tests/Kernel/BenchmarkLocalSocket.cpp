@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Format.h>
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibTest/TestCase.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Reads or writes all of the buffer, however many calls it takes.
+static bool transfer_all(int fd, u8* data, size_t size, bool is_write)
+{
+    size_t done = 0;
+    while (done < size) {
+        auto rc = is_write ? write(fd, data + done, size - done) : read(fd, data + done, size - done);
+        if (rc <= 0)
+            return false;
+        done += rc;
+    }
+    return true;
+}
+
+// Like an IPC server: sends back whatever it gets, in messages of the given size, until the other side goes away.
+static pid_t spawn_echo_process(int fds[2], size_t message_size)
+{
+    auto pid = fork();
+    VERIFY(pid >= 0);
+    if (pid == 0) {
+        close(fds[0]);
+        Vector<u8> message;
+        message.resize(message_size);
+        while (transfer_all(fds[1], message.data(), message_size, false)) {
+            if (!transfer_all(fds[1], message.data(), message_size, true))
+                break;
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    return pid;
+}
+
+static void measure_round_trips(size_t message_size, size_t round_trip_count)
+{
+    int fds[2];
+    auto rc = socketpair(AF_LOCAL, SOCK_STREAM, 0, fds);
+    EXPECT_EQ(rc, 0);
+    auto pid = spawn_echo_process(fds, message_size);
+
+    Vector<u8> message;
+    message.resize(message_size);
+    for (size_t i = 0; i < message_size; ++i)
+        message[i] = static_cast<u8>(i);
+
+    Core::ElapsedTimer timer(true);
+    timer.start();
+    for (size_t i = 0; i < round_trip_count; ++i) {
+        EXPECT(transfer_all(fds[0], message.data(), message_size, true));
+        EXPECT(transfer_all(fds[0], message.data(), message_size, false));
+    }
+    auto elapsed = timer.elapsed_time();
+
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+
+    auto microseconds_per_round_trip = static_cast<double>(elapsed.to_microseconds()) / round_trip_count;
+    outln("{} round trips of {} bytes: {} ms, {:.2} us per round trip", round_trip_count, message_size, elapsed.to_milliseconds(), microseconds_per_round_trip);
+}
+
+TEST_CASE(data_arrives_in_order_across_the_end_of_the_ring)
+{
+    int fds[2];
+    auto rc = socketpair(AF_LOCAL, SOCK_STREAM, 0, fds);
+    EXPECT_EQ(rc, 0);
+
+    // An odd size, so that the messages keep ending up split across the end of the ring in different places.
+    constexpr size_t message_size = 3001;
+    auto pid = spawn_echo_process(fds, message_size);
+
+    Vector<u8> sent;
+    Vector<u8> received;
+    sent.resize(message_size);
+    received.resize(message_size);
+    for (size_t i = 0; i < 200; ++i) {
+        for (size_t j = 0; j < message_size; ++j)
+            sent[j] = static_cast<u8>(i * 7 + j);
+        EXPECT(transfer_all(fds[0], sent.data(), message_size, true));
+        EXPECT(transfer_all(fds[0], received.data(), message_size, false));
+        EXPECT(sent == received);
+    }
+
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+}
+
+BENCHMARK_CASE(small_message_round_trip_latency)
+{
+    // About the size of a typical IPC message, like a mouse event or a paint request.
+    measure_round_trips(64, 20'000);
+}
+
+BENCHMARK_CASE(large_message_round_trip_latency)
+{
+    // Larger than the buffer going each way, so the writer has to wait for the reader to make room.
+    measure_round_trips(256 * KiB, 200);
+}
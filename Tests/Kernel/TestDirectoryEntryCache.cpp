@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/String.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool exists(char const* path)
+{
+    struct stat st;
+    return stat(path, &st) == 0;
+}
+
+static ino_t inode_of(char const* path)
+{
+    struct stat st;
+    EXPECT_EQ(stat(path, &st), 0);
+    return st.st_ino;
+}
+
+static void create_file(char const* path)
+{
+    int fd = open(path, O_CREAT | O_WRONLY | O_EXCL, 0644);
+    EXPECT(fd >= 0);
+    close(fd);
+}
+
+TEST_CASE(created_file_is_found_after_failed_lookup)
+{
+    char directory[] = "/tmp/dentry.XXXXXX";
+    EXPECT(mkdtemp(directory));
+    auto path = String::formatted("{}/file", directory);
+
+    EXPECT(!exists(path.characters()));
+    EXPECT(!exists(path.characters()));
+    create_file(path.characters());
+    EXPECT(exists(path.characters()));
+
+    EXPECT_EQ(unlink(path.characters()), 0);
+    EXPECT(!exists(path.characters()));
+    EXPECT_EQ(rmdir(directory), 0);
+}
+
+TEST_CASE(rename_moves_the_name)
+{
+    char directory[] = "/tmp/dentry.XXXXXX";
+    EXPECT(mkdtemp(directory));
+    auto old_path = String::formatted("{}/old", directory);
+    auto new_path = String::formatted("{}/new", directory);
+
+    create_file(old_path.characters());
+    auto inode = inode_of(old_path.characters());
+    EXPECT(!exists(new_path.characters()));
+
+    EXPECT_EQ(rename(old_path.characters(), new_path.characters()), 0);
+    EXPECT(!exists(old_path.characters()));
+    EXPECT_EQ(inode_of(new_path.characters()), inode);
+
+    EXPECT_EQ(unlink(new_path.characters()), 0);
+    EXPECT_EQ(rmdir(directory), 0);
+}
+
+TEST_CASE(recreated_directory_is_empty)
+{
+    char directory[] = "/tmp/dentry.XXXXXX";
+    EXPECT(mkdtemp(directory));
+    auto subdirectory = String::formatted("{}/subdirectory", directory);
+    auto path = String::formatted("{}/subdirectory/file", directory);
+
+    EXPECT_EQ(mkdir(subdirectory.characters(), 0755), 0);
+    create_file(path.characters());
+    EXPECT_EQ(unlink(path.characters()), 0);
+    EXPECT_EQ(rmdir(subdirectory.characters()), 0);
+
+    EXPECT_EQ(mkdir(subdirectory.characters(), 0755), 0);
+    EXPECT(!exists(path.characters()));
+    create_file(path.characters());
+    EXPECT(exists(path.characters()));
+
+    EXPECT_EQ(unlink(path.characters()), 0);
+    EXPECT_EQ(rmdir(subdirectory.characters()), 0);
+    EXPECT_EQ(rmdir(directory), 0);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/String.h>
+#include <LibTest/TestCase.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Enough names to spill over many blocks, so that the directory gets an index and its leaves get split.
+static constexpr size_t file_count = 2000;
+
+static String file_path(char const* directory, size_t i)
+{
+    return String::formatted("{}/a-reasonably-long-file-name-{}", directory, i);
+}
+
+static bool exists(String const& path)
+{
+    struct stat st;
+    return stat(path.characters(), &st) == 0;
+}
+
+static size_t count_entries(char const* directory)
+{
+    auto* dir = opendir(directory);
+    EXPECT(dir);
+    size_t count = 0;
+    while (readdir(dir))
+        ++count;
+    closedir(dir);
+    return count;
+}
+
+TEST_CASE(large_directory)
+{
+    // /tmp is a TmpFS, this needs to be on the Ext2 root file system.
+    char directory[] = "/home/anon/htree.XXXXXX";
+    EXPECT(mkdtemp(directory));
+
+    for (size_t i = 0; i < file_count; ++i) {
+        int fd = open(file_path(directory, i).characters(), O_CREAT | O_WRONLY | O_EXCL, 0644);
+        EXPECT(fd >= 0);
+        close(fd);
+    }
+    EXPECT_EQ(count_entries(directory), file_count + 2);
+
+    for (size_t i = 0; i < file_count; ++i)
+        EXPECT(exists(file_path(directory, i)));
+    EXPECT(!exists(file_path(directory, file_count)));
+
+    int fd = open(file_path(directory, 0).characters(), O_CREAT | O_WRONLY | O_EXCL, 0644);
+    EXPECT_EQ(fd, -1);
+    EXPECT_EQ(errno, EEXIST);
+
+    for (size_t i = 0; i < file_count; i += 2)
+        EXPECT_EQ(unlink(file_path(directory, i).characters()), 0);
+    for (size_t i = 0; i < file_count; ++i)
+        EXPECT_EQ(exists(file_path(directory, i)), i % 2 == 1);
+    EXPECT_EQ(count_entries(directory), file_count / 2 + 2);
+
+    for (size_t i = 1; i < file_count; i += 2)
+        EXPECT_EQ(unlink(file_path(directory, i).characters()), 0);
+    EXPECT_EQ(count_entries(directory), 2u);
+    EXPECT_EQ(rmdir(directory), 0);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int create_temporary_file()
+{
+    char path[] = "/tmp/tmpfs.XXXXXX";
+    int fd = mkstemp(path);
+    EXPECT(fd >= 0);
+    EXPECT_EQ(unlink(path), 0);
+    return fd;
+}
+
+static off_t file_size(int fd)
+{
+    struct stat st;
+    EXPECT_EQ(fstat(fd, &st), 0);
+    return st.st_size;
+}
+
+TEST_CASE(small_writes_add_up)
+{
+    int fd = create_temporary_file();
+    Array<u8, 100> chunk;
+    for (size_t i = 0; i < 5000; ++i) {
+        chunk.fill(i & 0xff);
+        EXPECT_EQ(write(fd, chunk.data(), chunk.size()), static_cast<ssize_t>(chunk.size()));
+    }
+    EXPECT_EQ(file_size(fd), 500000);
+
+    for (size_t i = 0; i < 5000; i += 499) {
+        EXPECT_EQ(pread(fd, chunk.data(), chunk.size(), i * chunk.size()), static_cast<ssize_t>(chunk.size()));
+        for (auto byte : chunk)
+            EXPECT_EQ(byte, i & 0xff);
+    }
+    close(fd);
+}
+
+TEST_CASE(holes_read_as_zeroes)
+{
+    int fd = create_temporary_file();
+    u8 byte = 0xaa;
+    EXPECT_EQ(pwrite(fd, &byte, 1, 1 * MiB), 1);
+    EXPECT_EQ(file_size(fd), static_cast<off_t>(1 * MiB + 1));
+
+    Array<u8, 4096> buffer;
+    buffer.fill(0xff);
+    EXPECT_EQ(pread(fd, buffer.data(), buffer.size(), 300 * KiB), static_cast<ssize_t>(buffer.size()));
+    for (auto value : buffer)
+        EXPECT_EQ(value, 0);
+    close(fd);
+}
+
+TEST_CASE(fallocate_grows_the_file)
+{
+    int fd = create_temporary_file();
+    EXPECT_EQ(posix_fallocate(fd, 0, 64 * KiB), 0);
+    EXPECT_EQ(file_size(fd), static_cast<off_t>(64 * KiB));
+
+    // Allocating a range inside of the file leaves its size alone.
+    EXPECT_EQ(posix_fallocate(fd, 4 * KiB, 4 * KiB), 0);
+    EXPECT_EQ(file_size(fd), static_cast<off_t>(64 * KiB));
+
+    u8 byte = 0xff;
+    EXPECT_EQ(pread(fd, &byte, 1, 32 * KiB), 1);
+    EXPECT_EQ(byte, 0);
+    close(fd);
+}
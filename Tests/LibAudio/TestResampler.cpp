@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <AK/Vector.h>
+#include <LibAudio/Resampler.h>
+#include <LibTest/TestCase.h>
+
+static Vector<Audio::Sample> sine_wave(float frequency, u32 sample_rate, size_t length)
+{
+    Vector<Audio::Sample> samples;
+    for (size_t i = 0; i < length; ++i) {
+        auto value = AK::sin(2 * AK::Pi<float> * frequency * i / sample_rate) * 0.5f;
+        samples.append({ value, -value });
+    }
+    return samples;
+}
+
+TEST_CASE(constant_signal_stays_constant)
+{
+    struct Rates {
+        u32 source;
+        u32 target;
+    };
+    for (auto rates : Array { Rates { 44100, 48000 }, Rates { 48000, 44100 }, Rates { 22050, 48000 }, Rates { 48000, 8000 } }) {
+        auto resampler = MUST(Audio::SincResampler::try_create(rates.source, rates.target));
+        Vector<Audio::Sample> input;
+        for (size_t i = 0; i < 4000; ++i)
+            input.append({ 0.25f, -0.5f });
+        auto output = MUST(resampler.resample(input));
+
+        // Skip the start, where the filter still sees the silence before the stream.
+        for (size_t i = Audio::SincResampler::filter_length; i < output.size(); ++i) {
+            EXPECT(AK::fabs(output[i].left - 0.25f) < 0.0001f);
+            EXPECT(AK::fabs(output[i].right + 0.5f) < 0.0001f);
+        }
+    }
+}
+
+TEST_CASE(output_length_follows_the_rate_ratio)
+{
+    auto resampler = MUST(Audio::SincResampler::try_create(44100, 48000));
+    size_t output_length = 0;
+    for (size_t batch = 0; batch < 100; ++batch)
+        output_length += MUST(resampler.resample(sine_wave(440, 44100, 441))).size();
+
+    // 44100 input samples are one second of audio, minus the half filter length that is still in flight.
+    EXPECT(output_length <= 48000u);
+    EXPECT(output_length >= 48000u - Audio::SincResampler::filter_length * 2);
+}
+
+TEST_CASE(batches_are_seamless)
+{
+    auto input = sine_wave(1000, 48000, 4800);
+
+    auto whole_resampler = MUST(Audio::SincResampler::try_create(48000, 44100));
+    auto whole = MUST(whole_resampler.resample(input));
+
+    auto batched_resampler = MUST(Audio::SincResampler::try_create(48000, 44100));
+    Vector<Audio::Sample> batched;
+    for (size_t offset = 0; offset < input.size(); offset += 37) {
+        auto batch = input.span().slice(offset, min<size_t>(37, input.size() - offset));
+        batched.extend(Vector<Audio::Sample> { MUST(batched_resampler.resample(batch)).span() });
+    }
+
+    EXPECT_EQ(whole.size(), batched.size());
+    for (size_t i = 0; i < min(whole.size(), batched.size()); ++i) {
+        EXPECT_EQ(whole[i].left, batched[i].left);
+        EXPECT_EQ(whole[i].right, batched[i].right);
+    }
+}
+
+TEST_CASE(sine_keeps_its_amplitude)
+{
+    auto resampler = MUST(Audio::SincResampler::try_create(44100, 48000));
+    auto output = MUST(resampler.resample(sine_wave(1000, 44100, 4410)));
+
+    float peak = 0;
+    for (size_t i = Audio::SincResampler::filter_length; i < output.size(); ++i)
+        peak = max(peak, AK::fabs(output[i].left));
+    EXPECT(peak > 0.49f && peak < 0.51f);
+}
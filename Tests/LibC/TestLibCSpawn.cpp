@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int wait_for_exit_status(pid_t pid)
+{
+    int wstatus = 0;
+    VERIFY(waitpid(pid, &wstatus, 0) == pid);
+    VERIFY(WIFEXITED(wstatus));
+    return WEXITSTATUS(wstatus);
+}
+
+TEST_CASE(spawn_reports_missing_program)
+{
+    pid_t pid = -1;
+    char const* argv[] = { "/bin/does-not-exist", nullptr };
+    int rc = posix_spawn(&pid, argv[0], nullptr, nullptr, const_cast<char**>(argv), environ);
+    EXPECT_EQ(rc, ENOENT);
+
+    rc = posix_spawnp(&pid, "does-not-exist", nullptr, nullptr, const_cast<char**>(argv), environ);
+    EXPECT_EQ(rc, ENOENT);
+}
+
+TEST_CASE(spawn_applies_file_actions_in_order)
+{
+    int fds[2];
+    EXPECT_EQ(pipe(fds), 0);
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_adddup2(&file_actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&file_actions, fds[0]);
+    posix_spawn_file_actions_addclose(&file_actions, fds[1]);
+    // Closing something that isn't open must not keep the program from running.
+    posix_spawn_file_actions_addclose(&file_actions, 1000);
+    posix_spawn_file_actions_addchdir(&file_actions, "/usr");
+
+    pid_t pid = -1;
+    char const* argv[] = { "pwd", nullptr };
+    int rc = posix_spawnp(&pid, argv[0], &file_actions, nullptr, const_cast<char**>(argv), environ);
+    posix_spawn_file_actions_destroy(&file_actions);
+    close(fds[1]);
+    EXPECT_EQ(rc, 0);
+
+    char buffer[64] {};
+    auto nread = read(fds[0], buffer, sizeof(buffer) - 1);
+    close(fds[0]);
+    EXPECT_EQ(StringView(buffer, max<ssize_t>(nread, 0)), "/usr\n"sv);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+}
+
+TEST_CASE(spawn_into_new_process_group)
+{
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    pid_t pid = -1;
+    char const* argv[] = { "true", nullptr };
+    int rc = posix_spawnp(&pid, argv[0], nullptr, &attr, const_cast<char**>(argv), environ);
+    posix_spawnattr_destroy(&attr);
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(getpgid(pid), pid);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+}
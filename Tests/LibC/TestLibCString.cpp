@@ -29,3 +29,73 @@ TEST_CASE(strtok_r_delimiters_only)
     // The string to which `saved_str` initially points to shouldn't be modified.
     EXPECT_EQ(strcmp(dummy, "a;"), 0);
 }
+
+TEST_CASE(memcpy_sizes_and_alignments)
+{
+    // Covers every size class of the optimized implementations, with differently aligned sources and destinations.
+    constexpr size_t max_size = 600;
+    static u8 source[max_size + 32];
+    static u8 destination[max_size + 64];
+    for (size_t i = 0; i < sizeof(source); ++i)
+        source[i] = i * 7 + 1;
+
+    for (size_t size = 0; size < max_size; ++size) {
+        for (size_t source_offset = 0; source_offset < 17; source_offset += 4) {
+            for (size_t destination_offset = 0; destination_offset < 17; destination_offset += 5) {
+                memset(destination, 0, sizeof(destination));
+                EXPECT_EQ(memcpy(destination + 16 + destination_offset, source + source_offset, size), destination + 16 + destination_offset);
+                EXPECT_EQ(memcmp(destination + 16 + destination_offset, source + source_offset, size), 0);
+                // Nothing around the destination may have been touched.
+                for (size_t i = 0; i < 16 + destination_offset; ++i)
+                    EXPECT_EQ(destination[i], 0);
+                for (size_t i = 16 + destination_offset + size; i < sizeof(destination); ++i)
+                    EXPECT_EQ(destination[i], 0);
+            }
+        }
+    }
+}
+
+TEST_CASE(memcpy_large)
+{
+    // Large enough to use non-temporal stores.
+    constexpr size_t size = 5 * MiB + 3;
+    auto* source = static_cast<u8*>(malloc(size));
+    auto* destination = static_cast<u8*>(malloc(size));
+    for (size_t i = 0; i < size; ++i)
+        source[i] = i % 251;
+    memcpy(destination, source, size);
+    EXPECT_EQ(memcmp(destination, source, size), 0);
+    free(source);
+    free(destination);
+}
+
+TEST_CASE(strlen_and_memchr_at_every_offset)
+{
+    alignas(16) char buffer[128];
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t length = 0; length < 64; ++length) {
+            memset(buffer, 1, sizeof(buffer));
+            buffer[offset + length] = '\0';
+            EXPECT_EQ(strlen(buffer + offset), length);
+
+            buffer[offset + length] = 'x';
+            EXPECT_EQ(memchr(buffer + offset, 'x', length), nullptr);
+            EXPECT_EQ(memchr(buffer + offset, 'x', length + 1), buffer + offset + length);
+        }
+    }
+}
+
+TEST_CASE(memcmp_ordering)
+{
+    u8 a[32] {};
+    u8 b[32] {};
+    for (size_t i = 0; i < sizeof(a); ++i) {
+        a[i] = 0x80;
+        b[i] = 0x7f;
+        // The first difference decides, and bytes compare as unsigned.
+        EXPECT(memcmp(a, b, sizeof(a)) > 0);
+        EXPECT(memcmp(b, a, sizeof(a)) < 0);
+        EXPECT_EQ(memcmp(a, b, i), 0);
+        b[i] = 0x80;
+    }
+}
@@ -6,9 +6,12 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Vector.h>
 #include <LibC/mallocdefs.h>
 #include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +41,56 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+TEST_CASE(malloc_good_size_stays_close_to_requested_size)
+{
+    for (size_t size = 1; size <= largest_size_class; ++size) {
+        auto good_size = malloc_good_size(size);
+        EXPECT(good_size >= size);
+        EXPECT(good_size - size < max<size_t>(16, size / size_classes_per_power_of_two));
+    }
+}
+
+static constexpr size_t allocations_per_thread = 2000;
+static void* allocations_from_other_thread[allocations_per_thread];
+
+static void* allocate_and_free(void* argument)
+{
+    auto thread_index = reinterpret_cast<uintptr_t>(argument);
+    Vector<u8*> allocations;
+    for (size_t i = 0; i < allocations_per_thread; ++i) {
+        auto size = (i * 37) % 1500 + 1;
+        auto* ptr = static_cast<u8*>(malloc(size));
+        VERIFY(ptr);
+        memset(ptr, static_cast<u8>(thread_index + i), size);
+        allocations.append(ptr);
+    }
+    for (size_t i = 0; i < allocations_per_thread; ++i) {
+        auto size = (i * 37) % 1500 + 1;
+        for (size_t j = 0; j < size; ++j) {
+            if (allocations[i][j] != static_cast<u8>(thread_index + i))
+                return reinterpret_cast<void*>(1);
+        }
+        // Hand every other allocation of the first thread to the main thread, so some chunks are freed by another thread.
+        if (thread_index == 0 && i % 2 == 0)
+            allocations_from_other_thread[i] = allocations[i];
+        else
+            free(allocations[i]);
+    }
+    return nullptr;
+}
+
+TEST_CASE(malloc_from_multiple_threads)
+{
+    static constexpr size_t thread_count = 4;
+    pthread_t threads[thread_count];
+    for (size_t i = 0; i < thread_count; ++i)
+        EXPECT_EQ(pthread_create(&threads[i], nullptr, allocate_and_free, reinterpret_cast<void*>(i)), 0);
+    for (size_t i = 0; i < thread_count; ++i) {
+        void* result = nullptr;
+        EXPECT_EQ(pthread_join(threads[i], &result), 0);
+        EXPECT_EQ(result, nullptr);
+    }
+    for (auto* ptr : allocations_from_other_thread)
+        free(ptr);
+}
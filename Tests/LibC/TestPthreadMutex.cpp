@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+static pthread_mutex_t make_mutex(int type, int protocol)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, type);
+    pthread_mutexattr_setprotocol(&attributes, protocol);
+    pthread_mutex_t mutex;
+    pthread_mutex_init(&mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    return mutex;
+}
+
+struct ContendedCounter {
+    pthread_mutex_t mutex;
+    size_t iterations { 0 };
+    size_t value { 0 };
+};
+
+static void* increment_contended_counter(void* argument)
+{
+    auto& counter = *static_cast<ContendedCounter*>(argument);
+    for (size_t i = 0; i < counter.iterations; ++i) {
+        pthread_mutex_lock(&counter.mutex);
+        ++counter.value;
+        pthread_mutex_unlock(&counter.mutex);
+    }
+    return nullptr;
+}
+
+static void run_contended_counter(int protocol, size_t iterations)
+{
+    ContendedCounter counter { make_mutex(PTHREAD_MUTEX_NORMAL, protocol), iterations };
+
+    Array<pthread_t, 4> threads;
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, increment_contended_counter, &counter), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    EXPECT_EQ(counter.value, threads.size() * iterations);
+    EXPECT_EQ(pthread_mutex_destroy(&counter.mutex), 0);
+}
+
+TEST_CASE(mutex_protocol_attribute)
+{
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+
+    int protocol = -1;
+    EXPECT_EQ(pthread_mutexattr_getprotocol(&attributes, &protocol), 0);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_NONE);
+
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT), 0);
+    EXPECT_EQ(pthread_mutexattr_getprotocol(&attributes, &protocol), 0);
+    EXPECT_EQ(protocol, PTHREAD_PRIO_INHERIT);
+
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_PROTECT), ENOTSUP);
+    EXPECT_EQ(pthread_mutexattr_setprotocol(&attributes, 1234), EINVAL);
+
+    pthread_mutexattr_destroy(&attributes);
+}
+
+TEST_CASE(priority_inheriting_mutex)
+{
+    auto mutex = make_mutex(PTHREAD_MUTEX_NORMAL, PTHREAD_PRIO_INHERIT);
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), EBUSY);
+    EXPECT_EQ(pthread_mutex_lock(&mutex), EDEADLK);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+}
+
+TEST_CASE(recursive_priority_inheriting_mutex)
+{
+    auto mutex = make_mutex(PTHREAD_MUTEX_RECURSIVE, PTHREAD_PRIO_INHERIT);
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_lock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_trylock(&mutex), 0);
+    EXPECT_EQ(pthread_mutex_unlock(&mutex), 0);
+}
+
+TEST_CASE(contended_mutex)
+{
+    run_contended_counter(PTHREAD_PRIO_NONE, 10000);
+}
+
+TEST_CASE(contended_priority_inheriting_mutex)
+{
+    run_contended_counter(PTHREAD_PRIO_INHERIT, 10000);
+}
+
+struct Broadcast {
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    bool go { false };
+    size_t waiting { 0 };
+    size_t woken { 0 };
+};
+
+static void* wait_for_broadcast(void* argument)
+{
+    auto& broadcast = *static_cast<Broadcast*>(argument);
+    pthread_mutex_lock(&broadcast.mutex);
+    ++broadcast.waiting;
+    while (!broadcast.go)
+        pthread_cond_wait(&broadcast.condition, &broadcast.mutex);
+    ++broadcast.woken;
+    pthread_mutex_unlock(&broadcast.mutex);
+    return nullptr;
+}
+
+static void run_broadcast(int protocol)
+{
+    Broadcast broadcast { make_mutex(PTHREAD_MUTEX_NORMAL, protocol), PTHREAD_COND_INITIALIZER };
+
+    Array<pthread_t, 8> threads;
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, wait_for_broadcast, &broadcast), 0);
+
+    for (;;) {
+        pthread_mutex_lock(&broadcast.mutex);
+        if (broadcast.waiting == threads.size())
+            break;
+        pthread_mutex_unlock(&broadcast.mutex);
+        usleep(1000);
+    }
+    broadcast.go = true;
+    pthread_cond_broadcast(&broadcast.condition);
+    pthread_mutex_unlock(&broadcast.mutex);
+
+    // Every single waiter has to be woken up, even though only one of them is woken up by the broadcast directly.
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    EXPECT_EQ(broadcast.woken, threads.size());
+}
+
+TEST_CASE(condition_broadcast_wakes_all_waiters)
+{
+    run_broadcast(PTHREAD_PRIO_NONE);
+}
+
+TEST_CASE(condition_broadcast_wakes_all_waiters_of_priority_inheriting_mutex)
+{
+    run_broadcast(PTHREAD_PRIO_INHERIT);
+}
+
+BENCHMARK_CASE(contended_mutex_throughput)
+{
+    run_contended_counter(PTHREAD_PRIO_NONE, 1'000'000);
+}
+
+BENCHMARK_CASE(contended_priority_inheriting_mutex_throughput)
+{
+    run_contended_counter(PTHREAD_PRIO_INHERIT, 1'000'000);
+}
@@ -324,4 +324,6 @@ TEST_CASE(truncation)
     EXPECT(test_single<unsigned long long int>({ LITERAL("xxxxxxxxxxxxxxxxxxxxxxx"), "|%llu|", ULLONG_MAX, 22, LITERAL("|18446744073709551615|\0") }));
     EXPECT(test_single<unsigned long long int>({ LITERAL("xxxxxxxxxxxxxxxxxxx"), "|%llx|", ULLONG_MAX, 18, LITERAL("|ffffffffffffffff|\0") }));
     EXPECT(test_single<unsigned long long int>({ LITERAL("xxxxxxxxxxxxxxxxxxx"), "|%llX|", ULLONG_MAX, 18, LITERAL("|FFFFFFFFFFFFFFFF|\0") }));
+    EXPECT(test_single<unsigned int>({ LITERAL("xxxxxxxxxxxxxx"), "|%o|", UINT_MAX, 13, LITERAL("|37777777777|\0") }));
+    EXPECT(test_single<unsigned long long int>({ LITERAL("xxxxxxxxxxxxxxxxxxxxxxxxx"), "|%llo|", ULLONG_MAX, 24, LITERAL("|1777777777777777777777|\0") }));
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/String.h>
 #include <LibTest/TestCase.h>
 #include <stdio.h>
 #include <sys/wait.h>
@@ -54,3 +55,47 @@ TEST_CASE(sprintf_sign)
     EXPECT_EQ(buf1, "+12"sv);
     EXPECT_EQ(buf2, "-12"sv);
 }
+
+TEST_CASE(unlocked_variants)
+{
+    auto* fp = tmpfile();
+    VERIFY(fp != nullptr);
+
+    flockfile(fp);
+    EXPECT_EQ(fputs_unlocked("hello", fp), 1);
+    EXPECT_EQ(fputc_unlocked(' ', fp), ' ');
+    EXPECT_EQ(fwrite_unlocked("world\n", 1, 6, fp), 6u);
+    EXPECT_EQ(fflush_unlocked(fp), 0);
+    funlockfile(fp);
+
+    rewind(fp);
+    char buf[32];
+    flockfile(fp);
+    EXPECT_EQ(fgets_unlocked(buf, sizeof(buf), fp), buf);
+    EXPECT_EQ(fgetc_unlocked(fp), EOF);
+    EXPECT(feof_unlocked(fp));
+    EXPECT(!ferror_unlocked(fp));
+    clearerr_unlocked(fp);
+    EXPECT(!feof_unlocked(fp));
+    funlockfile(fp);
+    fclose(fp);
+
+    EXPECT_EQ(buf, "hello world\n"sv);
+}
+
+TEST_CASE(fprintf_longer_than_its_buffer)
+{
+    auto* fp = tmpfile();
+    VERIFY(fp != nullptr);
+
+    auto expected = String::repeated('x', 1000);
+    int rc = fprintf(fp, "%s|%d|%s", expected.characters(), 42, expected.characters());
+    EXPECT_EQ(rc, 2004);
+    rewind(fp);
+
+    char buf[2048];
+    auto nread = fread(buf, 1, sizeof(buf), fp);
+    fclose(fp);
+    EXPECT_EQ(nread, 2004u);
+    EXPECT_EQ(StringView(buf, nread), String::formatted("{}|42|{}", expected, expected));
+}
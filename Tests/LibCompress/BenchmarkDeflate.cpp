@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Format.h>
+#include <AK/Random.h>
+#include <AK/Time.h>
+#include <LibCompress/Deflate.h>
+#include <time.h>
+
+// A few MiB of input that compresses roughly like real files do: text made up of a small vocabulary, followed by
+// binary data with short repeats and some noise.
+static ByteBuffer const& benchmark_corpus()
+{
+    static ByteBuffer s_corpus = [] {
+        constexpr StringView words[] = {
+            "the"sv, "of"sv, "and"sv, "to"sv, "in"sv, "is"sv, "that"sv, "for"sv, "return"sv, "auto"sv, "const"sv,
+            "size_t"sv, "if"sv, "else"sv, "while"sv, "static"sv, "void"sv, "ErrorOr"sv, "TRY"sv, "Vector"sv,
+            "compression"sv, "window"sv, "symbol"sv, "length"sv, "distance"sv, "block"sv, "stream"sv, "\n"sv,
+        };
+
+        ByteBuffer corpus;
+        corpus.ensure_capacity(4 * MiB + 64);
+        u32 seed = 1;
+        auto next_random = [&] {
+            seed = seed * 1103515245 + 12345;
+            return seed >> 16;
+        };
+
+        while (corpus.size() < 3 * MiB) {
+            corpus.append(words[next_random() % array_size(words)].bytes());
+            corpus.append(' ');
+        }
+        while (corpus.size() < 4 * MiB) {
+            auto value = static_cast<u8>(next_random());
+            auto run_length = next_random() % 16;
+            for (size_t i = 0; i < run_length; ++i)
+                corpus.append(static_cast<u8>(value + i));
+        }
+        return corpus;
+    }();
+    return s_corpus;
+}
+
+static void benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel level, StringView name)
+{
+    auto const& corpus = benchmark_corpus();
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    auto compressed = Compress::DeflateCompressor::compress_all(corpus, level);
+    timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    VERIFY(compressed.has_value());
+
+    auto elapsed = Time::from_timespec(end) - Time::from_timespec(start);
+    auto elapsed_seconds = max(elapsed.to_microseconds(), 1) / 1'000'000.0;
+    outln("{}: {:.1} MB/s, compressed to {:.1}%", name, corpus.size() / elapsed_seconds / 1'000'000.0, compressed->size() * 100.0 / corpus.size());
+
+    auto decompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(decompressed.has_value() && decompressed.value() == corpus);
+}
+
+BENCHMARK_CASE(deflate_compress_store)
+{
+    benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel::STORE, "STORE"sv);
+}
+
+BENCHMARK_CASE(deflate_compress_fast)
+{
+    benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel::FAST, "FAST"sv);
+}
+
+BENCHMARK_CASE(deflate_compress_good)
+{
+    benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel::GOOD, "GOOD"sv);
+}
+
+BENCHMARK_CASE(deflate_compress_great)
+{
+    benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel::GREAT, "GREAT"sv);
+}
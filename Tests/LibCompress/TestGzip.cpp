@@ -95,3 +95,20 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed.has_value());
     EXPECT(uncompressed.value() == original);
 }
+
+TEST_CASE(gzip_round_trip_multiple_threads)
+{
+    // Random words, so that there are matches that reach back across the chunks that are compressed on their own.
+    auto original = ByteBuffer::create_uninitialized(1 * MiB).release_value();
+    Array<u8, 4096> words;
+    fill_with_random(words.data(), words.size());
+    for (size_t i = 0; i < original.size(); i += 16)
+        original.overwrite(i, &words[(get_random<u16>() % (words.size() / 16)) * 16], 16);
+
+    auto compressed = Compress::GzipCompressor::compress_all(original, { .thread_count = 4 });
+    EXPECT(compressed.has_value());
+    EXPECT(compressed->size() < original.size() / 4);
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/Event.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Object.h>
+#include <LibCore/SmallAllocationPool.h>
+#include <LibTest/TestCase.h>
+
+class EventCounter final : public Core::Object {
+    C_OBJECT(EventCounter);
+
+public:
+    Function<void(int)> on_custom_event;
+
+private:
+    EventCounter() = default;
+
+    virtual void custom_event(Core::CustomEvent& event) override
+    {
+        if (on_custom_event)
+            on_custom_event(event.custom_type());
+    }
+};
+
+TEST_CASE(events_and_deferred_invocations_keep_their_order)
+{
+    Core::EventLoop event_loop;
+    auto counter = EventCounter::construct();
+    Vector<int> order;
+    counter->on_custom_event = [&](int custom_type) { order.append(custom_type); };
+
+    for (int i = 0; i < 100; ++i) {
+        if (i % 2 == 0)
+            event_loop.post_event(*counter, make<Core::CustomEvent>(i));
+        else
+            event_loop.deferred_invoke([&order, i] { order.append(i); });
+    }
+    event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+
+    EXPECT_EQ(order.size(), 100u);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(order[i], i);
+}
+
+TEST_CASE(small_allocations_are_reused)
+{
+    void* first = Core::SmallAllocationPool::allocate(100);
+    Core::SmallAllocationPool::deallocate(first, 100);
+    void* second = Core::SmallAllocationPool::allocate(120);
+    EXPECT_EQ(first, second);
+    Core::SmallAllocationPool::deallocate(second, 120);
+}
+
+// About what a busy frame in WindowServer or WebContent goes through.
+static constexpr size_t events_per_iteration = 1000;
+
+BENCHMARK_CASE(deferred_invoke_dispatch)
+{
+    Core::EventLoop event_loop;
+    size_t invocations = 0;
+    for (size_t i = 0; i < events_per_iteration; ++i)
+        event_loop.deferred_invoke([&invocations] { ++invocations; });
+    event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    EXPECT_EQ(invocations, events_per_iteration);
+}
+
+BENCHMARK_CASE(post_event_dispatch)
+{
+    Core::EventLoop event_loop;
+    auto counter = EventCounter::construct();
+    size_t events = 0;
+    counter->on_custom_event = [&](int) { ++events; };
+    for (size_t i = 0; i < events_per_iteration; ++i)
+        event_loop.post_event(*counter, make<Core::CustomEvent>(0));
+    event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    EXPECT_EQ(events, events_per_iteration);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/Coroutine.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Promise.h>
+#include <LibTest/TestCase.h>
+#include <unistd.h>
+
+static Core::Coroutine<int> add_later(int a, int b)
+{
+    co_await Core::sleep_for(10);
+    co_return a + b;
+}
+
+static Core::Coroutine<int> add_three_later(int a, int b, int c)
+{
+    auto sum = co_await add_later(a, b);
+    co_return co_await add_later(sum, c);
+}
+
+TEST_CASE(sleep_and_nested_coroutines)
+{
+    Core::EventLoop event_loop;
+    EXPECT_EQ(add_three_later(1, 2, 3).await(), 6);
+}
+
+TEST_CASE(coroutine_without_suspending)
+{
+    Core::EventLoop event_loop;
+    auto coroutine = []() -> Core::Coroutine<int> { co_return 42; }();
+    EXPECT(coroutine.is_done());
+    EXPECT_EQ(coroutine.await(), 42);
+}
+
+TEST_CASE(await_promise)
+{
+    Core::EventLoop event_loop;
+    auto promise = Core::Promise<int>::construct();
+    auto coroutine = [](NonnullRefPtr<Core::Promise<int>> promise) -> Core::Coroutine<int> {
+        co_return co_await promise;
+    }(promise);
+    EXPECT(!coroutine.is_done());
+
+    Core::deferred_invoke([promise]() mutable { promise->resolve(7); });
+    EXPECT_EQ(coroutine.await(), 7);
+}
+
+TEST_CASE(await_readable_fd)
+{
+    Core::EventLoop event_loop;
+    int fds[2];
+    EXPECT_EQ(pipe(fds), 0);
+
+    auto coroutine = [](int fd) -> Core::Coroutine<char> {
+        co_await Core::until_readable(fd);
+        char c = 0;
+        VERIFY(read(fd, &c, 1) == 1);
+        co_return c;
+    }(fds[0]);
+    EXPECT(!coroutine.is_done());
+
+    Core::deferred_invoke([fd = fds[1]] { VERIFY(write(fd, "x", 1) == 1); });
+    EXPECT_EQ(coroutine.await(), 'x');
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE(destroying_a_coroutine_cancels_it)
+{
+    Core::EventLoop event_loop;
+    bool did_resume = false;
+    {
+        auto coroutine = [](bool& did_resume) -> Core::Coroutine<void> {
+            co_await Core::sleep_for(10);
+            did_resume = true;
+        }(did_resume);
+    }
+
+    add_later(0, 0).await();
+    EXPECT(!did_resume);
+}
+
+TEST_CASE(detached_coroutine)
+{
+    Core::EventLoop event_loop;
+    int result = 0;
+    auto coroutine = [](int& result) -> Core::Coroutine<void> {
+        result = co_await add_later(20, 22);
+    }(result);
+    coroutine.detach();
+
+    while (result == 0)
+        event_loop.pump();
+    EXPECT_EQ(result, 42);
+}
@@ -115,6 +115,41 @@ TEST_CASE(producer_consumer_multithread)
     EXPECT_EQ(queue.weak_used(), (size_t)0);
 }
 
+// The producer blocks instead of failing, and never gets further ahead of the consumer than the producer limit.
+TEST_CASE(blocking_producer_with_limit)
+{
+    auto queue = MUST(TestQueue::try_create());
+    size_t const producer_limit = 4;
+    queue.set_producer_limit(producer_limit);
+    EXPECT_EQ(queue.producer_limit(), producer_limit);
+    auto const test_count = queue.size() * 4;
+
+    auto second_thread = Threading::Thread::construct([&queue]() {
+        auto copied_queue = queue;
+        for (size_t i = 0; i < test_count; ++i) {
+            QueueError result = TestQueue::QueueStatus::Invalid;
+            do {
+                EXPECT(copied_queue.weak_used() <= producer_limit);
+                result = copied_queue.try_dequeue();
+                if (!result.is_error())
+                    EXPECT_EQ(result.value(), (int)i);
+            } while (result.is_error() && result.error() == TestQueue::QueueStatus::Empty);
+
+            if (result.is_error())
+                FAIL("Unexpected error while dequeueing.");
+        }
+        return 0;
+    });
+    second_thread->start();
+
+    for (size_t i = 0; i < test_count; ++i)
+        EXPECT(!queue.blocking_enqueue((int)i).is_error());
+
+    (void)second_thread->join();
+
+    EXPECT_EQ(queue.weak_used(), (size_t)0);
+}
+
 // There are multiple parallel consumers, but nobody is producing at the same time.
 TEST_CASE(multi_consumer)
 {
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <AK/Format.h>
+#include <AK/Function.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibCrypto/Authentication/Poly1305.h>
+#include <LibCrypto/Checksum/Adler32.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Cipher/ChaCha20.h>
+#include <LibCrypto/Hash/SHA1.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <time.h>
+
+// About as much as a few TLS records, so that per-message setup shows up but doesn't dominate.
+static constexpr size_t message_size = 64 * KiB;
+static constexpr size_t total_size = 64 * MiB;
+
+static u64 read_cycle_counter()
+{
+#if ARCH(X86_64)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Runs the operation on message_size bytes at a time until total_size bytes went through it, and prints the throughput.
+// On x86_64, the cycles per byte are printed as well. Note that these are in TSC ticks, which may not run at the same
+// frequency as the core.
+static void benchmark(StringView name, Function<void(ReadonlyBytes, Bytes)> operation)
+{
+    auto input = MUST(ByteBuffer::create_zeroed(message_size));
+    auto output = MUST(ByteBuffer::create_zeroed(message_size));
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    auto start_cycles = read_cycle_counter();
+    for (size_t processed = 0; processed < total_size; processed += message_size)
+        operation(input, output);
+    auto end_cycles = read_cycle_counter();
+    timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    auto elapsed = Time::from_timespec(end) - Time::from_timespec(start);
+    auto elapsed_seconds = max(elapsed.to_microseconds(), 1) / 1'000'000.0;
+    auto megabytes_per_second = total_size / elapsed_seconds / 1'000'000.0;
+    if (end_cycles != start_cycles)
+        outln("{}: {:.1} MB/s, {:.2} cycles/byte", name, megabytes_per_second, static_cast<double>(end_cycles - start_cycles) / total_size);
+    else
+        outln("{}: {:.1} MB/s", name, megabytes_per_second);
+}
+
+static u8 const key_bytes[32] {
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+    0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+};
+static u8 const iv_bytes[16] { 0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88 };
+
+static void benchmark_aes_cbc(size_t key_bits, StringView name)
+{
+    Crypto::Cipher::AESCipher::CBCMode cipher(ReadonlyBytes { key_bytes, key_bits / 8 }, key_bits, Crypto::Cipher::Intent::Encryption, Crypto::Cipher::PaddingMode::Null);
+    benchmark(name, [&](ReadonlyBytes in, Bytes out) {
+        cipher.encrypt(in, out, { iv_bytes, 16 });
+    });
+}
+
+static void benchmark_aes_ctr(size_t key_bits, StringView name)
+{
+    Crypto::Cipher::AESCipher::CTRMode cipher(ReadonlyBytes { key_bytes, key_bits / 8 }, key_bits, Crypto::Cipher::Intent::Encryption);
+    benchmark(name, [&](ReadonlyBytes in, Bytes out) {
+        cipher.encrypt(in, out, { iv_bytes, 16 });
+    });
+}
+
+static void benchmark_aes_gcm(size_t key_bits, StringView name)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher(ReadonlyBytes { key_bytes, key_bits / 8 }, key_bits, Crypto::Cipher::Intent::Encryption);
+    u8 aad[13] {};
+    u8 tag[16] {};
+    benchmark(name, [&](ReadonlyBytes in, Bytes out) {
+        cipher.encrypt(in, out, { iv_bytes, 16 }, { aad, sizeof(aad) }, { tag, sizeof(tag) });
+    });
+}
+
+BENCHMARK_CASE(aes_128_cbc_encrypt)
+{
+    benchmark_aes_cbc(128, "AES-128-CBC encrypt"sv);
+}
+
+BENCHMARK_CASE(aes_256_cbc_encrypt)
+{
+    benchmark_aes_cbc(256, "AES-256-CBC encrypt"sv);
+}
+
+BENCHMARK_CASE(aes_128_cbc_decrypt)
+{
+    Crypto::Cipher::AESCipher::CBCMode cipher(ReadonlyBytes { key_bytes, 16 }, 128, Crypto::Cipher::Intent::Decryption, Crypto::Cipher::PaddingMode::Null);
+    benchmark("AES-128-CBC decrypt"sv, [&](ReadonlyBytes in, Bytes out) {
+        cipher.decrypt(in, out, { iv_bytes, 16 });
+    });
+}
+
+BENCHMARK_CASE(aes_128_ctr)
+{
+    benchmark_aes_ctr(128, "AES-128-CTR"sv);
+}
+
+BENCHMARK_CASE(aes_256_ctr)
+{
+    benchmark_aes_ctr(256, "AES-256-CTR"sv);
+}
+
+BENCHMARK_CASE(aes_128_gcm_encrypt)
+{
+    benchmark_aes_gcm(128, "AES-128-GCM encrypt"sv);
+}
+
+BENCHMARK_CASE(aes_256_gcm_encrypt)
+{
+    benchmark_aes_gcm(256, "AES-256-GCM encrypt"sv);
+}
+
+BENCHMARK_CASE(aes_128_gcm_decrypt)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher(ReadonlyBytes { key_bytes, 16 }, 128, Crypto::Cipher::Intent::Encryption);
+    u8 aad[13] {};
+    u8 tag[16] {};
+    benchmark("AES-128-GCM decrypt"sv, [&](ReadonlyBytes in, Bytes out) {
+        // The tag doesn't match, but all of the work is done regardless.
+        (void)cipher.decrypt(in, out, { iv_bytes, 16 }, { aad, sizeof(aad) }, { tag, sizeof(tag) });
+    });
+}
+
+BENCHMARK_CASE(chacha20)
+{
+    benchmark("ChaCha20"sv, [&](ReadonlyBytes in, Bytes out) {
+        Crypto::Cipher::ChaCha20 cipher(ReadonlyBytes { key_bytes, 32 }, ReadonlyBytes { iv_bytes, 12 });
+        cipher.encrypt(in, out);
+    });
+}
+
+BENCHMARK_CASE(poly1305)
+{
+    benchmark("Poly1305"sv, [&](ReadonlyBytes in, Bytes) {
+        Crypto::Authentication::Poly1305 mac(ReadonlyBytes { key_bytes, 32 });
+        mac.update(in);
+        (void)MUST(mac.digest());
+    });
+}
+
+BENCHMARK_CASE(crc32)
+{
+    benchmark("CRC32"sv, [&](ReadonlyBytes in, Bytes) {
+        (void)Crypto::Checksum::CRC32(in).digest();
+    });
+}
+
+BENCHMARK_CASE(adler32)
+{
+    benchmark("Adler32"sv, [&](ReadonlyBytes in, Bytes) {
+        (void)Crypto::Checksum::Adler32(in).digest();
+    });
+}
+
+BENCHMARK_CASE(crc32_copy_and_update)
+{
+    benchmark("CRC32 while copying"sv, [&](ReadonlyBytes in, Bytes out) {
+        Crypto::Checksum::CRC32 crc32;
+        crc32.copy_and_update(in, out);
+        (void)crc32.digest();
+    });
+}
+
+BENCHMARK_CASE(sha1)
+{
+    benchmark("SHA1"sv, [&](ReadonlyBytes in, Bytes) {
+        (void)Crypto::Hash::SHA1::hash(in.data(), in.size());
+    });
+}
+
+BENCHMARK_CASE(sha256)
+{
+    benchmark("SHA256"sv, [&](ReadonlyBytes in, Bytes) {
+        (void)Crypto::Hash::SHA256::hash(in.data(), in.size());
+    });
+}
+
+BENCHMARK_CASE(sha512)
+{
+    benchmark("SHA512"sv, [&](ReadonlyBytes in, Bytes) {
+        (void)Crypto::Hash::SHA512::hash(in.data(), in.size());
+    });
+}
+
+BENCHMARK_CASE(sha256_many_short_messages)
+{
+    // Roughly what every iteration of PBKDF2 with HMAC-SHA256 hashes.
+    static constexpr size_t short_message_size = 96;
+    Vector<ReadonlyBytes> messages;
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    benchmark("SHA256 many short messages"sv, [&](ReadonlyBytes in, Bytes) {
+        if (messages.is_empty()) {
+            for (size_t offset = 0; offset + short_message_size <= in.size(); offset += short_message_size)
+                messages.append(in.slice(offset, short_message_size));
+            digests.resize(messages.size());
+        }
+        Crypto::Hash::SHA256::hash_many(messages, digests);
+    });
+}
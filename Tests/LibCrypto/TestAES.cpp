@@ -401,6 +401,58 @@ TEST_CASE(test_AES_GCM_128bit_encrypt_with_aad)
     EXPECT(memcmp(result_tag, tag.data(), tag.size()) == 0);
 }
 
+TEST_CASE(test_AES_GCM_128bit_encrypt_and_decrypt_long_message_with_aad)
+{
+    // Long enough for the blocks to be encrypted and authenticated several at a time, plus a partial block at the end.
+    u8 key[16];
+    u8 iv[16] {};
+    u8 aad[20];
+    u8 plaintext[300];
+    for (size_t i = 0; i < sizeof(key); ++i)
+        key[i] = i;
+    for (size_t i = 0; i < 12; ++i)
+        iv[i] = 0xa0 + i;
+    for (size_t i = 0; i < sizeof(aad); ++i)
+        aad[i] = 0x30 + i;
+    for (size_t i = 0; i < sizeof(plaintext); ++i)
+        plaintext[i] = i * 7;
+
+    u8 result_tag[] { 0xa5, 0xb1, 0xa6, 0x13, 0xb2, 0x24, 0xa9, 0xad, 0xbf, 0xd8, 0xbe, 0x53, 0xd6, 0x40, 0x0e, 0x77 };
+    u8 result_ct[] {
+        0xaa, 0x81, 0x36, 0xae, 0x62, 0xaa, 0x19, 0x3b, 0xb2, 0x47, 0xf3, 0x4d, 0x12, 0x49, 0xd2, 0x09,
+        0x23, 0x99, 0x5d, 0x8d, 0x0f, 0x84, 0xa7, 0x0e, 0x8d, 0xbf, 0xc7, 0x26, 0x86, 0x46, 0x5d, 0x71,
+        0x7a, 0x44, 0xab, 0xc4, 0xf3, 0xe9, 0xe6, 0x7c, 0x67, 0xc1, 0xc4, 0xe9, 0x9b, 0xe0, 0x4b, 0x99,
+        0xec, 0x03, 0x12, 0x2c, 0x5f, 0xf2, 0xec, 0x6c, 0x0a, 0xb9, 0x18, 0x57, 0x41, 0xce, 0xb6, 0xc4,
+        0x31, 0xf6, 0x7d, 0x07, 0xb7, 0x95, 0x7b, 0x33, 0x28, 0xec, 0x89, 0xbf, 0x4d, 0x32, 0x67, 0xa9,
+        0x7c, 0x8e, 0x64, 0x6b, 0x33, 0xb2, 0xd1, 0xc0, 0x79, 0x74, 0x5f, 0x45, 0x2e, 0xf3, 0x9e, 0xd9,
+        0xa6, 0x4c, 0xd0, 0xa9, 0x8d, 0xa0, 0x14, 0x6d, 0xda, 0xbe, 0x56, 0x98, 0xa1, 0x1a, 0x99, 0xa6,
+        0x21, 0x8f, 0x4a, 0xaf, 0x04, 0x42, 0x57, 0x94, 0x9b, 0xc9, 0x58, 0xf4, 0xa8, 0x77, 0xbf, 0x09,
+        0x02, 0x66, 0x2d, 0x6d, 0xe8, 0xc4, 0x7e, 0x93, 0x14, 0x0b, 0x75, 0x5a, 0x4c, 0xf6, 0x49, 0xac,
+        0x6e, 0x98, 0x6e, 0xb5, 0x73, 0xbc, 0x41, 0x98, 0xc9, 0x24, 0x51, 0xe5, 0x3f, 0xe3, 0x71, 0xfd,
+        0xb5, 0x89, 0xbe, 0xa3, 0xca, 0xe0, 0x92, 0xe5, 0x19, 0x90, 0x19, 0xe4, 0xe7, 0xb2, 0x97, 0xc9,
+        0x30, 0x93, 0xb0, 0x5b, 0x83, 0x71, 0xa4, 0x4d, 0x8a, 0x3e, 0xf3, 0x91, 0xf4, 0x51, 0xfa, 0x8f,
+        0x3a, 0x39, 0x4f, 0xdf, 0x12, 0x72, 0x6a, 0x79, 0xe2, 0x32, 0xac, 0xfa, 0xbe, 0x17, 0x76, 0x6c,
+        0x46, 0x98, 0x54, 0x34, 0xe7, 0xe7, 0xcb, 0xec, 0xac, 0x54, 0xa9, 0x73, 0xab, 0xa0, 0x5d, 0x0d,
+        0x38, 0x18, 0x49, 0x78, 0xe2, 0x3c, 0xaa, 0x69, 0xa7, 0x5a, 0x73, 0x45, 0x07, 0x1f, 0xd8, 0x4b,
+        0x62, 0x37, 0x8c, 0x90, 0xc3, 0x1e, 0xfc, 0xfb, 0xdc, 0xf2, 0x4d, 0xe0, 0x93, 0xdd, 0x24, 0x2c,
+        0x74, 0x43, 0x76, 0x5d, 0xac, 0xc7, 0xed, 0x5b, 0x62, 0x67, 0x59, 0x0d, 0x90, 0x9c, 0x73, 0x5b,
+        0xa7, 0x1a, 0x2a, 0x50, 0xfd, 0x57, 0x08, 0x94, 0xe7, 0x63, 0x39, 0xda, 0xc5, 0x3f, 0xcc, 0x8c,
+        0x0a, 0x8e, 0x8e, 0xe1, 0x25, 0xaa, 0xe4, 0x3e, 0x60, 0xbd, 0x38, 0x6d
+    };
+
+    Crypto::Cipher::AESCipher::GCMMode cipher(ReadonlyBytes { key, sizeof(key) }, 128, Crypto::Cipher::Intent::Encryption);
+    auto tag = ByteBuffer::create_uninitialized(16).release_value();
+    auto out = ByteBuffer::create_uninitialized(sizeof(plaintext)).release_value();
+    cipher.encrypt({ plaintext, sizeof(plaintext) }, out.bytes(), { iv, sizeof(iv) }, { aad, sizeof(aad) }, tag);
+    EXPECT(memcmp(result_ct, out.data(), out.size()) == 0);
+    EXPECT(memcmp(result_tag, tag.data(), tag.size()) == 0);
+
+    auto decrypted = ByteBuffer::create_uninitialized(sizeof(plaintext)).release_value();
+    auto consistency = cipher.decrypt(out, decrypted.bytes(), { iv, sizeof(iv) }, { aad, sizeof(aad) }, tag);
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
+    EXPECT(memcmp(plaintext, decrypted.data(), decrypted.size()) == 0);
+}
+
 TEST_CASE(test_AES_GCM_128bit_decrypt_empty)
 {
     Crypto::Cipher::AESCipher::GCMMode cipher("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"_b, 128, Crypto::Cipher::Intent::Encryption);
@@ -201,6 +201,22 @@ TEST_CASE(test_unsigned_bigint_multiplication_with_big_numbers2)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_unsigned_bigint_karatsuba_multiplication)
+{
+    // These are well over the size where multiplication switches to Karatsuba, and F(2n) = F(n) * (F(n + 1) + F(n - 1)).
+    auto num1 = bigint_fibonacci(3000);
+    auto num2 = bigint_fibonacci(3001).plus(bigint_fibonacci(2999));
+    EXPECT_EQ(num1.multiplied_by(num2), bigint_fibonacci(6000));
+    EXPECT_EQ(num2.multiplied_by(num1), bigint_fibonacci(6000));
+
+    // One number is a lot longer than the other.
+    auto num3 = bigint_fibonacci(9000);
+    auto product = num3.multiplied_by(num1);
+    auto division_result = product.divided_by(num1);
+    EXPECT_EQ(division_result.quotient, num3);
+    EXPECT(division_result.remainder.is_zero());
+}
+
 TEST_CASE(test_unsigned_bigint_simple_division)
 {
     Crypto::UnsignedBigInteger num1(27194);
@@ -304,6 +320,21 @@ TEST_CASE(test_bigint_large_odd_fibonacci_with_carry_modular_power)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_bigint_rsa_sized_modular_power)
+{
+    auto base = Crypto::UnsignedBigInteger::from_base(16, "3f5a9bbd9d8affceb78f36a4b8a6b6996e6d5a55d93a93353f32ebd973575d1a73c81d21312015a32b73fc6072fcc7ffb7fbeba7b2211868460d5b41c624c8f5e60f4eec9881e189375e666ef2441f5eafc189015e50f7b8a372cddf49cee9ca7d5d477cbdd4486069657fac012ad61cc8ebb1606f65507bef0bb353935a1662"sv);
+    auto modulo = Crypto::UnsignedBigInteger::from_base(16, "ae2aa17d6efba0f4fdb48b3f8d95605b7f8b43706c1fb2918ec411835a28ede26a6566f306813a3cdaaf12a5c7a20213695e57a1414e647505a866cd1c42d0fe736d479633c57cdf80212c2684950c16677de7c67cbb5a6d12d9b29d96345e044c3396cf760198b72ee2002f906bfdc17aeff54e808c46a61f492fba47a1fca7"sv);
+
+    // As with the private key, which uses the biggest windows.
+    auto exponent = Crypto::UnsignedBigInteger::from_base(16, "cdc922f0dba670fa598007ba3de789868f7fb9a1b569a803d0b727e37cb2331fe51a3914c40cdc95c4ad705476567a56706c7724247ec6198e75f0c321c4c2bc30eb84d2f8d282d6a6d761f114f8b2f8adf634b6c8cedf09152e4cfd1593411d6e0a309a9d087986e81ec8622b8a29f081332e623ca58fe7daaa2a0dc31ffcfc"sv);
+    auto expected = Crypto::UnsignedBigInteger::from_base(16, "6f6a8ca470222df85661f981f7ad9a26ee91779e9e3cd44ef901e41a19b74f8414cb787b07c3e45cc073665d38407f5f5debcb6db2a4ba5613cc2a654d021dc8ab51ebd4892ed9fd62e24e594a44fe504887410fe85907f979d1d006743ccd72d632e8efdb1f81d0fd7ffed110651f980d155a418dd32b4a7785a487f0002417"sv);
+    EXPECT_EQ(Crypto::NumberTheory::ModularPower(base, exponent, modulo), expected);
+
+    // As with the public key.
+    auto expected_with_public_exponent = Crypto::UnsignedBigInteger::from_base(16, "5a170057c421b5e0986c0e57299e8c8c82f3703897de9911463b5ea297320e9aea15f487c41bfd1921fd6b11a95790ba810aa936c291561fa90d546d7921860f02acf76a525b2de7c2d2b1a9519c0d85d5f39f146131e3d57d35c263485cb9aa875955e7b377b2b6fea41a6a2b31e02447a7260bc886d757da3c95c2f4cc8042"sv);
+    EXPECT_EQ(Crypto::NumberTheory::ModularPower(base, 65537, modulo), expected_with_public_exponent);
+}
+
 TEST_CASE(test_bigint_modular_power_extra_tests)
 {
     struct {
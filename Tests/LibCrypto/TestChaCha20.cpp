@@ -6,6 +6,7 @@
 
 #include <AK/ByteBuffer.h>
 #include <LibCrypto/Cipher/ChaCha20.h>
+#include <LibCrypto/Cipher/ChaCha20Poly1305.h>
 #include <LibTest/TestCase.h>
 
 // https://datatracker.ietf.org/doc/html/rfc7539#appendix-A.2
@@ -139,3 +140,72 @@ TEST_CASE(test_vector_3)
     auto expected = ReadonlyBytes { ciphertext, 127 };
     EXPECT_EQ(result, expected);
 }
+
+TEST_CASE(test_batches_match_single_blocks)
+{
+    u8 key[32] {};
+    u8 nonce[12] {};
+    for (size_t i = 0; i < sizeof(key); ++i)
+        key[i] = i;
+
+    // Enough data for a few batches of blocks as well as a partial block at the end.
+    auto plaintext = MUST(ByteBuffer::create_zeroed(1000));
+    for (size_t i = 0; i < plaintext.size(); ++i)
+        plaintext[i] = i * 7;
+
+    auto batched = MUST(ByteBuffer::create_uninitialized(plaintext.size()));
+    auto batched_bytes = batched.bytes();
+    Crypto::Cipher::ChaCha20 batched_cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 }, 1);
+    batched_cipher.encrypt(plaintext, batched_bytes);
+
+    // Every call starts with a fresh block, so encrypting 64 bytes at a time only ever uses one block per call.
+    auto one_by_one = MUST(ByteBuffer::create_uninitialized(plaintext.size()));
+    Crypto::Cipher::ChaCha20 one_by_one_cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 }, 1);
+    for (size_t offset = 0; offset < plaintext.size(); offset += 64) {
+        auto size = min<size_t>(64, plaintext.size() - offset);
+        auto output = one_by_one.bytes().slice(offset, size);
+        one_by_one_cipher.encrypt(plaintext.bytes().slice(offset, size), output);
+    }
+
+    EXPECT_EQ(batched, one_by_one);
+}
+
+// https://datatracker.ietf.org/doc/html/rfc8439#section-2.8.2
+TEST_CASE(test_aead_vector)
+{
+    u8 key[32];
+    for (size_t i = 0; i < sizeof(key); ++i)
+        key[i] = 0x80 + i;
+    u8 nonce[12] { 0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47 };
+    u8 aad[12] { 0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7 };
+    auto plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it."sv.bytes();
+    u8 ciphertext[114] {
+        0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+        0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+        0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+        0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+        0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+        0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+        0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+        0x61, 0x16
+    };
+    u8 tag[16] {
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+    };
+
+    Crypto::Cipher::ChaCha20Poly1305 aead(ReadonlyBytes { key, 32 });
+    auto result = MUST(ByteBuffer::create_uninitialized(plaintext.size()));
+    u8 computed_tag[16];
+    aead.encrypt(plaintext, result, ReadonlyBytes { nonce, 12 }, ReadonlyBytes { aad, 12 }, Bytes { computed_tag, 16 });
+    EXPECT_EQ(result, (ReadonlyBytes { ciphertext, 114 }));
+    EXPECT_EQ((ReadonlyBytes { computed_tag, 16 }), (ReadonlyBytes { tag, 16 }));
+
+    auto decrypted = MUST(ByteBuffer::create_uninitialized(plaintext.size()));
+    auto consistency = aead.decrypt(ReadonlyBytes { ciphertext, 114 }, decrypted, ReadonlyBytes { nonce, 12 }, ReadonlyBytes { aad, 12 }, ReadonlyBytes { tag, 16 });
+    EXPECT(consistency == Crypto::VerificationConsistency::Consistent);
+    EXPECT_EQ(decrypted.bytes(), plaintext);
+
+    tag[0] ^= 1;
+    consistency = aead.decrypt(ReadonlyBytes { ciphertext, 114 }, decrypted, ReadonlyBytes { nonce, 12 }, ReadonlyBytes { aad, 12 }, ReadonlyBytes { tag, 16 });
+    EXPECT(consistency == Crypto::VerificationConsistency::Inconsistent);
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteBuffer.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibTest/TestCase.h>
@@ -33,3 +34,76 @@ TEST_CASE(test_crc32)
     do_test(String("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(String("various CRC algorithms input data").bytes(), 0x9BD366AE);
 }
+
+TEST_CASE(test_crc32_combine)
+{
+    auto input = "The quick brown fox jumps over the lazy dog"sv.bytes();
+    auto whole = Crypto::Checksum::CRC32(input).digest();
+
+    for (size_t split = 0; split <= input.size(); ++split) {
+        auto first = Crypto::Checksum::CRC32(input.slice(0, split)).digest();
+        auto second = Crypto::Checksum::CRC32(input.slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, second, input.size() - split), whole);
+    }
+}
+
+static ByteBuffer pseudo_random_bytes(size_t size)
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(size));
+    u32 state = 0x12345678;
+    for (auto& byte : buffer.bytes()) {
+        state = state * 1103515245 + 12345;
+        byte = state >> 24;
+    }
+    return buffer;
+}
+
+TEST_CASE(test_crc32_long_inputs)
+{
+    // Long inputs take the slicing and folding paths, which have to agree with going one byte at a time.
+    auto input = pseudo_random_bytes(4099);
+    for (size_t size : { 7u, 8u, 63u, 64u, 65u, 127u, 128u, 200u, 1024u, 4099u }) {
+        auto bytes = input.bytes().trim(size);
+        Crypto::Checksum::CRC32 byte_by_byte;
+        for (size_t i = 0; i < bytes.size(); ++i)
+            byte_by_byte.update(bytes.slice(i, 1));
+        EXPECT_EQ(Crypto::Checksum::CRC32(bytes).digest(), byte_by_byte.digest());
+    }
+
+    auto zeros = MUST(ByteBuffer::create_zeroed(1 * MiB));
+    EXPECT_EQ(Crypto::Checksum::CRC32(zeros).digest(), 0xA738EA1Cu);
+}
+
+TEST_CASE(test_adler32_long_inputs)
+{
+    // Long enough for the sums to be reduced several times in the middle.
+    auto input = pseudo_random_bytes(20000);
+    for (size_t size : { 15u, 16u, 17u, 5552u, 5553u, 20000u }) {
+        auto bytes = input.bytes().trim(size);
+        Crypto::Checksum::Adler32 byte_by_byte;
+        for (size_t i = 0; i < bytes.size(); ++i)
+            byte_by_byte.update(bytes.slice(i, 1));
+        EXPECT_EQ(Crypto::Checksum::Adler32(bytes).digest(), byte_by_byte.digest());
+    }
+
+    auto ones = MUST(ByteBuffer::create_uninitialized(1 * MiB));
+    ones.bytes().fill(0xFF);
+    EXPECT_EQ(Crypto::Checksum::Adler32(ones).digest(), 0x8E88EF11u);
+}
+
+TEST_CASE(test_checksum_copy_and_update)
+{
+    auto input = pseudo_random_bytes(10000);
+    auto output = MUST(ByteBuffer::create_zeroed(input.size()));
+
+    Crypto::Checksum::CRC32 crc32;
+    crc32.copy_and_update(input, output);
+    EXPECT_EQ(output, input);
+    EXPECT_EQ(crc32.digest(), Crypto::Checksum::CRC32(input).digest());
+
+    output.bytes().fill(0);
+    Crypto::Checksum::Adler32 adler32;
+    adler32.copy_and_update(input, output);
+    EXPECT_EQ(output, input);
+    EXPECT_EQ(adler32.digest(), Crypto::Checksum::Adler32(input).digest());
+}
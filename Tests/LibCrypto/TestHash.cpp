@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Vector.h>
 #include <LibCrypto/Authentication/GHash.h>
 #include <LibCrypto/Authentication/HMAC.h>
 #include <LibCrypto/Hash/MD5.h>
@@ -142,6 +143,22 @@ TEST_CASE(test_SHA1_hash_successive_updates)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA1_hash_uneven_updates)
+{
+    u8 result[] {
+        0x29, 0x1e, 0x9a, 0x6c, 0x66, 0x99, 0x49, 0x49, 0xb5, 0x7b, 0xa5, 0xe6, 0x50, 0x36, 0x1e, 0x98, 0xfc, 0x36, 0xb1, 0xba
+    };
+    auto message = ByteBuffer::create_uninitialized(1000).release_value();
+    message.bytes().fill('a');
+
+    // Updates that start in the middle of a block, span several blocks and end in the middle of another one.
+    auto hasher = Crypto::Hash::SHA1 {};
+    for (size_t offset = 0, size = 1; offset < message.size(); offset += size, size = size * 3 % 200 + 1)
+        hasher.update(message.bytes().slice(offset, min(size, message.size() - offset)));
+    auto digest = hasher.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+}
+
 TEST_CASE(test_SHA256_name)
 {
     Crypto::Hash::SHA256 sha;
@@ -166,6 +183,57 @@ TEST_CASE(test_SHA256_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_uneven_updates)
+{
+    u8 result[] {
+        0x41, 0xed, 0xec, 0xe4, 0x2d, 0x63, 0xe8, 0xd9, 0xbf, 0x51, 0x5a, 0x9b, 0xa6, 0x93, 0x2e, 0x1c, 0x20, 0xcb, 0xc9, 0xf5, 0xa5, 0xd1, 0x34, 0x64, 0x5a, 0xdb, 0x5d, 0xb1, 0xb9, 0x73, 0x7e, 0xa3
+    };
+    auto message = ByteBuffer::create_uninitialized(1000).release_value();
+    message.bytes().fill('a');
+
+    // Updates that start in the middle of a block, span several blocks and end in the middle of another one.
+    auto hasher = Crypto::Hash::SHA256 {};
+    for (size_t offset = 0, size = 1; offset < message.size(); offset += size, size = size * 3 % 200 + 1)
+        hasher.update(message.bytes().slice(offset, min(size, message.size() - offset)));
+    auto digest = hasher.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_peek_keeps_going)
+{
+    // Peeking in between has to leave the hash as if nothing happened, TLS 1.3 does that with its transcript.
+    auto hasher = Crypto::Hash::SHA256 {};
+    hasher.update("Well hello "sv);
+    auto partial = hasher.peek();
+    EXPECT(memcmp(partial.data, Crypto::Hash::SHA256::hash("Well hello "sv).data, Crypto::Hash::SHA256::digest_size()) == 0);
+    EXPECT(memcmp(hasher.peek().data, partial.data, Crypto::Hash::SHA256::digest_size()) == 0);
+
+    hasher.update("friends"sv);
+    auto digest = hasher.digest();
+    EXPECT(memcmp(digest.data, Crypto::Hash::SHA256::hash("Well hello friends"sv).data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_many)
+{
+    auto data = ByteBuffer::create_uninitialized(1000).release_value();
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i * 7;
+
+    // More messages than there are lanes, with sizes around the block boundaries so that they don't finish together.
+    Vector<ReadonlyBytes> messages;
+    for (size_t size : { 0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 500, 1000, 3 })
+        messages.append(data.bytes().trim(size));
+
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto expected = Crypto::Hash::SHA256::hash(messages[i].data(), messages[i].size());
+        EXPECT(memcmp(expected.data, digests[i].data, Crypto::Hash::SHA256::digest_size()) == 0);
+    }
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
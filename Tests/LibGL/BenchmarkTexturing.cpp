@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibGL/GL/gl.h>
+#include <LibGL/GLContext.h>
+#include <LibGfx/Bitmap.h>
+#include <LibTest/TestCase.h>
+
+static NonnullOwnPtr<GL::GLContext> create_benchmark_context(int width, int height)
+{
+    auto bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { width, height }));
+    auto context = MUST(GL::create_context(*bitmap));
+    GL::make_context_current(context);
+    return context;
+}
+
+static void upload_checkerboard_texture(int texture_size)
+{
+    Vector<u32> texels;
+    texels.resize(texture_size * texture_size);
+    for (int y = 0; y < texture_size; ++y) {
+        for (int x = 0; x < texture_size; ++x)
+            texels[y * texture_size + x] = ((x / 8 + y / 8) % 2) ? 0xff2080e0 : 0xffe0a020;
+    }
+
+    GLuint texture_id;
+    glGenTextures(1, &texture_id);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture_size, texture_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+}
+
+// Draws a quad that is rotated and seen at a steep angle, so that texels are fetched across rows as well as columns.
+static void draw_rotated_textured_quads(int run_count)
+{
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glFrustum(-1, 1, -1, 1, 1, 10);
+    glMatrixMode(GL_MODELVIEW);
+
+    glEnable(GL_TEXTURE_2D);
+    for (int run = 0; run < run_count; ++run) {
+        glLoadIdentity();
+        glTranslatef(0, 0, -2);
+        glRotatef(-60, 1, 0, 0);
+        glRotatef(run * 7.f, 0, 0, 1);
+
+        glBegin(GL_QUADS);
+        glTexCoord2f(0, 0);
+        glVertex2f(-2, -2);
+        glTexCoord2f(8, 0);
+        glVertex2f(2, -2);
+        glTexCoord2f(8, 8);
+        glVertex2f(2, 2);
+        glTexCoord2f(0, 8);
+        glVertex2f(-2, 2);
+        glEnd();
+    }
+    EXPECT_EQ(glGetError(), 0u);
+}
+
+BENCHMARK_CASE(bilinear_sampling)
+{
+    auto context = create_benchmark_context(256, 256);
+    upload_checkerboard_texture(512);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    draw_rotated_textured_quads(100);
+}
+
+BENCHMARK_CASE(trilinear_sampling)
+{
+    auto context = create_benchmark_context(256, 256);
+    upload_checkerboard_texture(512);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    draw_rotated_textured_quads(100);
+}
@@ -6,6 +6,7 @@
  */
 
 #include <LibGfx/Font/BitmapFont.h>
+#include <LibGfx/Font/FontCatalog.h>
 #include <LibGfx/Font/FontDatabase.h>
 #include <LibTest/TestCase.h>
 #include <stdio.h>
@@ -152,3 +153,36 @@ TEST_CASE(test_character_set_masking)
     EXPECT(!masked_font.value()->glyph_index(0x0100).has_value());
     EXPECT(masked_font.value()->glyph_index(0xFFFD).value() == 0x1FD);
 }
+
+TEST_CASE(test_font_catalog)
+{
+    char root[] = "/tmp/fonts.XXXXXX";
+    EXPECT(mkdtemp(root) != nullptr);
+    String root_path { root };
+    auto font_path = String::formatted("{}/CatalogTest.font", root_path);
+
+    auto font = Gfx::BitmapFont::create(10, 8, true, 256);
+    font->set_family("Catalog Test"sv);
+    font->set_presentation_size(10);
+    font->set_weight(700);
+    EXPECT(!font->write_to_file(font_path).is_error());
+
+    auto scanned_catalog = Gfx::FontCatalog::create_by_scanning(root_path);
+    EXPECT(!scanned_catalog.is_error());
+    EXPECT(!scanned_catalog.value().write_to_file().is_error());
+
+    auto catalog = Gfx::FontCatalog::load_from_file(root_path, Gfx::FontCatalog::Validation::DirectoriesAndFiles);
+    EXPECT(!catalog.is_error());
+    EXPECT_EQ(catalog.value().fonts().size(), 1u);
+    auto const& entry = catalog.value().fonts().first();
+    EXPECT(entry.kind == Gfx::FontCatalog::Entry::Kind::Bitmap);
+    EXPECT_EQ(entry.path, font_path);
+    EXPECT_EQ(entry.family, "Catalog Test"sv);
+    EXPECT_EQ(entry.presentation_size, 10);
+    EXPECT_EQ(entry.weight, 700);
+    EXPECT(entry.is_fixed_width);
+
+    unlink(Gfx::FontCatalog::path_for_directory(root_path).characters());
+    unlink(font_path.characters());
+    rmdir(root_path.characters());
+}
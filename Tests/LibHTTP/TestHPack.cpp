@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibHTTP/HPack.h>
+#include <LibTest/TestCase.h>
+
+using HTTP::HPack::Header;
+
+static u8 parse_hex_digit(char c)
+{
+    return c <= '9' ? c - '0' : c - 'a' + 10;
+}
+
+static ByteBuffer hex(StringView string)
+{
+    ByteBuffer buffer;
+    for (size_t i = 0; i + 1 < string.length(); i += 2)
+        buffer.append(static_cast<u8>(parse_hex_digit(string[i]) << 4 | parse_hex_digit(string[i + 1])));
+    return buffer;
+}
+
+static void expect_headers(Vector<Header> const& actual, Vector<Header> const& expected)
+{
+    EXPECT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < min(actual.size(), expected.size()); ++i) {
+        EXPECT_EQ(actual[i].name, expected[i].name);
+        EXPECT_EQ(actual[i].value, expected[i].value);
+    }
+}
+
+TEST_CASE(test_integer_representation)
+{
+    // https://www.rfc-editor.org/rfc/rfc7541#appendix-C.1
+    ByteBuffer buffer;
+    MUST(HTTP::HPack::encode_integer(buffer, 0, 5, 10));
+    EXPECT_EQ(buffer, hex("0a"sv));
+
+    buffer.clear();
+    MUST(HTTP::HPack::encode_integer(buffer, 0, 5, 1337));
+    EXPECT_EQ(buffer, hex("1f9a0a"sv));
+
+    buffer.clear();
+    MUST(HTTP::HPack::encode_integer(buffer, 0, 8, 42));
+    EXPECT_EQ(buffer, hex("2a"sv));
+
+    auto encoded = hex("1f9a0a"sv);
+    ReadonlyBytes input = encoded.bytes();
+    EXPECT_EQ(MUST(HTTP::HPack::decode_integer(input, 5)), 1337u);
+    EXPECT(input.is_empty());
+
+    auto overlong = hex("1fffffffffffffffff7f"sv);
+    input = overlong.bytes();
+    EXPECT(HTTP::HPack::decode_integer(input, 5).is_error());
+
+    auto cut_off = hex("1f9a"sv);
+    input = cut_off.bytes();
+    EXPECT(HTTP::HPack::decode_integer(input, 5).is_error());
+}
+
+TEST_CASE(test_huffman_round_trip)
+{
+    // https://www.rfc-editor.org/rfc/rfc7541#appendix-C.4.1
+    ByteBuffer encoded;
+    MUST(HTTP::HPack::huffman_encode(encoded, "www.example.com"sv.bytes()));
+    EXPECT_EQ(encoded, hex("f1e3c2e5f23a6ba0ab90f4ff"sv));
+    EXPECT_EQ(HTTP::HPack::huffman_encoded_length("www.example.com"sv.bytes()), 12u);
+    EXPECT_EQ(MUST(HTTP::HPack::huffman_decode(encoded)), "www.example.com"sv.bytes());
+
+    ByteBuffer all_bytes;
+    for (size_t i = 0; i < 256; ++i)
+        all_bytes.append(static_cast<u8>(i));
+    encoded.clear();
+    MUST(HTTP::HPack::huffman_encode(encoded, all_bytes));
+    EXPECT_EQ(MUST(HTTP::HPack::huffman_decode(encoded)), all_bytes);
+}
+
+TEST_CASE(test_huffman_invalid_padding)
+{
+    // "no-cache" followed by a whole byte of padding.
+    EXPECT(HTTP::HPack::huffman_decode(hex("a8eb10649cbfff"sv)).is_error());
+    // Padding that isn't made of ones.
+    EXPECT(HTTP::HPack::huffman_decode(hex("a8eb10649cbe"sv)).is_error());
+    EXPECT(!HTTP::HPack::huffman_decode(hex("a8eb10649cbf"sv)).is_error());
+}
+
+static Vector<Header> const first_request { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" } };
+static Vector<Header> const second_request { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" }, { "cache-control", "no-cache" } };
+static Vector<Header> const third_request { { ":method", "GET" }, { ":scheme", "https" }, { ":path", "/index.html" }, { ":authority", "www.example.com" }, { "custom-key", "custom-value" } };
+
+TEST_CASE(test_decode_requests_without_huffman)
+{
+    // https://www.rfc-editor.org/rfc/rfc7541#appendix-C.3
+    HTTP::HPack::Decoder decoder;
+    expect_headers(MUST(decoder.decode(hex("828684410f7777772e6578616d706c652e636f6d"sv))), first_request);
+    EXPECT_EQ(decoder.table().size(), 57u);
+
+    expect_headers(MUST(decoder.decode(hex("828684be58086e6f2d6361636865"sv))), second_request);
+    EXPECT_EQ(decoder.table().size(), 110u);
+
+    expect_headers(MUST(decoder.decode(hex("828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565"sv))), third_request);
+    EXPECT_EQ(decoder.table().size(), 164u);
+    EXPECT_EQ(decoder.table().at(0).name, "custom-key"sv);
+}
+
+TEST_CASE(test_encode_requests_with_huffman)
+{
+    // https://www.rfc-editor.org/rfc/rfc7541#appendix-C.4
+    HTTP::HPack::Encoder encoder;
+    HTTP::HPack::Decoder decoder;
+
+    auto block = MUST(encoder.encode(first_request));
+    EXPECT_EQ(block, hex("828684418cf1e3c2e5f23a6ba0ab90f4ff"sv));
+    expect_headers(MUST(decoder.decode(block)), first_request);
+
+    block = MUST(encoder.encode(second_request));
+    EXPECT_EQ(block, hex("828684be5886a8eb10649cbf"sv));
+    expect_headers(MUST(decoder.decode(block)), second_request);
+
+    block = MUST(encoder.encode(third_request));
+    EXPECT_EQ(block, hex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"sv));
+    expect_headers(MUST(decoder.decode(block)), third_request);
+    EXPECT_EQ(encoder.table().size(), 164u);
+    EXPECT_EQ(decoder.table().size(), 164u);
+}
+
+TEST_CASE(test_decode_responses_with_eviction)
+{
+    // https://www.rfc-editor.org/rfc/rfc7541#appendix-C.6
+    HTTP::HPack::Decoder decoder { 256 };
+    expect_headers(MUST(decoder.decode(hex("488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff6e919d29ad171863c78f0b97c8e9ae82ae43d3"sv))),
+        { { ":status", "302" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:21 GMT" }, { "location", "https://www.example.com" } });
+    EXPECT_EQ(decoder.table().size(), 222u);
+
+    expect_headers(MUST(decoder.decode(hex("4883640effc1c0bf"sv))),
+        { { ":status", "307" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:21 GMT" }, { "location", "https://www.example.com" } });
+    EXPECT_EQ(decoder.table().size(), 222u);
+    EXPECT_EQ(decoder.table().entry_count(), 4u);
+
+    expect_headers(MUST(decoder.decode(hex("88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7821dd7f2e6c7b335dfdfcd5b3960d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5b1063d5007"sv))),
+        { { ":status", "200" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:22 GMT" }, { "location", "https://www.example.com" }, { "content-encoding", "gzip" }, { "set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1" } });
+    EXPECT_EQ(decoder.table().size(), 215u);
+    EXPECT_EQ(decoder.table().entry_count(), 3u);
+}
+
+TEST_CASE(test_decode_errors)
+{
+    HTTP::HPack::Decoder decoder;
+    // Index 0 doesn't exist.
+    EXPECT(decoder.decode(hex("80"sv)).is_error());
+    // Nothing has been put into the dynamic table yet.
+    EXPECT(decoder.decode(hex("be"sv)).is_error());
+    // The string claims to be longer than the block.
+    EXPECT(decoder.decode(hex("400a6375"sv)).is_error());
+    // A name that decodes, followed by a value that doesn't, with and without indexing.
+    EXPECT(decoder.decode(hex("400361626308646566"sv)).is_error());
+    EXPECT(decoder.decode(hex("000361626308646566"sv)).is_error());
+    EXPECT(decoder.decode(hex("4108646566"sv)).is_error());
+    // Larger than the size we allow.
+    EXPECT(decoder.decode(hex("3fe21f"sv)).is_error());
+    // A size update has to come first.
+    EXPECT(decoder.decode(hex("823f00"sv)).is_error());
+}
+
+TEST_CASE(test_encoder_table_size_updates)
+{
+    HTTP::HPack::Encoder encoder;
+    HTTP::HPack::Decoder decoder;
+    MUST(decoder.decode(MUST(encoder.encode(third_request))));
+
+    // Going down to 0 and back up to 100 has to be signalled as "0" and then "100".
+    encoder.set_maximum_table_size(0);
+    encoder.set_maximum_table_size(100);
+    auto block = MUST(encoder.encode({ { "custom-key", "custom-value" } }));
+    auto size_updates = hex("203f45"sv);
+    EXPECT_EQ(block.bytes().trim(3), size_updates.bytes());
+    expect_headers(MUST(decoder.decode(block)), { { "custom-key", "custom-value" } });
+    EXPECT_EQ(decoder.table().maximum_size(), 100u);
+    EXPECT_EQ(decoder.table().entry_count(), 1u);
+
+    // Credentials are never put into the table.
+    block = MUST(encoder.encode({ { "authorization", "secret" } }));
+    EXPECT_EQ(block[0] & 0xf0, 0x10);
+    EXPECT_EQ(encoder.table().entry_count(), 1u);
+}
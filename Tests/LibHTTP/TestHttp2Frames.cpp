@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibHTTP/Http2.h>
+#include <LibTest/TestCase.h>
+
+using namespace HTTP::Http2;
+
+static ByteBuffer bytes_of(std::initializer_list<u8> list)
+{
+    ByteBuffer buffer;
+    for (auto byte : list)
+        buffer.append(byte);
+    return buffer;
+}
+
+TEST_CASE(test_frame_header_round_trip)
+{
+    ByteBuffer buffer;
+    MUST(append_frame(buffer, FrameType::Headers, Flags::EndHeaders | Flags::EndStream, 0x1234567, "abc"sv.bytes()));
+    EXPECT_EQ(buffer.size(), frame_header_size + 3);
+    EXPECT_EQ(buffer.bytes().slice(0, frame_header_size), bytes_of({ 0, 0, 3, 0x1, 0x5, 0x01, 0x23, 0x45, 0x67 }).bytes());
+
+    auto header = FrameHeader::parse(buffer);
+    EXPECT_EQ(header.length, 3u);
+    EXPECT_EQ(header.type, FrameType::Headers);
+    EXPECT(header.has_flag(Flags::EndHeaders));
+    EXPECT(header.has_flag(Flags::EndStream));
+    EXPECT(!header.has_flag(Flags::Padded));
+    EXPECT_EQ(header.stream_id, 0x1234567u);
+}
+
+TEST_CASE(test_frame_header_ignores_reserved_bit)
+{
+    auto buffer = bytes_of({ 0, 1, 0, 0x0, 0x0, 0x80, 0, 0, 3 });
+    auto header = FrameHeader::parse(buffer);
+    EXPECT_EQ(header.length, 256u);
+    EXPECT_EQ(header.type, FrameType::Data);
+    EXPECT_EQ(header.stream_id, 3u);
+}
+
+TEST_CASE(test_frame_content_padding)
+{
+    FrameHeader header { .length = 0, .type = FrameType::Data, .flags = Flags::Padded, .stream_id = 1 };
+    auto payload = bytes_of({ 2, 'h', 'i', 0, 0 });
+    EXPECT_EQ(MUST(frame_content(header, payload)), "hi"sv.bytes());
+
+    // A frame that is nothing but padding is fine.
+    auto only_padding = bytes_of({ 2, 0, 0 });
+    EXPECT(MUST(frame_content(header, only_padding)).is_empty());
+
+    auto too_much_padding = bytes_of({ 3, 0, 0 });
+    EXPECT(frame_content(header, too_much_padding).is_error());
+    EXPECT(frame_content(header, {}).is_error());
+}
+
+TEST_CASE(test_frame_content_priority)
+{
+    FrameHeader header { .length = 0, .type = FrameType::Headers, .flags = Flags::Priority | Flags::Padded, .stream_id = 1 };
+    auto payload = bytes_of({ 1, 0x80, 0, 0, 0, 15, 0x82, 0 });
+    EXPECT_EQ(MUST(frame_content(header, payload)), bytes_of({ 0x82 }).bytes());
+
+    header.flags = Flags::Priority;
+    EXPECT(frame_content(header, bytes_of({ 0, 0, 0, 1 })).is_error());
+
+    // DATA frames don't have priority fields, even if someone sets the flag.
+    header.type = FrameType::Data;
+    EXPECT_EQ(MUST(frame_content(header, bytes_of({ 0, 0, 0, 1 }))).size(), 4u);
+}
+
+TEST_CASE(test_settings)
+{
+    ByteBuffer payload;
+    MUST(append_setting(payload, SettingsParameter::EnablePush, 0));
+    MUST(append_setting(payload, SettingsParameter::MaxConcurrentStreams, 100));
+    MUST(append_setting(payload, SettingsParameter::InitialWindowSize, 1 << 20));
+    MUST(append_setting(payload, SettingsParameter::MaxFrameSize, 1 << 20));
+    EXPECT_EQ(payload.size(), 24u);
+    EXPECT_EQ(payload.bytes().slice(0, 6), bytes_of({ 0, 2, 0, 0, 0, 0 }).bytes());
+
+    // Unknown settings are ignored.
+    payload.append(bytes_of({ 0x12, 0x34, 0, 0, 0, 1 }).bytes());
+
+    Settings settings;
+    EXPECT(!settings.apply(payload).is_error());
+    EXPECT(!settings.enable_push);
+    EXPECT_EQ(settings.max_concurrent_streams, 100u);
+    EXPECT_EQ(settings.initial_window_size, 1u << 20);
+    EXPECT_EQ(settings.max_frame_size, 1u << 20);
+    EXPECT_EQ(settings.header_table_size, 4096u);
+}
+
+TEST_CASE(test_invalid_settings)
+{
+    auto expect_error = [](SettingsParameter parameter, u32 value, ErrorCode expected_error) {
+        ByteBuffer payload;
+        MUST(append_setting(payload, parameter, value));
+        Settings settings;
+        auto result = settings.apply(payload);
+        EXPECT(result.is_error());
+        if (result.is_error())
+            EXPECT_EQ(result.error(), expected_error);
+    };
+
+    expect_error(SettingsParameter::EnablePush, 2, ErrorCode::ProtocolError);
+    expect_error(SettingsParameter::InitialWindowSize, maximum_window_size + 1, ErrorCode::FlowControlError);
+    expect_error(SettingsParameter::MaxFrameSize, default_maximum_frame_size - 1, ErrorCode::ProtocolError);
+    expect_error(SettingsParameter::MaxFrameSize, 1 << 24, ErrorCode::ProtocolError);
+
+    Settings settings;
+    auto truncated = bytes_of({ 0, 2, 0, 0, 0 });
+    auto result = settings.apply(truncated);
+    EXPECT(result.is_error());
+    if (result.is_error())
+        EXPECT_EQ(result.error(), ErrorCode::FrameSizeError);
+}
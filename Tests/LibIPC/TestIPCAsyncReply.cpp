@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Stream.h>
+#include <LibIPC/ConnectionFromClient.h>
+#include <LibIPC/ConnectionToServer.h>
+#include <LibIPC/ResponsePromise.h>
+#include <LibTest/TestCase.h>
+#include <Tests/LibIPC/AsyncReplyClientEndpoint.h>
+#include <Tests/LibIPC/AsyncReplyServerEndpoint.h>
+#include <sys/socket.h>
+
+class AsyncReplyServerConnection final : public IPC::ConnectionFromClient<AsyncReplyClientEndpoint, AsyncReplyServerEndpoint> {
+    C_OBJECT(AsyncReplyServerConnection);
+
+public:
+    size_t pending_additions() const { return m_pending_additions.size(); }
+    size_t pings() const { return m_pings; }
+
+    void resolve_pending_additions()
+    {
+        for (auto& addition : m_pending_additions)
+            addition.promise.resolve(addition.sum);
+        m_pending_additions.clear();
+    }
+
+private:
+    explicit AsyncReplyServerConnection(NonnullOwnPtr<Core::Stream::LocalSocket> socket)
+        : IPC::ConnectionFromClient<AsyncReplyClientEndpoint, AsyncReplyServerEndpoint>(*this, move(socket), 1)
+    {
+    }
+
+    virtual void die() override { }
+
+    virtual void add(i32 a, i32 b, IPC::ResponsePromise<Messages::AsyncReplyServer::AddResponse> promise) override
+    {
+        m_pending_additions.append({ a + b, move(promise) });
+    }
+
+    virtual void ping() override { ++m_pings; }
+
+    struct PendingAddition {
+        i32 sum;
+        IPC::ResponsePromise<Messages::AsyncReplyServer::AddResponse> promise;
+    };
+    Vector<PendingAddition> m_pending_additions;
+    size_t m_pings { 0 };
+};
+
+class AsyncReplyClientConnection final
+    : public IPC::ConnectionToServer<AsyncReplyClientEndpoint, AsyncReplyServerEndpoint>
+    , public AsyncReplyClientEndpoint {
+    C_OBJECT(AsyncReplyClientConnection);
+
+public:
+    virtual void die() override { }
+
+    void expect_sum(Optional<i32>& sum)
+    {
+        expect_response(AsyncReplyServerEndpoint::static_magic(), Messages::AsyncReplyServer::AddResponse::static_message_id(), [&sum](auto response) {
+            VERIFY(response);
+            sum = static_cast<Messages::AsyncReplyServer::AddResponse&>(*response).sum();
+        });
+    }
+
+    void expect_pong(bool& got_pong)
+    {
+        expect_response(AsyncReplyServerEndpoint::static_magic(), Messages::AsyncReplyServer::PingResponse::static_message_id(), [&got_pong](auto response) {
+            got_pong = response != nullptr;
+        });
+    }
+
+private:
+    explicit AsyncReplyClientConnection(NonnullOwnPtr<Core::Stream::LocalSocket> socket)
+        : IPC::ConnectionToServer<AsyncReplyClientEndpoint, AsyncReplyServerEndpoint>(*this, move(socket))
+    {
+    }
+};
+
+struct Connections {
+    NonnullRefPtr<AsyncReplyServerConnection> server;
+    NonnullRefPtr<AsyncReplyClientConnection> client;
+};
+
+static Connections connect()
+{
+    int fds[2];
+    VERIFY(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds) == 0);
+    auto server_socket = MUST(Core::Stream::LocalSocket::adopt_fd(fds[0]));
+    auto client_socket = MUST(Core::Stream::LocalSocket::adopt_fd(fds[1]));
+    return { AsyncReplyServerConnection::construct(move(server_socket)), AsyncReplyClientConnection::construct(move(client_socket)) };
+}
+
+TEST_CASE(response_is_sent_once_the_promise_is_resolved)
+{
+    Core::EventLoop loop;
+    auto [server, client] = connect();
+
+    Optional<i32> sum;
+    client->expect_sum(sum);
+    client->async_add(2, 3);
+    loop.spin_until([&] { return server->pending_additions() == 1; });
+    EXPECT(!sum.has_value());
+
+    server->resolve_pending_additions();
+    loop.spin_until([&] { return sum.has_value(); });
+    EXPECT_EQ(sum.value(), 5);
+}
+
+TEST_CASE(server_keeps_handling_messages_while_a_reply_is_pending)
+{
+    Core::EventLoop loop;
+    auto [server, client] = connect();
+
+    Optional<i32> sum;
+    bool got_pong = false;
+    client->expect_sum(sum);
+    client->expect_pong(got_pong);
+    client->async_add(20, 22);
+    client->async_ping();
+
+    loop.spin_until([&] { return got_pong; });
+    EXPECT_EQ(server->pings(), 1u);
+    EXPECT_EQ(server->pending_additions(), 1u);
+    EXPECT(!sum.has_value());
+
+    server->resolve_pending_additions();
+    loop.spin_until([&] { return sum.has_value(); });
+    EXPECT_EQ(sum.value(), 42);
+}
+
+TEST_CASE(resolving_after_the_client_went_away_does_nothing)
+{
+    Core::EventLoop loop;
+    auto [server, client] = connect();
+
+    client->async_add(1, 1);
+    loop.spin_until([&] { return server->pending_additions() == 1; });
+
+    client->shutdown();
+    loop.spin_until([&] { return !server->is_open(); });
+    server->resolve_pending_additions();
+    EXPECT_EQ(server->pending_additions(), 0u);
+}
@@ -138,3 +138,45 @@ TEST_CASE(catch_exception)
                             "if (hitCatch !== true) throw new Exception('failed');\n"
                             "if (hitFinally !== true) throw new Exception('failed');");
 }
+
+TEST_CASE(serialized_executable_round_trip)
+{
+    SETUP_AND_PARSE("var a = 1;\n"
+                    "for (var i = 0; i < 10; ++i) a += i;\n"
+                    "try { b(); } catch (e) { a += 1; }\n"
+                    "if (a !== 47) throw new Exception('failed');");
+
+    auto executable = MUST(JS::Bytecode::Generator::generate(program));
+    JS::Bytecode::Interpreter::optimization_pipeline().perform(*executable);
+
+    auto serialized = MUST(executable->serialize());
+    auto deserialized = MUST(JS::Bytecode::Executable::deserialize(serialized));
+    EXPECT_EQ(deserialized->statistics().basic_block_count, executable->statistics().basic_block_count);
+    EXPECT_EQ(deserialized->statistics().instruction_count, executable->statistics().instruction_count);
+    EXPECT_EQ(deserialized->number_of_registers, executable->number_of_registers);
+
+    // Labels are stored as block indices, so serializing it again gives back just as much.
+    auto reserialized = MUST(deserialized->serialize());
+    EXPECT_EQ(reserialized.size(), serialized.size());
+
+    auto result = bytecode_interpreter.run(*deserialized);
+    EXPECT(!result.is_error());
+}
+
+TEST_CASE(serialized_executable_rejects_mismatches)
+{
+    SETUP_AND_PARSE("var a = 1; if (a + 1 !== 2) throw new Exception('failed');");
+
+    auto executable = MUST(JS::Bytecode::Generator::generate(program));
+    auto serialized = MUST(executable->serialize());
+
+    for (size_t size = 0; size < serialized.size(); ++size)
+        EXPECT(JS::Bytecode::Executable::deserialize(serialized.bytes().trim(size)).is_error());
+
+    // The version, then the layout fingerprint of the build that made it.
+    for (size_t offset : { 4u, 8u }) {
+        auto corrupted = MUST(ByteBuffer::copy(serialized));
+        corrupted[offset] ^= 0xff;
+        EXPECT(JS::Bytecode::Executable::deserialize(corrupted).is_error());
+    }
+}
@@ -7,7 +7,9 @@
 #include <AK/Forward.h>
 #include <AK/String.h>
 #include <LibCore/MappedFile.h>
+#include <LibPDF/CommonNames.h>
 #include <LibPDF/Document.h>
+#include <LibPDF/Fonts/PDFFont.h>
 #include <LibTest/Macros.h>
 #include <LibTest/TestCase.h>
 
@@ -38,6 +40,31 @@ TEST_CASE(complex_pdf)
     EXPECT_EQ(document.value()->get_page_count(), 3U);
 }
 
+TEST_CASE(linearized_pdf_first_page)
+{
+    auto file = Core::MappedFile::map("linearized.pdf"sv).release_value();
+    auto document = MUST(PDF::Document::create(file->bytes()));
+    MUST(document->initialize());
+    auto page = MUST(document->get_page(0));
+    EXPECT_EQ(page.media_box.width(), 612.0f);
+    EXPECT_EQ(page.media_box.height(), 792.0f);
+}
+
+TEST_CASE(fonts_and_object_streams)
+{
+    auto file = Core::MappedFile::map("type1.pdf"sv).release_value();
+    auto document = MUST(PDF::Document::create(file->bytes()));
+    MUST(document->initialize());
+    auto page = MUST(document->get_page(0));
+    auto fonts = MUST(page.resources->get_dict(document, PDF::CommonNames::Font));
+    for (auto const& [name, _] : fonts->map()) {
+        auto font_dictionary = MUST(fonts->get_dict(document, name));
+        auto font = MUST(document->get_or_create_font(font_dictionary));
+        auto same_font = MUST(document->get_or_create_font(font_dictionary));
+        EXPECT_EQ(font.ptr(), same_font.ptr());
+    }
+}
+
 TEST_CASE(empty_file_issue_10702)
 {
     AK::ReadonlyBytes empty;
@@ -1109,3 +1109,140 @@ TEST_CASE(inversion_state_in_char_class)
         EXPECT_EQ(result.capture_group_matches.first()[1].view.to_string(), "}"sv);
     }
 }
+
+TEST_CASE(lazy_dfa_matches_like_the_vm)
+{
+    Array tests {
+        Tuple { "a+b"sv, "xaab ab aaa b"sv },
+        Tuple { "(a|ab)(c|bcd)"sv, "abcd"sv },
+        Tuple { "x*?y|x"sv, "xxxyx"sv },
+        Tuple { "\\bfoo\\b"sv, "foo foobar barfoo foo"sv },
+        Tuple { "^\\w+$"sv, "line one\nline_two\nthree"sv },
+        Tuple { "(?:a*)*b"sv, "aaab ab b"sv },
+        Tuple { "[^ ]+"sv, "  some  words here "sv },
+        Tuple { ""sv, "abc"sv },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.get<0>(), ECMAScriptFlags::Global | ECMAScriptFlags::Multiline);
+        Regex<ECMA262> re_without_dfa(test.get<0>(), ECMAScriptFlags::Global | ECMAScriptFlags::Multiline);
+        EXPECT(re.lazy_dfa);
+        re_without_dfa.lazy_dfa = nullptr;
+
+        auto result = re.match(test.get<1>());
+        auto expected = re_without_dfa.match(test.get<1>());
+        EXPECT_EQ(result.success, expected.success);
+        EXPECT_EQ(result.matches.size(), expected.matches.size());
+        for (size_t i = 0; i < min(result.matches.size(), expected.matches.size()); ++i) {
+            EXPECT_EQ(result.matches[i].global_offset, expected.matches[i].global_offset);
+            EXPECT_EQ(result.matches[i].view.to_string(), expected.matches[i].view.to_string());
+        }
+        EXPECT_EQ(result.capture_group_matches.size(), expected.capture_group_matches.size());
+        for (size_t i = 0; i < min(result.capture_group_matches.size(), expected.capture_group_matches.size()); ++i) {
+            EXPECT_EQ(result.capture_group_matches[i].size(), expected.capture_group_matches[i].size());
+            for (size_t j = 0; j < min(result.capture_group_matches[i].size(), expected.capture_group_matches[i].size()); ++j)
+                EXPECT_EQ(result.capture_group_matches[i][j].view.to_string(), expected.capture_group_matches[i][j].view.to_string());
+        }
+    }
+}
+
+TEST_CASE(lazy_dfa_is_not_used_for_backreferences_or_lookarounds)
+{
+    EXPECT(!Regex<ECMA262>("(a)\\1"sv).lazy_dfa);
+    EXPECT(!Regex<ECMA262>("a(?=b)"sv).lazy_dfa);
+    EXPECT(!Regex<ECMA262>("(?<!a)b"sv).lazy_dfa);
+}
+
+TEST_CASE(lazy_dfa_does_not_backtrack)
+{
+    // The VM would try every way of splitting the a's between the alternatives before giving up.
+    Regex<ECMA262> re("(a|aa)*b"sv);
+    EXPECT(re.lazy_dfa);
+    auto input = String::repeated('a', 100);
+    EXPECT_EQ(re.match(input).success, false);
+
+    auto result = re.match(String::formatted("{}b", input));
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.capture_group_matches.first()[0].view.to_string(), "a"sv);
+
+    Regex<PosixExtended> posix_re("(x+x+)+y"sv, PosixFlags::Global);
+    EXPECT(posix_re.lazy_dfa);
+    EXPECT_EQ(posix_re.match(String::repeated('x', 5000)).success, false);
+}
+
+TEST_CASE(lazy_dfa_state_cache_is_bounded)
+{
+    // Every combination of the last 13 characters is a state of its own, so there are more than we keep.
+    Regex<ECMA262> re("(?:a|b)*a(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)"sv);
+    EXPECT(re.lazy_dfa);
+
+    StringBuilder builder;
+    u32 seed = 1;
+    for (size_t i = 0; i < 20'000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        builder.append((seed >> 16) & 1 ? 'a' : 'b');
+    }
+    builder.append("abbbbbbbbbbbb"sv);
+    auto input = builder.build();
+
+    EXPECT_EQ(re.match(input).success, true);
+    EXPECT(re.lazy_dfa->flush_count() > 0);
+    EXPECT_EQ(re.match(String::formatted("{}a", input)).success, false);
+}
+
+TEST_CASE(literals_every_match_contains)
+{
+    {
+        Regex<ECMA262> re("foo\\d+"sv);
+        EXPECT_EQ(re.parser_result.optimization_data.required_prefix, "foo");
+        EXPECT(re.parser_result.optimization_data.required_literal.is_empty());
+    }
+    {
+        Regex<ECMA262> re("\\w+@example\\.com"sv);
+        EXPECT(re.parser_result.optimization_data.required_prefix.is_empty());
+        EXPECT_EQ(re.parser_result.optimization_data.required_literal, "@example.com");
+    }
+    {
+        Regex<ECMA262> re("(?:cat|dog)s"sv);
+        EXPECT(re.parser_result.optimization_data.required_prefix.is_empty());
+        EXPECT_EQ(re.parser_result.optimization_data.required_literal, "s");
+    }
+    {
+        // What the lookahead matches isn't part of the match.
+        Regex<ECMA262> re("a(?=b)"sv);
+        EXPECT(re.parser_result.optimization_data.required_prefix.is_empty());
+        EXPECT(re.parser_result.optimization_data.required_literal.is_empty());
+    }
+}
+
+TEST_CASE(literals_are_looked_for_before_matching)
+{
+    Array tests {
+        Tuple { "foo\\d+"sv, "foo fo1 foo12 xfoo3 foofoo4 foo"sv },
+        Tuple { "\\w+@example\\.com"sv, "me@example.com, you@example.org and them@example.com"sv },
+        Tuple { "(?:cat|dog)s"sv, "cats and dogs, but not a cat"sv },
+        Tuple { "needle"sv, "a haystack that is longer than sixteen characters with a needle all the way at the end: needle"sv },
+        Tuple { "needle"sv, "a haystack that is longer than sixteen characters without one"sv },
+        Tuple { "^abc"sv, "abc\nxabc\nabcabc"sv },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.get<0>(), ECMAScriptFlags::Global | ECMAScriptFlags::Multiline);
+        Regex<ECMA262> re_without_literals(test.get<0>(), ECMAScriptFlags::Global | ECMAScriptFlags::Multiline);
+        re_without_literals.parser_result.optimization_data = {};
+        re_without_literals.lazy_dfa = nullptr;
+
+        auto result = re.match(test.get<1>());
+        auto expected = re_without_literals.match(test.get<1>());
+        EXPECT_EQ(result.success, expected.success);
+        EXPECT_EQ(result.matches.size(), expected.matches.size());
+        for (size_t i = 0; i < min(result.matches.size(), expected.matches.size()); ++i) {
+            EXPECT_EQ(result.matches[i].global_offset, expected.matches[i].global_offset);
+            EXPECT_EQ(result.matches[i].view.to_string(), expected.matches[i].view.to_string());
+        }
+    }
+
+    // The literals are only looked for as they are, so they don't get in the way of matching case insensitively.
+    Regex<ECMA262> re("foo\\d"sv, ECMAScriptFlags::Insensitive);
+    EXPECT_EQ(re.match("FOO1"sv).success, true);
+}
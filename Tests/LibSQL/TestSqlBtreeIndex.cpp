@@ -123,6 +123,7 @@ constexpr static u32 pointers[] = {
 NonnullRefPtr<SQL::BTree> setup_btree(SQL::Serializer&);
 void insert_and_get_to_and_from_btree(int);
 void insert_into_and_scan_btree(int);
+void bulk_load_and_scan_btree(int, int);
 
 NonnullRefPtr<SQL::BTree> setup_btree(SQL::Serializer& serializer)
 {
@@ -224,6 +225,63 @@ void insert_into_and_scan_btree(int num_keys)
     }
 }
 
+// The even numbers below twice the number of keys are bulk loaded, and then some odd ones are inserted in between.
+void bulk_load_and_scan_btree(int num_keys, int num_inserted_keys)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        EXPECT(!heap->open().is_error());
+        SQL::Serializer serializer(heap);
+        auto btree = setup_btree(serializer);
+        EXPECT(btree->is_empty());
+
+        Vector<SQL::Key> sorted_keys;
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = 2 * ix;
+            k.set_pointer(1000 + 2 * ix);
+            sorted_keys.append(k);
+        }
+        btree->bulk_load(sorted_keys);
+        EXPECT_EQ(btree->is_empty(), num_keys == 0);
+
+        for (auto ix = 0; ix < num_inserted_keys; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = 2 * (ix * 7 % num_keys) + 1;
+            k.set_pointer(1000 + 2 * (ix * 7 % num_keys) + 1);
+            EXPECT(btree->insert(k));
+        }
+    }
+
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        EXPECT(!heap->open().is_error());
+        SQL::Serializer serializer(heap);
+        auto btree = setup_btree(serializer);
+
+        int count = 0;
+        SQL::Tuple prev;
+        for (auto iter = btree->begin(); !iter.is_end(); iter++, count++) {
+            auto key = (*iter);
+            if (prev.size()) {
+                EXPECT(prev < key);
+            }
+            EXPECT_EQ(key.pointer(), 1000u + key[0].to_int().value());
+            prev = key;
+        }
+        EXPECT_EQ(count, num_keys + num_inserted_keys);
+
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = 2 * ix;
+            auto pointer_opt = btree->get(k);
+            EXPECT(pointer_opt.has_value());
+            EXPECT_EQ(pointer_opt.value_or(0), 1000u + 2 * ix);
+        }
+    }
+}
+
 TEST_CASE(btree_one_key)
 {
     insert_and_get_to_and_from_btree(1);
@@ -318,3 +376,23 @@ TEST_CASE(btree_scan_50_keys)
 {
     insert_into_and_scan_btree(50);
 }
+
+TEST_CASE(btree_bulk_load_one_key)
+{
+    bulk_load_and_scan_btree(1, 0);
+}
+
+TEST_CASE(btree_bulk_load_one_leaf)
+{
+    bulk_load_and_scan_btree(20, 5);
+}
+
+TEST_CASE(btree_bulk_load_1000_keys)
+{
+    bulk_load_and_scan_btree(1000, 0);
+}
+
+TEST_CASE(btree_bulk_load_and_insert)
+{
+    bulk_load_and_scan_btree(1000, 100);
+}
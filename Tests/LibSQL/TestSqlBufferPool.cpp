@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <LibSQL/BufferPool.h>
+#include <LibTest/TestCase.h>
+
+constexpr size_t block_size = 1024;
+constexpr size_t page_size = 4 * KiB;
+
+// A page whose every byte is the number of the block it's in.
+static ByteBuffer make_page(u32 page, size_t block_count = page_size / block_size)
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(block_count * block_size));
+    for (auto ix = 0u; ix < block_count; ix++)
+        buffer.bytes().slice(ix * block_size, block_size).fill(static_cast<u8>(page * (page_size / block_size) + ix));
+    return buffer;
+}
+
+TEST_CASE(blocks_are_found_on_their_page)
+{
+    SQL::BufferPool pool(block_size, page_size, 4);
+    EXPECT_EQ(pool.blocks_per_page(), 4u);
+    EXPECT_EQ(pool.page_of(9), 2u);
+    EXPECT(!pool.block(9).has_value());
+
+    MUST(pool.insert_page(2, make_page(2)));
+    for (u32 block = 8; block < 12; block++) {
+        auto bytes = pool.block(block);
+        EXPECT(bytes.has_value());
+        EXPECT_EQ(bytes->size(), block_size);
+        EXPECT_EQ((*bytes)[0], block);
+        EXPECT_EQ((*bytes)[block_size - 1], block);
+    }
+    EXPECT(!pool.block(12).has_value());
+    EXPECT_EQ(pool.hits(), 4u);
+    EXPECT_EQ(pool.misses(), 2u);
+}
+
+TEST_CASE(short_last_page)
+{
+    SQL::BufferPool pool(block_size, page_size, 4);
+    MUST(pool.insert_page(0, make_page(0, 2)));
+    EXPECT(pool.block(1).has_value());
+    EXPECT(!pool.block(2).has_value());
+
+    // Appending a block to the end of the file makes the page it's on longer.
+    auto longer_page = make_page(0, 3);
+    auto block = longer_page.bytes().slice(2 * block_size);
+    pool.update_block(2, block);
+    EXPECT(pool.block(2).has_value());
+    EXPECT_EQ((*pool.block(2))[0], 2);
+
+    // Writing a block further past the end than that leaves a gap, so the page is dropped instead.
+    MUST(pool.insert_page(1, make_page(1, 1)));
+    pool.update_block(6, block);
+    EXPECT(!pool.block(4).has_value());
+    EXPECT(pool.block(2).has_value());
+}
+
+TEST_CASE(writes_update_cached_blocks)
+{
+    SQL::BufferPool pool(block_size, page_size, 4);
+    MUST(pool.insert_page(1, make_page(1)));
+    auto block = MUST(ByteBuffer::create_zeroed(block_size));
+    block[0] = 0xaa;
+    pool.update_block(6, block);
+    EXPECT_EQ((*pool.block(6))[0], 0xaa);
+    EXPECT_EQ((*pool.block(5))[0], 5);
+}
+
+TEST_CASE(clock_evicts_pages_that_were_not_used)
+{
+    SQL::BufferPool pool(block_size, page_size, 3);
+    for (u32 page = 0; page < 3; page++)
+        MUST(pool.insert_page(page, make_page(page)));
+
+    // The hand goes past all of the pages once, taking back the use they got from being inserted, and evicts the
+    // first one. Then it stops on the second one, which wasn't used after that either.
+    MUST(pool.insert_page(3, make_page(3)));
+    EXPECT(!pool.block(0).has_value());
+    EXPECT(pool.block(8).has_value());
+    MUST(pool.insert_page(4, make_page(4)));
+    EXPECT(!pool.block(4).has_value());
+    EXPECT(pool.block(8).has_value());
+    EXPECT(pool.block(12).has_value());
+    EXPECT(pool.block(16).has_value());
+}
+
+TEST_CASE(clear)
+{
+    SQL::BufferPool pool(block_size, page_size, 2);
+    MUST(pool.insert_page(0, make_page(0)));
+    MUST(pool.insert_page(1, make_page(1)));
+    pool.clear();
+    EXPECT(!pool.block(0).has_value());
+    EXPECT(!pool.block(4).has_value());
+}
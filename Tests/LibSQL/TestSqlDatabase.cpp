@@ -7,6 +7,7 @@
 #include <unistd.h>
 
 #include <AK/ScopeGuard.h>
+#include <LibCore/File.h>
 #include <LibSQL/BTree.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Heap.h>
@@ -116,7 +117,7 @@ TEST_CASE(create_heap)
     ScopeGuard guard([]() { unlink("/tmp/test.db"); });
     auto heap = SQL::Heap::construct("/tmp/test.db");
     EXPECT(!heap->open().is_error());
-    EXPECT_EQ(heap->version(), 0x00000001u);
+    EXPECT_EQ(heap->version(), SQL::Heap::current_version);
 }
 
 TEST_CASE(create_from_dev_random)
@@ -225,3 +226,70 @@ TEST_CASE(insert_100_into_table)
 {
     insert_and_verify(100);
 }
+
+static ByteBuffer read_file(String const& path)
+{
+    auto file = MUST(Core::File::open(path, Core::OpenMode::ReadOnly));
+    return file->read_all();
+}
+
+static void write_file(String const& path, ReadonlyBytes data)
+{
+    auto file = MUST(Core::File::open(path, Core::OpenMode::WriteOnly | Core::OpenMode::Truncate));
+    EXPECT(file->write(data.data(), data.size()));
+}
+
+TEST_CASE(commits_are_recovered_from_write_ahead_log)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    ByteBuffer log;
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT(!db->open().is_error());
+        (void)setup_table(db);
+        insert_into_table(db, 10);
+        commit(db);
+        log = read_file("/tmp/test.db-wal");
+        EXPECT(!log.is_empty());
+    }
+
+    // As if the heap file never got any of the blocks after they were in the log.
+    EXPECT_EQ(truncate("/tmp/test.db", 0), 0);
+    write_file("/tmp/test.db-wal", log);
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT(!db->open().is_error());
+        verify_table_contents(db, 10);
+    }
+}
+
+TEST_CASE(incomplete_commit_is_ignored)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    ByteBuffer log;
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT(!db->open().is_error());
+        (void)setup_table(db);
+        insert_into_table(db, 10);
+        commit(db);
+        insert_into_table(db, 10);
+        commit(db);
+        log = read_file("/tmp/test.db-wal");
+    }
+
+    // Cut off in the middle of the second commit.
+    EXPECT_EQ(truncate("/tmp/test.db", 0), 0);
+    write_file("/tmp/test.db-wal", log.bytes().trim(log.size() - 100));
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT(!db->open().is_error());
+        verify_table_contents(db, 10);
+    }
+}
@@ -131,6 +131,28 @@ TEST_CASE(null_literal)
     validate("NULL"sv);
 }
 
+TEST_CASE(bind_parameter)
+{
+    auto result = parse("?"sv);
+    EXPECT(!result.is_error());
+    auto expression = result.release_value();
+    EXPECT(is<SQL::AST::Placeholder>(*expression));
+    EXPECT_EQ(static_cast<SQL::AST::Placeholder const&>(*expression).parameter_index(), 0u);
+
+    // Placeholders are numbered in the order they appear in.
+    auto chained_result = parse("(?, 1, ?)"sv);
+    EXPECT(!chained_result.is_error());
+    auto chained_expression = chained_result.release_value();
+    EXPECT(is<SQL::AST::ChainedExpression>(*chained_expression));
+    auto const& expressions = static_cast<SQL::AST::ChainedExpression const&>(*chained_expression).expressions();
+    EXPECT_EQ(expressions.size(), 3u);
+    EXPECT(is<SQL::AST::Placeholder>(expressions[0]));
+    EXPECT_EQ(static_cast<SQL::AST::Placeholder const&>(expressions[0]).parameter_index(), 0u);
+    EXPECT(is<SQL::AST::NumericLiteral>(expressions[1]));
+    EXPECT(is<SQL::AST::Placeholder>(expressions[2]));
+    EXPECT_EQ(static_cast<SQL::AST::Placeholder const&>(expressions[2]).parameter_index(), 1u);
+}
+
 TEST_CASE(column_name)
 {
     EXPECT(parse(".column_name"sv).is_error());
@@ -9,6 +9,7 @@
 
 #include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
+#include <LibSQL/AST/Operators.h>
 #include <LibSQL/AST/Parser.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Result.h>
@@ -21,19 +22,19 @@ namespace {
 
 constexpr char const* db_name = "/tmp/test.db";
 
-SQL::ResultOr<SQL::ResultSet> try_execute(NonnullRefPtr<SQL::Database> database, String const& sql)
+SQL::ResultOr<SQL::ResultSet> try_execute(NonnullRefPtr<SQL::Database> database, String const& sql, Vector<SQL::Value> const& placeholder_values = {})
 {
     auto parser = SQL::AST::Parser(SQL::AST::Lexer(sql));
     auto statement = parser.next_statement();
     EXPECT(!parser.has_errors());
     if (parser.has_errors())
         outln("{}", parser.errors()[0].to_string());
-    return statement->execute(move(database));
+    return statement->execute(move(database), placeholder_values);
 }
 
-SQL::ResultSet execute(NonnullRefPtr<SQL::Database> database, String const& sql)
+SQL::ResultSet execute(NonnullRefPtr<SQL::Database> database, String const& sql, Vector<SQL::Value> const& placeholder_values = {})
 {
-    auto result = try_execute(move(database), sql);
+    auto result = try_execute(move(database), sql, placeholder_values);
     if (result.is_error()) {
         outln("{}", result.release_error().error_string());
         VERIFY_NOT_REACHED();
@@ -268,6 +269,32 @@ TEST_CASE(select_with_where)
     }
 }
 
+TEST_CASE(select_with_where_on_stored_rows)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+    auto result = execute(database,
+        "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES "
+        "( 'Test_1', 41.6 ), "
+        "( 'Test_2', 43 ), "
+        "( 'Test_3', 44 );");
+    EXPECT(result.size() == 3);
+
+    // Fractional numbers are rounded when they're stored in an integer column.
+    result = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable WHERE TextColumn = 'Test_1';");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[1].type(), SQL::SQLType::Integer);
+    EXPECT_EQ(result[0].row[1].to_int().value(), 42);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE 43 <= IntColumn;");
+    EXPECT_EQ(result.size(), 2u);
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE 'Test_2' < TextColumn;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "Test_3"sv);
+}
+
 TEST_CASE(select_cross_join)
 {
     ScopeGuard guard([]() { unlink(db_name); });
@@ -559,6 +586,57 @@ TEST_CASE(select_with_limit_and_offset)
     EXPECT_EQ(result.size(), 10u);
 }
 
+TEST_CASE(cursor_hands_out_rows_one_at_a_time)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+    for (auto count = 0; count < 100; count++) {
+        auto result = execute(database,
+            String::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count));
+        EXPECT(result.size() == 1);
+    }
+
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer("SELECT TextColumn, IntColumn FROM TestSchema.TestTable ORDER BY IntColumn LIMIT 3 OFFSET 1;"sv));
+    auto statement = parser.next_statement();
+    EXPECT(!parser.has_errors());
+    auto cursor = MUST(static_cast<SQL::AST::Select const&>(*statement).open_cursor(database));
+    for (auto count = 1; count <= 3; count++) {
+        auto row = MUST(cursor->next());
+        EXPECT(row.has_value());
+        EXPECT_EQ(row.value()[1].to_int().value(), count);
+    }
+    EXPECT(!MUST(cursor->next()).has_value());
+}
+
+TEST_CASE(cursor_keeps_reading_while_rows_are_inserted)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+    for (auto count = 0; count < 10; count++) {
+        auto result = execute(database,
+            String::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count));
+        EXPECT(result.size() == 1);
+    }
+
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer("SELECT TextColumn, IntColumn FROM TestSchema.TestTable;"sv));
+    auto statement = parser.next_statement();
+    EXPECT(!parser.has_errors());
+    auto cursor = MUST(static_cast<SQL::AST::Select const&>(*statement).open_cursor(database));
+
+    // Rows inserted while the cursor is open are not part of what it reads.
+    auto row_count = 0u;
+    while (MUST(cursor->next()).has_value()) {
+        row_count++;
+        execute(database, String::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Late_{}', {} );", row_count, row_count));
+    }
+    EXPECT_EQ(row_count, 10u);
+    EXPECT_EQ(execute(database, "SELECT TextColumn FROM TestSchema.TestTable;").size(), 20u);
+}
+
 TEST_CASE(select_with_order_limit_and_offset)
 {
     ScopeGuard guard([]() { unlink(db_name); });
@@ -754,4 +832,203 @@ TEST_CASE(binary_operator_failure)
     expect_failure(move(result), '&');
 }
 
+
+TEST_CASE(select_with_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+    auto result = execute(database,
+        "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES "
+        "( 'Test_1', 42 ), "
+        "( 'Test_2', 43 ), "
+        "( 'Test_3', 44 ), "
+        "( 'Test_4', 45 ), "
+        "( 'Test_5', 46 );");
+    EXPECT(result.size() == 5);
+
+    // Rows that are there before the index is created, and rows that come after, both have to be found through it.
+    result = execute(database, "CREATE INDEX TestSchema.TestIndex ON TestTable ( IntColumn );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+    result = execute(database,
+        "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES "
+        "( 'Test_6', 44 ), "
+        "( 'Test_7', 47 );");
+    EXPECT(result.size() == 2);
+
+    result = execute(database, "EXPLAIN SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 44;");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Explain);
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0].to_string(), "SEARCH TESTSCHEMA.TESTTABLE USING INDEX TESTINDEX (INTCOLUMN = 44) FILTER 1 CONDITION");
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 44 ORDER BY TextColumn;");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0].to_string(), "Test_3");
+    EXPECT_EQ(result[1].row[0].to_string(), "Test_6");
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE (IntColumn > 43) AND (46 >= IntColumn);");
+    EXPECT_EQ(result.size(), 4u);
+    for (auto& row : result) {
+        EXPECT(row.row[0].to_int().value() > 43);
+        EXPECT(row.row[0].to_int().value() <= 46);
+    }
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn < 42.5;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0].to_int().value(), 42);
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn = 50;");
+    EXPECT(result.is_empty());
+}
+
+TEST_CASE(unique_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+    auto result = execute(database, "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_1', 42 ), ( 'Test_2', 42 );");
+    EXPECT(result.size() == 2);
+
+    EXPECT(try_execute(database, "CREATE UNIQUE INDEX TestSchema.TestIndex ON TestTable ( IntColumn );").is_error());
+    result = execute(database, "CREATE UNIQUE INDEX TestSchema.TestIndex ON TestTable ( TextColumn );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+
+    auto create_again = try_execute(database, "CREATE UNIQUE INDEX TestSchema.TestIndex ON TestTable ( TextColumn );");
+    EXPECT(create_again.is_error());
+    EXPECT(create_again.release_error().error() == SQL::SQLErrorCode::IndexExists);
+    result = execute(database, "CREATE UNIQUE INDEX IF NOT EXISTS TestSchema.TestIndex ON TestTable ( TextColumn );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+
+    EXPECT(try_execute(database, "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_1', 43 );").is_error());
+    result = execute(database, "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_3', 43 );");
+    EXPECT(result.size() == 1);
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE TextColumn = 'Test_1';");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0].to_int().value(), 42);
+    result = execute(database, "SELECT * FROM TestSchema.TestTable;");
+    EXPECT_EQ(result.size(), 3u);
+}
+
+TEST_CASE(index_survives_reopening_database)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    {
+        auto database = SQL::Database::construct(db_name);
+        EXPECT(!database->open().is_error());
+        create_table(database);
+        for (auto count = 0; count < 100; count++) {
+            auto result = execute(database,
+                String::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'T{}', {} );", count, count % 10));
+            EXPECT(result.size() == 1);
+        }
+        auto result = execute(database, "CREATE INDEX TestSchema.TestIndex ON TestTable ( IntColumn );");
+        EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+        EXPECT(!database->commit().is_error());
+    }
+    {
+        auto database = SQL::Database::construct(db_name);
+        EXPECT(!database->open().is_error());
+        auto result = execute(database, "EXPLAIN SELECT * FROM TestSchema.TestTable WHERE IntColumn = 7;");
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT(result[0].row[0].to_string().contains("USING INDEX TESTINDEX"sv));
+
+        result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 7;");
+        EXPECT_EQ(result.size(), 10u);
+        for (auto& row : result)
+            EXPECT(row.row[0].to_string().ends_with('7'));
+    }
+}
+
+TEST_CASE(explain_join)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_two_tables(database);
+
+    auto result = execute(database,
+        "EXPLAIN QUERY PLAN SELECT TestTable1.IntColumn, TextColumn1, TextColumn2 "
+        "FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE (TestTable1.IntColumn = TestTable2.IntColumn) AND (TextColumn1 = 'Test_1');");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0].to_string(), "SCAN TESTSCHEMA.TESTTABLE1 FILTER 1 CONDITION");
+    EXPECT_EQ(result[1].row[0].to_string(), "SCAN TESTSCHEMA.TESTTABLE2 HASH JOIN ON TESTTABLE2.INTCOLUMN = TESTTABLE1.INTCOLUMN");
+
+    result = execute(database,
+        "EXPLAIN SELECT * FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn < TestTable2.IntColumn;");
+    EXPECT_EQ(result.size(), 3u);
+    EXPECT_EQ(result[0].row[0].to_string(), "SCAN TESTSCHEMA.TESTTABLE1");
+    EXPECT_EQ(result[1].row[0].to_string(), "SCAN TESTSCHEMA.TESTTABLE2 NESTED LOOP JOIN");
+    EXPECT_EQ(result[2].row[0].to_string(), "FILTER 1 CONDITION");
+}
+
+TEST_CASE(insert_many_rows_into_indexed_table)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+    auto result = execute(database, "CREATE UNIQUE INDEX TestSchema.TestIndex ON TestTable ( IntColumn );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+
+    // Enough rows for the index to need more than one node, in an order that isn't the order of the index.
+    StringBuilder builder;
+    builder.append("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES "sv);
+    for (auto count = 0; count < 200; count++) {
+        if (count > 0)
+            builder.append(", "sv);
+        builder.appendff("( 'T{}', {} )", count, (count * 7) % 200);
+    }
+    builder.append(';');
+    result = execute(database, builder.build());
+    EXPECT_EQ(result.size(), 200u);
+
+    // A duplicate within the rows of one statement is caught before any of them are inserted.
+    EXPECT(try_execute(database, "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'A', 500 ), ( 'B', 500 );").is_error());
+    result = execute(database, "SELECT * FROM TestSchema.TestTable;");
+    EXPECT_EQ(result.size(), 200u);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 49;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0].to_string(), "T7");
+
+    result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 190;");
+    EXPECT_EQ(result.size(), 10u);
+}
+
+TEST_CASE(execute_with_placeholders)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+
+    auto sql = "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( ?, ? );"sv;
+    for (auto count = 0; count < 3; count++) {
+        auto result = execute(database, sql, { SQL::Value { String::formatted("Test_{}", count) }, SQL::Value { 40 + count } });
+        EXPECT_EQ(result.size(), 1u);
+    }
+
+    auto not_enough_values = try_execute(database, sql, { SQL::Value { "Test"sv } });
+    EXPECT(not_enough_values.is_error());
+    EXPECT(not_enough_values.release_error().error() == SQL::SQLErrorCode::InvalidNumberOfPlaceholderValues);
+
+    auto result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = ?;", { SQL::Value { 41 } });
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0].to_string(), "Test_1");
+
+    // The value for a placeholder can be used to look rows up in an index.
+    result = execute(database, "CREATE INDEX TestSchema.TestIndex ON TestTable ( IntColumn );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+    result = execute(database, "EXPLAIN SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = ?;", { SQL::Value { 42 } });
+    EXPECT(result[0].row[0].to_string().contains("USING INDEX TESTINDEX"sv));
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = ?;", { SQL::Value { 42 } });
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0].to_string(), "Test_2");
+}
+
 }
@@ -131,6 +131,47 @@ TEST_CASE(create_table)
     validate("CREATE TABLE test ( column1 varchar(1e3) );"sv, {}, "TEST"sv, { { "COLUMN1"sv, "VARCHAR"sv, { 1000 } } });
 }
 
+TEST_CASE(create_index)
+{
+    EXPECT(parse("CREATE INDEX;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON table_name;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON table_name ();"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON table_name ( column1, );"sv).is_error());
+    EXPECT(parse("CREATE UNIQUE index_name ON table_name ( column1 );"sv).is_error());
+    EXPECT(parse("CREATE INDEX IF index_name ON table_name ( column1 );"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON schema_name.table_name ( column1 );"sv).is_error());
+
+    auto validate = [](StringView sql, StringView expected_schema, StringView expected_index, StringView expected_table, Vector<StringView> expected_columns, bool expected_is_unique = false, bool expected_is_error_if_index_exists = true) {
+        auto result = parse(sql);
+        if (result.is_error())
+            outln("{}: {}", sql, result.error());
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::AST::CreateIndex>(*statement));
+
+        const auto& index = static_cast<const SQL::AST::CreateIndex&>(*statement);
+        EXPECT_EQ(index.schema_name(), expected_schema);
+        EXPECT_EQ(index.index_name(), expected_index);
+        EXPECT_EQ(index.table_name(), expected_table);
+        EXPECT_EQ(index.is_unique(), expected_is_unique);
+        EXPECT_EQ(index.is_error_if_index_exists(), expected_is_error_if_index_exists);
+
+        const auto& columns = index.column_names();
+        EXPECT_EQ(columns.size(), expected_columns.size());
+        for (size_t i = 0; i < columns.size(); ++i)
+            EXPECT_EQ(columns[i], expected_columns[i]);
+    };
+
+    validate("CREATE INDEX index_name ON table_name ( column1 );"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN1"sv });
+    validate("CREATE INDEX index_name ON table_name ( column1, column2 );"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN1"sv, "COLUMN2"sv });
+    validate("CREATE INDEX schema_name.index_name ON table_name ( column1 );"sv, "SCHEMA_NAME"sv, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN1"sv });
+    validate("CREATE UNIQUE INDEX index_name ON table_name ( column1 );"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN1"sv }, true, true);
+    validate("CREATE INDEX IF NOT EXISTS index_name ON table_name ( column1 );"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { "COLUMN1"sv }, false, false);
+}
+
 TEST_CASE(alter_table)
 {
     // This test case only contains common error cases of the AlterTable subclasses.
@@ -776,3 +817,23 @@ TEST_CASE(describe_table)
     validate("DESCRIBE TABLE TableName;"sv, {}, "TABLENAME"sv);
     validate("DESCRIBE TABLE SchemaName.TableName;"sv, "SCHEMANAME"sv, "TABLENAME"sv);
 }
+
+TEST_CASE(explain)
+{
+    EXPECT(parse("EXPLAIN;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY SELECT * FROM table_name;"sv).is_error());
+    EXPECT(parse("EXPLAIN DESCRIBE TABLE table_name;"sv).is_error());
+
+    auto validate = [](StringView sql) {
+        auto result = parse(sql);
+        if (result.is_error())
+            outln("{}: {}", sql, result.error());
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::AST::Explain>(*statement));
+    };
+
+    validate("EXPLAIN SELECT * FROM table_name;"sv);
+    validate("EXPLAIN QUERY PLAN SELECT * FROM table_name WHERE column1 = 1;"sv);
+}
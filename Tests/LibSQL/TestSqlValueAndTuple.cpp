@@ -9,6 +9,8 @@
 
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
+#include <LibSQL/RowLayout.h>
+#include <LibSQL/Serializer.h>
 #include <LibSQL/Tuple.h>
 #include <LibSQL/Value.h>
 #include <LibTest/TestCase.h>
@@ -521,6 +523,79 @@ TEST_CASE(serialize_tuple)
     EXPECT_EQ(tuple2[1], 42);
 }
 
+TEST_CASE(row_layout)
+{
+    NonnullRefPtr<SQL::TupleDescriptor> descriptor = adopt_ref(*new SQL::TupleDescriptor);
+    descriptor->append({ "schema", "table", "text1", SQL::SQLType::Text, SQL::Order::Ascending });
+    descriptor->append({ "schema", "table", "int", SQL::SQLType::Integer, SQL::Order::Ascending });
+    descriptor->append({ "schema", "table", "text2", SQL::SQLType::Text, SQL::Order::Ascending });
+    descriptor->append({ "schema", "table", "float", SQL::SQLType::Float, SQL::Order::Ascending });
+    descriptor->append({ "schema", "table", "bool", SQL::SQLType::Boolean, SQL::Order::Ascending });
+    descriptor->append({ "schema", "table", "text3", SQL::SQLType::Text, SQL::Order::Ascending });
+    SQL::Tuple tuple(descriptor);
+    tuple["text1"] = "Test";
+    tuple["int"] = 42.4;
+    tuple["float"] = 3.5;
+    tuple["bool"] = true;
+    tuple["text3"] = "Tested";
+
+    SQL::RowLayout layout(*descriptor);
+    SQL::Serializer serializer;
+    layout.serialize(serializer, tuple, 7);
+    serializer.rewind();
+    auto bytes = serializer.remaining_bytes();
+
+    // Pointer, null bitmap, three text offsets, an i32, an f64 and a u8, then the text.
+    auto fixed_length = sizeof(u32) + 1 + 3 * sizeof(u32) + sizeof(i32) + sizeof(double) + sizeof(u8);
+    EXPECT_EQ(bytes.size(), fixed_length + 10);
+    EXPECT_EQ(layout.length(tuple), bytes.size());
+    EXPECT_EQ(layout.stored_length(bytes), bytes.size());
+
+    EXPECT_EQ(SQL::RowLayout::next_pointer(bytes), 7u);
+    EXPECT_EQ(layout.column(bytes, 0), "Test"sv);
+    EXPECT_EQ(layout.column(bytes, 1).type(), SQL::SQLType::Integer);
+    EXPECT_EQ(layout.column(bytes, 1), 42);
+    EXPECT(layout.is_null(bytes, 2));
+    EXPECT_EQ(layout.column(bytes, 2).type(), SQL::SQLType::Text);
+    EXPECT_EQ(layout.column(bytes, 3), 3.5);
+    EXPECT_EQ(layout.column(bytes, 4), true);
+    EXPECT_EQ(layout.column(bytes, 5), "Tested"sv);
+
+    SQL::Tuple read_back(descriptor);
+    layout.read_columns(bytes, read_back);
+    EXPECT_EQ(read_back[0], "Test"sv);
+    EXPECT_EQ(read_back[1], 42);
+    EXPECT(read_back[2].is_null());
+    EXPECT_EQ(read_back[3], 3.5);
+    EXPECT_EQ(read_back[4], true);
+    EXPECT_EQ(read_back[5], "Tested"sv);
+}
+
+TEST_CASE(serialize_row)
+{
+    auto schema = SQL::SchemaDef::construct("TestSchema");
+    auto table = SQL::TableDef::construct(schema, "TestTable");
+    table->append_column("TextColumn", SQL::SQLType::Text);
+    table->append_column("IntColumn", SQL::SQLType::Integer);
+
+    SQL::Row row(table, 4);
+    row["TextColumn"] = "Test";
+    row["IntColumn"] = 42;
+    row.next_pointer(12);
+
+    SQL::Serializer serializer;
+    serializer.serialize<SQL::Row>(row);
+    EXPECT_EQ(serializer.offset(), row.length());
+
+    serializer.rewind();
+    auto row2 = serializer.deserialize<SQL::Row>(table, 4);
+    EXPECT_EQ(serializer.offset(), row.length());
+    EXPECT_EQ(row2.pointer(), 4u);
+    EXPECT_EQ(row2.next_pointer(), 12u);
+    EXPECT_EQ(row2["TextColumn"], "Test"sv);
+    EXPECT_EQ(row2["IntColumn"], 42);
+}
+
 TEST_CASE(copy_tuple)
 {
     NonnullRefPtr<SQL::TupleDescriptor> descriptor = adopt_ref(*new SQL::TupleDescriptor);
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/DateTime.h>
+#include <LibTLS/SessionCache.h>
+#include <LibTest/TestCase.h>
+
+static TLS::Session make_session(u8 id, time_t lifetime = TLS::SessionCache::MaximumSessionLifetimeInSeconds)
+{
+    TLS::Session session;
+    session.session_id[0] = id;
+    session.session_id_size = 1;
+    session.master_key = MUST(ByteBuffer::create_zeroed(48));
+    session.cipher = TLS::CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256;
+    session.expiry_timestamp = Core::DateTime::now().timestamp() + lifetime;
+    return session;
+}
+
+TEST_CASE(test_session_cache_hits_and_misses)
+{
+    auto cache = TLS::SessionCache::create();
+    EXPECT(!cache->find("example.com:443").has_value());
+
+    cache->store("example.com:443", make_session(1));
+    auto session = cache->find("example.com:443");
+    EXPECT(session.has_value());
+    EXPECT_EQ(session->session_id[0], 1);
+    EXPECT_EQ(session->master_key.size(), 48u);
+
+    // Different ports are different servers.
+    EXPECT(!cache->find("example.com:8443").has_value());
+
+    EXPECT_EQ(cache->hits(), 1u);
+    EXPECT_EQ(cache->misses(), 2u);
+}
+
+TEST_CASE(test_session_cache_replaces_and_rejects)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("example.com:443", make_session(1));
+    cache->store("example.com:443", make_session(2));
+    EXPECT_EQ(cache->find("example.com:443")->session_id[0], 2);
+
+    cache->did_reject_session("example.com:443");
+    EXPECT_EQ(cache->rejections(), 1u);
+    EXPECT(!cache->find("example.com:443").has_value());
+}
+
+TEST_CASE(test_session_cache_expiry)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("example.com:443", make_session(1, -1));
+    EXPECT(!cache->find("example.com:443").has_value());
+}
+
+TEST_CASE(test_session_cache_evicts_the_oldest_session)
+{
+    auto cache = TLS::SessionCache::create();
+    for (size_t i = 0; i < TLS::SessionCache::MaximumSessionCount; ++i)
+        cache->store(String::formatted("host{}:443", i), make_session(i, 1000 + i));
+
+    cache->store("newcomer:443", make_session(42));
+    EXPECT(!cache->find("host0:443").has_value());
+    EXPECT(cache->find("host1:443").has_value());
+    EXPECT(cache->find("newcomer:443").has_value());
+}
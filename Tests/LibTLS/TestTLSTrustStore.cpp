@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/DateTime.h>
+#include <LibTLS/TrustStore.h>
+#include <LibTest/TestCase.h>
+
+static TLS::Certificate make_certificate(String common_name, u8 fingerprint)
+{
+    TLS::Certificate certificate;
+    certificate.subject.entity = "SerenityOS";
+    certificate.subject.subject = move(common_name);
+    certificate.not_before = Core::DateTime::from_timestamp(Core::DateTime::now().timestamp() - 60);
+    certificate.not_after = Core::DateTime::from_timestamp(Core::DateTime::now().timestamp() + 60 * 60);
+    certificate.fingerprint = MUST(ByteBuffer::create_zeroed(32));
+    certificate.fingerprint[0] = fingerprint;
+    return certificate;
+}
+
+static Core::DateTime from_now(time_t seconds)
+{
+    return Core::DateTime::from_timestamp(Core::DateTime::now().timestamp() + seconds);
+}
+
+TEST_CASE(test_trust_store_find_by_subject)
+{
+    auto store = TLS::TrustStore::create({ make_certificate("Root A", 1), make_certificate("Root B", 2) });
+    EXPECT_EQ(store->size(), 2u);
+
+    auto const* root = store->find_by_subject("/O=SerenityOS/CN=Root B");
+    EXPECT(root);
+    EXPECT_EQ(root->fingerprint[0], 2);
+    EXPECT(!store->find_by_subject("/O=SerenityOS/CN=Root C"));
+}
+
+TEST_CASE(test_trust_store_verified_chains)
+{
+    auto store = TLS::TrustStore::create({});
+    auto leaf = make_certificate("example.com", 1);
+    EXPECT(!store->has_verified_chain_for(leaf));
+
+    store->did_verify_chain_for(leaf, from_now(60));
+    EXPECT(store->has_verified_chain_for(leaf));
+
+    // A different certificate for the same name is not the one that was verified.
+    EXPECT(!store->has_verified_chain_for(make_certificate("example.com", 2)));
+
+    EXPECT_EQ(store->verified_chain_hits(), 1u);
+    EXPECT_EQ(store->verified_chain_misses(), 2u);
+}
+
+TEST_CASE(test_trust_store_verified_chain_expiry)
+{
+    auto store = TLS::TrustStore::create({});
+    auto leaf = make_certificate("example.com", 1);
+    store->did_verify_chain_for(leaf, from_now(-1));
+    EXPECT(!store->has_verified_chain_for(leaf));
+}
+
+TEST_CASE(test_trust_store_evicts_the_chain_expiring_first)
+{
+    auto store = TLS::TrustStore::create({});
+    for (size_t i = 0; i < TLS::TrustStore::MaximumVerifiedChainCount; ++i)
+        store->did_verify_chain_for(make_certificate(String::formatted("host{}", i), i), from_now(1000 + i));
+
+    auto newcomer = make_certificate("newcomer", 1);
+    newcomer.fingerprint[1] = 1;
+    store->did_verify_chain_for(newcomer, from_now(60));
+    EXPECT(!store->has_verified_chain_for(make_certificate("host0", 0)));
+    EXPECT(store->has_verified_chain_for(make_certificate("host1", 1)));
+    EXPECT(store->has_verified_chain_for(newcomer));
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/ThreadPool.h>
+
+TEST_CASE(parallel_for_visits_every_index_once)
+{
+    auto pool = MUST(Threading::ThreadPool::try_create(4, "Test pool"sv));
+    Vector<u32> visits;
+    visits.resize(10000);
+
+    pool->parallel_for(visits.size(), [&](size_t index) {
+        AK::atomic_fetch_add(&visits[index], 1u);
+    });
+
+    for (auto count : visits)
+        EXPECT_EQ(count, 1u);
+}
+
+TEST_CASE(parallel_sort)
+{
+    auto pool = MUST(Threading::ThreadPool::try_create(4, "Test pool"sv));
+    Vector<u32> values;
+    u32 state = 1;
+    for (size_t i = 0; i < 100000; ++i) {
+        state = state * 1103515245 + 12345;
+        values.append(state % 1000);
+    }
+
+    pool->parallel_sort(values.span());
+
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1] <= values[i]);
+}
+
+TEST_CASE(task_group_tasks_can_spawn_tasks)
+{
+    auto pool = MUST(Threading::ThreadPool::try_create(2, "Test pool"sv));
+    Atomic<u32> count { 0 };
+    {
+        Threading::TaskGroup group(*pool);
+        for (size_t i = 0; i < 16; ++i) {
+            group.spawn([&] {
+                for (size_t j = 0; j < 16; ++j)
+                    group.spawn([&] { count.fetch_add(1); });
+            });
+        }
+        group.wait();
+    }
+    EXPECT_EQ(count.load(), 256u);
+}
+
+TEST_CASE(task_graph_respects_dependencies)
+{
+    auto pool = MUST(Threading::ThreadPool::try_create(4, "Test pool"sv));
+    Atomic<u32> step { 0 };
+    u32 first = 0, second = 0, third = 0, last = 0;
+
+    Threading::TaskGraph graph;
+    auto a = graph.add_task([&] { first = step.fetch_add(1) + 1; });
+    auto b = graph.add_task([&] { second = step.fetch_add(1) + 1; }, Array { a }.span());
+    auto c = graph.add_task([&] { third = step.fetch_add(1) + 1; }, Array { a }.span());
+    graph.add_task([&] { last = step.fetch_add(1) + 1; }, Array { b, c }.span());
+    graph.run(*pool);
+
+    EXPECT_EQ(first, 1u);
+    EXPECT(second > first && third > first);
+    EXPECT_EQ(last, 4u);
+}
+
+TEST_CASE(run_async_resolves_on_the_calling_event_loop)
+{
+    Core::EventLoop loop;
+    auto pool = MUST(Threading::ThreadPool::try_create(1, "Test pool"sv));
+    auto promise = pool->run_async<int>([] { return 42; });
+    EXPECT_EQ(promise->await(), 42);
+}
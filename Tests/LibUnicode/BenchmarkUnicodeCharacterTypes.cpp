@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Format.h>
+#include <AK/Function.h>
+#include <AK/Time.h>
+#include <LibUnicode/CharacterTypes.h>
+#include <time.h>
+
+// Every code point once, which is a lot more spread out than real text, plus a second pass over ASCII and the
+// BMP to weigh those about as much as text does.
+static void benchmark_lookup(StringView name, Function<u32(u32)> const& lookup)
+{
+    constexpr u32 code_point_count = 0x110000;
+
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    u32 checksum = 0;
+    size_t lookups = 0;
+    for (u32 code_point = 0; code_point < code_point_count; ++code_point)
+        checksum += lookup(code_point);
+    lookups += code_point_count;
+    for (u32 code_point = 0; code_point < 0x10000; ++code_point)
+        checksum += lookup(code_point % 0x80) + lookup(code_point);
+    lookups += 2 * 0x10000;
+
+    timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    auto elapsed = Time::from_timespec(end) - Time::from_timespec(start);
+    outln("{}: {:.2} ns per code point (checksum {})", name, elapsed.to_nanoseconds() / static_cast<double>(lookups), checksum);
+}
+
+BENCHMARK_CASE(general_category_lookup)
+{
+    auto letter = Unicode::general_category_from_string("L"sv);
+    if (!letter.has_value())
+        return;
+    benchmark_lookup("code_point_has_general_category"sv, [&](u32 code_point) -> u32 {
+        return Unicode::code_point_has_general_category(code_point, *letter);
+    });
+}
+
+BENCHMARK_CASE(property_lookup)
+{
+    auto white_space = Unicode::property_from_string("White_Space"sv);
+    if (!white_space.has_value())
+        return;
+    benchmark_lookup("code_point_has_property"sv, [&](u32 code_point) -> u32 {
+        return Unicode::code_point_has_property(code_point, *white_space);
+    });
+}
+
+BENCHMARK_CASE(script_lookup)
+{
+    auto latin = Unicode::script_from_string("Latin"sv);
+    if (!latin.has_value())
+        return;
+    benchmark_lookup("code_point_has_script"sv, [&](u32 code_point) -> u32 {
+        return Unicode::code_point_has_script(code_point, *latin);
+    });
+}
+
+BENCHMARK_CASE(case_mapping_lookup)
+{
+    benchmark_lookup("to_unicode_lowercase"sv, [](u32 code_point) { return Unicode::to_unicode_lowercase(code_point); });
+    benchmark_lookup("to_unicode_uppercase"sv, [](u32 code_point) { return Unicode::to_unicode_uppercase(code_point); });
+}
+
+BENCHMARK_CASE(combining_class_lookup)
+{
+    benchmark_lookup("canonical_combining_class"sv, [](u32 code_point) { return Unicode::canonical_combining_class(code_point); });
+}
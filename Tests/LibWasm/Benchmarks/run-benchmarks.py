@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+# Runs a few small WebAssembly kernels through the `wasm` utility and reports how many operations per second
+# each of them manages. The modules are assembled here, so no external WebAssembly toolchain is needed.
+#
+# Usage: run-benchmarks.py [--wasm path/to/wasm] [--iterations N] [benchmark...]
+
+import argparse
+import struct
+import subprocess
+import sys
+import time
+from os import path
+from tempfile import TemporaryDirectory
+
+
+def unsigned_leb128(value):
+    result = bytearray()
+    while True:
+        byte = value & 0x7f
+        value >>= 7
+        if value == 0:
+            result.append(byte)
+            return bytes(result)
+        result.append(byte | 0x80)
+
+
+def signed_leb128(value):
+    result = bytearray()
+    while True:
+        byte = value & 0x7f
+        value >>= 7
+        if (value == 0 and not byte & 0x40) or (value == -1 and byte & 0x40):
+            result.append(byte)
+            return bytes(result)
+        result.append(byte | 0x80)
+
+
+def vector(entries):
+    return unsigned_leb128(len(entries)) + b''.join(entries)
+
+
+def encoded_name(text):
+    return unsigned_leb128(len(text)) + text
+
+
+def section(identifier, contents):
+    return bytes([identifier]) + unsigned_leb128(len(contents)) + contents
+
+
+I32 = 0x7f
+V128 = 0x7b
+
+
+# Instructions, just the ones the kernels below need.
+def local_get(index):
+    return b'\x20' + unsigned_leb128(index)
+
+
+def local_set(index):
+    return b'\x21' + unsigned_leb128(index)
+
+
+def i32_const(value):
+    return b'\x41' + signed_leb128(value)
+
+
+def simd(opcode, immediates=b''):
+    return b'\xfd' + unsigned_leb128(opcode) + immediates
+
+
+def memory_argument(align, offset=0):
+    return unsigned_leb128(align) + unsigned_leb128(offset)
+
+
+def v128_const(*lanes):
+    return simd(0x0c, struct.pack('<4I', *lanes))
+
+
+def f32x4_const(*lanes):
+    return simd(0x0c, struct.pack('<4f', *lanes))
+
+
+I32_EQZ = b'\x45'
+I32_ADD = b'\x6a'
+I32_SUB = b'\x6b'
+I32_MUL = b'\x6c'
+I32_AND = b'\x71'
+I32_SHL = b'\x74'
+V128_LOAD = simd(0x00, memory_argument(4))
+V128_STORE = simd(0x0b, memory_argument(4))
+I8X16_SWIZZLE = simd(0x0e)
+I8X16_ADD_SAT_U = simd(0x70)
+I32X4_ADD = simd(0xae)
+I32X4_MUL = simd(0xb5)
+F32X4_ADD = simd(0xe4)
+F32X4_MUL = simd(0xe6)
+
+
+def i32x4_extract_lane(lane):
+    return simd(0x1b, bytes([lane]))
+
+
+def i8x16_shuffle(*lanes):
+    return simd(0x0d, bytes(lanes))
+
+
+def counted_loop(body):
+    # Runs body as many times as the first parameter says, counting it down to zero.
+    return (b'\x02\x40' + b'\x03\x40'
+            + local_get(0) + I32_EQZ + b'\x0d' + unsigned_leb128(1)
+            + body
+            + local_get(0) + i32_const(1) + I32_SUB + local_set(0)
+            + b'\x0c' + unsigned_leb128(0)
+            + b'\x0b' + b'\x0b')
+
+
+def module(locals, prologue, body, epilogue, memory=False):
+    # A module exporting `run(i32) -> i32`, which runs the body in a loop.
+    function_type = b'\x60' + vector([bytes([I32])]) + vector([bytes([I32])])
+    local_declarations = vector([unsigned_leb128(1) + bytes([kind]) for kind in locals])
+    code = local_declarations + prologue + counted_loop(body) + epilogue + b'\x0b'
+    contents = b'\x00asm' + struct.pack('<I', 1)
+    contents += section(1, vector([function_type]))
+    contents += section(3, vector([unsigned_leb128(0)]))
+    if memory:
+        contents += section(5, vector([b'\x00' + unsigned_leb128(1)]))
+    contents += section(7, vector([encoded_name(b'run') + b'\x00' + unsigned_leb128(0)]))
+    contents += section(10, vector([unsigned_leb128(len(code)) + code]))
+    return contents
+
+
+# Each benchmark is (description, operations per iteration, module); local 1 is the accumulator.
+BENCHMARKS = {
+    'i32-arithmetic': (
+        'i32.mul and i32.add on a scalar accumulator',
+        2,
+        module([I32], b'',
+               local_get(1) + i32_const(31) + I32_MUL + local_get(0) + I32_ADD + local_set(1),
+               local_get(1)),
+    ),
+    'i32x4-arithmetic': (
+        'i32x4.mul and i32x4.add on a vector accumulator',
+        2,
+        module([V128], v128_const(1, 2, 3, 4) + local_set(1),
+               local_get(1) + v128_const(31, 31, 31, 31) + I32X4_MUL
+               + v128_const(1, 3, 5, 7) + I32X4_ADD + local_set(1),
+               local_get(1) + i32x4_extract_lane(0)),
+    ),
+    'f32x4-multiply-add': (
+        'f32x4.mul and f32x4.add on a vector accumulator',
+        2,
+        module([V128], f32x4_const(1, 2, 3, 4) + local_set(1),
+               local_get(1) + f32x4_const(0.5, 0.5, 0.5, 0.5) + F32X4_MUL
+               + f32x4_const(1, 1, 1, 1) + F32X4_ADD + local_set(1),
+               local_get(1) + i32x4_extract_lane(0)),
+    ),
+    'i8x16-saturating-memory': (
+        'v128.load, i8x16.add_sat_u and v128.store over a 64 KiB buffer',
+        3,
+        module([V128], v128_const(0x01020304, 0x05060708, 0x090a0b0c, 0x0d0e0f10) + local_set(1),
+               local_get(0) + i32_const(4) + I32_SHL + i32_const(0xfff0) + I32_AND
+               + local_get(0) + i32_const(4) + I32_SHL + i32_const(0xfff0) + I32_AND
+               + V128_LOAD + local_get(1) + I8X16_ADD_SAT_U + V128_STORE,
+               i32_const(0), memory=True),
+    ),
+    'i8x16-permute': (
+        'i8x16.shuffle and i8x16.swizzle on a vector accumulator',
+        2,
+        module([V128], v128_const(0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c) + local_set(1),
+               local_get(1) + local_get(1) + i8x16_shuffle(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16)
+               + v128_const(0x0c0d0e0f, 0x08090a0b, 0x04050607, 0x00010203) + I8X16_SWIZZLE + local_set(1),
+               local_get(1) + i32x4_extract_lane(0)),
+    ),
+}
+
+
+def run_benchmark(wasm, directory, name, iterations):
+    description, operations_per_iteration, contents = BENCHMARKS[name]
+    module_path = path.join(directory, f'{name}.wasm')
+    with open(module_path, 'wb') as file:
+        file.write(contents)
+
+    start = time.perf_counter()
+    try:
+        result = subprocess.run([wasm, '-e', 'run', '--arg', str(iterations), module_path],
+                                stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    except OSError as error:
+        print(f'{name}: failed to run {wasm}: {error.strerror}', file=sys.stderr)
+        return False
+    elapsed = time.perf_counter() - start
+    if result.returncode != 0:
+        print(f'{name}: failed to run: {result.stderr.decode(errors="replace").strip()}', file=sys.stderr)
+        return False
+
+    operations = iterations * operations_per_iteration
+    print(f'{name:<26} {operations / elapsed:>16,.0f} ops/s  ({description})')
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run WebAssembly microbenchmarks through the wasm utility')
+    parser.add_argument('--wasm', default='wasm', help='path to the wasm utility')
+    parser.add_argument('--iterations', type=int, default=1_000_000, help='number of loop iterations per benchmark')
+    parser.add_argument('benchmarks', nargs='*',
+                        help=f'benchmarks to run, out of {", ".join(BENCHMARKS)} (default: all)')
+    args = parser.parse_args()
+    for name in args.benchmarks:
+        if name not in BENCHMARKS:
+            parser.error(f'unknown benchmark {name}')
+
+    succeeded = True
+    with TemporaryDirectory() as directory:
+        for name in args.benchmarks or BENCHMARKS.keys():
+            succeeded &= run_benchmark(args.wasm, directory, name, args.iterations)
+    return 0 if succeeded else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
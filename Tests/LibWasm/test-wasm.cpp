@@ -147,7 +147,22 @@ TESTJS_GLOBAL_FUNCTION(compare_typed_arrays, compareTypedArrays)
     if (!is<JS::TypedArrayBase>(rhs))
         return vm.throw_completion<JS::TypeError>("Expected a TypedArray");
     auto& rhs_array = static_cast<JS::TypedArrayBase&>(*rhs);
-    return JS::Value(lhs_array.viewed_array_buffer()->buffer() == rhs_array.viewed_array_buffer()->buffer());
+    return JS::Value(lhs_array.viewed_array_buffer()->bytes() == rhs_array.viewed_array_buffer()->bytes());
+}
+
+// Vectors are passed to and from the tests as BigInts, of which only the lowest 128 bits are used.
+static u128 bigint_to_vector(Crypto::SignedBigInteger const& value)
+{
+    auto& words = value.unsigned_value().words();
+    u64 parts[2] {};
+    for (size_t i = 0; i < min<size_t>(words.size(), 4); ++i)
+        parts[i / 2] |= static_cast<u64>(words[i]) << (32 * (i % 2));
+    return u128 { parts[0], parts[1] };
+}
+
+static Crypto::SignedBigInteger vector_to_bigint(u128 value)
+{
+    return Crypto::SignedBigInteger { Crypto::UnsignedBigInteger { value.high() }.shift_left(64).plus(Crypto::UnsignedBigInteger { value.low() }) };
 }
 
 void WebAssemblyModule::initialize(JS::Realm& realm)
@@ -175,6 +190,7 @@ JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::get_export)
                     [&](auto const& value) -> JS::Value { return JS::Value(static_cast<double>(value)); },
                     [&](i32 value) { return JS::Value(static_cast<double>(value)); },
                     [&](i64 value) -> JS::Value { return JS::js_bigint(vm, Crypto::SignedBigInteger { value }); },
+                    [&](u128 value) -> JS::Value { return JS::js_bigint(vm, vector_to_bigint(value)); },
                     [&](Wasm::Reference const& reference) -> JS::Value {
                         return reference.ref().visit(
                             [&](const Wasm::Reference::Null&) -> JS::Value { return JS::js_null(); },
@@ -227,6 +243,14 @@ JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::wasm_invoke)
         case Wasm::ValueType::Kind::F64:
             arguments.append(Wasm::Value(static_cast<double>(double_value)));
             break;
+        case Wasm::ValueType::Kind::V128:
+            if (argument.is_bigint()) {
+                auto value = TRY(argument.to_bigint(vm));
+                arguments.append(Wasm::Value(bigint_to_vector(value->big_integer())));
+            } else {
+                arguments.append(Wasm::Value(u128 { static_cast<u64>(double_value) }));
+            }
+            break;
         case Wasm::ValueType::Kind::FunctionReference:
             arguments.append(Wasm::Value(Wasm::Reference { Wasm::Reference::Func { static_cast<u64>(double_value) } }));
             break;
@@ -254,6 +278,7 @@ JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::wasm_invoke)
         [&](auto const& value) { return_value = JS::Value(static_cast<double>(value)); },
         [&](i32 value) { return_value = JS::Value(static_cast<double>(value)); },
         [&](i64 value) { return_value = JS::Value(JS::js_bigint(vm, Crypto::SignedBigInteger { value })); },
+        [&](u128 value) { return_value = JS::Value(JS::js_bigint(vm, vector_to_bigint(value))); },
         [&](Wasm::Reference const& reference) {
             reference.ref().visit(
                 [&](const Wasm::Reference::Null&) { return_value = JS::js_null(); },
@@ -29,3 +29,24 @@ TEST_CASE(character_reference_integer_overflow)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+TEST_CASE(listener_sees_every_element)
+{
+    struct EventRecorder : public XML::Listener {
+        virtual void element_start(XML::Name const& name, HashMap<XML::Name, String> const& attributes) override
+        {
+            events.append(String::formatted("<{} {}>", name, attributes.get("a"sv).value_or("-")));
+        }
+        virtual void element_end(XML::Name const& name) override { events.append(String::formatted("</{}>", name)); }
+        virtual void text(StringView text) override { events.append(text); }
+
+        Vector<String> events;
+    };
+
+    XML::Parser parser("<root a='1'>text<empty a=\"2\"/><child>more</child></root>"sv);
+    EventRecorder recorder;
+    EXPECT(!parser.parse_with_listener(recorder).is_error());
+
+    Vector<String> expected_events { "<root 1>", "text", "<empty 2>", "</empty>", "<child ->", "more", "</child>", "</root>" };
+    EXPECT_EQ(recorder.events, expected_events);
+}
@@ -1,7 +1,7 @@
 # This module is shared by multiple languages; use include blocker.
 include_guard()
 
-set(CMAKE_EXE_LINKER_FLAGS_INIT "-Wl,--hash-style=gnu,-z,relro,-z,now,-z,noexecstack,-z,separate-code,-z,max-page-size=0x1000")
+set(CMAKE_EXE_LINKER_FLAGS_INIT "-Wl,--hash-style=gnu,-z,relro,-z,noexecstack,-z,separate-code,-z,max-page-size=0x1000")
 
 macro(__serenity_compiler_gnu lang)
   set(CMAKE_SHARED_LIBRARY_RUNTIME_${lang}_FLAG "-Wl,-rpath,")
@@ -10,7 +10,7 @@ macro(__serenity_compiler_gnu lang)
   set(CMAKE_SHARED_LIBRARY_SONAME_${lang}_FLAG "-Wl,-soname,")
   set(CMAKE_EXE_EXPORTS_${lang}_FLAG "-Wl,--export-dynamic")
 
-  set(CMAKE_SHARED_LIBRARY_CREATE_${lang}_FLAGS "-shared -Wl,--hash-style=gnu,-z,relro,-z,now,-z,noexecstack,-z,separate-code")
+  set(CMAKE_SHARED_LIBRARY_CREATE_${lang}_FLAGS "-shared -Wl,--hash-style=gnu,-z,relro,-z,noexecstack,-z,separate-code")
 
   # Initialize link type selection flags.  These flags are used when
   # building a shared library, shared module, or executable that links
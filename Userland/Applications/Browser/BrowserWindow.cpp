@@ -355,6 +355,11 @@ void BrowserWindow::build_menus()
             active_tab().view().debug_request("dump-style-sheets");
         },
         this));
+    debug_menu.add_action(GUI::Action::create(
+        "Dump &Connection Pool", [this](auto&) {
+            active_tab().view().debug_request("dump-connection-pool");
+        },
+        this));
     debug_menu.add_action(GUI::Action::create("Dump &History", { Mod_Ctrl, Key_H }, g_icon_bag.history, [this](auto&) {
         active_tab().m_history.dump();
     }));
@@ -374,6 +379,13 @@ void BrowserWindow::build_menus()
         this);
     line_box_borders_action->set_checked(false);
     debug_menu.add_action(line_box_borders_action);
+    auto tile_cache_overlay_action = GUI::Action::create_checkable(
+        "&Tile Cache Overlay", [this](auto& action) {
+            active_tab().view().debug_request("set-tile-cache-overlay", action.is_checked() ? "on" : "off");
+        },
+        this);
+    tile_cache_overlay_action->set_checked(false);
+    debug_menu.add_action(tile_cache_overlay_action);
 
     debug_menu.add_separator();
     debug_menu.add_action(GUI::Action::create("Collect &Garbage", { Mod_Ctrl | Mod_Shift, Key_G }, g_icon_bag.trash_can, [this](auto&) {
@@ -294,6 +294,7 @@ void DirectoryView::setup_table_view()
 {
     m_table_view = add<GUI::TableView>();
     m_table_view->set_should_hide_unnecessary_scrollbars(true);
+    m_table_view->set_caches_cell_data(true);
     m_table_view->set_selection_mode(GUI::AbstractView::SelectionMode::MultiSelection);
     m_table_view->set_editable(true);
     m_table_view->set_edit_triggers(GUI::AbstractView::EditTrigger::EditKeyPressed);
@@ -32,7 +32,7 @@ ViewWidget::ViewWidget()
 void ViewWidget::clear()
 {
     m_timer->stop();
-    m_decoded_image.clear();
+    close_image();
     m_bitmap = nullptr;
     if (on_image_change)
         on_image_change(m_bitmap);
@@ -43,6 +43,14 @@ void ViewWidget::clear()
     update();
 }
 
+void ViewWidget::close_image()
+{
+    if (m_image.has_value() && m_decoder_client)
+        m_decoder_client->close_image(*m_image);
+    m_image.clear();
+    m_frames.clear();
+}
+
 void ViewWidget::flip(Gfx::Orientation orientation)
 {
     m_bitmap = m_bitmap->flipped(orientation).release_value_but_fixme_should_propagate_errors();
@@ -165,17 +173,29 @@ void ViewWidget::load_from_file(String const& path)
 
     auto& mapped_file = *file_or_error.value();
 
-    // Spawn a new ImageDecoder service process and connect to it.
-    auto client = ImageDecoderClient::Client::try_create().release_value_but_fixme_should_propagate_errors();
+    // Spawn an ImageDecoder service process the first time around and keep it, so that images which are opened again
+    // come out of its cache.
+    if (!m_decoder_client) {
+        m_decoder_client = ImageDecoderClient::Client::try_create().release_value_but_fixme_should_propagate_errors();
+        m_decoder_client->on_death = [this] {
+            m_decoder_client = nullptr;
+            m_image.clear();
+        };
+    }
 
-    auto decoded_image_or_error = client->decode_image(mapped_file.bytes());
-    if (!decoded_image_or_error.has_value()) {
+    close_image();
+    m_image = m_decoder_client->open_image(mapped_file.bytes());
+    if (!m_image.has_value() || m_image->frame_count == 0) {
         show_error();
         return;
     }
 
-    m_decoded_image = decoded_image_or_error.release_value();
-    m_bitmap = m_decoded_image->frames[0].bitmap;
+    m_frames.resize(m_image->frame_count);
+    auto first_frame = m_decoder_client->decode_frame(*m_image, 0);
+    if (first_frame.has_value())
+        m_frames[0] = first_frame.release_value();
+
+    m_bitmap = m_frames[0].bitmap;
     if (m_bitmap.is_null()) {
         show_error();
         return;
@@ -185,9 +205,8 @@ void ViewWidget::load_from_file(String const& path)
     if (on_image_change)
         on_image_change(m_bitmap);
 
-    if (m_decoded_image->is_animated && m_decoded_image->frames.size() > 1) {
-        auto const& first_frame = m_decoded_image->frames[0];
-        m_timer->set_interval(first_frame.duration);
+    if (m_image->is_animated && m_frames.size() > 1) {
+        m_timer->set_interval(m_frames[0].duration);
         m_timer->on_timeout = [this] { animate(); };
         m_timer->start();
     } else {
@@ -248,21 +267,29 @@ void ViewWidget::set_bitmap(Gfx::Bitmap const* bitmap)
 // Same as ImageWidget::animate(), you probably want to keep any changes in sync
 void ViewWidget::animate()
 {
-    if (!m_decoded_image.has_value())
+    if (!m_image.has_value() || !m_decoder_client)
         return;
 
-    m_current_frame_index = (m_current_frame_index + 1) % m_decoded_image->frames.size();
+    m_current_frame_index = (m_current_frame_index + 1) % m_frames.size();
 
-    auto const& current_frame = m_decoded_image->frames[m_current_frame_index];
+    auto& current_frame = m_frames[m_current_frame_index];
+    if (!current_frame.bitmap) {
+        auto frame = m_decoder_client->decode_frame(*m_image, m_current_frame_index);
+        if (!frame.has_value() || !frame->bitmap) {
+            m_timer->stop();
+            return;
+        }
+        current_frame = frame.release_value();
+    }
     set_bitmap(current_frame.bitmap);
 
     if ((int)current_frame.duration != m_timer->interval()) {
         m_timer->restart(current_frame.duration);
     }
 
-    if (m_current_frame_index == m_decoded_image->frames.size() - 1) {
+    if (m_current_frame_index == m_frames.size() - 1) {
         ++m_loops_completed;
-        if (m_loops_completed > 0 && m_loops_completed == m_decoded_image->loop_count) {
+        if (m_loops_completed > 0 && m_loops_completed == m_image->loop_count) {
             m_timer->stop();
         }
     }
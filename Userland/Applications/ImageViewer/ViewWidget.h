@@ -63,11 +63,15 @@ private:
 
     void set_bitmap(Gfx::Bitmap const* bitmap);
     void animate();
+    void close_image();
     Vector<String> load_files_from_directory(String const& path) const;
 
     String m_path;
     RefPtr<Gfx::Bitmap> m_bitmap;
-    Optional<ImageDecoderClient::DecodedImage> m_decoded_image;
+    RefPtr<ImageDecoderClient::Client> m_decoder_client;
+    Optional<ImageDecoderClient::LazyImage> m_image;
+    // Frames are fetched from the decoder as the animation first reaches them.
+    Vector<ImageDecoderClient::Frame> m_frames;
 
     size_t m_current_frame_index { 0 };
     size_t m_loops_completed { 0 };
@@ -42,21 +42,20 @@ PDFViewer::PDFViewer()
     set_focus_policy(GUI::FocusPolicy::StrongFocus);
     set_scrollbars_enabled(true);
 
-    start_timer(30'000);
-
     m_page_view_mode = static_cast<PageViewMode>(Config::read_i32("PDFViewer"sv, "Display"sv, "PageMode"sv, 0));
 }
 
 PDF::PDFErrorOr<void> PDFViewer::set_document(RefPtr<PDF::Document> document)
 {
+    cancel_pending_renders();
+    m_rendered_pages.clear();
+    m_rendered_page_usage_order.clear();
+    m_rendered_pages_size = 0;
+    m_pages_with_render_errors.clear();
+
     m_document = document;
     m_current_page_index = document->get_first_page_index();
     m_zoom_level = initial_zoom_level;
-    m_rendered_page_list.clear();
-
-    m_rendered_page_list.ensure_capacity(document->get_page_count());
-    for (u32 i = 0; i < document->get_page_count(); i++)
-        m_rendered_page_list.unchecked_append(HashMap<u32, RenderedPage>());
 
     TRY(cache_page_dimensions(true));
     update();
@@ -64,16 +63,134 @@ PDF::PDFErrorOr<void> PDFViewer::set_document(RefPtr<PDF::Document> document)
     return {};
 }
 
-PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> PDFViewer::get_rendered_page(u32 index)
+static PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_page(PDF::Document& document, u32 page_index, Gfx::IntSize page_size, int rotations)
+{
+    auto page = TRY(document.get_page(page_index));
+    auto bitmap = TRY(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, page_size));
+
+    TRY(PDF::Renderer::render(document, page, bitmap));
+
+    if (page.rotate + rotations != 0) {
+        int rotation_count = ((page.rotate + rotations) / 90) % 4;
+        if (rotation_count == 3) {
+            bitmap = TRY(bitmap->rotated(Gfx::RotationDirection::CounterClockwise));
+        } else {
+            for (int i = 0; i < rotation_count; i++)
+                bitmap = TRY(bitmap->rotated(Gfx::RotationDirection::Clockwise));
+        }
+    }
+
+    return bitmap;
+}
+
+PDFViewer::RenderKey PDFViewer::render_key(u32 page_index, u8 zoom_level) const
 {
-    auto& rendered_page_map = m_rendered_page_list[index];
-    auto existing_rendered_page = rendered_page_map.get(m_zoom_level);
-    if (existing_rendered_page.has_value() && existing_rendered_page.value().rotation == m_rotations)
-        return existing_rendered_page.value().bitmap;
-
-    auto rendered_page = TRY(render_page(index));
-    rendered_page_map.set(m_zoom_level, { rendered_page, m_rotations });
-    return rendered_page;
+    return (static_cast<u64>(page_index) << 32) | (static_cast<u64>(zoom_level) << 16) | static_cast<u64>(m_rotations);
+}
+
+RefPtr<Gfx::Bitmap> PDFViewer::get_rendered_page(u32 index)
+{
+    // This does nothing if we already have a rendering of the right size. The size also depends on the size
+    // of the viewer, so even a rendering at the current zoom level might need a refresh.
+    request_render(index);
+
+    auto key = render_key(index, m_zoom_level);
+    if (auto current_zoom_level_match = m_rendered_pages.get(key); current_zoom_level_match.has_value()) {
+        m_rendered_page_usage_order.remove_first_matching([&](auto other_key) { return other_key == key; });
+        m_rendered_page_usage_order.append(key);
+        return current_zoom_level_match.value();
+    }
+
+    // Until the render is done, show the page at the closest zoom level that we have.
+    for (size_t distance = 1; distance < zoom_levels.size(); ++distance) {
+        if (m_zoom_level >= distance) {
+            if (auto bitmap = m_rendered_pages.get(render_key(index, m_zoom_level - distance)); bitmap.has_value())
+                return bitmap.value();
+        }
+        if (m_zoom_level + distance < zoom_levels.size()) {
+            if (auto bitmap = m_rendered_pages.get(render_key(index, m_zoom_level + distance)); bitmap.has_value())
+                return bitmap.value();
+        }
+    }
+    return {};
+}
+
+void PDFViewer::paint_page(GUI::Painter& painter, u32 index, Gfx::IntRect const& rect)
+{
+    auto bitmap = get_rendered_page(index);
+    if (!bitmap) {
+        painter.fill_rect(rect, Color::White);
+        return;
+    }
+
+    if (bitmap->size() == rect.size())
+        painter.blit(rect.location(), *bitmap, bitmap->rect());
+    else
+        painter.draw_scaled_bitmap(rect, *bitmap, bitmap->rect(), 1.0f, Gfx::Painter::ScalingMode::BilinearBlend);
+}
+
+void PDFViewer::request_render(u32 page_index)
+{
+    if (page_index >= m_page_dimension_cache.render_info.size() || m_pages_with_render_errors.contains(page_index))
+        return;
+
+    auto key = render_key(page_index, m_zoom_level);
+    auto page_size = m_page_dimension_cache.render_info[page_index].size.to_type<int>();
+    if (m_pending_renders.contains(key))
+        return;
+    if (auto rendered_page = m_rendered_pages.get(key); rendered_page.has_value() && rendered_page.value()->size() == page_size)
+        return;
+
+    auto action = RenderAction::construct(
+        [document = NonnullRefPtr { *m_document }, page_index, page_size, rotations = m_rotations](auto& action) mutable -> PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> {
+            // The viewer has moved on from this page since it was requested.
+            if (action.is_cancelled())
+                return PDF::Error { PDF::Error::Type::Internal, "Rendering was cancelled" };
+            return render_page(document, page_index, page_size, rotations);
+        },
+        [weak_this = make_weak_ptr<PDFViewer>(), key, page_index, generation = m_render_generation](auto result) mutable {
+            if (!weak_this || weak_this->m_render_generation != generation)
+                return;
+            auto& viewer = *weak_this;
+            viewer.m_pending_renders.remove(key);
+
+            if (result.is_error()) {
+                viewer.m_pages_with_render_errors.set(page_index);
+                GUI::MessageBox::show_error(viewer.window(), String::formatted("Error rendering page:\n{}", result.error().message()));
+                return;
+            }
+
+            viewer.cache_rendered_page(key, result.release_value());
+            viewer.update();
+        });
+    m_pending_renders.set(key, move(action));
+}
+
+void PDFViewer::cancel_pending_renders()
+{
+    for (auto& it : m_pending_renders)
+        it.value->cancel();
+    m_pending_renders.clear();
+    ++m_render_generation;
+}
+
+void PDFViewer::cache_rendered_page(RenderKey key, NonnullRefPtr<Gfx::Bitmap> bitmap)
+{
+    if (auto old_bitmap = m_rendered_pages.get(key); old_bitmap.has_value()) {
+        m_rendered_pages_size -= old_bitmap.value()->size_in_bytes();
+        m_rendered_page_usage_order.remove_first_matching([&](auto other_key) { return other_key == key; });
+    }
+
+    m_rendered_pages_size += bitmap->size_in_bytes();
+    m_rendered_pages.set(key, move(bitmap));
+    m_rendered_page_usage_order.append(key);
+
+    // Never evict the page we just rendered, it's about to be shown.
+    while (m_rendered_pages_size > rendered_pages_budget && m_rendered_page_usage_order.size() > 1) {
+        auto evicted_key = m_rendered_page_usage_order.take_first();
+        m_rendered_pages_size -= m_rendered_pages.get(evicted_key).value()->size_in_bytes();
+        m_rendered_pages.remove(evicted_key);
+    }
 }
 
 void PDFViewer::paint_event(GUI::PaintEvent& event)
@@ -88,30 +205,23 @@ void PDFViewer::paint_event(GUI::PaintEvent& event)
     if (!m_document)
         return;
 
-    auto handle_error = [&]<typename T>(PDF::PDFErrorOr<T> maybe_error) {
-        if (maybe_error.is_error()) {
-            auto error = maybe_error.release_error();
-            GUI::MessageBox::show_error(nullptr, String::formatted("Error rendering page:\n{}", error.message()));
-            return true;
-        }
-        return false;
-    };
-
     if (m_page_view_mode == PageViewMode::Single) {
-        auto maybe_page = get_rendered_page(m_current_page_index);
-        if (handle_error(maybe_page))
-            return;
-
-        auto page = maybe_page.release_value();
-        set_content_size(page->size());
+        auto page_size = m_page_dimension_cache.render_info[m_current_page_index].size.to_type<int>();
+        set_content_size(page_size);
 
         painter.translate(frame_thickness(), frame_thickness());
         painter.translate(-horizontal_scrollbar().value(), -vertical_scrollbar().value());
 
-        int x = max(0, (width() - page->width()) / 2);
-        int y = max(0, (height() - page->height()) / 2);
+        int x = max(0, (width() - page_size.width()) / 2);
+        int y = max(0, (height() - page_size.height()) / 2);
 
-        painter.blit({ x, y }, *page, page->rect());
+        paint_page(painter, m_current_page_index, { { x, y }, page_size });
+
+        // Have the pages that are likely to be shown next ready by the time they are needed.
+        if (m_current_page_index + 1 < m_document->get_page_count())
+            request_render(m_current_page_index + 1);
+        if (m_current_page_index > 0)
+            request_render(m_current_page_index - 1);
         return;
     }
 
@@ -136,16 +246,12 @@ void PDFViewer::paint_event(GUI::PaintEvent& event)
     auto y_offset = initial_offset;
 
     for (size_t page_index = first_page_index; page_index <= last_page_index; page_index++) {
-        auto maybe_page = get_rendered_page(page_index);
-        if (handle_error(maybe_page))
-            return;
-
-        auto page = maybe_page.release_value();
+        auto page_size = m_page_dimension_cache.render_info[page_index].size.to_type<int>();
 
-        auto x = max(0, (width() - page->width()) / 2);
+        auto x = max(0, (width() - page_size.width()) / 2);
 
-        painter.blit({ x, PAGE_PADDING }, *page, page->rect());
-        auto diff_y = page->height() + PAGE_PADDING * 2;
+        paint_page(painter, page_index, { { x, PAGE_PADDING }, page_size });
+        auto diff_y = page_size.height() + PAGE_PADDING * 2;
         painter.translate(0, diff_y);
 
         if (y_offset < middle && y_offset + diff_y >= middle)
@@ -153,6 +259,12 @@ void PDFViewer::paint_event(GUI::PaintEvent& event)
 
         y_offset += diff_y;
     }
+
+    // Have the pages right outside of the view ready by the time they are scrolled to.
+    if (last_page_index + 1 < m_document->get_page_count())
+        request_render(last_page_index + 1);
+    if (first_page_index > 0)
+        request_render(first_page_index - 1);
 }
 
 void PDFViewer::set_current_page(u32 current_page)
@@ -164,8 +276,8 @@ void PDFViewer::set_current_page(u32 current_page)
 
 void PDFViewer::resize_event(GUI::ResizeEvent&)
 {
-    for (auto& map : m_rendered_page_list)
-        map.clear();
+    // The page sizes depend on the size of the viewer. Until the pages are rendered again, we show the old renders scaled to the new size.
+    cancel_pending_renders();
     if (m_document)
         MUST(cache_page_dimensions());
     update();
@@ -245,19 +357,11 @@ void PDFViewer::mousemove_event(GUI::MouseEvent& event)
     }
 }
 
-void PDFViewer::timer_event(Core::TimerEvent&)
-{
-    // Clear the bitmap vector of all pages except the current page
-    for (size_t i = 0; i < m_rendered_page_list.size(); i++) {
-        if (i != m_current_page_index)
-            m_rendered_page_list[i].clear();
-    }
-}
-
 void PDFViewer::zoom_in()
 {
     if (m_zoom_level < zoom_levels.size() - 1) {
         m_zoom_level++;
+        cancel_pending_renders();
         MUST(cache_page_dimensions());
         update();
     }
@@ -267,6 +371,7 @@ void PDFViewer::zoom_out()
 {
     if (m_zoom_level > 0) {
         m_zoom_level--;
+        cancel_pending_renders();
         MUST(cache_page_dimensions());
         update();
     }
@@ -275,6 +380,7 @@ void PDFViewer::zoom_out()
 void PDFViewer::reset_zoom()
 {
     m_zoom_level = initial_zoom_level;
+    cancel_pending_renders();
     MUST(cache_page_dimensions());
     update();
 }
@@ -282,6 +388,7 @@ void PDFViewer::reset_zoom()
 void PDFViewer::rotate(int degrees)
 {
     m_rotations = (m_rotations + degrees + 360) % 360;
+    cancel_pending_renders();
     MUST(cache_page_dimensions());
     update();
 }
@@ -293,27 +400,6 @@ void PDFViewer::set_page_view_mode(PageViewMode mode)
     update();
 }
 
-PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> PDFViewer::render_page(u32 page_index)
-{
-    auto page = TRY(m_document->get_page(page_index));
-    auto& page_size = m_page_dimension_cache.render_info[page_index].size;
-    auto bitmap = TRY(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, page_size.to_type<int>()));
-
-    TRY(PDF::Renderer::render(*m_document, page, bitmap));
-
-    if (page.rotate + m_rotations != 0) {
-        int rotation_count = ((page.rotate + m_rotations) / 90) % 4;
-        if (rotation_count == 3) {
-            bitmap = TRY(bitmap->rotated(Gfx::RotationDirection::CounterClockwise));
-        } else {
-            for (int i = 0; i < rotation_count; i++)
-                bitmap = TRY(bitmap->rotated(Gfx::RotationDirection::Clockwise));
-        }
-    }
-
-    return bitmap;
-}
-
 PDF::PDFErrorOr<void> PDFViewer::cache_page_dimensions(bool recalculate_fixed_info)
 {
     if (recalculate_fixed_info)
@@ -8,9 +8,11 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <LibGUI/AbstractScrollableWidget.h>
 #include <LibGfx/Bitmap.h>
 #include <LibPDF/Document.h>
+#include <LibThreading/BackgroundAction.h>
 
 static constexpr size_t initial_zoom_level = 8;
 
@@ -70,22 +72,37 @@ protected:
     virtual void mousedown_event(GUI::MouseEvent&) override;
     virtual void mouseup_event(GUI::MouseEvent&) override;
     virtual void mousemove_event(GUI::MouseEvent&) override;
-    virtual void timer_event(Core::TimerEvent&) override;
 
 private:
-    struct RenderedPage {
-        NonnullRefPtr<Gfx::Bitmap> bitmap;
-        int rotation;
-    };
-
-    PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> get_rendered_page(u32 index);
-    PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_page(u32 page_index);
+    using RenderAction = Threading::BackgroundAction<PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>>>;
+
+    // Identifies a rendering of a page at a given zoom level and rotation.
+    using RenderKey = u64;
+    RenderKey render_key(u32 page_index, u8 zoom_level) const;
+
+    // Returns the best rendering of the page we currently have, which may be a rendering at another
+    // zoom level that needs to be scaled. Unless we have an exact match, a render will be requested.
+    RefPtr<Gfx::Bitmap> get_rendered_page(u32 index);
+    void paint_page(GUI::Painter&, u32 index, Gfx::IntRect const&);
+    void request_render(u32 page_index);
+    void cancel_pending_renders();
+    void cache_rendered_page(RenderKey, NonnullRefPtr<Gfx::Bitmap>);
     PDF::PDFErrorOr<void> cache_page_dimensions(bool recalculate_fixed_info = false);
     void change_page(u32 new_page);
 
     RefPtr<PDF::Document> m_document;
     u32 m_current_page_index { 0 };
-    Vector<HashMap<u32, RenderedPage>> m_rendered_page_list;
+
+    // Rendered pages are kept around until they exceed this budget, at which point the least recently used ones are dropped.
+    static constexpr size_t rendered_pages_budget = 192 * MiB;
+    HashMap<RenderKey, NonnullRefPtr<Gfx::Bitmap>> m_rendered_pages;
+    Vector<RenderKey> m_rendered_page_usage_order;
+    size_t m_rendered_pages_size { 0 };
+
+    // All renders happen on the background thread, which is also the only thread that touches the document after it has been set.
+    HashMap<RenderKey, NonnullRefPtr<RenderAction>> m_pending_renders;
+    u32 m_render_generation { 0 };
+    HashTable<u32> m_pages_with_render_errors;
 
     u8 m_zoom_level { initial_zoom_level };
     PageDimensionCache m_page_dimension_cache;
@@ -32,6 +32,7 @@ void Cell::set_data(String new_data)
     m_data = move(new_data);
     m_dirty = true;
     m_evaluated_externally = false;
+    m_parsed_formula = nullptr;
 }
 
 void Cell::set_data(JS::Value new_data)
@@ -43,6 +44,7 @@ void Cell::set_data(JS::Value new_data)
 
     builder.append(new_data.to_string_without_side_effects());
     m_data = builder.build();
+    m_parsed_formula = nullptr;
 
     m_evaluated_data = move(new_data);
 }
@@ -96,26 +98,17 @@ void Cell::update_data(Badge<Sheet>)
     if (!m_dirty)
         return;
 
-    if (m_dirty) {
-        m_dirty = false;
-        if (m_kind == Formula) {
-            if (!m_evaluated_externally) {
-                auto value_or_error = m_sheet->evaluate(m_data, this);
-                if (value_or_error.is_error()) {
-                    m_evaluated_data = JS::js_undefined();
-                    m_thrown_value = *value_or_error.release_error().release_value();
-                } else {
-                    m_evaluated_data = value_or_error.release_value();
-                    m_thrown_value = {};
-                }
-            }
-        }
-
-        for (auto& ref : m_referencing_cells) {
-            if (ref) {
-                ref->m_dirty = true;
-                ref->update();
-            }
+    m_dirty = false;
+    if (m_kind == Formula && !m_evaluated_externally) {
+        // NOTE: The references are recorded again as the formula runs, which drops the ones it no longer makes.
+        clear_references();
+        auto value_or_error = evaluate_formula();
+        if (value_or_error.is_error()) {
+            m_evaluated_data = JS::js_undefined();
+            m_thrown_value = *value_or_error.release_error().release_value();
+        } else {
+            m_evaluated_data = value_or_error.release_value();
+            m_thrown_value = {};
         }
     }
 
@@ -140,6 +133,13 @@ void Cell::update_data(Badge<Sheet>)
     }
 }
 
+JS::ThrowCompletionOr<JS::Value> Cell::evaluate_formula()
+{
+    if (!m_parsed_formula)
+        m_parsed_formula = TRY(m_sheet->parse(m_data, this));
+    return m_sheet->run(*m_parsed_formula, this);
+}
+
 void Cell::update()
 {
     m_sheet->update(*this);
@@ -175,6 +175,16 @@ void Cell::reference_from(Cell* other)
         return;
 
     m_referencing_cells.append(other->make_weak_ptr());
+    other->m_referenced_cells.append(make_weak_ptr());
+}
+
+void Cell::clear_references()
+{
+    for (auto& referenced_cell : m_referenced_cells) {
+        if (referenced_cell)
+            referenced_cell->m_referencing_cells.remove_first_matching([this](auto const& ptr) { return ptr.ptr() == this; });
+    }
+    m_referenced_cells.clear();
 }
 
 void Cell::copy_from(Cell const& other)
@@ -189,6 +199,7 @@ void Cell::copy_from(Cell const& other)
     m_conditional_formats = other.m_conditional_formats;
     m_evaluated_formats = other.m_evaluated_formats;
     m_thrown_value = other.m_thrown_value;
+    m_parsed_formula = nullptr;
 }
 
 }
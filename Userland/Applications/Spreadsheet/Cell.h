@@ -15,6 +15,7 @@
 #include <AK/Types.h>
 #include <AK/WeakPtr.h>
 #include <LibGUI/Command.h>
+#include <LibJS/Heap/GCPtr.h>
 
 namespace Spreadsheet {
 
@@ -48,6 +49,7 @@ struct Cell : public Weakable<Cell> {
     void set_data(String new_data);
     void set_data(JS::Value new_data);
     bool dirty() const { return m_dirty; }
+    void mark_dirty() { m_dirty = true; }
     void clear_dirty() { m_dirty = false; }
 
     StringView name_for_javascript(Sheet const& sheet) const
@@ -71,6 +73,8 @@ struct Cell : public Weakable<Cell> {
     const JS::Value& evaluated_data() const { return m_evaluated_data; }
     Kind kind() const { return m_kind; }
     Vector<WeakPtr<Cell>> const& referencing_cells() const { return m_referencing_cells; }
+    Vector<WeakPtr<Cell>> const& referenced_cells() const { return m_referenced_cells; }
+    JS::GCPtr<JS::Script> parsed_formula() const { return m_parsed_formula; }
 
     void set_type(StringView name);
     void set_type(CellType const*);
@@ -82,6 +86,8 @@ struct Cell : public Weakable<Cell> {
         if (position != m_position) {
             m_dirty = true;
             m_position = move(position);
+            m_name_for_javascript = {};
+            m_parsed_formula = nullptr;
         }
     }
 
@@ -114,6 +120,9 @@ struct Cell : public Weakable<Cell> {
     void copy_from(Cell const&);
 
 private:
+    JS::ThrowCompletionOr<JS::Value> evaluate_formula();
+    void clear_references();
+
     bool m_dirty { false };
     bool m_evaluated_externally { false };
     String m_data;
@@ -121,7 +130,11 @@ private:
     JS::Value m_thrown_value;
     Kind m_kind { LiteralString };
     WeakPtr<Sheet> m_sheet;
+    // The cells whose values depend on ours, and the cells ours depends on.
     Vector<WeakPtr<Cell>> m_referencing_cells;
+    Vector<WeakPtr<Cell>> m_referenced_cells;
+    // The formula is only parsed again once it changes.
+    JS::GCPtr<JS::Script> m_parsed_formula;
     CellType const* m_type { nullptr };
     CellTypeMetadata m_type_metadata;
     Position m_position;
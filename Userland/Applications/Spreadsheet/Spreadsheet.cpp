@@ -127,21 +127,17 @@ void Sheet::update()
         m_update_requested = true;
         return;
     }
-    m_visited_cells_in_update.clear();
-    Vector<Cell&> cells_copy;
+    Vector<Cell&> dirty_cells;
 
     // Grab a copy as updates might insert cells into the table.
     for (auto& it : m_cells) {
         if (it.value->dirty()) {
-            cells_copy.append(*it.value);
+            dirty_cells.append(*it.value);
             m_workbook.set_dirty(true);
         }
     }
 
-    for (auto& cell : cells_copy)
-        update(cell);
-
-    m_visited_cells_in_update.clear();
+    update_in_dependency_order(dirty_cells);
 }
 
 void Sheet::update(Cell& cell)
@@ -150,21 +146,78 @@ void Sheet::update(Cell& cell)
         m_update_requested = true;
         return;
     }
-    if (cell.dirty()) {
-        if (has_been_visited(&cell)) {
-            // This may be part of an cyclic reference chain,
-            // so just ignore it.
-            cell.clear_dirty();
-            return;
+    if (!cell.dirty())
+        return;
+
+    // A cell that is being evaluated needs this one's value right away, only cyclic references get here.
+    if (m_is_updating_in_dependency_order) {
+        update_data_once(cell);
+        return;
+    }
+
+    Vector<Cell&> changed_cells;
+    changed_cells.append(cell);
+    update_in_dependency_order(changed_cells);
+}
+
+void Sheet::update_in_dependency_order(Vector<Cell&>& changed_cells)
+{
+    TemporaryChange updating_change { m_is_updating_in_dependency_order, true };
+    m_visited_cells_in_update.clear();
+
+    // Collect everything that depends on the changed cells in post-order, so that the reverse of it has
+    // every cell after all of the cells it depends on, and each of them only has to be evaluated once.
+    struct DependentsToVisit {
+        Cell* cell;
+        size_t next_dependent_index;
+    };
+    Vector<Cell&> post_order;
+    HashTable<Cell*> seen_cells;
+    Vector<DependentsToVisit> stack;
+    for (auto& changed_cell : changed_cells) {
+        if (seen_cells.set(&changed_cell) != AK::HashSetResult::InsertedNewEntry)
+            continue;
+        stack.append(DependentsToVisit { &changed_cell, 0 });
+        while (!stack.is_empty()) {
+            auto& top = stack.last();
+            auto& dependents = top.cell->referencing_cells();
+            if (top.next_dependent_index < dependents.size()) {
+                auto& dependent = dependents[top.next_dependent_index++];
+                if (dependent && seen_cells.set(dependent.ptr()) == AK::HashSetResult::InsertedNewEntry)
+                    stack.append(DependentsToVisit { dependent.ptr(), 0 });
+                continue;
+            }
+            post_order.append(*top.cell);
+            stack.take_last();
         }
-        m_visited_cells_in_update.set(&cell);
-        cell.update_data({});
     }
+
+    // Everything is marked first, so that members of a reference cycle see each other as out of date.
+    for (auto& cell : post_order)
+        cell.mark_dirty();
+
+    for (size_t i = post_order.size(); i > 0; --i)
+        update_data_once(post_order[i - 1]);
+
+    m_visited_cells_in_update.clear();
+}
+
+void Sheet::update_data_once(Cell& cell)
+{
+    if (!cell.dirty())
+        return;
+    if (has_been_visited(&cell)) {
+        // This may be part of an cyclic reference chain,
+        // so just ignore it.
+        cell.clear_dirty();
+        return;
+    }
+    m_visited_cells_in_update.set(&cell);
+    cell.update_data({});
 }
 
-JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_behalf_of)
+JS::ThrowCompletionOr<JS::NonnullGCPtr<JS::Script>> Sheet::parse(StringView source, Cell* on_behalf_of)
 {
-    TemporaryChange cell_change { m_current_cell_being_evaluated, on_behalf_of };
     auto name = on_behalf_of ? on_behalf_of->name_for_javascript(*this) : "cell <unknown>"sv;
     auto script_or_error = JS::Script::parse(
         source,
@@ -174,7 +227,19 @@ JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_beh
     if (script_or_error.is_error())
         return interpreter().vm().throw_completion<JS::SyntaxError>(script_or_error.error().first().to_string());
 
-    return interpreter().run(script_or_error.value());
+    return script_or_error.release_value();
+}
+
+JS::ThrowCompletionOr<JS::Value> Sheet::run(JS::Script& script, Cell* on_behalf_of)
+{
+    TemporaryChange cell_change { m_current_cell_being_evaluated, on_behalf_of };
+    return interpreter().run(script);
+}
+
+JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_behalf_of)
+{
+    auto script = TRY(parse(source, on_behalf_of));
+    return run(*script, on_behalf_of);
 }
 
 Cell* Sheet::at(StringView name)
@@ -121,6 +121,8 @@ public:
         }
     }
 
+    JS::ThrowCompletionOr<JS::NonnullGCPtr<JS::Script>> parse(StringView, Cell* = nullptr);
+    JS::ThrowCompletionOr<JS::Value> run(JS::Script&, Cell* = nullptr);
     JS::ThrowCompletionOr<JS::Value> evaluate(StringView, Cell* = nullptr);
     JS::Interpreter& interpreter() const;
     SheetGlobalObject& global_object() const { return *m_global_object; }
@@ -148,6 +150,10 @@ private:
     explicit Sheet(Workbook&);
     explicit Sheet(StringView name, Workbook&);
 
+    // Evaluates the changed cells and everything that depends on them, each cell after the ones it depends on.
+    void update_in_dependency_order(Vector<Cell&>& changed_cells);
+    void update_data_once(Cell&);
+
     String m_name;
     Vector<String> m_columns;
     size_t m_rows { 0 };
@@ -162,6 +168,7 @@ private:
     Cell* m_current_cell_being_evaluated { nullptr };
 
     HashTable<Cell*> m_visited_cells_in_update;
+    bool m_is_updating_in_dependency_order { false };
     bool m_should_ignore_updates { false };
     bool m_update_requested { false };
     mutable Optional<JsonObject> m_cached_documentation;
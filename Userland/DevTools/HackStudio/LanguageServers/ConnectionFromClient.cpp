@@ -24,6 +24,8 @@ ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSock
 void ConnectionFromClient::die()
 {
     s_connections.remove(client_id());
+    // The engine may have something left to write out to disk.
+    m_autocomplete_engine = nullptr;
     exit(0);
 }
 
@@ -18,7 +18,9 @@ private:
     ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSocket> socket)
         : LanguageServers::ConnectionFromClient(move(socket))
     {
-        m_autocomplete_engine = adopt_own(*new CodeComprehension::Cpp::CppComprehensionEngine(m_filedb));
+        auto engine = adopt_own(*new CodeComprehension::Cpp::CppComprehensionEngine(m_filedb));
+        engine->set_symbol_index_enabled(true);
+        m_autocomplete_engine = move(engine);
         m_autocomplete_engine->set_declarations_of_document_callback = [this](String const& filename, Vector<CodeComprehension::Declaration>&& declarations) {
             async_declarations_in_document(filename, move(declarations));
         };
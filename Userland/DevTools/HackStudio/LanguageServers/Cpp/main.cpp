@@ -5,7 +5,9 @@
  */
 
 #include "ConnectionFromClient.h"
+#include <LibCodeComprehension/SymbolIndex.h>
 #include <LibCore/ArgsParser.h>
+#include <LibCore/Directory.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
 #include <LibCore/System.h>
@@ -15,13 +17,18 @@
 ErrorOr<int> serenity_main(Main::Arguments)
 {
     Core::EventLoop event_loop;
-    TRY(Core::System::pledge("stdio unix recvfd rpath"));
+    TRY(Core::System::pledge("stdio unix recvfd rpath wpath cpath"));
 
     auto client = TRY(IPC::take_over_accepted_client_from_system_server<LanguageServers::Cpp::ConnectionFromClient>());
 
-    TRY(Core::System::pledge("stdio recvfd rpath"));
+    TRY(Core::System::pledge("stdio recvfd rpath wpath cpath"));
     TRY(Core::System::unveil("/usr/include", "r"));
 
+    auto symbol_index_directory = CodeComprehension::SymbolIndex::directory();
+    if (auto result = Core::Directory::create(symbol_index_directory, Core::Directory::CreateDirectories::Yes); result.is_error())
+        dbgln("Unable to create {}, the symbol index won't be saved: {}", symbol_index_directory, result.error());
+    TRY(Core::System::unveil(symbol_index_directory, "rwc"sv));
+
     // unveil will be sealed later, when we know the project's root path.
     return event_loop.exec();
 }
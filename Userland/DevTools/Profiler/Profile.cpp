@@ -33,6 +33,24 @@ static void sort_profile_nodes(Vector<NonnullRefPtr<ProfileNode>>& nodes)
         child->sort_children();
 }
 
+static bool is_cycle_or_instruction_counter(PerformanceCounter counter)
+{
+    return counter == PerformanceCounter::CPUCycles || counter == PerformanceCounter::InstructionsRetired;
+}
+
+static Optional<PerformanceCounter> performance_counter_from_event_type(StringView type)
+{
+    if (type == "cpu_cycles"sv)
+        return PerformanceCounter::CPUCycles;
+    if (type == "instructions_retired"sv)
+        return PerformanceCounter::InstructionsRetired;
+    if (type == "cache_misses"sv)
+        return PerformanceCounter::CacheMisses;
+    if (type == "branch_misses"sv)
+        return PerformanceCounter::BranchMisses;
+    return {};
+}
+
 Profile::Profile(Vector<Process> processes, Vector<Event> events)
     : m_processes(move(processes))
     , m_events(move(events))
@@ -46,6 +64,8 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     m_first_timestamp = m_events.first().timestamp;
     m_last_timestamp = m_events.last().timestamp;
 
+    build_event_buckets();
+
     m_model = ProfileModel::create(*this);
     m_samples_model = SamplesModel::create(*this);
     m_signposts_model = SignpostsModel::create(*this);
@@ -54,6 +74,76 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     rebuild_tree();
 }
 
+namespace {
+
+struct EventStack {
+    Process const* process { nullptr };
+    Span<Profile::Frame const> frames;
+};
+
+struct EventStackTraits : public GenericTraits<EventStack> {
+    static unsigned hash(EventStack const& stack)
+    {
+        unsigned hash = ptr_hash(stack.process);
+        for (auto const& frame : stack.frames)
+            hash = pair_int_hash(hash, pair_int_hash(ptr_hash(frame.address), Traits<String>::hash(frame.symbol)));
+        return hash;
+    }
+
+    static bool equals(EventStack const& a, EventStack const& b)
+    {
+        if (a.process != b.process || a.frames.size() != b.frames.size())
+            return false;
+        for (size_t i = 0; i < a.frames.size(); ++i) {
+            auto const& a_frame = a.frames[i];
+            auto const& b_frame = b.frames[i];
+            if (a_frame.address != b_frame.address || a_frame.offset != b_frame.offset || a_frame.symbol != b_frame.symbol)
+                return false;
+        }
+        return true;
+    }
+};
+
+}
+
+void Profile::build_event_buckets()
+{
+    Process const* last_process = nullptr;
+    auto process_of = [&](Event const& event) {
+        // Samples mostly come in runs from the same process, so don't look it up for every one of them.
+        if (!last_process || last_process->pid != event.pid || !last_process->valid_at(event.serial))
+            last_process = find_process(event.pid, event.serial);
+        return last_process;
+    };
+
+    HashMap<EventStack, size_t, EventStackTraits> stack_indices;
+    for (size_t bucket_start = 0; bucket_start < m_events.size(); bucket_start += events_per_bucket) {
+        auto bucket_end = min(bucket_start + events_per_bucket, m_events.size());
+        EventBucket bucket {
+            .first_timestamp = m_events[bucket_start].timestamp,
+            .last_timestamp = m_events[bucket_start].timestamp,
+            .stacks = {},
+        };
+        stack_indices.clear_with_capacity();
+
+        for (size_t event_index = bucket_start; event_index < bucket_end; ++event_index) {
+            auto const& event = m_events[event_index];
+            bucket.first_timestamp = min(bucket.first_timestamp, event.timestamp);
+            bucket.last_timestamp = max(bucket.last_timestamp, event.timestamp);
+            if (!event.data.has<Event::SampleData>())
+                continue;
+
+            auto stack_index = stack_indices.ensure(EventStack { process_of(event), event.frames.span() }, [&] {
+                bucket.stacks.append({ event_index, 0 });
+                return bucket.stacks.size() - 1;
+            });
+            ++bucket.stacks[stack_index].sample_count;
+        }
+
+        m_event_buckets.append(move(bucket));
+    }
+}
+
 GUI::Model& Profile::model()
 {
     return *m_model;
@@ -103,9 +193,70 @@ void Profile::rebuild_tree()
 
     m_filtered_event_indices.clear();
     m_filtered_signpost_indices.clear();
+    m_filtered_event_weight = 0;
     m_file_event_nodes->children().clear();
 
+    auto bucket_is_inside_filter_range = [&](EventBucket const& bucket) {
+        if (!has_timestamp_filter_range())
+            return true;
+        return bucket.first_timestamp >= m_timestamp_filter_range_start && bucket.last_timestamp <= m_timestamp_filter_range_end;
+    };
+    auto bucket_is_outside_filter_range = [&](EventBucket const& bucket) {
+        if (!has_timestamp_filter_range())
+            return false;
+        return bucket.last_timestamp < m_timestamp_filter_range_start || bucket.first_timestamp > m_timestamp_filter_range_end;
+    };
+
+    // When weighting by events, all samples of a stack add up the same way, so they can be added to the tree one stack at a time.
+    bool const use_event_buckets = m_weighting == Weighting::Events && !m_show_top_functions;
+
+    auto count_event = [](ProfileNode& node, u64 weight, Event::PerformanceCounterData const* counter_data) {
+        node.increment_event_count(weight);
+        if (counter_data)
+            node.add_performance_counter_period(counter_data->counter, counter_data->period);
+    };
+
+    auto add_to_call_tree = [&](Event const& event, u64 weight, Event::PerformanceCounterData const* counter_data) {
+        ProfileNode* node = nullptr;
+        auto& process_node = find_or_create_process_node(event.pid, event.serial);
+        count_event(process_node, weight, counter_data);
+
+        auto add_frame = [&](Frame const& frame, bool is_innermost_frame) {
+            if (frame.symbol.is_empty())
+                return IterationDecision::Break;
+
+            // FIXME: More cheating with intentional mixing of TID/PID here:
+            if (!node)
+                node = &process_node;
+            node = &node->find_or_create_child(frame.object_name, frame.symbol, frame.address, frame.offset, event.timestamp, event.pid);
+
+            count_event(*node, weight, counter_data);
+            if (is_innermost_frame) {
+                node->add_event_address(frame.address, weight);
+                node->increment_self_count(weight);
+            }
+            return IterationDecision::Continue;
+        };
+
+        if (!m_inverted) {
+            for (size_t i = 0; i < event.frames.size(); ++i) {
+                if (add_frame(event.frames.at(i), i == event.frames.size() - 1) == IterationDecision::Break)
+                    break;
+            }
+        } else {
+            for (ssize_t i = event.frames.size() - 1; i >= 0; --i) {
+                if (add_frame(event.frames.at(i), static_cast<size_t>(i) == event.frames.size() - 1) == IterationDecision::Break)
+                    break;
+            }
+        }
+    };
+
     for (size_t event_index = 0; event_index < m_events.size(); ++event_index) {
+        if (event_index % events_per_bucket == 0 && bucket_is_outside_filter_range(m_event_buckets[event_index / events_per_bucket])) {
+            event_index += events_per_bucket - 1;
+            continue;
+        }
+
         auto& event = m_events.at(event_index);
 
         if (has_timestamp_filter_range()) {
@@ -122,56 +273,55 @@ void Profile::rebuild_tree()
             continue;
         }
 
+        // Lock waits are shown on the timeline, they aren't samples.
+        if (event.data.has<Event::LockWaitData>())
+            continue;
+
         m_filtered_event_indices.append(event_index);
 
-        if (auto* malloc_data = event.data.get_pointer<Event::MallocData>(); malloc_data && !live_allocations.contains(malloc_data->ptr))
-            continue;
+        u64 weight = 1;
+        auto* malloc_data = event.data.get_pointer<Event::MallocData>();
+        auto* counter_data = event.data.get_pointer<Event::PerformanceCounterData>();
+        if (auto weighted_counter = weighted_performance_counter(); weighted_counter.has_value()) {
+            if (!counter_data)
+                continue;
+            if (counter_data->counter == weighted_counter.value())
+                weight = counter_data->period;
+            else if (is_cycle_or_instruction_counter(counter_data->counter) && is_cycle_or_instruction_counter(weighted_counter.value()))
+                weight = 0;
+            else
+                continue;
+            m_filtered_event_weight += weight;
+        } else if (m_weighting == Weighting::Events) {
+            // Counter overflows aren't samples, they are only shown when weighting by their counter.
+            if (counter_data)
+                continue;
 
-        if (event.data.has<Event::FreeData>())
-            continue;
+            m_filtered_event_weight += weight;
 
-        auto for_each_frame = [&]<typename Callback>(Callback callback) {
-            if (!m_inverted) {
-                for (size_t i = 0; i < event.frames.size(); ++i) {
-                    if (callback(event.frames.at(i), i == event.frames.size() - 1) == IterationDecision::Break)
-                        break;
-                }
-            } else {
-                for (ssize_t i = event.frames.size() - 1; i >= 0; --i) {
-                    if (callback(event.frames.at(i), static_cast<size_t>(i) == event.frames.size() - 1) == IterationDecision::Break)
-                        break;
-                }
-            }
-        };
+            if (malloc_data && !live_allocations.contains(malloc_data->ptr))
+                continue;
+
+            if (event.data.has<Event::FreeData>())
+                continue;
+        } else {
+            if (!malloc_data)
+                continue;
+            if (m_weighting == Weighting::LiveHeapBytes && !live_allocations.contains(malloc_data->ptr))
+                continue;
+            weight = malloc_data->size;
+            m_filtered_event_weight += weight;
+        }
+
+        // This sample is added along with the rest of its bucket below.
+        if (use_event_buckets && event.data.has<Event::SampleData>() && bucket_is_inside_filter_range(m_event_buckets[event_index / events_per_bucket]))
+            continue;
 
         if (!m_show_top_functions) {
-            ProfileNode* node = nullptr;
-            auto& process_node = find_or_create_process_node(event.pid, event.serial);
-            process_node.increment_event_count();
-            for_each_frame([&](Frame const& frame, bool is_innermost_frame) {
-                auto const& object_name = frame.object_name;
-                auto const& symbol = frame.symbol;
-                auto const& address = frame.address;
-                auto const& offset = frame.offset;
-
-                if (symbol.is_empty())
-                    return IterationDecision::Break;
-
-                // FIXME: More cheating with intentional mixing of TID/PID here:
-                if (!node)
-                    node = &process_node;
-                node = &node->find_or_create_child(object_name, symbol, address, offset, event.timestamp, event.pid);
-
-                node->increment_event_count();
-                if (is_innermost_frame) {
-                    node->add_event_address(address);
-                    node->increment_self_count();
-                }
-                return IterationDecision::Continue;
-            });
+            add_to_call_tree(event, weight, counter_data);
         } else {
             auto& process_node = find_or_create_process_node(event.pid, event.serial);
-            process_node.increment_event_count();
+            count_event(process_node, weight, counter_data);
             for (size_t i = 0; i < event.frames.size(); ++i) {
                 ProfileNode* node = nullptr;
                 ProfileNode* root = nullptr;
@@ -196,14 +346,14 @@ void Profile::rebuild_tree()
 
                     if (!root->has_seen_event(event_index)) {
                         root->did_see_event(event_index);
-                        root->increment_event_count();
+                        count_event(*root, weight, counter_data);
                     } else if (node != root) {
-                        node->increment_event_count();
+                        count_event(*node, weight, counter_data);
                     }
 
                     if (j == event.frames.size() - 1) {
-                        node->add_event_address(address);
-                        node->increment_self_count();
+                        node->add_event_address(address, weight);
+                        node->increment_self_count(weight);
                     }
                 }
             }
@@ -225,6 +375,19 @@ void Profile::rebuild_tree()
         }
     }
 
+    if (use_event_buckets) {
+        for (auto const& bucket : m_event_buckets) {
+            if (!bucket_is_inside_filter_range(bucket))
+                continue;
+            for (auto const& stack : bucket.stacks) {
+                // NOTE: Process filters cover whole processes, and all samples of a stack come from the same one.
+                auto const& event = m_events[stack.event_index];
+                if (process_filter_contains(event.pid, event.serial))
+                    add_to_call_tree(event, stack.sample_count, nullptr);
+            }
+        }
+    }
+
     sort_profile_nodes(roots);
 
     m_roots = move(roots);
@@ -396,6 +559,17 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
                 .start_timestamp = perf_event.get("start_timestamp"sv).to_number<size_t>(),
                 .success = perf_event.get("success"sv).to_bool()
             };
+        } else if (type_string == "lock_wait"sv) {
+            event.data = Event::LockWaitData {
+                .name = perf_event.get("name"sv).to_string(),
+                .lock = perf_event.get("lock"sv).to_number<FlatPtr>(),
+                .wait_time_ns = perf_event.get("wait_time_ns"sv).to_number<u64>(),
+            };
+        } else if (auto counter = performance_counter_from_event_type(type_string); counter.has_value()) {
+            event.data = Event::PerformanceCounterData {
+                .counter = counter.value(),
+                .period = perf_event.get("period"sv).to_number<u64>(),
+            };
         } else {
             dbgln("Unknown event type '{}'", type_string);
             VERIFY_NOT_REACHED();
@@ -406,8 +580,21 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
         auto const* stack = perf_event.get_ptr("stack"sv);
         VERIFY(stack);
         auto const& stack_array = stack->as_array();
+        bool has_javascript_frames = false;
         for (ssize_t i = stack_array.values().size() - 1; i >= 0; --i) {
             auto const& frame = stack_array.at(i);
+
+            // Profiles written by LibJS' SamplingProfiler describe JavaScript frames with an object instead of an address.
+            if (frame.is_object()) {
+                static FlyString const javascript_object_name = "JavaScript"sv;
+                auto const& frame_object = frame.as_object();
+                auto string_id = frame_object.get("symbol"sv).to_number<FlatPtr>();
+                auto symbol = profile_strings.get(string_id).value_or(String::formatted("JavaScript frame #{}", string_id));
+                event.frames.append({ javascript_object_name, move(symbol), 0, frame_object.get("offset"sv).to_number<u32>() });
+                has_javascript_frames = true;
+                continue;
+            }
+
             auto ptr = frame.to_number<u64>();
             u32 offset = 0;
             FlyString object_name;
@@ -436,11 +623,17 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
             event.frames.append({ object_name, symbol, (FlatPtr)ptr, offset });
         }
 
-        if (event.frames.size() < 2)
-            continue;
+        if (has_javascript_frames) {
+            if (event.frames.is_empty())
+                continue;
+            event.in_kernel = false;
+        } else {
+            if (event.frames.size() < 2)
+                continue;
 
-        FlatPtr innermost_frame_address = event.frames.at(1).address;
-        event.in_kernel = maybe_kernel_base.has_value() && innermost_frame_address >= maybe_kernel_base.value();
+            FlatPtr innermost_frame_address = event.frames.at(1).address;
+            event.in_kernel = maybe_kernel_base.has_value() && innermost_frame_address >= maybe_kernel_base.value();
+        }
 
         events.append(move(event));
     }
@@ -558,6 +751,50 @@ void Profile::set_show_top_functions(bool show)
     rebuild_tree();
 }
 
+void Profile::set_weighting(Weighting weighting)
+{
+    if (m_weighting == weighting)
+        return;
+    m_weighting = weighting;
+    rebuild_tree();
+}
+
+Optional<PerformanceCounter> Profile::weighted_performance_counter() const
+{
+    switch (m_weighting) {
+    case Weighting::CPUCycles:
+        return PerformanceCounter::CPUCycles;
+    case Weighting::InstructionsRetired:
+        return PerformanceCounter::InstructionsRetired;
+    case Weighting::CacheMisses:
+        return PerformanceCounter::CacheMisses;
+    case Weighting::BranchMisses:
+        return PerformanceCounter::BranchMisses;
+    default:
+        return {};
+    }
+}
+
+StringView Profile::weight_name() const
+{
+    switch (m_weighting) {
+    case Weighting::Events:
+        return "Samples"sv;
+    case Weighting::LiveHeapBytes:
+    case Weighting::AllocatedBytes:
+        return "Bytes"sv;
+    case Weighting::CPUCycles:
+        return "Cycles"sv;
+    case Weighting::InstructionsRetired:
+        return "Instructions"sv;
+    case Weighting::CacheMisses:
+        return "Cache Misses"sv;
+    case Weighting::BranchMisses:
+        return "Branch Misses"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
 void Profile::set_show_percentages(bool show_percentages)
 {
     if (m_show_percentages == show_percentages)
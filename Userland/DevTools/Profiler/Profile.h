@@ -32,6 +32,14 @@ namespace Profiler {
 extern Optional<MappedObject> g_kernel_debuginfo_object;
 extern OwnPtr<Debug::DebugInfo> g_kernel_debug_info;
 
+// The hardware events that are sampled whenever a performance counter overflows.
+enum class PerformanceCounter {
+    CPUCycles,
+    InstructionsRetired,
+    CacheMisses,
+    BranchMisses,
+};
+
 class ProfileNode : public RefCounted<ProfileNode> {
 public:
     static NonnullRefPtr<ProfileNode> create(Process const& process, FlyString const& object_name, String symbol, FlatPtr address, u32 offset, u64 timestamp, pid_t pid)
@@ -59,8 +67,8 @@ public:
     u32 offset() const { return m_offset; }
     u64 timestamp() const { return m_timestamp; }
 
-    u32 event_count() const { return m_event_count; }
-    u32 self_count() const { return m_self_count; }
+    u64 event_count() const { return m_event_count; }
+    u64 self_count() const { return m_self_count; }
 
     int child_count() const { return m_children.size(); }
     Vector<NonnullRefPtr<ProfileNode>> const& children() const { return m_children; }
@@ -90,19 +98,30 @@ public:
     ProfileNode* parent() { return m_parent; }
     ProfileNode const* parent() const { return m_parent; }
 
-    void increment_event_count() { ++m_event_count; }
-    void increment_self_count() { ++m_self_count; }
+    void increment_event_count(u64 weight = 1) { m_event_count += weight; }
+    void increment_self_count(u64 weight = 1) { m_self_count += weight; }
+
+    // Inclusive counts from the cycle and instruction counters, for computing instructions per cycle.
+    u64 cpu_cycles() const { return m_cpu_cycles; }
+    u64 instructions_retired() const { return m_instructions_retired; }
+    void add_performance_counter_period(PerformanceCounter counter, u64 period)
+    {
+        if (counter == PerformanceCounter::CPUCycles)
+            m_cpu_cycles += period;
+        else if (counter == PerformanceCounter::InstructionsRetired)
+            m_instructions_retired += period;
+    }
 
     void sort_children();
 
-    HashMap<FlatPtr, size_t> const& events_per_address() const { return m_events_per_address; }
-    void add_event_address(FlatPtr address)
+    HashMap<FlatPtr, u64> const& events_per_address() const { return m_events_per_address; }
+    void add_event_address(FlatPtr address, u64 weight = 1)
     {
         auto it = m_events_per_address.find(address);
         if (it == m_events_per_address.end())
-            m_events_per_address.set(address, 1);
+            m_events_per_address.set(address, weight);
         else
-            m_events_per_address.set(address, it->value + 1);
+            m_events_per_address.set(address, it->value + weight);
     }
 
     pid_t pid() const { return m_pid; }
@@ -122,11 +141,13 @@ private:
     pid_t m_pid { 0 };
     FlatPtr m_address { 0 };
     u32 m_offset { 0 };
-    u32 m_event_count { 0 };
-    u32 m_self_count { 0 };
+    u64 m_event_count { 0 };
+    u64 m_self_count { 0 };
+    u64 m_cpu_cycles { 0 };
+    u64 m_instructions_retired { 0 };
     u64 m_timestamp { 0 };
     Vector<NonnullRefPtr<ProfileNode>> m_children;
-    HashMap<FlatPtr, size_t> m_events_per_address;
+    HashMap<FlatPtr, u64> m_events_per_address;
     Bitmap m_seen_events;
 };
 
@@ -231,7 +252,19 @@ public:
             bool success;
         };
 
-        Variant<std::nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData> data { nullptr };
+        struct LockWaitData {
+            String name;
+            FlatPtr lock {};
+            u64 wait_time_ns {};
+        };
+
+        // One of these is recorded every `period` events of the counter.
+        struct PerformanceCounterData {
+            PerformanceCounter counter { PerformanceCounter::CPUCycles };
+            u64 period {};
+        };
+
+        Variant<std::nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData, LockWaitData, PerformanceCounterData> data { nullptr };
     };
 
     Vector<Event> const& events() const { return m_events; }
@@ -261,6 +294,31 @@ public:
     bool show_percentages() const { return m_show_percentages; }
     void set_show_percentages(bool);
 
+    // What the call tree and the flame graph are weighted by.
+    enum class Weighting {
+        // Every event counts once. Allocations are only included while they are live.
+        Events,
+        // Allocations that are still live at the end of the selected time range, by size.
+        LiveHeapBytes,
+        // All allocations made in the selected time range, by size.
+        AllocatedBytes,
+        // The events counted by the performance counters. Weighting by cycles or instructions
+        // also collects the other one of the two, so that the instructions per cycle can be shown.
+        CPUCycles,
+        InstructionsRetired,
+        CacheMisses,
+        BranchMisses,
+    };
+    Weighting weighting() const { return m_weighting; }
+    void set_weighting(Weighting);
+    bool is_weighted_by_bytes() const { return m_weighting == Weighting::LiveHeapBytes || m_weighting == Weighting::AllocatedBytes; }
+    Optional<PerformanceCounter> weighted_performance_counter() const;
+    // What a unit of weight is called, e.g. "Samples" or "Cycles".
+    StringView weight_name() const;
+
+    // The sum of all event weights in the current tree, for computing percentages.
+    u64 filtered_event_weight() const { return m_filtered_event_weight; }
+
     Vector<Process> const& processes() const { return m_processes; }
 
     template<typename Callback>
@@ -289,6 +347,7 @@ public:
 private:
     Profile(Vector<Process>, Vector<Event>);
 
+    void build_event_buckets();
     void rebuild_tree();
 
     RefPtr<ProfileModel> m_model;
@@ -311,6 +370,21 @@ private:
     Vector<size_t> m_signpost_indices;
     Vector<size_t> m_filtered_signpost_indices;
 
+    // The samples of each run of consecutive events, aggregated by their call stack. When weighting by events, the call tree
+    // for a time range is built from the stacks of the buckets that it covers, and only the events at its edges one by one.
+    static constexpr size_t events_per_bucket = 4096;
+    struct AggregatedStack {
+        // The first sample with this stack, which stands in for all of them.
+        size_t event_index { 0 };
+        u64 sample_count { 0 };
+    };
+    struct EventBucket {
+        u64 first_timestamp { 0 };
+        u64 last_timestamp { 0 };
+        Vector<AggregatedStack> stacks;
+    };
+    Vector<EventBucket> m_event_buckets;
+
     bool m_has_timestamp_filter_range { false };
     u64 m_timestamp_filter_range_start { 0 };
     u64 m_timestamp_filter_range_end { 0 };
@@ -322,6 +396,8 @@ private:
     bool m_inverted { false };
     bool m_show_top_functions { false };
     bool m_show_percentages { false };
+    Weighting m_weighting { Weighting::Events };
+    u64 m_filtered_event_weight { 0 };
 };
 
 }
@@ -76,9 +76,15 @@ String ProfileModel::column_name(int column) const
 {
     switch (column) {
     case Column::SampleCount:
+        if (m_profile.weighting() != Profile::Weighting::Events)
+            return String::formatted("{}{}", m_profile.show_percentages() ? "% " : "", m_profile.weight_name());
         return m_profile.show_percentages() ? "% Samples" : "# Samples";
     case Column::SelfCount:
+        if (m_profile.weighting() != Profile::Weighting::Events)
+            return String::formatted("{}Self {}", m_profile.show_percentages() ? "% " : "", m_profile.weight_name());
         return m_profile.show_percentages() ? "% Self" : "# Self";
+    case Column::InstructionsPerCycle:
+        return "IPC";
     case Column::ObjectName:
         return "Object";
     case Column::StackFrame:
@@ -95,7 +101,7 @@ GUI::Variant ProfileModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
 {
     auto* node = static_cast<ProfileNode*>(index.internal_data());
     if (role == GUI::ModelRole::TextAlignment) {
-        if (index.column() == Column::SampleCount || index.column() == Column::SelfCount)
+        if (index.column() == Column::SampleCount || index.column() == Column::SelfCount || index.column() == Column::InstructionsPerCycle)
             return Gfx::TextAlignment::CenterRight;
     }
     if (role == GUI::ModelRole::Icon) {
@@ -115,7 +121,7 @@ GUI::Variant ProfileModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
             auto percentage_full_precision = round_to<int>(
                 static_cast<float>(value)
                 * 100.f
-                / static_cast<float>(m_profile.filtered_event_indices().size())
+                / static_cast<float>(m_profile.filtered_event_weight())
                 * percent_digits_rounding);
             return String::formatted(
                 "{}.{:02}",
@@ -132,6 +138,12 @@ GUI::Variant ProfileModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
                 return round_percentages(node->self_count());
             return node->self_count();
         }
+        if (index.column() == Column::InstructionsPerCycle) {
+            // Only profiles that counted both cycles and instructions have these.
+            if (node->cpu_cycles() == 0 || node->instructions_retired() == 0)
+                return "";
+            return String::formatted("{:.2}", static_cast<double>(node->instructions_retired()) / static_cast<double>(node->cpu_cycles()));
+        }
         if (index.column() == Column::ObjectName)
             return node->object_name();
         if (index.column() == Column::StackFrame) {
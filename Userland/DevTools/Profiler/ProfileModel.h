@@ -27,6 +27,7 @@ public:
     enum Column {
         SampleCount,
         SelfCount,
+        InstructionsPerCycle,
         ObjectName,
         StackFrame,
         SymbolAddress,
@@ -108,7 +108,7 @@ SourceModel::SourceModel(Profile& profile, ProfileNode& node)
             line_number++;
 
             m_source_lines.append({
-                (u32)line_iterator.num_samples,
+                (u64)line_iterator.num_samples,
                 line_iterator.num_samples * 100.0f / node.event_count(),
                 file_iterator.key,
                 line_number,
@@ -74,6 +74,12 @@ void TimelineTrack::paint_event(GUI::PaintEvent& event)
         return IterationDecision::Continue;
     });
 
+    for_each_lock_wait([&](auto& lock_wait) {
+        auto const& data = lock_wait.data.template get<Profile::Event::LockWaitData>();
+        painter.fill_rect(lock_wait_rect(lock_wait.timestamp, data.wait_time_ns), Color::from_rgb(0xe0a030));
+        return IterationDecision::Continue;
+    });
+
     for (size_t bucket = 0; bucket < m_kernel_histogram->size(); bucket++) {
         auto kernel_value = m_kernel_histogram->at(bucket);
         auto user_value = m_user_histogram->at(bucket);
@@ -119,6 +125,31 @@ void TimelineTrack::for_each_signpost(Callback callback)
     });
 }
 
+template<typename Callback>
+void TimelineTrack::for_each_lock_wait(Callback callback)
+{
+    for (auto const& event : m_profile.events()) {
+        if (event.pid != m_process.pid || !event.data.has<Profile::Event::LockWaitData>())
+            continue;
+        if (!m_process.valid_at(event.serial))
+            continue;
+        if (callback(event) == IterationDecision::Break)
+            break;
+    }
+}
+
+// Lock waits are drawn as a strip along the bottom of the track, ending when the wait was over.
+Gfx::IntRect TimelineTrack::lock_wait_rect(u64 timestamp, u64 wait_time_ns) const
+{
+    constexpr int lock_wait_strip_height = 3;
+    auto column_width = this->column_width();
+    auto wait_time_ms = wait_time_ns / 1'000'000;
+    auto start_timestamp = timestamp > wait_time_ms ? timestamp - wait_time_ms : 0;
+    int x1 = (int)((float)(max(start_timestamp, m_profile.first_timestamp()) - m_profile.first_timestamp()) * column_width);
+    int x2 = (int)((float)(timestamp - m_profile.first_timestamp()) * column_width);
+    return { x1, height() - frame_thickness() - lock_wait_strip_height, max(1, x2 - x1), lock_wait_strip_height };
+}
+
 void TimelineTrack::mousemove_event(GUI::MouseEvent& event)
 {
     auto column_width = this->column_width();
@@ -137,6 +168,17 @@ void TimelineTrack::mousemove_event(GUI::MouseEvent& event)
         return IterationDecision::Continue;
     });
 
+    if (!hovering_a_signpost) {
+        for_each_lock_wait([&](auto& lock_wait) {
+            auto const& data = lock_wait.data.template get<Profile::Event::LockWaitData>();
+            if (!lock_wait_rect(lock_wait.timestamp, data.wait_time_ns).inflated(4, 0).contains_horizontally(event.x()))
+                return IterationDecision::Continue;
+            GUI::Application::the()->show_tooltip_immediately(String::formatted("Waited {} µs for lock '{}'", data.wait_time_ns / 1000, data.name), this);
+            hovering_a_signpost = true;
+            return IterationDecision::Break;
+        });
+    }
+
     if (!hovering_a_signpost)
         GUI::Application::the()->hide_tooltip();
 }
@@ -160,6 +202,9 @@ void TimelineTrack::recompute_histograms_if_needed(HistogramInputs const& inputs
         if (!m_process.valid_at(event.serial))
             continue;
 
+        if (event.data.has<Profile::Event::LockWaitData>())
+            continue;
+
         auto& histogram = event.in_kernel ? *m_kernel_histogram : *m_user_histogram;
         histogram.insert(clamp_timestamp(event.timestamp), 1 + event.lost_samples);
     }
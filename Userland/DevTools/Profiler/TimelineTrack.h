@@ -29,6 +29,9 @@ private:
 
     template<typename Callback>
     void for_each_signpost(Callback);
+    template<typename Callback>
+    void for_each_lock_wait(Callback);
+    Gfx::IntRect lock_wait_rect(u64 timestamp, u64 wait_time_ns) const;
 
     virtual void event(Core::Event&) override;
     virtual void paint_event(GUI::PaintEvent&) override;
@@ -13,6 +13,7 @@
 #include "TimelineHeader.h"
 #include "TimelineTrack.h"
 #include "TimelineView.h"
+#include <AK/NumberFormat.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ElapsedTimer.h>
 #include <LibCore/ProcessStatisticsReader.h>
@@ -20,6 +21,7 @@
 #include <LibCore/Timer.h>
 #include <LibDesktop/Launcher.h>
 #include <LibGUI/Action.h>
+#include <LibGUI/ActionGroup.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/BoxLayout.h>
 #include <LibGUI/Button.h>
@@ -227,7 +229,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto const format_sample_count = [&profile, sample_count_percent_format_string](auto const sample_count) {
         if (profile->show_percentages())
             return String::formatted(sample_count_percent_format_string, sample_count.as_float_or(0.0));
-        return String::formatted("{} Samples", sample_count.to_i32());
+        if (profile->is_weighted_by_bytes())
+            return human_readable_size(sample_count.to_i64());
+        return String::formatted("{} {}", sample_count.to_i64(), profile->weight_name());
     };
 
     auto statusbar = TRY(main_widget->try_add<GUI::Statusbar>());
@@ -241,7 +245,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             auto sample_count = profile->model().data(flamegraph_hovered_index.sibling_at_column(ProfileModel::Column::SampleCount));
             auto self_count = profile->model().data(flamegraph_hovered_index.sibling_at_column(ProfileModel::Column::SelfCount));
             builder.appendff("{}, ", stack);
-            builder.appendff("Samples: {}, ", format_sample_count(sample_count));
+            builder.appendff("{}: {}, ", profile->weight_name(), format_sample_count(sample_count));
             builder.appendff("Self: {}", format_sample_count(self_count));
         } else {
             u64 normalized_start_time = clamp_timestamp(min(view.select_start_time(), view.select_end_time()));
@@ -299,6 +303,31 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(view_menu->try_add_action(disassembly_action));
     TRY(view_menu->try_add_action(source_action));
 
+    TRY(view_menu->try_add_separator());
+
+    auto weighting_menu = TRY(view_menu->try_add_submenu("&Weigh By"));
+    GUI::ActionGroup weighting_actions;
+    weighting_actions.set_exclusive(true);
+
+    auto add_weighting_action = [&](StringView name, Profile::Weighting weighting) -> ErrorOr<NonnullRefPtr<GUI::Action>> {
+        auto action = GUI::Action::create_checkable(name, [&, weighting](auto&) {
+            profile->set_weighting(weighting);
+            tree_view->update();
+        });
+        weighting_actions.add_action(*action);
+        TRY(weighting_menu->try_add_action(action));
+        return action;
+    };
+    auto events_weighting_action = TRY(add_weighting_action("&Events"sv, Profile::Weighting::Events));
+    TRY(add_weighting_action("&Live Heap"sv, Profile::Weighting::LiveHeapBytes));
+    TRY(add_weighting_action("&Allocated Bytes"sv, Profile::Weighting::AllocatedBytes));
+    TRY(weighting_menu->try_add_separator());
+    TRY(add_weighting_action("&Cycles"sv, Profile::Weighting::CPUCycles));
+    TRY(add_weighting_action("&Instructions"sv, Profile::Weighting::InstructionsRetired));
+    TRY(add_weighting_action("Cache &Misses"sv, Profile::Weighting::CacheMisses));
+    TRY(add_weighting_action("&Branch Misses"sv, Profile::Weighting::BranchMisses));
+    events_weighting_action->set_checked(true);
+
     auto help_menu = TRY(window->try_add_menu("&Help"));
     TRY(help_menu->try_add_action(GUI::CommonActions::make_command_palette_action(window)));
     TRY(help_menu->try_add_action(GUI::CommonActions::make_help_action([](auto&) {
@@ -479,7 +479,7 @@ String MainWidget::read_next_sql_statement_of_editor()
     } while ((m_editor_line_level > 0) || piece.is_empty());
 
     auto statement_id = m_sql_client->sql_statement(m_connection_id, piece.to_string());
-    m_sql_client->async_statement_execute(statement_id);
+    m_sql_client->async_statement_execute(statement_id, {});
 
     return piece.to_string();
 }
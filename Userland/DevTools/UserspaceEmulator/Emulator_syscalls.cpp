@@ -19,6 +19,7 @@
 #include <serenity.h>
 #include <strings.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
 #include <sys/mman.h>
 #include <sys/poll.h>
 #include <sys/socket.h>
@@ -78,6 +79,12 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$dup2(arg1, arg2);
     case SC_emuctl:
         return virt$emuctl(arg1, arg2, arg3);
+    case SC_epoll_create1:
+        return virt$epoll_create1(arg1);
+    case SC_epoll_ctl:
+        return virt$epoll_ctl(arg1);
+    case SC_epoll_pwait:
+        return virt$epoll_pwait(arg1);
     case SC_execve:
         return virt$execve(arg1);
     case SC_exit:
@@ -181,6 +188,9 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$pledge(arg1);
     case SC_poll:
         return virt$poll(arg1);
+    case SC_posix_spawn:
+        // NOTE: LibC falls back to fork() and exec() for this, so that the spawned program runs in the emulator too.
+        return -ENOSYS;
     case SC_profiling_disable:
         return virt$profiling_disable(arg1);
     case SC_profiling_enable:
@@ -1006,6 +1016,7 @@ u32 Emulator::virt$mprotect(FlatPtr base, size_t size, int prot)
         }
         return IterationDecision::Continue;
     });
+    mmu().did_change_protection();
     if (has_non_mmapped_region)
         return -EINVAL;
 
@@ -1644,6 +1655,54 @@ int Emulator::virt$futex(FlatPtr params_addr)
     return 0;
 }
 
+int Emulator::virt$epoll_create1(int flags)
+{
+    int rc = epoll_create1(flags);
+    if (rc < 0)
+        return -errno;
+    return rc;
+}
+
+int Emulator::virt$epoll_ctl(FlatPtr params_addr)
+{
+    Syscall::SC_epoll_ctl_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    epoll_event event {};
+    if (params.event)
+        mmu().copy_from_vm(&event, (FlatPtr)params.event, sizeof(event));
+    int rc = epoll_ctl(params.epfd, params.op, params.fd, params.event ? &event : nullptr);
+    if (rc < 0)
+        return -errno;
+    return rc;
+}
+
+int Emulator::virt$epoll_pwait(FlatPtr params_addr)
+{
+    Syscall::SC_epoll_pwait_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+    if (params.max_events <= 0)
+        return -EINVAL;
+
+    Vector<epoll_event> events;
+    events.resize(params.max_events);
+
+    struct timespec timeout;
+    u32 sigmask;
+    if (params.timeout)
+        mmu().copy_from_vm(&timeout, (FlatPtr)params.timeout, sizeof(timeout));
+    if (params.sigmask)
+        mmu().copy_from_vm(&sigmask, (FlatPtr)params.sigmask, sizeof(sigmask));
+
+    Syscall::SC_epoll_pwait_params host_params { params.epfd, events.data(), params.max_events, params.timeout ? &timeout : nullptr, params.sigmask ? &sigmask : nullptr };
+    int rc = syscall(SC_epoll_pwait, &host_params);
+    if (rc < 0)
+        return rc;
+
+    mmu().copy_to_vm((FlatPtr)params.events, events.data(), rc * sizeof(epoll_event));
+    return rc;
+}
+
 int Emulator::virt$poll(FlatPtr params_addr)
 {
     Syscall::SC_poll_params params;
@@ -12,7 +12,9 @@
 #include "SoftFPU.h"
 #include "SoftVPU.h"
 #include "ValueWithShadow.h"
+#include <AK/Array.h>
 #include <AK/ByteReader.h>
+#include <AK/Optional.h>
 #include <LibX86/Instruction.h>
 #include <LibX86/Interpreter.h>
 
@@ -55,6 +57,9 @@ public:
     u32 base_eip() const { return m_base_eip; }
     void save_base_eip() { m_base_eip = m_eip; }
 
+    // Decodes the instruction at EIP, saves EIP as the base EIP and moves it past the instruction.
+    X86::Instruction const& fetch_instruction();
+
     u32 eip() const { return m_eip; }
     void set_eip(u32 eip)
     {
@@ -1340,8 +1345,44 @@ private:
 
     Region* m_cached_code_region { nullptr };
     u8* m_cached_code_base_ptr { nullptr };
+    u32 m_code_cache_generation { 0 };
+
+    // Instructions decoded from regions that can't be written to, which is where nearly all code lives.
+    // Those bytes can only change by remapping or mprotect(), which bump the MMU's layout generation.
+    struct CachedInstruction {
+        u32 eip { 0 };
+        u32 generation { 0 };
+        u8 length { 0 };
+        Optional<X86::Instruction> instruction;
+    };
+    static constexpr size_t instruction_cache_size = 16384;
+    Array<CachedInstruction, instruction_cache_size> m_instruction_cache;
 };
 
+ALWAYS_INLINE X86::Instruction const& SoftCPU::fetch_instruction()
+{
+    u32 generation = m_emulator.mmu().layout_generation();
+    if (m_code_cache_generation != generation) [[unlikely]] {
+        m_cached_code_region = nullptr;
+        m_code_cache_generation = generation;
+    }
+
+    save_base_eip();
+    auto& entry = m_instruction_cache[m_eip % instruction_cache_size];
+    if (entry.eip == m_eip && entry.generation == generation) [[likely]] {
+        m_eip += entry.length;
+        return *entry.instruction;
+    }
+
+    entry.instruction = X86::Instruction::from_stream(*this, true, true);
+    entry.eip = m_base_eip;
+    entry.length = m_eip - m_base_eip;
+    // NOTE: The code region is the one the last byte came from, so this also rules out instructions that span regions.
+    bool is_cacheable = m_cached_code_region->contains(m_base_eip) && !m_cached_code_region->is_writable();
+    entry.generation = is_cacheable ? generation : 0;
+    return *entry.instruction;
+}
+
 ALWAYS_INLINE u8 SoftCPU::read8()
 {
     if (!m_cached_code_region || !m_cached_code_region->contains(m_eip))
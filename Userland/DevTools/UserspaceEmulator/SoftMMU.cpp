@@ -31,6 +31,7 @@ void SoftMMU::add_region(NonnullOwnPtr<Region> region)
 
     m_regions.append(move(region));
     quick_sort((Vector<OwnPtr<Region>>&)m_regions, [](auto& a, auto& b) { return a->base() < b->base(); });
+    ++m_layout_generation;
 }
 
 void SoftMMU::remove_region(Region& region)
@@ -41,6 +42,7 @@ void SoftMMU::remove_region(Region& region)
     }
 
     m_regions.remove_first_matching([&](auto& entry) { return entry.ptr() == &region; });
+    ++m_layout_generation;
 }
 
 void SoftMMU::ensure_split_at(X86::LogicalAddress address)
@@ -82,6 +84,7 @@ void SoftMMU::ensure_split_at(X86::LogicalAddress address)
 
     m_regions.append(move(new_region));
     quick_sort((Vector<OwnPtr<Region>>&)m_regions, [](auto& a, auto& b) { return a->base() < b->base(); });
+    ++m_layout_generation;
 }
 
 void SoftMMU::set_tls_region(NonnullOwnPtr<Region> region)
@@ -305,18 +308,70 @@ void SoftMMU::write256(X86::LogicalAddress address, ValueWithShadow<u256> value)
     region->write256(address.offset() - region->base(), value);
 }
 
+bool SoftMMU::can_access_directly(Region const& region, u32 offset_in_region, size_t size) const
+{
+    if (offset_in_region + size > region.size())
+        return false;
+    // The malloc tracer needs to see every access to a malloc block.
+    if (is<MmapRegion>(region) && static_cast<MmapRegion const&>(region).is_malloc_block())
+        return !m_emulator.malloc_tracer();
+    return true;
+}
+
 void SoftMMU::copy_to_vm(FlatPtr destination, void const* source, size_t size)
 {
     // FIXME: We should have a way to preserve the shadow data here as well.
-    for (size_t i = 0; i < size; ++i)
-        write8({ 0x23, destination + i }, shadow_wrap_as_initialized(((u8 const*)source)[i]));
+    auto const* bytes = static_cast<u8 const*>(source);
+    while (size > 0) {
+        auto* region = find_region({ 0x23, destination });
+        if (!region || !region->is_writable()) {
+            // Let write8() report the bad access.
+            write8({ 0x23, destination }, shadow_wrap_as_initialized(*bytes));
+            VERIFY_NOT_REACHED();
+        }
+
+        u32 offset_in_region = destination - region->base();
+        size_t chunk_size = min(size, static_cast<size_t>(region->size() - offset_in_region));
+        if (can_access_directly(*region, offset_in_region, chunk_size)) {
+            memcpy(region->data() + offset_in_region, bytes, chunk_size);
+            memset(region->shadow_data() + offset_in_region, 0x01, chunk_size);
+        } else {
+            for (size_t i = 0; i < chunk_size; ++i)
+                region->write8(offset_in_region + i, shadow_wrap_as_initialized(bytes[i]));
+        }
+
+        destination += chunk_size;
+        bytes += chunk_size;
+        size -= chunk_size;
+    }
 }
 
 void SoftMMU::copy_from_vm(void* destination, const FlatPtr source, size_t size)
 {
     // FIXME: We should have a way to preserve the shadow data here as well.
-    for (size_t i = 0; i < size; ++i)
-        ((u8*)destination)[i] = read8({ 0x23, source + i }).value();
+    auto* bytes = static_cast<u8*>(destination);
+    FlatPtr address = source;
+    while (size > 0) {
+        auto* region = find_region({ 0x23, address });
+        if (!region || !region->is_readable()) {
+            // Let read8() report the bad access.
+            (void)read8({ 0x23, address });
+            VERIFY_NOT_REACHED();
+        }
+
+        u32 offset_in_region = address - region->base();
+        size_t chunk_size = min(size, static_cast<size_t>(region->size() - offset_in_region));
+        if (can_access_directly(*region, offset_in_region, chunk_size)) {
+            memcpy(bytes, region->data() + offset_in_region, chunk_size);
+        } else {
+            for (size_t i = 0; i < chunk_size; ++i)
+                bytes[i] = region->read8(offset_in_region + i).value();
+        }
+
+        address += chunk_size;
+        bytes += chunk_size;
+        size -= chunk_size;
+    }
 }
 
 ByteBuffer SoftMMU::copy_buffer_from_vm(const FlatPtr source, size_t size)
@@ -48,6 +48,15 @@ public:
             TODO();
         }
 
+        u32 offset_in_region = address.offset() - region->base();
+        if (can_access_directly(*region, offset_in_region, sizeof(T))) [[likely]] {
+            T value;
+            Array<u8, sizeof(T)> shadow;
+            __builtin_memcpy(&value, region->data() + offset_in_region, sizeof(T));
+            __builtin_memcpy(shadow.data(), region->shadow_data() + offset_in_region, sizeof(T));
+            return { value, shadow };
+        }
+
         alignas(alignof(T)) u8 data[sizeof(T)];
         Array<u8, sizeof(T)> shadow;
 
@@ -79,6 +88,11 @@ public:
         return m_page_to_region_map[page_index];
     }
 
+    // Bumped whenever regions are mapped, unmapped, split or change protection, so that anything
+    // cached about them (like decoded instructions) can tell that it has gone stale.
+    u32 layout_generation() const { return m_layout_generation; }
+    void did_change_protection() { ++m_layout_generation; }
+
     void add_region(NonnullOwnPtr<Region>);
     void remove_region(Region&);
     void ensure_split_at(X86::LogicalAddress);
@@ -138,8 +152,13 @@ public:
     }
 
 private:
+    // Whether an access can skip the region's own read/write functions and go straight to its memory.
+    bool can_access_directly(Region const&, u32 offset_in_region, size_t size) const;
+
     Emulator& m_emulator;
 
+    u32 m_layout_generation { 1 };
+
     Region* m_page_to_region_map[786432] = { nullptr };
 
     OwnPtr<Region> m_tls_region;
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Format.h>
 #include <AK/Platform.h>
 #include <AK/UFixedBigInt.h>
@@ -16,6 +17,35 @@ namespace UserspaceEmulator {
 template<typename T>
 class ValueAndShadowReference;
 
+// Initialized shadow bytes are 0x01, so most values can be checked a whole word at a time.
+template<size_t Size>
+ALWAYS_INLINE bool shadow_has_uninitialized_bytes(Array<u8, Size> const& shadow)
+{
+    if constexpr (Size % sizeof(u64) == 0) {
+        for (size_t i = 0; i < Size; i += sizeof(u64)) {
+            u64 word;
+            __builtin_memcpy(&word, shadow.data() + i, sizeof(word));
+            if ((word & 0x0101010101010101ull) != 0x0101010101010101ull)
+                return true;
+        }
+        return false;
+    } else if constexpr (Size == sizeof(u32)) {
+        u32 word;
+        __builtin_memcpy(&word, shadow.data(), sizeof(word));
+        return (word & 0x01010101u) != 0x01010101u;
+    } else if constexpr (Size == sizeof(u16)) {
+        u16 word;
+        __builtin_memcpy(&word, shadow.data(), sizeof(word));
+        return (word & 0x0101u) != 0x0101u;
+    } else {
+        for (size_t i = 0; i < Size; ++i) {
+            if ((shadow[i] & 0x01) != 0x01)
+                return true;
+        }
+        return false;
+    }
+}
+
 template<typename T>
 class ValueWithShadow {
 public:
@@ -76,14 +106,7 @@ public:
         };
     }
 
-    bool is_uninitialized() const
-    {
-        for (size_t i = 0; i < sizeof(ShadowType); ++i) {
-            if ((m_shadow[i] & 0x01) != 0x01)
-                return true;
-        }
-        return false;
-    }
+    bool is_uninitialized() const { return shadow_has_uninitialized_bytes(m_shadow); }
 
     void set_initialized()
     {
@@ -107,14 +130,7 @@ public:
     {
     }
 
-    bool is_uninitialized() const
-    {
-        for (size_t i = 0; i < sizeof(ShadowType); ++i) {
-            if ((m_shadow[i] & 0x01) != 0x01)
-                return true;
-        }
-        return false;
-    }
+    bool is_uninitialized() const { return shadow_has_uninitialized_bytes(m_shadow); }
 
     ValueAndShadowReference<T>& operator=(ValueWithShadow<T> const&);
 
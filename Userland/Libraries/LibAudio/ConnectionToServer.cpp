@@ -8,13 +8,11 @@
 #include <AK/Atomic.h>
 #include <AK/Format.h>
 #include <AK/OwnPtr.h>
-#include <AK/Time.h>
 #include <AK/Types.h>
 #include <LibAudio/ConnectionToServer.h>
 #include <LibAudio/UserSampleQueue.h>
 #include <LibCore/Event.h>
 #include <LibThreading/Mutex.h>
-#include <time.h>
 
 namespace Audio {
 
@@ -61,7 +59,6 @@ ErrorOr<void> ConnectionToServer::async_enqueue(FixedArray<Sample>&& samples)
     if (!m_background_audio_enqueuer->is_started())
         m_background_audio_enqueuer->start();
 
-    update_good_sleep_time();
     m_user_queue->append(move(samples));
     // Wake the background thread to make sure it starts enqueuing audio.
     m_enqueuer_loop->wake_once(*this, 0);
@@ -75,14 +72,6 @@ void ConnectionToServer::clear_client_buffer()
     m_user_queue->clear();
 }
 
-void ConnectionToServer::update_good_sleep_time()
-{
-    auto sample_rate = static_cast<double>(get_sample_rate());
-    auto buffer_play_time_ns = 1'000'000'000.0 / (sample_rate / static_cast<double>(AUDIO_BUFFER_SIZE));
-    // A factor of 1 should be good for now.
-    m_good_sleep_time = Time::from_nanoseconds(static_cast<unsigned>(buffer_play_time_ns)).to_timespec();
-}
-
 // Non-realtime audio writing loop
 void ConnectionToServer::custom_event(Core::CustomEvent&)
 {
@@ -99,10 +88,9 @@ void ConnectionToServer::custom_event(Core::CustomEvent&)
 
         m_user_queue->discard_samples(available_samples);
 
-        // FIXME: Could we receive interrupts in a good non-IPC way instead?
-        auto result = m_buffer->try_blocking_enqueue(next_chunk, [this]() {
-            nanosleep(&m_good_sleep_time, nullptr);
-        });
+        // This sleeps until AudioServer has taken a buffer out if the queue is full, or holds as much audio as the server
+        // wants to have queued up.
+        auto result = m_buffer->blocking_enqueue(next_chunk);
         if (result.is_error())
             dbgln("Error while writing samples to shared buffer: {}", result.error());
     }
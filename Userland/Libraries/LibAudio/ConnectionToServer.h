@@ -70,9 +70,6 @@ private:
     // We use this to perform the audio enqueuing on the background thread's event loop
     virtual void custom_event(Core::CustomEvent&) override;
 
-    // FIXME: This should be called every time the sample rate changes, but we just cautiously call it on every non-realtime enqueue.
-    void update_good_sleep_time();
-
     // Shared audio buffer: both server and client constantly read and write to/from this.
     // This needn't be mutex protected: it's internally multi-threading aware.
     OwnPtr<AudioQueue> m_buffer;
@@ -83,10 +80,6 @@ private:
     NonnullRefPtr<Threading::Thread> m_background_audio_enqueuer;
     Core::EventLoop* m_enqueuer_loop { nullptr };
     Threading::Mutex m_enqueuer_loop_destruction;
-
-    // A good amount of time to sleep when the queue is full.
-    // (Only used for non-realtime enqueues)
-    timespec m_good_sleep_time {};
 };
 
 }
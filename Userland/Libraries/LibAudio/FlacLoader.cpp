@@ -10,6 +10,7 @@
 #include <AK/Format.h>
 #include <AK/IntegralMath.h>
 #include <AK/Math.h>
+#include <AK/SIMD.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StdLibExtras.h>
 #include <AK/String.h>
@@ -182,6 +183,9 @@ MaybeLoaderError FlacLoaderPlugin::load_seektable(FlacRawMetadataBlock& block)
             .byte_offset = LOADER_TRY(seektable_bytes->read_bits<u64>(64)),
             .num_samples = LOADER_TRY(seektable_bytes->read_bits<u16>(16))
         };
+        // Placeholder seek points don't point anywhere, and they always come last.
+        if (seekpoint.sample_index == NumericLimits<u64>::max())
+            break;
         m_seektable.append(seekpoint);
     }
     dbgln_if(AFLACLOADER_DEBUG, "Loaded seektable of size {}", m_seektable.size());
@@ -243,55 +247,77 @@ MaybeLoaderError FlacLoaderPlugin::seek(int int_sample_index)
         return {};
 
     auto maybe_target_seekpoint = m_seektable.last_matching([sample_index](auto& seekpoint) { return seekpoint.sample_index <= sample_index; });
-    // No seektable or no fitting entry: Perform normal forward read
-    if (!maybe_target_seekpoint.has_value()) {
-        if (sample_index < m_loaded_samples) {
-            LOADER_TRY(m_stream->seek(m_data_start_location, Core::Stream::SeekMode::SetPosition));
-            m_loaded_samples = 0;
-        }
-        auto to_read = sample_index - m_loaded_samples;
-        if (to_read == 0)
-            return {};
-        dbgln_if(AFLACLOADER_DEBUG, "Seeking {} samples manually", to_read);
-        (void)TRY(get_more_samples(to_read));
-    } else {
-        auto target_seekpoint = maybe_target_seekpoint.release_value();
+    u64 target_seekpoint_sample_index = maybe_target_seekpoint.has_value() ? maybe_target_seekpoint->sample_index : 0;
 
-        // When a small seek happens, we may already be closer to the target than the seekpoint.
-        if (sample_index - target_seekpoint.sample_index > sample_index - m_loaded_samples) {
-            dbgln_if(AFLACLOADER_DEBUG, "Close enough to target: seeking {} samples manually", sample_index - m_loaded_samples);
-            (void)TRY(get_more_samples(sample_index - m_loaded_samples));
-            return {};
-        }
-
-        dbgln_if(AFLACLOADER_DEBUG, "Seeking to seektable: sample index {}, byte offset {}, sample count {}", target_seekpoint.sample_index, target_seekpoint.byte_offset, target_seekpoint.num_samples);
-        auto position = target_seekpoint.byte_offset + m_data_start_location;
+    // When a small forward seek happens, we may already be closer to the target than any seek point.
+    if (sample_index < m_loaded_samples || target_seekpoint_sample_index > m_loaded_samples) {
+        u64 byte_offset = maybe_target_seekpoint.has_value() ? maybe_target_seekpoint->byte_offset : 0;
+        dbgln_if(AFLACLOADER_DEBUG, "Seeking to seek point: sample index {}, byte offset {}", target_seekpoint_sample_index, byte_offset);
+        auto position = byte_offset + m_data_start_location;
         if (m_stream->seek(static_cast<i64>(position), Core::Stream::SeekMode::SetPosition).is_error())
             return LoaderError { LoaderError::Category::IO, m_loaded_samples, String::formatted("Invalid seek position {}", position) };
+        m_loaded_samples = target_seekpoint_sample_index;
+        m_unread_data.clear_with_capacity();
+    }
 
-        auto remaining_samples_after_seekpoint = sample_index - m_data_start_location;
-        if (remaining_samples_after_seekpoint > 0)
-            (void)TRY(get_more_samples(remaining_samples_after_seekpoint));
-        m_loaded_samples = target_seekpoint.sample_index;
+    dbgln_if(AFLACLOADER_DEBUG, "Seeking {} samples manually", sample_index - m_loaded_samples);
+    return skip_samples(sample_index - m_loaded_samples);
+}
+
+MaybeLoaderError FlacLoaderPlugin::skip_samples(size_t count)
+{
+    Array<Sample, 1024> discarded_samples;
+    while (count > 0) {
+        auto skipped = TRY(load_samples(discarded_samples.span().trim(count)));
+        if (skipped == 0)
+            break;
+        count -= skipped;
     }
     return {};
 }
 
+void FlacLoaderPlugin::remember_seek_point(u64 sample_index, u64 byte_offset, u16 sample_count)
+{
+    // Half a second between seek points keeps the seek table small, while seeking only has to decode a few frames.
+    u64 minimum_distance = m_sample_rate / 2;
+
+    size_t index = m_seektable.size();
+    while (index > 0 && m_seektable[index - 1].sample_index > sample_index)
+        --index;
+    if (index > 0 && m_seektable[index - 1].sample_index + minimum_distance > sample_index)
+        return;
+    if (index < m_seektable.size() && sample_index + minimum_distance > m_seektable[index].sample_index)
+        return;
+
+    // If we're out of memory, seeking is merely going to be slower.
+    (void)m_seektable.try_insert(index, { sample_index, byte_offset, sample_count });
+}
+
 LoaderSamples FlacLoaderPlugin::get_more_samples(size_t max_bytes_to_read_from_input)
 {
     ssize_t remaining_samples = static_cast<ssize_t>(m_total_samples - m_loaded_samples);
     if (remaining_samples <= 0)
         return FixedArray<Sample> {};
 
-    // FIXME: samples_to_read is calculated wrong, because when seeking not all samples are loaded.
-    size_t samples_to_read = min(max_bytes_to_read_from_input, remaining_samples);
-    auto samples = FixedArray<Sample>::must_create_but_fixme_should_propagate_errors(samples_to_read);
+    auto samples = LOADER_TRY(FixedArray<Sample>::try_create(min(max_bytes_to_read_from_input, remaining_samples)));
+    auto loaded_samples = TRY(load_samples(samples.span()));
+    VERIFY(loaded_samples == samples.size());
+    return samples;
+}
+
+ErrorOr<size_t, LoaderError> FlacLoaderPlugin::load_samples(Span<Sample> buffer)
+{
+    ssize_t remaining_samples = static_cast<ssize_t>(m_total_samples - m_loaded_samples);
+    if (remaining_samples <= 0)
+        return 0;
+
+    size_t samples_to_read = min(buffer.size(), static_cast<size_t>(remaining_samples));
     size_t sample_index = 0;
 
     if (m_unread_data.size() > 0) {
         size_t to_transfer = min(m_unread_data.size(), samples_to_read);
         dbgln_if(AFLACLOADER_DEBUG, "Reading {} samples from unread sample buffer (size {})", to_transfer, m_unread_data.size());
-        AK::TypedTransfer<Sample>::move(samples.data(), m_unread_data.data(), to_transfer);
+        AK::TypedTransfer<Sample>::move(buffer.data(), m_unread_data.data(), to_transfer);
         if (to_transfer < m_unread_data.size())
             m_unread_data.remove(0, to_transfer);
         else
@@ -301,13 +327,18 @@ LoaderSamples FlacLoaderPlugin::get_more_samples(size_t max_bytes_to_read_from_i
     }
 
     while (sample_index < samples_to_read) {
-        TRY(next_frame(samples.span().slice(sample_index)));
-        sample_index += m_current_frame->sample_count;
+        // Whatever was left of the previous frame has been used up, so this is where the next frame starts.
+        u64 frame_sample_index = m_loaded_samples + sample_index;
+        u64 frame_byte_offset = LOADER_TRY(m_stream->tell()) - m_data_start_location;
+
+        TRY(next_frame(buffer.slice(sample_index, samples_to_read - sample_index)));
+        remember_seek_point(frame_sample_index, frame_byte_offset, m_current_frame->sample_count);
+        sample_index += min<size_t>(m_current_frame->sample_count, samples_to_read - sample_index);
     }
 
     m_loaded_samples += sample_index;
 
-    return samples;
+    return sample_index;
 }
 
 // 11.21. FRAME
@@ -380,13 +411,10 @@ MaybeLoaderError FlacLoaderPlugin::next_frame(Span<Sample> target_vector)
     };
 
     u8 subframe_count = frame_channel_type_to_channel_count(channel_type);
-    Vector<Vector<i32>> current_subframes;
-    current_subframes.ensure_capacity(subframe_count);
 
     for (u8 i = 0; i < subframe_count; ++i) {
         FlacSubframeHeader new_subframe = TRY(next_subframe_header(*bit_stream, i));
-        Vector<i32> subframe_samples = TRY(parse_subframe(new_subframe, *bit_stream));
-        current_subframes.unchecked_append(move(subframe_samples));
+        TRY(parse_subframe(new_subframe, *bit_stream, m_subframe_samples[i]));
     }
 
     // 11.2. Overview ("The audio data is composed of...")
@@ -397,13 +425,32 @@ MaybeLoaderError FlacLoaderPlugin::next_frame(Span<Sample> target_vector)
     [[maybe_unused]] u16 footer_checksum = LOADER_TRY(bit_stream->read_bits<u16>(16));
     dbgln_if(AFLACLOADER_DEBUG, "Subframe footer checksum: {}", footer_checksum);
 
-    Vector<i32> left;
-    Vector<i32> right;
+    auto const& first_channel = m_subframe_samples[0];
+    auto const& second_channel = m_subframe_samples[subframe_count > 1 ? 1 : 0];
+    VERIFY(first_channel.size() == second_channel.size() && first_channel.size() == m_current_frame->sample_count);
+
+    float sample_rescale = 1.0f / static_cast<float>(1 << (pcm_bits_per_sample(m_current_frame->bit_depth) - 1));
+    dbgln_if(AFLACLOADER_DEBUG, "Sample rescaled from {} bits: factor {}", pcm_bits_per_sample(m_current_frame->bit_depth), sample_rescale);
+
+    auto samples_to_directly_copy = min(target_vector.size(), m_current_frame->sample_count);
+    // move superfluous data into the class buffer instead
+    auto result = m_unread_data.try_grow_capacity(m_current_frame->sample_count - samples_to_directly_copy);
+    if (result.is_error())
+        return LoaderError { LoaderError::Category::Internal, static_cast<size_t>(samples_to_directly_copy + m_current_sample_or_frame), "Couldn't allocate sample buffer for superfluous data" };
+
+    auto to_sample = [sample_rescale](i64 left, i64 right) {
+        return Sample { static_cast<float>(left) * sample_rescale, static_cast<float>(right) * sample_rescale };
+    };
+    // Undo the inter-channel decorrelation and zip together the channels in one go.
+    auto write_samples = [&](auto decorrelate) {
+        for (size_t i = 0; i < samples_to_directly_copy; ++i)
+            target_vector[i] = decorrelate(first_channel[i], second_channel[i]);
+        for (size_t i = samples_to_directly_copy; i < m_current_frame->sample_count; ++i)
+            m_unread_data.unchecked_append(decorrelate(first_channel[i], second_channel[i]));
+    };
 
     switch (channel_type) {
     case FlacFrameChannelType::Mono:
-        left = right = current_subframes[0];
-        break;
     case FlacFrameChannelType::Stereo:
     // TODO mix together surround channels on each side?
     case FlacFrameChannelType::StereoCenter:
@@ -412,63 +459,26 @@ MaybeLoaderError FlacLoaderPlugin::next_frame(Span<Sample> target_vector)
     case FlacFrameChannelType::Surround5p1:
     case FlacFrameChannelType::Surround6p1:
     case FlacFrameChannelType::Surround7p1:
-        left = current_subframes[0];
-        right = current_subframes[1];
+        write_samples([&](i64 left, i64 right) { return to_sample(left, right); });
         break;
     case FlacFrameChannelType::LeftSideStereo:
         // channels are left (0) and side (1)
-        left = current_subframes[0];
-        right.ensure_capacity(left.size());
-        for (size_t i = 0; i < left.size(); ++i) {
-            // right = left - side
-            right.unchecked_append(left[i] - current_subframes[1][i]);
-        }
+        write_samples([&](i64 left, i64 side) { return to_sample(left, left - side); });
         break;
     case FlacFrameChannelType::RightSideStereo:
         // channels are side (0) and right (1)
-        right = current_subframes[1];
-        left.ensure_capacity(right.size());
-        for (size_t i = 0; i < right.size(); ++i) {
-            // left = right + side
-            left.unchecked_append(right[i] + current_subframes[0][i]);
-        }
+        write_samples([&](i64 side, i64 right) { return to_sample(right + side, right); });
         break;
     case FlacFrameChannelType::MidSideStereo:
         // channels are mid (0) and side (1)
-        left.ensure_capacity(current_subframes[0].size());
-        right.ensure_capacity(current_subframes[0].size());
-        for (size_t i = 0; i < current_subframes[0].size(); ++i) {
-            i64 mid = current_subframes[0][i];
-            i64 side = current_subframes[1][i];
-            mid *= 2;
-            // prevent integer division errors
-            left.unchecked_append(static_cast<i32>((mid + side) / 2));
-            right.unchecked_append(static_cast<i32>((mid - side) / 2));
-        }
+        write_samples([&](i64 mid, i64 side) {
+            // The encoder dropped the lowest bit of the mid channel, which is the same as the lowest bit of the side channel.
+            mid = (mid << 1) | (side & 1);
+            return to_sample((mid + side) >> 1, (mid - side) >> 1);
+        });
         break;
     }
 
-    VERIFY(left.size() == right.size() && left.size() == m_current_frame->sample_count);
-
-    float sample_rescale = static_cast<float>(1 << (pcm_bits_per_sample(m_current_frame->bit_depth) - 1));
-    dbgln_if(AFLACLOADER_DEBUG, "Sample rescaled from {} bits: factor {:.1f}", pcm_bits_per_sample(m_current_frame->bit_depth), sample_rescale);
-
-    // zip together channels
-    auto samples_to_directly_copy = min(target_vector.size(), m_current_frame->sample_count);
-    for (size_t i = 0; i < samples_to_directly_copy; ++i) {
-        Sample frame = { left[i] / sample_rescale, right[i] / sample_rescale };
-        target_vector[i] = frame;
-    }
-    // move superfluous data into the class buffer instead
-    auto result = m_unread_data.try_grow_capacity(m_current_frame->sample_count - samples_to_directly_copy);
-    if (result.is_error())
-        return LoaderError { LoaderError::Category::Internal, static_cast<size_t>(samples_to_directly_copy + m_current_sample_or_frame), "Couldn't allocate sample buffer for superfluous data" };
-
-    for (size_t i = samples_to_directly_copy; i < m_current_frame->sample_count; ++i) {
-        Sample frame = { left[i] / sample_rescale, right[i] / sample_rescale };
-        m_unread_data.unchecked_append(frame);
-    }
-
     return {};
 #undef FLAC_VERIFY
 }
@@ -625,9 +635,10 @@ ErrorOr<FlacSubframeHeader, LoaderError> FlacLoaderPlugin::next_subframe_header(
     };
 }
 
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::parse_subframe(FlacSubframeHeader& subframe_header, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::parse_subframe(FlacSubframeHeader& subframe_header, BigEndianInputBitStream& bit_input, Vector<i32>& samples)
 {
-    Vector<i32> samples;
+    samples.clear_with_capacity();
+    LOADER_TRY(samples.try_ensure_capacity(m_current_frame->sample_count));
 
     switch (subframe_header.type) {
     case FlacSubframeType::Constant: {
@@ -635,7 +646,6 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::parse_subframe(FlacSubframeH
         u64 constant_value = LOADER_TRY(bit_input.read_bits<u64>(subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample));
         dbgln_if(AFLACLOADER_DEBUG, "Constant subframe: {}", constant_value);
 
-        samples.ensure_capacity(m_current_frame->sample_count);
         VERIFY(subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample != 0);
         i32 constant = sign_extend(static_cast<u32>(constant_value), subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample);
         for (u32 i = 0; i < m_current_frame->sample_count; ++i) {
@@ -645,38 +655,40 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::parse_subframe(FlacSubframeH
     }
     case FlacSubframeType::Fixed: {
         dbgln_if(AFLACLOADER_DEBUG, "Fixed LPC subframe order {}", subframe_header.order);
-        samples = TRY(decode_fixed_lpc(subframe_header, bit_input));
+        TRY(decode_fixed_lpc(subframe_header, bit_input, samples));
         break;
     }
     case FlacSubframeType::Verbatim: {
         dbgln_if(AFLACLOADER_DEBUG, "Verbatim subframe");
-        samples = TRY(decode_verbatim(subframe_header, bit_input));
+        TRY(decode_verbatim(subframe_header, bit_input, samples));
         break;
     }
     case FlacSubframeType::LPC: {
         dbgln_if(AFLACLOADER_DEBUG, "Custom LPC subframe order {}", subframe_header.order);
-        samples = TRY(decode_custom_lpc(subframe_header, bit_input));
+        TRY(decode_custom_lpc(subframe_header, bit_input, samples));
         break;
     }
     default:
         return LoaderError { LoaderError::Category::Unimplemented, static_cast<size_t>(m_current_sample_or_frame), "Unhandled FLAC subframe type" };
     }
 
-    for (size_t i = 0; i < samples.size(); ++i) {
-        samples[i] <<= subframe_header.wasted_bits_per_sample;
+    if (subframe_header.wasted_bits_per_sample != 0) {
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] <<= subframe_header.wasted_bits_per_sample;
+        }
     }
 
-    ResampleHelper<i32> resampler(m_current_frame->sample_rate, m_sample_rate);
-    return resampler.resample(samples);
+    if (m_current_frame->sample_rate != m_sample_rate) {
+        ResampleHelper<i32> resampler(m_current_frame->sample_rate, m_sample_rate);
+        samples = resampler.resample(samples);
+    }
+    return {};
 }
 
 // 11.29. SUBFRAME_VERBATIM
 // Decode a subframe that isn't actually encoded, usually seen in random data
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_verbatim(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_verbatim(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input, Vector<i32>& decoded)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
-
     VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
     for (size_t i = 0; i < m_current_frame->sample_count; ++i) {
         decoded.unchecked_append(sign_extend(
@@ -684,16 +696,69 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_verbatim(FlacSubframe
             subframe.bits_per_sample - subframe.wasted_bits_per_sample));
     }
 
-    return decoded;
+    return {};
+}
+
+// Restores the samples from the custom LPC residual, with SIMD tricks for the common case where a 32-bit sum can't overflow.
+static void restore_custom_lpc(Span<i32> decoded, Span<i32 const> coefficients, u8 bits_per_sample, u8 lpc_precision, i8 lpc_shift)
+{
+    size_t order = coefficients.size();
+
+    // The same condition as libFLAC's: the samples have at most bits_per_sample bits, the coefficients lpc_precision bits,
+    // and summing `order` of their products adds another log2(order) bits.
+    if (bits_per_sample + lpc_precision + AK::log2(order) <= 32) {
+        // Reversing the coefficients makes the predictor a dot product with the `order` samples right before the current one.
+        // Padding them to a multiple of four with leading zeros then lets us process four of those products at a time.
+        size_t padded_order = align_up_to(order, 4);
+        Array<i32, 32> reversed_coefficients {};
+        for (size_t t = 0; t < order; ++t)
+            reversed_coefficients[padded_order - 1 - t] = coefficients[t];
+
+        auto predict_scalar = [&](size_t i) {
+            i32 sample = 0;
+            for (size_t t = 0; t < order; ++t)
+                sample += coefficients[t] * decoded[i - t - 1];
+            decoded[i] += sample >> lpc_shift;
+        };
+
+        size_t i = order;
+        for (; i < min(padded_order, decoded.size()); ++i)
+            predict_scalar(i);
+
+        for (; i < decoded.size(); ++i) {
+            AK::SIMD::i32x4 sums {};
+            auto const* previous_samples = &decoded[i - padded_order];
+            for (size_t t = 0; t < padded_order; t += 4) {
+                AK::SIMD::i32x4 samples;
+                AK::SIMD::i32x4 taps;
+                __builtin_memcpy(&samples, previous_samples + t, sizeof(samples));
+                __builtin_memcpy(&taps, &reversed_coefficients[t], sizeof(taps));
+                sums += samples * taps;
+            }
+            decoded[i] += (sums[0] + sums[1] + sums[2] + sums[3]) >> lpc_shift;
+        }
+        return;
+    }
+
+    for (size_t i = order; i < decoded.size(); ++i) {
+        // (see below)
+        i64 sample = 0;
+        for (size_t t = 0; t < order; ++t) {
+            // It's really important that we compute in 64-bit land here.
+            // Even though FLAC operates at a maximum bit depth of 32 bits, modern encoders use super-large coefficients for maximum compression.
+            // These will easily overflow 32 bits and cause strange white noise that abruptly stops intermittently (at the end of a frame).
+            // The simple fix of course is to do intermediate computations in 64 bits.
+            // These considerations are not in the original FLAC spec, but have been added to the IETF standard: https://datatracker.ietf.org/doc/html/draft-ietf-cellar-flac-03#appendix-A.3
+            sample += static_cast<i64>(coefficients[t]) * static_cast<i64>(decoded[i - t - 1]);
+        }
+        decoded[i] += sample >> lpc_shift;
+    }
 }
 
 // 11.28. SUBFRAME_LPC
 // Decode a subframe encoded with a custom linear predictor coding, i.e. the subframe provides the polynomial order and coefficients
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_custom_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input, Vector<i32>& decoded)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
-
     VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
     // warm-up samples
     for (auto i = 0; i < subframe.order; ++i) {
@@ -711,44 +776,29 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubfra
     // shift needed on the data (signed!)
     i8 lpc_shift = sign_extend(LOADER_TRY(bit_input.read_bits<u8>(5)), 5);
 
-    Vector<i32> coefficients;
-    coefficients.ensure_capacity(subframe.order);
+    Array<i32, 32> coefficients;
     // read coefficients
     for (auto i = 0; i < subframe.order; ++i) {
         u32 raw_coefficient = LOADER_TRY(bit_input.read_bits<u32>(lpc_precision));
-        i32 coefficient = static_cast<i32>(sign_extend(raw_coefficient, lpc_precision));
-        coefficients.unchecked_append(coefficient);
+        coefficients[i] = static_cast<i32>(sign_extend(raw_coefficient, lpc_precision));
     }
 
-    dbgln_if(AFLACLOADER_DEBUG, "{}-bit {} shift coefficients: {}", lpc_precision, lpc_shift, coefficients);
+    dbgln_if(AFLACLOADER_DEBUG, "{}-bit {} shift coefficients: {}", lpc_precision, lpc_shift, coefficients.span().trim(subframe.order));
 
     TRY(decode_residual(decoded, subframe, bit_input));
+    if (decoded.size() != m_current_frame->sample_count)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Residual doesn't fit the block size" };
 
     // approximate the waveform with the predictor
-    for (size_t i = subframe.order; i < m_current_frame->sample_count; ++i) {
-        // (see below)
-        i64 sample = 0;
-        for (size_t t = 0; t < subframe.order; ++t) {
-            // It's really important that we compute in 64-bit land here.
-            // Even though FLAC operates at a maximum bit depth of 32 bits, modern encoders use super-large coefficients for maximum compression.
-            // These will easily overflow 32 bits and cause strange white noise that abruptly stops intermittently (at the end of a frame).
-            // The simple fix of course is to do intermediate computations in 64 bits.
-            // These considerations are not in the original FLAC spec, but have been added to the IETF standard: https://datatracker.ietf.org/doc/html/draft-ietf-cellar-flac-03#appendix-A.3
-            sample += static_cast<i64>(coefficients[t]) * static_cast<i64>(decoded[i - t - 1]);
-        }
-        decoded[i] += sample >> lpc_shift;
-    }
+    restore_custom_lpc(decoded.span(), coefficients.span().trim(subframe.order), subframe.bits_per_sample - subframe.wasted_bits_per_sample, lpc_precision, lpc_shift);
 
-    return decoded;
+    return {};
 }
 
 // 11.27. SUBFRAME_FIXED
 // Decode a subframe encoded with one of the fixed linear predictor codings
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_fixed_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input, Vector<i32>& decoded)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
-
     VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
     // warm-up samples
     for (auto i = 0; i < subframe.order; ++i) {
@@ -758,6 +808,8 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubfram
     }
 
     TRY(decode_residual(decoded, subframe, bit_input));
+    if (decoded.size() != m_current_frame->sample_count)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Residual doesn't fit the block size" };
 
     dbgln_if(AFLACLOADER_DEBUG, "decoded length {}, {} order predictor", decoded.size(), subframe.order);
 
@@ -807,7 +859,7 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubfram
     default:
         return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), String::formatted("Unrecognized predictor order {}", subframe.order) };
     }
-    return decoded;
+    return {};
 }
 
 // 11.30. RESIDUAL
@@ -822,17 +874,13 @@ MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i32>& decoded, FlacSub
     if (residual_mode == FlacResidualMode::Rice4Bit) {
         // 11.30.2. RESIDUAL_CODING_METHOD_PARTITIONED_EXP_GOLOMB
         // decode a single Rice partition with four bits for the order k
-        for (size_t i = 0; i < partitions; ++i) {
-            auto rice_partition = TRY(decode_rice_partition(4, partitions, i, subframe, bit_input));
-            decoded.extend(move(rice_partition));
-        }
+        for (size_t i = 0; i < partitions; ++i)
+            TRY(decode_rice_partition(decoded, 4, partitions, i, subframe, bit_input));
     } else if (residual_mode == FlacResidualMode::Rice5Bit) {
         // 11.30.3. RESIDUAL_CODING_METHOD_PARTITIONED_EXP_GOLOMB2
         // five bits equivalent
-        for (size_t i = 0; i < partitions; ++i) {
-            auto rice_partition = TRY(decode_rice_partition(5, partitions, i, subframe, bit_input));
-            decoded.extend(move(rice_partition));
-        }
+        for (size_t i = 0; i < partitions; ++i)
+            TRY(decode_rice_partition(decoded, 5, partitions, i, subframe, bit_input));
     } else
         return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Reserved residual coding method" };
 
@@ -841,7 +889,7 @@ MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i32>& decoded, FlacSub
 
 // 11.30.2.1. EXP_GOLOMB_PARTITION and 11.30.3.1. EXP_GOLOMB2_PARTITION
 // Decode a single Rice partition as part of the residual, every partition can have its own Rice parameter k
-ALWAYS_INLINE ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+ALWAYS_INLINE MaybeLoaderError FlacLoaderPlugin::decode_rice_partition(Vector<i32>& decoded, u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
 {
     // 11.30.2.2. EXP GOLOMB PARTITION ENCODING PARAMETER and 11.30.3.2. EXP-GOLOMB2 PARTITION ENCODING PARAMETER
     u8 k = LOADER_TRY(bit_input.read_bits<u8>(partition_type));
@@ -854,22 +902,27 @@ ALWAYS_INLINE ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_rice_pa
     if (partition_index == 0)
         residual_sample_count -= subframe.order;
 
-    Vector<i32> rice_partition;
-    rice_partition.resize(residual_sample_count);
+    // The residual has room for the whole block, so a well-formed partition always fits.
+    if (decoded.size() + residual_sample_count > m_current_frame->sample_count)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Rice partition is larger than the block" };
 
     // escape code for unencoded binary partition
     if (k == (1 << partition_type) - 1) {
         u8 unencoded_bps = LOADER_TRY(bit_input.read_bits<u8>(5));
         for (size_t r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = LOADER_TRY(bit_input.read_bits<u8>(unencoded_bps));
+            if (unencoded_bps == 0) {
+                decoded.unchecked_append(0);
+                continue;
+            }
+            decoded.unchecked_append(sign_extend(LOADER_TRY(bit_input.read_bits<u32>(unencoded_bps)), unencoded_bps));
         }
     } else {
         for (size_t r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = LOADER_TRY(decode_unsigned_exp_golomb(k, bit_input));
+            decoded.unchecked_append(LOADER_TRY(decode_unsigned_exp_golomb(k, bit_input)));
         }
     }
 
-    return rice_partition;
+    return {};
 }
 
 // Decode a single number encoded with Rice/Exponential-Golomb encoding (the unsigned variant)
@@ -8,6 +8,7 @@
 
 #include "FlacTypes.h"
 #include "Loader.h"
+#include <AK/Array.h>
 #include <AK/Error.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
@@ -54,6 +55,7 @@ public:
     virtual MaybeLoaderError initialize() override;
 
     virtual LoaderSamples get_more_samples(size_t max_bytes_to_read_from_input = 128 * KiB) override;
+    virtual ErrorOr<size_t, LoaderError> load_samples(Span<Sample> buffer) override;
 
     virtual MaybeLoaderError reset() override;
     virtual MaybeLoaderError seek(int sample_index) override;
@@ -77,16 +79,20 @@ private:
     MaybeLoaderError next_frame(Span<Sample>);
     // Helper of next_frame that fetches a sub frame's header
     ErrorOr<FlacSubframeHeader, LoaderError> next_subframe_header(BigEndianInputBitStream& bit_input, u8 channel_index);
-    // Helper of next_frame that decompresses a subframe
-    ErrorOr<Vector<i32>, LoaderError> parse_subframe(FlacSubframeHeader& subframe_header, BigEndianInputBitStream& bit_input);
+    // Helper of next_frame that decompresses a subframe into the (reused) sample buffer
+    MaybeLoaderError parse_subframe(FlacSubframeHeader& subframe_header, BigEndianInputBitStream& bit_input, Vector<i32>& samples);
     // Subframe-internal data decoders (heavy lifting)
-    ErrorOr<Vector<i32>, LoaderError> decode_fixed_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
-    ErrorOr<Vector<i32>, LoaderError> decode_verbatim(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
-    ErrorOr<Vector<i32>, LoaderError> decode_custom_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
+    MaybeLoaderError decode_fixed_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input, Vector<i32>& decoded);
+    MaybeLoaderError decode_verbatim(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input, Vector<i32>& decoded);
+    MaybeLoaderError decode_custom_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input, Vector<i32>& decoded);
     MaybeLoaderError decode_residual(Vector<i32>& decoded, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
-    // decode a single rice partition that has its own rice parameter
-    ALWAYS_INLINE ErrorOr<Vector<i32>, LoaderError> decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
+    // decode a single rice partition that has its own rice parameter, and append it to the decoded samples
+    ALWAYS_INLINE MaybeLoaderError decode_rice_partition(Vector<i32>& decoded, u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
     MaybeLoaderError load_seektable(FlacRawMetadataBlock&);
+    // Adds a seek point for a frame that was just decoded, unless there already is one close by.
+    void remember_seek_point(u64 sample_index, u64 byte_offset, u16 sample_count);
+    // Decodes and discards samples until the stream has moved forward by `count` samples.
+    MaybeLoaderError skip_samples(size_t count);
     MaybeLoaderError load_picture(FlacRawMetadataBlock&);
 
     // Converters for special coding used in frame headers
@@ -114,7 +120,10 @@ private:
     // Whatever the last get_more_samples() call couldn't return gets stored here.
     Vector<Sample, FLAC_BUFFER_SIZE> m_unread_data;
     u64 m_current_sample_or_frame { 0 };
+    // Seek points from the SEEKTABLE, and the ones that decoding added, ordered by sample index.
     Vector<FlacSeekPoint> m_seektable;
+    // Decoded samples of every channel in the current frame, kept around to avoid allocating them again for each frame.
+    Array<Vector<i32>, 8> m_subframe_samples;
 };
 
 }
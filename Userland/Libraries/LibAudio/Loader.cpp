@@ -31,6 +31,13 @@ MaybeLoaderError LoaderPlugin::initialize()
     return {};
 }
 
+ErrorOr<size_t, LoaderError> LoaderPlugin::load_samples(Span<Sample> buffer)
+{
+    auto samples = TRY(get_more_samples(buffer.size()));
+    samples.span().copy_to(buffer);
+    return samples.size();
+}
+
 Loader::Loader(NonnullOwnPtr<LoaderPlugin> plugin)
     : m_plugin(move(plugin))
 {
@@ -38,6 +38,10 @@ public:
 
     virtual LoaderSamples get_more_samples(size_t max_bytes_to_read_from_input = 128 * KiB) = 0;
 
+    // Decodes samples into the buffer and returns how many there were, which is zero at the end of the stream.
+    // Unlike get_more_samples(), this lets callers reuse one buffer for a whole stream.
+    virtual ErrorOr<size_t, LoaderError> load_samples(Span<Sample> buffer);
+
     virtual MaybeLoaderError reset() = 0;
 
     virtual MaybeLoaderError seek(int const sample_index) = 0;
@@ -75,6 +79,7 @@ public:
     static Result<NonnullRefPtr<Loader>, LoaderError> create(Bytes& buffer) { return adopt_ref(*new Loader(TRY(try_create(buffer)))); }
 
     LoaderSamples get_more_samples(size_t max_samples_to_read_from_input = 128 * KiB) const { return m_plugin->get_more_samples(max_samples_to_read_from_input); }
+    ErrorOr<size_t, LoaderError> load_samples(Span<Sample> buffer) const { return m_plugin->load_samples(buffer); }
 
     MaybeLoaderError reset() const { return m_plugin->reset(); }
     MaybeLoaderError seek(int const position) const { return m_plugin->seek(position); }
@@ -60,34 +60,71 @@ MaybeLoaderError MP3LoaderPlugin::reset()
 
 MaybeLoaderError MP3LoaderPlugin::seek(int const position)
 {
-    for (auto const& seek_entry : m_seek_table) {
-        if (seek_entry.get<1>() >= position) {
-            LOADER_TRY(m_stream->seek(seek_entry.get<0>(), Core::Stream::SeekMode::SetPosition));
-            m_loaded_samples = seek_entry.get<1>();
-            break;
-        }
+    // A frame can take its main data from the bit reservoir of the frames before it, and its first samples
+    // are overlapped with the last ones of the previous frame. So we start decoding a few frames early,
+    // which gives us properly decoded samples by the time we reach the target.
+    constexpr int priming_samples = 4 * 1152;
+    int const decoding_start = max(position - priming_samples, 0);
+
+    // Find the last frame that starts at or before where we want to start decoding.
+    size_t low = 0;
+    size_t high = m_seek_table.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (m_seek_table[middle].get<1>() <= decoding_start)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    size_t byte_offset = 0;
+    m_loaded_samples = 0;
+    if (low > 0) {
+        byte_offset = m_seek_table[low - 1].get<0>();
+        m_loaded_samples = m_seek_table[low - 1].get<1>();
     }
+    LOADER_TRY(m_stream->seek(byte_offset, Core::Stream::SeekMode::SetPosition));
+    m_bitstream->align_to_byte_boundary();
+
     m_current_frame = {};
     m_current_frame_read = 0;
     m_synthesis_buffer = {};
+    m_last_values = {};
     m_bit_reservoir.discard_or_error(m_bit_reservoir.size());
     m_bit_reservoir.handle_any_error();
     m_is_first_frame = true;
+
+    Array<Sample, 1152> discarded_samples;
+    while (m_loaded_samples < static_cast<size_t>(position)) {
+        auto to_discard = min(discarded_samples.size(), static_cast<size_t>(position) - m_loaded_samples);
+        if (TRY(load_samples(discarded_samples.span().trim(to_discard))) == 0)
+            break;
+    }
     return {};
 }
 
 LoaderSamples MP3LoaderPlugin::get_more_samples(size_t max_samples_to_read_from_input)
 {
     FixedArray<Sample> samples = LOADER_TRY(FixedArray<Sample>::try_create(max_samples_to_read_from_input));
+    auto loaded_samples = TRY(load_samples(samples.span()));
+    if (loaded_samples == samples.size())
+        return samples;
+
+    // We ran into the end of the stream.
+    auto all_loaded_samples = LOADER_TRY(FixedArray<Sample>::try_create(loaded_samples));
+    samples.span().trim(loaded_samples).copy_to(all_loaded_samples.span());
+    return all_loaded_samples;
+}
 
-    size_t samples_to_read = max_samples_to_read_from_input;
+ErrorOr<size_t, LoaderError> MP3LoaderPlugin::load_samples(Span<Sample> samples)
+{
+    size_t samples_to_read = samples.size();
     while (samples_to_read > 0) {
         if (!m_current_frame.has_value()) {
             auto maybe_frame = read_next_frame();
             if (maybe_frame.is_error()) {
-                if (m_stream->is_eof()) {
-                    return FixedArray<Sample> {};
-                }
+                if (m_stream->is_eof())
+                    break;
                 return maybe_frame.release_error();
             }
             m_current_frame = maybe_frame.release_value();
@@ -115,32 +152,32 @@ LoaderSamples MP3LoaderPlugin::get_more_samples(size_t max_samples_to_read_from_
         }
     }
 
-    m_loaded_samples += samples.size();
-    return samples;
+    auto loaded_samples = samples.size() - samples_to_read;
+    m_loaded_samples += loaded_samples;
+    return loaded_samples;
 }
 
 MaybeLoaderError MP3LoaderPlugin::build_seek_table()
 {
     int sample_count = 0;
-    size_t frame_count = 0;
     m_seek_table.clear();
 
     m_bitstream->align_to_byte_boundary();
 
     while (!synchronize().is_error()) {
-        auto const frame_pos = -2 + LOADER_TRY(m_stream->seek(0, Core::Stream::SeekMode::FromCurrentPosition));
+        // The bit stream has consumed the two bytes of the sync word.
+        auto const frame_pos = LOADER_TRY(m_stream->tell()) - 2;
 
         auto error_or_header = read_header();
         if (error_or_header.is_error() || error_or_header.value().id != 1 || error_or_header.value().layer != 3) {
             continue;
         }
-        frame_count++;
-        sample_count += 1152;
 
-        if (frame_count % 10 == 0)
-            m_seek_table.append({ frame_pos, sample_count });
+        // Remembering every frame is cheap, and lets seeking start decoding right where it's needed.
+        LOADER_TRY(m_seek_table.try_append({ frame_pos, sample_count }));
+        sample_count += 1152;
 
-        LOADER_TRY(m_stream->seek(error_or_header.value().frame_size - 6, Core::Stream::SeekMode::FromCurrentPosition));
+        LOADER_TRY(m_stream->seek(frame_pos + error_or_header.value().frame_size, Core::Stream::SeekMode::SetPosition));
 
         // TODO: This is just here to clear the bitstream buffer.
         // Bitstream should have a method to sync its state to the underlying stream.
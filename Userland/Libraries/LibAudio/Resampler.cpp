@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <AK/SIMD.h>
+#include <LibAudio/Resampler.h>
+
+namespace Audio {
+
+using AK::SIMD::f32x4;
+
+static_assert(SincResampler::filter_length % 4 == 0);
+
+// The input samples before the center of the filter; the first output sample lines up with the first input sample.
+static constexpr size_t history_length = SincResampler::filter_length / 2 - 1;
+
+static u32 greatest_common_divisor(u32 a, u32 b)
+{
+    while (b != 0) {
+        auto remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    return a;
+}
+
+static double sinc(double x)
+{
+    if (x == 0)
+        return 1;
+    return AK::sin(AK::Pi<double> * x) / (AK::Pi<double> * x);
+}
+
+static double blackman_window(double x)
+{
+    // x is the distance from the center of the filter, in samples.
+    auto position = 2 * AK::Pi<double> * x / SincResampler::filter_length;
+    return 0.42 + 0.5 * AK::cos(position) + 0.08 * AK::cos(2 * position);
+}
+
+ErrorOr<SincResampler> SincResampler::try_create(u32 source, u32 target)
+{
+    VERIFY(source > 0);
+    VERIFY(target > 0);
+
+    auto divisor = greatest_common_divisor(source, target);
+    u32 input_step = source / divisor;
+    u32 output_step = target / divisor;
+
+    size_t phase_count = min<size_t>(output_step, max_phase_count);
+    auto coefficients = TRY(FixedArray<float>::try_create(phase_count * filter_length));
+
+    // When downsampling, the cutoff has to move down to the target's Nyquist frequency to avoid aliasing.
+    // It also sits a bit below Nyquist, so that the transition band of this rather short filter doesn't alias either.
+    double cutoff = 0.95 * min(1.0, static_cast<double>(output_step) / input_step);
+
+    for (size_t phase = 0; phase < phase_count; ++phase) {
+        auto fraction = static_cast<double>(phase) / phase_count;
+        auto* phase_coefficients = &coefficients[phase * filter_length];
+
+        double sum = 0;
+        for (size_t tap = 0; tap < filter_length; ++tap) {
+            auto x = static_cast<double>(tap) - history_length - fraction;
+            auto coefficient = cutoff * sinc(cutoff * x) * blackman_window(x);
+            phase_coefficients[tap] = static_cast<float>(coefficient);
+            sum += coefficient;
+        }
+        // Normalize every phase to unity gain, so that a constant signal stays constant.
+        for (size_t tap = 0; tap < filter_length; ++tap)
+            phase_coefficients[tap] = static_cast<float>(phase_coefficients[tap] / sum);
+    }
+
+    SincResampler resampler { source, target, input_step, output_step, move(coefficients) };
+    resampler.reset();
+    return resampler;
+}
+
+SincResampler::SincResampler(u32 source, u32 target, u32 input_step, u32 output_step, FixedArray<float> coefficients)
+    : m_source(source)
+    , m_target(target)
+    , m_input_step(input_step)
+    , m_output_step(output_step)
+    , m_coefficients(move(coefficients))
+{
+}
+
+void SincResampler::reset()
+{
+    m_left.clear_with_capacity();
+    m_right.clear_with_capacity();
+    m_left.resize(history_length);
+    m_right.resize(history_length);
+    m_phase = 0;
+}
+
+size_t SincResampler::output_count_for_buffered_input() const
+{
+    if (m_left.size() < filter_length)
+        return 0;
+    // Output sample j starts at input (m_phase + j * input_step) / output_step, and needs that plus filter_length inputs.
+    u64 available_positions = static_cast<u64>(m_left.size() - filter_length + 1) * m_output_step;
+    if (available_positions <= m_phase)
+        return 0;
+    return ceil_div(available_positions - m_phase, static_cast<u64>(m_input_step));
+}
+
+static ALWAYS_INLINE float horizontal_sum(f32x4 value)
+{
+    return (value[0] + value[1]) + (value[2] + value[3]);
+}
+
+ErrorOr<FixedArray<Sample>> SincResampler::resample(Span<Sample const> input)
+{
+    TRY(m_left.try_ensure_capacity(m_left.size() + input.size()));
+    TRY(m_right.try_ensure_capacity(m_right.size() + input.size()));
+    for (auto const& sample : input) {
+        m_left.unchecked_append(sample.left);
+        m_right.unchecked_append(sample.right);
+    }
+
+    auto output = TRY(FixedArray<Sample>::try_create(output_count_for_buffered_input()));
+    size_t phase_count = m_coefficients.size() / filter_length;
+
+    size_t start = 0;
+    for (auto& output_sample : output) {
+        auto const* coefficients = &m_coefficients[static_cast<u64>(m_phase) * phase_count / m_output_step * filter_length];
+        auto const* left = m_left.data() + start;
+        auto const* right = m_right.data() + start;
+
+        f32x4 left_sum {};
+        f32x4 right_sum {};
+        for (size_t tap = 0; tap < filter_length; tap += 4) {
+            f32x4 taps;
+            f32x4 left_samples;
+            f32x4 right_samples;
+            __builtin_memcpy(&taps, coefficients + tap, sizeof(taps));
+            __builtin_memcpy(&left_samples, left + tap, sizeof(left_samples));
+            __builtin_memcpy(&right_samples, right + tap, sizeof(right_samples));
+            left_sum += taps * left_samples;
+            right_sum += taps * right_samples;
+        }
+        output_sample = { horizontal_sum(left_sum), horizontal_sum(right_sum) };
+
+        m_phase += m_input_step;
+        start += m_phase / m_output_step;
+        m_phase %= m_output_step;
+    }
+
+    // Keep the inputs that the next output sample still needs.
+    m_left.remove(0, start);
+    m_right.remove(0, start);
+    return output;
+}
+
+}
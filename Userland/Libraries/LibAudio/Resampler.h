@@ -7,8 +7,12 @@
 #pragma once
 
 #include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/FixedArray.h>
+#include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
+#include <LibAudio/Sample.h>
 
 namespace Audio {
 
@@ -84,4 +88,44 @@ private:
     SampleType m_last_sample_r {};
 };
 
+// A polyphase windowed-sinc resampler for streams of samples.
+// Unlike ResampleHelper, it keeps the last few input samples around between batches,
+// so it should only be reset when the stream is interrupted (e.g. when seeking).
+class SincResampler {
+public:
+    // Taps of the interpolation filter, half of which lie on either side of the output sample.
+    static constexpr size_t filter_length = 32;
+    // Rate ratios that need more phases than this share the closest precomputed phase.
+    static constexpr size_t max_phase_count = 512;
+
+    static ErrorOr<SincResampler> try_create(u32 source, u32 target);
+
+    // Resamples the next batch of the stream. The output lags the input by half the filter length.
+    ErrorOr<FixedArray<Sample>> resample(Span<Sample const>);
+
+    void reset();
+
+    u32 source() const { return m_source; }
+    u32 target() const { return m_target; }
+
+private:
+    SincResampler(u32 source, u32 target, u32 input_step, u32 output_step, FixedArray<float> coefficients);
+
+    size_t output_count_for_buffered_input() const;
+
+    const u32 m_source;
+    const u32 m_target;
+    // Each output sample advances the input position by input_step / output_step samples.
+    const u32 m_input_step;
+    const u32 m_output_step;
+    // filter_length coefficients per phase.
+    FixedArray<float> m_coefficients;
+
+    // Planar input samples, starting with the first tap of the next output sample.
+    Vector<float> m_left;
+    Vector<float> m_right;
+    // The fractional input position of the next output sample, in units of 1 / output_step.
+    u32 m_phase { 0 };
+};
+
 }
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "cpu_features.h"
+#include <string.h>
+
+extern "C" {
+
+extern void* memcpy_sse2(void*, void const*, size_t);
+extern void* memcpy_sse2_erms(void*, void const*, size_t);
+
+namespace {
+[[gnu::used]] decltype(&memcpy) resolve_memcpy()
+{
+    // Just like rep stosb in memset(), rep movsb is slower than SSE copies on TCG.
+    if (is_running_on_tcg())
+        return memcpy_sse2;
+
+    if (has_fast_rep_movsb_and_stosb())
+        return memcpy_sse2_erms;
+
+    return memcpy_sse2;
+}
+}
+
+#if !defined(AK_COMPILER_CLANG) && !defined(_DYNAMIC_LOADER)
+[[gnu::ifunc("resolve_memcpy")]] void* memcpy(void*, void const*, size_t);
+#else
+// DynamicLoader can't self-relocate IFUNCs.
+// FIXME: There's a circular dependency between LibC and libunwind when built with Clang,
+// so the IFUNC resolver could be called before LibC has been relocated, returning bogus addresses.
+void* memcpy(void* dest_ptr, void const* src_ptr, size_t n)
+{
+    static decltype(&memcpy) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_memcpy();
+
+    return s_impl(dest_ptr, src_ptr, n);
+}
+#endif
+}
@@ -20,20 +20,26 @@ void __pthread_fork_atfork_register_child(void (*)(void));
 
 int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t*);
 
+// Set once the process creates its first thread, and never cleared. Until then, nobody can contend for a lock.
+extern bool __pthread_has_created_threads;
+
 typedef void (*KeyDestructor)(void*);
 
 void __pthread_key_destroy_for_current_thread(void);
 
 #define __PTHREAD_MUTEX_NORMAL 0
 #define __PTHREAD_MUTEX_RECURSIVE 1
-#define __PTHREAD_MUTEX_INITIALIZER     \
-    {                                   \
-        0, 0, 0, __PTHREAD_MUTEX_NORMAL \
+#define __PTHREAD_PRIO_NONE 0
+#define __PTHREAD_PRIO_INHERIT 1
+#define __PTHREAD_PRIO_PROTECT 2
+#define __PTHREAD_MUTEX_INITIALIZER                          \
+    {                                                        \
+        0, 0, 0, __PTHREAD_MUTEX_NORMAL, __PTHREAD_PRIO_NONE \
     }
 
-#define __PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP \
-    {                                            \
-        0, 0, 0, __PTHREAD_MUTEX_RECURSIVE       \
+#define __PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP                \
+    {                                                           \
+        0, 0, 0, __PTHREAD_MUTEX_RECURSIVE, __PTHREAD_PRIO_NONE \
     }
 
 __END_DECLS
@@ -21,7 +21,7 @@ public:
         : m_fd(fd)
         , m_mode(mode)
     {
-        pthread_mutexattr_t attr = { __PTHREAD_MUTEX_RECURSIVE };
+        pthread_mutexattr_t attr = { __PTHREAD_MUTEX_RECURSIVE, __PTHREAD_PRIO_NONE };
         pthread_mutex_init(&m_mutex, &attr);
     }
     ~FILE();
@@ -140,17 +140,21 @@ public:
     using List = IntrusiveList<&FILE::m_list_node>;
 };
 
+// Skips locking in processes that have only ever had a single thread, nobody could be holding the lock then.
+// flockfile() always locks, so that its lock stays in place even if the process starts a thread in the meantime.
 class ScopedFileLock {
 public:
     ScopedFileLock(FILE* file)
-        : m_file(file)
+        : m_file(__pthread_has_created_threads ? file : nullptr)
     {
-        m_file->lock();
+        if (m_file)
+            m_file->lock();
     }
 
     ~ScopedFileLock()
     {
-        m_file->unlock();
+        if (m_file)
+            m_file->unlock();
     }
 
 private:
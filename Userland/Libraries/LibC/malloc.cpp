@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/BuiltinWrappers.h>
 #include <AK/Debug.h>
 #include <AK/ScopedValueRollback.h>
@@ -55,6 +56,7 @@ static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
 static bool s_profiling = false;
+static size_t s_profiling_sample_interval = 0;
 static bool s_in_userspace_emulator = false;
 
 ALWAYS_INLINE static void ue_notify_malloc(void const* ptr, size_t size)
@@ -81,6 +83,83 @@ ALWAYS_INLINE static void ue_notify_chunk_size_changed(void const* block, size_t
         syscall(SC_emuctl, 4, chunk_size, (FlatPtr)block);
 }
 
+// When sampling allocations for the profiler, about one allocation is reported per s_profiling_sample_interval
+// allocated bytes. The reported size is the number of bytes the sample stands for, so that the profile adds up
+// to an estimate of the real allocation volume.
+#ifndef NO_TLS
+static __thread ssize_t s_bytes_until_next_profiling_sample;
+#else
+static ssize_t s_bytes_until_next_profiling_sample;
+#endif
+
+// The addresses of allocations that were reported while sampling, so that we only report their free() and not
+// everyone else's. malloc() can't allocate memory for its own bookkeeping, so this is a fixed-size set made of
+// cache line sized buckets. Allocations that don't fit just aren't sampled.
+struct alignas(64) SampledAllocationBucket {
+    Atomic<FlatPtr> pointers[64 / sizeof(FlatPtr)];
+};
+static constexpr size_t sampled_allocation_bucket_count = 256;
+static SampledAllocationBucket s_sampled_allocations[sampled_allocation_bucket_count];
+
+static SampledAllocationBucket& sampled_allocation_bucket_for(FlatPtr ptr)
+{
+    return s_sampled_allocations[((ptr >> 4) * 2654435761u) % sampled_allocation_bucket_count];
+}
+
+static bool remember_sampled_allocation(FlatPtr ptr)
+{
+    for (auto& slot : sampled_allocation_bucket_for(ptr).pointers) {
+        FlatPtr expected = 0;
+        if (slot.compare_exchange_strong(expected, ptr, AK::MemoryOrder::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+static bool forget_sampled_allocation(FlatPtr ptr)
+{
+    for (auto& slot : sampled_allocation_bucket_for(ptr).pointers) {
+        FlatPtr expected = ptr;
+        if (slot.load(AK::MemoryOrder::memory_order_relaxed) == ptr && slot.compare_exchange_strong(expected, 0, AK::MemoryOrder::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+static void report_sampled_malloc(void const* ptr, size_t size)
+{
+    // Pick the distance to the next sample at random so that allocation patterns can't line up with the interval.
+    s_bytes_until_next_profiling_sample = 1 + arc4random_uniform(2 * s_profiling_sample_interval);
+
+    if (!remember_sampled_allocation(reinterpret_cast<FlatPtr>(ptr)))
+        return;
+
+    // Small allocations get sampled with a probability of roughly size / interval, large ones always get sampled.
+    perf_event(PERF_EVENT_MALLOC, max(size, s_profiling_sample_interval), reinterpret_cast<FlatPtr>(ptr));
+}
+
+ALWAYS_INLINE static void profiling_notify_malloc(void const* ptr, size_t size)
+{
+    if (!s_profiling)
+        return;
+    if (!s_profiling_sample_interval) {
+        perf_event(PERF_EVENT_MALLOC, size, reinterpret_cast<FlatPtr>(ptr));
+        return;
+    }
+    s_bytes_until_next_profiling_sample -= size;
+    if (s_bytes_until_next_profiling_sample <= 0)
+        report_sampled_malloc(ptr, size);
+}
+
+ALWAYS_INLINE static void profiling_notify_free(void const* ptr)
+{
+    if (!s_profiling)
+        return;
+    if (s_profiling_sample_interval && (!ptr || !forget_sampled_allocation(reinterpret_cast<FlatPtr>(ptr))))
+        return;
+    perf_event(PERF_EVENT_FREE, reinterpret_cast<FlatPtr>(ptr), 0);
+}
+
 struct MemoryAuditingSuppressor {
     ALWAYS_INLINE MemoryAuditingSuppressor()
     {
@@ -116,6 +195,9 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_refills;
+    size_t number_of_thread_cache_drains;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -216,13 +298,38 @@ static inline bool block_has_aligned_chunk(long align, long bytes_per_chunk, lon
 
 // --- END MATH ---
 
+// Returns the index of the smallest size class that can hold the given size.
+static constexpr size_t size_class_index_for(size_t size)
+{
+    if (size <= 64)
+        return size <= 16 ? 0 : (size + 15) / 16 - 1;
+    // Above 64, there are size_classes_per_power_of_two classes between each power of two and the next.
+    auto last_byte = size - 1;
+    size_t log2 = sizeof(size_t) * 8 - 1 - count_leading_zeroes(last_byte);
+    size_t step_in_power_of_two = ((last_byte - (1ul << log2)) >> (log2 - 2)) + 1;
+    return 3 + (log2 - 6) * size_classes_per_power_of_two + step_in_power_of_two;
+}
+
+consteval bool check_size_class_index_for()
+{
+    for (size_t size = 1; size <= largest_size_class; ++size) {
+        auto index = size_class_index_for(size);
+        if (index >= num_size_classes || size_classes[index] < size || (index > 0 && size_classes[index - 1] >= size))
+            return false;
+    }
+    return true;
+}
+static_assert(check_size_class_index_for());
+
 static Allocator* allocator_for_size(size_t size, size_t& good_size, size_t align = 1)
 {
-    for (size_t i = 0; size_classes[i]; ++i) {
-        auto& allocator = allocators()[i];
-        if (size <= size_classes[i] && block_has_aligned_chunk(align, allocator.size, (ChunkedBlock::block_size - sizeof(ChunkedBlock)) / allocator.size)) {
-            good_size = size_classes[i];
-            return &allocator;
+    if (size <= largest_size_class) {
+        for (size_t i = size_class_index_for(size); i < num_size_classes; ++i) {
+            auto& allocator = allocators()[i];
+            if (block_has_aligned_chunk(align, allocator.size, (ChunkedBlock::block_size - sizeof(ChunkedBlock)) / allocator.size)) {
+                good_size = size_classes[i];
+                return &allocator;
+            }
         }
     }
     good_size = PAGE_ROUND_UP(size);
@@ -294,6 +401,184 @@ enum class CallerWillInitializeMemory {
 __thread bool s_allocation_enabled = true;
 #endif
 
+// Takes a chunk from one of the allocator's blocks, setting up a new block if necessary.
+// NOTE: This must be called with s_malloc_mutex held.
+static ErrorOr<void*> allocate_chunk(Allocator& allocator, size_t good_size, size_t align)
+{
+    ChunkedBlock* block = nullptr;
+    void* ptr = nullptr;
+    for (auto& current : allocator.usable_blocks) {
+        if (current.free_chunks()) {
+            ptr = try_allocate_chunk_aligned(align, current);
+            if (ptr) {
+                block = &current;
+                break;
+            }
+        }
+    }
+
+    if (!block && s_hot_empty_block_count) {
+        g_malloc_stats.number_of_hot_empty_block_hits++;
+        block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        if (block->m_size != good_size) {
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+            set_mmap_name(block, ChunkedBlock::block_size, buffer);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block && s_cold_empty_block_count) {
+        g_malloc_stats.number_of_cold_empty_block_hits++;
+        block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            VERIFY_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            VERIFY_NOT_REACHED();
+        }
+        if (this_block_was_purged || block->m_size != good_size) {
+            if (this_block_was_purged)
+                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block) {
+        g_malloc_stats.number_of_block_allocs++;
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
+        new (block) ChunkedBlock(good_size);
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
+    }
+
+    if (!ptr) {
+        ptr = try_allocate_chunk_aligned(align, *block);
+    }
+
+    VERIFY(ptr);
+    if (block->is_full()) {
+        g_malloc_stats.number_of_blocks_full++;
+        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
+    }
+    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    return ptr;
+}
+
+// Puts a chunk back into its block, and recycles the block if it became empty.
+// NOTE: This must be called with s_malloc_mutex held.
+static void free_chunk(ChunkedBlock& block, void* ptr)
+{
+    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, &block, block.bytes_per_chunk(), block.used_chunks());
+
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block.m_freelist;
+    block.m_freelist = entry;
+
+    if (block.is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block.m_size, good_size);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", &block, good_size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(block);
+        allocator->usable_blocks.prepend(block);
+    }
+
+    ++block.m_free_chunks;
+
+    if (!block.used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block.m_size, good_size);
+        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", &block);
+            g_malloc_stats.number_of_hot_keeps++;
+            allocator->usable_blocks.remove(block);
+            s_hot_empty_blocks[s_hot_empty_block_count++] = &block;
+            return;
+        }
+        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", &block);
+            g_malloc_stats.number_of_cold_keeps++;
+            allocator->usable_blocks.remove(block);
+            s_cold_empty_blocks[s_cold_empty_block_count++] = &block;
+            mprotect(&block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(&block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", &block, good_size);
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(block);
+        --allocator->block_count;
+        os_free(&block, ChunkedBlock::block_size);
+    }
+}
+
+#ifndef NO_TLS
+// Every thread keeps some free chunks of the smaller size classes to itself, so that most allocations and frees
+// don't have to take s_malloc_mutex. The caches are filled from and drained back into the shared blocks in batches.
+static constexpr size_t largest_thread_cached_size_class = 1024;
+static constexpr size_t number_of_thread_cached_size_classes = size_class_index_for(largest_thread_cached_size_class) + 1;
+static constexpr size_t thread_cache_batch_bytes = 2 * KiB;
+
+struct ThreadCache {
+    struct Bin {
+        FreelistEntry* chunks;
+        size_t chunk_count;
+    };
+    Bin bins[number_of_thread_cached_size_classes];
+};
+
+static __thread ThreadCache s_thread_cache;
+static bool s_use_thread_caches = true;
+
+static constexpr size_t thread_cache_batch_size(size_t size_class_index)
+{
+    return clamp(thread_cache_batch_bytes / size_classes[size_class_index], 2, 32);
+}
+
+// NOTE: This must be called with s_malloc_mutex held.
+static void refill_thread_cache_bin(size_t size_class_index)
+{
+    g_malloc_stats.number_of_thread_cache_refills++;
+    auto& bin = s_thread_cache.bins[size_class_index];
+    auto& allocator = allocators()[size_class_index];
+    for (size_t i = 0; i < thread_cache_batch_size(size_class_index); ++i) {
+        auto ptr_or_error = allocate_chunk(allocator, allocator.size, 16);
+        if (ptr_or_error.is_error())
+            break;
+        auto* entry = (FreelistEntry*)ptr_or_error.value();
+        entry->next = bin.chunks;
+        bin.chunks = entry;
+        ++bin.chunk_count;
+    }
+}
+
+// NOTE: This must be called with s_malloc_mutex held.
+static void drain_thread_cache_bin(ThreadCache::Bin& bin, size_t count)
+{
+    g_malloc_stats.number_of_thread_cache_drains++;
+    for (; count && bin.chunks; --count) {
+        auto* entry = bin.chunks;
+        bin.chunks = entry->next;
+        --bin.chunk_count;
+        free_chunk(*(ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask), entry);
+    }
+}
+#endif
+
 static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
 {
 #ifndef NO_TLS
@@ -322,6 +607,27 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
+#ifndef NO_TLS
+    if (allocator && align <= 16 && s_use_thread_caches) {
+        size_t size_class_index = allocator - allocators();
+        if (size_class_index < number_of_thread_cached_size_classes) {
+            auto& bin = s_thread_cache.bins[size_class_index];
+            if (!bin.chunks) {
+                PthreadMutexLocker locker(s_malloc_mutex);
+                refill_thread_cache_bin(size_class_index);
+            }
+            if (auto* entry = bin.chunks) {
+                bin.chunks = entry->next;
+                --bin.chunk_count;
+                if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+                    memset(entry, MALLOC_SCRUB_BYTE, good_size);
+                ue_notify_malloc(entry, size);
+                return entry;
+            }
+        }
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (!allocator) {
@@ -366,79 +672,10 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         return ptr;
     }
 
-    ChunkedBlock* block = nullptr;
-    void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
-        if (current.free_chunks()) {
-            ptr = try_allocate_chunk_aligned(align, current);
-            if (ptr) {
-                block = &current;
-                break;
-            }
-        }
-    }
-
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
-        if (block->m_size != good_size) {
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-            set_mmap_name(block, ChunkedBlock::block_size, buffer);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
-    }
-
-    if (!ptr) {
-        ptr = try_allocate_chunk_aligned(align, *block);
-    }
-
-    VERIFY(ptr);
-    if (block->is_full()) {
-        g_malloc_stats.number_of_blocks_full++;
-        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
-    }
-    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    void* ptr = TRY(allocate_chunk(*allocator, good_size, align));
 
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -460,6 +697,28 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
+#ifndef NO_TLS
+    if (magic == MAGIC_PAGE_HEADER && s_use_thread_caches) {
+        auto* block = (ChunkedBlock*)block_base;
+        auto size_class_index = size_class_index_for(block->m_size);
+        if (size_class_index < number_of_thread_cached_size_classes) {
+            if (s_scrub_free)
+                memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
+            auto& bin = s_thread_cache.bins[size_class_index];
+            auto batch_size = thread_cache_batch_size(size_class_index);
+            if (bin.chunk_count >= 2 * batch_size) {
+                PthreadMutexLocker locker(s_malloc_mutex);
+                drain_thread_cache_bin(bin, batch_size);
+            }
+            auto* entry = (FreelistEntry*)ptr;
+            entry->next = bin.chunks;
+            bin.chunks = entry;
+            ++bin.chunk_count;
+            return;
+        }
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (magic == MAGIC_BIGALLOC_HEADER) {
@@ -490,51 +749,10 @@ static void free_impl(void* ptr)
     assert(magic == MAGIC_PAGE_HEADER);
     auto* block = (ChunkedBlock*)block_base;
 
-    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
-
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
-    }
-
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    free_chunk(*block, ptr);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
@@ -548,9 +766,7 @@ void* malloc(size_t size)
         return nullptr;
     }
 
-    if (s_profiling)
-        perf_event(PERF_EVENT_MALLOC, size, reinterpret_cast<FlatPtr>(ptr_or_error.value()));
-
+    profiling_notify_malloc(ptr_or_error.value(), size);
     return ptr_or_error.value();
 }
 
@@ -558,8 +774,7 @@ void* malloc(size_t size)
 void free(void* ptr)
 {
     MemoryAuditingSuppressor suppressor;
-    if (s_profiling)
-        perf_event(PERF_EVENT_FREE, reinterpret_cast<FlatPtr>(ptr), 0);
+    profiling_notify_free(ptr);
     ue_notify_free(ptr);
     free_impl(ptr);
 }
@@ -581,6 +796,7 @@ void* calloc(size_t count, size_t size)
     }
 
     memset(ptr_or_error.value(), 0, new_size);
+    profiling_notify_malloc(ptr_or_error.value(), new_size);
     return ptr_or_error.value();
 }
 
@@ -593,6 +809,7 @@ int posix_memalign(void** memptr, size_t alignment, size_t size)
     if (ptr_or_error.is_error())
         return ptr_or_error.error().code();
 
+    profiling_notify_malloc(ptr_or_error.value(), size);
     *memptr = ptr_or_error.value();
     return 0;
 }
@@ -607,6 +824,7 @@ void* aligned_alloc(size_t alignment, size_t size)
         return nullptr;
     }
 
+    profiling_notify_malloc(ptr_or_error.value(), size);
     return ptr_or_error.value();
 }
 
@@ -632,6 +850,24 @@ size_t malloc_good_size(size_t size)
     return good_size;
 }
 
+// When a big allocation shrinks, the pages past its new end are handed back to the kernel right away.
+// They'll read back as zeroes should the allocation grow into them again.
+static void release_unused_pages_of_big_allocation(void* ptr, size_t size)
+{
+    void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::block_mask);
+    if (*(size_t*)block_base != MAGIC_BIGALLOC_HEADER)
+        return;
+    auto* block = (BigAllocationBlock*)block_base;
+    auto unused_start = round_up_to_power_of_two((FlatPtr)ptr + size, PAGE_SIZE);
+    auto block_end = (FlatPtr)block + block->m_size;
+    if (unused_start >= block_end)
+        return;
+    // NOTE: This is only advice, so a failure is nothing the caller of realloc() has to hear about, not even through errno.
+    ScopedValueRollback rollback(errno);
+    if (madvise((void*)unused_start, block_end - unused_start, MADV_DONTNEED) < 0)
+        dbgln_if(MALLOC_DEBUG, "LibC: Failed to release the unused pages of big allocation {:p}: {}", block, strerror(errno));
+}
+
 void* realloc(void* ptr, size_t size)
 {
     MemoryAuditingSuppressor suppressor;
@@ -645,6 +881,7 @@ void* realloc(void* ptr, size_t size)
     auto existing_allocation_size = malloc_size(ptr);
 
     if (size <= existing_allocation_size) {
+        release_unused_pages_of_big_allocation(ptr, size);
         ue_notify_realloc(ptr, size);
         return ptr;
     }
@@ -664,6 +901,10 @@ void __malloc_init()
         // keeps track of heap memory anyway.
         s_scrub_malloc = false;
         s_scrub_free = false;
+#ifndef NO_TLS
+        // UE expects freed chunks to go back to their block right away.
+        s_use_thread_caches = false;
+#endif
     }
 
     if (secure_getenv("LIBC_NOSCRUB_MALLOC"))
@@ -674,6 +915,11 @@ void __malloc_init()
         s_log_malloc = true;
     if (secure_getenv("LIBC_PROFILE_MALLOC"))
         s_profiling = true;
+    if (auto* sample_interval = secure_getenv("LIBC_PROFILE_MALLOC_SAMPLE_INTERVAL")) {
+        s_profiling_sample_interval = strtoul(sample_interval, nullptr, 10);
+        if (s_profiling_sample_interval)
+            s_profiling = true;
+    }
 
     for (size_t i = 0; i < num_size_classes; ++i) {
         new (&allocators()[i]) Allocator();
@@ -683,6 +929,17 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_release_thread_cache()
+{
+#ifndef NO_TLS
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (auto& bin : s_thread_cache.bins) {
+        if (bin.chunks)
+            drain_thread_cache_bin(bin, bin.chunk_count);
+    }
+#endif
+}
+
 void serenity_dump_malloc_stats()
 {
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
@@ -706,5 +963,8 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
+    dbgln("thread cache drains: {}", g_malloc_stats.number_of_thread_cache_drains);
 }
 }
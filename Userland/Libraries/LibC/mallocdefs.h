@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Types.h>
 
@@ -16,8 +17,26 @@
 
 #define PAGE_ROUND_UP(x) ((((size_t)(x)) + PAGE_SIZE - 1) & (~(PAGE_SIZE - 1)))
 
-static constexpr unsigned short size_classes[] = { 16, 32, 64, 128, 256, 496, 1008, 2032, 4080, 8176, 16368, 32752, 0 };
-static constexpr size_t num_size_classes = (sizeof(size_classes) / sizeof(unsigned short)) - 1;
+// Size classes are spaced four to a power of two (e.g. 256, 320, 384, 448, 512), which keeps the space
+// wasted by rounding up an allocation below 25%. The largest class is the largest size that a ChunkedBlock
+// can hold. The table is terminated by a 0.
+static constexpr size_t size_classes_per_power_of_two = 4;
+static constexpr size_t num_size_classes = 40;
+static constexpr unsigned short largest_size_class = 32752;
+
+static constexpr auto size_classes = [] {
+    Array<unsigned short, num_size_classes + 1> classes {};
+    size_t index = 0;
+    for (unsigned short size = 16; size <= 64; size += 16)
+        classes[index++] = size;
+    for (size_t power_of_two = 64; index < num_size_classes - 1; power_of_two *= 2) {
+        for (size_t i = 1; i <= size_classes_per_power_of_two && index < num_size_classes - 1; ++i)
+            classes[index++] = power_of_two + i * (power_of_two / size_classes_per_power_of_two);
+    }
+    classes[index] = largest_size_class;
+    return classes;
+}();
+static_assert(size_classes[num_size_classes - 2] < largest_size_class);
 
 #ifndef NO_TLS
 extern "C" {
@@ -83,3 +102,5 @@ struct ChunkedBlock : public CommonHeader {
 
     using List = IntrusiveList<&ChunkedBlock::m_list_node>;
 };
+
+static_assert((ChunkedBlock::block_size - sizeof(ChunkedBlock)) / largest_size_class >= 1);
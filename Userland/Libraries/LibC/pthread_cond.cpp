@@ -150,12 +150,27 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
     if (!(value & NEED_TO_WAKE_ALL)) [[likely]]
         return 0;
 
-    AK::atomic_fetch_and(&cond->value, ~(NEED_TO_WAKE_ONE | NEED_TO_WAKE_ALL), AK::memory_order_acquire);
+    value = AK::atomic_fetch_and(&cond->value, ~(NEED_TO_WAKE_ONE | NEED_TO_WAKE_ALL), AK::memory_order_acquire) & ~(NEED_TO_WAKE_ONE | NEED_TO_WAKE_ALL);
 
     pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
     VERIFY(mutex);
 
-    int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, 1, nullptr, &mutex->lock, INT_MAX);
-    VERIFY(rc >= 0);
+    // The waiters of a priority-inheriting mutex have to wait through the kernel's own queue for it, so we can't requeue onto it.
+    if (mutex->protocol == PTHREAD_PRIO_INHERIT) {
+        int rc = futex_wake(&cond->value, INT_MAX, false);
+        VERIFY(rc >= 0);
+        return 0;
+    }
+
+    // Wake a single waiter, and move all the others over to the mutex, where they will be woken up one by one
+    // as the mutex gets unlocked. Otherwise they would all wake up at once, only to fight over the mutex.
+    for (;;) {
+        int rc = futex(&cond->value, FUTEX_CMP_REQUEUE | FUTEX_PRIVATE_FLAG, 1, reinterpret_cast<timespec const*>(static_cast<uintptr_t>(INT_MAX)), &mutex->lock, value);
+        if (rc >= 0)
+            break;
+        // Somebody started waiting or signalled in the meantime, which is fine, but we have to try again.
+        VERIFY(errno == EAGAIN);
+        value = AK::atomic_load(&cond->value, AK::memory_order_relaxed);
+    }
     return 0;
 }
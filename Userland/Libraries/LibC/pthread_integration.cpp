@@ -27,6 +27,8 @@ static NeverDestroyed<Vector<void (*)(void), 4>> g_atfork_parent_list;
 }
 
 extern "C" {
+bool __pthread_has_created_threads = false;
+
 void __pthread_fork_prepare(void)
 {
     if (!g_did_touch_atfork.load())
@@ -97,6 +99,85 @@ static constexpr u32 MUTEX_UNLOCKED = 0;
 static constexpr u32 MUTEX_LOCKED_NO_NEED_TO_WAKE = 1;
 static constexpr u32 MUTEX_LOCKED_NEED_TO_WAKE = 2;
 
+// How many times we look at a contended mutex before going to sleep on it.
+static constexpr int MUTEX_SPIN_COUNT = 100;
+
+static ALWAYS_INLINE void spin_loop_hint()
+{
+#if ARCH(I386) || ARCH(X86_64)
+    __builtin_ia32_pause();
+#elif ARCH(AARCH64)
+    asm volatile("yield");
+#endif
+}
+
+static bool can_spin_on_contended_mutexes()
+{
+    // Spinning can only pay off if the owner gets to run at the same time as us.
+    static int s_processor_count = 0;
+    int processor_count = AK::atomic_load(&s_processor_count, AK::memory_order_relaxed);
+    if (processor_count == 0) {
+        processor_count = max(1l, sysconf(_SC_NPROCESSORS_ONLN));
+        AK::atomic_store(&s_processor_count, processor_count, AK::memory_order_relaxed);
+    }
+    return processor_count > 1;
+}
+
+// Owners usually only hold a mutex for a short while, so waiting for them to release it is often a lot
+// cheaper than going to sleep and being woken up again. Once somebody is sleeping on the mutex, the owner
+// most likely isn't about to release it (or isn't even running), so we stop spinning at that point.
+static bool try_acquire_contended_mutex_by_spinning(pthread_mutex_t* mutex, u32& value)
+{
+    if (!can_spin_on_contended_mutexes())
+        return false;
+    for (int i = 0; i < MUTEX_SPIN_COUNT && value != MUTEX_LOCKED_NEED_TO_WAKE; ++i) {
+        spin_loop_hint();
+        value = AK::atomic_load(&mutex->lock, AK::memory_order_relaxed);
+        if (value == MUTEX_UNLOCKED && AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+// Priority-inheriting mutexes store the thread ID of their owner in the lock, and leave all waiting to the kernel,
+// which lends the priority of the waiting threads to the owner for as long as it holds the mutex.
+static int lock_priority_inheriting_mutex(pthread_mutex_t* mutex, bool only_try)
+{
+    u32 tid = pthread_self();
+    u32 value = MUTEX_UNLOCKED;
+    if (!AK::atomic_compare_exchange_strong(&mutex->lock, value, tid, AK::memory_order_acquire)) {
+        if ((value & FUTEX_TID_MASK) == tid) {
+            if (mutex->type != __PTHREAD_MUTEX_RECURSIVE)
+                return only_try ? EBUSY : EDEADLK;
+            // We already own the mutex!
+            mutex->level++;
+            return 0;
+        }
+        if (only_try)
+            return EBUSY;
+        if (futex(&mutex->lock, FUTEX_LOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0) < 0)
+            return errno;
+    }
+    mutex->level = 0;
+    return 0;
+}
+
+static int unlock_priority_inheriting_mutex(pthread_mutex_t* mutex)
+{
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->level > 0) {
+        mutex->level--;
+        return 0;
+    }
+
+    u32 expected = pthread_self();
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_UNLOCKED, AK::memory_order_release))
+        return 0;
+    // Somebody is waiting for the mutex, so the kernel has to wake them up.
+    if (futex(&mutex->lock, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0) < 0)
+        return errno;
+    return 0;
+}
+
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_init.html
 int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attributes)
 {
@@ -104,12 +185,16 @@ int pthread_mutex_init(pthread_mutex_t* mutex, pthread_mutexattr_t const* attrib
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_trylock.html
 int pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) [[unlikely]]
+        return lock_priority_inheriting_mutex(mutex, true);
+
     u32 expected = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
 
@@ -132,6 +217,9 @@ int pthread_mutex_trylock(pthread_mutex_t* mutex)
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_lock.html
 int pthread_mutex_lock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) [[unlikely]]
+        return lock_priority_inheriting_mutex(mutex, false);
+
     // Fast path: attempt to claim the mutex without waiting.
     u32 value = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
@@ -149,6 +237,14 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
         }
     }
 
+    // Not quite as fast path: the owner might be about to release the mutex.
+    if (try_acquire_contended_mutex_by_spinning(mutex, value)) {
+        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
+            AK::atomic_store(&mutex->owner, pthread_self(), AK::memory_order_relaxed);
+        mutex->level = 0;
+        return 0;
+    }
+
     // Slow path: wait, record the fact that we're going to wait, and always
     // remember to wake the next thread up once we release the mutex.
     if (value != MUTEX_LOCKED_NEED_TO_WAKE)
@@ -167,6 +263,10 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
 
 int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
 {
+    // Condition variables never requeue waiters onto priority-inheriting mutexes, see pthread_cond_broadcast().
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return lock_priority_inheriting_mutex(mutex, false);
+
     // Same as pthread_mutex_lock(), but always set MUTEX_LOCKED_NEED_TO_WAKE,
     // and also don't bother checking for already owning the mutex recursively,
     // because we know we don't. Used in the condition variable implementation.
@@ -185,6 +285,9 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_unlock.html
 int pthread_mutex_unlock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) [[unlikely]]
+        return unlock_priority_inheriting_mutex(mutex);
+
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->level > 0) {
         mutex->level--;
         return 0;
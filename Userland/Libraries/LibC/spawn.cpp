@@ -13,22 +13,52 @@
 
 #include <spawn.h>
 
-#include <AK/Function.h>
+#include <AK/String.h>
 #include <AK/Vector.h>
+#include <LibCore/File.h>
+#include <alloca.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <syscall.h>
 #include <unistd.h>
 
 struct posix_spawn_file_actions_state {
-    Vector<Function<int()>, 4> actions;
+    Vector<Syscall::SC_posix_spawn_file_action, 4> actions;
 };
 
 extern "C" {
 
+static int run_file_action(Syscall::SC_posix_spawn_file_action const& action)
+{
+    switch (action.type) {
+    case Syscall::SpawnFileActionType::Close:
+        // Closing a file descriptor that isn't open is not an error, there simply is nothing to inherit.
+        if (close(action.fd) < 0 && errno != EBADF)
+            return -1;
+        return 0;
+    case Syscall::SpawnFileActionType::Dup2:
+        return dup2(action.fd, action.new_fd);
+    case Syscall::SpawnFileActionType::Open: {
+        int opened_fd = open(action.path.characters, action.options, action.mode);
+        if (opened_fd < 0 || opened_fd == action.fd)
+            return opened_fd;
+        if (int rc = dup2(opened_fd, action.fd); rc < 0)
+            return rc;
+        return close(opened_fd);
+    }
+    case Syscall::SpawnFileActionType::Chdir:
+        return chdir(action.path.characters);
+    case Syscall::SpawnFileActionType::Fchdir:
+        return fchdir(action.fd);
+    }
+    VERIFY_NOT_REACHED();
+}
+
 [[noreturn]] static void posix_spawn_child(char const* path, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[], int (*exec)(char const*, char* const[], char* const[]))
 {
     if (attr) {
@@ -81,13 +111,19 @@ extern "C" {
                 _exit(127);
             }
         }
+        if (flags & POSIX_SPAWN_TCSETPGROUP) {
+            if (tcsetpgrp(attr->tcsetpgrp_fd, getpgrp()) < 0) {
+                perror("posix_spawn tcsetpgrp");
+                _exit(127);
+            }
+        }
 
         // FIXME: POSIX_SPAWN_SETSCHEDULER
     }
 
     if (file_actions) {
         for (auto const& action : file_actions->state->actions) {
-            if (action() < 0) {
+            if (run_file_action(action) < 0) {
                 perror("posix_spawn file action");
                 _exit(127);
             }
@@ -99,9 +135,68 @@ extern "C" {
     _exit(127);
 }
 
+// The kernel can set up everything but these flags for the child itself, without copying our address space first.
+static constexpr short flags_handled_by_kernel = POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSID | POSIX_SPAWN_TCSETPGROUP;
+
+static int spawn_in_kernel(pid_t* out_pid, char const* path, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
+{
+    size_t arg_count = 0;
+    for (size_t i = 0; argv[i]; ++i)
+        ++arg_count;
+
+    size_t env_count = 0;
+    for (size_t i = 0; envp[i]; ++i)
+        ++env_count;
+
+    auto copy_strings = [&](auto& vec, size_t count, auto& output) {
+        output.length = count;
+        for (size_t i = 0; vec[i]; ++i) {
+            output.strings[i].characters = vec[i];
+            output.strings[i].length = strlen(vec[i]);
+        }
+    };
+
+    Syscall::SC_posix_spawn_params params {};
+    params.arguments.strings = (Syscall::StringArgument*)alloca(arg_count * sizeof(Syscall::StringArgument));
+    params.environment.strings = (Syscall::StringArgument*)alloca(env_count * sizeof(Syscall::StringArgument));
+
+    params.path = { path, strlen(path) };
+    copy_strings(argv, arg_count, params.arguments);
+    copy_strings(envp, env_count, params.environment);
+
+    if (file_actions) {
+        params.file_actions = file_actions->state->actions.data();
+        params.file_action_count = file_actions->state->actions.size();
+    }
+    if (attr) {
+        params.flags = attr->flags;
+        params.pgroup = attr->pgroup;
+        params.sigdefault = attr->sigdefault;
+        params.sigmask = attr->sigmask;
+        params.tty_fd = attr->tcsetpgrp_fd;
+    }
+
+    int rc = syscall(SC_posix_spawn, &params);
+    if (rc < 0)
+        return -rc;
+    *out_pid = rc;
+    return 0;
+}
+
+static bool can_spawn_in_kernel(posix_spawnattr_t const* attr)
+{
+    return !attr || !(attr->flags & ~flags_handled_by_kernel);
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn.html
 int posix_spawn(pid_t* out_pid, char const* path, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
 {
+    if (can_spawn_in_kernel(attr)) {
+        // NOTE: The kernel doesn't know posix_spawn() when we're running in UserspaceEmulator, which needs to see fork() instead.
+        if (int rc = spawn_in_kernel(out_pid, path, file_actions, attr, argv, envp); rc != ENOSYS)
+            return rc;
+    }
+
     pid_t child_pid = fork();
     if (child_pid < 0)
         return errno;
@@ -117,6 +212,28 @@ int posix_spawn(pid_t* out_pid, char const* path, posix_spawn_file_actions_t con
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawnp.html
 int posix_spawnp(pid_t* out_pid, char const* file, posix_spawn_file_actions_t const* file_actions, posix_spawnattr_t const* attr, char* const argv[], char* const envp[])
 {
+    if (can_spawn_in_kernel(attr)) {
+        if (strchr(file, '/'))
+            return posix_spawn(out_pid, file, file_actions, attr, argv, envp);
+
+        // Same search as execvpe(). Candidates that don't exist are skipped up front, as every attempt
+        // to spawn one would set up a child process only to tear it down again.
+        String search_path = getenv("PATH");
+        if (search_path.is_empty())
+            search_path = DEFAULT_PATH;
+        int rc = ENOENT;
+        for (auto& part : search_path.split(':')) {
+            auto candidate = String::formatted("{}/{}", part, file);
+            if (access(candidate.characters(), F_OK) < 0)
+                continue;
+            rc = spawn_in_kernel(out_pid, candidate.characters(), file_actions, attr, argv, envp);
+            if (rc != ENOENT)
+                break;
+        }
+        if (rc != ENOSYS)
+            return rc;
+    }
+
     pid_t child_pid = fork();
     if (child_pid < 0)
         return errno;
@@ -132,41 +249,34 @@ int posix_spawnp(pid_t* out_pid, char const* file, posix_spawn_file_actions_t co
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_addchdir.html
 int posix_spawn_file_actions_addchdir(posix_spawn_file_actions_t* actions, char const* path)
 {
-    actions->state->actions.append([path]() { return chdir(path); });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Chdir, .fd = -1, .new_fd = -1, .options = 0, .mode = 0, .path = { path, strlen(path) } });
     return 0;
 }
 
 int posix_spawn_file_actions_addfchdir(posix_spawn_file_actions_t* actions, int fd)
 {
-    actions->state->actions.append([fd]() { return fchdir(fd); });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Fchdir, .fd = fd, .new_fd = -1, .options = 0, .mode = 0, .path = {} });
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_addclose.html
 int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t* actions, int fd)
 {
-    actions->state->actions.append([fd]() { return close(fd); });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Close, .fd = fd, .new_fd = -1, .options = 0, .mode = 0, .path = {} });
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_adddup2.html
 int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t* actions, int old_fd, int new_fd)
 {
-    actions->state->actions.append([old_fd, new_fd]() { return dup2(old_fd, new_fd); });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Dup2, .fd = old_fd, .new_fd = new_fd, .options = 0, .mode = 0, .path = {} });
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawn_file_actions_addopen.html
 int posix_spawn_file_actions_addopen(posix_spawn_file_actions_t* actions, int want_fd, char const* path, int flags, mode_t mode)
 {
-    actions->state->actions.append([want_fd, path, flags, mode]() {
-        int opened_fd = open(path, flags, mode);
-        if (opened_fd < 0 || opened_fd == want_fd)
-            return opened_fd;
-        if (int rc = dup2(opened_fd, want_fd); rc < 0)
-            return rc;
-        return close(opened_fd);
-    });
+    actions->state->actions.append({ .type = Syscall::SpawnFileActionType::Open, .fd = want_fd, .new_fd = -1, .options = flags, .mode = mode, .path = { path, strlen(path) } });
     return 0;
 }
 
@@ -241,13 +351,14 @@ int posix_spawnattr_init(posix_spawnattr_t* attr)
     // attr->schedpolicy intentionally not written; its default value is unspecified.
     sigemptyset(&attr->sigdefault);
     // attr->sigmask intentionally not written; its default value is unspecified.
+    attr->tcsetpgrp_fd = -1;
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/posix_spawnattr_setflags.html
 int posix_spawnattr_setflags(posix_spawnattr_t* attr, short flags)
 {
-    if (flags & ~(POSIX_SPAWN_RESETIDS | POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSCHEDPARAM | POSIX_SPAWN_SETSCHEDULER | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSID))
+    if (flags & ~(POSIX_SPAWN_RESETIDS | POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSCHEDPARAM | POSIX_SPAWN_SETSCHEDULER | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSID | POSIX_SPAWN_TCSETPGROUP))
         return EINVAL;
 
     attr->flags = flags;
@@ -288,4 +399,17 @@ int posix_spawnattr_setsigmask(posix_spawnattr_t* attr, sigset_t const* sigmask)
     attr->sigmask = *sigmask;
     return 0;
 }
+
+// https://www.gnu.org/software/libc/manual/html_node/Functions-for-Job-Control.html (GNU extension)
+int posix_spawnattr_tcgetpgrp_np(posix_spawnattr_t const* attr, int* out_fd)
+{
+    *out_fd = attr->tcsetpgrp_fd;
+    return 0;
+}
+
+int posix_spawnattr_tcsetpgrp_np(posix_spawnattr_t* attr, int fd)
+{
+    attr->tcsetpgrp_fd = fd;
+    return 0;
+}
 }
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <Kernel/API/POSIX/spawn.h>
 #include <sched.h>
 #include <signal.h>
 #include <sys/cdefs.h>
@@ -20,21 +21,6 @@
 
 __BEGIN_DECLS
 
-enum {
-    POSIX_SPAWN_RESETIDS = 1 << 0,
-    POSIX_SPAWN_SETPGROUP = 1 << 1,
-
-    POSIX_SPAWN_SETSCHEDPARAM = 1 << 2,
-    POSIX_SPAWN_SETSCHEDULER = 1 << 3,
-
-    POSIX_SPAWN_SETSIGDEF = 1 << 4,
-    POSIX_SPAWN_SETSIGMASK = 1 << 5,
-
-    POSIX_SPAWN_SETSID = 1 << 6,
-};
-
-#define POSIX_SPAWN_SETSID POSIX_SPAWN_SETSID
-
 struct posix_spawn_file_actions_state;
 typedef struct {
     struct posix_spawn_file_actions_state* state;
@@ -47,6 +33,7 @@ typedef struct {
     int schedpolicy;
     sigset_t sigdefault;
     sigset_t sigmask;
+    int tcsetpgrp_fd;
 } posix_spawnattr_t;
 
 int posix_spawn(pid_t*, char const*, posix_spawn_file_actions_t const*, posix_spawnattr_t const*, char* const argv[], char* const envp[]);
@@ -75,4 +62,7 @@ int posix_spawnattr_setschedpolicy(posix_spawnattr_t*, int);
 int posix_spawnattr_setsigdefault(posix_spawnattr_t*, sigset_t const*);
 int posix_spawnattr_setsigmask(posix_spawnattr_t*, sigset_t const*);
 
+int posix_spawnattr_tcgetpgrp_np(posix_spawnattr_t const*, int* out_fd);
+int posix_spawnattr_tcsetpgrp_np(posix_spawnattr_t*, int fd);
+
 __END_DECLS
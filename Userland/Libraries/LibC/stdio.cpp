@@ -594,6 +594,12 @@ int fileno(FILE* stream)
     return stream->fileno();
 }
 
+int fileno_unlocked(FILE* stream)
+{
+    VERIFY(stream);
+    return stream->fileno();
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/feof.html
 int feof(FILE* stream)
 {
@@ -602,6 +608,12 @@ int feof(FILE* stream)
     return stream->eof();
 }
 
+int feof_unlocked(FILE* stream)
+{
+    VERIFY(stream);
+    return stream->eof();
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/fflush.html
 int fflush(FILE* stream)
 {
@@ -618,11 +630,24 @@ int fflush(FILE* stream)
     return stream->flush() ? 0 : EOF;
 }
 
+int fflush_unlocked(FILE* stream)
+{
+    if (!stream)
+        return fflush(nullptr);
+    return stream->flush() ? 0 : EOF;
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/fgets.html
 char* fgets(char* buffer, int size, FILE* stream)
 {
     VERIFY(stream);
     ScopedFileLock lock(stream);
+    return fgets_unlocked(buffer, size, stream);
+}
+
+char* fgets_unlocked(char* buffer, int size, FILE* stream)
+{
+    VERIFY(stream);
     bool ok = stream->gets(reinterpret_cast<u8*>(buffer), size);
     return ok ? buffer : nullptr;
 }
@@ -666,6 +691,12 @@ int getchar()
     return getc(stdin);
 }
 
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/getchar_unlocked.html
+int getchar_unlocked()
+{
+    return getc_unlocked(stdin);
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/getdelim.html
 ssize_t getdelim(char** lineptr, size_t* n, int delim, FILE* stream)
 {
@@ -732,8 +763,14 @@ int ungetc(int c, FILE* stream)
 int fputc(int ch, FILE* stream)
 {
     VERIFY(stream);
-    u8 byte = ch;
     ScopedFileLock lock(stream);
+    return fputc_unlocked(ch, stream);
+}
+
+int fputc_unlocked(int ch, FILE* stream)
+{
+    VERIFY(stream);
+    u8 byte = ch;
     size_t nwritten = stream->write(&byte, 1);
     if (nwritten == 0)
         return EOF;
@@ -747,18 +784,36 @@ int putc(int ch, FILE* stream)
     return fputc(ch, stream);
 }
 
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/putc_unlocked.html
+int putc_unlocked(int ch, FILE* stream)
+{
+    return fputc_unlocked(ch, stream);
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/putchar.html
 int putchar(int ch)
 {
     return putc(ch, stdout);
 }
 
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/putchar_unlocked.html
+int putchar_unlocked(int ch)
+{
+    return putc_unlocked(ch, stdout);
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/fputs.html
 int fputs(char const* s, FILE* stream)
 {
     VERIFY(stream);
-    size_t len = strlen(s);
     ScopedFileLock lock(stream);
+    return fputs_unlocked(s, stream);
+}
+
+int fputs_unlocked(char const* s, FILE* stream)
+{
+    VERIFY(stream);
+    size_t len = strlen(s);
     size_t nwritten = stream->write(reinterpret_cast<u8 const*>(s), len);
     if (nwritten < len)
         return EOF;
@@ -768,10 +823,11 @@ int fputs(char const* s, FILE* stream)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/puts.html
 int puts(char const* s)
 {
-    int rc = fputs(s, stdout);
+    ScopedFileLock lock(stdout);
+    int rc = fputs_unlocked(s, stdout);
     if (rc == EOF)
         return EOF;
-    return fputc('\n', stdout);
+    return fputc_unlocked('\n', stdout);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/clearerr.html
@@ -782,6 +838,12 @@ void clearerr(FILE* stream)
     stream->clear_err();
 }
 
+void clearerr_unlocked(FILE* stream)
+{
+    VERIFY(stream);
+    stream->clear_err();
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/ferror.html
 int ferror(FILE* stream)
 {
@@ -790,6 +852,12 @@ int ferror(FILE* stream)
     return stream->error();
 }
 
+int ferror_unlocked(FILE* stream)
+{
+    VERIFY(stream);
+    return stream->error();
+}
+
 size_t fread_unlocked(void* ptr, size_t size, size_t nmemb, FILE* stream)
 {
     VERIFY(stream);
@@ -809,19 +877,25 @@ size_t fread(void* ptr, size_t size, size_t nmemb, FILE* stream)
     return fread_unlocked(ptr, size, nmemb, stream);
 }
 
-// https://pubs.opengroup.org/onlinepubs/9699919799/functions/fwrite.html
-size_t fwrite(void const* ptr, size_t size, size_t nmemb, FILE* stream)
+size_t fwrite_unlocked(void const* ptr, size_t size, size_t nmemb, FILE* stream)
 {
     VERIFY(stream);
     VERIFY(!Checked<size_t>::multiplication_would_overflow(size, nmemb));
 
-    ScopedFileLock lock(stream);
     size_t nwritten = stream->write(reinterpret_cast<u8 const*>(ptr), size * nmemb);
     if (!nwritten)
         return 0;
     return nwritten / size;
 }
 
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/fwrite.html
+size_t fwrite(void const* ptr, size_t size, size_t nmemb, FILE* stream)
+{
+    VERIFY(stream);
+    ScopedFileLock lock(stream);
+    return fwrite_unlocked(ptr, size, nmemb, stream);
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/fseek.html
 int fseek(FILE* stream, long offset, int whence)
 {
@@ -886,15 +960,29 @@ void rewind(FILE* stream)
     clearerr(stream);
 }
 
-ALWAYS_INLINE void stdout_putch(char*&, char ch)
-{
-    putchar(ch);
-}
-
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/vfprintf.html
 int vfprintf(FILE* stream, char const* fmt, va_list ap)
 {
-    return printf_internal([stream](auto, char ch) { fputc(ch, stream); }, nullptr, fmt, ap);
+    VERIFY(stream);
+    ScopedFileLock lock(stream);
+
+    // Collect the output in a small buffer and hand it to the stream in bulk,
+    // instead of writing it one character at a time.
+    u8 buffer[256];
+    size_t buffered = 0;
+    auto flush_buffer = [&] {
+        stream->write(buffer, buffered);
+        buffered = 0;
+    };
+    int rc = printf_internal(
+        [&](auto, char ch) {
+            buffer[buffered++] = ch;
+            if (buffered == sizeof(buffer))
+                flush_buffer();
+        },
+        nullptr, fmt, ap);
+    flush_buffer();
+    return rc;
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/fprintf.html
@@ -910,7 +998,7 @@ int fprintf(FILE* stream, char const* fmt, ...)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/vprintf.html
 int vprintf(char const* fmt, va_list ap)
 {
-    return printf_internal(stdout_putch, nullptr, fmt, ap);
+    return vfprintf(stdout, fmt, ap);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/printf.html
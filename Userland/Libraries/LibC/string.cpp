@@ -5,10 +5,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Format.h>
 #include <AK/MemMem.h>
 #include <AK/Memory.h>
 #include <AK/Platform.h>
+#include <AK/SIMD.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 #include <assert.h>
@@ -19,6 +21,26 @@
 #include <stdlib.h>
 #include <string.h>
 
+// strlen() and memchr() look at a whole word (or 16 bytes, with SSE2) at a time.
+// The bit tricks below assume a little-endian byte order, which is all we run on.
+
+static constexpr FlatPtr low_bits = explode_byte(0x01);
+static constexpr FlatPtr high_bits = explode_byte(0x80);
+
+// Sets the high bit of the lowest zero byte in `word`. Higher bytes may be flagged incorrectly if they are 0x01.
+ALWAYS_INLINE static FlatPtr find_zero_bytes(FlatPtr word)
+{
+    return (word - low_bits) & ~word & high_bits;
+}
+
+#ifdef __SSE2__
+// Returns a mask with one bit set for each byte in `bytes` that is `value`.
+ALWAYS_INLINE static u32 find_bytes(AK::SIMD::u8x16 bytes, u8 value)
+{
+    return __builtin_ia32_pmovmskb128((AK::SIMD::c8x16)(bytes == value));
+}
+#endif
+
 extern "C" {
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strspn.html
@@ -50,12 +72,40 @@ size_t strcspn(char const* s, char const* reject)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strlen.html
-size_t strlen(char const* str)
-{
-    size_t len = 0;
-    while (*(str++))
-        ++len;
-    return len;
+// NOTE: This reads whole aligned blocks, which may extend past the terminator. They can't cross into an unmapped page,
+//       but ASan doesn't know that.
+NO_SANITIZE_ADDRESS size_t strlen(char const* str)
+{
+#ifdef __SSE2__
+    auto offset = (FlatPtr)str & 15;
+    auto const* block = str - offset;
+    AK::SIMD::u8x16 bytes;
+    __builtin_memcpy(&bytes, block, sizeof(bytes));
+    // Ignore the bytes before the start of the string.
+    auto mask = find_bytes(bytes, 0) >> offset;
+    if (mask != 0)
+        return count_trailing_zeroes(mask);
+    for (;;) {
+        block += 16;
+        __builtin_memcpy(&bytes, block, sizeof(bytes));
+        mask = find_bytes(bytes, 0);
+        if (mask != 0)
+            return block + count_trailing_zeroes(mask) - str;
+    }
+#else
+    auto offset = (FlatPtr)str & (sizeof(FlatPtr) - 1);
+    auto const* block = str - offset;
+    FlatPtr word;
+    __builtin_memcpy(&word, block, sizeof(word));
+    // Pretend that the bytes before the start of the string aren't zero.
+    auto zero_bytes = find_zero_bytes(word | ((FlatPtr(1) << (offset * 8)) - 1));
+    while (zero_bytes == 0) {
+        block += sizeof(FlatPtr);
+        __builtin_memcpy(&word, block, sizeof(word));
+        zero_bytes = find_zero_bytes(word);
+    }
+    return block + count_trailing_zeroes(zero_bytes) / 8 - str;
+#endif
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strnlen.html
@@ -115,6 +165,17 @@ int memcmp(void const* v1, void const* v2, size_t n)
 {
     auto* s1 = (uint8_t const*)v1;
     auto* s2 = (uint8_t const*)v2;
+    for (; n >= sizeof(FlatPtr); s1 += sizeof(FlatPtr), s2 += sizeof(FlatPtr), n -= sizeof(FlatPtr)) {
+        FlatPtr word1;
+        FlatPtr word2;
+        __builtin_memcpy(&word1, s1, sizeof(word1));
+        __builtin_memcpy(&word2, s2, sizeof(word2));
+        if (word1 != word2) {
+            // The first byte that differs decides the result.
+            auto index = count_trailing_zeroes(word1 ^ word2) / 8;
+            return s1[index] < s2[index] ? -1 : 1;
+        }
+    }
     while (n-- > 0) {
         if (*s1++ != *s2++)
             return s1[-1] < s2[-1] ? -1 : 1;
@@ -128,23 +189,28 @@ int timingsafe_memcmp(void const* b1, void const* b2, size_t len)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memcpy.html
+#if ARCH(I386)
 void* memcpy(void* dest_ptr, void const* src_ptr, size_t n)
 {
-#if ARCH(I386) || ARCH(X86_64)
     void* original_dest = dest_ptr;
     asm volatile(
         "rep movsb"
         : "+D"(dest_ptr), "+S"(src_ptr), "+c"(n)::"memory");
     return original_dest;
+}
+#elif ARCH(X86_64)
+// For x86-64, an optimized ASM implementation is found in ./arch/x86_64/memcpy.S
 #elif ARCH(AARCH64)
+void* memcpy(void* dest_ptr, void const* src_ptr, size_t n)
+{
     (void)dest_ptr;
     (void)src_ptr;
     (void)n;
     TODO_AARCH64();
+}
 #else
 #    error Unknown architecture
 #endif
-}
 
 #if ARCH(I386)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memset.html
@@ -266,11 +332,27 @@ char* strchrnul(char const* str, int c)
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memchr.html
 void* memchr(void const* ptr, int c, size_t size)
 {
-    char ch = c;
-    auto* cptr = (char const*)ptr;
-    for (size_t i = 0; i < size; ++i) {
-        if (cptr[i] == ch)
-            return const_cast<char*>(cptr + i);
+    u8 ch = c;
+    auto* bytes = (u8 const*)ptr;
+#ifdef __SSE2__
+    for (; size >= 16; bytes += 16, size -= 16) {
+        AK::SIMD::u8x16 block;
+        __builtin_memcpy(&block, bytes, sizeof(block));
+        if (auto mask = find_bytes(block, ch); mask != 0)
+            return const_cast<u8*>(bytes + count_trailing_zeroes(mask));
+    }
+#else
+    auto pattern = explode_byte(ch);
+    for (; size >= sizeof(FlatPtr); bytes += sizeof(FlatPtr), size -= sizeof(FlatPtr)) {
+        FlatPtr word;
+        __builtin_memcpy(&word, bytes, sizeof(word));
+        if (auto matches = find_zero_bytes(word ^ pattern); matches != 0)
+            return const_cast<u8*>(bytes + count_trailing_zeroes(matches) / 8);
+    }
+#endif
+    for (; size > 0; ++bytes, --size) {
+        if (*bytes == ch)
+            return const_cast<u8*>(bytes);
     }
     return nullptr;
 }
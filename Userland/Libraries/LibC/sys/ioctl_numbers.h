@@ -130,12 +130,17 @@ enum IOCtlNumber {
     KCOV_DISABLE,
     SOUNDCARD_IOCTL_SET_SAMPLE_RATE,
     SOUNDCARD_IOCTL_GET_SAMPLE_RATE,
+    SOUNDCARD_IOCTL_SET_OUTPUT_BUFFER_COUNT,
+    SOUNDCARD_IOCTL_GET_OUTPUT_BUFFER_COUNT,
     STORAGE_DEVICE_GET_SIZE,
     STORAGE_DEVICE_GET_BLOCK_SIZE,
     VIRGL_IOCTL_CREATE_CONTEXT,
     VIRGL_IOCTL_CREATE_RESOURCE,
     VIRGL_IOCTL_SUBMIT_CMD,
     VIRGL_IOCTL_TRANSFER_DATA,
+    VIRGL_IOCTL_DESTROY_RESOURCE,
+    VIRGL_IOCTL_SET_SCANOUT,
+    VIRGL_IOCTL_FLUSH_RESOURCE,
     KDSETMODE,
     KDGETMODE,
 };
@@ -186,11 +191,16 @@ enum IOCtlNumber {
 #define FIONREAD FIONREAD
 #define SOUNDCARD_IOCTL_SET_SAMPLE_RATE SOUNDCARD_IOCTL_SET_SAMPLE_RATE
 #define SOUNDCARD_IOCTL_GET_SAMPLE_RATE SOUNDCARD_IOCTL_GET_SAMPLE_RATE
+#define SOUNDCARD_IOCTL_SET_OUTPUT_BUFFER_COUNT SOUNDCARD_IOCTL_SET_OUTPUT_BUFFER_COUNT
+#define SOUNDCARD_IOCTL_GET_OUTPUT_BUFFER_COUNT SOUNDCARD_IOCTL_GET_OUTPUT_BUFFER_COUNT
 #define STORAGE_DEVICE_GET_SIZE STORAGE_DEVICE_GET_SIZE
 #define STORAGE_DEVICE_GET_BLOCK_SIZE STORAGE_DEVICE_GET_BLOCK_SIZE
 #define VIRGL_IOCTL_CREATE_CONTEXT VIRGL_IOCTL_CREATE_CONTEXT
 #define VIRGL_IOCTL_CREATE_RESOURCE VIRGL_IOCTL_CREATE_RESOURCE
 #define VIRGL_IOCTL_SUBMIT_CMD VIRGL_IOCTL_SUBMIT_CMD
 #define VIRGL_IOCTL_TRANSFER_DATA VIRGL_IOCTL_TRANSFER_DATA
+#define VIRGL_IOCTL_DESTROY_RESOURCE VIRGL_IOCTL_DESTROY_RESOURCE
+#define VIRGL_IOCTL_SET_SCANOUT VIRGL_IOCTL_SET_SCANOUT
+#define VIRGL_IOCTL_FLUSH_RESOURCE VIRGL_IOCTL_FLUSH_RESOURCE
 #define KDSETMODE KDSETMODE
 #define KDGETMODE KDGETMODE
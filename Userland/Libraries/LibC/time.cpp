@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/time.h>
 #include <sys/times.h>
 #include <syscall.h>
@@ -435,33 +436,104 @@ clock_t clock()
 static Kernel::TimePage* get_kernel_time_page()
 {
     static Kernel::TimePage* s_kernel_time_page;
-    // FIXME: Thread safety
-    if (!s_kernel_time_page) {
-        auto rc = syscall(SC_map_time_page);
-        if ((int)rc < 0 && (int)rc > -EMAXERRNO) {
-            errno = -(int)rc;
-            return nullptr;
-        }
-        s_kernel_time_page = (Kernel::TimePage*)rc;
+    if (auto* page = AK::atomic_load(&s_kernel_time_page, AK::memory_order_acquire))
+        return page;
+
+    auto rc = syscall(SC_map_time_page);
+    if ((int)rc < 0 && (int)rc > -EMAXERRNO) {
+        errno = -(int)rc;
+        return nullptr;
     }
-    return s_kernel_time_page;
+    auto* page = (Kernel::TimePage*)rc;
+    Kernel::TimePage* expected = nullptr;
+    if (!AK::atomic_compare_exchange_strong(&s_kernel_time_page, expected, page, AK::memory_order_acq_rel)) {
+        // Another thread mapped the page first, so we can drop our mapping again.
+        munmap(page, sizeof(Kernel::TimePage));
+        return expected;
+    }
+    return page;
 }
 
-int clock_gettime(clockid_t clock_id, struct timespec* ts)
+#if ARCH(I386) || ARCH(X86_64)
+static ALWAYS_INLINE u64 read_tsc()
 {
+    u32 lsw;
+    u32 msw;
+    asm volatile("rdtsc"
+                 : "=d"(msw), "=a"(lsw));
+    return ((u64)msw << 32) | lsw;
+}
+#endif
+
+#if ARCH(I386) || ARCH(X86_64)
+// The precise monotonic time this process has handed out last.
+static u64 s_last_precise_monotonic_ns;
+
+static u64 clamp_to_last_precise_monotonic_ns(u64 monotonic_ns)
+{
+    auto last_monotonic_ns = AK::atomic_load(&s_last_precise_monotonic_ns, AK::memory_order_relaxed);
+    while (last_monotonic_ns < monotonic_ns) {
+        if (AK::atomic_compare_exchange_strong(&s_last_precise_monotonic_ns, last_monotonic_ns, monotonic_ns, AK::memory_order_relaxed))
+            return monotonic_ns;
+    }
+    return last_monotonic_ns;
+}
+#endif
+
+static bool read_clock_from_time_page(Kernel::TimePage const& page, clockid_t clock_id, struct timespec& ts)
+{
+    u32 update_iteration;
     if (Kernel::time_page_supports(clock_id)) {
+        do {
+            update_iteration = AK::atomic_load(&page.update1, AK::memory_order_acquire);
+            ts = page.clocks[clock_id];
+        } while (update_iteration != AK::atomic_load(&page.update2, AK::memory_order_acquire));
+        return true;
+    }
+
+#if ARCH(I386) || ARCH(X86_64)
+    timespec monotonic_base;
+    timespec realtime_base;
+    u64 delta_ns;
+    do {
+        update_iteration = AK::atomic_load(&page.update1, AK::memory_order_acquire);
+        if (!page.tsc_is_usable)
+            return false;
+        monotonic_base = page.clocks[CLOCK_MONOTONIC];
+        realtime_base = page.clocks[CLOCK_REALTIME];
+        auto tsc = read_tsc();
+        // NOTE: The TSC of this CPU may lag slightly behind the one that the kernel read it on.
+        auto tsc_delta = tsc > page.tsc_at_update ? tsc - page.tsc_at_update : 0;
+        delta_ns = Kernel::time_page_tsc_delta_to_ns(page, tsc_delta);
+    } while (update_iteration != AK::atomic_load(&page.update2, AK::memory_order_acquire));
+
+    auto to_ns = [](timespec const& time) { return static_cast<i64>(time.tv_sec) * 1'000'000'000 + time.tv_nsec; };
+    // NOTE: The TSC doesn't run at exactly the rate we measured, so the time extrapolated from one update can be a
+    //       little past the time of the next one. Clamping makes sure the clock never seems to go backwards.
+    auto monotonic_base_ns = to_ns(monotonic_base);
+    auto monotonic_ns = clamp_to_last_precise_monotonic_ns(monotonic_base_ns + delta_ns);
+
+    // The realtime clock moves in step with the monotonic one between updates.
+    i64 ns = clock_id == CLOCK_MONOTONIC ? monotonic_ns : to_ns(realtime_base) + static_cast<i64>(monotonic_ns - monotonic_base_ns);
+    ts.tv_sec = ns / 1'000'000'000;
+    ts.tv_nsec = ns % 1'000'000'000;
+    return true;
+#else
+    return false;
+#endif
+}
+
+int clock_gettime(clockid_t clock_id, struct timespec* ts)
+{
+    if (Kernel::time_page_supports(clock_id) || Kernel::time_page_supports_with_tsc(clock_id)) {
         if (!ts) {
             errno = EFAULT;
             return -1;
         }
 
         if (auto* kernel_time_page = get_kernel_time_page()) {
-            u32 update_iteration;
-            do {
-                update_iteration = AK::atomic_load(&kernel_time_page->update1, AK::memory_order_acquire);
-                *ts = kernel_time_page->clocks[clock_id];
-            } while (update_iteration != AK::atomic_load(&kernel_time_page->update2, AK::memory_order_acquire));
-            return 0;
+            if (read_clock_from_time_page(*kernel_time_page, clock_id, *ts))
+                return 0;
         }
     }
 
@@ -320,17 +320,89 @@ String BestMoveCommand::to_string() const
     return builder.build();
 }
 
-InfoCommand InfoCommand::from_string([[maybe_unused]] StringView command)
+InfoCommand InfoCommand::from_string(StringView command)
 {
-    // FIXME: Implement this.
-    VERIFY_NOT_REACHED();
+    auto tokens = command.split_view(' ');
+    VERIFY(tokens[0] == "info");
+
+    InfoCommand info_command;
+    for (size_t i = 1; i < tokens.size(); ++i) {
+        if (tokens[i] == "depth") {
+            VERIFY(++i < tokens.size());
+            info_command.depth = tokens[i].to_int().value();
+        } else if (tokens[i] == "seldepth") {
+            VERIFY(++i < tokens.size());
+            info_command.seldepth = tokens[i].to_int().value();
+        } else if (tokens[i] == "time") {
+            VERIFY(++i < tokens.size());
+            info_command.time = tokens[i].to_int().value();
+        } else if (tokens[i] == "nodes") {
+            VERIFY(++i < tokens.size());
+            info_command.nodes = tokens[i].to_int().value();
+        } else if (tokens[i] == "nps") {
+            VERIFY(++i < tokens.size());
+            info_command.nps = tokens[i].to_int().value();
+        } else if (tokens[i] == "score") {
+            VERIFY(i + 2 < tokens.size());
+            if (tokens[i + 1] == "cp")
+                info_command.score_cp = tokens[i + 2].to_int().value();
+            else if (tokens[i + 1] == "mate")
+                info_command.score_mate = tokens[i + 2].to_int().value();
+            i += 2;
+        } else if (tokens[i] == "currmove") {
+            VERIFY(++i < tokens.size());
+            info_command.currmove = Move(tokens[i]);
+        } else if (tokens[i] == "currmovenumber") {
+            VERIFY(++i < tokens.size());
+            info_command.currmove_number = tokens[i].to_int().value();
+        } else if (tokens[i] == "pv") {
+            // The principal variation takes up the rest of the line.
+            Vector<Chess::Move> pv;
+            while (++i < tokens.size())
+                pv.append(Move(tokens[i]));
+            info_command.pv = move(pv);
+        } else if (tokens[i] == "string") {
+            // FIXME: Keep the string around, it takes up the rest of the line.
+            break;
+        }
+    }
+
+    return info_command;
 }
 
 String InfoCommand::to_string() const
 {
-    // FIXME: Implement this.
-    VERIFY_NOT_REACHED();
-    return "info";
+    StringBuilder builder;
+    builder.append("info"sv);
+
+    if (depth.has_value())
+        builder.appendff(" depth {}", depth.value());
+    if (seldepth.has_value())
+        builder.appendff(" seldepth {}", seldepth.value());
+    if (time.has_value())
+        builder.appendff(" time {}", time.value());
+    if (nodes.has_value())
+        builder.appendff(" nodes {}", nodes.value());
+    if (nps.has_value())
+        builder.appendff(" nps {}", nps.value());
+    if (score_cp.has_value())
+        builder.appendff(" score cp {}", score_cp.value());
+    if (score_mate.has_value())
+        builder.appendff(" score mate {}", score_mate.value());
+    if (currmove.has_value())
+        builder.appendff(" currmove {}", currmove.value().to_long_algebraic());
+    if (currmove_number.has_value())
+        builder.appendff(" currmovenumber {}", currmove_number.value());
+    if (pv.has_value()) {
+        builder.append(" pv"sv);
+        for (auto& move : pv.value()) {
+            builder.append(' ');
+            builder.append(move.to_long_algebraic());
+        }
+    }
+
+    builder.append('\n');
+    return builder.build();
 }
 
 }
@@ -246,7 +246,7 @@ private:
 class InfoCommand : public Command {
 public:
     explicit InfoCommand()
-        : Command(Command::Type::BestMove)
+        : Command(Command::Type::Info)
     {
     }
 
@@ -258,6 +258,7 @@ public:
     Optional<int> seldepth;
     Optional<int> time;
     Optional<int> nodes;
+    Optional<int> nps;
     Optional<Vector<Chess::Move>> pv;
     // FIXME: Add multipv.
     Optional<int> score_cp;
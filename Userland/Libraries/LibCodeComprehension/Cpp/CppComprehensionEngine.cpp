@@ -20,6 +20,9 @@
 
 namespace CodeComprehension::Cpp {
 
+// Every incremental parse keeps the previous version of the document alive, so after this many we parse from scratch.
+static constexpr size_t max_incremental_parses_in_a_row = 16;
+
 CppComprehensionEngine::CppComprehensionEngine(FileDB const& filedb)
     : CodeComprehensionEngine(filedb, true)
 {
@@ -43,7 +46,7 @@ CppComprehensionEngine::DocumentData const* CppComprehensionEngine::get_document
     return document_data.value();
 }
 
-OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_document_data_for(String const& file)
+OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_document_data_for(String const& file, OwnPtr<DocumentData> previous_document)
 {
     if (m_unfinished_documents.contains(file)) {
         return {};
@@ -53,7 +56,7 @@ OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_docu
     auto document = filedb().get_or_read_from_filesystem(file);
     if (!document.has_value())
         return {};
-    return create_document_data(move(document.value()), file);
+    return create_document_data(move(document.value()), file, move(previous_document));
 }
 
 void CppComprehensionEngine::set_document_data(String const& file, OwnPtr<DocumentData>&& data)
@@ -391,9 +394,59 @@ String CppComprehensionEngine::document_path_from_include_path(StringView includ
     return result;
 }
 
+static bool definitions_are_equal(Preprocessor::Definitions const& a, Preprocessor::Definitions const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (auto& it : a) {
+        auto other = b.get(it.key);
+        if (!other.has_value())
+            return false;
+        auto const& definition = it.value;
+        if (definition.parameters != other->parameters || definition.value != other->value || definition.line != other->line || definition.column != other->column)
+            return false;
+    }
+    return true;
+}
+
 void CppComprehensionEngine::on_edit(String const& file)
 {
-    set_document_data(file, create_document_data_for(file));
+    auto absolute_path = filedb().to_absolute_path(file);
+    OwnPtr<DocumentData> previous_document;
+    if (auto it = m_documents.find(absolute_path); it != m_documents.end())
+        previous_document = move(it->value);
+
+    Optional<Preprocessor::Definitions> previous_definitions;
+    if (previous_document)
+        previous_definitions = previous_document->preprocessor().definitions();
+
+    auto document = create_document_data_for(file, move(previous_document));
+    bool definitions_changed = !document || !previous_definitions.has_value() || !definitions_are_equal(*previous_definitions, document->preprocessor().definitions());
+    set_document_data(absolute_path, move(document));
+
+    // Everything that includes this document was preprocessed with its old definitions.
+    if (definitions_changed)
+        drop_documents_that_include(absolute_path);
+}
+
+void CppComprehensionEngine::drop_documents_that_include(String const& file)
+{
+    // NOTE: They're processed again the next time something asks for them.
+    Vector<String> stale_documents;
+    for (auto& it : m_documents) {
+        if (!it.value)
+            continue;
+        for (auto& header : it.value->m_available_headers) {
+            if (filedb().to_absolute_path(header) == file) {
+                stale_documents.append(it.key);
+                break;
+            }
+        }
+    }
+    for (auto& path : stale_documents) {
+        dbgln_if(CPP_LANGUAGE_SERVER_DEBUG, "Dropping {}, since the definitions in {} have changed", path, file);
+        m_documents.remove(path);
+    }
 }
 
 void CppComprehensionEngine::file_opened([[maybe_unused]] String const& file)
@@ -413,7 +466,36 @@ Optional<CodeComprehension::ProjectLocation> CppComprehensionEngine::find_declar
         return CodeComprehension::ProjectLocation { decl->filename(), decl->start().line, decl->start().column };
     }
 
-    return find_preprocessor_definition(document, identifier_position);
+    if (auto location = find_preprocessor_definition(document, identifier_position); location.has_value())
+        return location;
+
+    return find_declaration_in_symbol_index(document, identifier_position);
+}
+
+SymbolIndex* CppComprehensionEngine::symbol_index()
+{
+    // We only know which project we're in once the client has told us.
+    if (!m_symbol_index && m_symbol_index_enabled && !filedb().project_root().is_null())
+        m_symbol_index = make<SymbolIndex>(filedb().project_root());
+    return m_symbol_index.ptr();
+}
+
+Optional<CodeComprehension::ProjectLocation> CppComprehensionEngine::find_declaration_in_symbol_index(DocumentData const& document, GUI::TextPosition const& identifier_position)
+{
+    auto* index = symbol_index();
+    if (!index)
+        return {};
+
+    auto token = document.parser().token_at({ identifier_position.line(), identifier_position.column() });
+    if (!token.has_value() || token->type() != Token::Type::Identifier)
+        return {};
+
+    // FIXME: The index only knows the names of the symbols, so this takes the first one with the right name,
+    //        without looking at the scope it's referenced from.
+    auto declarations = index->find_declarations(token->text());
+    if (declarations.is_empty())
+        return {};
+    return declarations.first().position;
 }
 
 RefPtr<Cpp::Declaration> CppComprehensionEngine::find_declaration_of(DocumentData const& document, const GUI::TextPosition& identifier_position)
@@ -587,6 +669,9 @@ void CppComprehensionEngine::update_declared_symbols(DocumentData& document)
     for (auto& definition : document.preprocessor().definitions()) {
         declarations.append({ definition.key, { document.filename(), definition.value.line, definition.value.column }, CodeComprehension::DeclarationType::PreprocessorDefinition, {} });
     }
+
+    if (auto* index = symbol_index())
+        index->set_declarations_of_file(document.filename(), declarations);
     set_declarations_of_document(document.filename(), move(declarations));
 }
 
@@ -612,8 +697,12 @@ CodeComprehension::DeclarationType CppComprehensionEngine::type_of_declaration(C
     return CodeComprehension::DeclarationType::Variable;
 }
 
-OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_document_data(String text, String const& filename)
+OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_document_data(String text, String const& filename, OwnPtr<DocumentData> previous_document)
 {
+    // Edits that leave the text as it was, like typing something and deleting it again, don't have to be processed at all.
+    if (previous_document && previous_document->text() == text)
+        return previous_document;
+
     auto document_data = make<DocumentData>();
     document_data->m_filename = filename;
     document_data->m_text = move(text);
@@ -646,7 +735,13 @@ OwnPtr<CppComprehensionEngine::DocumentData> CppComprehensionEngine::create_docu
 
     document_data->m_parser = make<Parser>(move(tokens), filename);
 
-    auto root = document_data->parser().parse();
+    // Only the top-level declarations that were touched by the edit are parsed again, the rest is taken from the previous version.
+    bool should_reparse = previous_document && previous_document->m_previous_preprocessors.size() < max_incremental_parses_in_a_row;
+    if (should_reparse) {
+        document_data->m_previous_preprocessors = move(previous_document->m_previous_preprocessors);
+        document_data->m_previous_preprocessors.append(previous_document->m_preprocessor.release_nonnull());
+    }
+    auto root = should_reparse ? document_data->parser().reparse(previous_document->parser()) : document_data->parser().parse();
 
     if constexpr (CPP_LANGUAGE_SERVER_DEBUG)
         root->dump();
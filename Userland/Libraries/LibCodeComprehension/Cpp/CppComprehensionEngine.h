@@ -16,6 +16,7 @@
 #include <LibCpp/Preprocessor.h>
 #include <LibGUI/TextPosition.h>
 #include <Libraries/LibCodeComprehension/CodeComprehensionEngine.h>
+#include <Libraries/LibCodeComprehension/SymbolIndex.h>
 
 namespace CodeComprehension::Cpp {
 
@@ -32,6 +33,9 @@ public:
     virtual Optional<FunctionParamsHint> get_function_params_hint(String const&, GUI::TextPosition const&) override;
     virtual Vector<CodeComprehension::TokenInfo> get_tokens_info(String const& filename) override;
 
+    // Keeps where the symbols of the project are declared on disk, so that they can be found before their files are parsed.
+    void set_symbol_index_enabled(bool enabled) { m_symbol_index_enabled = enabled; }
+
 private:
     struct SymbolName {
         StringView name;
@@ -93,6 +97,9 @@ private:
 
         HashMap<SymbolName, Symbol> m_symbols;
         HashTable<String> m_available_headers;
+
+        // Incremental parsing carries nodes over from earlier versions of the document, which still point into their text.
+        Vector<NonnullOwnPtr<Preprocessor>> m_previous_preprocessors;
     };
 
     Vector<CodeComprehension::AutocompleteResultEntry> autocomplete_property(DocumentData const&, MemberExpression const&, const String partial_text) const;
@@ -118,7 +125,8 @@ private:
     DocumentData const* get_or_create_document_data(String const& file);
     void set_document_data(String const& file, OwnPtr<DocumentData>&& data);
 
-    OwnPtr<DocumentData> create_document_data_for(String const& file);
+    OwnPtr<DocumentData> create_document_data_for(String const& file, OwnPtr<DocumentData> previous_document = {});
+    void drop_documents_that_include(String const& file);
     String document_path_from_include_path(StringView include_path) const;
     void update_declared_symbols(DocumentData&);
     void update_todo_entries(DocumentData&);
@@ -129,7 +137,9 @@ private:
     Optional<CodeComprehension::ProjectLocation> find_preprocessor_definition(DocumentData const&, const GUI::TextPosition&);
     Optional<Cpp::Preprocessor::Substitution> find_preprocessor_substitution(DocumentData const&, Cpp::Position const&);
 
-    OwnPtr<DocumentData> create_document_data(String text, String const& filename);
+    OwnPtr<DocumentData> create_document_data(String text, String const& filename, OwnPtr<DocumentData> previous_document = {});
+    SymbolIndex* symbol_index();
+    Optional<CodeComprehension::ProjectLocation> find_declaration_in_symbol_index(DocumentData const&, GUI::TextPosition const&);
     Optional<Vector<CodeComprehension::AutocompleteResultEntry>> try_autocomplete_property(DocumentData const&, ASTNode const&, Optional<Token> containing_token) const;
     Optional<Vector<CodeComprehension::AutocompleteResultEntry>> try_autocomplete_name(DocumentData const&, ASTNode const&, Optional<Token> containing_token) const;
     Optional<Vector<CodeComprehension::AutocompleteResultEntry>> try_autocomplete_include(DocumentData const&, Token include_path_token, Cpp::Position const& cursor_position) const;
@@ -151,6 +161,9 @@ private:
     // A document is added to this set when we start processing it (e.g because it was #included) and removed when we're done.
     // We use this to prevent circular #includes from looping indefinitely.
     HashTable<String> m_unfinished_documents;
+
+    bool m_symbol_index_enabled { false };
+    OwnPtr<SymbolIndex> m_symbol_index;
 };
 
 template<typename Func>
@@ -61,6 +61,7 @@ static void test_complete_local_args();
 static void test_complete_local_vars();
 static void test_complete_type();
 static void test_find_variable_definition();
+static void test_find_declaration_after_edit();
 static void test_complete_includes();
 static void test_parameters_hint();
 
@@ -70,6 +71,7 @@ int run_tests()
     test_complete_local_vars();
     test_complete_type();
     test_find_variable_definition();
+    test_find_declaration_after_edit();
     test_complete_includes();
     test_parameters_hint();
     return s_some_test_failed ? 1 : 0;
@@ -145,6 +147,31 @@ void test_find_variable_definition()
     FAIL("wrong declaration location");
 }
 
+void test_find_declaration_after_edit()
+{
+    I_TEST(Find Declaration After Edit)
+    FileDB filedb;
+    add_file(filedb, "find_declaration_after_edit.cpp");
+    CodeComprehension::Cpp::CppComprehensionEngine engine(filedb);
+    auto position = engine.find_declaration_of("find_declaration_after_edit.cpp", { 12, 12 });
+    if (!position.has_value() || position.value().line != 10)
+        FAIL("declaration not found before the edit");
+
+    // The edit only touches the first function, so the last one is carried over and has to be moved down.
+    auto file = Core::File::open(LexicalPath::join(TESTS_ROOT_DIR, "find_declaration_after_edit.cpp"sv).string(), Core::OpenMode::ReadOnly);
+    VERIFY(!file.is_error());
+    auto text = String::copy(file.value()->read_all());
+    filedb.add("find_declaration_after_edit.cpp", text.replace("return 1;"sv, "int one = 1;\n    return one;"sv, ReplaceMode::FirstOnly));
+    engine.on_edit("find_declaration_after_edit.cpp");
+
+    position = engine.find_declaration_of("find_declaration_after_edit.cpp", { 13, 12 });
+    if (!position.has_value())
+        FAIL("declaration not found after the edit");
+    if (position.value().line == 11 && position.value().column == 10)
+        PASS;
+    FAIL("wrong declaration location after the edit");
+}
+
 void test_complete_includes()
 {
     I_TEST(Complete include statements)
@@ -0,0 +1,14 @@
+int first()
+{
+    return 1;
+}
+
+int second()
+{
+    return 2;
+}
+
+int third(int value)
+{
+    return value;
+}
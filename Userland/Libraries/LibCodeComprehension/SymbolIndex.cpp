@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "SymbolIndex.h"
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <unistd.h>
+
+namespace CodeComprehension {
+
+// Writing the whole index out is not free, so a steady stream of edits only gets it written this often.
+static constexpr i64 minimum_seconds_between_saves = 10;
+
+static i64 modification_time_of(String const& filename)
+{
+    auto stat = Core::System::stat(filename);
+    if (stat.is_error())
+        return 0;
+    return stat.value().st_mtime;
+}
+
+String SymbolIndex::directory()
+{
+    return String::formatted("{}/.cache/HackStudio", Core::StandardPaths::home_directory());
+}
+
+SymbolIndex::SymbolIndex(String const& project_root)
+    : m_project_root(project_root)
+    , m_last_save_time(Time::now_monotonic())
+{
+    if (auto result = load(); result.is_error() && !(result.error().is_errno() && result.error().code() == ENOENT))
+        dbgln("SymbolIndex: Failed to load {}: {}", path(), result.error());
+}
+
+SymbolIndex::~SymbolIndex()
+{
+    if (auto result = save(); result.is_error())
+        dbgln("SymbolIndex: Failed to save {}: {}", path(), result.error());
+}
+
+String SymbolIndex::path() const
+{
+    return String::formatted("{}/{:08x}.json", directory(), m_project_root.hash());
+}
+
+void SymbolIndex::set_declarations_of_file(String const& filename, Vector<Declaration> const& declarations)
+{
+    // Headers from outside of the project are parsed again whenever they're included, so there's no point in keeping them.
+    if (!filename.starts_with(m_project_root))
+        return;
+
+    auto& file = m_files.ensure(filename);
+    if (file.declarations == declarations)
+        return;
+    file.modification_time = modification_time_of(filename);
+    file.declarations = declarations;
+    m_has_unsaved_changes = true;
+
+    if ((Time::now_monotonic() - m_last_save_time).to_seconds() < minimum_seconds_between_saves)
+        return;
+    if (auto result = save(); result.is_error())
+        dbgln("SymbolIndex: Failed to save {}: {}", path(), result.error());
+}
+
+Vector<Declaration> SymbolIndex::find_declarations(StringView name) const
+{
+    Vector<Declaration> declarations;
+    for (auto& it : m_files) {
+        for (auto& declaration : it.value.declarations) {
+            if (declaration.name == name)
+                declarations.append(declaration);
+        }
+    }
+    return declarations;
+}
+
+ErrorOr<void> SymbolIndex::load()
+{
+    auto file = TRY(Core::Stream::File::open(path(), Core::Stream::OpenMode::Read));
+    auto contents = TRY(file->read_all());
+    auto json = TRY(JsonValue::from_string(contents));
+    if (!json.is_object() || json.as_object().get("project_root"sv).as_string_or({}) != m_project_root)
+        return Error::from_string_literal("Not an index of this project");
+
+    auto const* files = json.as_object().get_ptr("files"sv);
+    if (!files || !files->is_object())
+        return Error::from_string_literal("Index has no files");
+
+    files->as_object().for_each_member([&](String const& filename, JsonValue const& value) {
+        if (!value.is_object())
+            return;
+        auto modification_time = value.as_object().get("modification_time"sv).to_i64();
+        if (modification_time == 0 || modification_time != modification_time_of(filename))
+            return;
+
+        File file;
+        file.modification_time = modification_time;
+        auto const* declarations = value.as_object().get_ptr("declarations"sv);
+        if (!declarations || !declarations->is_array())
+            return;
+        declarations->as_array().for_each([&](JsonValue const& declaration_value) {
+            if (!declaration_value.is_object())
+                return;
+            auto const& declaration = declaration_value.as_object();
+            auto type = declaration.get("type"sv).to_u32();
+            if (type > to_underlying(DeclarationType::Member))
+                return;
+            file.declarations.append({
+                declaration.get("name"sv).as_string_or({}),
+                { filename, declaration.get("line"sv).to_u64(), declaration.get("column"sv).to_u64() },
+                static_cast<DeclarationType>(type),
+                declaration.get("scope"sv).as_string_or({}),
+            });
+        });
+        m_files.set(filename, move(file));
+    });
+    return {};
+}
+
+ErrorOr<void> SymbolIndex::save()
+{
+    if (!m_has_unsaved_changes)
+        return {};
+
+    JsonObject files;
+    for (auto& it : m_files) {
+        JsonArray declarations;
+        for (auto& declaration : it.value.declarations) {
+            JsonObject declaration_object;
+            declaration_object.set("name", declaration.name);
+            declaration_object.set("scope", declaration.scope);
+            declaration_object.set("type", to_underlying(declaration.type));
+            declaration_object.set("line", declaration.position.line);
+            declaration_object.set("column", declaration.position.column);
+            declarations.append(move(declaration_object));
+        }
+        JsonObject file;
+        file.set("modification_time", it.value.modification_time);
+        file.set("declarations", move(declarations));
+        files.set(it.key, move(file));
+    }
+
+    JsonObject index;
+    index.set("project_root", m_project_root);
+    index.set("files", move(files));
+
+    // NOTE: Another language server may be reading the index of the same project, so it has to be replaced in one go.
+    auto temporary_path = String::formatted("{}.tmp-{}", path(), getpid());
+    {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate, 0600));
+        if (!file->write_or_error(index.to_string().bytes()))
+            return Error::from_string_literal("Failed to write the index");
+    }
+    TRY(Core::System::rename(temporary_path, path()));
+
+    m_has_unsaved_changes = false;
+    m_last_save_time = Time::now_monotonic();
+    return {};
+}
+
+}
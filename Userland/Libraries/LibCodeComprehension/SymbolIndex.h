@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "Types.h"
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/String.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+
+namespace CodeComprehension {
+
+// Remembers where the symbols of a project are declared, across runs of the language server.
+// This lets us find declarations in files that haven't been parsed since the project was opened.
+// The declarations of a file are dropped when it is loaded again if the file was modified in the meantime.
+class SymbolIndex {
+    AK_MAKE_NONCOPYABLE(SymbolIndex);
+    AK_MAKE_NONMOVABLE(SymbolIndex);
+
+public:
+    static String directory();
+
+    explicit SymbolIndex(String const& project_root);
+    ~SymbolIndex();
+
+    void set_declarations_of_file(String const& filename, Vector<Declaration> const&);
+    Vector<Declaration> find_declarations(StringView name) const;
+
+    ErrorOr<void> save();
+
+private:
+    String path() const;
+    ErrorOr<void> load();
+
+    struct File {
+        i64 modification_time { 0 };
+        Vector<Declaration> declarations;
+    };
+
+    String m_project_root;
+    HashMap<String, File> m_files;
+    bool m_has_unsaved_changes { false };
+    Time m_last_save_time;
+};
+
+}
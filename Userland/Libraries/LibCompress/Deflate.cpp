@@ -8,7 +8,8 @@
 #include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/BinaryHeap.h>
-#include <AK/BinarySearch.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/Endian.h>
 #include <AK/MemoryStream.h>
 #include <string.h>
 
@@ -19,6 +20,7 @@ namespace Compress {
 static constexpr u8 deflate_special_code_length_copy = 16;
 static constexpr u8 deflate_special_code_length_zeros = 17;
 static constexpr u8 deflate_special_code_length_long_zeros = 18;
+static constexpr size_t max_back_reference_length = 258;
 
 CanonicalCode const& CanonicalCode::fixed_literal_codes()
 {
@@ -50,10 +52,16 @@ CanonicalCode const& CanonicalCode::fixed_distance_codes()
 
 Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 {
-    // FIXME: I can't quite follow the algorithm here, but it seems to work.
-
     CanonicalCode code;
 
+    auto add_to_fast_table = [&](u16 symbol, size_t code_length) {
+        if (code_length > fast_lookup_bits)
+            return;
+        // Every index that starts with this symbol's (lsb-first) code decodes to it, whatever the remaining bits are.
+        for (size_t rest = 0; rest < (1u << (fast_lookup_bits - code_length)); ++rest)
+            code.m_fast_table[code.m_bit_codes[symbol] | (rest << code_length)] = symbol << 4 | code_length;
+    };
+
     auto non_zero_symbols = 0;
     auto last_non_zero = -1;
     for (size_t i = 0; i < bytes.size(); i++) {
@@ -63,18 +71,25 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_symbol_codes.append(0b10);
         code.m_symbol_values.append(last_non_zero);
+        code.m_first_code_of_length[1] = 0;
+        code.m_first_index_of_length[1] = 0;
+        code.m_code_count_of_length[1] = 1;
         code.m_bit_codes[last_non_zero] = 0;
         code.m_bit_code_lengths[last_non_zero] = 1;
+        add_to_fast_table(last_non_zero, 1);
         return code;
     }
 
+    // Codes are handed out in order of length and then symbol, each length continuing where the previous one left off.
     auto next_code = 0;
     for (size_t code_length = 1; code_length <= 15; ++code_length) {
         next_code <<= 1;
         auto start_bit = 1 << code_length;
 
+        code.m_first_code_of_length[code_length] = next_code;
+        code.m_first_index_of_length[code_length] = code.m_symbol_values.size();
+
         for (size_t symbol = 0; symbol < bytes.size(); ++symbol) {
             if (bytes[symbol] != code_length)
                 continue;
@@ -82,13 +97,15 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
             code.m_symbol_values.append(symbol);
             code.m_bit_codes[symbol] = fast_reverse16(start_bit | next_code, code_length); // DEFLATE writes huffman encoded symbols as lsb-first
             code.m_bit_code_lengths[symbol] = code_length;
+            add_to_fast_table(symbol, code_length);
 
             next_code++;
         }
+
+        code.m_code_count_of_length[code_length] = code.m_symbol_values.size() - code.m_first_index_of_length[code_length];
     }
 
     if (next_code != (1 << 15)) {
@@ -98,21 +115,34 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
     return code;
 }
 
-u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+u32 CanonicalCode::decode_long_symbol(u32 bits, size_t& code_length) const
 {
-    u32 code_bits = 1;
+    // The code arrives most significant bit first, so it's built up one bit at a time until it falls into the range of
+    // codes that have the current length.
+    u32 code_bits = 0;
+    for (size_t length = 1; length <= 15; ++length) {
+        code_bits = code_bits << 1 | ((bits >> (length - 1)) & 1);
+        auto index = code_bits - m_first_code_of_length[length];
+        if (index < m_code_count_of_length[length]) {
+            code_length = length;
+            return m_symbol_values[m_first_index_of_length[length] + index];
+        }
+    }
+    return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
+}
 
-    for (;;) {
+u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+{
+    // The underlying stream must not be read past the end of the deflate data, so peeking ahead isn't an option here.
+    // Instead, the code is read one bit at a time like in decode_long_symbol().
+    u32 code_bits = 0;
+    for (size_t length = 1; length <= 15; ++length) {
         code_bits = code_bits << 1 | stream.read_bits(1);
-        if (code_bits >= (1 << 16))
-            return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
-
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+        auto index = code_bits - m_first_code_of_length[length];
+        if (index < m_code_count_of_length[length])
+            return m_symbol_values[m_first_index_of_length[length] + index];
     }
+    return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
 }
 
 void CanonicalCode::write_symbol(OutputBitStream& stream, u32 symbol) const
@@ -159,14 +189,17 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
         }
         auto const distance = m_decompressor.decode_distance(distance_symbol);
 
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            m_decompressor.m_output_stream.read({ &byte, sizeof(byte) }, distance);
+        // Copy the back reference in as few pieces as possible. A piece can't be longer than the distance, since the
+        // bytes after that are the ones this copy is producing.
+        u8 buffer[max_back_reference_length];
+        for (size_t copied = 0; copied < length;) {
+            auto nread = m_decompressor.m_output_stream.read({ buffer, length - copied }, distance);
             if (m_decompressor.m_output_stream.handle_any_error()) {
                 m_decompressor.set_fatal_error();
                 return false; // a back reference was requested that was too far back (outside our current sliding window)
             }
-            m_decompressor.m_output_stream << byte;
+            m_decompressor.m_output_stream.write({ buffer, nread });
+            copied += nread;
         }
 
         return true;
@@ -276,10 +309,10 @@ size_t DeflateDecompressor::read(Bytes bytes)
         }
 
         if (m_state == State::ReadingCompressedBlock) {
-            auto nread = m_output_stream.read(slice);
+            auto nread = read_from_output_stream(slice);
 
             while (nread < slice.size() && m_compressed_block.try_read_more()) {
-                nread += m_output_stream.read(slice.slice(nread));
+                nread += read_from_output_stream(slice.slice(nread));
             }
 
             if (m_input_stream.has_any_error()) {
@@ -298,10 +331,10 @@ size_t DeflateDecompressor::read(Bytes bytes)
         }
 
         if (m_state == State::ReadingUncompressedBlock) {
-            auto nread = m_output_stream.read(slice);
+            auto nread = read_from_output_stream(slice);
 
             while (nread < slice.size() && m_uncompressed_block.try_read_more()) {
-                nread += m_output_stream.read(slice.slice(nread));
+                nread += read_from_output_stream(slice.slice(nread));
             }
 
             if (m_input_stream.has_any_error()) {
@@ -324,6 +357,21 @@ size_t DeflateDecompressor::read(Bytes bytes)
     return total_read;
 }
 
+size_t DeflateDecompressor::read_from_output_stream(Bytes bytes)
+{
+    if (!m_output_checksum)
+        return m_output_stream.read(bytes);
+
+    size_t nread = 0;
+    while (nread < bytes.size() && !m_output_stream.eof()) {
+        auto available = m_output_stream.peek_contiguous_bytes().trim(bytes.size() - nread);
+        m_output_checksum->copy_and_update(available, bytes.slice(nread));
+        m_output_stream.discard_or_error(available.size());
+        nread += available.size();
+    }
+    return nread;
+}
+
 bool DeflateDecompressor::read_or_error(Bytes bytes)
 {
     if (read(bytes) < bytes.size()) {
@@ -359,24 +407,6 @@ bool DeflateDecompressor::handle_any_error()
     return Stream::handle_any_error() || handled_errors;
 }
 
-Optional<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
-{
-    InputMemoryStream memory_stream { bytes };
-    DeflateDecompressor deflate_stream { memory_stream };
-    DuplexMemoryStream output_stream;
-
-    u8 buffer[4096];
-    while (!deflate_stream.has_any_error() && !deflate_stream.unreliable_eof()) {
-        auto const nread = deflate_stream.read({ buffer, sizeof(buffer) });
-        output_stream.write_or_error({ buffer, nread });
-    }
-
-    if (deflate_stream.handle_any_error())
-        return {};
-
-    return output_stream.copy_into_contiguous_buffer();
-}
-
 u32 DeflateDecompressor::decode_length(u32 symbol)
 {
     // FIXME: I can't quite follow the algorithm here, but it seems to work.
@@ -410,18 +440,21 @@ u32 DeflateDecompressor::decode_distance(u32 symbol)
     VERIFY_NOT_REACHED();
 }
 
-void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
+// Reads the code lengths at the start of a dynamic huffman block and builds the codes from them. This is shared by the
+// streaming decompressor and decompress_all(), which read their input differently.
+template<typename BitSource>
+static bool decode_dynamic_codes(BitSource& source, CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
 {
-    auto literal_code_count = m_input_stream.read_bits(5) + 257;
-    auto distance_code_count = m_input_stream.read_bits(5) + 1;
-    auto code_length_count = m_input_stream.read_bits(4) + 4;
+    auto literal_code_count = source.read_bits(5) + 257;
+    auto distance_code_count = source.read_bits(5) + 1;
+    auto code_length_count = source.read_bits(4) + 4;
 
     // First we have to extract the code lengths of the code that was used to encode the code lengths of
     // the code that was used to encode the block.
 
     u8 code_lengths_code_lengths[19] = { 0 };
     for (size_t i = 0; i < code_length_count; ++i) {
-        code_lengths_code_lengths[code_lengths_code_lengths_order[i]] = m_input_stream.read_bits(3);
+        code_lengths_code_lengths[code_lengths_code_lengths_order[i]] = source.read_bits(3);
     }
 
     // Now we can extract the code that was used to encode the code lengths of the code that was used to
@@ -429,8 +462,7 @@ void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<Can
 
     auto code_length_code_result = CanonicalCode::from_bytes({ code_lengths_code_lengths, sizeof(code_lengths_code_lengths) });
     if (!code_length_code_result.has_value()) {
-        set_fatal_error();
-        return;
+        return false;
     }
     auto const code_length_code = code_length_code_result.value();
 
@@ -438,23 +470,22 @@ void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<Can
 
     Vector<u8> code_lengths;
     while (code_lengths.size() < literal_code_count + distance_code_count) {
-        auto symbol = code_length_code.read_symbol(m_input_stream);
+        auto symbol = source.read_symbol(code_length_code);
 
         if (symbol == UINT32_MAX) {
-            set_fatal_error();
-            return;
+            return false;
         }
 
         if (symbol < deflate_special_code_length_copy) {
             code_lengths.append(static_cast<u8>(symbol));
             continue;
         } else if (symbol == deflate_special_code_length_zeros) {
-            auto nrepeat = 3 + m_input_stream.read_bits(3);
+            auto nrepeat = 3 + source.read_bits(3);
             for (size_t j = 0; j < nrepeat; ++j)
                 code_lengths.append(0);
             continue;
         } else if (symbol == deflate_special_code_length_long_zeros) {
-            auto nrepeat = 11 + m_input_stream.read_bits(7);
+            auto nrepeat = 11 + source.read_bits(7);
             for (size_t j = 0; j < nrepeat; ++j)
                 code_lengths.append(0);
             continue;
@@ -462,27 +493,24 @@ void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<Can
             VERIFY(symbol == deflate_special_code_length_copy);
 
             if (code_lengths.is_empty()) {
-                set_fatal_error();
-                return;
+                return false;
             }
 
-            auto nrepeat = 3 + m_input_stream.read_bits(2);
+            auto nrepeat = 3 + source.read_bits(2);
             for (size_t j = 0; j < nrepeat; ++j)
                 code_lengths.append(code_lengths.last());
         }
     }
 
     if (code_lengths.size() != literal_code_count + distance_code_count) {
-        set_fatal_error();
-        return;
+        return false;
     }
 
     // Now we extract the code that was used to encode literals and lengths in the block.
 
     auto literal_code_result = CanonicalCode::from_bytes(code_lengths.span().trim(literal_code_count));
     if (!literal_code_result.has_value()) {
-        set_fatal_error();
-        return;
+        return false;
     }
     literal_code = literal_code_result.value();
 
@@ -492,19 +520,247 @@ void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<Can
         auto length = code_lengths[literal_code_count];
 
         if (length == 0) {
-            return;
+            return true;
         } else if (length != 1) {
-            set_fatal_error();
-            return;
+            return false;
         }
     }
 
     auto distance_code_result = CanonicalCode::from_bytes(code_lengths.span().slice(literal_code_count));
     if (!distance_code_result.has_value()) {
-        set_fatal_error();
-        return;
+        return false;
     }
     distance_code = distance_code_result.value();
+    return true;
+}
+
+void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
+{
+    struct {
+        InputBitStream& stream;
+
+        u32 read_bits(size_t count) { return stream.read_bits(count); }
+        u32 read_symbol(CanonicalCode const& code) { return code.read_symbol(stream); }
+    } source { m_input_stream };
+
+    if (!decode_dynamic_codes(source, literal_code, distance_code))
+        set_fatal_error();
+}
+
+// Decodes a deflate stream that is entirely in memory. Unlike the streaming decompressor, this is free to read ahead of
+// what it has decoded, so it keeps up to 64 bits of input around and can decode most symbols with one table lookup
+// into the code and a single refill. The output is its own window, so back references are plain copies.
+class MemoryInflater {
+public:
+    explicit MemoryInflater(ReadonlyBytes input)
+        : m_input(input)
+    {
+    }
+
+    Optional<ByteBuffer> inflate();
+
+    u32 read_bits(size_t count)
+    {
+        refill();
+        auto bits = peek_bits(count);
+        consume_bits(count);
+        return bits;
+    }
+
+    u32 read_symbol(CanonicalCode const& code)
+    {
+        refill();
+        size_t code_length = 0;
+        auto symbol = code.decode_symbol(peek_bits(15), code_length);
+        if (symbol != UINT32_MAX)
+            consume_bits(code_length);
+        return symbol;
+    }
+
+private:
+    // Past the end of the input, zeroes are shifted in. Reading into those is an error, which is checked for once per
+    // symbol or block instead of for every refill.
+    ALWAYS_INLINE void refill()
+    {
+        while (m_bit_count <= 56) {
+            if (m_input_offset < m_input.size()) {
+                m_bit_buffer |= static_cast<u64>(m_input[m_input_offset++]) << m_bit_count;
+            } else {
+                ++m_padding_bytes;
+            }
+            m_bit_count += 8;
+        }
+    }
+
+    ALWAYS_INLINE u32 peek_bits(size_t count) const { return m_bit_buffer & ((1ull << count) - 1); }
+
+    ALWAYS_INLINE void consume_bits(size_t count)
+    {
+        m_bit_buffer >>= count;
+        m_bit_count -= count;
+    }
+
+    // The padding bytes in the buffer are the last ones shifted in, so as long as there are at least as many bits
+    // left as there is padding, no real input was missing.
+    bool has_read_past_end() const { return m_bit_count < m_padding_bytes * 8; }
+
+    bool inflate_uncompressed_block();
+    bool inflate_compressed_block(CanonicalCode const& literal_code, Optional<CanonicalCode> const& distance_code);
+    bool ensure_output_capacity(size_t additional);
+
+    ReadonlyBytes m_input;
+    size_t m_input_offset { 0 };
+    size_t m_padding_bytes { 0 };
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
+    ByteBuffer m_output;
+};
+
+bool MemoryInflater::ensure_output_capacity(size_t additional)
+{
+    // Leave a little slack at the end, so that back references can be copied in whole words.
+    auto needed = m_output.size() + additional + sizeof(u64);
+    if (needed <= m_output.capacity())
+        return true;
+    return !m_output.try_ensure_capacity(max(needed, m_output.capacity() * 2)).is_error();
+}
+
+bool MemoryInflater::inflate_uncompressed_block()
+{
+    // Throw away the rest of the current byte, what is left in the bit buffer is then whole bytes of input.
+    consume_bits(m_bit_count % 8);
+    refill();
+    auto length = read_bits(16);
+    auto negated_length = read_bits(16);
+    if ((length ^ 0xffff) != negated_length || has_read_past_end())
+        return false;
+
+    if (!ensure_output_capacity(length))
+        return false;
+
+    // Take the bytes still in the bit buffer first, then copy the rest directly from the input.
+    size_t from_buffer = min<size_t>(length, (m_bit_count / 8) - m_padding_bytes);
+    for (size_t i = 0; i < from_buffer; ++i) {
+        m_output.append(static_cast<u8>(peek_bits(8)));
+        consume_bits(8);
+    }
+
+    auto from_input = length - from_buffer;
+    if (from_input == 0)
+        return true;
+
+    // If anything is left to copy, the bit buffer is empty apart from padding.
+    VERIFY(m_bit_count == m_padding_bytes * 8);
+    if (m_input.size() - m_input_offset < from_input)
+        return false;
+    m_output.append(m_input.slice(m_input_offset, from_input));
+    m_input_offset += from_input;
+    m_bit_buffer = 0;
+    m_bit_count = 0;
+    m_padding_bytes = 0;
+    return true;
+}
+
+bool MemoryInflater::inflate_compressed_block(CanonicalCode const& literal_code, Optional<CanonicalCode> const& distance_code)
+{
+    for (;;) {
+        // A literal/length code, its extra bits, a distance code and its extra bits take at most 15 + 5 + 15 + 13 = 48
+        // bits, so a single refill per symbol is enough.
+        refill();
+        if (has_read_past_end())
+            return false;
+
+        size_t code_length = 0;
+        auto symbol = literal_code.decode_symbol(peek_bits(15), code_length);
+        if (symbol >= 286) // invalid deflate literal/length symbol
+            return false;
+        consume_bits(code_length);
+
+        if (symbol < 256) {
+            if (!ensure_output_capacity(1))
+                return false;
+            m_output.append(static_cast<u8>(symbol));
+            continue;
+        }
+
+        if (symbol == 256)
+            return true;
+
+        if (!distance_code.has_value())
+            return false;
+
+        auto const& length_symbol = packed_length_symbols[symbol - 257];
+        size_t length = length_symbol.base_length + peek_bits(length_symbol.extra_bits);
+        consume_bits(length_symbol.extra_bits);
+
+        auto distance_symbol = distance_code->decode_symbol(peek_bits(15), code_length);
+        if (distance_symbol >= 30) // invalid deflate distance symbol
+            return false;
+        consume_bits(code_length);
+
+        auto const& packed_distance = packed_distances[distance_symbol];
+        size_t distance = packed_distance.base_distance + peek_bits(packed_distance.extra_bits);
+        consume_bits(packed_distance.extra_bits);
+
+        if (distance > m_output.size())
+            return false; // a back reference was requested that was too far back
+        if (!ensure_output_capacity(length))
+            return false;
+
+        auto* destination = m_output.data() + m_output.size();
+        auto const* source = destination - distance;
+        m_output.resize(m_output.size() + length);
+
+        if (distance >= sizeof(u64)) {
+            // Every word that is read was completely written before, even when source and destination overlap. The
+            // last word may go beyond the length, into the slack that ensure_output_capacity() leaves.
+            for (size_t i = 0; i < length; i += sizeof(u64))
+                __builtin_memcpy(destination + i, source + i, sizeof(u64));
+        } else {
+            for (size_t i = 0; i < length; ++i)
+                destination[i] = source[i];
+        }
+    }
+}
+
+Optional<ByteBuffer> MemoryInflater::inflate()
+{
+    for (;;) {
+        auto is_final_block = read_bits(1);
+        auto block_type = read_bits(2);
+        if (has_read_past_end())
+            return {};
+
+        if (block_type == 0b00) {
+            if (!inflate_uncompressed_block())
+                return {};
+        } else if (block_type == 0b01) {
+            if (!inflate_compressed_block(CanonicalCode::fixed_literal_codes(), CanonicalCode::fixed_distance_codes()))
+                return {};
+        } else if (block_type == 0b10) {
+            CanonicalCode literal_code;
+            Optional<CanonicalCode> distance_code;
+            if (!decode_dynamic_codes(*this, literal_code, distance_code) || has_read_past_end())
+                return {};
+            if (!inflate_compressed_block(literal_code, distance_code))
+                return {};
+        } else {
+            return {};
+        }
+
+        if (is_final_block)
+            break;
+    }
+
+    if (has_read_past_end())
+        return {};
+    return move(m_output);
+}
+
+Optional<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
+{
+    MemoryInflater inflater { bytes };
+    return inflater.inflate();
 }
 
 DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel compression_level)
@@ -514,11 +770,13 @@ DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel comp
 {
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
+    reset_hash_chains();
 }
 
 DeflateCompressor::~DeflateCompressor()
 {
-    VERIFY(m_finished);
+    // Either the stream was finished or it was sync flushed and nothing was written since, so no data is lost.
+    VERIFY(m_finished || m_pending_block_size == 0);
 }
 
 size_t DeflateCompressor::write(ReadonlyBytes bytes)
@@ -564,8 +822,21 @@ size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate
             return 0;
     }
 
-    // Find the actual length
+    // Find the actual length, comparing 8 bytes at a time while that doesn't read past the maximum length
     auto match_length = previous_match_length + 1;
+    while (match_length + sizeof(u64) <= maximum_match_length) {
+        u64 start_bytes;
+        u64 candidate_bytes;
+        __builtin_memcpy(&start_bytes, &m_rolling_window[start + match_length], sizeof(u64));
+        __builtin_memcpy(&candidate_bytes, &m_rolling_window[candidate + match_length], sizeof(u64));
+        auto difference = AK::convert_between_host_and_little_endian(start_bytes ^ candidate_bytes);
+        if (difference != 0) {
+            match_length += count_trailing_zeroes(difference) / 8;
+            VERIFY(match_length <= maximum_match_length);
+            return match_length;
+        }
+        match_length += sizeof(u64);
+    }
     while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
         match_length++;
     }
@@ -594,8 +865,8 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
-            break; // outside the window
+        if (start - candidate > max_match_distance)
+            break; // too far back to be encoded, and the remaining candidates are even further back
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
 
@@ -608,7 +879,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
                 return match_length; // bail if we got the maximum possible length
         }
 
-        candidate = m_hash_prev[candidate % window_size];
+        candidate = m_hash_prev[candidate];
     }
     if (!match_found)
         return 0;                 // we didn't find any matches
@@ -692,16 +963,31 @@ void DeflateCompressor::generate_huffman_lengths(Array<u8, Size>& lengths, Array
     }
 }
 
-void DeflateCompressor::lz77_compress_block()
+void DeflateCompressor::reset_hash_chains()
 {
-    for (auto& slot : m_hash_head) { // initialize chained hash table
+    for (auto& slot : m_hash_head)
         slot = empty_slot;
-    }
+    for (auto& slot : m_hash_prev)
+        slot = empty_slot;
+}
+
+// Moves the hash chains along with the data when the current block becomes the previous one.
+void DeflateCompressor::slide_hash_chains()
+{
+    auto slide = [](u16 position) -> u16 {
+        return (position == empty_slot || position < block_size) ? empty_slot : position - block_size;
+    };
+    for (auto& slot : m_hash_head)
+        slot = slide(slot);
+    for (size_t i = 0; i < block_size; ++i)
+        m_hash_prev[i] = slide(m_hash_prev[i + block_size]);
+}
 
-    auto insert_hash = [&](auto pos, auto hash) {
-        auto window_pos = pos % window_size;
-        m_hash_prev[window_pos] = m_hash_head[hash];
-        m_hash_head[hash] = window_pos;
+void DeflateCompressor::lz77_compress_block()
+{
+    auto insert_hash = [&](size_t pos, u16 hash) {
+        m_hash_prev[pos] = m_hash_head[hash];
+        m_hash_head[hash] = pos;
     };
 
     auto emit_literal = [&](auto literal) {
@@ -1040,6 +1326,13 @@ void DeflateCompressor::flush()
     if (m_finished)
         m_output_stream.align_to_byte_boundary();
 
+    // Matches can only reach back into the previous block if it was full, otherwise its data and this block's
+    // wouldn't be next to each other in the window.
+    if (m_pending_block_size == block_size)
+        slide_hash_chains();
+    else
+        reset_hash_chains();
+
     // reset all block specific members
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
@@ -1056,6 +1349,46 @@ void DeflateCompressor::final_flush()
     flush();
 }
 
+void DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+
+    if (m_pending_block_size > 0)
+        flush();
+
+    if (m_output_stream.handle_any_error()) {
+        set_fatal_error();
+        return;
+    }
+
+    m_output_stream.write_bit(false);    // not the final block
+    m_output_stream.write_bits(0b00, 2); // no compression
+    m_output_stream.align_to_byte_boundary();
+    LittleEndian<u16> len = 0;
+    m_output_stream << len;
+    LittleEndian<u16> nlen = 0xffff;
+    m_output_stream << nlen;
+}
+
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(!m_finished && m_pending_block_size == 0);
+
+    // The dictionary takes the place of the previous block, right before where the pending block starts.
+    if (dictionary.size() > block_size)
+        dictionary = dictionary.slice_from_end(block_size);
+    auto start = block_size - dictionary.size();
+    dictionary.copy_to({ m_rolling_window + start, dictionary.size() });
+
+    reset_hash_chains();
+    // Sequences that would continue into the pending block can't be hashed yet, as it is still empty.
+    for (size_t position = start; position + min_match_length <= block_size; ++position) {
+        auto hash = hash_sequence(&m_rolling_window[position]);
+        m_hash_prev[position] = m_hash_head[hash];
+        m_hash_head[hash] = position;
+    }
+}
+
 Optional<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     DuplexMemoryStream output_stream;
@@ -13,24 +13,47 @@
 #include <AK/Endian.h>
 #include <AK/Vector.h>
 #include <LibCompress/DeflateTables.h>
+#include <LibCrypto/Checksum/ChecksumFunction.h>
 
 namespace Compress {
 
 class CanonicalCode {
 public:
+    // Codes up to this long are decoded with a single table lookup.
+    static constexpr size_t fast_lookup_bits = 9;
+
     CanonicalCode() = default;
     u32 read_symbol(InputBitStream&) const;
     void write_symbol(OutputBitStream&, u32) const;
 
+    // Decodes the symbol whose code starts at the lowest bit of `bits`, which has to hold at least 15 bits of input.
+    // Returns UINT32_MAX if there is no such symbol, otherwise code_length is set to how many bits it took.
+    ALWAYS_INLINE u32 decode_symbol(u32 bits, size_t& code_length) const
+    {
+        auto entry = m_fast_table[bits & ((1 << fast_lookup_bits) - 1)];
+        if (entry != 0) {
+            code_length = entry & 0xf;
+            return entry >> 4;
+        }
+        return decode_long_symbol(bits, code_length);
+    }
+
     static CanonicalCode const& fixed_literal_codes();
     static CanonicalCode const& fixed_distance_codes();
 
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    // Decompression - indexed by code
-    Vector<u16> m_symbol_codes;
+    u32 decode_long_symbol(u32 bits, size_t& code_length) const;
+
+    // Decompression - the symbols in canonical order, which is by code length and then by symbol
     Vector<u16> m_symbol_values;
+    // For every code length, the first code of that length and where its symbols start in m_symbol_values
+    Array<u16, 16> m_first_code_of_length {};
+    Array<u16, 16> m_first_index_of_length {};
+    Array<u16, 16> m_code_count_of_length {};
+    // Indexed by the next fast_lookup_bits bits of input, holds (symbol << 4 | code length), or 0 for longer codes.
+    Array<u16, 1 << fast_lookup_bits> m_fast_table {};
 
     // Compression - indexed by symbol
     Array<u16, 288> m_bit_codes {}; // deflate uses a maximum of 288 symbols (maximum of 32 for distances)
@@ -86,7 +109,12 @@ public:
 
     static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
 
+    // Updates the checksum with the decompressed data while it's being read, instead of in a separate pass over it.
+    void set_output_checksum(Crypto::Checksum::ChecksumFunction<u32>* checksum) { m_output_checksum = checksum; }
+
 private:
+    size_t read_from_output_stream(Bytes);
+
     u32 decode_length(u32);
     u32 decode_distance(u32);
     void decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code);
@@ -101,6 +129,7 @@ private:
 
     InputBitStream m_input_stream;
     CircularDuplexStream<32 * KiB> m_output_stream;
+    Crypto::Checksum::ChecksumFunction<u32>* m_output_checksum { nullptr };
 };
 
 class DeflateCompressor final : public OutputStream {
@@ -112,6 +141,7 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_match_distance = 32 * KiB; // back references can't reach further than this
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -144,6 +174,13 @@ public:
     size_t write(ReadonlyBytes) override;
     bool write_or_error(ReadonlyBytes) override;
     void final_flush();
+    // Writes out everything that was written so far followed by an empty stored block, which leaves the output on a byte
+    // boundary. This allows a separately compressed deflate stream to be appended after it.
+    void sync_flush();
+    // Lets the first block refer back to data that precedes this stream, without that data being written again. This is
+    // only valid if whatever decompresses the output has already decompressed that data right before it, e.g. because
+    // the output is appended to a sync flushed stream that ended with it. Has to be called before anything is written.
+    void set_dictionary(ReadonlyBytes);
 
     static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
@@ -155,6 +192,8 @@ private:
     size_t compare_match_candidate(size_t start, size_t candidate, size_t prev_match_length, size_t max_match_length);
     size_t find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t max_match_length, size_t& match_position);
     void lz77_compress_block();
+    void reset_hash_chains();
+    void slide_hash_chains();
 
     // Huffman Coding
     struct code_length_symbol {
@@ -194,7 +233,7 @@ private:
     Array<u16, max_huffman_literals> m_symbol_frequencies;    // there are 286 valid symbol values (symbols 286-287 never occur)
     Array<u16, max_huffman_distances> m_distance_frequencies; // there are 30 valid distance values (distances 30-31 never occur)
 
-    // LZ77 Chained hash table
+    // LZ77 Chained hash table. It stays valid across blocks, so that matches can reach back into the previous block.
     u16 m_hash_head[1 << hash_bits];
     u16 m_hash_prev[window_size];
 };
@@ -7,9 +7,11 @@
 
 #include <LibCompress/Gzip.h>
 
+#include <AK/Atomic.h>
 #include <AK/MemoryStream.h>
 #include <AK/String.h>
 #include <LibCore/DateTime.h>
+#include <LibThreading/Thread.h>
 
 namespace Compress {
 
@@ -60,7 +62,6 @@ size_t GzipDecompressor::read(Bytes bytes)
 
         if (m_current_member.has_value()) {
             size_t nread = current_member().m_stream.read(slice);
-            current_member().m_checksum.update(slice.trim(nread));
             current_member().m_nread += nread;
 
             if (current_member().m_stream.handle_any_error()) {
@@ -221,8 +222,93 @@ bool GzipDecompressor::handle_any_error()
 }
 
 GzipCompressor::GzipCompressor(OutputStream& stream)
+    : GzipCompressor(stream, Options {})
+{
+}
+
+GzipCompressor::GzipCompressor(OutputStream& stream, Options const& options)
     : m_output_stream(stream)
+    , m_options(options)
+{
+}
+
+// When compressing on multiple threads, the input is split into chunks of this size. Each one becomes its own piece of
+// deflate data that uses the end of the previous chunk as its dictionary, so matches can still reach across chunks and
+// the output ends up barely larger than when compressing on a single thread.
+static constexpr size_t parallel_chunk_size = 128 * KiB;
+
+bool GzipCompressor::write_compressed_chunks(ReadonlyBytes bytes, u32& crc32_digest)
 {
+    struct Chunk {
+        ReadonlyBytes input;
+        ByteBuffer output;
+        u32 crc32_digest { 0 };
+        bool succeeded { false };
+    };
+
+    auto chunk_count = ceil_div(bytes.size(), parallel_chunk_size);
+    Vector<Chunk> chunks;
+    chunks.resize(chunk_count);
+    for (size_t i = 0; i < chunk_count; ++i)
+        chunks[i].input = bytes.slice(i * parallel_chunk_size, min(parallel_chunk_size, bytes.size() - i * parallel_chunk_size));
+
+    // Every chunk but the last one ends with a sync flush, which leaves the output on a byte boundary without ending the
+    // deflate stream, so the outputs can simply be concatenated.
+    auto compress_chunk = [&](size_t index) {
+        auto& chunk = chunks[index];
+        DuplexMemoryStream output_stream;
+        DeflateCompressor deflate_stream { output_stream };
+        if (index > 0)
+            deflate_stream.set_dictionary(bytes.slice(0, index * parallel_chunk_size));
+
+        deflate_stream.write_or_error(chunk.input);
+        if (index == chunk_count - 1)
+            deflate_stream.final_flush();
+        else
+            deflate_stream.sync_flush();
+
+        if (deflate_stream.handle_any_error())
+            return;
+
+        chunk.output = output_stream.copy_into_contiguous_buffer();
+        chunk.crc32_digest = Crypto::Checksum::CRC32 { chunk.input }.digest();
+        chunk.succeeded = true;
+    };
+
+    Atomic<size_t> next_chunk { 0 };
+    auto compress_chunks = [&] {
+        for (;;) {
+            auto index = next_chunk.fetch_add(1);
+            if (index >= chunk_count)
+                return;
+            compress_chunk(index);
+        }
+    };
+
+    // The calling thread takes part in compressing.
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    auto thread_count = min(m_options.thread_count, chunk_count);
+    for (size_t i = 1; i < thread_count; ++i) {
+        auto thread = Threading::Thread::construct([&]() -> intptr_t {
+            compress_chunks();
+            return 0;
+        },
+            "gzip compressor"sv);
+        thread->start();
+        threads.append(move(thread));
+    }
+    compress_chunks();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    crc32_digest = 0;
+    for (auto& chunk : chunks) {
+        if (!chunk.succeeded)
+            return false;
+        m_output_stream << chunk.output.bytes();
+        crc32_digest = Crypto::Checksum::CRC32::combine(crc32_digest, chunk.crc32_digest, chunk.input.size());
+    }
+    return true;
 }
 
 size_t GzipCompressor::write(ReadonlyBytes bytes)
@@ -236,12 +322,22 @@ size_t GzipCompressor::write(ReadonlyBytes bytes)
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
     m_output_stream << Bytes { &header, sizeof(header) };
-    DeflateCompressor compressed_stream { m_output_stream };
-    VERIFY(compressed_stream.write_or_error(bytes));
-    compressed_stream.final_flush();
-    Crypto::Checksum::CRC32 crc32;
-    crc32.update(bytes);
-    LittleEndian<u32> digest = crc32.digest();
+
+    u32 crc32_digest = 0;
+    if (m_options.thread_count > 1 && bytes.size() > parallel_chunk_size) {
+        if (!write_compressed_chunks(bytes, crc32_digest)) {
+            set_fatal_error();
+            return 0;
+        }
+    } else {
+        DeflateCompressor compressed_stream { m_output_stream };
+        VERIFY(compressed_stream.write_or_error(bytes));
+        compressed_stream.final_flush();
+        Crypto::Checksum::CRC32 crc32;
+        crc32.update(bytes);
+        crc32_digest = crc32.digest();
+    }
+    LittleEndian<u32> digest = crc32_digest;
     LittleEndian<u32> size = bytes.size();
     m_output_stream << digest << size;
     return bytes.size();
@@ -258,9 +354,14 @@ bool GzipCompressor::write_or_error(ReadonlyBytes bytes)
 }
 
 Optional<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
+{
+    return compress_all(bytes, Options {});
+}
+
+Optional<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, Options const& options)
 {
     DuplexMemoryStream output_stream;
-    GzipCompressor gzip_stream { output_stream };
+    GzipCompressor gzip_stream { output_stream, options };
 
     gzip_stream.write_or_error(bytes);
 
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Noncopyable.h>
 #include <LibCompress/Deflate.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
@@ -55,11 +56,16 @@ public:
 
 private:
     class Member {
+        // The decompressor points at the checksum, so neither of them may move.
+        AK_MAKE_NONCOPYABLE(Member);
+        AK_MAKE_NONMOVABLE(Member);
+
     public:
         Member(BlockHeader header, InputStream& stream)
             : m_header(header)
             , m_stream(stream)
         {
+            m_stream.set_output_checksum(&m_checksum);
         }
 
         BlockHeader m_header;
@@ -81,16 +87,27 @@ private:
 
 class GzipCompressor final : public OutputStream {
 public:
+    struct Options {
+        // Large inputs are split into chunks that are compressed on up to this many threads at once.
+        // Anything above 1 requires the process to be allowed to create threads.
+        size_t thread_count { 1 };
+    };
+
     GzipCompressor(OutputStream&);
+    GzipCompressor(OutputStream&, Options const&);
     ~GzipCompressor() = default;
 
     size_t write(ReadonlyBytes) override;
     bool write_or_error(ReadonlyBytes) override;
 
     static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes);
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, Options const&);
 
 private:
+    bool write_compressed_chunks(ReadonlyBytes, u32& crc32_digest);
+
     OutputStream& m_output_stream;
+    Options m_options;
 };
 
 }
@@ -71,7 +71,7 @@ ZlibCompressor::ZlibCompressor(OutputStream& stream, ZlibCompressionLevel compre
     // Zlib only defines Deflate as a compression method.
     auto compression_method = ZlibCompressionMethod::Deflate;
 
-    write_header(compression_method, compression_level);
+    write_header(m_output_stream, compression_method, compression_level);
 
     // FIXME: Find a way to compress with Deflate's "Best" compression level.
     m_compressor = make<DeflateCompressor>(stream, static_cast<DeflateCompressor::CompressionLevel>(compression_level));
@@ -82,7 +82,7 @@ ZlibCompressor::~ZlibCompressor()
     VERIFY(m_finished);
 }
 
-void ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+void ZlibCompressor::write_header(OutputStream& stream, ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
 {
     u8 compression_info = 0;
     if (compression_method == ZlibCompressionMethod::Deflate) {
@@ -101,7 +101,7 @@ void ZlibCompressor::write_header(ZlibCompressionMethod compression_method, Zlib
 
     // FIXME: Support pre-defined dictionaries.
 
-    m_output_stream << header.as_u16;
+    stream << header.as_u16;
 }
 
 size_t ZlibCompressor::write(ReadonlyBytes bytes)
@@ -71,8 +71,8 @@ public:
 
     static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default);
 
-private:
-    void write_header(ZlibCompressionMethod, ZlibCompressionLevel);
+    // For callers that put a zlib stream together from deflate data they compressed themselves.
+    static void write_header(OutputStream&, ZlibCompressionMethod, ZlibCompressionLevel);
 
     bool m_finished { false };
     OutputBitStream m_output_stream;
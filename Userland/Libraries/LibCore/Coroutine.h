@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/StdLibExtras.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/Promise.h>
+#include <LibCore/SmallAllocationPool.h>
+#include <LibCore/Timer.h>
+#include <coroutine>
+
+namespace Core {
+
+template<typename T>
+class Coroutine;
+
+namespace Detail {
+
+struct CoroutinePromiseBase {
+    static void* operator new(size_t size) { return SmallAllocationPool::allocate(size); }
+    static void operator delete(void* frame, size_t size) { SmallAllocationPool::deallocate(frame, size); }
+
+    // Coroutines start right away, and only suspend once they have to wait for something.
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            auto& promise = handle.promise();
+            if (promise.is_detached) {
+                handle.destroy();
+                return std::noop_coroutine();
+            }
+            if (promise.awaiter)
+                return promise.awaiter;
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept { }
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { VERIFY_NOT_REACHED(); }
+
+    // The coroutine that is waiting for this one to be done, if any.
+    std::coroutine_handle<> awaiter;
+    bool is_detached { false };
+};
+
+template<typename T>
+struct CoroutinePromise : public CoroutinePromiseBase {
+    Coroutine<T> get_return_object();
+
+    template<typename U>
+    void return_value(U&& value) { result = forward<U>(value); }
+
+    Optional<T> result;
+};
+
+template<>
+struct CoroutinePromise<void> : public CoroutinePromiseBase {
+    Coroutine<void> get_return_object();
+
+    void return_void() { }
+};
+
+// Shared between an awaiter and the callback that resumes its coroutine, so that the callback can tell
+// whether the coroutine has been destroyed in the meantime.
+struct ResumeToken : public RefCounted<ResumeToken> {
+    std::coroutine_handle<> handle;
+
+    void resume_later()
+    {
+        // NOTE: Resuming the coroutine lets it destroy whatever is calling us, so leave that to the event loop.
+        Core::deferred_invoke([token = NonnullRefPtr(*this)]() mutable {
+            if (auto handle = AK::exchange(token->handle, {}))
+                handle.resume();
+        });
+    }
+};
+
+}
+
+// The result of a coroutine that may have to wait for things to happen on the event loop. It can be waited
+// for with co_await from another coroutine, or with await() from regular code. The coroutine is destroyed
+// along with this, which cancels whatever it was waiting for, unless it was detached.
+template<typename T>
+class [[nodiscard]] Coroutine {
+    AK_MAKE_NONCOPYABLE(Coroutine);
+
+public:
+    using promise_type = Detail::CoroutinePromise<T>;
+
+    Coroutine(Coroutine&& other)
+        : m_handle(AK::exchange(other.m_handle, {}))
+    {
+    }
+
+    Coroutine& operator=(Coroutine&& other)
+    {
+        if (this != &other) {
+            destroy();
+            m_handle = AK::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    ~Coroutine() { destroy(); }
+
+    bool is_done() const { return m_handle.done(); }
+
+    // Runs the event loop until the coroutine is done.
+    T await()
+    {
+        while (!m_handle.done())
+            Core::EventLoop::current().pump();
+        return take_result();
+    }
+
+    // Lets the coroutine run to completion on its own, it frees itself once it is done.
+    void detach()
+    {
+        auto handle = AK::exchange(m_handle, {});
+        if (handle.done()) {
+            handle.destroy();
+            return;
+        }
+        handle.promise().is_detached = true;
+    }
+
+    bool await_ready() const { return m_handle.done(); }
+    void await_suspend(std::coroutine_handle<> awaiter) { m_handle.promise().awaiter = awaiter; }
+    T await_resume() { return take_result(); }
+
+private:
+    friend promise_type;
+
+    explicit Coroutine(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+    }
+
+    T take_result()
+    {
+        VERIFY(m_handle.done());
+        if constexpr (!IsVoid<T>)
+            return m_handle.promise().result.release_value();
+    }
+
+    void destroy()
+    {
+        if (m_handle)
+            AK::exchange(m_handle, {}).destroy();
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template<typename T>
+Coroutine<T> Detail::CoroutinePromise<T>::get_return_object()
+{
+    return Coroutine<T> { std::coroutine_handle<CoroutinePromise<T>>::from_promise(*this) };
+}
+
+inline Coroutine<void> Detail::CoroutinePromise<void>::get_return_object()
+{
+    return Coroutine<void> { std::coroutine_handle<CoroutinePromise<void>>::from_promise(*this) };
+}
+
+// co_await sleep_for(milliseconds) resumes the coroutine once the time has passed.
+class [[nodiscard]] SleepAwaiter {
+    AK_MAKE_NONCOPYABLE(SleepAwaiter);
+    AK_MAKE_NONMOVABLE(SleepAwaiter);
+
+public:
+    explicit SleepAwaiter(int milliseconds)
+        : m_milliseconds(milliseconds)
+    {
+    }
+
+    ~SleepAwaiter()
+    {
+        if (m_timer)
+            m_timer->stop();
+        if (m_token)
+            m_token->handle = {};
+    }
+
+    bool await_ready() const { return m_milliseconds <= 0; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_token = adopt_ref(*new Detail::ResumeToken);
+        m_token->handle = handle;
+        m_timer = Timer::create_single_shot(m_milliseconds, [token = m_token]() mutable { token->resume_later(); });
+        m_timer->start();
+    }
+
+    void await_resume() { }
+
+private:
+    int m_milliseconds { 0 };
+    RefPtr<Timer> m_timer;
+    RefPtr<Detail::ResumeToken> m_token;
+};
+
+inline SleepAwaiter sleep_for(int milliseconds) { return SleepAwaiter { milliseconds }; }
+
+// co_await until_readable(fd) (or until_writable()) resumes the coroutine once the fd can be read from (or written to).
+class [[nodiscard]] NotifierAwaiter {
+    AK_MAKE_NONCOPYABLE(NotifierAwaiter);
+    AK_MAKE_NONMOVABLE(NotifierAwaiter);
+
+public:
+    NotifierAwaiter(int fd, Notifier::Event event)
+        : m_fd(fd)
+        , m_event(event)
+    {
+    }
+
+    ~NotifierAwaiter()
+    {
+        if (m_notifier)
+            m_notifier->set_enabled(false);
+        if (m_token)
+            m_token->handle = {};
+    }
+
+    bool await_ready() const { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_token = adopt_ref(*new Detail::ResumeToken);
+        m_token->handle = handle;
+        m_notifier = Notifier::construct(m_fd, m_event);
+        auto on_ready = [notifier = m_notifier.ptr(), token = m_token]() mutable {
+            notifier->set_enabled(false);
+            token->resume_later();
+        };
+        if (m_event == Notifier::Event::Read)
+            m_notifier->on_ready_to_read = move(on_ready);
+        else
+            m_notifier->on_ready_to_write = move(on_ready);
+    }
+
+    void await_resume() { }
+
+private:
+    int m_fd { -1 };
+    Notifier::Event m_event;
+    RefPtr<Notifier> m_notifier;
+    RefPtr<Detail::ResumeToken> m_token;
+};
+
+inline NotifierAwaiter until_readable(int fd) { return NotifierAwaiter { fd, Notifier::Event::Read }; }
+inline NotifierAwaiter until_writable(int fd) { return NotifierAwaiter { fd, Notifier::Event::Write }; }
+
+// co_await on a Core::Promise resumes the coroutine with the result once the promise is resolved.
+template<typename Result>
+class [[nodiscard]] PromiseAwaiter {
+    AK_MAKE_NONCOPYABLE(PromiseAwaiter);
+    AK_MAKE_NONMOVABLE(PromiseAwaiter);
+
+public:
+    explicit PromiseAwaiter(NonnullRefPtr<Promise<Result>> promise)
+        : m_promise(move(promise))
+    {
+    }
+
+    ~PromiseAwaiter()
+    {
+        if (!m_token)
+            return;
+        m_token->handle = {};
+        if (!m_promise->is_resolved())
+            m_promise->on_resolved = nullptr;
+    }
+
+    bool await_ready() { return m_promise->is_resolved(); }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_token = adopt_ref(*new Detail::ResumeToken);
+        m_token->handle = handle;
+        m_promise->on_resolved = [token = m_token](Result&) mutable { token->resume_later(); };
+    }
+
+    Result await_resume() { return m_promise->await(); }
+
+private:
+    NonnullRefPtr<Promise<Result>> m_promise;
+    RefPtr<Detail::ResumeToken> m_token;
+};
+
+template<typename Result>
+PromiseAwaiter<Result> operator co_await(NonnullRefPtr<Promise<Result>> promise)
+{
+    return PromiseAwaiter<Result> { move(promise) };
+}
+
+}
@@ -11,8 +11,9 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <AK/WeakPtr.h>
-#include <LibCore/DeferredInvocationContext.h>
 #include <LibCore/Forward.h>
+#include <LibCore/Object.h>
+#include <LibCore/SmallAllocationPool.h>
 
 namespace Core {
 
@@ -24,7 +25,6 @@ public:
         Timer,
         NotifierRead,
         NotifierWrite,
-        DeferredInvoke,
         ChildAdded,
         ChildRemoved,
         Custom,
@@ -37,6 +37,11 @@ public:
     }
     virtual ~Event() = default;
 
+    // Lots of events are posted and dispatched every second, so they come from a pool rather than straight from malloc.
+    static void* operator new(size_t size) { return SmallAllocationPool::allocate(size); }
+    static void* operator new(size_t, void* where) { return where; }
+    static void operator delete(void* event, size_t size) { SmallAllocationPool::deallocate(event, size); }
+
     unsigned type() const { return m_type; }
 
     bool is_accepted() const { return m_accepted; }
@@ -48,22 +53,6 @@ private:
     bool m_accepted { true };
 };
 
-class DeferredInvocationEvent : public Event {
-    friend class EventLoop;
-
-public:
-    DeferredInvocationEvent(NonnullRefPtr<DeferredInvocationContext> context, Function<void()> invokee)
-        : Event(Event::Type::DeferredInvoke)
-        , m_context(move(context))
-        , m_invokee(move(invokee))
-    {
-    }
-
-private:
-    NonnullRefPtr<DeferredInvocationContext> m_context;
-    Function<void()> m_invokee;
-};
-
 class TimerEvent final : public Event {
 public:
     explicit TimerEvent(int timer_id)
@@ -38,6 +38,7 @@
 
 #ifdef AK_OS_SERENITY
 #    include <LibCore/Account.h>
+#    include <sys/epoll.h>
 
 extern bool s_global_initializers_ran;
 #endif
@@ -74,6 +75,20 @@ static thread_local HashTable<Notifier*>* s_notifiers;
 thread_local int EventLoop::s_wake_pipe_fds[2];
 thread_local bool EventLoop::s_wake_pipe_initialized { false };
 
+#ifdef AK_OS_SERENITY
+// On Serenity, each thread keeps its notifiers in a persistent epoll interest set, so that waiting for events
+// doesn't have to hand every file descriptor to the kernel again. Several notifiers may share a file descriptor.
+struct NotifiersForFD {
+    Vector<Notifier*, 1> notifiers;
+    u32 watched_events { 0 };
+};
+static thread_local HashMap<int, NotifiersForFD>* s_notifiers_by_fd;
+static thread_local int s_epoll_fd { -1 };
+// The interest set is shared with any forked children, so they have to make their own before touching it.
+static thread_local pid_t s_epoll_pid { 0 };
+static constexpr int max_ready_events_per_wait = 64;
+#endif
+
 void EventLoop::initialize_wake_pipes()
 {
     if (!s_wake_pipe_initialized) {
@@ -90,6 +105,78 @@ void EventLoop::initialize_wake_pipes()
     }
 }
 
+#ifdef AK_OS_SERENITY
+static bool watch_fd_with_epoll(int fd, u32 events, u32 previously_watched_events)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.fd = fd;
+    auto op = previously_watched_events != 0 ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    int rc = epoll_ctl(s_epoll_fd, op, fd, &event);
+    // NOTE: The file descriptor may have been closed and reused for a different file behind our back.
+    if (rc < 0 && errno == ENOENT && op == EPOLL_CTL_MOD)
+        rc = epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    if (rc < 0) {
+        dbgln("Core::EventLoop: Failed to watch fd {}: {}", fd, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static void ensure_epoll_instance(int wake_pipe_read_fd)
+{
+    if (s_epoll_fd >= 0 && s_epoll_pid == getpid())
+        return;
+    if (s_epoll_fd >= 0)
+        (void)close(s_epoll_fd);
+
+    s_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (s_epoll_fd < 0) {
+        perror("Core::EventLoop: epoll_create1");
+        VERIFY_NOT_REACHED();
+    }
+    s_epoll_pid = getpid();
+
+    VERIFY(watch_fd_with_epoll(wake_pipe_read_fd, EPOLLIN, 0));
+    for (auto& it : *s_notifiers_by_fd) {
+        if (it.value.watched_events != 0 && !watch_fd_with_epoll(it.key, it.value.watched_events, 0))
+            it.value.watched_events = 0;
+    }
+}
+
+static void update_epoll_interest(int fd, int wake_pipe_read_fd)
+{
+    ensure_epoll_instance(wake_pipe_read_fd);
+    auto it = s_notifiers_by_fd->find(fd);
+    if (it == s_notifiers_by_fd->end())
+        return;
+
+    auto& entry = it->value;
+    u32 events = 0;
+    for (auto* notifier : entry.notifiers) {
+        if (notifier->event_mask() & Notifier::Read)
+            events |= EPOLLIN;
+        if (notifier->event_mask() & Notifier::Write)
+            events |= EPOLLOUT;
+        if (notifier->event_mask() & Notifier::Exceptional)
+            VERIFY_NOT_REACHED();
+    }
+
+    if (events != entry.watched_events) {
+        if (events == 0) {
+            // NOTE: This fails harmlessly if the file descriptor was already closed and reused.
+            (void)epoll_ctl(s_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+            entry.watched_events = 0;
+        } else {
+            entry.watched_events = watch_fd_with_epoll(fd, events, entry.watched_events) ? events : 0;
+        }
+    }
+
+    if (entry.notifiers.is_empty())
+        s_notifiers_by_fd->remove(it);
+}
+#endif
+
 bool EventLoop::has_been_instantiated()
 {
     return s_event_loop_stack != nullptr && !s_event_loop_stack->is_empty();
@@ -328,6 +415,9 @@ EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
         s_event_loop_stack = new Vector<EventLoop&>;
         s_timers = new HashMap<int, NonnullOwnPtr<EventLoopTimer>>;
         s_notifiers = new HashTable<Notifier*>;
+#ifdef AK_OS_SERENITY
+        s_notifiers_by_fd = new HashMap<int, NotifiersForFD>;
+#endif
     }
 
     if (s_event_loop_stack->is_empty()) {
@@ -463,12 +553,15 @@ size_t EventLoop::pump(WaitMode mode)
     size_t processed_events = 0;
     for (size_t i = 0; i < events.size(); ++i) {
         auto& queued_event = events.at(i);
-        auto receiver = queued_event.receiver.strong_ref();
-        auto& event = *queued_event.event;
-        if (receiver)
+        if (queued_event.invokee) {
+            dbgln_if(DEFERRED_INVOKE_DEBUG, "DeferredInvoke");
+            queued_event.invokee();
+        } else if (auto receiver = queued_event.receiver.strong_ref()) {
+            auto& event = *queued_event.event;
             dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: {} event {}", *receiver, event.type());
-
-        if (!receiver) {
+            receiver->dispatch_event(event);
+        } else {
+            auto& event = *queued_event.event;
             switch (event.type()) {
             case Event::Quit:
                 VERIFY_NOT_REACHED();
@@ -476,12 +569,6 @@ size_t EventLoop::pump(WaitMode mode)
                 dbgln_if(EVENTLOOP_DEBUG, "Event type {} with no receiver :(", event.type());
                 break;
             }
-        } else if (event.type() == Event::Type::DeferredInvoke) {
-            dbgln_if(DEFERRED_INVOKE_DEBUG, "DeferredInvoke: receiver = {}", *receiver);
-            static_cast<DeferredInvocationEvent&>(event).m_invokee();
-        } else {
-            NonnullRefPtr<Object> protector(*receiver);
-            receiver->dispatch_event(event);
         }
         ++processed_events;
 
@@ -510,6 +597,12 @@ void EventLoop::post_event(Object& receiver, NonnullOwnPtr<Event>&& event, Shoul
         wake();
 }
 
+void EventLoop::deferred_invoke(Function<void()> invokee)
+{
+    Threading::MutexLocker lock(m_private->lock);
+    m_queued_events.empend(move(invokee));
+}
+
 void EventLoop::wake_once(Object& receiver, int custom_event_type)
 {
     Threading::MutexLocker lock(m_private->lock);
@@ -663,6 +756,13 @@ void EventLoop::notify_forked(ForkEvent event)
         s_event_loop_stack->clear();
         s_timers->clear();
         s_notifiers->clear();
+#ifdef AK_OS_SERENITY
+        s_notifiers_by_fd->clear();
+        if (s_epoll_fd >= 0) {
+            (void)close(s_epoll_fd);
+            s_epoll_fd = -1;
+        }
+#endif
         s_wake_pipe_initialized = false;
         initialize_wake_pipes();
         if (auto* info = signals_info<false>()) {
@@ -678,6 +778,10 @@ void EventLoop::notify_forked(ForkEvent event)
 
 void EventLoop::wait_for_event(WaitMode mode)
 {
+#ifdef AK_OS_SERENITY
+retry:
+    ensure_epoll_instance(s_wake_pipe_fds[0]);
+#else
     fd_set rfds;
     fd_set wfds;
 retry:
@@ -703,6 +807,7 @@ retry:
         if (notifier->event_mask() & Notifier::Exceptional)
             VERIFY_NOT_REACHED();
     }
+#endif
 
     bool queued_events_is_empty;
     {
@@ -726,8 +831,17 @@ retry:
         }
     }
 
+#ifdef AK_OS_SERENITY
+    // NOTE: Round up, so that we don't keep waking up just before a timer is due.
+    int timeout_ms = should_wait_forever ? -1 : static_cast<int>(timeout.tv_sec * 1000 + (timeout.tv_usec + 999) / 1000);
+    epoll_event ready_events[max_ready_events_per_wait];
+
+try_select_again:
+    int marked_fd_count = epoll_wait(s_epoll_fd, ready_events, max_ready_events_per_wait, timeout_ms);
+#else
 try_select_again:
     int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+#endif
     if (marked_fd_count < 0) {
         int saved_errno = errno;
         if (saved_errno == EINTR) {
@@ -738,7 +852,17 @@ try_select_again:
         dbgln("Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
         VERIFY_NOT_REACHED();
     }
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+
+#ifdef AK_OS_SERENITY
+    bool wake_pipe_is_ready = false;
+    for (int i = 0; i < marked_fd_count; ++i) {
+        if (ready_events[i].data.fd == s_wake_pipe_fds[0])
+            wake_pipe_is_ready = true;
+    }
+#else
+    bool wake_pipe_is_ready = FD_ISSET(s_wake_pipe_fds[0], &rfds);
+#endif
+    if (wake_pipe_is_ready) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -796,6 +920,20 @@ try_select_again:
     if (!marked_fd_count)
         return;
 
+#ifdef AK_OS_SERENITY
+    for (int i = 0; i < marked_fd_count; ++i) {
+        auto& ready_event = ready_events[i];
+        auto it = s_notifiers_by_fd->find(ready_event.data.fd);
+        if (it == s_notifiers_by_fd->end())
+            continue;
+        for (auto* notifier : it->value.notifiers) {
+            if ((ready_event.events & EPOLLIN) && (notifier->event_mask() & Notifier::Event::Read))
+                post_event(*notifier, make<NotifierReadEvent>(notifier->fd()));
+            if ((ready_event.events & EPOLLOUT) && (notifier->event_mask() & Notifier::Event::Write))
+                post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
+        }
+    }
+#else
     for (auto& notifier : *s_notifiers) {
         if (FD_ISSET(notifier->fd(), &rfds)) {
             if (notifier->event_mask() & Notifier::Event::Read)
@@ -806,6 +944,7 @@ try_select_again:
                 post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
         }
     }
+#endif
 }
 
 bool EventLoopTimer::has_expired(Time const& now) const
@@ -869,13 +1008,33 @@ bool EventLoop::unregister_timer(int timer_id)
 void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
-    s_notifiers->set(&notifier);
+    [[maybe_unused]] auto result = s_notifiers->set(&notifier);
+#ifdef AK_OS_SERENITY
+    if (result == AK::HashSetResult::InsertedNewEntry)
+        s_notifiers_by_fd->ensure(notifier.fd()).notifiers.append(&notifier);
+    update_epoll_interest(notifier.fd(), s_wake_pipe_fds[0]);
+#endif
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
-    s_notifiers->remove(&notifier);
+    if (!s_notifiers->remove(&notifier))
+        return;
+#ifdef AK_OS_SERENITY
+    if (auto it = s_notifiers_by_fd->find(notifier.fd()); it != s_notifiers_by_fd->end())
+        it->value.notifiers.remove_first_matching([&](auto* entry) { return entry == &notifier; });
+    update_epoll_interest(notifier.fd(), s_wake_pipe_fds[0]);
+#endif
+}
+
+void EventLoop::notifier_event_mask_changed(Badge<Notifier>, [[maybe_unused]] Notifier& notifier)
+{
+    VERIFY_EVENT_LOOP_INITIALIZED();
+#ifdef AK_OS_SERENITY
+    if (s_notifiers->contains(&notifier))
+        update_epoll_interest(notifier.fd(), s_wake_pipe_fds[0]);
+#endif
 }
 
 void EventLoop::wake_current()
@@ -900,9 +1059,15 @@ EventLoop::QueuedEvent::QueuedEvent(Object& receiver, NonnullOwnPtr<Event> event
 {
 }
 
+EventLoop::QueuedEvent::QueuedEvent(Function<void()> invokee)
+    : invokee(move(invokee))
+{
+}
+
 EventLoop::QueuedEvent::QueuedEvent(QueuedEvent&& other)
     : receiver(other.receiver)
     , event(move(other.event))
+    , invokee(move(other.invokee))
 {
 }
 
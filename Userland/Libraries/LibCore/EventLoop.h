@@ -17,7 +17,6 @@
 #include <AK/Time.h>
 #include <AK/Vector.h>
 #include <AK/WeakPtr.h>
-#include <LibCore/DeferredInvocationContext.h>
 #include <LibCore/Event.h>
 #include <LibCore/Forward.h>
 #include <LibThreading/MutexProtected.h>
@@ -67,6 +66,7 @@ public:
 
     static void register_notifier(Badge<Notifier>, Notifier&);
     static void unregister_notifier(Badge<Notifier>, Notifier&);
+    static void notifier_event_mask_changed(Badge<Notifier>, Notifier&);
 
     void quit(int);
     void unquit();
@@ -91,11 +91,8 @@ public:
 
     static bool has_been_instantiated();
 
-    void deferred_invoke(Function<void()> invokee)
-    {
-        auto context = DeferredInvocationContext::construct();
-        post_event(context, make<Core::DeferredInvocationEvent>(context, move(invokee)));
-    }
+    // Calls `invokee` from the event loop, after the events that are already queued.
+    void deferred_invoke(Function<void()> invokee);
 
 private:
     void wait_for_event(WaitMode);
@@ -103,16 +100,20 @@ private:
     static void dispatch_signal(int);
     static void handle_signal(int);
 
+    // Either an event for a receiver, or a deferred invocation. Deferred invocations are kept in the queue itself,
+    // and most callbacks fit into a Function without allocating, so they don't cost anything past the queue.
     struct QueuedEvent {
         AK_MAKE_NONCOPYABLE(QueuedEvent);
 
     public:
         QueuedEvent(Object& receiver, NonnullOwnPtr<Event>);
+        explicit QueuedEvent(Function<void()> invokee);
         QueuedEvent(QueuedEvent&&);
         ~QueuedEvent() = default;
 
         WeakPtr<Object> receiver;
-        NonnullOwnPtr<Event> event;
+        OwnPtr<Event> event;
+        Function<void()> invokee;
     };
 
     Vector<QueuedEvent, 64> m_queued_events;
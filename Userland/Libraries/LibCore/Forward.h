@@ -15,11 +15,11 @@ class ConfigFile;
 class CustomEvent;
 class DateTime;
 class DirIterator;
-class DeferredInvocationContext;
 class ElapsedTimer;
 class Event;
 class EventLoop;
 class File;
+class HostLookup;
 class IODevice;
 class LocalServer;
 class MimeData;
@@ -41,6 +41,7 @@ namespace Stream {
 class Socket;
 class Stream;
 class BufferedSocketBase;
+class TCPConnector;
 }
 
 }
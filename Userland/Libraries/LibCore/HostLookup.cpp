@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/HostLookup.h>
+#include <string.h>
+
+namespace Core {
+
+// LookupServer's IPC endpoint can't be used from LibCore, since LibIPC is built on top of it.
+// Like LibC/netdb.cpp, we speak the lookup_name() message by hand instead.
+// Keep the name synchronized with LookupServer/LookupServer.ipc.
+static constexpr u32 lookup_server_endpoint_magic = "LookupServer"sv.hash();
+static constexpr i32 lookup_name_message_id = 1;
+static constexpr i32 lookup_name_response_message_id = 2;
+
+HostLookup::HostLookup(String host, Callback callback)
+    : m_host(move(host))
+    , m_callback(move(callback))
+{
+    // Never call back before whoever made us had a chance to hold on to us.
+    Core::deferred_invoke([weak_this = make_weak_ptr<HostLookup>()] {
+        if (auto strong_this = weak_this.strong_ref())
+            strong_this->start();
+    });
+}
+
+void HostLookup::cancel()
+{
+    m_callback = nullptr;
+    discard_socket();
+}
+
+void HostLookup::start()
+{
+    if (!m_callback)
+        return;
+
+    if (auto address = IPv4Address::from_string(m_host); address.has_value()) {
+        finish(Vector<IPv4Address> { address.release_value() });
+        return;
+    }
+
+    if (auto result = send_request(); result.is_error()) {
+        // Without a LookupServer to talk to (like on Lagom), all we can do is ask the system, which blocks.
+        dbgln_if(CSOCKET_DEBUG, "HostLookup: Couldn't ask LookupServer for {}, falling back to getaddrinfo: {}", m_host, result.error());
+        discard_socket();
+        finish(Stream::Socket::resolve_host_addresses(m_host, Stream::Socket::SocketType::Stream));
+    }
+}
+
+ErrorOr<void> HostLookup::send_request()
+{
+    m_socket = TRY(Stream::LocalSocket::connect("/tmp/portal/lookup"));
+
+    auto name_length = static_cast<i32>(m_host.length());
+    struct [[gnu::packed]] {
+        u32 message_size;
+        u32 endpoint_magic;
+        i32 message_id;
+        i32 name_length;
+    } request_header = {
+        static_cast<u32>(sizeof(request_header) - sizeof(request_header.message_size) + name_length),
+        lookup_server_endpoint_magic,
+        lookup_name_message_id,
+        name_length,
+    };
+    // LookupServer might otherwise see the header on its own, and take it for a complete message.
+    auto request = TRY(ByteBuffer::create_uninitialized(sizeof(request_header) + name_length));
+    memcpy(request.data(), &request_header, sizeof(request_header));
+    memcpy(request.data() + sizeof(request_header), m_host.characters(), name_length);
+    // The request is tiny, so it goes out in one piece while the socket is still blocking.
+    if (!m_socket->write_or_error(request))
+        return Error::from_string_literal("Failed to send the request to LookupServer");
+
+    TRY(m_socket->set_blocking(false));
+    m_socket->on_ready_to_read = [this] {
+        did_receive_data();
+    };
+    return {};
+}
+
+void HostLookup::did_receive_data()
+{
+    u8 buffer[1 * KiB];
+    bool did_reach_eof = false;
+    for (;;) {
+        auto bytes_or_error = m_socket->read({ buffer, sizeof(buffer) });
+        if (bytes_or_error.is_error()) {
+            if (bytes_or_error.error().is_errno() && bytes_or_error.error().code() == EAGAIN)
+                break;
+            finish(bytes_or_error.release_error());
+            return;
+        }
+        if (bytes_or_error.value().is_empty()) {
+            did_reach_eof = true;
+            break;
+        }
+        if (m_response.try_append(bytes_or_error.value()).is_error()) {
+            finish(Error::from_errno(ENOMEM));
+            return;
+        }
+    }
+
+    auto has_complete_response = [&] {
+        if (m_response.size() < sizeof(u32))
+            return false;
+        auto message_size = *reinterpret_cast<u32 const*>(m_response.data());
+        return m_response.size() >= sizeof(u32) + message_size;
+    };
+    if (has_complete_response())
+        finish(parse_response());
+    else if (did_reach_eof)
+        finish(Error::from_string_literal("LookupServer closed the connection"));
+}
+
+ErrorOr<Vector<IPv4Address>> HostLookup::parse_response() const
+{
+    ReadonlyBytes bytes = m_response;
+    auto read = [&]<typename T>(T& value) {
+        if (bytes.size() < sizeof(T))
+            return false;
+        memcpy(&value, bytes.data(), sizeof(T));
+        bytes = bytes.slice(sizeof(T));
+        return true;
+    };
+
+    struct [[gnu::packed]] {
+        u32 message_size;
+        u32 endpoint_magic;
+        i32 message_id;
+        i32 code;
+        u64 address_count;
+    } response_header;
+    if (!read(response_header) || response_header.endpoint_magic != lookup_server_endpoint_magic || response_header.message_id != lookup_name_response_message_id)
+        return Error::from_string_literal("Invalid response from LookupServer");
+    if (response_header.code != 0)
+        return Error::from_string_literal("LookupServer failed to look up the host");
+
+    Vector<IPv4Address> addresses;
+    for (u64 i = 0; i < response_header.address_count; ++i) {
+        i32 length;
+        if (!read(length) || length < 0 || static_cast<size_t>(length) > bytes.size())
+            return Error::from_string_literal("Invalid response from LookupServer");
+        auto record = bytes.trim(length);
+        bytes = bytes.slice(length);
+        // Anything that isn't an A record (like the CNAME that led us to it) is of no use to us.
+        if (record.size() == sizeof(u32))
+            addresses.append(IPv4Address { record.data() });
+    }
+    if (addresses.is_empty())
+        return Error::from_string_literal("Host has no IPv4 addresses");
+    return addresses;
+}
+
+void HostLookup::finish(ErrorOr<Vector<IPv4Address>> result)
+{
+    // Whoever we call back might well let go of us.
+    NonnullRefPtr protector { *this };
+    auto callback = move(m_callback);
+    cancel();
+    if (callback)
+        callback(move(result));
+}
+
+void HostLookup::discard_socket()
+{
+    if (!m_socket)
+        return;
+    m_socket->set_notifications_enabled(false);
+    // We might be inside its on_ready_to_read right now, so it has to stay around until that returns.
+    Core::deferred_invoke([socket = move(m_socket)] {});
+    m_response.clear();
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/IPv4Address.h>
+#include <AK/OwnPtr.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/Object.h>
+#include <LibCore/Stream.h>
+
+namespace Core {
+
+// Looks up the IPv4 addresses of a host through LookupServer, without blocking the event loop.
+// The callback is invoked from the event loop, unless the lookup is cancelled or dropped first.
+class HostLookup final : public Object {
+    C_OBJECT(HostLookup)
+
+public:
+    using Callback = Function<void(ErrorOr<Vector<IPv4Address>>)>;
+
+    virtual ~HostLookup() override = default;
+
+    String const& host() const { return m_host; }
+
+    void cancel();
+
+private:
+    HostLookup(String host, Callback);
+
+    void start();
+    ErrorOr<void> send_request();
+    void did_receive_data();
+    ErrorOr<Vector<IPv4Address>> parse_response() const;
+
+    void finish(ErrorOr<Vector<IPv4Address>>);
+    void discard_socket();
+
+    String m_host;
+    Callback m_callback;
+    OwnPtr<Stream::LocalSocket> m_socket;
+    ByteBuffer m_response;
+};
+
+}
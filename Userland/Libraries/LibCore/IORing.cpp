@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/IORing.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(AK_OS_SERENITY)
+#    include <serenity.h>
+#endif
+
+namespace Core {
+
+template<typename T>
+static ErrorOr<T> result_from(i32 result)
+{
+    if (result < 0)
+        return Error::from_errno(-result);
+    return static_cast<T>(result);
+}
+
+#if defined(AK_OS_SERENITY)
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::create(u32 entries)
+{
+    auto fd = io_ring_create(entries, O_CLOEXEC);
+    if (fd < 0)
+        return Error::from_syscall("io_ring_create"sv, -errno);
+
+    auto* ring = mmap(nullptr, Kernel::io_ring_mapping_size(entries), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ring == MAP_FAILED) {
+        auto saved_errno = errno;
+        (void)::close(fd);
+        return Error::from_syscall("mmap"sv, -saved_errno);
+    }
+
+    auto notifier = Notifier::construct(fd, Notifier::Event::Read);
+    return adopt_ref(*new IORing(fd, entries, static_cast<u8*>(ring), move(notifier)));
+}
+
+IORing::IORing(int fd, u32 entries, u8* ring, NonnullRefPtr<Notifier> notifier)
+    : m_fd(fd)
+    , m_entries(entries)
+    , m_ring(ring)
+    , m_notifier(move(notifier))
+{
+    m_notifier->on_ready_to_read = [this] {
+        process_completions();
+    };
+}
+
+IORing::~IORing()
+{
+    m_notifier->close();
+    (void)munmap(m_ring, Kernel::io_ring_mapping_size(m_entries));
+    (void)::close(m_fd);
+}
+
+ErrorOr<void> IORing::submit(Kernel::IORingSubmission submission, PendingOperation operation)
+{
+    auto& header = this->header();
+    auto tail = header.submission_tail;
+    if (tail - AK::atomic_load(&header.submission_head, AK::MemoryOrder::memory_order_acquire) >= m_entries) {
+        TRY(flush());
+        if (tail - AK::atomic_load(&header.submission_head, AK::MemoryOrder::memory_order_acquire) >= m_entries)
+            return Error::from_errno(EBUSY);
+    }
+
+    submission.user_data = m_next_user_data++;
+    TRY(m_pending_operations.try_set(submission.user_data, move(operation)));
+
+    auto* submissions = reinterpret_cast<Kernel::IORingSubmission*>(m_ring + Kernel::io_ring_submissions_offset());
+    submissions[tail & (m_entries - 1)] = submission;
+    AK::atomic_store(&header.submission_tail, tail + 1, AK::MemoryOrder::memory_order_release);
+
+    if (m_unflushed_submissions++ == 0) {
+        deferred_invoke([weak_this = make_weak_ptr()]() mutable {
+            if (weak_this)
+                (void)weak_this->flush();
+        });
+    }
+    return {};
+}
+
+ErrorOr<void> IORing::flush()
+{
+    while (m_unflushed_submissions > 0) {
+        auto rc = io_ring_enter(m_fd, m_unflushed_submissions, 0);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            return Error::from_syscall("io_ring_enter"sv, -errno);
+        }
+        m_unflushed_submissions -= min<u32>(rc, m_unflushed_submissions);
+        if (rc == 0)
+            break;
+    }
+    return {};
+}
+
+void IORing::process_completions()
+{
+    auto& header = this->header();
+    auto* completions = reinterpret_cast<Kernel::IORingCompletion const*>(m_ring + Kernel::io_ring_completions_offset(m_entries));
+    auto completion_mask = Kernel::io_ring_completion_entries(m_entries) - 1;
+
+    auto head = header.completion_head;
+    while (head != AK::atomic_load(&header.completion_tail, AK::MemoryOrder::memory_order_acquire)) {
+        auto completion = completions[head & completion_mask];
+        ++head;
+        // NOTE: Give the slot back before running the callback, since it might start more operations.
+        AK::atomic_store(&header.completion_head, head, AK::MemoryOrder::memory_order_release);
+
+        auto it = m_pending_operations.find(completion.user_data);
+        if (it == m_pending_operations.end())
+            continue;
+        auto operation = move(it->value);
+        m_pending_operations.remove(it);
+        operation.on_complete(completion.result);
+    }
+}
+
+#else
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::create(u32)
+{
+    return Error::from_errno(ENOTSUP);
+}
+
+IORing::~IORing() = default;
+
+ErrorOr<void> IORing::submit(Kernel::IORingSubmission, PendingOperation)
+{
+    return Error::from_errno(ENOTSUP);
+}
+
+ErrorOr<void> IORing::flush()
+{
+    return Error::from_errno(ENOTSUP);
+}
+
+void IORing::process_completions()
+{
+}
+
+#endif
+
+ErrorOr<void> IORing::read(int fd, Bytes buffer, Optional<u64> offset, Function<void(ErrorOr<size_t>)> callback)
+{
+    Kernel::IORingSubmission submission {};
+    submission.operation = Kernel::IORingOperation::Read;
+    submission.fd = fd;
+    submission.offset = offset.value_or(Kernel::io_ring_current_offset);
+    submission.address = reinterpret_cast<FlatPtr>(buffer.data());
+    submission.length = buffer.size();
+    return submit(submission, { [callback = move(callback)](i32 result) { callback(result_from<size_t>(result)); }, {} });
+}
+
+ErrorOr<void> IORing::write(int fd, ReadonlyBytes buffer, Optional<u64> offset, Function<void(ErrorOr<size_t>)> callback)
+{
+    Kernel::IORingSubmission submission {};
+    submission.operation = Kernel::IORingOperation::Write;
+    submission.fd = fd;
+    submission.offset = offset.value_or(Kernel::io_ring_current_offset);
+    submission.address = reinterpret_cast<FlatPtr>(buffer.data());
+    submission.length = buffer.size();
+    return submit(submission, { [callback = move(callback)](i32 result) { callback(result_from<size_t>(result)); }, {} });
+}
+
+ErrorOr<void> IORing::poll(int fd, short events, Function<void(ErrorOr<short>)> callback)
+{
+    Kernel::IORingSubmission submission {};
+    submission.operation = Kernel::IORingOperation::Poll;
+    submission.fd = fd;
+    submission.poll_events = events;
+    return submit(submission, { [callback = move(callback)](i32 result) { callback(result_from<short>(result)); }, {} });
+}
+
+ErrorOr<void> IORing::accept(int fd, int flags, Function<void(ErrorOr<int>)> callback)
+{
+    Kernel::IORingSubmission submission {};
+    submission.operation = Kernel::IORingOperation::Accept;
+    submission.fd = fd;
+    submission.flags = flags;
+    return submit(submission, { [callback = move(callback)](i32 result) { callback(result_from<int>(result)); }, {} });
+}
+
+ErrorOr<void> IORing::connect(int fd, sockaddr const* address, socklen_t address_length, Function<void(ErrorOr<void>)> callback)
+{
+    Vector<u8> address_copy;
+    TRY(address_copy.try_append(reinterpret_cast<u8 const*>(address), address_length));
+
+    Kernel::IORingSubmission submission {};
+    submission.operation = Kernel::IORingOperation::Connect;
+    submission.fd = fd;
+    submission.address = reinterpret_cast<FlatPtr>(address_copy.data());
+    submission.length = address_length;
+    auto on_complete = [callback = move(callback)](i32 result) {
+        if (result < 0)
+            return callback(Error::from_errno(-result));
+        callback(ErrorOr<void> {});
+    };
+    return submit(submission, { move(on_complete), move(address_copy) });
+}
+
+}
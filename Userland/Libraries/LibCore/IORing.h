@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <AK/Weakable.h>
+#include <Kernel/API/IORing.h>
+#include <LibCore/Notifier.h>
+#include <sys/socket.h>
+
+namespace Core {
+
+// Batches I/O operations into a kernel I/O ring, and runs their callbacks from the event loop as they complete.
+// Operations are handed to the kernel on the next event loop iteration (or when calling flush()), so any number
+// of them can be started with a single syscall. Buffers passed to read() and write() have to stay alive until
+// the operation's callback has run.
+class IORing final
+    : public RefCounted<IORing>
+    , public Weakable<IORing> {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    static ErrorOr<NonnullRefPtr<IORing>> create(u32 entries = 256);
+    ~IORing();
+
+    ErrorOr<void> read(int fd, Bytes, Optional<u64> offset, Function<void(ErrorOr<size_t>)>);
+    ErrorOr<void> write(int fd, ReadonlyBytes, Optional<u64> offset, Function<void(ErrorOr<size_t>)>);
+    ErrorOr<void> poll(int fd, short events, Function<void(ErrorOr<short>)>);
+    // The flags can be SOCK_NONBLOCK and SOCK_CLOEXEC, like with accept4().
+    ErrorOr<void> accept(int fd, int flags, Function<void(ErrorOr<int>)>);
+    ErrorOr<void> connect(int fd, sockaddr const*, socklen_t, Function<void(ErrorOr<void>)>);
+
+    // Hands all queued operations to the kernel right away.
+    ErrorOr<void> flush();
+
+    // Runs the callbacks of all operations that have completed.
+    void process_completions();
+
+    size_t pending_operation_count() const { return m_pending_operations.size(); }
+
+private:
+    IORing(int fd, u32 entries, u8* ring, NonnullRefPtr<Notifier>);
+
+    struct PendingOperation {
+        Function<void(i32)> on_complete;
+        // The kernel reads connect() addresses when the submission is flushed, so we hold on to a copy until then.
+        Vector<u8> address;
+    };
+
+    Kernel::IORingHeader& header() { return *reinterpret_cast<Kernel::IORingHeader*>(m_ring); }
+    ErrorOr<void> submit(Kernel::IORingSubmission, PendingOperation);
+
+    int m_fd { -1 };
+    u32 m_entries { 0 };
+    u8* m_ring { nullptr };
+    NonnullRefPtr<Notifier> m_notifier;
+
+    u32 m_unflushed_submissions { 0 };
+    u64 m_next_user_data { 1 };
+    HashMap<u64, PendingOperation> m_pending_operations;
+};
+
+}
@@ -31,6 +31,8 @@ public:
     Function<void(HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code)> on_headers_received;
     Function<void(bool success)> on_finish;
     Function<void(Optional<u32>, u32)> on_progress;
+    // Called with every part of the response body once it has been written to the output stream.
+    Function<void(ReadonlyBytes)> on_body_data_written;
 
     bool is_cancelled() const { return m_error == Error::Cancelled; }
     bool has_error() const { return m_error != Error::None; }
@@ -58,7 +60,13 @@ protected:
     void did_fail(Error);
     void did_progress(Optional<u32> total_size, u32 downloaded);
 
-    ErrorOr<size_t> do_write(ReadonlyBytes bytes) { return m_output_stream.write(bytes); }
+    ErrorOr<size_t> do_write(ReadonlyBytes bytes)
+    {
+        auto written = TRY(m_output_stream.write(bytes));
+        if (on_body_data_written)
+            on_body_data_written(bytes.trim(written));
+        return written;
+    }
 
 private:
     RefPtr<NetworkResponse> m_response;
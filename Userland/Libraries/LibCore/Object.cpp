@@ -17,7 +17,8 @@ namespace Core {
 
 IntrusiveList<&Object::m_all_objects_list_node>& Object::all_objects()
 {
-    static IntrusiveList<&Object::m_all_objects_list_node> objects;
+    // Objects belong to the thread (and event loop) that created them, so every thread keeps its own list.
+    static thread_local IntrusiveList<&Object::m_all_objects_list_node> objects;
     return objects;
 }
 
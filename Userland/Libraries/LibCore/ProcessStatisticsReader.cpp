@@ -5,9 +5,7 @@
  */
 
 #include <AK/ByteBuffer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
@@ -31,76 +29,139 @@ Optional<AllProcessesStatistics> ProcessStatisticsReader::get_all(RefPtr<Core::F
         }
     }
 
-    AllProcessesStatistics all_processes_statistics;
-
     auto file_contents = proc_all_file->read_all();
-    auto json = JsonValue::from_string(file_contents);
-    if (json.is_error())
+    auto result = parse_all(file_contents, include_usernames);
+    if (result.is_error()) {
+        warnln("ProcessStatisticsReader: Failed to parse /sys/kernel/processes: {}", result.error());
         return {};
+    }
+    return result.release_value();
+}
+
+namespace {
+
+// Walks the records in /sys/kernel/processes, see Kernel/API/ProcessStatistics.h.
+class RecordReader {
+public:
+    explicit RecordReader(ReadonlyBytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    bool is_eof() const { return m_offset == m_bytes.size(); }
 
-    auto& json_obj = json.value().as_object();
-    json_obj.get("processes"sv).as_array().for_each([&](auto& value) {
-        const JsonObject& process_object = value.as_object();
-        Core::ProcessStatistics process;
+    // The kernel may know more fields than we do, in which case the ones we don't know are skipped,
+    // and if it knows fewer, the rest of the record stays zeroed.
+    template<typename Record>
+    ErrorOr<Record> read_record(size_t record_size)
+    {
+        if (m_bytes.size() - m_offset < record_size)
+            return Error::from_string_literal("Truncated record");
+        Record record {};
+        __builtin_memcpy(&record, m_bytes.offset(m_offset), min(record_size, sizeof(record)));
+        m_offset += record_size;
+        return record;
+    }
+
+    ErrorOr<void> skip(size_t count)
+    {
+        if (m_bytes.size() - m_offset < count)
+            return Error::from_string_literal("Truncated record");
+        m_offset += count;
+        return {};
+    }
+
+    ErrorOr<String> read_string(size_t length)
+    {
+        if (m_bytes.size() - m_offset < length)
+            return Error::from_string_literal("Truncated string");
+        auto string = StringView { m_bytes.slice(m_offset, length) };
+        m_offset += length;
+        return String(string);
+    }
+
+private:
+    ReadonlyBytes m_bytes;
+    size_t m_offset { 0 };
+};
+
+}
+
+ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::parse_all(ReadonlyBytes bytes, bool include_usernames)
+{
+    RecordReader reader(bytes);
+
+    auto header = TRY(reader.read_record<Kernel::ProcessStatisticsHeader>(sizeof(Kernel::ProcessStatisticsHeader)));
+    if (header.magic != Kernel::process_statistics_magic)
+        return Error::from_string_literal("Not a process statistics file");
+    if (header.version != Kernel::process_statistics_version)
+        return Error::from_string_literal("Unsupported process statistics version");
+    if (header.header_size < sizeof(Kernel::ProcessStatisticsHeader))
+        return Error::from_string_literal("Invalid process statistics header");
+    TRY(reader.skip(header.header_size - sizeof(Kernel::ProcessStatisticsHeader)));
+
+    AllProcessesStatistics all_processes_statistics {};
+    all_processes_statistics.total_time_scheduled = header.total_time;
+    all_processes_statistics.total_time_scheduled_kernel = header.total_time_kernel;
+
+    while (!reader.is_eof()) {
+        auto record = TRY(reader.read_record<Kernel::ProcessStatisticsRecord>(header.process_record_size));
 
         // kernel data first
-        process.pid = process_object.get("pid"sv).to_u32();
-        process.pgid = process_object.get("pgid"sv).to_u32();
-        process.pgp = process_object.get("pgp"sv).to_u32();
-        process.sid = process_object.get("sid"sv).to_u32();
-        process.uid = process_object.get("uid"sv).to_u32();
-        process.gid = process_object.get("gid"sv).to_u32();
-        process.ppid = process_object.get("ppid"sv).to_u32();
-        process.nfds = process_object.get("nfds"sv).to_u32();
-        process.kernel = process_object.get("kernel"sv).to_bool();
-        process.name = process_object.get("name"sv).to_string();
-        process.executable = process_object.get("executable"sv).to_string();
-        process.tty = process_object.get("tty"sv).to_string();
-        process.pledge = process_object.get("pledge"sv).to_string();
-        process.veil = process_object.get("veil"sv).to_string();
-        process.amount_virtual = process_object.get("amount_virtual"sv).to_u32();
-        process.amount_resident = process_object.get("amount_resident"sv).to_u32();
-        process.amount_shared = process_object.get("amount_shared"sv).to_u32();
-        process.amount_dirty_private = process_object.get("amount_dirty_private"sv).to_u32();
-        process.amount_clean_inode = process_object.get("amount_clean_inode"sv).to_u32();
-        process.amount_purgeable_volatile = process_object.get("amount_purgeable_volatile"sv).to_u32();
-        process.amount_purgeable_nonvolatile = process_object.get("amount_purgeable_nonvolatile"sv).to_u32();
-
-        auto& thread_array = process_object.get_ptr("threads"sv)->as_array();
-        process.threads.ensure_capacity(thread_array.size());
-        thread_array.for_each([&](auto& value) {
-            auto& thread_object = value.as_object();
-            Core::ThreadStatistics thread;
-            thread.tid = thread_object.get("tid"sv).to_u32();
-            thread.times_scheduled = thread_object.get("times_scheduled"sv).to_u32();
-            thread.name = thread_object.get("name"sv).to_string();
-            thread.state = thread_object.get("state"sv).to_string();
-            thread.time_user = thread_object.get("time_user"sv).to_u64();
-            thread.time_kernel = thread_object.get("time_kernel"sv).to_u64();
-            thread.cpu = thread_object.get("cpu"sv).to_u32();
-            thread.priority = thread_object.get("priority"sv).to_u32();
-            thread.syscall_count = thread_object.get("syscall_count"sv).to_u32();
-            thread.inode_faults = thread_object.get("inode_faults"sv).to_u32();
-            thread.zero_faults = thread_object.get("zero_faults"sv).to_u32();
-            thread.cow_faults = thread_object.get("cow_faults"sv).to_u32();
-            thread.unix_socket_read_bytes = thread_object.get("unix_socket_read_bytes"sv).to_u32();
-            thread.unix_socket_write_bytes = thread_object.get("unix_socket_write_bytes"sv).to_u32();
-            thread.ipv4_socket_read_bytes = thread_object.get("ipv4_socket_read_bytes"sv).to_u32();
-            thread.ipv4_socket_write_bytes = thread_object.get("ipv4_socket_write_bytes"sv).to_u32();
-            thread.file_read_bytes = thread_object.get("file_read_bytes"sv).to_u32();
-            thread.file_write_bytes = thread_object.get("file_write_bytes"sv).to_u32();
-            process.threads.append(move(thread));
-        });
+        ProcessStatistics process {};
+        process.pid = record.pid;
+        process.pgid = record.pgid;
+        process.pgp = record.pgp;
+        process.sid = record.sid;
+        process.uid = record.uid;
+        process.gid = record.gid;
+        process.ppid = record.ppid;
+        process.nfds = record.nfds;
+        process.kernel = record.kernel;
+        process.name = TRY(reader.read_string(record.name_length));
+        process.executable = TRY(reader.read_string(record.executable_length));
+        process.tty = TRY(reader.read_string(record.tty_length));
+        process.pledge = TRY(reader.read_string(record.pledge_length));
+        process.veil = TRY(reader.read_string(record.veil_length));
+        process.amount_virtual = record.amount_virtual;
+        process.amount_resident = record.amount_resident;
+        process.amount_shared = record.amount_shared;
+        process.amount_dirty_private = record.amount_dirty_private;
+        process.amount_clean_inode = record.amount_clean_inode;
+        process.amount_purgeable_volatile = record.amount_purgeable_volatile;
+        process.amount_purgeable_nonvolatile = record.amount_purgeable_nonvolatile;
+
+        TRY(process.threads.try_ensure_capacity(record.thread_count));
+        for (u32 i = 0; i < record.thread_count; ++i) {
+            auto thread_record = TRY(reader.read_record<Kernel::ThreadStatisticsRecord>(header.thread_record_size));
+            ThreadStatistics thread {};
+            thread.tid = thread_record.tid;
+            thread.times_scheduled = thread_record.times_scheduled;
+            thread.time_user = thread_record.time_user;
+            thread.time_kernel = thread_record.time_kernel;
+            thread.cpu = thread_record.cpu;
+            thread.priority = thread_record.priority;
+            thread.syscall_count = thread_record.syscall_count;
+            thread.inode_faults = thread_record.inode_faults;
+            thread.zero_faults = thread_record.zero_faults;
+            thread.cow_faults = thread_record.cow_faults;
+            thread.unix_socket_read_bytes = thread_record.unix_socket_read_bytes;
+            thread.unix_socket_write_bytes = thread_record.unix_socket_write_bytes;
+            thread.ipv4_socket_read_bytes = thread_record.ipv4_socket_read_bytes;
+            thread.ipv4_socket_write_bytes = thread_record.ipv4_socket_write_bytes;
+            thread.file_read_bytes = thread_record.file_read_bytes;
+            thread.file_write_bytes = thread_record.file_write_bytes;
+            thread.name = TRY(reader.read_string(thread_record.name_length));
+            thread.state = TRY(reader.read_string(thread_record.state_length));
+            process.threads.unchecked_append(move(thread));
+        }
 
         // and synthetic data last
-        if (include_usernames) {
+        if (include_usernames)
             process.username = username_from_uid(process.uid);
-        }
-        all_processes_statistics.processes.append(move(process));
-    });
+        TRY(all_processes_statistics.processes.try_append(move(process)));
+    }
 
-    all_processes_statistics.total_time_scheduled = json_obj.get("total_time"sv).to_u64();
-    all_processes_statistics.total_time_scheduled_kernel = json_obj.get("total_time_kernel"sv).to_u64();
     return all_processes_statistics;
 }
 
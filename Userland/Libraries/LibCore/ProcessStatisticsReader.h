@@ -75,6 +75,8 @@ public:
     static Optional<AllProcessesStatistics> get_all(RefPtr<Core::File>&, bool include_usernames = true);
     static Optional<AllProcessesStatistics> get_all(bool include_usernames = true);
 
+    static ErrorOr<AllProcessesStatistics> parse_all(ReadonlyBytes, bool include_usernames = true);
+
 private:
     static String username_from_uid(uid_t);
     static HashMap<uid_t, String> s_usernames;
@@ -29,6 +29,10 @@
 #include <sched.h>
 #include <sys/mman.h>
 
+#ifdef AK_OS_SERENITY
+#    include <serenity.h>
+#endif
+
 namespace Core {
 
 // A circular lock-free queue (or a buffer) with a single producer,
@@ -109,6 +113,38 @@ public:
         return ((head() - 1) % Size) != (m_queue->m_queue->m_tail.load() % Size);
     }
 
+    // Limits how many elements blocking_enqueue() keeps in the queue, which bounds the latency between enqueuing and
+    // dequeuing an element. This is meant to be set by the consumer and doesn't affect try_enqueue().
+    void set_producer_limit(size_t limit)
+    {
+        m_queue->m_queue->m_producer_limit.store(clamp<size_t>(limit, 1, Size - 1), AK::MemoryOrder::memory_order_relaxed);
+    }
+    size_t producer_limit() const { return m_queue->m_queue->m_producer_limit.load(AK::MemoryOrder::memory_order_relaxed); }
+
+    // Enqueues once there is room and fewer than producer_limit() elements are queued. Until then, the producer sleeps
+    // on a futex that is woken by the next dequeue, so there is no polling.
+    ErrorOr<void> blocking_enqueue(ValueType to_insert)
+    {
+        VERIFY(!m_queue.is_null());
+        auto& queue = *m_queue->m_queue;
+        while (true) {
+            auto dequeue_count = queue.m_dequeue_count.load();
+            if (weak_used() < producer_limit()) {
+                auto result = try_enqueue(to_insert);
+                if (!result.is_error())
+                    return {};
+                if (result.error() != QueueStatus::Full)
+                    return Error::from_string_literal("Unexpected error while enqueuing");
+            }
+
+            queue.m_producer_waiting.store(true);
+            // A dequeue that happened before the flag was set doesn't wake us, so we have to look again.
+            if (queue.m_dequeue_count.load() != dequeue_count)
+                continue;
+            wait_for_dequeue(dequeue_count);
+        }
+    }
+
     // Repeatedly try to enqueue, using the wait_function to wait if it's not possible
     ErrorOr<void> try_blocking_enqueue(ValueType to_insert, Function<void()> wait_function)
     {
@@ -141,6 +177,9 @@ public:
                 auto data = move(m_queue->m_queue->m_data[old_head % Size]);
                 m_queue->m_queue->m_head.fetch_add(1);
                 m_queue->m_queue->m_head_protector.store(NumericLimits<size_t>::max(), AK::MemoryOrder::memory_order_release);
+                m_queue->m_queue->m_dequeue_count.fetch_add(1);
+                if (m_queue->m_queue->m_producer_waiting.exchange(false))
+                    wake_producer();
                 return { move(data) };
             }
         }
@@ -153,6 +192,24 @@ public:
     }
 
 private:
+    void wait_for_dequeue(u32 dequeue_count)
+    {
+#ifdef AK_OS_SERENITY
+        // The queue lives in shared memory, so this has to be a process-shared futex.
+        futex_wait(const_cast<u32*>(m_queue->m_queue->m_dequeue_count.ptr()), dequeue_count, nullptr, 0, true);
+#else
+        (void)dequeue_count;
+        sched_yield();
+#endif
+    }
+
+    void wake_producer()
+    {
+#ifdef AK_OS_SERENITY
+        futex_wake(const_cast<u32*>(m_queue->m_queue->m_dequeue_count.ptr()), 1, true);
+#endif
+    }
+
     struct SharedMemorySPCQ {
         SharedMemorySPCQ() = default;
         SharedMemorySPCQ(SharedMemorySPCQ const&) = delete;
@@ -173,6 +230,11 @@ private:
         AK_CACHE_ALIGNED Atomic<size_t, AK::MemoryOrder::memory_order_seq_cst> m_head { 0 };
         AK_CACHE_ALIGNED Atomic<size_t, AK::MemoryOrder::memory_order_seq_cst> m_head_protector { NumericLimits<size_t>::max() };
 
+        // Incremented after every dequeue; blocking_enqueue() sleeps on this with a futex while m_producer_waiting is set.
+        AK_CACHE_ALIGNED Atomic<u32, AK::MemoryOrder::memory_order_seq_cst> m_dequeue_count { 0 };
+        Atomic<bool, AK::MemoryOrder::memory_order_seq_cst> m_producer_waiting { false };
+        Atomic<size_t, AK::MemoryOrder::memory_order_seq_cst> m_producer_limit { Size - 1 };
+
         alignas(ValueType) Array<ValueType, Size> m_data;
     };
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Optional.h>
+#include <LibCore/SmallAllocationPool.h>
+#include <stdlib.h>
+
+namespace Core {
+
+// Allocations are rounded up to a multiple of this, and pooled as long as they are no larger than the largest size class.
+static constexpr size_t size_class_granularity = 32;
+static constexpr size_t size_class_count = 32;
+static constexpr size_t max_pooled_allocations_per_size_class = 64;
+
+struct FreeAllocation {
+    FreeAllocation* next;
+};
+
+struct Pool {
+    FreeAllocation* first_free_allocation;
+    size_t free_allocation_count;
+};
+
+// NOTE: This has to stay trivially destructible, so what a thread has pooled is not freed when it exits.
+static thread_local Array<Pool, size_class_count> s_pools {};
+
+static Optional<size_t> size_class_for(size_t size)
+{
+    auto size_class = (size + size_class_granularity - 1) / size_class_granularity;
+    if (size_class == 0 || size_class > size_class_count)
+        return {};
+    return size_class - 1;
+}
+
+void* SmallAllocationPool::allocate(size_t size)
+{
+    auto size_class = size_class_for(size);
+    if (size_class.has_value()) {
+        auto& pool = s_pools[*size_class];
+        if (auto* allocation = pool.first_free_allocation) {
+            pool.first_free_allocation = allocation->next;
+            --pool.free_allocation_count;
+            return allocation;
+        }
+        size = (*size_class + 1) * size_class_granularity;
+    }
+
+    auto* allocation = malloc(size);
+    VERIFY(allocation);
+    return allocation;
+}
+
+void SmallAllocationPool::deallocate(void* allocation, size_t size)
+{
+    auto size_class = size_class_for(size);
+    if (size_class.has_value()) {
+        auto& pool = s_pools[*size_class];
+        if (pool.free_allocation_count < max_pooled_allocations_per_size_class) {
+            auto* free_allocation = static_cast<FreeAllocation*>(allocation);
+            free_allocation->next = pool.first_free_allocation;
+            pool.first_free_allocation = free_allocation;
+            ++pool.free_allocation_count;
+            return;
+        }
+    }
+    free(allocation);
+}
+
+}
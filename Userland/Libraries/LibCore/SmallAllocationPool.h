@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Core {
+
+// For small objects that come and go all the time, like events and coroutine frames. Freed allocations are kept
+// around per thread for the next allocation of about the same size, instead of going back to malloc each time.
+// Allocations may be freed on a different thread than the one they were made on.
+struct SmallAllocationPool {
+    static void* allocate(size_t);
+    static void deallocate(void*, size_t);
+};
+
+}
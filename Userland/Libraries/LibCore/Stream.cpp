@@ -7,6 +7,7 @@
 
 #include "Stream.h"
 #include <LibCore/System.h>
+#include <LibCore/TCPConnector.h>
 #include <fcntl.h>
 #include <netdb.h>
 #include <poll.h>
@@ -332,6 +333,12 @@ ErrorOr<int> Socket::create_fd(SocketDomain domain, SocketType type)
 }
 
 ErrorOr<IPv4Address> Socket::resolve_host(String const& host, SocketType type)
+{
+    auto addresses = TRY(resolve_host_addresses(host, type));
+    return addresses.first();
+}
+
+ErrorOr<Vector<IPv4Address>> Socket::resolve_host_addresses(String const& host, SocketType type)
 {
     int socket_type;
     switch (type) {
@@ -365,15 +372,20 @@ ErrorOr<IPv4Address> Socket::resolve_host(String const& host, SocketType type)
 
     ScopeGuard free_results = [results] { freeaddrinfo(results); };
 
+    Vector<IPv4Address> addresses;
     for (auto* result = results; result != nullptr; result = result->ai_next) {
         if (result->ai_family == AF_INET) {
             auto* socket_address = bit_cast<struct sockaddr_in*>(result->ai_addr);
             NetworkOrdered<u32> network_ordered_address { socket_address->sin_addr.s_addr };
-            return IPv4Address { network_ordered_address };
+            IPv4Address address { network_ordered_address };
+            if (!addresses.contains_slow(address))
+                TRY(addresses.try_append(address));
         }
     }
 
-    return Error::from_string_literal("Could not resolve to IPv4 address");
+    if (addresses.is_empty())
+        return Error::from_string_literal("Could not resolve to IPv4 address");
+    return addresses;
 }
 
 ErrorOr<void> Socket::connect_local(int fd, String const& path)
@@ -507,6 +519,11 @@ ErrorOr<NonnullOwnPtr<TCPSocket>> TCPSocket::connect(SocketAddress const& addres
     return socket;
 }
 
+ErrorOr<NonnullRefPtr<TCPConnector>> TCPSocket::connect_async(String const& host, u16 port, Function<void(ErrorOr<NonnullOwnPtr<TCPSocket>>)> callback)
+{
+    return TCPConnector::try_create(host, port, move(callback));
+}
+
 ErrorOr<NonnullOwnPtr<TCPSocket>> TCPSocket::adopt_fd(int fd)
 {
     if (fd < 0) {
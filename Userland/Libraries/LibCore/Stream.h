@@ -12,18 +12,26 @@
 #include <AK/IPv4Address.h>
 #include <AK/MemMem.h>
 #include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
 #include <AK/Result.h>
 #include <AK/Span.h>
 #include <AK/String.h>
 #include <AK/Time.h>
 #include <AK/Variant.h>
+#include <AK/Vector.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/SocketAddress.h>
 #include <errno.h>
 #include <netdb.h>
 
+namespace Core {
+class HostLookup;
+}
+
 namespace Core::Stream {
 
+class TCPConnector;
+
 /// The base, abstract class for stream operations. This class defines the
 /// operations one can perform on every stream in LibCore.
 class Stream {
@@ -132,6 +140,8 @@ public:
     Function<void()> on_ready_to_read;
 
 protected:
+    friend class Core::HostLookup;
+
     enum class SocketDomain {
         Local,
         Inet,
@@ -150,6 +160,7 @@ protected:
     // FIXME: This will need to be updated when IPv6 socket arrives. Perhaps a
     //        base class for all address types is appropriate.
     static ErrorOr<IPv4Address> resolve_host(String const&, SocketType);
+    static ErrorOr<Vector<IPv4Address>> resolve_host_addresses(String const&, SocketType);
 
     static ErrorOr<void> connect_local(int fd, String const& path);
     static ErrorOr<void> connect_inet(int fd, SocketAddress const&);
@@ -227,6 +238,8 @@ public:
     virtual ErrorOr<off_t> seek(i64 offset, SeekMode) override;
     virtual ErrorOr<void> truncate(off_t length) override;
 
+    int fd() const { return m_fd; }
+
     virtual ~File() override
     {
         if (m_should_close_file_descriptor == ShouldCloseFileDescriptor::Yes)
@@ -302,6 +315,11 @@ public:
     static ErrorOr<NonnullOwnPtr<TCPSocket>> connect(SocketAddress const& address);
     static ErrorOr<NonnullOwnPtr<TCPSocket>> adopt_fd(int fd);
 
+    /// Resolves the host and connects without blocking, racing its addresses
+    /// against each other (see TCPConnector). The callback is invoked from the
+    /// event loop, unless the returned connector is dropped or cancelled first.
+    static ErrorOr<NonnullRefPtr<TCPConnector>> connect_async(String const& host, u16 port, Function<void(ErrorOr<NonnullOwnPtr<TCPSocket>>)>);
+
     TCPSocket(TCPSocket&& other)
         : Socket(static_cast<Socket&&>(other))
         , m_helper(move(other.m_helper))
@@ -337,6 +355,13 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    Optional<int> fd() const
+    {
+        if (!is_open())
+            return {};
+        return m_helper.fd();
+    }
+
     virtual ~TCPSocket() override { close(); }
 
 private:
@@ -794,10 +819,18 @@ public:
     virtual void close() override { m_helper.stream().close(); }
     virtual ErrorOr<off_t> seek(i64 offset, SeekMode mode) override
     {
+        // The underlying stream is ahead of us by whatever we have buffered.
+        if (mode == SeekMode::FromCurrentPosition)
+            offset -= static_cast<i64>(m_helper.buffered_data_size());
         auto result = TRY(m_helper.stream().seek(offset, mode));
         m_helper.clear_buffer();
         return result;
     }
+    // Unlike seeking, this keeps the buffer intact, so it's cheap to ask for the position while reading.
+    virtual ErrorOr<off_t> tell() const override
+    {
+        return TRY(m_helper.stream().tell()) - static_cast<off_t>(m_helper.buffered_data_size());
+    }
     virtual ErrorOr<void> truncate(off_t length) override
     {
         return m_helper.stream().truncate(length);
@@ -880,6 +913,11 @@ public:
 
     virtual size_t buffer_size() const override { return m_helper.buffer_size(); }
 
+    Optional<int> fd() const requires(requires(T const& stream) { stream.fd(); }) { return m_helper.stream().fd(); }
+
+    T& underlying_stream() { return m_helper.stream(); }
+    T const& underlying_stream() const { return m_helper.stream(); }
+
     virtual ~BufferedSocket() override = default;
 
 private:
@@ -29,6 +29,7 @@
 #    include <LibCore/Account.h>
 #    include <LibSystem/syscall.h>
 #    include <serenity.h>
+#    include <sys/sendfile.h>
 #endif
 
 #if defined(AK_OS_LINUX) && !defined(MFD_CLOEXEC)
@@ -132,6 +133,14 @@ ErrorOr<int> recvfd(int sockfd, int options)
     return fd;
 }
 
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    auto rc = ::sendfile(out_fd, in_fd, offset, count);
+    if (rc < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return rc;
+}
+
 ErrorOr<void> ptrace_peekbuf(pid_t tid, void const* tracee_addr, Bytes destination_buf)
 {
     Syscall::SC_ptrace_buf_params buf_params {
@@ -389,6 +398,21 @@ ErrorOr<void> ftruncate(int fd, off_t length)
     return {};
 }
 
+ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
+{
+#ifdef AK_OS_MACOS
+    (void)fd;
+    (void)offset;
+    (void)length;
+    return Error::from_errno(ENOTSUP);
+#else
+    // NOTE: posix_fallocate() returns the error instead of setting errno.
+    if (int rc = ::posix_fallocate(fd, offset, length); rc != 0)
+        return Error::from_syscall("posix_fallocate"sv, -rc);
+    return {};
+#endif
+}
+
 ErrorOr<struct stat> stat(StringView path)
 {
     if (!path.characters_without_null_termination())
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCore/System.h>
+#include <LibCore/TCPConnector.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+
+namespace Core::Stream {
+
+TCPConnector::TCPConnector(String host, u16 port, Callback callback)
+    : m_host(move(host))
+    , m_port(port)
+    , m_callback(move(callback))
+{
+    start();
+}
+
+TCPConnector::~TCPConnector()
+{
+    close_all_attempts();
+}
+
+void TCPConnector::cancel()
+{
+    m_callback = nullptr;
+    if (m_lookup) {
+        m_lookup->cancel();
+        m_lookup = nullptr;
+    }
+    close_all_attempts();
+    if (m_attempt_delay_timer)
+        m_attempt_delay_timer->stop();
+    if (m_timeout_timer)
+        m_timeout_timer->stop();
+}
+
+void TCPConnector::start()
+{
+    m_timeout_timer = Timer::create_single_shot(timeout_milliseconds, [this] {
+        finish(Error::from_errno(ETIMEDOUT));
+    });
+    m_timeout_timer->start();
+
+    // This never calls back right away, so whoever made us gets to hold on to us first.
+    m_lookup = HostLookup::construct(m_host, [this](auto addresses_or_error) {
+        did_resolve(move(addresses_or_error));
+    });
+}
+
+void TCPConnector::did_resolve(ErrorOr<Vector<IPv4Address>> addresses_or_error)
+{
+    m_lookup = nullptr;
+
+    if (addresses_or_error.is_error()) {
+        finish(addresses_or_error.release_error());
+        return;
+    }
+    m_addresses = addresses_or_error.release_value();
+    dbgln_if(CSOCKET_DEBUG, "TCPConnector: {} resolved to {} addresses", m_host, m_addresses.size());
+
+    m_attempt_delay_timer = Timer::create_single_shot(connection_attempt_delay_milliseconds, [this] {
+        start_next_attempt();
+    });
+    start_next_attempt();
+}
+
+void TCPConnector::start_next_attempt()
+{
+    while (m_next_address_index < m_addresses.size()) {
+        auto address = m_addresses[m_next_address_index++];
+        auto result = start_attempt(address);
+        if (!result.is_error()) {
+            // Give this one a head start before racing the next address against it.
+            if (m_next_address_index < m_addresses.size())
+                m_attempt_delay_timer->restart();
+            return;
+        }
+        dbgln_if(CSOCKET_DEBUG, "TCPConnector: Connecting to {}:{} failed right away: {}", address, m_port, result.error());
+        m_last_error = result.release_error();
+    }
+
+    if (m_attempts.is_empty())
+        finish(m_last_error.value_or(Error::from_errno(ECONNREFUSED)));
+}
+
+ErrorOr<void> TCPConnector::start_attempt(IPv4Address address)
+{
+    dbgln_if(CSOCKET_DEBUG, "TCPConnector: Trying {}:{} for {}", address, m_port, m_host);
+    auto fd = TRY(System::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+
+    auto socket_address = SocketAddress { address, m_port }.to_sockaddr_in();
+    if (auto result = System::connect(fd, bit_cast<struct sockaddr*>(&socket_address), sizeof(socket_address)); result.is_error()) {
+        if (!result.error().is_errno() || result.error().code() != EINPROGRESS) {
+            (void)System::close(fd);
+            return result.release_error();
+        }
+    }
+
+    auto notifier = Notifier::construct(fd, Notifier::Event::Write);
+    notifier->on_ready_to_write = [this, fd] {
+        did_finish_attempt(fd);
+    };
+    m_attempts.append({ address, fd, move(notifier) });
+    return {};
+}
+
+void TCPConnector::did_finish_attempt(int fd)
+{
+    auto it = m_attempts.find_if([&](auto& attempt) { return attempt.fd == fd; });
+    VERIFY(!it.is_end());
+    auto attempt = m_attempts.take(it.index());
+    attempt.notifier->set_enabled(false);
+
+    int error = 0;
+    socklen_t error_size = sizeof(error);
+    if (auto result = System::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_size); result.is_error())
+        error = result.error().code();
+    if (error != 0) {
+        dbgln_if(CSOCKET_DEBUG, "TCPConnector: Connecting to {}:{} failed: {}", attempt.address, m_port, strerror(error));
+        (void)System::close(fd);
+        did_fail_attempt(Error::from_errno(error));
+        return;
+    }
+
+    dbgln_if(CSOCKET_DEBUG, "TCPConnector: Connected to {}:{} for {}", attempt.address, m_port, m_host);
+    auto socket_or_error = [&]() -> ErrorOr<NonnullOwnPtr<TCPSocket>> {
+        // Sockets from TCPSocket::connect() start out blocking, so ours shouldn't be any different.
+        auto flags = TRY(System::fcntl(fd, F_GETFL));
+        TRY(System::fcntl(fd, F_SETFL, flags & ~O_NONBLOCK));
+        return TCPSocket::adopt_fd(fd);
+    }();
+    if (socket_or_error.is_error())
+        (void)System::close(fd);
+    finish(move(socket_or_error));
+}
+
+void TCPConnector::did_fail_attempt(Error error)
+{
+    m_last_error = move(error);
+    // No need to wait for the attempt delay, the next address might as well go right away.
+    if (m_next_address_index < m_addresses.size()) {
+        m_attempt_delay_timer->stop();
+        start_next_attempt();
+        return;
+    }
+    if (m_attempts.is_empty())
+        finish(m_last_error.release_value());
+}
+
+void TCPConnector::finish(ErrorOr<NonnullOwnPtr<TCPSocket>> result)
+{
+    // Whoever we call back might well let go of us.
+    NonnullRefPtr protector { *this };
+    auto callback = move(m_callback);
+    cancel();
+    if (callback)
+        callback(move(result));
+}
+
+void TCPConnector::close_all_attempts()
+{
+    for (auto& attempt : m_attempts) {
+        attempt.notifier->set_enabled(false);
+        (void)System::close(attempt.fd);
+    }
+    m_attempts.clear();
+}
+
+}
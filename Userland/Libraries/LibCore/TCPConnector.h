@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/IPv4Address.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <LibCore/HostLookup.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/Object.h>
+#include <LibCore/Stream.h>
+#include <LibCore/Timer.h>
+
+namespace Core::Stream {
+
+// Connects a TCPSocket without ever blocking the event loop.
+// The host is looked up through LookupServer (see HostLookup), and the addresses it resolves to are raced against each other:
+// the next one is tried whenever the previous attempt hasn't connected within the attempt delay, and whichever
+// connects first wins (Happy Eyeballs, RFC 8305). Dropping the last reference to the connector gives up on it.
+class TCPConnector final : public Object {
+    C_OBJECT(TCPConnector)
+
+public:
+    using Callback = Function<void(ErrorOr<NonnullOwnPtr<TCPSocket>>)>;
+
+    // The "Connection Attempt Delay" recommended by RFC 8305, section 5.
+    static constexpr int connection_attempt_delay_milliseconds = 250;
+    static constexpr int timeout_milliseconds = 30'000;
+
+    virtual ~TCPConnector() override;
+
+    String const& host() const { return m_host; }
+    u16 port() const { return m_port; }
+
+    // Stops all attempts that are still going on. The callback is not invoked after this.
+    void cancel();
+
+private:
+    TCPConnector(String host, u16 port, Callback);
+
+    struct Attempt {
+        IPv4Address address;
+        int fd { -1 };
+        RefPtr<Notifier> notifier;
+    };
+
+    void start();
+    void did_resolve(ErrorOr<Vector<IPv4Address>>);
+
+    void start_next_attempt();
+    ErrorOr<void> start_attempt(IPv4Address);
+    void did_finish_attempt(int fd);
+    void did_fail_attempt(Error);
+
+    void finish(ErrorOr<NonnullOwnPtr<TCPSocket>>);
+    void close_all_attempts();
+
+    String m_host;
+    u16 m_port { 0 };
+    Callback m_callback;
+
+    RefPtr<HostLookup> m_lookup;
+
+    Vector<IPv4Address> m_addresses;
+    size_t m_next_address_index { 0 };
+    Vector<Attempt> m_attempts;
+    Optional<Error> m_last_error;
+
+    RefPtr<Timer> m_attempt_delay_timer;
+    RefPtr<Timer> m_timeout_timer;
+};
+
+}
@@ -26,6 +26,7 @@ public:
     };
 
     bool is_listening() const { return m_listening; }
+    int fd() const { return m_fd; }
     ErrorOr<void> listen(IPv4Address const& address, u16 port, AllowAddressReuse = AllowAddressReuse::No);
     ErrorOr<void> set_blocking(bool blocking);
 
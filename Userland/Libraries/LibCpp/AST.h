@@ -54,6 +54,15 @@ public:
     void set_end(Position const& end) { m_end = end; }
     void set_parent(ASTNode& parent) { m_parent = &parent; }
 
+    // Used when the node is carried over to a new version of its document, in which it has moved up or down.
+    void move_by_lines(ssize_t line_delta)
+    {
+        if (m_start.has_value())
+            m_start->line += line_delta;
+        if (m_end.has_value())
+            m_end->line += line_delta;
+    }
+
     virtual NonnullRefPtrVector<Declaration> declarations() const { return {}; }
 
     virtual bool is_identifier() const { return false; }
@@ -7,6 +7,7 @@
 #include "Parser.h"
 #include "AST.h"
 #include <AK/Debug.h>
+#include <AK/HashTable.h>
 #include <AK/ScopeGuard.h>
 #include <AK/ScopeLogger.h>
 #include <LibCpp/Lexer.h>
@@ -37,13 +38,132 @@ NonnullRefPtr<TranslationUnit> Parser::parse()
     return unit;
 }
 
-NonnullRefPtrVector<Declaration> Parser::parse_declarations_in_translation_unit(ASTNode& parent)
+static bool tokens_have_same_contents(Token const& a, Token const& b)
 {
+    return a.type() == b.type() && a.text() == b.text();
+}
+
+NonnullRefPtr<TranslationUnit> Parser::reparse(Parser& previous)
+{
+    LOG_SCOPE();
+    auto const& old_tokens = previous.m_tokens;
+    if (m_tokens.is_empty() || old_tokens.is_empty() || !previous.m_root_node)
+        return parse();
+
+    // Find where the two versions of the document start to differ, and where they become the same again.
+    // Everything in front of the edit has to be exactly where it was, everything behind it may only have moved by whole lines.
+    auto max_common_tokens = min(m_tokens.size(), old_tokens.size());
+    size_t common_prefix = 0;
+    while (common_prefix < max_common_tokens) {
+        auto const& old_token = old_tokens[common_prefix];
+        auto const& new_token = m_tokens[common_prefix];
+        if (!tokens_have_same_contents(old_token, new_token) || !(old_token.start() == new_token.start()) || !(old_token.end() == new_token.end()))
+            break;
+        ++common_prefix;
+    }
+
+    size_t common_suffix = 0;
+    ssize_t line_delta = 0;
+    while (common_prefix + common_suffix < max_common_tokens) {
+        auto const& old_token = old_tokens[old_tokens.size() - common_suffix - 1];
+        auto const& new_token = m_tokens[m_tokens.size() - common_suffix - 1];
+        if (!tokens_have_same_contents(old_token, new_token) || old_token.start().column != new_token.start().column || old_token.end().column != new_token.end().column)
+            break;
+        auto start_delta = static_cast<ssize_t>(new_token.start().line) - static_cast<ssize_t>(old_token.start().line);
+        auto end_delta = static_cast<ssize_t>(new_token.end().line) - static_cast<ssize_t>(old_token.end().line);
+        if (start_delta != end_delta || (common_suffix > 0 && start_delta != line_delta))
+            break;
+        line_delta = start_delta;
+        ++common_suffix;
+    }
+    auto first_edited_old_token = common_prefix;
+    auto first_old_token_after_edit = old_tokens.size() - common_suffix;
+
+    // A declaration is only reused if it doesn't touch the edit, and isn't right next to it either, since the parser
+    // looks ahead past the end of a declaration to decide what it's looking at.
+    auto const* old_root = previous.m_root_node.ptr();
+    auto old_declarations = old_root->declarations();
+    auto const& old_ranges = previous.m_top_level_declaration_tokens;
+    VERIFY(old_ranges.size() == old_declarations.size());
+
+    size_t prefix_declarations = 0;
+    while (prefix_declarations < old_ranges.size() && old_ranges[prefix_declarations].end <= first_edited_old_token)
+        ++prefix_declarations;
+    if (prefix_declarations > 0)
+        --prefix_declarations;
+
+    size_t first_suffix_declaration = old_ranges.size();
+    while (first_suffix_declaration > prefix_declarations && old_ranges[first_suffix_declaration - 1].start >= first_old_token_after_edit)
+        --first_suffix_declaration;
+    if (first_suffix_declaration < old_ranges.size())
+        ++first_suffix_declaration;
+
+    auto to_new_token_index = [&](size_t old_index) { return old_index + m_tokens.size() - old_tokens.size(); };
+    size_t resume_token_index = prefix_declarations > 0 ? old_ranges[prefix_declarations - 1].end : 0;
+    size_t stop_token_index = first_suffix_declaration < old_ranges.size() ? to_new_token_index(old_ranges[first_suffix_declaration].start) : m_tokens.size();
+
+    HashTable<ASTNode const*> prefix_declaration_nodes;
+    HashTable<ASTNode const*> suffix_declaration_nodes;
+    for (size_t i = 0; i < prefix_declarations; ++i)
+        prefix_declaration_nodes.set(&old_declarations[i]);
+    for (size_t i = first_suffix_declaration; i < old_declarations.size(); ++i)
+        suffix_declaration_nodes.set(&old_declarations[i]);
+
+    // This has to happen before the declarations get their new parent, since we find the declaration a node belongs to by walking up.
+    NonnullRefPtrVector<ASTNode> prefix_nodes;
+    NonnullRefPtrVector<ASTNode> suffix_nodes;
+    for (auto& node : previous.m_nodes) {
+        ASTNode const* top_level_node = &node;
+        while (top_level_node->parent() && top_level_node->parent() != old_root)
+            top_level_node = top_level_node->parent();
+        if (top_level_node->parent() != old_root)
+            continue;
+        if (prefix_declaration_nodes.contains(top_level_node))
+            prefix_nodes.append(node);
+        else if (suffix_declaration_nodes.contains(top_level_node))
+            suffix_nodes.append(node);
+    }
+
+    auto unit = create_root_ast_node(m_tokens.first().start(), m_tokens.last().end());
     NonnullRefPtrVector<Declaration> declarations;
-    while (!eof()) {
+    for (size_t i = 0; i < prefix_declarations; ++i) {
+        old_declarations[i].set_parent(*unit);
+        declarations.append(old_declarations[i]);
+        m_top_level_declaration_tokens.append(old_ranges[i]);
+    }
+    m_nodes.extend(move(prefix_nodes));
+
+    m_state.token_index = resume_token_index;
+    declarations.extend(parse_declarations_in_translation_unit(*unit, stop_token_index));
+
+    if (m_state.token_index == stop_token_index && first_suffix_declaration < old_declarations.size()) {
+        for (size_t i = first_suffix_declaration; i < old_declarations.size(); ++i) {
+            old_declarations[i].set_parent(*unit);
+            declarations.append(old_declarations[i]);
+            m_top_level_declaration_tokens.append({ to_new_token_index(old_ranges[i].start), to_new_token_index(old_ranges[i].end) });
+        }
+        for (auto& node : suffix_nodes)
+            node.move_by_lines(line_delta);
+        m_nodes.extend(move(suffix_nodes));
+    } else {
+        // The edited part went on into the declarations behind it, so they have to be parsed again.
+        declarations.extend(parse_declarations_in_translation_unit(*unit));
+    }
+
+    dbgln_if(CPP_DEBUG, "Reparsed tokens {}-{} of {}, reused {} of {} declarations", resume_token_index, stop_token_index, m_tokens.size(), prefix_declaration_nodes.size() + suffix_declaration_nodes.size(), old_declarations.size());
+    unit->set_declarations(move(declarations));
+    return unit;
+}
+
+NonnullRefPtrVector<Declaration> Parser::parse_declarations_in_translation_unit(ASTNode& parent, size_t end_token_index)
+{
+    NonnullRefPtrVector<Declaration> declarations;
+    while (!eof() && m_state.token_index < end_token_index) {
+        auto start_token_index = m_state.token_index;
         auto declaration = parse_single_declaration_in_translation_unit(parent);
         if (declaration) {
             declarations.append(declaration.release_nonnull());
+            m_top_level_declaration_tokens.append({ start_token_index, m_state.token_index });
         } else {
             error("unexpected token"sv);
             consume();
@@ -8,6 +8,7 @@
 
 #include <AK/Noncopyable.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/NumericLimits.h>
 #include <LibCodeComprehension/Types.h>
 #include <LibCpp/AST.h>
 #include <LibCpp/Lexer.h>
@@ -23,6 +24,12 @@ public:
     ~Parser() = default;
 
     NonnullRefPtr<TranslationUnit> parse();
+
+    // Parses the tokens like parse() does, but takes the top-level declarations that weren't touched by the edit
+    // from the previous parse of the same document instead of parsing them again.
+    // NOTE: The nodes that are carried over still point into the text of the previous version, which has to be kept alive.
+    //       The previous parser shouldn't be used afterwards, since its nodes now belong to this one.
+    NonnullRefPtr<TranslationUnit> reparse(Parser& previous);
     bool eof() const;
 
     RefPtr<ASTNode> node_at(Position) const;
@@ -110,7 +117,7 @@ private:
     NonnullRefPtr<Comment> parse_comment(ASTNode& parent);
     NonnullRefPtr<IfStatement> parse_if_statement(ASTNode& parent);
     NonnullRefPtr<NamespaceDeclaration> parse_namespace_declaration(ASTNode& parent, bool is_nested_namespace = false);
-    NonnullRefPtrVector<Declaration> parse_declarations_in_translation_unit(ASTNode& parent);
+    NonnullRefPtrVector<Declaration> parse_declarations_in_translation_unit(ASTNode& parent, size_t end_token_index = NumericLimits<size_t>::max());
     RefPtr<Declaration> parse_single_declaration_in_translation_unit(ASTNode& parent);
     NonnullRefPtrVector<Type> parse_template_arguments(ASTNode& parent);
     NonnullRefPtr<Name> parse_name(ASTNode& parent);
@@ -192,6 +199,13 @@ private:
     RefPtr<TranslationUnit> m_root_node;
     Vector<String> m_errors;
     NonnullRefPtrVector<ASTNode> m_nodes;
+
+    // The tokens that each of the top-level declarations was parsed from, including the comments in front of it.
+    struct TokenRange {
+        size_t start { 0 };
+        size_t end { 0 };
+    };
+    Vector<TokenRange> m_top_level_declaration_tokens;
 };
 
 }
@@ -10,6 +10,10 @@
 #include <AK/Types.h>
 #include <LibCrypto/Authentication/GHash.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#endif
+
 namespace {
 
 static u32 to_u32(u8 const* b)
@@ -24,13 +28,135 @@ static void to_u8s(u8* b, u32 const* w)
     }
 }
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define PCLMUL_SUPPORTED
+
+using v2di = long long __attribute__((vector_size(16)));
+
+static bool cpu_supports_pclmul()
+{
+    static bool const s_supported = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ecx & bit_PCLMUL) != 0;
+    }();
+    return s_supported;
+}
+
+// A block as a 128-bit number, with its first byte being the most significant one. GCM numbers the bits the other way
+// around, so the most significant bit is the coefficient of x^0.
+struct FieldElement {
+    u64 high { 0 };
+    u64 low { 0 };
+
+    static FieldElement load(u8 const* bytes)
+    {
+        return { AK::convert_between_host_and_big_endian(ByteReader::load64(bytes)), AK::convert_between_host_and_big_endian(ByteReader::load64(bytes + 8)) };
+    }
+
+    FieldElement operator^(FieldElement const& other) const { return { high ^ other.high, low ^ other.low }; }
+};
+
+// The 256-bit carry-less product of two field elements, most significant word first. Products can be XORed together
+// before reducing them, which saves most of the work when several blocks are multiplied at once.
+struct UnreducedProduct {
+    u64 words[4] {};
+
+    UnreducedProduct operator^(UnreducedProduct const& other) const
+    {
+        return { { words[0] ^ other.words[0], words[1] ^ other.words[1], words[2] ^ other.words[2], words[3] ^ other.words[3] } };
+    }
+};
+
+[[gnu::target("pclmul")]] static UnreducedProduct carryless_multiply(FieldElement a, FieldElement b)
+{
+    v2di x { static_cast<long long>(a.low), static_cast<long long>(a.high) };
+    v2di y { static_cast<long long>(b.low), static_cast<long long>(b.high) };
+    v2di low = __builtin_ia32_pclmulqdq128(x, y, 0x00);
+    v2di high = __builtin_ia32_pclmulqdq128(x, y, 0x11);
+    v2di middle = __builtin_ia32_pclmulqdq128(x, y, 0x01) ^ __builtin_ia32_pclmulqdq128(x, y, 0x10);
+    return { {
+        static_cast<u64>(high[1]),
+        static_cast<u64>(high[0] ^ middle[1]),
+        static_cast<u64>(low[1] ^ middle[0]),
+        static_cast<u64>(low[0]),
+    } };
+}
+
+// Reduces a product modulo x^128 + x^7 + x^2 + x + 1, following Intel's "Carry-Less Multiplication Instruction and its
+// Usage for Computing the GCM Mode", algorithm 5. Since the bits are reflected, the product is one bit short of where
+// it should be and first has to be shifted left.
+static FieldElement reduce(UnreducedProduct const& product)
+{
+    u64 x3 = product.words[0] << 1 | product.words[1] >> 63;
+    u64 x2 = product.words[1] << 1 | product.words[2] >> 63;
+    u64 x1 = product.words[2] << 1 | product.words[3] >> 63;
+    u64 x0 = product.words[3] << 1;
+
+    u64 d = x1 ^ (x0 << 63) ^ (x0 << 62) ^ (x0 << 57);
+    u64 h1 = d ^ (d >> 1) ^ (d >> 2) ^ (d >> 7);
+    u64 h0 = x0 ^ (x0 >> 1 | d << 63) ^ (x0 >> 2 | d << 62) ^ (x0 >> 7 | d << 57);
+    return { x3 ^ h1, x2 ^ h0 };
+}
+
+static FieldElement multiply(FieldElement a, FieldElement b)
+{
+    return reduce(carryless_multiply(a, b));
+}
+#endif
+
 }
 
 namespace Crypto {
 namespace Authentication {
 
+#ifdef PCLMUL_SUPPORTED
+static GHash::TagType process_with_pclmul(u32 const (&key)[4], ReadonlyBytes aad, ReadonlyBytes cipher)
+{
+    FieldElement h1 { static_cast<u64>(key[0]) << 32 | key[1], static_cast<u64>(key[2]) << 32 | key[3] };
+    auto h2 = multiply(h1, h1);
+    auto h3 = multiply(h2, h1);
+    auto h4 = multiply(h3, h1);
+
+    FieldElement tag;
+    auto transform = [&](ReadonlyBytes data) {
+        size_t offset = 0;
+        // Four blocks at a time, as ((tag ^ X1) * H^4) ^ (X2 * H^3) ^ (X3 * H^2) ^ (X4 * H) with a single reduction.
+        for (; offset + 64 <= data.size(); offset += 64) {
+            auto product = carryless_multiply(tag ^ FieldElement::load(data.offset(offset)), h4)
+                ^ carryless_multiply(FieldElement::load(data.offset(offset + 16)), h3)
+                ^ carryless_multiply(FieldElement::load(data.offset(offset + 32)), h2)
+                ^ carryless_multiply(FieldElement::load(data.offset(offset + 48)), h1);
+            tag = reduce(product);
+        }
+        for (; offset + 16 <= data.size(); offset += 16)
+            tag = multiply(tag ^ FieldElement::load(data.offset(offset)), h1);
+        if (offset < data.size()) {
+            u8 last_block[16] {};
+            data.slice(offset).copy_to({ last_block, sizeof(last_block) });
+            tag = multiply(tag ^ FieldElement::load(last_block), h1);
+        }
+    };
+
+    transform(aad);
+    transform(cipher);
+    tag = multiply(tag ^ FieldElement { 8 * static_cast<u64>(aad.size()), 8 * static_cast<u64>(cipher.size()) }, h1);
+
+    GHash::TagType digest;
+    ByteReader::store(digest.data, AK::convert_between_host_and_big_endian(tag.high));
+    ByteReader::store(digest.data + 8, AK::convert_between_host_and_big_endian(tag.low));
+    return digest;
+}
+#endif
+
 GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
 {
+#ifdef PCLMUL_SUPPORTED
+    if (cpu_supports_pclmul())
+        return process_with_pclmul(m_key, aad, cipher);
+#endif
+
     u32 tag[4] { 0, 0, 0, 0 };
 
     auto transform_one = [&](auto& buf) {
@@ -10,209 +10,271 @@
 
 namespace Crypto::Authentication {
 
-Poly1305::Poly1305(ReadonlyBytes key)
+static u32 load_le32(u8 const* address)
 {
-    for (size_t i = 0; i < 16; i += 4) {
-        m_state.r[i / 4] = AK::convert_between_host_and_little_endian(ByteReader::load32(key.offset(i)));
-    }
+    return AK::convert_between_host_and_little_endian(ByteReader::load32(address));
+}
+
+#ifdef __SIZEOF_INT128__
+using u128 = unsigned __int128;
+
+static constexpr u64 limb_mask_44 = 0xFFFFFFFFFFF;
+static constexpr u64 limb_mask_42 = 0x3FFFFFFFFFF;
+
+static u64 load_le64(u8 const* address)
+{
+    return AK::convert_between_host_and_little_endian(ByteReader::load64(address));
+}
+#else
+static constexpr u32 limb_mask_26 = 0x3FFFFFF;
+#endif
 
+Poly1305::Poly1305(ReadonlyBytes key)
+{
     // r[3], r[7], r[11], and r[15] are required to have their top four bits clear (be smaller than 16)
     // r[4], r[8], and r[12] are required to have their bottom two bits clear (be divisible by 4)
-    m_state.r[0] &= 0x0FFFFFFF;
-    m_state.r[1] &= 0x0FFFFFFC;
-    m_state.r[2] &= 0x0FFFFFFC;
-    m_state.r[3] &= 0x0FFFFFFC;
+    // The masks below do that while splitting r into limbs.
+#ifdef __SIZEOF_INT128__
+    u64 t0 = load_le64(key.offset(0));
+    u64 t1 = load_le64(key.offset(8));
+    m_state.r[0] = t0 & 0xFFC0FFFFFFF;
+    m_state.r[1] = ((t0 >> 44) | (t1 << 20)) & 0xFFFFFC0FFFF;
+    m_state.r[2] = (t1 >> 24) & 0x00FFFFFFC0F;
+#else
+    m_state.r[0] = load_le32(key.offset(0)) & 0x3FFFFFF;
+    m_state.r[1] = (load_le32(key.offset(3)) >> 2) & 0x3FFFF03;
+    m_state.r[2] = (load_le32(key.offset(6)) >> 4) & 0x3FFC0FF;
+    m_state.r[3] = (load_le32(key.offset(9)) >> 6) & 0x3F03FFF;
+    m_state.r[4] = (load_le32(key.offset(12)) >> 8) & 0x00FFFFF;
+#endif
 
     for (size_t i = 16; i < 32; i += 4) {
-        m_state.s[(i - 16) / 4] = AK::convert_between_host_and_little_endian(ByteReader::load32(key.offset(i)));
+        m_state.s[(i - 16) / 4] = load_le32(key.offset(i));
     }
 }
 
 void Poly1305::update(ReadonlyBytes message)
 {
     size_t offset = 0;
-    while (offset < message.size()) {
-        u32 n = min(message.size() - offset, 16 - m_state.block_count);
-        memcpy(m_state.blocks + m_state.block_count, message.offset_pointer(offset), n);
+
+    // Top up a partial block from an earlier update first.
+    if (m_state.block_count != 0) {
+        size_t n = min(message.size(), BlockSize - m_state.block_count);
+        memcpy(m_state.blocks + m_state.block_count, message.data(), n);
         m_state.block_count += n;
         offset += n;
 
-        if (m_state.block_count == 16) {
-            process_block();
-            m_state.block_count = 0;
-        }
-    }
-}
+        if (m_state.block_count < BlockSize)
+            return;
 
-void Poly1305::process_block()
-{
-    u32 a[5];
-    u8 n = m_state.block_count;
-
-    // Add one bit beyond the number of octets.  For a 16-byte block,
-    // this is equivalent to adding 2^128 to the number.  For the shorter
-    // block, it can be 2^120, 2^112, or any power of two that is evenly
-    // divisible by 8, all the way down to 2^8.
-    m_state.blocks[n++] = 0x01;
-
-    // If the block is not 17 bytes long (the last block), pad it with zeros.
-    // This is meaningless if you are treating the blocks as numbers.
-    while (n < 17) {
-        m_state.blocks[n++] = 0x00;
+        process_block(m_state.blocks);
+        m_state.block_count = 0;
     }
 
-    // Read the block as a little-endian number.
-    for (size_t i = 0; i < 16; i += 4) {
-        a[i / 4] = AK::convert_between_host_and_little_endian(ByteReader::load32(m_state.blocks + i));
-    }
-    a[4] = m_state.blocks[16];
+    // Whole blocks can be read straight from the message.
+    for (; message.size() - offset >= BlockSize; offset += BlockSize)
+        process_block(message.offset_pointer(offset));
 
-    // Add this number to the accumulator.
-    m_state.a[0] += a[0];
-    m_state.a[1] += a[1];
-    m_state.a[2] += a[2];
-    m_state.a[3] += a[3];
-    m_state.a[4] += a[4];
+    memcpy(m_state.blocks, message.offset_pointer(offset), message.size() - offset);
+    m_state.block_count = message.size() - offset;
+}
 
-    // Carry
-    m_state.a[1] += m_state.a[0] >> 32;
-    m_state.a[2] += m_state.a[1] >> 32;
-    m_state.a[3] += m_state.a[2] >> 32;
-    m_state.a[4] += m_state.a[3] >> 32;
-
-    // Only consider the least significant bits
-    a[0] = m_state.a[0] & 0xFFFFFFFF;
-    a[1] = m_state.a[1] & 0xFFFFFFFF;
-    a[2] = m_state.a[2] & 0xFFFFFFFF;
-    a[3] = m_state.a[3] & 0xFFFFFFFF;
-    a[4] = m_state.a[4] & 0xFFFFFFFF;
-
-    // Multiply by r
-    m_state.a[0] = (u64)a[0] * m_state.r[0];
-    m_state.a[1] = (u64)a[0] * m_state.r[1] + (u64)a[1] * m_state.r[0];
-    m_state.a[2] = (u64)a[0] * m_state.r[2] + (u64)a[1] * m_state.r[1] + (u64)a[2] * m_state.r[0];
-    m_state.a[3] = (u64)a[0] * m_state.r[3] + (u64)a[1] * m_state.r[2] + (u64)a[2] * m_state.r[1] + (u64)a[3] * m_state.r[0];
-    m_state.a[4] = (u64)a[1] * m_state.r[3] + (u64)a[2] * m_state.r[2] + (u64)a[3] * m_state.r[1] + (u64)a[4] * m_state.r[0];
-    m_state.a[5] = (u64)a[2] * m_state.r[3] + (u64)a[3] * m_state.r[2] + (u64)a[4] * m_state.r[1];
-    m_state.a[6] = (u64)a[3] * m_state.r[3] + (u64)a[4] * m_state.r[2];
-    m_state.a[7] = (u64)a[4] * m_state.r[3];
+// Computes a = ((a + block) * r) % (2^130 - 5), only partially reducing the result.
+void Poly1305::process_block(u8 const* block, bool is_final_block)
+{
+    // Add one bit beyond the number of octets. For a 16-byte block, this is equivalent to adding 2^128 to the number.
+    // The last block has that bit appended to its bytes already, and is padded with zeros.
+    auto& r = m_state.r;
+    auto& a = m_state.a;
 
-    // Carry
-    m_state.a[1] += m_state.a[0] >> 32;
-    m_state.a[2] += m_state.a[1] >> 32;
-    m_state.a[3] += m_state.a[2] >> 32;
-    m_state.a[4] += m_state.a[3] >> 32;
-    m_state.a[5] += m_state.a[4] >> 32;
-    m_state.a[6] += m_state.a[5] >> 32;
-    m_state.a[7] += m_state.a[6] >> 32;
-
-    // Save the high part of the accumulator
-    a[0] = m_state.a[4] & 0xFFFFFFFC;
-    a[1] = m_state.a[5] & 0xFFFFFFFF;
-    a[2] = m_state.a[6] & 0xFFFFFFFF;
-    a[3] = m_state.a[7] & 0xFFFFFFFF;
-
-    // Only consider the least significant bits
-    m_state.a[0] &= 0xFFFFFFFF;
-    m_state.a[1] &= 0xFFFFFFFF;
-    m_state.a[2] &= 0xFFFFFFFF;
-    m_state.a[3] &= 0xFFFFFFFF;
-    m_state.a[4] &= 0x00000003;
-
-    // Fast modular reduction (first pass)
-    m_state.a[0] += a[0];
-    m_state.a[0] += (a[0] >> 2) | (a[1] << 30);
-    m_state.a[1] += a[1];
-    m_state.a[1] += (a[1] >> 2) | (a[2] << 30);
-    m_state.a[2] += a[2];
-    m_state.a[2] += (a[2] >> 2) | (a[3] << 30);
-    m_state.a[3] += a[3];
-    m_state.a[3] += (a[3] >> 2);
+#ifdef __SIZEOF_INT128__
+    u64 high_bit = is_final_block ? 0 : (1ull << 40);
 
-    // Carry
-    m_state.a[1] += m_state.a[0] >> 32;
-    m_state.a[2] += m_state.a[1] >> 32;
-    m_state.a[3] += m_state.a[2] >> 32;
-    m_state.a[4] += m_state.a[3] >> 32;
+    u64 t0 = load_le64(block);
+    u64 t1 = load_le64(block + 8);
+    a[0] += t0 & limb_mask_44;
+    a[1] += ((t0 >> 44) | (t1 << 20)) & limb_mask_44;
+    a[2] += ((t1 >> 24) & limb_mask_42) | high_bit;
 
-    // Save the high part of the accumulator
-    a[0] = m_state.a[4] & 0xFFFFFFFC;
+    // Since 2^130 = 5 (mod 2^130 - 5), the parts of the product that reach past 2^130 wrap around multiplied by 5,
+    // the extra factor of 4 accounts for the two bits that r[1] * a[2] and r[2] * a[1] reach past the top limb.
+    u64 s1 = r[1] * (5 << 2);
+    u64 s2 = r[2] * (5 << 2);
 
-    // Only consider the least significant bits
-    m_state.a[0] &= 0xFFFFFFFF;
-    m_state.a[1] &= 0xFFFFFFFF;
-    m_state.a[2] &= 0xFFFFFFFF;
-    m_state.a[3] &= 0xFFFFFFFF;
-    m_state.a[4] &= 0x00000003;
+    u128 d0 = (u128)a[0] * r[0] + (u128)a[1] * s2 + (u128)a[2] * s1;
+    u128 d1 = (u128)a[0] * r[1] + (u128)a[1] * r[0] + (u128)a[2] * s2;
+    u128 d2 = (u128)a[0] * r[2] + (u128)a[1] * r[1] + (u128)a[2] * r[0];
 
-    // Fast modular reduction (second pass)
-    m_state.a[0] += a[0];
-    m_state.a[0] += a[0] >> 2;
+    // Carry
+    u64 carry = (u64)(d0 >> 44);
+    a[0] = (u64)d0 & limb_mask_44;
+    d1 += carry;
+    carry = (u64)(d1 >> 44);
+    a[1] = (u64)d1 & limb_mask_44;
+    d2 += carry;
+    carry = (u64)(d2 >> 42);
+    a[2] = (u64)d2 & limb_mask_42;
+    a[0] += carry * 5;
+    carry = a[0] >> 44;
+    a[0] &= limb_mask_44;
+    a[1] += carry;
+#else
+    u32 high_bit = is_final_block ? 0 : (1u << 24);
+
+    a[0] += load_le32(block) & limb_mask_26;
+    a[1] += (load_le32(block + 3) >> 2) & limb_mask_26;
+    a[2] += (load_le32(block + 6) >> 4) & limb_mask_26;
+    a[3] += (load_le32(block + 9) >> 6) & limb_mask_26;
+    a[4] += (load_le32(block + 12) >> 8) | high_bit;
+
+    // Since 2^130 = 5 (mod 2^130 - 5), the parts of the product that reach past 2^130 wrap around multiplied by 5.
+    u32 s1 = r[1] * 5;
+    u32 s2 = r[2] * 5;
+    u32 s3 = r[3] * 5;
+    u32 s4 = r[4] * 5;
+
+    u64 d0 = (u64)a[0] * r[0] + (u64)a[1] * s4 + (u64)a[2] * s3 + (u64)a[3] * s2 + (u64)a[4] * s1;
+    u64 d1 = (u64)a[0] * r[1] + (u64)a[1] * r[0] + (u64)a[2] * s4 + (u64)a[3] * s3 + (u64)a[4] * s2;
+    u64 d2 = (u64)a[0] * r[2] + (u64)a[1] * r[1] + (u64)a[2] * r[0] + (u64)a[3] * s4 + (u64)a[4] * s3;
+    u64 d3 = (u64)a[0] * r[3] + (u64)a[1] * r[2] + (u64)a[2] * r[1] + (u64)a[3] * r[0] + (u64)a[4] * s4;
+    u64 d4 = (u64)a[0] * r[4] + (u64)a[1] * r[3] + (u64)a[2] * r[2] + (u64)a[3] * r[1] + (u64)a[4] * r[0];
 
     // Carry
-    m_state.a[1] += m_state.a[0] >> 32;
-    m_state.a[2] += m_state.a[1] >> 32;
-    m_state.a[3] += m_state.a[2] >> 32;
-    m_state.a[4] += m_state.a[3] >> 32;
-
-    // Only consider the least significant bits
-    m_state.a[0] &= 0xFFFFFFFF;
-    m_state.a[1] &= 0xFFFFFFFF;
-    m_state.a[2] &= 0xFFFFFFFF;
-    m_state.a[3] &= 0xFFFFFFFF;
-    m_state.a[4] &= 0x00000003;
+    u32 carry = (u32)(d0 >> 26);
+    a[0] = (u32)d0 & limb_mask_26;
+    d1 += carry;
+    carry = (u32)(d1 >> 26);
+    a[1] = (u32)d1 & limb_mask_26;
+    d2 += carry;
+    carry = (u32)(d2 >> 26);
+    a[2] = (u32)d2 & limb_mask_26;
+    d3 += carry;
+    carry = (u32)(d3 >> 26);
+    a[3] = (u32)d3 & limb_mask_26;
+    d4 += carry;
+    carry = (u32)(d4 >> 26);
+    a[4] = (u32)d4 & limb_mask_26;
+    a[0] += carry * 5;
+    carry = a[0] >> 26;
+    a[0] &= limb_mask_26;
+    a[1] += carry;
+#endif
 }
 
 ErrorOr<ByteBuffer> Poly1305::digest()
 {
-    if (m_state.block_count != 0)
-        process_block();
+    if (m_state.block_count != 0) {
+        // If the block is not 16 bytes long (the last block), append the extra bit and pad it with zeros.
+        m_state.blocks[m_state.block_count] = 0x01;
+        memset(m_state.blocks + m_state.block_count + 1, 0, BlockSize - m_state.block_count - 1);
+        process_block(m_state.blocks, true);
+        m_state.block_count = 0;
+    }
 
+    auto& a = m_state.a;
     u32 b[4];
 
-    // Save the accumulator
-    b[0] = m_state.a[0] & 0xFFFFFFFF;
-    b[1] = m_state.a[1] & 0xFFFFFFFF;
-    b[2] = m_state.a[2] & 0xFFFFFFFF;
-    b[3] = m_state.a[3] & 0xFFFFFFFF;
+#ifdef __SIZEOF_INT128__
+    // Fully carry the accumulator
+    u64 carry = a[1] >> 44;
+    a[1] &= limb_mask_44;
+    a[2] += carry;
+    carry = a[2] >> 42;
+    a[2] &= limb_mask_42;
+    a[0] += carry * 5;
+    carry = a[0] >> 44;
+    a[0] &= limb_mask_44;
+    a[1] += carry;
+    carry = a[1] >> 44;
+    a[1] &= limb_mask_44;
+    a[2] += carry;
+    carry = a[2] >> 42;
+    a[2] &= limb_mask_42;
+    a[0] += carry * 5;
+    carry = a[0] >> 44;
+    a[0] &= limb_mask_44;
+    a[1] += carry;
+
+    // Compute a + 5 - 2^130
+    u64 g0 = a[0] + 5;
+    carry = g0 >> 44;
+    g0 &= limb_mask_44;
+    u64 g1 = a[1] + carry;
+    carry = g1 >> 44;
+    g1 &= limb_mask_44;
+    u64 g2 = a[2] + carry - (1ull << 42);
+
+    // Select a - (2^130 - 5) if that didn't go negative, which means a was not fully reduced yet.
+    u64 mask = (g2 >> 63) - 1;
+    a[0] = (a[0] & ~mask) | (g0 & mask);
+    a[1] = (a[1] & ~mask) | (g1 & mask);
+    a[2] = (a[2] & ~mask) | (g2 & mask);
 
-    // Compute a + 5
-    m_state.a[0] += 5;
-
-    // Carry
-    m_state.a[1] += m_state.a[0] >> 32;
-    m_state.a[2] += m_state.a[1] >> 32;
-    m_state.a[3] += m_state.a[2] >> 32;
-    m_state.a[4] += m_state.a[3] >> 32;
+    // Finally, the value of the secret key "s" is added to the accumulator,
+    // and the 128 least significant bits are serialized in little-endian
+    // order to form the tag.
+    u64 s0 = m_state.s[0] | ((u64)m_state.s[1] << 32);
+    u64 s1 = m_state.s[2] | ((u64)m_state.s[3] << 32);
+    a[0] += s0 & limb_mask_44;
+    carry = a[0] >> 44;
+    a[0] &= limb_mask_44;
+    a[1] += (((s0 >> 44) | (s1 << 20)) & limb_mask_44) + carry;
+    carry = a[1] >> 44;
+    a[1] &= limb_mask_44;
+    a[2] += ((s1 >> 24) & limb_mask_42) + carry;
+    a[2] &= limb_mask_42;
+
+    u64 low = a[0] | (a[1] << 44);
+    u64 high = (a[1] >> 20) | (a[2] << 24);
+    b[0] = (u32)low;
+    b[1] = (u32)(low >> 32);
+    b[2] = (u32)high;
+    b[3] = (u32)(high >> 32);
+#else
+    // Fully carry the accumulator
+    u32 carry = a[1] >> 26;
+    a[1] &= limb_mask_26;
+    for (size_t i = 2; i < 5; ++i) {
+        a[i] += carry;
+        carry = a[i] >> 26;
+        a[i] &= limb_mask_26;
+    }
+    a[0] += carry * 5;
+    carry = a[0] >> 26;
+    a[0] &= limb_mask_26;
+    a[1] += carry;
+
+    // Compute a + 5 - 2^130
+    u32 g[5];
+    g[0] = a[0] + 5;
+    carry = g[0] >> 26;
+    g[0] &= limb_mask_26;
+    for (size_t i = 1; i < 4; ++i) {
+        g[i] = a[i] + carry;
+        carry = g[i] >> 26;
+        g[i] &= limb_mask_26;
+    }
+    g[4] = a[4] + carry - (1u << 26);
 
-    // Select mask based on (a + 5) >= 2^130
-    u32 mask = ((m_state.a[4] & 0x04) >> 2) - 1;
+    // Select a - (2^130 - 5) if that didn't go negative, which means a was not fully reduced yet.
+    u32 mask = (g[4] >> 31) - 1;
+    for (size_t i = 0; i < 5; ++i)
+        a[i] = (a[i] & ~mask) | (g[i] & mask);
 
-    // Select based on mask
-    m_state.a[0] = (m_state.a[0] & ~mask) | (b[0] & mask);
-    m_state.a[1] = (m_state.a[1] & ~mask) | (b[1] & mask);
-    m_state.a[2] = (m_state.a[2] & ~mask) | (b[2] & mask);
-    m_state.a[3] = (m_state.a[3] & ~mask) | (b[3] & mask);
+    b[0] = a[0] | (a[1] << 26);
+    b[1] = (a[1] >> 6) | (a[2] << 20);
+    b[2] = (a[2] >> 12) | (a[3] << 14);
+    b[3] = (a[3] >> 18) | (a[4] << 8);
 
     // Finally, the value of the secret key "s" is added to the accumulator,
     // and the 128 least significant bits are serialized in little-endian
     // order to form the tag.
-    m_state.a[0] += m_state.s[0];
-    m_state.a[1] += m_state.s[1];
-    m_state.a[2] += m_state.s[2];
-    m_state.a[3] += m_state.s[3];
-
-    // Carry
-    m_state.a[1] += m_state.a[0] >> 32;
-    m_state.a[2] += m_state.a[1] >> 32;
-    m_state.a[3] += m_state.a[2] >> 32;
-    m_state.a[4] += m_state.a[3] >> 32;
-
-    // Only consider the least significant bits
-    b[0] = m_state.a[0] & 0xFFFFFFFF;
-    b[1] = m_state.a[1] & 0xFFFFFFFF;
-    b[2] = m_state.a[2] & 0xFFFFFFFF;
-    b[3] = m_state.a[3] & 0xFFFFFFFF;
+    u64 sum = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        sum = (u64)b[i] + m_state.s[i] + (sum >> 32);
+        b[i] = (u32)sum;
+    }
+#endif
 
     ByteBuffer output = TRY(ByteBuffer::create_uninitialized(16));
 
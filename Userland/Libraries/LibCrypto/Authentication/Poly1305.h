@@ -10,23 +10,34 @@
 
 namespace Crypto::Authentication {
 
+// The 130 bit numbers are kept in limbs that are small enough that multiplying them doesn't overflow twice their size:
+// three limbs of 44, 44 and 42 bits when we have 128 bit integers, and five limbs of 26 bits otherwise.
 struct State {
-    u32 r[4] {};
+#ifdef __SIZEOF_INT128__
+    static constexpr size_t LimbCount = 3;
+    using Limb = u64;
+#else
+    static constexpr size_t LimbCount = 5;
+    using Limb = u32;
+#endif
+    Limb r[LimbCount] {};
+    Limb a[LimbCount] {};
     u32 s[4] {};
-    u64 a[8] {};
-    u8 blocks[17] {};
+    u8 blocks[16] {};
     u8 block_count {};
 };
 
 class Poly1305 {
 
 public:
+    static constexpr size_t BlockSize = 16;
+
     explicit Poly1305(ReadonlyBytes key);
     void update(ReadonlyBytes message);
     ErrorOr<ByteBuffer> digest();
 
 private:
-    void process_block();
+    void process_block(u8 const* block, bool is_final_block = false);
 
     State m_state;
 };
@@ -10,39 +10,130 @@
 namespace Crypto {
 
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N * M) word operations, where N and M are the number of words in the numerator and the denominator.
  * Division method:
- * We loop over the bits of the divisor, attempting to subtract divisor<<i from the dividend.
- * If the result is non-negative, it means that divisor*2^i "fits" in the dividend,
- * so we set the ith bit in the quotient and reduce divisor<<i from the dividend.
- * When we're done, what's left from the dividend is the remainder.
+ * This is schoolbook long division with one word per digit, Algorithm D from Knuth's TAOCP Vol. 2, 4.3.1.
+ * The denominator is shifted so that its top bit is set, which makes the estimate of every quotient digit from the
+ * top two words of the remainder off by at most two. Both numbers are copied before anything is written to the
+ * quotient or the remainder, so these may be the same as the numerator.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::divide_without_allocation(
     UnsignedBigInteger const& numerator,
     UnsignedBigInteger const& denominator,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
+    UnsignedBigInteger&,
+    UnsignedBigInteger&,
     UnsignedBigInteger& temp_shift,
     UnsignedBigInteger& temp_minus,
     UnsignedBigInteger& quotient,
     UnsignedBigInteger& remainder)
 {
+    using Word = UnsignedBigInteger::Word;
+    using DoubleWord = u64;
+    constexpr size_t bits_in_word = UnsignedBigInteger::BITS_IN_WORD;
+
+    auto numerator_length = numerator.trimmed_length();
+    auto denominator_length = denominator.trimmed_length();
+    VERIFY(denominator_length > 0);
+
+    if (numerator_length < denominator_length) {
+        remainder.set_to(numerator);
+        quotient.set_to_0();
+        return;
+    }
+
+    // Normalize both numbers, so that the top bit of the denominator is set.
+    auto shift = count_leading_zeroes(denominator.m_words[denominator_length - 1]);
+    auto shift_left = [&](UnsignedBigInteger const& number, size_t length, Word* output) {
+        Word carry = 0;
+        for (size_t i = 0; i < length; ++i) {
+            Word word = number.m_words[i];
+            output[i] = (word << shift) | carry;
+            carry = shift == 0 ? 0 : word >> (bits_in_word - shift);
+        }
+        return carry;
+    };
+
+    temp_shift.set_to_0();
+    temp_shift.m_words.resize_and_keep_capacity(denominator_length);
+    Word* divisor = temp_shift.m_words.data();
+    shift_left(denominator, denominator_length, divisor);
+
+    temp_minus.set_to_0();
+    temp_minus.m_words.resize_and_keep_capacity(numerator_length + 1);
+    Word* dividend = temp_minus.m_words.data();
+    dividend[numerator_length] = shift_left(numerator, numerator_length, dividend);
+
+    auto quotient_length = numerator_length - denominator_length + 1;
     quotient.set_to_0();
-    remainder.set_to(numerator);
-
-    // iterate all bits
-    for (int word_index = numerator.trimmed_length() - 1; word_index >= 0; --word_index) {
-        for (int bit_index = UnsignedBigInteger::BITS_IN_WORD - 1; bit_index >= 0; --bit_index) {
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
-            shift_left_without_allocation(denominator, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-
-            subtract_without_allocation(remainder, temp_shift, temp_minus);
-            if (!temp_minus.is_invalid()) {
-                remainder.set_to(temp_minus);
-                quotient.set_bit_inplace(shift_amount);
+    quotient.m_words.resize_and_keep_capacity(quotient_length);
+    Word* quotient_words = quotient.m_words.data();
+
+    if (denominator_length == 1) {
+        DoubleWord partial_remainder = dividend[numerator_length];
+        for (size_t i = numerator_length; i-- > 0;) {
+            DoubleWord current = (partial_remainder << bits_in_word) | dividend[i];
+            quotient_words[i] = static_cast<Word>(current / divisor[0]);
+            partial_remainder = current % divisor[0];
+        }
+        quotient.clamp_to_trimmed_length();
+        remainder.set_to(static_cast<Word>(partial_remainder >> shift));
+        return;
+    }
+
+    DoubleWord top_divisor_word = divisor[denominator_length - 1];
+    DoubleWord second_divisor_word = divisor[denominator_length - 2];
+    for (size_t j = quotient_length; j-- > 0;) {
+        // Estimate the digit from the top two words of the remainder and the top word of the denominator, then correct
+        // the estimate with the second word, which leaves it at most one too large.
+        Word* current = dividend + j;
+        DoubleWord top = (static_cast<DoubleWord>(current[denominator_length]) << bits_in_word) | current[denominator_length - 1];
+        DoubleWord quotient_estimate = top / top_divisor_word;
+        DoubleWord remainder_estimate = top % top_divisor_word;
+        while (quotient_estimate >> bits_in_word
+            || quotient_estimate * second_divisor_word > ((remainder_estimate << bits_in_word) | current[denominator_length - 2])) {
+            --quotient_estimate;
+            remainder_estimate += top_divisor_word;
+            if (remainder_estimate >> bits_in_word)
+                break;
+        }
+
+        // Subtract the denominator times the estimate from the remainder.
+        DoubleWord carry = 0;
+        Word borrow = 0;
+        for (size_t i = 0; i < denominator_length; ++i) {
+            DoubleWord product = quotient_estimate * divisor[i] + carry;
+            carry = product >> bits_in_word;
+            DoubleWord difference = static_cast<DoubleWord>(current[i]) - static_cast<Word>(product) - borrow;
+            current[i] = static_cast<Word>(difference);
+            borrow = (difference >> bits_in_word) != 0;
+        }
+        DoubleWord difference = static_cast<DoubleWord>(current[denominator_length]) - carry - borrow;
+        current[denominator_length] = static_cast<Word>(difference);
+
+        // If that went negative, the estimate was one too large, and we have to add the denominator back once.
+        if (difference >> bits_in_word) {
+            --quotient_estimate;
+            DoubleWord sum_carry = 0;
+            for (size_t i = 0; i < denominator_length; ++i) {
+                DoubleWord sum = static_cast<DoubleWord>(current[i]) + divisor[i] + sum_carry;
+                current[i] = static_cast<Word>(sum);
+                sum_carry = sum >> bits_in_word;
             }
+            current[denominator_length] += static_cast<Word>(sum_carry);
         }
+
+        quotient_words[j] = static_cast<Word>(quotient_estimate);
+    }
+
+    // What's left of the dividend is the remainder, which just has to be shifted back.
+    remainder.set_to_0();
+    remainder.m_words.resize_and_keep_capacity(denominator_length);
+    for (size_t i = 0; i < denominator_length; ++i) {
+        Word high_bits = shift == 0 ? 0 : dividend[i + 1] << (bits_in_word - shift);
+        remainder.m_words[i] = (dividend[i] >> shift) | high_bits;
     }
+    quotient.clamp_to_trimmed_length();
+    remainder.clamp_to_trimmed_length();
 }
 
 /**
@@ -71,44 +71,77 @@ ALWAYS_INLINE static u32 inverse_wrapped(u32 value)
 }
 
 /**
- * Computes z = x * y + c. z_carry contains the top bits, z contains the bottom bits.
+ * Computes a montgomery "fragment" for y_i. This computes "z[i] += x[i] * y_i" for all words while rippling the carry, and returns the carry.
+ * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
  */
-ALWAYS_INLINE static void linear_multiplication_with_carry(u32 x, u32 y, u32 c, u32& z_carry, u32& z)
+UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
 {
-    u64 result = static_cast<u64>(x) * static_cast<u64>(y) + static_cast<u64>(c);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
+    // x[i] * y_i + z[i] + carry always fits in 64 bits, since (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1.
+    auto* z_words = z.m_words.data() + offset_in_z;
+    auto const* x_words = x.m_words.data();
+    u64 carry { 0 };
+    for (size_t i = 0; i < num_words; ++i) {
+        u64 result = static_cast<u64>(x_words[i]) * y_digit + z_words[i] + carry;
+        z_words[i] = static_cast<UnsignedBigInteger::Word>(result);
+        carry = result >> UnsignedBigInteger::BITS_IN_WORD;
+    }
+    return static_cast<UnsignedBigInteger::Word>(carry);
 }
 
-/**
- * Computes z = a + b. z_carry contains the top bit (1 or 0), z contains the bottom bits.
- */
-ALWAYS_INLINE static void addition_with_carry(u32 a, u32 b, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(a) + static_cast<u64>(b);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
+#ifdef __SIZEOF_INT128__
+// The words of a number are two halves of a 64-bit limb each, which this lets us read and write directly.
+using AliasedDoubleWord = u64 __attribute__((may_alias, aligned(alignof(UnsignedBigInteger::Word))));
 
 /**
- * Computes a montgomery "fragment" for y_i. This computes "z[i] += x[i] * y_i" for all words while rippling the carry, and returns the carry.
- * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
+ * This is the same almost montgomery product as below, but on 64-bit limbs with 128-bit products, which needs a quarter
+ * of the multiplications. The reduction is interleaved with the multiplication, so that z is only num_limbs + 2 limbs.
+ * Algorithm from: Koç, Acar and Kaliski, "Analyzing and Comparing Montgomery Multiplication Algorithms" (CIOS).
  */
-UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
+static void almost_montgomery_multiplication_with_double_words(AliasedDoubleWord const* x, AliasedDoubleWord const* y, AliasedDoubleWord const* modulo, AliasedDoubleWord* z, u64 k, size_t num_limbs, AliasedDoubleWord* result)
 {
-    UnsignedBigInteger::Word carry { 0 };
-    for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word a_carry;
-        UnsignedBigInteger::Word a;
-        linear_multiplication_with_carry(x.m_words[i], y_digit, z.m_words[offset_in_z + i], a_carry, a);
-        UnsignedBigInteger::Word b_carry;
-        UnsignedBigInteger::Word b;
-        addition_with_carry(a, carry, b_carry, b);
-        z.m_words[offset_in_z + i] = b;
-        carry = a_carry + b_carry;
+    using u128 = unsigned __int128;
+
+    __builtin_memset(z, 0, (num_limbs + 2) * sizeof(u64));
+    for (size_t i = 0; i < num_limbs; ++i) {
+        // z += x * y_i
+        u64 y_limb = y[i];
+        u64 carry = 0;
+        for (size_t j = 0; j < num_limbs; ++j) {
+            u128 product = static_cast<u128>(x[j]) * y_limb + z[j] + carry;
+            z[j] = static_cast<u64>(product);
+            carry = static_cast<u64>(product >> 64);
+        }
+        u128 top = static_cast<u128>(z[num_limbs]) + carry;
+        z[num_limbs] = static_cast<u64>(top);
+        z[num_limbs + 1] = static_cast<u64>(top >> 64);
+
+        // z = (z + modulo * (z_0 * k)) / 2^64, which is exact since the lowest limb becomes zero.
+        u64 t = z[0] * k;
+        u128 product = static_cast<u128>(modulo[0]) * t + z[0];
+        carry = static_cast<u64>(product >> 64);
+        for (size_t j = 1; j < num_limbs; ++j) {
+            product = static_cast<u128>(modulo[j]) * t + z[j] + carry;
+            z[j - 1] = static_cast<u64>(product);
+            carry = static_cast<u64>(product >> 64);
+        }
+        top = static_cast<u128>(z[num_limbs]) + carry;
+        z[num_limbs - 1] = static_cast<u64>(top);
+        z[num_limbs] = z[num_limbs + 1] + static_cast<u64>(top >> 64);
+    }
+
+    // Like below, a carry means that we're "one bigger" than we need to be, so we subtract the modulo once.
+    if (z[num_limbs] == 0) {
+        __builtin_memcpy(result, z, num_limbs * sizeof(u64));
+        return;
+    }
+    u64 borrow = 0;
+    for (size_t i = 0; i < num_limbs; ++i) {
+        u128 difference = static_cast<u128>(z[i]) - modulo[i] - borrow;
+        result[i] = static_cast<u64>(difference);
+        borrow = static_cast<u64>(difference >> 64) & 1;
     }
-    return carry;
 }
+#endif
 
 /**
  * Computes the "almost montgomery" product : x * y * 2 ^ (-num_words * BITS_IN_WORD) % modulo
@@ -131,6 +164,30 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
     VERIFY(y.length() >= num_words);
     VERIFY(modulo.length() >= num_words);
 
+#ifdef __SIZEOF_INT128__
+    if (num_words % 2 == 0) {
+        // k is the negated inverse of the modulo over 2^32, so one more Newton-Raphson step gives us the one over 2^64.
+        u64 first_limb_of_modulo = *reinterpret_cast<AliasedDoubleWord const*>(modulo.m_words.data());
+        u64 inverse = static_cast<u64>(-static_cast<u64>(k)) & 0xffffffff;
+        inverse *= 2 - first_limb_of_modulo * inverse;
+        u64 k_for_double_words = -inverse;
+
+        z.set_to_0();
+        z.resize_with_leading_zeros(num_words + 4);
+        result.set_to_0();
+        result.resize_with_leading_zeros(num_words);
+        almost_montgomery_multiplication_with_double_words(
+            reinterpret_cast<AliasedDoubleWord const*>(x.m_words.data()),
+            reinterpret_cast<AliasedDoubleWord const*>(y.m_words.data()),
+            reinterpret_cast<AliasedDoubleWord const*>(modulo.m_words.data()),
+            reinterpret_cast<AliasedDoubleWord*>(z.m_words.data()),
+            k_for_double_words,
+            num_words / 2,
+            reinterpret_cast<AliasedDoubleWord*>(result.m_words.data()));
+        return;
+    }
+#endif
+
     z.set_to(0);
     z.resize_with_leading_zeros(num_words * 2);
 
@@ -181,6 +238,8 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
 /**
  * Complexity: still O(N^3) with N the number of words in the largest word, but less complex than the classical mod power.
  * Note: the montgomery multiplications requires an inverse modulo over 2^32, which is only defined for odd numbers.
+ * The exponent is processed with sliding windows: a run of zero bits costs one squaring per bit, and every window of
+ * up to window_size bits that starts and ends with a one costs one multiplication with a precomputed odd power.
  */
 void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocations(
     UnsignedBigInteger const& base,
@@ -197,9 +256,18 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 {
     VERIFY(modulo.is_odd());
 
-    // Note: While this is a constexpr variable for clarity and could be changed in theory,
-    // various optimized parts of the algorithm rely on this value being exactly 4.
-    constexpr size_t window_size = 4;
+    // Bigger windows need fewer multiplications, but more precomputed powers. These sizes are the ones OpenSSL uses.
+    constexpr size_t max_window_size = 6;
+    size_t exponent_bits = exponent.one_based_index_of_highest_set_bit();
+    size_t window_size = 1;
+    if (exponent_bits > 671)
+        window_size = 6;
+    else if (exponent_bits > 239)
+        window_size = 5;
+    else if (exponent_bits > 79)
+        window_size = 4;
+    else if (exponent_bits > 23)
+        window_size = 3;
 
     size_t num_words = modulo.trimmed_length();
     UnsignedBigInteger::Word k = inverse_wrapped(modulo.m_words[0]);
@@ -220,39 +288,54 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
     one.set_to(1);
     one.resize_with_leading_zeros(num_words);
 
-    // Compute the montgomery powers from 0 to 2^window_size. powers[i] = x^i
-    UnsignedBigInteger powers[1 << window_size];
-    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, powers[0]);
-    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[1]);
-    for (size_t i = 2; i < (1 << window_size); ++i)
-        almost_montgomery_multiplication_without_allocation(powers[i - 1], powers[1], modulo, temp_z, k, num_words, powers[i]);
-
-    z.set_to(powers[0]);
-    z.resize_with_leading_zeros(num_words);
-    zz.set_to(0);
-    zz.resize_with_leading_zeros(num_words);
-
-    ssize_t exponent_length = exponent.trimmed_length();
-    for (ssize_t word_in_exponent = exponent_length - 1; word_in_exponent >= 0; --word_in_exponent) {
-        UnsignedBigInteger::Word exponent_word = exponent.m_words[word_in_exponent];
-        size_t bit_in_word = 0;
-        while (bit_in_word < UnsignedBigInteger::BITS_IN_WORD) {
-            if (word_in_exponent != exponent_length - 1 || bit_in_word != 0) {
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+    // z = 1 and x = x, in montgomery form.
+    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, z);
+    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, zz);
+
+    // Compute the odd montgomery powers up to 2^window_size. odd_powers[i] = x^(2 * i + 1)
+    UnsignedBigInteger odd_powers[1 << (max_window_size - 1)];
+    odd_powers[0].set_to(zz);
+    if (window_size > 1) {
+        almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, x);
+        for (size_t i = 1; i < (1u << (window_size - 1)); ++i)
+            almost_montgomery_multiplication_without_allocation(odd_powers[i - 1], x, modulo, temp_z, k, num_words, odd_powers[i]);
+    }
+
+    auto exponent_bit = [&](size_t index) {
+        return (exponent.m_words[index / UnsignedBigInteger::BITS_IN_WORD] >> (index % UnsignedBigInteger::BITS_IN_WORD)) & 1;
+    };
+
+    bool is_first_window = true;
+    for (ssize_t bit = static_cast<ssize_t>(exponent_bits) - 1; bit >= 0;) {
+        if (!exponent_bit(bit)) {
+            almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
+            swap(z, zz);
+            --bit;
+            continue;
+        }
+
+        // Find the longest window that ends in a one.
+        ssize_t window_end = max(bit - static_cast<ssize_t>(window_size) + 1, static_cast<ssize_t>(0));
+        while (!exponent_bit(window_end))
+            ++window_end;
+        size_t window_value = 0;
+        for (ssize_t i = bit; i >= window_end; --i)
+            window_value = (window_value << 1) | exponent_bit(i);
+
+        auto& power = odd_powers[window_value / 2];
+        if (is_first_window) {
+            // Squaring one is pointless, we can just start from the power.
+            z.set_to(power);
+            is_first_window = false;
+        } else {
+            for (ssize_t i = bit; i >= window_end; --i) {
                 almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+                swap(z, zz);
             }
-            auto power_index = exponent_word >> (UnsignedBigInteger::BITS_IN_WORD - window_size);
-            auto& power = powers[power_index];
             almost_montgomery_multiplication_without_allocation(z, power, modulo, temp_z, k, num_words, zz);
-
             swap(z, zz);
-
-            // Move to the next window
-            exponent_word <<= window_size;
-            bit_in_word += window_size;
         }
+        bit = window_end - 1;
     }
 
     almost_montgomery_multiplication_without_allocation(z, one, modulo, temp_z, k, num_words, zz);
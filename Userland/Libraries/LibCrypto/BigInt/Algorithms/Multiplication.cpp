@@ -9,38 +9,193 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+static_assert(sizeof(DoubleWord) == 2 * sizeof(Word));
+
+// Below this many words, the schoolbook method wins over Karatsuba, which has to do a lot more bookkeeping.
+static constexpr size_t karatsuba_threshold = 32;
+
+/**
+ * Computes output = left * right, with output being left_length + right_length words long.
+ * Complexity: O(N * M) word multiplications.
+ */
+static void multiply_words_schoolbook(Word* output, Word const* left, size_t left_length, Word const* right, size_t right_length)
+{
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    for (size_t i = 0; i < right_length; ++i) {
+        DoubleWord carry = 0;
+        DoubleWord right_word = right[i];
+        for (size_t j = 0; j < left_length; ++j) {
+            DoubleWord product = left[j] * right_word + output[i + j] + carry;
+            output[i + j] = static_cast<Word>(product);
+            carry = product >> UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[i + left_length] = static_cast<Word>(carry);
+    }
+}
+
+/**
+ * Computes accumulator += value, where the accumulator is at least as long as the value and doesn't overflow.
+ */
+static void add_words_into_accumulator(Word* accumulator, size_t accumulator_length, Word const* value, size_t value_length)
+{
+    DoubleWord carry = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        DoubleWord sum = static_cast<DoubleWord>(accumulator[i]) + value[i] + carry;
+        accumulator[i] = static_cast<Word>(sum);
+        carry = sum >> UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry != 0 && i < accumulator_length; ++i) {
+        DoubleWord sum = static_cast<DoubleWord>(accumulator[i]) + carry;
+        accumulator[i] = static_cast<Word>(sum);
+        carry = sum >> UnsignedBigInteger::BITS_IN_WORD;
+    }
+    VERIFY(carry == 0);
+}
+
+/**
+ * Computes accumulator -= value, where the result is known to be non-negative.
+ */
+static void subtract_words_from_accumulator(Word* accumulator, size_t accumulator_length, Word const* value, size_t value_length)
+{
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(accumulator[i]) - value[i] - borrow;
+        accumulator[i] = static_cast<Word>(difference);
+        borrow = (difference >> UnsignedBigInteger::BITS_IN_WORD) != 0;
+    }
+    for (; borrow != 0 && i < accumulator_length; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(accumulator[i]) - borrow;
+        accumulator[i] = static_cast<Word>(difference);
+        borrow = (difference >> UnsignedBigInteger::BITS_IN_WORD) != 0;
+    }
+    VERIFY(borrow == 0);
+}
+
+static Word add_words(Word* output, Word const* left, size_t left_length, Word const* right, size_t right_length)
+{
+    VERIFY(left_length >= right_length);
+    __builtin_memcpy(output, left, left_length * sizeof(Word));
+    output[left_length] = 0;
+    add_words_into_accumulator(output, left_length + 1, right, right_length);
+    return output[left_length];
+}
+
+static size_t scratch_words_for_multiplication(size_t left_length, size_t right_length);
+
+static size_t scratch_words_for_karatsuba(size_t length)
+{
+    auto high_length = length - length / 2;
+    // The sums of both halves, their product, and whatever that multiplication needs.
+    return 2 * (high_length + 1) + 2 * (high_length + 1) + scratch_words_for_multiplication(high_length + 1, high_length + 1);
+}
+
+static size_t scratch_words_for_multiplication(size_t left_length, size_t right_length)
+{
+    if (left_length < right_length)
+        swap(left_length, right_length);
+    if (right_length < karatsuba_threshold)
+        return 0;
+    if (left_length == right_length)
+        return scratch_words_for_karatsuba(left_length);
+    // The product of one slice, and whatever that multiplication needs.
+    return left_length + right_length + max(scratch_words_for_karatsuba(right_length), scratch_words_for_multiplication(left_length % right_length, right_length));
+}
+
+static void multiply_words(Word* output, Word const* left, size_t left_length, Word const* right, size_t right_length, Word* scratch);
+
+/**
+ * Computes output = left * right for two numbers that are both length words long, by splitting them into a low and a
+ * high half and doing three multiplications of half the size instead of four:
+ *     left * right = high_product * B^2 + ((left_low + left_high) * (right_low + right_high) - high_product - low_product) * B + low_product
+ * Complexity: O(N ^ log2(3))
+ */
+static void multiply_words_karatsuba(Word* output, Word const* left, Word const* right, size_t length, Word* scratch)
+{
+    auto low_length = length / 2;
+    auto high_length = length - low_length;
+
+    // The low and high products go right where they belong in the output.
+    multiply_words(output, left, low_length, right, low_length, scratch);
+    multiply_words(output + 2 * low_length, left + low_length, high_length, right + low_length, high_length, scratch);
+
+    auto sum_length = high_length + 1;
+    Word* left_sum = scratch;
+    Word* right_sum = left_sum + sum_length;
+    Word* middle = right_sum + sum_length;
+    Word* next_scratch = middle + 2 * sum_length;
+
+    add_words(left_sum, left + low_length, high_length, left, low_length);
+    add_words(right_sum, right + low_length, high_length, right, low_length);
+    multiply_words(middle, left_sum, sum_length, right_sum, sum_length, next_scratch);
+    subtract_words_from_accumulator(middle, 2 * sum_length, output, 2 * low_length);
+    subtract_words_from_accumulator(middle, 2 * sum_length, output + 2 * low_length, 2 * high_length);
+
+    // The middle product is known to fit in 2 * high_length + 1 words now, and doesn't carry out of the output.
+    auto middle_length = min(2 * sum_length, 2 * length - low_length);
+    add_words_into_accumulator(output + low_length, 2 * length - low_length, middle, middle_length);
+}
+
+/**
+ * Computes output = left * right, with output being left_length + right_length words long.
+ * The scratch space has to be at least scratch_words_for_multiplication(left_length, right_length) words.
+ */
+static void multiply_words(Word* output, Word const* left, size_t left_length, Word const* right, size_t right_length, Word* scratch)
+{
+    if (left_length < right_length) {
+        swap(left, right);
+        swap(left_length, right_length);
+    }
+
+    if (right_length < karatsuba_threshold) {
+        multiply_words_schoolbook(output, left, left_length, right, right_length);
+        return;
+    }
+
+    if (left_length == right_length) {
+        multiply_words_karatsuba(output, left, right, left_length, scratch);
+        return;
+    }
+
+    // Karatsuba only works for numbers of the same length, so the longer number is multiplied one slice at a time.
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    Word* product = scratch;
+    Word* next_scratch = product + left_length + right_length;
+    for (size_t offset = 0; offset < left_length; offset += right_length) {
+        auto slice_length = min(right_length, left_length - offset);
+        multiply_words(product, left + offset, slice_length, right, right_length, next_scratch);
+        add_words_into_accumulator(output + offset, left_length + right_length - offset, product, slice_length + right_length);
+    }
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
- * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Complexity: O(N^2) where N is the number of words in the larger number, or O(N ^ log2(3)) once both numbers are
+ * at least karatsuba_threshold words long.
+ * temp_shift is used as the scratch space for Karatsuba, the other temporaries aren't used anymore.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
+    UnsignedBigInteger&,
+    UnsignedBigInteger&,
     UnsignedBigInteger& temp_shift,
     UnsignedBigInteger& output)
 {
-    output.set_to_0();
-
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    auto left_length = left.trimmed_length();
+    auto right_length = right.trimmed_length();
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    output.set_to_0();
+    if (left_length == 0 || right_length == 0)
+        return;
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
-    }
+    temp_shift.set_to_0();
+    temp_shift.m_words.resize_and_keep_capacity(scratch_words_for_multiplication(left_length, right_length));
+    output.m_words.resize_and_keep_capacity(left_length + right_length);
+    multiply_words(output.m_words.data(), left.m_words.data(), left_length, right.m_words.data(), right_length, temp_shift.m_words.data());
+    output.clamp_to_trimmed_length();
 }
 
 }
@@ -1,20 +1,71 @@
 /*
- * Copyright (c) 2020, the SerenityOS developers.
+ * Copyright (c) 2020-2022, the SerenityOS developers.
  *
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/SIMD.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
 namespace Crypto::Checksum {
 
+using AK::SIMD::u32x4;
+using AK::SIMD::u8x16;
+
+static constexpr u32 modulus = 65521;
+
+// The sums are only reduced once per this many bytes, which is what zlib uses to keep b from overflowing 32 bits.
+static constexpr size_t bytes_per_reduction = 5552;
+static constexpr size_t block_size = 16;
+static_assert(bytes_per_reduction % block_size == 0);
+
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+    u8 const* bytes = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        auto chunk_size = min(remaining, bytes_per_reduction);
+        remaining -= chunk_size;
+
+        u64 a = m_state_a;
+        u64 b = m_state_b;
+
+        // For every block of 16 bytes, a grows by the sum of the bytes and b by 16 times the a from before the block and
+        // by each byte weighted by how many times it is added into b within the block. The sums of the bytes in all of
+        // the previous blocks are kept per lane, so the lanes are only added up at the end of the chunk.
+        auto block_count = chunk_size / block_size;
+        if (block_count > 0) {
+            u32x4 sums {};
+            u32x4 sums_before_block {};
+            u32x4 weighted_sums {};
+            for (size_t i = 0; i < block_count; ++i, bytes += block_size) {
+                u8x16 block;
+                __builtin_memcpy(&block, bytes, sizeof(block));
+                auto first = __builtin_convertvector(__builtin_shufflevector(block, block, 0, 1, 2, 3), u32x4);
+                auto second = __builtin_convertvector(__builtin_shufflevector(block, block, 4, 5, 6, 7), u32x4);
+                auto third = __builtin_convertvector(__builtin_shufflevector(block, block, 8, 9, 10, 11), u32x4);
+                auto fourth = __builtin_convertvector(__builtin_shufflevector(block, block, 12, 13, 14, 15), u32x4);
+
+                sums_before_block += sums;
+                sums += first + second + third + fourth;
+                weighted_sums += first * u32x4 { 16, 15, 14, 13 } + second * u32x4 { 12, 11, 10, 9 }
+                    + third * u32x4 { 8, 7, 6, 5 } + fourth * u32x4 { 4, 3, 2, 1 };
+            }
+
+            auto add_lanes = [](u32x4 lanes) { return static_cast<u64>(lanes[0]) + lanes[1] + lanes[2] + lanes[3]; };
+            b += a * block_size * block_count + block_size * add_lanes(sums_before_block) + add_lanes(weighted_sums);
+            a += add_lanes(sums);
+        }
+
+        for (size_t i = block_count * block_size; i < chunk_size; ++i) {
+            a += *bytes++;
+            b += a;
+        }
+
+        m_state_a = a % modulus;
+        m_state_b = b % modulus;
     }
 };
 
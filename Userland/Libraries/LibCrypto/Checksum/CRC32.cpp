@@ -5,16 +5,24 @@
  */
 
 #include <AK/Array.h>
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#endif
+
 namespace Crypto::Checksum {
 
-static constexpr auto generate_table()
+// The first table is the CRC of every single byte. Every further table advances the CRC in the previous one by another
+// byte of zeros, which allows "slicing" eight bytes at a time into independent lookups.
+static constexpr auto generate_tables()
 {
-    Array<u32, 256> data {};
-    for (auto i = 0u; i < data.size(); i++) {
+    Array<Array<u32, 256>, 8> data {};
+    for (auto i = 0u; i < data[0].size(); i++) {
         u32 value = i;
 
         for (auto j = 0; j < 8; j++) {
@@ -25,18 +33,158 @@ static constexpr auto generate_table()
             }
         }
 
-        data[i] = value;
+        data[0][i] = value;
+    }
+    for (auto k = 1u; k < data.size(); k++) {
+        for (auto i = 0u; i < data[k].size(); i++)
+            data[k][i] = (data[k - 1][i] >> 8) ^ data[0][data[k - 1][i] & 0xFF];
     }
     return data;
 }
 
-static constexpr auto table = generate_table();
+static constexpr auto tables = generate_tables();
+static constexpr auto& table = tables[0];
 
-void CRC32::update(ReadonlyBytes data)
+static u32 update_with_tables(u32 state, u8 const* data, size_t size)
+{
+    for (; size >= 8; data += 8, size -= 8) {
+        u32 low = AK::convert_between_host_and_little_endian(ByteReader::load32(data)) ^ state;
+        u32 high = AK::convert_between_host_and_little_endian(ByteReader::load32(data + 4));
+        state = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+            ^ tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+    }
+    for (; size > 0; ++data, --size)
+        state = table[(state ^ *data) & 0xFF] ^ (state >> 8);
+    return state;
+}
+
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define PCLMUL_SUPPORTED
+
+using v2di = long long __attribute__((vector_size(16)));
+
+static bool cpu_supports_pclmul()
+{
+    static bool const s_supported = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ecx & bit_PCLMUL) != 0;
+    }();
+    return s_supported;
+}
+
+// Below this, setting up the folding costs more than it saves.
+static constexpr size_t minimum_size_for_folding = 64;
+
+[[gnu::target("pclmul")]] static v2di fold(v2di value, v2di constants, v2di data)
+{
+    return __builtin_ia32_pclmulqdq128(value, constants, 0x00) ^ __builtin_ia32_pclmulqdq128(value, constants, 0x11) ^ data;
+}
+
+static v2di load(u8 const* data)
+{
+    v2di value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Folds 128-bit blocks into each other with carry-less multiplications by x^n modulo the polynomial, and reduces what
+// is left with a Barrett reduction. This follows Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+// Instruction", with the bit-reflected constants for the CRC32 polynomial. Only whole blocks are consumed, the amount of
+// bytes that were is returned.
+[[gnu::target("pclmul")]] static size_t update_with_folding(u32& state, u8 const* data, size_t size)
+{
+    VERIFY(size >= minimum_size_for_folding);
+
+    // x^(4*128+32) and x^(4*128-32), x^(128+32) and x^(128-32), x^64, and floor(x^64 / P) and P itself.
+    v2di const fold_by_4_constants { 0x154442bd4, 0x1c6e41596 };
+    v2di const fold_by_1_constants { 0x1751997d0, 0xccaa009e };
+    v2di const fold_to_32_bits_constant { 0x163cd6124, 0 };
+    v2di const barrett_constants { 0x1DB710641, 0x1F7011641 };
+    v2di const low_32_bits_mask { 0xFFFFFFFF, 0 };
+
+    v2di x0 = load(data) ^ v2di { state, 0 };
+    v2di x1 = load(data + 16);
+    v2di x2 = load(data + 32);
+    v2di x3 = load(data + 48);
+    size_t offset = 64;
+
+    for (; size - offset >= 64; offset += 64) {
+        x0 = fold(x0, fold_by_4_constants, load(data + offset));
+        x1 = fold(x1, fold_by_4_constants, load(data + offset + 16));
+        x2 = fold(x2, fold_by_4_constants, load(data + offset + 32));
+        x3 = fold(x3, fold_by_4_constants, load(data + offset + 48));
+    }
+
+    v2di x = fold(x0, fold_by_1_constants, x1);
+    x = fold(x, fold_by_1_constants, x2);
+    x = fold(x, fold_by_1_constants, x3);
+    for (; size - offset >= 16; offset += 16)
+        x = fold(x, fold_by_1_constants, load(data + offset));
+
+    // Fold 128 into 64 bits, which also appends the 32 bits of zeros the CRC is defined with.
+    x = __builtin_ia32_pclmulqdq128(fold_by_1_constants, x, 0x01) ^ v2di { x[1], 0 };
+
+    // Fold 64 into 32 bits.
+    auto low = static_cast<u64>(x[0]);
+    auto high = static_cast<u64>(x[1]);
+    x = __builtin_ia32_pclmulqdq128(x & low_32_bits_mask, fold_to_32_bits_constant, 0x00)
+        ^ v2di { static_cast<long long>(low >> 32 | high << 32), static_cast<long long>(high >> 32) };
+
+    // Barrett reduction down to the final 32 bits.
+    auto quotient = __builtin_ia32_pclmulqdq128(x & low_32_bits_mask, barrett_constants, 0x10) & low_32_bits_mask;
+    x ^= __builtin_ia32_pclmulqdq128(quotient, barrett_constants, 0x00);
+    state = static_cast<u32>(static_cast<u64>(x[0]) >> 32);
+
+    return offset;
+}
+#endif
+
+// Multiplies two polynomials modulo the CRC polynomial. Like the table above, this works on bit-reflected values, so
+// the most significant bit holds the coefficient of x^0.
+static constexpr u32 multiply_modulo_polynomial(u32 a, u32 b)
+{
+    u32 product = 0;
+    for (u32 mask = 1u << 31; mask != 0; mask >>= 1) {
+        if (a & mask)
+            product ^= b;
+        b = (b & 1) ? 0xEDB88320 ^ (b >> 1) : b >> 1;
+    }
+    return product;
+}
+
+// x^(2^n) modulo the CRC polynomial, for every n that can be needed to shift by a 64-bit amount of bytes.
+static constexpr auto generate_power_table()
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state = table[(m_state ^ data.at(i)) & 0xFF] ^ (m_state >> 8);
+    Array<u32, 64> data {};
+    data[0] = 1u << 30; // x^1
+    for (auto i = 1u; i < data.size(); i++)
+        data[i] = multiply_modulo_polynomial(data[i - 1], data[i - 1]);
+    return data;
+}
+
+static constexpr auto power_table = generate_power_table();
+
+u32 CRC32::combine(u32 first_digest, u32 second_digest, u64 second_length)
+{
+    // Appending n bytes to some data multiplies its (unconditioned) CRC by x^(8n). The pre- and post-conditioning with
+    // all ones bits cancel out between the two digests, so they can be combined as is.
+    u32 shift = 1u << 31; // x^0
+    for (size_t power = 3; second_length != 0 && power < power_table.size(); ++power, second_length >>= 1) {
+        if (second_length & 1)
+            shift = multiply_modulo_polynomial(power_table[power], shift);
     }
+    return multiply_modulo_polynomial(shift, first_digest) ^ second_digest;
+}
+
+void CRC32::update(ReadonlyBytes data)
+{
+#ifdef PCLMUL_SUPPORTED
+    if (data.size() >= minimum_size_for_folding && cpu_supports_pclmul())
+        data = data.slice(update_with_folding(m_state, data.data(), data.size()));
+#endif
+    m_state = update_with_tables(m_state, data.data(), data.size());
 };
 
 u32 CRC32::digest()
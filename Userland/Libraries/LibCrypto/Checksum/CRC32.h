@@ -29,6 +29,10 @@ public:
     virtual void update(ReadonlyBytes data) override;
     virtual u32 digest() override;
 
+    // Returns the digest of two pieces of data back to back, given the digest of each and the length of the second one.
+    // This allows computing the digest of data whose parts were checksummed separately, e.g. on different threads.
+    static u32 combine(u32 first_digest, u32 second_digest, u64 second_length);
+
 private:
     u32 m_state { ~0u };
 };
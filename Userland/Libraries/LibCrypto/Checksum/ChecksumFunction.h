@@ -1,12 +1,14 @@
 /*
- * Copyright (c) 2020, the SerenityOS developers.
+ * Copyright (c) 2020-2022, the SerenityOS developers.
  *
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
 #pragma once
 
+#include <AK/Assertions.h>
 #include <AK/Span.h>
+#include <AK/StdLibExtras.h>
 
 namespace Crypto::Checksum {
 
@@ -16,7 +18,22 @@ public:
     virtual void update(ReadonlyBytes data) = 0;
     virtual ChecksumType digest() = 0;
 
+    // Copies the source into the destination and updates the checksum with it along the way, so that e.g. decompressors
+    // don't have to make a second pass over all of their output. The data is checksummed in pieces small enough to
+    // still be in the cache right after they were copied.
+    virtual void copy_and_update(ReadonlyBytes source, Bytes destination)
+    {
+        VERIFY(destination.size() >= source.size());
+        for (size_t offset = 0; offset < source.size(); offset += copy_chunk_size) {
+            auto chunk = source.slice(offset, min(copy_chunk_size, source.size() - offset));
+            __builtin_memcpy(destination.offset(offset), chunk.data(), chunk.size());
+            update(destination.slice(offset, chunk.size()));
+        }
+    }
+
 protected:
+    static constexpr size_t copy_chunk_size = 4096;
+
     virtual ~ChecksumFunction() = default;
 };
 
@@ -8,9 +8,94 @@
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#endif
+
 namespace Crypto {
 namespace Cipher {
 
+#if ARCH(X86_64) && !defined(KERNEL)
+// The kernel doesn't save vector registers for its own code, so only userspace can make use of AES-NI.
+#    define AES_NI_SUPPORTED
+
+using v2di = long long __attribute__((vector_size(16)));
+
+static bool cpu_supports_aes_ni()
+{
+    static bool const s_supported = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ecx & bit_AES) != 0;
+    }();
+    return s_supported;
+}
+
+// Encrypts `count` blocks, four at a time while possible. The blocks don't depend on each other, so the rounds of
+// different blocks can be in flight at once, which hides most of the latency of each AESENC.
+[[gnu::target("aes")]] static void encrypt_blocks_with_aes_ni(u8 const* round_key_bytes, size_t rounds, u8 const* in, u8* out, size_t count)
+{
+    v2di round_keys[15];
+    for (size_t i = 0; i <= rounds; ++i)
+        __builtin_memcpy(&round_keys[i], round_key_bytes + i * sizeof(v2di), sizeof(v2di));
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        v2di blocks[4];
+        __builtin_memcpy(blocks, in + i * sizeof(v2di), sizeof(blocks));
+        for (auto& block : blocks)
+            block ^= round_keys[0];
+        for (size_t round = 1; round < rounds; ++round) {
+            for (auto& block : blocks)
+                block = __builtin_ia32_aesenc128(block, round_keys[round]);
+        }
+        for (auto& block : blocks)
+            block = __builtin_ia32_aesenclast128(block, round_keys[rounds]);
+        __builtin_memcpy(out + i * sizeof(v2di), blocks, sizeof(blocks));
+    }
+
+    for (; i < count; ++i) {
+        v2di block;
+        __builtin_memcpy(&block, in + i * sizeof(v2di), sizeof(block));
+        block ^= round_keys[0];
+        for (size_t round = 1; round < rounds; ++round)
+            block = __builtin_ia32_aesenc128(block, round_keys[round]);
+        block = __builtin_ia32_aesenclast128(block, round_keys[rounds]);
+        __builtin_memcpy(out + i * sizeof(v2di), &block, sizeof(block));
+    }
+}
+
+// The decryption key schedule is already laid out the way AESDEC wants it, with the round keys reversed and the
+// inverse MixColumns applied to all but the first and the last one.
+[[gnu::target("aes")]] static void decrypt_block_with_aes_ni(u8 const* round_key_bytes, size_t rounds, u8 const* in, u8* out)
+{
+    v2di block;
+    v2di round_key;
+    __builtin_memcpy(&block, in, sizeof(block));
+    __builtin_memcpy(&round_key, round_key_bytes, sizeof(round_key));
+    block ^= round_key;
+    for (size_t round = 1; round < rounds; ++round) {
+        __builtin_memcpy(&round_key, round_key_bytes + round * sizeof(v2di), sizeof(round_key));
+        block = __builtin_ia32_aesdec128(block, round_key);
+    }
+    __builtin_memcpy(&round_key, round_key_bytes + rounds * sizeof(v2di), sizeof(round_key));
+    block = __builtin_ia32_aesdeclast128(block, round_key);
+    __builtin_memcpy(out, &block, sizeof(block));
+}
+
+void AESCipherKey::store_round_key_bytes()
+{
+    for (size_t i = 0; i < (rounds() + 1) * 4; ++i) {
+        auto word = m_rd_keys[i];
+        m_round_key_bytes[i * 4 + 0] = word >> 24;
+        m_round_key_bytes[i * 4 + 1] = word >> 16;
+        m_round_key_bytes[i * 4 + 2] = word >> 8;
+        m_round_key_bytes[i * 4 + 3] = word;
+    }
+}
+#endif
+
 template<typename T>
 constexpr u32 get_key(T pt)
 {
@@ -197,8 +282,27 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
     }
 }
 
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+#ifdef AES_NI_SUPPORTED
+    if (cpu_supports_aes_ni()) {
+        VERIFY(in.size() % block_size() == 0 && out.size() >= in.size());
+        encrypt_blocks_with_aes_ni(key().round_key_bytes(), key().rounds(), in.data(), out.data(), in.size() / block_size());
+        return;
+    }
+#endif
+    Cipher<AESCipherKey, AESCipherBlock>::encrypt_blocks(in, out);
+}
+
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#ifdef AES_NI_SUPPORTED
+    if (cpu_supports_aes_ni()) {
+        encrypt_blocks_with_aes_ni(key().round_key_bytes(), key().rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -288,6 +392,13 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#ifdef AES_NI_SUPPORTED
+    if (cpu_supports_aes_ni()) {
+        decrypt_block_with_aes_ni(key().round_key_bytes(), key().rounds(), in.bytes().data(), out.bytes().data());
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
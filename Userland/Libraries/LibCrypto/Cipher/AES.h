@@ -80,6 +80,9 @@ struct AESCipherKey : public CipherKey {
             expand_encrypt_key(user_key, key_bits);
         else
             expand_decrypt_key(user_key, key_bits);
+#if ARCH(X86_64) && !defined(KERNEL)
+        store_round_key_bytes();
+#endif
     }
 
     virtual ~AESCipherKey() override = default;
@@ -87,6 +90,11 @@ struct AESCipherKey : public CipherKey {
     size_t rounds() const { return m_rounds; }
     size_t length() const { return m_bits / 8; }
 
+#if ARCH(X86_64) && !defined(KERNEL)
+    // The round keys in the byte order the AES-NI instructions expect.
+    u8 const* round_key_bytes() const { return m_round_key_bytes; }
+#endif
+
 protected:
     u32* round_keys()
     {
@@ -96,6 +104,10 @@ protected:
 private:
     static constexpr size_t MAX_ROUND_COUNT = 14;
     u32 m_rd_keys[(MAX_ROUND_COUNT + 1) * 4] { 0 };
+#if ARCH(X86_64) && !defined(KERNEL)
+    void store_round_key_bytes();
+    u8 m_round_key_bytes[(MAX_ROUND_COUNT + 1) * 16] { 0 };
+#endif
     size_t m_rounds;
     size_t m_bits;
 };
@@ -119,6 +131,7 @@ public:
 
     virtual void encrypt_block(BlockType const& in, BlockType& out) override;
     virtual void decrypt_block(BlockType const& in, BlockType& out) override;
+    virtual void encrypt_blocks(ReadonlyBytes in, Bytes out) override;
 
 #ifndef KERNEL
     virtual String class_name() const override
@@ -6,6 +6,8 @@
 
 #include <AK/ByteReader.h>
 #include <AK/Endian.h>
+#include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
 #include <LibCrypto/Cipher/ChaCha20.h>
 
 namespace Crypto::Cipher {
@@ -111,9 +113,85 @@ void ChaCha20::do_quarter_round(u32& a, u32& b, u32& c, u32& d)
     rotl(b, 7);
 }
 
+using AK::SIMD::u32x4;
+
+ALWAYS_INLINE static u32x4 rotl(u32x4 x, u32 n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+ALWAYS_INLINE static void do_vector_quarter_round(u32x4& a, u32x4& b, u32x4& c, u32x4& d)
+{
+    a += b;
+    d ^= a;
+    d = rotl(d, 16);
+
+    c += d;
+    b ^= c;
+    b = rotl(b, 12);
+
+    a += b;
+    d ^= a;
+    d = rotl(d, 8);
+
+    c += d;
+    b ^= c;
+    b = rotl(b, 7);
+}
+
+// Generates the next four blocks at once, with every lane of the vectors holding the same word of a different block,
+// and XORs them with BlocksPerBatch * BlockSize bytes of input.
+// The caller makes sure that the block counter doesn't need to carry over while doing so.
+void ChaCha20::xor_with_block_batch(u8 const* input, u8* output)
+{
+    static_assert(BlocksPerBatch == 4);
+
+    u32x4 initial[16];
+    for (size_t i = 0; i < 16; ++i)
+        initial[i] = u32x4 { m_state[i], m_state[i], m_state[i], m_state[i] };
+    initial[12] += u32x4 { 0, 1, 2, 3 };
+
+    u32x4 x[16];
+    for (size_t i = 0; i < 16; ++i)
+        x[i] = initial[i];
+
+    for (u32 i = 0; i < 20; i += 2) {
+        // Column rounds
+        do_vector_quarter_round(x[0], x[4], x[8], x[12]);
+        do_vector_quarter_round(x[1], x[5], x[9], x[13]);
+        do_vector_quarter_round(x[2], x[6], x[10], x[14]);
+        do_vector_quarter_round(x[3], x[7], x[11], x[15]);
+
+        // Diagonal rounds
+        do_vector_quarter_round(x[0], x[5], x[10], x[15]);
+        do_vector_quarter_round(x[1], x[6], x[11], x[12]);
+        do_vector_quarter_round(x[2], x[7], x[8], x[13]);
+        do_vector_quarter_round(x[3], x[4], x[9], x[14]);
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+        x[i] += initial[i];
+
+    for (size_t block = 0; block < BlocksPerBatch; ++block) {
+        for (size_t i = 0; i < 16; ++i) {
+            auto offset = block * BlockSize + i * sizeof(u32);
+            u32 word = ByteReader::load32(input + offset) ^ AK::convert_between_host_and_little_endian(x[i][block]);
+            ByteReader::store(output + offset, word);
+        }
+    }
+}
+
 void ChaCha20::run_cipher(ReadonlyBytes input, Bytes& output)
 {
     size_t offset = 0;
+
+    // Go through whole batches of blocks first, as long as the block counter doesn't carry over in the middle of one.
+    while (input.size() - offset >= BlocksPerBatch * BlockSize && m_state[12] <= NumericLimits<u32>::max() - BlocksPerBatch) {
+        xor_with_block_batch(input.offset_pointer(offset), output.offset_pointer(offset));
+        m_state[12] += BlocksPerBatch;
+        offset += BlocksPerBatch * BlockSize;
+    }
+
     size_t block_offset = 0;
     while (offset < input.size()) {
         if (block_offset == 0 || block_offset >= 64) {
@@ -21,8 +21,12 @@ public:
     void decrypt(ReadonlyBytes input, Bytes& output);
 
 private:
+    static constexpr size_t BlockSize = 64;
+    static constexpr size_t BlocksPerBatch = 4;
+
     void run_cipher(ReadonlyBytes input, Bytes& output);
     void generate_block();
+    void xor_with_block_batch(u8 const* input, u8* output);
     ALWAYS_INLINE void do_quarter_round(u32& a, u32& b, u32& c, u32& d);
 
     u32 m_state[16] {};
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
+#include <AK/Memory.h>
+#include <LibCrypto/Authentication/Poly1305.h>
+#include <LibCrypto/Cipher/ChaCha20.h>
+#include <LibCrypto/Cipher/ChaCha20Poly1305.h>
+
+namespace Crypto::Cipher {
+
+ChaCha20Poly1305::ChaCha20Poly1305(ReadonlyBytes key)
+{
+    VERIFY(key.size() == KeySize);
+    key.copy_to({ m_key, KeySize });
+}
+
+// https://datatracker.ietf.org/doc/html/rfc8439#section-2.8
+void ChaCha20Poly1305::compute_tag(ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes ciphertext, Bytes tag) const
+{
+    VERIFY(tag.size() == TagSize);
+
+    // The one-time Poly1305 key is the first 32 bytes of the key stream for block 0.
+    u8 one_time_key[64] {};
+    Bytes one_time_key_bytes { one_time_key, sizeof(one_time_key) };
+    ChaCha20 key_generator({ m_key, KeySize }, nonce, 0);
+    key_generator.encrypt({ one_time_key, sizeof(one_time_key) }, one_time_key_bytes);
+
+    static constexpr u8 zeros[Authentication::Poly1305::BlockSize] {};
+    auto padding_for = [](size_t size) { return (Authentication::Poly1305::BlockSize - size % Authentication::Poly1305::BlockSize) % Authentication::Poly1305::BlockSize; };
+
+    Authentication::Poly1305 mac({ one_time_key, 32 });
+    mac.update(aad);
+    mac.update({ zeros, padding_for(aad.size()) });
+    mac.update(ciphertext);
+    mac.update({ zeros, padding_for(ciphertext.size()) });
+
+    u8 lengths[16];
+    ByteReader::store(lengths, AK::convert_between_host_and_little_endian((u64)aad.size()));
+    ByteReader::store(lengths + 8, AK::convert_between_host_and_little_endian((u64)ciphertext.size()));
+    mac.update({ lengths, sizeof(lengths) });
+
+    secure_zero(one_time_key, sizeof(one_time_key));
+
+    // The digest lives in a ByteBuffer, so we won't get our tag if we run out of memory.
+    auto digest_result = mac.digest();
+    if (digest_result.is_error()) {
+        dbgln("ChaCha20Poly1305: Not enough memory to compute the tag");
+        tag.fill(0);
+        return;
+    }
+    digest_result.value().bytes().copy_to(tag);
+}
+
+void ChaCha20Poly1305::encrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, Bytes tag) const
+{
+    VERIFY(nonce.size() == NonceSize);
+    VERIFY(out.size() >= in.size());
+
+    // The plaintext is encrypted starting at block 1, block 0 is used for the Poly1305 key.
+    ChaCha20 cipher({ m_key, KeySize }, nonce, 1);
+    auto ciphertext = out.trim(in.size());
+    cipher.encrypt(in, ciphertext);
+
+    compute_tag(nonce, aad, ciphertext, tag);
+}
+
+VerificationConsistency ChaCha20Poly1305::decrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes tag) const
+{
+    VERIFY(nonce.size() == NonceSize);
+    VERIFY(out.size() >= in.size());
+
+    u8 expected_tag[TagSize];
+    compute_tag(nonce, aad, in, { expected_tag, TagSize });
+    if (tag.size() != TagSize || !timing_safe_compare(expected_tag, tag.data(), TagSize))
+        return VerificationConsistency::Inconsistent;
+
+    ChaCha20 cipher({ m_key, KeySize }, nonce, 1);
+    auto plaintext = out.trim(in.size());
+    cipher.decrypt(in, plaintext);
+    return VerificationConsistency::Consistent;
+}
+
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Verification.h>
+
+namespace Crypto::Cipher {
+
+// https://datatracker.ietf.org/doc/html/rfc8439#section-2.8
+// The AEAD construction of ChaCha20 and Poly1305, with a 256 bit key, a 96 bit nonce and a 128 bit tag.
+class ChaCha20Poly1305 {
+public:
+    static constexpr size_t KeySize = 32;
+    static constexpr size_t NonceSize = 12;
+    static constexpr size_t TagSize = 16;
+
+    explicit ChaCha20Poly1305(ReadonlyBytes key);
+
+    void encrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, Bytes tag) const;
+    VerificationConsistency decrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes tag) const;
+
+private:
+    void compute_tag(ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes ciphertext, Bytes tag) const;
+
+    u8 m_key[KeySize] {};
+};
+
+}
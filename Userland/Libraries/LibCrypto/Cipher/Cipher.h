@@ -112,6 +112,18 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) = 0;
     virtual void decrypt_block(BlockType const& in, BlockType& out) = 0;
 
+    // Encrypts a run of whole blocks. Ciphers that can work on several blocks at once should override this.
+    virtual void encrypt_blocks(ReadonlyBytes in, Bytes out)
+    {
+        VERIFY(in.size() % block_size() == 0 && out.size() >= in.size());
+        BlockType block;
+        for (size_t offset = 0; offset < in.size(); offset += block_size()) {
+            block.overwrite(in.slice(offset, block_size()));
+            encrypt_block(block, block);
+            block.bytes().copy_to(out.slice(offset));
+        }
+    }
+
 #ifndef KERNEL
     virtual String class_name() const = 0;
 #endif
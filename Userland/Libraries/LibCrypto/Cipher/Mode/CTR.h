@@ -169,7 +169,33 @@ protected:
         Bytes iv { m_ivec_storage, IV_length() };
 
         size_t offset { 0 };
-        auto block_size = cipher.block_size();
+        constexpr auto block_size = T::block_size();
+
+        // Whole batches of counter blocks are encrypted with a single call, so that ciphers which can work on several
+        // blocks at once get the chance to.
+        constexpr size_t batch_size = 8 * block_size;
+        u8 counter_blocks[batch_size];
+        u8 key_stream[batch_size];
+        while (length >= batch_size) {
+            for (size_t i = 0; i < batch_size; i += block_size) {
+                __builtin_memcpy(counter_blocks + i, iv.data(), block_size);
+                increment(iv);
+            }
+            cipher.encrypt_blocks({ counter_blocks, batch_size }, { key_stream, batch_size });
+
+            VERIFY(offset + batch_size <= out.size());
+            if (in) {
+                auto const* input = in->offset(offset);
+                auto* output = out.offset(offset);
+                for (size_t i = 0; i < batch_size; ++i)
+                    output[i] = input[i] ^ key_stream[i];
+            } else {
+                __builtin_memcpy(out.offset(offset), key_stream, batch_size);
+            }
+
+            length -= batch_size;
+            offset += batch_size;
+        }
 
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
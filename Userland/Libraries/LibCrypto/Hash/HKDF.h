@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Span.h>
+#include <LibCrypto/Authentication/HMAC.h>
+
+namespace Crypto {
+namespace Hash {
+
+// HMAC-based Extract-and-Expand Key Derivation Function, RFC 5869.
+// Any extra arguments are passed on to the hash function, so that HKDF<Manager> can pick its hash at runtime.
+template<typename HashT>
+class HKDF {
+public:
+    using HashType = HashT;
+    using DigestType = typename HashType::DigestType;
+
+    // RFC 5869 section 2.2, HKDF-Extract(salt, IKM) -> PRK
+    // An empty salt is equivalent to one made of HashLen zeros, since HMAC pads its key with zeros anyway.
+    template<typename... Args>
+    static DigestType extract(ReadonlyBytes salt, ReadonlyBytes input_keying_material, Args... args)
+    {
+        Authentication::HMAC<HashType> hmac(salt, args...);
+        return hmac.process(input_keying_material);
+    }
+
+    // RFC 5869 section 2.3, HKDF-Expand(PRK, info, L) -> OKM, with L being the size of the output.
+    template<typename... Args>
+    static ErrorOr<void> expand(ReadonlyBytes pseudorandom_key, ReadonlyBytes info, Bytes output, Args... args)
+    {
+        Authentication::HMAC<HashType> hmac(pseudorandom_key, args...);
+        auto hash_length = hmac.digest_size();
+        if (output.size() > 255 * hash_length)
+            return Error::from_string_literal("HKDF: Requested output is too long");
+
+        size_t offset = 0;
+        for (u8 counter = 1; offset < output.size(); ++counter) {
+            // T(N) = HMAC-Hash(PRK, T(N - 1) | info | N), where T(N - 1) is the block we've just written out.
+            if (counter > 1)
+                hmac.update(output.slice(offset - hash_length, hash_length));
+            hmac.update(info);
+            hmac.update(&counter, 1);
+            auto block = hmac.digest();
+
+            auto size = min(hash_length, output.size() - offset);
+            output.overwrite(offset, block.immutable_data(), size);
+            offset += size;
+        }
+        return {};
+    }
+};
+
+}
+}
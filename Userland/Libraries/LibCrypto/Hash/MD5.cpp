@@ -75,12 +75,19 @@ void MD5::update(u8 const* input, size_t length)
 }
 MD5::DigestType MD5::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 MD5::DigestType MD5::peek()
+{
+    // Finishing the hash clobbers its state, so do that on a copy to be able to keep going afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+MD5::DigestType MD5::finish()
 {
     DigestType digest;
     u8 bits[8];
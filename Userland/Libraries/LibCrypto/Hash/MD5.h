@@ -86,6 +86,7 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(u8 const*);
 
     static void encode(u32 const* from, u8* to, size_t length);
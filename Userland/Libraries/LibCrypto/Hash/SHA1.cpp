@@ -9,9 +9,97 @@
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define SHA_NI_SUPPORTED
+
+using v4si = int __attribute__((vector_size(16)));
+using v16qi = char __attribute__((vector_size(16)));
+
+static bool cpu_supports_sha_ni()
+{
+    static bool const s_supported = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & bit_SSSE3) == 0)
+            return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & bit_SHA) != 0;
+    }();
+    return s_supported;
+}
+
+// SHA1RNDS4 does four rounds at a time on ABCD (from the highest lane down), with the round function as its immediate.
+// E is only kept implicitly: SHA1NEXTE derives it from ABCD of four rounds ago and adds it to the next message words.
+// The group is always a constant, so that the indices into the words fold away once this is inlined.
+template<int round_function>
+[[gnu::target("sha,ssse3")]] static ALWAYS_INLINE void do_sha_ni_rounds(v4si& abcd, v4si& previous_abcd, v4si e, v4si (&words)[4], u8 const* data, size_t group)
+{
+    auto& current = words[group % 4];
+    if (group < 4) {
+        v16qi bytes;
+        __builtin_memcpy(&bytes, data + group * 16, sizeof(bytes));
+        v16qi const byte_swap { 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+        current = (v4si)__builtin_ia32_pshufb128(bytes, byte_swap);
+    } else {
+        current = __builtin_ia32_sha1msg1(current, words[(group + 1) % 4]) ^ words[(group + 2) % 4];
+        current = __builtin_ia32_sha1msg2(current, words[(group + 3) % 4]);
+    }
+
+    auto message = group == 0 ? e + current : __builtin_ia32_sha1nexte(previous_abcd, current);
+    previous_abcd = abcd;
+    abcd = __builtin_ia32_sha1rnds4(abcd, message, round_function);
+}
+
+[[gnu::target("sha,ssse3")]] static void transform_blocks_with_sha_ni(u32* state, u8 const* data, size_t count)
+{
+    v4si abcd { static_cast<int>(state[3]), static_cast<int>(state[2]), static_cast<int>(state[1]), static_cast<int>(state[0]) };
+    v4si e { 0, 0, 0, static_cast<int>(state[4]) };
+
+    for (size_t block = 0; block < count; ++block, data += SHA1::block_size()) {
+        auto saved_abcd = abcd;
+        v4si previous_abcd {};
+        v4si words[4];
+
+        do_sha_ni_rounds<0>(abcd, previous_abcd, e, words, data, 0);
+        do_sha_ni_rounds<0>(abcd, previous_abcd, e, words, data, 1);
+        do_sha_ni_rounds<0>(abcd, previous_abcd, e, words, data, 2);
+        do_sha_ni_rounds<0>(abcd, previous_abcd, e, words, data, 3);
+        do_sha_ni_rounds<0>(abcd, previous_abcd, e, words, data, 4);
+        do_sha_ni_rounds<1>(abcd, previous_abcd, e, words, data, 5);
+        do_sha_ni_rounds<1>(abcd, previous_abcd, e, words, data, 6);
+        do_sha_ni_rounds<1>(abcd, previous_abcd, e, words, data, 7);
+        do_sha_ni_rounds<1>(abcd, previous_abcd, e, words, data, 8);
+        do_sha_ni_rounds<1>(abcd, previous_abcd, e, words, data, 9);
+        do_sha_ni_rounds<2>(abcd, previous_abcd, e, words, data, 10);
+        do_sha_ni_rounds<2>(abcd, previous_abcd, e, words, data, 11);
+        do_sha_ni_rounds<2>(abcd, previous_abcd, e, words, data, 12);
+        do_sha_ni_rounds<2>(abcd, previous_abcd, e, words, data, 13);
+        do_sha_ni_rounds<2>(abcd, previous_abcd, e, words, data, 14);
+        do_sha_ni_rounds<3>(abcd, previous_abcd, e, words, data, 15);
+        do_sha_ni_rounds<3>(abcd, previous_abcd, e, words, data, 16);
+        do_sha_ni_rounds<3>(abcd, previous_abcd, e, words, data, 17);
+        do_sha_ni_rounds<3>(abcd, previous_abcd, e, words, data, 18);
+        do_sha_ni_rounds<3>(abcd, previous_abcd, e, words, data, 19);
+
+        e = __builtin_ia32_sha1nexte(previous_abcd, e);
+        abcd += saved_abcd;
+    }
+
+    state[0] = abcd[3];
+    state[1] = abcd[2];
+    state[2] = abcd[1];
+    state[3] = abcd[0];
+    state[4] = e[3];
+}
+#endif
+
 static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
 {
     return (value << bits) | (value >> (32 - bits));
@@ -67,26 +155,61 @@ inline void SHA1::transform(u8 const* data)
     secure_zero(blocks, 16 * sizeof(u32));
 }
 
+void SHA1::transform_blocks(u8 const* data, size_t count)
+{
+#ifdef SHA_NI_SUPPORTED
+    if (cpu_supports_sha_ni()) {
+        transform_blocks_with_sha_ni(m_state, data, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i)
+        transform(data + i * BlockSize);
+}
+
 void SHA1::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (m_data_length > 0) {
+        auto to_copy = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, to_copy);
+        m_data_length += to_copy;
+        message += to_copy;
+        length -= to_copy;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
+    }
+
+    // Whole blocks are hashed straight out of the message instead of going through the buffer.
+    auto block_count = length / BlockSize;
+    if (block_count > 0) {
+        transform_blocks(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
     }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA1::DigestType SHA1::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA1::DigestType SHA1::peek()
+{
+    // Finishing the hash clobbers its state, so do that on a copy to be able to keep going afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA1::DigestType SHA1::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
@@ -98,7 +221,7 @@ SHA1::DigestType SHA1::peek()
     __builtin_memcpy(state, m_state, 20);
 
     if (BlockSize == m_data_length) {
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
         m_data_length = 0;
         i = 0;
@@ -114,7 +237,7 @@ SHA1::DigestType SHA1::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -131,7 +254,7 @@ SHA1::DigestType SHA1::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     for (size_t i = 0; i < 4; ++i) {
         digest.data[i + 0] = (m_state[0] >> (24 - i * 8)) & 0x000000ff;
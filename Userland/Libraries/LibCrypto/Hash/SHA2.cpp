@@ -4,11 +4,119 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Endian.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#ifndef KERNEL
+#    include <AK/SIMD.h>
+
+// Without AVX, GCC warns that 32-byte vectors are passed differently. All of the functions taking them are static.
+#    pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <cpuid.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
+
+#if ARCH(X86_64) && !defined(KERNEL)
+// The kernel doesn't save vector registers for its own code, so only userspace can make use of the SHA extensions.
+#    define SHA_NI_SUPPORTED
+
+using v4si = int __attribute__((vector_size(16)));
+using v16qi = char __attribute__((vector_size(16)));
+
+static bool cpu_supports_sha_ni()
+{
+    static bool const s_supported = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & bit_SSSE3) == 0)
+            return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & bit_SHA) != 0;
+    }();
+    return s_supported;
+}
+
+// Loads four big-endian words of the message, with the first one in the lowest lane.
+[[gnu::target("ssse3")]] static ALWAYS_INLINE v4si load_big_endian_words(u8 const* data)
+{
+    v16qi bytes;
+    __builtin_memcpy(&bytes, data, sizeof(bytes));
+    v16qi const byte_swap { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 };
+    return (v4si)__builtin_ia32_pshufb128(bytes, byte_swap);
+}
+
+// SHA256RNDS2 wants the state split into ABEF and CDGH (from the highest lane down), does two rounds at a time and
+// takes the message words with their round constants already added. The message schedule for the next four words
+// is computed by SHA256MSG1 and SHA256MSG2 from the previous sixteen, that is the previous four groups of four.
+// The group is always a constant, so that the indices into the words fold away once this is inlined.
+[[gnu::target("sha,ssse3")]] static ALWAYS_INLINE void do_sha_ni_rounds(v4si& abef, v4si& cdgh, v4si (&words)[4], u8 const* data, size_t group)
+{
+    auto& current = words[group % 4];
+    if (group < 4) {
+        current = load_big_endian_words(data + group * 16);
+    } else {
+        auto const& previous = words[(group + 3) % 4];
+        auto const& before_previous = words[(group + 2) % 4];
+        v4si shifted { before_previous[1], before_previous[2], before_previous[3], previous[0] };
+        current = __builtin_ia32_sha256msg1(current, words[(group + 1) % 4]) + shifted;
+        current = __builtin_ia32_sha256msg2(current, previous);
+    }
+
+    v4si round_constants;
+    __builtin_memcpy(&round_constants, &SHA256Constants::RoundConstants[group * 4], sizeof(round_constants));
+    auto message = current + round_constants;
+    cdgh = __builtin_ia32_sha256rnds2(cdgh, abef, message);
+    message = v4si { message[2], message[3], 0, 0 };
+    abef = __builtin_ia32_sha256rnds2(abef, cdgh, message);
+}
+
+[[gnu::target("sha,ssse3")]] static void transform_blocks_with_sha_ni(u32* state, u8 const* data, size_t count)
+{
+    v4si abef { static_cast<int>(state[5]), static_cast<int>(state[4]), static_cast<int>(state[1]), static_cast<int>(state[0]) };
+    v4si cdgh { static_cast<int>(state[7]), static_cast<int>(state[6]), static_cast<int>(state[3]), static_cast<int>(state[2]) };
+
+    for (size_t block = 0; block < count; ++block, data += SHA256::block_size()) {
+        auto saved_abef = abef;
+        auto saved_cdgh = cdgh;
+        v4si words[4];
+
+        do_sha_ni_rounds(abef, cdgh, words, data, 0);
+        do_sha_ni_rounds(abef, cdgh, words, data, 1);
+        do_sha_ni_rounds(abef, cdgh, words, data, 2);
+        do_sha_ni_rounds(abef, cdgh, words, data, 3);
+        do_sha_ni_rounds(abef, cdgh, words, data, 4);
+        do_sha_ni_rounds(abef, cdgh, words, data, 5);
+        do_sha_ni_rounds(abef, cdgh, words, data, 6);
+        do_sha_ni_rounds(abef, cdgh, words, data, 7);
+        do_sha_ni_rounds(abef, cdgh, words, data, 8);
+        do_sha_ni_rounds(abef, cdgh, words, data, 9);
+        do_sha_ni_rounds(abef, cdgh, words, data, 10);
+        do_sha_ni_rounds(abef, cdgh, words, data, 11);
+        do_sha_ni_rounds(abef, cdgh, words, data, 12);
+        do_sha_ni_rounds(abef, cdgh, words, data, 13);
+        do_sha_ni_rounds(abef, cdgh, words, data, 14);
+        do_sha_ni_rounds(abef, cdgh, words, data, 15);
+
+        abef += saved_abef;
+        cdgh += saved_cdgh;
+    }
+
+    state[0] = abef[3];
+    state[1] = abef[2];
+    state[2] = cdgh[3];
+    state[3] = cdgh[2];
+    state[4] = abef[1];
+    state[5] = abef[0];
+    state[6] = cdgh[1];
+    state[7] = cdgh[0];
+}
+#endif
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
 constexpr static auto CH(u32 x, u32 y, u32 z) { return (x & y) ^ (z & ~x); }
 constexpr static auto MAJ(u32 x, u32 y, u32 z) { return (x & y) ^ (x & z) ^ (y & z); }
@@ -66,32 +174,67 @@ inline void SHA256::transform(u8 const* data)
     m_state[7] += h;
 }
 
+void SHA256::transform_blocks(u8 const* data, size_t count)
+{
+#ifdef SHA_NI_SUPPORTED
+    if (cpu_supports_sha_ni()) {
+        transform_blocks_with_sha_ni(m_state, data, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i)
+        transform(data + i * BlockSize);
+}
+
 void SHA256::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (m_data_length > 0) {
+        auto to_copy = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, to_copy);
+        m_data_length += to_copy;
+        message += to_copy;
+        length -= to_copy;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
+    }
+
+    // Whole blocks are hashed straight out of the message instead of going through the buffer.
+    auto block_count = length / BlockSize;
+    if (block_count > 0) {
+        transform_blocks(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
     }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA256::DigestType SHA256::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA256::DigestType SHA256::peek()
+{
+    // Finishing the hash clobbers its state, so do that on a copy to be able to keep going afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA256::DigestType SHA256::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
 
     if (BlockSize == m_data_length) {
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
         m_data_length = 0;
         i = 0;
@@ -107,7 +250,7 @@ SHA256::DigestType SHA256::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -124,7 +267,7 @@ SHA256::DigestType SHA256::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
@@ -142,6 +285,167 @@ SHA256::DigestType SHA256::peek()
     return digest;
 }
 
+#ifndef KERNEL
+using AK::SIMD::u32x8;
+
+static constexpr size_t MultiBufferLaneCount = 8;
+
+static ALWAYS_INLINE u32x8 ROTRIGHT(u32x8 a, size_t b) { return (a >> b) | (a << (32 - b)); }
+static ALWAYS_INLINE u32x8 CH(u32x8 x, u32x8 y, u32x8 z) { return (x & y) ^ (z & ~x); }
+static ALWAYS_INLINE u32x8 MAJ(u32x8 x, u32x8 y, u32x8 z) { return (x & y) ^ (x & z) ^ (y & z); }
+static ALWAYS_INLINE u32x8 EP0(u32x8 x) { return ROTRIGHT(x, 2) ^ ROTRIGHT(x, 13) ^ ROTRIGHT(x, 22); }
+static ALWAYS_INLINE u32x8 EP1(u32x8 x) { return ROTRIGHT(x, 6) ^ ROTRIGHT(x, 11) ^ ROTRIGHT(x, 25); }
+static ALWAYS_INLINE u32x8 SIGN0(u32x8 x) { return ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ (x >> 3); }
+static ALWAYS_INLINE u32x8 SIGN1(u32x8 x) { return ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ (x >> 10); }
+
+// This is the regular compression function, except that every lane works on a block of its own.
+static ALWAYS_INLINE void transform_lanes(u32x8 (&state)[8], u8 const* const (&blocks)[MultiBufferLaneCount])
+{
+    u32x8 m[64];
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t lane = 0; lane < MultiBufferLaneCount; ++lane) {
+            u32 word;
+            __builtin_memcpy(&word, blocks[lane] + i * 4, sizeof(word));
+            m[i][lane] = AK::convert_between_host_and_network_endian(word);
+        }
+    }
+
+    for (size_t i = 16; i < 64; ++i)
+        m[i] = SIGN1(m[i - 2]) + m[i - 7] + SIGN0(m[i - 15]) + m[i - 16];
+
+    auto a = state[0], b = state[1],
+         c = state[2], d = state[3],
+         e = state[4], f = state[5],
+         g = state[6], h = state[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+        auto temp0 = h + EP1(e) + CH(e, f, g) + SHA256Constants::RoundConstants[i] + m[i];
+        auto temp1 = EP0(a) + MAJ(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp0;
+        d = c;
+        c = b;
+        b = a;
+        a = temp0 + temp1;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+// Every lane runs through as many blocks as the longest message needs. Once a shorter message is done, its lane keeps
+// computing, but the results are masked out of its state.
+static ALWAYS_INLINE void hash_lanes(Span<ReadonlyBytes const> messages, Span<SHA256::DigestType> digests)
+{
+    VERIFY(messages.size() <= MultiBufferLaneCount);
+
+    // The padding and the length can take up to two blocks at the end of each message.
+    u8 tails[MultiBufferLaneCount][2 * SHA256::BlockSize] {};
+    size_t full_block_counts[MultiBufferLaneCount] {};
+    size_t block_counts[MultiBufferLaneCount] {};
+    size_t max_block_count = 0;
+    for (size_t lane = 0; lane < messages.size(); ++lane) {
+        auto message = messages[lane];
+        full_block_counts[lane] = message.size() / SHA256::BlockSize;
+        block_counts[lane] = (message.size() + 8) / SHA256::BlockSize + 1;
+        max_block_count = max(max_block_count, block_counts[lane]);
+
+        auto tail = message.slice(full_block_counts[lane] * SHA256::BlockSize);
+        auto tail_size = (block_counts[lane] - full_block_counts[lane]) * SHA256::BlockSize;
+        __builtin_memcpy(tails[lane], tail.data(), tail.size());
+        tails[lane][tail.size()] = 0x80;
+        u64 bit_length = static_cast<u64>(message.size()) * 8;
+        for (size_t i = 0; i < 8; ++i)
+            tails[lane][tail_size - 1 - i] = bit_length >> (i * 8);
+    }
+
+    u32x8 state[8];
+    for (size_t i = 0; i < 8; ++i)
+        state[i] = u32x8 {} + SHA256Constants::InitializationHashes[i];
+
+    for (size_t block = 0; block < max_block_count; ++block) {
+        u8 const* blocks[MultiBufferLaneCount];
+        u32x8 active {};
+        for (size_t lane = 0; lane < MultiBufferLaneCount; ++lane) {
+            if (block < full_block_counts[lane])
+                blocks[lane] = messages[lane].offset(block * SHA256::BlockSize);
+            else if (block < block_counts[lane])
+                blocks[lane] = tails[lane] + (block - full_block_counts[lane]) * SHA256::BlockSize;
+            else
+                blocks[lane] = tails[lane];
+            active[lane] = block < block_counts[lane] ? NumericLimits<u32>::max() : 0;
+        }
+
+        u32x8 new_state[8];
+        __builtin_memcpy(new_state, state, sizeof(state));
+        transform_lanes(new_state, blocks);
+        for (size_t i = 0; i < 8; ++i)
+            state[i] = (new_state[i] & active) | (state[i] & ~active);
+    }
+
+    for (size_t lane = 0; lane < messages.size(); ++lane) {
+        for (size_t i = 0; i < 8; ++i) {
+            u32 word = AK::convert_between_host_and_network_endian(static_cast<u32>(state[i][lane]));
+            __builtin_memcpy(digests[lane].data + i * 4, &word, sizeof(word));
+        }
+    }
+}
+
+#    if ARCH(X86_64)
+static bool cpu_supports_avx2()
+{
+    static bool const s_supported = [] {
+        u32 eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (ecx & bit_OSXSAVE) == 0 || (ecx & bit_AVX) == 0)
+            return false;
+        // The kernel has to save the upper halves of the YMM registers as well.
+        u32 xcr0_low, xcr0_high;
+        asm("xgetbv"
+            : "=a"(xcr0_low), "=d"(xcr0_high)
+            : "c"(0));
+        if ((xcr0_low & 0b110) != 0b110)
+            return false;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (ebx & bit_AVX2) != 0;
+    }();
+    return s_supported;
+}
+
+// The baseline only has SSE2, so the eight lanes are processed as two halves, unless we can use AVX2.
+[[gnu::target("avx2")]] static void hash_lanes_with_avx2(Span<ReadonlyBytes const> messages, Span<SHA256::DigestType> digests)
+{
+    hash_lanes(messages, digests);
+}
+#    endif
+
+void SHA256::hash_many(Span<ReadonlyBytes const> messages, Span<DigestType> digests)
+{
+    VERIFY(digests.size() >= messages.size());
+
+    for (size_t first = 0; first < messages.size(); first += MultiBufferLaneCount) {
+        auto count = min(MultiBufferLaneCount, messages.size() - first);
+        auto lane_messages = messages.slice(first, count);
+        auto lane_digests = digests.slice(first, count);
+#    if ARCH(X86_64)
+        if (cpu_supports_avx2()) {
+            hash_lanes_with_avx2(lane_messages, lane_digests);
+            continue;
+        }
+#    endif
+        hash_lanes(lane_messages, lane_digests);
+    }
+}
+#endif
+
 inline void SHA384::transform(u8 const* data)
 {
     u64 m[80];
@@ -184,32 +488,61 @@ inline void SHA384::transform(u8 const* data)
     m_state[7] += h;
 }
 
+void SHA384::transform_blocks(u8 const* data, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        transform(data + i * BlockSize);
+}
+
 void SHA384::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 1024;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (m_data_length > 0) {
+        auto to_copy = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, to_copy);
+        m_data_length += to_copy;
+        message += to_copy;
+        length -= to_copy;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
+    }
+
+    // Whole blocks are hashed straight out of the message instead of going through the buffer.
+    auto block_count = length / BlockSize;
+    if (block_count > 0) {
+        transform_blocks(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
     }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA384::DigestType SHA384::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA384::DigestType SHA384::peek()
+{
+    // Finishing the hash clobbers its state, so do that on a copy to be able to keep going afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA384::DigestType SHA384::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
 
     if (BlockSize == m_data_length) {
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
         m_data_length = 0;
         i = 0;
@@ -225,7 +558,7 @@ SHA384::DigestType SHA384::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -251,7 +584,7 @@ SHA384::DigestType SHA384::peek()
     m_data_buffer[BlockSize - 15] = 0;
     m_data_buffer[BlockSize - 16] = 0;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
@@ -308,32 +641,61 @@ inline void SHA512::transform(u8 const* data)
     m_state[7] += h;
 }
 
+void SHA512::transform_blocks(u8 const* data, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        transform(data + i * BlockSize);
+}
+
 void SHA512::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 1024;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (m_data_length > 0) {
+        auto to_copy = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, to_copy);
+        m_data_length += to_copy;
+        message += to_copy;
+        length -= to_copy;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
     }
+
+    // Whole blocks are hashed straight out of the message instead of going through the buffer.
+    auto block_count = length / BlockSize;
+    if (block_count > 0) {
+        transform_blocks(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA512::DigestType SHA512::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA512::DigestType SHA512::peek()
+{
+    // Finishing the hash clobbers its state, so do that on a copy to be able to keep going afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA512::DigestType SHA512::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
 
     if (BlockSize == m_data_length) {
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
         m_data_length = 0;
         i = 0;
@@ -349,7 +711,7 @@ SHA512::DigestType SHA512::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -375,7 +737,7 @@ SHA512::DigestType SHA512::peek()
     m_data_buffer[BlockSize - 15] = 0;
     m_data_buffer[BlockSize - 16] = 0;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
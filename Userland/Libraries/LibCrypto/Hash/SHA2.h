@@ -101,6 +101,10 @@ public:
     inline static DigestType hash(StringView buffer) { return hash((u8 const*)buffer.characters_without_null_termination(), buffer.length()); }
 
 #ifndef KERNEL
+    // Hashes every message into the digest at the same index. Up to eight messages at a time are hashed side by side,
+    // each in its own vector lane, which is much faster than one after the other when there are lots of them.
+    static void hash_many(Span<ReadonlyBytes const> messages, Span<DigestType> digests);
+
     virtual String class_name() const override
     {
         return String::formatted("SHA{}", DigestSize * 8);
@@ -116,7 +120,9 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(u8 const*);
+    void transform_blocks(u8 const*, size_t count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -168,7 +174,9 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(u8 const*);
+    void transform_blocks(u8 const*, size_t count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -220,7 +228,9 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(u8 const*);
+    void transform_blocks(u8 const*, size_t count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -51,10 +51,14 @@ static size_t s_allocated_tls_block_size = 0;
 static char** s_envp = nullptr;
 static LibCExitFunction s_libc_exit = nullptr;
 static __pthread_mutex_t s_loader_lock = __PTHREAD_MUTEX_INITIALIZER;
+// Lazily bound PLT entries are resolved without holding s_loader_lock, possibly while another thread is in dlopen().
+// This protects s_global_objects against those lookups.
+static __pthread_mutex_t s_global_objects_lock = __PTHREAD_MUTEX_INITIALIZER;
 static String s_cwd;
 
 static bool s_allowed_to_check_environment_variables { false };
 static bool s_do_breakpoint_trap_before_entry { false };
+static bool s_bind_now { false };
 static StringView s_ld_library_path;
 static StringView s_main_program_pledge_promises;
 static String s_loader_pledge_promises;
@@ -70,6 +74,9 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
 
     auto symbol = DynamicObject::HashSymbol { name };
 
+    pthread_mutex_lock(&s_global_objects_lock);
+    ScopeGuard unlock_guard = [] { pthread_mutex_unlock(&s_global_objects_lock); };
+
     for (auto& lib : s_global_objects) {
         auto res = lib.value->lookup_symbol(symbol);
         if (!res.has_value())
@@ -83,6 +90,13 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
     return weak_result;
 }
 
+static void set_global_object(String const& filepath, NonnullRefPtr<DynamicObject> object)
+{
+    pthread_mutex_lock(&s_global_objects_lock);
+    s_global_objects.set(filepath, move(object));
+    pthread_mutex_unlock(&s_global_objects_lock);
+}
+
 static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(String const& filepath, int fd)
 {
     VERIFY(filepath.starts_with('/'));
@@ -98,7 +112,7 @@ static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(String c
 
     // This actually maps the library at the intended and final place.
     auto main_library_object = loader->map();
-    s_global_objects.set(filepath, *main_library_object);
+    set_global_object(filepath, *main_library_object);
 
     return loader;
 }
@@ -370,7 +384,7 @@ static Result<void, DlErrorMessage> link_main_library(String const& path, int fl
     for (auto& loader : loaders) {
         auto dynamic_object = loader.map();
         if (dynamic_object)
-            s_global_objects.set(dynamic_object->filepath(), *dynamic_object);
+            set_global_object(dynamic_object->filepath(), *dynamic_object);
     }
 
     for (auto& loader : loaders) {
@@ -454,9 +468,13 @@ static Optional<DlErrorMessage> verify_tls_for_dlopen(DynamicLoader const& loade
 
 static Result<void*, DlErrorMessage> __dlopen(char const* filename, int flags)
 {
-    // FIXME: RTLD_NOW and RTLD_LOCAL are not supported
-    flags &= ~RTLD_NOW;
-    flags |= RTLD_LAZY;
+    // FIXME: RTLD_LOCAL is not supported
+    if (s_bind_now)
+        flags |= RTLD_NOW;
+    if (flags & RTLD_NOW)
+        flags &= ~RTLD_LAZY;
+    else
+        flags |= RTLD_LAZY;
     flags &= ~RTLD_LOCAL;
     flags |= RTLD_GLOBAL;
 
@@ -577,6 +595,12 @@ static void read_environment_variables()
             s_do_breakpoint_trap_before_entry = true;
         }
 
+        // Like other loaders, any non-empty value makes us resolve all PLT entries before running the program.
+        constexpr auto bind_now_string = "LD_BIND_NOW="sv;
+        if (env_string.starts_with(bind_now_string) && env_string.length() > bind_now_string.length()) {
+            s_bind_now = true;
+        }
+
         constexpr auto library_path_string = "LD_LIBRARY_PATH="sv;
         if (env_string.starts_with(library_path_string)) {
             s_ld_library_path = env_string.substring_view(library_path_string.length());
@@ -635,7 +659,7 @@ void ELF::DynamicLinker::linker_main(String&& main_program_path, int main_progra
     allocate_tls();
 
     auto entry_point_function = [&main_program_path] {
-        auto result = link_main_library(main_program_path, RTLD_GLOBAL | RTLD_LAZY);
+        auto result = link_main_library(main_program_path, RTLD_GLOBAL | (s_bind_now ? RTLD_NOW : RTLD_LAZY));
         if (result.is_error()) {
             warnln("{}", result.error().text);
             _exit(1);
@@ -10,6 +10,7 @@
 #include <AK/Debug.h>
 #include <AK/Optional.h>
 #include <AK/QuickSort.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibELF/DynamicLinker.h>
 #include <LibELF/DynamicLoader.h>
@@ -166,6 +167,9 @@ bool DynamicLoader::load_stage_2(unsigned flags)
 {
     VERIFY(flags & RTLD_GLOBAL);
 
+    // Without a PLT trampoline (see load_stage_3), the PLT entries have to be resolved right away.
+    m_bind_now = m_dynamic_object->must_bind_now() || !(flags & RTLD_LAZY);
+
     if (m_dynamic_object->has_text_relocations()) {
         dbgln("\033[33mWarning:\033[0m Dynamic object {} has text relocations", m_dynamic_object->filepath());
         for (auto& text_segment : m_text_segments) {
@@ -213,6 +217,11 @@ void DynamicLoader::do_main_relocations()
         }
     };
 
+    // Many relocations refer to the same symbol (think vtables and typeinfo), so remember what each symbol
+    // resolved to instead of searching all global objects again. Symbols that we couldn't find aren't cached,
+    // the objects that define them might not be loaded yet.
+    ScopeGuard clear_cache = [this] { m_symbol_lookup_cache.clear(); };
+
     do_relr_relocations();
     m_dynamic_object->relocation_section().for_each_relocation(do_single_relocation);
     m_dynamic_object->plt_relocation_section().for_each_relocation(do_single_relocation);
@@ -261,6 +270,8 @@ void DynamicLoader::load_stage_4()
 
 void DynamicLoader::do_lazy_relocations()
 {
+    ScopeGuard clear_cache = [this] { m_symbol_lookup_cache.clear(); };
+
     for (auto const& relocation : m_unresolved_relocations) {
         if (auto res = do_relocation(relocation, ShouldInitializeWeak::Yes); res != RelocationResult::Success) {
             dbgln("Loader.so: {} unresolved symbol '{}'", m_filepath, relocation.symbol().name());
@@ -492,7 +503,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
     case R_X86_64_64: {
 #endif
         auto symbol = relocation.symbol();
-        auto res = lookup_symbol(symbol);
+        auto res = lookup_symbol_for(relocation);
         if (!res.has_value()) {
             if (symbol.bind() == STB_WEAK)
                 return RelocationResult::ResolveLater;
@@ -511,7 +522,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
 #if ARCH(I386)
     case R_386_PC32: {
         auto symbol = relocation.symbol();
-        auto result = lookup_symbol(symbol);
+        auto result = lookup_symbol_for(relocation);
         if (!result.has_value())
             return RelocationResult::Failed;
         auto relative_offset = result.value().address - m_dynamic_object->base_address().offset(relocation.offset());
@@ -523,7 +534,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
     case R_X86_64_GLOB_DAT: {
 #endif
         auto symbol = relocation.symbol();
-        auto res = lookup_symbol(symbol);
+        auto res = lookup_symbol_for(relocation);
         VirtualAddress symbol_location;
         if (!res.has_value()) {
             if (symbol.bind() == STB_WEAK) {
@@ -575,7 +586,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
         FlatPtr symbol_value;
         DynamicObject const* dynamic_object_of_symbol;
         if (relocation.symbol_index() != 0) {
-            auto res = lookup_symbol(symbol);
+            auto res = lookup_symbol_for(relocation);
             if (!res.has_value())
                 break;
             VERIFY(symbol.type() != STT_GNU_IFUNC);
@@ -600,8 +611,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
 #else
     case R_X86_64_JUMP_SLOT: {
 #endif
-        // FIXME: Or BIND_NOW flag passed in?
-        if (m_dynamic_object->must_bind_now()) {
+        if (m_bind_now) {
             // Eagerly BIND_NOW the PLT entries, doing all the symbol looking goodness
             // The patch method returns the address for the LAZY fixup path, but we don't need it here
             m_dynamic_object->patch_plt_entry(relocation.offset_in_section());
@@ -718,6 +728,18 @@ void DynamicLoader::call_object_init_functions()
     }
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol_for(DynamicObject::Relocation const& relocation)
+{
+    auto symbol_index = relocation.symbol_index();
+    if (auto it = m_symbol_lookup_cache.find(symbol_index); it != m_symbol_lookup_cache.end())
+        return it->value;
+
+    auto result = lookup_symbol(relocation.symbol());
+    if (result.has_value())
+        m_symbol_lookup_cache.set(symbol_index, result.value());
+    return result;
+}
+
 Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol(const ELF::DynamicObject::Symbol& symbol)
 {
     if (symbol.is_undefined() || symbol.bind() == STB_WEAK)
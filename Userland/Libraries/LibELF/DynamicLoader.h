@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/Assertions.h>
+#include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/String.h>
@@ -134,6 +135,7 @@ private:
         ResolveLater = 2,
     };
     RelocationResult do_relocation(DynamicObject::Relocation const&, ShouldInitializeWeak should_initialize_weak);
+    Optional<DynamicObject::SymbolLookupResult> lookup_symbol_for(DynamicObject::Relocation const&);
     void do_relr_relocations();
     void find_tls_size_and_alignment();
 
@@ -160,6 +162,10 @@ private:
 
     Vector<DynamicObject::Relocation> m_unresolved_relocations;
 
+    // Only populated while relocating, keyed by symbol index.
+    HashMap<unsigned, DynamicObject::SymbolLookupResult> m_symbol_lookup_cache;
+    bool m_bind_now { false };
+
     mutable RefPtr<DynamicObject> m_cached_dynamic_object;
 
     bool m_fully_relocated { false };
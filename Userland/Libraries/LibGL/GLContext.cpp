@@ -134,10 +134,15 @@ void GLContext::gl_end()
     RETURN_WITH_ERROR_IF(!m_in_draw_state, GL_INVALID_OPERATION);
     m_in_draw_state = false;
 
+    draw_vertex_list(m_current_draw_mode);
+}
+
+void GLContext::draw_vertex_list(GLenum draw_mode)
+{
     sync_device_config();
 
     GPU::PrimitiveType primitive_type;
-    switch (m_current_draw_mode) {
+    switch (draw_mode) {
     case GL_LINE_LOOP:
         primitive_type = GPU::PrimitiveType::LineLoop;
         break;
@@ -397,6 +397,23 @@ private:
     bool m_sampler_config_is_dirty { true };
     bool m_light_state_is_dirty { true };
 
+    // A glBegin()/glEnd() pair from a display list, with all vertices it specified already built. Attributes that were
+    // not set inside the pair before a vertex was specified are taken from the current state when the list is called.
+    struct CompiledPrimitive {
+        GLenum draw_mode { GL_TRIANGLES };
+        Vector<GPU::Vertex> vertices;
+        size_t vertices_using_current_color { 0 };
+        size_t vertices_using_current_normal { 0 };
+        Array<size_t, GPU::NUM_TEXTURE_UNITS> vertices_using_current_tex_coord {};
+        Optional<FloatVector4> final_color;
+        Optional<FloatVector3> final_normal;
+        Array<Optional<FloatVector4>, GPU::NUM_TEXTURE_UNITS> final_tex_coord;
+    };
+
+    void draw_compiled_primitive(size_t listing_index, size_t primitive_index);
+    void draw_vertex_list(GLenum draw_mode);
+    void read_vertex_from_client_arrays(int index);
+
     struct Listing {
 
         template<typename F>
@@ -485,12 +502,14 @@ private:
             decltype(&GLContext::gl_get_light),
             decltype(&GLContext::gl_clip_plane),
             decltype(&GLContext::gl_copy_tex_sub_image_2d),
-            decltype(&GLContext::gl_point_size)>;
+            decltype(&GLContext::gl_point_size),
+            decltype(&GLContext::draw_compiled_primitive)>;
 
         using ExtraSavedArguments = Variant<
             FloatMatrix4x4>;
 
         Vector<NonnullOwnPtr<ExtraSavedArguments>> saved_arguments;
+        Vector<CompiledPrimitive> compiled_primitives;
         Vector<FunctionsAndArgs> entries;
     };
 
@@ -505,6 +524,9 @@ private:
     };
     Optional<CurrentListing> m_current_listing_index;
 
+    void compile_listing(Listing&, size_t listing_index);
+    Optional<CompiledPrimitive> compile_primitive(Span<Listing::FunctionsAndArgs const> entries, size_t& entry_count) const;
+
     VertexAttribPointer m_client_vertex_pointer;
     VertexAttribPointer m_client_color_pointer;
     Vector<VertexAttribPointer> m_client_tex_coord_pointer;
@@ -95,8 +95,10 @@ void GLContext::gl_delete_lists(GLuint list, GLsizei range)
     if (m_listings.size() < list || m_listings.size() <= list + range)
         return;
 
-    for (auto& entry : m_listings.span().slice(list - 1, range))
+    for (auto& entry : m_listings.span().slice(list - 1, range)) {
         entry.entries.clear_with_capacity();
+        entry.compiled_primitives.clear_with_capacity();
+    }
 }
 
 void GLContext::gl_end_list()
@@ -104,6 +106,7 @@ void GLContext::gl_end_list()
     RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
     RETURN_WITH_ERROR_IF(!m_current_listing_index.has_value(), GL_INVALID_OPERATION);
 
+    compile_listing(m_current_listing_index->listing, m_current_listing_index->index);
     m_listings[m_current_listing_index->index] = move(m_current_listing_index->listing);
     m_current_listing_index.clear();
 }
@@ -164,4 +167,143 @@ void GLContext::invoke_list(size_t list_index)
     }
 }
 
+void GLContext::compile_listing(Listing& listing, size_t listing_index)
+{
+    Vector<Listing::FunctionsAndArgs> entries;
+    entries.ensure_capacity(listing.entries.size());
+
+    for (size_t i = 0; i < listing.entries.size();) {
+        size_t entry_count = 0;
+        auto compiled_primitive = compile_primitive(listing.entries.span().slice(i), entry_count);
+        if (!compiled_primitive.has_value()) {
+            entries.append(move(listing.entries[i++]));
+            continue;
+        }
+
+        entries.empend(&GLContext::draw_compiled_primitive, Listing::ArgumentsFor<&GLContext::draw_compiled_primitive> { listing_index, listing.compiled_primitives.size() });
+        listing.compiled_primitives.append(compiled_primitive.release_value());
+        i += entry_count;
+    }
+
+    listing.entries = move(entries);
+}
+
+Optional<GLContext::CompiledPrimitive> GLContext::compile_primitive(Span<Listing::FunctionsAndArgs const> entries, size_t& entry_count) const
+{
+    auto is_call_to = [](auto const& entry, auto member) {
+        return entry.function.visit([&](auto function) {
+            if constexpr (IsSame<decltype(function), decltype(member)>)
+                return function == member;
+            else
+                return false;
+        });
+    };
+    auto arguments_of = [](auto const& entry, auto member) -> auto const& {
+        return entry.arguments.template get<Listing::TupleTypeForArgumentListOf<decltype(member)>>();
+    };
+
+    if (entries.is_empty() || !is_call_to(entries[0], &GLContext::gl_begin))
+        return {};
+    auto draw_mode = arguments_of(entries[0], &GLContext::gl_begin).get<0>();
+    if (draw_mode > GL_POLYGON)
+        return {};
+
+    // Only pairs that contain nothing but vertex attributes and vertices are compiled, everything else is replayed
+    // call by call as before.
+    CompiledPrimitive primitive;
+    primitive.draw_mode = draw_mode;
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+        auto const& entry = entries[i];
+
+        if (is_call_to(entry, &GLContext::gl_end)) {
+            entry_count = i + 1;
+            return primitive;
+        }
+
+        if (is_call_to(entry, &GLContext::gl_vertex)) {
+            auto const& arguments = arguments_of(entry, &GLContext::gl_vertex);
+            GPU::Vertex vertex;
+            vertex.position = {
+                static_cast<float>(arguments.get<0>()),
+                static_cast<float>(arguments.get<1>()),
+                static_cast<float>(arguments.get<2>()),
+                static_cast<float>(arguments.get<3>()),
+            };
+
+            auto vertex_count = primitive.vertices.size() + 1;
+            if (primitive.final_color.has_value())
+                vertex.color = primitive.final_color.value();
+            else
+                primitive.vertices_using_current_color = vertex_count;
+            if (primitive.final_normal.has_value())
+                vertex.normal = primitive.final_normal.value();
+            else
+                primitive.vertices_using_current_normal = vertex_count;
+            for (size_t t = 0; t < m_device_info.num_texture_units; ++t) {
+                if (primitive.final_tex_coord[t].has_value())
+                    vertex.tex_coords[t] = primitive.final_tex_coord[t].value();
+                else
+                    primitive.vertices_using_current_tex_coord[t] = vertex_count;
+            }
+
+            primitive.vertices.append(vertex);
+        } else if (is_call_to(entry, &GLContext::gl_color)) {
+            auto const& arguments = arguments_of(entry, &GLContext::gl_color);
+            primitive.final_color = FloatVector4 {
+                static_cast<float>(arguments.get<0>()),
+                static_cast<float>(arguments.get<1>()),
+                static_cast<float>(arguments.get<2>()),
+                static_cast<float>(arguments.get<3>()),
+            };
+        } else if (is_call_to(entry, &GLContext::gl_normal)) {
+            auto const& arguments = arguments_of(entry, &GLContext::gl_normal);
+            primitive.final_normal = FloatVector3 { arguments.get<0>(), arguments.get<1>(), arguments.get<2>() };
+        } else if (is_call_to(entry, &GLContext::gl_tex_coord)) {
+            auto const& arguments = arguments_of(entry, &GLContext::gl_tex_coord);
+            primitive.final_tex_coord[0] = FloatVector4 { arguments.get<0>(), arguments.get<1>(), arguments.get<2>(), arguments.get<3>() };
+        } else if (is_call_to(entry, &GLContext::gl_multi_tex_coord)) {
+            auto const& arguments = arguments_of(entry, &GLContext::gl_multi_tex_coord);
+            auto target = arguments.get<0>();
+            if (target < GL_TEXTURE0 || target >= GL_TEXTURE0 + m_device_info.num_texture_units)
+                return {};
+            primitive.final_tex_coord[target - GL_TEXTURE0] = FloatVector4 { arguments.get<1>(), arguments.get<2>(), arguments.get<3>(), arguments.get<4>() };
+        } else {
+            return {};
+        }
+    }
+
+    return {};
+}
+
+void GLContext::draw_compiled_primitive(size_t listing_index, size_t primitive_index)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    auto const& primitive = m_listings[listing_index].compiled_primitives[primitive_index];
+
+    VERIFY(m_vertex_list.is_empty());
+    m_vertex_list.extend(primitive.vertices);
+
+    for (size_t i = 0; i < primitive.vertices_using_current_color; ++i)
+        m_vertex_list[i].color = m_current_vertex_color;
+    for (size_t i = 0; i < primitive.vertices_using_current_normal; ++i)
+        m_vertex_list[i].normal = m_current_vertex_normal;
+    for (size_t t = 0; t < m_device_info.num_texture_units; ++t) {
+        for (size_t i = 0; i < primitive.vertices_using_current_tex_coord[t]; ++i)
+            m_vertex_list[i].tex_coords[t] = m_current_vertex_tex_coord[t];
+    }
+
+    if (primitive.final_color.has_value())
+        m_current_vertex_color = primitive.final_color.value();
+    if (primitive.final_normal.has_value())
+        m_current_vertex_normal = primitive.final_normal.value();
+    for (size_t t = 0; t < m_device_info.num_texture_units; ++t) {
+        if (primitive.final_tex_coord[t].has_value())
+            m_current_vertex_tex_coord[t] = primitive.final_tex_coord[t].value();
+    }
+
+    draw_vertex_list(primitive.draw_mode);
+}
+
 }
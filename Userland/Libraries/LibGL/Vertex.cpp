@@ -124,6 +124,7 @@ void GLContext::gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
 {
     // NOTE: This always dereferences data; display list support is deferred to the
     //       individual vertex attribute calls such as `gl_color`, `gl_normal` etc.
+    //       Outside of display lists, vertices are read from the client arrays directly.
     RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
 
     // FIXME: Some modes are still missing (GL_POINTS, GL_LINE_STRIP, GL_LINE_LOOP, GL_LINES)
@@ -140,31 +141,10 @@ void GLContext::gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
     auto last = first + count;
     gl_begin(mode);
     for (int i = first; i < last; i++) {
-        if (m_client_side_color_array_enabled) {
-            float color[4] { 0.f, 0.f, 0.f, 1.f };
-            read_from_vertex_attribute_pointer(m_client_color_pointer, i, color);
-            gl_color(color[0], color[1], color[2], color[3]);
-        }
-
-        for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
-            if (m_client_side_texture_coord_array_enabled[t]) {
-                float tex_coords[4] { 0.f, 0.f, 0.f, 1.f };
-                read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], i, tex_coords);
-                gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
-            }
-        }
-
-        if (m_client_side_normal_array_enabled) {
-            float normal[3];
-            read_from_vertex_attribute_pointer(m_client_normal_pointer, i, normal);
-            gl_normal(normal[0], normal[1], normal[2]);
-        }
-
-        if (m_client_side_vertex_array_enabled) {
-            float vertex[4] { 0.f, 0.f, 0.f, 1.f };
-            read_from_vertex_attribute_pointer(m_client_vertex_pointer, i, vertex);
-            gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
-        }
+        if (should_append_to_listing())
+            gl_array_element(i);
+        else
+            read_vertex_from_client_arrays(i);
     }
     gl_end();
 }
@@ -173,6 +153,7 @@ void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, void c
 {
     // NOTE: This always dereferences data; display list support is deferred to the
     //       individual vertex attribute calls such as `gl_color`, `gl_normal` etc.
+    //       Outside of display lists, vertices are read from the client arrays directly.
     RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
 
     // FIXME: Some modes are still missing (GL_POINTS, GL_LINE_STRIP, GL_LINE_LOOP, GL_LINES)
@@ -206,31 +187,10 @@ void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, void c
             break;
         }
 
-        if (m_client_side_color_array_enabled) {
-            float color[4] { 0.f, 0.f, 0.f, 1.f };
-            read_from_vertex_attribute_pointer(m_client_color_pointer, i, color);
-            gl_color(color[0], color[1], color[2], color[3]);
-        }
-
-        for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
-            if (m_client_side_texture_coord_array_enabled[t]) {
-                float tex_coords[4] { 0.f, 0.f, 0.f, 1.f };
-                read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], i, tex_coords);
-                gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
-            }
-        }
-
-        if (m_client_side_normal_array_enabled) {
-            float normal[3];
-            read_from_vertex_attribute_pointer(m_client_normal_pointer, i, normal);
-            gl_normal(normal[0], normal[1], normal[2]);
-        }
-
-        if (m_client_side_vertex_array_enabled) {
-            float vertex[4] { 0.f, 0.f, 0.f, 1.f };
-            read_from_vertex_attribute_pointer(m_client_vertex_pointer, i, vertex);
-            gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
-        }
+        if (should_append_to_listing())
+            gl_array_element(i);
+        else
+            read_vertex_from_client_arrays(i);
     }
     gl_end();
 }
@@ -282,6 +242,44 @@ void GLContext::gl_vertex(GLdouble x, GLdouble y, GLdouble z, GLdouble w)
     m_vertex_list.append(vertex);
 }
 
+void GLContext::read_vertex_from_client_arrays(int index)
+{
+    if (m_client_side_color_array_enabled) {
+        float color[4] { 0.f, 0.f, 0.f, 1.f };
+        read_from_vertex_attribute_pointer(m_client_color_pointer, index, color);
+        m_current_vertex_color = { color[0], color[1], color[2], color[3] };
+    }
+
+    for (size_t t = 0; t < m_device_info.num_texture_units; ++t) {
+        if (m_client_side_texture_coord_array_enabled[t]) {
+            float tex_coords[4] { 0.f, 0.f, 0.f, 1.f };
+            read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], index, tex_coords);
+            m_current_vertex_tex_coord[t] = { tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3] };
+        }
+    }
+
+    if (m_client_side_normal_array_enabled) {
+        float normal[3];
+        read_from_vertex_attribute_pointer(m_client_normal_pointer, index, normal);
+        m_current_vertex_normal = { normal[0], normal[1], normal[2] };
+    }
+
+    if (!m_client_side_vertex_array_enabled)
+        return;
+
+    float position[4] { 0.f, 0.f, 0.f, 1.f };
+    read_from_vertex_attribute_pointer(m_client_vertex_pointer, index, position);
+
+    GPU::Vertex vertex;
+    vertex.position = { position[0], position[1], position[2], position[3] };
+    vertex.color = m_current_vertex_color;
+    for (size_t t = 0; t < m_device_info.num_texture_units; ++t)
+        vertex.tex_coords[t] = m_current_vertex_tex_coord[t];
+    vertex.normal = m_current_vertex_normal;
+
+    m_vertex_list.append(vertex);
+}
+
 void GLContext::gl_vertex_pointer(GLint size, GLenum type, GLsizei stride, void const* pointer)
 {
     RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
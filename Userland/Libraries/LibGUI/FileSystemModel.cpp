@@ -11,13 +11,17 @@
 #include <AK/QuickSort.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/DirIterator.h>
+#include <LibCore/Directory.h>
 #include <LibCore/File.h>
 #include <LibCore/StandardPaths.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
 #include <LibGUI/AbstractView.h>
 #include <LibGUI/FileIconProvider.h>
 #include <LibGUI/FileSystemModel.h>
 #include <LibGUI/Painter.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/PNGWriter.h>
 #include <LibThreading/BackgroundAction.h>
 #include <grp.h>
 #include <pwd.h>
@@ -631,6 +635,21 @@ Icon FileSystemModel::icon_for(Node const& node) const
 
 static HashMap<String, RefPtr<Gfx::Bitmap>> s_thumbnail_cache;
 
+struct ThumbnailRequest {
+    String path;
+    String cache_path;
+    WeakPtr<FileSystemModel> model;
+};
+static Vector<ThumbnailRequest> s_pending_thumbnail_requests;
+static bool s_is_rendering_thumbnail { false };
+
+// Thumbnails are kept on disk too, so that other processes and later runs don't have to decode the images again.
+static String thumbnail_cache_path_for(FileSystemModel::Node const& node)
+{
+    auto path = node.full_path();
+    return String::formatted("{}/.cache/thumbnails/{:08x}-{}-{}.png", Core::StandardPaths::home_directory(), path.hash(), node.size, node.mtime);
+}
+
 static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
 {
     auto bitmap = TRY(Gfx::Bitmap::try_load_from_file(path));
@@ -644,6 +663,32 @@ static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
     return thumbnail;
 }
 
+static ErrorOr<void> write_thumbnail_to_cache(Gfx::Bitmap const& thumbnail, String const& cache_path)
+{
+    TRY(Core::Directory::create(LexicalPath(cache_path).parent(), Core::Directory::CreateDirectories::Yes));
+
+    // NOTE: Other processes may be reading the same file, so it has to be replaced in one go.
+    auto temporary_path = String::formatted("{}.tmp-{}", cache_path, getpid());
+    {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate));
+        if (!file->write_or_error(Gfx::PNGWriter::encode(thumbnail)))
+            return Error::from_string_literal("Failed to write thumbnail");
+    }
+    TRY(Core::System::rename(temporary_path, cache_path));
+    return {};
+}
+
+static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> load_or_render_thumbnail(String const& path, String const& cache_path)
+{
+    if (auto cached_thumbnail_or_error = Gfx::Bitmap::try_load_from_file(cache_path); !cached_thumbnail_or_error.is_error())
+        return cached_thumbnail_or_error.release_value();
+
+    auto thumbnail = TRY(render_thumbnail(path));
+    if (auto result = write_thumbnail_to_cache(*thumbnail, cache_path); result.is_error())
+        dbgln("Failed to cache thumbnail for {}: {}", path, result.error());
+    return thumbnail;
+}
+
 bool FileSystemModel::fetch_thumbnail_for(Node const& node)
 {
     // See if we already have the thumbnail
@@ -663,14 +708,28 @@ bool FileSystemModel::fetch_thumbnail_for(Node const& node)
     s_thumbnail_cache.set(path, nullptr);
     m_thumbnail_progress_total++;
 
-    auto weak_this = make_weak_ptr();
+    s_pending_thumbnail_requests.append({ path, thumbnail_cache_path_for(node), make_weak_ptr() });
+    render_next_thumbnail();
+
+    return false;
+}
+
+void FileSystemModel::render_next_thumbnail()
+{
+    if (s_is_rendering_thumbnail || s_pending_thumbnail_requests.is_empty())
+        return;
+
+    // The latest requests are for the items that were painted last, which are the most likely to still be visible.
+    auto request = s_pending_thumbnail_requests.take_last();
+    s_is_rendering_thumbnail = true;
 
     (void)Threading::BackgroundAction<ErrorOr<NonnullRefPtr<Gfx::Bitmap>>>::construct(
-        [path](auto&) {
-            return render_thumbnail(path);
+        [path = request.path, cache_path = request.cache_path](auto&) {
+            return load_or_render_thumbnail(path, cache_path);
         },
 
-        [this, path, weak_this](auto thumbnail_or_error) {
+        [path = request.path, model = request.model](auto thumbnail_or_error) mutable {
+            s_is_rendering_thumbnail = false;
             if (thumbnail_or_error.is_error()) {
                 s_thumbnail_cache.set(path, nullptr);
                 dbgln("Failed to load thumbnail for {}: {}", path, thumbnail_or_error.error());
@@ -680,21 +739,24 @@ bool FileSystemModel::fetch_thumbnail_for(Node const& node)
 
             // The model was destroyed, no need to update
             // progress or call any event handlers.
-            if (weak_this.is_null())
-                return;
-
-            m_thumbnail_progress++;
-            if (on_thumbnail_progress)
-                on_thumbnail_progress(m_thumbnail_progress, m_thumbnail_progress_total);
-            if (m_thumbnail_progress == m_thumbnail_progress_total) {
-                m_thumbnail_progress = 0;
-                m_thumbnail_progress_total = 0;
-            }
+            if (model)
+                model->did_render_thumbnail();
 
-            did_update(UpdateFlag::DontInvalidateIndices);
+            render_next_thumbnail();
         });
+}
 
-    return false;
+void FileSystemModel::did_render_thumbnail()
+{
+    m_thumbnail_progress++;
+    if (on_thumbnail_progress)
+        on_thumbnail_progress(m_thumbnail_progress, m_thumbnail_progress_total);
+    if (m_thumbnail_progress == m_thumbnail_progress_total) {
+        m_thumbnail_progress = 0;
+        m_thumbnail_progress_total = 0;
+    }
+
+    did_update(UpdateFlag::DontInvalidateIndices);
 }
 
 int FileSystemModel::column_count(ModelIndex const&) const
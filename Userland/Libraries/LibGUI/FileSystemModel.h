@@ -158,6 +158,8 @@ private:
     HashMap<gid_t, String> m_group_names;
 
     bool fetch_thumbnail_for(Node const& node);
+    static void render_next_thumbnail();
+    void did_render_thumbnail();
     GUI::Icon icon_for(Node const& node) const;
 
     void handle_file_event(Core::FileWatcherEvent const& event);
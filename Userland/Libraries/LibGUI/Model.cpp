@@ -63,6 +63,15 @@ ModelIndex Model::index(int row, int column, ModelIndex const&) const
     return create_index(row, column);
 }
 
+Vector<Variant> Model::data_for_range(int first_row, int count, int column, ModelRole role, ModelIndex const& parent) const
+{
+    Vector<Variant> data;
+    data.ensure_capacity(count);
+    for (int row = first_row; row < first_row + count; ++row)
+        data.unchecked_append(this->data(index(row, column, parent), role));
+    return data;
+}
+
 bool Model::accepts_drag(ModelIndex const&, Vector<String> const&) const
 {
     return false;
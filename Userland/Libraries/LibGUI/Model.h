@@ -67,6 +67,9 @@ public:
     virtual int column_count(ModelIndex const& = ModelIndex()) const = 0;
     virtual String column_name(int) const { return {}; }
     virtual Variant data(ModelIndex const&, ModelRole = ModelRole::Display) const = 0;
+    // The data of `column` for `count` rows starting at `first_row`. Models that can look up many rows
+    // at once for less than one data() call each should override this.
+    virtual Vector<Variant> data_for_range(int first_row, int count, int column, ModelRole = ModelRole::Display, ModelIndex const& parent = ModelIndex()) const;
     virtual TriState data_matches(ModelIndex const&, Variant const&) const { return TriState::Unknown; }
     virtual void invalidate();
     virtual ModelIndex parent_index(ModelIndex const&) const { return {}; }
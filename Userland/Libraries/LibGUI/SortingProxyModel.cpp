@@ -10,6 +10,9 @@
 
 namespace GUI {
 
+// Beyond this, moving each of the rows that are out of order into place is slower than sorting from scratch.
+static constexpr size_t max_rows_to_move_into_place = 16;
+
 SortingProxyModel::SortingProxyModel(NonnullRefPtr<Model> source)
     : m_source(move(source))
 {
@@ -177,13 +180,41 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
         return;
     }
 
-    for (int i = 0; i < row_count; ++i)
-        mapping.source_rows[i] = i;
+    // Look up every key once, rather than twice for every comparison.
+    auto keys = source().data_for_range(0, row_count, column, m_sort_role, mapping.source_parent);
+    for (auto& key : keys) {
+        if (key.is_string())
+            key = key.as_string().to_lowercase();
+    }
+    auto is_in_order = [&](int row1, int row2) -> bool {
+        return sort_order == SortOrder::Ascending ? keys[row1] < keys[row2] : keys[row2] < keys[row1];
+    };
+
+    // Start out from the previous order, as updates usually only move a few rows, if any.
+    bool can_reuse_previous_order = old_source_rows.size() == static_cast<size_t>(row_count);
+    if (can_reuse_previous_order) {
+        size_t out_of_order_count = 0;
+        for (int i = 1; i < row_count; ++i) {
+            if (is_in_order(mapping.source_rows[i], mapping.source_rows[i - 1]))
+                ++out_of_order_count;
+        }
+        if (out_of_order_count > max_rows_to_move_into_place)
+            can_reuse_previous_order = false;
+    }
 
-    quick_sort(mapping.source_rows, [&](auto row1, auto row2) -> bool {
-        bool is_less_than = less_than(source().index(row1, column, mapping.source_parent), source().index(row2, column, mapping.source_parent));
-        return sort_order == SortOrder::Ascending ? is_less_than : !is_less_than;
-    });
+    if (can_reuse_previous_order) {
+        for (int i = 1; i < row_count; ++i) {
+            auto row = mapping.source_rows[i];
+            int j = i;
+            for (; j > 0 && is_in_order(row, mapping.source_rows[j - 1]); --j)
+                mapping.source_rows[j] = mapping.source_rows[j - 1];
+            mapping.source_rows[j] = row;
+        }
+    } else {
+        for (int i = 0; i < row_count; ++i)
+            mapping.source_rows[i] = i;
+        quick_sort(mapping.source_rows, is_in_order);
+    }
 
     for (int i = 0; i < row_count; ++i)
         mapping.proxy_rows[mapping.source_rows[i]] = i;
@@ -195,7 +226,7 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
             Vector<ModelIndex> selected_indices_in_source;
             Vector<ModelIndex> stale_indices_in_selection;
             selection.for_each_index([&](ModelIndex const& index) {
-                if (index.parent() == mapping.source_parent) {
+                if (index.parent() == mapping.source_parent && static_cast<size_t>(index.row()) < old_source_rows.size()) {
                     stale_indices_in_selection.append(index);
                     selected_indices_in_source.append(source().index(old_source_rows[index.row()], index.column(), mapping.source_parent));
                 }
@@ -206,17 +237,14 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
             }
 
             for (auto& index : selected_indices_in_source) {
-                for (size_t i = 0; i < mapping.source_rows.size(); ++i) {
-                    if (mapping.source_rows[i] == index.row()) {
-                        auto new_source_index = this->index(i, index.column(), mapping.source_parent);
-                        selection.add(new_source_index);
-                        // Update the view's cursor.
-                        auto cursor = view.cursor_index();
-                        if (cursor.is_valid() && cursor.parent() == mapping.source_parent)
-                            view.set_cursor(new_source_index, AbstractView::SelectionUpdate::None, false);
-                        break;
-                    }
-                }
+                if (static_cast<size_t>(index.row()) >= mapping.proxy_rows.size())
+                    continue;
+                auto new_source_index = this->index(mapping.proxy_rows[index.row()], index.column(), mapping.source_parent);
+                selection.add(new_source_index);
+                // Update the view's cursor.
+                auto cursor = view.cursor_index();
+                if (cursor.is_valid() && cursor.parent() == mapping.source_parent)
+                    view.set_cursor(new_source_index, AbstractView::SelectionUpdate::None, false);
             }
         });
     });
@@ -245,10 +273,6 @@ SortingProxyModel::InternalMapIterator SortingProxyModel::build_mapping(ModelInd
 
     mapping->source_parent = source_parent;
 
-    int row_count = source().row_count(source_parent);
-    mapping->source_rows.resize(row_count);
-    mapping->proxy_rows.resize(row_count);
-
     sort_mapping(*mapping, m_last_key_column, m_last_sort_order);
 
     if (source_parent.is_valid()) {
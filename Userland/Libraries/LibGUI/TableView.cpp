@@ -51,14 +51,17 @@ void TableView::paint_event(PaintEvent& event)
     int x_offset = row_header().is_visible() ? row_header().width() : 0;
     int y_offset = column_header().is_visible() ? column_header().height() : 0;
 
-    bool dummy;
-    int first_visible_row = index_at_event_position(frame_inner_rect().top_left().translated(x_offset, y_offset), dummy).row();
-    int last_visible_row = index_at_event_position(frame_inner_rect().bottom_right().translated(x_offset, y_offset), dummy).row();
-
-    if (first_visible_row == -1)
-        first_visible_row = 0;
-    if (last_visible_row == -1)
-        last_visible_row = model()->row_count() - 1;
+    // Only the rows and columns that intersect the exposed area are painted, in content coordinates.
+    auto exposed_content_rect = event.rect().intersected(frame_inner_rect()).translated(horizontal_scrollbar().value() - frame_thickness(), vertical_scrollbar().value() - frame_thickness());
+    int first_visible_row = max(0, (exposed_content_rect.top() - y_offset) / row_height());
+    int last_visible_row = min(model()->row_count() - 1, (exposed_content_rect.bottom() - y_offset) / row_height());
+
+    if (m_caches_cell_data) {
+        // Forget about the cells that were scrolled out of view a while ago.
+        size_t visible_cell_count = max(0, last_visible_row - first_visible_row + 1) * model()->column_count();
+        if (m_cell_data_cache.size() > visible_cell_count * 4)
+            m_cell_data_cache.clear();
+    }
 
     int painted_item_index = first_visible_row;
 
@@ -92,6 +95,10 @@ void TableView::paint_event(PaintEvent& event)
             bool is_key_column = m_key_column == column_index;
             Gfx::IntRect cell_rect(horizontal_padding() + x, y, column_width, row_height());
             auto cell_rect_for_fill = cell_rect.inflated(horizontal_padding() * 2, 0);
+            if (!cell_rect_for_fill.intersects_horizontally(exposed_content_rect)) {
+                x += column_width + horizontal_padding() * 2;
+                continue;
+            }
             if (is_key_column && is_key_column_highlighted())
                 painter.fill_rect(cell_rect_for_fill, key_column_background_color);
             auto cell_index = model()->index(row_index, column_index);
@@ -100,7 +107,8 @@ void TableView::paint_event(PaintEvent& event)
             if (delegate && delegate->should_paint(cell_index)) {
                 delegate->paint(painter, cell_rect, palette(), cell_index);
             } else {
-                auto data = cell_index.data();
+                auto cell_data = data_for_painting(cell_index);
+                auto& data = cell_data.display;
                 if (data.is_bitmap()) {
                     auto cell_constrained_bitmap_rect = data.as_bitmap().rect();
                     if (data.as_bitmap().rect().width() > column_width)
@@ -119,19 +127,15 @@ void TableView::paint_event(PaintEvent& event)
                         } else if (m_hovered_index.is_valid() && cell_index.row() == m_hovered_index.row()) {
                             painter.blit_brightened(cell_rect.location(), *bitmap, bitmap->rect());
                         } else {
-                            auto opacity = cell_index.data(ModelRole::IconOpacity).as_float_or(1.0f);
-                            painter.blit(cell_rect.location(), *bitmap, bitmap->rect(), opacity);
+                            painter.blit(cell_rect.location(), *bitmap, bitmap->rect(), cell_data.icon_opacity);
                         }
                     }
                 } else {
-                    if (!is_selected_row) {
-                        auto cell_background_color = cell_index.data(ModelRole::BackgroundColor);
-                        if (cell_background_color.is_valid())
-                            painter.fill_rect(cell_rect_for_fill, cell_background_color.to_color(background_color));
-                    }
+                    if (!is_selected_row && cell_data.background_color.is_valid())
+                        painter.fill_rect(cell_rect_for_fill, cell_data.background_color.to_color(background_color));
 
-                    auto text_alignment = cell_index.data(ModelRole::TextAlignment).to_text_alignment(Gfx::TextAlignment::CenterLeft);
-                    draw_item_text(painter, cell_index, is_selected_row, cell_rect, data.to_string(), font_for_index(cell_index), text_alignment, Gfx::TextElision::Right);
+                    Gfx::Font const& font = cell_data.font.is_font() ? cell_data.font.as_font() : this->font();
+                    draw_item_text(painter, cell_index, is_selected_row, cell_rect, cell_data.text, font, cell_data.text_alignment, Gfx::TextElision::Right);
                 }
             }
 
@@ -162,6 +166,66 @@ void TableView::paint_event(PaintEvent& event)
         painter.fill_rect(unpainted_rect, widget_background_color);
 }
 
+TableView::CellData TableView::data_for_painting(ModelIndex const& index)
+{
+    if (m_caches_cell_data) {
+        if (auto it = m_cell_data_cache.find(index); it != m_cell_data_cache.end())
+            return it->value;
+    }
+
+    CellData cell_data;
+    cell_data.display = index.data();
+    if (cell_data.display.is_icon()) {
+        cell_data.icon_opacity = index.data(ModelRole::IconOpacity).as_float_or(1.0f);
+    } else if (!cell_data.display.is_bitmap()) {
+        cell_data.text = cell_data.display.to_string();
+        cell_data.background_color = index.data(ModelRole::BackgroundColor);
+        cell_data.text_alignment = index.data(ModelRole::TextAlignment).to_text_alignment(Gfx::TextAlignment::CenterLeft);
+        cell_data.font = index.data(ModelRole::Font);
+    }
+
+    if (m_caches_cell_data)
+        m_cell_data_cache.set(index, cell_data);
+    return cell_data;
+}
+
+void TableView::set_caches_cell_data(bool caches_cell_data)
+{
+    m_caches_cell_data = caches_cell_data;
+    m_cell_data_cache.clear();
+}
+
+void TableView::did_update_selection()
+{
+    // NOTE: Some models show selected items differently, without telling us.
+    m_cell_data_cache.clear();
+    AbstractTableView::did_update_selection();
+}
+
+void TableView::model_did_update(unsigned flags)
+{
+    m_cell_data_cache.clear();
+    AbstractTableView::model_did_update(flags);
+}
+
+void TableView::model_did_insert_rows(ModelIndex const& parent, int first, int last)
+{
+    m_cell_data_cache.clear();
+    AbstractTableView::model_did_insert_rows(parent, first, last);
+}
+
+void TableView::model_did_move_rows(ModelIndex const& source_parent, int first, int last, ModelIndex const& target_parent, int target_index)
+{
+    m_cell_data_cache.clear();
+    AbstractTableView::model_did_move_rows(source_parent, first, last, target_parent, target_index);
+}
+
+void TableView::model_did_delete_rows(ModelIndex const& parent, int first, int last)
+{
+    m_cell_data_cache.clear();
+    AbstractTableView::model_did_delete_rows(parent, first, last);
+}
+
 void TableView::second_paint_event(PaintEvent& event)
 {
     if (!m_rubber_banding)
@@ -37,6 +37,12 @@ public:
 
     virtual void move_cursor(CursorMovement, SelectionUpdate) override;
 
+    // Keeps what the model had to say about the painted cells until it reports a change, so repainting does
+    // not have to ask it again. Models whose data changes without them telling their clients (other than along
+    // with the selection) can not be used with this.
+    bool caches_cell_data() const { return m_caches_cell_data; }
+    void set_caches_cell_data(bool);
+
 protected:
     TableView();
 
@@ -47,7 +53,23 @@ protected:
     virtual void paint_event(PaintEvent&) override;
     virtual void second_paint_event(PaintEvent&) override;
 
+    virtual void did_update_selection() override;
+    virtual void model_did_update(unsigned flags) override;
+    virtual void model_did_insert_rows(ModelIndex const& parent, int first, int last) override;
+    virtual void model_did_move_rows(ModelIndex const& source_parent, int first, int last, ModelIndex const& target_parent, int target_index) override;
+    virtual void model_did_delete_rows(ModelIndex const& parent, int first, int last) override;
+
 private:
+    struct CellData {
+        Variant display;
+        String text;
+        Variant background_color;
+        Variant font;
+        Gfx::TextAlignment text_alignment { Gfx::TextAlignment::CenterLeft };
+        float icon_opacity { 1.0f };
+    };
+    CellData data_for_painting(ModelIndex const&);
+
     GridStyle m_grid_style { GridStyle::None };
 
     bool m_highlight_key_column { true };
@@ -55,6 +77,9 @@ private:
     bool m_rubber_banding { false };
     int m_rubber_band_origin { 0 };
     int m_rubber_band_current { 0 };
+
+    bool m_caches_cell_data { false };
+    HashMap<ModelIndex, CellData> m_cell_data_cache;
 };
 
 }
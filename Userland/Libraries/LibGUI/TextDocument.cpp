@@ -38,6 +38,15 @@ TextDocument::TextDocument(Client* client)
     };
 }
 
+// Counts the code points in valid UTF-8 by counting the bytes that aren't continuation bytes, which is a lot cheaper than decoding.
+static size_t code_point_count(StringView utf8)
+{
+    size_t count = 0;
+    for (auto byte : utf8.bytes())
+        count += (byte & 0xc0) != 0x80;
+    return count;
+}
+
 bool TextDocument::set_text(StringView text, AllowCallback allow_callback)
 {
     m_client_notifications_enabled = false;
@@ -49,38 +58,31 @@ bool TextDocument::set_text(StringView text, AllowCallback allow_callback)
         set_text({});
     });
 
-    size_t start_of_current_line = 0;
-
-    auto add_line = [&](size_t current_position) -> bool {
-        size_t line_length = current_position - start_of_current_line;
-        auto line = make<TextDocumentLine>(*this);
+    if (!Utf8View(text).validate())
+        return false;
 
-        bool success = true;
-        if (line_length)
-            success = line->set_text(*this, text.substring_view(start_of_current_line, current_position - start_of_current_line));
+    // NOTE: The lines are going to point into this, so it can't change until they are all gone.
+    auto original_text = ByteBuffer::create_uninitialized(text.length());
+    if (original_text.is_error())
+        return false;
+    m_original_text = original_text.release_value();
+    text.bytes().copy_to(m_original_text.bytes());
+    auto original_text_view = StringView { m_original_text.bytes() };
 
-        if (!success)
-            return false;
+    size_t start_of_current_line = 0;
 
+    auto add_line = [&](size_t current_position) {
+        auto line_text = original_text_view.substring_view(start_of_current_line, current_position - start_of_current_line);
+        auto line = make<TextDocumentLine>(*this);
+        if (!line_text.is_empty())
+            line->set_original_text({}, line_text, code_point_count(line_text));
         append_line(move(line));
         start_of_current_line = current_position + 1;
-
-        return true;
     };
 
-    size_t i = 0;
-    for (i = 0; i < text.length(); ++i) {
-        if (text[i] != '\n')
-            continue;
-
-        auto success = add_line(i);
-        if (!success)
-            return false;
-    }
-
-    auto success = add_line(i);
-    if (!success)
-        return false;
+    for (auto end_of_line = original_text_view.find('\n'); end_of_line.has_value(); end_of_line = original_text_view.find('\n', start_of_current_line))
+        add_line(*end_of_line);
+    add_line(original_text_view.length());
 
     // Don't show the file's trailing newline as an actual new line.
     if (line_count() > 1 && line(line_count() - 1).is_empty())
@@ -140,8 +142,8 @@ bool TextDocumentLine::can_select() const
 size_t TextDocumentLine::leading_spaces() const
 {
     size_t count = 0;
-    for (; count < m_text.size(); ++count) {
-        if (m_text[count] != ' ') {
+    for (; count < length(); ++count) {
+        if (code_points()[count] != ' ') {
             break;
         }
     }
@@ -150,6 +152,8 @@ size_t TextDocumentLine::leading_spaces() const
 
 String TextDocumentLine::to_utf8() const
 {
+    if (!m_original_text.is_empty())
+        return m_original_text;
     StringBuilder builder;
     builder.append(view());
     return builder.to_string();
@@ -165,14 +169,33 @@ TextDocumentLine::TextDocumentLine(TextDocument& document, StringView text)
     set_text(document, text);
 }
 
+void TextDocumentLine::set_original_text(Badge<TextDocument>, StringView text, size_t length)
+{
+    m_text.clear();
+    m_original_text = text;
+    m_original_length = length;
+}
+
+void TextDocumentLine::decode_original_text() const
+{
+    if (m_original_text.is_empty())
+        return;
+    m_text.ensure_capacity(m_original_length);
+    for (auto code_point : Utf8View(m_original_text))
+        m_text.unchecked_append(code_point);
+    m_original_text = {};
+}
+
 void TextDocumentLine::clear(TextDocument& document)
 {
+    m_original_text = {};
     m_text.clear();
     document.update_views({});
 }
 
 void TextDocumentLine::set_text(TextDocument& document, Vector<u32> const text)
 {
+    m_original_text = {};
     m_text = move(text);
     document.update_views({});
 }
@@ -183,6 +206,7 @@ bool TextDocumentLine::set_text(TextDocument& document, StringView text)
         clear(document);
         return true;
     }
+    m_original_text = {};
     m_text.clear();
     Utf8View utf8_view(text);
     if (!utf8_view.validate()) {
@@ -198,6 +222,7 @@ void TextDocumentLine::append(TextDocument& document, u32 const* code_points, si
 {
     if (length == 0)
         return;
+    decode_original_text();
     m_text.append(code_points, length);
     document.update_views({});
 }
@@ -214,6 +239,7 @@ void TextDocumentLine::prepend(TextDocument& document, u32 code_point)
 
 void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_point)
 {
+    decode_original_text();
     if (index == length()) {
         m_text.append(code_point);
     } else {
@@ -224,6 +250,7 @@ void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_poi
 
 void TextDocumentLine::remove(TextDocument& document, size_t index)
 {
+    decode_original_text();
     if (index == length()) {
         m_text.take_last();
     } else {
@@ -234,6 +261,7 @@ void TextDocumentLine::remove(TextDocument& document, size_t index)
 
 void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t length)
 {
+    decode_original_text();
     VERIFY(length <= m_text.size());
 
     Vector<u32> new_data;
@@ -248,6 +276,7 @@ void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t
 
 void TextDocumentLine::truncate(TextDocument& document, size_t length)
 {
+    decode_original_text();
     m_text.resize(length);
     document.update_views({});
 }
@@ -273,6 +302,8 @@ void TextDocument::insert_line(size_t line_index, NonnullOwnPtr<TextDocumentLine
 NonnullOwnPtr<TextDocumentLine> TextDocument::take_line(size_t line_index)
 {
     auto line = lines().take(line_index);
+    // NOTE: The line may outlive the text it points into, so it has to be decoded now.
+    (void)line->code_points();
     if (m_client_notifications_enabled) {
         for (auto* client : m_clients)
             client->document_did_remove_line(line_index);
@@ -336,7 +367,10 @@ String TextDocument::text() const
     StringBuilder builder;
     for (size_t i = 0; i < line_count(); ++i) {
         auto& line = this->line(i);
-        builder.append(line.view());
+        if (auto original_text = line.original_text(); original_text.has_value())
+            builder.append(*original_text);
+        else
+            builder.append(line.view());
         if (i != line_count() - 1)
             builder.append('\n');
     }
@@ -590,10 +624,71 @@ TextRange TextDocument::find_previous(StringView needle, TextPosition const& sta
     return {};
 }
 
+// Calls `on_match` with the index of each match of `needle` in `text`, not counting matches that overlap previous ones.
+template<typename Text, typename Callback>
+static void find_all_in_line(Text const& text, size_t length, StringView needle, bool match_case, Callback on_match)
+{
+    auto matches_at = [&](size_t index) {
+        for (size_t i = 0; i < needle.length(); ++i) {
+            u32 haystack_code_point = text[index + i];
+            u32 needle_code_point = static_cast<u8>(needle[i]);
+            if (match_case ? haystack_code_point != needle_code_point : tolower(haystack_code_point) != tolower(needle_code_point))
+                return false;
+        }
+        return true;
+    };
+    for (size_t index = 0; index + needle.length() <= length;) {
+        if (!matches_at(index)) {
+            ++index;
+            continue;
+        }
+        on_match(index);
+        index += needle.length();
+    }
+}
+
 Vector<TextRange> TextDocument::find_all(StringView needle, bool regmatch, bool match_case)
 {
     Vector<TextRange> ranges;
 
+    // Stepping through the document position by position is slow, and would decode every line, so plain
+    // needles are searched for line by line, in the UTF-8 of lines that haven't been decoded.
+    if (!regmatch && !needle.is_empty() && !needle.contains('\n')) {
+        for (size_t line_index = 0; line_index < line_count(); ++line_index) {
+            auto& line = this->line(line_index);
+            auto add_range = [&](size_t start_column, size_t end_column) {
+                ranges.append({ { line_index, start_column }, { line_index, end_column } });
+            };
+
+            auto original_text = line.original_text();
+            if (!original_text.has_value()) {
+                find_all_in_line(line.code_points(), line.length(), needle, match_case, [&](size_t column) {
+                    add_range(column, column + needle.length());
+                });
+                continue;
+            }
+
+            // Columns are counted in code points, so keep track of how many there are up to where we are.
+            size_t counted_bytes = 0;
+            size_t counted_columns = 0;
+            auto add_range_at_byte_offset = [&](size_t offset) {
+                counted_columns += code_point_count(original_text->substring_view(counted_bytes, offset - counted_bytes));
+                counted_bytes = offset + needle.length();
+                auto needle_columns = code_point_count(original_text->substring_view(offset, needle.length()));
+                add_range(counted_columns, counted_columns + needle_columns);
+                counted_columns += needle_columns;
+            };
+
+            if (!match_case) {
+                find_all_in_line(original_text->characters_without_null_termination(), original_text->length(), needle, false, add_range_at_byte_offset);
+                continue;
+            }
+            for (auto match = original_text->find(needle); match.has_value(); match = original_text->find(needle, counted_bytes))
+                add_range_at_byte_offset(*match);
+        }
+        return ranges;
+    }
+
     TextPosition position;
     for (;;) {
         auto range = find_next(needle, position, SearchShouldWrap::No, regmatch, match_case);
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/HashTable.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/NonnullRefPtr.h>
@@ -143,6 +144,8 @@ private:
     void merge_span_collections();
 
     NonnullOwnPtrVector<TextDocumentLine> m_lines;
+    // The text that lines which haven't been decoded yet point into.
+    ByteBuffer m_original_text;
     HashMap<u32, Vector<TextDocumentSpan>> m_span_collections;
     Vector<TextDocumentSpan> m_spans;
 
@@ -167,8 +170,21 @@ public:
     String to_utf8() const;
 
     Utf32View view() const { return { code_points(), length() }; }
-    u32 const* code_points() const { return m_text.data(); }
-    size_t length() const { return m_text.size(); }
+    u32 const* code_points() const
+    {
+        decode_original_text();
+        return m_text.data();
+    }
+    size_t length() const { return m_original_text.is_empty() ? m_text.size() : m_original_length; }
+
+    // The UTF-8 text of the line, as long as it hasn't been looked at code point by code point, or changed, since the document's text was set.
+    Optional<StringView> original_text() const
+    {
+        if (m_original_text.is_empty())
+            return {};
+        return m_original_text;
+    }
+    void set_original_text(Badge<TextDocument>, StringView text, size_t length);
     bool set_text(TextDocument&, StringView);
     void set_text(TextDocument&, Vector<u32>);
     void append(TextDocument&, u32);
@@ -188,8 +204,15 @@ public:
     size_t leading_spaces() const;
 
 private:
+    void decode_original_text() const;
+
     // NOTE: This vector is null terminated.
-    Vector<u32> m_text;
+    mutable Vector<u32> m_text;
+
+    // Lines point into the text the document was given, and are only decoded once they are needed, which makes
+    // setting a large text cheap. Most of the lines of a large file are never even looked at.
+    mutable StringView m_original_text;
+    size_t m_original_length { 0 };
 };
 
 class TextDocumentUndoCommand : public Command {
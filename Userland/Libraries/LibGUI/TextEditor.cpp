@@ -11,6 +11,7 @@
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <AK/TemporaryChange.h>
+#include <AK/Utf8View.h>
 #include <LibCore/File.h>
 #include <LibCore/Timer.h>
 #include <LibGUI/Action.h>
@@ -1908,6 +1909,8 @@ void TextEditor::recompute_visual_lines(size_t line_index)
 
     if (is_wrapping_enabled())
         visual_data.visual_rect = { m_horizontal_content_padding, 0, available_width, static_cast<int>(visual_data.visual_line_breaks.size()) * line_height() };
+    else if (auto original_text = line.original_text(); original_text.has_value())
+        visual_data.visual_rect = { m_horizontal_content_padding, 0, text_width_for_font(Utf8View(*original_text), font()), line_height() };
     else
         visual_data.visual_rect = { m_horizontal_content_padding, 0, text_width_for_font(line.view(), font()), line_height() };
 }
@@ -24,6 +24,7 @@
 #include <LibGUI/Widget.h>
 #include <LibGUI/Window.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/DisjointRectSet.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -49,9 +50,13 @@ public:
 
     i32 serial() const { return m_serial; }
 
+    bool is_known_to_window_server() const { return m_is_known_to_window_server; }
+    void set_known_to_window_server() { m_is_known_to_window_server = true; }
+
 private:
     NonnullRefPtr<Gfx::Bitmap> m_bitmap;
     const i32 m_serial;
+    bool m_is_known_to_window_server { false };
 };
 
 static NeverDestroyed<HashTable<Window*>> all_windows;
@@ -445,12 +450,13 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
         m_main_widget->dispatch_event(paint_event, this);
     }
 
+    bool window_server_has_damage = false;
     if (m_double_buffering_enabled)
-        flip(rects);
+        window_server_has_damage = flip(rects);
     else if (created_new_backing_store)
         set_current_backing_store(*m_back_store, true);
 
-    if (is_visible())
+    if (is_visible() && !window_server_has_damage)
         ConnectionToWindowServer::the().async_did_finish_painting(m_window_id, rects);
 }
 
@@ -889,28 +895,38 @@ void Window::set_current_backing_store(WindowBackingStore& backing_store, bool f
 {
     auto& bitmap = backing_store.bitmap();
     ConnectionToWindowServer::the().set_window_backing_store(m_window_id, 32, bitmap.pitch(), bitmap.anonymous_buffer().fd(), backing_store.serial(), bitmap.has_alpha_channel(), bitmap.size(), flush_immediately);
+    backing_store.set_known_to_window_server();
 }
 
-void Window::flip(Vector<Gfx::IntRect, 32> const& dirty_rects)
+bool Window::flip(Vector<Gfx::IntRect, 32> const& dirty_rects)
 {
     swap(m_front_store, m_back_store);
 
-    set_current_backing_store(*m_front_store);
+    // If WindowServer already has the new front buffer, it can switch back to it and invalidate just the
+    // painted rects in one go, without us having to send it the buffer again.
+    bool window_server_has_damage = m_front_store->is_known_to_window_server()
+        && ConnectionToWindowServer::the().flip_window_backing_store(m_window_id, m_front_store->serial(), dirty_rects);
+    if (!window_server_has_damage)
+        set_current_backing_store(*m_front_store);
 
     if (!m_back_store || m_back_store->size() != m_front_store->size()) {
         m_back_store = create_backing_store(m_front_store->size());
         VERIFY(m_back_store);
         memcpy(m_back_store->bitmap().scanline(0), m_front_store->bitmap().scanline(0), m_front_store->bitmap().size_in_bytes());
         m_back_store->bitmap().set_volatile();
-        return;
+        return window_server_has_damage;
     }
 
-    // Copy whatever was painted from the front to the back.
+    // Copy whatever was painted from the front to the back. Paint rects often overlap, so make sure we only
+    // copy every pixel once.
+    Gfx::DisjointIntRectSet rects_to_copy;
+    rects_to_copy.add_many(dirty_rects);
     Painter painter(m_back_store->bitmap());
-    for (auto& dirty_rect : dirty_rects)
-        painter.blit(dirty_rect.location(), m_front_store->bitmap(), dirty_rect, 1.0f, false);
+    for (auto& rect : rects_to_copy.rects())
+        painter.blit(rect.location(), m_front_store->bitmap(), rect, 1.0f, false);
 
     m_back_store->bitmap().set_volatile();
+    return window_server_has_damage;
 }
 
 OwnPtr<WindowBackingStore> Window::create_backing_store(Gfx::IntSize const& size)
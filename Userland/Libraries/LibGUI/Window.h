@@ -272,7 +272,7 @@ private:
 
     OwnPtr<WindowBackingStore> create_backing_store(Gfx::IntSize const&);
     void set_current_backing_store(WindowBackingStore&, bool flush_immediately = false);
-    void flip(Vector<Gfx::IntRect, 32> const& dirty_rects);
+    bool flip(Vector<Gfx::IntRect, 32> const& dirty_rects);
     void force_update();
 
     bool are_cursors_the_same(AK::Variant<Gfx::StandardCursor, NonnullRefPtr<Gfx::Bitmap>> const&, AK::Variant<Gfx::StandardCursor, NonnullRefPtr<Gfx::Bitmap>> const&) const;
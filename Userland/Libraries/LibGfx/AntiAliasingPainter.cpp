@@ -14,6 +14,7 @@
 #include <AK/Function.h>
 #include <AK/NumericLimits.h>
 #include <LibGfx/AntiAliasingPainter.h>
+#include <LibGfx/CoverageRasterizer.h>
 #include <LibGfx/Line.h>
 
 namespace Gfx {
@@ -218,7 +219,12 @@ void AntiAliasingPainter::draw_line(FloatPoint const& actual_from, FloatPoint co
 
 void AntiAliasingPainter::fill_path(Path& path, Color color, Painter::WindingRule rule)
 {
-    Detail::fill_path<Detail::FillPathMode::AllowFloatingPoints>(*this, path, color, rule);
+    // FIXME: Teach CoverageRasterizer about painters with a scale factor.
+    if (m_underlying_painter.scale() != 1) {
+        Detail::fill_path<Detail::FillPathMode::AllowFloatingPoints>(*this, path, color, rule);
+        return;
+    }
+    CoverageRasterizer(m_underlying_painter, path, m_transform).fill(color, rule);
 }
 
 void AntiAliasingPainter::stroke_path(Path const& path, Color color, float thickness)
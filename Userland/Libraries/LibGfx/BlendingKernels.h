@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BitCast.h>
+#include <AK/SIMDExtras.h>
+#include <LibGfx/Color.h>
+
+
+// NOTE: These are all static and inlined, so the ABI differences GCC warns about don't matter here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// The kernels below produce exactly the same pixels as Color::blend() and Color::interpolate(). They are written with the
+// vector types from AK/SIMD.h, so the compiler turns them into SSE2 on x86 and NEON on AArch64.
+namespace Gfx::Kernels {
+
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+using AK::SIMD::u16x16;
+using AK::SIMD::u32x4;
+using AK::SIMD::u8x16;
+using AK::SIMD::u8x4;
+
+static constexpr int pixels_per_vector = 4;
+
+// Exact for everything up to 255 * 255, which is the most a blended channel can add up to.
+ALWAYS_INLINE static u16x16 divide_by_255(u16x16 value)
+{
+    return (value + 1 + (value >> 8)) >> 8;
+}
+
+ALWAYS_INLINE static u16x16 load_pixels(ARGB32 const* pixels)
+{
+    u8x16 bytes;
+    __builtin_memcpy(&bytes, pixels, sizeof(bytes));
+    return __builtin_convertvector(bytes, u16x16);
+}
+
+ALWAYS_INLINE static void store_pixels(ARGB32* pixels, u16x16 value)
+{
+    auto bytes = __builtin_convertvector(value, u8x16);
+    __builtin_memcpy(pixels, &bytes, sizeof(bytes));
+}
+
+ALWAYS_INLINE static bool are_opaque(ARGB32 const* pixels)
+{
+    u32x4 value;
+    __builtin_memcpy(&value, pixels, sizeof(value));
+    return AK::SIMD::all((value >> 24) == 0xff);
+}
+
+// When the destination is opaque, Color::blend() comes down to (destination * (255 - alpha) + source * alpha) / 255 per
+// channel, and the result is opaque as well.
+ALWAYS_INLINE static u16x16 blend_over_opaque(u16x16 destination, u16x16 source, u16x16 alpha)
+{
+    constexpr u16x16 opaque_alpha { 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff };
+    constexpr u16x16 color_channels { 0xff, 0xff, 0xff, 0, 0xff, 0xff, 0xff, 0, 0xff, 0xff, 0xff, 0, 0xff, 0xff, 0xff, 0 };
+    auto blended = divide_by_255(destination * (255 - alpha) + source * alpha);
+    return (blended & color_channels) | opaque_alpha;
+}
+
+// Blends a row of source pixels over the destination. If an alpha table is given, the alpha of each source pixel is looked up in it.
+// Destinations without an alpha channel are considered opaque, like Color::from_rgb() would.
+template<bool destination_has_alpha>
+static void blend_row(ARGB32* destination, ARGB32 const* source, int count, u8 const* alpha_table)
+{
+    int x = 0;
+    for (; x + pixels_per_vector <= count; x += pixels_per_vector) {
+        if (destination_has_alpha && !are_opaque(destination + x)) {
+            for (int i = x; i < x + pixels_per_vector; ++i) {
+                auto color = Color::from_argb(source[i]);
+                if (alpha_table)
+                    color.set_alpha(alpha_table[color.alpha()]);
+                destination[i] = Color::from_argb(destination[i]).blend(color).value();
+            }
+            continue;
+        }
+
+        auto source_pixels = load_pixels(source + x);
+        u16x16 alpha;
+        if (alpha_table) {
+            u16 a0 = alpha_table[source[x] >> 24];
+            u16 a1 = alpha_table[source[x + 1] >> 24];
+            u16 a2 = alpha_table[source[x + 2] >> 24];
+            u16 a3 = alpha_table[source[x + 3] >> 24];
+            alpha = u16x16 { a0, a0, a0, a0, a1, a1, a1, a1, a2, a2, a2, a2, a3, a3, a3, a3 };
+        } else {
+            alpha = __builtin_shufflevector(source_pixels, source_pixels, 3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+        }
+        store_pixels(destination + x, blend_over_opaque(load_pixels(destination + x), source_pixels, alpha));
+    }
+
+    for (; x < count; ++x) {
+        auto color = Color::from_argb(source[x]);
+        if (alpha_table)
+            color.set_alpha(alpha_table[color.alpha()]);
+        auto destination_color = destination_has_alpha ? Color::from_argb(destination[x]) : Color::from_rgb(destination[x]);
+        destination[x] = destination_color.blend(color).value();
+    }
+}
+
+// Blends a single color over a row of destination pixels, as if it were a row of source pixels of that color.
+static void blend_color_row(ARGB32* destination, Color color, int count)
+{
+    u16 const b = color.blue();
+    u16 const g = color.green();
+    u16 const r = color.red();
+    u16 const a = color.alpha();
+    u16x16 const source { b, g, r, a, b, g, r, a, b, g, r, a, b, g, r, a };
+    u16x16 const alpha { a, a, a, a, a, a, a, a, a, a, a, a, a, a, a, a };
+
+    int x = 0;
+    for (; x + pixels_per_vector <= count; x += pixels_per_vector) {
+        if (!are_opaque(destination + x)) {
+            for (int i = x; i < x + pixels_per_vector; ++i)
+                destination[i] = Color::from_argb(destination[i]).blend(color).value();
+            continue;
+        }
+        store_pixels(destination + x, blend_over_opaque(load_pixels(destination + x), source, alpha));
+    }
+
+    for (; x < count; ++x)
+        destination[x] = Color::from_argb(destination[x]).blend(color).value();
+}
+
+// Blends a single color over a row of destination pixels, with the color's alpha scaled by the coverage of each pixel.
+static void blend_coverage_row(ARGB32* destination, u8 const* coverage, Color color, int count)
+{
+    u16 const b = color.blue();
+    u16 const g = color.green();
+    u16 const r = color.red();
+    u16 const a = color.alpha();
+    u16x16 const source { b, g, r, a, b, g, r, a, b, g, r, a, b, g, r, a };
+
+    auto blend_one = [&](int i) {
+        if (!coverage[i])
+            return;
+        destination[i] = Color::from_argb(destination[i]).blend(color.with_alpha(coverage[i] * a / 255)).value();
+    };
+
+    int x = 0;
+    for (; x + pixels_per_vector <= count; x += pixels_per_vector) {
+        u32 coverage_of_all;
+        __builtin_memcpy(&coverage_of_all, coverage + x, sizeof(coverage_of_all));
+        if (coverage_of_all == 0)
+            continue;
+        if (!are_opaque(destination + x)) {
+            for (int i = x; i < x + pixels_per_vector; ++i)
+                blend_one(i);
+            continue;
+        }
+        u16 a0 = coverage[x] * a / 255;
+        u16 a1 = coverage[x + 1] * a / 255;
+        u16 a2 = coverage[x + 2] * a / 255;
+        u16 a3 = coverage[x + 3] * a / 255;
+        u16x16 alpha { a0, a0, a0, a0, a1, a1, a1, a1, a2, a2, a2, a2, a3, a3, a3, a3 };
+        store_pixels(destination + x, blend_over_opaque(load_pixels(destination + x), source, alpha));
+    }
+
+    for (; x < count; ++x)
+        blend_one(x);
+}
+
+ALWAYS_INLINE static f32x4 to_channels(Color color)
+{
+    return __builtin_convertvector(bit_cast<u8x4>(color.value()), f32x4);
+}
+
+// Rounds to the nearest integer (ties to even) just like round_to() does. Adding and subtracting 1.5 * 2^23 pushes the
+// fraction out of the mantissa, which works for anything whose magnitude is below 2^22.
+ALWAYS_INLINE static f32x4 round_to_nearest(f32x4 value)
+{
+    constexpr f32x4 magic { 12582912.0f, 12582912.0f, 12582912.0f, 12582912.0f };
+    return (value + magic) - magic;
+}
+
+ALWAYS_INLINE static f32x4 interpolate(f32x4 from, f32x4 to, float weight)
+{
+    return from + round_to_nearest((to - from) * weight);
+}
+
+// Same as top_left.interpolate(top_right, x_ratio).interpolate(bottom_left.interpolate(bottom_right, x_ratio), y_ratio)
+ALWAYS_INLINE static Color interpolate_bilinear(Color top_left, Color top_right, Color bottom_left, Color bottom_right, float x_ratio, float y_ratio)
+{
+    auto top = interpolate(to_channels(top_left), to_channels(top_right), x_ratio);
+    auto bottom = interpolate(to_channels(bottom_left), to_channels(bottom_right), x_ratio);
+    auto result = interpolate(top, bottom, y_ratio);
+    auto channels = __builtin_convertvector(__builtin_convertvector(result, i32x4), u8x4);
+    return Color::from_argb(bit_cast<ARGB32>(channels));
+}
+
+}
+
+#pragma GCC diagnostic pop
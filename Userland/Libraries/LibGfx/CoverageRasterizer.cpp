@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/BlendingKernels.h>
+#include <LibGfx/CoverageRasterizer.h>
+
+namespace Gfx {
+
+CoverageRasterizer::CoverageRasterizer(Painter& painter, Path const& path, AffineTransform const& transform)
+    : m_painter(painter)
+{
+    VERIFY(painter.scale() == 1);
+
+    auto const& lines = path.split_lines();
+    if (lines.is_empty())
+        return;
+
+    auto translation = painter.translation().to_type<float>();
+    float min_x = NumericLimits<float>::max();
+    float min_y = NumericLimits<float>::max();
+    float max_x = NumericLimits<float>::lowest();
+    float max_y = NumericLimits<float>::lowest();
+
+    m_edges.ensure_capacity(lines.size());
+    for (auto const& line : lines) {
+        auto from = transform.map(line.from).translated(translation);
+        auto to = transform.map(line.to).translated(translation);
+        // Horizontal edges don't change the winding of anything, so they don't add any coverage.
+        if (from.y() == to.y())
+            continue;
+        m_edges.append({ from, to });
+        min_x = min(min_x, min(from.x(), to.x()));
+        max_x = max(max_x, max(from.x(), to.x()));
+        min_y = min(min_y, min(from.y(), to.y()));
+        max_y = max(max_y, max(from.y(), to.y()));
+    }
+    if (m_edges.is_empty())
+        return;
+
+    int left = floorf(min_x);
+    int top = floorf(min_y);
+    IntRect path_bounds { left, top, static_cast<int>(ceilf(max_x)) - left + 1, static_cast<int>(ceilf(max_y)) - top + 1 };
+    m_bounds = path_bounds.intersected(painter.clip_rect()).intersected(painter.target()->rect());
+    if (m_bounds.is_empty())
+        return;
+
+    size_t band_count = ceil_div(m_bounds.height(), band_height);
+    m_edges_by_band.resize(band_count);
+    for (size_t i = 0; i < m_edges.size(); ++i) {
+        auto const& edge = m_edges[i];
+        float edge_top = min(edge.from.y(), edge.to.y());
+        float edge_bottom = max(edge.from.y(), edge.to.y());
+        if (edge_bottom <= m_bounds.top() || edge_top >= m_bounds.top() + m_bounds.height())
+            continue;
+        int first_band = max(0, static_cast<int>(floorf(edge_top) - m_bounds.top()) / band_height);
+        int last_band = min(static_cast<int>(band_count) - 1, static_cast<int>(ceilf(edge_bottom) - m_bounds.top()) / band_height);
+        for (int band = first_band; band <= last_band; ++band)
+            m_edges_by_band[band].append(i);
+    }
+
+    // Every row has a cell for each column, plus two more so that edges on the right border don't need special cases.
+    m_accumulation.resize((m_bounds.width() + 2) * band_height);
+    m_coverage.resize(m_bounds.width());
+}
+
+void CoverageRasterizer::fill(Color color, Painter::WindingRule winding_rule)
+{
+    if (m_bounds.is_empty() || color.alpha() == 0)
+        return;
+
+    for (size_t band = 0; band < m_edges_by_band.size(); ++band)
+        fill_band(band, color, winding_rule);
+}
+
+void CoverageRasterizer::fill_band(size_t band_index, Color color, Painter::WindingRule winding_rule)
+{
+    auto const& edges = m_edges_by_band[band_index];
+    if (edges.is_empty())
+        return;
+
+    int band_top = m_bounds.top() + static_cast<int>(band_index) * band_height;
+    int band_bottom = min(band_top + band_height, m_bounds.top() + m_bounds.height());
+    int width = m_bounds.width();
+    size_t row_pitch = width + 2;
+
+    m_accumulation.span().fill(0.0f);
+    for (auto edge_index : edges)
+        accumulate_edge(m_edges[edge_index], band_top, band_bottom);
+
+    auto* target = m_painter.target();
+    for (int y = band_top; y < band_bottom; ++y) {
+        float const* cells = &m_accumulation[(y - band_top) * row_pitch];
+        float winding = 0.0f;
+        bool any_coverage = false;
+        for (int x = 0; x < width; ++x) {
+            winding += cells[x];
+            float coverage = fabsf(winding);
+            if (winding_rule == Painter::WindingRule::EvenOdd) {
+                coverage = fmodf(coverage, 2.0f);
+                if (coverage > 1.0f)
+                    coverage = 2.0f - coverage;
+            }
+            m_coverage[x] = static_cast<u8>(min(coverage, 1.0f) * 255.0f + 0.5f);
+            any_coverage |= m_coverage[x] != 0;
+        }
+        if (any_coverage)
+            Kernels::blend_coverage_row(target->scanline(y) + m_bounds.left(), m_coverage.data(), color, width);
+    }
+}
+
+void CoverageRasterizer::accumulate_edge(Edge const& edge, int band_top, int band_bottom)
+{
+    auto from = edge.from;
+    auto to = edge.to;
+    float direction = 1.0f;
+    if (from.y() > to.y()) {
+        swap(from, to);
+        direction = -1.0f;
+    }
+
+    float top = max(from.y(), static_cast<float>(band_top));
+    float bottom = min(to.y(), static_cast<float>(band_bottom));
+    if (top >= bottom)
+        return;
+
+    float dxdy = (to.x() - from.x()) / (to.y() - from.y());
+    size_t row_pitch = m_bounds.width() + 2;
+    float left = m_bounds.left();
+
+    for (int y = floorf(top); y < bottom; ++y) {
+        float row_top = max(top, static_cast<float>(y));
+        float row_bottom = min(bottom, static_cast<float>(y + 1));
+        if (row_top >= row_bottom)
+            continue;
+        float from_x = from.x() + (row_top - from.y()) * dxdy - left;
+        float to_x = from.x() + (row_bottom - from.y()) * dxdy - left;
+        accumulate_row(&m_accumulation[(y - band_top) * row_pitch], from_x, to_x, (row_bottom - row_top) * direction);
+    }
+}
+
+void CoverageRasterizer::accumulate_row(float* cells, float from_x, float to_x, float dy) const
+{
+    float width = m_bounds.width();
+    if (from_x > to_x)
+        swap(from_x, to_x);
+
+    // Whatever lies left of the bounds still changes the winding of every pixel in the row, so it's added to the first cell.
+    // Whatever lies right of them doesn't matter at all.
+    if (to_x <= 0.0f) {
+        cells[0] += dy;
+        return;
+    }
+    if (from_x >= width)
+        return;
+
+    float dx = to_x - from_x;
+    if (from_x < 0.0f) {
+        float left_part = dy * (-from_x / dx);
+        cells[0] += left_part;
+        dy -= left_part;
+        dx = to_x;
+        from_x = 0.0f;
+    }
+    if (to_x > width) {
+        dy *= (width - from_x) / dx;
+        dx = width - from_x;
+        to_x = width;
+    }
+
+    int first_column = from_x;
+    int last_column = to_x;
+    if (last_column == first_column || (last_column == first_column + 1 && to_x == last_column)) {
+        // The edge stays within one pixel, so the area to the right of it is a trapezoid.
+        float middle = (from_x + to_x) * 0.5f - first_column;
+        cells[first_column] += dy * (1.0f - middle);
+        cells[first_column + 1] += dy * middle;
+        return;
+    }
+
+    float dy_per_column = dy / dx;
+
+    float first_dy = dy_per_column * (first_column + 1 - from_x);
+    float first_middle = (from_x + first_column + 1) * 0.5f - first_column;
+    cells[first_column] += first_dy * (1.0f - first_middle);
+    cells[first_column + 1] += first_dy * first_middle;
+
+    for (int column = first_column + 1; column < last_column; ++column) {
+        cells[column] += dy_per_column * 0.5f;
+        cells[column + 1] += dy_per_column * 0.5f;
+    }
+
+    if (to_x > last_column) {
+        float last_dy = dy_per_column * (to_x - last_column);
+        float last_middle = (to_x - last_column) * 0.5f;
+        cells[last_column] += last_dy * (1.0f - last_middle);
+        cells[last_column + 1] += last_dy * last_middle;
+    }
+}
+
+}
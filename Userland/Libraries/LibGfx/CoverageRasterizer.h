@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Vector.h>
+#include <LibGfx/AffineTransform.h>
+#include <LibGfx/Painter.h>
+#include <LibGfx/Path.h>
+
+namespace Gfx {
+
+// Fills paths with anti-aliased edges by accumulating the exact area every edge covers in each pixel.
+// Only the rows and columns the path touches inside the clip rect are ever looked at, and they are processed in
+// horizontal bands that don't depend on each other. Each band only needs the edges that cross it and a small
+// accumulation buffer, so bands could be handed to other threads as-is.
+class CoverageRasterizer {
+public:
+    static constexpr int band_height = 16;
+
+    CoverageRasterizer(Painter&, Path const&, AffineTransform const& = {});
+
+    void fill(Color, Painter::WindingRule);
+
+private:
+    struct Edge {
+        FloatPoint from;
+        FloatPoint to;
+    };
+
+    void fill_band(size_t band_index, Color, Painter::WindingRule);
+    void accumulate_edge(Edge const&, int band_top, int band_bottom);
+    void accumulate_row(float* cells, float from_x, float to_x, float dy) const;
+
+    Painter& m_painter;
+    IntRect m_bounds;
+    Vector<Edge> m_edges;
+    Vector<Vector<size_t>> m_edges_by_band;
+    Vector<float> m_accumulation;
+    Vector<u8> m_coverage;
+};
+
+}
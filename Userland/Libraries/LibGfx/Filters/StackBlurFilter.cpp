@@ -10,7 +10,9 @@
 #endif
 
 #include <AK/Array.h>
+#include <AK/BitCast.h>
 #include <AK/Math.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
 
@@ -38,274 +40,112 @@ constexpr auto mult_table = [] {
     return lut;
 }();
 
-// Note: This is named to be consistent with the algorithm, but it's actually a simple circular buffer.
-struct BlurStack {
-    BlurStack(size_t size)
-    {
-        m_data.resize(size);
-    }
-
-    struct Iterator {
-        friend BlurStack;
-
-        ALWAYS_INLINE Color& operator*()
-        {
-            return m_data.at(m_idx);
-        }
-
-        ALWAYS_INLINE Color* operator->()
-        {
-            return &m_data.at(m_idx);
-        }
-
-        ALWAYS_INLINE Iterator operator++()
-        {
-            // Note: This seemed to profile slightly better than %
-            if (++m_idx >= m_data.size())
-                m_idx = 0;
-            return *this;
-        }
-
-        ALWAYS_INLINE Iterator operator++(int)
-        {
-            auto prev_it = *this;
-            ++*(this);
-            return prev_it;
-        }
+using AK::SIMD::u32x4;
+using AK::SIMD::u8x4;
 
-    private:
-        Iterator(size_t idx, Span<Color> data)
-            : m_idx(idx)
-            , m_data(data)
-        {
-        }
-
-        size_t m_idx;
-        Span<Color> m_data;
-    };
-
-    Iterator iterator_from_position(size_t position)
-    {
-        VERIFY(position < m_data.size());
-        return Iterator(position, m_data);
-    }
+// Each pixel is blurred as a vector of its four channels, in memory order (blue, green, red, alpha).
+ALWAYS_INLINE static u32x4 to_channels(ARGB32 pixel)
+{
+    return __builtin_convertvector(bit_cast<u8x4>(pixel), u32x4);
+}
 
-private:
-    Vector<Color, 512> m_data;
-};
+ALWAYS_INLINE static ARGB32 from_channels(u32x4 channels)
+{
+    return bit_cast<ARGB32>(__builtin_convertvector(channels, u8x4));
+}
 
 // This is an implementation of StackBlur by Mario Klingemann (https://observablehq.com/@jobleonard/mario-klingemans-stackblur)
 // (Link is to a secondary source as the original site is now down)
-FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
+// It blurs every row of `source` and writes the result as a column of `destination`. Doing that twice blurs in both directions,
+// while both passes only ever read memory in order.
+static void blur_rows_and_transpose(ARGB32 const* source, size_t source_pitch, ARGB32* destination, size_t destination_pitch, uint width, uint height, uint radius, ARGB32 fill_pixel)
 {
-    // TODO: Implement a plain RGB version of this (if required)
-
-    if (radius == 0)
-        return;
-
-    fill_color = fill_color.with_alpha(0);
-
-    uint width = m_bitmap.width();
-    uint height = m_bitmap.height();
-
     uint div = 2 * radius + 1;
     uint radius_plus_1 = radius + 1;
     uint sum_factor = radius_plus_1 * (radius_plus_1 + 1) / 2;
 
-    auto get_pixel = [&](int x, int y) {
-        auto color = m_bitmap.get_pixel<StorageFormat::BGRA8888>(x, y);
-        if (color.alpha() == 0)
-            return fill_color;
-        return color;
-    };
-
-    auto set_pixel = [&](int x, int y, Color color) {
-        return m_bitmap.set_pixel<StorageFormat::BGRA8888>(x, y, color);
-    };
-
-    BlurStack blur_stack { div };
-    auto const stack_start = blur_stack.iterator_from_position(0);
-    auto const stack_end = blur_stack.iterator_from_position(radius_plus_1);
-    auto stack_iterator = stack_start;
-
     auto const sum_mult = mult_table[radius - 1];
     auto const sum_shift = shift_table[radius - 1];
 
-    for (uint y = 0; y < height; y++) {
-        stack_iterator = stack_start;
+    // Note: This is named to be consistent with the algorithm, but it's actually a simple circular buffer.
+    Array<u32x4, 2 * MAX_RADIUS + 1> stack;
 
-        auto color = get_pixel(0, y);
+    for (uint y = 0; y < height; y++) {
+        auto const* row = source + y * source_pitch;
+        auto get_pixel = [&](uint x) {
+            auto pixel = row[x];
+            if ((pixel >> 24) == 0)
+                pixel = fill_pixel;
+            return to_channels(pixel);
+        };
+
+        auto color = get_pixel(0);
         for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
+            stack[i] = color;
 
         // All the sums here work to approximate a gaussian.
         // Note: Only about 17 bits are actually used in each sum.
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
+        u32x4 in_sum {};
+        u32x4 out_sum = radius_plus_1 * color;
+        u32x4 sum = sum_factor * color;
 
         for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(min(i, width - 1), y);
+            auto color = get_pixel(min(i, width - 1));
+            stack[radius_plus_1 + i - 1] = color;
+            sum += color * (radius_plus_1 - i);
+            in_sum += color;
+        }
+
+        uint stack_in = 0;
+        uint stack_out = radius_plus_1;
 
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
+        for (uint x = 0; x < width; x++) {
+            auto result = (sum * sum_mult) >> sum_shift;
+            destination[x * destination_pitch + y] = result[3] != 0 ? from_channels(result) : fill_pixel;
 
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
+            sum -= out_sum;
+            out_sum -= stack[stack_in];
 
-            ++stack_iterator;
-        }
+            auto color = get_pixel(min(x + radius_plus_1, width - 1));
+            stack[stack_in] = color;
+            in_sum += color;
+            sum += in_sum;
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
+            if (++stack_in >= div)
+                stack_in = 0;
 
-        for (uint x = 0; x < width; x++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(min(x + radius_plus_1, width - 1), y);
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
+            color = stack[stack_out];
+            out_sum += color;
+            in_sum -= color;
+
+            if (++stack_out >= div)
+                stack_out = 0;
         }
     }
+}
 
-    for (uint x = 0; x < width; x++) {
-        stack_iterator = stack_start;
-
-        auto color = get_pixel(x, 0);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
+FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
+{
+    // TODO: Implement a plain RGB version of this (if required)
 
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(x, min(i, height - 1));
+    if (radius == 0)
+        return;
 
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
+    uint width = m_bitmap.width();
+    uint height = m_bitmap.height();
+    if (width == 0 || height == 0)
+        return;
 
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
+    auto fill_pixel = fill_color.with_alpha(0).value();
 
-            ++stack_iterator;
-        }
+    Vector<ARGB32> transposed;
+    if (transposed.try_resize(width * height).is_error())
+        return;
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
-
-        for (uint y = 0; y < height; y++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(x, min(y + radius_plus_1, height - 1));
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
-        }
-    }
+    auto* pixels = m_bitmap.scanline(0);
+    size_t pitch = m_bitmap.pitch() / sizeof(ARGB32);
+    blur_rows_and_transpose(pixels, pitch, transposed.data(), height, width, height, radius, fill_pixel);
+    blur_rows_and_transpose(transposed.data(), height, pixels, pitch, height, width, radius, fill_pixel);
 }
 
 }
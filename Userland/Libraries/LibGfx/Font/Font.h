@@ -159,6 +159,8 @@ public:
 
     Font const& bold_variant() const;
 
+    virtual bool is_scaled_font() const { return false; }
+
 private:
     mutable RefPtr<Gfx::Font> m_bold_variant;
 };
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/LexicalPath.h>
+#include <AK/Queue.h>
+#include <AK/QuickSort.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <LibGfx/Font/BitmapFont.h>
+#include <LibGfx/Font/FontCatalog.h>
+#include <LibGfx/Font/TrueType/Font.h>
+#include <LibGfx/Font/WOFF/Font.h>
+#include <unistd.h>
+
+namespace Gfx {
+
+// The catalog is a header, followed by the directories, the fonts, and finally all of the strings they refer to.
+// Every string is NUL-terminated, and referred to by its offset from the start of the strings.
+static constexpr u32 catalog_magic = 0x54414346; // "FCAT"
+static constexpr u32 catalog_version = 1;
+
+struct [[gnu::packed]] CatalogHeader {
+    u32 magic;
+    u32 version;
+    u32 root_offset;
+    u32 directory_count;
+    u32 font_count;
+    u32 strings_size;
+};
+
+struct [[gnu::packed]] CatalogDirectory {
+    i64 modification_time;
+    u32 path_offset;
+};
+
+struct [[gnu::packed]] CatalogFont {
+    i64 modification_time;
+    u32 path_offset;
+    u32 family_offset;
+    u32 variant_offset;
+    u16 weight;
+    u8 slope;
+    u8 presentation_size;
+    u8 kind;
+    u8 is_fixed_width;
+};
+
+static ErrorOr<i64> modification_time_of(StringView path)
+{
+    auto stat = TRY(Core::System::stat(path));
+    return stat.st_mtime;
+}
+
+static Optional<FontCatalog::Entry> entry_for_font_file(String const& path)
+{
+    FontCatalog::Entry entry;
+    entry.path = path;
+
+    auto fill_in_from_vector_font = [&](VectorFont const& font) {
+        entry.family = font.family();
+        entry.variant = font.variant();
+        entry.weight = font.weight();
+        entry.slope = font.slope();
+        entry.is_fixed_width = font.is_fixed_width();
+    };
+
+    if (path.ends_with(".font"sv)) {
+        auto font_or_error = BitmapFont::try_load_from_file(path);
+        if (font_or_error.is_error())
+            return {};
+        auto font = font_or_error.release_value();
+        entry.kind = FontCatalog::Entry::Kind::Bitmap;
+        entry.family = font->family();
+        entry.variant = font->variant();
+        entry.weight = font->weight();
+        entry.slope = font->slope();
+        entry.presentation_size = font->presentation_size();
+        entry.is_fixed_width = font->is_fixed_width();
+    } else if (path.ends_with(".ttf"sv)) {
+        // FIXME: What about .otf
+        auto font_or_error = TTF::Font::try_load_from_file(path);
+        if (font_or_error.is_error())
+            return {};
+        entry.kind = FontCatalog::Entry::Kind::TrueType;
+        fill_in_from_vector_font(*font_or_error.value());
+    } else if (path.ends_with(".woff"sv)) {
+        auto font_or_error = WOFF::Font::try_load_from_file(path);
+        if (font_or_error.is_error())
+            return {};
+        entry.kind = FontCatalog::Entry::Kind::WOFF;
+        fill_in_from_vector_font(*font_or_error.value());
+    } else {
+        return {};
+    }
+
+    auto modification_time = modification_time_of(path);
+    if (modification_time.is_error())
+        return {};
+    entry.modification_time = modification_time.value();
+    return entry;
+}
+
+String FontCatalog::path_for_directory(StringView root)
+{
+    return String::formatted("{}.catalog", LexicalPath::canonicalized_path(root));
+}
+
+ErrorOr<FontCatalog> FontCatalog::create_by_scanning(String const& root)
+{
+    FontCatalog catalog(LexicalPath::canonicalized_path(root));
+
+    Queue<String> path_queue;
+    path_queue.enqueue(catalog.m_root);
+
+    while (!path_queue.is_empty()) {
+        auto current_directory = path_queue.dequeue();
+        TRY(catalog.m_directories.try_append({ current_directory, TRY(modification_time_of(current_directory)) }));
+
+        Core::DirIterator dir_iterator(current_directory, Core::DirIterator::SkipParentAndBaseDir);
+        if (dir_iterator.has_error())
+            return Error::from_errno(dir_iterator.error());
+        while (dir_iterator.has_next()) {
+            auto path = dir_iterator.next_full_path();
+
+            if (Core::File::is_directory(path)) {
+                path_queue.enqueue(path);
+                continue;
+            }
+
+            if (auto entry = entry_for_font_file(path); entry.has_value())
+                TRY(catalog.m_fonts.try_append(entry.release_value()));
+        }
+    }
+
+    // NOTE: The order of directory entries is arbitrary, this way the same fonts always make the same catalog.
+    quick_sort(catalog.m_fonts, [](auto& a, auto& b) { return a.path < b.path; });
+    return catalog;
+}
+
+ErrorOr<FontCatalog> FontCatalog::load_from_file(String const& root, Validation validation)
+{
+    FontCatalog catalog(LexicalPath::canonicalized_path(root));
+
+    auto file = TRY(Core::MappedFile::map(path_for_directory(catalog.m_root)));
+    auto bytes = file->bytes();
+
+    if (bytes.size() < sizeof(CatalogHeader))
+        return Error::from_string_literal("Font catalog is too small");
+    auto const& header = *reinterpret_cast<CatalogHeader const*>(bytes.data());
+    if (header.magic != catalog_magic || header.version != catalog_version)
+        return Error::from_string_literal("Not a font catalog of this version");
+
+    u64 directories_offset = sizeof(CatalogHeader);
+    u64 fonts_offset = directories_offset + static_cast<u64>(header.directory_count) * sizeof(CatalogDirectory);
+    u64 strings_offset = fonts_offset + static_cast<u64>(header.font_count) * sizeof(CatalogFont);
+    if (strings_offset + header.strings_size != bytes.size())
+        return Error::from_string_literal("Font catalog has the wrong size");
+
+    auto strings = bytes.slice(strings_offset, header.strings_size);
+    auto string_at = [&](u32 offset) -> ErrorOr<StringView> {
+        if (offset >= strings.size())
+            return Error::from_string_literal("Font catalog refers to a string outside of it");
+        auto const* start = reinterpret_cast<char const*>(strings.offset_pointer(offset));
+        auto length = strnlen(start, strings.size() - offset);
+        if (offset + length == strings.size())
+            return Error::from_string_literal("Font catalog has an unterminated string");
+        return StringView { start, length };
+    };
+
+    if (TRY(string_at(header.root_offset)) != catalog.m_root)
+        return Error::from_string_literal("Font catalog is for another directory");
+
+    auto const* directories = reinterpret_cast<CatalogDirectory const*>(bytes.offset_pointer(directories_offset));
+    for (size_t i = 0; i < header.directory_count; ++i) {
+        auto path = TRY(string_at(directories[i].path_offset));
+        auto modification_time = modification_time_of(path);
+        if (modification_time.is_error() || modification_time.value() != directories[i].modification_time)
+            return Error::from_string_literal("Font catalog is out of date");
+        TRY(catalog.m_directories.try_append({ path, directories[i].modification_time }));
+    }
+
+    auto const* fonts = reinterpret_cast<CatalogFont const*>(bytes.offset_pointer(fonts_offset));
+    TRY(catalog.m_fonts.try_ensure_capacity(header.font_count));
+    for (size_t i = 0; i < header.font_count; ++i) {
+        auto const& font = fonts[i];
+        if (font.kind > to_underlying(Entry::Kind::WOFF))
+            return Error::from_string_literal("Font catalog has a font of unknown kind");
+
+        Entry entry;
+        entry.kind = static_cast<Entry::Kind>(font.kind);
+        entry.path = TRY(string_at(font.path_offset));
+        entry.family = TRY(string_at(font.family_offset));
+        entry.variant = TRY(string_at(font.variant_offset));
+        entry.weight = font.weight;
+        entry.slope = font.slope;
+        entry.presentation_size = font.presentation_size;
+        entry.is_fixed_width = font.is_fixed_width;
+        entry.modification_time = font.modification_time;
+
+        if (validation == Validation::DirectoriesAndFiles) {
+            auto modification_time = modification_time_of(entry.path);
+            if (modification_time.is_error() || modification_time.value() != entry.modification_time)
+                return Error::from_string_literal("Font catalog is out of date");
+        }
+
+        catalog.m_fonts.unchecked_append(move(entry));
+    }
+
+    return catalog;
+}
+
+ErrorOr<void> FontCatalog::write_to_file() const
+{
+    ByteBuffer strings;
+    HashMap<String, u32> string_offsets;
+    auto add_string = [&](String const& string) -> ErrorOr<u32> {
+        if (auto offset = string_offsets.get(string); offset.has_value())
+            return offset.value();
+        u32 offset = strings.size();
+        TRY(strings.try_append(string.bytes()));
+        TRY(strings.try_append(0));
+        TRY(string_offsets.try_set(string, offset));
+        return offset;
+    };
+
+    CatalogHeader header {};
+    header.magic = catalog_magic;
+    header.version = catalog_version;
+    header.root_offset = TRY(add_string(m_root));
+    header.directory_count = m_directories.size();
+    header.font_count = m_fonts.size();
+
+    Vector<CatalogDirectory> directories;
+    TRY(directories.try_ensure_capacity(m_directories.size()));
+    for (auto& directory : m_directories)
+        directories.unchecked_append({ directory.modification_time, TRY(add_string(directory.path)) });
+
+    Vector<CatalogFont> fonts;
+    TRY(fonts.try_ensure_capacity(m_fonts.size()));
+    for (auto& entry : m_fonts) {
+        CatalogFont font {};
+        font.modification_time = entry.modification_time;
+        font.path_offset = TRY(add_string(entry.path));
+        font.family_offset = TRY(add_string(entry.family));
+        font.variant_offset = TRY(add_string(entry.variant));
+        font.weight = entry.weight;
+        font.slope = entry.slope;
+        font.presentation_size = entry.presentation_size;
+        font.kind = to_underlying(entry.kind);
+        font.is_fixed_width = entry.is_fixed_width;
+        fonts.unchecked_append(font);
+    }
+    header.strings_size = strings.size();
+
+    ByteBuffer contents;
+    TRY(contents.try_append(&header, sizeof(header)));
+    TRY(contents.try_append(directories.data(), directories.size() * sizeof(CatalogDirectory)));
+    TRY(contents.try_append(fonts.data(), fonts.size() * sizeof(CatalogFont)));
+    TRY(contents.try_append(strings));
+
+    // NOTE: Processes may be reading the catalog while we're writing it, so it has to be replaced in one go.
+    auto path = path_for_directory(m_root);
+    auto temporary_path = String::formatted("{}.tmp-{}", path, getpid());
+    {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate, 0644));
+        if (!file->write_or_error(contents))
+            return Error::from_string_literal("Failed to write the font catalog");
+    }
+    TRY(Core::System::rename(temporary_path, path));
+    return {};
+}
+
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+namespace Gfx {
+
+// Describes every font below a directory, so that a process can find out which fonts there are without opening each of them.
+// The catalog is kept next to the directory it describes (e.g. /res/fonts.catalog for /res/fonts), and is written by fontcatalog(1).
+class FontCatalog {
+public:
+    struct Entry {
+        enum class Kind : u8 {
+            Bitmap,
+            TrueType,
+            WOFF,
+        };
+
+        Kind kind { Kind::Bitmap };
+        String path;
+        String family;
+        String variant;
+        u16 weight { 0 };
+        u8 slope { 0 };
+        // Only bitmap fonts have a presentation size, vector fonts can be drawn at any size.
+        u8 presentation_size { 0 };
+        bool is_fixed_width { false };
+        i64 modification_time { 0 };
+    };
+
+    enum class Validation {
+        // Checks that no file has been added to or removed from any of the directories. This only has to look at the directories.
+        Directories,
+        // Also checks that none of the fonts has been changed in place.
+        DirectoriesAndFiles,
+    };
+
+    static String path_for_directory(StringView root);
+
+    static ErrorOr<FontCatalog> create_by_scanning(String const& root);
+    // Fails if there is no catalog for the directory, or if it's out of date.
+    static ErrorOr<FontCatalog> load_from_file(String const& root, Validation = Validation::Directories);
+
+    ErrorOr<void> write_to_file() const;
+
+    String const& root() const { return m_root; }
+    Vector<Entry> const& fonts() const { return m_fonts; }
+
+private:
+    struct Directory {
+        String path;
+        i64 modification_time { 0 };
+    };
+
+    explicit FontCatalog(String root)
+        : m_root(move(root))
+    {
+    }
+
+    String m_root;
+    Vector<Directory> m_directories;
+    Vector<Entry> m_fonts;
+};
+
+}
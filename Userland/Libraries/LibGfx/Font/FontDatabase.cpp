@@ -11,6 +11,7 @@
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
 #include <LibGfx/Font/Font.h>
+#include <LibGfx/Font/FontCatalog.h>
 #include <LibGfx/Font/FontDatabase.h>
 #include <LibGfx/Font/TrueType/Font.h>
 #include <LibGfx/Font/Typeface.h>
@@ -118,10 +119,29 @@ Font& FontDatabase::default_fixed_width_font()
 }
 
 struct FontDatabase::Private {
-    HashMap<String, NonnullRefPtr<Gfx::Font>> full_name_to_font_map;
+    struct NamedBitmapFont {
+        NonnullRefPtr<Typeface> typeface;
+        u8 presentation_size { 0 };
+        bool is_fixed_width { false };
+    };
+
+    // The bitmap fonts by their qualified name, e.g. "Katica 10 400 0". They're loaded by their typeface when they're first asked for.
+    HashMap<String, NamedBitmapFont> full_name_to_font_map;
     HashMap<FlyString, Vector<NonnullRefPtr<Typeface>>> typefaces;
 };
 
+void FontDatabase::load_fonts_from_catalog(FontCatalog const& catalog)
+{
+    for (auto& entry : catalog.fonts()) {
+        auto typeface = get_or_create_typeface(entry.family, entry.variant);
+        typeface->add_font_from_catalog(entry);
+        if (entry.kind == FontCatalog::Entry::Kind::Bitmap) {
+            auto qualified_name = String::formatted("{} {} {} {}", entry.family, entry.presentation_size, entry.weight, entry.slope);
+            m_private->full_name_to_font_map.set(move(qualified_name), { typeface.release_nonnull(), entry.presentation_size, entry.is_fixed_width });
+        }
+    }
+}
+
 void FontDatabase::load_all_fonts_from_path(String const& root)
 {
     Queue<String> path_queue;
@@ -145,9 +165,9 @@ void FontDatabase::load_all_fonts_from_path(String const& root)
             if (path.ends_with(".font"sv)) {
                 if (auto font_or_error = Gfx::BitmapFont::try_load_from_file(path); !font_or_error.is_error()) {
                     auto font = font_or_error.release_value();
-                    m_private->full_name_to_font_map.set(font->qualified_name(), *font);
                     auto typeface = get_or_create_typeface(font->family(), font->variant());
                     typeface->add_bitmap_font(font);
+                    m_private->full_name_to_font_map.set(font->qualified_name(), { typeface.release_nonnull(), font->presentation_size(), font->is_fixed_width() });
                 }
             } else if (path.ends_with(".ttf"sv)) {
                 // FIXME: What about .otf
@@ -170,31 +190,43 @@ void FontDatabase::load_all_fonts_from_path(String const& root)
 FontDatabase::FontDatabase()
     : m_private(make<Private>())
 {
+    // NOTE: Opening every font just to find out what it is takes a while, so we'd much rather go by the catalog.
+    auto catalog = FontCatalog::load_from_file(s_default_fonts_lookup_path);
+    if (!catalog.is_error()) {
+        load_fonts_from_catalog(catalog.value());
+        return;
+    }
+    if (!catalog.error().is_errno() || catalog.error().code() != ENOENT)
+        dbgln("FontDatabase: Not using the font catalog: {}", catalog.error());
     load_all_fonts_from_path(s_default_fonts_lookup_path);
 }
 
 void FontDatabase::for_each_font(Function<void(Gfx::Font const&)> callback)
 {
-    Vector<RefPtr<Gfx::Font>> fonts;
-    fonts.ensure_capacity(m_private->full_name_to_font_map.size());
+    Vector<String> names;
+    names.ensure_capacity(m_private->full_name_to_font_map.size());
     for (auto& it : m_private->full_name_to_font_map)
-        fonts.append(it.value);
-    quick_sort(fonts, [](auto& a, auto& b) { return a->qualified_name() < b->qualified_name(); });
-    for (auto& font : fonts)
-        callback(*font);
+        names.append(it.key);
+    quick_sort(names);
+    for (auto& name : names) {
+        if (auto font = get_by_name(name))
+            callback(*font);
+    }
 }
 
 void FontDatabase::for_each_fixed_width_font(Function<void(Gfx::Font const&)> callback)
 {
-    Vector<RefPtr<Gfx::Font>> fonts;
-    fonts.ensure_capacity(m_private->full_name_to_font_map.size());
+    Vector<String> names;
+    names.ensure_capacity(m_private->full_name_to_font_map.size());
     for (auto& it : m_private->full_name_to_font_map) {
-        if (it.value->is_fixed_width())
-            fonts.append(it.value);
+        if (it.value.is_fixed_width)
+            names.append(it.key);
+    }
+    quick_sort(names);
+    for (auto& name : names) {
+        if (auto font = get_by_name(name))
+            callback(*font);
     }
-    quick_sort(fonts, [](auto& a, auto& b) { return a->qualified_name() < b->qualified_name(); });
-    for (auto& font : fonts)
-        callback(*font);
 }
 
 RefPtr<Gfx::Font> FontDatabase::get_by_name(StringView name)
@@ -212,7 +244,7 @@ RefPtr<Gfx::Font> FontDatabase::get_by_name(StringView name)
         dbgln("Font lookup failed: '{}'", name);
         return nullptr;
     }
-    return it->value;
+    return it->value.typeface->get_font(it->value.presentation_size);
 }
 
 RefPtr<Gfx::Font> FontDatabase::get(FlyString const& family, float point_size, unsigned weight, unsigned slope, Font::AllowInexactSizeMatch allow_inexact_size_match)
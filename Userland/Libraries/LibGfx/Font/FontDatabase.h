@@ -63,6 +63,7 @@ private:
     ~FontDatabase() = default;
 
     void load_fonts();
+    void load_fonts_from_catalog(FontCatalog const&);
 
     RefPtr<Typeface> get_or_create_typeface(String const& family, String const& variant);
 
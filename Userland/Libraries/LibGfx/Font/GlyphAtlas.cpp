@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/GlyphAtlas.h>
+#include <LibGfx/Font/ScaledFont.h>
+
+namespace Gfx {
+
+GlyphAtlas& GlyphAtlas::the()
+{
+    static GlyphAtlas s_the;
+    return s_the;
+}
+
+Optional<GlyphAtlas::Glyph> GlyphAtlas::glyph(ScaledFont const& font, u32 glyph_id, int subpixel_position)
+{
+    VERIFY(subpixel_position >= 0 && subpixel_position < subpixel_positions);
+    Key key { font.font_id(), glyph_id, static_cast<u8>(subpixel_position) };
+
+    if (auto it = m_locations.find(key); it != m_locations.end()) {
+        m_pages[it->value.page_index].last_used = ++m_use_counter;
+        return glyph_at(it->value);
+    }
+
+    auto bitmap = font.rasterize_glyph(glyph_id, GlyphSubpixelOffset { subpixel_offset_for_position(subpixel_position) });
+    if (!bitmap || bitmap->width() > page_size || bitmap->height() > page_size)
+        return {};
+
+    auto location = allocate(bitmap->size());
+    if (!location.has_value())
+        return {};
+
+    auto& page = m_pages[location->page_index];
+    page.keys.append(key);
+    page.last_used = ++m_use_counter;
+    m_locations.set(key, *location);
+
+    // The rasterizer only ever produces white pixels, so all we need to keep around is their alpha.
+    auto const& rect = location->rect;
+    for (int y = 0; y < rect.height(); ++y) {
+        auto const* source = bitmap->scanline(y);
+        auto* destination = &page.coverage[(rect.y() + y) * page_size + rect.x()];
+        for (int x = 0; x < rect.width(); ++x)
+            destination[x] = source[x] >> 24;
+    }
+
+    return glyph_at(*location);
+}
+
+GlyphAtlas::Glyph GlyphAtlas::glyph_at(Location const& location)
+{
+    auto& page = m_pages[location.page_index];
+    return Glyph {
+        .coverage = &page.coverage[location.rect.y() * page_size + location.rect.x()],
+        .pitch = page_size,
+        .size = location.rect.size(),
+    };
+}
+
+Optional<GlyphAtlas::Location> GlyphAtlas::allocate(IntSize size)
+{
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (auto rect = allocate_in_page(m_pages[i], size); rect.has_value())
+            return Location { i, *rect };
+    }
+
+    if (m_pages.size() < max_page_count) {
+        auto page = make<Page>();
+        if (page->coverage.try_resize(page_size * page_size).is_error())
+            return {};
+        m_pages.append(move(page));
+        auto rect = allocate_in_page(m_pages.last(), size);
+        VERIFY(rect.has_value());
+        return Location { m_pages.size() - 1, *rect };
+    }
+
+    size_t least_recently_used = 0;
+    for (size_t i = 1; i < m_pages.size(); ++i) {
+        if (m_pages[i].last_used < m_pages[least_recently_used].last_used)
+            least_recently_used = i;
+    }
+    clear_page(least_recently_used);
+    auto rect = allocate_in_page(m_pages[least_recently_used], size);
+    VERIFY(rect.has_value());
+    return Location { least_recently_used, *rect };
+}
+
+Optional<IntRect> GlyphAtlas::allocate_in_page(Page& page, IntSize size)
+{
+    // Glyphs are packed into horizontal shelves. A shelf is only reused for glyphs that are about as tall as it is,
+    // so that small glyphs don't waste the space in a tall shelf.
+    for (auto& shelf : page.shelves) {
+        if (shelf.height < size.height() || shelf.height > size.height() + size.height() / 4 + 2)
+            continue;
+        if (shelf.used_width + size.width() > page_size)
+            continue;
+        IntRect rect { shelf.used_width, shelf.y, size.width(), size.height() };
+        shelf.used_width += size.width();
+        return rect;
+    }
+
+    if (page.used_height + size.height() > page_size)
+        return {};
+
+    page.shelves.append({ .y = page.used_height, .height = size.height(), .used_width = size.width() });
+    IntRect rect { 0, page.used_height, size.width(), size.height() };
+    page.used_height += size.height();
+    return rect;
+}
+
+void GlyphAtlas::clear_page(size_t page_index)
+{
+    auto& page = m_pages[page_index];
+    for (auto const& key : page.keys)
+        m_locations.remove(key);
+    page.keys.clear();
+    page.shelves.clear();
+    page.used_height = 0;
+}
+
+}
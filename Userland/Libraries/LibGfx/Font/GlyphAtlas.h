@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibGfx/Forward.h>
+#include <LibGfx/Rect.h>
+
+namespace Gfx {
+
+// Keeps the rasterized glyphs of all vector fonts packed into a few shared pages of coverage values.
+// Each font size gets its own entries, and every glyph can have up to subpixel_positions variants, which are only
+// rasterized once somebody draws them. Since all of them share the same fixed amount of memory, subpixel positioning
+// only ever costs rasterization time. When the pages are full, the least recently used one is thrown out.
+class GlyphAtlas {
+public:
+    static constexpr int subpixel_positions = 4;
+    static constexpr int page_size = 512;
+    static constexpr size_t max_page_count = 8;
+
+    struct Glyph {
+        u8 const* coverage { nullptr };
+        size_t pitch { 0 };
+        IntSize size;
+
+        u8 coverage_at(int x, int y) const { return coverage[y * pitch + x]; }
+    };
+
+    static GlyphAtlas& the();
+
+    // Returns a glyph rasterized at the given subpixel position (0 to subpixel_positions - 1), or nothing if it is too
+    // big for the atlas. The coverage stays valid until the next call.
+    Optional<Glyph> glyph(ScaledFont const&, u32 glyph_id, int subpixel_position);
+
+    static float subpixel_offset_for_position(int position) { return static_cast<float>(position) / subpixel_positions; }
+
+private:
+    GlyphAtlas() = default;
+
+    struct Key {
+        u32 font_id { 0 };
+        u32 glyph_id { 0 };
+        u8 subpixel_position { 0 };
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public GenericTraits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(pair_int_hash(key.font_id, key.glyph_id), key.subpixel_position); }
+    };
+
+    struct Location {
+        size_t page_index { 0 };
+        IntRect rect;
+    };
+
+    struct Shelf {
+        int y { 0 };
+        int height { 0 };
+        int used_width { 0 };
+    };
+
+    struct Page {
+        Vector<u8> coverage;
+        Vector<Shelf> shelves;
+        Vector<Key> keys;
+        int used_height { 0 };
+        u64 last_used { 0 };
+    };
+
+    Glyph glyph_at(Location const&);
+    Optional<Location> allocate(IntSize);
+    Optional<IntRect> allocate_in_page(Page&, IntSize);
+    void clear_page(size_t page_index);
+
+    HashMap<Key, Location, KeyTraits> m_locations;
+    NonnullOwnPtrVector<Page> m_pages;
+    u64 m_use_counter { 0 };
+};
+
+}
@@ -4,15 +4,39 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/UnicodeUtils.h>
 #include <AK/Utf32View.h>
 #include <AK/Utf8View.h>
 #include <LibGfx/Font/ScaledFont.h>
+#include <LibGfx/Font/TextWidthCache.h>
 
 namespace Gfx {
 
-int ScaledFont::width(StringView view) const { return unicode_view_width(Utf8View(view)); }
-int ScaledFont::width(Utf8View const& view) const { return unicode_view_width(view); }
-int ScaledFont::width(Utf32View const& view) const { return unicode_view_width(view); }
+int ScaledFont::width(StringView view) const { return cached_width(view, [&] { return unicode_view_width(Utf8View(view)); }); }
+int ScaledFont::width(Utf8View const& view) const { return cached_width(view.as_string(), [&] { return unicode_view_width(view); }); }
+
+int ScaledFont::width(Utf32View const& view) const
+{
+    // The cache is keyed by UTF-8, so short runs are encoded on the stack first.
+    Vector<u8, TextWidthCache::max_text_length> utf8;
+    for (auto code_point : view) {
+        (void)AK::UnicodeUtils::code_point_to_utf8(code_point, [&](char byte) { utf8.append(byte); });
+        if (utf8.size() > TextWidthCache::max_text_length)
+            return unicode_view_width(view);
+    }
+    return cached_width(StringView { utf8.data(), utf8.size() }, [&] { return unicode_view_width(view); });
+}
+
+template<typename Callback>
+int ScaledFont::cached_width(StringView text, Callback measure) const
+{
+    auto& cache = TextWidthCache::the();
+    if (auto width = cache.get(m_font_id, text); width.has_value())
+        return *width;
+    auto width = measure();
+    cache.set(m_font_id, text, width);
+    return width;
+}
 
 template<typename T>
 ALWAYS_INLINE int ScaledFont::unicode_view_width(T const& view) const
@@ -44,7 +68,7 @@ RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id) const
     if (glyph_iterator != m_cached_glyph_bitmaps.end())
         return glyph_iterator->value;
 
-    auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale);
+    auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, {});
     m_cached_glyph_bitmaps.set(glyph_id, glyph_bitmap);
     return glyph_bitmap;
 }
@@ -22,6 +22,7 @@ public:
         : m_font(move(font))
         , m_point_width(point_width)
         , m_point_height(point_height)
+        , m_font_id(next_font_id())
     {
         float units_per_em = m_font->units_per_em();
         m_x_scale = (point_width * dpi_x) / (POINTS_PER_INCH * units_per_em);
@@ -31,6 +32,11 @@ public:
     ScaledFontMetrics metrics() const { return m_font->metrics(m_x_scale, m_y_scale); }
     ScaledGlyphMetrics glyph_metrics(u32 glyph_id) const { return m_font->glyph_metrics(glyph_id, m_x_scale, m_y_scale); }
     RefPtr<Gfx::Bitmap> rasterize_glyph(u32 glyph_id) const;
+    RefPtr<Gfx::Bitmap> rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const { return m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, subpixel_offset); }
+
+    // Identifies this font in process-wide caches like the GlyphAtlas and the TextWidthCache. These are never reused,
+    // so the caches can't confuse a font that went away with a new one.
+    u32 font_id() const { return m_font_id; }
 
     // ^Gfx::Font
     virtual NonnullRefPtr<Font> clone() const override { return *this; } // FIXME: clone() should not need to be implemented
@@ -64,6 +70,7 @@ public:
     virtual String variant() const override { return m_font->variant(); }
     virtual String qualified_name() const override { return String::formatted("{} {} {} {}", family(), presentation_size(), weight(), slope()); }
     virtual String human_readable_name() const override { return String::formatted("{} {} {}", family(), variant(), presentation_size()); }
+    virtual bool is_scaled_font() const override { return true; }
 
 private:
     NonnullRefPtr<VectorFont> m_font;
@@ -71,10 +78,19 @@ private:
     float m_y_scale { 0.0f };
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
+    u32 m_font_id { 0 };
     mutable HashMap<u32, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
 
+    static u32 next_font_id()
+    {
+        static u32 s_next_font_id = 0;
+        return ++s_next_font_id;
+    }
+
     template<typename T>
     int unicode_view_width(T const& view) const;
+    template<typename Callback>
+    int cached_width(StringView text, Callback measure) const;
 };
 
 }
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Font/TextWidthCache.h>
+
+namespace Gfx {
+
+TextWidthCache& TextWidthCache::the()
+{
+    static TextWidthCache s_the;
+    return s_the;
+}
+
+Optional<int> TextWidthCache::get(u32 font_id, StringView text)
+{
+    if (text.length() > max_text_length)
+        return {};
+
+    auto it = m_entries.find(hash(font_id, text), [&](auto& entry) {
+        return entry->font_id == font_id && entry->text == text;
+    });
+    if (it == m_entries.end())
+        return {};
+
+    auto& entry = **it;
+    m_lru.remove(entry);
+    m_lru.append(entry);
+    return entry.width;
+}
+
+void TextWidthCache::set(u32 font_id, StringView text, int width)
+{
+    if (text.length() > max_text_length)
+        return;
+
+    auto it = m_entries.find(hash(font_id, text), [&](auto& entry) {
+        return entry->font_id == font_id && entry->text == text;
+    });
+    if (it != m_entries.end()) {
+        (*it)->width = width;
+        return;
+    }
+
+    if (m_entries.size() >= max_entry_count) {
+        auto* least_recently_used = m_lru.take_first();
+        auto lru_it = m_entries.find(hash(least_recently_used->font_id, least_recently_used->text), [&](auto& entry) {
+            return entry.ptr() == least_recently_used;
+        });
+        VERIFY(lru_it != m_entries.end());
+        m_entries.remove(lru_it);
+    }
+
+    auto entry = make<Entry>();
+    entry->font_id = font_id;
+    entry->text = text;
+    entry->width = width;
+    m_lru.append(*entry);
+    m_entries.set(move(entry));
+}
+
+}
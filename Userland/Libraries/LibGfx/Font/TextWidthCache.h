@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+
+namespace Gfx {
+
+// Remembers how wide short runs of text are in a given vector font, so that relayouts don't have to look up every glyph again.
+// It is shared by all fonts in the process and holds at most max_entry_count runs, throwing out the least recently used ones.
+class TextWidthCache {
+public:
+    static constexpr size_t max_text_length = 128;
+    static constexpr size_t max_entry_count = 8192;
+
+    static TextWidthCache& the();
+
+    Optional<int> get(u32 font_id, StringView text);
+    void set(u32 font_id, StringView text, int width);
+
+private:
+    TextWidthCache() = default;
+
+    struct Entry {
+        u32 font_id { 0 };
+        String text;
+        int width { 0 };
+        IntrusiveListNode<Entry> lru_node;
+    };
+
+    static unsigned hash(u32 font_id, StringView text) { return pair_int_hash(font_id, text.hash()); }
+
+    struct EntryTraits : public GenericTraits<NonnullOwnPtr<Entry>> {
+        static unsigned hash(NonnullOwnPtr<Entry> const& entry) { return TextWidthCache::hash(entry->font_id, entry->text); }
+        static bool equals(NonnullOwnPtr<Entry> const& a, NonnullOwnPtr<Entry> const& b) { return a->font_id == b->font_id && a->text == b->text; }
+    };
+
+    HashTable<NonnullOwnPtr<Entry>, EntryTraits> m_entries;
+    IntrusiveList<&Entry::lru_node> m_lru;
+};
+
+}
@@ -5,83 +5,132 @@
  */
 
 #include <LibGfx/Font/ScaledFont.h>
+#include <LibGfx/Font/TrueType/Font.h>
 #include <LibGfx/Font/Typeface.h>
+#include <LibGfx/Font/WOFF/Font.h>
 
 namespace Gfx {
 
 unsigned Typeface::weight() const
 {
-    VERIFY(m_vector_font || m_bitmap_fonts.size() > 0);
+    VERIFY(m_vector_font.has_value() || m_bitmap_fonts.size() > 0);
 
     if (is_fixed_size())
-        return m_bitmap_fonts[0]->weight();
+        return m_bitmap_fonts[0].weight;
 
-    return m_vector_font->weight();
+    return m_vector_font->weight;
 }
 
 u8 Typeface::slope() const
 {
-    VERIFY(m_vector_font || m_bitmap_fonts.size() > 0);
+    VERIFY(m_vector_font.has_value() || m_bitmap_fonts.size() > 0);
 
     if (is_fixed_size())
-        return m_bitmap_fonts[0]->slope();
+        return m_bitmap_fonts[0].slope;
 
-    return m_vector_font->slope();
+    return m_vector_font->slope;
 }
 
 bool Typeface::is_fixed_width() const
 {
-    VERIFY(m_vector_font || m_bitmap_fonts.size() > 0);
+    VERIFY(m_vector_font.has_value() || m_bitmap_fonts.size() > 0);
 
     if (is_fixed_size())
-        return m_bitmap_fonts[0]->is_fixed_width();
+        return m_bitmap_fonts[0].is_fixed_width;
 
-    return m_vector_font->is_fixed_width();
+    return m_vector_font->is_fixed_width;
 }
 
 void Typeface::add_bitmap_font(RefPtr<BitmapFont> font)
 {
-    m_bitmap_fonts.append(font);
+    m_bitmap_fonts.append({ font->presentation_size(), font->weight(), font->slope(), font->is_fixed_width(), {}, font });
 }
 
 void Typeface::set_vector_font(RefPtr<VectorFont> font)
 {
-    m_vector_font = move(font);
+    if (!font) {
+        m_vector_font = {};
+        return;
+    }
+    m_vector_font = VectorFontSource { font->weight(), font->slope(), font->is_fixed_width(), {}, {}, move(font) };
+}
+
+void Typeface::add_font_from_catalog(FontCatalog::Entry const& entry)
+{
+    if (entry.kind == FontCatalog::Entry::Kind::Bitmap)
+        m_bitmap_fonts.append({ entry.presentation_size, entry.weight, entry.slope, entry.is_fixed_width, entry.path, {} });
+    else
+        m_vector_font = VectorFontSource { entry.weight, entry.slope, entry.is_fixed_width, entry.kind, entry.path, {} };
+}
+
+RefPtr<BitmapFont> Typeface::load(BitmapFontSource const& source)
+{
+    if (source.path.is_null())
+        return source.font;
+
+    auto font_or_error = BitmapFont::try_load_from_file(source.path);
+    if (font_or_error.is_error())
+        dbgln("Typeface: Failed to load {}: {}", source.path, font_or_error.error());
+    else
+        source.font = font_or_error.release_value();
+    source.path = {};
+    return source.font;
+}
+
+RefPtr<VectorFont> Typeface::load(VectorFontSource const& source)
+{
+    if (source.path.is_null())
+        return source.font;
+
+    auto font_or_error = [&]() -> ErrorOr<NonnullRefPtr<VectorFont>> {
+        if (source.kind == FontCatalog::Entry::Kind::WOFF)
+            return TRY(WOFF::Font::try_load_from_file(source.path));
+        return TRY(TTF::Font::try_load_from_file(source.path));
+    }();
+    if (font_or_error.is_error())
+        dbgln("Typeface: Failed to load {}: {}", source.path, font_or_error.error());
+    else
+        source.font = font_or_error.release_value();
+    source.path = {};
+    return source.font;
 }
 
 RefPtr<Font> Typeface::get_font(float point_size, Font::AllowInexactSizeMatch allow_inexact_size_match) const
 {
     VERIFY(point_size > 0);
 
-    if (m_vector_font)
-        return adopt_ref(*new Gfx::ScaledFont(*m_vector_font, point_size, point_size));
+    if (m_vector_font.has_value()) {
+        if (auto vector_font = load(*m_vector_font))
+            return adopt_ref(*new Gfx::ScaledFont(*vector_font, point_size, point_size));
+    }
 
-    RefPtr<BitmapFont> best_match;
+    BitmapFontSource const* best_match = nullptr;
     int size = roundf(point_size);
     int best_delta = NumericLimits<int>::max();
 
-    for (auto font : m_bitmap_fonts) {
-        if (font->presentation_size() == size)
-            return font;
+    for (auto& source : m_bitmap_fonts) {
+        if (source.presentation_size == size)
+            return load(source);
         if (allow_inexact_size_match == Font::AllowInexactSizeMatch::Yes) {
-            int delta = static_cast<int>(font->presentation_size()) - static_cast<int>(size);
+            int delta = static_cast<int>(source.presentation_size) - static_cast<int>(size);
             if (abs(delta) < best_delta) {
-                best_match = font;
+                best_match = &source;
                 best_delta = abs(delta);
             }
         }
     }
 
     if (allow_inexact_size_match == Font::AllowInexactSizeMatch::Yes && best_match)
-        return best_match;
+        return load(*best_match);
 
     return {};
 }
 
 void Typeface::for_each_fixed_size_font(Function<void(Font const&)> callback) const
 {
-    for (auto font : m_bitmap_fonts) {
-        callback(*font);
+    for (auto& source : m_bitmap_fonts) {
+        if (auto font = load(source))
+            callback(*font);
     }
 }
 
@@ -12,6 +12,7 @@
 #include <AK/Vector.h>
 #include <LibGfx/Font/BitmapFont.h>
 #include <LibGfx/Font/Font.h>
+#include <LibGfx/Font/FontCatalog.h>
 #include <LibGfx/Font/VectorFont.h>
 
 namespace Gfx {
@@ -35,15 +36,39 @@ public:
 
     void add_bitmap_font(RefPtr<BitmapFont>);
     void set_vector_font(RefPtr<VectorFont>);
+    // The font is only loaded from its file once it's asked for.
+    void add_font_from_catalog(FontCatalog::Entry const&);
 
     RefPtr<Font> get_font(float point_size, Font::AllowInexactSizeMatch = Font::AllowInexactSizeMatch::No) const;
 
 private:
+    struct BitmapFontSource {
+        u8 presentation_size { 0 };
+        unsigned weight { 0 };
+        u8 slope { 0 };
+        bool is_fixed_width { false };
+        // Null once the font has been loaded, or if it failed to load.
+        mutable String path;
+        mutable RefPtr<BitmapFont> font;
+    };
+
+    struct VectorFontSource {
+        unsigned weight { 0 };
+        u8 slope { 0 };
+        bool is_fixed_width { false };
+        FontCatalog::Entry::Kind kind { FontCatalog::Entry::Kind::TrueType };
+        mutable String path;
+        mutable RefPtr<VectorFont> font;
+    };
+
+    static RefPtr<BitmapFont> load(BitmapFontSource const&);
+    static RefPtr<VectorFont> load(VectorFontSource const&);
+
     FlyString m_family;
     FlyString m_variant;
 
-    Vector<RefPtr<BitmapFont>> m_bitmap_fonts;
-    RefPtr<VectorFont> m_vector_font;
+    Vector<BitmapFontSource> m_bitmap_fonts;
+    Optional<VectorFontSource> m_vector_font;
 };
 
 }
@@ -8,9 +8,13 @@
 #include <AK/HashMap.h>
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMDExtras.h>
+#include <AK/SIMDMath.h>
 #include <AK/Vector.h>
 #include <LibGfx/JPGLoader.h>
 
+#pragma GCC diagnostic ignored "-Wpsabi"
+
 #define JPG_INVALID 0X0000
 
 #define JPG_APPN0 0XFFE0
@@ -864,7 +868,33 @@ static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macrobloc
     }
 }
 
-static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+
+static ALWAYS_INLINE f32x4 load_coefficients(i32 const* coefficients)
+{
+    return AK::SIMD::to_f32x4(i32x4 { coefficients[0], coefficients[1], coefficients[2], coefficients[3] });
+}
+
+static ALWAYS_INLINE void store_coefficients(i32* coefficients, f32x4 values)
+{
+    auto integers = AK::SIMD::to_i32x4(values);
+    coefficients[0] = integers[0];
+    coefficients[1] = integers[1];
+    coefficients[2] = integers[2];
+    coefficients[3] = integers[3];
+}
+
+static ALWAYS_INLINE void transpose_block(i32* block_component)
+{
+    for (u32 i = 0; i < 8; ++i) {
+        for (u32 j = i + 1; j < 8; ++j)
+            swap(block_component[i * 8 + j], block_component[j * 8 + i]);
+    }
+}
+
+// Runs the one-dimensional IDCT down the columns of a block, four columns at a time.
+static ALWAYS_INLINE void inverse_dct_columns(i32* block_component)
 {
     static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
     static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
@@ -881,6 +911,77 @@ static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& ma
     static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
 
+    for (u32 k = 0; k < 8; k += 4) {
+        f32x4 const g0 = load_coefficients(&block_component[0 * 8 + k]) * s0;
+        f32x4 const g1 = load_coefficients(&block_component[4 * 8 + k]) * s4;
+        f32x4 const g2 = load_coefficients(&block_component[2 * 8 + k]) * s2;
+        f32x4 const g3 = load_coefficients(&block_component[6 * 8 + k]) * s6;
+        f32x4 const g4 = load_coefficients(&block_component[5 * 8 + k]) * s5;
+        f32x4 const g5 = load_coefficients(&block_component[1 * 8 + k]) * s1;
+        f32x4 const g6 = load_coefficients(&block_component[7 * 8 + k]) * s7;
+        f32x4 const g7 = load_coefficients(&block_component[3 * 8 + k]) * s3;
+
+        f32x4 const f0 = g0;
+        f32x4 const f1 = g1;
+        f32x4 const f2 = g2;
+        f32x4 const f3 = g3;
+        f32x4 const f4 = g4 - g7;
+        f32x4 const f5 = g5 + g6;
+        f32x4 const f6 = g5 - g6;
+        f32x4 const f7 = g4 + g7;
+
+        f32x4 const e0 = f0;
+        f32x4 const e1 = f1;
+        f32x4 const e2 = f2 - f3;
+        f32x4 const e3 = f2 + f3;
+        f32x4 const e4 = f4;
+        f32x4 const e5 = f5 - f7;
+        f32x4 const e6 = f6;
+        f32x4 const e7 = f5 + f7;
+        f32x4 const e8 = f4 + f6;
+
+        f32x4 const d0 = e0;
+        f32x4 const d1 = e1;
+        f32x4 const d2 = e2 * m1;
+        f32x4 const d3 = e3;
+        f32x4 const d4 = e4 * m2;
+        f32x4 const d5 = e5 * m3;
+        f32x4 const d6 = e6 * m4;
+        f32x4 const d7 = e7;
+        f32x4 const d8 = e8 * m5;
+
+        f32x4 const c0 = d0 + d1;
+        f32x4 const c1 = d0 - d1;
+        f32x4 const c2 = d2 - d3;
+        f32x4 const c3 = d3;
+        f32x4 const c4 = d4 + d8;
+        f32x4 const c5 = d5 + d7;
+        f32x4 const c6 = d6 - d8;
+        f32x4 const c7 = d7;
+        f32x4 const c8 = c5 - c6;
+
+        f32x4 const b0 = c0 + c3;
+        f32x4 const b1 = c1 + c2;
+        f32x4 const b2 = c1 - c2;
+        f32x4 const b3 = c0 - c3;
+        f32x4 const b4 = c4 - c8;
+        f32x4 const b5 = c8;
+        f32x4 const b6 = c6 - c7;
+        f32x4 const b7 = c7;
+
+        store_coefficients(&block_component[0 * 8 + k], b0 + b7);
+        store_coefficients(&block_component[1 * 8 + k], b1 + b6);
+        store_coefficients(&block_component[2 * 8 + k], b2 + b5);
+        store_coefficients(&block_component[3 * 8 + k], b3 + b4);
+        store_coefficients(&block_component[4 * 8 + k], b3 - b4);
+        store_coefficients(&block_component[5 * 8 + k], b2 - b5);
+        store_coefficients(&block_component[6 * 8 + k], b1 - b6);
+        store_coefficients(&block_component[7 * 8 + k], b0 - b7);
+    }
+}
+
+static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+{
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (u32 component_i = 0; component_i < context.component_count; component_i++) {
@@ -890,140 +991,12 @@ static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& ma
                         u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[mb_index];
                         i32* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            float const g0 = block_component[0 * 8 + k] * s0;
-                            float const g1 = block_component[4 * 8 + k] * s4;
-                            float const g2 = block_component[2 * 8 + k] * s2;
-                            float const g3 = block_component[6 * 8 + k] * s6;
-                            float const g4 = block_component[5 * 8 + k] * s5;
-                            float const g5 = block_component[1 * 8 + k] * s1;
-                            float const g6 = block_component[7 * 8 + k] * s7;
-                            float const g7 = block_component[3 * 8 + k] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            float const g0 = block_component[l * 8 + 0] * s0;
-                            float const g1 = block_component[l * 8 + 4] * s4;
-                            float const g2 = block_component[l * 8 + 2] * s2;
-                            float const g3 = block_component[l * 8 + 6] * s6;
-                            float const g4 = block_component[l * 8 + 5] * s5;
-                            float const g5 = block_component[l * 8 + 1] * s1;
-                            float const g6 = block_component[l * 8 + 7] * s7;
-                            float const g7 = block_component[l * 8 + 3] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
-                        }
+
+                        // The row pass is the column pass on the transposed block.
+                        inverse_dct_columns(block_component);
+                        transpose_block(block_component);
+                        inverse_dct_columns(block_component);
+                        transpose_block(block_component);
                     }
                 }
             }
@@ -1045,17 +1018,28 @@ static void ycbcr_to_rgb(JPGLoadingContext const& context, Vector<Macroblock>& m
                     i32* cb = macroblocks[mb_index].cb;
                     i32* cr = macroblocks[mb_index].cr;
                     for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
+                        // The chroma block may be the block we are writing to, so its samples for this row are
+                        // upsampled into a local copy before any of the row is overwritten.
+                        const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
+                        i32 row_cb[8];
+                        i32 row_cr[8];
+                        for (u8 j = 0; j < 8; ++j) {
                             const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
                             const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
+                            row_cb[j] = chroma.cb[chroma_pixel];
+                            row_cr[j] = chroma.cr[chroma_pixel];
+                        }
+                        for (u8 j = 0; j < 8; j += 4) {
+                            const u8 pixel = i * 8 + j;
+                            auto luma = load_coefficients(&y[pixel]);
+                            auto blue_difference = load_coefficients(&row_cb[j]);
+                            auto red_difference = load_coefficients(&row_cr[j]);
+                            auto r = luma + 1.402f * red_difference + 128;
+                            auto g = luma - 0.344f * blue_difference - 0.714f * red_difference + 128;
+                            auto b = luma + 1.772f * blue_difference + 128;
+                            store_coefficients(&y[pixel], AK::SIMD::clamp(r, 0.0f, 255.0f));
+                            store_coefficients(&cb[pixel], AK::SIMD::clamp(g, 0.0f, 255.0f));
+                            store_coefficients(&cr[pixel], AK::SIMD::clamp(b, 0.0f, 255.0f));
                         }
                     }
                 }
@@ -1076,13 +1060,14 @@ static bool compose_bitmap(JPGLoadingContext& context, Vector<Macroblock> const&
     for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
         const u32 block_row = y / 8;
         const u32 pixel_row = y % 8;
+        auto* scanline = context.bitmap->scanline(y);
         for (u32 x = 0; x < context.frame.width; x++) {
             const u32 block_column = x / 8;
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
             const u32 pixel_column = x % 8;
             const u32 pixel_index = pixel_row * 8 + pixel_column;
             const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+            scanline[x] = color.value();
         }
     }
 
@@ -8,12 +8,15 @@
 #include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/PNGLoader.h>
 #include <LibGfx/PNGShared.h>
 #include <string.h>
 
+#pragma GCC diagnostic ignored "-Wpsabi"
+
 namespace Gfx {
 
 struct PNG_IHDR {
@@ -91,7 +94,6 @@ struct PNGLoadingContext {
     bool has_seen_zlib_header { false };
     bool has_alpha() const { return to_underlying(color_type) & 4 || palette_transparency_data.size() > 0; }
     Vector<Scanline> scanlines;
-    ByteBuffer unfiltered_data;
     RefPtr<Gfx::Bitmap> bitmap;
     ByteBuffer* decompression_buffer { nullptr };
     Vector<u8> compressed_data;
@@ -173,10 +175,101 @@ union [[gnu::packed]] Pixel {
 };
 static_assert(AssertSize<Pixel, 4>());
 
+using AK::SIMD::i16x4;
+
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static i16x4 load_pixel(u8 const* bytes)
+{
+    if constexpr (bytes_per_pixel == 4)
+        return i16x4 { bytes[0], bytes[1], bytes[2], bytes[3] };
+    else
+        return i16x4 { bytes[0], bytes[1], bytes[2], 0 };
+}
+
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static void store_pixel(u8* bytes, i16x4 pixel)
+{
+    for (size_t i = 0; i < bytes_per_pixel; ++i)
+        bytes[i] = pixel[i];
+}
+
+// Unfilters a scanline of 3 or 4 bytes per pixel one whole pixel at a time, since every byte depends on the byte of
+// the pixel to its left, but not on the other bytes of its own pixel.
+template<size_t bytes_per_pixel, typename Predictor>
+ALWAYS_INLINE static void unfilter_pixels(Bytes scanline_data, ReadonlyBytes previous_scanlines_data, Predictor predictor)
+{
+    i16x4 left {};
+    i16x4 upper_left {};
+    for (size_t i = 0; i + bytes_per_pixel <= scanline_data.size(); i += bytes_per_pixel) {
+        auto above = load_pixel<bytes_per_pixel>(&previous_scanlines_data[i]);
+        auto current = (load_pixel<bytes_per_pixel>(&scanline_data[i]) + predictor(left, above, upper_left)) & 0xff;
+        store_pixel<bytes_per_pixel>(&scanline_data[i], current);
+        left = current;
+        upper_left = above;
+    }
+}
+
+template<size_t bytes_per_pixel>
+static void unfilter_scanline_pixelwise(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data)
+{
+    switch (filter) {
+    case PNG::FilterType::Sub:
+        unfilter_pixels<bytes_per_pixel>(scanline_data, previous_scanlines_data, [](i16x4 left, i16x4, i16x4) {
+            return left;
+        });
+        break;
+    case PNG::FilterType::Average:
+        unfilter_pixels<bytes_per_pixel>(scanline_data, previous_scanlines_data, [](i16x4 left, i16x4 above, i16x4) {
+            return (left + above) >> 1;
+        });
+        break;
+    case PNG::FilterType::Paeth:
+        unfilter_pixels<bytes_per_pixel>(scanline_data, previous_scanlines_data, [](i16x4 left, i16x4 above, i16x4 upper_left) {
+            auto predictor = left + above - upper_left;
+            auto predictor_left = predictor - left;
+            auto predictor_above = predictor - above;
+            auto predictor_upper_left = predictor - upper_left;
+            predictor_left = predictor_left < 0 ? -predictor_left : predictor_left;
+            predictor_above = predictor_above < 0 ? -predictor_above : predictor_above;
+            predictor_upper_left = predictor_upper_left < 0 ? -predictor_upper_left : predictor_upper_left;
+            auto nearest_above_or_upper_left = predictor_above <= predictor_upper_left ? above : upper_left;
+            return (predictor_left <= predictor_above && predictor_left <= predictor_upper_left) ? left : nearest_above_or_upper_left;
+        });
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
 static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data, u8 bytes_per_complete_pixel)
 {
     VERIFY(filter != PNG::FilterType::None);
 
+    // Up doesn't depend on any byte to the left, so it is done 16 bytes at a time.
+    if (filter == PNG::FilterType::Up) {
+        size_t i = 0;
+        for (; i + sizeof(AK::SIMD::u8x16) <= scanline_data.size(); i += sizeof(AK::SIMD::u8x16)) {
+            AK::SIMD::u8x16 current;
+            AK::SIMD::u8x16 above;
+            __builtin_memcpy(&current, &scanline_data[i], sizeof(current));
+            __builtin_memcpy(&above, &previous_scanlines_data[i], sizeof(above));
+            current += above;
+            __builtin_memcpy(&scanline_data[i], &current, sizeof(current));
+        }
+        for (; i < scanline_data.size(); ++i)
+            scanline_data[i] += previous_scanlines_data[i];
+        return;
+    }
+
+    if (bytes_per_complete_pixel == 4) {
+        unfilter_scanline_pixelwise<4>(filter, scanline_data, previous_scanlines_data);
+        return;
+    }
+    if (bytes_per_complete_pixel == 3) {
+        unfilter_scanline_pixelwise<3>(filter, scanline_data, previous_scanlines_data);
+        return;
+    }
+
     switch (filter) {
     case PNG::FilterType::Sub:
         // This loop starts at bytes_per_complete_pixel because all bytes before that are
@@ -189,12 +282,6 @@ static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, Reado
             scanline_data[i] += left;
         }
         break;
-    case PNG::FilterType::Up:
-        for (size_t i = 0; i < scanline_data.size(); ++i) {
-            u8 above = previous_scanlines_data[i];
-            scanline_data[i] += above;
-        }
-        break;
     case PNG::FilterType::Average:
         for (size_t i = 0; i < scanline_data.size(); ++i) {
             u32 left = (i < bytes_per_complete_pixel) ? 0 : scanline_data[i - bytes_per_complete_pixel];
@@ -293,18 +380,9 @@ ALWAYS_INLINE static void unpack_triplets_with_transparency_value(PNGLoadingCont
 
 NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
 {
-    // First unfilter the scanlines:
-
-    // FIXME: Instead of creating a separate buffer for the scanlines that need to be
-    //        mutated, the mutation could be done in place (if the data was non-const).
+    // First unfilter the scanlines. They point into the decompression buffer, which is ours, so this is done in place.
     size_t bytes_per_scanline = context.scanlines[0].data.size();
-    size_t bytes_needed_for_all_unfiltered_scanlines = 0;
-    for (int y = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            bytes_needed_for_all_unfiltered_scanlines += bytes_per_scanline;
-        }
-    }
-    context.unfiltered_data = TRY(ByteBuffer::create_uninitialized(bytes_needed_for_all_unfiltered_scanlines));
+    auto& decompression_buffer = *context.decompression_buffer;
 
     // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
     // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
@@ -318,19 +396,15 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     memset(dummy_scanline_bytes, 0, sizeof(dummy_scanline_bytes));
     auto previous_scanlines_data = ReadonlyBytes { dummy_scanline_bytes, sizeof(dummy_scanline_bytes) };
 
-    for (int y = 0, data_start = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            auto scanline_data_slice = context.unfiltered_data.bytes().slice(data_start, bytes_per_scanline);
-
-            // Copy the current values over and set the scanline's data to the to-be-mutated slice
-            context.scanlines[y].data.copy_to(scanline_data_slice);
-            context.scanlines[y].data = scanline_data_slice;
-
-            unfilter_scanline(context.scanlines[y].filter, scanline_data_slice, previous_scanlines_data, bytes_per_complete_pixel);
-
-            data_start += bytes_per_scanline;
+    for (int y = 0; y < context.height; ++y) {
+        auto& scanline = context.scanlines[y];
+        if (scanline.filter != PNG::FilterType::None) {
+            auto offset_in_buffer = static_cast<size_t>(scanline.data.data() - decompression_buffer.data());
+            VERIFY(offset_in_buffer + scanline.data.size() <= decompression_buffer.size());
+            auto scanline_data = decompression_buffer.bytes().slice(offset_in_buffer, scanline.data.size());
+            unfilter_scanline(scanline.filter, scanline_data, previous_scanlines_data, bytes_per_complete_pixel);
         }
-        previous_scanlines_data = context.scanlines[y].data;
+        previous_scanlines_data = scanline.data;
     }
 
     // Now unpack the scanlines to RGBA:
@@ -640,6 +714,7 @@ static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& str
     subimage_context.palette_transparency_data = context.palette_transparency_data;
     subimage_context.bit_depth = context.bit_depth;
     subimage_context.filter_method = context.filter_method;
+    subimage_context.decompression_buffer = context.decompression_buffer;
 
     // For small images, some passes might be empty
     if (!subimage_context.width || !subimage_context.height)
@@ -7,12 +7,16 @@
  */
 
 #include <AK/Concepts.h>
+#include <AK/MemoryStream.h>
 #include <AK/SIMDExtras.h>
 #include <AK/String.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
+#include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/PNGWriter.h>
+#include <LibThreading/Thread.h>
 
 #pragma GCC diagnostic ignored "-Wpsabi"
 
@@ -155,74 +159,68 @@ union [[gnu::packed]] Pixel {
 };
 static_assert(AssertSize<Pixel, 4>());
 
-void PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
+// Filters the rows [first_row, end_row) of the bitmap and appends them to the output, each preceded by its filter type.
+static void filter_rows(Gfx::Bitmap const& bitmap, int first_row, int end_row, ByteBuffer& output)
 {
-    PNGChunk png_chunk { "IDAT" };
-    png_chunk.reserve(bitmap.size_in_bytes());
-
-    ByteBuffer uncompressed_block_data;
-    uncompressed_block_data.ensure_capacity(bitmap.size_in_bytes() + bitmap.height());
-
-    Pixel dummy_scanline[bitmap.width()];
-    auto const* scanline_minus_1 = dummy_scanline;
-
-    for (int y = 0; y < bitmap.height(); ++y) {
-        auto* scanline = reinterpret_cast<Pixel const*>(bitmap.scanline(y));
-
-        struct Filter {
-            PNG::FilterType type;
-            ByteBuffer buffer {};
-            int sum = 0;
-
-            void append(u8 byte)
-            {
-                buffer.append(byte);
-                sum += static_cast<i8>(byte);
-            }
-
-            void append(AK::SIMD::u8x4 simd)
-            {
-                append(simd[0]);
-                append(simd[1]);
-                append(simd[2]);
-                append(simd[3]);
-            }
-        };
+    struct Filter {
+        PNG::FilterType type;
+        u8* data { nullptr };
+        int sum { 0 };
+
+        ALWAYS_INLINE void store(int x, AK::SIMD::u8x4 simd)
+        {
+            __builtin_memcpy(data + x * sizeof(Pixel), &simd, sizeof(Pixel));
+            for (size_t i = 0; i < sizeof(Pixel); ++i)
+                sum += abs(static_cast<i8>(simd[i]));
+        }
+    };
 
-        Filter none_filter { .type = PNG::FilterType::None };
-        none_filter.buffer.ensure_capacity(sizeof(Pixel) * bitmap.height());
+    size_t row_size = bitmap.width() * sizeof(Pixel);
 
-        Filter sub_filter { .type = PNG::FilterType::Sub };
-        sub_filter.buffer.ensure_capacity(sizeof(Pixel) * bitmap.height());
+    // All five candidates for a row are written into one scratch buffer that is reused for every row.
+    auto scratch = ByteBuffer::create_uninitialized(row_size * 5).release_value_but_fixme_should_propagate_errors();
+    Filter filters[] = {
+        { .type = PNG::FilterType::None, .data = scratch.data() },
+        { .type = PNG::FilterType::Sub, .data = scratch.data() + row_size },
+        { .type = PNG::FilterType::Up, .data = scratch.data() + row_size * 2 },
+        { .type = PNG::FilterType::Average, .data = scratch.data() + row_size * 3 },
+        { .type = PNG::FilterType::Paeth, .data = scratch.data() + row_size * 4 },
+    };
+    auto& none_filter = filters[0];
+    auto& sub_filter = filters[1];
+    auto& up_filter = filters[2];
+    auto& average_filter = filters[3];
+    auto& paeth_filter = filters[4];
 
-        Filter up_filter { .type = PNG::FilterType::Up };
-        up_filter.buffer.ensure_capacity(sizeof(Pixel) * bitmap.height());
+    Vector<Pixel> dummy_scanline;
+    dummy_scanline.resize(bitmap.width());
+    auto const* scanline_minus_1 = first_row == 0 ? dummy_scanline.data() : reinterpret_cast<Pixel const*>(bitmap.scanline(first_row - 1));
 
-        Filter average_filter { .type = PNG::FilterType::Average };
-        average_filter.buffer.ensure_capacity(sizeof(ARGB32) * bitmap.height());
+    for (int y = first_row; y < end_row; ++y) {
+        auto* scanline = reinterpret_cast<Pixel const*>(bitmap.scanline(y));
 
-        Filter paeth_filter { .type = PNG::FilterType::Paeth };
-        paeth_filter.buffer.ensure_capacity(sizeof(ARGB32) * bitmap.height());
+        for (auto& filter : filters)
+            filter.sum = 0;
 
-        auto pixel_x_minus_1 = Pixel::gfx_to_png(*dummy_scanline);
-        auto pixel_xy_minus_1 = Pixel::gfx_to_png(*dummy_scanline);
+        auto pixel_x_minus_1 = Pixel::gfx_to_png(*dummy_scanline.data());
+        auto pixel_xy_minus_1 = Pixel::gfx_to_png(*dummy_scanline.data());
 
         for (int x = 0; x < bitmap.width(); ++x) {
             auto pixel = Pixel::gfx_to_png(scanline[x]);
             auto pixel_y_minus_1 = Pixel::gfx_to_png(scanline_minus_1[x]);
 
-            none_filter.append(pixel);
+            none_filter.store(x, pixel);
 
-            sub_filter.append(pixel - pixel_x_minus_1);
+            sub_filter.store(x, pixel - pixel_x_minus_1);
 
-            up_filter.append(pixel - pixel_y_minus_1);
+            up_filter.store(x, pixel - pixel_y_minus_1);
 
             // The sum Orig(a) + Orig(b) shall be performed without overflow (using at least nine-bit arithmetic).
             auto sum = AK::SIMD::to_u16x4(pixel_x_minus_1) + AK::SIMD::to_u16x4(pixel_y_minus_1);
             auto average = AK::SIMD::to_u8x4(sum / 2);
-            average_filter.append(pixel - average);
+            average_filter.store(x, pixel - average);
 
-            paeth_filter.append(pixel - PNG::paeth_predictor(pixel_x_minus_1, pixel_y_minus_1, pixel_xy_minus_1));
+            paeth_filter.store(x, pixel - PNG::paeth_predictor(pixel_x_minus_1, pixel_y_minus_1, pixel_xy_minus_1));
 
             pixel_x_minus_1 = pixel;
             pixel_xy_minus_1 = pixel_y_minus_1;
@@ -236,37 +234,106 @@ void PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
         // The following simple heuristic has performed well in early tests:
         // compute the output scanline using all five filters, and select the filter that gives the smallest sum of absolute values of outputs.
         // (Consider the output bytes as signed differences for this test.)
-        Filter& best_filter = none_filter;
-        if (abs(best_filter.sum) > abs(sub_filter.sum))
-            best_filter = sub_filter;
-        if (abs(best_filter.sum) > abs(up_filter.sum))
-            best_filter = up_filter;
-        if (abs(best_filter.sum) > abs(average_filter.sum))
-            best_filter = average_filter;
-        if (abs(best_filter.sum) > abs(paeth_filter.sum))
-            best_filter = paeth_filter;
-
-        uncompressed_block_data.append(to_underlying(best_filter.type));
-        uncompressed_block_data.append(best_filter.buffer);
+        Filter const* best_filter = &none_filter;
+        for (auto const& filter : filters) {
+            if (filter.sum < best_filter->sum)
+                best_filter = &filter;
+        }
+
+        output.append(to_underlying(best_filter->type));
+        output.append(best_filter->data, row_size);
+    }
+}
+
+// Compresses one group of rows into deflate data that doesn't refer back to any other group. Every group except the
+// last one ends with a sync flush, so that the groups can be concatenated into a single deflate stream.
+static Optional<ByteBuffer> compress_row_group(ReadonlyBytes filtered_rows, bool is_last_group)
+{
+    DuplexMemoryStream output_stream;
+    Compress::DeflateCompressor deflate_stream { output_stream, Compress::DeflateCompressor::CompressionLevel::GREAT };
+
+    deflate_stream.write_or_error(filtered_rows);
+    if (is_last_group)
+        deflate_stream.final_flush();
+    else
+        deflate_stream.sync_flush();
+
+    if (deflate_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+void PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap, Options const& options)
+{
+    PNGChunk png_chunk { "IDAT" };
+    png_chunk.reserve(bitmap.size_in_bytes());
+
+    // Splitting the rows up costs a little compression, since matches can't reach back into the previous group.
+    // Groups are therefore kept large enough for that to not matter much.
+    static constexpr int min_rows_per_group = 64;
+    size_t group_count = max<size_t>(1, min(options.thread_count, static_cast<size_t>(bitmap.height() / min_rows_per_group)));
+    int rows_per_group = ceil_div(bitmap.height(), static_cast<int>(group_count));
+    group_count = ceil_div(bitmap.height(), rows_per_group);
+
+    Vector<ByteBuffer> filtered_groups;
+    filtered_groups.resize(group_count);
+    Vector<Optional<ByteBuffer>> compressed_groups;
+    compressed_groups.resize(group_count);
+
+    auto encode_group = [&](size_t group) {
+        int first_row = group * rows_per_group;
+        int end_row = min(first_row + rows_per_group, bitmap.height());
+        auto& filtered = filtered_groups[group];
+        filtered.ensure_capacity((end_row - first_row) * (bitmap.width() * sizeof(Pixel) + 1));
+        filter_rows(bitmap, first_row, end_row, filtered);
+        compressed_groups[group] = compress_row_group(filtered, group == group_count - 1);
+    };
+
+    // The calling thread encodes the first group itself.
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t group = 1; group < group_count; ++group) {
+        auto thread = Threading::Thread::construct([&, group]() -> intptr_t {
+            encode_group(group);
+            return 0;
+        },
+            "PNG encoder"sv);
+        thread->start();
+        threads.append(move(thread));
     }
+    encode_group(0);
+    for (auto& thread : threads)
+        (void)thread->join();
 
-    auto maybe_zlib_buffer = Compress::ZlibCompressor::compress_all(uncompressed_block_data, Compress::ZlibCompressionLevel::Best);
-    if (!maybe_zlib_buffer.has_value()) {
+    DuplexMemoryStream header_stream;
+    Compress::ZlibCompressor::write_header(header_stream, Compress::ZlibCompressionMethod::Deflate, Compress::ZlibCompressionLevel::Best);
+    auto header = header_stream.copy_into_contiguous_buffer();
+    png_chunk.add(header.data(), header.size());
+
+    Crypto::Checksum::Adler32 adler32_checksum;
+    for (size_t group = 0; group < group_count; ++group) {
         // FIXME: Handle errors.
-        VERIFY_NOT_REACHED();
+        VERIFY(compressed_groups[group].has_value());
+        auto const& compressed = *compressed_groups[group];
+        png_chunk.add(compressed.data(), compressed.size());
+        adler32_checksum.update(filtered_groups[group]);
     }
-    auto zlib_buffer = maybe_zlib_buffer.release_value();
+    png_chunk.add_as_big_endian(adler32_checksum.digest());
 
-    png_chunk.add(zlib_buffer.data(), zlib_buffer.size());
     add_chunk(png_chunk);
 }
 
 ByteBuffer PNGWriter::encode(Gfx::Bitmap const& bitmap)
+{
+    return encode(bitmap, Options {});
+}
+
+ByteBuffer PNGWriter::encode(Gfx::Bitmap const& bitmap, Options const& options)
 {
     PNGWriter writer;
     writer.add_png_header();
     writer.add_IHDR_chunk(bitmap.width(), bitmap.height(), 8, PNG::ColorType::TruecolorWithAlpha, 0, 0, 0);
-    writer.add_IDAT_chunk(bitmap);
+    writer.add_IDAT_chunk(bitmap, options);
     writer.add_IEND_chunk();
     // FIXME: Handle OOM failure.
     return ByteBuffer::copy(writer.m_data).release_value_but_fixme_should_propagate_errors();
@@ -17,7 +17,14 @@ class PNGChunk;
 
 class PNGWriter {
 public:
+    struct Options {
+        // The rows are split into up to this many groups, which are filtered and compressed on their own threads.
+        // Anything above 1 requires the process to be allowed to create threads.
+        size_t thread_count { 1 };
+    };
+
     static ByteBuffer encode(Gfx::Bitmap const&);
+    static ByteBuffer encode(Gfx::Bitmap const&, Options const&);
 
 private:
     PNGWriter() = default;
@@ -26,7 +33,7 @@ private:
     void add_chunk(PNGChunk&);
     void add_png_header();
     void add_IHDR_chunk(u32 width, u32 height, u8 bit_depth, PNG::ColorType color_type, u8 compression_method, u8 filter_method, u8 interlace_method);
-    void add_IDAT_chunk(Gfx::Bitmap const&);
+    void add_IDAT_chunk(Gfx::Bitmap const&, Options const&);
     void add_IEND_chunk();
 };
 
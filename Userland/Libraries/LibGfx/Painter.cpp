@@ -15,7 +15,10 @@
 #include "Font/Emoji.h"
 #include "Font/Font.h"
 #include "Font/FontDatabase.h"
+#include "Font/GlyphAtlas.h"
+#include "Font/ScaledFont.h"
 #include "Gamma.h"
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
@@ -27,6 +30,7 @@
 #include <AK/StringBuilder.h>
 #include <AK/Utf32View.h>
 #include <AK/Utf8View.h>
+#include <LibGfx/BlendingKernels.h>
 #include <LibGfx/CharacterBitmap.h>
 #include <LibGfx/FillPathImplementation.h>
 #include <LibGfx/Palette.h>
@@ -122,8 +126,7 @@ void Painter::fill_physical_rect(IntRect const& physical_rect, Color color)
     size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
 
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
-            dst[j] = Color::from_argb(dst[j]).blend(color).value();
+        Kernels::blend_color_row(dst, color, physical_rect.width());
         dst += dst_skip;
     }
 }
@@ -816,27 +819,31 @@ static void swap_red_and_blue_channels(Color& color)
     color = Color::from_argb(bgra);
 }
 
-// FIXME: This function is very unoptimized.
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
+    // The opacity only ever changes the alpha of the source pixels, so we work out what it turns each of them into up front.
+    Array<u8, 256> alpha_table;
+    for (size_t alpha = 0; alpha < alpha_table.size(); ++alpha) {
+        if constexpr (has_alpha & BlitState::SrcAlpha) {
+            float pixel_opacity = alpha / 255.0;
+            alpha_table[alpha] = 255 * (state.opacity * pixel_opacity);
+        } else {
+            alpha_table[alpha] = state.opacity * 255;
+        }
+    }
+
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
-            if constexpr (has_alpha & BlitState::SrcAlpha) {
+        if (state.src_format == BitmapFormat::RGBA8888) {
+            for (int x = 0; x < state.column_count; ++x) {
+                Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
                 Color src_color_with_alpha = Color::from_argb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
+                swap_red_and_blue_channels(src_color_with_alpha);
+                src_color_with_alpha.set_alpha(alpha_table[src_color_with_alpha.alpha()]);
                 state.dst[x] = dest_color.blend(src_color_with_alpha).value();
             }
+        } else {
+            Kernels::blend_row<(has_alpha & BlitState::DstAlpha) != 0>(state.dst, state.src, state.column_count, alpha_table.data());
         }
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
@@ -1193,10 +1200,7 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
                 auto bottom_left = get_pixel(source, scaled_x0, scaled_y1);
                 auto bottom_right = get_pixel(source, scaled_x1, scaled_y1);
 
-                auto top = top_left.interpolate(top_right, x_ratio);
-                auto bottom = bottom_left.interpolate(bottom_right, x_ratio);
-
-                src_pixel = top.interpolate(bottom, y_ratio);
+                src_pixel = Kernels::interpolate_bilinear(top_left, top_right, bottom_left, bottom_right, x_ratio, y_ratio);
             } else if constexpr (scaling_mode == Painter::ScalingMode::SmoothPixels) {
                 auto scaled_x1 = clamp(desired_x >> 32, clipped_src_rect.left(), clipped_src_rect.right());
                 auto scaled_x0 = clamp(scaled_x1 - 1, clipped_src_rect.left(), clipped_src_rect.right());
@@ -1214,10 +1218,7 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
                 auto bottom_left = get_pixel(source, scaled_x0, scaled_y1);
                 auto bottom_right = get_pixel(source, scaled_x1, scaled_y1);
 
-                auto top = top_left.interpolate(top_right, scaled_x_ratio);
-                auto bottom = bottom_left.interpolate(bottom_right, scaled_x_ratio);
-
-                src_pixel = top.interpolate(bottom, scaled_y_ratio);
+                src_pixel = Kernels::interpolate_bilinear(top_left, top_right, bottom_left, bottom_right, scaled_x_ratio, scaled_y_ratio);
             } else {
                 auto scaled_x = clamp(desired_x >> 32, clipped_src_rect.left(), clipped_src_rect.right());
                 auto scaled_y = clamp(desired_y >> 32, clipped_src_rect.top(), clipped_src_rect.bottom());
@@ -1322,6 +1323,12 @@ FLATTEN void Painter::draw_glyph(IntPoint const& point, u32 code_point, Color co
 
 FLATTEN void Painter::draw_glyph(IntPoint const& point, u32 code_point, Font const& font, Color color)
 {
+    if (font.is_scaled_font() && scale() == 1) {
+        DrawGlyph glyph { point.to_type<float>(), code_point };
+        draw_glyph_run({ &glyph, 1 }, font, color);
+        return;
+    }
+
     auto glyph = font.glyph(code_point);
     auto top_left = point + IntPoint(glyph.left_bearing(), 0);
 
@@ -1334,6 +1341,69 @@ FLATTEN void Painter::draw_glyph(IntPoint const& point, u32 code_point, Font con
     }
 }
 
+void Painter::draw_glyph_run(Span<DrawGlyph const> glyphs, Font const& font, Color color)
+{
+    // FIXME: The atlas only has glyphs for a scale of 1, so anything else still upsamples the font's own glyph bitmaps.
+    if (!font.is_scaled_font() || scale() != 1) {
+        for (auto const& glyph : glyphs)
+            draw_glyph(glyph.position.to_rounded<int>(), glyph.code_point, font, color);
+        return;
+    }
+
+    auto const& scaled_font = static_cast<ScaledFont const&>(font);
+    auto& atlas = GlyphAtlas::the();
+    auto clip = clip_rect();
+
+    // Same as multiplying a white glyph pixel with the color, like draw_glyph() does for glyph bitmaps.
+    Array<u8, 256> alpha_for_coverage;
+    for (size_t coverage = 0; coverage < alpha_for_coverage.size(); ++coverage)
+        alpha_for_coverage[coverage] = coverage * color.alpha() / 255;
+
+    for (auto const& glyph : glyphs) {
+        auto glyph_id = scaled_font.glyph_id_for_code_point(glyph.code_point);
+        auto metrics = scaled_font.glyph_metrics(glyph_id);
+
+        int x = floorf(glyph.position.x());
+        int subpixel_position = roundf((glyph.position.x() - x) * GlyphAtlas::subpixel_positions);
+        if (subpixel_position == GlyphAtlas::subpixel_positions) {
+            ++x;
+            subpixel_position = 0;
+        }
+        IntPoint top_left { x + metrics.left_side_bearing, static_cast<int>(roundf(glyph.position.y())) };
+
+        auto atlas_glyph = atlas.glyph(scaled_font, glyph_id, subpixel_position);
+        if (!atlas_glyph.has_value()) {
+            auto bitmap = scaled_font.rasterize_glyph(glyph_id);
+            if (!bitmap)
+                continue;
+            blit_filtered(top_left, *bitmap, bitmap->rect(), [color](Color pixel) -> Color {
+                return pixel.multiply(color);
+            });
+            continue;
+        }
+
+        auto dst_rect = IntRect(top_left, atlas_glyph->size).translated(translation());
+        auto clipped_rect = dst_rect.intersected(clip);
+        if (clipped_rect.is_empty())
+            continue;
+
+        int const first_row = clipped_rect.top() - dst_rect.top();
+        int const first_column = clipped_rect.left() - dst_rect.left();
+        ARGB32* dst = m_target->scanline(clipped_rect.y()) + clipped_rect.x();
+        size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
+
+        for (int row = 0; row < clipped_rect.height(); ++row) {
+            u8 const* coverage = &atlas_glyph->coverage[(first_row + row) * atlas_glyph->pitch + first_column];
+            for (int column = 0; column < clipped_rect.width(); ++column) {
+                if (!coverage[column])
+                    continue;
+                dst[column] = Color::from_argb(dst[column]).blend(color.with_alpha(alpha_for_coverage[coverage[column]])).value();
+            }
+            dst += dst_skip;
+        }
+    }
+}
+
 void Painter::draw_emoji(IntPoint const& point, Gfx::Bitmap const& emoji, Font const& font)
 {
     IntRect dst_rect {
@@ -1353,14 +1423,26 @@ void Painter::draw_glyph_or_emoji(IntPoint const& point, u32 code_point, Font co
     return draw_glyph_or_emoji(point, it, font, color);
 }
 
-void Painter::draw_glyph_or_emoji(IntPoint const& point, Utf8CodePointIterator& it, Font const& font, Color color)
+// FIXME: These should live somewhere else.
+static constexpr u32 text_variation_selector = 0xFE0E;
+static constexpr u32 emoji_variation_selector = 0xFE0F;
+static constexpr u32 regional_indicator_symbol_a = 0x1F1E6;
+static constexpr u32 regional_indicator_symbol_z = 0x1F1FF;
+
+static bool could_start_emoji(u32 code_point, Optional<u32> next_code_point)
 {
-    // FIXME: These should live somewhere else.
-    constexpr u32 text_variation_selector = 0xFE0E;
-    constexpr u32 emoji_variation_selector = 0xFE0F;
-    constexpr u32 regional_indicator_symbol_a = 0x1F1E6;
-    constexpr u32 regional_indicator_symbol_z = 0x1F1FF;
+    auto code_point_is_regional_indicator = code_point >= regional_indicator_symbol_a && code_point <= regional_indicator_symbol_z;
+    return false
+        // Flag emojis consist of two regional indicators.
+        || code_point_is_regional_indicator
+        // U+00A9 (copyright) or U+00AE (registered) are text glyphs by default,
+        // keycap emojis ({#,*,0-9} U+FE0F U+20E3) start with a regular ASCII character.
+        // Both cases are handled by peeking for the variation selector.
+        || next_code_point == emoji_variation_selector;
+}
 
+void Painter::draw_glyph_or_emoji(IntPoint const& point, Utf8CodePointIterator& it, Font const& font, Color color)
+{
     auto initial_it = it;
     u32 code_point = *it;
     auto next_code_point = it.peek(1);
@@ -1375,16 +1457,8 @@ void Painter::draw_glyph_or_emoji(IntPoint const& point, Utf8CodePointIterator&
             ++it;
     };
 
-    auto code_point_is_regional_indicator = code_point >= regional_indicator_symbol_a && code_point <= regional_indicator_symbol_z;
     auto font_contains_glyph = font.contains_glyph(code_point);
-
-    auto check_for_emoji = false
-        // Flag emojis consist of two regional indicators.
-        || code_point_is_regional_indicator
-        // U+00A9 (copyright) or U+00AE (registered) are text glyphs by default,
-        // keycap emojis ({#,*,0-9} U+FE0F U+20E3) start with a regular ASCII character.
-        // Both cases are handled by peeking for the variation selector.
-        || next_code_point == emoji_variation_selector;
+    auto check_for_emoji = could_start_emoji(code_point, next_code_point);
 
     // If the font contains the glyph, and we know it's not the start of an emoji, draw a text glyph.
     if (font_contains_glyph && !check_for_emoji) {
@@ -2416,6 +2490,13 @@ void Painter::draw_text_run(FloatPoint const& baseline_start, Utf8View const& st
 
     u32 last_code_point = 0;
 
+    // Plain text glyphs are collected and drawn in one go, everything that might be an emoji goes through draw_glyph_or_emoji().
+    Vector<DrawGlyph, 64> glyph_run;
+    auto flush_glyph_run = [&] {
+        draw_glyph_run(glyph_run, font, color);
+        glyph_run.clear_with_capacity();
+    };
+
     for (auto code_point_iterator = string.begin(); code_point_iterator != string.end(); ++code_point_iterator) {
         auto code_point = *code_point_iterator;
         if (should_paint_as_space(code_point)) {
@@ -2426,10 +2507,21 @@ void Painter::draw_text_run(FloatPoint const& baseline_start, Utf8View const& st
 
         // FIXME: this is probably not the real space taken for complex emojis
         x += font.glyphs_horizontal_kerning(last_code_point, code_point);
-        draw_glyph_or_emoji({ static_cast<int>(x), y }, code_point_iterator, font, color);
+
+        auto next_code_point = code_point_iterator.peek(1);
+        if (font.contains_glyph(code_point) && !could_start_emoji(code_point, next_code_point)) {
+            glyph_run.append({ { x, static_cast<float>(y) }, code_point });
+            // Skip a variation selector like draw_glyph_or_emoji() would.
+            if (next_code_point == text_variation_selector)
+                ++code_point_iterator;
+        } else {
+            flush_glyph_run();
+            draw_glyph_or_emoji({ static_cast<int>(x), y }, code_point_iterator, font, color);
+        }
         x += font.glyph_or_emoji_width(code_point) + font.glyph_spacing();
         last_code_point = code_point;
     }
+    flush_glyph_run();
 }
 
 void Painter::draw_scaled_bitmap_with_transform(Gfx::IntRect const& dst_rect, Gfx::Bitmap const& bitmap, Gfx::FloatRect const& src_rect, Gfx::AffineTransform const& transform, float opacity, Gfx::Painter::ScalingMode scaling_mode)
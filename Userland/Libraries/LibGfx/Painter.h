@@ -23,6 +23,12 @@
 
 namespace Gfx {
 
+struct DrawGlyph {
+    // Where the top left corner of the glyph's advance box goes, which is where draw_glyph() would put it.
+    FloatPoint position;
+    u32 code_point { 0 };
+};
+
 class Painter {
 public:
     explicit Painter(Gfx::Bitmap&);
@@ -88,6 +94,8 @@ public:
     void draw_ui_text(Gfx::IntRect const&, StringView, Gfx::Font const&, TextAlignment, Gfx::Color);
     void draw_glyph(IntPoint const&, u32, Color);
     void draw_glyph(IntPoint const&, u32, Font const&, Color);
+    // Draws a batch of text glyphs, without looking for emoji. Vector fonts are drawn from the GlyphAtlas, at subpixel positions.
+    void draw_glyph_run(Span<DrawGlyph const>, Font const&, Color);
     void draw_emoji(IntPoint const&, Gfx::Bitmap const&, Font const&);
     void draw_glyph_or_emoji(IntPoint const&, u32, Font const&, Color);
     void draw_glyph_or_emoji(IntPoint const&, Utf8CodePointIterator&, Font const&, Color);
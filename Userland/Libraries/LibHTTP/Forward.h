@@ -8,6 +8,7 @@
 
 namespace HTTP {
 
+class Http2Connection;
 class HttpRequest;
 class HttpResponse;
 class HttpsJob;
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibHTTP/HPack.h>
+#include <LibHTTP/HPackTables.h>
+
+namespace HTTP::HPack {
+
+void DynamicTable::set_maximum_size(size_t maximum_size)
+{
+    m_maximum_size = maximum_size;
+    evict_until_size_is_at_most(maximum_size);
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-4.4
+void DynamicTable::insert(Header header)
+{
+    auto size = entry_size(header.name, header.value);
+    if (size > m_maximum_size) {
+        // "an attempt to add an entry larger than the maximum size causes the table to be emptied of all existing entries"
+        evict_until_size_is_at_most(0);
+        return;
+    }
+
+    evict_until_size_is_at_most(m_maximum_size - size);
+    m_entries.append(move(header));
+    m_size += size;
+}
+
+void DynamicTable::evict_until_size_is_at_most(size_t size)
+{
+    size_t evicted_count = 0;
+    while (m_size > size) {
+        auto& oldest = m_entries[evicted_count++];
+        m_size -= entry_size(oldest.name, oldest.value);
+    }
+    m_entries.remove(0, evicted_count);
+}
+
+ErrorOr<void> encode_integer(ByteBuffer& output, u8 first_byte_flags, u8 prefix_bits, u64 value)
+{
+    u8 prefix_mask = (1 << prefix_bits) - 1;
+    if (value < prefix_mask)
+        return output.try_append(static_cast<u8>(first_byte_flags | value));
+
+    TRY(output.try_append(static_cast<u8>(first_byte_flags | prefix_mask)));
+    value -= prefix_mask;
+    while (value >= 0x80) {
+        TRY(output.try_append(static_cast<u8>((value & 0x7f) | 0x80)));
+        value >>= 7;
+    }
+    return output.try_append(static_cast<u8>(value));
+}
+
+ErrorOr<u64> decode_integer(ReadonlyBytes& input, u8 prefix_bits)
+{
+    if (input.is_empty())
+        return Error::from_string_literal("Integer is cut off");
+
+    u8 prefix_mask = (1 << prefix_bits) - 1;
+    u64 value = input[0] & prefix_mask;
+    input = input.slice(1);
+    if (value < prefix_mask)
+        return value;
+
+    for (size_t shift = 0;; shift += 7) {
+        if (input.is_empty())
+            return Error::from_string_literal("Integer is cut off");
+        // Nothing we deal with comes anywhere close to this, so anything longer is just trying to overflow us.
+        if (shift > 28)
+            return Error::from_string_literal("Integer is too large");
+        auto byte = input[0];
+        input = input.slice(1);
+        value += static_cast<u64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+struct HuffmanDecodingTables {
+    // The symbols in canonical order, which is by code length and then by symbol.
+    Array<u16, 257> symbols {};
+    Array<u32, huffman_maximum_code_length + 1> first_code_of_length {};
+    Array<u16, huffman_maximum_code_length + 1> first_index_of_length {};
+    Array<u16, huffman_maximum_code_length + 1> code_count_of_length {};
+};
+
+static constexpr HuffmanDecodingTables generate_huffman_decoding_tables()
+{
+    HuffmanDecodingTables tables;
+    u16 index = 0;
+    for (u8 length = 1; length <= huffman_maximum_code_length; ++length) {
+        tables.first_index_of_length[length] = index;
+        for (u16 symbol = 0; symbol < huffman_codes.size(); ++symbol) {
+            if (huffman_codes[symbol].length != length)
+                continue;
+            if (tables.code_count_of_length[length]++ == 0)
+                tables.first_code_of_length[length] = huffman_codes[symbol].code;
+            tables.symbols[index++] = symbol;
+        }
+    }
+    return tables;
+}
+
+static constexpr auto huffman_decoding_tables = generate_huffman_decoding_tables();
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-5.2
+ErrorOr<ByteBuffer> huffman_decode(ReadonlyBytes input)
+{
+    ByteBuffer output;
+    // The shortest code is 5 bits long, so this is as large as the result can get.
+    TRY(output.try_ensure_capacity(input.size() * 8 / 5));
+
+    u32 code = 0;
+    u8 code_length = 0;
+    for (auto byte : input) {
+        for (int bit = 7; bit >= 0; --bit) {
+            code = (code << 1) | ((byte >> bit) & 1);
+            if (++code_length > huffman_maximum_code_length)
+                return Error::from_string_literal("Invalid Huffman code");
+
+            auto offset = code - huffman_decoding_tables.first_code_of_length[code_length];
+            if (code < huffman_decoding_tables.first_code_of_length[code_length] || offset >= huffman_decoding_tables.code_count_of_length[code_length])
+                continue;
+
+            auto symbol = huffman_decoding_tables.symbols[huffman_decoding_tables.first_index_of_length[code_length] + offset];
+            if (symbol == huffman_end_of_string)
+                return Error::from_string_literal("Huffman-encoded string contains EOS");
+            output.append(static_cast<u8>(symbol));
+            code = 0;
+            code_length = 0;
+        }
+    }
+
+    // "A padding strictly longer than 7 bits MUST be treated as a decoding error.
+    //  A padding not corresponding to the most significant bits of the code for the EOS symbol MUST be treated as a decoding error."
+    if (code_length > 7 || code != (1u << code_length) - 1)
+        return Error::from_string_literal("Invalid Huffman padding");
+
+    return output;
+}
+
+size_t huffman_encoded_length(ReadonlyBytes input)
+{
+    size_t bits = 0;
+    for (auto byte : input)
+        bits += huffman_codes[byte].length;
+    return (bits + 7) / 8;
+}
+
+ErrorOr<void> huffman_encode(ByteBuffer& output, ReadonlyBytes input)
+{
+    u64 bit_buffer = 0;
+    size_t bit_count = 0;
+    for (auto byte : input) {
+        auto& code = huffman_codes[byte];
+        bit_buffer = (bit_buffer << code.length) | code.code;
+        bit_count += code.length;
+        while (bit_count >= 8) {
+            bit_count -= 8;
+            TRY(output.try_append(static_cast<u8>(bit_buffer >> bit_count)));
+        }
+    }
+
+    // Pad with the most significant bits of EOS, which are all ones.
+    if (bit_count > 0)
+        TRY(output.try_append(static_cast<u8>((bit_buffer << (8 - bit_count)) | (0xff >> bit_count))));
+    return {};
+}
+
+ErrorOr<void> encode_string(ByteBuffer& output, StringView string)
+{
+    auto huffman_length = huffman_encoded_length(string.bytes());
+    if (huffman_length < string.length()) {
+        TRY(encode_integer(output, 0x80, 7, huffman_length));
+        return huffman_encode(output, string.bytes());
+    }
+
+    TRY(encode_integer(output, 0, 7, string.length()));
+    return output.try_append(string.bytes());
+}
+
+ErrorOr<String> decode_string(ReadonlyBytes& input)
+{
+    if (input.is_empty())
+        return Error::from_string_literal("String is cut off");
+
+    bool is_huffman_encoded = input[0] & 0x80;
+    auto length = TRY(decode_integer(input, 7));
+    if (length > input.size())
+        return Error::from_string_literal("String is cut off");
+
+    auto bytes = input.trim(length);
+    input = input.slice(length);
+    if (!is_huffman_encoded)
+        return String { bytes };
+    return String { TRY(huffman_decode(bytes)).bytes() };
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-2.3.3
+ErrorOr<Header> Decoder::header_at(size_t index) const
+{
+    if (index == 0)
+        return Error::from_string_literal("Header index 0 is invalid");
+    if (index <= static_table.size()) {
+        auto& entry = static_table[index - 1];
+        return Header { entry.name, entry.value };
+    }
+    index -= static_table.size() + 1;
+    if (index >= m_table.entry_count())
+        return Error::from_string_literal("Header index is out of bounds");
+    return m_table.at(index);
+}
+
+ErrorOr<String> Decoder::name_at(ReadonlyBytes& input, u64 index)
+{
+    if (index == 0)
+        return decode_string(input);
+    return TRY(header_at(index)).name;
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-6
+ErrorOr<Vector<Header>> Decoder::decode(ReadonlyBytes header_block)
+{
+    Vector<Header> headers;
+    bool may_update_table_size = true;
+    while (!header_block.is_empty()) {
+        auto first_byte = header_block[0];
+        if (first_byte & 0x80) {
+            // Indexed Header Field
+            auto index = TRY(decode_integer(header_block, 7));
+            TRY(headers.try_append(TRY(header_at(index))));
+        } else if (first_byte & 0x40) {
+            // Literal Header Field with Incremental Indexing
+            auto index = TRY(decode_integer(header_block, 6));
+            auto name = TRY(name_at(header_block, index));
+            // Note: The value is decoded first, a TRY() inside the braces would leak the name if it returned.
+            auto value = TRY(decode_string(header_block));
+            Header header { move(name), move(value) };
+            m_table.insert(header);
+            TRY(headers.try_append(move(header)));
+        } else if (first_byte & 0x20) {
+            // Dynamic Table Size Update
+            // "This dynamic table size update MUST occur at the beginning of the first header block following the change"
+            if (!may_update_table_size)
+                return Error::from_string_literal("Dynamic table size update after the start of the header block");
+            auto size = TRY(decode_integer(header_block, 5));
+            if (size > m_maximum_table_size)
+                return Error::from_string_literal("Dynamic table size update exceeds the size we allow");
+            m_table.set_maximum_size(size);
+            continue;
+        } else {
+            // Literal Header Field without Indexing, or Never Indexed. To us, they're the same.
+            auto index = TRY(decode_integer(header_block, 4));
+            auto name = TRY(name_at(header_block, index));
+            auto value = TRY(decode_string(header_block));
+            TRY(headers.try_append({ move(name), move(value) }));
+        }
+        may_update_table_size = false;
+    }
+    return headers;
+}
+
+void Encoder::set_maximum_table_size(size_t size)
+{
+    size = min(size, default_dynamic_table_size);
+    if (size == m_table.maximum_size())
+        return;
+
+    // "If the maximum size is reduced and then increased between header blocks,
+    //  the encoder MUST signal the smallest size first, followed by the final one."
+    if (!m_smallest_pending_table_size.has_value() || size < *m_smallest_pending_table_size)
+        m_smallest_pending_table_size = size;
+    m_table.set_maximum_size(size);
+}
+
+Optional<size_t> Encoder::find_in_static_table(Header const& header, bool& value_matches) const
+{
+    Optional<size_t> name_index;
+    for (size_t i = 0; i < static_table.size(); ++i) {
+        if (static_table[i].name != header.name)
+            continue;
+        if (static_table[i].value == header.value) {
+            value_matches = true;
+            return i + 1;
+        }
+        if (!name_index.has_value())
+            name_index = i + 1;
+    }
+    return name_index;
+}
+
+Optional<size_t> Encoder::find_in_dynamic_table(Header const& header, bool& value_matches) const
+{
+    Optional<size_t> name_index;
+    for (size_t i = 0; i < m_table.entry_count(); ++i) {
+        auto& entry = m_table.at(i);
+        if (entry.name != header.name)
+            continue;
+        if (entry.value == header.value) {
+            value_matches = true;
+            return static_table.size() + i + 1;
+        }
+        if (!name_index.has_value())
+            name_index = static_table.size() + i + 1;
+    }
+    return name_index;
+}
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-7.1.3
+static bool is_sensitive(Header const& header)
+{
+    if (header.name == "authorization"sv || header.name == "proxy-authorization"sv)
+        return true;
+    // Short cookies are easy to guess one character at a time if an attacker can watch the compressed size.
+    return header.name == "cookie"sv && header.value.length() < 20;
+}
+
+ErrorOr<void> Encoder::encode_header(ByteBuffer& output, Header const& header)
+{
+    bool value_matches = false;
+    auto index = find_in_static_table(header, value_matches);
+    if (!value_matches) {
+        bool dynamic_value_matches = false;
+        auto dynamic_index = find_in_dynamic_table(header, dynamic_value_matches);
+        if (dynamic_value_matches || !index.has_value()) {
+            index = dynamic_index;
+            value_matches = dynamic_value_matches;
+        }
+    }
+
+    if (value_matches)
+        return encode_integer(output, 0x80, 7, *index);
+
+    auto name_index = index.value_or(0);
+    auto sensitive = is_sensitive(header);
+    if (!sensitive && DynamicTable::entry_size(header.name, header.value) <= m_table.maximum_size()) {
+        TRY(encode_integer(output, 0x40, 6, name_index));
+        if (name_index == 0)
+            TRY(encode_string(output, header.name));
+        TRY(encode_string(output, header.value));
+        m_table.insert(header);
+        return {};
+    }
+
+    TRY(encode_integer(output, sensitive ? 0x10 : 0x00, 4, name_index));
+    if (name_index == 0)
+        TRY(encode_string(output, header.name));
+    return encode_string(output, header.value);
+}
+
+ErrorOr<ByteBuffer> Encoder::encode(Vector<Header> const& headers)
+{
+    ByteBuffer output;
+    if (m_smallest_pending_table_size.has_value()) {
+        TRY(encode_integer(output, 0x20, 5, *m_smallest_pending_table_size));
+        if (*m_smallest_pending_table_size != m_table.maximum_size())
+            TRY(encode_integer(output, 0x20, 5, m_table.maximum_size()));
+        m_smallest_pending_table_size.clear();
+    }
+
+    for (auto& header : headers)
+        TRY(encode_header(output, header));
+    return output;
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+// https://www.rfc-editor.org/rfc/rfc7541
+namespace HTTP::HPack {
+
+struct Header {
+    String name;
+    String value;
+
+    bool operator==(Header const&) const = default;
+};
+
+// The size both ends start with, until SETTINGS_HEADER_TABLE_SIZE says otherwise.
+static constexpr size_t default_dynamic_table_size = 4096;
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-2.3.2
+class DynamicTable {
+public:
+    explicit DynamicTable(size_t maximum_size)
+        : m_maximum_size(maximum_size)
+    {
+    }
+
+    size_t size() const { return m_size; }
+    size_t maximum_size() const { return m_maximum_size; }
+    size_t entry_count() const { return m_entries.size(); }
+
+    void set_maximum_size(size_t);
+    void insert(Header);
+
+    // Index 0 is the most recently inserted entry.
+    Header const& at(size_t index) const { return m_entries[m_entries.size() - index - 1]; }
+
+    // https://www.rfc-editor.org/rfc/rfc7541#section-4.1
+    static constexpr size_t entry_size(StringView name, StringView value) { return name.length() + value.length() + 32; }
+
+private:
+    void evict_until_size_is_at_most(size_t);
+
+    // Oldest first, so that inserting doesn't have to move anything.
+    Vector<Header> m_entries;
+    size_t m_size { 0 };
+    size_t m_maximum_size { 0 };
+};
+
+class Decoder {
+public:
+    // `maximum_table_size` is what we advertise through SETTINGS_HEADER_TABLE_SIZE, the encoder may only shrink it.
+    explicit Decoder(size_t maximum_table_size = default_dynamic_table_size)
+        : m_table(maximum_table_size)
+        , m_maximum_table_size(maximum_table_size)
+    {
+    }
+
+    // Decodes a complete header block, i.e. the fragments of a HEADERS frame and all its CONTINUATIONs put together.
+    // Any error leaves the decoder out of sync with the encoder, and has to be treated as a connection error.
+    ErrorOr<Vector<Header>> decode(ReadonlyBytes header_block);
+
+    DynamicTable const& table() const { return m_table; }
+
+private:
+    ErrorOr<Header> header_at(size_t index) const;
+    ErrorOr<String> name_at(ReadonlyBytes&, u64 index);
+
+    DynamicTable m_table;
+    size_t m_maximum_table_size { 0 };
+};
+
+class Encoder {
+public:
+    Encoder() = default;
+
+    // Follows the peer's SETTINGS_HEADER_TABLE_SIZE, we stick to the default size if they allow more than that.
+    void set_maximum_table_size(size_t);
+
+    ErrorOr<ByteBuffer> encode(Vector<Header> const&);
+
+    DynamicTable const& table() const { return m_table; }
+
+private:
+    ErrorOr<void> encode_header(ByteBuffer&, Header const&);
+    Optional<size_t> find_in_static_table(Header const&, bool& value_matches) const;
+    Optional<size_t> find_in_dynamic_table(Header const&, bool& value_matches) const;
+
+    DynamicTable m_table { default_dynamic_table_size };
+    Optional<size_t> m_smallest_pending_table_size;
+};
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-5.1
+ErrorOr<void> encode_integer(ByteBuffer&, u8 first_byte_flags, u8 prefix_bits, u64 value);
+ErrorOr<u64> decode_integer(ReadonlyBytes&, u8 prefix_bits);
+
+// https://www.rfc-editor.org/rfc/rfc7541#section-5.2
+ErrorOr<void> encode_string(ByteBuffer&, StringView);
+ErrorOr<String> decode_string(ReadonlyBytes&);
+
+ErrorOr<ByteBuffer> huffman_decode(ReadonlyBytes);
+size_t huffman_encoded_length(ReadonlyBytes);
+ErrorOr<void> huffman_encode(ByteBuffer&, ReadonlyBytes);
+
+}
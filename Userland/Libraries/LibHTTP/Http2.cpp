@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
+#include <LibHTTP/Http2.h>
+
+namespace HTTP::Http2 {
+
+StringView to_string(FrameType type)
+{
+    switch (type) {
+    case FrameType::Data:
+        return "DATA"sv;
+    case FrameType::Headers:
+        return "HEADERS"sv;
+    case FrameType::Priority:
+        return "PRIORITY"sv;
+    case FrameType::ResetStream:
+        return "RST_STREAM"sv;
+    case FrameType::Settings:
+        return "SETTINGS"sv;
+    case FrameType::PushPromise:
+        return "PUSH_PROMISE"sv;
+    case FrameType::Ping:
+        return "PING"sv;
+    case FrameType::GoAway:
+        return "GOAWAY"sv;
+    case FrameType::WindowUpdate:
+        return "WINDOW_UPDATE"sv;
+    case FrameType::Continuation:
+        return "CONTINUATION"sv;
+    }
+    return "(unknown)"sv;
+}
+
+StringView to_string(ErrorCode code)
+{
+    switch (code) {
+    case ErrorCode::NoError:
+        return "NO_ERROR"sv;
+    case ErrorCode::ProtocolError:
+        return "PROTOCOL_ERROR"sv;
+    case ErrorCode::InternalError:
+        return "INTERNAL_ERROR"sv;
+    case ErrorCode::FlowControlError:
+        return "FLOW_CONTROL_ERROR"sv;
+    case ErrorCode::SettingsTimeout:
+        return "SETTINGS_TIMEOUT"sv;
+    case ErrorCode::StreamClosed:
+        return "STREAM_CLOSED"sv;
+    case ErrorCode::FrameSizeError:
+        return "FRAME_SIZE_ERROR"sv;
+    case ErrorCode::RefusedStream:
+        return "REFUSED_STREAM"sv;
+    case ErrorCode::Cancel:
+        return "CANCEL"sv;
+    case ErrorCode::CompressionError:
+        return "COMPRESSION_ERROR"sv;
+    case ErrorCode::ConnectError:
+        return "CONNECT_ERROR"sv;
+    case ErrorCode::EnhanceYourCalm:
+        return "ENHANCE_YOUR_CALM"sv;
+    case ErrorCode::InadequateSecurity:
+        return "INADEQUATE_SECURITY"sv;
+    case ErrorCode::Http11Required:
+        return "HTTP_1_1_REQUIRED"sv;
+    }
+    return "(unknown)"sv;
+}
+
+static u32 read_u32(ReadonlyBytes bytes, size_t offset = 0)
+{
+    u32 value;
+    ByteReader::load(bytes.offset(offset), value);
+    return AK::convert_between_host_and_network_endian(value);
+}
+
+FrameHeader FrameHeader::parse(ReadonlyBytes bytes)
+{
+    VERIFY(bytes.size() >= frame_header_size);
+    return {
+        .length = static_cast<u32>(bytes[0] << 16 | bytes[1] << 8 | bytes[2]),
+        .type = static_cast<FrameType>(bytes[3]),
+        .flags = bytes[4],
+        // "R: A reserved 1-bit field. [...] MUST be ignored when receiving."
+        .stream_id = read_u32(bytes, 5) & maximum_stream_id,
+    };
+}
+
+ErrorOr<void> append_frame(ByteBuffer& buffer, FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    VERIFY(payload.size() < (1 << 24));
+    u8 header[frame_header_size] = {
+        static_cast<u8>(payload.size() >> 16),
+        static_cast<u8>(payload.size() >> 8),
+        static_cast<u8>(payload.size()),
+        static_cast<u8>(type),
+        flags,
+        static_cast<u8>(stream_id >> 24),
+        static_cast<u8>(stream_id >> 16),
+        static_cast<u8>(stream_id >> 8),
+        static_cast<u8>(stream_id),
+    };
+    TRY(buffer.try_append(header, sizeof(header)));
+    return buffer.try_append(payload);
+}
+
+ErrorOr<ReadonlyBytes> frame_content(FrameHeader const& header, ReadonlyBytes payload)
+{
+    size_t padding_length = 0;
+    if (header.has_flag(Flags::Padded)) {
+        if (payload.is_empty())
+            return Error::from_string_literal("Padded frame has no padding length");
+        padding_length = payload[0];
+        payload = payload.slice(1);
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc9113#section-6.2
+    // Exclusive flag and stream dependency (4 bytes), and weight (1 byte). We don't care about the server's opinion on these.
+    if (header.type == FrameType::Headers && header.has_flag(Flags::Priority)) {
+        if (payload.size() < 5)
+            return Error::from_string_literal("HEADERS frame is too short for its priority fields");
+        payload = payload.slice(5);
+    }
+
+    // "If the length of the padding is the length of the frame payload or greater, the recipient MUST treat this as a connection error"
+    if (padding_length > payload.size())
+        return Error::from_string_literal("Frame padding is longer than the frame");
+    return payload.trim(payload.size() - padding_length);
+}
+
+ErrorOr<void, ErrorCode> Settings::apply(ReadonlyBytes payload)
+{
+    if (payload.size() % 6 != 0)
+        return ErrorCode::FrameSizeError;
+
+    for (size_t offset = 0; offset < payload.size(); offset += 6) {
+        auto parameter = static_cast<SettingsParameter>(payload[offset] << 8 | payload[offset + 1]);
+        auto value = read_u32(payload, offset + 2);
+        switch (parameter) {
+        case SettingsParameter::HeaderTableSize:
+            header_table_size = value;
+            break;
+        case SettingsParameter::EnablePush:
+            if (value > 1)
+                return ErrorCode::ProtocolError;
+            enable_push = value == 1;
+            break;
+        case SettingsParameter::MaxConcurrentStreams:
+            max_concurrent_streams = value;
+            break;
+        case SettingsParameter::InitialWindowSize:
+            if (value > maximum_window_size)
+                return ErrorCode::FlowControlError;
+            initial_window_size = value;
+            break;
+        case SettingsParameter::MaxFrameSize:
+            if (value < default_maximum_frame_size || value > 0xffffff)
+                return ErrorCode::ProtocolError;
+            max_frame_size = value;
+            break;
+        case SettingsParameter::MaxHeaderListSize:
+            max_header_list_size = value;
+            break;
+        default:
+            // "An endpoint that receives a SETTINGS frame with any unknown or unsupported identifier MUST ignore that setting."
+            break;
+        }
+    }
+    return {};
+}
+
+ErrorOr<void> append_setting(ByteBuffer& buffer, SettingsParameter parameter, u32 value)
+{
+    u8 setting[6] = {
+        static_cast<u8>(to_underlying(parameter) >> 8),
+        static_cast<u8>(to_underlying(parameter)),
+        static_cast<u8>(value >> 24),
+        static_cast<u8>(value >> 16),
+        static_cast<u8>(value >> 8),
+        static_cast<u8>(value),
+    };
+    return buffer.try_append(setting, sizeof(setting));
+}
+
+}
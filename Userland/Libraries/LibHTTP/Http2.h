@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/NumericLimits.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+// https://www.rfc-editor.org/rfc/rfc9113
+namespace HTTP::Http2 {
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-3.4
+static constexpr StringView connection_preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"sv;
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-4.1
+static constexpr size_t frame_header_size = 9;
+
+static constexpr u32 default_initial_window_size = 65535;
+static constexpr u32 default_maximum_frame_size = 16384;
+static constexpr u32 maximum_window_size = 0x7fffffff;
+static constexpr u32 maximum_stream_id = 0x7fffffff;
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6
+enum class FrameType : u8 {
+    Data = 0x0,
+    Headers = 0x1,
+    Priority = 0x2,
+    ResetStream = 0x3,
+    Settings = 0x4,
+    PushPromise = 0x5,
+    Ping = 0x6,
+    GoAway = 0x7,
+    WindowUpdate = 0x8,
+    Continuation = 0x9,
+};
+
+namespace Flags {
+static constexpr u8 EndStream = 0x1;
+static constexpr u8 Ack = 0x1;
+static constexpr u8 EndHeaders = 0x4;
+static constexpr u8 Padded = 0x8;
+static constexpr u8 Priority = 0x20;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.5.2
+enum class SettingsParameter : u16 {
+    HeaderTableSize = 0x1,
+    EnablePush = 0x2,
+    MaxConcurrentStreams = 0x3,
+    InitialWindowSize = 0x4,
+    MaxFrameSize = 0x5,
+    MaxHeaderListSize = 0x6,
+};
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-7
+enum class ErrorCode : u32 {
+    NoError = 0x0,
+    ProtocolError = 0x1,
+    InternalError = 0x2,
+    FlowControlError = 0x3,
+    SettingsTimeout = 0x4,
+    StreamClosed = 0x5,
+    FrameSizeError = 0x6,
+    RefusedStream = 0x7,
+    Cancel = 0x8,
+    CompressionError = 0x9,
+    ConnectError = 0xa,
+    EnhanceYourCalm = 0xb,
+    InadequateSecurity = 0xc,
+    Http11Required = 0xd,
+};
+
+StringView to_string(FrameType);
+StringView to_string(ErrorCode);
+
+struct FrameHeader {
+    u32 length { 0 };
+    FrameType type { FrameType::Data };
+    u8 flags { 0 };
+    u32 stream_id { 0 };
+
+    bool has_flag(u8 flag) const { return (flags & flag) == flag; }
+
+    // `bytes` has to hold at least frame_header_size bytes.
+    static FrameHeader parse(ReadonlyBytes bytes);
+};
+
+ErrorOr<void> append_frame(ByteBuffer&, FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+
+// Strips the padding, and for HEADERS frames the priority fields, off the payload of a DATA or HEADERS frame.
+ErrorOr<ReadonlyBytes> frame_content(FrameHeader const&, ReadonlyBytes payload);
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.5.2
+struct Settings {
+    u32 header_table_size { 4096 };
+    bool enable_push { true };
+    u32 max_concurrent_streams { NumericLimits<u32>::max() };
+    u32 initial_window_size { default_initial_window_size };
+    u32 max_frame_size { default_maximum_frame_size };
+    u32 max_header_list_size { NumericLimits<u32>::max() };
+
+    // Applies the payload of a SETTINGS frame, failing with the error code that the connection has to be closed with.
+    ErrorOr<void, ErrorCode> apply(ReadonlyBytes payload);
+};
+
+ErrorOr<void> append_setting(ByteBuffer&, SettingsParameter, u32 value);
+
+}
@@ -0,0 +1,696 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteReader.h>
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <AK/StringBuilder.h>
+#include <LibHTTP/Http2Connection.h>
+
+namespace HTTP {
+
+// The default windows of 64 KiB would have us waiting on WINDOW_UPDATEs all the time on any connection worth talking about.
+static constexpr u32 local_stream_window_size = 1 * MiB;
+static constexpr u32 local_connection_window_size = 16 * MiB;
+static constexpr u32 local_maximum_header_list_size = 256 * KiB;
+
+static u32 read_u32(ReadonlyBytes bytes, size_t offset = 0)
+{
+    u32 value;
+    ByteReader::load(bytes.offset(offset), value);
+    return AK::convert_between_host_and_network_endian(value);
+}
+
+static void write_u32(u8* bytes, u32 value)
+{
+    value = AK::convert_between_host_and_network_endian(value);
+    ByteReader::store(bytes, value);
+}
+
+ErrorOr<NonnullRefPtr<Http2Connection>> Http2Connection::try_create(Core::Stream::BufferedSocketBase& socket)
+{
+    auto connection = adopt_ref(*new Http2Connection(socket));
+    TRY(connection->send_preface());
+    return connection;
+}
+
+Http2Connection::Http2Connection(Core::Stream::BufferedSocketBase& socket)
+    : m_socket(socket)
+    , m_decoder(HPack::default_dynamic_table_size)
+{
+    m_socket.on_ready_to_read = [this] {
+        read_from_socket();
+    };
+}
+
+Http2Connection::~Http2Connection()
+{
+    m_socket.on_ready_to_read = nullptr;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-3.4
+ErrorOr<void> Http2Connection::send_preface()
+{
+    TRY(m_output.try_append(Http2::connection_preface.bytes()));
+
+    ByteBuffer settings;
+    // We never accept pushed streams, there's nothing that would make use of them.
+    TRY(Http2::append_setting(settings, Http2::SettingsParameter::EnablePush, 0));
+    TRY(Http2::append_setting(settings, Http2::SettingsParameter::InitialWindowSize, local_stream_window_size));
+    TRY(Http2::append_setting(settings, Http2::SettingsParameter::MaxHeaderListSize, local_maximum_header_list_size));
+    TRY(Http2::append_frame(m_output, Http2::FrameType::Settings, 0, 0, settings));
+
+    // The connection window can only grow through WINDOW_UPDATE.
+    queue_window_update(0, local_connection_window_size - Http2::default_initial_window_size);
+    m_receive_window = local_connection_window_size;
+
+    flush_output();
+    if (m_is_going_away)
+        return Error::from_string_literal("Failed to send the HTTP/2 connection preface");
+    return {};
+}
+
+bool Http2Connection::can_open_stream() const
+{
+    if (m_is_going_away || !m_socket.is_open() || m_next_stream_id > Http2::maximum_stream_id)
+        return false;
+    return m_streams.size() < min(m_remote_settings.max_concurrent_streams, maximum_concurrent_streams);
+}
+
+static bool is_connection_specific_header(StringView name)
+{
+    // https://www.rfc-editor.org/rfc/rfc9113#section-8.2.2
+    // Host is replaced by :authority.
+    return name.equals_ignoring_case("Connection"sv)
+        || name.equals_ignoring_case("Keep-Alive"sv)
+        || name.equals_ignoring_case("Proxy-Connection"sv)
+        || name.equals_ignoring_case("Transfer-Encoding"sv)
+        || name.equals_ignoring_case("Upgrade"sv)
+        || name.equals_ignoring_case("Host"sv);
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-8.3.1
+static ErrorOr<Vector<HPack::Header>> headers_for_request(HttpRequest const& request)
+{
+    auto const& url = request.url();
+
+    StringBuilder path;
+    path.append(URL::percent_encode(url.path(), URL::PercentEncodeSet::EncodeURI));
+    if (!url.query().is_empty()) {
+        path.append('?');
+        path.append(url.query());
+    }
+
+    StringBuilder authority;
+    authority.append(url.host());
+    if (url.port().has_value())
+        authority.appendff(":{}", *url.port());
+
+    Vector<HPack::Header> headers;
+    TRY(headers.try_append({ ":method", request.method_name() }));
+    TRY(headers.try_append({ ":scheme", url.scheme() }));
+    TRY(headers.try_append({ ":authority", authority.to_string() }));
+    TRY(headers.try_append({ ":path", path.to_string() }));
+
+    for (auto& header : request.headers()) {
+        if (is_connection_specific_header(header.name))
+            continue;
+        // "TE [...] MUST NOT contain any value other than "trailers"."
+        if (header.name.equals_ignoring_case("TE"sv) && header.value != "trailers"sv)
+            continue;
+        // "Field names MUST be converted to lowercase when constructing an HTTP/2 message."
+        TRY(headers.try_append({ header.name.to_lowercase(), header.value }));
+    }
+
+    if (!request.body().is_empty() || request.method() == HttpRequest::Method::POST)
+        TRY(headers.try_append({ "content-length", String::number(request.body().size()) }));
+
+    return headers;
+}
+
+ErrorOr<u32> Http2Connection::open_stream(HttpRequest const& request, u16 weight, StreamCallbacks callbacks)
+{
+    VERIFY(weight >= 1 && weight <= 256);
+    if (!can_open_stream())
+        return Error::from_string_literal("Can't open any more streams on this connection");
+
+    auto header_block = TRY(m_encoder.encode(TRY(headers_for_request(request))));
+    auto stream = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Stream {
+        .callbacks = move(callbacks),
+        .send_window = m_remote_settings.initial_window_size,
+        .receive_window = local_stream_window_size,
+        .pending_body = TRY(ByteBuffer::copy(request.body())),
+    }));
+
+    auto stream_id = m_next_stream_id;
+    m_next_stream_id += 2;
+    dbgln_if(HTTP2_DEBUG, "HTTP/2: Opening stream {} with weight {} for {}", stream_id, weight, request.url());
+
+    // https://www.rfc-editor.org/rfc/rfc9113#section-6.2
+    // A non-exclusive dependency on stream 0, so that every stream shares the connection by weight.
+    u8 priority[5] = { 0, 0, 0, 0, static_cast<u8>(weight - 1) };
+    auto fragment_size = min<size_t>(header_block.size(), m_remote_settings.max_frame_size - sizeof(priority));
+    ByteBuffer first_payload;
+    TRY(first_payload.try_append(priority, sizeof(priority)));
+    TRY(first_payload.try_append(header_block.bytes().trim(fragment_size)));
+
+    u8 flags = Http2::Flags::Priority;
+    if (fragment_size == header_block.size())
+        flags |= Http2::Flags::EndHeaders;
+    if (stream->pending_body.is_empty())
+        flags |= Http2::Flags::EndStream;
+    queue_frame(Http2::FrameType::Headers, flags, stream_id, first_payload);
+
+    for (size_t offset = fragment_size; offset < header_block.size();) {
+        auto size = min<size_t>(header_block.size() - offset, m_remote_settings.max_frame_size);
+        auto is_last = offset + size == header_block.size();
+        queue_frame(Http2::FrameType::Continuation, is_last ? Http2::Flags::EndHeaders : 0, stream_id, header_block.bytes().slice(offset, size));
+        offset += size;
+    }
+
+    auto& stream_reference = *stream;
+    m_streams.set(stream_id, move(stream));
+    send_pending_body(stream_id, stream_reference);
+    flush_output();
+    return stream_id;
+}
+
+void Http2Connection::reset_stream(u32 stream_id)
+{
+    if (!m_streams.remove(stream_id))
+        return;
+    dbgln_if(HTTP2_DEBUG, "HTTP/2: Cancelling stream {}", stream_id);
+    u8 payload[4];
+    write_u32(payload, to_underlying(Http2::ErrorCode::Cancel));
+    queue_frame(Http2::FrameType::ResetStream, 0, stream_id, { payload, sizeof(payload) });
+    flush_output();
+}
+
+void Http2Connection::pause_stream(u32 stream_id)
+{
+    if (auto* stream = find_stream(stream_id))
+        stream->is_paused = true;
+}
+
+void Http2Connection::resume_stream(u32 stream_id)
+{
+    auto* stream = find_stream(stream_id);
+    if (!stream || !stream->is_paused)
+        return;
+    stream->is_paused = false;
+    if (stream->receive_window <= local_stream_window_size / 2) {
+        queue_window_update(stream_id, local_stream_window_size - stream->receive_window);
+        stream->receive_window = local_stream_window_size;
+        flush_output();
+    }
+}
+
+void Http2Connection::read_from_socket()
+{
+    NonnullRefPtr protector(*this);
+
+    // The socket is buffered, so we might not be notified about data that's already in the buffer. Read until it's empty.
+    while (true) {
+        auto can_read_without_blocking = m_socket.can_read_without_blocking();
+        if (can_read_without_blocking.is_error())
+            return fail_connection(Http2::ErrorCode::InternalError, Core::NetworkJob::Error::TransmissionFailed);
+        if (!can_read_without_blocking.value())
+            break;
+
+        u8 buffer[16 * KiB];
+        auto result = m_socket.read({ buffer, sizeof(buffer) });
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            dbgln("HTTP/2: Failed to read from the socket: {}", result.error());
+            return fail_connection(Http2::ErrorCode::InternalError, Core::NetworkJob::Error::TransmissionFailed);
+        }
+        if (result.value().is_empty())
+            break;
+        if (m_receive_buffer.try_append(result.value()).is_error())
+            return fail_connection(Http2::ErrorCode::InternalError, Core::NetworkJob::Error::TransmissionFailed);
+    }
+
+    process_received_frames();
+    flush_output();
+
+    if (!m_is_going_away && (m_socket.is_eof() || !m_socket.is_open())) {
+        dbgln_if(HTTP2_DEBUG, "HTTP/2: Connection closed with {} streams still open", m_streams.size());
+        m_is_going_away = true;
+        fail_all_streams(Core::NetworkJob::Error::TransmissionFailed);
+    }
+}
+
+void Http2Connection::process_received_frames()
+{
+    size_t offset = 0;
+    while (!m_is_going_away || !m_streams.is_empty()) {
+        auto data = m_receive_buffer.bytes().slice(offset);
+        if (data.size() < Http2::frame_header_size)
+            break;
+
+        auto header = Http2::FrameHeader::parse(data);
+        // We never raise SETTINGS_MAX_FRAME_SIZE, so this is the largest frame the server is allowed to send.
+        if (header.length > Http2::default_maximum_frame_size)
+            return fail_connection(Http2::ErrorCode::FrameSizeError, Core::NetworkJob::Error::ProtocolFailed);
+        if (data.size() < Http2::frame_header_size + header.length)
+            break;
+
+        offset += Http2::frame_header_size + header.length;
+        dbgln_if(HTTP2_DEBUG, "HTTP/2: Received {} frame for stream {} with {} bytes, flags {:02x}", Http2::to_string(header.type), header.stream_id, header.length, header.flags);
+        if (auto result = handle_frame(header, data.slice(Http2::frame_header_size, header.length)); result.is_error()) {
+            dbgln("HTTP/2: Closing the connection because of a {} frame: {}", Http2::to_string(header.type), Http2::to_string(result.error()));
+            return fail_connection(result.error(), Core::NetworkJob::Error::ProtocolFailed);
+        }
+    }
+
+    auto remaining = m_receive_buffer.size() - offset;
+    if (offset > 0 && remaining > 0)
+        memmove(m_receive_buffer.data(), m_receive_buffer.data() + offset, remaining);
+    m_receive_buffer.resize(remaining);
+}
+
+Http2Connection::FrameResult Http2Connection::handle_frame(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    // https://www.rfc-editor.org/rfc/rfc9113#section-6.10
+    if (m_is_expecting_continuation && (header.type != Http2::FrameType::Continuation || header.stream_id != m_header_block_stream_id))
+        return Http2::ErrorCode::ProtocolError;
+
+    switch (header.type) {
+    case Http2::FrameType::Data:
+        return handle_data(header, payload);
+    case Http2::FrameType::Headers:
+        return handle_headers(header, payload);
+    case Http2::FrameType::Continuation:
+        return handle_continuation(header, payload);
+    case Http2::FrameType::ResetStream:
+        return handle_reset_stream(header, payload);
+    case Http2::FrameType::Settings:
+        return handle_settings(header, payload);
+    case Http2::FrameType::Ping:
+        return handle_ping(header, payload);
+    case Http2::FrameType::GoAway:
+        return handle_go_away(header, payload);
+    case Http2::FrameType::WindowUpdate:
+        return handle_window_update(header, payload);
+    case Http2::FrameType::PushPromise:
+        // "A client cannot push. [...]" and we told the server not to either, with SETTINGS_ENABLE_PUSH.
+        return Http2::ErrorCode::ProtocolError;
+    case Http2::FrameType::Priority:
+        if (header.stream_id == 0)
+            return Http2::ErrorCode::ProtocolError;
+        return {};
+    }
+
+    // "Implementations MUST ignore and discard frames of unknown types."
+    return {};
+}
+
+Http2Connection::Stream* Http2Connection::find_stream(u32 stream_id)
+{
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return nullptr;
+    return it->value.ptr();
+}
+
+OwnPtr<Http2Connection::Stream> Http2Connection::take_stream(u32 stream_id)
+{
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return nullptr;
+    OwnPtr<Stream> stream = move(it->value);
+    m_streams.remove(it);
+    return stream;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.1
+Http2Connection::FrameResult Http2Connection::handle_data(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id == 0)
+        return Http2::ErrorCode::ProtocolError;
+
+    // Flow control covers the whole payload, padding included. It applies to streams we've since reset too.
+    m_receive_window -= header.length;
+    if (m_receive_window < 0)
+        return Http2::ErrorCode::FlowControlError;
+    // Slow readers are dealt with per stream (see pause_stream()), the connection window is handed out right away
+    // so that one of them can't hold up all the others.
+    if (m_receive_window <= local_connection_window_size / 2) {
+        queue_window_update(0, local_connection_window_size - m_receive_window);
+        m_receive_window = local_connection_window_size;
+    }
+
+    auto* stream = find_stream(header.stream_id);
+    if (!stream) {
+        if (!was_opened_by_us(header.stream_id))
+            return Http2::ErrorCode::ProtocolError;
+        // Whatever was in flight when we reset the stream.
+        return {};
+    }
+
+    if (!stream->has_received_headers) {
+        fail_stream(header.stream_id, Http2::ErrorCode::ProtocolError, Core::NetworkJob::Error::ProtocolFailed);
+        return {};
+    }
+
+    stream->receive_window -= header.length;
+    if (stream->receive_window < 0) {
+        fail_stream(header.stream_id, Http2::ErrorCode::FlowControlError, Core::NetworkJob::Error::ProtocolFailed);
+        return {};
+    }
+
+    auto content = Http2::frame_content(header, payload);
+    if (content.is_error())
+        return Http2::ErrorCode::ProtocolError;
+
+    if (!content.value().is_empty()) {
+        stream->callbacks.on_data(content.value());
+        // The stream may have been reset from within the callback.
+        stream = find_stream(header.stream_id);
+        if (!stream)
+            return {};
+    }
+
+    if (header.has_flag(Http2::Flags::EndStream)) {
+        finish_stream(header.stream_id);
+        return {};
+    }
+
+    if (!stream->is_paused && stream->receive_window <= local_stream_window_size / 2) {
+        queue_window_update(header.stream_id, local_stream_window_size - stream->receive_window);
+        stream->receive_window = local_stream_window_size;
+    }
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.2
+Http2Connection::FrameResult Http2Connection::handle_headers(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id == 0)
+        return Http2::ErrorCode::ProtocolError;
+
+    auto content = Http2::frame_content(header, payload);
+    if (content.is_error())
+        return Http2::ErrorCode::ProtocolError;
+
+    m_header_block.clear();
+    if (m_header_block.try_append(content.value()).is_error())
+        return Http2::ErrorCode::InternalError;
+    m_header_block_stream_id = header.stream_id;
+    m_header_block_ends_stream = header.has_flag(Http2::Flags::EndStream);
+
+    if (!header.has_flag(Http2::Flags::EndHeaders)) {
+        m_is_expecting_continuation = true;
+        return {};
+    }
+    return handle_header_block();
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.10
+Http2Connection::FrameResult Http2Connection::handle_continuation(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (!m_is_expecting_continuation)
+        return Http2::ErrorCode::ProtocolError;
+
+    // The block has to be decoded to keep HPACK in sync, so the only thing we can do about an oversized one is give up.
+    if (m_header_block.size() + payload.size() > local_maximum_header_list_size)
+        return Http2::ErrorCode::EnhanceYourCalm;
+    if (m_header_block.try_append(payload).is_error())
+        return Http2::ErrorCode::InternalError;
+
+    if (!header.has_flag(Http2::Flags::EndHeaders))
+        return {};
+    m_is_expecting_continuation = false;
+    return handle_header_block();
+}
+
+Http2Connection::FrameResult Http2Connection::handle_header_block()
+{
+    auto headers_or_error = m_decoder.decode(m_header_block);
+    m_header_block.clear();
+    if (headers_or_error.is_error()) {
+        dbgln("HTTP/2: Failed to decode a header block: {}", headers_or_error.error());
+        return Http2::ErrorCode::CompressionError;
+    }
+    auto headers = headers_or_error.release_value();
+
+    auto stream_id = m_header_block_stream_id;
+    auto* stream = find_stream(stream_id);
+    if (!stream) {
+        if (!was_opened_by_us(stream_id))
+            return Http2::ErrorCode::ProtocolError;
+        return {};
+    }
+
+    if (!stream->has_received_headers) {
+        auto status = headers.find_if([](auto& header) { return header.name == ":status"sv; });
+        auto status_code = status.is_end() ? Optional<u32> {} : status->value.to_uint();
+        if (!status_code.has_value()) {
+            fail_stream(stream_id, Http2::ErrorCode::ProtocolError, Core::NetworkJob::Error::ProtocolFailed);
+            return {};
+        }
+
+        // Informational responses like 103 Early Hints come before the real one.
+        if (*status_code >= 100 && *status_code < 200) {
+            if (m_header_block_ends_stream)
+                fail_stream(stream_id, Http2::ErrorCode::ProtocolError, Core::NetworkJob::Error::ProtocolFailed);
+            return {};
+        }
+
+        stream->has_received_headers = true;
+        stream->callbacks.on_headers(*status_code, headers);
+        stream = find_stream(stream_id);
+    }
+
+    if (stream && m_header_block_ends_stream)
+        finish_stream(stream_id);
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.4
+Http2Connection::FrameResult Http2Connection::handle_reset_stream(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id == 0)
+        return Http2::ErrorCode::ProtocolError;
+    if (payload.size() != 4)
+        return Http2::ErrorCode::FrameSizeError;
+
+    auto stream = take_stream(header.stream_id);
+    if (!stream)
+        return {};
+
+    auto error_code = static_cast<Http2::ErrorCode>(read_u32(payload));
+    dbgln("HTTP/2: Server reset stream {}: {}", header.stream_id, Http2::to_string(error_code));
+    stream->callbacks.on_error(Core::NetworkJob::Error::TransmissionFailed);
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.5
+Http2Connection::FrameResult Http2Connection::handle_settings(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id != 0)
+        return Http2::ErrorCode::ProtocolError;
+    if (header.has_flag(Http2::Flags::Ack)) {
+        if (!payload.is_empty())
+            return Http2::ErrorCode::FrameSizeError;
+        return {};
+    }
+
+    auto previous_initial_window_size = m_remote_settings.initial_window_size;
+    TRY(m_remote_settings.apply(payload));
+    m_encoder.set_maximum_table_size(m_remote_settings.header_table_size);
+
+    // "a change to SETTINGS_INITIAL_WINDOW_SIZE MUST adjust the size of all stream flow-control windows that it maintains by the difference"
+    auto window_size_difference = static_cast<i64>(m_remote_settings.initial_window_size) - previous_initial_window_size;
+    for (auto& it : m_streams) {
+        it.value->send_window += window_size_difference;
+        if (it.value->send_window > Http2::maximum_window_size)
+            return Http2::ErrorCode::FlowControlError;
+    }
+
+    queue_frame(Http2::FrameType::Settings, Http2::Flags::Ack, 0, {});
+    if (window_size_difference > 0)
+        send_all_pending_bodies();
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.7
+Http2Connection::FrameResult Http2Connection::handle_ping(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id != 0)
+        return Http2::ErrorCode::ProtocolError;
+    if (payload.size() != 8)
+        return Http2::ErrorCode::FrameSizeError;
+    if (!header.has_flag(Http2::Flags::Ack))
+        queue_frame(Http2::FrameType::Ping, Http2::Flags::Ack, 0, payload);
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.8
+Http2Connection::FrameResult Http2Connection::handle_go_away(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (header.stream_id != 0)
+        return Http2::ErrorCode::ProtocolError;
+    if (payload.size() < 8)
+        return Http2::ErrorCode::FrameSizeError;
+
+    auto last_stream_id = read_u32(payload) & Http2::maximum_stream_id;
+    auto error_code = static_cast<Http2::ErrorCode>(read_u32(payload, 4));
+    dbgln_if(HTTP2_DEBUG, "HTTP/2: Server is going away after stream {}: {}", last_stream_id, Http2::to_string(error_code));
+    m_is_going_away = true;
+
+    // Streams up to the last one are still being worked on, everything after that was never looked at.
+    Vector<u32> unprocessed_streams;
+    for (auto& it : m_streams) {
+        if (it.key > last_stream_id)
+            unprocessed_streams.append(it.key);
+    }
+    for (auto stream_id : unprocessed_streams) {
+        if (auto stream = take_stream(stream_id))
+            stream->callbacks.on_error(Core::NetworkJob::Error::ConnectionFailed);
+    }
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9113#section-6.9
+Http2Connection::FrameResult Http2Connection::handle_window_update(Http2::FrameHeader const& header, ReadonlyBytes payload)
+{
+    if (payload.size() != 4)
+        return Http2::ErrorCode::FrameSizeError;
+
+    auto increment = read_u32(payload) & Http2::maximum_window_size;
+    if (header.stream_id == 0) {
+        if (increment == 0)
+            return Http2::ErrorCode::ProtocolError;
+        m_send_window += increment;
+        if (m_send_window > Http2::maximum_window_size)
+            return Http2::ErrorCode::FlowControlError;
+        send_all_pending_bodies();
+        return {};
+    }
+
+    auto* stream = find_stream(header.stream_id);
+    if (!stream)
+        return {};
+    if (increment == 0) {
+        fail_stream(header.stream_id, Http2::ErrorCode::ProtocolError, Core::NetworkJob::Error::ProtocolFailed);
+        return {};
+    }
+    stream->send_window += increment;
+    if (stream->send_window > Http2::maximum_window_size) {
+        fail_stream(header.stream_id, Http2::ErrorCode::FlowControlError, Core::NetworkJob::Error::ProtocolFailed);
+        return {};
+    }
+    send_pending_body(header.stream_id, *stream);
+    return {};
+}
+
+void Http2Connection::send_pending_body(u32 stream_id, Stream& stream)
+{
+    auto& body = stream.pending_body;
+    while (stream.pending_body_offset < body.size() && stream.send_window > 0 && m_send_window > 0) {
+        auto size = min(body.size() - stream.pending_body_offset, static_cast<size_t>(m_remote_settings.max_frame_size));
+        size = min(size, static_cast<size_t>(min(stream.send_window, m_send_window)));
+        auto is_last = stream.pending_body_offset + size == body.size();
+        queue_frame(Http2::FrameType::Data, is_last ? Http2::Flags::EndStream : 0, stream_id, body.bytes().slice(stream.pending_body_offset, size));
+        stream.pending_body_offset += size;
+        stream.send_window -= size;
+        m_send_window -= size;
+    }
+
+    if (stream.pending_body_offset == body.size() && !body.is_empty()) {
+        body.clear();
+        stream.pending_body_offset = 0;
+    }
+}
+
+void Http2Connection::send_all_pending_bodies()
+{
+    for (auto& it : m_streams) {
+        if (m_send_window <= 0)
+            break;
+        if (!it.value->pending_body.is_empty())
+            send_pending_body(it.key, *it.value);
+    }
+}
+
+void Http2Connection::finish_stream(u32 stream_id)
+{
+    auto stream = take_stream(stream_id);
+    VERIFY(stream);
+    dbgln_if(HTTP2_DEBUG, "HTTP/2: Stream {} finished", stream_id);
+    stream->callbacks.on_finish();
+}
+
+void Http2Connection::fail_stream(u32 stream_id, Http2::ErrorCode error_code, Core::NetworkJob::Error error)
+{
+    auto stream = take_stream(stream_id);
+    if (!stream)
+        return;
+
+    dbgln("HTTP/2: Resetting stream {}: {}", stream_id, Http2::to_string(error_code));
+    u8 payload[4];
+    write_u32(payload, to_underlying(error_code));
+    queue_frame(Http2::FrameType::ResetStream, 0, stream_id, { payload, sizeof(payload) });
+    stream->callbacks.on_error(error);
+}
+
+void Http2Connection::fail_connection(Http2::ErrorCode error_code, Core::NetworkJob::Error error)
+{
+    if (!m_is_going_away) {
+        // We never accept streams from the server, so it can't have started any that we might have processed.
+        u8 payload[8];
+        write_u32(payload, 0);
+        write_u32(payload + 4, to_underlying(error_code));
+        queue_frame(Http2::FrameType::GoAway, 0, 0, { payload, sizeof(payload) });
+        flush_output();
+        m_is_going_away = true;
+    }
+
+    m_receive_buffer.clear();
+    fail_all_streams(error);
+    m_socket.close();
+}
+
+void Http2Connection::fail_all_streams(Core::NetworkJob::Error error)
+{
+    auto streams = move(m_streams);
+    for (auto& it : streams)
+        it.value->callbacks.on_error(error);
+}
+
+void Http2Connection::queue_frame(Http2::FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (Http2::append_frame(m_output, type, flags, stream_id, payload).is_error()) {
+        dbgln("HTTP/2: Ran out of memory while queueing a {} frame", Http2::to_string(type));
+        m_is_going_away = true;
+    }
+}
+
+void Http2Connection::queue_window_update(u32 stream_id, u32 increment)
+{
+    u8 payload[4];
+    write_u32(payload, increment);
+    queue_frame(Http2::FrameType::WindowUpdate, 0, stream_id, { payload, sizeof(payload) });
+}
+
+void Http2Connection::flush_output()
+{
+    if (m_output.is_empty())
+        return;
+
+    // Everything that piled up while handling a batch of frames goes out together.
+    auto success = m_socket.write_or_error(m_output);
+    m_output.clear();
+    if (!success && !m_is_going_away) {
+        dbgln("HTTP/2: Failed to write to the socket");
+        m_is_going_away = true;
+        fail_all_streams(Core::NetworkJob::Error::TransmissionFailed);
+    }
+}
+
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/Weakable.h>
+#include <LibCore/NetworkJob.h>
+#include <LibCore/Stream.h>
+#include <LibHTTP/HPack.h>
+#include <LibHTTP/Http2.h>
+#include <LibHTTP/HttpRequest.h>
+
+namespace HTTP {
+
+// Runs any number of requests at the same time over one socket that negotiated "h2" through ALPN.
+// It takes over the socket's on_ready_to_read, and has to be destroyed before the socket is.
+class Http2Connection
+    : public RefCounted<Http2Connection>
+    , public Weakable<Http2Connection> {
+public:
+    struct StreamCallbacks {
+        // Called once, with the final (non-1xx) response. Trailers are dropped.
+        Function<void(u32 status_code, Vector<HPack::Header> const&)> on_headers;
+        Function<void(ReadonlyBytes)> on_data;
+        Function<void()> on_finish;
+        Function<void(Core::NetworkJob::Error)> on_error;
+    };
+
+    // Servers split their bandwidth between streams by weight, which goes from 1 to 256.
+    static constexpr u16 default_stream_weight = 16;
+
+    // Servers may allow any number of streams, but past this point more of them won't make anything faster.
+    static constexpr u32 maximum_concurrent_streams = 100;
+
+    static ErrorOr<NonnullRefPtr<Http2Connection>> try_create(Core::Stream::BufferedSocketBase&);
+    ~Http2Connection();
+
+    // Sends the request right away, and returns the stream it went out on.
+    ErrorOr<u32> open_stream(HttpRequest const&, u16 weight, StreamCallbacks);
+
+    // Tells the server that we're no longer interested. None of the stream's callbacks will be called again.
+    void reset_stream(u32 stream_id);
+
+    // Holds back the stream's flow control window, so that the server stops sending its body until it's resumed.
+    void pause_stream(u32 stream_id);
+    void resume_stream(u32 stream_id);
+
+    bool can_open_stream() const;
+    bool is_going_away() const { return m_is_going_away; }
+    size_t active_stream_count() const { return m_streams.size(); }
+
+    Core::Stream::BufferedSocketBase& socket() { return m_socket; }
+
+private:
+    struct Stream {
+        StreamCallbacks callbacks;
+        // Windows can go negative when the peer shrinks SETTINGS_INITIAL_WINDOW_SIZE.
+        i64 send_window { 0 };
+        i64 receive_window { 0 };
+        ByteBuffer pending_body;
+        size_t pending_body_offset { 0 };
+        bool has_received_headers { false };
+        bool is_paused { false };
+    };
+
+    using FrameResult = ErrorOr<void, Http2::ErrorCode>;
+
+    explicit Http2Connection(Core::Stream::BufferedSocketBase&);
+
+    ErrorOr<void> send_preface();
+    void read_from_socket();
+    void process_received_frames();
+
+    FrameResult handle_frame(Http2::FrameHeader const&, ReadonlyBytes payload);
+    FrameResult handle_data(Http2::FrameHeader const&, ReadonlyBytes payload);
+    FrameResult handle_headers(Http2::FrameHeader const&, ReadonlyBytes payload);
+    FrameResult handle_continuation(Http2::FrameHeader const&, ReadonlyBytes payload);
+    FrameResult handle_header_block();
+    FrameResult handle_reset_stream(Http2::FrameHeader const&, ReadonlyBytes payload);
+    FrameResult handle_settings(Http2::FrameHeader const&, ReadonlyBytes payload);
+    FrameResult handle_ping(Http2::FrameHeader const&, ReadonlyBytes payload);
+    FrameResult handle_go_away(Http2::FrameHeader const&, ReadonlyBytes payload);
+    FrameResult handle_window_update(Http2::FrameHeader const&, ReadonlyBytes payload);
+
+    Stream* find_stream(u32 stream_id);
+    OwnPtr<Stream> take_stream(u32 stream_id);
+    bool was_opened_by_us(u32 stream_id) const { return stream_id % 2 == 1 && stream_id < m_next_stream_id; }
+    void finish_stream(u32 stream_id);
+    void fail_stream(u32 stream_id, Http2::ErrorCode, Core::NetworkJob::Error);
+    void fail_connection(Http2::ErrorCode, Core::NetworkJob::Error);
+    void fail_all_streams(Core::NetworkJob::Error);
+
+    void send_pending_body(u32 stream_id, Stream&);
+    void send_all_pending_bodies();
+    void queue_frame(Http2::FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void queue_window_update(u32 stream_id, u32 increment);
+    void flush_output();
+
+    Core::Stream::BufferedSocketBase& m_socket;
+    HashMap<u32, NonnullOwnPtr<Stream>> m_streams;
+    u32 m_next_stream_id { 1 };
+
+    Http2::Settings m_remote_settings;
+    HPack::Encoder m_encoder;
+    HPack::Decoder m_decoder;
+
+    i64 m_send_window { Http2::default_initial_window_size };
+    i64 m_receive_window { Http2::default_initial_window_size };
+
+    ByteBuffer m_receive_buffer;
+    ByteBuffer m_output;
+
+    // A header block may be split across a HEADERS frame and any number of CONTINUATIONs, nothing else may come in between.
+    ByteBuffer m_header_block;
+    u32 m_header_block_stream_id { 0 };
+    bool m_header_block_ends_stream { false };
+    bool m_is_expecting_continuation { false };
+
+    bool m_is_going_away { false };
+};
+
+}
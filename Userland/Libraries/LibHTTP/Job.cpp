@@ -126,6 +126,20 @@ void Job::shutdown(ShutdownMode mode)
 {
     if (!m_socket)
         return;
+    if (m_is_http2_stream) {
+        // The socket belongs to every stream on the connection, so only ours goes away.
+        if (m_http2_connection && m_http2_stream_id != 0)
+            m_http2_connection->reset_stream(m_http2_stream_id);
+        m_http2_connection = nullptr;
+        m_http2_stream_id = 0;
+        m_socket = nullptr;
+        return;
+    }
+    // The socket might go back to the connection cache, make sure it's usable for the next job.
+    if (m_is_reading_paused) {
+        m_is_reading_paused = false;
+        m_socket->set_notifications_enabled(true);
+    }
     if (mode == ShutdownMode::CloseSocket) {
         m_socket->close();
         m_socket->on_ready_to_read = nullptr;
@@ -179,7 +193,7 @@ void Job::register_on_ready_to_read(Function<void()> callback)
         auto can_read_without_blocking = m_socket->can_read_without_blocking();
         if (can_read_without_blocking.is_error())
             return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-        if (can_read_without_blocking.value() && m_state != State::Finished && !has_error()) {
+        if (can_read_without_blocking.value() && m_state != State::Finished && !has_error() && !m_is_reading_paused) {
             deferred_invoke([this] {
                 if (m_socket && m_socket->on_ready_to_read)
                     m_socket->on_ready_to_read();
@@ -212,6 +226,148 @@ ErrorOr<ByteBuffer> Job::receive(size_t size)
     return buffer.slice(0, nread);
 }
 
+void Job::add_response_header(StringView name, String value)
+{
+    if (name.equals_ignoring_case("Set-Cookie"sv)) {
+        dbgln_if(JOB_DEBUG, "Job: Received Set-Cookie header: '{}'", value);
+        m_set_cookie_headers.append(move(value));
+        return;
+    }
+
+    if (auto existing_value = m_headers.get(name); existing_value.has_value()) {
+        StringBuilder builder;
+        builder.append(existing_value.value());
+        builder.append(',');
+        builder.append(value);
+        m_headers.set(name, builder.build());
+    } else {
+        m_headers.set(name, value);
+    }
+
+    if (name.equals_ignoring_case("Content-Encoding"sv)) {
+        // Assume that any content-encoding means that we can't decode it as a stream :(
+        dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
+        m_can_stream_response = false;
+    } else if (name.equals_ignoring_case("Content-Length"sv)) {
+        auto length = value.to_uint();
+        if (length.has_value())
+            m_content_length = length.value();
+    }
+}
+
+void Job::did_receive_all_headers()
+{
+    if (on_headers_received) {
+        if (!m_set_cookie_headers.is_empty())
+            m_headers.set("Set-Cookie", JsonArray { m_set_cookie_headers }.to_string());
+        on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
+    }
+    m_state = State::InBody;
+}
+
+void Job::did_receive_body_data(ByteBuffer payload)
+{
+    m_received_buffers.append(make<ReceivedBuffer>(move(payload)));
+    m_buffered_size += m_received_buffers.last().data.size();
+    m_received_size += m_received_buffers.last().data.size();
+    flush_received_buffers();
+
+    // Without streaming, the body has to be buffered in full anyway, so there's no point in pausing.
+    if (m_can_stream_response && m_buffered_size > maximum_buffered_size)
+        pause_reading();
+
+    deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+}
+
+void Job::pause_reading()
+{
+    if (m_is_reading_paused)
+        return;
+    dbgln_if(JOB_DEBUG, "Job: {} bytes are waiting to be flushed for {}, pausing reads", m_buffered_size, m_request.url());
+    m_is_reading_paused = true;
+    if (m_is_http2_stream) {
+        // The socket is shared with the other streams, so only this stream's flow control window is held back.
+        if (m_http2_connection && m_http2_stream_id != 0)
+            m_http2_connection->pause_stream(m_http2_stream_id);
+    } else if (m_socket) {
+        m_socket->set_notifications_enabled(false);
+    }
+    // The timer keeps flushing until the output stream has caught up.
+    if (!has_timer())
+        start_timer(50);
+}
+
+void Job::resume_reading()
+{
+    if (!m_is_reading_paused)
+        return;
+    dbgln_if(JOB_DEBUG, "Job: Output has caught up for {}, resuming reads", m_request.url());
+    m_is_reading_paused = false;
+    if (m_is_http2_stream) {
+        if (m_http2_connection && m_http2_stream_id != 0)
+            m_http2_connection->resume_stream(m_http2_stream_id);
+        return;
+    }
+    if (!m_socket)
+        return;
+    m_socket->set_notifications_enabled(true);
+    // Whatever is already in the socket's buffer won't cause a notification.
+    deferred_invoke([this] {
+        if (m_socket && m_socket->on_ready_to_read)
+            m_socket->on_ready_to_read();
+    });
+}
+
+void Job::start_on_http2_connection(Http2Connection& connection, u16 weight)
+{
+    VERIFY(!m_socket);
+    m_socket = &connection.socket();
+    m_http2_connection = connection;
+    m_is_http2_stream = true;
+
+    Http2Connection::StreamCallbacks callbacks {
+        .on_headers = [this](auto status_code, auto& headers) { did_receive_http2_headers(status_code, headers); },
+        .on_data = [this](auto data) {
+            auto buffer = ByteBuffer::copy(data);
+            if (buffer.is_error()) {
+                shutdown(ShutdownMode::DetachFromSocket);
+                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+            }
+            did_receive_body_data(buffer.release_value());
+        },
+        .on_finish = [this] {
+            m_http2_stream_id = 0;
+            finish_up();
+        },
+        .on_error = [this](auto error) {
+            m_http2_stream_id = 0;
+            deferred_invoke([this, error] { did_fail(error); });
+        },
+    };
+
+    auto stream_id = connection.open_stream(m_request, weight, move(callbacks));
+    if (stream_id.is_error()) {
+        dbgln("Job: Failed to start a stream for {}: {}", m_request.url(), stream_id.error());
+        return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ConnectionFailed); });
+    }
+    m_http2_stream_id = stream_id.release_value();
+    dbgln_if(JOB_DEBUG, "Job: {} runs on HTTP/2 stream {}", m_request.url(), m_http2_stream_id);
+}
+
+void Job::did_receive_http2_headers(u32 status_code, Vector<HPack::Header> const& headers)
+{
+    m_code = static_cast<int>(status_code);
+    for (auto& header : headers) {
+        // The pseudo-headers have been dealt with by the connection already.
+        if (header.name.starts_with(':'))
+            continue;
+        add_response_header(header.name, header.value);
+    }
+    did_receive_all_headers();
+
+    // There's no Connection: close, transfer codings or reading until EOF with HTTP/2, the stream ends the response.
+}
+
 void Job::on_socket_connected()
 {
     auto raw_request = m_request.to_raw_request();
@@ -336,12 +492,7 @@ void Job::on_socket_connected()
                 if (m_state == State::Trailers) {
                     return finish_up();
                 }
-                if (on_headers_received) {
-                    if (!m_set_cookie_headers.is_empty())
-                        m_headers.set("Set-Cookie", JsonArray { m_set_cookie_headers }.to_string());
-                    on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
-                }
-                m_state = State::InBody;
+                did_receive_all_headers();
 
                 // We've reached the end of the headers, there's a possibility that the server
                 // responds with nothing (content-length = 0 with normal encoding); if that's the case,
@@ -381,33 +532,7 @@ void Job::on_socket_connected()
                 return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
             }
             auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
-            if (name.equals_ignoring_case("Set-Cookie"sv)) {
-                dbgln_if(JOB_DEBUG, "Job: Received Set-Cookie header: '{}'", value);
-                m_set_cookie_headers.append(move(value));
-
-                auto can_read_without_blocking = m_socket->can_read_without_blocking();
-                if (can_read_without_blocking.is_error())
-                    return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-                if (!can_read_without_blocking.value())
-                    return;
-            } else if (auto existing_value = m_headers.get(name); existing_value.has_value()) {
-                StringBuilder builder;
-                builder.append(existing_value.value());
-                builder.append(',');
-                builder.append(value);
-                m_headers.set(name, builder.build());
-            } else {
-                m_headers.set(name, value);
-            }
-            if (name.equals_ignoring_case("Content-Encoding"sv)) {
-                // Assume that any content-encoding means that we can't decode it as a stream :(
-                dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
-                m_can_stream_response = false;
-            } else if (name.equals_ignoring_case("Content-Length"sv)) {
-                auto length = value.to_uint();
-                if (length.has_value())
-                    m_content_length = length.value();
-            }
+            add_response_header(name, value);
             dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
 
             auto can_read_without_blocking = m_socket->can_read_without_blocking();
@@ -420,7 +545,7 @@ void Job::on_socket_connected()
         }
         VERIFY(m_state == State::InBody);
 
-        while (true) {
+        while (!m_is_reading_paused) {
             auto can_read_without_blocking = m_socket->can_read_without_blocking();
             if (can_read_without_blocking.is_error())
                 return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
@@ -534,12 +659,8 @@ void Job::on_socket_connected()
                 }
             }
 
-            m_received_buffers.append(make<ReceivedBuffer>(payload));
-            m_buffered_size += payload.size();
-            m_received_size += payload.size();
-            flush_received_buffers();
-
-            deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+            auto payload_size = payload.size();
+            did_receive_body_data(move(payload));
 
             if (read_everything) {
                 VERIFY(m_received_size <= m_content_length.value());
@@ -556,7 +677,7 @@ void Job::on_socket_connected()
             }
 
             if (m_current_chunk_remaining_size.has_value()) {
-                auto size = m_current_chunk_remaining_size.value() - payload.size();
+                auto size = m_current_chunk_remaining_size.value() - payload_size;
 
                 dbgln_if(JOB_DEBUG, "Job: We have {} bytes left over in this chunk", size);
                 if (size == 0) {
@@ -598,7 +719,16 @@ void Job::on_socket_connected()
 void Job::timer_event(Core::TimerEvent& event)
 {
     event.accept();
-    finish_up();
+    if (m_state != State::Finished) {
+        flush_received_buffers();
+        if (m_buffered_size <= maximum_buffered_size / 2) {
+            stop_timer();
+            resume_reading();
+        }
+        return;
+    }
+    if (!m_has_scheduled_finish)
+        finish_up();
     if (m_buffered_size == 0)
         stop_timer();
 }
@@ -607,6 +737,12 @@ void Job::finish_up()
 {
     VERIFY(!m_has_scheduled_finish);
     m_state = State::Finished;
+    if (m_is_reading_paused) {
+        // We won't read anything else, but whoever uses the socket next will.
+        m_is_reading_paused = false;
+        if (!m_is_http2_stream && m_socket)
+            m_socket->set_notifications_enabled(true);
+    }
     if (!m_can_stream_response) {
         auto maybe_flattened_buffer = ByteBuffer::create_uninitialized(m_buffered_size);
         if (maybe_flattened_buffer.is_error())
@@ -10,7 +10,9 @@
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Optional.h>
+#include <AK/WeakPtr.h>
 #include <LibCore/NetworkJob.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 
@@ -26,16 +28,29 @@ public:
     virtual void start(Core::Stream::Socket&) override;
     virtual void shutdown(ShutdownMode) override;
 
+    // Runs the request as a stream on the connection, next to whatever else is running on it.
+    void start_on_http2_connection(Http2Connection&, u16 weight = Http2Connection::default_stream_weight);
+
     Core::Stream::Socket const* socket() const { return m_socket; }
     URL url() const { return m_request.url(); }
 
+    // Once this much of the body is waiting for the output stream to take it, we stop reading from the socket
+    // until the output has caught up, which makes the server slow down for slow readers.
+    static constexpr size_t maximum_buffered_size = 1 * MiB;
+
     HttpResponse* response() { return static_cast<HttpResponse*>(Core::NetworkJob::response()); }
     HttpResponse const* response() const { return static_cast<HttpResponse const*>(Core::NetworkJob::response()); }
 
 protected:
     void finish_up();
     void on_socket_connected();
+    void add_response_header(StringView name, String value);
+    void did_receive_all_headers();
+    void did_receive_http2_headers(u32 status_code, Vector<HPack::Header> const&);
+    void did_receive_body_data(ByteBuffer);
     void flush_received_buffers();
+    void pause_reading();
+    void resume_reading();
     void register_on_ready_to_read(Function<void()>);
     ErrorOr<String> read_line(size_t);
     ErrorOr<ByteBuffer> receive(size_t);
@@ -81,6 +96,11 @@ protected:
     bool m_can_stream_response { true };
     bool m_should_read_chunk_ending_line { false };
     bool m_has_scheduled_finish { false };
+    bool m_is_reading_paused { false };
+
+    bool m_is_http2_stream { false };
+    WeakPtr<Http2Connection> m_http2_connection;
+    u32 m_http2_stream_id { 0 };
 };
 
 }
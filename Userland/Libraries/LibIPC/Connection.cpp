@@ -5,13 +5,33 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Debug.h>
+#include <AK/TemporaryChange.h>
 #include <LibCore/System.h>
 #include <LibIPC/Connection.h>
 #include <LibIPC/Stub.h>
+#include <fcntl.h>
 #include <sys/select.h>
 
 namespace IPC {
 
+// The number of out-of-line buffers each connection keeps around for reuse.
+static constexpr size_t max_out_of_line_buffers = 4;
+
+// Placed at the start of each out-of-line buffer, followed by the message.
+struct OutOfLineBufferHeader {
+    // Set by the sender when it puts a message into the buffer, and cleared by the receiver once it has decoded it.
+    u32 in_use;
+    u32 message_size;
+};
+
+// Sent over the socket in place of an out-of-line message.
+struct OutOfLineMessageHeader {
+    u32 buffer_id;
+    // If this is not zero, the fd of a new buffer of this size precedes any fds of the message itself.
+    u32 new_buffer_size;
+};
+
 struct CoreEventLoopDeferredInvoker final : public DeferredInvoker {
     virtual ~CoreEventLoopDeferredInvoker() = default;
 
@@ -59,9 +79,17 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     if (!m_socket->is_open())
         return Error::from_string_literal("Trying to post_message during IPC shutdown");
 
+    ++m_statistics.messages_sent;
+    bool is_out_of_line = false;
+    if (buffer.data.size() >= out_of_line_message_threshold)
+        is_out_of_line = TRY(try_move_to_out_of_line_buffer(buffer));
+
     // Prepend the message size.
     uint32_t message_size = buffer.data.size();
+    if (is_out_of_line)
+        message_size |= out_of_line_message_flag;
     TRY(buffer.data.try_prepend(reinterpret_cast<u8 const*>(&message_size), sizeof(message_size)));
+    m_statistics.bytes_sent_inline += buffer.data.size();
 
     for (auto& fd : buffer.fds) {
         if (auto result = fd_passing_socket().send_fd(fd.value()); result.is_error()) {
@@ -70,7 +98,27 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
         }
     }
 
-    ReadonlyBytes bytes_to_write { buffer.data.span() };
+    // NOTE: The fds have been sent already, but the peer only picks them up once it decodes the message.
+    if (m_is_coalescing_writes) {
+        TRY(m_pending_bytes.try_append(buffer.data.data(), buffer.data.size()));
+        return {};
+    }
+
+    return write_to_socket(buffer.data.span());
+}
+
+ErrorOr<void> ConnectionBase::flush_pending_messages()
+{
+    if (m_pending_bytes.is_empty())
+        return {};
+    auto bytes = move(m_pending_bytes);
+    if (!m_socket->is_open())
+        return Error::from_string_literal("Trying to flush messages during IPC shutdown");
+    return write_to_socket(bytes.span());
+}
+
+ErrorOr<void> ConnectionBase::write_to_socket(ReadonlyBytes bytes_to_write)
+{
     int writes_done = 0;
     size_t initial_size = bytes_to_write.size();
     while (!bytes_to_write.is_empty()) {
@@ -109,12 +157,130 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     return {};
 }
 
+ErrorOr<bool> ConnectionBase::try_move_to_out_of_line_buffer(MessageBuffer& buffer)
+{
+    auto buffer_size_needed = sizeof(OutOfLineBufferHeader) + buffer.data.size();
+
+    auto is_in_use = [](Core::AnonymousBuffer& out_of_line_buffer) {
+        return AK::atomic_load(&out_of_line_buffer.data<OutOfLineBufferHeader>()->in_use, AK::MemoryOrder::memory_order_acquire) != 0;
+    };
+
+    Optional<size_t> buffer_id;
+    Optional<size_t> replaceable_buffer_id;
+    for (size_t i = 0; i < m_out_of_line_buffers.size(); ++i) {
+        auto& out_of_line_buffer = m_out_of_line_buffers[i];
+        if (is_in_use(out_of_line_buffer))
+            continue;
+        if (out_of_line_buffer.size() >= buffer_size_needed) {
+            buffer_id = i;
+            break;
+        }
+        if (!replaceable_buffer_id.has_value())
+            replaceable_buffer_id = i;
+    }
+
+    bool is_new_buffer = !buffer_id.has_value();
+    if (is_new_buffer) {
+        if (m_out_of_line_buffers.size() < max_out_of_line_buffers)
+            buffer_id = m_out_of_line_buffers.size();
+        else if (replaceable_buffer_id.has_value())
+            buffer_id = replaceable_buffer_id;
+        else
+            return false; // The peer is still busy with all of our buffers, so just write the message to the socket.
+
+        auto new_buffer = TRY(Core::AnonymousBuffer::create_with_size(round_up_to_power_of_two(buffer_size_needed, out_of_line_message_threshold)));
+        if (buffer_id.value() == m_out_of_line_buffers.size())
+            TRY(m_out_of_line_buffers.try_append(move(new_buffer)));
+        else
+            m_out_of_line_buffers[buffer_id.value()] = move(new_buffer);
+        ++m_statistics.out_of_line_buffers_created;
+    } else {
+        ++m_statistics.out_of_line_buffers_reused;
+    }
+
+    auto& out_of_line_buffer = m_out_of_line_buffers[buffer_id.value()];
+    OutOfLineMessageHeader message_header { static_cast<u32>(buffer_id.value()), 0 };
+    if (is_new_buffer) {
+        message_header.new_buffer_size = out_of_line_buffer.size();
+        auto fd = TRY(Core::System::dup(out_of_line_buffer.fd()));
+        TRY(buffer.fds.try_prepend(adopt_ref(*new AutoCloseFileDescriptor(fd))));
+    }
+
+    auto* buffer_header = out_of_line_buffer.data<OutOfLineBufferHeader>();
+    buffer_header->in_use = 1;
+    buffer_header->message_size = buffer.data.size();
+    memcpy(buffer_header + 1, buffer.data.data(), buffer.data.size());
+    m_statistics.bytes_sent_out_of_line += buffer.data.size();
+
+    buffer.data.clear_with_capacity();
+    buffer.data.append(reinterpret_cast<u8 const*>(&message_header), sizeof(message_header));
+    return true;
+}
+
+ErrorOr<ByteBuffer> ConnectionBase::receive_out_of_line_message(ReadonlyBytes header_bytes)
+{
+    if (header_bytes.size() != sizeof(OutOfLineMessageHeader))
+        return Error::from_string_literal("Out-of-line message header has the wrong size");
+    OutOfLineMessageHeader message_header;
+    memcpy(&message_header, header_bytes.data(), sizeof(message_header));
+    if (message_header.buffer_id >= max_out_of_line_buffers)
+        return Error::from_string_literal("Out-of-line message uses an invalid buffer");
+
+    if (message_header.new_buffer_size != 0) {
+        auto fd = TRY(fd_passing_socket().receive_fd(O_CLOEXEC));
+        auto new_buffer = TRY(Core::AnonymousBuffer::create_from_anon_fd(fd, message_header.new_buffer_size));
+        TRY(m_peer_out_of_line_buffers.try_set(message_header.buffer_id, move(new_buffer)));
+    }
+
+    auto it = m_peer_out_of_line_buffers.find(message_header.buffer_id);
+    if (it == m_peer_out_of_line_buffers.end())
+        return Error::from_string_literal("Out-of-line message uses an unknown buffer");
+    auto& out_of_line_buffer = it->value;
+
+    // NOTE: The peer could change the buffer under our feet, so only look at the message size once.
+    auto message_size = AK::atomic_load(&out_of_line_buffer.data<OutOfLineBufferHeader>()->message_size, AK::MemoryOrder::memory_order_relaxed);
+    if (message_size > out_of_line_buffer.size() - sizeof(OutOfLineBufferHeader))
+        return Error::from_string_literal("Out-of-line message is larger than its buffer");
+
+    // NOTE: The peer may also keep writing to the message, so it's copied out before anything decodes it.
+    //       After that, the peer can have the buffer back.
+    auto message = TRY(ByteBuffer::copy(out_of_line_buffer.data<u8>() + sizeof(OutOfLineBufferHeader), message_size));
+    AK::atomic_store(&out_of_line_buffer.data<OutOfLineBufferHeader>()->in_use, 0u, AK::MemoryOrder::memory_order_release);
+
+    m_statistics.bytes_received_out_of_line += message_size;
+    return message;
+}
+
 void ConnectionBase::shutdown()
 {
+    dbgln_if(IPC_STATISTICS_DEBUG, "IPC::ConnectionBase ({:p}, {}): sent {} messages ({} bytes inline, {} bytes out-of-line, {} buffers created, {} reused), received {} messages ({} bytes inline, {} bytes out-of-line)",
+        this, m_local_stub.name(),
+        m_statistics.messages_sent, m_statistics.bytes_sent_inline, m_statistics.bytes_sent_out_of_line,
+        m_statistics.out_of_line_buffers_created, m_statistics.out_of_line_buffers_reused,
+        m_statistics.messages_received, m_statistics.bytes_received_inline, m_statistics.bytes_received_out_of_line);
+    if (m_socket->is_open())
+        (void)flush_pending_messages();
     m_socket->close();
+
+    auto expected_responses = move(m_expected_responses);
+    for (auto& expected_response : expected_responses)
+        expected_response.callback(nullptr);
+
     die();
 }
 
+u32 ConnectionBase::expect_response(u32 endpoint_magic, int message_id, ResponseCallback callback)
+{
+    auto id = m_next_expected_response_id++;
+    m_expected_responses.append({ id, endpoint_magic, message_id, move(callback) });
+    return id;
+}
+
+void ConnectionBase::cancel_expected_response(u32 id)
+{
+    m_expected_responses.remove_first_matching([&](auto& expected_response) { return expected_response.id == id; });
+}
+
 void ConnectionBase::shutdown_with_error(Error const& error)
 {
     dbgln("IPC::ConnectionBase ({:p}) had an error ({}), disconnecting.", this, error);
@@ -123,16 +289,55 @@ void ConnectionBase::shutdown_with_error(Error const& error)
 
 void ConnectionBase::handle_messages()
 {
+    if (!m_local_stub.m_connection)
+        m_local_stub.m_connection = make_weak_ptr<ConnectionBase>();
+
+    // Everything we send while handling a batch of messages goes out in a single write once we're done.
     auto messages = move(m_unprocessed_messages);
-    for (auto& message : messages) {
-        if (message.endpoint_magic() == m_local_endpoint_magic) {
-            if (auto response = m_local_stub.handle(message)) {
-                if (auto result = post_message(*response); result.is_error()) {
-                    dbgln("IPC::ConnectionBase::handle_messages: {}", result.error());
+
+    // Responses that someone is waiting for are taken out first, and handed over once the rest of the batch is done.
+    struct AnsweredResponse {
+        ResponseCallback callback;
+        NonnullOwnPtr<Message> message;
+    };
+    Vector<AnsweredResponse> answered_responses;
+    for (size_t i = 0; i < messages.size() && !m_expected_responses.is_empty();) {
+        auto& message = messages[i];
+        Optional<size_t> waiter_index;
+        for (size_t j = 0; j < m_expected_responses.size(); ++j) {
+            auto& expected_response = m_expected_responses[j];
+            if (expected_response.endpoint_magic == message.endpoint_magic() && expected_response.message_id == message.message_id()) {
+                waiter_index = j;
+                break;
+            }
+        }
+        if (!waiter_index.has_value()) {
+            ++i;
+            continue;
+        }
+        auto callback = move(m_expected_responses.take(*waiter_index).callback);
+        answered_responses.append({ move(callback), messages.take(i) });
+    }
+
+    {
+        TemporaryChange coalescing_writes { m_is_coalescing_writes, true };
+        for (auto& message : messages) {
+            if (message.endpoint_magic() == m_local_endpoint_magic) {
+                if (auto response = m_local_stub.handle(message)) {
+                    if (auto result = post_message(*response); result.is_error()) {
+                        dbgln("IPC::ConnectionBase::handle_messages: {}", result.error());
+                    }
                 }
             }
         }
     }
+    if (!m_is_coalescing_writes) {
+        if (auto result = flush_pending_messages(); result.is_error())
+            dbgln("IPC::ConnectionBase::handle_messages: {}", result.error());
+    }
+
+    for (auto& answered_response : answered_responses)
+        answered_response.callback(move(answered_response.message));
 }
 
 void ConnectionBase::wait_for_socket_to_become_readable()
@@ -181,6 +386,7 @@ ErrorOr<Vector<u8>> ConnectionBase::read_as_much_as_possible_from_socket_without
         }
 
         bytes.append(bytes_read.data(), bytes_read.size());
+        m_statistics.bytes_received_inline += bytes_read.size();
     }
 
     if (!bytes.is_empty()) {
@@ -220,6 +426,12 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
 
 OwnPtr<IPC::Message> ConnectionBase::wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id)
 {
+    // The peer can't respond to a request that we're still holding on to.
+    if (auto result = flush_pending_messages(); result.is_error()) {
+        dbgln("IPC::ConnectionBase::wait_for_specific_endpoint_message_impl: {}", result.error());
+        return {};
+    }
+
     for (;;) {
         // Double check we don't already have the event waiting for us.
         // Otherwise we might end up blocked for a while for no reason.
@@ -8,8 +8,11 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Try.h>
+#include <LibCore/AnonymousBuffer.h>
+#include <LibCore/Coroutine.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Notifier.h>
@@ -34,12 +37,33 @@ struct DeferredInvoker {
     virtual void schedule(Function<void()>) = 0;
 };
 
+// Messages at least this large are not written to the socket, but put into a shared buffer that is passed by fd.
+// The socket then only carries a small header that tells the peer which buffer to look at.
+static constexpr size_t out_of_line_message_threshold = 64 * KiB;
+
+// Set in the size that is prepended to a message if the message is out-of-line.
+static constexpr u32 out_of_line_message_flag = 0x80000000;
+
 class ConnectionBase : public Core::Object {
     C_OBJECT_ABSTRACT(ConnectionBase);
 
 public:
     virtual ~ConnectionBase() override = default;
 
+    struct Statistics {
+        size_t messages_sent { 0 };
+        size_t bytes_sent_inline { 0 };
+        size_t bytes_sent_out_of_line { 0 };
+        size_t out_of_line_buffers_created { 0 };
+        size_t out_of_line_buffers_reused { 0 };
+        size_t messages_received { 0 };
+        size_t bytes_received_inline { 0 };
+        size_t bytes_received_out_of_line { 0 };
+    };
+
+    // How many bytes went through the socket, and how many through shared buffers instead.
+    Statistics const& statistics() const { return m_statistics; }
+
     void set_fd_passing_socket(NonnullOwnPtr<Core::Stream::LocalSocket>);
     void set_deferred_invoker(NonnullOwnPtr<DeferredInvoker>);
 
@@ -49,6 +73,14 @@ public:
     void shutdown();
     virtual void die() { }
 
+    using ResponseCallback = Function<void(OwnPtr<Message>)>;
+
+    // Hands the next message from the peer with the given id to `callback`, rather than leaving it unhandled.
+    // Waiters for the same message get them in the order in which they started waiting, and get nullptr if the
+    // connection is shut down first. The returned id can be used to stop waiting.
+    u32 expect_response(u32 endpoint_magic, int message_id, ResponseCallback);
+    void cancel_expected_response(u32 id);
+
     Core::Stream::LocalSocket& socket() { return *m_socket; }
     Core::Stream::LocalSocket& fd_passing_socket();
 
@@ -66,8 +98,15 @@ protected:
     ErrorOr<void> drain_messages_from_peer();
 
     ErrorOr<void> post_message(MessageBuffer);
+    ErrorOr<void> write_to_socket(ReadonlyBytes);
+    ErrorOr<void> flush_pending_messages();
     void handle_messages();
 
+    ErrorOr<bool> try_move_to_out_of_line_buffer(MessageBuffer&);
+
+    // Returns a copy of the message the peer placed in one of its buffers, and hands the buffer back to the peer.
+    ErrorOr<ByteBuffer> receive_out_of_line_message(ReadonlyBytes header);
+
     IPC::Stub& m_local_stub;
 
     NonnullOwnPtr<Core::Stream::LocalSocket> m_socket;
@@ -81,6 +120,71 @@ protected:
     u32 m_local_endpoint_magic { 0 };
 
     NonnullOwnPtr<DeferredInvoker> m_deferred_invoker;
+
+    // Buffers we put our out-of-line messages in, indexed by buffer id. They are reused once the peer is done with them.
+    Vector<Core::AnonymousBuffer> m_out_of_line_buffers;
+    // Buffers the peer put its out-of-line messages in.
+    HashMap<u32, Core::AnonymousBuffer> m_peer_out_of_line_buffers;
+
+    // Messages that are posted while this is set are collected in m_pending_bytes, and written in one go later.
+    bool m_is_coalescing_writes { false };
+    Vector<u8> m_pending_bytes;
+
+    Statistics m_statistics;
+
+    struct ExpectedResponse {
+        u32 id { 0 };
+        u32 endpoint_magic { 0 };
+        int message_id { 0 };
+        ResponseCallback callback;
+    };
+    Vector<ExpectedResponse> m_expected_responses;
+    u32 m_next_expected_response_id { 1 };
+};
+
+// co_await on this resumes the coroutine with the response to a request, or with nullptr if the connection
+// went away before the response arrived.
+template<typename ResponseType, typename PeerEndpoint>
+class [[nodiscard]] ResponseAwaiter {
+    AK_MAKE_NONCOPYABLE(ResponseAwaiter);
+    AK_MAKE_NONMOVABLE(ResponseAwaiter);
+
+public:
+    ResponseAwaiter(ConnectionBase& connection, bool was_posted)
+        : m_connection(connection.make_weak_ptr<ConnectionBase>())
+        , m_was_posted(was_posted)
+    {
+    }
+
+    ~ResponseAwaiter()
+    {
+        if (m_expected_response_id.has_value() && m_connection)
+            m_connection->cancel_expected_response(*m_expected_response_id);
+    }
+
+    bool await_ready() const { return !m_was_posted || !m_connection; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_expected_response_id = m_connection->expect_response(PeerEndpoint::static_magic(), ResponseType::static_message_id(), [this, handle](OwnPtr<Message> response) {
+            m_expected_response_id.clear();
+            m_response = move(response);
+            handle.resume();
+        });
+    }
+
+    OwnPtr<ResponseType> await_resume()
+    {
+        if (!m_response)
+            return {};
+        return m_response.template release_nonnull<ResponseType>();
+    }
+
+private:
+    WeakPtr<ConnectionBase> m_connection;
+    bool m_was_posted { false };
+    Optional<u32> m_expected_response_id;
+    OwnPtr<Message> m_response;
 };
 
 template<typename LocalEndpoint, typename PeerEndpoint>
@@ -120,6 +224,14 @@ public:
         return wait_for_specific_endpoint_message<typename RequestType::ResponseType, PeerEndpoint>();
     }
 
+    // Like send_sync(), but for coroutines, which get to co_await the response instead of blocking on it.
+    template<typename RequestType, typename... Args>
+    ResponseAwaiter<typename RequestType::ResponseType, PeerEndpoint> send_for_response(Args&&... args)
+    {
+        bool was_posted = !post_message(RequestType(forward<Args>(args)...)).is_error();
+        return { *this, was_posted };
+    }
+
 protected:
     template<typename MessageType, typename Endpoint>
     OwnPtr<MessageType> wait_for_specific_endpoint_message()
@@ -134,18 +246,34 @@ protected:
         u32 message_size = 0;
         for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
             memcpy(&message_size, bytes.data() + index, sizeof(message_size));
+            bool is_out_of_line = message_size & out_of_line_message_flag;
+            message_size &= ~out_of_line_message_flag;
             if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
                 break;
             index += sizeof(message_size);
             auto remaining_bytes = ReadonlyBytes { bytes.data() + index, message_size };
-            if (auto message = LocalEndpoint::decode_message(remaining_bytes, fd_passing_socket())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else if (auto message = PeerEndpoint::decode_message(remaining_bytes, fd_passing_socket())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else {
+
+            ByteBuffer out_of_line_message;
+            if (is_out_of_line) {
+                auto maybe_message = receive_out_of_line_message(remaining_bytes);
+                if (maybe_message.is_error()) {
+                    dbgln("Failed to receive an out-of-line message: {}", maybe_message.error());
+                    break;
+                }
+                out_of_line_message = maybe_message.release_value();
+                remaining_bytes = out_of_line_message.bytes();
+            }
+
+            auto message = LocalEndpoint::decode_message(remaining_bytes, fd_passing_socket());
+            if (!message)
+                message = PeerEndpoint::decode_message(remaining_bytes, fd_passing_socket());
+
+            if (!message) {
                 dbgln("Failed to parse a message");
                 break;
             }
+            ++m_statistics.messages_received;
+            m_unprocessed_messages.append(message.release_nonnull());
         }
     }
 };
@@ -8,6 +8,7 @@
 
 namespace IPC {
 
+class ConnectionBase;
 class Decoder;
 class Dictionary;
 class Encoder;
@@ -15,6 +16,9 @@ class Message;
 class File;
 class Stub;
 
+template<typename ResponseType>
+class ResponsePromise;
+
 template<typename T>
 bool encode(Encoder&, T const&);
 
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/WeakPtr.h>
+#include <LibIPC/Connection.h>
+
+namespace IPC {
+
+// Handed to the handler of a request that is declared with [AsyncReply].
+// The handler may return right away, and resolve the promise once the response is ready, e.g. from a later
+// event loop turn, so the server doesn't have to block while producing it. The client still waits as usual.
+// NOTE: Responses don't say which request they answer, so the promises for the same message must be resolved in the
+//       order their requests came in.
+template<typename ResponseType>
+class ResponsePromise {
+    AK_MAKE_NONCOPYABLE(ResponsePromise);
+
+public:
+    explicit ResponsePromise(WeakPtr<ConnectionBase> connection)
+        : m_connection(move(connection))
+    {
+    }
+
+    ResponsePromise(ResponsePromise&& other)
+        : m_connection(move(other.m_connection))
+        , m_is_resolved(exchange(other.m_is_resolved, true))
+    {
+    }
+
+    ~ResponsePromise()
+    {
+        if (!m_is_resolved)
+            dbgln("IPC::ResponsePromise: Dropped without a response, the peer will wait for it until it disconnects");
+    }
+
+    // NOTE: Does nothing if the peer has disconnected in the meantime.
+    void resolve(ResponseType response)
+    {
+        VERIFY(!m_is_resolved);
+        m_is_resolved = true;
+        if (!m_connection || !m_connection->is_open())
+            return;
+        if (auto result = m_connection->post_message(response); result.is_error())
+            dbgln("IPC::ResponsePromise::resolve: {}", result.error());
+    }
+
+private:
+    WeakPtr<ConnectionBase> m_connection;
+    bool m_is_resolved { false };
+};
+
+}
@@ -9,6 +9,8 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/String.h>
+#include <AK/WeakPtr.h>
+#include <LibIPC/Forward.h>
 
 namespace AK {
 class BufferStream;
@@ -30,8 +32,14 @@ public:
 protected:
     Stub() = default;
 
+    // The connection that messages to this stub come in through, for sending responses later on.
+    WeakPtr<ConnectionBase> const& response_connection() const { return m_connection; }
+
 private:
+    friend class ConnectionBase;
+
     String m_name;
+    WeakPtr<ConnectionBase> m_connection;
 };
 
 }
@@ -20,20 +20,28 @@ void Client::die()
         on_death();
 }
 
-Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data)
+static Optional<Core::AnonymousBuffer> copy_to_anonymous_buffer(ReadonlyBytes encoded_data)
 {
-    if (encoded_data.is_empty())
-        return {};
-
     auto encoded_buffer_or_error = Core::AnonymousBuffer::create_with_size(encoded_data.size());
     if (encoded_buffer_or_error.is_error()) {
         dbgln("Could not allocate encoded buffer");
         return {};
     }
     auto encoded_buffer = encoded_buffer_or_error.release_value();
-
     memcpy(encoded_buffer.data<void>(), encoded_data.data(), encoded_data.size());
-    auto response_or_error = try_decode_image(move(encoded_buffer));
+    return encoded_buffer;
+}
+
+Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size)
+{
+    if (encoded_data.is_empty())
+        return {};
+
+    auto encoded_buffer = copy_to_anonymous_buffer(encoded_data);
+    if (!encoded_buffer.has_value())
+        return {};
+
+    auto response_or_error = try_decode_image(encoded_buffer.release_value(), ideal_size);
 
     if (response_or_error.is_error()) {
         dbgln("ImageDecoder died heroically");
@@ -57,4 +65,43 @@ Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data)
     return image;
 }
 
+Optional<LazyImage> Client::open_image(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size)
+{
+    if (encoded_data.is_empty())
+        return {};
+
+    auto encoded_buffer = copy_to_anonymous_buffer(encoded_data);
+    if (!encoded_buffer.has_value())
+        return {};
+
+    auto response_or_error = try_open_image(encoded_buffer.release_value(), ideal_size);
+    if (response_or_error.is_error()) {
+        dbgln("ImageDecoder died heroically");
+        return {};
+    }
+
+    auto& response = response_or_error.value();
+    if (response.image_id() < 0)
+        return {};
+
+    return LazyImage { response.image_id(), response.is_animated(), response.loop_count(), response.frame_count() };
+}
+
+Optional<Frame> Client::decode_frame(LazyImage const& image, u32 frame_index)
+{
+    auto response_or_error = try_decode_frame(image.id, frame_index);
+    if (response_or_error.is_error()) {
+        dbgln("ImageDecoder died heroically");
+        return {};
+    }
+
+    auto& response = response_or_error.value();
+    return Frame { response.bitmap().bitmap(), response.duration() };
+}
+
+void Client::close_image(LazyImage const& image)
+{
+    async_close_image(image.id);
+}
+
 }
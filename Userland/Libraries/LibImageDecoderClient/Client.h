@@ -24,13 +24,26 @@ struct DecodedImage {
     Vector<Frame> frames;
 };
 
+// An image that stays open in the decoder, so that its frames can be fetched one at a time with decode_frame().
+struct LazyImage {
+    i32 id { -1 };
+    bool is_animated { false };
+    u32 loop_count { 0 };
+    u32 frame_count { 0 };
+};
+
 class Client final
     : public IPC::ConnectionToServer<ImageDecoderClientEndpoint, ImageDecoderServerEndpoint>
     , public ImageDecoderClientEndpoint {
     IPC_CLIENT_CONNECTION(Client, "/tmp/session/%sid/portal/image"sv);
 
 public:
-    Optional<DecodedImage> decode_image(ReadonlyBytes);
+    // If an ideal size is given, the decoder may hand out bitmaps that are smaller than the image, but never smaller than that size.
+    Optional<DecodedImage> decode_image(ReadonlyBytes, Optional<Gfx::IntSize> ideal_size = {});
+
+    Optional<LazyImage> open_image(ReadonlyBytes, Optional<Gfx::IntSize> ideal_size = {});
+    Optional<Frame> decode_frame(LazyImage const&, u32 frame_index);
+    void close_image(LazyImage const&);
 
     Function<void()> on_death;
 
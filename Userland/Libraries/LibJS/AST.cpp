@@ -17,6 +17,7 @@
 #include <LibJS/AST.h>
 #include <LibJS/Heap/MarkedVector.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/Parser.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/Array.h>
@@ -34,6 +35,7 @@
 #include <LibJS/Runtime/Reference.h>
 #include <LibJS/Runtime/RegExpObject.h>
 #include <LibJS/Runtime/Shape.h>
+#include <LibJS/SamplingProfiler.h>
 #include <typeinfo>
 
 namespace JS {
@@ -49,6 +51,7 @@ public:
     {
         m_interpreter.vm().running_execution_context().current_node = &node;
         m_interpreter.push_ast_node(m_chain_node);
+        SamplingProfiler::take_sample_if_requested();
     }
 
     ~InterpreterNodeScope()
@@ -205,6 +208,17 @@ void LabelledStatement::dump(int indent) const
     m_labelled_item->dump(indent + 2);
 }
 
+void FunctionBody::ensure_parsed() const
+{
+    if (is_parsed())
+        return;
+
+    auto function = Parser::parse_lazy_function(*m_lazy_parse_info);
+    auto& parsed_body = static_cast<FunctionBody const&>(function->body());
+    const_cast<FunctionBody&>(*this).take_contents_from(const_cast<FunctionBody&>(parsed_body));
+    m_lazy_parse_info->is_parsed = true;
+}
+
 // 10.2.1.3 Runtime Semantics: EvaluateBody, https://tc39.es/ecma262/#sec-runtime-semantics-evaluatebody
 Completion FunctionBody::execute(Interpreter& interpreter) const
 {
@@ -2401,6 +2415,8 @@ void FunctionNode::dump(int indent, String const& class_name) const
     }
     print_indent(indent + 1);
     outln("(Body)");
+    if (is<FunctionBody>(body()))
+        static_cast<FunctionBody const&>(body()).ensure_parsed();
     body().dump(indent + 2);
 }
 
@@ -4371,6 +4387,14 @@ void ScopeNode::add_hoisted_function(NonnullRefPtr<FunctionDeclaration> declarat
     m_functions_hoistable_with_annexB_extension.append(move(declaration));
 }
 
+void ScopeNode::take_contents_from(ScopeNode& other)
+{
+    m_children = move(other.m_children);
+    m_lexical_declarations = move(other.m_lexical_declarations);
+    m_var_declarations = move(other.m_var_declarations);
+    m_functions_hoistable_with_annexB_extension = move(other.m_functions_hoistable_with_annexB_extension);
+}
+
 // 16.2.1.11 Runtime Semantics: Evaluation, https://tc39.es/ecma262/#sec-module-semantics-runtime-semantics-evaluation
 Completion ImportStatement::execute(Interpreter& interpreter) const
 {
@@ -259,6 +259,8 @@ public:
 
     ThrowCompletionOr<void> for_each_function_hoistable_with_annexB_extension(ThrowCompletionOrVoidCallback<FunctionDeclaration&>&& callback) const;
 
+    void take_contents_from(ScopeNode& other);
+
 protected:
     explicit ScopeNode(SourceRange source_range)
         : Statement(source_range)
@@ -529,6 +531,16 @@ public:
 
 class FunctionBody final : public ScopeNode {
 public:
+    // Everything we need to parse the body of a function again, after its contents were thrown away.
+    struct LazyParseInfo {
+        String function_source_text;
+        FlyString filename;
+        Position function_start;
+        bool in_strict_mode { false };
+        bool in_module { false };
+        bool is_parsed { false };
+    };
+
     explicit FunctionBody(SourceRange source_range)
         : ScopeNode(source_range)
     {
@@ -538,10 +550,19 @@ public:
 
     bool in_strict_mode() const { return m_in_strict_mode; }
 
+    void set_lazy_parse_info(NonnullOwnPtr<LazyParseInfo> info) { m_lazy_parse_info = move(info); }
+    bool is_parsed() const { return !m_lazy_parse_info || m_lazy_parse_info->is_parsed; }
+
+    // Parses the body again if it was only pre-parsed. This has to happen before the body is looked at during a call.
+    void ensure_parsed() const;
+
     virtual Completion execute(Interpreter&) const override;
 
 private:
     bool m_in_strict_mode { false };
+
+    // NOTE: This is kept once the body has been parsed, since the new nodes refer to the filename stored in here.
+    mutable OwnPtr<LazyParseInfo> m_lazy_parse_info;
 };
 
 class Expression : public ASTNode {
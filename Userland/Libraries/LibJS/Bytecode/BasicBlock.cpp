@@ -28,6 +28,13 @@ BasicBlock::BasicBlock(String name, size_t size)
 }
 
 BasicBlock::~BasicBlock()
+{
+    destroy_instructions();
+    if (m_buffer)
+        munmap(m_buffer, m_buffer_capacity);
+}
+
+void BasicBlock::destroy_instructions()
 {
     Bytecode::InstructionStreamIterator it(instruction_stream());
     while (!it.at_end()) {
@@ -35,8 +42,7 @@ BasicBlock::~BasicBlock()
         ++it;
         Instruction::destroy(const_cast<Instruction&>(to_destroy));
     }
-
-    munmap(m_buffer, m_buffer_capacity);
+    m_buffer_size = 0;
 }
 
 void BasicBlock::seal()
@@ -64,4 +70,29 @@ void BasicBlock::grow(size_t additional_size)
     VERIFY(m_buffer_size <= m_buffer_capacity);
 }
 
+void BasicBlock::append_copy_of(Instruction const& instruction)
+{
+    // FIXME: Op::NewBigInt is not trivially copyable, so we can't use a simple memcpy for it.
+    if (instruction.type() == Instruction::Type::NewBigInt) {
+        VERIFY(can_grow(sizeof(Op::NewBigInt)));
+        new (next_slot()) Op::NewBigInt(static_cast<Op::NewBigInt const&>(instruction));
+        grow(sizeof(Op::NewBigInt));
+        return;
+    }
+    auto instruction_size = instruction.length();
+    VERIFY(can_grow(instruction_size));
+    memcpy(next_slot(), &instruction, instruction_size);
+    grow(instruction_size);
+}
+
+void BasicBlock::take_instructions_from(BasicBlock& other)
+{
+    destroy_instructions();
+    munmap(m_buffer, m_buffer_capacity);
+
+    m_buffer = exchange(other.m_buffer, nullptr);
+    m_buffer_capacity = exchange(other.m_buffer_capacity, 0);
+    m_buffer_size = exchange(other.m_buffer_size, 0);
+}
+
 }
@@ -36,6 +36,13 @@ public:
     bool can_grow(size_t additional_size) const { return m_buffer_size + additional_size <= m_buffer_capacity; }
     void grow(size_t additional_size);
 
+    // Appends a copy of an instruction from another block.
+    void append_copy_of(Instruction const&);
+
+    // Replaces this block's instructions with the ones in the given block, which is left empty.
+    // This lets passes rewrite a block without having to update all the jumps to it.
+    void take_instructions_from(BasicBlock&);
+
     void terminate(Badge<Generator>) { m_is_terminated = true; }
     bool is_terminated() const { return m_is_terminated; }
 
@@ -44,6 +51,8 @@ public:
 private:
     BasicBlock(String name, size_t size);
 
+    void destroy_instructions();
+
     u8* m_buffer { nullptr };
     size_t m_buffer_capacity { 0 };
     size_t m_buffer_size { 0 };
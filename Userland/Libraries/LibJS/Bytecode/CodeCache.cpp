@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/Stream.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibJS/Bytecode/CodeCache.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <stdio.h>
+#include <unistd.h>
+
+namespace JS::Bytecode {
+
+CodeCache& CodeCache::the()
+{
+    static CodeCache s_the;
+    return s_the;
+}
+
+String CodeCache::path_for(StringView source_text, FunctionKind kind, bool is_strict_mode) const
+{
+    // The same source text may compile to different bytecode depending on how it's going to run,
+    // and on how much we optimize it.
+    u8 const flags[] = {
+        static_cast<u8>(kind),
+        static_cast<u8>(is_strict_mode),
+        static_cast<u8>(Interpreter::optimization_level()),
+    };
+
+    Crypto::Hash::SHA256 sha;
+    sha.update(flags, sizeof(flags));
+    sha.update(source_text.bytes());
+    auto digest = sha.digest();
+    return String::formatted("{}/{}.jsbc", m_directory, encode_hex(digest.bytes()));
+}
+
+OwnPtr<Executable> CodeCache::load(StringView source_text, FunctionKind kind, bool is_strict_mode) const
+{
+    if (!is_enabled() || source_text.is_empty())
+        return {};
+
+    auto path = path_for(source_text, kind, is_strict_mode);
+    auto file_or_error = Core::MappedFile::map(path);
+    if (file_or_error.is_error())
+        return {};
+
+    auto executable_or_error = Executable::deserialize(file_or_error.value()->bytes());
+    if (executable_or_error.is_error()) {
+        dbgln_if(JS_BYTECODE_DEBUG, "Ignoring cached bytecode in {}: {}", path, executable_or_error.error());
+        return {};
+    }
+    return executable_or_error.release_value();
+}
+
+void CodeCache::store(StringView source_text, FunctionKind kind, bool is_strict_mode, Executable const& executable) const
+{
+    if (!is_enabled() || source_text.is_empty())
+        return;
+
+    auto serialized_executable_or_error = executable.serialize();
+    if (serialized_executable_or_error.is_error())
+        return;
+
+    // NOTE: We write to a file of our own first, so nobody else may see a partially written one.
+    auto path = path_for(source_text, kind, is_strict_mode);
+    auto temporary_path = String::formatted("{}.{}", path, getpid());
+    auto write_file = [&]() -> ErrorOr<void> {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write));
+        if (!file->write_or_error(serialized_executable_or_error.value()))
+            return AK::Error::from_string_literal("Failed to write bytecode");
+        file->close();
+        if (rename(temporary_path.characters(), path.characters()) < 0)
+            return AK::Error::from_syscall("rename"sv, -errno);
+        return {};
+    };
+
+    if (auto result = write_file(); result.is_error()) {
+        dbgln_if(JS_BYTECODE_DEBUG, "Failed to cache bytecode in {}: {}", path, result.error());
+        (void)unlink(temporary_path.characters());
+    }
+}
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/String.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Runtime/FunctionKind.h>
+
+namespace JS::Bytecode {
+
+// Keeps optimized bytecode on disk, keyed by the source text it was generated from, so the same code
+// doesn't have to be generated and optimized again the next time it runs. Only executables that
+// Executable::serialize() can handle are cached. Nothing is cached until a directory has been set.
+class CodeCache {
+public:
+    static CodeCache& the();
+
+    void set_directory(String directory) { m_directory = move(directory); }
+    bool is_enabled() const { return !m_directory.is_null(); }
+
+    OwnPtr<Executable> load(StringView source_text, FunctionKind, bool is_strict_mode) const;
+    void store(StringView source_text, FunctionKind, bool is_strict_mode, Executable const&) const;
+
+private:
+    CodeCache() = default;
+
+    String path_for(StringView source_text, FunctionKind, bool is_strict_mode) const;
+
+    String m_directory;
+};
+
+}
@@ -4,10 +4,324 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashMap.h>
 #include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Op.h>
 
 namespace JS::Bytecode {
 
+Executable::Statistics Executable::statistics() const
+{
+    Statistics statistics;
+    statistics.basic_block_count = basic_blocks.size();
+    statistics.number_of_registers = number_of_registers;
+    for (auto& block : basic_blocks) {
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it)
+            ++statistics.instruction_count;
+    }
+    return statistics;
+}
+
+// NOTE: Instructions are stored just like they are in memory, so this has to change whenever any of them does.
+//       The layout fingerprint below catches most such changes (and builds that lay them out differently), but
+//       not all of them, e.g. swapping two members of the same size.
+static constexpr u32 serialized_executable_magic = 0x434a424c; // "LBJC"
+static constexpr u32 serialized_executable_version = 2;
+
+static constexpr size_t number_of_instruction_types = 0
+#define __BYTECODE_OP(op) +1
+    ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    ;
+
+// A hash of the size and alignment of every instruction, and of what they're made of, in the order of their types.
+static constexpr u32 serialized_executable_layout_fingerprint = [] {
+    u32 hash = 2166136261u;
+    auto add = [&](size_t value) {
+        hash = (hash ^ static_cast<u32>(value)) * 16777619u;
+    };
+    add(sizeof(void*));
+    add(sizeof(Instruction));
+    add(sizeof(Value));
+    add(sizeof(Register));
+    add(sizeof(Label));
+    add(sizeof(StringTableIndex));
+    add(sizeof(IdentifierTableIndex));
+#define __BYTECODE_OP(op) \
+    add(sizeof(Op::op));  \
+    add(alignof(Op::op));
+    ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    return hash;
+}();
+
+static bool is_serializable(Instruction const& instruction)
+{
+    switch (instruction.type()) {
+    case Instruction::Type::NewBigInt:
+    case Instruction::Type::PushDeclarativeEnvironment:
+        // These own memory on the heap.
+        return false;
+    case Instruction::Type::NewClass:
+    case Instruction::Type::NewFunction:
+        // These refer to the AST.
+        return false;
+    case Instruction::Type::LoadImmediate:
+        return !static_cast<Op::LoadImmediate const&>(instruction).value().is_cell();
+    default:
+        return true;
+    }
+}
+
+static void for_each_label(Instruction const& instruction, Function<void(Label const&)> const& callback)
+{
+    auto visit = [&](Optional<Label> const& label) {
+        if (label.has_value())
+            callback(label.value());
+    };
+
+    switch (instruction.type()) {
+    case Instruction::Type::Jump:
+    case Instruction::Type::JumpConditional:
+    case Instruction::Type::JumpNullish:
+    case Instruction::Type::JumpUndefined: {
+        auto& jump = static_cast<Op::Jump const&>(instruction);
+        visit(jump.true_target());
+        visit(jump.false_target());
+        break;
+    }
+    case Instruction::Type::EnterUnwindContext: {
+        auto& enter_unwind_context = static_cast<Op::EnterUnwindContext const&>(instruction);
+        callback(enter_unwind_context.entry_point());
+        visit(enter_unwind_context.handler_target());
+        visit(enter_unwind_context.finalizer_target());
+        break;
+    }
+    case Instruction::Type::FinishUnwind:
+        callback(static_cast<Op::FinishUnwind const&>(instruction).next_target());
+        break;
+    case Instruction::Type::ContinuePendingUnwind:
+        callback(static_cast<Op::ContinuePendingUnwind const&>(instruction).resume_target());
+        break;
+    case Instruction::Type::Yield:
+        visit(static_cast<Op::Yield const&>(instruction).continuation());
+        break;
+    default:
+        break;
+    }
+}
+
+class ExecutableEncoder {
+public:
+    template<typename T>
+    ErrorOr<void> encode(T const& value) requires(IsTriviallyCopyable<T>)
+    {
+        return m_buffer.try_append(&value, sizeof(T));
+    }
+
+    ErrorOr<void> encode(StringView string)
+    {
+        TRY(encode<u64>(string.length()));
+        return m_buffer.try_append(string.characters_without_null_termination(), string.length());
+    }
+
+    ErrorOr<void> encode(ReadonlyBytes bytes)
+    {
+        TRY(encode<u64>(bytes.size()));
+        return m_buffer.try_append(bytes);
+    }
+
+    ByteBuffer take_buffer() { return move(m_buffer); }
+
+private:
+    ByteBuffer m_buffer;
+};
+
+class ExecutableDecoder {
+public:
+    explicit ExecutableDecoder(ReadonlyBytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    template<typename T>
+    ErrorOr<T> decode() requires(IsTriviallyCopyable<T>)
+    {
+        T value;
+        TRY(read(&value, sizeof(T)));
+        return value;
+    }
+
+    ErrorOr<ReadonlyBytes> decode_bytes()
+    {
+        auto size = TRY(decode<u64>());
+        if (size > m_bytes.size() - m_offset)
+            return AK::Error::from_string_literal("Serialized executable is truncated");
+        auto bytes = m_bytes.slice(m_offset, size);
+        m_offset += size;
+        return bytes;
+    }
+
+    ErrorOr<String> decode_string()
+    {
+        auto bytes = TRY(decode_bytes());
+        return String { StringView { bytes } };
+    }
+
+    bool is_at_end() const { return m_offset == m_bytes.size(); }
+
+private:
+    ErrorOr<void> read(void* destination, size_t size)
+    {
+        if (size > m_bytes.size() - m_offset)
+            return AK::Error::from_string_literal("Serialized executable is truncated");
+        memcpy(destination, m_bytes.offset_pointer(m_offset), size);
+        m_offset += size;
+        return {};
+    }
+
+    ReadonlyBytes m_bytes;
+    size_t m_offset { 0 };
+};
+
+ErrorOr<ByteBuffer> Executable::serialize() const
+{
+    HashMap<BasicBlock const*, u32> block_indices;
+    for (size_t i = 0; i < basic_blocks.size(); ++i)
+        block_indices.set(&basic_blocks[i], i);
+
+    ExecutableEncoder encoder;
+    TRY(encoder.encode(serialized_executable_magic));
+    TRY(encoder.encode(serialized_executable_version));
+    TRY(encoder.encode(serialized_executable_layout_fingerprint));
+    TRY(encoder.encode<u8>(is_strict_mode));
+    TRY(encoder.encode<u64>(number_of_registers));
+    TRY(encoder.encode<u64>(property_lookup_caches.size()));
+    TRY(encoder.encode<u64>(environment_variable_caches.size()));
+
+    TRY(encoder.encode<u64>(string_table->size()));
+    for (size_t i = 0; i < string_table->size(); ++i)
+        TRY(encoder.encode(get_string(i).view()));
+
+    TRY(encoder.encode<u64>(identifier_table->size()));
+    for (size_t i = 0; i < identifier_table->size(); ++i)
+        TRY(encoder.encode(get_identifier(i).view()));
+
+    TRY(encoder.encode<u64>(basic_blocks.size()));
+    for (auto& block : basic_blocks) {
+        // Labels point to blocks, so we store the index of their block instead, in the order we'll find them again.
+        Vector<u32> label_targets;
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+            if (!is_serializable(*it))
+                return AK::Error::from_string_literal("Executable contains instructions that can't be serialized");
+            for_each_label(*it, [&](Label const& label) {
+                label_targets.append(block_indices.get(&label.block()).value());
+            });
+        }
+
+        TRY(encoder.encode(block.name().view()));
+        TRY(encoder.encode(block.instruction_stream()));
+        TRY(encoder.encode<u64>(label_targets.size()));
+        for (auto target : label_targets)
+            TRY(encoder.encode(target));
+    }
+
+    return encoder.take_buffer();
+}
+
+ErrorOr<NonnullOwnPtr<Executable>> Executable::deserialize(ReadonlyBytes bytes)
+{
+    ExecutableDecoder decoder { bytes };
+    if (TRY(decoder.decode<u32>()) != serialized_executable_magic || TRY(decoder.decode<u32>()) != serialized_executable_version)
+        return AK::Error::from_string_literal("Serialized executable has an unsupported format");
+    if (TRY(decoder.decode<u32>()) != serialized_executable_layout_fingerprint)
+        return AK::Error::from_string_literal("Serialized executable was made by a build that lays out instructions differently");
+
+    auto is_strict_mode = TRY(decoder.decode<u8>()) != 0;
+    auto number_of_registers = TRY(decoder.decode<u64>());
+
+    Vector<PropertyLookupCache> property_lookup_caches;
+    Vector<EnvironmentVariableCache> environment_variable_caches;
+    TRY(property_lookup_caches.try_resize(TRY(decoder.decode<u64>())));
+    TRY(environment_variable_caches.try_resize(TRY(decoder.decode<u64>())));
+
+    auto string_table = make<StringTable>();
+    auto string_count = TRY(decoder.decode<u64>());
+    for (size_t i = 0; i < string_count; ++i)
+        string_table->insert(TRY(decoder.decode_string()));
+
+    auto identifier_table = make<IdentifierTable>();
+    auto identifier_count = TRY(decoder.decode<u64>());
+    for (size_t i = 0; i < identifier_count; ++i)
+        identifier_table->insert(TRY(decoder.decode_string()));
+
+    NonnullOwnPtrVector<BasicBlock> basic_blocks;
+    Vector<Vector<u32>> label_targets;
+    auto block_count = TRY(decoder.decode<u64>());
+    for (size_t i = 0; i < block_count; ++i) {
+        auto name = TRY(decoder.decode_string());
+        auto instruction_stream = TRY(decoder.decode_bytes());
+
+        // NOTE: A block destroys its instructions when it goes away, so it must never contain anything but complete
+        //       instructions that we know how to destroy. This catches truncated or corrupted files, but it doesn't
+        //       make it safe to load executables from untrusted places, no more than it would be for native code.
+        auto stream = TRY(ByteBuffer::copy(instruction_stream));
+        for (size_t offset = 0; offset < stream.size();) {
+            if (stream.size() - offset < sizeof(Instruction))
+                return AK::Error::from_string_literal("Serialized executable has a truncated instruction");
+            auto const& instruction = *reinterpret_cast<Instruction const*>(stream.offset_pointer(offset));
+            if (static_cast<size_t>(to_underlying(instruction.type())) >= number_of_instruction_types || !is_serializable(instruction))
+                return AK::Error::from_string_literal("Serialized executable has an invalid instruction");
+            if (instruction.length() > stream.size() - offset)
+                return AK::Error::from_string_literal("Serialized executable has a truncated instruction");
+            offset += instruction.length();
+        }
+
+        auto block = BasicBlock::create(move(name), stream.size());
+        memcpy(block->next_slot(), stream.data(), stream.size());
+        block->grow(stream.size());
+
+        Vector<u32> targets;
+        auto label_count = TRY(decoder.decode<u64>());
+        for (size_t j = 0; j < label_count; ++j)
+            TRY(targets.try_append(TRY(decoder.decode<u32>())));
+        label_targets.append(move(targets));
+
+        basic_blocks.append(move(block));
+    }
+
+    if (!decoder.is_at_end())
+        return AK::Error::from_string_literal("Serialized executable has trailing data");
+
+    for (size_t i = 0; i < basic_blocks.size(); ++i) {
+        auto& targets = label_targets[i];
+        size_t next_target = 0;
+        bool has_invalid_label = false;
+        for (InstructionStreamIterator it { basic_blocks[i].instruction_stream() }; !it.at_end(); ++it) {
+            for_each_label(*it, [&](Label const& label) {
+                if (next_target >= targets.size() || targets[next_target] >= basic_blocks.size()) {
+                    has_invalid_label = true;
+                    return;
+                }
+                const_cast<Label&>(label) = Label { basic_blocks[targets[next_target++]] };
+            });
+        }
+        if (has_invalid_label || next_target != targets.size())
+            return AK::Error::from_string_literal("Serialized executable has invalid jump targets");
+    }
+
+    return adopt_nonnull_own_or_enomem(new (nothrow) Executable {
+        .name = {},
+        .basic_blocks = move(basic_blocks),
+        .string_table = move(string_table),
+        .identifier_table = move(identifier_table),
+        .number_of_registers = number_of_registers,
+        .is_strict_mode = is_strict_mode,
+        .property_lookup_caches = move(property_lookup_caches),
+        .environment_variable_caches = move(environment_variable_caches) });
+}
+
 void Executable::dump() const
 {
     dbgln("\033[33;1mJS::Bytecode::Executable\033[0m ({})", name);
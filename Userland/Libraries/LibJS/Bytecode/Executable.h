@@ -6,14 +6,40 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
 #include <AK/FlyString.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/WeakPtr.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
 #include <LibJS/Bytecode/StringTable.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/EnvironmentCoordinate.h>
+#include <LibJS/Runtime/Shape.h>
 
 namespace JS::Bytecode {
 
+// Remembers where GetById/PutById found a property for the last few shapes it has seen.
+struct PropertyLookupCache {
+    static constexpr size_t max_number_of_shapes = 4;
+
+    struct Entry {
+        WeakPtr<Shape> shape;
+        // If set, the property was found in the prototype of objects with the above shape, while it had this shape.
+        WeakPtr<Shape> prototype_shape;
+        u32 property_offset { 0 };
+    };
+
+    AK::Array<Entry, max_number_of_shapes> entries;
+    size_t next_entry_to_replace { 0 };
+};
+
+struct EnvironmentVariableCache {
+    Optional<EnvironmentCoordinate> coordinate;
+};
+
 struct Executable {
     FlyString name;
     NonnullOwnPtrVector<BasicBlock> basic_blocks;
@@ -22,9 +48,37 @@ struct Executable {
     size_t number_of_registers { 0 };
     bool is_strict_mode { false };
 
+    // NOTE: These are updated while the executable runs, which doesn't change its meaning.
+    mutable Vector<PropertyLookupCache> property_lookup_caches;
+    mutable Vector<EnvironmentVariableCache> environment_variable_caches;
+
+    // Compiled by the JIT the first time this executable runs, if it's enabled.
+    mutable OwnPtr<JIT::NativeExecutable> native_executable {};
+    mutable bool did_try_jit_compilation { false };
+
     String const& get_string(StringTableIndex index) const { return string_table->get(index); }
     FlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
+    struct Statistics {
+        size_t basic_block_count { 0 };
+        size_t instruction_count { 0 };
+        size_t number_of_registers { 0 };
+
+        Statistics& operator+=(Statistics const& other)
+        {
+            basic_block_count += other.basic_block_count;
+            instruction_count += other.instruction_count;
+            number_of_registers += other.number_of_registers;
+            return *this;
+        }
+    };
+    Statistics statistics() const;
+
+    // Executables whose instructions don't refer to the AST or to heap cells can be written out and read back
+    // later, as long as it's by the same build of LibJS. The name is up to whoever reads it back.
+    ErrorOr<ByteBuffer> serialize() const;
+    static ErrorOr<NonnullOwnPtr<Executable>> deserialize(ReadonlyBytes);
+
     void dump() const;
 };
 
@@ -109,6 +109,8 @@ public:
     String to_string(Bytecode::Executable const&) const;
     ThrowCompletionOr<void> execute(Bytecode::Interpreter&) const;
     void replace_references(BasicBlock const&, BasicBlock const&);
+    // Calls the callback for each register operand, which doesn't include the accumulator that most instructions use implicitly.
+    void for_each_register(Function<void(Register&)> const&);
     static void destroy(Instruction&);
 
 protected:
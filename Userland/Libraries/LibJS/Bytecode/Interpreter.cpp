@@ -5,20 +5,37 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/QuickSort.h>
 #include <AK/TemporaryChange.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Op.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/Realm.h>
+#include <LibJS/SamplingProfiler.h>
 
 namespace JS::Bytecode {
 
 static Interpreter* s_current;
 bool g_dump_bytecode = false;
+bool g_use_jit = false;
+bool g_count_opcodes = false;
+
+#define __BYTECODE_OP(op) +1
+static constexpr size_t number_of_opcodes = 0 ENUMERATE_BYTECODE_OPS(__BYTECODE_OP);
+#undef __BYTECODE_OP
+
+static constexpr AK::Array<StringView, number_of_opcodes> s_opcode_names {
+#define __BYTECODE_OP(op) #op##sv,
+    ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+};
+
+static AK::Array<u64, number_of_opcodes> s_opcode_counters {};
 
 Interpreter* Interpreter::current()
 {
@@ -69,67 +86,10 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
 
     registers().resize(executable.number_of_registers);
 
-    for (;;) {
-        Bytecode::InstructionStreamIterator pc(m_current_block->instruction_stream());
-        TemporaryChange temp_change { m_pc, &pc };
-
-        bool will_jump = false;
-        bool will_return = false;
-        while (!pc.at_end()) {
-            auto& instruction = *pc;
-            auto ran_or_error = instruction.execute(*this);
-            if (ran_or_error.is_error()) {
-                auto exception_value = *ran_or_error.throw_completion().value();
-                m_saved_exception = make_handle(exception_value);
-                if (m_unwind_contexts.is_empty())
-                    break;
-                auto& unwind_context = m_unwind_contexts.last();
-                if (unwind_context.executable != m_current_executable)
-                    break;
-                if (unwind_context.handler) {
-                    m_current_block = unwind_context.handler;
-                    unwind_context.handler = nullptr;
-
-                    // If there's no finalizer, there's nowhere for the handler block to unwind to, so the unwind context is no longer needed.
-                    if (!unwind_context.finalizer)
-                        m_unwind_contexts.take_last();
-
-                    accumulator() = exception_value;
-                    m_saved_exception = {};
-                    will_jump = true;
-                    break;
-                }
-                if (unwind_context.finalizer) {
-                    m_current_block = unwind_context.finalizer;
-                    m_unwind_contexts.take_last();
-                    will_jump = true;
-                    break;
-                }
-                // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
-                // If you run into this, you probably forgot to remove the current unwind_context somewhere.
-                VERIFY_NOT_REACHED();
-            }
-            if (m_pending_jump.has_value()) {
-                m_current_block = m_pending_jump.release_value();
-                will_jump = true;
-                break;
-            }
-            if (!m_return_value.is_empty()) {
-                will_return = true;
-                break;
-            }
-            ++pc;
-        }
-
-        if (will_return)
-            break;
-
-        if (pc.at_end() && !will_jump)
-            break;
-
-        if (!m_saved_exception.is_null())
-            break;
-    }
+    if (auto* native_executable = native_executable_for(executable))
+        run_native_code(*native_executable);
+    else
+        run_bytecode();
 
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter did run unit {:p}", &executable);
 
@@ -177,6 +137,145 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
     return { return_value, nullptr };
 }
 
+void Interpreter::run_bytecode()
+{
+    for (;;) {
+        Bytecode::InstructionStreamIterator pc(m_current_block->instruction_stream());
+        TemporaryChange temp_change { m_pc, &pc };
+
+        bool will_jump = false;
+        bool will_return = false;
+        while (!pc.at_end()) {
+            auto& instruction = *pc;
+            SamplingProfiler::take_sample_if_requested();
+            if (g_count_opcodes) [[unlikely]]
+                count_opcode(instruction);
+            auto ran_or_error = instruction.execute(*this);
+            if (ran_or_error.is_error()) {
+                will_jump = handle_exception(*ran_or_error.throw_completion().value());
+                break;
+            }
+            if (m_pending_jump.has_value()) {
+                m_current_block = m_pending_jump.release_value();
+                will_jump = true;
+                break;
+            }
+            if (!m_return_value.is_empty()) {
+                will_return = true;
+                break;
+            }
+            ++pc;
+        }
+
+        if (will_return)
+            break;
+
+        if (pc.at_end() && !will_jump)
+            break;
+
+        if (!m_saved_exception.is_null())
+            break;
+    }
+}
+
+void Interpreter::run_native_code(JIT::NativeExecutable const& native_executable)
+{
+    // NOTE: The register file doesn't move while the executable runs, so native code can hold on to it.
+    for (;;) {
+        auto exit_reason = native_executable.run(*this, registers().data(), *m_current_block);
+        if (exit_reason != JIT::ExitReason::Jump)
+            break;
+    }
+}
+
+JIT::NativeExecutable const* Interpreter::native_executable_for(Executable const& executable)
+{
+    if (!g_use_jit)
+        return nullptr;
+    if (!executable.did_try_jit_compilation) {
+        executable.did_try_jit_compilation = true;
+        executable.native_executable = JIT::Compiler::compile(executable);
+    }
+    return executable.native_executable.ptr();
+}
+
+JIT::ExitReason Interpreter::run_instruction_for_jit(Instruction const& instruction)
+{
+    SamplingProfiler::take_sample_if_requested();
+    if (g_count_opcodes) [[unlikely]]
+        count_opcode(instruction);
+    auto ran_or_error = instruction.execute(*this);
+    if (ran_or_error.is_error()) {
+        if (handle_exception(*ran_or_error.throw_completion().value()))
+            return JIT::ExitReason::Jump;
+        return JIT::ExitReason::Exception;
+    }
+    if (m_pending_jump.has_value()) {
+        m_current_block = m_pending_jump.release_value();
+        return JIT::ExitReason::Jump;
+    }
+    if (!m_return_value.is_empty())
+        return JIT::ExitReason::Return;
+    return JIT::ExitReason::Continue;
+}
+
+void Interpreter::count_opcode(Instruction const& instruction)
+{
+    ++s_opcode_counters[to_underlying(instruction.type())];
+}
+
+Span<u64 const> Interpreter::opcode_counters()
+{
+    return s_opcode_counters.span();
+}
+
+void Interpreter::dump_opcode_counters()
+{
+    Vector<size_t, number_of_opcodes> opcodes;
+    u64 total = 0;
+    for (size_t i = 0; i < number_of_opcodes; ++i) {
+        if (s_opcode_counters[i] == 0)
+            continue;
+        opcodes.append(i);
+        total += s_opcode_counters[i];
+    }
+    quick_sort(opcodes, [](auto a, auto b) { return s_opcode_counters[a] > s_opcode_counters[b]; });
+
+    warnln("Executed {} instructions:", total);
+    for (auto opcode : opcodes)
+        warnln("{:>12} {:5.2}% {}", s_opcode_counters[opcode], 100.0 * s_opcode_counters[opcode] / total, s_opcode_names[opcode]);
+}
+
+bool Interpreter::handle_exception(Value exception_value)
+{
+    m_saved_exception = make_handle(exception_value);
+    if (m_unwind_contexts.is_empty())
+        return false;
+    auto& unwind_context = m_unwind_contexts.last();
+    if (unwind_context.executable != m_current_executable)
+        return false;
+    if (unwind_context.handler) {
+        m_current_block = unwind_context.handler;
+        unwind_context.handler = nullptr;
+
+        // If there's no finalizer, there's nowhere for the handler block to unwind to, so the unwind context is no longer needed.
+        if (!unwind_context.finalizer)
+            m_unwind_contexts.take_last();
+
+        accumulator() = exception_value;
+        m_saved_exception = {};
+        return true;
+    }
+    if (unwind_context.finalizer) {
+        m_current_block = unwind_context.finalizer;
+        m_unwind_contexts.take_last();
+        return true;
+    }
+    // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
+    // If you run into this, you probably forgot to remove the current unwind_context somewhere.
+    VERIFY_NOT_REACHED();
+}
+
 void Interpreter::enter_unwind_context(Optional<Label> handler_target, Optional<Label> finalizer_target)
 {
     m_unwind_contexts.empend(m_current_executable, handler_target.has_value() ? &handler_target->block() : nullptr, finalizer_target.has_value() ? &finalizer_target->block() : nullptr);
@@ -208,6 +307,7 @@ VM::InterpreterExecutionScope Interpreter::ast_interpreter_scope()
 }
 
 AK::Array<OwnPtr<PassManager>, static_cast<UnderlyingType<Interpreter::OptimizationLevel>>(Interpreter::OptimizationLevel::__Count)> Interpreter::s_optimization_pipelines {};
+Interpreter::OptimizationLevel Interpreter::s_optimization_level { Interpreter::OptimizationLevel::Default };
 
 Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::OptimizationLevel level)
 {
@@ -230,6 +330,11 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
         pm->add<Passes::UnifySameBlocks>();
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::MergeBlocks>();
+        pm->add<Passes::LoadStoreForwarding>();
+        pm->add<Passes::ConstantFolding>();
+        pm->add<Passes::GenerateCFG>();
+        pm->add<Passes::DeadCodeElimination>();
+        pm->add<Passes::CoalesceRegisters>();
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::PlaceBlocks>();
     } else {
@@ -13,6 +13,7 @@
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
 #include <LibJS/Heap/Handle.h>
+#include <LibJS/JIT/NativeExecutable.h>
 #include <LibJS/Runtime/VM.h>
 #include <LibJS/Runtime/Value.h>
 
@@ -73,11 +74,32 @@ public:
         __Count,
         Default = None,
     };
-    static Bytecode::PassManager& optimization_pipeline(OptimizationLevel = OptimizationLevel::Default);
+    static Bytecode::PassManager& optimization_pipeline(OptimizationLevel);
+    static Bytecode::PassManager& optimization_pipeline() { return optimization_pipeline(s_optimization_level); }
+
+    // The level used by optimization_pipeline() when none is given, e.g. for functions compiled on first call.
+    static void set_optimization_level(OptimizationLevel level) { s_optimization_level = level; }
+    static OptimizationLevel optimization_level() { return s_optimization_level; }
 
     VM::InterpreterExecutionScope ast_interpreter_scope();
 
+    // Runs a single instruction on behalf of JIT-compiled code, and tells it whether it can carry on with the next one.
+    JIT::ExitReason run_instruction_for_jit(Instruction const&);
+
+    // How often each kind of instruction has run while g_count_opcodes was set, indexed by Instruction::Type.
+    // NOTE: Instructions that the JIT compiled to native code are only counted when they call back into the interpreter.
+    static Span<u64 const> opcode_counters();
+    static void dump_opcode_counters();
+
 private:
+    void run_bytecode();
+    static void count_opcode(Instruction const&);
+    void run_native_code(JIT::NativeExecutable const&);
+    JIT::NativeExecutable const* native_executable_for(Executable const&);
+
+    // Returns true if the exception is caught in the current executable, in which case the current block is the one handling it.
+    bool handle_exception(Value exception_value);
+
     RegisterWindow& window()
     {
         return m_register_windows.last().visit([](auto& x) -> RegisterWindow& { return *x; });
@@ -91,6 +113,7 @@ private:
     MarkedVector<Value>& registers() { return window().registers; }
 
     static AK::Array<OwnPtr<PassManager>, static_cast<UnderlyingType<Interpreter::OptimizationLevel>>(Interpreter::OptimizationLevel::__Count)> s_optimization_pipelines;
+    static OptimizationLevel s_optimization_level;
 
     VM& m_vm;
     Realm& m_realm;
@@ -106,5 +129,7 @@ private:
 };
 
 extern bool g_dump_bytecode;
+extern bool g_use_jit;
+extern bool g_count_opcodes;
 
 }
@@ -351,35 +351,38 @@ ThrowCompletionOr<void> ConcatString::execute_impl(Bytecode::Interpreter& interp
     return {};
 }
 
-ThrowCompletionOr<void> GetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
+// Resolves a binding like VM::resolve_binding() does, but goes straight to the environment it was found in the last time if possible.
+static ThrowCompletionOr<Reference> resolve_binding_with_cache(Bytecode::Interpreter& interpreter, FlyString const& name, Environment* start_environment, EnvironmentVariableCache& cache)
 {
     auto& vm = interpreter.vm();
-
-    auto get_reference = [&]() -> ThrowCompletionOr<Reference> {
-        auto const& string = interpreter.current_executable().get_identifier(m_identifier);
-        if (m_cached_environment_coordinate.has_value()) {
-            Environment* environment = nullptr;
-            if (m_cached_environment_coordinate->index == EnvironmentCoordinate::global_marker) {
-                environment = &interpreter.vm().current_realm()->global_environment();
-            } else {
-                environment = vm.running_execution_context().lexical_environment;
-                for (size_t i = 0; i < m_cached_environment_coordinate->hops; ++i)
-                    environment = environment->outer_environment();
-                VERIFY(environment);
-                VERIFY(environment->is_declarative_environment());
-            }
-            if (!environment->is_permanently_screwed_by_eval()) {
-                return Reference { *environment, string, vm.in_strict_mode(), m_cached_environment_coordinate };
-            }
-            m_cached_environment_coordinate = {};
+    if (cache.coordinate.has_value()) {
+        Environment* environment = nullptr;
+        if (cache.coordinate->index == EnvironmentCoordinate::global_marker) {
+            environment = &vm.current_realm()->global_environment();
+        } else {
+            environment = start_environment;
+            for (size_t i = 0; i < cache.coordinate->hops; ++i)
+                environment = environment->outer_environment();
+            VERIFY(environment);
+            VERIFY(environment->is_declarative_environment());
         }
+        if (!environment->is_permanently_screwed_by_eval())
+            return Reference { *environment, name, vm.in_strict_mode(), cache.coordinate };
+        cache.coordinate = {};
+    }
 
-        auto reference = TRY(vm.resolve_binding(string));
-        if (reference.environment_coordinate().has_value())
-            m_cached_environment_coordinate = reference.environment_coordinate();
-        return reference;
-    };
-    auto reference = TRY(get_reference());
+    auto reference = TRY(vm.resolve_binding(name, start_environment));
+    if (reference.environment_coordinate().has_value())
+        cache.coordinate = reference.environment_coordinate();
+    return reference;
+}
+
+ThrowCompletionOr<void> GetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
+{
+    auto& vm = interpreter.vm();
+    auto const& executable = interpreter.current_executable();
+    auto const& string = executable.get_identifier(m_identifier);
+    auto reference = TRY(resolve_binding_with_cache(interpreter, string, vm.running_execution_context().lexical_environment, executable.environment_variable_caches[m_cache_index]));
     interpreter.accumulator() = TRY(reference.get_value(vm));
     return {};
 }
@@ -452,9 +455,10 @@ ThrowCompletionOr<void> CreateVariable::execute_impl(Bytecode::Interpreter& inte
 ThrowCompletionOr<void> SetVariable::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
-    auto const& name = interpreter.current_executable().get_identifier(m_identifier);
+    auto const& executable = interpreter.current_executable();
+    auto const& name = executable.get_identifier(m_identifier);
     auto environment = m_mode == EnvironmentMode::Lexical ? vm.running_execution_context().lexical_environment : vm.running_execution_context().variable_environment;
-    auto reference = TRY(vm.resolve_binding(name, environment));
+    auto reference = TRY(resolve_binding_with_cache(interpreter, name, environment, executable.environment_variable_caches[m_cache_index]));
     switch (m_initialization_mode) {
     case InitializationMode::Initialize:
         TRY(reference.initialize_referenced_binding(vm, interpreter.accumulator()));
@@ -471,21 +475,116 @@ ThrowCompletionOr<void> SetVariable::execute_impl(Bytecode::Interpreter& interpr
     return {};
 }
 
+// NOTE: Objects can only share a non-unique shape if they have the same prototype and the same own properties in the
+//       same storage slots, so an own data property that was found for one shape is in the same slot for all of them.
+//       If the property was found in the prototype instead, the prototype's shape has to match as well.
+static Optional<Value> get_by_id_from_cache(Object const& object, PropertyLookupCache const& cache)
+{
+    if (object.has_exotic_property_access())
+        return {};
+    auto const& shape = object.shape();
+    for (auto const& entry : cache.entries) {
+        if (entry.shape.ptr() != &shape)
+            continue;
+        if (!entry.prototype_shape)
+            return object.get_direct(entry.property_offset);
+        auto const* prototype = shape.prototype();
+        if (prototype && &prototype->shape() == entry.prototype_shape.ptr())
+            return prototype->get_direct(entry.property_offset);
+    }
+    return {};
+}
+
+static void add_to_cache(PropertyLookupCache& cache, Shape& shape, Shape* prototype_shape, u32 property_offset)
+{
+    auto& entry = cache.entries[cache.next_entry_to_replace];
+    cache.next_entry_to_replace = (cache.next_entry_to_replace + 1) % PropertyLookupCache::max_number_of_shapes;
+    entry.shape = shape.make_weak_ptr<Shape>();
+    entry.prototype_shape = prototype_shape ? prototype_shape->make_weak_ptr<Shape>() : WeakPtr<Shape> {};
+    entry.property_offset = property_offset;
+}
+
+// Remembers where [[Get]] found the property, if it's a plain data property that we can load directly next time.
+// Exotic objects may not look at their storage at all, which is why the value has to match what we would load.
+static void update_get_by_id_cache(PropertyLookupCache& cache, Object& object, FlyString const& name, Value value)
+{
+    auto is_cacheable = [&](Object& holder) -> Optional<u32> {
+        if (holder.has_exotic_property_access() || holder.shape().is_unique())
+            return {};
+        auto metadata = holder.shape().lookup(name);
+        if (!metadata.has_value() || holder.get_direct(metadata->offset).is_accessor())
+            return {};
+        if (holder.get_direct(metadata->offset).encoded() != value.encoded())
+            return {};
+        return metadata->offset;
+    };
+
+    if (object.has_exotic_property_access() || object.shape().is_unique())
+        return;
+    if (object.shape().lookup(name).has_value()) {
+        if (auto offset = is_cacheable(object); offset.has_value())
+            add_to_cache(cache, object.shape(), nullptr, offset.value());
+        return;
+    }
+    auto* prototype = object.shape().prototype();
+    if (!prototype)
+        return;
+    if (auto offset = is_cacheable(*prototype); offset.has_value())
+        add_to_cache(cache, object.shape(), &prototype->shape(), offset.value());
+}
+
 ThrowCompletionOr<void> GetById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
+    auto const& executable = interpreter.current_executable();
+    auto& cache = executable.property_lookup_caches[m_cache_index];
     auto* object = TRY(interpreter.accumulator().to_object(vm));
-    interpreter.accumulator() = TRY(object->get(interpreter.current_executable().get_identifier(m_property)));
+    if (auto value = get_by_id_from_cache(*object, cache); value.has_value()) {
+        interpreter.accumulator() = value.release_value();
+        return {};
+    }
+
+    auto const& name = executable.get_identifier(m_property);
+    auto value = TRY(object->get(name));
+    update_get_by_id_cache(cache, *object, name, value);
+    interpreter.accumulator() = value;
     return {};
 }
 
 ThrowCompletionOr<void> PutById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
+    auto const& executable = interpreter.current_executable();
     auto* object = TRY(interpreter.reg(m_base).to_object(vm));
-    PropertyKey name = interpreter.current_executable().get_identifier(m_property);
     auto value = interpreter.accumulator();
-    return put_by_property_key(object, value, name, interpreter, m_kind);
+    if (m_kind != PropertyKind::KeyValue) {
+        PropertyKey name = executable.get_identifier(m_property);
+        return put_by_property_key(object, value, name, interpreter, m_kind);
+    }
+
+    // NOTE: Only writes to existing own writable data properties are cached, as they don't change the object's shape.
+    auto& cache = executable.property_lookup_caches[m_cache_index];
+    for (auto const& entry : cache.entries) {
+        if (entry.shape.ptr() == &object->shape() && !entry.prototype_shape && !object->has_exotic_property_access()) {
+            object->put_direct(entry.property_offset, value);
+            return {};
+        }
+    }
+
+    auto const& name = executable.get_identifier(m_property);
+    auto* shape_before = &object->shape();
+    TRY(put_by_property_key(object, value, name, interpreter, m_kind));
+
+    auto& shape = object->shape();
+    if (&shape != shape_before || shape.is_unique() || object->has_exotic_property_access())
+        return {};
+    auto metadata = shape.lookup(name);
+    if (!metadata.has_value() || !metadata->attributes.is_writable() || object->get_direct(metadata->offset).is_accessor())
+        return {};
+    if (object->get_direct(metadata->offset).encoded() != value.encoded())
+        return {};
+    add_to_cache(cache, shape, nullptr, metadata->offset);
+    return {};
 }
 
 ThrowCompletionOr<void> DeleteById::execute_impl(Bytecode::Interpreter& interpreter) const
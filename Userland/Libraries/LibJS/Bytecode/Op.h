@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/StdLibExtras.h>
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
@@ -34,6 +35,9 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback) { callback(m_src); }
+
+    Register src() const { return m_src; }
 
 private:
     Register m_src;
@@ -51,6 +55,8 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
 
+    Value value() const { return m_value; }
+
 private:
     Value m_value;
 };
@@ -66,6 +72,9 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback) { callback(m_dst); }
+
+    Register dst() const { return m_dst; }
 
 private:
     Register m_dst;
@@ -107,6 +116,12 @@ private:
         ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;    \
         String to_string_impl(Bytecode::Executable const&) const;              \
         void replace_references_impl(BasicBlock const&, BasicBlock const&) { } \
+        void for_each_register_impl(Function<void(Register&)> const& callback) \
+        {                                                                      \
+            callback(m_lhs_reg);                                               \
+        }                                                                      \
+                                                                               \
+        Register lhs() const { return m_lhs_reg; }                             \
                                                                                \
     private:                                                                   \
         Register m_lhs_reg;                                                    \
@@ -199,6 +214,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback)
+    {
+        callback(m_from_object);
+        for (size_t i = 0; i < m_excluded_names_count; i++)
+            callback(m_excluded_names[i]);
+    }
 
     size_t length_impl() const { return sizeof(*this) + sizeof(Register) * m_excluded_names_count; }
 
@@ -244,6 +265,17 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback)
+    {
+        if (m_element_count == 0)
+            return;
+        callback(m_elements[0]);
+        callback(m_elements[1]);
+    }
+
+    // The elements are read from consecutive registers, starting with the first one.
+    size_t element_count() const { return m_element_count; }
+    Register first_element() const { return m_elements[0]; }
 
     size_t length_impl() const
     {
@@ -267,6 +299,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback) { callback(m_lhs); }
 
 private:
     Register m_lhs;
@@ -296,6 +329,8 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    Register lhs() const { return m_lhs; }
+    void for_each_register_impl(Function<void(Register&)> const& callback) { callback(m_lhs); }
 
 private:
     Register m_lhs;
@@ -363,11 +398,12 @@ public:
         Set,
         InitializeOrSet,
     };
-    explicit SetVariable(IdentifierTableIndex identifier, InitializationMode initialization_mode = InitializationMode::Set, EnvironmentMode mode = EnvironmentMode::Lexical)
+    explicit SetVariable(IdentifierTableIndex identifier, u32 cache_index, InitializationMode initialization_mode = InitializationMode::Set, EnvironmentMode mode = EnvironmentMode::Lexical)
         : Instruction(Type::SetVariable)
         , m_identifier(identifier)
         , m_mode(mode)
         , m_initialization_mode(initialization_mode)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -379,13 +415,15 @@ private:
     IdentifierTableIndex m_identifier;
     EnvironmentMode m_mode;
     InitializationMode m_initialization_mode { InitializationMode::Set };
+    u32 m_cache_index { 0 };
 };
 
 class GetVariable final : public Instruction {
 public:
-    explicit GetVariable(IdentifierTableIndex identifier)
+    explicit GetVariable(IdentifierTableIndex identifier, u32 cache_index)
         : Instruction(Type::GetVariable)
         , m_identifier(identifier)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -395,8 +433,7 @@ public:
 
 private:
     IdentifierTableIndex m_identifier;
-
-    Optional<EnvironmentCoordinate> mutable m_cached_environment_coordinate;
+    u32 m_cache_index { 0 };
 };
 
 class DeleteVariable final : public Instruction {
@@ -417,9 +454,10 @@ private:
 
 class GetById final : public Instruction {
 public:
-    explicit GetById(IdentifierTableIndex property)
+    explicit GetById(IdentifierTableIndex property, u32 cache_index)
         : Instruction(Type::GetById)
         , m_property(property)
+        , m_cache_index(cache_index)
     {
     }
 
@@ -429,6 +467,7 @@ public:
 
 private:
     IdentifierTableIndex m_property;
+    u32 m_cache_index { 0 };
 };
 
 enum class PropertyKind {
@@ -441,22 +480,25 @@ enum class PropertyKind {
 
 class PutById final : public Instruction {
 public:
-    explicit PutById(Register base, IdentifierTableIndex property, PropertyKind kind = PropertyKind::KeyValue)
+    explicit PutById(Register base, IdentifierTableIndex property, u32 cache_index, PropertyKind kind = PropertyKind::KeyValue)
         : Instruction(Type::PutById)
         , m_base(base)
         , m_property(property)
         , m_kind(kind)
+        , m_cache_index(cache_index)
     {
     }
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback) { callback(m_base); }
 
 private:
     Register m_base;
     IdentifierTableIndex m_property;
     PropertyKind m_kind;
+    u32 m_cache_index { 0 };
 };
 
 class DeleteById final : public Instruction {
@@ -486,6 +528,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback) { callback(m_base); }
 
 private:
     Register m_base;
@@ -504,6 +547,11 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback)
+    {
+        callback(m_base);
+        callback(m_property);
+    }
 
 private:
     Register m_base;
@@ -522,6 +570,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback) { callback(m_base); }
 
 private:
     Register m_base;
@@ -616,6 +665,11 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void for_each_register_impl(Function<void(Register&)> const& callback)
+    {
+        callback(m_callee);
+        callback(m_this_value);
+    }
 
     Completion throw_type_error_for_callee(Bytecode::Interpreter&, StringView callee_type) const;
 
@@ -793,6 +847,8 @@ public:
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&);
 
+    auto& next_target() const { return m_next_target; }
+
 private:
     Label m_next_target;
 };
@@ -992,6 +1048,29 @@ ALWAYS_INLINE void Instruction::replace_references(BasicBlock const& from, Basic
 #undef __BYTECODE_OP
 }
 
+// Instructions that don't refer to any registers besides the accumulator simply don't implement for_each_register_impl().
+template<typename OpType>
+ALWAYS_INLINE void for_each_register_of(OpType& instruction, Function<void(Register&)> const& callback)
+{
+    if constexpr (requires { instruction.for_each_register_impl(callback); })
+        instruction.for_each_register_impl(callback);
+}
+
+ALWAYS_INLINE void Instruction::for_each_register(Function<void(Register&)> const& callback)
+{
+#define __BYTECODE_OP(op)                                                             \
+    case Instruction::Type::op:                                                       \
+        return for_each_register_of(static_cast<Bytecode::Op::op&>(*this), callback);
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
 ALWAYS_INLINE size_t Instruction::length() const
 {
     if (type() == Type::NewArray)
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// NOTE: Exception handlers may run after any instruction that can throw, and we don't have precise liveness
+//       information across blocks. So only registers that live and die inside a single block, and that are
+//       written before being read in it, share slots with each other. Everything else gets a slot of its own.
+struct RegisterInfo {
+    BasicBlock const* block { nullptr };
+    bool is_block_local { true };
+    bool is_pinned { false };
+    size_t start { 0 };
+    size_t end { 0 };
+};
+
+void CoalesceRegisters::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    HashMap<u32, RegisterInfo> register_info;
+
+    for (auto& block : executable.executable.basic_blocks) {
+        size_t position = 0;
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it, ++position) {
+            auto& instruction = const_cast<Instruction&>(*it);
+
+            // NewArray reads a whole range of registers, so they have to stay where they are.
+            if (instruction.type() == Instruction::Type::NewArray) {
+                auto& new_array = static_cast<Op::NewArray const&>(instruction);
+                for (size_t i = 0; i < new_array.element_count(); ++i)
+                    register_info.ensure(new_array.first_element().index() + i).is_pinned = true;
+            }
+
+            instruction.for_each_register([&](Register& reg) {
+                if (reg.index() == Register::accumulator_index)
+                    return;
+                auto& info = register_info.ensure(reg.index());
+                if (!info.block) {
+                    info.block = &block;
+                    info.start = position;
+                    info.is_block_local = instruction.type() == Instruction::Type::Store;
+                } else if (info.block != &block) {
+                    info.is_block_local = false;
+                }
+                info.end = position;
+            });
+        }
+    }
+
+    HashMap<u32, u32> new_indices;
+    HashTable<u32> reserved_slots;
+    Vector<u32> global_registers;
+    HashMap<BasicBlock const*, Vector<u32>> block_local_registers;
+
+    for (auto& entry : register_info) {
+        if (entry.value.is_pinned) {
+            new_indices.set(entry.key, entry.key);
+            reserved_slots.set(entry.key);
+        } else if (entry.value.is_block_local) {
+            block_local_registers.ensure(entry.value.block).append(entry.key);
+        } else {
+            global_registers.append(entry.key);
+        }
+    }
+
+    auto allocate_slot = [&](HashTable<u32> const& slots_in_use) {
+        u32 slot = Register::accumulator_index + 1;
+        while (reserved_slots.contains(slot) || slots_in_use.contains(slot))
+            ++slot;
+        return slot;
+    };
+
+    quick_sort(global_registers);
+    for (auto index : global_registers) {
+        auto slot = allocate_slot({});
+        new_indices.set(index, slot);
+        reserved_slots.set(slot);
+    }
+
+    // A simple linear scan per block; the registers of one block can reuse the slots of another one.
+    for (auto& entry : block_local_registers) {
+        auto& registers = entry.value;
+        quick_sort(registers, [&](auto a, auto b) { return register_info.get(a)->start < register_info.get(b)->start; });
+
+        Vector<u32> active_registers;
+        HashTable<u32> slots_in_use;
+        for (auto index : registers) {
+            auto start = register_info.get(index)->start;
+            active_registers.remove_all_matching([&](auto active_index) {
+                if (register_info.get(active_index)->end >= start)
+                    return false;
+                slots_in_use.remove(*new_indices.get(active_index));
+                return true;
+            });
+
+            auto slot = allocate_slot(slots_in_use);
+            new_indices.set(index, slot);
+            slots_in_use.set(slot);
+            active_registers.append(index);
+        }
+    }
+
+    u32 highest_index = Register::accumulator_index;
+    for (auto& entry : new_indices)
+        highest_index = max(highest_index, entry.value);
+
+    for (auto& block : executable.executable.basic_blocks) {
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+            const_cast<Instruction&>(*it).for_each_register([&](Register& reg) {
+                if (reg.index() != Register::accumulator_index)
+                    reg = Register(*new_indices.get(reg.index()));
+            });
+        }
+    }
+
+    executable.executable.number_of_registers = highest_index + 1;
+
+    finished();
+}
+
+}
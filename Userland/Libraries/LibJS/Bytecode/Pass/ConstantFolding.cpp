@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// Only numbers that fit in an i32 are folded by the bitwise operators, so they don't have to do ToInt32.
+static Optional<i32> as_int32(Value value)
+{
+    if (!value.is_number())
+        return {};
+    auto number = value.as_double();
+    if (number < NumericLimits<i32>::min() || number > NumericLimits<i32>::max() || static_cast<i32>(number) != number)
+        return {};
+    return static_cast<i32>(number);
+}
+
+// NOTE: Only numbers are folded, since they can't have side effects or throw no matter what we do with them.
+static Optional<Value> fold_binary_op(Instruction::Type type, Value lhs, Value rhs)
+{
+    if (!lhs.is_number() || !rhs.is_number())
+        return {};
+
+    auto a = lhs.as_double();
+    auto b = rhs.as_double();
+    switch (type) {
+    case Instruction::Type::Add:
+        return Value(a + b);
+    case Instruction::Type::Sub:
+        return Value(a - b);
+    case Instruction::Type::Mul:
+        return Value(a * b);
+    case Instruction::Type::Div:
+        return Value(a / b);
+    case Instruction::Type::Mod:
+        // fmod() follows the same rules for NaN, infinities and zeroes as Number::remainder().
+        return Value(fmod(a, b));
+    case Instruction::Type::LessThan:
+        return Value(a < b);
+    case Instruction::Type::LessThanEquals:
+        return Value(a <= b);
+    case Instruction::Type::GreaterThan:
+        return Value(a > b);
+    case Instruction::Type::GreaterThanEquals:
+        return Value(a >= b);
+    case Instruction::Type::StrictlyEquals:
+    case Instruction::Type::LooselyEquals:
+        return Value(a == b);
+    case Instruction::Type::StrictlyInequals:
+    case Instruction::Type::LooselyInequals:
+        return Value(a != b);
+    default:
+        break;
+    }
+
+    auto lhs_int32 = as_int32(lhs);
+    auto rhs_int32 = as_int32(rhs);
+    if (!lhs_int32.has_value() || !rhs_int32.has_value())
+        return {};
+
+    auto x = lhs_int32.value();
+    auto y = rhs_int32.value();
+    switch (type) {
+    case Instruction::Type::BitwiseAnd:
+        return Value(x & y);
+    case Instruction::Type::BitwiseOr:
+        return Value(x | y);
+    case Instruction::Type::BitwiseXor:
+        return Value(x ^ y);
+    case Instruction::Type::LeftShift:
+        return Value(static_cast<i32>(static_cast<u32>(x) << (y & 31)));
+    case Instruction::Type::RightShift:
+        return Value(x >> (y & 31));
+    case Instruction::Type::UnsignedRightShift:
+        return Value(static_cast<u32>(x) >> (y & 31));
+    default:
+        return {};
+    }
+}
+
+static Optional<Value> fold_unary_op(Instruction::Type type, Value value)
+{
+    switch (type) {
+    case Instruction::Type::Not:
+        return Value(!value.to_boolean());
+    case Instruction::Type::UnaryMinus:
+        if (value.is_number())
+            return Value(-value.as_double());
+        return {};
+    case Instruction::Type::BitwiseNot:
+        if (auto int32 = as_int32(value); int32.has_value())
+            return Value(~int32.value());
+        return {};
+    default:
+        return {};
+    }
+}
+
+static Optional<Bytecode::Register> lhs_of_binary_op(Instruction const& instruction)
+{
+    switch (instruction.type()) {
+#define __BYTECODE_OP(OpTitleCase, op_snake_case) \
+    case Instruction::Type::OpTitleCase:          \
+        return static_cast<Op::OpTitleCase const&>(instruction).lhs();
+        JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    default:
+        return {};
+    }
+}
+
+static void fold_constants(BasicBlock& block)
+{
+    // Replacing a binary op with a LoadImmediate is the only way for the block to grow.
+    auto new_block = BasicBlock::create(block.name(), block.size() * 2);
+    bool did_change = false;
+
+    Optional<Value> accumulator_constant;
+    HashMap<u32, Value> register_constants;
+
+    auto emit_load_immediate = [&](Value value) {
+        new (new_block->next_slot()) Op::LoadImmediate(value);
+        new_block->grow(sizeof(Op::LoadImmediate));
+        accumulator_constant = value;
+        did_change = true;
+    };
+
+    auto emit_jump = [&](Optional<Label> const& target) {
+        new (new_block->next_slot()) Op::Jump(target);
+        new_block->grow(sizeof(Op::Jump));
+        did_change = true;
+    };
+
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        auto& instruction = *it;
+        switch (instruction.type()) {
+        case Instruction::Type::LoadImmediate:
+            accumulator_constant = static_cast<Op::LoadImmediate const&>(instruction).value();
+            break;
+        case Instruction::Type::Load: {
+            auto source = static_cast<Op::Load const&>(instruction).src().index();
+            if (source != Register::accumulator_index)
+                accumulator_constant = register_constants.get(source);
+            break;
+        }
+        case Instruction::Type::Store: {
+            auto destination = static_cast<Op::Store const&>(instruction).dst().index();
+            if (destination == Register::accumulator_index)
+                break;
+            if (accumulator_constant.has_value())
+                register_constants.set(destination, accumulator_constant.value());
+            else
+                register_constants.remove(destination);
+            break;
+        }
+        case Instruction::Type::ConcatString:
+            register_constants.remove(static_cast<Op::ConcatString const&>(instruction).lhs().index());
+            break;
+        case Instruction::Type::Not:
+        case Instruction::Type::UnaryMinus:
+        case Instruction::Type::BitwiseNot:
+            if (accumulator_constant.has_value()) {
+                if (auto result = fold_unary_op(instruction.type(), accumulator_constant.value()); result.has_value()) {
+                    emit_load_immediate(result.value());
+                    continue;
+                }
+            }
+            accumulator_constant = {};
+            break;
+        case Instruction::Type::JumpConditional:
+        case Instruction::Type::JumpNullish:
+        case Instruction::Type::JumpUndefined:
+            if (accumulator_constant.has_value()) {
+                auto& jump = static_cast<Op::Jump const&>(instruction);
+                auto value = accumulator_constant.value();
+                bool is_taken;
+                if (instruction.type() == Instruction::Type::JumpConditional)
+                    is_taken = value.to_boolean();
+                else if (instruction.type() == Instruction::Type::JumpNullish)
+                    is_taken = value.is_nullish();
+                else
+                    is_taken = value.is_undefined();
+                emit_jump(is_taken ? jump.true_target() : jump.false_target());
+                continue;
+            }
+            break;
+        default:
+            if (auto lhs = lhs_of_binary_op(instruction); lhs.has_value()) {
+                Optional<Value> lhs_constant = accumulator_constant;
+                if (lhs->index() != Register::accumulator_index)
+                    lhs_constant = register_constants.get(lhs->index());
+                if (lhs_constant.has_value() && accumulator_constant.has_value()) {
+                    if (auto result = fold_binary_op(instruction.type(), lhs_constant.value(), accumulator_constant.value()); result.has_value()) {
+                        emit_load_immediate(result.value());
+                        continue;
+                    }
+                }
+            }
+            accumulator_constant = {};
+            break;
+        }
+        new_block->append_copy_of(instruction);
+    }
+
+    if (did_change)
+        block.take_instructions_from(*new_block);
+}
+
+void ConstantFolding::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks)
+        fold_constants(block);
+
+    finished();
+}
+
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static void remove_unreachable_blocks(PassPipelineExecutable& executable)
+{
+    auto& cfg = *executable.cfg;
+    HashTable<BasicBlock const*> reachable_blocks;
+    Vector<BasicBlock const*> worklist;
+
+    auto visit = [&](BasicBlock const* block) {
+        if (reachable_blocks.set(block) == AK::HashSetResult::InsertedNewEntry)
+            worklist.append(block);
+    };
+
+    visit(&executable.executable.basic_blocks.first());
+    while (!worklist.is_empty()) {
+        auto const* block = worklist.take_last();
+        if (auto successors = cfg.get(block); successors.has_value()) {
+            for (auto const* successor : *successors)
+                visit(successor);
+        }
+        // FinishUnwind jumps without being a terminator, so GenerateCFG doesn't know about it.
+        for (InstructionStreamIterator it { block->instruction_stream() }; !it.at_end(); ++it) {
+            if ((*it).type() == Instruction::Type::FinishUnwind)
+                visit(&static_cast<Op::FinishUnwind const&>(*it).next_target().block());
+        }
+    }
+
+    if (reachable_blocks.size() == executable.executable.basic_blocks.size())
+        return;
+
+    executable.executable.basic_blocks.remove_all_matching([&](auto& block) { return !reachable_blocks.contains(block.ptr()); });
+
+    // The CFG still refers to the blocks we just removed.
+    executable.cfg.clear();
+    executable.inverted_cfg.clear();
+    executable.exported_blocks.clear();
+}
+
+// NOTE: Load, LoadImmediate and Store can't throw, so a value they overwrite can't be observed by an exception
+//       handler either. Anything else may read any register, so we forget everything we know when we see one.
+static void remove_dead_stores(BasicBlock& block)
+{
+    Vector<Instruction const*> instructions;
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it)
+        instructions.append(&*it);
+
+    // Whether the value in the accumulator (or a register) is overwritten before anything reads it.
+    bool accumulator_is_dead = false;
+    HashTable<u32> dead_registers;
+    HashTable<Instruction const*> dead_instructions;
+
+    for (size_t i = instructions.size(); i > 0; --i) {
+        auto const& instruction = *instructions[i - 1];
+        switch (instruction.type()) {
+        case Instruction::Type::Load: {
+            auto source = static_cast<Op::Load const&>(instruction).src().index();
+            if (accumulator_is_dead) {
+                dead_instructions.set(&instruction);
+                continue;
+            }
+            if (source == Register::accumulator_index)
+                continue;
+            dead_registers.remove(source);
+            accumulator_is_dead = true;
+            continue;
+        }
+        case Instruction::Type::LoadImmediate:
+            if (accumulator_is_dead)
+                dead_instructions.set(&instruction);
+            accumulator_is_dead = true;
+            continue;
+        case Instruction::Type::Store: {
+            auto destination = static_cast<Op::Store const&>(instruction).dst().index();
+            if (destination == Register::accumulator_index || dead_registers.contains(destination)) {
+                dead_instructions.set(&instruction);
+                continue;
+            }
+            dead_registers.set(destination);
+            accumulator_is_dead = false;
+            continue;
+        }
+        default:
+            accumulator_is_dead = false;
+            dead_registers.clear();
+            continue;
+        }
+    }
+
+    if (dead_instructions.is_empty())
+        return;
+
+    auto new_block = BasicBlock::create(block.name(), block.size());
+    for (auto const* instruction : instructions) {
+        if (!dead_instructions.contains(instruction))
+            new_block->append_copy_of(*instruction);
+    }
+    block.take_instructions_from(*new_block);
+}
+
+void DeadCodeElimination::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    VERIFY(executable.cfg.has_value());
+    remove_unreachable_blocks(executable);
+
+    for (auto& block : executable.executable.basic_blocks)
+        remove_dead_stores(block);
+
+    finished();
+}
+
+}
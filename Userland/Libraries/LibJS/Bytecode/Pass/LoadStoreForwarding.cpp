@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// NOTE: Nothing is known at the start of a block, so this only has to look at one block at a time.
+//       Within a block, registers other than the accumulator are only written by Store and ConcatString,
+//       while pretty much everything else may replace the value in the accumulator.
+static void forward_loads_and_stores(BasicBlock& block)
+{
+    // Replacing a Load with a LoadImmediate is the only way for the block to grow.
+    auto new_block = BasicBlock::create(block.name(), block.size() * 2);
+    bool did_change = false;
+
+    Optional<u32> accumulator_is_copy_of;
+    Optional<Value> accumulator_constant;
+    HashMap<u32, Value> register_constants;
+
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        auto& instruction = *it;
+        switch (instruction.type()) {
+        case Instruction::Type::Load: {
+            auto source = static_cast<Op::Load const&>(instruction).src().index();
+            if (source == Register::accumulator_index || accumulator_is_copy_of == source) {
+                did_change = true;
+                continue;
+            }
+            accumulator_is_copy_of = source;
+            accumulator_constant = register_constants.get(source);
+            if (accumulator_constant.has_value()) {
+                new (new_block->next_slot()) Op::LoadImmediate(accumulator_constant.value());
+                new_block->grow(sizeof(Op::LoadImmediate));
+                did_change = true;
+                continue;
+            }
+            break;
+        }
+        case Instruction::Type::LoadImmediate: {
+            auto value = static_cast<Op::LoadImmediate const&>(instruction).value();
+            if (accumulator_constant.has_value() && accumulator_constant->encoded() == value.encoded()) {
+                did_change = true;
+                continue;
+            }
+            accumulator_is_copy_of = {};
+            accumulator_constant = value;
+            break;
+        }
+        case Instruction::Type::Store: {
+            auto destination = static_cast<Op::Store const&>(instruction).dst().index();
+            if (destination == Register::accumulator_index || accumulator_is_copy_of == destination) {
+                did_change = true;
+                continue;
+            }
+            if (accumulator_constant.has_value())
+                register_constants.set(destination, accumulator_constant.value());
+            else
+                register_constants.remove(destination);
+            accumulator_is_copy_of = destination;
+            break;
+        }
+        case Instruction::Type::ConcatString: {
+            // This writes to its register, and leaves the accumulator alone.
+            auto lhs = static_cast<Op::ConcatString const&>(instruction).lhs().index();
+            register_constants.remove(lhs);
+            if (accumulator_is_copy_of == lhs)
+                accumulator_is_copy_of = {};
+            break;
+        }
+        default:
+            accumulator_is_copy_of = {};
+            accumulator_constant = {};
+            break;
+        }
+        new_block->append_copy_of(instruction);
+    }
+
+    if (did_change)
+        block.take_instructions_from(*new_block);
+}
+
+void LoadStoreForwarding::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    for (auto& block : executable.executable.basic_blocks)
+        forward_loads_and_stores(block);
+
+    finished();
+}
+
+}
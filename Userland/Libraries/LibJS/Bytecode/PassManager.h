@@ -7,6 +7,7 @@
 #pragma once
 
 #include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <sys/time.h>
 #include <time.h>
@@ -67,8 +68,13 @@ public:
 
     void perform(Executable& executable)
     {
+        auto statistics_before = executable.statistics();
         PassPipelineExecutable pipeline_executable { executable };
         perform(pipeline_executable);
+
+        ++m_statistics.executable_count;
+        m_statistics.before += statistics_before;
+        m_statistics.after += executable.statistics();
     }
 
     virtual void perform(PassPipelineExecutable& executable) override
@@ -79,8 +85,17 @@ public:
         finished();
     }
 
+    // Totals for every executable this pipeline has been run on, to see how much the passes shrink them.
+    struct Statistics {
+        size_t executable_count { 0 };
+        Executable::Statistics before;
+        Executable::Statistics after;
+    };
+    Statistics const& statistics() const { return m_statistics; }
+
 private:
     NonnullOwnPtrVector<Pass> m_passes;
+    Statistics m_statistics;
 };
 
 namespace Passes {
@@ -121,6 +136,47 @@ private:
     virtual void perform(PassPipelineExecutable&) override;
 };
 
+// Removes loads and stores of values that are already in the accumulator or the register, and loads
+// registers with a known constant value as immediates instead.
+class LoadStoreForwarding : public Pass {
+public:
+    LoadStoreForwarding() = default;
+    ~LoadStoreForwarding() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Evaluates arithmetic, comparisons and conditional jumps on operands that are known constants.
+class ConstantFolding : public Pass {
+public:
+    ConstantFolding() = default;
+    ~ConstantFolding() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Removes unreachable blocks, and writes to the accumulator or registers that are overwritten before being read.
+class DeadCodeElimination : public Pass {
+public:
+    DeadCodeElimination() = default;
+    ~DeadCodeElimination() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Lets registers whose lifetimes don't overlap share a slot, shrinking the register file of the executable.
+class CoalesceRegisters : public Pass {
+public:
+    CoalesceRegisters() = default;
+    ~CoalesceRegisters() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
 class DumpCFG : public Pass {
 public:
     DumpCFG(FILE* file)
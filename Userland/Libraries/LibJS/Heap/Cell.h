@@ -38,6 +38,8 @@ public:
 
     enum class State {
         Live,
+        // Unreachable and finalized, but not destroyed until its HeapBlock is swept.
+        Condemned,
         Dead,
     };
 
@@ -88,6 +90,9 @@ public:
 
     bool overrides_must_survive_garbage_collection(Badge<Heap>) const { return m_overrides_must_survive_garbage_collection; }
 
+    bool can_be_swept_lazily(Badge<Heap>) const { return m_can_be_swept_lazily; }
+    void set_can_be_swept_lazily(Badge<Heap>, bool b) { m_can_be_swept_lazily = b; }
+
     Heap& heap() const;
     VM& vm() const;
 
@@ -99,7 +104,8 @@ protected:
 private:
     bool m_mark : 1 { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
-    State m_state : 1 { State::Live };
+    bool m_can_be_swept_lazily : 1 { false };
+    State m_state : 2 { State::Live };
 };
 
 }
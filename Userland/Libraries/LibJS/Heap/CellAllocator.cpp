@@ -5,6 +5,7 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/Debug.h>
 #include <LibJS/Heap/BlockAllocator.h>
 #include <LibJS/Heap/CellAllocator.h>
 #include <LibJS/Heap/Heap.h>
@@ -19,6 +20,16 @@ CellAllocator::CellAllocator(size_t cell_size)
 
 Cell* CellAllocator::allocate_cell(Heap& heap)
 {
+    if (m_usable_blocks.is_empty() && !m_unswept_blocks.is_empty()) {
+        while (m_usable_blocks.is_empty() && !m_unswept_blocks.is_empty())
+            sweep_block(*m_unswept_blocks.first());
+        if (m_usable_blocks.is_empty() && !m_empty_blocks.is_empty())
+            m_usable_blocks.append(*m_empty_blocks.first());
+        // Hand back the empty blocks all at once when sweeping is done, rather than one by one as we find them.
+        if (m_unswept_blocks.is_empty())
+            release_empty_blocks();
+    }
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
         m_usable_blocks.append(*block.leak_ptr());
@@ -32,19 +43,45 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
     return cell;
 }
 
-void CellAllocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
+void CellAllocator::schedule_sweep(Badge<Heap>)
+{
+    while (!m_full_blocks.is_empty())
+        m_unswept_blocks.append(*m_full_blocks.first());
+    while (!m_usable_blocks.is_empty())
+        m_unswept_blocks.append(*m_usable_blocks.first());
+}
+
+size_t CellAllocator::finish_sweeping(Badge<Heap>)
 {
-    auto& heap = block.heap();
-    block.m_list_node.remove();
-    // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
-    block.~HeapBlock();
-    heap.block_allocator().deallocate_block(&block);
+    while (!m_unswept_blocks.is_empty())
+        sweep_block(*m_unswept_blocks.first());
+    return release_empty_blocks();
 }
 
-void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
+void CellAllocator::sweep_block(HeapBlock& block)
 {
-    VERIFY(!block.is_full());
-    m_usable_blocks.append(block);
+    if (!block.sweep())
+        m_empty_blocks.append(block);
+    else if (block.is_full())
+        m_full_blocks.append(block);
+    else
+        m_usable_blocks.append(block);
+}
+
+size_t CellAllocator::release_empty_blocks()
+{
+    size_t released_blocks = 0;
+    while (!m_empty_blocks.is_empty()) {
+        auto& block = *m_empty_blocks.first();
+        auto& heap = block.heap();
+        dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", &block, block.cell_size());
+        block.m_list_node.remove();
+        // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
+        block.~HeapBlock();
+        heap.block_allocator().deallocate_block(&block);
+        ++released_blocks;
+    }
+    return released_blocks;
 }
 
 }
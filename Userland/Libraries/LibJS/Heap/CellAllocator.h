@@ -25,26 +25,33 @@ public:
     template<typename Callback>
     IterationDecision for_each_block(Callback callback)
     {
-        for (auto& block : m_full_blocks) {
-            if (callback(block) == IterationDecision::Break)
-                return IterationDecision::Break;
-        }
-        for (auto& block : m_usable_blocks) {
-            if (callback(block) == IterationDecision::Break)
-                return IterationDecision::Break;
+        for (auto* list : { &m_full_blocks, &m_usable_blocks, &m_unswept_blocks, &m_empty_blocks }) {
+            for (auto& block : *list) {
+                if (callback(block) == IterationDecision::Break)
+                    return IterationDecision::Break;
+            }
         }
         return IterationDecision::Continue;
     }
 
-    void block_did_become_empty(Badge<Heap>, HeapBlock&);
-    void block_did_become_usable(Badge<Heap>, HeapBlock&);
+    // After a collection, blocks are swept one at a time whenever we run out of room for new cells,
+    // so the collection itself doesn't have to touch every block.
+    void schedule_sweep(Badge<Heap>);
+
+    // Sweeps whatever is left of the blocks, and returns the number of blocks that became empty and were freed.
+    size_t finish_sweeping(Badge<Heap>);
 
 private:
+    void sweep_block(HeapBlock&);
+    size_t release_empty_blocks();
+
     const size_t m_cell_size;
 
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+    BlockList m_unswept_blocks;
+    BlockList m_empty_blocks;
 };
 
 }
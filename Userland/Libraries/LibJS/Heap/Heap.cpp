@@ -73,14 +73,12 @@ ALWAYS_INLINE CellAllocator& Heap::allocator_for_size(size_t cell_size)
 
 Cell* Heap::allocate_cell(size_t size)
 {
-    if (should_collect_on_every_allocation()) {
+    if (should_collect_on_every_allocation())
         collect_garbage();
-    } else if (m_allocations_since_last_gc > m_max_allocations_between_gc) {
-        m_allocations_since_last_gc = 0;
+    else if (m_allocations_since_last_gc > m_max_allocations_between_gc)
         collect_garbage();
-    } else {
+    else
         ++m_allocations_since_last_gc;
-    }
 
     auto& allocator = allocator_for_size(size);
     return allocator.allocate_cell(*this);
@@ -97,17 +95,58 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
 #endif
 
     auto collection_measurement_timer = Core::ElapsedTimer::start_new();
+    m_allocations_since_last_gc = 0;
+    if (collection_type == CollectionType::CollectGarbage && m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    // Cells that survived the last collection stay marked until their block is swept, so we can't mark before that.
+    CollectionStatistics statistics;
+    statistics.freed_blocks = finish_sweeping();
+
     if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
-            return;
-        }
         HashTable<Cell*> roots;
         gather_roots(roots);
         mark_live_cells(roots);
     }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    condemn_unmarked_cells(statistics);
+
+    for (auto& weak_container : m_weak_containers)
+        weak_container.remove_dead_cells({});
+
+    m_max_allocations_between_gc = max(minimum_allocations_between_gc, statistics.live_cells);
+
+    // Everything has to go when the heap is going away, and the report should account for all of the freed blocks.
+    if (collection_type == CollectionType::CollectEverything || print_report) {
+        statistics.freed_blocks += finish_sweeping();
+    } else {
+        for (auto& allocator : m_allocators)
+            allocator->schedule_sweep({});
+    }
+
+    if (print_report)
+        print_collection_report(statistics, collection_measurement_timer);
+}
+
+void Heap::collect_garbage_if_idle_collection_is_worthwhile()
+{
+    if (m_collecting_garbage)
+        return;
+    if (!m_gc_deferrals && m_allocations_since_last_gc >= m_max_allocations_between_gc / 2) {
+        collect_garbage();
+        return;
+    }
+    (void)finish_sweeping();
+}
+
+size_t Heap::finish_sweeping()
+{
+    dbgln_if(HEAP_DEBUG, "finish_sweeping:");
+    size_t freed_blocks = 0;
+    for (auto& allocator : m_allocators)
+        freed_blocks += allocator->finish_sweeping({});
+    return freed_blocks;
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -203,6 +242,8 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
     }
 }
 
+// NOTE: Cells are marked when they are first seen, but their edges are visited from a work list rather than
+//       recursively, so long chains of objects (linked lists, deep DOM trees) can't overflow the stack.
 class MarkingVisitor final : public Cell::Visitor {
 public:
     MarkingVisitor() = default;
@@ -214,8 +255,17 @@ public:
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
-        cell.visit_edges(*this);
+        m_work_list.append(&cell);
+    }
+
+    void mark_all_reachable_cells()
+    {
+        while (!m_work_list.is_empty())
+            m_work_list.take_last()->visit_edges(*this);
     }
+
+private:
+    Vector<Cell*> m_work_list;
 };
 
 void Heap::mark_live_cells(HashTable<Cell*> const& roots)
@@ -225,6 +275,7 @@ void Heap::mark_live_cells(HashTable<Cell*> const& roots)
     MarkingVisitor visitor;
     for (auto* root : roots)
         visitor.visit(root);
+    visitor.mark_all_reachable_cells();
 
     for (auto& inverse_root : m_uprooted_cells)
         inverse_root->set_marked(false);
@@ -239,64 +290,36 @@ bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
     return cell.must_survive_garbage_collection();
 }
 
-void Heap::finalize_unmarked_cells()
-{
-    for_each_block([&](auto& block) {
-        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
-            if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
-                cell->finalize();
-        });
-        return IterationDecision::Continue;
-    });
-}
-
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::condemn_unmarked_cells(CollectionStatistics& statistics)
 {
-    dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
-    Vector<HeapBlock*, 32> empty_blocks;
-    Vector<HeapBlock*, 32> full_blocks_that_became_usable;
-
-    size_t collected_cells = 0;
-    size_t live_cells = 0;
-    size_t collected_cell_bytes = 0;
-    size_t live_cell_bytes = 0;
+    dbgln_if(HEAP_DEBUG, "condemn_unmarked_cells:");
+    Vector<Cell*> cells_to_destroy_now;
 
     for_each_block([&](auto& block) {
-        bool block_has_live_cells = false;
-        bool block_was_full = block.is_full();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
-            if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
-                dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
-                block.deallocate(cell);
-                ++collected_cells;
-                collected_cell_bytes += block.cell_size();
-            } else {
-                cell->set_marked(false);
-                block_has_live_cells = true;
-                ++live_cells;
-                live_cell_bytes += block.cell_size();
+            if (cell->is_marked() || cell_must_survive_garbage_collection(*cell)) {
+                ++statistics.live_cells;
+                statistics.live_cell_bytes += block.cell_size();
+                return;
             }
+            dbgln_if(HEAP_DEBUG, "  x {}", cell);
+            cell->finalize();
+            cell->set_state(Cell::State::Condemned);
+            if (!cell->can_be_swept_lazily({}))
+                cells_to_destroy_now.append(cell);
+            ++statistics.collected_cells;
+            statistics.collected_cell_bytes += block.cell_size();
         });
-        if (!block_has_live_cells)
-            empty_blocks.append(&block);
-        else if (block_was_full != block.is_full())
-            full_blocks_that_became_usable.append(&block);
         return IterationDecision::Continue;
     });
 
-    for (auto& weak_container : m_weak_containers)
-        weak_container.remove_dead_cells({});
-
-    for (auto* block : empty_blocks) {
-        dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
-        allocator_for_size(block->cell_size()).block_did_become_empty({}, *block);
-    }
-
-    for (auto* block : full_blocks_that_became_usable) {
-        dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
-        allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
-    }
+    // NOTE: This happens after every finalizer has run, so finalizers can still look at other dead cells.
+    for (auto* cell : cells_to_destroy_now)
+        HeapBlock::from_cell(cell)->deallocate(cell);
+}
 
+void Heap::print_collection_report(CollectionStatistics const& statistics, Core::ElapsedTimer const& measurement_timer)
+{
     if constexpr (HEAP_DEBUG) {
         for_each_block([&](auto& block) {
             dbgln(" > Live HeapBlock @ {}: cell_size={}", &block, block.cell_size());
@@ -306,22 +329,20 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
 
     int time_spent = measurement_timer.elapsed();
 
-    if (print_report) {
-        size_t live_block_count = 0;
-        for_each_block([&](auto&) {
-            ++live_block_count;
-            return IterationDecision::Continue;
-        });
+    size_t live_block_count = 0;
+    for_each_block([&](auto&) {
+        ++live_block_count;
+        return IterationDecision::Continue;
+    });
 
-        dbgln("Garbage collection report");
-        dbgln("=============================================");
-        dbgln("     Time spent: {} ms", time_spent);
-        dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
-        dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
-        dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
-        dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
-        dbgln("=============================================");
-    }
+    dbgln("Garbage collection report");
+    dbgln("=============================================");
+    dbgln("     Time spent: {} ms", time_spent);
+    dbgln("     Live cells: {} ({} bytes)", statistics.live_cells, statistics.live_cell_bytes);
+    dbgln("Collected cells: {} ({} bytes)", statistics.collected_cells, statistics.collected_cell_bytes);
+    dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
+    dbgln("   Freed blocks: {} ({} bytes)", statistics.freed_blocks, statistics.freed_blocks * HeapBlock::block_size);
+    dbgln("=============================================");
 }
 
 void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
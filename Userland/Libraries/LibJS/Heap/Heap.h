@@ -24,6 +24,27 @@
 
 namespace JS {
 
+// Cells of these types may be destroyed at any point after they have become unreachable, since the only thing their
+// destructors do is free memory they own. Anything else (e.g. cells with weak pointers to them, or that unregister
+// themselves from somewhere in their destructor) is destroyed during the collection that found it to be dead.
+// NOTE: This intentionally names exact types, as subclasses can easily bring their own cleanup along.
+template<typename T>
+inline constexpr bool CanBeSweptLazily = false;
+template<>
+inline constexpr bool CanBeSweptLazily<Object> = true;
+template<>
+inline constexpr bool CanBeSweptLazily<Array> = true;
+template<>
+inline constexpr bool CanBeSweptLazily<PrimitiveString> = true;
+template<>
+inline constexpr bool CanBeSweptLazily<BigInt> = true;
+template<>
+inline constexpr bool CanBeSweptLazily<Accessor> = true;
+template<>
+inline constexpr bool CanBeSweptLazily<DeclarativeEnvironment> = true;
+template<>
+inline constexpr bool CanBeSweptLazily<FunctionEnvironment> = true;
+
 class Heap {
     AK_MAKE_NONCOPYABLE(Heap);
     AK_MAKE_NONMOVABLE(Heap);
@@ -37,7 +58,9 @@ public:
     {
         auto* memory = allocate_cell(sizeof(T));
         new (memory) T(forward<Args>(args)...);
-        return static_cast<T*>(memory);
+        auto* cell = static_cast<T*>(memory);
+        cell->set_can_be_swept_lazily({}, CanBeSweptLazily<T>);
+        return cell;
     }
 
     template<typename T, typename... Args>
@@ -46,6 +69,7 @@ public:
         auto* memory = allocate_cell(sizeof(T));
         new (memory) T(forward<Args>(args)...);
         auto* cell = static_cast<T*>(memory);
+        cell->set_can_be_swept_lazily({}, CanBeSweptLazily<T>);
         memory->initialize(realm);
         return cell;
     }
@@ -57,6 +81,11 @@ public:
 
     void collect_garbage(CollectionType = CollectionType::CollectGarbage, bool print_report = false);
 
+    // Meant to be called when the embedder is idle, e.g. between event loop tasks. This collects a bit earlier than
+    // allocation would, so the pause happens where nobody is waiting for it, with a shallow stack to scan.
+    // Otherwise, it finishes sweeping the blocks left over from the last collection.
+    void collect_garbage_if_idle_collection_is_worthwhile();
+
     VM& vm() { return m_vm; }
 
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
@@ -85,9 +114,18 @@ private:
 
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
+    struct CollectionStatistics {
+        size_t live_cells { 0 };
+        size_t live_cell_bytes { 0 };
+        size_t collected_cells { 0 };
+        size_t collected_cell_bytes { 0 };
+        size_t freed_blocks { 0 };
+    };
+
     void mark_live_cells(HashTable<Cell*> const& live_cells);
-    void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void condemn_unmarked_cells(CollectionStatistics&);
+    size_t finish_sweeping();
+    void print_collection_report(CollectionStatistics const&, Core::ElapsedTimer const&);
 
     CellAllocator& allocator_for_size(size_t);
 
@@ -100,7 +138,10 @@ private:
         }
     }
 
-    size_t m_max_allocations_between_gc { 100000 };
+    // The number of allocations between collections scales with the number of cells that survived the last one,
+    // so the cost of collecting stays proportional to the amount of allocation instead of the size of the heap.
+    static constexpr size_t minimum_allocations_between_gc = 100000;
+    size_t m_max_allocations_between_gc { minimum_allocations_between_gc };
     size_t m_allocations_since_last_gc { 0 };
 
     bool m_should_collect_on_every_allocation { false };
@@ -49,6 +49,10 @@ public:
 
     void deallocate(Cell*);
 
+    // Destroys the cells condemned by the last collection, and clears the marks of the ones that survived it.
+    // Returns whether there are any cells left in the block.
+    bool sweep();
+
     template<typename Callback>
     void for_each_cell(Callback callback)
     {
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace JS::JIT {
+
+// A tiny x86_64 assembler that knows exactly the instructions the baseline JIT needs, and nothing more.
+class Assembler {
+public:
+    enum class Reg : u8 {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+        RBX = 3,
+        RSP = 4,
+        RBP = 5,
+        RSI = 6,
+        RDI = 7,
+        R8 = 8,
+        R9 = 9,
+        R10 = 10,
+        R11 = 11,
+        R12 = 12,
+        R13 = 13,
+        R14 = 14,
+        R15 = 15,
+    };
+
+    enum class Condition : u8 {
+        Overflow = 0x0,
+        NotOverflow = 0x1,
+        Below = 0x2,
+        AboveOrEqual = 0x3,
+        Equal = 0x4,
+        NotEqual = 0x5,
+        BelowOrEqual = 0x6,
+        Above = 0x7,
+        Sign = 0x8,
+        NotSign = 0x9,
+        LessThan = 0xc,
+        GreaterThanOrEqual = 0xd,
+        LessThanOrEqual = 0xe,
+        GreaterThan = 0xf,
+    };
+
+    struct Label {
+        Optional<size_t> offset;
+        // Offsets of rel32 displacements that have to point at this label once it's bound.
+        Vector<size_t> pending_jumps;
+    };
+
+    explicit Assembler(Vector<u8>& output)
+        : m_output(output)
+    {
+    }
+
+    size_t offset() const { return m_output.size(); }
+
+    void bind(Label& label)
+    {
+        VERIFY(!label.offset.has_value());
+        label.offset = offset();
+        for (auto jump : label.pending_jumps)
+            patch_rel32(jump, offset());
+        label.pending_jumps.clear();
+    }
+
+    void push(Reg reg)
+    {
+        emit_rex_if_needed(false, Reg::RAX, reg);
+        emit8(0x50 | (to_underlying(reg) & 7));
+    }
+
+    void pop(Reg reg)
+    {
+        emit_rex_if_needed(false, Reg::RAX, reg);
+        emit8(0x58 | (to_underlying(reg) & 7));
+    }
+
+    void ret() { emit8(0xc3); }
+
+    // mov dst, src
+    void mov(Reg dst, Reg src)
+    {
+        emit_rex(true, src, dst);
+        emit8(0x89);
+        emit_modrm_reg(src, dst);
+    }
+
+    // mov dst, imm64
+    void mov(Reg dst, u64 imm)
+    {
+        if (imm <= NumericLimits<u32>::max()) {
+            mov32(dst, static_cast<u32>(imm));
+            return;
+        }
+        emit_rex(true, Reg::RAX, dst);
+        emit8(0xb8 | (to_underlying(dst) & 7));
+        emit64(imm);
+    }
+
+    // mov dst32, imm32 (zero-extends into the upper half)
+    void mov32(Reg dst, u32 imm)
+    {
+        emit_rex_if_needed(false, Reg::RAX, dst);
+        emit8(0xb8 | (to_underlying(dst) & 7));
+        emit32(imm);
+    }
+
+    // mov dst, [base + displacement]
+    void load(Reg dst, Reg base, i32 displacement)
+    {
+        emit_rex(true, dst, base);
+        emit8(0x8b);
+        emit_modrm_memory(dst, base, displacement);
+    }
+
+    // mov [base + displacement], src
+    void store(Reg base, i32 displacement, Reg src)
+    {
+        emit_rex(true, src, base);
+        emit8(0x89);
+        emit_modrm_memory(src, base, displacement);
+    }
+
+    // shr reg, imm8
+    void shift_right(Reg reg, u8 amount)
+    {
+        emit_rex(true, Reg::RAX, reg);
+        emit8(0xc1);
+        emit_modrm_reg(static_cast<Reg>(5), reg);
+        emit8(amount);
+    }
+
+    // cmp lhs32, imm32
+    void compare32(Reg lhs, u32 imm)
+    {
+        emit_rex_if_needed(false, Reg::RAX, lhs);
+        emit8(0x81);
+        emit_modrm_reg(static_cast<Reg>(7), lhs);
+        emit32(imm);
+    }
+
+    // cmp lhs32, rhs32
+    void compare32(Reg lhs, Reg rhs)
+    {
+        emit_rex_if_needed(false, rhs, lhs);
+        emit8(0x39);
+        emit_modrm_reg(rhs, lhs);
+    }
+
+    // and reg32, imm32
+    void and32(Reg reg, u32 imm)
+    {
+        emit_rex_if_needed(false, Reg::RAX, reg);
+        emit8(0x81);
+        emit_modrm_reg(static_cast<Reg>(4), reg);
+        emit32(imm);
+    }
+
+    // test reg32, imm32
+    void test32(Reg reg, u32 imm)
+    {
+        emit_rex_if_needed(false, Reg::RAX, reg);
+        emit8(0xf7);
+        emit_modrm_reg(static_cast<Reg>(0), reg);
+        emit32(imm);
+    }
+
+    // test lhs32, rhs32
+    void test32(Reg lhs, Reg rhs)
+    {
+        emit_rex_if_needed(false, rhs, lhs);
+        emit8(0x85);
+        emit_modrm_reg(rhs, lhs);
+    }
+
+    // add dst32, src32
+    void add32(Reg dst, Reg src)
+    {
+        emit_rex_if_needed(false, src, dst);
+        emit8(0x01);
+        emit_modrm_reg(src, dst);
+    }
+
+    // sub dst32, src32
+    void sub32(Reg dst, Reg src)
+    {
+        emit_rex_if_needed(false, src, dst);
+        emit8(0x29);
+        emit_modrm_reg(src, dst);
+    }
+
+    // imul dst32, src32
+    void mul32(Reg dst, Reg src)
+    {
+        emit_rex_if_needed(false, dst, src);
+        emit8(0x0f);
+        emit8(0xaf);
+        emit_modrm_reg(dst, src);
+    }
+
+    // add dst32, imm8
+    void add32(Reg dst, i8 imm)
+    {
+        emit_rex_if_needed(false, Reg::RAX, dst);
+        emit8(0x83);
+        emit_modrm_reg(static_cast<Reg>(0), dst);
+        emit8(static_cast<u8>(imm));
+    }
+
+    // or dst, src
+    void bitwise_or(Reg dst, Reg src)
+    {
+        emit_rex(true, src, dst);
+        emit8(0x09);
+        emit_modrm_reg(src, dst);
+    }
+
+    // add rsp, imm8 / sub rsp, imm8
+    void adjust_stack_pointer(i8 amount)
+    {
+        emit_rex(true, Reg::RAX, Reg::RSP);
+        emit8(0x83);
+        emit_modrm_reg(static_cast<Reg>(amount < 0 ? 5 : 0), Reg::RSP);
+        emit8(static_cast<u8>(amount < 0 ? -amount : amount));
+    }
+
+    // setcc dst8 followed by movzx dst32, dst8 (only for registers that don't need a REX prefix to address their low byte)
+    void set_if(Condition condition, Reg dst)
+    {
+        VERIFY(to_underlying(dst) < 4);
+        emit8(0x0f);
+        emit8(0x90 | to_underlying(condition));
+        emit_modrm_reg(static_cast<Reg>(0), dst);
+        emit8(0x0f);
+        emit8(0xb6);
+        emit_modrm_reg(dst, dst);
+    }
+
+    void jump(Label& label)
+    {
+        emit8(0xe9);
+        emit_rel32_to(label);
+    }
+
+    void jump_if(Condition condition, Label& label)
+    {
+        emit8(0x0f);
+        emit8(0x80 | to_underlying(condition));
+        emit_rel32_to(label);
+    }
+
+    // jmp reg
+    void jump(Reg reg)
+    {
+        emit_rex_if_needed(false, Reg::RAX, reg);
+        emit8(0xff);
+        emit_modrm_reg(static_cast<Reg>(4), reg);
+    }
+
+    // call reg
+    void call(Reg reg)
+    {
+        emit_rex_if_needed(false, Reg::RAX, reg);
+        emit8(0xff);
+        emit_modrm_reg(static_cast<Reg>(2), reg);
+    }
+
+private:
+    void emit8(u8 value) { m_output.append(value); }
+
+    void emit32(u32 value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            emit8(static_cast<u8>(value >> (i * 8)));
+    }
+
+    void emit64(u64 value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            emit8(static_cast<u8>(value >> (i * 8)));
+    }
+
+    static bool is_extended(Reg reg) { return to_underlying(reg) >= 8; }
+
+    // The REX prefix for an instruction where `reg` goes into ModR/M.reg and `rm` into ModR/M.rm (or the opcode).
+    void emit_rex(bool wide, Reg reg, Reg rm)
+    {
+        emit8(0x40 | (wide ? 0x08 : 0) | (is_extended(reg) ? 0x04 : 0) | (is_extended(rm) ? 0x01 : 0));
+    }
+
+    void emit_rex_if_needed(bool wide, Reg reg, Reg rm)
+    {
+        if (wide || is_extended(reg) || is_extended(rm))
+            emit_rex(wide, reg, rm);
+    }
+
+    void emit_modrm_reg(Reg reg, Reg rm)
+    {
+        emit8(0xc0 | ((to_underlying(reg) & 7) << 3) | (to_underlying(rm) & 7));
+    }
+
+    void emit_modrm_memory(Reg reg, Reg base, i32 displacement)
+    {
+        emit8(0x80 | ((to_underlying(reg) & 7) << 3) | (to_underlying(base) & 7));
+        // NOTE: RSP and R12 can only be used as a base register through a SIB byte.
+        if ((to_underlying(base) & 7) == 4)
+            emit8(0x24);
+        emit32(static_cast<u32>(displacement));
+    }
+
+    void emit_rel32_to(Label& label)
+    {
+        auto displacement_offset = offset();
+        emit32(0);
+        if (label.offset.has_value())
+            patch_rel32(displacement_offset, label.offset.value());
+        else
+            label.pending_jumps.append(displacement_offset);
+    }
+
+    void patch_rel32(size_t displacement_offset, size_t target)
+    {
+        auto displacement = static_cast<i32>(static_cast<i64>(target) - static_cast<i64>(displacement_offset + 4));
+        for (size_t i = 0; i < 4; ++i)
+            m_output[displacement_offset + i] = static_cast<u8>(static_cast<u32>(displacement) >> (i * 8));
+    }
+
+    Vector<u8>& m_output;
+};
+
+}
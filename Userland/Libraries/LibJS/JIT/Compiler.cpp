@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Platform.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::JIT {
+
+#if ARCH(X86_64)
+
+static constexpr Assembler::Reg interpreter_register = Assembler::Reg::RBX;
+static constexpr Assembler::Reg registers_register = Assembler::Reg::R12;
+static constexpr Assembler::Reg accumulator_register = Assembler::Reg::R13;
+
+// These are called from native code, so they have to stick to plain C types in their signatures.
+static u64 run_instruction(Bytecode::Interpreter* interpreter, Bytecode::Instruction const* instruction)
+{
+    return to_underlying(interpreter->run_instruction_for_jit(*instruction));
+}
+
+static u64 value_to_boolean(Value const* value)
+{
+    return value->to_boolean();
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const& executable)
+{
+    Compiler compiler(executable);
+    auto native_executable_or_error = compiler.compile_executable();
+    if (native_executable_or_error.is_error()) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: Could not compile '{}': {}", executable.name, native_executable_or_error.error());
+        return nullptr;
+    }
+    dbgln_if(JS_JIT_DEBUG, "JIT: Compiled '{}' into {} bytes of machine code", executable.name, compiler.m_output.size());
+    return native_executable_or_error.release_value();
+}
+
+Compiler::Compiler(Bytecode::Executable const& executable)
+    : m_executable(executable)
+{
+}
+
+ErrorOr<NonnullOwnPtr<NativeExecutable>> Compiler::compile_executable()
+{
+    TRY(m_block_labels.try_resize(m_executable.basic_blocks.size()));
+    for (size_t i = 0; i < m_executable.basic_blocks.size(); ++i)
+        TRY(m_block_indices.try_set(&m_executable.basic_blocks[i], i));
+
+    compile_entry_and_exit();
+
+    HashMap<Bytecode::BasicBlock const*, size_t> block_offsets;
+    for (auto& block : m_executable.basic_blocks) {
+        TRY(block_offsets.try_set(&block, m_assembler.offset()));
+        if (!compile_block(block))
+            return AK::Error::from_string_literal("Unsupported instruction");
+    }
+
+    return NativeExecutable::create(m_output.span(), 0, move(block_offsets));
+}
+
+void Compiler::compile_entry_and_exit()
+{
+    // u64 entry(Interpreter*, Value* registers, u8 const* block)
+    m_assembler.push(Reg::RBP);
+    m_assembler.mov(Reg::RBP, Reg::RSP);
+    m_assembler.push(interpreter_register);
+    m_assembler.push(registers_register);
+    m_assembler.push(accumulator_register);
+    // NOTE: This keeps the stack pointer 16-byte aligned for the calls that native code makes.
+    m_assembler.adjust_stack_pointer(-8);
+
+    m_assembler.mov(interpreter_register, Reg::RDI);
+    m_assembler.mov(registers_register, Reg::RSI);
+    m_assembler.load(accumulator_register, registers_register, 0);
+    m_assembler.jump(Reg::RDX);
+
+    // The exit reason is in RAX, and the accumulator is expected to have been written back already.
+    m_assembler.bind(m_exit);
+    m_assembler.adjust_stack_pointer(8);
+    m_assembler.pop(accumulator_register);
+    m_assembler.pop(registers_register);
+    m_assembler.pop(interpreter_register);
+    m_assembler.pop(Reg::RBP);
+    m_assembler.ret();
+}
+
+bool Compiler::compile_block(Bytecode::BasicBlock const& block)
+{
+    m_assembler.bind(m_block_labels[m_block_indices.get(&block).value()]);
+
+    Bytecode::InstructionStreamIterator it(block.instruction_stream());
+    while (!it.at_end()) {
+        auto& instruction = *it;
+        if (!compile_instruction(instruction))
+            return false;
+        if (instruction.is_terminator())
+            return true;
+        ++it;
+    }
+
+    exit_with(ExitReason::FellOffEnd);
+    return true;
+}
+
+bool Compiler::compile_instruction(Bytecode::Instruction const& instruction)
+{
+    using Condition = Assembler::Condition;
+
+    switch (instruction.type()) {
+    case Bytecode::Instruction::Type::Load:
+        load_register(accumulator_register, static_cast<Bytecode::Op::Load const&>(instruction).src());
+        return true;
+    case Bytecode::Instruction::Type::LoadImmediate:
+        m_assembler.mov(accumulator_register, static_cast<Bytecode::Op::LoadImmediate const&>(instruction).value().encoded());
+        return true;
+    case Bytecode::Instruction::Type::Store:
+        store_register(static_cast<Bytecode::Op::Store const&>(instruction).dst(), accumulator_register);
+        return true;
+
+    case Bytecode::Instruction::Type::Add:
+        compile_binary_op_with_int32_fast_path(instruction, static_cast<Bytecode::Op::Add const&>(instruction).lhs(), [&](Label& slow_path) {
+            m_assembler.add32(Reg::RAX, accumulator_register);
+            m_assembler.jump_if(Condition::Overflow, slow_path);
+            box_int32(Reg::RAX);
+        });
+        return true;
+    case Bytecode::Instruction::Type::Sub:
+        compile_binary_op_with_int32_fast_path(instruction, static_cast<Bytecode::Op::Sub const&>(instruction).lhs(), [&](Label& slow_path) {
+            m_assembler.sub32(Reg::RAX, accumulator_register);
+            m_assembler.jump_if(Condition::Overflow, slow_path);
+            box_int32(Reg::RAX);
+        });
+        return true;
+    case Bytecode::Instruction::Type::Mul:
+        compile_binary_op_with_int32_fast_path(instruction, static_cast<Bytecode::Op::Mul const&>(instruction).lhs(), [&](Label& slow_path) {
+            m_assembler.mul32(Reg::RAX, accumulator_register);
+            m_assembler.jump_if(Condition::Overflow, slow_path);
+            // NOTE: A zero result might have to be -0, which isn't an int32.
+            m_assembler.test32(Reg::RAX, Reg::RAX);
+            m_assembler.jump_if(Condition::Equal, slow_path);
+            box_int32(Reg::RAX);
+        });
+        return true;
+
+    case Bytecode::Instruction::Type::LessThan:
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::LessThan const&>(instruction).lhs(), Condition::LessThan);
+        return true;
+    case Bytecode::Instruction::Type::LessThanEquals:
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::LessThanEquals const&>(instruction).lhs(), Condition::LessThanOrEqual);
+        return true;
+    case Bytecode::Instruction::Type::GreaterThan:
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::GreaterThan const&>(instruction).lhs(), Condition::GreaterThan);
+        return true;
+    case Bytecode::Instruction::Type::GreaterThanEquals:
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::GreaterThanEquals const&>(instruction).lhs(), Condition::GreaterThanOrEqual);
+        return true;
+    case Bytecode::Instruction::Type::StrictlyEquals:
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::StrictlyEquals const&>(instruction).lhs(), Condition::Equal);
+        return true;
+    case Bytecode::Instruction::Type::StrictlyInequals:
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::StrictlyInequals const&>(instruction).lhs(), Condition::NotEqual);
+        return true;
+    case Bytecode::Instruction::Type::LooselyEquals:
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::LooselyEquals const&>(instruction).lhs(), Condition::Equal);
+        return true;
+    case Bytecode::Instruction::Type::LooselyInequals:
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::LooselyInequals const&>(instruction).lhs(), Condition::NotEqual);
+        return true;
+
+    case Bytecode::Instruction::Type::Increment:
+        compile_increment_or_decrement(instruction, 1);
+        return true;
+    case Bytecode::Instruction::Type::Decrement:
+        compile_increment_or_decrement(instruction, -1);
+        return true;
+
+    case Bytecode::Instruction::Type::Jump:
+    case Bytecode::Instruction::Type::JumpConditional:
+    case Bytecode::Instruction::Type::JumpNullish:
+    case Bytecode::Instruction::Type::JumpUndefined: {
+        auto& jump = static_cast<Bytecode::Op::Jump const&>(instruction);
+        auto* true_target = jump.true_target().has_value() ? label_for(jump.true_target()->block()) : nullptr;
+        if (!true_target)
+            return false;
+        if (instruction.type() == Bytecode::Instruction::Type::Jump) {
+            m_assembler.jump(*true_target);
+            return true;
+        }
+        auto* false_target = jump.false_target().has_value() ? label_for(jump.false_target()->block()) : nullptr;
+        if (!false_target)
+            return false;
+        if (instruction.type() == Bytecode::Instruction::Type::JumpConditional)
+            compile_jump_conditional(*true_target, *false_target);
+        else if (instruction.type() == Bytecode::Instruction::Type::JumpNullish)
+            compile_jump_nullish(*true_target, *false_target);
+        else
+            compile_jump_undefined(*true_target, *false_target);
+        return true;
+    }
+
+    default:
+        // Everything else, including the other terminators, lets the interpreter decide what happens next.
+        call_instruction_implementation(instruction);
+        if (instruction.is_terminator())
+            exit_with(ExitReason::FellOffEnd);
+        return true;
+    }
+}
+
+Assembler::Label* Compiler::label_for(Bytecode::BasicBlock const& block)
+{
+    auto index = m_block_indices.get(&block);
+    if (!index.has_value())
+        return nullptr;
+    return &m_block_labels[index.value()];
+}
+
+void Compiler::load_register(Reg dst, Bytecode::Register reg)
+{
+    if (reg.index() == Bytecode::Register::accumulator_index) {
+        if (dst != accumulator_register)
+            m_assembler.mov(dst, accumulator_register);
+        return;
+    }
+    m_assembler.load(dst, registers_register, reg.index() * sizeof(Value));
+}
+
+void Compiler::store_register(Bytecode::Register reg, Reg src)
+{
+    if (reg.index() == Bytecode::Register::accumulator_index) {
+        if (src != accumulator_register)
+            m_assembler.mov(accumulator_register, src);
+        return;
+    }
+    m_assembler.store(registers_register, reg.index() * sizeof(Value), src);
+}
+
+// Clobbers RCX.
+void Compiler::branch_if_not_int32(Reg value, Label& label)
+{
+    m_assembler.mov(Reg::RCX, value);
+    m_assembler.shift_right(Reg::RCX, TAG_SHIFT);
+    m_assembler.compare32(Reg::RCX, static_cast<u32>(INT32_TAG));
+    m_assembler.jump_if(Assembler::Condition::NotEqual, label);
+}
+
+// Turns a zero-extended 32-bit integer into an int32 Value. Clobbers RCX.
+void Compiler::box_int32(Reg value)
+{
+    m_assembler.mov(Reg::RCX, SHIFTED_INT32_TAG);
+    m_assembler.bitwise_or(value, Reg::RCX);
+}
+
+// Turns a zero-extended 0 or 1 into a boolean Value. Clobbers RCX.
+void Compiler::box_boolean(Reg value)
+{
+    m_assembler.mov(Reg::RCX, BOOLEAN_TAG << TAG_SHIFT);
+    m_assembler.bitwise_or(value, Reg::RCX);
+}
+
+void Compiler::call_instruction_implementation(Bytecode::Instruction const& instruction)
+{
+    m_assembler.store(registers_register, 0, accumulator_register);
+    m_assembler.mov(Reg::RDI, interpreter_register);
+    m_assembler.mov(Reg::RSI, reinterpret_cast<u64>(&instruction));
+    m_assembler.mov(Reg::RAX, reinterpret_cast<u64>(&run_instruction));
+    m_assembler.call(Reg::RAX);
+
+    // Anything other than ExitReason::Continue hands control back to the interpreter.
+    m_assembler.test32(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, m_exit);
+    m_assembler.load(accumulator_register, registers_register, 0);
+}
+
+void Compiler::exit_with(ExitReason reason)
+{
+    m_assembler.store(registers_register, 0, accumulator_register);
+    m_assembler.mov32(Reg::RAX, static_cast<u32>(reason));
+    m_assembler.jump(m_exit);
+}
+
+template<typename EmitOperation>
+void Compiler::compile_binary_op_with_int32_fast_path(Bytecode::Instruction const& instruction, Bytecode::Register lhs, EmitOperation emit_operation)
+{
+    Label slow_path;
+    Label done;
+
+    load_register(Reg::RAX, lhs);
+    branch_if_not_int32(Reg::RAX, slow_path);
+    branch_if_not_int32(accumulator_register, slow_path);
+
+    // With both operands being int32, their lower halves are the actual values.
+    emit_operation(slow_path);
+    m_assembler.mov(accumulator_register, Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.bind(slow_path);
+    call_instruction_implementation(instruction);
+    m_assembler.bind(done);
+}
+
+void Compiler::compile_int32_comparison(Bytecode::Instruction const& instruction, Bytecode::Register lhs, Assembler::Condition condition)
+{
+    compile_binary_op_with_int32_fast_path(instruction, lhs, [&](Label&) {
+        m_assembler.compare32(Reg::RAX, accumulator_register);
+        m_assembler.set_if(condition, Reg::RAX);
+        box_boolean(Reg::RAX);
+    });
+}
+
+void Compiler::compile_increment_or_decrement(Bytecode::Instruction const& instruction, i8 delta)
+{
+    Label slow_path;
+    Label done;
+
+    m_assembler.mov(Reg::RAX, accumulator_register);
+    branch_if_not_int32(Reg::RAX, slow_path);
+    m_assembler.add32(Reg::RAX, delta);
+    m_assembler.jump_if(Assembler::Condition::Overflow, slow_path);
+    box_int32(Reg::RAX);
+    m_assembler.mov(accumulator_register, Reg::RAX);
+    m_assembler.jump(done);
+
+    m_assembler.bind(slow_path);
+    call_instruction_implementation(instruction);
+    m_assembler.bind(done);
+}
+
+void Compiler::compile_jump_conditional(Label& true_target, Label& false_target)
+{
+    Label not_boolean;
+    Label slow_path;
+
+    m_assembler.mov(Reg::RAX, accumulator_register);
+    m_assembler.shift_right(Reg::RAX, TAG_SHIFT);
+
+    m_assembler.compare32(Reg::RAX, static_cast<u32>(BOOLEAN_TAG));
+    m_assembler.jump_if(Assembler::Condition::NotEqual, not_boolean);
+    m_assembler.test32(accumulator_register, 1u);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, true_target);
+    m_assembler.jump(false_target);
+
+    m_assembler.bind(not_boolean);
+    m_assembler.compare32(Reg::RAX, static_cast<u32>(INT32_TAG));
+    m_assembler.jump_if(Assembler::Condition::NotEqual, slow_path);
+    m_assembler.test32(accumulator_register, accumulator_register);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, true_target);
+    m_assembler.jump(false_target);
+
+    // NOTE: ToBoolean can't throw or run any code, so there's no need to involve the interpreter here.
+    m_assembler.bind(slow_path);
+    m_assembler.store(registers_register, 0, accumulator_register);
+    m_assembler.mov(Reg::RDI, registers_register);
+    m_assembler.mov(Reg::RAX, reinterpret_cast<u64>(&value_to_boolean));
+    m_assembler.call(Reg::RAX);
+    m_assembler.test32(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqual, true_target);
+    m_assembler.jump(false_target);
+}
+
+void Compiler::compile_jump_nullish(Label& true_target, Label& false_target)
+{
+    m_assembler.mov(Reg::RAX, accumulator_register);
+    m_assembler.shift_right(Reg::RAX, TAG_SHIFT);
+    m_assembler.and32(Reg::RAX, static_cast<u32>(IS_NULLISH_EXTRACT_PATTERN));
+    m_assembler.compare32(Reg::RAX, static_cast<u32>(IS_NULLISH_PATTERN));
+    m_assembler.jump_if(Assembler::Condition::Equal, true_target);
+    m_assembler.jump(false_target);
+}
+
+void Compiler::compile_jump_undefined(Label& true_target, Label& false_target)
+{
+    m_assembler.mov(Reg::RAX, accumulator_register);
+    m_assembler.shift_right(Reg::RAX, TAG_SHIFT);
+    m_assembler.compare32(Reg::RAX, static_cast<u32>(UNDEFINED_TAG));
+    m_assembler.jump_if(Assembler::Condition::Equal, true_target);
+    m_assembler.jump(false_target);
+}
+
+#else
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const&)
+{
+    return nullptr;
+}
+
+#endif
+
+}
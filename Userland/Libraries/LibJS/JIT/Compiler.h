@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Register.h>
+#include <LibJS/Forward.h>
+#include <LibJS/JIT/Assembler.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+// A baseline JIT that translates each basic block of an executable into x86_64 machine code.
+// Most instructions are compiled into a call to the instruction's regular implementation, which saves the
+// dispatch overhead of the interpreter. Loads, stores, jumps and int32 arithmetic and comparisons get
+// inline fast paths, and only fall back to that call for operands that aren't int32.
+//
+// While native code runs, RBX holds the interpreter, R12 points at the register file and R13 holds the
+// accumulator. The accumulator in the register file is only kept up to date across calls out of native code.
+class Compiler {
+public:
+    // Returns null if the executable can't be compiled, in which case the interpreter should just run it.
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable const&);
+
+private:
+    using Reg = Assembler::Reg;
+    using Label = Assembler::Label;
+
+    explicit Compiler(Bytecode::Executable const&);
+
+    ErrorOr<NonnullOwnPtr<NativeExecutable>> compile_executable();
+    bool compile_block(Bytecode::BasicBlock const&);
+    bool compile_instruction(Bytecode::Instruction const&);
+
+    void compile_entry_and_exit();
+    void compile_jump_conditional(Label& true_target, Label& false_target);
+    void compile_jump_nullish(Label& true_target, Label& false_target);
+    void compile_jump_undefined(Label& true_target, Label& false_target);
+    void compile_increment_or_decrement(Bytecode::Instruction const&, i8 delta);
+
+    template<typename EmitOperation>
+    void compile_binary_op_with_int32_fast_path(Bytecode::Instruction const&, Bytecode::Register lhs, EmitOperation);
+    void compile_int32_comparison(Bytecode::Instruction const&, Bytecode::Register lhs, Assembler::Condition);
+
+    void load_register(Reg dst, Bytecode::Register);
+    void store_register(Bytecode::Register, Reg src);
+    void branch_if_not_int32(Reg value, Label&);
+    void box_int32(Reg value);
+    void box_boolean(Reg value);
+    void call_instruction_implementation(Bytecode::Instruction const&);
+    void exit_with(ExitReason);
+
+    Label* label_for(Bytecode::BasicBlock const&);
+
+    Bytecode::Executable const& m_executable;
+    Vector<u8> m_output;
+    Assembler m_assembler { m_output };
+
+    Label m_exit;
+    Vector<Label> m_block_labels;
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_indices;
+};
+
+}
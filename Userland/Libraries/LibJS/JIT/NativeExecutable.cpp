@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/OwnPtr.h>
+#include <AK/StdLibExtras.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(AK_OS_SERENITY)
+#    include <serenity.h>
+#endif
+
+namespace JS::JIT {
+
+// NOTE: The code is never writable and executable at the same time. On Serenity, memory that has ever been
+//       writable can't become executable, so the code is written through one mapping of an anonymous file,
+//       and executed through another one.
+static ErrorOr<u8*> map_executable_code(ReadonlyBytes code, size_t mapping_size)
+{
+#if defined(AK_OS_SERENITY)
+    int fd = anon_create(mapping_size, O_CLOEXEC);
+    if (fd < 0)
+        return AK::Error::from_syscall("anon_create"sv, -errno);
+
+    auto* writable = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (writable == MAP_FAILED) {
+        auto saved_errno = errno;
+        (void)close(fd);
+        return AK::Error::from_syscall("mmap"sv, -saved_errno);
+    }
+    memcpy(writable, code.data(), code.size());
+    (void)munmap(writable, mapping_size);
+
+    auto* executable = mmap(nullptr, mapping_size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+    auto saved_errno = errno;
+    (void)close(fd);
+    if (executable == MAP_FAILED)
+        return AK::Error::from_syscall("mmap"sv, -saved_errno);
+    return static_cast<u8*>(executable);
+#else
+    auto* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+        return AK::Error::from_syscall("mmap"sv, -errno);
+    memcpy(mapping, code.data(), code.size());
+    if (mprotect(mapping, mapping_size, PROT_READ | PROT_EXEC) < 0) {
+        auto saved_errno = errno;
+        (void)munmap(mapping, mapping_size);
+        return AK::Error::from_syscall("mprotect"sv, -saved_errno);
+    }
+    return static_cast<u8*>(mapping);
+#endif
+}
+
+ErrorOr<NonnullOwnPtr<NativeExecutable>> NativeExecutable::create(ReadonlyBytes code, size_t entry_offset, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets)
+{
+    auto mapping_size = round_up_to_power_of_two(code.size(), static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+    auto* mapping = TRY(map_executable_code(code, mapping_size));
+    return adopt_nonnull_own_or_enomem(new (nothrow) NativeExecutable(mapping, mapping_size, entry_offset, move(block_offsets)));
+}
+
+NativeExecutable::NativeExecutable(u8* code, size_t mapping_size, size_t entry_offset, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets)
+    : m_code(code)
+    , m_mapping_size(mapping_size)
+    , m_entry_offset(entry_offset)
+    , m_block_offsets(move(block_offsets))
+{
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    (void)munmap(m_code, m_mapping_size);
+}
+
+ExitReason NativeExecutable::run(Bytecode::Interpreter& interpreter, Value* registers, Bytecode::BasicBlock const& block) const
+{
+    using EntryPoint = u64 (*)(Bytecode::Interpreter*, Value*, u8 const*);
+    auto entry_point = reinterpret_cast<EntryPoint>(m_code + m_entry_offset);
+    auto block_offset = m_block_offsets.get(&block);
+    VERIFY(block_offset.has_value());
+    auto exit_reason = static_cast<ExitReason>(entry_point(&interpreter, registers, m_code + block_offset.value()));
+    VERIFY(exit_reason != ExitReason::Continue);
+    return exit_reason;
+}
+
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+// Why native code handed control back to the interpreter.
+enum class ExitReason : u64 {
+    // Only used by the helpers called from native code, it never leaves NativeExecutable::run().
+    Continue = 0,
+    // Execution should continue at the interpreter's current block.
+    Jump,
+    Return,
+    Exception,
+    // The block ended without a terminator, which ends the executable just like returning would.
+    FellOffEnd,
+};
+
+// The machine code the JIT compiled for an executable, with an entry point for each of its basic blocks.
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    static ErrorOr<NonnullOwnPtr<NativeExecutable>> create(ReadonlyBytes code, size_t entry_offset, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets);
+    ~NativeExecutable();
+
+    ExitReason run(Bytecode::Interpreter&, Value* registers, Bytecode::BasicBlock const&) const;
+
+private:
+    NativeExecutable(u8* code, size_t mapping_size, size_t entry_offset, HashMap<Bytecode::BasicBlock const*, size_t> block_offsets);
+
+    u8* m_code { nullptr };
+    size_t m_mapping_size { 0 };
+    size_t m_entry_offset { 0 };
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_offsets;
+};
+
+}
@@ -2561,6 +2561,11 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
         : push_start();
     VERIFY(!(parse_options & FunctionNodeParseOptions::IsGetterFunction && parse_options & FunctionNodeParseOptions::IsSetterFunction));
 
+    // NOTE: Function declarations are hoisted and often never called, so we don't keep the AST of their bodies around
+    //       until they are. Expressions tend to be called right away, so parsing them twice wouldn't pay off.
+    auto const can_parse_lazily = IsSame<FunctionNodeType, FunctionDeclaration> && parse_options == FunctionNodeParseOptions::CheckForFunctionAndName;
+    auto const outer_strict_mode = m_state.strict_mode;
+
     TemporaryChange super_property_access_rollback(m_state.allow_super_property_lookup, !!(parse_options & FunctionNodeParseOptions::AllowSuperPropertyLookup));
     TemporaryChange super_constructor_call_rollback(m_state.allow_super_constructor_call, !!(parse_options & FunctionNodeParseOptions::AllowSuperConstructorCall));
     TemporaryChange break_context_rollback(m_state.in_break_context, false);
@@ -2639,6 +2644,22 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
     auto source_text = String { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+
+    // The whole body has been parsed at this point, so every early error has been reported already.
+    if (can_parse_lazily && !has_errors()) {
+        auto lazy_body = create_ast_node<FunctionBody>(body->source_range());
+        if (has_strict_directive)
+            lazy_body->set_strict_mode();
+        lazy_body->set_lazy_parse_info(make<FunctionBody::LazyParseInfo>(FunctionBody::LazyParseInfo {
+            .function_source_text = source_text,
+            .filename = m_state.current_token.filename(),
+            .function_start = rule_start.position(),
+            .in_strict_mode = outer_strict_mode,
+            .in_module = m_program_type == Program::Type::Module,
+        }));
+        body = move(lazy_body);
+    }
+
     return create_ast_node<FunctionNodeType>(
         { m_state.current_token.filename(), rule_start.position(), position() },
         name, move(source_text), move(body), move(parameters), function_length,
@@ -2646,6 +2667,25 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
         contains_direct_call_to_eval);
 }
 
+NonnullRefPtr<FunctionDeclaration> Parser::parse_lazy_function(FunctionBody::LazyParseInfo const& info)
+{
+    auto const& start = info.function_start;
+    Parser parser(Lexer(info.function_source_text, info.filename, start.line, start.column - 1), info.in_module ? Program::Type::Module : Program::Type::Script);
+    parser.m_state.strict_mode = info.in_strict_mode;
+
+    // Private names have already been checked against the enclosing classes during the first parse.
+    HashTable<StringView> referenced_private_names;
+    parser.m_state.referenced_private_names = &referenced_private_names;
+
+    // Some constructs (e.g. class fields in parameter initializers) expect an enclosing scope.
+    auto program = adopt_ref(*new Program({ info.filename, start, start }, info.in_module ? Program::Type::Module : Program::Type::Script));
+    ScopePusher program_scope = ScopePusher::program_scope(parser, *program);
+
+    auto function = parser.parse_function_node<FunctionDeclaration>(FunctionNodeParseOptions::CheckForFunctionAndName | FunctionNodeParseOptions::IsBeingParsedLazily);
+    VERIFY(!parser.has_errors());
+    return function;
+}
+
 Vector<FunctionNode::Parameter> Parser::parse_formal_parameters(int& function_length, u16 parse_options)
 {
     auto rule_start = push_start();
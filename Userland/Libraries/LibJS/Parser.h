@@ -37,6 +37,7 @@ struct FunctionNodeParseOptions {
         IsGeneratorFunction = 1 << 6,
         IsAsyncFunction = 1 << 7,
         HasDefaultExportName = 1 << 8,
+        IsBeingParsedLazily = 1 << 9,
     };
 };
 
@@ -59,6 +60,9 @@ public:
     NonnullRefPtr<FunctionNodeType> parse_function_node(u16 parse_options = FunctionNodeParseOptions::CheckForFunctionAndName, Optional<Position> const& function_start = {});
     Vector<FunctionNode::Parameter> parse_formal_parameters(int& function_length, u16 parse_options = 0);
 
+    // Parses a function declaration that was only pre-parsed before, see FunctionBody::ensure_parsed().
+    static NonnullRefPtr<FunctionDeclaration> parse_lazy_function(FunctionBody::LazyParseInfo const&);
+
     enum class AllowDuplicates {
         Yes,
         No
@@ -215,6 +215,16 @@ ThrowCompletionOr<MarkedVector<Value>> sort_indexed_properties(VM& vm, Object co
     // 1. Let items be a new empty List.
     auto items = MarkedVector<Value> { vm.heap() };
 
+    // NOTE: A packed Array has all of its elements as own data properties, so HasProperty and Get can't have any side effects.
+    if (is<Array>(object) && object.indexed_properties().is_packed() && length <= object.indexed_properties().array_like_size()) {
+        auto elements = object.indexed_properties().packed_elements();
+        items.ensure_capacity(length);
+        for (size_t k = 0; k < length; ++k)
+            items.append(elements[k]);
+        TRY(array_merge_sort(vm, sort_compare, items));
+        return items;
+    }
+
     // 2. Let k be 0.
     // 3. Repeat, while k < len,
     for (size_t k = 0; k < length; ++k) {
@@ -30,6 +30,11 @@ ArrayBuffer* ArrayBuffer::create(Realm& realm, ByteBuffer* buffer)
     return realm.heap().allocate<ArrayBuffer>(realm, buffer, *realm.intrinsics().array_buffer_prototype());
 }
 
+ArrayBuffer* ArrayBuffer::create(Realm& realm, Function<Bytes()> external_bytes)
+{
+    return realm.heap().allocate<ArrayBuffer>(realm, move(external_bytes), *realm.intrinsics().array_buffer_prototype());
+}
+
 ArrayBuffer::ArrayBuffer(ByteBuffer buffer, Object& prototype)
     : Object(prototype)
     , m_buffer(move(buffer))
@@ -44,6 +49,22 @@ ArrayBuffer::ArrayBuffer(ByteBuffer* buffer, Object& prototype)
 {
 }
 
+ArrayBuffer::ArrayBuffer(Function<Bytes()> external_bytes, Object& prototype)
+    : Object(prototype)
+    , m_buffer(move(external_bytes))
+    , m_detach_key(js_undefined())
+{
+}
+
+Bytes ArrayBuffer::bytes()
+{
+    return m_buffer.visit(
+        [](Empty) -> Bytes { VERIFY_NOT_REACHED(); },
+        [](ByteBuffer* buffer) { return buffer->bytes(); },
+        [](ByteBuffer& buffer) { return buffer.bytes(); },
+        [](Function<Bytes()>& external_bytes) { return external_bytes(); });
+}
+
 void ArrayBuffer::visit_edges(Cell::Visitor& visitor)
 {
     Base::visit_edges(visitor);
@@ -104,14 +125,14 @@ ThrowCompletionOr<ArrayBuffer*> clone_array_buffer(VM& vm, ArrayBuffer& source_b
     auto* target_buffer = TRY(allocate_array_buffer(vm, *realm.intrinsics().array_buffer_constructor(), source_length));
 
     // 3. Let srcBlock be srcBuffer.[[ArrayBufferData]].
-    auto& source_block = source_buffer.buffer();
+    auto source_block = source_buffer.bytes();
 
     // 4. Let targetBlock be targetBuffer.[[ArrayBufferData]].
-    auto& target_block = target_buffer->buffer();
+    auto target_block = target_buffer->bytes();
 
     // 5. Perform CopyDataBlockBytes(targetBlock, 0, srcBlock, srcByteOffset, srcLength).
     // FIXME: This is only correct for ArrayBuffers, once SharedArrayBuffer is implemented, the AO has to be implemented
-    target_block.overwrite(0, source_block.offset_pointer(source_byte_offset), source_length);
+    source_block.slice(source_byte_offset, source_length).copy_to(target_block);
 
     // 6. Return targetBuffer.
     return target_buffer;
@@ -28,13 +28,21 @@ public:
     static ThrowCompletionOr<ArrayBuffer*> create(Realm&, size_t);
     static ArrayBuffer* create(Realm&, ByteBuffer);
     static ArrayBuffer* create(Realm&, ByteBuffer*);
+    // For data that's owned by someone else, and that may change size (like a WebAssembly memory does when it grows),
+    // so it's asked for the bytes again whenever they're accessed.
+    static ArrayBuffer* create(Realm&, Function<Bytes()> external_bytes);
 
     virtual ~ArrayBuffer() override = default;
 
-    size_t byte_length() const { return buffer_impl().size(); }
+    size_t byte_length() const { return bytes().size(); }
+
+    // NOTE: Only ArrayBuffers that don't view external bytes have a ByteBuffer, use bytes() to access any of them.
     ByteBuffer& buffer() { return buffer_impl(); }
     ByteBuffer const& buffer() const { return buffer_impl(); }
 
+    Bytes bytes();
+    ReadonlyBytes bytes() const { return const_cast<ArrayBuffer*>(this)->bytes(); }
+
     // Used by allocate_array_buffer() to attach the data block after construction
     void set_buffer(ByteBuffer buffer) { m_buffer = move(buffer); }
 
@@ -58,19 +66,24 @@ public:
 private:
     ArrayBuffer(ByteBuffer buffer, Object& prototype);
     ArrayBuffer(ByteBuffer* buffer, Object& prototype);
+    ArrayBuffer(Function<Bytes()> external_bytes, Object& prototype);
 
     virtual void visit_edges(Visitor&) override;
 
     ByteBuffer& buffer_impl()
     {
         ByteBuffer* ptr { nullptr };
-        m_buffer.visit([&](Empty) { VERIFY_NOT_REACHED(); }, [&](auto* pointer) { ptr = pointer; }, [&](auto& value) { ptr = &value; });
+        m_buffer.visit(
+            [&](Empty) { VERIFY_NOT_REACHED(); },
+            [&](ByteBuffer* pointer) { ptr = pointer; },
+            [&](ByteBuffer& value) { ptr = &value; },
+            [&](Function<Bytes()>&) { VERIFY_NOT_REACHED(); });
         return *ptr;
     }
 
     ByteBuffer const& buffer_impl() const { return const_cast<ArrayBuffer*>(this)->buffer_impl(); }
 
-    Variant<Empty, ByteBuffer, ByteBuffer*> m_buffer;
+    Variant<Empty, ByteBuffer, ByteBuffer*, Function<Bytes()>> m_buffer;
     // The various detach related members of ArrayBuffer are not used by any ECMA262 functionality,
     // but are required to be available for the use of various harnesses like the Test262 test runner.
     Value m_detach_key;
@@ -132,7 +145,7 @@ Value ArrayBuffer::get_value(size_t byte_index, [[maybe_unused]] bool is_typed_a
     // FIXME: Check for shared buffer
 
     // FIXME: Propagate errors.
-    auto raw_value = MUST(buffer_impl().slice(byte_index, element_size));
+    auto raw_value = MUST(ByteBuffer::copy(bytes().slice(byte_index, element_size)));
     return raw_bytes_to_numeric<T>(vm, move(raw_value), is_little_endian);
 }
 
@@ -211,7 +224,7 @@ void ArrayBuffer::set_value(size_t byte_index, Value value, [[maybe_unused]] boo
 
     // FIXME: Check for shared buffer
 
-    raw_bytes.span().copy_to(buffer_impl().span().slice(byte_index));
+    raw_bytes.span().copy_to(bytes().slice(byte_index));
 }
 
 // 25.1.2.13 GetModifySetValueInBuffer ( arrayBuffer, byteIndex, type, value, op [ , isLittleEndian ] ), https://tc39.es/ecma262/#sec-getmodifysetvalueinbuffer
@@ -225,9 +238,9 @@ Value ArrayBuffer::get_modify_set_value(size_t byte_index, Value value, ReadWrit
     // FIXME: Check for shared buffer
 
     // FIXME: Propagate errors.
-    auto raw_bytes_read = MUST(buffer_impl().slice(byte_index, sizeof(T)));
+    auto raw_bytes_read = MUST(ByteBuffer::copy(bytes().slice(byte_index, sizeof(T))));
     auto raw_bytes_modified = operation(raw_bytes_read, raw_bytes);
-    raw_bytes_modified.span().copy_to(buffer_impl().span().slice(byte_index));
+    raw_bytes_modified.span().copy_to(bytes().slice(byte_index));
 
     return raw_bytes_to_numeric<T>(vm, raw_bytes_read, is_little_endian);
 }
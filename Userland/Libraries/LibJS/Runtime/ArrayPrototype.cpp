@@ -9,6 +9,7 @@
 
 #include <AK/Function.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -148,6 +149,72 @@ static ThrowCompletionOr<Object*> array_species_create(VM& vm, Object& original_
     return TRY(construct(vm, constructor.as_function(), Value(length)));
 }
 
+// NOTE: An Array without holes has all of its elements as own data properties, so HasProperty and Get can't have
+//       any side effects for them, and we can read them from the storage directly.
+static Optional<Value> packed_element_at(Object const& object, size_t index)
+{
+    if (!is<Array>(object))
+        return {};
+    auto const& indexed_properties = object.indexed_properties();
+    if (!indexed_properties.is_packed() || index >= indexed_properties.array_like_size())
+        return {};
+    return indexed_properties.packed_elements()[index];
+}
+
+// NOTE: Setting a new index of an Array can only be observed through a setter on its prototype chain, or fail if the
+//       Array isn't extensible or its length isn't writable. If none of that can happen, we may append directly.
+static bool can_append_directly(VM& vm, Object& object)
+{
+    if (!is<Array>(object) || !static_cast<Array&>(object).length_is_writable() || !MUST(object.is_extensible()))
+        return false;
+    auto& intrinsics = vm.current_realm()->intrinsics();
+    auto const* array_prototype = intrinsics.array_prototype();
+    auto const* object_prototype = intrinsics.object_prototype();
+    return object.shape().prototype() == array_prototype
+        && array_prototype->indexed_properties().is_empty()
+        && array_prototype->shape().prototype() == object_prototype
+        && object_prototype->indexed_properties().is_empty();
+}
+
+// NOTE: The default comparison orders numbers by their string representation. Converting a number to a string can't have
+//       side effects, so for an Array of numbers without holes we do that once for every element, instead of twice for
+//       every comparison.
+static Optional<MarkedVector<Value>> sort_packed_numbers_by_default_comparison(VM& vm, Object const& object, size_t length)
+{
+    if (!is<Array>(object))
+        return {};
+    auto const& indexed_properties = object.indexed_properties();
+    auto elements_kind = indexed_properties.elements_kind();
+    if (elements_kind != ElementsKind::PackedInt32 && elements_kind != ElementsKind::PackedNumber)
+        return {};
+    auto elements = indexed_properties.packed_elements();
+    if (elements.size() != length)
+        return {};
+
+    Vector<String> strings;
+    Vector<size_t> order;
+    strings.ensure_capacity(length);
+    order.ensure_capacity(length);
+    for (size_t i = 0; i < length; ++i) {
+        strings.unchecked_append(MUST(elements[i].to_string(vm)));
+        order.unchecked_append(i);
+    }
+
+    // The strings are all ASCII, so comparing their bytes is the same as comparing their code units.
+    // Ties are broken by the original position, as the sort has to be stable.
+    quick_sort(order, [&](size_t a, size_t b) {
+        if (auto result = strings[a].view().compare(strings[b].view()); result != 0)
+            return result < 0;
+        return a < b;
+    });
+
+    MarkedVector<Value> items { vm.heap() };
+    items.ensure_capacity(length);
+    for (auto index : order)
+        items.append(elements[index]);
+    return items;
+}
+
 // 23.1.3.1 Array.prototype.at ( index ), https://tc39.es/ecma262/#sec-array.prototype.at
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::at)
 {
@@ -703,13 +770,16 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::for_each)
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
+        // NOTE: The callback may change the array, so we have to check whether it's still packed every time.
+        auto packed_element = packed_element_at(*object, k);
+
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
+        auto k_present = packed_element.has_value() || TRY(object->has_property(property_key));
 
         // c. If kPresent is true, then
         if (k_present) {
             // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
+            auto k_value = packed_element.has_value() ? packed_element.value() : TRY(object->get(property_key));
 
             // ii. Perform ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
             TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
@@ -955,6 +1025,16 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    // NOTE: Nothing in the loop below can have side effects for a packed Array, so we may just look at its elements.
+    if (is<Array>(*object) && object->indexed_properties().is_packed() && length <= object->indexed_properties().array_like_size()) {
+        auto elements = object->indexed_properties().packed_elements();
+        for (; k < length; ++k) {
+            if (is_strictly_equal(search_element, elements[k]))
+                return Value(k);
+        }
+        return Value(-1);
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -1118,13 +1198,16 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
+        // NOTE: The callback may change the array, so we have to check whether it's still packed every time.
+        auto packed_element = packed_element_at(*object, k);
+
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
+        auto k_present = packed_element.has_value() || TRY(object->has_property(property_key));
 
         // c. If kPresent is true, then
         if (k_present) {
             // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
+            auto k_value = packed_element.has_value() ? packed_element.value() : TRY(object->get(property_key));
 
             // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
             auto mapped_value = TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
@@ -1165,6 +1248,11 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::push)
     auto new_length = length + argument_count;
     if (new_length > MAX_ARRAY_LIKE_INDEX)
         return vm.throw_completion<TypeError>(ErrorType::ArrayMaxSize);
+    if (can_append_directly(vm, *this_object)) {
+        for (size_t i = 0; i < argument_count; ++i)
+            this_object->indexed_properties().append(vm.argument(i));
+        return Value(new_length);
+    }
     for (size_t i = 0; i < argument_count; ++i)
         TRY(this_object->set(length + i, vm.argument(i), Object::ShouldThrowExceptions::Yes));
     auto new_length_value = Value(new_length);
@@ -1577,7 +1665,8 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     };
 
     // 6. Let sortedList be ? SortIndexedProperties(obj, len, SortCompare, true).
-    auto sorted_list = TRY(sort_indexed_properties(vm, *object, length, sort_compare, true));
+    auto packed_sorted_list = comparefn.is_undefined() ? sort_packed_numbers_by_default_comparison(vm, *object, length) : Optional<MarkedVector<Value>> {};
+    auto sorted_list = packed_sorted_list.has_value() ? packed_sorted_list.release_value() : TRY(sort_indexed_properties(vm, *object, length, sort_compare, true));
 
     // 7. Let itemCount be the number of elements in sortedList.
     auto item_count = sorted_list.size();
@@ -1809,7 +1898,8 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::to_sorted)
     };
 
     // 6. Let sortedList be ? SortIndexedProperties(obj, len, SortCompare, false).
-    auto sorted_list = TRY(sort_indexed_properties(vm, *object, length, sort_compare, false));
+    auto packed_sorted_list = comparefn.is_undefined() ? sort_packed_numbers_by_default_comparison(vm, *object, length) : Optional<MarkedVector<Value>> {};
+    auto sorted_list = packed_sorted_list.has_value() ? packed_sorted_list.release_value() : TRY(sort_indexed_properties(vm, *object, length, sort_compare, false));
 
     // 7. Let j be 0.
     // 8. Repeat, while j < len,
@@ -189,7 +189,7 @@ static ThrowCompletionOr<Value> atomic_compare_exchange_impl(VM& vm, TypedArrayB
     auto* buffer = TRY(validate_integer_typed_array(vm, typed_array));
 
     // 2. Let block be buffer.[[ArrayBufferData]].
-    auto& block = buffer->buffer();
+    // NOTE: The bytes are only looked up below, as the steps in between might run code that resizes them.
 
     // 3. Let indexedPosition be ? ValidateAtomicAccess(typedArray, index).
     auto indexed_position = TRY(validate_atomic_access(vm, typed_array, vm.argument(1)));
@@ -237,9 +237,11 @@ static ThrowCompletionOr<Value> atomic_compare_exchange_impl(VM& vm, TypedArrayB
     //     a-i.
     // 14. Else,
 
+    auto block = buffer->bytes();
+
     // a. Let rawBytesRead be a List of length elementSize whose elements are the sequence of elementSize bytes starting with block[indexedPosition].
     // FIXME: Propagate errors.
-    auto raw_bytes_read = MUST(block.slice(indexed_position, sizeof(T)));
+    auto raw_bytes_read = MUST(ByteBuffer::copy(block.slice(indexed_position, sizeof(T))));
 
     // b. If ByteListEqual(rawBytesRead, expectedBytes) is true, then
     //    i. Store the individual bytes of replacementBytes into block, starting at block[indexedPosition].
@@ -248,7 +250,7 @@ static ThrowCompletionOr<Value> atomic_compare_exchange_impl(VM& vm, TypedArrayB
     } else {
         using U = Conditional<IsSame<ClampedU8, T>, u8, T>;
 
-        auto* v = reinterpret_cast<U*>(block.span().slice(indexed_position).data());
+        auto* v = reinterpret_cast<U*>(block.slice(indexed_position).data());
         auto* e = reinterpret_cast<U*>(expected_bytes.data());
         auto* r = reinterpret_cast<U*>(replacement_bytes.data());
         (void)AK::atomic_compare_exchange_strong(v, *e, *r);
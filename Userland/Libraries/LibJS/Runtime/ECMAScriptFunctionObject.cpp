@@ -9,6 +9,7 @@
 #include <AK/Function.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/CodeCache.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Interpreter.h>
@@ -791,6 +792,9 @@ Completion ECMAScriptFunctionObject::ordinary_call_evaluate_body()
     if (m_kind == FunctionKind::AsyncGenerator)
         return vm.throw_completion<InternalError>(ErrorType::NotImplemented, "Async Generator function execution");
 
+    if (is<FunctionBody>(*m_ecmascript_code))
+        static_cast<FunctionBody const&>(*m_ecmascript_code).ensure_parsed();
+
     if (bytecode_interpreter) {
         if (!m_bytecode_executable) {
             auto compile = [&](auto& node, auto kind, auto name) -> ThrowCompletionOr<NonnullOwnPtr<Bytecode::Executable>> {
@@ -812,7 +816,20 @@ Completion ECMAScriptFunctionObject::ordinary_call_evaluate_body()
                 return bytecode_executable;
             };
 
-            m_bytecode_executable = TRY(compile(*m_ecmascript_code, m_kind, m_name));
+            // NOTE: Class constructors and field initializers share the source text of their class, so that doesn't
+            //       tell them apart. Everything else compiles to the same bytecode whenever the source text is the same.
+            auto& code_cache = Bytecode::CodeCache::the();
+            bool can_use_code_cache = !m_is_class_constructor && m_class_field_initializer_name.has<Empty>();
+            if (can_use_code_cache)
+                m_bytecode_executable = code_cache.load(m_source_text, m_kind, m_strict);
+
+            if (m_bytecode_executable) {
+                m_bytecode_executable->name = m_name;
+            } else {
+                m_bytecode_executable = TRY(compile(*m_ecmascript_code, m_kind, m_name));
+                if (can_use_code_cache)
+                    code_cache.store(m_source_text, m_kind, m_strict, *m_bytecode_executable);
+            }
 
             size_t default_parameter_index = 0;
             for (auto& parameter : m_formal_parameters) {
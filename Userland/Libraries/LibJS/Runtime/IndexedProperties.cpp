@@ -13,10 +13,28 @@ namespace JS {
 constexpr const size_t SPARSE_ARRAY_HOLE_THRESHOLD = 200;
 constexpr const size_t LENGTH_SETTER_GENERIC_STORAGE_THRESHOLD = 4 * MiB;
 
+static ElementsKind elements_kind_of(Value value)
+{
+    if (value.is_empty())
+        return ElementsKind::Holey;
+    if ((value.encoded() >> TAG_SHIFT) == INT32_TAG)
+        return ElementsKind::PackedInt32;
+    if (value.is_number())
+        return ElementsKind::PackedNumber;
+    return ElementsKind::Packed;
+}
+
 SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initial_values)
     : m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto value : m_packed_elements)
+        update_elements_kind(value);
+}
+
+void SimpleIndexedPropertyStorage::update_elements_kind(Value value)
+{
+    m_elements_kind = max(m_elements_kind, elements_kind_of(value));
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -49,16 +67,21 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        // Everything between the old end of the array and the new element is a hole.
+        if (index > m_array_size)
+            m_elements_kind = ElementsKind::Holey;
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
     m_packed_elements[index] = value;
+    update_elements_kind(value);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
     m_packed_elements[index] = {};
+    m_elements_kind = ElementsKind::Holey;
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
@@ -77,6 +100,8 @@ ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size > m_array_size)
+        m_elements_kind = ElementsKind::Holey;
     m_array_size = new_size;
     m_packed_elements.resize_and_keep_capacity(new_size);
     return true;
@@ -297,6 +322,24 @@ Vector<u32> IndexedProperties::indices() const
     return indices;
 }
 
+ElementsKind IndexedProperties::elements_kind() const
+{
+    if (!m_storage)
+        return ElementsKind::PackedInt32;
+    if (!m_storage->is_simple_storage())
+        return ElementsKind::Holey;
+    return static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).elements_kind();
+}
+
+Span<Value const> IndexedProperties::packed_elements() const
+{
+    VERIFY(is_packed());
+    if (!m_storage)
+        return {};
+    // The storage may have grown beyond the array-like size, the elements past it are all empty.
+    return static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).elements().span().trim(array_like_size());
+}
+
 void IndexedProperties::switch_to_generic_storage()
 {
     if (!m_storage) {
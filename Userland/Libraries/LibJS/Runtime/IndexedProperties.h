@@ -19,6 +19,20 @@ struct ValueAndAttributes {
 
 class IndexedProperties;
 class IndexedPropertyIterator;
+
+// What we know about the values in a SimpleIndexedPropertyStorage. An array only ever moves down this list,
+// so code that checked the kind once can rely on the elements being at least that well-behaved until it
+// gives control back to arbitrary user code.
+enum class ElementsKind : u8 {
+    // No holes, and every element is a number that's stored as an i32.
+    PackedInt32,
+    // No holes, and every element is a number.
+    PackedNumber,
+    // No holes, but the elements can be anything.
+    Packed,
+    // There may be holes.
+    Holey,
+};
 class GenericIndexedPropertyStorage;
 
 class IndexedPropertyStorage {
@@ -60,13 +74,18 @@ public:
     virtual bool is_simple_storage() const override { return true; }
     Vector<Value> const& elements() const { return m_packed_elements; }
 
+    ElementsKind elements_kind() const { return m_elements_kind; }
+    bool is_packed() const { return m_elements_kind != ElementsKind::Holey; }
+
 private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
+    void update_elements_kind(Value);
 
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+    ElementsKind m_elements_kind { ElementsKind::PackedInt32 };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
@@ -140,6 +159,13 @@ public:
 
     Vector<u32> indices() const;
 
+    // Generic storage is always considered holey, an object without indexed properties is trivially packed.
+    ElementsKind elements_kind() const;
+    bool is_packed() const { return elements_kind() != ElementsKind::Holey; }
+
+    // The elements of packed storage can be read directly, since none of them is missing from the object.
+    Span<Value const> packed_elements() const;
+
     template<typename Callback>
     void for_each_value(Callback callback)
     {
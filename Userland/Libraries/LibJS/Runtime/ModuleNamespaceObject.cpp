@@ -20,6 +20,7 @@ ModuleNamespaceObject::ModuleNamespaceObject(Realm& realm, Module* module, Vecto
     quick_sort(m_exports, [&](FlyString const& lhs, FlyString const& rhs) {
         return lhs.view() < rhs.view();
     });
+    set_has_exotic_property_access();
 }
 
 void ModuleNamespaceObject::initialize(Realm& realm)
@@ -168,9 +168,15 @@ public:
     bool has_parameter_map() const { return m_has_parameter_map; }
     void set_has_parameter_map() { m_has_parameter_map = true; }
 
+    // Set by exotic objects that don't simply look at their own storage for every property key in [[Get]] and [[Set]],
+    // so that the bytecode interpreter's property lookup caches always go through the regular lookup for them.
+    bool has_exotic_property_access() const { return m_has_exotic_property_access; }
+    void set_has_exotic_property_access() { m_has_exotic_property_access = true; }
+
     virtual void visit_edges(Cell::Visitor&) override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
+    void put_direct(size_t index, Value value) { m_storage[index] = value; }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
@@ -201,6 +207,7 @@ protected:
 
     // [[ParameterMap]]
     bool m_has_parameter_map { false };
+    bool m_has_exotic_property_access { false };
 
 private:
     void set_shape(Shape& shape) { m_shape = &shape; }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <AK/CharacterTypes.h>
 #include <AK/Utf16View.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -17,6 +18,8 @@ namespace JS {
 
 PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
     : m_is_rope(true)
+    , m_has_utf16_length(true)
+    , m_utf16_length(lhs.length_in_utf16_code_units() + rhs.length_in_utf16_code_units())
     , m_lhs(&lhs)
     , m_rhs(&rhs)
 {
@@ -34,9 +37,16 @@ PrimitiveString::PrimitiveString(Utf16String string)
 {
 }
 
-PrimitiveString::~PrimitiveString()
+// NOTE: This happens here rather than in the destructor, since we may only be destroyed a while after the collection
+//       that found us dead, and nobody should be able to find us in the string cache until then.
+void PrimitiveString::finalize()
 {
-    vm().string_cache().remove(m_utf8_string);
+    Base::finalize();
+    if (!m_has_utf8_string)
+        return;
+    auto& string_cache = vm().string_cache();
+    if (auto it = string_cache.find(m_utf8_string); it != string_cache.end() && it->value == this)
+        string_cache.remove(it);
 }
 
 void PrimitiveString::visit_edges(Cell::Visitor& visitor)
@@ -87,15 +97,31 @@ Utf16View PrimitiveString::utf16_string_view() const
     return utf16_string().view();
 }
 
+size_t PrimitiveString::length_in_utf16_code_units() const
+{
+    // NOTE: Ropes always know their length, as it's just the sum of the lengths of their two halves.
+    if (m_has_utf16_length)
+        return m_utf16_length;
+
+    if (m_has_utf16_string) {
+        m_utf16_length = m_utf16_string.length_in_code_units();
+    } else {
+        // Code points outside the BMP take up two code units, everything else (including lone surrogates) only one.
+        m_utf16_length = 0;
+        for (auto code_point : Utf8View(m_utf8_string))
+            m_utf16_length += code_point > 0xffff ? 2 : 1;
+    }
+    m_has_utf16_length = true;
+    return m_utf16_length;
+}
+
 Optional<Value> PrimitiveString::get(VM& vm, PropertyKey const& property_key) const
 {
     if (property_key.is_symbol())
         return {};
     if (property_key.is_string()) {
-        if (property_key.as_string() == vm.names.length.as_string()) {
-            auto length = utf16_string().length_in_code_units();
-            return Value(static_cast<double>(length));
-        }
+        if (property_key.as_string() == vm.names.length.as_string())
+            return Value(static_cast<double>(length_in_utf16_code_units()));
     }
     auto index = canonical_numeric_index_string(property_key, CanonicalIndexMode::IgnoreNumericRoundtrip);
     if (!index.is_index())
@@ -187,25 +213,6 @@ void PrimitiveString::resolve_rope_if_needed() const
     if (!m_is_rope)
         return;
 
-    // NOTE: Special case for two concatenated UTF-16 strings.
-    //       This is here as an optimization, although I'm unsure how valuable it is.
-    if (m_lhs->has_utf16_string() && m_rhs->has_utf16_string()) {
-        auto const& lhs_string = m_lhs->utf16_string();
-        auto const& rhs_string = m_rhs->utf16_string();
-
-        Vector<u16, 1> combined;
-        combined.ensure_capacity(lhs_string.length_in_code_units() + rhs_string.length_in_code_units());
-        combined.extend(lhs_string.string());
-        combined.extend(rhs_string.string());
-
-        m_utf16_string = Utf16String(move(combined));
-        m_has_utf16_string = true;
-        m_is_rope = false;
-        m_lhs = nullptr;
-        m_rhs = nullptr;
-        return;
-    }
-
     // This vector will hold all the pieces of the rope that need to be assembled
     // into the resolved string.
     Vector<PrimitiveString const*> pieces;
@@ -225,6 +232,22 @@ void PrimitiveString::resolve_rope_if_needed() const
         pieces.append(current);
     }
 
+    // NOTE: If every piece is already UTF-16, we can simply put their code units next to each other.
+    //       Surrogate pairs that are split across two pieces need no special handling in that case.
+    if (all_of(pieces, [](auto const* piece) { return piece->has_utf16_string(); })) {
+        Vector<u16, 1> combined;
+        combined.ensure_capacity(m_utf16_length);
+        for (auto const* piece : pieces)
+            combined.extend(piece->utf16_string().string());
+
+        m_utf16_string = Utf16String(move(combined));
+        m_has_utf16_string = true;
+        m_is_rope = false;
+        m_lhs = nullptr;
+        m_rhs = nullptr;
+        return;
+    }
+
     // Now that we have all the pieces, we can concatenate them using a StringBuilder.
     StringBuilder builder;
 
@@ -19,7 +19,7 @@ class PrimitiveString final : public Cell {
     JS_CELL(PrimitiveString, Cell);
 
 public:
-    virtual ~PrimitiveString();
+    virtual ~PrimitiveString() override = default;
 
     PrimitiveString(PrimitiveString const&) = delete;
     PrimitiveString& operator=(PrimitiveString const&) = delete;
@@ -33,9 +33,14 @@ public:
     Utf16View utf16_string_view() const;
     bool has_utf16_string() const { return m_has_utf16_string; }
 
+    // This doesn't resolve ropes, so looking at the length of a string that's still being built is cheap.
+    size_t length_in_utf16_code_units() const;
+
     Optional<Value> get(VM&, PropertyKey const&) const;
 
 private:
+    virtual void finalize() override;
+
     explicit PrimitiveString(PrimitiveString&, PrimitiveString&);
     explicit PrimitiveString(String);
     explicit PrimitiveString(Utf16String);
@@ -47,6 +52,9 @@ private:
     mutable bool m_is_rope { false };
     mutable bool m_has_utf8_string { false };
     mutable bool m_has_utf16_string { false };
+    mutable bool m_has_utf16_length { false };
+
+    mutable size_t m_utf16_length { 0 };
 
     mutable PrimitiveString* m_lhs { nullptr };
     mutable PrimitiveString* m_rhs { nullptr };
@@ -65,6 +65,7 @@ protected:
         : Object(prototype)
         , m_intrinsic_constructor(intrinsic_constructor)
     {
+        set_has_exotic_property_access();
     }
 
     u32 m_array_length { 0 };
@@ -416,11 +417,11 @@ public:
 
     Span<UnderlyingBufferDataType const> data() const
     {
-        return { reinterpret_cast<UnderlyingBufferDataType const*>(m_viewed_array_buffer->buffer().data() + m_byte_offset), m_array_length };
+        return { reinterpret_cast<UnderlyingBufferDataType const*>(m_viewed_array_buffer->bytes().data() + m_byte_offset), m_array_length };
     }
     Span<UnderlyingBufferDataType> data()
     {
-        return { reinterpret_cast<UnderlyingBufferDataType*>(m_viewed_array_buffer->buffer().data() + m_byte_offset), m_array_length };
+        return { reinterpret_cast<UnderlyingBufferDataType*>(m_viewed_array_buffer->bytes().data() + m_byte_offset), m_array_length };
     }
 
     virtual size_t element_size() const override { return sizeof(UnderlyingBufferDataType); };
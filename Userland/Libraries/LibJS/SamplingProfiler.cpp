@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObjectSerializer.h>
+#include <AK/StringBuilder.h>
+#include <AK/Time.h>
+#include <LibCore/Stream.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/ECMAScriptFunctionObject.h>
+#include <LibJS/Runtime/ExecutionContext.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/SamplingProfiler.h>
+#include <unistd.h>
+
+namespace JS {
+
+Atomic<bool> SamplingProfiler::s_sample_requested { false };
+SamplingProfiler* SamplingProfiler::s_current { nullptr };
+
+static u64 current_timestamp()
+{
+    return Time::now_monotonic().to_milliseconds();
+}
+
+static pid_t current_tid()
+{
+#ifdef AK_OS_SERENITY
+    return gettid();
+#else
+    return getpid();
+#endif
+}
+
+ErrorOr<NonnullOwnPtr<SamplingProfiler>> SamplingProfiler::create(VM& vm, u32 interval_in_microseconds)
+{
+    VERIFY(interval_in_microseconds > 0);
+    auto profiler = TRY(adopt_nonnull_own_or_enomem(new (nothrow) SamplingProfiler(vm, interval_in_microseconds)));
+
+    profiler->m_sampler_thread = TRY(Threading::Thread::try_create([profiler = profiler.ptr()]() -> intptr_t {
+        while (!profiler->m_should_stop.load(AK::MemoryOrder::memory_order_relaxed)) {
+            usleep(profiler->m_interval_in_microseconds);
+            // If the last sample hasn't been taken yet, the VM is busy somewhere we can't look at it (e.g. in a long-running native function).
+            if (s_sample_requested.exchange(true, AK::MemoryOrder::memory_order_relaxed))
+                profiler->m_lost_samples.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        }
+        return 0;
+    },
+        "JS sampler"sv));
+    profiler->m_sampler_thread->start();
+
+    return profiler;
+}
+
+SamplingProfiler::SamplingProfiler(VM& vm, u32 interval_in_microseconds)
+    : m_vm(vm)
+    , m_vm_thread(pthread_self())
+    , m_start_timestamp(current_timestamp())
+    , m_interval_in_microseconds(interval_in_microseconds)
+{
+    VERIFY(!s_current);
+    s_current = this;
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    if (m_sampler_thread) {
+        m_should_stop.store(true, AK::MemoryOrder::memory_order_relaxed);
+        (void)m_sampler_thread->join();
+    }
+
+    VERIFY(s_current == this);
+    s_current = nullptr;
+    s_sample_requested.store(false, AK::MemoryOrder::memory_order_relaxed);
+}
+
+void SamplingProfiler::take_requested_sample()
+{
+    // Other VMs may run on other threads, and their interpreters check for samples too.
+    if (!s_current || !pthread_equal(pthread_self(), s_current->m_vm_thread))
+        return;
+    s_sample_requested.store(false, AK::MemoryOrder::memory_order_relaxed);
+    s_current->take_sample();
+}
+
+size_t SamplingProfiler::string_index(String const& string)
+{
+    if (auto index = m_string_indices.get(string); index.has_value())
+        return index.value();
+    m_strings.append(string);
+    m_string_indices.set(string, m_strings.size() - 1);
+    return m_strings.size() - 1;
+}
+
+void SamplingProfiler::take_sample()
+{
+    auto const& execution_context_stack = m_vm.execution_context_stack();
+    if (execution_context_stack.is_empty())
+        return;
+
+    Sample sample;
+    sample.timestamp = current_timestamp();
+    sample.lost_samples = m_lost_samples.exchange(0, AK::MemoryOrder::memory_order_relaxed);
+    sample.frames.ensure_capacity(execution_context_stack.size());
+
+    // NOTE: Only the innermost execution context can be matched with the bytecode that's running, the others are somewhere further up the native stack.
+    auto* bytecode_interpreter = Bytecode::Interpreter::current();
+
+    for (size_t i = execution_context_stack.size(); i > 0; --i) {
+        auto const& context = *execution_context_stack[i - 1];
+        bool is_innermost_frame = i == execution_context_stack.size();
+
+        StringBuilder builder;
+        if (!context.function_name.is_empty())
+            builder.append(context.function_name);
+        else if (context.function)
+            builder.append("(anonymous)"sv);
+        else
+            builder.append("(global)"sv);
+
+        // The AST interpreter keeps track of the node it's executing, for everything else the best we can do is where the function starts.
+        Optional<SourceRange> source_range;
+        if (context.current_node)
+            source_range = context.current_node->source_range();
+        else if (context.function && context.function->is_ecmascript_function_object())
+            source_range = static_cast<ECMAScriptFunctionObject const&>(*context.function).ecmascript_code().source_range();
+
+        if (source_range.has_value())
+            builder.appendff(" ({}:{}:{})", source_range->filename, source_range->start.line, source_range->start.column);
+        else if (context.function)
+            builder.append(" (native)"sv);
+
+        Frame frame;
+        frame.symbol_index = string_index(builder.to_string());
+        if (is_innermost_frame && bytecode_interpreter && !context.current_node)
+            frame.bytecode_offset = bytecode_interpreter->pc();
+        sample.frames.unchecked_append(move(frame));
+    }
+
+    m_samples.append(move(sample));
+}
+
+ErrorOr<void> SamplingProfiler::write_perfcore_file(StringView path) const
+{
+    StringBuilder builder;
+    auto object = TRY(JsonObjectSerializer<>::try_create(builder));
+
+    {
+        auto strings = TRY(object.add_array("strings"sv));
+        for (auto const& string : m_strings)
+            TRY(strings.add(string));
+        TRY(strings.finish());
+    }
+
+    auto pid = getpid();
+    auto tid = current_tid();
+
+    auto events = TRY(object.add_array("events"sv));
+
+    // NOTE: Profiler wants to know about the process and thread before it sees any of their samples.
+    auto add_event_header = [&](auto& event, StringView type, u64 timestamp, u32 lost_samples) -> ErrorOr<void> {
+        TRY(event.add("type"sv, type));
+        TRY(event.add("pid"sv, pid));
+        TRY(event.add("tid"sv, tid));
+        TRY(event.add("timestamp"sv, timestamp));
+        TRY(event.add("lost_samples"sv, lost_samples));
+        return {};
+    };
+
+    {
+        auto event = TRY(events.add_object());
+        TRY(add_event_header(event, "process_create"sv, m_start_timestamp, 0));
+        TRY(event.add("parent_pid"sv, 0));
+        TRY(event.add("executable"sv, "JavaScript"sv));
+        auto stack = TRY(event.add_array("stack"sv));
+        TRY(stack.finish());
+        TRY(event.finish());
+    }
+    {
+        auto event = TRY(events.add_object());
+        TRY(add_event_header(event, "thread_create"sv, m_start_timestamp, 0));
+        TRY(event.add("parent_tid"sv, 0));
+        auto stack = TRY(event.add_array("stack"sv));
+        TRY(stack.finish());
+        TRY(event.finish());
+    }
+
+    for (auto const& sample : m_samples) {
+        auto event = TRY(events.add_object());
+        TRY(add_event_header(event, "sample"sv, sample.timestamp, sample.lost_samples));
+        auto stack = TRY(event.add_array("stack"sv));
+        // JavaScript frames are objects, so they can be told apart from the addresses of native frames.
+        for (auto const& frame : sample.frames) {
+            auto frame_object = TRY(stack.add_object());
+            TRY(frame_object.add("symbol"sv, frame.symbol_index));
+            if (frame.bytecode_offset.has_value())
+                TRY(frame_object.add("offset"sv, frame.bytecode_offset.value()));
+            TRY(frame_object.finish());
+        }
+        TRY(stack.finish());
+        TRY(event.finish());
+    }
+
+    TRY(events.finish());
+    TRY(object.finish());
+
+    auto file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate));
+    if (!file->write_or_error(builder.string_view().bytes()))
+        return AK::Error::from_string_literal("Failed to write profile");
+    return {};
+}
+
+}
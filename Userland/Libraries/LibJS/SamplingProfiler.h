@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+#include <LibThreading/Thread.h>
+#include <pthread.h>
+
+namespace JS {
+
+// Periodically records the execution context stack of a VM, and writes it out in the perfcore format that Profiler understands.
+// A background thread asks for a sample, and the interpreters take it the next time they are between two instructions (or AST
+// nodes), which is the only time the execution context stack can be looked at safely.
+class SamplingProfiler {
+    AK_MAKE_NONCOPYABLE(SamplingProfiler);
+    AK_MAKE_NONMOVABLE(SamplingProfiler);
+
+public:
+    static ErrorOr<NonnullOwnPtr<SamplingProfiler>> create(VM&, u32 interval_in_microseconds = 1000);
+    ~SamplingProfiler();
+
+    ALWAYS_INLINE static void take_sample_if_requested()
+    {
+        if (s_sample_requested.load(AK::MemoryOrder::memory_order_relaxed)) [[unlikely]]
+            take_requested_sample();
+    }
+
+    size_t sample_count() const { return m_samples.size(); }
+
+    ErrorOr<void> write_perfcore_file(StringView path) const;
+
+private:
+    SamplingProfiler(VM&, u32 interval_in_microseconds);
+
+    struct Frame {
+        size_t symbol_index { 0 };
+        Optional<size_t> bytecode_offset;
+    };
+
+    struct Sample {
+        u64 timestamp { 0 };
+        u32 lost_samples { 0 };
+        Vector<Frame> frames; // Innermost frame first, like in the samples taken by the kernel.
+    };
+
+    static void take_requested_sample();
+    void take_sample();
+    size_t string_index(String const&);
+
+    static Atomic<bool> s_sample_requested;
+    static SamplingProfiler* s_current;
+
+    VM& m_vm;
+    pthread_t m_vm_thread;
+    u64 m_start_timestamp { 0 };
+    u32 m_interval_in_microseconds { 0 };
+
+    RefPtr<Threading::Thread> m_sampler_thread;
+    Atomic<bool> m_should_stop { false };
+    Atomic<u32> m_lost_samples { 0 };
+
+    Vector<Sample> m_samples;
+    Vector<String> m_strings;
+    HashMap<String, size_t> m_string_indices;
+};
+
+}
@@ -0,0 +1,79 @@
+describe("packed arrays behave like any other array", () => {
+    test("push calls setters on the prototype chain", () => {
+        var a = [1, 2, 3];
+        var setterCalls = 0;
+        Object.defineProperty(Array.prototype, 3, {
+            set() {
+                setterCalls++;
+            },
+            configurable: true,
+        });
+        try {
+            expect(a.push(4)).toBe(4);
+            expect(setterCalls).toBe(1);
+            expect(a.hasOwnProperty(3)).toBeFalse();
+        } finally {
+            delete Array.prototype[3];
+        }
+        expect(a.push(5)).toBe(5);
+        expect(a[3]).toBeUndefined();
+        expect(a[4]).toBe(5);
+    });
+
+    test("push does not extend non-extensible arrays", () => {
+        var a = [1, 2, 3];
+        Object.preventExtensions(a);
+        expect(() => {
+            a.push(4);
+        }).toThrow(TypeError);
+        expect(a).toEqual([1, 2, 3]);
+    });
+
+    test("forEach and map notice changes made by the callback", () => {
+        var a = [1, 2, 3, 4];
+        var seen = [];
+        a.forEach((value, index) => {
+            seen.push(value);
+            if (index === 0) {
+                a.pop();
+                a[1] = "changed";
+            }
+        });
+        expect(seen).toEqual([1, "changed", 3]);
+
+        var b = [1, 2, 3];
+        var mapped = b.map((value, index) => {
+            if (index === 0) delete b[1];
+            return value * 2;
+        });
+        expect(mapped).toHaveLength(3);
+        expect(mapped.hasOwnProperty(1)).toBeFalse();
+        expect(mapped[2]).toBe(6);
+    });
+
+    test("indexOf looks at the prototype for holes", () => {
+        var a = [1, , 3];
+        Array.prototype[1] = "from prototype";
+        try {
+            expect(a.indexOf("from prototype")).toBe(1);
+        } finally {
+            delete Array.prototype[1];
+        }
+        expect([1, 2, 3].indexOf(3)).toBe(2);
+        expect([1, 2, 3].indexOf(3, -1)).toBe(2);
+        expect([1, 2, NaN].indexOf(NaN)).toBe(-1);
+    });
+
+    test("default sort of numbers compares strings and is stable", () => {
+        expect([10, 9, 1, 100, -1, 0.5].sort()).toEqual([-1, 0.5, 1, 10, 100, 9]);
+        var a = [0, -0, 0, -0];
+        var sorted = a.sort();
+        expect(sorted.map(value => 1 / value)).toEqual([
+            Infinity,
+            -Infinity,
+            Infinity,
+            -Infinity,
+        ]);
+        expect([3, 20, 100].toSorted()).toEqual([100, 20, 3]);
+    });
+});
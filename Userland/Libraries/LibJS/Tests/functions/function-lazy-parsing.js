@@ -0,0 +1,67 @@
+test("function declarations behave the same when called later", () => {
+    function add(a, b) {
+        return a + b;
+    }
+    expect(add(1, 2)).toBe(3);
+    expect(add.toString()).toBe("function add(a, b) {\n        return a + b;\n    }");
+});
+
+test("nested declarations, arguments and eval", () => {
+    function outer() {
+        function inner() {
+            return arguments.length;
+        }
+        return inner(1, 2, 3) + eval("arguments.length");
+    }
+    expect(outer(1)).toBe(4);
+});
+
+test("strict mode is inherited by function declarations", () => {
+    "use strict";
+    function getThis() {
+        return this;
+    }
+    expect(getThis()).toBeUndefined();
+
+    function withDefaultClass(c = class { field = 1; }) {
+        return new c().field;
+    }
+    expect(withDefaultClass()).toBe(1);
+});
+
+test("async and generator declarations", () => {
+    function* generator() {
+        yield 1;
+        yield 2;
+    }
+    expect([...generator()]).toEqual([1, 2]);
+
+    async function asyncFunction() {
+        return await 42;
+    }
+    let result;
+    asyncFunction().then(value => {
+        result = value;
+    });
+    runQueuedPromiseJobs();
+    expect(result).toBe(42);
+});
+
+test("syntax errors in function bodies are still reported right away", () => {
+    expect("function f() { return; }").toEval();
+    expect("function f() { let a; let a; }").not.toEval();
+    expect("function f() { 'use strict'; with ({}) {} }").not.toEval();
+});
+
+test("private names in function declarations inside classes", () => {
+    class A {
+        #value = 5;
+        static read(object) {
+            function read() {
+                return object.#value;
+            }
+            return read();
+        }
+    }
+    expect(A.read(new A())).toBe(5);
+});
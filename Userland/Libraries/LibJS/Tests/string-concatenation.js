@@ -28,3 +28,19 @@ test("adding strings with dangling surrogates", () => {
     expect("\ud834a" + "\udf06").toBe("\ud834a\udf06");
     expect("\ud834" + "a\udf06").toBe("\ud834a\udf06");
 });
+
+test("length of strings that are still being concatenated", () => {
+    let s = "";
+    for (let i = 0; i < 1000; ++i) {
+        s += "ab";
+        expect(s).toHaveLength((i + 1) * 2);
+    }
+    expect(s.slice(-4)).toBe("abab");
+
+    let pieces = "😀";
+    pieces += "\ud834";
+    pieces += "\udf06";
+    expect(pieces).toHaveLength(4);
+    expect(pieces).toBe("😀𝌆");
+    expect(pieces.charCodeAt(3)).toBe(0xdf06);
+});
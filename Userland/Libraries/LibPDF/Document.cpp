@@ -6,6 +6,7 @@
 
 #include <LibPDF/CommonNames.h>
 #include <LibPDF/Document.h>
+#include <LibPDF/Fonts/PDFFont.h>
 #include <LibPDF/Parser.h>
 
 namespace PDF {
@@ -63,12 +64,17 @@ Document::Document(NonnullRefPtr<DocumentParser> const& parser)
     m_parser->set_document(this);
 }
 
+Document::~Document() = default;
+
 PDFErrorOr<void> Document::initialize()
 {
     if (m_security_handler)
         VERIFY(m_security_handler->has_user_password());
 
-    TRY(build_page_tree());
+    // A linearized file has everything that's needed to display the first page up front,
+    // so we can wait with reading the page tree until another page is requested.
+    if (!m_parser->is_linearized())
+        TRY(ensure_page_tree_is_built());
     TRY(build_outline());
 
     return {};
@@ -94,18 +100,26 @@ u32 Document::get_first_page_index() const
 
 u32 Document::get_page_count() const
 {
+    if (!m_page_tree_is_built)
+        return m_parser->linearized_page_count();
     return m_page_object_indices.size();
 }
 
 PDFErrorOr<Page> Document::get_page(u32 index)
 {
-    VERIFY(index < m_page_object_indices.size());
+    VERIFY(index < get_page_count());
 
     auto cached_page = m_pages.get(index);
     if (cached_page.has_value())
         return cached_page.value();
 
-    auto page_object_index = m_page_object_indices[index];
+    u32 page_object_index;
+    if (!m_page_tree_is_built && index == m_parser->linearized_first_page_index()) {
+        page_object_index = m_parser->linearized_first_page_object_index();
+    } else {
+        TRY(ensure_page_tree_is_built());
+        page_object_index = m_page_object_indices[index];
+    }
     auto page_object = TRY(get_or_load_value(page_object_index));
     auto raw_page_object = TRY(resolve_to<DictObject>(page_object));
 
@@ -146,6 +160,16 @@ PDFErrorOr<Page> Document::get_page(u32 index)
     return page;
 }
 
+PDFErrorOr<NonnullRefPtr<PDFFont>> Document::get_or_create_font(NonnullRefPtr<DictObject> const& font_dictionary)
+{
+    if (auto font = m_fonts.get(font_dictionary); font.has_value())
+        return NonnullRefPtr { *font.value() };
+
+    auto font = TRY(PDFFont::create(this, font_dictionary));
+    m_fonts.set(font_dictionary, font);
+    return font;
+}
+
 PDFErrorOr<Value> Document::resolve(Value const& value)
 {
     if (value.has<Reference>()) {
@@ -166,6 +190,15 @@ PDFErrorOr<Value> Document::resolve(Value const& value)
     return value;
 }
 
+PDFErrorOr<void> Document::ensure_page_tree_is_built()
+{
+    if (m_page_tree_is_built)
+        return {};
+    TRY(build_page_tree());
+    m_page_tree_is_built = true;
+    return {};
+}
+
 PDFErrorOr<void> Document::build_page_tree()
 {
     auto page_tree = TRY(m_catalog->get_dict(this, CommonNames::Pages));
@@ -101,6 +101,9 @@ public:
 
     [[nodiscard]] PDFErrorOr<Page> get_page(u32 index);
 
+    // Fonts are shared between pages, so they are only created once per font dictionary.
+    [[nodiscard]] PDFErrorOr<NonnullRefPtr<PDFFont>> get_or_create_font(NonnullRefPtr<DictObject> const& font_dictionary);
+
     ALWAYS_INLINE Value get_value(u32 index) const
     {
         return m_values.get(index).value_or({});
@@ -132,6 +135,8 @@ public:
         VERIFY_NOT_REACHED();
     }
 
+    ~Document();
+
 private:
     explicit Document(NonnullRefPtr<DocumentParser> const& parser);
 
@@ -142,6 +147,7 @@ private:
     // improve lookup time. This would reduce the initial overhead by not loading
     // every page tree node of, say, a 1000+ page PDF file.
     PDFErrorOr<void> build_page_tree();
+    PDFErrorOr<void> ensure_page_tree_is_built();
     PDFErrorOr<void> add_page_tree_node_to_page_tree(NonnullRefPtr<DictObject> const& page_tree);
 
     PDFErrorOr<void> build_outline();
@@ -156,8 +162,10 @@ private:
     RefPtr<DictObject> m_catalog;
     RefPtr<DictObject> m_trailer;
     Vector<u32> m_page_object_indices;
+    bool m_page_tree_is_built { false };
     HashMap<u32, Page> m_pages;
     HashMap<u32, Value> m_values;
+    HashMap<NonnullRefPtr<DictObject>, NonnullRefPtr<PDFFont>> m_fonts;
     RefPtr<OutlineDict> m_outline;
     RefPtr<SecurityHandler> m_security_handler;
 };
@@ -43,15 +43,20 @@ PDFErrorOr<void> DocumentParser::initialize()
         }
     }
 
-    if (is_linearized)
+    if (is_linearized) {
+        m_is_linearized = true;
         return initialize_linearized_xref_table();
+    }
 
     return initialize_non_linearized_xref_table();
 }
 
 PDFErrorOr<Value> DocumentParser::parse_object_with_index(u32 index)
 {
-    VERIFY(m_xref_table->has_object(index));
+    if (!m_xref_table->has_object(index))
+        TRY(ensure_main_xref_table_is_merged());
+    if (!m_xref_table->has_object(index))
+        return error(String::formatted("Object with index {} is not in the xref table", index));
 
     if (m_xref_table->is_object_compressed(index))
         // The object can be found in a object stream
@@ -188,18 +193,47 @@ PDFErrorOr<void> DocumentParser::initialize_linearized_xref_table()
     if (!m_trailer)
         m_trailer = TRY(parse_file_trailer());
 
-    // Also parse the main xref table and merge into the first-page xref table. Note
-    // that we don't use the main xref table offset from the linearization dict because
-    // for some reason, it specified the offset of the whitespace after the object
-    // index start and length? So it's much easier to do it this way.
-    auto main_xref_table_offset = m_trailer->get_value(CommonNames::Prev).to_int();
-    m_reader.move_to(main_xref_table_offset);
+    // The main xref table is merged into the first-page xref table once we need an
+    // object that isn't part of the first page. Note that we don't use the main xref
+    // table offset from the linearization dict because for some reason, it specified
+    // the offset of the whitespace after the object index start and length? So it's
+    // much easier to do it this way.
+    m_unmerged_main_xref_table_offset = m_trailer->get_value(CommonNames::Prev).to_int();
+
+    return {};
+}
+
+PDFErrorOr<void> DocumentParser::ensure_main_xref_table_is_merged()
+{
+    if (!m_unmerged_main_xref_table_offset.has_value())
+        return {};
+
+    m_reader.move_to(m_unmerged_main_xref_table_offset.release_value());
     auto main_xref_table = TRY(parse_xref_table());
     TRY(m_xref_table->merge(move(*main_xref_table)));
 
     return {};
 }
 
+u32 DocumentParser::linearized_first_page_object_index() const
+{
+    VERIFY(m_is_linearized);
+    return m_linearization_dictionary->first_page_object_number;
+}
+
+u32 DocumentParser::linearized_first_page_index() const
+{
+    VERIFY(m_is_linearized);
+    auto first_page = m_linearization_dictionary->first_page;
+    return first_page == NumericLimits<u32>::max() ? 0 : first_page;
+}
+
+u32 DocumentParser::linearized_page_count() const
+{
+    VERIFY(m_is_linearized);
+    return m_linearization_dictionary->number_of_pages;
+}
+
 PDFErrorOr<void> DocumentParser::initialize_hint_tables()
 {
     auto linearization_dict = m_linearization_dictionary.value();
@@ -449,6 +483,30 @@ PDFErrorOr<NonnullRefPtr<DictObject>> DocumentParser::parse_file_trailer()
 PDFErrorOr<Value> DocumentParser::parse_compressed_object_with_index(u32 index)
 {
     auto object_stream_index = m_xref_table->object_stream_for_object(index);
+    auto const* object_stream = TRY(get_or_load_object_stream(object_stream_index));
+
+    auto object_offset = object_stream->object_offsets.get(index);
+    if (!object_offset.has_value())
+        return error(String::formatted("Object with index {} is not in object stream {}", index, object_stream_index));
+
+    Parser stream_parser(m_document, object_stream->stream->bytes());
+    stream_parser.move_to(object_offset.value());
+    return TRY(stream_parser.parse_value());
+}
+
+PDFErrorOr<DocumentParser::ObjectStream const*> DocumentParser::get_or_load_object_stream(u32 object_stream_index)
+{
+    if (auto it = m_object_stream_cache.find(object_stream_index); it != m_object_stream_cache.end()) {
+        m_object_stream_cache_usage_order.remove_first_matching([&](auto index) { return index == object_stream_index; });
+        m_object_stream_cache_usage_order.append(object_stream_index);
+        return &it->value;
+    }
+
+    if (!m_xref_table->has_object(object_stream_index))
+        TRY(ensure_main_xref_table_is_merged());
+    if (!m_xref_table->has_object(object_stream_index))
+        return error(String::formatted("Object stream with index {} is not in the xref table", object_stream_index));
+
     auto stream_offset = m_xref_table->byte_offset_for_object(object_stream_index);
 
     m_reader.move_to(stream_offset);
@@ -456,7 +514,7 @@ PDFErrorOr<Value> DocumentParser::parse_compressed_object_with_index(u32 index)
     auto first_number = TRY(parse_number());
     auto second_number = TRY(parse_number());
 
-    if (first_number.get<int>() != object_stream_index)
+    if (first_number.get<int>() != static_cast<int>(object_stream_index))
         return error("Mismatching object stream index");
     if (second_number.get<int>() != 0)
         return error("Non-zero object stream generation number");
@@ -475,20 +533,27 @@ PDFErrorOr<Value> DocumentParser::parse_compressed_object_with_index(u32 index)
     auto object_count = dict->get_value("N").get_u32();
     auto first_object_offset = dict->get_value("First").get_u32();
 
-    auto stream = TRY(parse_stream(dict));
-    Parser stream_parser(m_document, stream->bytes());
+    ObjectStream object_stream { TRY(parse_stream(dict)), {} };
 
+    // Index all objects in the stream at once, instead of scanning the header again for every one of them.
+    Parser stream_parser(m_document, object_stream.stream->bytes());
     for (u32 i = 0; i < object_count; ++i) {
         auto object_number = TRY(stream_parser.parse_number());
         auto object_offset = TRY(stream_parser.parse_number());
+        object_stream.object_offsets.set(object_number.get_u32(), first_object_offset + object_offset.get_u32());
+    }
 
-        if (object_number.get_u32() == index) {
-            stream_parser.move_to(first_object_offset + object_offset.get_u32());
-            break;
-        }
+    auto stream_size = object_stream.stream->bytes().size();
+    while (!m_object_stream_cache_usage_order.is_empty() && m_object_stream_cache_size + stream_size > object_stream_cache_budget) {
+        auto evicted_index = m_object_stream_cache_usage_order.take_first();
+        m_object_stream_cache_size -= m_object_stream_cache.get(evicted_index)->stream->bytes().size();
+        m_object_stream_cache.remove(evicted_index);
     }
 
-    return TRY(stream_parser.parse_value());
+    m_object_stream_cache_size += stream_size;
+    m_object_stream_cache_usage_order.append(object_stream_index);
+    m_object_stream_cache.set(object_stream_index, move(object_stream));
+    return &m_object_stream_cache.find(object_stream_index)->value;
 }
 
 PDFErrorOr<DocumentParser::PageOffsetHintTable> DocumentParser::parse_page_offset_hint_table(ReadonlyBytes hint_stream_bytes)
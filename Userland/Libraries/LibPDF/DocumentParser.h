@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <LibPDF/Parser.h>
 
 namespace PDF {
@@ -31,6 +32,13 @@ public:
     // is not a page object
     PDFErrorOr<RefPtr<DictObject>> conditionally_parse_page_tree_node(u32 object_index);
 
+    // For linearized files, the first page can be loaded from the first-page section alone,
+    // without having to walk the page tree (which may live in the main section).
+    [[nodiscard]] bool is_linearized() const { return m_is_linearized; }
+    [[nodiscard]] u32 linearized_first_page_object_index() const;
+    [[nodiscard]] u32 linearized_first_page_index() const;
+    [[nodiscard]] u32 linearized_page_count() const;
+
 private:
     struct LinearizationDictionary {
         u32 length_of_file { 0 };
@@ -86,13 +94,34 @@ private:
     PDFErrorOr<NonnullRefPtr<XRefTable>> parse_xref_table();
     PDFErrorOr<NonnullRefPtr<DictObject>> parse_file_trailer();
     PDFErrorOr<Value> parse_compressed_object_with_index(u32 index);
+    PDFErrorOr<void> ensure_main_xref_table_is_merged();
 
     bool navigate_to_before_eof_marker();
     bool navigate_to_after_startxref();
 
+    // An object stream, decoded once, along with the offsets of all the objects it contains.
+    struct ObjectStream {
+        NonnullRefPtr<StreamObject> stream;
+        HashMap<u32, u32> object_offsets;
+    };
+
+    PDFErrorOr<ObjectStream const*> get_or_load_object_stream(u32 object_stream_index);
+
     RefPtr<XRefTable> m_xref_table;
     RefPtr<DictObject> m_trailer;
     Optional<LinearizationDictionary> m_linearization_dictionary;
+    bool m_is_linearized { false };
+
+    // The main xref table of a linearized file is only needed for objects outside of the
+    // first-page section, so it is only parsed once one of them is requested.
+    Optional<size_t> m_unmerged_main_xref_table_offset;
+
+    // Decoded object streams can be large, so only the most recently used ones are kept
+    // around, up to a total size of object_stream_cache_budget bytes.
+    static constexpr size_t object_stream_cache_budget = 8 * MiB;
+    HashMap<u32, ObjectStream> m_object_stream_cache;
+    Vector<u32> m_object_stream_cache_usage_order;
+    size_t m_object_stream_cache_size { 0 };
 };
 
 }
@@ -13,6 +13,7 @@ namespace PDF {
 
 class Document;
 class Object;
+class PDFFont;
 
 #define ENUMERATE_OBJECT_TYPES(V) \
     V(StringObject, string)       \
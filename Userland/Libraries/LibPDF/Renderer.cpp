@@ -347,7 +347,7 @@ RENDERER_HANDLER(text_set_font)
     auto target_font_name = MUST(m_document->resolve_to<NameObject>(args[0]))->name();
     auto fonts_dictionary = MUST(m_page.resources->get_dict(m_document, CommonNames::Font));
     auto font_dictionary = MUST(fonts_dictionary->get_dict(m_document, target_font_name));
-    auto font = TRY(PDFFont::create(m_document, font_dictionary));
+    auto font = TRY(m_document->get_or_create_font(font_dictionary));
     text_state().font = font;
 
     // FIXME: We do not yet have the standard 14 fonts, as some of them are not open fonts,
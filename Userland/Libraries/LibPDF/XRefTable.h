@@ -70,7 +70,7 @@ public:
 
     [[nodiscard]] ALWAYS_INLINE bool has_object(size_t index) const
     {
-        return index < m_entries.size() && m_entries[index].byte_offset != -1;
+        return index < m_entries.size() && m_entries[index].byte_offset != invalid_byte_offset;
     }
 
     [[nodiscard]] ALWAYS_INLINE long byte_offset_for_object(size_t index) const
@@ -22,6 +22,16 @@ bool Request::stop()
 
 template<typename T>
 void Request::stream_into_impl(T& stream)
+{
+    set_up_internal_stream_data([&stream](auto read_bytes) {
+        if (!stream.write_or_error(read_bytes)) {
+            // FIXME: What do we do here?
+            TODO();
+        }
+    });
+}
+
+void Request::set_up_internal_stream_data(DataReceived on_data_available)
 {
     VERIFY(!m_internal_stream_data);
 
@@ -42,7 +52,10 @@ void Request::stream_into_impl(T& stream)
             user_on_finish(m_internal_stream_data->success, m_internal_stream_data->total_size);
         }
     };
-    m_internal_stream_data->read_notifier->on_ready_to_read = [this, &stream] {
+
+    // We only read once per notification, so that a slow consumer leaves the rest in the pipe.
+    // RequestServer then sees the pipe fill up, and stops reading from the network until we've caught up.
+    m_internal_stream_data->read_notifier->on_ready_to_read = [this, on_data_available = move(on_data_available)] {
         constexpr size_t buffer_size = 256 * KiB;
         static char buf[buffer_size];
         do {
@@ -54,10 +67,7 @@ void Request::stream_into_impl(T& stream)
             auto read_bytes = result.release_value();
             if (read_bytes.is_empty())
                 break;
-            if (!stream.write_or_error(read_bytes)) {
-                // FIXME: What do we do here?
-                TODO();
-            }
+            on_data_available(read_bytes);
             break;
         } while (true);
 
@@ -99,19 +109,39 @@ void Request::set_should_buffer_all_input(bool value)
     on_headers_received = [this](auto& headers, auto response_code) {
         m_internal_buffered_data->response_headers = headers;
         m_internal_buffered_data->response_code = move(response_code);
+
+        // Knowing the size up front saves us from growing the buffer over and over again.
+        // Don't take the server's word for it beyond a point though, it might never send that much.
+        if (auto content_length = headers.get("Content-Length"sv); content_length.has_value() && !headers.contains("Content-Encoding"sv)) {
+            if (auto length = content_length->to_uint(); length.has_value())
+                (void)m_internal_buffered_data->payload.try_ensure_capacity(min(*length, 64 * MiB));
+        }
     };
 
     on_finish = [this](auto success, u32 total_size) {
-        auto output_buffer = m_internal_buffered_data->payload_stream.copy_into_contiguous_buffer();
         on_buffered_request_finish(
             success,
             total_size,
             m_internal_buffered_data->response_headers,
             m_internal_buffered_data->response_code,
-            output_buffer);
+            m_internal_buffered_data->payload);
     };
 
-    stream_into(m_internal_buffered_data->payload_stream);
+    set_up_internal_stream_data([this](auto read_bytes) {
+        // FIXME: Tell the caller when we run out of memory instead of dropping data.
+        if (m_internal_buffered_data->payload.try_append(read_bytes).is_error())
+            dbgln("Request: Failed to buffer {} bytes of the response", read_bytes.size());
+    });
+}
+
+void Request::set_unbuffered_request_callbacks(HeadersReceived on_headers_received, DataReceived on_data_received, RequestFinished on_finish)
+{
+    VERIFY(!m_internal_stream_data);
+    VERIFY(!m_internal_buffered_data);
+
+    this->on_headers_received = move(on_headers_received);
+    this->on_finish = move(on_finish);
+    set_up_internal_stream_data(move(on_data_received));
 }
 
 void Request::did_finish(Badge<RequestClient>, bool success, u32 total_size)
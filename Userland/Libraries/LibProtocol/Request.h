@@ -45,6 +45,15 @@ public:
     /// Note: Will override `on_finish', and `on_headers_received', and expects `on_buffered_request_finish' to be set!
     void set_should_buffer_all_input(bool);
 
+    using HeadersReceived = Function<void(HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code)>;
+    using DataReceived = Function<void(ReadonlyBytes data)>;
+    using RequestFinished = Function<void(bool success, u32 total_size)>;
+
+    /// Hands the body to `on_data_received' piece by piece as it arrives, without holding on to any of it.
+    /// `on_headers_received' is called before any data, and `on_finish' after all of it.
+    /// Note: Will override `on_finish', and `on_headers_received'.
+    void set_unbuffered_request_callbacks(HeadersReceived on_headers_received, DataReceived on_data_received, RequestFinished on_finish);
+
     /// Note: Must be set before `set_should_buffer_all_input(true)`.
     Function<void(bool success, u32 total_size, HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code, ReadonlyBytes payload)> on_buffered_request_finish;
     Function<void(bool success, u32 total_size)> on_finish;
@@ -64,6 +73,7 @@ private:
     explicit Request(RequestClient&, i32 request_id);
     template<typename T>
     void stream_into_impl(T&);
+    void set_up_internal_stream_data(DataReceived on_data_available);
 
     WeakPtr<RequestClient> m_client;
     int m_request_id { -1 };
@@ -72,7 +82,7 @@ private:
     bool m_should_buffer_all_input { false };
 
     struct InternalBufferedData {
-        DuplexMemoryStream payload_stream;
+        ByteBuffer payload;
         HashMap<String, String, CaseInsensitiveStringTraits> response_headers;
         Optional<u32> response_code;
     };
@@ -0,0 +1,639 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/NumericLimits.h>
+#include <LibRegex/RegexDFA.h>
+
+namespace regex {
+
+// Resume points with this bit set are a node in the middle of a string, all others are a position in the bytecode.
+static constexpr u32 node_flag = 0x80000000;
+static constexpr u32 no_instruction = NumericLimits<u32>::max();
+
+// All states are thrown away once there are this many of them. If that happens more than `max_flushes_per_search`
+// times in a single search, the states wouldn't be reused often enough to be worth caching.
+static constexpr size_t max_state_count = 1000;
+static constexpr size_t max_flushes_per_search = 4;
+
+static bool is_word_character(u32 ch)
+{
+    return is_ascii_alphanumeric(ch) || ch == '_';
+}
+
+OwnPtr<LazyDFA> LazyDFA::try_create(ByteCode const& bytecode)
+{
+    auto dfa = adopt_own(*new LazyDFA);
+    if (!dfa->compile(bytecode))
+        return nullptr;
+    return dfa;
+}
+
+bool LazyDFA::compile(ByteCode const& bytecode)
+{
+    m_bytecode_size = bytecode.size();
+    if (m_bytecode_size >= node_flag)
+        return false;
+
+    m_instruction_at.ensure_capacity(m_bytecode_size);
+    for (size_t i = 0; i < m_bytecode_size; ++i)
+        m_instruction_at.unchecked_append(no_instruction);
+
+    MatchState state;
+    while (state.instruction_position < m_bytecode_size) {
+        auto& opcode = bytecode.get_opcode(state);
+        auto ip = state.instruction_position;
+        auto next_ip = ip + opcode.size();
+        Instruction instruction { opcode.opcode_id(), ip, next_ip };
+
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (!compile_compare(bytecode, instruction))
+                return false;
+            break;
+        case OpCodeId::Jump:
+            instruction.target_ip = next_ip + to<OpCode_Jump>(opcode).offset();
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            instruction.target_ip = next_ip + to<OpCode_ForkJump>(opcode).offset();
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            instruction.target_ip = next_ip + to<OpCode_ForkStay>(opcode).offset();
+            break;
+        case OpCodeId::JumpNonEmpty: {
+            auto& jump = to<OpCode_JumpNonEmpty>(opcode);
+            instruction.target_ip = next_ip + jump.offset();
+            instruction.checkpoint_ip = next_ip + jump.checkpoint();
+            instruction.form = jump.form();
+            switch (instruction.form) {
+            case OpCodeId::Jump:
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkStay:
+            case OpCodeId::ForkReplaceJump:
+            case OpCodeId::ForkReplaceStay:
+                break;
+            default:
+                return false;
+            }
+            break;
+        }
+        case OpCodeId::CheckBoundary:
+            instruction.boundary_type = to<OpCode_CheckBoundary>(opcode).type();
+            break;
+        case OpCodeId::Checkpoint:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::Exit:
+            break;
+        default:
+            // Lookarounds are made of Save, Restore, GoBack and FailForks, and Repeat counts the iterations of a single
+            // path; none of them mean anything when all the paths are followed at once.
+            return false;
+        }
+
+        m_instruction_at[ip] = m_instructions.size();
+        m_instructions.append(move(instruction));
+        state.instruction_position = next_ip;
+    }
+
+    auto is_valid_target = [&](size_t ip) {
+        return ip >= m_bytecode_size || m_instruction_at[ip] != no_instruction;
+    };
+    for (auto& instruction : m_instructions) {
+        switch (instruction.opcode_id) {
+        case OpCodeId::Jump:
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+        case OpCodeId::JumpNonEmpty:
+            if (!is_valid_target(instruction.target_ip))
+                return false;
+            break;
+        default:
+            break;
+        }
+    }
+
+    auto slot_count = m_instructions.size() + 1 + m_nodes.size();
+    m_visited.resize(slot_count + m_instructions.size());
+    m_added.resize(slot_count);
+    m_steps.ensure_capacity(m_nodes.size());
+    return true;
+}
+
+bool LazyDFA::compile_compare(ByteCode const& bytecode, Instruction& instruction)
+{
+    auto argument_count = bytecode.at(instruction.ip + 1);
+    auto offset = instruction.ip + 3;
+    for (size_t i = 0; i < argument_count; ++i) {
+        auto compare_type = (CharacterCompareType)bytecode.at(offset++);
+        switch (compare_type) {
+        case CharacterCompareType::Inverse:
+        case CharacterCompareType::TemporaryInverse:
+        case CharacterCompareType::AnyChar:
+        case CharacterCompareType::And:
+        case CharacterCompareType::Or:
+        case CharacterCompareType::EndAndOr:
+            break;
+        case CharacterCompareType::Char:
+        case CharacterCompareType::CharClass:
+        case CharacterCompareType::CharRange:
+        case CharacterCompareType::Property:
+        case CharacterCompareType::GeneralCategory:
+        case CharacterCompareType::Script:
+        case CharacterCompareType::ScriptExtension:
+            ++offset;
+            break;
+        case CharacterCompareType::LookupTable: {
+            auto count = bytecode.at(offset++);
+            offset += count;
+            break;
+        }
+        case CharacterCompareType::String: {
+            // A string is matched one character at a time, which only works if nothing else is compared along with it.
+            if (argument_count != 1)
+                return false;
+            auto length = bytecode.at(offset++);
+            if (length == 0)
+                return false;
+            for (size_t j = 0; j < length; ++j) {
+                auto ch = static_cast<u32>(bytecode.at(offset++));
+                // The characters of a Utf16View are compared one code unit at a time.
+                if (ch > 0xffff || is_unicode_surrogate(ch))
+                    m_can_match_utf16 = false;
+                instruction.string.append(ch);
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    instruction.first_node = m_nodes.size();
+    auto node_count = max<size_t>(instruction.string.size(), 1);
+    for (size_t i = 0; i < node_count; ++i)
+        m_nodes.append({ static_cast<u32>(m_instructions.size()), static_cast<u32>(i) });
+    return true;
+}
+
+bool LazyDFA::can_match(RegexStringView const& view, AllOptions options) const
+{
+    if (view.unicode() || view.is_u8_view())
+        return false;
+    if (view.is_u16_view() && !m_can_match_utf16)
+        return false;
+    return !options.has_flag_set(AllFlags::MatchNotBeginOfLine) && !options.has_flag_set(AllFlags::MatchNotEndOfLine);
+}
+
+u32 LazyDFA::next_generation()
+{
+    if (++m_generation == 0) {
+        for (auto& generation : m_visited)
+            generation = 0;
+        for (auto& generation : m_added)
+            generation = 0;
+        m_generation = 1;
+    }
+    return m_generation;
+}
+
+u32 LazyDFA::slot_of(u32 resume_point) const
+{
+    if (resume_point & node_flag)
+        return m_instructions.size() + 1 + (resume_point & ~node_flag);
+    if (resume_point >= m_bytecode_size)
+        return m_instructions.size();
+    return m_instruction_at[resume_point];
+}
+
+u32 LazyDFA::resume_point_after(u32 node_index) const
+{
+    auto const& node = m_nodes[node_index];
+    auto const& instruction = m_instructions[node.instruction];
+    if (node.string_index + 1 < instruction.string.size())
+        return node_flag | (node_index + 1);
+    return min(instruction.next_ip, m_bytecode_size);
+}
+
+// Follows the threads through everything that doesn't consume a character, in the order the VM would try it, and puts
+// the nodes they get to into m_steps. Returns the thread that got to the end of the bytecode, if one did; the VM would
+// stop there, so nothing it would have tried after that is followed.
+Optional<size_t> LazyDFA::expand(Span<u32 const> threads, bool searching, Context const& context)
+{
+    auto generation = next_generation();
+    auto visit = [&](u32 slot) {
+        if (m_visited[slot] == generation)
+            return false;
+        m_visited[slot] = generation;
+        return true;
+    };
+    auto empty_loop_slots = m_instructions.size() + 1 + m_nodes.size();
+
+    m_steps.clear_with_capacity();
+    auto thread_count = threads.size() + (searching ? 1 : 0);
+    for (size_t thread = 0; thread < thread_count; ++thread) {
+        m_pending_paths.clear_with_capacity();
+        m_checkpoints.clear_with_capacity();
+        // Entry 0 is the end of every list of checkpoints a path went past.
+        m_checkpoints.append({ 0, 0 });
+        m_pending_paths.append({ thread < threads.size() ? threads[thread] : 0, 0 });
+
+        while (!m_pending_paths.is_empty()) {
+            auto path = m_pending_paths.take_last();
+            auto follow = [&](size_t ip) {
+                m_pending_paths.append({ static_cast<u32>(min(ip, m_bytecode_size)), path.checkpoints });
+            };
+
+            if (path.resume_point & node_flag) {
+                if (visit(slot_of(path.resume_point)))
+                    m_steps.append({ path.resume_point & ~node_flag, static_cast<u32>(thread) });
+                continue;
+            }
+            if (path.resume_point >= m_bytecode_size)
+                return thread;
+
+            auto index = m_instruction_at[path.resume_point];
+            auto const& instruction = m_instructions[index];
+            if (instruction.opcode_id == OpCodeId::Compare) {
+                if (visit(slot_of(node_flag | instruction.first_node)))
+                    m_steps.append({ instruction.first_node, static_cast<u32>(thread) });
+                continue;
+            }
+
+            // An iteration of a loop is empty if the path went past its checkpoint without consuming anything since.
+            bool is_empty_iteration = false;
+            if (instruction.opcode_id == OpCodeId::JumpNonEmpty) {
+                for (auto entry = path.checkpoints; entry != 0; entry = m_checkpoints[entry].parent) {
+                    if (m_checkpoints[entry].ip == instruction.checkpoint_ip) {
+                        is_empty_iteration = true;
+                        break;
+                    }
+                }
+            }
+            if (!visit(is_empty_iteration ? empty_loop_slots + index : index))
+                continue;
+
+            // The paths are taken off the end, so the one the VM would try first goes last.
+            auto fork = [&](OpCodeId kind) {
+                switch (kind) {
+                case OpCodeId::Jump:
+                    follow(instruction.target_ip);
+                    break;
+                case OpCodeId::ForkJump:
+                case OpCodeId::ForkReplaceJump:
+                    follow(instruction.next_ip);
+                    follow(instruction.target_ip);
+                    break;
+                case OpCodeId::ForkStay:
+                case OpCodeId::ForkReplaceStay:
+                    follow(instruction.target_ip);
+                    follow(instruction.next_ip);
+                    break;
+                default:
+                    VERIFY_NOT_REACHED();
+                }
+            };
+
+            switch (instruction.opcode_id) {
+            case OpCodeId::Jump:
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkReplaceJump:
+            case OpCodeId::ForkStay:
+            case OpCodeId::ForkReplaceStay:
+                fork(instruction.opcode_id);
+                break;
+            case OpCodeId::JumpNonEmpty:
+                if (is_empty_iteration)
+                    follow(instruction.next_ip);
+                else
+                    fork(instruction.form);
+                break;
+            case OpCodeId::Checkpoint:
+                m_checkpoints.append({ instruction.ip, path.checkpoints });
+                m_pending_paths.append({ static_cast<u32>(instruction.next_ip), static_cast<u32>(m_checkpoints.size() - 1) });
+                break;
+            case OpCodeId::CheckBegin:
+                if (context.at_start || (m_multiline && context.after_newline))
+                    follow(instruction.next_ip);
+                break;
+            case OpCodeId::CheckEnd:
+                if (!context.next_character.has_value() || (m_multiline && *context.next_character == '\n'))
+                    follow(instruction.next_ip);
+                break;
+            case OpCodeId::CheckBoundary: {
+                auto is_before_word_character = context.next_character.has_value() && is_word_character(*context.next_character);
+                auto is_boundary = context.after_word_character != is_before_word_character;
+                if (is_boundary == (instruction.boundary_type == BoundaryCheckType::Word))
+                    follow(instruction.next_ip);
+                break;
+            }
+            case OpCodeId::Exit:
+                break;
+            default:
+                follow(instruction.next_ip);
+                break;
+            }
+        }
+    }
+    return {};
+}
+
+bool LazyDFA::matches(ByteCode const& bytecode, MatchInput const& input, size_t position, u32 node_index)
+{
+    auto const& node = m_nodes[node_index];
+    auto const& instruction = m_instructions[node.instruction];
+
+    if (!instruction.string.is_empty()) {
+        auto ch = input.view[position];
+        auto expected = instruction.string[node.string_index];
+        // The VM turns the string back into the kind of view it's comparing against, which for a StringView keeps
+        // only the low byte of every character.
+        if (input.view.is_string_view())
+            expected &= 0xff;
+        if (m_insensitive)
+            return to_ascii_lowercase(ch) == to_ascii_lowercase(expected);
+        return ch == expected;
+    }
+
+    m_compare_state.instruction_position = instruction.ip;
+    m_compare_state.string_position = position;
+    m_compare_state.string_position_in_code_units = position;
+    auto& opcode = bytecode.get_opcode(m_compare_state);
+    auto result = opcode.execute(input, m_compare_state);
+    return result == ExecutionResult::Continue && m_compare_state.string_position == position + 1;
+}
+
+u8 LazyDFA::flags_after(u32 ch)
+{
+    u8 flags = 0;
+    if (ch == '\n')
+        flags |= AfterNewline;
+    if (is_word_character(ch))
+        flags |= AfterWordCharacter;
+    return flags;
+}
+
+u8 LazyDFA::flags_at(MatchInput const& input, size_t position) const
+{
+    if (position == 0)
+        return AtStart;
+    return flags_after(input.view[position - 1]);
+}
+
+Optional<u32> LazyDFA::find_state(Vector<u32> const& threads, u8 flags) const
+{
+    u32 hash = int_hash(flags);
+    for (auto thread : threads)
+        hash = pair_int_hash(hash, thread);
+
+    auto states = m_states_by_hash.find(hash);
+    if (states == m_states_by_hash.end())
+        return {};
+    for (auto index : states->value) {
+        auto const& state = m_states[index];
+        if (state.flags == flags && state.threads == threads)
+            return index;
+    }
+    return {};
+}
+
+u32 LazyDFA::add_state(Vector<u32>&& threads, u8 flags)
+{
+    if (m_states.size() >= max_state_count) {
+        flush();
+        ++m_flushes_in_search;
+    }
+
+    u32 hash = int_hash(flags);
+    for (auto thread : threads)
+        hash = pair_int_hash(hash, thread);
+
+    u32 index = m_states.size();
+    auto state = make<State>();
+    state->threads = move(threads);
+    state->flags = flags;
+    m_states.append(move(state));
+    m_states_by_hash.ensure(hash).append(index);
+    return index;
+}
+
+void LazyDFA::flush()
+{
+    m_states.clear();
+    m_states_by_hash.clear();
+    ++m_flush_count;
+}
+
+// Transitions are stored as the index of the state they go to plus one, shifted left by one, with the lowest bit set
+// if a match ended right before the character. So a transition that hasn't been worked out yet is 0.
+u32 LazyDFA::compute_transition(ByteCode const& bytecode, MatchInput const& input, u32 state_index, size_t position, u32 ch)
+{
+    auto const& state = m_states[state_index];
+    Context context {
+        .at_start = (state.flags & AtStart) != 0,
+        .after_newline = (state.flags & AfterNewline) != 0,
+        .after_word_character = (state.flags & AfterWordCharacter) != 0,
+        .next_character = ch,
+    };
+    bool searching = (state.flags & Searching) != 0;
+    bool accepted = expand(state.threads.span(), searching, context).has_value();
+
+    Vector<u32> threads;
+    auto generation = next_generation();
+    for (auto& step : m_steps) {
+        if (!matches(bytecode, input, position, step.node))
+            continue;
+        auto resume_point = resume_point_after(step.node);
+        auto slot = slot_of(resume_point);
+        if (m_added[slot] == generation)
+            continue;
+        m_added[slot] = generation;
+        threads.append(resume_point);
+    }
+
+    auto flags = flags_after(ch);
+    if (searching && !accepted)
+        flags |= Searching;
+    auto target = find_state(threads, flags);
+    if (!target.has_value())
+        target = add_state(move(threads), flags);
+    return ((*target + 1) << 1) | (accepted ? 1 : 0);
+}
+
+LazyDFA::Outcome LazyDFA::run_dfa(ByteCode const& bytecode, MatchInput const& input, size_t start, bool anchored, size_t& end)
+{
+    auto const& view = input.view;
+    auto length = view.length();
+    auto is_u16_view = view.is_u16_view();
+
+    Vector<u32> initial_threads;
+    if (anchored)
+        initial_threads.append(0);
+    u8 initial_flags = flags_at(input, start) | (anchored ? 0 : Searching);
+    auto state_index = find_state(initial_threads, initial_flags);
+    if (!state_index.has_value())
+        state_index = add_state(move(initial_threads), initial_flags);
+
+    bool found = false;
+    for (auto position = start;; ++position) {
+        auto& state = m_states[*state_index];
+        if (position == length) {
+            if (!state.accepts_at_end.has_value()) {
+                Context context {
+                    .at_start = (state.flags & AtStart) != 0,
+                    .after_newline = (state.flags & AfterNewline) != 0,
+                    .after_word_character = (state.flags & AfterWordCharacter) != 0,
+                    .next_character = {},
+                };
+                state.accepts_at_end = expand(state.threads.span(), (state.flags & Searching) != 0, context).has_value();
+            }
+            if (*state.accepts_at_end) {
+                end = position;
+                found = true;
+            }
+            break;
+        }
+
+        auto ch = view[position];
+        // A Utf16View hands out whole code points, but a Compare may look at just the code unit, so the two have to be
+        // the same for what the Compare did to be remembered.
+        auto is_cacheable = !is_u16_view || (ch <= 0xffff && !is_unicode_surrogate(ch));
+
+        u32 transition = 0;
+        if (ch < state.transitions.size()) {
+            transition = state.transitions[ch];
+        } else if (auto it = state.wide_transitions.find(ch); it != state.wide_transitions.end()) {
+            transition = it->value;
+        }
+
+        if (transition == 0 || !is_cacheable) {
+            auto flushes_before = m_flushes_in_search;
+            transition = compute_transition(bytecode, input, *state_index, position, ch);
+            if (m_flushes_in_search > max_flushes_per_search)
+                return Outcome::GaveUp;
+            // If the states were thrown away, the one the transition came from is gone.
+            if (is_cacheable && flushes_before == m_flushes_in_search) {
+                auto& from = m_states[*state_index];
+                if (ch < from.transitions.size())
+                    from.transitions[ch] = transition;
+                else
+                    from.wide_transitions.set(ch, transition);
+            }
+        }
+
+        if (transition & 1) {
+            end = position;
+            found = true;
+        }
+        state_index = (transition >> 1) - 1;
+
+        auto const& next_state = m_states[*state_index];
+        if (next_state.threads.is_empty() && !(next_state.flags & Searching))
+            break;
+    }
+    return found ? Outcome::Match : Outcome::NoMatch;
+}
+
+// Runs the threads over the input without any DFA states, keeping track of where each of them started. Used to find
+// where a match starts, and for inputs that make too many states.
+Optional<LazyDFA::Match> LazyDFA::run_threads(ByteCode const& bytecode, MatchInput const& input, size_t start, bool anchored, Optional<size_t> end)
+{
+    auto const& view = input.view;
+    auto length = view.length();
+    auto last_position = end.value_or(length);
+
+    Vector<u32> threads;
+    Vector<size_t> starts;
+    if (anchored) {
+        threads.append(0);
+        starts.append(start);
+    }
+    auto flags = flags_at(input, start);
+    bool searching = !anchored;
+
+    Optional<Match> match;
+    Vector<u32> next_threads;
+    Vector<size_t> next_starts;
+    for (auto position = start;; ++position) {
+        Optional<u32> next_character;
+        if (position < length)
+            next_character = view[position];
+        Context context {
+            .at_start = (flags & AtStart) != 0,
+            .after_newline = (flags & AfterNewline) != 0,
+            .after_word_character = (flags & AfterWordCharacter) != 0,
+            .next_character = next_character,
+        };
+
+        if (searching)
+            starts.append(position);
+        if (auto thread = expand(threads.span(), searching, context); thread.has_value()) {
+            match = Match { starts[*thread], position };
+            searching = false;
+        }
+        if (position == last_position || !next_character.has_value())
+            break;
+
+        next_threads.clear_with_capacity();
+        next_starts.clear_with_capacity();
+        auto generation = next_generation();
+        for (auto& step : m_steps) {
+            if (!matches(bytecode, input, position, step.node))
+                continue;
+            auto resume_point = resume_point_after(step.node);
+            auto slot = slot_of(resume_point);
+            if (m_added[slot] == generation)
+                continue;
+            m_added[slot] = generation;
+            next_threads.append(resume_point);
+            next_starts.append(starts[step.thread]);
+        }
+        swap(threads, next_threads);
+        swap(starts, next_starts);
+        flags = flags_after(*next_character);
+
+        if (threads.is_empty() && !searching)
+            break;
+    }
+    return match;
+}
+
+Optional<LazyDFA::Match> LazyDFA::find(ByteCode const& bytecode, MatchInput const& input, size_t start, bool anchored)
+{
+    // What the Compares did is remembered in the states, and depends on the options.
+    if (!m_options.has_value() || *m_options != input.regex_options.value()) {
+        if (m_options.has_value())
+            flush();
+        m_options = input.regex_options.value();
+        m_multiline = input.regex_options.has_flag_set(AllFlags::Multiline) && input.regex_options.has_flag_set(AllFlags::Internal_ConsiderNewline);
+        m_insensitive = input.regex_options.has_flag_set(AllFlags::Insensitive);
+    }
+    m_flushes_in_search = 0;
+
+    size_t end = 0;
+    switch (run_dfa(bytecode, input, start, anchored, end)) {
+    case Outcome::NoMatch:
+        return {};
+    case Outcome::Match:
+        if (anchored)
+            return Match { start, end };
+        // The DFA only knows where the match ends, the threads know where it started.
+        return run_threads(bytecode, input, start, false, end);
+    case Outcome::GaveUp:
+        return run_threads(bytecode, input, start, anchored, {});
+    }
+    VERIFY_NOT_REACHED();
+}
+
+}
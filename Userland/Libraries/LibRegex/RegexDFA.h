@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+#include "RegexOptions.h"
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// Finds the matches of a pattern in time linear to the length of the input, instead of backtracking through it.
+//
+// All the paths through the bytecode are followed at once, in the order the VM would try them one after the other, so
+// the match found is the one the VM would have found first. The sets of paths that are alive at some point of the input
+// become the states of a DFA as it is run over the input, and the transitions between them are remembered, so every
+// character after the first few mostly takes a single lookup. If an input makes more states than we are willing to
+// keep, they are thrown away; if that keeps happening, the rest of the input is matched without caching any states,
+// which is slower, but just as linear.
+//
+// Only patterns that need the VM for nothing but their capture groups can be matched like this, so anything with
+// backreferences, lookarounds or counted repetitions doesn't get a LazyDFA.
+class LazyDFA {
+    AK_MAKE_NONCOPYABLE(LazyDFA);
+    AK_MAKE_NONMOVABLE(LazyDFA);
+
+public:
+    static OwnPtr<LazyDFA> try_create(ByteCode const&);
+
+    struct Match {
+        size_t start;
+        size_t end;
+    };
+
+    // Whether find() can match the view with these options, which it can't if positions in the view aren't all a single
+    // code unit, or if the options change what it means to be at the beginning or end of a line.
+    bool can_match(RegexStringView const&, AllOptions) const;
+
+    // The match the VM would find first if it was run from every position starting at `start` one after the other, or
+    // only from `start` if the search is anchored.
+    Optional<Match> find(ByteCode const&, MatchInput const&, size_t start, bool anchored);
+
+    size_t state_count() const { return m_states.size(); }
+    size_t flush_count() const { return m_flush_count; }
+
+private:
+    LazyDFA() = default;
+
+    struct Instruction {
+        OpCodeId opcode_id { OpCodeId::Jump };
+        size_t ip { 0 };
+        size_t next_ip { 0 };
+        size_t target_ip { 0 };
+        size_t checkpoint_ip { 0 };
+        OpCodeId form { OpCodeId::Jump };
+        BoundaryCheckType boundary_type { BoundaryCheckType::Word };
+        // A Compare of a whole string has a node for every character of it, all other Compares have a single one.
+        Vector<u32> string {};
+        u32 first_node { 0 };
+    };
+
+    struct Node {
+        u32 instruction;
+        u32 string_index;
+    };
+
+    // What the assertions of the pattern need to know about where in the input the paths are.
+    struct Context {
+        bool at_start { false };
+        bool after_newline { false };
+        bool after_word_character { false };
+        Optional<u32> next_character;
+    };
+
+    // A path that has reached a node, and the thread it came from.
+    struct Step {
+        u32 node;
+        u32 thread;
+    };
+
+    struct State {
+        // Where the paths that are alive continue, best one first. A position in the bytecode, or a node in the middle
+        // of a string.
+        Vector<u32> threads;
+        u8 flags { 0 };
+        Array<u32, 256> transitions {};
+        HashMap<u32, u32> wide_transitions;
+        Optional<bool> accepts_at_end;
+    };
+
+    enum StateFlags : u8 {
+        AtStart = 1 << 0,
+        AfterNewline = 1 << 1,
+        AfterWordCharacter = 1 << 2,
+        // No match was found yet, so a new path starts before every character.
+        Searching = 1 << 3,
+    };
+
+    bool compile(ByteCode const&);
+    bool compile_compare(ByteCode const&, Instruction&);
+
+    u32 slot_of(u32 resume_point) const;
+    u32 resume_point_after(u32 node) const;
+    Optional<size_t> expand(Span<u32 const> threads, bool searching, Context const&);
+    bool matches(ByteCode const&, MatchInput const&, size_t position, u32 node);
+
+    enum class Outcome {
+        NoMatch,
+        Match,
+        GaveUp,
+    };
+    Outcome run_dfa(ByteCode const&, MatchInput const&, size_t start, bool anchored, size_t& end);
+    u32 compute_transition(ByteCode const&, MatchInput const&, u32 state_index, size_t position, u32 ch);
+    Optional<Match> run_threads(ByteCode const&, MatchInput const&, size_t start, bool anchored, Optional<size_t> end);
+
+    static u8 flags_after(u32 ch);
+    u8 flags_at(MatchInput const&, size_t position) const;
+    Optional<u32> find_state(Vector<u32> const& threads, u8 flags) const;
+    u32 add_state(Vector<u32>&& threads, u8 flags);
+    void flush();
+    u32 next_generation();
+
+    Vector<Instruction> m_instructions;
+    Vector<Node> m_nodes;
+    Vector<u32> m_instruction_at;
+    size_t m_bytecode_size { 0 };
+    bool m_can_match_utf16 { true };
+
+    NonnullOwnPtrVector<State> m_states;
+    HashMap<u32, Vector<u32>> m_states_by_hash;
+    Optional<AllFlags> m_options;
+    size_t m_flush_count { 0 };
+    size_t m_flushes_in_search { 0 };
+
+    bool m_multiline { false };
+    bool m_insensitive { false };
+
+    // Scratch space for expand() and the steps after it, kept around to not allocate it again for every character.
+    struct PendingPath {
+        u32 resume_point;
+        u32 checkpoints;
+    };
+    struct CheckpointEntry {
+        size_t ip;
+        u32 parent;
+    };
+    Vector<PendingPath> m_pending_paths;
+    Vector<CheckpointEntry> m_checkpoints;
+    Vector<Step> m_steps;
+    Vector<u32> m_visited;
+    Vector<u32> m_added;
+    u32 m_generation { 0 };
+    MatchState m_compare_state;
+};
+
+}
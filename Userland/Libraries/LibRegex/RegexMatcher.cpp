@@ -6,6 +6,7 @@
 
 #include <AK/BumpAllocator.h>
 #include <AK/Debug.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <LibRegex/RegexMatcher.h>
@@ -40,8 +41,10 @@ Regex<Parser>::Regex(String pattern, typename ParserTraits<Parser>::OptionsType
     parser_result = parser.parse();
 
     run_optimization_passes();
-    if (parser_result.error == regex::Error::NoError)
+    if (parser_result.error == regex::Error::NoError) {
         matcher = make<Matcher<Parser>>(this, static_cast<decltype(regex_options.value())>(parser_result.options.value()));
+        lazy_dfa = LazyDFA::try_create(parser_result.bytecode);
+    }
 }
 
 template<class Parser>
@@ -50,8 +53,10 @@ Regex<Parser>::Regex(regex::Parser::Result parse_result, String pattern, typenam
     , parser_result(move(parse_result))
 {
     run_optimization_passes();
-    if (parser_result.error == regex::Error::NoError)
+    if (parser_result.error == regex::Error::NoError) {
         matcher = make<Matcher<Parser>>(this, regex_options | static_cast<decltype(regex_options.value())>(parse_result.options.value()));
+        lazy_dfa = LazyDFA::try_create(parser_result.bytecode);
+    }
 }
 
 template<class Parser>
@@ -59,6 +64,7 @@ Regex<Parser>::Regex(Regex&& regex)
     : pattern_value(move(regex.pattern_value))
     , parser_result(move(regex.parser_result))
     , matcher(move(regex.matcher))
+    , lazy_dfa(move(regex.lazy_dfa))
     , start_offset(regex.start_offset)
 {
     if (matcher)
@@ -73,6 +79,7 @@ Regex<Parser>& Regex<Parser>::operator=(Regex&& regex)
     matcher = move(regex.matcher);
     if (matcher)
         matcher->reset_pattern({}, this);
+    lazy_dfa = move(regex.lazy_dfa);
     start_offset = regex.start_offset;
     return *this;
 }
@@ -99,6 +106,48 @@ String Regex<Parser>::error_string(Optional<String> message) const
     return eb.build();
 }
 
+// Looks at 16 positions at a time for the first and the last character of the literal, and only compares the rest of
+// it where both are there.
+static Optional<size_t> find_literal(StringView haystack, StringView literal, size_t start)
+{
+    using AK::SIMD::u64x2;
+    using AK::SIMD::u8x16;
+
+    auto length = literal.length();
+    VERIFY(length != 0);
+    if (start > haystack.length() || haystack.length() - start < length)
+        return {};
+
+    auto const* characters = haystack.characters_without_null_termination();
+    auto last_start = haystack.length() - length;
+    auto first_character = static_cast<u8>(literal[0]);
+    auto last_character = static_cast<u8>(literal[length - 1]);
+    auto is_at = [&](size_t position) {
+        return __builtin_memcmp(characters + position, literal.characters_without_null_termination(), length) == 0;
+    };
+
+    auto position = start;
+    for (; position + sizeof(u8x16) <= last_start + 1; position += sizeof(u8x16)) {
+        u8x16 firsts;
+        u8x16 lasts;
+        __builtin_memcpy(&firsts, characters + position, sizeof(firsts));
+        __builtin_memcpy(&lasts, characters + position + length - 1, sizeof(lasts));
+        auto candidates = (firsts == first_character) & (lasts == last_character);
+        auto candidate_words = (u64x2)candidates;
+        if ((candidate_words[0] | candidate_words[1]) == 0)
+            continue;
+        for (size_t i = 0; i < sizeof(u8x16); ++i) {
+            if (candidates[i] && is_at(position + i))
+                return position + i;
+        }
+    }
+    for (; position <= last_start; ++position) {
+        if (static_cast<u8>(characters[position]) == first_character && is_at(position))
+            return position;
+    }
+    return {};
+}
+
 template<typename Parser>
 RegexResult Matcher<Parser>::match(RegexStringView view, Optional<typename ParserTraits<Parser>::OptionsType> regex_options) const
 {
@@ -184,6 +233,8 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
         continue_search = false;
 
     auto single_match_only = input.regex_options.has_flag_set(AllFlags::SingleMatch);
+    auto has_capture_groups = m_pattern->parser_result.capture_groups_count != 0 || m_pattern->parser_result.named_capture_groups_count != 0;
+    auto const& optimization_data = m_pattern->parser_result.optimization_data;
 
     for (auto const& view : views) {
         if (lines_to_skip != 0) {
@@ -199,6 +250,9 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
         state.string_position = view_index;
         state.string_position_in_code_units = view_index;
         bool succeeded = false;
+        bool use_lazy_dfa = m_pattern->lazy_dfa && m_pattern->lazy_dfa->can_match(view, input.regex_options);
+        // The literals are ASCII, and they can only be looked for as they are in text that is ASCII compatible.
+        bool use_literals = view.is_string_view() && !view.unicode() && !input.regex_options.has_flag_set(AllFlags::Insensitive);
 
         if (view_index == view_length && m_pattern->parser_result.match_length_minimum == 0) {
             // Run the code until it tries to consume something.
@@ -226,6 +280,10 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             }
         }
 
+        // Every match contains this somewhere, so if the view doesn't, there's no need to look for a match in it at all.
+        if (use_literals && !optimization_data.required_literal.is_empty() && !find_literal(view.string_view(), optimization_data.required_literal, view_index).has_value())
+            view_index = view_length + 1;
+
         for (; view_index <= view_length; ++view_index) {
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
@@ -240,6 +298,37 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             if (match_length_minimum && match_length_minimum > view_length - view_index)
                 break;
 
+            if (use_literals && !optimization_data.required_prefix.is_empty()) {
+                // A match can only start where the text every match starts with is.
+                auto const& prefix = optimization_data.required_prefix;
+                if (!continue_search) {
+                    if (!view.string_view().substring_view(view_index).starts_with(prefix))
+                        break;
+                } else {
+                    auto prefix_index = find_literal(view.string_view(), prefix, view_index);
+                    if (!prefix_index.has_value())
+                        break;
+                    view_index = *prefix_index;
+                    if (match_length_minimum && match_length_minimum > view_length - view_index)
+                        break;
+                }
+            }
+
+            Optional<LazyDFA::Match> dfa_match;
+            if (use_lazy_dfa) {
+                // Let the DFA find where the next match is, so the VM is only ever run where it will succeed, and not
+                // at all if there are no capture groups for it to fill in.
+                dfa_match = m_pattern->lazy_dfa->find(m_pattern->parser_result.bytecode, input, view_index, !continue_search);
+                if (!dfa_match.has_value())
+                    break;
+
+                view_index = dfa_match->start;
+                if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
+                    break;
+                if (match_length_minimum && match_length_minimum > view_length - view_index)
+                    break;
+            }
+
             input.column = match_count;
             input.match_index = match_count;
 
@@ -248,7 +337,14 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             state.instruction_position = 0;
             state.repetition_marks.clear();
 
-            auto success = execute(input, state, operations);
+            bool success;
+            if (dfa_match.has_value() && !has_capture_groups) {
+                state.string_position = dfa_match->end;
+                state.string_position_in_code_units = dfa_match->end;
+                success = true;
+            } else {
+                success = execute(input, state, operations);
+            }
             if (success) {
                 succeeded = true;
 
@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/QuickSort.h>
 #include <AK/RedBlackTree.h>
 #include <AK/Stack.h>
+#include <AK/StringBuilder.h>
 #include <LibRegex/Regex.h>
 #include <LibRegex/RegexBytecodeStreamOptimizer.h>
 #if REGEX_DEBUG
@@ -28,6 +31,187 @@ void Regex<Parser>::run_optimization_passes()
     attempt_rewrite_loops_as_atomic_groups(split_basic_blocks(parser_result.bytecode));
 
     parser_result.bytecode.flatten();
+
+    fill_optimization_data();
+}
+
+// The text a Compare matches, if it matches nothing but some ASCII text.
+static Optional<String> literal_compared_by(ByteCode const& bytecode, size_t ip)
+{
+    if (bytecode.at(ip + 1) != 1)
+        return {};
+
+    auto compare_type = (CharacterCompareType)bytecode.at(ip + 3);
+    if (compare_type == CharacterCompareType::Char) {
+        auto ch = bytecode.at(ip + 4);
+        if (ch > 0x7f)
+            return {};
+        return String::repeated(static_cast<char>(ch), 1);
+    }
+    if (compare_type != CharacterCompareType::String)
+        return {};
+
+    auto length = bytecode.at(ip + 4);
+    StringBuilder builder;
+    for (size_t i = 0; i < length; ++i) {
+        auto ch = bytecode.at(ip + 5 + i);
+        if (ch > 0x7f)
+            return {};
+        builder.append(static_cast<char>(ch));
+    }
+    return builder.to_string();
+}
+
+template<typename Parser>
+void Regex<Parser>::fill_optimization_data()
+{
+    // Finding out whether a Compare is on every path through the bytecode means walking all the others once for it,
+    // which isn't worth it for huge patterns.
+    static constexpr size_t max_instructions_to_analyze = 1000;
+
+    auto& bytecode = parser_result.bytecode;
+    auto& data = parser_result.optimization_data;
+    data = {};
+
+    struct Instruction {
+        OpCodeId opcode_id;
+        Vector<size_t, 2> successors;
+        Optional<String> literal;
+        size_t predecessor_count { 0 };
+    };
+    Vector<Instruction> instructions;
+    HashMap<size_t, size_t> instruction_at;
+
+    auto bytecode_size = bytecode.size();
+    MatchState state;
+    state.instruction_position = 0;
+    while (state.instruction_position < bytecode_size) {
+        if (instructions.size() == max_instructions_to_analyze)
+            return;
+
+        auto& opcode = bytecode.get_opcode(state);
+        auto ip = state.instruction_position;
+        auto next_ip = ip + opcode.size();
+        Instruction instruction { opcode.opcode_id(), {}, {} };
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            instruction.literal = literal_compared_by(bytecode, ip);
+            instruction.successors.append(next_ip);
+            break;
+        case OpCodeId::Jump:
+            instruction.successors.append(next_ip + static_cast<OpCode_Jump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            instruction.successors.append(next_ip);
+            instruction.successors.append(next_ip + static_cast<OpCode_ForkJump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            instruction.successors.append(next_ip);
+            instruction.successors.append(next_ip + static_cast<OpCode_ForkStay const&>(opcode).offset());
+            break;
+        case OpCodeId::JumpNonEmpty:
+            instruction.successors.append(next_ip);
+            instruction.successors.append(next_ip + static_cast<OpCode_JumpNonEmpty const&>(opcode).offset());
+            break;
+        case OpCodeId::Repeat:
+            instruction.successors.append(next_ip);
+            instruction.successors.append(ip - static_cast<OpCode_Repeat const&>(opcode).offset());
+            break;
+        case OpCodeId::Exit:
+            instruction.successors.append(bytecode_size);
+            break;
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::FailForks:
+            // Lookarounds match text that isn't part of the match, or have to not match it at all.
+            return;
+        default:
+            instruction.successors.append(next_ip);
+            break;
+        }
+        instruction_at.set(ip, instructions.size());
+        instructions.append(move(instruction));
+        state.instruction_position = next_ip;
+    }
+
+    // From here on, successors are indices into `instructions`, and the one past the last of them is where a match ends.
+    auto accept = instructions.size();
+    for (auto& instruction : instructions) {
+        for (auto& successor : instruction.successors) {
+            if (successor >= bytecode_size) {
+                successor = accept;
+                continue;
+            }
+            auto index = instruction_at.get(successor);
+            if (!index.has_value())
+                return;
+            successor = *index;
+            ++instructions[successor].predecessor_count;
+        }
+    }
+
+    if (instructions.is_empty())
+        return;
+
+    StringBuilder prefix;
+    HashTable<size_t> seen;
+    for (size_t index = 0; index != accept && !seen.contains(index); index = instructions[index].successors.first()) {
+        seen.set(index);
+        auto const& instruction = instructions[index];
+        if (instruction.successors.size() != 1)
+            break;
+        if (instruction.opcode_id == OpCodeId::Compare) {
+            if (!instruction.literal.has_value())
+                break;
+            prefix.append(*instruction.literal);
+        } else if (instruction.opcode_id == OpCodeId::Exit) {
+            break;
+        }
+    }
+    data.required_prefix = prefix.to_string();
+
+    Vector<bool> visited;
+    auto can_match_without = [&](size_t excluded) {
+        if (excluded == 0)
+            return false;
+        visited.clear_with_capacity();
+        visited.resize(instructions.size() + 1);
+        Vector<size_t> pending;
+        pending.append(0);
+        visited[0] = true;
+        while (!pending.is_empty()) {
+            auto index = pending.take_last();
+            if (index == accept)
+                return true;
+            for (auto successor : instructions[index].successors) {
+                if (successor == excluded || visited[successor])
+                    continue;
+                visited[successor] = true;
+                pending.append(successor);
+            }
+        }
+        return false;
+    };
+
+    // A run of literals on every path, with nothing ever jumping into the middle of it, is some text that every match
+    // contains.
+    for (size_t index = 0; index < instructions.size(); ++index) {
+        if (!instructions[index].literal.has_value() || can_match_without(index))
+            continue;
+
+        StringBuilder literal;
+        literal.append(*instructions[index].literal);
+        for (auto next = instructions[index].successors.first(); next != accept; next = instructions[next].successors.first()) {
+            if (!instructions[next].literal.has_value() || instructions[next].predecessor_count != 1)
+                break;
+            literal.append(*instructions[next].literal);
+        }
+        if (literal.length() > max(data.required_prefix.length(), data.required_literal.length()))
+            data.required_literal = literal.to_string();
+    }
 }
 
 template<typename Parser>
@@ -196,6 +196,7 @@ Parser::Result Parser::parse(Optional<AllOptions> regex_options)
         move(m_parser_state.error_token),
         m_parser_state.named_capture_groups.keys(),
         m_parser_state.regex_options,
+        {},
     };
 }
 
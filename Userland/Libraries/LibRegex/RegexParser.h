@@ -55,6 +55,14 @@ public:
         Token error_token;
         Vector<FlyString> capture_groups;
         AllOptions options;
+
+        // Filled in by the optimizer, and checked for in the input before the pattern is matched against it.
+        struct OptimizationData {
+            // The literal text every match starts with.
+            String required_prefix;
+            // The longest literal text every match has to contain, if it is longer than the prefix.
+            String required_literal;
+        } optimization_data {};
     };
 
     explicit Parser(Lexer& lexer)
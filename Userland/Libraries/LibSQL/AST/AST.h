@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <AK/NonnullOwnPtr.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/RefCounted.h>
@@ -302,6 +303,7 @@ struct ExecutionContext {
     NonnullRefPtr<Database> database;
     class Statement const* statement;
     Tuple* current_row { nullptr };
+    Span<Value const> placeholder_values {};
 };
 
 class Expression : public ASTNode {
@@ -361,6 +363,22 @@ public:
     virtual ResultOr<Value> evaluate(ExecutionContext&) const override;
 };
 
+// A '?' in the statement, which stands for a value that's given when the statement is executed. The placeholders are
+// numbered in the order they appear in.
+class Placeholder : public Expression {
+public:
+    explicit Placeholder(size_t parameter_index)
+        : m_parameter_index(parameter_index)
+    {
+    }
+
+    size_t parameter_index() const { return m_parameter_index; }
+    virtual ResultOr<Value> evaluate(ExecutionContext&) const override;
+
+private:
+    size_t m_parameter_index;
+};
+
 class NestedExpression : public Expression {
 public:
     NonnullRefPtr<Expression> const& expression() const { return m_expression; }
@@ -729,7 +747,7 @@ private:
 
 class Statement : public ASTNode {
 public:
-    ResultOr<ResultSet> execute(AK::NonnullRefPtr<Database> database) const;
+    ResultOr<ResultSet> execute(AK::NonnullRefPtr<Database> database, Span<Value const> placeholder_values = {}) const;
 
     virtual ResultOr<ResultSet> execute(ExecutionContext&) const
     {
@@ -1048,6 +1066,9 @@ public:
     RefPtr<LimitClause> const& limit_clause() const { return m_limit_clause; }
     ResultOr<ResultSet> execute(ExecutionContext&) const override;
 
+    // Starts executing the statement, without reading any more of the database than it takes to produce the first row.
+    ResultOr<NonnullOwnPtr<Cursor>> open_cursor(NonnullRefPtr<Database>, Span<Value const> placeholder_values = {}) const;
+
 private:
     RefPtr<CommonTableExpressionList> m_common_table_expression_list;
     bool m_select_all;
@@ -1059,6 +1080,50 @@ private:
     RefPtr<LimitClause> m_limit_clause;
 };
 
+class CreateIndex : public Statement {
+public:
+    CreateIndex(String schema_name, String index_name, String table_name, Vector<String> column_names, bool is_unique, bool is_error_if_index_exists)
+        : m_schema_name(move(schema_name))
+        , m_index_name(move(index_name))
+        , m_table_name(move(table_name))
+        , m_column_names(move(column_names))
+        , m_is_unique(is_unique)
+        , m_is_error_if_index_exists(is_error_if_index_exists)
+    {
+    }
+
+    String const& schema_name() const { return m_schema_name; }
+    String const& index_name() const { return m_index_name; }
+    String const& table_name() const { return m_table_name; }
+    Vector<String> const& column_names() const { return m_column_names; }
+    bool is_unique() const { return m_is_unique; }
+    bool is_error_if_index_exists() const { return m_is_error_if_index_exists; }
+
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    String m_schema_name;
+    String m_index_name;
+    String m_table_name;
+    Vector<String> m_column_names;
+    bool m_is_unique;
+    bool m_is_error_if_index_exists;
+};
+
+class Explain : public Statement {
+public:
+    explicit Explain(NonnullRefPtr<Select> select_statement)
+        : m_select_statement(move(select_statement))
+    {
+    }
+
+    NonnullRefPtr<Select> const& select_statement() const { return m_select_statement; }
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    NonnullRefPtr<Select> m_select_statement;
+};
+
 class DescribeTable : public Statement {
 public:
     DescribeTable(NonnullRefPtr<QualifiedTableName> qualified_table_name)
@@ -36,8 +36,8 @@ ResultOr<ResultSet> Insert::execute(ExecutionContext& context) const
             return Result { SQLCommand::Insert, SQLErrorCode::ColumnDoesNotExist, column };
     }
 
-    ResultSet result { SQLCommand::Insert };
-    TRY(result.try_ensure_capacity(m_chained_expressions.size()));
+    Vector<Row> inserted_rows;
+    TRY(inserted_rows.try_ensure_capacity(m_chained_expressions.size()));
 
     for (auto& row_expr : m_chained_expressions) {
         for (auto& column_def : table_def->columns()) {
@@ -63,13 +63,29 @@ ResultOr<ResultSet> Insert::execute(ExecutionContext& context) const
             if (!does_value_data_type_match(element_type, input_value_type))
                 return Result { SQLCommand::Insert, SQLErrorCode::InvalidValueType, table_def->columns()[element_index].name() };
 
+            // Integer columns only store whole numbers, so the value is rounded here already. That way the row and the
+            // keys of its indexes hold the same value as the stored row does.
+            if (element_type == SQLType::Integer && input_value_type != SQLType::Integer) {
+                auto integer = values[ix].to_int();
+                if (!integer.has_value())
+                    return Result { SQLCommand::Insert, SQLErrorCode::InvalidValueType, table_def->columns()[element_index].name() };
+                row[element_index] = Value(integer.value());
+                continue;
+            }
+
             row[element_index] = move(values[ix]);
         }
 
-        TRY(context.database->insert(row));
-        result.insert_row(row, {});
+        inserted_rows.unchecked_append(row);
     }
 
+    // The rows are only inserted once all of them have been evaluated, so that they go into the table together.
+    TRY(context.database->insert_many(inserted_rows));
+
+    ResultSet result { SQLCommand::Insert };
+    TRY(result.try_ensure_capacity(inserted_rows.size()));
+    for (auto& row : inserted_rows)
+        result.insert_row(row, {});
     return result;
 }
 
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AllOf.h>
+#include <AK/QuickSort.h>
+#include <LibSQL/AST/Operators.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Row.h>
+#include <LibSQL/RowLayout.h>
+
+namespace SQL::AST {
+
+static ResultOr<bool> passes_filters(Vector<Expression const*> const& filters, ExecutionContext& context)
+{
+    for (auto const* filter : filters) {
+        auto result = TRY(filter->evaluate(context)).to_bool();
+        if (!result.has_value() || !result.value())
+            return false;
+    }
+    return true;
+}
+
+// Numbers don't always have the type of the column they were stored in, so integers are hashed as what the column holds.
+static Optional<u32> join_hash(Value const& value, SQLType column_type)
+{
+    if (value.is_null())
+        return {};
+    if (column_type == SQLType::Integer) {
+        auto integer = value.to_int();
+        if (!integer.has_value())
+            return {};
+        return int_hash(*integer);
+    }
+    return value.hash();
+}
+
+UnityOperator::UnityOperator()
+    : m_descriptor(adopt_ref(*new TupleDescriptor))
+{
+    m_descriptor->empend("__unity__"sv);
+}
+
+ResultOr<Optional<Tuple>> UnityOperator::next(ExecutionContext&)
+{
+    if (m_is_exhausted)
+        return Optional<Tuple> {};
+    m_is_exhausted = true;
+    Tuple tuple(m_descriptor);
+    tuple[0] = Value { true };
+    return Optional<Tuple> { tuple };
+}
+
+TableScanOperator::TableScanOperator(QueryPlan::TableAccess access)
+    : m_access(move(access))
+    , m_descriptor(m_access.table->to_tuple_descriptor())
+    , m_layout(*m_descriptor)
+{
+}
+
+ResultOr<u32> TableScanOperator::next_pointer(ExecutionContext& context)
+{
+    if (!m_is_started) {
+        m_is_started = true;
+        if (m_access.index)
+            m_index_pointers = TRY(context.database->select_range_pointers(*m_access.index, m_access.lower_bound, m_access.upper_bound));
+        else
+            m_next_pointer = m_access.table->pointer();
+    }
+    if (!m_access.index)
+        return m_next_pointer;
+    if (m_next_index_pointer >= m_index_pointers.size())
+        return 0u;
+    return m_index_pointers[m_next_index_pointer++];
+}
+
+ResultOr<Optional<Tuple>> TableScanOperator::next(ExecutionContext& context)
+{
+    while (true) {
+        auto pointer = TRY(next_pointer(context));
+        if (!pointer)
+            return Optional<Tuple> {};
+
+        // Rows read from the heap don't know which table they're from, so they get the descriptor of the table.
+        Tuple row(m_descriptor, pointer);
+
+        if (auto stored_row = TRY(context.database->select_stored_row(*m_access.table, pointer)); stored_row.has_value()) {
+            // Only the columns the filters look at are read before the row is known to pass them.
+            auto bytes = stored_row->bytes();
+            if (!m_access.index)
+                m_next_pointer = RowLayout::next_pointer(bytes);
+            auto passes_filters = all_of(m_access.filters, [&](auto const& filter) {
+                return filter.matches(m_layout.column(bytes, filter.column_index));
+            });
+            if (!passes_filters)
+                continue;
+            m_layout.read_columns(bytes, row);
+            return Optional<Tuple> { row };
+        }
+
+        auto stored_row = TRY(context.database->select_row(*m_access.table, pointer));
+        if (!m_access.index)
+            m_next_pointer = stored_row.next_pointer();
+        for (auto ix = 0u; ix < stored_row.size(); ix++)
+            row[ix] = stored_row[ix];
+        auto passes_filters = all_of(m_access.filters, [&](auto const& filter) {
+            return filter.matches(row[filter.column_index]);
+        });
+        if (passes_filters)
+            return Optional<Tuple> { row };
+    }
+}
+
+FilterOperator::FilterOperator(NonnullOwnPtr<Operator> input, Vector<Expression const*> filters)
+    : m_input(move(input))
+    , m_filters(move(filters))
+{
+}
+
+ResultOr<Optional<Tuple>> FilterOperator::next(ExecutionContext& context)
+{
+    while (true) {
+        auto row = TRY(m_input->next(context));
+        if (!row.has_value())
+            return row;
+        context.current_row = &row.value();
+        if (TRY(passes_filters(m_filters, context)))
+            return row;
+    }
+}
+
+JoinOperator::JoinOperator(NonnullOwnPtr<Operator> outer, NonnullOwnPtr<Operator> inner, QueryPlan::TableAccess const& access)
+    : m_outer(move(outer))
+    , m_inner(move(inner))
+    , m_strategy(access.join_strategy)
+    , m_join_column(access.join_column)
+    , m_outer_join_column(access.outer_join_column)
+    , m_join_column_type(access.join_column_type)
+{
+    VERIFY(m_strategy != QueryPlan::JoinStrategy::None);
+}
+
+ResultOr<void> JoinOperator::read_inner(ExecutionContext& context)
+{
+    m_is_inner_read = true;
+    while (true) {
+        auto row = TRY(m_inner->next(context));
+        if (!row.has_value())
+            return {};
+        if (m_strategy == QueryPlan::JoinStrategy::Hash) {
+            context.current_row = &row.value();
+            auto value = TRY(m_join_column->evaluate(context));
+            if (auto hash = join_hash(value, m_join_column_type); hash.has_value())
+                m_inner_rows_by_hash.ensure(*hash).append(m_inner_rows.size());
+            m_inner_join_values.append(move(value));
+        }
+        m_inner_rows.append(row.release_value());
+    }
+}
+
+ResultOr<void> JoinOperator::find_matches(ExecutionContext& context)
+{
+    m_next_match = 0;
+    m_matches = nullptr;
+    if (m_strategy != QueryPlan::JoinStrategy::Hash)
+        return {};
+
+    context.current_row = &m_outer_row.value();
+    m_outer_join_value = TRY(m_outer_join_column->evaluate(context));
+    auto hash = join_hash(m_outer_join_value, m_join_column_type);
+    if (!hash.has_value())
+        return {};
+    auto matching_rows = m_inner_rows_by_hash.find(*hash);
+    if (matching_rows != m_inner_rows_by_hash.end())
+        m_matches = &matching_rows->value;
+    return {};
+}
+
+Tuple JoinOperator::join(Tuple const& inner_row)
+{
+    auto const& outer_row = m_outer_row.value();
+    if (!m_descriptor) {
+        m_descriptor = adopt_ref(*new TupleDescriptor);
+        m_descriptor->extend(*outer_row.descriptor());
+        m_descriptor->extend(*inner_row.descriptor());
+    }
+    Tuple joined_row(*m_descriptor);
+    joined_row.clear();
+    joined_row.extend(outer_row);
+    joined_row.extend(inner_row);
+    return joined_row;
+}
+
+ResultOr<Optional<Tuple>> JoinOperator::next(ExecutionContext& context)
+{
+    if (!m_is_inner_read)
+        TRY(read_inner(context));
+
+    while (true) {
+        if (m_outer_row.has_value()) {
+            if (m_strategy == QueryPlan::JoinStrategy::Hash) {
+                while (m_matches && m_next_match < m_matches->size()) {
+                    auto ix = m_matches->at(m_next_match++);
+                    if (m_inner_join_values[ix].compare(m_outer_join_value) == 0)
+                        return Optional<Tuple> { join(m_inner_rows[ix]) };
+                }
+            } else if (m_next_match < m_inner_rows.size()) {
+                return Optional<Tuple> { join(m_inner_rows[m_next_match++]) };
+            }
+        }
+
+        m_outer_row = TRY(m_outer->next(context));
+        if (!m_outer_row.has_value())
+            return Optional<Tuple> {};
+        TRY(find_matches(context));
+    }
+}
+
+SortOperator::SortOperator(NonnullOwnPtr<Operator> input, NonnullRefPtrVector<OrderingTerm> ordering_terms)
+    : m_input(move(input))
+    , m_ordering_terms(move(ordering_terms))
+{
+}
+
+ResultOr<void> SortOperator::sort(ExecutionContext& context)
+{
+    m_is_sorted = true;
+
+    auto sort_descriptor = adopt_ref(*new TupleDescriptor);
+    for (auto& term : m_ordering_terms)
+        sort_descriptor->append(TupleElementDescriptor { .order = term.order() });
+
+    while (true) {
+        auto row = TRY(m_input->next(context));
+        if (!row.has_value())
+            break;
+
+        context.current_row = &row.value();
+        Tuple sort_key(sort_descriptor);
+        sort_key.clear();
+        for (auto& term : m_ordering_terms)
+            sort_key.append(TRY(term.expression()->evaluate(context)));
+        m_rows.append({ move(sort_key), row.release_value(), m_rows.size() });
+    }
+
+    quick_sort(m_rows, [](auto const& a, auto const& b) {
+        auto compare = a.sort_key.compare(b.sort_key);
+        return compare < 0 || (compare == 0 && a.sequence_number < b.sequence_number);
+    });
+    return {};
+}
+
+ResultOr<Optional<Tuple>> SortOperator::next(ExecutionContext& context)
+{
+    if (!m_is_sorted)
+        TRY(sort(context));
+    if (m_next_row >= m_rows.size())
+        return Optional<Tuple> {};
+    return Optional<Tuple> { m_rows[m_next_row++].row };
+}
+
+LimitOperator::LimitOperator(NonnullOwnPtr<Operator> input, size_t offset, size_t limit)
+    : m_input(move(input))
+    , m_offset(offset)
+    , m_limit(limit)
+{
+}
+
+ResultOr<Optional<Tuple>> LimitOperator::next(ExecutionContext& context)
+{
+    while (m_skipped < m_offset) {
+        if (!TRY(m_input->next(context)).has_value())
+            return Optional<Tuple> {};
+        m_skipped++;
+    }
+    if (m_produced >= m_limit)
+        return Optional<Tuple> {};
+    auto row = TRY(m_input->next(context));
+    if (row.has_value())
+        m_produced++;
+    return row;
+}
+
+ProjectOperator::ProjectOperator(NonnullOwnPtr<Operator> input, NonnullRefPtrVector<ResultColumn> columns)
+    : m_input(move(input))
+    , m_columns(move(columns))
+    , m_descriptor(adopt_ref(*new TupleDescriptor))
+{
+}
+
+ResultOr<Optional<Tuple>> ProjectOperator::next(ExecutionContext& context)
+{
+    auto row = TRY(m_input->next(context));
+    if (!row.has_value())
+        return Optional<Tuple> {};
+
+    // The descriptor is filled in as the first tuple is appended to, and shared by all the tuples after it.
+    context.current_row = &row.value();
+    Tuple tuple(m_descriptor);
+    tuple.clear();
+    for (auto& column : m_columns)
+        tuple.append(TRY(column.expression()->evaluate(context)));
+    return Optional<Tuple> { tuple };
+}
+
+Cursor::Cursor(NonnullRefPtr<Database> database, NonnullRefPtr<Select const> select, NonnullOwnPtr<Operator> root, Span<Value const> placeholder_values)
+    : m_select(move(select))
+    , m_placeholder_values(placeholder_values)
+    , m_context({ move(database), m_select.ptr(), nullptr, m_placeholder_values.span() })
+    , m_root(move(root))
+{
+}
+
+ResultOr<Optional<Tuple>> Cursor::next()
+{
+    return m_root->next(m_context);
+}
+
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Result.h>
+#include <LibSQL/RowLayout.h>
+#include <LibSQL/Tuple.h>
+#include <LibSQL/Value.h>
+
+namespace SQL::AST {
+
+/**
+ * The steps a SELECT is executed in. Every operator hands out its tuples one
+ * at a time, and pulls only as many tuples out of its input as it needs to
+ * produce the next one. So nothing is read from the database before it's
+ * asked for, and a query that stops early, like one with a LIMIT, doesn't
+ * read any further than it has to.
+ */
+class Operator {
+public:
+    virtual ~Operator() = default;
+
+    // The next tuple, or nothing once all of them have been handed out.
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) = 0;
+};
+
+// The single empty row a SELECT without any tables evaluates its columns on.
+class UnityOperator final : public Operator {
+public:
+    UnityOperator();
+    ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    NonnullRefPtr<TupleDescriptor> m_descriptor;
+    bool m_is_exhausted { false };
+};
+
+// Reads the rows of a table, either all of them or the ones an index finds, and checks the filters of the table on them.
+// Where the heap stores rows by their RowLayout, the filters are checked on the stored row before the rest of it is read.
+class TableScanOperator final : public Operator {
+public:
+    explicit TableScanOperator(QueryPlan::TableAccess);
+    ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    ResultOr<u32> next_pointer(ExecutionContext&);
+
+    QueryPlan::TableAccess m_access;
+    NonnullRefPtr<TupleDescriptor> m_descriptor;
+    RowLayout m_layout;
+    bool m_is_started { false };
+    u32 m_next_pointer { 0 };
+    Vector<u32> m_index_pointers;
+    size_t m_next_index_pointer { 0 };
+};
+
+class FilterOperator final : public Operator {
+public:
+    FilterOperator(NonnullOwnPtr<Operator> input, Vector<Expression const*> filters);
+    ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    Vector<Expression const*> m_filters;
+};
+
+// Joins every tuple of the outer input to the matching rows of a table. The rows of the table are all read the first
+// time they're needed, and looked up by hash if the table is hash joined.
+class JoinOperator final : public Operator {
+public:
+    JoinOperator(NonnullOwnPtr<Operator> outer, NonnullOwnPtr<Operator> inner, QueryPlan::TableAccess const&);
+    ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    ResultOr<void> read_inner(ExecutionContext&);
+    ResultOr<void> find_matches(ExecutionContext&);
+    Tuple join(Tuple const& inner_row);
+
+    NonnullOwnPtr<Operator> m_outer;
+    NonnullOwnPtr<Operator> m_inner;
+    QueryPlan::JoinStrategy m_strategy;
+    ColumnNameExpression const* m_join_column;
+    ColumnNameExpression const* m_outer_join_column;
+    SQLType m_join_column_type;
+
+    bool m_is_inner_read { false };
+    Vector<Tuple> m_inner_rows;
+    Vector<Value> m_inner_join_values;
+    HashMap<u32, Vector<size_t>> m_inner_rows_by_hash;
+
+    Optional<Tuple> m_outer_row;
+    Value m_outer_join_value;
+    Vector<size_t> const* m_matches { nullptr };
+    size_t m_next_match { 0 };
+    RefPtr<TupleDescriptor> m_descriptor;
+};
+
+// Has to see all of its input before it can hand out the first tuple of it. Tuples that sort the same stay in the order they came in.
+class SortOperator final : public Operator {
+public:
+    SortOperator(NonnullOwnPtr<Operator> input, NonnullRefPtrVector<OrderingTerm> ordering_terms);
+    ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    struct SortedRow {
+        Tuple sort_key;
+        Tuple row;
+        size_t sequence_number;
+    };
+
+    ResultOr<void> sort(ExecutionContext&);
+
+    NonnullOwnPtr<Operator> m_input;
+    NonnullRefPtrVector<OrderingTerm> m_ordering_terms;
+    bool m_is_sorted { false };
+    Vector<SortedRow> m_rows;
+    size_t m_next_row { 0 };
+};
+
+// Stops pulling tuples out of its input as soon as it has handed out as many as it may.
+class LimitOperator final : public Operator {
+public:
+    LimitOperator(NonnullOwnPtr<Operator> input, size_t offset, size_t limit);
+    ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    size_t m_offset;
+    size_t m_limit;
+    size_t m_skipped { 0 };
+    size_t m_produced { 0 };
+};
+
+// Evaluates the result columns on each tuple of its input.
+class ProjectOperator final : public Operator {
+public:
+    ProjectOperator(NonnullOwnPtr<Operator> input, NonnullRefPtrVector<ResultColumn> columns);
+    ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    NonnullRefPtrVector<ResultColumn> m_columns;
+    NonnullRefPtr<TupleDescriptor> m_descriptor;
+};
+
+/**
+ * An open SELECT, which hands out the rows of its result one at a time. It
+ * keeps the statement it's executing, the values for its placeholders and
+ * the database it's reading from alive for as long as it's open.
+ */
+class Cursor {
+public:
+    Cursor(NonnullRefPtr<Database>, NonnullRefPtr<Select const>, NonnullOwnPtr<Operator>, Span<Value const> placeholder_values = {});
+
+    ResultOr<Optional<Tuple>> next();
+
+private:
+    NonnullRefPtr<Select const> m_select;
+    Vector<Value> m_placeholder_values;
+    ExecutionContext m_context;
+    NonnullOwnPtr<Operator> m_root;
+};
+
+}
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <AK/TypeCasts.h>
+#include <LibSQL/AST/Operators.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/Database.h>
+#include <math.h>
+
+namespace SQL::AST {
+
+namespace {
+
+// A comparison between a column and a literal, with the column on the left hand side.
+struct ColumnComparison {
+    size_t table_index;
+    ColumnDef const* column;
+    BinaryOperator op;
+    Value literal;
+    bool is_column_on_left;
+};
+
+}
+
+static void collect_conjuncts(Expression const& expression, Vector<Expression const*>& conjuncts)
+{
+    if (is<ChainedExpression>(expression)) {
+        auto const& chained_expression = static_cast<ChainedExpression const&>(expression);
+        if (chained_expression.expressions().size() == 1) {
+            collect_conjuncts(chained_expression.expressions().first(), conjuncts);
+            return;
+        }
+    }
+    if (is<BinaryOperatorExpression>(expression)) {
+        auto const& binary_expression = static_cast<BinaryOperatorExpression const&>(expression);
+        if (binary_expression.type() == BinaryOperator::And) {
+            collect_conjuncts(*binary_expression.lhs(), conjuncts);
+            collect_conjuncts(*binary_expression.rhs(), conjuncts);
+            return;
+        }
+    }
+    conjuncts.append(&expression);
+}
+
+// Finds the one table a column name refers to, the same way ColumnNameExpression::evaluate() does.
+static Optional<size_t> resolve_column(Vector<QueryPlan::TableAccess> const& tables, ColumnNameExpression const& column_name, ColumnDef const*& column)
+{
+    Optional<size_t> table_index;
+    for (auto ix = 0u; ix < tables.size(); ix++) {
+        auto const& table = *tables[ix].table;
+        if (!column_name.table_name().is_empty() && table.name() != column_name.table_name())
+            continue;
+        if (!column_name.schema_name().is_empty() && table.parent()->name() != column_name.schema_name())
+            continue;
+        for (auto& table_column : table.columns()) {
+            if (table_column.name() != column_name.column_name())
+                continue;
+            if (table_index.has_value())
+                return {};
+            table_index = ix;
+            column = &table_column;
+        }
+    }
+    return table_index;
+}
+
+static size_t column_index(TableDef const& table, ColumnDef const& column)
+{
+    for (auto ix = 0u; ix < table.columns().size(); ix++) {
+        if (&table.columns()[ix] == &column)
+            return ix;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static Optional<BinaryOperator> comparison_with_operands_swapped(BinaryOperator op)
+{
+    switch (op) {
+    case BinaryOperator::Equals:
+        return BinaryOperator::Equals;
+    case BinaryOperator::LessThan:
+        return BinaryOperator::GreaterThan;
+    case BinaryOperator::LessThanEquals:
+        return BinaryOperator::GreaterThanEquals;
+    case BinaryOperator::GreaterThan:
+        return BinaryOperator::LessThan;
+    case BinaryOperator::GreaterThanEquals:
+        return BinaryOperator::LessThanEquals;
+    default:
+        return {};
+    }
+}
+
+// Placeholders are as good as literals here, since the plan is made for the values the statement is executed with.
+static Optional<Value> literal_value(Expression const& expression, ExecutionContext const& context)
+{
+    if (is<Placeholder>(expression)) {
+        auto parameter_index = static_cast<Placeholder const&>(expression).parameter_index();
+        if (parameter_index >= context.placeholder_values.size())
+            return {};
+        return context.placeholder_values[parameter_index];
+    }
+    if (is<NumericLiteral>(expression))
+        return Value { static_cast<NumericLiteral const&>(expression).value() };
+    if (is<StringLiteral>(expression))
+        return Value { static_cast<StringLiteral const&>(expression).value() };
+    return {};
+}
+
+static Optional<ColumnComparison> as_column_comparison(Vector<QueryPlan::TableAccess> const& tables, Expression const& expression, ExecutionContext const& context)
+{
+    if (!is<BinaryOperatorExpression>(expression))
+        return {};
+    auto const& binary_expression = static_cast<BinaryOperatorExpression const&>(expression);
+    if (!comparison_with_operands_swapped(binary_expression.type()).has_value())
+        return {};
+
+    auto try_operands = [&](Expression const& column_operand, Expression const& literal_operand, BinaryOperator op, bool is_column_on_left) -> Optional<ColumnComparison> {
+        if (!is<ColumnNameExpression>(column_operand))
+            return {};
+        auto literal = literal_value(literal_operand, context);
+        if (!literal.has_value())
+            return {};
+        ColumnDef const* column = nullptr;
+        auto table_index = resolve_column(tables, static_cast<ColumnNameExpression const&>(column_operand), column);
+        if (!table_index.has_value())
+            return {};
+        return ColumnComparison { *table_index, column, op, literal.release_value(), is_column_on_left };
+    };
+
+    if (auto comparison = try_operands(*binary_expression.lhs(), *binary_expression.rhs(), binary_expression.type(), true); comparison.has_value())
+        return comparison;
+    return try_operands(*binary_expression.rhs(), *binary_expression.lhs(), *comparison_with_operands_swapped(binary_expression.type()), false);
+}
+
+// The index holds the values as they're stored in the column, so the literal has to be turned into one of those first.
+// Bounds on integer columns are rounded inwards, so that they let through at least every row the comparison itself would.
+static Optional<Value> literal_as_index_bound(Value const& literal, SQLType type, BinaryOperator op)
+{
+    switch (type) {
+    case SQLType::Text:
+        if (literal.type() != SQLType::Text)
+            return {};
+        return literal;
+    case SQLType::Float:
+        if (literal.type() == SQLType::Integer)
+            return Value { literal.to_double().value() };
+        if (literal.type() != SQLType::Float)
+            return {};
+        return literal;
+    case SQLType::Integer: {
+        // Only the values of placeholders can be integers already.
+        if (literal.type() == SQLType::Integer)
+            return literal;
+        if (literal.type() != SQLType::Float)
+            return {};
+        auto value = literal.to_double().value();
+        if (op == BinaryOperator::GreaterThan || op == BinaryOperator::GreaterThanEquals)
+            value = ceil(value);
+        else if (op == BinaryOperator::LessThan || op == BinaryOperator::LessThanEquals)
+            value = floor(value);
+        else if (floor(value) != value)
+            return {};
+        if (value < NumericLimits<int>::min() || value > NumericLimits<int>::max())
+            return {};
+        return Value { static_cast<int>(value) };
+    }
+    default:
+        return {};
+    }
+}
+
+// Compares the same way BinaryOperatorExpression::evaluate() does, so it doesn't matter which of the two checks a row.
+bool QueryPlan::ColumnFilter::matches(Value const& column_value) const
+{
+    auto compare = is_column_on_left ? column_value.compare(literal) : literal.compare(column_value);
+    switch (op) {
+    case BinaryOperator::Equals:
+        return compare == 0;
+    case BinaryOperator::LessThan:
+        return compare < 0;
+    case BinaryOperator::LessThanEquals:
+        return compare <= 0;
+    case BinaryOperator::GreaterThan:
+        return compare > 0;
+    case BinaryOperator::GreaterThanEquals:
+        return compare >= 0;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+static void choose_index(QueryPlan::TableAccess& access, Vector<ColumnComparison> const& comparisons)
+{
+    for (auto& index : access.table->indexes()) {
+        auto const& key_part = index.key_definition().first();
+        Value lower_bound;
+        Value upper_bound;
+        for (auto& comparison : comparisons) {
+            if (comparison.column->name() != key_part.name())
+                continue;
+            auto bound = literal_as_index_bound(comparison.literal, key_part.type(), comparison.op);
+            if (!bound.has_value())
+                continue;
+
+            auto is_lower_bound = comparison.op != BinaryOperator::LessThan && comparison.op != BinaryOperator::LessThanEquals;
+            auto is_upper_bound = comparison.op != BinaryOperator::GreaterThan && comparison.op != BinaryOperator::GreaterThanEquals;
+            if (is_lower_bound && (lower_bound.is_null() || bound->compare(lower_bound) > 0))
+                lower_bound = *bound;
+            if (is_upper_bound && (upper_bound.is_null() || bound->compare(upper_bound) < 0))
+                upper_bound = *bound;
+        }
+        if (lower_bound.is_null() && upper_bound.is_null())
+            continue;
+
+        // An index that finds the rows for a single value beats one that has to go through a range of them.
+        auto is_point_lookup = !lower_bound.is_null() && !upper_bound.is_null() && lower_bound.compare(upper_bound) == 0;
+        auto current_is_point_lookup = access.index && !access.lower_bound.is_null() && !access.upper_bound.is_null() && access.lower_bound.compare(access.upper_bound) == 0;
+        if (access.index && (current_is_point_lookup || !is_point_lookup))
+            continue;
+
+        access.index = &index;
+        access.lower_bound = lower_bound;
+        access.upper_bound = upper_bound;
+    }
+}
+
+static bool is_hashable_join_column(ColumnDef const& column)
+{
+    // Floats are only ever compared give or take an epsilon.
+    return column.type() == SQLType::Integer || column.type() == SQLType::Text;
+}
+
+ResultOr<QueryPlan> QueryPlan::create(Select const& select, ExecutionContext& context)
+{
+    QueryPlan plan;
+
+    for (auto& table_descriptor : select.table_or_subquery_list()) {
+        if (!table_descriptor.is_table())
+            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
+
+        auto table_def = TRY(context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
+        if (!table_def)
+            return Result { SQLCommand::Select, SQLErrorCode::TableDoesNotExist, table_descriptor.table_name() };
+        if (table_def->num_columns() == 0)
+            continue;
+
+        TableAccess access { table_def.release_nonnull() };
+        if (!plan.m_tables.is_empty())
+            access.join_strategy = JoinStrategy::NestedLoop;
+        plan.m_tables.append(move(access));
+    }
+
+    Vector<Expression const*> conjuncts;
+    if (select.where_clause())
+        collect_conjuncts(*select.where_clause(), conjuncts);
+
+    Vector<Vector<ColumnComparison>> comparisons_by_table;
+    comparisons_by_table.resize(plan.m_tables.size());
+
+    for (auto const* conjunct : conjuncts) {
+        // Comparisons with a literal are checked while the table is being read, and may decide which index is used to read it.
+        if (auto comparison = as_column_comparison(plan.m_tables, *conjunct, context); comparison.has_value()) {
+            auto& access = plan.m_tables[comparison->table_index];
+            auto op = comparison->is_column_on_left ? comparison->op : *comparison_with_operands_swapped(comparison->op);
+            access.filters.append({ column_index(*access.table, *comparison->column), op, comparison->literal, comparison->is_column_on_left });
+            comparisons_by_table[comparison->table_index].append(comparison.release_value());
+            continue;
+        }
+
+        // An equality between columns of two tables joins the later one to the rows of the ones before it.
+        if (is<BinaryOperatorExpression>(*conjunct) && static_cast<BinaryOperatorExpression const&>(*conjunct).type() == BinaryOperator::Equals) {
+            auto const& equality = static_cast<BinaryOperatorExpression const&>(*conjunct);
+            if (is<ColumnNameExpression>(*equality.lhs()) && is<ColumnNameExpression>(*equality.rhs())) {
+                auto const& lhs = static_cast<ColumnNameExpression const&>(*equality.lhs());
+                auto const& rhs = static_cast<ColumnNameExpression const&>(*equality.rhs());
+                ColumnDef const* lhs_column = nullptr;
+                ColumnDef const* rhs_column = nullptr;
+                auto lhs_table = resolve_column(plan.m_tables, lhs, lhs_column);
+                auto rhs_table = resolve_column(plan.m_tables, rhs, rhs_column);
+
+                // Values of different types can be equal without hashing the same, so those are left to a nested loop.
+                if (lhs_table.has_value() && rhs_table.has_value() && *lhs_table != *rhs_table && lhs_column->type() == rhs_column->type() && is_hashable_join_column(*lhs_column)) {
+                    auto& access = plan.m_tables[max(*lhs_table, *rhs_table)];
+                    if (access.join_strategy != JoinStrategy::Hash) {
+                        access.join_strategy = JoinStrategy::Hash;
+                        access.join_column = *lhs_table > *rhs_table ? &lhs : &rhs;
+                        access.outer_join_column = *lhs_table > *rhs_table ? &rhs : &lhs;
+                        access.join_column_type = lhs_column->type();
+                        continue;
+                    }
+                }
+            }
+        }
+
+        plan.m_residual_filters.append(conjunct);
+    }
+
+    for (auto ix = 0u; ix < plan.m_tables.size(); ix++)
+        choose_index(plan.m_tables[ix], comparisons_by_table[ix]);
+
+    return plan;
+}
+
+NonnullOwnPtr<Operator> QueryPlan::create_operator() const
+{
+    if (m_tables.is_empty())
+        return make<UnityOperator>();
+
+    NonnullOwnPtr<Operator> root = make<TableScanOperator>(m_tables.first());
+    for (auto ix = 1u; ix < m_tables.size(); ix++)
+        root = make<JoinOperator>(move(root), make<TableScanOperator>(m_tables[ix]), m_tables[ix]);
+
+    if (!m_residual_filters.is_empty())
+        root = make<FilterOperator>(move(root), m_residual_filters);
+    return root;
+}
+
+static String column_display_name(ColumnNameExpression const& column)
+{
+    if (column.table_name().is_empty())
+        return column.column_name();
+    return String::formatted("{}.{}", column.table_name(), column.column_name());
+}
+
+Vector<String> QueryPlan::describe() const
+{
+    Vector<String> lines;
+    for (auto& access : m_tables) {
+        StringBuilder builder;
+        builder.appendff("{} {}.{}", access.index ? "SEARCH"sv : "SCAN"sv, access.table->parent()->name(), access.table->name());
+
+        if (access.index) {
+            auto const& column_name = access.index->key_definition().first().name();
+            builder.appendff(" USING INDEX {} (", access.index->name());
+            if (!access.lower_bound.is_null() && !access.upper_bound.is_null() && access.lower_bound.compare(access.upper_bound) == 0)
+                builder.appendff("{} = {}", column_name, access.lower_bound);
+            else if (!access.lower_bound.is_null() && !access.upper_bound.is_null())
+                builder.appendff("{} >= {} AND {} <= {}", column_name, access.lower_bound, column_name, access.upper_bound);
+            else if (!access.lower_bound.is_null())
+                builder.appendff("{} >= {}", column_name, access.lower_bound);
+            else
+                builder.appendff("{} <= {}", column_name, access.upper_bound);
+            builder.append(')');
+        }
+
+        if (access.join_strategy == JoinStrategy::Hash)
+            builder.appendff(" HASH JOIN ON {} = {}", column_display_name(*access.join_column), column_display_name(*access.outer_join_column));
+        else if (access.join_strategy == JoinStrategy::NestedLoop)
+            builder.append(" NESTED LOOP JOIN"sv);
+
+        if (!access.filters.is_empty())
+            builder.appendff(" FILTER {} CONDITION{}", access.filters.size(), access.filters.size() == 1 ? ""sv : "S"sv);
+        lines.append(builder.to_string());
+    }
+
+    if (!m_residual_filters.is_empty())
+        lines.append(String::formatted("FILTER {} CONDITION{}", m_residual_filters.size(), m_residual_filters.size() == 1 ? ""sv : "S"sv));
+    return lines;
+}
+
+}
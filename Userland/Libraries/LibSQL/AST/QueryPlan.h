@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Result.h>
+#include <LibSQL/Tuple.h>
+#include <LibSQL/Value.h>
+
+namespace SQL::AST {
+
+/**
+ * A QueryPlan describes how the rows of a SELECT are found: how each table
+ * in the FROM clause is read, which parts of the WHERE clause are checked
+ * while reading it, and how it's joined to the tables before it.
+ *
+ * A table is read through an index if the WHERE clause compares the first
+ * column of that index with a literal, otherwise all of it is read. The
+ * tables are joined in the order they're listed in, with a hash join if an
+ * equality between two columns of the same type connects the table to one
+ * before it, and a nested loop otherwise.
+ */
+class QueryPlan {
+public:
+    enum class JoinStrategy {
+        None,
+        NestedLoop,
+        Hash,
+    };
+
+    // A comparison of a column of a table with a literal, the way round the WHERE clause has it. It's checked on the
+    // stored row, so that only the rows that pass it are read into tuples.
+    struct ColumnFilter {
+        size_t column_index;
+        BinaryOperator op;
+        Value literal;
+        bool is_column_on_left { true };
+
+        bool matches(Value const& column_value) const;
+    };
+
+    struct TableAccess {
+        NonnullRefPtr<TableDef> table;
+        IndexDef const* index { nullptr };
+        Value lower_bound {};
+        Value upper_bound {};
+        Vector<ColumnFilter> filters {};
+
+        JoinStrategy join_strategy { JoinStrategy::None };
+        ColumnNameExpression const* join_column { nullptr };
+        ColumnNameExpression const* outer_join_column { nullptr };
+        SQLType join_column_type { SQLType::Null };
+    };
+
+    static ResultOr<QueryPlan> create(Select const&, ExecutionContext&);
+
+    Vector<TableAccess> const& tables() const { return m_tables; }
+    Vector<Expression const*> const& residual_filters() const { return m_residual_filters; }
+
+    // Produces the rows of the cartesian product of the tables that pass the whole WHERE clause.
+    NonnullOwnPtr<Operator> create_operator() const;
+    Vector<String> describe() const;
+
+private:
+    QueryPlan() = default;
+
+    Vector<TableAccess> m_tables;
+    Vector<Expression const*> m_residual_filters;
+};
+
+}
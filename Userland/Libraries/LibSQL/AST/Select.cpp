@@ -6,13 +6,14 @@
 
 #include <AK/NumericLimits.h>
 #include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/Operators.h>
+#include <LibSQL/AST/QueryPlan.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
-#include <LibSQL/Row.h>
 
 namespace SQL::AST {
 
-ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+ResultOr<NonnullOwnPtr<Cursor>> Select::open_cursor(NonnullRefPtr<Database> database, Span<Value const> placeholder_values) const
 {
     NonnullRefPtrVector<ResultColumn> columns;
 
@@ -23,7 +24,7 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         if (!table_descriptor.is_table())
             return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
 
-        auto table_def = TRY(context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
+        auto table_def = TRY(database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
         if (!table_def)
             return Result { SQLCommand::Select, SQLErrorCode::TableDoesNotExist, table_descriptor.table_name() };
 
@@ -48,73 +49,14 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         }
     }
 
-    ResultSet result { SQLCommand::Select };
-
-    auto descriptor = adopt_ref(*new TupleDescriptor);
-    Tuple tuple(descriptor);
-    Vector<Tuple> rows;
-    descriptor->empend("__unity__"sv);
-    tuple.append(Value { true });
-    rows.append(tuple);
-
-    for (auto& table_descriptor : table_or_subquery_list()) {
-        if (!table_descriptor.is_table())
-            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
-
-        auto table_def = TRY(context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
-        if (table_def->num_columns() == 0)
-            continue;
-
-        auto old_descriptor_size = descriptor->size();
-        descriptor->extend(table_def->to_tuple_descriptor());
+    ExecutionContext context { database, this, nullptr, placeholder_values };
+    auto plan = TRY(QueryPlan::create(*this, context));
+    auto root = plan.create_operator();
 
-        while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
-            auto cartesian_row = rows.take_first();
-            auto table_rows = TRY(context.database->select_all(*table_def));
-
-            for (auto& table_row : table_rows) {
-                auto new_row = cartesian_row;
-                new_row.extend(table_row);
-                rows.append(new_row);
-            }
-        }
-    }
-
-    bool has_ordering { false };
-    auto sort_descriptor = adopt_ref(*new TupleDescriptor);
-    for (auto& term : m_ordering_term_list) {
-        sort_descriptor->append(TupleElementDescriptor { .order = term.order() });
-        has_ordering = true;
-    }
-    Tuple sort_key(sort_descriptor);
-
-    for (auto& row : rows) {
-        context.current_row = &row;
-
-        if (where_clause()) {
-            auto where_result = TRY(where_clause()->evaluate(context)).to_bool();
-            if (!where_result.has_value() || !where_result.value())
-                continue;
-        }
-
-        tuple.clear();
-
-        for (auto& col : columns) {
-            auto value = TRY(col.expression()->evaluate(context));
-            tuple.append(value);
-        }
-
-        if (has_ordering) {
-            sort_key.clear();
-            for (auto& term : m_ordering_term_list) {
-                auto value = TRY(term.expression()->evaluate(context));
-                sort_key.append(value);
-            }
-        }
-
-        result.insert_row(tuple, sort_key);
-    }
+    if (!m_ordering_term_list.is_empty())
+        root = make<SortOperator>(move(root), m_ordering_term_list);
 
+    // The rows are limited before they're projected, so that the result columns are only evaluated on the rows that are returned.
     if (m_limit_clause != nullptr) {
         size_t limit_value = NumericLimits<size_t>::max();
         size_t offset_value = 0;
@@ -139,9 +81,24 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
             }
         }
 
-        result.limit(offset_value, limit_value);
+        root = make<LimitOperator>(move(root), offset_value, limit_value);
     }
 
+    root = make<ProjectOperator>(move(root), move(columns));
+    return make<Cursor>(move(database), *this, move(root), placeholder_values);
+}
+
+ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+{
+    auto cursor = TRY(open_cursor(context.database, context.placeholder_values));
+
+    ResultSet result { SQLCommand::Select };
+    while (true) {
+        auto row = TRY(cursor->next());
+        if (!row.has_value())
+            break;
+        result.insert_row(row.value(), Tuple {});
+    }
     return result;
 }
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Debug.h>
 #include <AK/Format.h>
 #include <LibSQL/BTree.h>
 #include <LibSQL/Meta.h>
@@ -46,6 +47,8 @@ void BTree::initialize_root()
     } else {
         set_pointer(new_record_pointer());
         m_root = make<TreeNode>(*this, nullptr, pointer());
+        // The block has to be written even if nothing is ever put in the tree, or the heap would have a hole in it.
+        serializer().serialize_and_write(*m_root.ptr(), m_root->pointer());
         if (on_new_root)
             on_new_root();
     }
@@ -70,6 +73,106 @@ bool BTree::insert(Key const& key)
     return m_root->insert(key);
 }
 
+bool BTree::is_empty()
+{
+    if (!m_root)
+        initialize_root();
+    VERIFY(m_root);
+    return m_root->size() == 0;
+}
+
+// Fills an empty tree with keys that are already in order, writing every node once instead of again for every key
+// that goes into it. The leaves are filled from left to right, each one with as many keys as fit in its block, and
+// the first key that doesn't fit moves up to separate the leaf from the next one. The level above is built from those
+// keys the same way, and so on until a level is left that fits in the root.
+void BTree::bulk_load(Vector<Key> const& sorted_keys)
+{
+    VERIFY(is_empty());
+    if (sorted_keys.is_empty())
+        return;
+
+    struct NodeInProgress {
+        u32 first_down_pointer { 0 };
+        Vector<Key> entries;
+        Vector<u32> down_pointers;
+        size_t length { 2 * sizeof(u32) };
+    };
+
+    auto make_node = [&](NodeInProgress const& node, u32 pointer, bool is_leaf) {
+        auto tree_node = make<TreeNode>(*this, pointer);
+        tree_node->m_is_leaf = is_leaf;
+        tree_node->m_down.empend(tree_node.ptr(), node.first_down_pointer);
+        for (auto ix = 0u; ix < node.entries.size(); ix++) {
+            tree_node->m_entries.append(node.entries[ix]);
+            tree_node->m_down.empend(tree_node.ptr(), node.down_pointers[ix]);
+        }
+        return tree_node;
+    };
+
+    u32 first_down_pointer = 0;
+    Vector<Key> keys = sorted_keys;
+    Vector<u32> down_pointers;
+    down_pointers.resize(keys.size());
+    for (bool is_leaf = true;; is_leaf = false) {
+        Vector<NodeInProgress> nodes;
+        nodes.append({ first_down_pointer, {}, {} });
+        Vector<Key> separators;
+        for (auto ix = 0u; ix < keys.size(); ix++) {
+            auto& node = nodes.last();
+            auto key_length = sizeof(u32) + keys[ix].length();
+            if (!node.entries.is_empty() && node.length + key_length > BLOCKSIZE) {
+                separators.append(keys[ix]);
+                nodes.append({ down_pointers[ix], {}, {} });
+                continue;
+            }
+            node.entries.append(keys[ix]);
+            node.down_pointers.append(down_pointers[ix]);
+            node.length += key_length;
+        }
+
+        // If the last key went up, the node it would have separated from the one before is empty. It gets the last
+        // key of the node before instead, which goes up in its place.
+        if (nodes.size() > 1 && nodes.last().entries.is_empty()) {
+            auto& previous = nodes[nodes.size() - 2];
+            if (previous.entries.size() < 2) {
+                // Keys this long can't be spread over the nodes like that, so they're inserted one by one after all.
+                // The nodes of the levels that were written already are simply left unused.
+                for (auto& key : sorted_keys)
+                    VERIFY(m_root->insert(key));
+                return;
+            }
+            auto& last = nodes.last();
+            last.entries.append(separators.take_last());
+            last.down_pointers.append(last.first_down_pointer);
+            last.length += sizeof(u32) + last.entries.last().length();
+            last.first_down_pointer = previous.down_pointers.take_last();
+            auto separator = previous.entries.take_last();
+            previous.length -= sizeof(u32) + separator.length();
+            separators.append(move(separator));
+        }
+
+        // The root keeps the block it has, so the pointer to the tree doesn't change.
+        if (nodes.size() == 1) {
+            m_root = make_node(nodes.first(), pointer(), is_leaf);
+            serializer().serialize_and_write(*m_root.ptr(), m_root->pointer());
+            m_root->dump_if(SQL_DEBUG, "bulk_load");
+            return;
+        }
+
+        down_pointers.clear();
+        for (auto ix = 0u; ix < nodes.size(); ix++) {
+            auto node_pointer = new_record_pointer();
+            auto node = make_node(nodes[ix], node_pointer, is_leaf);
+            serializer().serialize_and_write(*node, node_pointer);
+            if (ix == 0)
+                first_down_pointer = node_pointer;
+            else
+                down_pointers.append(node_pointer);
+        }
+        keys = move(separators);
+    }
+}
+
 bool BTree::update_key_pointer(Key const& key)
 {
     if (!m_root)
@@ -103,6 +206,21 @@ BTreeIterator BTree::find(Key const& key)
     return end();
 }
 
+// Like find(), but gives the first entry that isn't less than the key, even if there is no entry the key matches exactly.
+BTreeIterator BTree::lower_bound(Key const& key)
+{
+    if (!m_root)
+        initialize_root();
+    VERIFY(m_root);
+    for (auto node = m_root->node_for(key); node; node = node->up()) {
+        for (auto ix = 0u; ix < node->size(); ix++) {
+            if ((*node)[ix].match(key) >= 0)
+                return BTreeIterator(node, (int)ix);
+        }
+    }
+    return end();
+}
+
 void BTree::list_tree()
 {
     if (!m_root)
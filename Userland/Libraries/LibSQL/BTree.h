@@ -100,10 +100,13 @@ public:
     ~BTree() override = default;
 
     u32 root() const { return (m_root) ? m_root->pointer() : 0; }
+    bool is_empty();
     bool insert(Key const&);
+    void bulk_load(Vector<Key> const& sorted_keys);
     bool update_key_pointer(Key const&);
     Optional<u32> get(Key&);
     BTreeIterator find(Key const& key);
+    BTreeIterator lower_bound(Key const& key);
     BTreeIterator begin();
     static BTreeIterator end();
     void list_tree();
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StdLibExtras.h>
+#include <LibSQL/BufferPool.h>
+
+namespace SQL {
+
+BufferPool::BufferPool(size_t block_size, size_t page_size, size_t frame_count)
+    : m_block_size(block_size)
+    , m_page_size(page_size)
+{
+    VERIFY(page_size >= min_page_size && page_size <= max_page_size);
+    VERIFY(is_power_of_two(page_size));
+    VERIFY(page_size % block_size == 0);
+    VERIFY(frame_count > 0);
+    m_frames.resize(frame_count);
+}
+
+Optional<ReadonlyBytes> BufferPool::block(u32 block)
+{
+    auto frame_index = m_frame_for_page.get(page_of(block));
+    if (!frame_index.has_value()) {
+        m_misses++;
+        return {};
+    }
+
+    auto& frame = m_frames[*frame_index];
+    auto offset = (block - first_block_of(*frame.page)) * m_block_size;
+    if (offset + m_block_size > frame.data.size()) {
+        m_misses++;
+        return {};
+    }
+
+    m_hits++;
+    frame.is_referenced = true;
+    return frame.data.bytes().slice(offset, m_block_size);
+}
+
+size_t BufferPool::find_victim()
+{
+    while (true) {
+        auto& frame = m_frames[m_clock_hand];
+        auto frame_index = m_clock_hand;
+        m_clock_hand = (m_clock_hand + 1) % m_frames.size();
+        if (!frame.page.has_value() || !frame.is_referenced)
+            return frame_index;
+        frame.is_referenced = false;
+    }
+}
+
+void BufferPool::evict(size_t frame_index)
+{
+    auto& frame = m_frames[frame_index];
+    if (frame.page.has_value())
+        m_frame_for_page.remove(*frame.page);
+    frame.page = {};
+    frame.is_referenced = false;
+}
+
+ErrorOr<void> BufferPool::insert_page(u32 page, ReadonlyBytes data)
+{
+    VERIFY(data.size() <= m_page_size);
+
+    size_t frame_index;
+    if (auto existing_frame = m_frame_for_page.get(page); existing_frame.has_value()) {
+        frame_index = *existing_frame;
+    } else {
+        frame_index = find_victim();
+        evict(frame_index);
+    }
+
+    auto& frame = m_frames[frame_index];
+    if (frame.data.capacity() < m_page_size)
+        TRY(frame.data.try_ensure_capacity(m_page_size));
+    TRY(frame.data.try_resize(data.size()));
+    data.copy_to(frame.data.bytes());
+    frame.page = page;
+    frame.is_referenced = true;
+    m_frame_for_page.set(page, frame_index);
+    return {};
+}
+
+void BufferPool::update_block(u32 block, ReadonlyBytes data)
+{
+    VERIFY(data.size() == m_block_size);
+    auto frame_index = m_frame_for_page.get(page_of(block));
+    if (!frame_index.has_value())
+        return;
+
+    auto& frame = m_frames[*frame_index];
+    auto offset = (block - first_block_of(*frame.page)) * m_block_size;
+    if (offset + m_block_size <= frame.data.size()) {
+        data.copy_to(frame.data.bytes().slice(offset));
+        return;
+    }
+
+    // A block that's appended right after the end of the page just makes it longer. The frame has room for a whole
+    // page, so that never has to allocate.
+    if (offset == frame.data.size()) {
+        frame.data.append(data);
+        return;
+    }
+
+    // There's a gap between what's in the frame and the block, which only reading the page again can fill.
+    evict(*frame_index);
+}
+
+void BufferPool::clear()
+{
+    for (auto ix = 0u; ix < m_frames.size(); ix++)
+        evict(ix);
+    m_clock_hand = 0;
+}
+
+}
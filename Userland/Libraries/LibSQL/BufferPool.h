@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace SQL {
+
+/**
+ * A BufferPool keeps the pages of a Heap file that were read most recently
+ * in memory, so that walking the same part of a B-Tree again doesn't have
+ * to go back to the file for every node.
+ *
+ * A page is a run of consecutive blocks, and is read from the file all at
+ * once. There is a fixed number of frames for pages to be kept in. Once all
+ * of them are taken, a page is evicted by the clock algorithm: the hand goes
+ * round the frames, giving every frame that was used since it last came by
+ * another round, and takes the first one that wasn't.
+ *
+ * The pool only ever hands out copies of what's in its frames, so a frame
+ * never has to stay pinned to its page while someone is using the page.
+ */
+class BufferPool {
+public:
+    static constexpr size_t min_page_size = 4 * KiB;
+    static constexpr size_t max_page_size = 16 * KiB;
+    static constexpr size_t default_page_size = 4 * KiB;
+    static constexpr size_t default_frame_count = 256;
+
+    BufferPool(size_t block_size, size_t page_size = default_page_size, size_t frame_count = default_frame_count);
+
+    size_t page_size() const { return m_page_size; }
+    size_t blocks_per_page() const { return m_page_size / m_block_size; }
+    u32 page_of(u32 block) const { return block / blocks_per_page(); }
+    u32 first_block_of(u32 page) const { return page * blocks_per_page(); }
+
+    // The contents of a block, if the page it's on is in the pool.
+    Optional<ReadonlyBytes> block(u32 block);
+
+    // Puts a page that was just read from the file in a frame. The last page of the file can be shorter than the others.
+    ErrorOr<void> insert_page(u32 page, ReadonlyBytes);
+
+    // Keeps the page a block is on up to date when the block is written to the file.
+    void update_block(u32 block, ReadonlyBytes);
+
+    void clear();
+
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+
+private:
+    struct Frame {
+        Optional<u32> page;
+        ByteBuffer data;
+        bool is_referenced { false };
+    };
+
+    size_t find_victim();
+    void evict(size_t frame_index);
+
+    size_t m_block_size { 0 };
+    size_t m_page_size { 0 };
+    Vector<Frame> m_frames;
+    size_t m_clock_hand { 0 };
+    HashMap<u32, size_t> m_frame_for_page;
+
+    size_t m_hits { 0 };
+    size_t m_misses { 0 };
+};
+
+}
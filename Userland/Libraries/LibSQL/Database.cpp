@@ -6,8 +6,10 @@
  */
 
 #include <AK/Format.h>
+#include <AK/QuickSort.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
+#include <AK/TypeCasts.h>
 
 #include <LibSQL/BTree.h>
 #include <LibSQL/Database.h>
@@ -42,6 +44,11 @@ ErrorOr<void> Database::open()
         m_heap->set_table_columns_root(m_table_columns->root());
     };
 
+    m_table_indexes = BTree::construct(m_serializer, IndexDef::index_def()->to_tuple_descriptor(), m_heap->table_indexes_root());
+    m_table_indexes->on_new_root = [&]() {
+        m_heap->set_table_indexes_root(m_table_indexes->root());
+    };
+
     m_open = true;
     auto default_schema = TRY(get_schema("default"));
     if (!default_schema) {
@@ -82,9 +89,34 @@ ErrorOr<void> Database::commit()
 {
     VERIFY(is_open());
     TRY(m_heap->flush());
+    if (m_heap->needs_checkpoint())
+        TRY(m_heap->checkpoint());
     return {};
 }
 
+void Database::commit_soon(Function<void(ErrorOr<void>)> on_committed)
+{
+    VERIFY(is_open());
+    m_pending_commits.append(move(on_committed));
+    if (m_pending_commits.size() > 1)
+        return;
+
+    deferred_invoke([this]() {
+        auto pending_commits = move(m_pending_commits);
+        auto result = m_heap->flush();
+        for (auto& on_committed : pending_commits)
+            on_committed(result);
+
+        // Everyone's heard back about their commit by the time this runs.
+        if (!result.is_error() && m_heap->needs_checkpoint()) {
+            deferred_invoke([this]() {
+                if (auto maybe_error = m_heap->checkpoint(); maybe_error.is_error())
+                    warnln("Database({}): could not checkpoint: {}"sv, m_heap->name(), maybe_error.error());
+            });
+        }
+    });
+}
+
 ErrorOr<void> Database::add_schema(SchemaDef const& schema)
 {
     VERIFY(is_open());
@@ -165,15 +197,102 @@ ErrorOr<RefPtr<TableDef>> Database::get_table(String const& schema, String const
     ret->set_pointer((*table_iterator).pointer());
     m_table_cache.set(key.hash(), ret);
     auto hash = ret->hash();
-    auto column_key = ColumnDef::make_key(ret);
+    auto column_key = ColumnDef::make_key(*ret);
     for (auto column_iterator = m_table_columns->find(column_key);
          !column_iterator.is_end() && ((*column_iterator)["table_hash"].to_u32().value() == hash);
          column_iterator++) {
         ret->append_column(*column_iterator);
     }
+
+    auto index_key = IndexDef::make_key(*ret);
+    for (auto index_iterator = m_table_indexes->find(index_key);
+         !index_iterator.is_end() && ((*index_iterator)["table_hash"].to_u32().value() == hash);
+         index_iterator++) {
+        auto index_def = IndexDef::construct(ret.ptr(), (*index_iterator)["index_name"].to_string(), (*index_iterator)["unique"].to_int().value() != 0, (*index_iterator).pointer());
+
+        // The key parts of an index are stored like the columns of a table, under the hash of the index.
+        auto index_hash = index_def->hash();
+        auto key_part_key = ColumnDef::make_key(*index_def);
+        for (auto key_part_iterator = m_table_columns->find(key_part_key);
+             !key_part_iterator.is_end() && ((*key_part_iterator)["table_hash"].to_u32().value() == index_hash);
+             key_part_iterator++) {
+            auto column_type = (*key_part_iterator)["column_type"].to_int();
+            VERIFY(column_type.has_value());
+            index_def->append_column((*key_part_iterator)["column_name"].to_string(), static_cast<SQLType>(*column_type));
+        }
+        ret->append_index(index_def);
+    }
     return RefPtr<TableDef>(ret);
 }
 
+ErrorOr<void> Database::add_index(IndexDef& index)
+{
+    VERIFY(is_open());
+    auto& table = verify_cast<TableDef>(*index.parent());
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+
+    if (!index.unique())
+        index.append_column(IndexDef::row_pointer_column_name, SQLType::Integer);
+
+    // The rows that are already in the table go into the index right away. They're checked before anything is
+    // written, so that an index that can't be created isn't left behind half made.
+    auto rows = TRY(select_all(table));
+    Vector<Key> keys;
+    TRY(keys.try_ensure_capacity(rows.size()));
+    for (auto& row : rows)
+        keys.unchecked_append(index_key_for(index, row));
+    quick_sort(keys);
+    if (index.unique()) {
+        for (auto ix = 1u; ix < keys.size(); ix++) {
+            if (keys[ix - 1] == keys[ix]) {
+                warnln("Rows of table '{}' are not unique for index '{}'"sv, table.name(), index.name());
+                return Error::from_string_literal("Unique constraint violated");
+            }
+        }
+    }
+
+    if (!m_table_indexes->insert(index.key())) {
+        warnln("Duplicate index name '{}' on table '{}'"sv, index.name(), table.name());
+        return Error::from_string_literal("Duplicate index name");
+    }
+    for (auto& key_part : index.key_definition()) {
+        VERIFY(m_table_columns->insert(key_part.key()));
+    }
+
+    index_tree(index)->bulk_load(keys);
+    table.append_index(index);
+    return {};
+}
+
+NonnullRefPtr<BTree> Database::index_tree(IndexDef const& index)
+{
+    auto hash = index.hash();
+    if (auto tree = m_index_trees.get(hash); tree.has_value())
+        return *tree.value();
+
+    // The keys are unique even in indexes that allow duplicates, because of the row pointer at the end of them.
+    auto tree = BTree::construct(m_serializer, index.to_tuple_descriptor(), true, index.pointer());
+    tree->on_new_root = [this, index_key = index.key(), &tree = *tree]() mutable {
+        index_key.set_pointer(tree.root());
+        VERIFY(m_table_indexes->update_key_pointer(index_key));
+    };
+    m_index_trees.set(hash, tree);
+    return tree;
+}
+
+Key Database::index_key_for(IndexDef const& index, Row const& row)
+{
+    Key key(index.to_tuple_descriptor());
+    for (auto& key_part : index.key_definition()) {
+        if (key_part.name() == IndexDef::row_pointer_column_name)
+            key[key_part.name()] = row.pointer();
+        else
+            key[key_part.name()] = row[key_part.name()];
+    }
+    key.set_pointer(row.pointer());
+    return key;
+}
+
 ErrorOr<Vector<Row>> Database::select_all(TableDef const& table)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -184,6 +303,46 @@ ErrorOr<Vector<Row>> Database::select_all(TableDef const& table)
     return ret;
 }
 
+ErrorOr<Row> Database::select_row(TableDef const& table, u32 pointer)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    VERIFY(pointer);
+    return m_serializer.deserialize_block<Row>(pointer, table, pointer);
+}
+
+ErrorOr<Optional<ByteBuffer>> Database::select_stored_row(TableDef const& table, u32 pointer)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    VERIFY(pointer);
+    if (m_heap->version() < Heap::compact_rows_version)
+        return Optional<ByteBuffer> {};
+    return Optional<ByteBuffer> { TRY(m_heap->read_block(pointer)) };
+}
+
+// Only the pointers are collected, so that the rows can be read one by one as they're needed. The index can't be walked
+// lazily instead, since inserting into it in the meantime moves its entries from one node to another.
+ErrorOr<Vector<u32>> Database::select_range_pointers(IndexDef const& index, Value const& lower_bound, Value const& upper_bound)
+{
+    auto const& table = verify_cast<TableDef>(*index.parent_relation());
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    auto tree = index_tree(index);
+
+    // Only the first key part is looked at. The rest of the key is left null, and a null key part matches anything.
+    auto const& first_key_part = index.key_definition().first().name();
+    Key lower_key(index.to_tuple_descriptor());
+    lower_key[first_key_part] = lower_bound;
+    Key upper_key(index.to_tuple_descriptor());
+    upper_key[first_key_part] = upper_bound;
+
+    Vector<u32> ret;
+    for (auto iterator = lower_bound.is_null() ? tree->begin() : tree->lower_bound(lower_key); !iterator.is_end(); iterator++) {
+        if (!upper_bound.is_null() && (*iterator).match(upper_key) > 0)
+            break;
+        TRY(ret.try_append((*iterator).pointer()));
+    }
+    return ret;
+}
+
 ErrorOr<Vector<Row>> Database::match(TableDef const& table, Key const& key)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -200,21 +359,86 @@ ErrorOr<Vector<Row>> Database::match(TableDef const& table, Key const& key)
     return ret;
 }
 
+bool Database::has_null_key_part(Key const& key)
+{
+    for (auto ix = 0u; ix < key.size(); ix++) {
+        if (key[ix].is_null())
+            return true;
+    }
+    return false;
+}
+
 ErrorOr<void> Database::insert(Row& row)
 {
-    VERIFY(m_table_cache.get(row.table()->key().hash()).has_value());
+    return insert_many({ &row, 1 });
+}
+
+// All the rows have to be for the same table. They're put in front of the rows the table has already, so that the
+// table only has to be pointed at its new first row once, and the keys for them go into every index in order.
+ErrorOr<void> Database::insert_many(Span<Row> rows)
+{
+    if (rows.is_empty())
+        return {};
+    auto table = rows[0].table();
+    VERIFY(m_table_cache.get(table->key().hash()).has_value());
     // TODO Check constraints
 
-    row.set_pointer(m_heap->new_record_pointer());
-    row.next_pointer(row.table()->pointer());
-    TRY(update(row));
+    // Nothing is written (or even given a block) before every unique index has been checked, both against the rows in
+    // the table and against the other rows that are inserted with it, so that no row ends up half inserted.
+    for (auto& index : table->indexes()) {
+        if (!index.unique())
+            continue;
+        auto tree = index_tree(index);
+        Vector<Key> keys;
+        TRY(keys.try_ensure_capacity(rows.size()));
+        for (auto& row : rows) {
+            VERIFY(row.table() == table);
+            auto key = index_key_for(index, row);
+            if (has_null_key_part(key))
+                continue;
+            if (!tree->find(key).is_end()) {
+                warnln("Row is not unique for index '{}'"sv, index.name());
+                return Error::from_string_literal("Unique constraint violated");
+            }
+            keys.unchecked_append(move(key));
+        }
+        quick_sort(keys);
+        for (auto ix = 1u; ix < keys.size(); ix++) {
+            if (keys[ix - 1] == keys[ix]) {
+                warnln("Row is not unique for index '{}'"sv, index.name());
+                return Error::from_string_literal("Unique constraint violated");
+            }
+        }
+    }
 
-    // TODO update indexes defined on table.
+    auto next_pointer = table->pointer();
+    for (auto& row : rows) {
+        row.set_pointer(m_heap->new_record_pointer());
+        row.next_pointer(next_pointer);
+        TRY(update(row));
+        next_pointer = row.pointer();
+    }
+
+    for (auto& index : table->indexes()) {
+        Vector<Key> keys;
+        TRY(keys.try_ensure_capacity(rows.size()));
+        for (auto& row : rows)
+            keys.unchecked_append(index_key_for(index, row));
+        quick_sort(keys);
+
+        auto tree = index_tree(index);
+        if (tree->is_empty()) {
+            tree->bulk_load(keys);
+            continue;
+        }
+        for (auto& key : keys)
+            VERIFY(tree->insert(key));
+    }
 
-    auto table_key = row.table()->key();
-    table_key.set_pointer(row.pointer());
+    auto table_key = table->key();
+    table_key.set_pointer(next_pointer);
     VERIFY(m_tables->update_key_pointer(table_key));
-    row.table()->set_pointer(row.pointer());
+    table->set_pointer(next_pointer);
     return {};
 }
 
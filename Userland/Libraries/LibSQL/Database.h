@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
 #include <LibCore/Object.h>
@@ -21,6 +22,10 @@ namespace SQL {
  * A Database object logically connects a Heap with the SQL data we want
  * to store in it. It has BTree pointers for B-Trees holding the definitions
  * of tables, columns, indexes, and other SQL objects.
+ *
+ * Every index defined on a table is a B-Tree of its own, with a key for each
+ * row of the table pointing at that row. The pointer in the index definition
+ * is the root of that tree.
  */
 class Database : public Core::Object {
     C_OBJECT(Database);
@@ -32,6 +37,10 @@ public:
     bool is_open() const { return m_open; }
     ErrorOr<void> commit();
 
+    // Commits once the event loop gets to it, together with everything else that's committed with this until then,
+    // so that they all share one sync of the write-ahead log.
+    void commit_soon(Function<void(ErrorOr<void>)> on_committed);
+
     ErrorOr<void> add_schema(SchemaDef const&);
     static Key get_schema_key(String const&);
     ErrorOr<RefPtr<SchemaDef>> get_schema(String const&);
@@ -40,23 +49,38 @@ public:
     static Key get_table_key(String const&, String const&);
     ErrorOr<RefPtr<TableDef>> get_table(String const&, String const&);
 
+    ErrorOr<void> add_index(IndexDef& index);
+
     ErrorOr<Vector<Row>> select_all(TableDef const&);
+    ErrorOr<Row> select_row(TableDef const&, u32 pointer);
+    // The row as it's stored, if the heap stores rows the way RowLayout lays them out. A few columns can be read out of
+    // it without reading the whole row.
+    ErrorOr<Optional<ByteBuffer>> select_stored_row(TableDef const&, u32 pointer);
+    ErrorOr<Vector<u32>> select_range_pointers(IndexDef const&, Value const& lower_bound, Value const& upper_bound);
     ErrorOr<Vector<Row>> match(TableDef const&, Key const&);
     ErrorOr<void> insert(Row&);
+    ErrorOr<void> insert_many(Span<Row>);
     ErrorOr<void> update(Row&);
 
 private:
     explicit Database(String);
 
+    NonnullRefPtr<BTree> index_tree(IndexDef const&);
+    static Key index_key_for(IndexDef const&, Row const&);
+    static bool has_null_key_part(Key const&);
+
     bool m_open { false };
     NonnullRefPtr<Heap> m_heap;
     Serializer m_serializer;
     RefPtr<BTree> m_schemas;
     RefPtr<BTree> m_tables;
     RefPtr<BTree> m_table_columns;
+    RefPtr<BTree> m_table_indexes;
 
     HashMap<u32, RefPtr<SchemaDef>> m_schema_cache;
     HashMap<u32, RefPtr<TableDef>> m_table_cache;
+    HashMap<u32, NonnullRefPtr<BTree>> m_index_trees;
+    Vector<Function<void(ErrorOr<void>)>> m_pending_commits;
 };
 
 }
@@ -50,13 +50,16 @@ class ColumnDefinition;
 class ColumnNameExpression;
 class CommonTableExpression;
 class CommonTableExpressionList;
+class CreateIndex;
 class CreateTable;
+class Cursor;
 class Delete;
 class DropColumn;
 class DropTable;
 class ErrorExpression;
 class ErrorStatement;
 class ExistsExpression;
+class Explain;
 class Expression;
 class GroupByClause;
 class InChainedExpression;
@@ -74,9 +77,11 @@ class NestedExpression;
 class NullExpression;
 class NullLiteral;
 class NumericLiteral;
+class Operator;
 class OrderingTerm;
 class Parser;
 class QualifiedTableName;
+class QueryPlan;
 class RenameColumn;
 class RenameTable;
 class ResultColumn;
@@ -8,14 +8,17 @@
 #include <AK/QuickSort.h>
 #include <AK/String.h>
 #include <LibCore/IODevice.h>
+#include <LibCrypto/Checksum/CRC32.h>
 #include <LibSQL/Heap.h>
 #include <LibSQL/Serializer.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 namespace SQL {
 
-Heap::Heap(String file_name)
+Heap::Heap(String file_name, size_t page_size)
+    : m_buffer_pool(BLOCKSIZE, page_size)
 {
     set_name(move(file_name));
 }
@@ -26,13 +29,22 @@ Heap::~Heap()
         if (auto maybe_error = flush(); maybe_error.is_error())
             warnln("~Heap({}): {}", name(), maybe_error.error());
     }
+    // Once everything in the log is in the heap file, there's no need to keep the log around until the heap is opened again.
+    if (m_file && m_write_ahead_log_file) {
+        if (auto maybe_error = checkpoint(); maybe_error.is_error())
+            warnln("~Heap({}): {}", name(), maybe_error.error());
+        else
+            unlink(write_ahead_log_file_name().characters());
+    }
 }
 
 ErrorOr<void> Heap::open()
 {
     size_t file_size = 0;
+    bool file_exists = true;
     struct stat stat_buffer;
     if (stat(name().characters(), &stat_buffer) != 0) {
+        file_exists = false;
         if (errno != ENOENT) {
             warnln("Heap::open({}): could not stat: {}"sv, name(), strerror(errno));
             return Error::from_string_literal("Heap::open(): could not stat file");
@@ -47,8 +59,18 @@ ErrorOr<void> Heap::open()
         m_next_block = m_end_of_file = file_size / BLOCKSIZE;
 
     auto file = TRY(Core::Stream::File::open(name(), Core::Stream::OpenMode::ReadWrite));
+    m_fd = file->fd();
     m_file = TRY(Core::Stream::BufferedFile::create(move(file)));
 
+    if (auto error_maybe = open_write_ahead_log_file(file_exists); error_maybe.is_error()) {
+        m_file = nullptr;
+        return error_maybe.release_error();
+    }
+
+    // Replaying the log may have written to a heap file that was empty before.
+    if (file_size == 0)
+        file_size = TRY(m_file->seek(0, Core::Stream::SeekMode::FromEndPosition));
+
     if (file_size > 0) {
         if (auto error_maybe = read_zero_block(); error_maybe.is_error()) {
             m_file = nullptr;
@@ -77,16 +99,46 @@ ErrorOr<ByteBuffer> Heap::read_block(u32 block)
         return Error::from_string_literal("Heap()::read_block(): block # out of range");
     }
 
-    dbgln_if(SQL_DEBUG, "Read heap block {}", block);
-    TRY(seek_block(block));
+    // Blocks that were handed out but haven't been written yet aren't in the file. The one right at the end of it reads
+    // as empty, same as it always has.
+    if (block >= m_end_of_file) {
+        TRY(seek_block(block));
+        return ByteBuffer {};
+    }
 
-    auto buffer = TRY(ByteBuffer::create_uninitialized(BLOCKSIZE));
-    auto bytes = TRY(m_file->read(buffer));
+    auto bytes = m_buffer_pool.block(block);
+    if (!bytes.has_value()) {
+        TRY(read_page(m_buffer_pool.page_of(block)));
+        bytes = m_buffer_pool.block(block);
+        VERIFY(bytes.has_value());
+    }
+
+    dbgln_if(SQL_DEBUG, "Read heap block {}", block);
+    dbgln_if(SQL_DEBUG, "{:hex-dump}", bytes->trim(8));
+    return TRY(ByteBuffer::copy(*bytes));
+}
 
-    dbgln_if(SQL_DEBUG, "{:hex-dump}", bytes.trim(8));
-    TRY(buffer.try_resize(bytes.size()));
+ErrorOr<void> Heap::read_page(u32 page)
+{
+    auto first_block = m_buffer_pool.first_block_of(page);
+    VERIFY(first_block < m_end_of_file);
+    auto block_count = min<u32>(m_buffer_pool.blocks_per_page(), m_end_of_file - first_block);
+
+    dbgln_if(SQL_DEBUG, "Read heap page {}: blocks {} to {}", page, first_block, first_block + block_count - 1);
+    TRY(seek_block(first_block));
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(block_count * BLOCKSIZE));
+    size_t bytes_read = 0;
+    while (bytes_read < buffer.size()) {
+        auto bytes = TRY(m_file->read(buffer.bytes().slice(bytes_read)));
+        if (bytes.is_empty()) {
+            warnln("Heap({})::read_page({}): unexpected end of file"sv, name(), page);
+            return Error::from_string_literal("Heap()::read_page(): unexpected end of file");
+        }
+        bytes_read += bytes.size();
+    }
 
-    return buffer;
+    return m_buffer_pool.insert_page(page, buffer);
 }
 
 ErrorOr<void> Heap::write_block(u32 block, ByteBuffer& buffer)
@@ -114,6 +166,7 @@ ErrorOr<void> Heap::write_block(u32 block, ByteBuffer& buffer)
 
     dbgln_if(SQL_DEBUG, "{:hex-dump}", buffer.bytes().trim(8));
     TRY(m_file->write(buffer));
+    m_buffer_pool.update_block(block, buffer);
 
     if (block == m_end_of_file)
         m_end_of_file++;
@@ -159,11 +212,17 @@ u32 Heap::new_record_pointer()
 ErrorOr<void> Heap::flush()
 {
     VERIFY(m_file);
+    if (m_write_ahead_log.is_empty())
+        return {};
+
     Vector<u32> blocks;
     for (auto& wal_entry : m_write_ahead_log) {
         blocks.append(wal_entry.key);
     }
     quick_sort(blocks);
+
+    // Once the blocks are in the log they're committed, even if writing them to the heap file doesn't get finished.
+    TRY(append_to_write_ahead_log_file(blocks));
     for (auto& block : blocks) {
         auto buffer_it = m_write_ahead_log.find(block);
         VERIFY(buffer_it != m_write_ahead_log.end());
@@ -175,6 +234,156 @@ ErrorOr<void> Heap::flush()
     return {};
 }
 
+// Every block in the log file is a record of its own: a header of its type, the block number and the CRC32 of the two
+// of those together with the block, followed by the block itself. The blocks of a commit are followed by a commit record,
+// with the number of blocks in the commit and a CRC32 of their checksums, and only count once that's there.
+constexpr static u32 WAL_BLOCK_RECORD = 0x4b4c4257;
+constexpr static u32 WAL_COMMIT_RECORD = 0x4d4f4357;
+constexpr static size_t WAL_RECORD_HEADER_SIZE = 3 * sizeof(u32);
+
+static u32 wal_block_checksum(u32 block, ReadonlyBytes data)
+{
+    Crypto::Checksum::CRC32 crc32;
+    crc32.update({ &WAL_BLOCK_RECORD, sizeof(u32) });
+    crc32.update({ &block, sizeof(u32) });
+    crc32.update(data);
+    return crc32.digest();
+}
+
+static void append_wal_record_header(ByteBuffer& buffer, u32 type, u32 value, u32 checksum)
+{
+    buffer.append(&type, sizeof(u32));
+    buffer.append(&value, sizeof(u32));
+    buffer.append(&checksum, sizeof(u32));
+}
+
+ErrorOr<void> Heap::append_to_write_ahead_log_file(Vector<u32> const& blocks)
+{
+    VERIFY(m_write_ahead_log_file);
+
+    // All of the records go out with a single write, and a single sync, no matter how many blocks there are.
+    ByteBuffer records;
+    TRY(records.try_ensure_capacity(blocks.size() * (WAL_RECORD_HEADER_SIZE + BLOCKSIZE) + WAL_RECORD_HEADER_SIZE));
+    Crypto::Checksum::CRC32 commit_crc32;
+    for (auto block : blocks) {
+        auto& buffer = m_write_ahead_log.find(block)->value;
+        VERIFY(buffer.size() <= BLOCKSIZE);
+        auto block_data = TRY(ByteBuffer::create_zeroed(BLOCKSIZE));
+        buffer.bytes().copy_to(block_data);
+
+        auto checksum = wal_block_checksum(block, block_data);
+        append_wal_record_header(records, WAL_BLOCK_RECORD, block, checksum);
+        records.append(block_data);
+        commit_crc32.update({ &checksum, sizeof(u32) });
+    }
+    append_wal_record_header(records, WAL_COMMIT_RECORD, blocks.size(), commit_crc32.digest());
+
+    TRY(m_write_ahead_log_file->seek(0, Core::Stream::SeekMode::FromEndPosition));
+    if (!m_write_ahead_log_file->write_or_error(records)) {
+        warnln("Heap({}): could not append to the write-ahead log"sv, name());
+        return Error::from_string_literal("Heap()::append_to_write_ahead_log_file(): could not write to the write-ahead log");
+    }
+    if (fsync(m_write_ahead_log_file->fd()) < 0)
+        return Error::from_syscall("fsync"sv, -errno);
+
+    m_blocks_in_write_ahead_log_file += blocks.size();
+    dbgln_if(SQL_DEBUG, "Appended {} blocks to the write-ahead log of {}", blocks.size(), name());
+    return {};
+}
+
+// Blocks from the log are written to where they go no matter how long the heap file is, since the heap file may not
+// have gotten as far as they did before the log was replayed.
+ErrorOr<void> Heap::write_recovered_block(u32 block, ReadonlyBytes data)
+{
+    TRY(m_file->seek(block * BLOCKSIZE, Core::Stream::SeekMode::SetPosition));
+    if (!m_file->write_or_error(data))
+        return Error::from_string_literal("Heap()::write_recovered_block(): could not write to the heap file");
+    m_end_of_file = max(m_end_of_file, block + 1);
+    m_next_block = max(m_next_block, m_end_of_file);
+    return {};
+}
+
+ErrorOr<void> Heap::open_write_ahead_log_file(bool replay)
+{
+    m_write_ahead_log_file = TRY(Core::Stream::File::open(write_ahead_log_file_name(), Core::Stream::OpenMode::ReadWrite));
+    auto log_size = TRY(m_write_ahead_log_file->seek(0, Core::Stream::SeekMode::FromEndPosition));
+    if (log_size == 0)
+        return {};
+
+    // A log without its heap file is left over from one that was deleted, and has nothing to do with the one that's
+    // being created now.
+    if (!replay) {
+        warnln("Heap({}): Discarding the write-ahead log of a heap file that doesn't exist anymore"sv, name());
+        return checkpoint();
+    }
+
+    TRY(m_write_ahead_log_file->seek(0, Core::Stream::SeekMode::SetPosition));
+    auto log = TRY(ByteBuffer::create_uninitialized(log_size));
+    size_t bytes_read = 0;
+    while (bytes_read < log.size()) {
+        auto bytes = TRY(m_write_ahead_log_file->read(log.bytes().slice(bytes_read)));
+        if (bytes.is_empty())
+            break;
+        bytes_read += bytes.size();
+    }
+
+    // Reads up to the first record that's cut off or doesn't match its checksum, which is where writing the log stopped.
+    size_t offset = 0;
+    size_t recovered_blocks = 0;
+    Vector<size_t> commit_block_offsets;
+    Crypto::Checksum::CRC32 commit_crc32;
+    while (offset + WAL_RECORD_HEADER_SIZE <= bytes_read) {
+        u32 header[3];
+        memcpy(header, log.offset_pointer(offset), WAL_RECORD_HEADER_SIZE);
+        auto [type, value, checksum] = header;
+        offset += WAL_RECORD_HEADER_SIZE;
+
+        if (type == WAL_BLOCK_RECORD) {
+            if (offset + BLOCKSIZE > bytes_read || wal_block_checksum(value, log.bytes().slice(offset, BLOCKSIZE)) != checksum)
+                break;
+            commit_block_offsets.append(offset);
+            commit_crc32.update({ &checksum, sizeof(u32) });
+            offset += BLOCKSIZE;
+            continue;
+        }
+
+        if (type != WAL_COMMIT_RECORD || value != commit_block_offsets.size() || commit_crc32.digest() != checksum)
+            break;
+        for (auto block_offset : commit_block_offsets) {
+            u32 block;
+            memcpy(&block, log.offset_pointer(block_offset - 2 * sizeof(u32)), sizeof(u32));
+            TRY(write_recovered_block(block, log.bytes().slice(block_offset, BLOCKSIZE)));
+        }
+        recovered_blocks += commit_block_offsets.size();
+        commit_block_offsets.clear();
+        commit_crc32 = {};
+    }
+
+    dbgln_if(SQL_DEBUG, "Recovered {} blocks from the write-ahead log of {}", recovered_blocks, name());
+    if (offset < bytes_read || !commit_block_offsets.is_empty())
+        warnln("Heap({}): Ignoring the incomplete commit at the end of the write-ahead log"sv, name());
+
+    m_blocks_in_write_ahead_log_file = recovered_blocks;
+    return checkpoint();
+}
+
+ErrorOr<void> Heap::checkpoint()
+{
+    VERIFY(m_file);
+    VERIFY(m_write_ahead_log_file);
+
+    // The log can only start over once everything in it is in the heap file for sure.
+    if (fsync(m_fd) < 0)
+        return Error::from_syscall("fsync"sv, -errno);
+    TRY(m_write_ahead_log_file->truncate(0));
+    if (fsync(m_write_ahead_log_file->fd()) < 0)
+        return Error::from_syscall("fsync"sv, -errno);
+
+    dbgln_if(SQL_DEBUG, "Checkpointed {} blocks from the write-ahead log of {}", m_blocks_in_write_ahead_log_file, name());
+    m_blocks_in_write_ahead_log_file = 0;
+    return {};
+}
+
 constexpr static auto FILE_ID = "SerenitySQL "sv;
 constexpr static auto VERSION_OFFSET = FILE_ID.length();
 constexpr static auto SCHEMAS_ROOT_OFFSET = VERSION_OFFSET + sizeof(u32);
@@ -182,6 +391,8 @@ constexpr static auto TABLES_ROOT_OFFSET = SCHEMAS_ROOT_OFFSET + sizeof(u32);
 constexpr static auto TABLE_COLUMNS_ROOT_OFFSET = TABLES_ROOT_OFFSET + sizeof(u32);
 constexpr static auto FREE_LIST_OFFSET = TABLE_COLUMNS_ROOT_OFFSET + sizeof(u32);
 constexpr static auto USER_VALUES_OFFSET = FREE_LIST_OFFSET + sizeof(u32);
+// This came after the user values, so heap files from before there were indexes still read as having none.
+constexpr static auto TABLE_INDEXES_ROOT_OFFSET = USER_VALUES_OFFSET + 16 * sizeof(u32);
 
 ErrorOr<void> Heap::read_zero_block()
 {
@@ -197,6 +408,10 @@ ErrorOr<void> Heap::read_zero_block()
 
     memcpy(&m_version, buffer.offset_pointer(VERSION_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Version: {}.{}", (m_version & 0xFFFF0000) >> 16, (m_version & 0x0000FFFF));
+    if (m_version > current_version) {
+        warnln("{}: Heap file version {} is newer than the latest one known, {}"sv, name(), m_version, current_version);
+        return Error::from_string_literal("Heap()::read_zero_block(): Heap file is from a newer version of SerenitySQL");
+    }
 
     memcpy(&m_schemas_root, buffer.offset_pointer(SCHEMAS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_schemas_root);
@@ -207,6 +422,9 @@ ErrorOr<void> Heap::read_zero_block()
     memcpy(&m_table_columns_root, buffer.offset_pointer(TABLE_COLUMNS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Table columns root node: {}", m_table_columns_root);
 
+    memcpy(&m_table_indexes_root, buffer.offset_pointer(TABLE_INDEXES_ROOT_OFFSET), sizeof(u32));
+    dbgln_if(SQL_DEBUG, "Table indexes root node: {}", m_table_indexes_root);
+
     memcpy(&m_free_list, buffer.offset_pointer(FREE_LIST_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Free list: {}", m_free_list);
 
@@ -226,6 +444,7 @@ void Heap::update_zero_block()
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_schemas_root);
     dbgln_if(SQL_DEBUG, "Tables root node: {}", m_tables_root);
     dbgln_if(SQL_DEBUG, "Table Columns root node: {}", m_table_columns_root);
+    dbgln_if(SQL_DEBUG, "Table Indexes root node: {}", m_table_indexes_root);
     dbgln_if(SQL_DEBUG, "Free list: {}", m_free_list);
     for (auto ix = 0u; ix < m_user_values.size(); ix++) {
         if (m_user_values[ix]) {
@@ -242,16 +461,18 @@ void Heap::update_zero_block()
     buffer.overwrite(TABLE_COLUMNS_ROOT_OFFSET, &m_table_columns_root, sizeof(u32));
     buffer.overwrite(FREE_LIST_OFFSET, &m_free_list, sizeof(u32));
     buffer.overwrite(USER_VALUES_OFFSET, m_user_values.data(), m_user_values.size() * sizeof(u32));
+    buffer.overwrite(TABLE_INDEXES_ROOT_OFFSET, &m_table_indexes_root, sizeof(u32));
 
     add_to_wal(0, buffer);
 }
 
 void Heap::initialize_zero_block()
 {
-    m_version = 0x00000001;
+    m_version = current_version;
     m_schemas_root = 0;
     m_tables_root = 0;
     m_table_columns_root = 0;
+    m_table_indexes_root = 0;
     m_next_block = 1;
     m_free_list = 0;
     for (auto& user : m_user_values) {
@@ -13,6 +13,7 @@
 #include <AK/Vector.h>
 #include <LibCore/Object.h>
 #include <LibCore/Stream.h>
+#include <LibSQL/BufferPool.h>
 
 namespace SQL {
 
@@ -28,6 +29,17 @@ constexpr static u32 BLOCKSIZE = 1024;
  * assumed that a single SQL database is backed by a single Heap.
  *
  * Currently only B-Trees and tuple stores are implemented.
+ *
+ * Blocks are read from the file a page at a time, and the pages that were
+ * used most recently are kept in a BufferPool.
+ *
+ * Blocks that are written are kept in memory until they're committed by
+ * flush(). That appends them to a write-ahead log file next to the heap
+ * file, and syncs it, before the blocks are written to the heap file
+ * itself. The heap file is only synced when the log is checkpointed, after
+ * which the log starts over. Whatever was committed after the last
+ * checkpoint is written to the heap file again from the log when the heap
+ * is opened, so a commit survives a crash as soon as flush() returns.
  */
 class Heap : public Core::Object {
     C_OBJECT(Heap);
@@ -65,6 +77,18 @@ public:
         m_table_columns_root = root;
         update_zero_block();
     }
+
+    u32 table_indexes_root() const { return m_table_indexes_root; }
+
+    void set_table_indexes_root(u32 root)
+    {
+        m_table_indexes_root = root;
+        update_zero_block();
+    }
+    // Version 2 stores the rows of tables in the compact format of RowLayout. Heap files made before that keep
+    // storing their rows as tuples.
+    static constexpr u32 current_version = 0x00000002;
+    static constexpr u32 compact_rows_version = 0x00000002;
     u32 version() const { return m_version; }
 
     u32 user_value(size_t index) const
@@ -89,25 +113,43 @@ public:
 
     ErrorOr<void> flush();
 
+    // The log is checkpointed once there are this many blocks in it.
+    static constexpr u32 checkpoint_threshold = 1024;
+    bool needs_checkpoint() const { return m_blocks_in_write_ahead_log_file >= checkpoint_threshold; }
+    ErrorOr<void> checkpoint();
+    String write_ahead_log_file_name() const { return String::formatted("{}-wal", name()); }
+
+    BufferPool const& buffer_pool() const { return m_buffer_pool; }
+
 private:
-    explicit Heap(String);
+    explicit Heap(String, size_t page_size = BufferPool::default_page_size);
 
     ErrorOr<void> write_block(u32, ByteBuffer&);
     ErrorOr<void> seek_block(u32);
+    ErrorOr<void> read_page(u32);
+    ErrorOr<void> open_write_ahead_log_file(bool replay);
+    ErrorOr<void> append_to_write_ahead_log_file(Vector<u32> const& blocks);
+    ErrorOr<void> write_recovered_block(u32, ReadonlyBytes);
     ErrorOr<void> read_zero_block();
     void initialize_zero_block();
     void update_zero_block();
 
     OwnPtr<Core::Stream::BufferedFile> m_file;
+    int m_fd { -1 };
+    OwnPtr<Core::Stream::File> m_write_ahead_log_file;
+    u32 m_blocks_in_write_ahead_log_file { 0 };
     u32 m_free_list { 0 };
     u32 m_next_block { 1 };
     u32 m_end_of_file { 1 };
     u32 m_schemas_root { 0 };
     u32 m_tables_root { 0 };
     u32 m_table_columns_root { 0 };
-    u32 m_version { 0x00000001 };
+    u32 m_table_indexes_root { 0 };
+    u32 m_version { current_version };
     Array<u32, 16> m_user_values { 0 };
+    // The blocks written since the last commit, which aren't in the log file yet.
     HashMap<u32, ByteBuffer> m_write_ahead_log;
+    BufferPool m_buffer_pool;
 };
 
 }
@@ -80,7 +80,7 @@ public:
     Value const& default_value() const { return m_default; }
 
     static NonnullRefPtr<IndexDef> index_def();
-    static Key make_key(TableDef const&);
+    static Key make_key(Relation const&);
 
 protected:
     ColumnDef(Relation*, size_t, String, SQLType);
@@ -119,6 +119,10 @@ public:
     static NonnullRefPtr<IndexDef> index_def();
     static Key make_key(TableDef const& table_def);
 
+    // Indexes that allow duplicates get this as their last key part, so that every entry in the tree is unique anyway
+    // and all the entries for one value sit next to each other.
+    static constexpr StringView row_pointer_column_name = "$row"sv;
+
 private:
     IndexDef(TableDef*, String, bool unique = true, u32 pointer = 0);
     explicit IndexDef(String, bool unique = true, u32 pointer = 0);
@@ -140,6 +144,7 @@ public:
     size_t num_indexes() { return m_indexes.size(); }
     NonnullRefPtrVector<ColumnDef> const& columns() const { return m_columns; }
     NonnullRefPtrVector<IndexDef> const& indexes() const { return m_indexes; }
+    void append_index(NonnullRefPtr<IndexDef>);
     [[nodiscard]] NonnullRefPtr<TupleDescriptor> to_tuple_descriptor() const;
 
     static NonnullRefPtr<IndexDef> index_def();
@@ -6,6 +6,7 @@
 
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
+#include <LibSQL/RowLayout.h>
 #include <LibSQL/Serializer.h>
 #include <LibSQL/Tuple.h>
 
@@ -34,16 +35,42 @@ Row::Row(RefPtr<TableDef> table, u32 pointer, Serializer& serializer)
     Row::deserialize(serializer);
 }
 
+// Rows that don't know their table can't be stored by the layout of its columns, so they're stored as tuples.
+bool Row::is_stored_compactly(Serializer& serializer) const
+{
+    return m_table && serializer.heap_version() >= Heap::compact_rows_version;
+}
+
+size_t Row::length() const
+{
+    if (!m_table)
+        return Tuple::length() + sizeof(u32);
+    return RowLayout(*descriptor()).length(*this);
+}
+
 void Row::deserialize(Serializer& serializer)
 {
-    Tuple::deserialize(serializer);
-    m_next_pointer = serializer.deserialize<u32>();
+    if (!is_stored_compactly(serializer)) {
+        Tuple::deserialize(serializer);
+        m_next_pointer = serializer.deserialize<u32>();
+        return;
+    }
+
+    RowLayout layout(*descriptor());
+    auto bytes = serializer.remaining_bytes();
+    m_next_pointer = RowLayout::next_pointer(bytes);
+    layout.read_columns(bytes, *this);
+    serializer.skip(layout.stored_length(bytes));
 }
 
 void Row::serialize(Serializer& serializer) const
 {
-    Tuple::serialize(serializer);
-    serializer.serialize<u32>(next_pointer());
+    if (!is_stored_compactly(serializer)) {
+        Tuple::serialize(serializer);
+        serializer.serialize<u32>(next_pointer());
+        return;
+    }
+    RowLayout(*descriptor()).serialize(serializer, *this, next_pointer());
 }
 
 void Row::copy_from(Row const& other)
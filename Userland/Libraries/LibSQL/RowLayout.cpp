@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/String.h>
+#include <LibSQL/RowLayout.h>
+#include <LibSQL/Serializer.h>
+#include <LibSQL/Tuple.h>
+#include <LibSQL/TupleDescriptor.h>
+#include <string.h>
+
+namespace SQL {
+
+static size_t slot_size(SQLType type)
+{
+    switch (type) {
+    case SQLType::Integer:
+        return sizeof(i32);
+    case SQLType::Float:
+        return sizeof(double);
+    case SQLType::Boolean:
+        return sizeof(u8);
+    case SQLType::Text:
+        return sizeof(u32);
+    default:
+        // Columns can't be of any other type, but if one was it would always be null.
+        return 0;
+    }
+}
+
+template<typename T>
+static T read_at(ReadonlyBytes bytes, size_t offset)
+{
+    T value;
+    memcpy(&value, bytes.slice(offset, sizeof(T)).data(), sizeof(T));
+    return value;
+}
+
+RowLayout::RowLayout(TupleDescriptor const& descriptor)
+{
+    m_fixed_length = null_bitmap_offset() + (descriptor.size() + 7) / 8;
+    m_slots.ensure_capacity(descriptor.size());
+    for (auto& element : descriptor) {
+        m_slots.unchecked_append({ element.type, m_fixed_length, m_last_text_slot });
+        if (element.type == SQLType::Text)
+            m_last_text_slot = m_slots.size() - 1;
+        m_fixed_length += slot_size(element.type);
+    }
+}
+
+size_t RowLayout::length(Tuple const& tuple) const
+{
+    VERIFY(tuple.size() == column_count());
+    size_t length = m_fixed_length;
+    for (auto ix = 0u; ix < m_slots.size(); ix++) {
+        if (m_slots[ix].type == SQLType::Text && !tuple[ix].is_null())
+            length += tuple[ix].to_string().length();
+    }
+    return length;
+}
+
+void RowLayout::serialize(Serializer& serializer, Tuple const& tuple, u32 next_pointer) const
+{
+    VERIFY(tuple.size() == column_count());
+    serializer.serialize<u32>(next_pointer);
+
+    // The values are turned into the type of their column first, since a value that can't be is stored as null.
+    Vector<Optional<Value>> values;
+    values.ensure_capacity(m_slots.size());
+    for (auto ix = 0u; ix < m_slots.size(); ix++) {
+        auto const& value = tuple[ix];
+        if (value.is_null()) {
+            values.unchecked_append({});
+            continue;
+        }
+        switch (m_slots[ix].type) {
+        case SQLType::Integer:
+            if (auto integer = value.to_int(); integer.has_value())
+                values.unchecked_append(Value(integer.value()));
+            else
+                values.unchecked_append({});
+            break;
+        case SQLType::Float:
+            if (auto number = value.to_double(); number.has_value())
+                values.unchecked_append(Value(number.value()));
+            else
+                values.unchecked_append({});
+            break;
+        case SQLType::Boolean:
+            if (auto boolean = value.to_bool(); boolean.has_value())
+                values.unchecked_append(Value(boolean.value()));
+            else
+                values.unchecked_append({});
+            break;
+        case SQLType::Text:
+            values.unchecked_append(Value(value.to_string()));
+            break;
+        default:
+            values.unchecked_append({});
+            break;
+        }
+    }
+
+    for (auto ix = 0u; ix < m_slots.size(); ix += 8) {
+        u8 null_bits = 0;
+        for (auto bit = 0u; bit < 8 && ix + bit < m_slots.size(); bit++) {
+            if (!values[ix + bit].has_value())
+                null_bits |= 1 << bit;
+        }
+        serializer.serialize<u8>(null_bits);
+    }
+
+    u32 text_end = 0;
+    for (auto ix = 0u; ix < m_slots.size(); ix++) {
+        auto const& value = values[ix];
+        switch (m_slots[ix].type) {
+        case SQLType::Integer:
+            serializer.serialize<i32>(value.has_value() ? value->to_int().value() : 0);
+            break;
+        case SQLType::Float:
+            serializer.serialize<double>(value.has_value() ? value->to_double().value() : 0.0);
+            break;
+        case SQLType::Boolean:
+            serializer.serialize<u8>(value.has_value() && value->to_bool().value() ? 1 : 0);
+            break;
+        case SQLType::Text:
+            if (value.has_value())
+                text_end += value->to_string().length();
+            serializer.serialize<u32>(text_end);
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (auto ix = 0u; ix < m_slots.size(); ix++) {
+        if (m_slots[ix].type == SQLType::Text && values[ix].has_value())
+            serializer.serialize_bytes(values[ix]->to_string().bytes());
+    }
+}
+
+u32 RowLayout::next_pointer(ReadonlyBytes bytes)
+{
+    return read_at<u32>(bytes, 0);
+}
+
+u32 RowLayout::text_end(ReadonlyBytes bytes, Optional<size_t> slot) const
+{
+    if (!slot.has_value())
+        return 0;
+    return read_at<u32>(bytes, m_slots[*slot].offset);
+}
+
+size_t RowLayout::stored_length(ReadonlyBytes bytes) const
+{
+    return m_fixed_length + text_end(bytes, m_last_text_slot);
+}
+
+bool RowLayout::is_null(ReadonlyBytes bytes, size_t column) const
+{
+    VERIFY(column < m_slots.size());
+    if (slot_size(m_slots[column].type) == 0)
+        return true;
+    auto null_bits = read_at<u8>(bytes, null_bitmap_offset() + column / 8);
+    return (null_bits & (1 << (column % 8))) != 0;
+}
+
+Value RowLayout::column(ReadonlyBytes bytes, size_t column) const
+{
+    auto const& slot = m_slots[column];
+    if (is_null(bytes, column))
+        return Value(slot.type);
+
+    switch (slot.type) {
+    case SQLType::Integer:
+        return Value(static_cast<int>(read_at<i32>(bytes, slot.offset)));
+    case SQLType::Float:
+        return Value(read_at<double>(bytes, slot.offset));
+    case SQLType::Boolean:
+        return Value(read_at<u8>(bytes, slot.offset) != 0);
+    case SQLType::Text: {
+        auto start = text_end(bytes, slot.previous_text_slot);
+        auto end = read_at<u32>(bytes, slot.offset);
+        VERIFY(start <= end);
+        return Value(String(StringView(bytes.slice(text_offset() + start, end - start))));
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+void RowLayout::read_columns(ReadonlyBytes bytes, Tuple& tuple) const
+{
+    VERIFY(tuple.size() == column_count());
+    for (auto ix = 0u; ix < m_slots.size(); ix++)
+        tuple[ix] = column(bytes, ix);
+}
+
+}
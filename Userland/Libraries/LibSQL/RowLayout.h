@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Type.h>
+#include <LibSQL/Value.h>
+
+namespace SQL {
+
+/**
+ * The way the rows of a table are stored in the heap. Unlike a Tuple, which
+ * stores the name and type of every one of its values along with it, a row
+ * only stores its values, in the order and with the types of the columns
+ * of its table:
+ *
+ *   u32 pointer to the next row
+ *   a bitmap with a bit for every column, which is set if it is null
+ *   a slot for every column: i32 for an integer, f64 for a float, u8 for
+ *     a boolean, and for text the u32 offset its characters end at among
+ *     the characters of all the text columns
+ *   the characters of all the text columns, one after the other
+ *
+ * Since every slot has the same size in every row, a single column can be
+ * read out of the stored row without reading any of the others.
+ *
+ * Values are stored as the type of their column. Integer columns round
+ * fractional numbers, and a value that can't be turned into the type of its
+ * column is stored as null.
+ */
+class RowLayout {
+public:
+    explicit RowLayout(TupleDescriptor const&);
+
+    size_t column_count() const { return m_slots.size(); }
+    size_t length(Tuple const&) const;
+
+    void serialize(Serializer&, Tuple const&, u32 next_pointer) const;
+
+    static u32 next_pointer(ReadonlyBytes);
+    size_t stored_length(ReadonlyBytes) const;
+    bool is_null(ReadonlyBytes, size_t column) const;
+    Value column(ReadonlyBytes, size_t column) const;
+    void read_columns(ReadonlyBytes, Tuple&) const;
+
+private:
+    struct Slot {
+        SQLType type;
+        size_t offset;
+        // The slot of the text column before this one, whose characters end where the ones of this one start.
+        Optional<size_t> previous_text_slot;
+    };
+
+    size_t null_bitmap_offset() const { return sizeof(u32); }
+    size_t text_offset() const { return m_fixed_length; }
+    u32 text_end(ReadonlyBytes, Optional<size_t> slot) const;
+
+    Vector<Slot> m_slots;
+    Optional<size_t> m_last_text_slot;
+    size_t m_fixed_length { 0 };
+};
+
+}
@@ -107,6 +107,20 @@ public:
 
     void serialize(String const&);
 
+    // Writes the bytes as they are, without their length in front of them.
+    void serialize_bytes(ReadonlyBytes bytes)
+    {
+        write(bytes.data(), bytes.size());
+    }
+
+    // What's left of the block being read, for things that read themselves out of it without going through the serializer.
+    [[nodiscard]] ReadonlyBytes remaining_bytes() const { return m_buffer.bytes().slice(m_current_offset); }
+    void skip(size_t size)
+    {
+        VERIFY(m_current_offset + size <= m_buffer.size());
+        m_current_offset += size;
+    }
+
     template<typename T>
     bool serialize_and_write(T const& t, u32 pointer)
     {
@@ -130,6 +144,9 @@ public:
         return pointer < m_heap->size();
     }
 
+    // Serializers without a heap are only used for values that aren't stored, so they may as well use the latest format.
+    u32 heap_version() const { return m_heap ? m_heap->version() : Heap::current_version; }
+
     Heap& heap()
     {
         VERIFY(m_heap.ptr() != nullptr);
@@ -106,7 +106,14 @@ void TreeNode::deserialize(Serializer& serializer)
 {
     auto nodes = serializer.deserialize<u32>();
     dbgln_if(SQL_DEBUG, "Deserializing node. Size {}", nodes);
-    if (nodes > 0) {
+
+    // Nodes that are read through a DownPointer are made as empty leaves first, which already have their one down
+    // pointer. What's on the heap replaces that.
+    m_down.clear();
+    if (nodes == 0) {
+        m_is_leaf = true;
+        m_down.empend(this, 0u);
+    } else {
         for (u32 i = 0; i < nodes; i++) {
             auto left = serializer.deserialize<u32>();
             dbgln_if(SQL_DEBUG, "Down[{}] {}", i, left);
@@ -144,7 +151,8 @@ size_t TreeNode::length() const
 {
     if (!size())
         return 0;
-    size_t len = sizeof(u32);
+    // The number of entries and the pointer to the right of the last one, and the entries with the pointers to their left.
+    size_t len = 2 * sizeof(u32);
     for (auto& key : m_entries) {
         len += sizeof(u32) + key.length();
     }
@@ -322,12 +330,12 @@ void TreeNode::split()
         auto entry = m_entries.take(median_index);
         auto down = m_down.take(median_index);
 
-        // Reparent to new right node:
+        // Reparent to new right node. Nodes that haven't been read yet get it as their parent when they are:
         if (down.m_node != nullptr) {
             down.m_node->m_up = new_node;
         }
         new_node->m_entries.append(entry);
-        new_node->m_down.append(move(down));
+        new_node->m_down.append(DownPointer(new_node, down));
     }
 
     // Move the median key in the node one level up. Its right node will
@@ -337,7 +345,7 @@ void TreeNode::split()
     dump_if(SQL_DEBUG, "Split Left To WAL");
     tree().serializer().serialize_and_write(*this, pointer());
     new_node->dump_if(SQL_DEBUG, "Split Right to WAL");
-    tree().serializer().serialize_and_write(*new_node, pointer());
+    tree().serializer().serialize_and_write(*new_node, new_node->pointer());
 
     m_up->just_insert(median, new_node);
 }
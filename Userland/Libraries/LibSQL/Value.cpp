@@ -6,6 +6,8 @@
  */
 
 #include <AK/NumericLimits.h>
+#include <LibIPC/Decoder.h>
+#include <LibIPC/Encoder.h>
 #include <LibSQL/AST/AST.h>
 #include <LibSQL/Serializer.h>
 #include <LibSQL/TupleDescriptor.h>
@@ -295,17 +297,17 @@ ResultOr<void> Value::assign_tuple(Vector<Value> values)
 
 size_t Value::length() const
 {
+    // This is the number of bytes the value takes up when it's serialized, which starts with the byte for its type.
     if (is_null())
-        return 0;
+        return sizeof(u8);
 
-    // FIXME: This seems to be more of an encoded byte size rather than a length.
     return m_value->visit(
-        [](String const& value) -> size_t { return sizeof(u32) + value.length(); },
-        [](int value) -> size_t { return sizeof(value); },
-        [](double value) -> size_t { return sizeof(value); },
-        [](bool value) -> size_t { return sizeof(value); },
+        [](String const& value) -> size_t { return sizeof(u8) + sizeof(u32) + value.length(); },
+        [](int value) -> size_t { return sizeof(u8) + sizeof(value); },
+        [](double value) -> size_t { return sizeof(u8) + sizeof(value); },
+        [](bool value) -> size_t { return sizeof(u8) + sizeof(value); },
         [](TupleValue const& value) -> size_t {
-            auto size = value.descriptor->length() + sizeof(u32);
+            auto size = sizeof(u8) + value.descriptor->length() + sizeof(u32);
 
             for (auto const& element : value.values)
                 size += element.length();
@@ -647,3 +649,99 @@ ResultOr<NonnullRefPtr<TupleDescriptor>> Value::infer_tuple_descriptor(Vector<Va
 }
 
 }
+
+// Values are sent to SQLServer as the values for the placeholders of a statement. A tuple is sent as the values in it.
+template<>
+bool IPC::encode(Encoder& encoder, SQL::Value const& value)
+{
+    encoder << to_underlying(value.type());
+    encoder << value.is_null();
+    if (value.is_null())
+        return true;
+
+    switch (value.type()) {
+    case SQL::SQLType::Null:
+        break;
+    case SQL::SQLType::Text:
+        encoder << value.to_string();
+        break;
+    case SQL::SQLType::Integer:
+        encoder << value.to_int().value();
+        break;
+    case SQL::SQLType::Float:
+        encoder << value.to_double().value();
+        break;
+    case SQL::SQLType::Boolean:
+        encoder << value.to_bool().value();
+        break;
+    case SQL::SQLType::Tuple:
+        encoder << value.to_vector().value();
+        break;
+    }
+    return true;
+}
+
+template<>
+ErrorOr<void> IPC::decode(Decoder& decoder, SQL::Value& value)
+{
+    UnderlyingType<SQL::SQLType> raw_type;
+    TRY(decoder.decode(raw_type));
+    bool is_null;
+    TRY(decoder.decode(is_null));
+
+    auto type = static_cast<SQL::SQLType>(raw_type);
+    switch (type) {
+    case SQL::SQLType::Null:
+    case SQL::SQLType::Text:
+    case SQL::SQLType::Integer:
+    case SQL::SQLType::Float:
+    case SQL::SQLType::Boolean:
+    case SQL::SQLType::Tuple:
+        break;
+    default:
+        return Error::from_string_literal("IPC: Invalid SQL value type");
+    }
+    if (is_null || type == SQL::SQLType::Null) {
+        value = SQL::Value { type };
+        return {};
+    }
+
+    switch (type) {
+    case SQL::SQLType::Text: {
+        String text;
+        TRY(decoder.decode(text));
+        value = SQL::Value { move(text) };
+        break;
+    }
+    case SQL::SQLType::Integer: {
+        int integer;
+        TRY(decoder.decode(integer));
+        value = SQL::Value { integer };
+        break;
+    }
+    case SQL::SQLType::Float: {
+        double number;
+        TRY(decoder.decode(number));
+        value = SQL::Value { number };
+        break;
+    }
+    case SQL::SQLType::Boolean: {
+        bool boolean;
+        TRY(decoder.decode(boolean));
+        value = SQL::Value { boolean };
+        break;
+    }
+    case SQL::SQLType::Tuple: {
+        Vector<SQL::Value> values;
+        TRY(decoder.decode(values));
+        auto tuple = SQL::Value::create_tuple(move(values));
+        if (tuple.is_error())
+            return Error::from_string_literal("IPC: Invalid SQL tuple");
+        value = tuple.release_value();
+        break;
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    return {};
+}
@@ -13,6 +13,7 @@
 #include <AK/StringView.h>
 #include <AK/Variant.h>
 #include <AK/Vector.h>
+#include <LibIPC/Forward.h>
 #include <LibSQL/Forward.h>
 #include <LibSQL/Result.h>
 #include <LibSQL/Type.h>
@@ -121,6 +122,16 @@ private:
 
 }
 
+namespace IPC {
+
+template<>
+bool encode(Encoder&, SQL::Value const&);
+
+template<>
+ErrorOr<void> decode(Decoder&, SQL::Value&);
+
+}
+
 template<>
 struct AK::Formatter<SQL::Value> : Formatter<StringView> {
     ErrorOr<void> format(FormatBuilder& builder, SQL::Value const& value)
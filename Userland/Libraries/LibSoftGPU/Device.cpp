@@ -33,6 +33,7 @@ static i64 g_num_pixels_blended;
 static i64 g_num_sampler_calls;
 static i64 g_num_stencil_writes;
 static i64 g_num_quads;
+static i64 g_num_fragment_pipeline_updates;
 
 using AK::abs;
 using AK::SIMD::any;
@@ -215,14 +216,17 @@ ALWAYS_INLINE static void test_alpha(PixelQuad& quad, GPU::AlphaTestFunction alp
     }
 }
 
-template<typename CB1, typename CB2, typename CB3>
-ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes)
+template<typename CB0, typename CB1, typename CB2, typename CB3>
+ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB0 may_cover_block, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes)
 {
     // Return if alpha testing is a no-op
     if (m_options.enable_alpha_test && m_options.alpha_test_func == GPU::AlphaTestFunction::Never)
         return;
     auto const alpha_test_ref_value = expand4(m_options.alpha_test_ref_value);
 
+    if (m_fragment_pipeline_dirty)
+        update_fragment_pipeline();
+
     // Buffers
     auto color_buffer = m_frame_buffer->color_buffer();
     auto depth_buffer = m_frame_buffer->depth_buffer();
@@ -281,245 +285,254 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
     auto const qy0 = render_bounds_top & ~1;
     auto const qy1 = render_bounds_bottom & ~1;
 
-    // Rasterize all quads
+    // Rasterize all quads, one block at a time. Blocks that the primitive cannot cover are skipped as a whole.
     // FIXME: this could be embarrassingly parallel
-    for (int qy = qy0; qy <= qy1; qy += 2) {
-        for (int qx = qx0; qx <= qx1; qx += 2) {
-            PixelQuad quad;
-            quad.screen_coordinates = {
-                i32x4 { qx, qx + 1, qx, qx + 1 },
-                i32x4 { qy, qy, qy + 1, qy + 1 },
-            };
-
-            // Set coverage mask and test against render bounds
-            set_coverage_mask(quad);
-            quad.mask &= quad.screen_coordinates.x() >= render_bounds_left
-                && quad.screen_coordinates.x() <= render_bounds_right
-                && quad.screen_coordinates.y() >= render_bounds_top
-                && quad.screen_coordinates.y() <= render_bounds_bottom;
-            auto coverage_bits = maskbits(quad.mask);
-            if (coverage_bits == 0)
+    for (int by = qy0; by <= qy1; by += RASTERIZER_BLOCK_SIZE) {
+        for (int bx = qx0; bx <= qx1; bx += RASTERIZER_BLOCK_SIZE) {
+            if (!may_cover_block(Gfx::IntRect { bx, by, RASTERIZER_BLOCK_SIZE, RASTERIZER_BLOCK_SIZE }))
                 continue;
 
-            INCREASE_STATISTICS_COUNTER(g_num_quads, 1);
-            INCREASE_STATISTICS_COUNTER(g_num_pixels, maskcount(quad.mask));
-
-            // Stencil testing
-            GPU::StencilType* stencil_ptrs[4];
-            i32x4 stencil_value;
-            if (m_options.enable_stencil_test) {
-                stencil_ptrs[0] = coverage_bits & 1 ? &stencil_buffer->scanline(qy)[qx] : nullptr;
-                stencil_ptrs[1] = coverage_bits & 2 ? &stencil_buffer->scanline(qy)[qx + 1] : nullptr;
-                stencil_ptrs[2] = coverage_bits & 4 ? &stencil_buffer->scanline(qy + 1)[qx] : nullptr;
-                stencil_ptrs[3] = coverage_bits & 8 ? &stencil_buffer->scanline(qy + 1)[qx + 1] : nullptr;
-
-                stencil_value = load4_masked(stencil_ptrs[0], stencil_ptrs[1], stencil_ptrs[2], stencil_ptrs[3], quad.mask);
-                stencil_value &= stencil_configuration.test_mask;
-
-                i32x4 stencil_test_passed;
-                switch (stencil_configuration.test_function) {
-                case GPU::StencilTestFunction::Always:
-                    stencil_test_passed = expand4(~0);
-                    break;
-                case GPU::StencilTestFunction::Equal:
-                    stencil_test_passed = stencil_value == stencil_reference_value;
-                    break;
-                case GPU::StencilTestFunction::Greater:
-                    stencil_test_passed = stencil_value > stencil_reference_value;
-                    break;
-                case GPU::StencilTestFunction::GreaterOrEqual:
-                    stencil_test_passed = stencil_value >= stencil_reference_value;
-                    break;
-                case GPU::StencilTestFunction::Less:
-                    stencil_test_passed = stencil_value < stencil_reference_value;
-                    break;
-                case GPU::StencilTestFunction::LessOrEqual:
-                    stencil_test_passed = stencil_value <= stencil_reference_value;
-                    break;
-                case GPU::StencilTestFunction::Never:
-                    stencil_test_passed = expand4(0);
-                    break;
-                case GPU::StencilTestFunction::NotEqual:
-                    stencil_test_passed = stencil_value != stencil_reference_value;
-                    break;
-                default:
-                    VERIFY_NOT_REACHED();
-                }
-
-                // Update stencil buffer for pixels that failed the stencil test
-                write_to_stencil(
-                    stencil_ptrs,
-                    stencil_value,
-                    stencil_configuration.on_stencil_test_fail,
-                    stencil_reference_value,
-                    stencil_configuration.write_mask,
-                    quad.mask & ~stencil_test_passed);
-
-                // Update coverage mask + early quad rejection
-                quad.mask &= stencil_test_passed;
-                coverage_bits = maskbits(quad.mask);
-                if (coverage_bits == 0)
-                    continue;
-            }
+            auto const block_qx1 = min(bx + RASTERIZER_BLOCK_SIZE - 2, qx1);
+            auto const block_qy1 = min(by + RASTERIZER_BLOCK_SIZE - 2, qy1);
+            for (int qy = by; qy <= block_qy1; qy += 2) {
+                for (int qx = bx; qx <= block_qx1; qx += 2) {
+                    PixelQuad quad;
+                    quad.screen_coordinates = {
+                        i32x4 { qx, qx + 1, qx, qx + 1 },
+                        i32x4 { qy, qy, qy + 1, qy + 1 },
+                    };
 
-            // Depth testing
-            GPU::DepthType* depth_ptrs[4] = {
-                coverage_bits & 1 ? &depth_buffer->scanline(qy)[qx] : nullptr,
-                coverage_bits & 2 ? &depth_buffer->scanline(qy)[qx + 1] : nullptr,
-                coverage_bits & 4 ? &depth_buffer->scanline(qy + 1)[qx] : nullptr,
-                coverage_bits & 8 ? &depth_buffer->scanline(qy + 1)[qx + 1] : nullptr,
-            };
-            if (m_options.enable_depth_test) {
-                set_quad_depth(quad);
-
-                auto depth = load4_masked(depth_ptrs[0], depth_ptrs[1], depth_ptrs[2], depth_ptrs[3], quad.mask);
-                i32x4 depth_test_passed;
-                switch (m_options.depth_func) {
-                case GPU::DepthTestFunction::Always:
-                    depth_test_passed = expand4(~0);
-                    break;
-                case GPU::DepthTestFunction::Never:
-                    depth_test_passed = expand4(0);
-                    break;
-                case GPU::DepthTestFunction::Greater:
-                    depth_test_passed = quad.depth > depth;
-                    break;
-                case GPU::DepthTestFunction::GreaterOrEqual:
-                    depth_test_passed = quad.depth >= depth;
-                    break;
-                case GPU::DepthTestFunction::NotEqual:
-#ifdef __SSE__
-                    depth_test_passed = quad.depth != depth;
-#else
-                    depth_test_passed = i32x4 {
-                        bit_cast<u32>(quad.depth[0]) != bit_cast<u32>(depth[0]) ? -1 : 0,
-                        bit_cast<u32>(quad.depth[1]) != bit_cast<u32>(depth[1]) ? -1 : 0,
-                        bit_cast<u32>(quad.depth[2]) != bit_cast<u32>(depth[2]) ? -1 : 0,
-                        bit_cast<u32>(quad.depth[3]) != bit_cast<u32>(depth[3]) ? -1 : 0,
+                    // Set coverage mask and test against render bounds
+                    set_coverage_mask(quad);
+                    quad.mask &= quad.screen_coordinates.x() >= render_bounds_left
+                        && quad.screen_coordinates.x() <= render_bounds_right
+                        && quad.screen_coordinates.y() >= render_bounds_top
+                        && quad.screen_coordinates.y() <= render_bounds_bottom;
+                    auto coverage_bits = maskbits(quad.mask);
+                    if (coverage_bits == 0)
+                        continue;
+
+                    INCREASE_STATISTICS_COUNTER(g_num_quads, 1);
+                    INCREASE_STATISTICS_COUNTER(g_num_pixels, maskcount(quad.mask));
+
+                    // Stencil testing
+                    GPU::StencilType* stencil_ptrs[4];
+                    i32x4 stencil_value;
+                    if (m_options.enable_stencil_test) {
+                        stencil_ptrs[0] = coverage_bits & 1 ? &stencil_buffer->scanline(qy)[qx] : nullptr;
+                        stencil_ptrs[1] = coverage_bits & 2 ? &stencil_buffer->scanline(qy)[qx + 1] : nullptr;
+                        stencil_ptrs[2] = coverage_bits & 4 ? &stencil_buffer->scanline(qy + 1)[qx] : nullptr;
+                        stencil_ptrs[3] = coverage_bits & 8 ? &stencil_buffer->scanline(qy + 1)[qx + 1] : nullptr;
+
+                        stencil_value = load4_masked(stencil_ptrs[0], stencil_ptrs[1], stencil_ptrs[2], stencil_ptrs[3], quad.mask);
+                        stencil_value &= stencil_configuration.test_mask;
+
+                        i32x4 stencil_test_passed;
+                        switch (stencil_configuration.test_function) {
+                        case GPU::StencilTestFunction::Always:
+                            stencil_test_passed = expand4(~0);
+                            break;
+                        case GPU::StencilTestFunction::Equal:
+                            stencil_test_passed = stencil_value == stencil_reference_value;
+                            break;
+                        case GPU::StencilTestFunction::Greater:
+                            stencil_test_passed = stencil_value > stencil_reference_value;
+                            break;
+                        case GPU::StencilTestFunction::GreaterOrEqual:
+                            stencil_test_passed = stencil_value >= stencil_reference_value;
+                            break;
+                        case GPU::StencilTestFunction::Less:
+                            stencil_test_passed = stencil_value < stencil_reference_value;
+                            break;
+                        case GPU::StencilTestFunction::LessOrEqual:
+                            stencil_test_passed = stencil_value <= stencil_reference_value;
+                            break;
+                        case GPU::StencilTestFunction::Never:
+                            stencil_test_passed = expand4(0);
+                            break;
+                        case GPU::StencilTestFunction::NotEqual:
+                            stencil_test_passed = stencil_value != stencil_reference_value;
+                            break;
+                        default:
+                            VERIFY_NOT_REACHED();
+                        }
+
+                        // Update stencil buffer for pixels that failed the stencil test
+                        write_to_stencil(
+                            stencil_ptrs,
+                            stencil_value,
+                            stencil_configuration.on_stencil_test_fail,
+                            stencil_reference_value,
+                            stencil_configuration.write_mask,
+                            quad.mask & ~stencil_test_passed);
+
+                        // Update coverage mask + early quad rejection
+                        quad.mask &= stencil_test_passed;
+                        coverage_bits = maskbits(quad.mask);
+                        if (coverage_bits == 0)
+                            continue;
+                    }
+
+                    // Depth testing
+                    GPU::DepthType* depth_ptrs[4] = {
+                        coverage_bits & 1 ? &depth_buffer->scanline(qy)[qx] : nullptr,
+                        coverage_bits & 2 ? &depth_buffer->scanline(qy)[qx + 1] : nullptr,
+                        coverage_bits & 4 ? &depth_buffer->scanline(qy + 1)[qx] : nullptr,
+                        coverage_bits & 8 ? &depth_buffer->scanline(qy + 1)[qx + 1] : nullptr,
                     };
-#endif
-                    break;
-                case GPU::DepthTestFunction::Equal:
-#ifdef __SSE__
-                    depth_test_passed = quad.depth == depth;
-#else
-                    //
-                    // This is an interesting quirk that occurs due to us using the x87 FPU when Serenity is
-                    // compiled for the i686 target. When we calculate our depth value to be stored in the buffer,
-                    // it is an 80-bit x87 floating point number, however, when stored into the depth buffer, this is
-                    // truncated to 32 bits. This 38 bit loss of precision means that when x87 `FCOMP` is eventually
-                    // used here the comparison fails.
-                    // This could be solved by using a `long double` for the depth buffer, however this would take
-                    // up significantly more space and is completely overkill for a depth buffer. As such, comparing
-                    // the first 32-bits of this depth value is "good enough" that if we get a hit on it being
-                    // equal, we can pretty much guarantee that it's actually equal.
-                    //
-                    depth_test_passed = i32x4 {
-                        bit_cast<u32>(quad.depth[0]) == bit_cast<u32>(depth[0]) ? -1 : 0,
-                        bit_cast<u32>(quad.depth[1]) == bit_cast<u32>(depth[1]) ? -1 : 0,
-                        bit_cast<u32>(quad.depth[2]) == bit_cast<u32>(depth[2]) ? -1 : 0,
-                        bit_cast<u32>(quad.depth[3]) == bit_cast<u32>(depth[3]) ? -1 : 0,
+                    if (m_options.enable_depth_test) {
+                        set_quad_depth(quad);
+
+                        auto depth = load4_masked(depth_ptrs[0], depth_ptrs[1], depth_ptrs[2], depth_ptrs[3], quad.mask);
+                        i32x4 depth_test_passed;
+                        switch (m_options.depth_func) {
+                        case GPU::DepthTestFunction::Always:
+                            depth_test_passed = expand4(~0);
+                            break;
+                        case GPU::DepthTestFunction::Never:
+                            depth_test_passed = expand4(0);
+                            break;
+                        case GPU::DepthTestFunction::Greater:
+                            depth_test_passed = quad.depth > depth;
+                            break;
+                        case GPU::DepthTestFunction::GreaterOrEqual:
+                            depth_test_passed = quad.depth >= depth;
+                            break;
+                        case GPU::DepthTestFunction::NotEqual:
+        #ifdef __SSE__
+                            depth_test_passed = quad.depth != depth;
+        #else
+                            depth_test_passed = i32x4 {
+                                bit_cast<u32>(quad.depth[0]) != bit_cast<u32>(depth[0]) ? -1 : 0,
+                                bit_cast<u32>(quad.depth[1]) != bit_cast<u32>(depth[1]) ? -1 : 0,
+                                bit_cast<u32>(quad.depth[2]) != bit_cast<u32>(depth[2]) ? -1 : 0,
+                                bit_cast<u32>(quad.depth[3]) != bit_cast<u32>(depth[3]) ? -1 : 0,
+                            };
+        #endif
+                            break;
+                        case GPU::DepthTestFunction::Equal:
+        #ifdef __SSE__
+                            depth_test_passed = quad.depth == depth;
+        #else
+                            //
+                            // This is an interesting quirk that occurs due to us using the x87 FPU when Serenity is
+                            // compiled for the i686 target. When we calculate our depth value to be stored in the buffer,
+                            // it is an 80-bit x87 floating point number, however, when stored into the depth buffer, this is
+                            // truncated to 32 bits. This 38 bit loss of precision means that when x87 `FCOMP` is eventually
+                            // used here the comparison fails.
+                            // This could be solved by using a `long double` for the depth buffer, however this would take
+                            // up significantly more space and is completely overkill for a depth buffer. As such, comparing
+                            // the first 32-bits of this depth value is "good enough" that if we get a hit on it being
+                            // equal, we can pretty much guarantee that it's actually equal.
+                            //
+                            depth_test_passed = i32x4 {
+                                bit_cast<u32>(quad.depth[0]) == bit_cast<u32>(depth[0]) ? -1 : 0,
+                                bit_cast<u32>(quad.depth[1]) == bit_cast<u32>(depth[1]) ? -1 : 0,
+                                bit_cast<u32>(quad.depth[2]) == bit_cast<u32>(depth[2]) ? -1 : 0,
+                                bit_cast<u32>(quad.depth[3]) == bit_cast<u32>(depth[3]) ? -1 : 0,
+                            };
+        #endif
+                            break;
+                        case GPU::DepthTestFunction::LessOrEqual:
+                            depth_test_passed = quad.depth <= depth;
+                            break;
+                        case GPU::DepthTestFunction::Less:
+                            depth_test_passed = quad.depth < depth;
+                            break;
+                        default:
+                            VERIFY_NOT_REACHED();
+                        }
+
+                        // Update stencil buffer for pixels that failed the depth test
+                        if (m_options.enable_stencil_test) {
+                            write_to_stencil(
+                                stencil_ptrs,
+                                stencil_value,
+                                stencil_configuration.on_depth_test_fail,
+                                stencil_reference_value,
+                                stencil_configuration.write_mask,
+                                quad.mask & ~depth_test_passed);
+                        }
+
+                        // Update coverage mask + early quad rejection
+                        quad.mask &= depth_test_passed;
+                        coverage_bits = maskbits(quad.mask);
+                        if (coverage_bits == 0)
+                            continue;
+                    }
+
+                    // Update stencil buffer for passed pixels
+                    if (m_options.enable_stencil_test) {
+                        write_to_stencil(
+                            stencil_ptrs,
+                            stencil_value,
+                            stencil_configuration.on_pass,
+                            stencil_reference_value,
+                            stencil_configuration.write_mask,
+                            quad.mask);
+                    }
+
+                    INCREASE_STATISTICS_COUNTER(g_num_pixels_shaded, maskcount(quad.mask));
+
+                    set_quad_attributes(quad);
+                    (this->*m_shade_fragments)(quad);
+
+                    // Alpha testing
+                    if (m_options.enable_alpha_test) {
+                        test_alpha(quad, m_options.alpha_test_func, alpha_test_ref_value);
+                        coverage_bits = maskbits(quad.mask);
+                        if (coverage_bits == 0)
+                            continue;
+                    }
+
+                    // Write to depth buffer
+                    if (m_options.enable_depth_test && m_options.enable_depth_write)
+                        store4_masked(quad.depth, depth_ptrs[0], depth_ptrs[1], depth_ptrs[2], depth_ptrs[3], quad.mask);
+
+                    // We will not update the color buffer at all
+                    if ((m_options.color_mask == 0) || !m_options.enable_color_write)
+                        continue;
+
+                    GPU::ColorType* color_ptrs[4] = {
+                        coverage_bits & 1 ? &color_buffer->scanline(qy)[qx] : nullptr,
+                        coverage_bits & 2 ? &color_buffer->scanline(qy)[qx + 1] : nullptr,
+                        coverage_bits & 4 ? &color_buffer->scanline(qy + 1)[qx] : nullptr,
+                        coverage_bits & 8 ? &color_buffer->scanline(qy + 1)[qx + 1] : nullptr,
                     };
-#endif
-                    break;
-                case GPU::DepthTestFunction::LessOrEqual:
-                    depth_test_passed = quad.depth <= depth;
-                    break;
-                case GPU::DepthTestFunction::Less:
-                    depth_test_passed = quad.depth < depth;
-                    break;
-                default:
-                    VERIFY_NOT_REACHED();
-                }
 
-                // Update stencil buffer for pixels that failed the depth test
-                if (m_options.enable_stencil_test) {
-                    write_to_stencil(
-                        stencil_ptrs,
-                        stencil_value,
-                        stencil_configuration.on_depth_test_fail,
-                        stencil_reference_value,
-                        stencil_configuration.write_mask,
-                        quad.mask & ~depth_test_passed);
+                    u32x4 dst_u32;
+                    if (m_options.enable_blending || m_options.color_mask != 0xffffffff)
+                        dst_u32 = load4_masked(color_ptrs[0], color_ptrs[1], color_ptrs[2], color_ptrs[3], quad.mask);
+
+                    if (m_options.enable_blending) {
+                        INCREASE_STATISTICS_COUNTER(g_num_pixels_blended, maskcount(quad.mask));
+
+                        // Blend color values from pixel_staging into color_buffer
+                        auto const& src = quad.out_color;
+                        auto dst = to_vec4(dst_u32);
+
+                        auto src_factor = expand4(m_alpha_blend_factors.src_constant)
+                            + src * m_alpha_blend_factors.src_factor_src_color
+                            + Vector4<f32x4> { src.w(), src.w(), src.w(), src.w() } * m_alpha_blend_factors.src_factor_src_alpha
+                            + dst * m_alpha_blend_factors.src_factor_dst_color
+                            + Vector4<f32x4> { dst.w(), dst.w(), dst.w(), dst.w() } * m_alpha_blend_factors.src_factor_dst_alpha;
+
+                        auto dst_factor = expand4(m_alpha_blend_factors.dst_constant)
+                            + src * m_alpha_blend_factors.dst_factor_src_color
+                            + Vector4<f32x4> { src.w(), src.w(), src.w(), src.w() } * m_alpha_blend_factors.dst_factor_src_alpha
+                            + dst * m_alpha_blend_factors.dst_factor_dst_color
+                            + Vector4<f32x4> { dst.w(), dst.w(), dst.w(), dst.w() } * m_alpha_blend_factors.dst_factor_dst_alpha;
+
+                        quad.out_color = src * src_factor + dst * dst_factor;
+                    }
+
+                    auto const argb32_color = to_argb32(quad.out_color);
+                    if (m_options.color_mask == 0xffffffff)
+                        store4_masked(argb32_color, color_ptrs[0], color_ptrs[1], color_ptrs[2], color_ptrs[3], quad.mask);
+                    else
+                        store4_masked((argb32_color & m_options.color_mask) | (dst_u32 & ~m_options.color_mask), color_ptrs[0], color_ptrs[1], color_ptrs[2], color_ptrs[3], quad.mask);
                 }
-
-                // Update coverage mask + early quad rejection
-                quad.mask &= depth_test_passed;
-                coverage_bits = maskbits(quad.mask);
-                if (coverage_bits == 0)
-                    continue;
-            }
-
-            // Update stencil buffer for passed pixels
-            if (m_options.enable_stencil_test) {
-                write_to_stencil(
-                    stencil_ptrs,
-                    stencil_value,
-                    stencil_configuration.on_pass,
-                    stencil_reference_value,
-                    stencil_configuration.write_mask,
-                    quad.mask);
             }
-
-            INCREASE_STATISTICS_COUNTER(g_num_pixels_shaded, maskcount(quad.mask));
-
-            set_quad_attributes(quad);
-            shade_fragments(quad);
-
-            // Alpha testing
-            if (m_options.enable_alpha_test) {
-                test_alpha(quad, m_options.alpha_test_func, alpha_test_ref_value);
-                coverage_bits = maskbits(quad.mask);
-                if (coverage_bits == 0)
-                    continue;
-            }
-
-            // Write to depth buffer
-            if (m_options.enable_depth_test && m_options.enable_depth_write)
-                store4_masked(quad.depth, depth_ptrs[0], depth_ptrs[1], depth_ptrs[2], depth_ptrs[3], quad.mask);
-
-            // We will not update the color buffer at all
-            if ((m_options.color_mask == 0) || !m_options.enable_color_write)
-                continue;
-
-            GPU::ColorType* color_ptrs[4] = {
-                coverage_bits & 1 ? &color_buffer->scanline(qy)[qx] : nullptr,
-                coverage_bits & 2 ? &color_buffer->scanline(qy)[qx + 1] : nullptr,
-                coverage_bits & 4 ? &color_buffer->scanline(qy + 1)[qx] : nullptr,
-                coverage_bits & 8 ? &color_buffer->scanline(qy + 1)[qx + 1] : nullptr,
-            };
-
-            u32x4 dst_u32;
-            if (m_options.enable_blending || m_options.color_mask != 0xffffffff)
-                dst_u32 = load4_masked(color_ptrs[0], color_ptrs[1], color_ptrs[2], color_ptrs[3], quad.mask);
-
-            if (m_options.enable_blending) {
-                INCREASE_STATISTICS_COUNTER(g_num_pixels_blended, maskcount(quad.mask));
-
-                // Blend color values from pixel_staging into color_buffer
-                auto const& src = quad.out_color;
-                auto dst = to_vec4(dst_u32);
-
-                auto src_factor = expand4(m_alpha_blend_factors.src_constant)
-                    + src * m_alpha_blend_factors.src_factor_src_color
-                    + Vector4<f32x4> { src.w(), src.w(), src.w(), src.w() } * m_alpha_blend_factors.src_factor_src_alpha
-                    + dst * m_alpha_blend_factors.src_factor_dst_color
-                    + Vector4<f32x4> { dst.w(), dst.w(), dst.w(), dst.w() } * m_alpha_blend_factors.src_factor_dst_alpha;
-
-                auto dst_factor = expand4(m_alpha_blend_factors.dst_constant)
-                    + src * m_alpha_blend_factors.dst_factor_src_color
-                    + Vector4<f32x4> { src.w(), src.w(), src.w(), src.w() } * m_alpha_blend_factors.dst_factor_src_alpha
-                    + dst * m_alpha_blend_factors.dst_factor_dst_color
-                    + Vector4<f32x4> { dst.w(), dst.w(), dst.w(), dst.w() } * m_alpha_blend_factors.dst_factor_dst_alpha;
-
-                quad.out_color = src * src_factor + dst * dst_factor;
-            }
-
-            auto const argb32_color = to_argb32(quad.out_color);
-            if (m_options.color_mask == 0xffffffff)
-                store4_masked(argb32_color, color_ptrs[0], color_ptrs[1], color_ptrs[2], color_ptrs[3], quad.mask);
-            else
-                store4_masked((argb32_color & m_options.color_mask) | (dst_u32 & ~m_options.color_mask), color_ptrs[0], color_ptrs[1], color_ptrs[2], color_ptrs[3], quad.mask);
         }
     }
 }
@@ -561,6 +574,7 @@ void Device::rasterize_line_antialiased(GPU::Vertex& from, GPU::Vertex& to)
     f32x4 distance_along_line;
     rasterize(
         render_bounds,
+        [](auto const&) { return true; },
         [&from_coords4, &distance_along_line, &line_vector4, &line_dot4, &line_radius](auto& quad) {
             auto const screen_coordinates4 = to_vec2_f32x4(quad.screen_coordinates);
             auto const pixel_vector = screen_coordinates4 - from_coords4;
@@ -616,6 +630,7 @@ void Device::rasterize_point_aliased(GPU::Vertex& point)
     // Rasterize the point as a rect
     rasterize(
         point_rect,
+        [](auto const&) { return true; },
         [](auto& quad) {
             // We already passed in point_rect, so this doesn't matter
             quad.mask = expand4(~0);
@@ -647,6 +662,7 @@ void Device::rasterize_point_antialiased(GPU::Vertex& point)
     // Rasterize using a 2D signed distance field for a circle
     rasterize(
         render_bounds,
+        [](auto const&) { return true; },
         [&center4, &radius](auto& quad) {
             auto screen_coords = to_vec2_f32x4(quad.screen_coordinates);
             auto distance_to_point = length(center4 - screen_coords) - radius;
@@ -784,8 +800,22 @@ void Device::rasterize_triangle(Triangle& triangle)
         expand4(vertex2.window_coordinates.z() + depth_offset),
     };
 
+    // The edge functions are linear, so a block can only be covered if, for every edge, at least one of its corners
+    // lies on the inner side of that edge.
+    auto may_cover_block = [&](Gfx::IntRect const& block) {
+        Vector2<i32x4> const corners {
+            i32x4 { block.left(), block.right(), block.left(), block.right() },
+            i32x4 { block.top(), block.top(), block.bottom(), block.bottom() },
+        };
+        auto edge_values = calculate_edge_values4(corners * subpixel_factor + half_pixel_offset);
+        return any(edge_values.x() >= zero.x())
+            && any(edge_values.y() >= zero.y())
+            && any(edge_values.z() >= zero.z());
+    };
+
     rasterize(
         render_bounds,
+        may_cover_block,
         [&](auto& quad) {
             auto edge_values = calculate_edge_values4(quad.screen_coordinates * subpixel_factor + half_pixel_offset);
             quad.mask = test_point4(edge_values);
@@ -1203,7 +1233,7 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
         rasterize_triangle(triangle);
 }
 
-ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad)
+ALWAYS_INLINE Vector4<f32x4> Device::apply_texture_environments(PixelQuad const& quad)
 {
     Array<Vector4<f32x4>, GPU::NUM_TEXTURE_UNITS> texture_stage_texel;
 
@@ -1325,42 +1355,94 @@ ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad)
             break;
         }
     }
-    quad.out_color = current_color;
+    return current_color;
+}
 
-    // Calculate fog
+ALWAYS_INLINE void Device::apply_fog(PixelQuad& quad)
+{
     // Math from here: https://opengl-notes.readthedocs.io/en/latest/topics/texturing/aliasing.html
 
     // FIXME: exponential fog is not vectorized, we should add a SIMD exp function that calculates an approximation.
-    if (m_options.fog_enabled) {
-        f32x4 factor;
-        switch (m_options.fog_mode) {
-        case GPU::FogMode::Linear:
-            factor = (m_options.fog_end - quad.fog_depth) / (m_options.fog_end - m_options.fog_start);
-            break;
-        case GPU::FogMode::Exp: {
-            auto argument = -m_options.fog_density * quad.fog_depth;
-            factor = exp(argument);
-        } break;
-        case GPU::FogMode::Exp2: {
-            auto argument = m_options.fog_density * quad.fog_depth;
-            argument *= -argument;
-            factor = exp(argument);
-        } break;
-        default:
-            VERIFY_NOT_REACHED();
-        }
+    f32x4 factor;
+    switch (m_options.fog_mode) {
+    case GPU::FogMode::Linear:
+        factor = (m_options.fog_end - quad.fog_depth) / (m_options.fog_end - m_options.fog_start);
+        break;
+    case GPU::FogMode::Exp: {
+        auto argument = -m_options.fog_density * quad.fog_depth;
+        factor = exp(argument);
+    } break;
+    case GPU::FogMode::Exp2: {
+        auto argument = m_options.fog_density * quad.fog_depth;
+        argument *= -argument;
+        factor = exp(argument);
+    } break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
 
-        // Mix texel's RGB with fog's RBG - leave alpha alone
-        auto fog_color = expand4(m_options.fog_color);
-        quad.out_color.set_x(mix(fog_color.x(), quad.out_color.x(), factor));
-        quad.out_color.set_y(mix(fog_color.y(), quad.out_color.y(), factor));
-        quad.out_color.set_z(mix(fog_color.z(), quad.out_color.z(), factor));
+    // Mix texel's RGB with fog's RBG - leave alpha alone
+    auto fog_color = expand4(m_options.fog_color);
+    quad.out_color.set_x(mix(fog_color.x(), quad.out_color.x(), factor));
+    quad.out_color.set_y(mix(fog_color.y(), quad.out_color.y(), factor));
+    quad.out_color.set_z(mix(fog_color.z(), quad.out_color.z(), factor));
+}
+
+template<Device::TexturingPath texturing_path, bool fog_enabled>
+void Device::shade_fragments(PixelQuad& quad)
+{
+    if constexpr (texturing_path == TexturingPath::None) {
+        quad.out_color = quad.vertex_color;
+    } else if constexpr (texturing_path == TexturingPath::SingleUnitModulate) {
+        auto const& texture_coordinates = quad.texture_coordinates[m_single_texture_unit];
+        auto texel = m_samplers[m_single_texture_unit].sample_2d(texture_coordinates.xy() / texture_coordinates.w());
+        INCREASE_STATISTICS_COUNTER(g_num_sampler_calls, 1);
+        quad.out_color = quad.vertex_color * texel;
+    } else {
+        quad.out_color = apply_texture_environments(quad);
     }
 
+    if constexpr (fog_enabled)
+        apply_fog(quad);
+
     // Multiply coverage with the fragment's alpha to obtain the final alpha value
     quad.out_color.set_w(quad.out_color.w() * quad.coverage);
 }
 
+void Device::update_fragment_pipeline()
+{
+    // Find the cheapest specialization of shade_fragments() that produces the same result as the generic path
+    // for the current state, so that the per-quad work doesn't have to look at any of it again.
+    size_t enabled_texture_units = 0;
+    for (GPU::TextureUnitIndex i = 0; i < GPU::NUM_TEXTURE_UNITS; ++i) {
+        if (!m_texture_unit_configuration[i].enabled)
+            continue;
+        ++enabled_texture_units;
+        m_single_texture_unit = i;
+    }
+
+    auto texturing_path = TexturingPath::Generic;
+    if (enabled_texture_units == 0)
+        texturing_path = TexturingPath::None;
+    else if (enabled_texture_units == 1 && m_samplers[m_single_texture_unit].config().fixed_function_texture_environment.env_mode == GPU::TextureEnvMode::Modulate)
+        texturing_path = TexturingPath::SingleUnitModulate;
+
+    auto select = [&]<bool fog_enabled>() -> ShadeFragmentsFunction {
+        switch (texturing_path) {
+        case TexturingPath::None:
+            return &Device::shade_fragments<TexturingPath::None, fog_enabled>;
+        case TexturingPath::SingleUnitModulate:
+            return &Device::shade_fragments<TexturingPath::SingleUnitModulate, fog_enabled>;
+        case TexturingPath::Generic:
+            return &Device::shade_fragments<TexturingPath::Generic, fog_enabled>;
+        }
+        VERIFY_NOT_REACHED();
+    };
+    m_shade_fragments = m_options.fog_enabled ? select.operator()<true>() : select.operator()<false>();
+    m_fragment_pipeline_dirty = false;
+    INCREASE_STATISTICS_COUNTER(g_num_fragment_pipeline_updates, 1);
+}
+
 void Device::resize(Gfx::IntSize const& size)
 {
     auto frame_buffer_or_error = FrameBuffer<GPU::ColorType, GPU::DepthType, GPU::StencilType>::try_create(size);
@@ -1459,13 +1541,7 @@ void Device::blit_from_color_buffer(NonnullRefPtr<GPU::Image> image, u32 level,
     auto const* input_data = m_frame_buffer->color_buffer()->scanline(0);
 
     auto const& softgpu_image = reinterpret_cast<Image*>(image.ptr());
-    auto output_layout = softgpu_image->image_data_layout(level, output_offset);
-    auto* output_data = softgpu_image->texel_pointer(level, 0, 0, 0);
-
-    PixelConverter converter { input_layout, output_layout };
-    auto conversion_result = converter.convert(input_data, output_data, {});
-    if (conversion_result.is_error())
-        dbgln("Pixel conversion failed: {}", conversion_result.error().string_literal());
+    softgpu_image->write_texels(level, output_offset, input_data, input_layout);
 }
 
 void Device::blit_from_color_buffer(void* output_data, Vector2<i32> input_offset, GPU::ImageDataLayout const& output_layout)
@@ -1498,13 +1574,7 @@ void Device::blit_from_depth_buffer(NonnullRefPtr<GPU::Image> image, u32 level,
     auto const* input_data = m_frame_buffer->depth_buffer()->scanline(0);
 
     auto const& softgpu_image = reinterpret_cast<Image*>(image.ptr());
-    auto output_layout = softgpu_image->image_data_layout(level, output_offset);
-    auto* output_data = softgpu_image->texel_pointer(level, 0, 0, 0);
-
-    PixelConverter converter { input_layout, output_layout };
-    auto conversion_result = converter.convert(input_data, output_data, {});
-    if (conversion_result.is_error())
-        dbgln("Pixel conversion failed: {}", conversion_result.error().string_literal());
+    softgpu_image->write_texels(level, output_offset, input_data, input_layout);
 }
 
 void Device::blit_to_color_buffer_at_raster_position(void const* input_data, GPU::ImageDataLayout const& input_layout)
@@ -1578,6 +1648,7 @@ void Device::draw_statistics_overlay(Gfx::Bitmap& target)
             g_num_pixels_shaded > 0 ? g_num_pixels_blended * 100 / g_num_pixels_shaded : 0,
             num_rendertarget_pixels > 0 ? g_num_pixels_shaded * 100 / num_rendertarget_pixels - 100 : 0));
         builder.append(String::formatted("Sampler calls: {}\n", g_num_sampler_calls));
+        builder.append(String::formatted("Pipelines    : {}\n", g_num_fragment_pipeline_updates));
 
         debug_string = builder.to_string();
 
@@ -1592,6 +1663,7 @@ void Device::draw_statistics_overlay(Gfx::Bitmap& target)
     g_num_sampler_calls = 0;
     g_num_stencil_writes = 0;
     g_num_quads = 0;
+    g_num_fragment_pipeline_updates = 0;
 
     auto& font = Gfx::FontDatabase::default_fixed_width_font();
 
@@ -1606,6 +1678,7 @@ void Device::draw_statistics_overlay(Gfx::Bitmap& target)
 void Device::set_options(GPU::RasterizerOptions const& options)
 {
     m_options = options;
+    m_fragment_pipeline_dirty = true;
 
     if (m_options.enable_blending)
         setup_blend_factors();
@@ -1631,6 +1704,7 @@ void Device::set_sampler_config(unsigned sampler, GPU::SamplerConfig const& conf
     VERIFY(config.bound_image.is_null() || config.bound_image->ownership_token() == this);
 
     m_samplers[sampler].set_config(config);
+    m_fragment_pipeline_dirty = true;
 }
 
 void Device::set_light_state(unsigned int light_id, GPU::Light const& light)
@@ -1651,6 +1725,7 @@ void Device::set_stencil_configuration(GPU::Face face, GPU::StencilConfiguration
 void Device::set_texture_unit_configuration(GPU::TextureUnitIndex index, GPU::TextureUnitConfiguration const& configuration)
 {
     m_texture_unit_configuration[index] = configuration;
+    m_fragment_pipeline_dirty = true;
 }
 
 void Device::set_raster_position(GPU::RasterPosition const& raster_position)
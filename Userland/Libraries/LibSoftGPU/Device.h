@@ -85,8 +85,8 @@ private:
     GPU::ImageDataLayout color_buffer_data_layout(Vector2<u32> size, Vector2<i32> offset);
     GPU::ImageDataLayout depth_buffer_data_layout(Vector2<u32> size, Vector2<i32> offset);
 
-    template<typename CB1, typename CB2, typename CB3>
-    void rasterize(Gfx::IntRect& render_bounds, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes);
+    template<typename CB0, typename CB1, typename CB2, typename CB3>
+    void rasterize(Gfx::IntRect& render_bounds, CB0 may_cover_block, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes);
 
     void rasterize_line_aliased(GPU::Vertex&, GPU::Vertex&);
     void rasterize_line_antialiased(GPU::Vertex&, GPU::Vertex&);
@@ -98,7 +98,21 @@ private:
 
     void rasterize_triangle(Triangle&);
     void setup_blend_factors();
+
+    // The fragment paths shade_fragments() is specialized for. Anything not covered by a cheaper path goes through
+    // the generic texture environment evaluation.
+    enum class TexturingPath {
+        None,
+        SingleUnitModulate,
+        Generic,
+    };
+    using ShadeFragmentsFunction = void (Device::*)(PixelQuad&);
+
+    template<TexturingPath, bool fog_enabled>
     void shade_fragments(PixelQuad&);
+    Vector4<AK::SIMD::f32x4> apply_texture_environments(PixelQuad const&);
+    void apply_fog(PixelQuad&);
+    void update_fragment_pipeline();
 
     RefPtr<FrameBuffer<GPU::ColorType, GPU::DepthType, GPU::StencilType>> m_frame_buffer {};
     GPU::RasterizerOptions m_options;
@@ -115,6 +129,9 @@ private:
     Vector<FloatVector4> m_clip_planes;
     Array<GPU::StencilConfiguration, 2u> m_stencil_configuration;
     Array<GPU::TextureUnitConfiguration, GPU::NUM_TEXTURE_UNITS> m_texture_unit_configuration;
+    ShadeFragmentsFunction m_shade_fragments { nullptr };
+    GPU::TextureUnitIndex m_single_texture_unit { 0 };
+    bool m_fragment_pipeline_dirty { true };
 };
 
 }
@@ -16,7 +16,7 @@ namespace SoftGPU {
 Image::Image(void const* ownership_token, GPU::PixelFormat const& pixel_format, u32 width, u32 height, u32 depth, u32 max_levels)
     : GPU::Image(ownership_token)
     , m_pixel_format(pixel_format)
-    , m_mipmap_buffers(FixedArray<RefPtr<Typed3DBuffer<FloatVector4>>>::must_create_but_fixme_should_propagate_errors(max_levels))
+    , m_levels(FixedArray<Level>::must_create_but_fixme_should_propagate_errors(max_levels))
 {
     VERIFY(pixel_format == GPU::PixelFormat::Alpha
         || pixel_format == GPU::PixelFormat::Intensity
@@ -35,7 +35,15 @@ Image::Image(void const* ownership_token, GPU::PixelFormat const& pixel_format,
 
     u32 level;
     for (level = 0; level < max_levels; ++level) {
-        m_mipmap_buffers[level] = MUST(Typed3DBuffer<FloatVector4>::try_create(width, height, depth));
+        auto& image_level = m_levels[level];
+        image_level.width = width;
+        image_level.height = height;
+        image_level.depth = depth;
+        image_level.tiles_per_row = ceil_div(width, tile_size);
+        image_level.tiles_per_column = ceil_div(height, tile_size);
+        auto texels = FixedArray<FloatVector4>::must_create_but_fixme_should_propagate_errors(
+            image_level.tiles_per_row * image_level.tiles_per_column * depth * tile_size * tile_size);
+        image_level.texels.swap(texels);
 
         if (width <= 1 && height <= 1 && depth <= 1)
             break;
@@ -48,13 +56,8 @@ Image::Image(void const* ownership_token, GPU::PixelFormat const& pixel_format,
     m_number_of_levels = level + 1;
 }
 
-GPU::ImageDataLayout Image::image_data_layout(u32 level, Vector3<i32> offset) const
+GPU::ImageDataLayout Image::linear_data_layout(Vector3<u32> size)
 {
-    auto const width = width_at_level(level);
-    auto const height = height_at_level(level);
-    auto const depth = depth_at_level(level);
-
-    // FIXME: we are directly writing to FloatVector4s. We should probably find a better way to do this
     return {
         .pixel_type = {
             .format = GPU::PixelFormat::RGBA,
@@ -62,51 +65,106 @@ GPU::ImageDataLayout Image::image_data_layout(u32 level, Vector3<i32> offset) co
             .data_type = GPU::PixelDataType::Float,
         },
         .dimensions = {
-            .width = width,
-            .height = height,
-            .depth = depth,
+            .width = size.x(),
+            .height = size.y(),
+            .depth = size.z(),
         },
         .selection = {
-            .offset_x = offset.x(),
-            .offset_y = offset.y(),
-            .offset_z = offset.z(),
-            .width = width - offset.x(),
-            .height = height - offset.y(),
-            .depth = depth - offset.z(),
+            .width = size.x(),
+            .height = size.y(),
+            .depth = size.z(),
         },
     };
 }
 
+Vector3<u32> Image::region_size_at_offset(u32 level, Vector3<i32> offset) const
+{
+    auto remaining = [](u32 size, i32 offset) -> u32 {
+        return offset >= 0 && static_cast<u32>(offset) < size ? size - offset : 0;
+    };
+    return {
+        remaining(width_at_level(level), offset.x()),
+        remaining(height_at_level(level), offset.y()),
+        remaining(depth_at_level(level), offset.z()),
+    };
+}
+
+ErrorOr<FixedArray<FloatVector4>> Image::copy_region_to_linear(u32 level, Vector3<i32> offset, Vector3<u32> size) const
+{
+    auto linear_texels = TRY(FixedArray<FloatVector4>::try_create(size.x() * size.y() * size.z()));
+    size_t i = 0;
+    for (u32 z = 0; z < size.z(); ++z) {
+        for (u32 y = 0; y < size.y(); ++y) {
+            for (u32 x = 0; x < size.x(); ++x)
+                linear_texels[i++] = texel(level, offset.x() + x, offset.y() + y, offset.z() + z);
+        }
+    }
+    return linear_texels;
+}
+
+void Image::copy_region_from_linear(u32 level, Vector3<i32> offset, Vector3<u32> size, FixedArray<FloatVector4> const& linear_texels)
+{
+    size_t i = 0;
+    for (u32 z = 0; z < size.z(); ++z) {
+        for (u32 y = 0; y < size.y(); ++y) {
+            for (u32 x = 0; x < size.x(); ++x)
+                set_texel(level, offset.x() + x, offset.y() + y, offset.z() + z, linear_texels[i++]);
+        }
+    }
+}
+
 void Image::write_texels(u32 level, Vector3<i32> const& output_offset, void const* input_data, GPU::ImageDataLayout const& input_layout)
 {
     VERIFY(level < number_of_levels());
 
-    auto output_layout = image_data_layout(level, output_offset);
-    auto texel_data = texel_pointer(level, 0, 0, 0);
+    auto region_size = region_size_at_offset(level, output_offset);
+    if (region_size.x() == 0 || region_size.y() == 0 || region_size.z() == 0)
+        return;
 
-    PixelConverter converter { input_layout, output_layout };
+    // The pixel converter only deals with linear data, so the affected region is converted in a linear copy. It
+    // starts out with the current texels since the input does not necessarily cover all of it.
+    auto linear_texels_or_error = copy_region_to_linear(level, output_offset, region_size);
+    if (linear_texels_or_error.is_error()) {
+        dbgln("Pixel conversion failed: {}", linear_texels_or_error.error().string_literal());
+        return;
+    }
+    auto linear_texels = linear_texels_or_error.release_value();
+
+    PixelConverter converter { input_layout, linear_data_layout(region_size) };
     ErrorOr<void> conversion_result;
     switch (m_pixel_format) {
     case GPU::PixelFormat::Luminance:
     case GPU::PixelFormat::RGB:
         // Both Luminance and RGB set the alpha to 1, regardless of the source texel
-        conversion_result = converter.convert(input_data, texel_data, [](auto& components) { components[3] = 1.f; });
+        conversion_result = converter.convert(input_data, linear_texels.data(), [](auto& components) { components[3] = 1.f; });
         break;
     default:
-        conversion_result = converter.convert(input_data, texel_data, {});
+        conversion_result = converter.convert(input_data, linear_texels.data(), {});
     }
-    if (conversion_result.is_error())
+    if (conversion_result.is_error()) {
         dbgln("Pixel conversion failed: {}", conversion_result.error().string_literal());
+        return;
+    }
+
+    copy_region_from_linear(level, output_offset, region_size, linear_texels);
 }
 
 void Image::read_texels(u32 level, Vector3<i32> const& input_offset, void* output_data, GPU::ImageDataLayout const& output_layout) const
 {
     VERIFY(level < number_of_levels());
 
-    auto input_layout = image_data_layout(level, input_offset);
+    auto region_size = region_size_at_offset(level, input_offset);
+    if (region_size.x() == 0 || region_size.y() == 0 || region_size.z() == 0)
+        return;
 
-    PixelConverter converter { input_layout, output_layout };
-    auto conversion_result = converter.convert(texel_pointer(level, 0, 0, 0), output_data, {});
+    auto linear_texels_or_error = copy_region_to_linear(level, input_offset, region_size);
+    if (linear_texels_or_error.is_error()) {
+        dbgln("Pixel conversion failed: {}", linear_texels_or_error.error().string_literal());
+        return;
+    }
+
+    PixelConverter converter { linear_data_layout(region_size), output_layout };
+    auto conversion_result = converter.convert(linear_texels_or_error.value().data(), output_data, {});
     if (conversion_result.is_error())
         dbgln("Pixel conversion failed: {}", conversion_result.error().string_literal());
 }
@@ -170,28 +228,12 @@ void Image::regenerate_mipmaps()
     };
     auto copy_image_into_bitmap = [&](u32 level) -> NonnullRefPtr<Gfx::Bitmap> {
         auto bitmap = empty_bitmap_for_level(level);
-
-        auto input_layout = image_data_layout(level, { 0, 0, 0 });
-        auto const* input_data = texel_pointer(level, 0, 0, 0);
-
-        auto output_layout = image_data_layout_for_bitmap(bitmap);
-        auto* output_data = bitmap->scanline(0);
-
-        PixelConverter converter { input_layout, output_layout };
-        MUST(converter.convert(input_data, output_data, {}));
+        read_texels(level, { 0, 0, 0 }, bitmap->scanline(0), image_data_layout_for_bitmap(bitmap));
         return bitmap;
     };
     auto copy_bitmap_into_level = [&](NonnullRefPtr<Gfx::Bitmap> bitmap, u32 level) {
         VERIFY(level >= 1);
-
-        auto input_layout = image_data_layout_for_bitmap(bitmap);
-        auto const* input_data = bitmap->scanline(0);
-
-        auto output_layout = image_data_layout(level, { 0, 0, 0 });
-        auto* output_data = texel_pointer(level, 0, 0, 0);
-
-        PixelConverter converter { input_layout, output_layout };
-        MUST(converter.convert(input_data, output_data, {}));
+        write_texels(level, { 0, 0, 0 }, bitmap->scanline(0), image_data_layout_for_bitmap(bitmap));
     };
 
     // For levels 1..number_of_levels-1, we generate downscaled versions of the level above
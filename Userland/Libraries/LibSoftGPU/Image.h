@@ -14,54 +14,69 @@
 #include <LibGPU/ImageFormat.h>
 #include <LibGfx/Vector3.h>
 #include <LibGfx/Vector4.h>
-#include <LibSoftGPU/Buffer/Typed3DBuffer.h>
 
 namespace SoftGPU {
 
+// Texels are stored in tiles of tile_size x tile_size, row by row within a tile. The texels that a bilinear or
+// trilinear lookup needs are close to each other in both directions, so they usually end up in the same cache lines
+// no matter in which direction the texture is traversed.
 class Image final : public GPU::Image {
 public:
+    static constexpr u32 tile_size = 4;
+
     Image(void const* ownership_token, GPU::PixelFormat const&, u32 width, u32 height, u32 depth, u32 max_levels);
 
-    virtual u32 width_at_level(u32 level) const override { return m_mipmap_buffers[level]->width(); }
-    virtual u32 height_at_level(u32 level) const override { return m_mipmap_buffers[level]->height(); }
-    virtual u32 depth_at_level(u32 level) const override { return m_mipmap_buffers[level]->depth(); }
+    virtual u32 width_at_level(u32 level) const override { return m_levels[level].width; }
+    virtual u32 height_at_level(u32 level) const override { return m_levels[level].height; }
+    virtual u32 depth_at_level(u32 level) const override { return m_levels[level].depth; }
     virtual u32 number_of_levels() const override { return m_number_of_levels; }
     bool width_is_power_of_two() const { return m_width_is_power_of_two; }
     bool height_is_power_of_two() const { return m_height_is_power_of_two; }
     bool depth_is_power_of_two() const { return m_depth_is_power_of_two; }
 
-    GPU::ImageDataLayout image_data_layout(u32 level, Vector3<i32> offset) const;
     virtual void regenerate_mipmaps() override;
 
     FloatVector4 const& texel(u32 level, int x, int y, int z) const
     {
-        return *texel_pointer(level, x, y, z);
+        auto const& image_level = m_levels[level];
+        return image_level.texels[image_level.texel_index(x, y, z)];
     }
 
     void set_texel(u32 level, int x, int y, int z, FloatVector4 const& color)
     {
-        *texel_pointer(level, x, y, z) = color;
+        auto& image_level = m_levels[level];
+        image_level.texels[image_level.texel_index(x, y, z)] = color;
     }
 
     virtual void write_texels(u32 level, Vector3<i32> const& output_offset, void const* input_data, GPU::ImageDataLayout const&) override;
     virtual void read_texels(u32 level, Vector3<i32> const& input_offset, void* output_data, GPU::ImageDataLayout const&) const override;
     virtual void copy_texels(GPU::Image const& source, u32 source_level, Vector3<u32> const& source_offset, Vector3<u32> const& size, u32 destination_level, Vector3<u32> const& destination_offset) override;
 
-    FloatVector4 const* texel_pointer(u32 level, int x, int y, int z) const
-    {
-        return m_mipmap_buffers[level]->buffer_pointer(x, y, z);
-    }
+private:
+    struct Level {
+        FixedArray<FloatVector4> texels;
+        u32 width { 0 };
+        u32 height { 0 };
+        u32 depth { 0 };
+        u32 tiles_per_row { 0 };
+        u32 tiles_per_column { 0 };
 
-    FloatVector4* texel_pointer(u32 level, int x, int y, int z)
-    {
-        return m_mipmap_buffers[level]->buffer_pointer(x, y, z);
-    }
+        ALWAYS_INLINE size_t texel_index(u32 x, u32 y, u32 z) const
+        {
+            auto tile_index = (z * tiles_per_column + y / tile_size) * tiles_per_row + x / tile_size;
+            return tile_index * tile_size * tile_size + (y % tile_size) * tile_size + x % tile_size;
+        }
+    };
+
+    static GPU::ImageDataLayout linear_data_layout(Vector3<u32> size);
+    Vector3<u32> region_size_at_offset(u32 level, Vector3<i32> offset) const;
+    ErrorOr<FixedArray<FloatVector4>> copy_region_to_linear(u32 level, Vector3<i32> offset, Vector3<u32> size) const;
+    void copy_region_from_linear(u32 level, Vector3<i32> offset, Vector3<u32> size, FixedArray<FloatVector4> const&);
 
-private:
     u32 m_number_of_levels { 0 };
 
     GPU::PixelFormat m_pixel_format;
-    FixedArray<RefPtr<Typed3DBuffer<FloatVector4>>> m_mipmap_buffers;
+    FixedArray<Level> m_levels;
 
     bool m_width_is_power_of_two { false };
     bool m_height_is_power_of_two { false };
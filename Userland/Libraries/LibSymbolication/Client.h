@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibIPC/ConnectionToServer.h>
+#include <SymbolServer/SymbolClientEndpoint.h>
+#include <SymbolServer/SymbolServerEndpoint.h>
+
+namespace Symbolication {
+
+class Client final
+    : public IPC::ConnectionToServer<SymbolClientEndpoint, SymbolServerEndpoint>
+    , public SymbolClientEndpoint {
+    IPC_CLIENT_CONNECTION(Client, "/tmp/session/%sid/portal/symbol"sv)
+
+private:
+    explicit Client(NonnullOwnPtr<Core::Stream::LocalSocket> socket)
+        : IPC::ConnectionToServer<SymbolClientEndpoint, SymbolServerEndpoint>(*this, move(socket))
+    {
+    }
+};
+
+}
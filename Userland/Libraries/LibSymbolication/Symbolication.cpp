@@ -6,13 +6,19 @@
 
 #include <AK/Array.h>
 #include <AK/Checked.h>
+#include <AK/HashTable.h>
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
 #include <AK/LexicalPath.h>
+#include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
+#include <LibCore/System.h>
 #include <LibDebug/DebugInfo.h>
+#include <LibIPC/Decoder.h>
+#include <LibIPC/Encoder.h>
+#include <LibSymbolication/Client.h>
 #include <LibSymbolication/Symbolication.h>
 
 namespace Symbolication {
@@ -21,6 +27,7 @@ struct CachedELF {
     NonnullRefPtr<Core::MappedFile> mapped_file;
     NonnullOwnPtr<Debug::DebugInfo> debug_info;
     NonnullOwnPtr<ELF::Image> image;
+    time_t modification_time { 0 };
 };
 
 static HashMap<String, OwnPtr<CachedELF>> s_cache;
@@ -63,25 +70,29 @@ Optional<FlatPtr> kernel_base()
     return s_kernel_base;
 }
 
+static Optional<String> find_object(String const& path)
+{
+    if (path.starts_with('/'))
+        return path;
+
+    Array<StringView, 2> search_paths { "/usr/lib"sv, "/usr/local/lib"sv };
+    for (auto& search_path : search_paths) {
+        auto full_path = LexicalPath::join(search_path, path).string();
+        if (Core::File::exists(full_path))
+            return full_path;
+    }
+    return {};
+}
+
 Optional<Symbol> symbolicate(String const& path, FlatPtr address, IncludeSourcePosition include_source_positions)
 {
-    String full_path = path;
-    if (!path.starts_with('/')) {
-        Array<StringView, 2> search_paths { "/usr/lib"sv, "/usr/local/lib"sv };
-        bool found = false;
-        for (auto& search_path : search_paths) {
-            full_path = LexicalPath::join(search_path, path).string();
-            if (Core::File::exists(full_path)) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            dbgln("Failed to find candidate for {}", path);
-            s_cache.set(path, {});
-            return {};
-        }
+    auto maybe_full_path = find_object(path);
+    if (!maybe_full_path.has_value()) {
+        dbgln("Failed to find candidate for {}", path);
+        s_cache.set(path, {});
+        return {};
     }
+    auto const& full_path = maybe_full_path.value();
     if (!s_cache.contains(full_path)) {
         auto mapped_file = Core::MappedFile::map(full_path);
         if (mapped_file.is_error()) {
@@ -95,7 +106,9 @@ Optional<Symbol> symbolicate(String const& path, FlatPtr address, IncludeSourceP
             s_cache.set(full_path, {});
             return {};
         }
-        auto cached_elf = make<CachedELF>(mapped_file.release_value(), make<Debug::DebugInfo>(*elf), move(elf));
+        auto stat_or_error = Core::System::stat(full_path);
+        auto modification_time = stat_or_error.is_error() ? 0 : stat_or_error.value().st_mtime;
+        auto cached_elf = make<CachedELF>(mapped_file.release_value(), make<Debug::DebugInfo>(*elf), move(elf), modification_time);
         s_cache.set(full_path, move(cached_elf));
     }
 
@@ -132,6 +145,66 @@ Optional<Symbol> symbolicate(String const& path, FlatPtr address, IncludeSourceP
     };
 }
 
+// Drops the cached object at the path if it has been replaced on disk since it was loaded, or if loading it failed.
+static void forget_object_if_changed(String const& path)
+{
+    auto full_path = find_object(path);
+    if (!full_path.has_value())
+        return;
+    auto it = s_cache.find(full_path.value());
+    if (it == s_cache.end())
+        return;
+    auto stat_or_error = Core::System::stat(full_path.value());
+    if (stat_or_error.is_error() || !it->value || it->value->modification_time != stat_or_error.value().st_mtime)
+        s_cache.remove(it);
+}
+
+Vector<Optional<Symbol>> symbolicate_in_process(Vector<SymbolRequest> const& requests, IncludeSourcePosition include_source_positions)
+{
+    HashTable<String> checked_paths;
+    Vector<Optional<Symbol>> symbols;
+    symbols.ensure_capacity(requests.size());
+    for (auto const& request : requests) {
+        if (checked_paths.set(request.path) == AK::HashSetResult::InsertedNewEntry)
+            forget_object_if_changed(request.path);
+        symbols.unchecked_append(symbolicate(request.path, request.address, include_source_positions));
+    }
+    return symbols;
+}
+
+Vector<Optional<Symbol>> symbolicate(Vector<SymbolRequest> const& requests, IncludeSourcePosition include_source_positions)
+{
+    if (requests.is_empty())
+        return {};
+
+    // NOTE: The connection needs an event loop on this thread, which e.g. a BackgroundAction doesn't have.
+    if (Core::EventLoop::has_been_instantiated()) {
+        if (auto client_or_error = Client::try_create(); !client_or_error.is_error()) {
+            Vector<String> paths;
+            Vector<FlatPtr> addresses;
+            paths.ensure_capacity(requests.size());
+            addresses.ensure_capacity(requests.size());
+            for (auto const& request : requests) {
+                paths.unchecked_append(request.path);
+                addresses.unchecked_append(request.address);
+            }
+
+            auto response = client_or_error.value()->send_sync_but_allow_failure<Messages::SymbolServer::Symbolicate>(move(paths), move(addresses), include_source_positions == IncludeSourcePosition::Yes);
+            if (response && response->symbols().size() == requests.size()) {
+                auto symbols = response->take_symbols();
+                // The server can only see the objects it has been allowed to, so look for the rest ourselves.
+                for (size_t i = 0; i < symbols.size(); ++i) {
+                    if (!symbols[i].has_value())
+                        symbols[i] = symbolicate(requests[i].path, requests[i].address, include_source_positions);
+                }
+                return symbols;
+            }
+        }
+    }
+
+    return symbolicate_in_process(requests, include_source_positions);
+}
+
 Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid, IncludeSourcePosition include_source_positions)
 {
     struct RegionWithSymbols {
@@ -209,7 +282,8 @@ Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid, IncludeSourcePosition in
         }
     }
 
-    Vector<Symbol> symbols;
+    Vector<SymbolRequest> requests;
+    Vector<FlatPtr> requested_addresses;
     bool first_frame = true;
 
     for (auto address : stack) {
@@ -250,19 +324,71 @@ Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid, IncludeSourcePosition in
         // However, because the first frame represents the current
         // instruction pointer rather than the return address we don't
         // subtract 1 for that.
-        auto result = symbolicate(found_region->path, adjusted_address - (first_frame ? 0 : 1), include_source_positions);
+        requests.append({ found_region->path, adjusted_address - (first_frame ? 0 : 1) });
+        requested_addresses.append(address);
         first_frame = false;
-        if (!result.has_value()) {
-            symbols.append(Symbol {
-                .address = address,
+    }
+
+    auto results = symbolicate(requests, include_source_positions);
+
+    Vector<Symbol> symbols;
+    symbols.ensure_capacity(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].has_value()) {
+            symbols.unchecked_append(Symbol {
+                .address = requested_addresses[i],
                 .source_positions = {},
             });
             continue;
         }
 
-        symbols.append(result.value());
+        symbols.unchecked_append(results[i].release_value());
     }
     return symbols;
 }
 
 }
+
+template<>
+bool IPC::encode(Encoder& encoder, Symbolication::Symbol const& symbol)
+{
+    encoder << symbol.address;
+    encoder << symbol.name;
+    encoder << symbol.object;
+    encoder << symbol.offset;
+    encoder << static_cast<u64>(symbol.source_positions.size());
+    for (auto const& position : symbol.source_positions) {
+        encoder << String { position.file_path };
+        encoder << static_cast<u64>(position.line_number);
+        encoder << position.address_of_first_statement;
+    }
+    return true;
+}
+
+template<>
+ErrorOr<void> IPC::decode(Decoder& decoder, Symbolication::Symbol& symbol)
+{
+    TRY(decoder.decode(symbol.address));
+    TRY(decoder.decode(symbol.name));
+    TRY(decoder.decode(symbol.object));
+    TRY(decoder.decode(symbol.offset));
+
+    u64 position_count = 0;
+    TRY(decoder.decode(position_count));
+    if (position_count > NumericLimits<i32>::max())
+        return Error::from_string_literal("IPC: Invalid source position count");
+    TRY(symbol.source_positions.try_ensure_capacity(position_count));
+    for (u64 i = 0; i < position_count; ++i) {
+        String file_path;
+        u64 line_number = 0;
+        Optional<FlatPtr> address_of_first_statement;
+        TRY(decoder.decode(file_path));
+        TRY(decoder.decode(line_number));
+        TRY(decoder.decode(address_of_first_statement));
+
+        Debug::DebugInfo::SourcePosition position { move(file_path), line_number };
+        position.address_of_first_statement = address_of_first_statement;
+        symbol.source_positions.unchecked_append(move(position));
+    }
+    return {};
+}
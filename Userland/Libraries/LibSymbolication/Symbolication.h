@@ -8,6 +8,7 @@
 
 #include <AK/String.h>
 #include <LibDebug/DebugInfo.h>
+#include <LibIPC/Forward.h>
 
 namespace Symbolication {
 
@@ -25,8 +26,30 @@ enum class IncludeSourcePosition {
     No
 };
 
+struct SymbolRequest {
+    String path;
+    FlatPtr address { 0 };
+};
+
 Optional<FlatPtr> kernel_base();
 Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid, IncludeSourcePosition = IncludeSourcePosition::Yes);
 Optional<Symbol> symbolicate(String const& path, FlatPtr address, IncludeSourcePosition = IncludeSourcePosition::Yes);
 
+// Resolves all of the addresses with a single request to SymbolServer, which keeps the symbol tables and line programs
+// of the objects it has seen loaded. If the server can't be reached, they are resolved in this process instead.
+Vector<Optional<Symbol>> symbolicate(Vector<SymbolRequest> const&, IncludeSourcePosition = IncludeSourcePosition::Yes);
+
+// Like above, but always in this process. Objects that have changed on disk since they were cached are loaded again.
+Vector<Optional<Symbol>> symbolicate_in_process(Vector<SymbolRequest> const&, IncludeSourcePosition = IncludeSourcePosition::Yes);
+
+}
+
+namespace IPC {
+
+template<>
+bool encode(Encoder&, Symbolication::Symbol const&);
+
+template<>
+ErrorOr<void> decode(Decoder&, Symbolication::Symbol&);
+
 }
@@ -10,6 +10,7 @@
 #include <LibCrypto/ASN1/ASN1.h>
 #include <LibCrypto/ASN1/DER.h>
 #include <LibCrypto/ASN1/PEM.h>
+#include <LibCrypto/Hash/SHA2.h>
 
 namespace TLS {
 
@@ -99,6 +100,11 @@ Optional<Certificate> Certificate::parse_asn1(ReadonlyBytes buffer, bool)
         return {};
     certificate.original_asn1 = copy_buffer_result.release_value();
 
+    auto fingerprint_result = ByteBuffer::copy(Crypto::Hash::SHA256::hash(buffer.data(), buffer.size()).bytes());
+    if (fingerprint_result.is_error())
+        return {};
+    certificate.fingerprint = fingerprint_result.release_value();
+
     Crypto::ASN1::Decoder decoder { buffer };
     // Certificate ::= Sequence {
     //     certificate          TBSCertificate,
@@ -9,6 +9,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Forward.h>
 #include <AK/Optional.h>
+#include <AK/RefPtr.h>
 #include <AK/Singleton.h>
 #include <AK/Types.h>
 #include <LibCore/ConfigFile.h>
@@ -126,11 +127,15 @@ public:
     }
 };
 
+class TrustStore;
+
 class DefaultRootCACertificates {
 public:
     DefaultRootCACertificates();
+    ~DefaultRootCACertificates();
 
-    Vector<Certificate> const& certificates() const { return m_ca_certificates; }
+    // The certificates are parsed once per process, connections share the resulting store instead of copying it.
+    NonnullRefPtr<TrustStore> trust_store() const;
 
     void reload_certificates(Core::ConfigFile&);
 
@@ -139,7 +144,7 @@ public:
 private:
     static Singleton<DefaultRootCACertificates> s_the;
 
-    Vector<Certificate> m_ca_certificates;
+    RefPtr<TrustStore> m_trust_store;
 };
 
 }
@@ -76,7 +76,9 @@ enum class CipherSuite {
     ECDHE_ECDSA_WITH_AES_256_CCM_8 = 0xC0AF,
 
     // RFC 7905 - ChaCha20-Poly1305 Cipher Suites
+    ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256 = 0xCCA8,
     ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256 = 0xCCA9,
+    DHE_RSA_WITH_CHACHA20_POLY1305_SHA256 = 0xCCAA,
     ECDHE_PSK_WITH_CHACHA20_POLY1305_SHA256 = 0xCCAC,
     DHE_PSK_WITH_CHACHA20_POLY1305 = 0xCCAD,
 
@@ -103,6 +105,8 @@ enum class HashAlgorithm : u8 {
     SHA256 = 4,
     SHA384 = 5,
     SHA512 = 6,
+    // RFC 8422 section 5.1.3, for signature algorithms that hash the message themselves.
+    INTRINSIC = 8,
 };
 
 // Defined in RFC 5246 section 7.4.1.4.1
@@ -111,6 +115,11 @@ enum class SignatureAlgorithm : u8 {
     RSA = 1,
     DSA = 2,
     ECDSA = 3,
+    // RFC 8446 section 4.2.3 (and RFC 8422 section 5.1.3): RSASSA-PSS with a public key of rsaEncryption,
+    // always paired with HashAlgorithm::INTRINSIC.
+    RSA_PSS_RSAE_SHA256 = 4,
+    RSA_PSS_RSAE_SHA384 = 5,
+    RSA_PSS_RSAE_SHA512 = 6,
 };
 
 // Defined in RFC 5246 section 7.4.1.4.1
@@ -170,6 +179,7 @@ enum class CipherAlgorithm {
     AES_128_CCM_8,
     AES_256_CBC,
     AES_256_GCM,
+    CHACHA20_POLY1305,
 };
 
 constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
@@ -182,6 +192,7 @@ constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
         return 128;
     case CipherAlgorithm::AES_256_CBC:
     case CipherAlgorithm::AES_256_GCM:
+    case CipherAlgorithm::CHACHA20_POLY1305:
         return 256;
     case CipherAlgorithm::Invalid:
     default:
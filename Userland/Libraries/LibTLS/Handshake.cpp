@@ -9,6 +9,7 @@
 #include <AK/Endian.h>
 #include <AK/Random.h>
 
+#include <LibCore/DateTime.h>
 #include <LibCore/Timer.h>
 #include <LibCrypto/ASN1/DER.h>
 #include <LibCrypto/PK/Code/EMSA_PSS.h>
@@ -18,7 +19,10 @@ namespace TLS {
 
 ByteBuffer TLSv12::build_hello()
 {
-    fill_with_random(&m_context.local_random, 32);
+    // RFC 8446 section 4.1.2: The ClientHello we send in response to a HelloRetryRequest keeps the same random and session ID.
+    bool is_retry = m_context.tls13.did_retry_hello;
+    if (!is_retry)
+        fill_with_random(&m_context.local_random, 32);
 
     auto packet_version = (u16)m_context.options.version;
     auto version = (u16)m_context.options.version;
@@ -35,6 +39,49 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    bool offer_tls13 = is_offering_tls13();
+    bool use_session_cache = m_context.options.session_cache && !m_context.options.session_cache_key.is_empty();
+    if (!is_retry) {
+        m_context.offered_session.clear();
+        if (use_session_cache)
+            m_context.offered_session = m_context.options.session_cache->find(m_context.options.session_cache_key);
+        if (m_context.offered_session.has_value() && m_context.offered_session->version == Version::V13 && !offer_tls13)
+            m_context.offered_session.clear();
+    }
+
+    // TLS 1.3 sessions are resumed through the pre_shared_key extension instead.
+    if (!is_retry && m_context.offered_session.has_value() && m_context.offered_session->version == Version::V12) {
+        auto& session = *m_context.offered_session;
+        dbgln_if(TLS_DEBUG, "Offering to resume the session for {}", m_context.options.session_cache_key);
+        if (!session.ticket.is_empty()) {
+            // RFC 5077 section 3.4: "When presenting a ticket, the client MAY generate and include a Session ID in
+            //                        the TLS ClientHello. If the server accepts the ticket and the Session ID is not
+            //                        empty, then it MUST respond with the same Session ID present in the ClientHello."
+            // This is what tells us whether the server accepted the ticket.
+            fill_with_random(m_context.session_id, sizeof(m_context.session_id));
+            m_context.session_id_size = sizeof(m_context.session_id);
+        } else {
+            memcpy(m_context.session_id, session.session_id, session.session_id_size);
+            m_context.session_id_size = session.session_id_size;
+        }
+    }
+
+    if (offer_tls13 && !is_retry && m_context.session_id_size == 0) {
+        // RFC 8446 section D.4: Middlebox compatibility mode asks for a non-empty legacy_session_id.
+        fill_with_random(m_context.session_id, sizeof(m_context.session_id));
+        m_context.session_id_size = sizeof(m_context.session_id);
+    }
+
+    ByteBuffer tls13_extensions;
+    if (offer_tls13) {
+        auto extensions_or_error = build_tls13_hello_extensions();
+        if (extensions_or_error.is_error()) {
+            dbgln("Failed to build the TLS 1.3 ClientHello extensions: {}", extensions_or_error.error());
+            return {};
+        }
+        tls13_extensions = extensions_or_error.release_value();
+    }
+
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
@@ -86,6 +133,16 @@ ByteBuffer TLSv12::build_hello()
     if (supports_elliptic_curves)
         extension_length += 6 + elliptic_curves_length + 5 + supported_ec_point_formats_length;
 
+    // session_ticket: 2b extension ID, 2b extension length, followed by the ticket, if we have one.
+    // An empty one tells the server that we'd like to receive a ticket.
+    ReadonlyBytes session_ticket;
+    if (m_context.offered_session.has_value() && m_context.offered_session->version == Version::V12)
+        session_ticket = m_context.offered_session->ticket;
+    if (use_session_cache)
+        extension_length += 4 + session_ticket.size();
+
+    extension_length += tls13_extensions.size();
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -130,11 +187,33 @@ ByteBuffer TLSv12::build_hello()
             builder.append((u8)format);
     }
 
+    if (use_session_cache) {
+        // session_ticket extension
+        builder.append((u16)HandshakeExtension::SessionTicket);
+        builder.append((u16)session_ticket.size());
+        builder.append(session_ticket);
+    }
+
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // application_layer_protocol_negotiation extension
+        builder.append((u16)HandshakeExtension::ApplicationLayerProtocolNegotiation);
+        builder.append((u16)(alpn_length + 2));
+        builder.append((u16)alpn_length);
+        auto append_protocol = [&](StringView protocol) {
+            builder.append((u8)protocol.length());
+            builder.append(protocol.bytes());
+        };
+        if (!m_context.negotiated_alpn.is_null()) {
+            append_protocol(m_context.negotiated_alpn);
+        } else {
+            for (auto& alpn : m_context.alpn)
+                append_protocol(alpn);
+        }
     }
 
+    // These have to come last, as pre_shared_key must be the very last extension.
+    builder.append(tls13_extensions);
+
     // set the "length" field of the packet
     size_t remaining = builder.length() - start_length;
     size_t payload_position = 6;
@@ -145,6 +224,12 @@ ByteBuffer TLSv12::build_hello()
     builder.set(payload_position + 2, remaining);
 
     auto packet = builder.build();
+    if (m_context.tls13.is_psk_offered) {
+        if (auto result = write_tls13_psk_binder(packet); result.is_error()) {
+            dbgln("Failed to compute the PSK binder: {}", result.error());
+            return {};
+        }
+    }
     update_packet(packet);
 
     return packet;
@@ -218,6 +303,21 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
 
     // TODO: Compare Hashes
     dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+
+    if (m_context.is_resumed_session) {
+        // RFC 5246 section 7.3: In an abbreviated handshake, the server sends its Finished message first,
+        //                       and the handshake is complete once we've sent ours.
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
+    did_establish_connection();
+
+    return index + size;
+}
+
+void TLSv12::did_establish_connection()
+{
     m_context.connection_status = ConnectionStatus::Established;
 
     if (m_handshake_timeout_timer) {
@@ -227,15 +327,60 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         m_handshake_timeout_timer = nullptr;
     }
 
+    store_session_in_cache();
+
     if (on_connected)
         on_connected();
+}
 
-    return index + size;
+void TLSv12::store_session_in_cache()
+{
+    // TLS 1.3 sessions come with the NewSessionTicket messages that follow the handshake.
+    if (m_context.is_tls13)
+        return;
+
+    auto& cache = m_context.options.session_cache;
+    if (!cache || m_context.options.session_cache_key.is_empty())
+        return;
+
+    // A resumed session stays in the cache as it was, unless the server gave us a new ticket for it.
+    if (m_context.is_resumed_session && m_context.session_ticket.is_empty())
+        return;
+
+    if (m_context.session_id_size == 0 && m_context.session_ticket.is_empty()) {
+        dbgln_if(TLS_DEBUG, "Server for {} doesn't support resuming sessions", m_context.options.session_cache_key);
+        return;
+    }
+
+    auto master_key = ByteBuffer::copy(m_context.master_key);
+    if (master_key.is_error())
+        return;
+
+    Session session;
+    memcpy(session.session_id, m_context.session_id, m_context.session_id_size);
+    session.session_id_size = m_context.session_id_size;
+    session.ticket = move(m_context.session_ticket);
+    session.master_key = master_key.release_value();
+    session.cipher = m_context.cipher;
+
+    auto now = Core::DateTime::now().timestamp();
+    session.expiry_timestamp = now + SessionCache::MaximumSessionLifetimeInSeconds;
+    if (m_context.session_ticket_lifetime_hint)
+        session.expiry_timestamp = min(session.expiry_timestamp, now + m_context.session_ticket_lifetime_hint);
+
+    cache->store(m_context.options.session_cache_key, move(session));
+}
+
+void TLSv12::forget_cached_session()
+{
+    if (m_context.options.session_cache && m_context.offered_session.has_value())
+        m_context.options.session_cache->remove(m_context.options.session_cache_key);
 }
 
 ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
 {
-    if (m_context.connection_status == ConnectionStatus::Established) {
+    // TLS 1.3 does have handshake messages after the handshake, session tickets and key updates.
+    if (m_context.connection_status == ConnectionStatus::Established && !m_context.is_tls13) {
         dbgln_if(TLS_DEBUG, "Renegotiation attempt ignored");
         // FIXME: We should properly say "NoRenegotiation", but that causes a handshake failure
         //        so we just roll with it and pretend that we _did_ renegotiate
@@ -257,169 +402,197 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
         if (payload_size + 1 > buffer_length)
             return (i8)Error::NeedMoreData;
 
-        switch (type) {
-        case HelloRequest:
-            if (m_context.handshake_messages[0] >= 1) {
-                dbgln("unexpected hello request message");
-                payload_res = (i8)Error::UnexpectedMessage;
+        // Post-handshake messages aren't part of the transcript.
+        bool is_post_handshake_message = m_context.connection_status == ConnectionStatus::Established;
+        if (m_context.is_tls13 && type != ServerHello) {
+            payload_res = handle_tls13_handshake_message(type, buffer.slice(1, payload_size));
+        } else {
+            switch (type) {
+            case HelloRequest:
+                if (m_context.handshake_messages[0] >= 1) {
+                    dbgln("unexpected hello request message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[0];
+                dbgln("hello request (renegotiation?)");
+                if (m_context.connection_status == ConnectionStatus::Established) {
+                    // renegotiation
+                    payload_res = (i8)Error::NoRenegotiation;
+                } else {
+                    // :shrug:
+                    payload_res = (i8)Error::UnexpectedMessage;
+                }
                 break;
-            }
-            ++m_context.handshake_messages[0];
-            dbgln("hello request (renegotiation?)");
-            if (m_context.connection_status == ConnectionStatus::Established) {
-                // renegotiation
-                payload_res = (i8)Error::NoRenegotiation;
-            } else {
-                // :shrug:
-                payload_res = (i8)Error::UnexpectedMessage;
-            }
-            break;
-        case ClientHello:
-            // FIXME: We only support client mode right now
-            if (m_context.is_server) {
-                VERIFY_NOT_REACHED();
-            }
-            payload_res = (i8)Error::UnexpectedMessage;
-            break;
-        case ServerHello:
-            if (m_context.handshake_messages[2] >= 1) {
-                dbgln("unexpected server hello message");
+            case ClientHello:
+                // FIXME: We only support client mode right now
+                if (m_context.is_server) {
+                    VERIFY_NOT_REACHED();
+                }
                 payload_res = (i8)Error::UnexpectedMessage;
                 break;
-            }
-            ++m_context.handshake_messages[2];
-            dbgln_if(TLS_DEBUG, "server hello");
-            if (m_context.is_server) {
-                dbgln("unsupported: server mode");
-                VERIFY_NOT_REACHED();
-            }
-            payload_res = handle_server_hello(buffer.slice(1, payload_size), write_packets);
-            break;
-        case HelloVerifyRequest:
-            dbgln("unsupported: DTLS");
-            payload_res = (i8)Error::UnexpectedMessage;
-            break;
-        case CertificateMessage:
-            if (m_context.handshake_messages[4] >= 1) {
-                dbgln("unexpected certificate message");
+            case ServerHello:
+                if (m_context.handshake_messages[2] >= 1) {
+                    dbgln("unexpected server hello message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[2];
+                dbgln_if(TLS_DEBUG, "server hello");
+                if (m_context.is_server) {
+                    dbgln("unsupported: server mode");
+                    VERIFY_NOT_REACHED();
+                }
+                payload_res = handle_server_hello(buffer.slice(1, payload_size), write_packets);
+                break;
+            case HelloVerifyRequest:
+                dbgln("unsupported: DTLS");
                 payload_res = (i8)Error::UnexpectedMessage;
                 break;
-            }
-            ++m_context.handshake_messages[4];
-            dbgln_if(TLS_DEBUG, "certificate");
-            if (m_context.connection_status == ConnectionStatus::Negotiating) {
+            case NewSessionTicket:
+                if (m_context.handshake_messages[11] >= 1) {
+                    dbgln("unexpected new session ticket message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[11];
+                dbgln_if(TLS_DEBUG, "new session ticket");
                 if (m_context.is_server) {
                     dbgln("unsupported: server mode");
                     VERIFY_NOT_REACHED();
                 }
-                payload_res = handle_certificate(buffer.slice(1, payload_size));
-            } else {
-                payload_res = (i8)Error::UnexpectedMessage;
-            }
-            break;
-        case ServerKeyExchange:
-            if (m_context.handshake_messages[5] >= 1) {
-                dbgln("unexpected server key exchange message");
-                payload_res = (i8)Error::UnexpectedMessage;
+                if (m_context.connection_status == ConnectionStatus::KeyExchange) {
+                    payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+                } else {
+                    payload_res = (i8)Error::UnexpectedMessage;
+                }
                 break;
-            }
-            ++m_context.handshake_messages[5];
-            dbgln_if(TLS_DEBUG, "server key exchange");
-            if (m_context.is_server) {
-                dbgln("unsupported: server mode");
-                VERIFY_NOT_REACHED();
-            } else {
-                payload_res = handle_server_key_exchange(buffer.slice(1, payload_size));
-            }
-            break;
-        case CertificateRequest:
-            if (m_context.handshake_messages[6] >= 1) {
-                dbgln("unexpected certificate request message");
-                payload_res = (i8)Error::UnexpectedMessage;
+            case CertificateMessage:
+                if (m_context.handshake_messages[4] >= 1) {
+                    dbgln("unexpected certificate message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[4];
+                dbgln_if(TLS_DEBUG, "certificate");
+                if (m_context.connection_status == ConnectionStatus::Negotiating) {
+                    if (m_context.is_server) {
+                        dbgln("unsupported: server mode");
+                        VERIFY_NOT_REACHED();
+                    }
+                    payload_res = handle_certificate(buffer.slice(1, payload_size));
+                } else {
+                    payload_res = (i8)Error::UnexpectedMessage;
+                }
                 break;
-            }
-            ++m_context.handshake_messages[6];
-            if (m_context.is_server) {
-                dbgln("invalid request");
-                dbgln("unsupported: server mode");
-                VERIFY_NOT_REACHED();
-            } else {
-                // we do not support "certificate request"
-                dbgln("certificate request");
-                if (on_tls_certificate_request)
-                    on_tls_certificate_request(*this);
-                m_context.client_verified = VerificationNeeded;
-            }
-            break;
-        case ServerHelloDone:
-            if (m_context.handshake_messages[7] >= 1) {
-                dbgln("unexpected server hello done message");
-                payload_res = (i8)Error::UnexpectedMessage;
+            case ServerKeyExchange:
+                if (m_context.handshake_messages[5] >= 1) {
+                    dbgln("unexpected server key exchange message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[5];
+                dbgln_if(TLS_DEBUG, "server key exchange");
+                if (m_context.is_server) {
+                    dbgln("unsupported: server mode");
+                    VERIFY_NOT_REACHED();
+                } else {
+                    payload_res = handle_server_key_exchange(buffer.slice(1, payload_size));
+                }
                 break;
-            }
-            ++m_context.handshake_messages[7];
-            dbgln_if(TLS_DEBUG, "server hello done");
-            if (m_context.is_server) {
-                dbgln("unsupported: server mode");
-                VERIFY_NOT_REACHED();
-            } else {
-                payload_res = handle_server_hello_done(buffer.slice(1, payload_size));
-                if (payload_res > 0)
-                    write_packets = WritePacketStage::ClientHandshake;
-            }
-            break;
-        case CertificateVerify:
-            if (m_context.handshake_messages[8] >= 1) {
-                dbgln("unexpected certificate verify message");
-                payload_res = (i8)Error::UnexpectedMessage;
+            case CertificateRequest:
+                if (m_context.handshake_messages[6] >= 1) {
+                    dbgln("unexpected certificate request message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[6];
+                if (m_context.is_server) {
+                    dbgln("invalid request");
+                    dbgln("unsupported: server mode");
+                    VERIFY_NOT_REACHED();
+                } else {
+                    // we do not support "certificate request"
+                    dbgln("certificate request");
+                    if (on_tls_certificate_request)
+                        on_tls_certificate_request(*this);
+                    m_context.client_verified = VerificationNeeded;
+                }
                 break;
-            }
-            ++m_context.handshake_messages[8];
-            dbgln_if(TLS_DEBUG, "certificate verify");
-            if (m_context.connection_status == ConnectionStatus::KeyExchange) {
-                payload_res = handle_certificate_verify(buffer.slice(1, payload_size));
-            } else {
-                payload_res = (i8)Error::UnexpectedMessage;
-            }
-            break;
-        case ClientKeyExchange:
-            if (m_context.handshake_messages[9] >= 1) {
-                dbgln("unexpected client key exchange message");
-                payload_res = (i8)Error::UnexpectedMessage;
+            case ServerHelloDone:
+                if (m_context.handshake_messages[7] >= 1) {
+                    dbgln("unexpected server hello done message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[7];
+                dbgln_if(TLS_DEBUG, "server hello done");
+                if (m_context.is_server) {
+                    dbgln("unsupported: server mode");
+                    VERIFY_NOT_REACHED();
+                } else {
+                    payload_res = handle_server_hello_done(buffer.slice(1, payload_size));
+                    if (payload_res > 0)
+                        write_packets = WritePacketStage::ClientHandshake;
+                }
                 break;
-            }
-            ++m_context.handshake_messages[9];
-            dbgln_if(TLS_DEBUG, "client key exchange");
-            if (m_context.is_server) {
-                dbgln("unsupported: server mode");
-                VERIFY_NOT_REACHED();
-            } else {
-                payload_res = (i8)Error::UnexpectedMessage;
-            }
-            break;
-        case Finished:
-            m_context.cached_handshake.clear();
-            if (m_context.handshake_messages[10] >= 1) {
-                dbgln("unexpected finished message");
-                payload_res = (i8)Error::UnexpectedMessage;
+            case CertificateVerify:
+                if (m_context.handshake_messages[8] >= 1) {
+                    dbgln("unexpected certificate verify message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[8];
+                dbgln_if(TLS_DEBUG, "certificate verify");
+                if (m_context.connection_status == ConnectionStatus::KeyExchange) {
+                    payload_res = handle_certificate_verify(buffer.slice(1, payload_size));
+                } else {
+                    payload_res = (i8)Error::UnexpectedMessage;
+                }
                 break;
+            case ClientKeyExchange:
+                if (m_context.handshake_messages[9] >= 1) {
+                    dbgln("unexpected client key exchange message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[9];
+                dbgln_if(TLS_DEBUG, "client key exchange");
+                if (m_context.is_server) {
+                    dbgln("unsupported: server mode");
+                    VERIFY_NOT_REACHED();
+                } else {
+                    payload_res = (i8)Error::UnexpectedMessage;
+                }
+                break;
+            case Finished:
+                m_context.cached_handshake.clear();
+                if (m_context.handshake_messages[10] >= 1) {
+                    dbgln("unexpected finished message");
+                    payload_res = (i8)Error::UnexpectedMessage;
+                    break;
+                }
+                ++m_context.handshake_messages[10];
+                dbgln_if(TLS_DEBUG, "finished");
+                payload_res = handle_handshake_finished(buffer.slice(1, payload_size), write_packets);
+                if (payload_res > 0) {
+                    memset(m_context.handshake_messages, 0, sizeof(m_context.handshake_messages));
+                }
+                break;
+            default:
+                dbgln("message type not understood: {}", type);
+                return (i8)Error::NotUnderstood;
             }
-            ++m_context.handshake_messages[10];
-            dbgln_if(TLS_DEBUG, "finished");
-            payload_res = handle_handshake_finished(buffer.slice(1, payload_size), write_packets);
-            if (payload_res > 0) {
-                memset(m_context.handshake_messages, 0, sizeof(m_context.handshake_messages));
-            }
-            break;
-        default:
-            dbgln("message type not understood: {}", type);
-            return (i8)Error::NotUnderstood;
         }
 
-        if (type != HelloRequest) {
+        if (type != HelloRequest && !is_post_handshake_message) {
             update_hash(buffer.slice(0, payload_size + 1), 0);
         }
 
+        // TLS 1.3 derives its keys from the transcript, so that has to wait until the message is part of it.
+        if (payload_res >= 0 && m_context.is_tls13 && !is_post_handshake_message)
+            payload_res = advance_tls13_key_schedule(type);
+
         // if something went wrong, send an alert about it
         if (payload_res < 0) {
             switch ((Error)payload_res) {
@@ -538,7 +711,7 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 auto packet = build_handshake_finished();
                 write_packet(packet);
             }
-            m_context.connection_status = ConnectionStatus::Established;
+            did_establish_connection();
             break;
         }
         payload_size++;
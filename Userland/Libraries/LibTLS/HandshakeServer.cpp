@@ -24,7 +24,9 @@ namespace TLS {
 ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& write_packets)
 {
     write_packets = WritePacketStage::Initial;
-    if (m_context.connection_status != ConnectionStatus::Disconnected && m_context.connection_status != ConnectionStatus::Renegotiating) {
+    // After a HelloRetryRequest, the real ServerHello follows.
+    bool is_expecting_second_hello = m_context.tls13.did_retry_hello && m_context.connection_status == ConnectionStatus::Negotiating;
+    if (m_context.connection_status != ConnectionStatus::Disconnected && m_context.connection_status != ConnectionStatus::Renegotiating && !is_expecting_second_hello) {
         dbgln("unexpected hello message");
         return (i8)Error::UnexpectedMessage;
     }
@@ -54,6 +56,7 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
 
     memcpy(m_context.remote_random, buffer.offset_pointer(res), sizeof(m_context.remote_random));
     res += sizeof(m_context.remote_random);
+    bool is_hello_retry_request = is_hello_retry_request_random();
 
     u8 session_length = buffer[res++];
     if (buffer.size() - res < session_length) {
@@ -61,6 +64,12 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // RFC 5246 section 7.4.1.3: If the server echoes the session ID we offered, it agreed to resume that session.
+    // RFC 8446 section 4.1.3: A TLS 1.3 server always echoes it.
+    bool is_session_id_echoed = session_length == m_context.session_id_size
+        && memcmp(m_context.session_id, buffer.offset_pointer(res), session_length) == 0;
+    bool is_resuming_offered_session = m_context.offered_session.has_value() && session_length != 0 && is_session_id_echoed;
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -88,7 +97,9 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
     dbgln_if(TLS_DEBUG, "Cipher: {}", (u16)cipher);
 
     // Simplification: We only support handshake hash functions via HMAC
-    m_context.handshake_hash.initialize(hmac_hash());
+    // After a HelloRetryRequest, the transcript is already being hashed with the cipher suite's hash.
+    if (m_context.handshake_hash.kind() == Crypto::Hash::HashKind::None)
+        m_context.handshake_hash.initialize(hmac_hash());
 
     // Compression method
     if (buffer.size() - res < 1)
@@ -150,27 +161,10 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
                 dbgln("SNI host_name: {}", m_context.extensions.SNI);
             }
         } else if (extension_type == HandshakeExtension::ApplicationLayerProtocolNegotiation && m_context.alpn.size()) {
-            if (buffer.size() - res > 2) {
-                auto alpn_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
-                if (alpn_length && alpn_length <= extension_length - 2) {
-                    u8 const* alpn = buffer.offset_pointer(res + 2);
-                    size_t alpn_position = 0;
-                    while (alpn_position < alpn_length) {
-                        u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
-                            break;
-                        String alpn_str { (char const*)alpn + alpn_position, alpn_length };
-                        if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
-                            m_context.negotiated_alpn = alpn_str;
-                            dbgln("negotiated alpn: {}", alpn_str);
-                            break;
-                        }
-                        alpn_position += alpn_length;
-                        if (!m_context.is_server) // server hello must contain one ALPN
-                            break;
-                    }
-                }
-            }
+            if (buffer.size() - res < extension_length)
+                return (i8)Error::NeedMoreData;
+            if (!handle_alpn_extension(buffer.slice(res, extension_length)))
+                return (i8)Error::BrokenPacket;
             res += extension_length;
         } else if (extension_type == HandshakeExtension::SignatureAlgorithms) {
             dbgln("supported signatures: ");
@@ -187,15 +181,134 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
             // uncompressed points. Therefore, this extension can be safely ignored as it should always inform us
             // that the server supports uncompressed points.
             res += extension_length;
+        } else if (extension_type == HandshakeExtension::SupportedVersions
+            || extension_type == HandshakeExtension::KeyShare
+            || extension_type == HandshakeExtension::PreSharedKey
+            || extension_type == HandshakeExtension::Cookie) {
+            auto result = handle_tls13_server_hello_extension(extension_type, buffer.slice(res, extension_length), is_hello_retry_request);
+            if (result < 0)
+                return result;
+            res += extension_length;
+        } else if (extension_type == HandshakeExtension::SessionTicket) {
+            // RFC 5077 section 3.2: The server sends an empty SessionTicket extension to indicate that it will send
+            // a new session ticket using the NewSessionTicket handshake message.
+            // We take whatever NewSessionTicket message comes along, so there's nothing to remember here.
+            res += extension_length;
         } else {
             dbgln("Encountered unknown extension {} with length {}", (u16)extension_type, extension_length);
             res += extension_length;
         }
     }
 
+    if (m_context.tls13.selected_version.has_value() || is_hello_retry_request) {
+        auto result = handle_tls13_server_hello(is_hello_retry_request, is_session_id_echoed);
+        if (result < 0)
+            return result;
+        return res;
+    }
+
+    if (is_tls13_cipher_suite(cipher)) {
+        dbgln("Server picked a TLS 1.3 cipher suite for TLS 1.2");
+        return (i8)Error::NoCommonCipher;
+    }
+
+    if (is_downgraded_from_tls13()) {
+        dbgln("Server supports TLS 1.3, but something made it fall back to TLS 1.2");
+        return (i8)Error::NotSafe;
+    }
+
+    if (m_context.offered_session.has_value()) {
+        auto& session_cache = *m_context.options.session_cache;
+        auto& session = *m_context.offered_session;
+        if (!is_resuming_offered_session) {
+            dbgln_if(TLS_DEBUG, "Server did not resume the session for {}", m_context.options.session_cache_key);
+            session_cache.did_reject_session(m_context.options.session_cache_key);
+            m_context.offered_session.clear();
+            return res;
+        }
+
+        // RFC 5246 section 7.4.1.3: The server MUST use the cipher suite of the session it resumes.
+        if (session.cipher != cipher) {
+            dbgln("Server resumed a session with a different cipher suite");
+            forget_cached_session();
+            return (i8)Error::NotSafe;
+        }
+
+        dbgln_if(TLS_DEBUG, "Resuming the session for {}", m_context.options.session_cache_key);
+        m_context.master_key = move(session.master_key);
+        if (!expand_key())
+            return (i8)Error::NotSafe;
+
+        // There's no certificate or key exchange in an abbreviated handshake, the server's ChangeCipherSpec comes right away.
+        m_context.is_resumed_session = true;
+        m_context.connection_status = ConnectionStatus::KeyExchange;
+        session_cache.did_resume_session();
+    }
+
     return res;
 }
 
+// https://www.rfc-editor.org/rfc/rfc7301#section-3.1
+bool TLSv12::handle_alpn_extension(ReadonlyBytes extension)
+{
+    if (extension.size() < 2)
+        return false;
+    size_t list_length = AK::convert_between_host_and_network_endian(ByteReader::load16(extension.data()));
+    if (list_length != extension.size() - 2)
+        return false;
+
+    // "The "extension_data" field of the [server's] extension is structured the same as described above
+    //  for the client "extension_data", except that the "ProtocolNameList" MUST contain exactly one "ProtocolName"."
+    auto list = extension.slice(2);
+    if (list.is_empty() || list[0] == 0 || list[0] != list.size() - 1)
+        return false;
+
+    auto protocol = StringView { list.slice(1) };
+    if (!m_context.alpn.contains_slow(protocol)) {
+        dbgln("TLS: Server picked the application protocol '{}', which we didn't offer", protocol);
+        return false;
+    }
+
+    m_context.negotiated_alpn = protocol;
+    dbgln_if(TLS_DEBUG, "Negotiated the application protocol '{}'", protocol);
+    return true;
+}
+
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 3)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    // RFC 5077 section 3.3:
+    //     struct {
+    //         uint32 ticket_lifetime_hint;
+    //         opaque ticket<0..2^16-1>;
+    //     } NewSessionTicket;
+    if (size < 6)
+        return (i8)Error::BrokenPacket;
+
+    u32 lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    u16 ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (ticket_length + 6u > size)
+        return (i8)Error::BrokenPacket;
+
+    // An empty ticket means that the server changed its mind about giving us one.
+    auto ticket = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket.is_error())
+        return (i8)Error::OutOfMemory;
+
+    dbgln_if(TLS_DEBUG, "Received a session ticket of {} bytes, lifetime hint {}s", ticket_length, lifetime_hint);
+    m_context.session_ticket = ticket.release_value();
+    m_context.session_ticket_lifetime_hint = lifetime_hint;
+
+    return size + 3;
+}
+
 ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
 {
     if (buffer.size() < 3)
@@ -292,6 +405,20 @@ ssize_t TLSv12::handle_dhe_rsa_server_key_exchange(ReadonlyBytes buffer)
     return verify_rsa_server_key_exchange(server_key_info, signature);
 }
 
+OwnPtr<Crypto::Curves::EllipticCurve> TLSv12::create_elliptic_curve(NamedCurve curve)
+{
+    switch (curve) {
+    case NamedCurve::x25519:
+        return make<Crypto::Curves::X25519>();
+    case NamedCurve::x448:
+        return make<Crypto::Curves::X448>();
+    case NamedCurve::secp256r1:
+        return make<Crypto::Curves::SECP256r1>();
+    default:
+        return {};
+    }
+}
+
 ssize_t TLSv12::handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes buffer)
 {
     if (buffer.size() < 7)
@@ -305,19 +432,9 @@ ssize_t TLSv12::handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes buffer)
     if (!m_context.options.elliptic_curves.contains_slow(curve))
         return (i8)Error::NotUnderstood;
 
-    switch ((NamedCurve)curve) {
-    case NamedCurve::x25519:
-        m_context.server_key_exchange_curve = make<Crypto::Curves::X25519>();
-        break;
-    case NamedCurve::x448:
-        m_context.server_key_exchange_curve = make<Crypto::Curves::X448>();
-        break;
-    case NamedCurve::secp256r1:
-        m_context.server_key_exchange_curve = make<Crypto::Curves::SECP256r1>();
-        break;
-    default:
+    m_context.server_key_exchange_curve = create_elliptic_curve(curve);
+    if (!m_context.server_key_exchange_curve)
         return (i8)Error::NotUnderstood;
-    }
 
     auto server_public_key_length = buffer[6];
     if (server_public_key_length != m_context.server_key_exchange_curve->key_size())
@@ -347,16 +464,36 @@ ssize_t TLSv12::verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buf
 {
     auto signature_hash = signature_buffer[0];
     auto signature_algorithm = signature_buffer[1];
-    if (signature_algorithm != (u8)SignatureAlgorithm::RSA) {
-        dbgln("verify_rsa_server_key_exchange failed: Signature algorithm is not RSA, instead {}", signature_algorithm);
-        return (i8)Error::NotUnderstood;
-    }
-
     auto signature_length = AK::convert_between_host_and_network_endian(ByteReader::load16(signature_buffer.offset_pointer(2)));
     auto signature = signature_buffer.slice(4, signature_length);
 
+    auto message_result = ByteBuffer::create_uninitialized(64 + server_key_info_buffer.size());
+    if (message_result.is_error()) {
+        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
+        return (i8)Error::OutOfMemory;
+    }
+    auto message = message_result.release_value();
+    message.overwrite(0, m_context.local_random, 32);
+    message.overwrite(32, m_context.remote_random, 32);
+    message.overwrite(64, server_key_info_buffer.data(), server_key_info_buffer.size());
+
+    return verify_rsa_signature({ (HashAlgorithm)signature_hash, (SignatureAlgorithm)signature_algorithm }, message, signature);
+}
+
+// Verifies a signature made with the server's certificate, either PKCS#1 v1.5 with the given hash, or RSASSA-PSS.
+ssize_t TLSv12::verify_rsa_signature(SignatureAndHashAlgorithm algorithm, ReadonlyBytes message, ReadonlyBytes signature)
+{
+    bool is_pss = algorithm.hash == HashAlgorithm::INTRINSIC
+        && (algorithm.signature == SignatureAlgorithm::RSA_PSS_RSAE_SHA256
+            || algorithm.signature == SignatureAlgorithm::RSA_PSS_RSAE_SHA384
+            || algorithm.signature == SignatureAlgorithm::RSA_PSS_RSAE_SHA512);
+    if (algorithm.signature != SignatureAlgorithm::RSA && !is_pss) {
+        dbgln("verify_rsa_signature failed: Signature algorithm is not RSA, instead {}", (u8)algorithm.signature);
+        return (i8)Error::NotUnderstood;
+    }
+
     if (m_context.certificates.is_empty()) {
-        dbgln("verify_rsa_server_key_exchange failed: Attempting to verify signature without certificates");
+        dbgln("verify_rsa_signature failed: Attempting to verify signature without certificates");
         return (i8)Error::NotSafe;
     }
     // RFC5246 section 7.4.2: The sender's certificate MUST come first in the list.
@@ -364,49 +501,66 @@ ssize_t TLSv12::verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buf
     Crypto::PK::RSAPrivateKey dummy_private_key;
     auto rsa = Crypto::PK::RSA(certificate_public_key, dummy_private_key);
 
-    auto signature_verify_buffer_result = ByteBuffer::create_uninitialized(signature_length);
+    auto signature_verify_buffer_result = ByteBuffer::create_uninitialized(signature.size());
     if (signature_verify_buffer_result.is_error()) {
-        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
+        dbgln("verify_rsa_signature failed: Not enough memory");
         return (i8)Error::OutOfMemory;
     }
     auto signature_verify_buffer = signature_verify_buffer_result.release_value();
     auto signature_verify_bytes = signature_verify_buffer.bytes();
     rsa.verify(signature, signature_verify_bytes);
 
-    auto message_result = ByteBuffer::create_uninitialized(64 + server_key_info_buffer.size());
-    if (message_result.is_error()) {
-        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
-        return (i8)Error::OutOfMemory;
-    }
-    auto message = message_result.release_value();
-    message.overwrite(0, m_context.local_random, 32);
-    message.overwrite(32, m_context.remote_random, 32);
-    message.overwrite(64, server_key_info_buffer.data(), server_key_info_buffer.size());
+    auto verification = Crypto::VerificationConsistency::Inconsistent;
+    if (is_pss) {
+        // RFC 8017 section 8.1.2: The encoded message is one bit shorter than the modulus, which can make it a byte shorter.
+        auto em_bits = certificate_public_key.modulus().one_based_index_of_highest_set_bit() - 1;
+        auto em_length = (em_bits + 7) / 8;
+        if (em_length > signature_verify_bytes.size()) {
+            dbgln("verify_rsa_signature failed: Signature is too short");
+            return (i8)Error::NotSafe;
+        }
+        auto encoded_message = signature_verify_bytes.slice(signature_verify_bytes.size() - em_length);
+
+        // RFC 8446 section 4.2.3: The salt is as long as the digest.
+        switch (algorithm.signature) {
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA256:
+            verification = Crypto::PK::EMSA_PSS<Crypto::Hash::SHA256, Crypto::Hash::SHA256::DigestSize>().verify(message, encoded_message, em_bits);
+            break;
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA384:
+            verification = Crypto::PK::EMSA_PSS<Crypto::Hash::SHA384, Crypto::Hash::SHA384::DigestSize>().verify(message, encoded_message, em_bits);
+            break;
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA512:
+            verification = Crypto::PK::EMSA_PSS<Crypto::Hash::SHA512, Crypto::Hash::SHA512::DigestSize>().verify(message, encoded_message, em_bits);
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    } else {
+        Crypto::Hash::HashKind hash_kind;
+        switch (algorithm.hash) {
+        case HashAlgorithm::SHA1:
+            hash_kind = Crypto::Hash::HashKind::SHA1;
+            break;
+        case HashAlgorithm::SHA256:
+            hash_kind = Crypto::Hash::HashKind::SHA256;
+            break;
+        case HashAlgorithm::SHA384:
+            hash_kind = Crypto::Hash::HashKind::SHA384;
+            break;
+        case HashAlgorithm::SHA512:
+            hash_kind = Crypto::Hash::HashKind::SHA512;
+            break;
+        default:
+            dbgln("verify_rsa_signature failed: Hash algorithm is not SHA1/256/384/512, instead {}", (u8)algorithm.hash);
+            return (i8)Error::NotUnderstood;
+        }
 
-    Crypto::Hash::HashKind hash_kind;
-    switch ((HashAlgorithm)signature_hash) {
-    case HashAlgorithm::SHA1:
-        hash_kind = Crypto::Hash::HashKind::SHA1;
-        break;
-    case HashAlgorithm::SHA256:
-        hash_kind = Crypto::Hash::HashKind::SHA256;
-        break;
-    case HashAlgorithm::SHA384:
-        hash_kind = Crypto::Hash::HashKind::SHA384;
-        break;
-    case HashAlgorithm::SHA512:
-        hash_kind = Crypto::Hash::HashKind::SHA512;
-        break;
-    default:
-        dbgln("verify_rsa_server_key_exchange failed: Hash algorithm is not SHA1/256/384/512, instead {}", signature_hash);
-        return (i8)Error::NotUnderstood;
+        auto pkcs1 = Crypto::PK::EMSA_PKCS1_V1_5<Crypto::Hash::Manager>(hash_kind);
+        verification = pkcs1.verify(message, signature_verify_bytes, signature.size() * 8);
     }
 
-    auto pkcs1 = Crypto::PK::EMSA_PKCS1_V1_5<Crypto::Hash::Manager>(hash_kind);
-    auto verification = pkcs1.verify(message, signature_verify_bytes, signature_length * 8);
-
     if (verification == Crypto::VerificationConsistency::Inconsistent) {
-        dbgln("verify_rsa_server_key_exchange failed: Verification of signature inconsistent");
+        dbgln("verify_rsa_signature failed: Verification of signature inconsistent");
         return (i8)Error::NotSafe;
     }
 
@@ -14,6 +14,15 @@
 
 namespace TLS {
 
+// RFC 7905 section 2: The nonce is the fixed IV XORed with the sequence number, padded on the left to 12 bytes.
+static void compute_chacha20_poly1305_nonce(u8 const* iv, u64 sequence_number, Bytes nonce)
+{
+    VERIFY(nonce.size() == Crypto::Cipher::ChaCha20Poly1305::NonceSize);
+    __builtin_memcpy(nonce.data(), iv, nonce.size());
+    for (size_t i = 0; i < sizeof(sequence_number); ++i)
+        nonce[nonce.size() - 1 - i] ^= (u8)(sequence_number >> (8 * i));
+}
+
 ByteBuffer TLSv12::build_alert(bool critical, u8 code)
 {
     PacketBuilder builder(MessageType::Alert, (u16)m_context.options.version);
@@ -69,6 +78,11 @@ void TLSv12::update_packet(ByteBuffer& packet)
     u32 header_size = 5;
     ByteReader::store(packet.offset_pointer(3), AK::convert_between_host_and_network_endian((u16)(packet.size() - header_size)));
 
+    if (m_context.is_tls13) {
+        update_tls13_packet(packet);
+        return;
+    }
+
     if (packet[0] != (u8)MessageType::ChangeCipher) {
         if (packet[0] == (u8)MessageType::Handshake && packet.size() > header_size) {
             u8 handshake_type = packet[header_size];
@@ -90,6 +104,11 @@ void TLSv12::update_packet(ByteBuffer& packet)
                     padding = 0;
                     mac_size = 0; // AEAD provides its own authentication scheme.
                 },
+                [&](Crypto::Cipher::ChaCha20Poly1305&) {
+                    VERIFY(is_aead());
+                    padding = 0;
+                    mac_size = 0;
+                },
                 [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                     VERIFY(!is_aead());
                     block_size = cbc.cipher().block_size();
@@ -175,6 +194,42 @@ void TLSv12::update_packet(ByteBuffer& packet)
 
                         VERIFY(header_size + 8 + length + 16 == ct.size());
                     },
+                    [&](Crypto::Cipher::ChaCha20Poly1305& chacha) {
+                        VERIFY(is_aead());
+                        // We need enough space for a header, the data and a tag, the nonce isn't transmitted.
+                        auto ct_buffer_result = ByteBuffer::create_uninitialized(header_size + length + Crypto::Cipher::ChaCha20Poly1305::TagSize);
+                        if (ct_buffer_result.is_error()) {
+                            dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
+                            VERIFY_NOT_REACHED();
+                        }
+                        ct = ct_buffer_result.release_value();
+
+                        // copy the header over
+                        ct.overwrite(0, packet.data(), header_size - 2);
+
+                        // The AAD is the same as for GCM.
+                        u8 aad[13];
+                        Bytes aad_bytes { aad, 13 };
+                        OutputMemoryStream aad_stream { aad_bytes };
+
+                        u64 seq_no = AK::convert_between_host_and_network_endian(m_context.local_sequence_number);
+                        u16 len = AK::convert_between_host_and_network_endian((u16)(packet.size() - header_size));
+
+                        aad_stream.write({ &seq_no, sizeof(seq_no) });
+                        aad_stream.write(packet.bytes().slice(0, 3)); // content-type + version
+                        aad_stream.write({ &len, sizeof(len) });      // length
+                        VERIFY(aad_stream.is_end());
+
+                        u8 nonce[Crypto::Cipher::ChaCha20Poly1305::NonceSize];
+                        compute_chacha20_poly1305_nonce(m_context.crypto.local_aead_iv, m_context.local_sequence_number, { nonce, sizeof(nonce) });
+
+                        chacha.encrypt(
+                            packet.bytes().slice(header_size, length),
+                            ct.bytes().slice(header_size, length),
+                            { nonce, sizeof(nonce) },
+                            aad_bytes,
+                            ct.bytes().slice(header_size + length, Crypto::Cipher::ChaCha20Poly1305::TagSize));
+                    },
                     [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                         VERIFY(!is_aead());
                         // We need enough space for a header, iv_length bytes of IV and whatever the packet contains
@@ -346,7 +401,27 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
     ByteBuffer decrypted;
 
-    if (m_context.cipher_spec_set && type != MessageType::ChangeCipher) {
+    if (m_context.is_tls13) {
+        // RFC 8446 section 5: A ChangeCipherSpec may show up during the handshake for middlebox compatibility, and is dropped.
+        if (type == MessageType::ChangeCipher) {
+            if (m_context.connection_status == ConnectionStatus::Established || length != 1 || plain[0] != 1) {
+                dbgln("unexpected change cipher message");
+                auto packet = build_alert(true, (u8)AlertDescription::UnexpectedMessage);
+                write_packet(packet);
+                return (i8)Error::UnexpectedMessage;
+            }
+            return header_size + length;
+        }
+
+        if (m_context.cipher_spec_set) {
+            auto inner_type = decrypt_tls13_record(buffer.slice(0, header_size + length), decrypted);
+            if (inner_type < 0)
+                return inner_type;
+            type = (MessageType)inner_type;
+            plain = decrypted;
+            length = decrypted.size();
+        }
+    } else if (m_context.cipher_spec_set && type != MessageType::ChangeCipher) {
         if constexpr (TLS_DEBUG) {
             dbgln("Encrypted: ");
             print_buffer(buffer.slice(header_size, length));
@@ -427,6 +502,57 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
                 plain = decrypted;
             },
+            [&](Crypto::Cipher::ChaCha20Poly1305& chacha) {
+                VERIFY(is_aead());
+                constexpr auto tag_size = Crypto::Cipher::ChaCha20Poly1305::TagSize;
+                if (length < tag_size) {
+                    dbgln("Invalid packet length");
+                    auto packet = build_alert(true, (u8)AlertDescription::DecryptError);
+                    write_packet(packet);
+                    return_value = Error::BrokenPacket;
+                    return;
+                }
+
+                auto packet_length = length - tag_size;
+                auto decrypted_result = ByteBuffer::create_uninitialized(packet_length);
+                if (decrypted_result.is_error()) {
+                    dbgln("Failed to allocate memory for the packet");
+                    return_value = Error::DecryptionFailed;
+                    return;
+                }
+                decrypted = decrypted_result.release_value();
+
+                // The AAD is the same as for GCM.
+                u8 aad[13];
+                Bytes aad_bytes { aad, 13 };
+                OutputMemoryStream aad_stream { aad_bytes };
+
+                u64 seq_no = AK::convert_between_host_and_network_endian(m_context.remote_sequence_number);
+                u16 len = AK::convert_between_host_and_network_endian((u16)packet_length);
+
+                aad_stream.write({ &seq_no, sizeof(seq_no) });      // Sequence number
+                aad_stream.write(buffer.slice(0, header_size - 2)); // content-type + version
+                aad_stream.write({ &len, sizeof(u16) });
+                VERIFY(aad_stream.is_end());
+
+                u8 nonce[Crypto::Cipher::ChaCha20Poly1305::NonceSize];
+                compute_chacha20_poly1305_nonce(m_context.crypto.remote_aead_iv, m_context.remote_sequence_number, { nonce, sizeof(nonce) });
+
+                auto ciphertext = plain.slice(0, packet_length);
+                auto tag = plain.slice(packet_length, tag_size);
+                auto consistency = chacha.decrypt(ciphertext, decrypted, { nonce, sizeof(nonce) }, aad_bytes, tag);
+
+                if (consistency != Crypto::VerificationConsistency::Consistent) {
+                    dbgln("integrity check failed (tag length {})", tag.size());
+                    auto packet = build_alert(true, (u8)AlertDescription::BadRecordMAC);
+                    write_packet(packet);
+
+                    return_value = Error::IntegrityCheckFailed;
+                    return;
+                }
+
+                plain = decrypted;
+            },
             [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                 VERIFY(!is_aead());
                 auto iv_size = iv_length();
@@ -536,11 +662,14 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                 m_context.critical_error = code;
                 try_disambiguate_error();
                 res = (i8)Error::UnknownError;
+                // Don't try to resume a session that the server may have just choked on.
+                if (m_context.connection_status != ConnectionStatus::Established)
+                    forget_cached_session();
             }
 
             if (code == (u8)AlertDescription::CloseNotify) {
                 res += 2;
-                alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+                alert(AlertLevel::Warning, AlertDescription::CloseNotify);
                 if (!m_context.cipher_spec_set) {
                     // AWS CloudFront hits this.
                     dbgln("Server sent a close notify and we haven't agreed on a cipher suite. Treating it as a handshake failure.");
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCore/DateTime.h>
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+Optional<Session> SessionCache::find(String const& key)
+{
+    auto it = m_sessions.find(key);
+    if (it != m_sessions.end() && it->value.expiry_timestamp <= Core::DateTime::now().timestamp()) {
+        dbgln_if(TLS_DEBUG, "Session for {} expired", key);
+        m_sessions.remove(it);
+        it = m_sessions.end();
+    }
+
+    if (it == m_sessions.end()) {
+        ++m_misses;
+        return {};
+    }
+
+    ++m_hits;
+    return it->value;
+}
+
+void SessionCache::store(String const& key, Session session)
+{
+    if (!m_sessions.contains(key) && m_sessions.size() >= MaximumSessionCount) {
+        // Make room by throwing out the session that would have expired first.
+        auto oldest = m_sessions.begin();
+        for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+            if (it->value.expiry_timestamp < oldest->value.expiry_timestamp)
+                oldest = it;
+        }
+        m_sessions.remove(oldest);
+    }
+
+    m_sessions.set(key, move(session));
+}
+
+void SessionCache::remove(String const& key)
+{
+    m_sessions.remove(key);
+}
+
+void SessionCache::did_reject_session(String const& key)
+{
+    ++m_rejections;
+    remove(key);
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <LibTLS/CipherSuite.h>
+#include <LibTLS/TLSPacketBuilder.h>
+
+namespace TLS {
+
+// Everything a client needs to resume a session with an abbreviated handshake, either by offering
+// the session ID the server gave us (RFC 5246 section 7.3), or by presenting a ticket (RFC 5077).
+// TLS 1.3 sessions are always tickets, and their master key is the pre-shared key (RFC 8446 section 4.6.1).
+struct Session {
+    Version version { Version::V12 };
+    u8 session_id[32] {};
+    u8 session_id_size { 0 };
+    ByteBuffer ticket;
+    ByteBuffer master_key;
+    CipherSuite cipher { CipherSuite::Invalid };
+    time_t expiry_timestamp { 0 };
+
+    // RFC 8446 section 4.2.11.1: Needed to tell the server how old the ticket is.
+    u32 ticket_age_add { 0 };
+    i64 ticket_received_timestamp_ms { 0 };
+};
+
+// A client-side cache of resumable sessions, keyed by "host:port".
+// It is meant to be shared by all connections a client makes, through Options::session_cache.
+class SessionCache : public RefCounted<SessionCache> {
+public:
+    // RFC 5246 section F.1.4: "an upper limit of 24 hours is suggested for session ID lifetimes".
+    // Servers rarely keep their state around for that long though, so don't bother offering anything older than this.
+    static constexpr time_t MaximumSessionLifetimeInSeconds = 60 * 60;
+    static constexpr size_t MaximumSessionCount = 256;
+
+    static NonnullRefPtr<SessionCache> create() { return adopt_ref(*new SessionCache); }
+
+    Optional<Session> find(String const& key);
+    void store(String const& key, Session);
+    void remove(String const& key);
+
+    // Lookups that found a session, and lookups that didn't.
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+
+    // Sessions that were offered to, and accepted or turned down by the server.
+    size_t resumptions() const { return m_resumptions; }
+    size_t rejections() const { return m_rejections; }
+
+    void did_resume_session() { ++m_resumptions; }
+    void did_reject_session(String const& key);
+
+private:
+    SessionCache() = default;
+
+    HashMap<String, Session> m_sessions;
+    size_t m_hits { 0 };
+    size_t m_misses { 0 };
+    size_t m_resumptions { 0 };
+    size_t m_rejections { 0 };
+};
+
+}
@@ -74,6 +74,9 @@ ErrorOr<size_t> TLSv12::write(ReadonlyBytes bytes)
 
 ErrorOr<NonnullOwnPtr<TLSv12>> TLSv12::connect(String const& host, u16 port, Options options)
 {
+    if (options.session_cache && options.session_cache_key.is_empty())
+        options.session_cache_key = String::formatted("{}:{}", host, port);
+
     Core::EventLoop loop;
     OwnPtr<Core::Stream::Socket> tcp_socket = TRY(Core::Stream::TCPSocket::connect(host, port));
     TRY(tcp_socket->set_blocking(false));
@@ -115,6 +118,33 @@ ErrorOr<NonnullOwnPtr<TLSv12>> TLSv12::connect(String const& host, Core::Stream:
     return AK::Error::from_string_view(alert_name(static_cast<AlertDescription>(256 - result)));
 }
 
+ErrorOr<NonnullOwnPtr<TLSv12>> TLSv12::connect_async(String const& host, NonnullOwnPtr<Core::Stream::Socket> underlying_stream, Options options, Function<void(ErrorOr<void>)> on_complete)
+{
+    TRY(underlying_stream->set_blocking(false));
+    auto tls_socket = TRY(adopt_nonnull_own_or_enomem(new (nothrow) TLSv12(OwnPtr<Core::Stream::Socket>(move(underlying_stream)), move(options))));
+    tls_socket->set_sni(host);
+    tls_socket->m_on_async_connect_complete = move(on_complete);
+    tls_socket->on_connected = [socket = tls_socket.ptr()] {
+        socket->did_finish_async_connect({});
+    };
+    tls_socket->on_tls_error = [socket = tls_socket.ptr()](AlertDescription alert) {
+        socket->try_disambiguate_error();
+        // FIXME: Should return richer information here.
+        socket->did_finish_async_connect(AK::Error::from_string_view(alert_name(alert)));
+    };
+    return tls_socket;
+}
+
+void TLSv12::did_finish_async_connect(ErrorOr<void> result)
+{
+    // Whatever happens after the handshake is up to whoever owns the socket now.
+    on_connected = nullptr;
+    on_tls_error = nullptr;
+    auto on_complete = move(m_on_async_connect_complete);
+    if (on_complete)
+        on_complete(move(result));
+}
+
 void TLSv12::setup_connection()
 {
     Core::deferred_invoke([this] {
@@ -317,7 +347,9 @@ ErrorOr<bool> TLSv12::flush()
 
 void TLSv12::close()
 {
-    alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+    // RFC 5246 section 7.2.2: Fatal alerts invalidate the session, so closing the connection with
+    //                         anything but a warning would make the server forget about the session.
+    alert(AlertLevel::Warning, AlertDescription::CloseNotify);
     // bye bye.
     m_context.connection_status = ConnectionStatus::Disconnected;
 }
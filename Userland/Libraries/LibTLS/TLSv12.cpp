@@ -129,7 +129,7 @@ void TLSv12::try_disambiguate_error() const
         dbgln("- No cipher suite in common with {} (the server is oh so secure)", m_context.extensions.SNI);
         break;
     case AlertDescription::ProtocolVersion:
-        dbgln("- The server refused to negotiate with TLS 1.2 :(");
+        dbgln("- The server refused to negotiate with TLS 1.2 or 1.3 :(");
         break;
     case AlertDescription::UnexpectedMessage:
         dbgln("- We sent an invalid message for the state we're in.");
@@ -175,21 +175,23 @@ void TLSv12::try_disambiguate_error() const
     }
 }
 
+void TLSv12::add_alpn(StringView alpn)
+{
+    m_context.alpn.append(alpn);
+}
+
+bool TLSv12::has_alpn(StringView alpn) const
+{
+    return m_context.alpn.contains_slow(alpn);
+}
+
 void TLSv12::set_root_certificates(Vector<Certificate> certificates)
 {
-    if (!m_context.root_certificates.is_empty()) {
+    if (m_context.root_certificates && !m_context.root_certificates->is_empty())
         dbgln("TLS warn: resetting root certificates!");
-        m_context.root_certificates.clear();
-    }
 
-    for (auto& cert : certificates) {
-        if (!cert.is_valid())
-            dbgln("Certificate for {} by {} is invalid, things may or may not work!", cert.subject.subject, cert.issuer.subject);
-        // FIXME: Figure out what we should do when our root certs are invalid.
-
-        m_context.root_certificates.set(cert.subject_identifier_string(), cert);
-    }
-    dbgln_if(TLS_DEBUG, "{}: Set {} root certificates", this, m_context.root_certificates.size());
+    m_context.root_certificates = TrustStore::create(certificates);
+    dbgln_if(TLS_DEBUG, "{}: Set {} root certificates", this, m_context.root_certificates->size());
 }
 
 static bool wildcard_matches(StringView host, StringView subject)
@@ -221,7 +223,7 @@ static bool certificate_subject_matches_host(Certificate& cert, StringView host)
     return false;
 }
 
-bool Context::verify_chain(StringView host) const
+bool Context::verify_chain(StringView host)
 {
     if (!options.validate_certificates)
         return true;
@@ -258,6 +260,7 @@ bool Context::verify_chain(StringView host) const
         return false;
     }
 
+    Optional<Core::DateTime> chain_expiry;
     for (size_t cert_index = 0; cert_index < local_chain->size(); ++cert_index) {
         auto cert = local_chain->at(cert_index);
 
@@ -269,17 +272,27 @@ bool Context::verify_chain(StringView host) const
             return false;
         }
 
-        auto maybe_root_certificate = root_certificates.get(issuer_string);
-        if (maybe_root_certificate.has_value()) {
-            auto& root_certificate = *maybe_root_certificate;
-            auto verification_correct = verify_certificate_pair(cert, root_certificate);
+        if (cert_index == 0 && root_certificates->has_verified_chain_for(cert)) {
+            dbgln_if(TLS_DEBUG, "verify_chain: Chain for {} was verified before", subject_string);
+            return true;
+        }
+
+        if (!chain_expiry.has_value() || cert.not_after < *chain_expiry)
+            chain_expiry = cert.not_after;
+
+        if (auto const* root_certificate = root_certificates->find_by_subject(issuer_string)) {
+            auto verification_correct = verify_certificate_pair(cert, *root_certificate);
 
             if (!verification_correct) {
                 dbgln("verify_chain: Signature inconsistent, {} was not signed by {} (root certificate)", subject_string, issuer_string);
                 return false;
             }
 
-            // Root certificate reached, and correctly verified, so we can stop now
+            // Root certificate reached, and correctly verified, so we can stop now.
+            // Once the leaf is known to be signed by a trusted chain it stays that way, at least until something in it expires.
+            if (root_certificate->not_after < *chain_expiry)
+                chain_expiry = root_certificate->not_after;
+            root_certificates->did_verify_chain_for(local_chain->first(), *chain_expiry);
             return true;
         }
 
@@ -433,10 +446,12 @@ TLSv12::TLSv12(StreamVariantType stream, Options options)
     m_context.options = move(options);
     m_context.is_server = false;
     m_context.tls_buffer = {};
+    m_context.alpn = m_context.options.alpn_protocols;
 
-    set_root_certificates(m_context.options.root_certificates.has_value()
-            ? *m_context.options.root_certificates
-            : DefaultRootCACertificates::the().certificates());
+    if (m_context.options.root_certificates.has_value())
+        set_root_certificates(*m_context.options.root_certificates);
+    else
+        m_context.root_certificates = DefaultRootCACertificates::the().trust_store();
 
     setup_connection();
 }
@@ -473,15 +488,23 @@ DefaultRootCACertificates::DefaultRootCACertificates()
     auto config_result = Core::ConfigFile::open_for_system("ca_certs");
     if (config_result.is_error()) {
         dbgln("Failed to load CA Certificates: {}", config_result.error());
+        m_trust_store = TrustStore::create({});
         return;
     }
     auto config = config_result.release_value();
     reload_certificates(config);
 }
 
+DefaultRootCACertificates::~DefaultRootCACertificates() = default;
+
+NonnullRefPtr<TrustStore> DefaultRootCACertificates::trust_store() const
+{
+    return *m_trust_store;
+}
+
 void DefaultRootCACertificates::reload_certificates(Core::ConfigFile& config)
 {
-    m_ca_certificates.clear();
+    Vector<Certificate> certificates;
     for (auto& entity : config.groups()) {
         for (auto& subject : config.keys(entity)) {
             auto certificate_base64 = config.read_entry(entity, subject);
@@ -499,10 +522,12 @@ void DefaultRootCACertificates::reload_certificates(Core::ConfigFile& config)
                 continue;
             }
             auto certificate = certificate_result.release_value();
-            m_ca_certificates.append(move(certificate));
+            certificates.append(move(certificate));
         }
     }
 
-    dbgln("Loaded {} CA Certificates", m_ca_certificates.size());
+    // Connections that are still using the old store keep it alive until they are done with it.
+    m_trust_store = TrustStore::create(certificates);
+    dbgln("Loaded {} CA Certificates", m_trust_store->size());
 }
 }
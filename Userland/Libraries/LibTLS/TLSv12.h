@@ -15,11 +15,14 @@
 #include <LibCrypto/Authentication/HMAC.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
 #include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Cipher/ChaCha20Poly1305.h>
 #include <LibCrypto/Curves/EllipticCurve.h>
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
+#include <LibTLS/TrustStore.h>
 
 namespace TLS {
 
@@ -123,13 +126,17 @@ enum HandshakeType {
     ClientHello = 0x01,
     ServerHello = 0x02,
     HelloVerifyRequest = 0x03,
+    NewSessionTicket = 0x04,
+    EncryptedExtensions = 0x08,
     CertificateMessage = 0x0b,
     ServerKeyExchange = 0x0c,
     CertificateRequest = 0x0d,
     ServerHelloDone = 0x0e,
     CertificateVerify = 0x0f,
     ClientKeyExchange = 0x10,
-    Finished = 0x14
+    Finished = 0x14,
+    KeyUpdate = 0x18,
+    MessageHash = 0xfe,
 };
 
 enum class HandshakeExtension : u16 {
@@ -138,6 +145,12 @@ enum class HandshakeExtension : u16 {
     ECPointFormats = 0x0b,
     SignatureAlgorithms = 0x0d,
     ApplicationLayerProtocolNegotiation = 0x10,
+    SessionTicket = 0x23,
+    PreSharedKey = 0x29,
+    SupportedVersions = 0x2b,
+    Cookie = 0x2c,
+    PSKKeyExchangeModes = 0x2d,
+    KeyShare = 0x33,
 };
 
 enum class NameType : u8 {
@@ -172,17 +185,24 @@ enum class ECCurveType : u8 {
 // 4 bytes of fixed IV, 8 random (nonce) bytes, 4 bytes for counter
 // GCM specifically asks us to transmit only the nonce, the counter is zero
 // and the fixed IV is derived from the premaster key.
-#define ENUMERATE_CIPHERS(C)                                                                                                                              \
-    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                \
-    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                \
-    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)           \
-    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false)           \
-    C(true, CipherSuite::RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)             \
-    C(true, CipherSuite::RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)             \
-    C(true, CipherSuite::DHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)     \
-    C(true, CipherSuite::DHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)     \
-    C(true, CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true) \
-    C(true, CipherSuite::ECDHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)
+// ChaCha20-Poly1305 doesn't transmit any part of its nonce either, it's a 12 byte fixed IV XORed with the sequence number.
+// TLS 1.3 cipher suites don't name a key exchange, and use a 12 byte nonce derived from the traffic secret.
+#define ENUMERATE_CIPHERS(C)                                                                                                                                           \
+    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                             \
+    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                             \
+    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)                        \
+    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false)                        \
+    C(true, CipherSuite::RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                          \
+    C(true, CipherSuite::RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)                          \
+    C(true, CipherSuite::DHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                  \
+    C(true, CipherSuite::DHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)                  \
+    C(true, CipherSuite::DHE_RSA_WITH_CHACHA20_POLY1305_SHA256, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::CHACHA20_POLY1305, Crypto::Hash::SHA256, 12, true)     \
+    C(true, CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)              \
+    C(true, CipherSuite::ECDHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)              \
+    C(true, CipherSuite::ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::CHACHA20_POLY1305, Crypto::Hash::SHA256, 12, true) \
+    C(true, CipherSuite::AES_128_GCM_SHA256, KeyExchangeAlgorithm::Invalid, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 12, true)                              \
+    C(true, CipherSuite::AES_256_GCM_SHA384, KeyExchangeAlgorithm::Invalid, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 12, true)                              \
+    C(true, CipherSuite::CHACHA20_POLY1305_SHA256, KeyExchangeAlgorithm::Invalid, CipherAlgorithm::CHACHA20_POLY1305, Crypto::Hash::SHA256, 12, true)
 
 constexpr KeyExchangeAlgorithm get_key_exchange_algorithm(CipherSuite suite)
 {
@@ -238,7 +258,12 @@ struct Options {
     }
 
     OPTION_WITH_DEFAULTS(Version, version, Version::V12)
+    // TLS 1.3 is offered on top of `version` through the supported_versions extension, unless this is lowered.
+    OPTION_WITH_DEFAULTS(Version, maximum_version, Version::V13)
     OPTION_WITH_DEFAULTS(Vector<SignatureAndHashAlgorithm>, supported_signature_algorithms,
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA256 },
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA384 },
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA512 },
         { HashAlgorithm::SHA512, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA384, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA256, SignatureAlgorithm::RSA },
@@ -258,11 +283,19 @@ struct Options {
     OPTION_WITH_DEFAULTS(Function<void()>, finish_callback, [] {})
     OPTION_WITH_DEFAULTS(Function<Vector<Certificate>()>, certificate_provider, [] { return Vector<Certificate> {}; })
 
+    // Sessions are only resumed when the connection has a cache and a key to look itself up with.
+    // connect() with a host and a port uses "host:port" as the key if none was given.
+    OPTION_WITH_DEFAULTS(RefPtr<SessionCache>, session_cache, )
+    OPTION_WITH_DEFAULTS(String, session_cache_key, )
+
+    // Application protocols to offer through ALPN, most preferred first. alpn() tells which one the server picked.
+    OPTION_WITH_DEFAULTS(Vector<String>, alpn_protocols, )
+
 #undef OPTION_WITH_DEFAULTS
 };
 
 struct Context {
-    bool verify_chain(StringView host) const;
+    bool verify_chain(StringView host);
     bool verify_certificate_pair(Certificate const& subject, Certificate const& issuer) const;
 
     Options options;
@@ -271,6 +304,10 @@ struct Context {
     u8 local_random[32];
     u8 session_id[32];
     u8 session_id_size { 0 };
+    ByteBuffer session_ticket;
+    u32 session_ticket_lifetime_hint { 0 };
+    Optional<Session> offered_session;
+    bool is_resumed_session { false };
     CipherSuite cipher;
     bool is_server { false };
     Vector<Certificate> certificates;
@@ -285,8 +322,9 @@ struct Context {
         u8 local_mac[32];
         u8 local_iv[16];
         u8 remote_iv[16];
-        u8 local_aead_iv[4];
-        u8 remote_aead_iv[4];
+        // AES-GCM only uses the first 4 bytes, ChaCha20-Poly1305 uses all 12.
+        u8 local_aead_iv[12];
+        u8 remote_aead_iv[12];
     } crypto;
 
     Crypto::Hash::Manager handshake_hash;
@@ -321,12 +359,12 @@ struct Context {
     bool has_invoked_finish_or_error_callback { false };
 
     // message flags
-    u8 handshake_messages[11] { 0 };
+    u8 handshake_messages[13] { 0 };
     ByteBuffer user_data;
-    HashMap<String, Certificate> root_certificates;
+    RefPtr<TrustStore> root_certificates;
 
     Vector<String> alpn;
-    StringView negotiated_alpn;
+    String negotiated_alpn;
 
     size_t send_retries { 0 };
 
@@ -339,6 +377,35 @@ struct Context {
     } server_diffie_hellman_params;
 
     OwnPtr<Crypto::Curves::EllipticCurve> server_key_exchange_curve;
+
+    // Set once the server picked TLS 1.3, everything in `tls13` only applies from then on.
+    bool is_tls13 { false };
+    struct {
+        NamedCurve key_share_group { NamedCurve::x25519 };
+        OwnPtr<Crypto::Curves::EllipticCurve> key_share_curve;
+        ByteBuffer key_share_private_key;
+
+        // What the server told us in its ServerHello or HelloRetryRequest.
+        Optional<Version> selected_version;
+        Optional<NamedCurve> requested_group;
+        NamedCurve server_key_share_group { NamedCurve::x25519 };
+        ByteBuffer server_key_share;
+        Optional<u16> selected_identity;
+        ByteBuffer cookie;
+
+        bool did_retry_hello { false };
+        bool is_hello_retry_pending { false };
+        CipherSuite hello_retry_cipher { CipherSuite::Invalid };
+        bool is_psk_offered { false };
+        bool is_psk_accepted { false };
+        bool is_certificate_requested { false };
+        ByteBuffer certificate_request_context;
+
+        ByteBuffer handshake_secret;
+        ByteBuffer client_traffic_secret;
+        ByteBuffer server_traffic_secret;
+        ByteBuffer resumption_master_secret;
+    } tls13;
 };
 
 class TLSv12 final : public Core::Stream::Socket {
@@ -386,10 +453,15 @@ public:
     static ErrorOr<NonnullOwnPtr<TLSv12>> connect(String const& host, u16 port, Options = {});
     static ErrorOr<NonnullOwnPtr<TLSv12>> connect(String const& host, Core::Stream::Socket& underlying_stream, Options = {});
 
+    // Takes over an already connected socket and starts the handshake, without waiting for it to finish.
+    // The callback is invoked from the event loop once the connection is established or has failed.
+    static ErrorOr<NonnullOwnPtr<TLSv12>> connect_async(String const& host, NonnullOwnPtr<Core::Stream::Socket> underlying_stream, Options, Function<void(ErrorOr<void>)> on_complete);
+
     using StreamVariantType = Variant<OwnPtr<Core::Stream::Socket>, Core::Stream::Socket*>;
     explicit TLSv12(StreamVariantType, Options);
 
     bool is_established() const { return m_context.connection_status == ConnectionStatus::Established; }
+    bool is_resumed_session() const { return m_context.is_resumed_session; }
 
     void set_sni(StringView sni)
     {
@@ -431,6 +503,12 @@ public:
         return v == Version::V12;
     }
 
+    static constexpr bool is_tls13_cipher_suite(CipherSuite suite)
+    {
+        // RFC 8446 section B.4: All TLS 1.3 cipher suites live in {0x13, *}.
+        return ((u16)suite & 0xff00) == 0x1300;
+    }
+
     void alert(AlertLevel, AlertDescription);
 
     bool can_read_line() const { return m_context.application_buffer.size() && memchr(m_context.application_buffer.data(), '\n', m_context.application_buffer.size()); }
@@ -477,12 +555,14 @@ private:
     void notify_client_for_app_data();
 
     ssize_t handle_server_hello(ReadonlyBytes, WritePacketStage&);
+    bool handle_alpn_extension(ReadonlyBytes);
     ssize_t handle_handshake_finished(ReadonlyBytes, WritePacketStage&);
     ssize_t handle_certificate(ReadonlyBytes);
     ssize_t handle_server_key_exchange(ReadonlyBytes);
     ssize_t handle_dhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_server_hello_done(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
@@ -491,6 +571,40 @@ private:
     void pseudorandom_function(Bytes output, ReadonlyBytes secret, u8 const* label, size_t label_length, ReadonlyBytes seed, ReadonlyBytes seed_b);
 
     ssize_t verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buffer, ReadonlyBytes signature_buffer);
+    ssize_t verify_rsa_signature(SignatureAndHashAlgorithm, ReadonlyBytes message, ReadonlyBytes signature);
+
+    static OwnPtr<Crypto::Curves::EllipticCurve> create_elliptic_curve(NamedCurve);
+
+    // TLS 1.3 (RFC 8446), see TLSv13.cpp
+    bool is_offering_tls13() const;
+    bool is_hello_retry_request_random() const;
+    bool is_downgraded_from_tls13() const;
+    ErrorOr<ByteBuffer> build_tls13_hello_extensions();
+    ErrorOr<void> write_tls13_psk_binder(ByteBuffer& client_hello);
+    ssize_t handle_tls13_server_hello_extension(HandshakeExtension, ReadonlyBytes, bool is_hello_retry_request);
+    ssize_t handle_tls13_server_hello(bool is_hello_retry_request, bool is_session_id_echoed);
+    ssize_t handle_tls13_handshake_message(u8 type, ReadonlyBytes);
+    ssize_t handle_tls13_encrypted_extensions(ReadonlyBytes);
+    ssize_t handle_tls13_certificate_request(ReadonlyBytes);
+    ssize_t handle_tls13_certificate(ReadonlyBytes);
+    ssize_t handle_tls13_certificate_verify(ReadonlyBytes);
+    ssize_t handle_tls13_finished(ReadonlyBytes);
+    ssize_t handle_tls13_new_session_ticket(ReadonlyBytes);
+    ssize_t handle_tls13_key_update(ReadonlyBytes);
+    ssize_t advance_tls13_key_schedule(u8 handshake_type);
+    ErrorOr<void> derive_tls13_handshake_secrets();
+    ErrorOr<void> finish_tls13_handshake();
+    ByteBuffer build_tls13_certificate();
+    ErrorOr<ByteBuffer> build_tls13_handshake_finished();
+    ErrorOr<ByteBuffer> build_tls13_key_update();
+    void update_tls13_packet(ByteBuffer& packet);
+    ssize_t decrypt_tls13_record(ReadonlyBytes record, ByteBuffer& plaintext);
+
+    enum class TrafficDirection {
+        Local,
+        Remote,
+    };
+    ErrorOr<void> set_tls13_traffic_secret(TrafficDirection, ByteBuffer secret);
 
     size_t key_length() const
     {
@@ -563,6 +677,11 @@ private:
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
     void try_disambiguate_error() const;
+    void did_finish_async_connect(ErrorOr<void>);
+
+    void did_establish_connection();
+    void store_session_in_cache();
+    void forget_cached_session();
 
     bool m_eof { false };
     StreamVariantType m_stream;
@@ -574,7 +693,8 @@ private:
     using CipherVariant = Variant<
         Empty,
         Crypto::Cipher::AESCipher::CBCMode,
-        Crypto::Cipher::AESCipher::GCMMode>;
+        Crypto::Cipher::AESCipher::GCMMode,
+        Crypto::Cipher::ChaCha20Poly1305>;
     CipherVariant m_cipher_local {};
     CipherVariant m_cipher_remote {};
 
@@ -583,6 +703,7 @@ private:
     i32 m_max_wait_time_for_handshake_in_seconds { 10 };
 
     RefPtr<Core::Timer> m_handshake_timeout_timer;
+    Function<void(ErrorOr<void>)> m_on_async_connect_complete;
 };
 
 }
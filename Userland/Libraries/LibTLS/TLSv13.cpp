@@ -0,0 +1,1040 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <AK/Memory.h>
+#include <AK/Time.h>
+#include <LibCore/DateTime.h>
+#include <LibCrypto/Hash/HKDF.h>
+#include <LibTLS/TLSv12.h>
+
+namespace TLS {
+
+using HKDF = Crypto::Hash::HKDF<Crypto::Hash::Manager>;
+
+// RFC 8446 section 4.1.3: A HelloRetryRequest is a ServerHello with SHA-256("HelloRetryRequest") as its random.
+static constexpr u8 hello_retry_request_random[32] = {
+    0xCF, 0x21, 0xAD, 0x74, 0xE5, 0x9A, 0x61, 0x11, 0xBE, 0x1D, 0x8C, 0x02, 0x1E, 0x65, 0xB8, 0x91,
+    0xC2, 0xA2, 0x11, 0x16, 0x7A, 0xBB, 0x8C, 0x5E, 0x07, 0x9E, 0x09, 0xE2, 0xC8, 0xA8, 0x33, 0x9C
+};
+
+// RFC 8446 section 4.1.3: A TLS 1.3 server that negotiates TLS 1.2 puts this into the last 8 bytes of its random.
+static constexpr u8 tls12_downgrade_sentinel[8] = { 'D', 'O', 'W', 'N', 'G', 'R', 'D', 0x01 };
+
+// RFC 8446 section 4.2.9: We only ever resume with a fresh (EC)DHE exchange.
+static constexpr u8 psk_dhe_ke_mode = 1;
+
+// RFC 8446 section 5.3: All of the cipher suites we support use a 12 byte nonce and a 16 byte tag.
+static constexpr size_t aead_nonce_size = 12;
+static constexpr size_t aead_tag_size = 16;
+
+static constexpr size_t record_header_size = 5;
+
+static u16 read_u16(ReadonlyBytes buffer, size_t offset)
+{
+    return AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(offset)));
+}
+
+static u32 read_u24(ReadonlyBytes buffer, size_t offset)
+{
+    return buffer[offset] * 0x10000 + buffer[offset + 1] * 0x100 + buffer[offset + 2];
+}
+
+static u32 read_u32(ReadonlyBytes buffer, size_t offset)
+{
+    return AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(offset)));
+}
+
+static ErrorOr<void> append_u8(ByteBuffer& buffer, u8 value)
+{
+    return buffer.try_append(&value, sizeof(value));
+}
+
+static ErrorOr<void> append_u16(ByteBuffer& buffer, u16 value)
+{
+    u8 bytes[] { (u8)(value >> 8), (u8)value };
+    return buffer.try_append(bytes, sizeof(bytes));
+}
+
+static ErrorOr<void> append_u32(ByteBuffer& buffer, u32 value)
+{
+    u8 bytes[] { (u8)(value >> 24), (u8)(value >> 16), (u8)(value >> 8), (u8)value };
+    return buffer.try_append(bytes, sizeof(bytes));
+}
+
+// RFC 8446 appendix B.4
+static Crypto::Hash::HashKind hash_for_cipher_suite(CipherSuite suite)
+{
+    if (suite == CipherSuite::AES_256_GCM_SHA384)
+        return Crypto::Hash::HashKind::SHA384;
+    return Crypto::Hash::HashKind::SHA256;
+}
+
+static Crypto::Hash::Manager::DigestType hash_of_nothing(Crypto::Hash::HashKind hash)
+{
+    return Crypto::Hash::Manager(hash).peek();
+}
+
+static ErrorOr<ByteBuffer> hkdf_extract(Crypto::Hash::HashKind hash, ReadonlyBytes salt, ReadonlyBytes input_keying_material)
+{
+    auto pseudorandom_key = HKDF::extract(salt, input_keying_material, hash);
+    return ByteBuffer::copy(pseudorandom_key.bytes());
+}
+
+// RFC 8446 section 7.1:
+//     HKDF-Expand-Label(Secret, Label, Context, Length) = HKDF-Expand(Secret, HkdfLabel, Length)
+//     struct {
+//         uint16 length = Length;
+//         opaque label<7..255> = "tls13 " + Label;
+//         opaque context<0..255> = Context;
+//     } HkdfLabel;
+static ErrorOr<ByteBuffer> hkdf_expand_label(Crypto::Hash::HashKind hash, ReadonlyBytes secret, StringView label, ReadonlyBytes context, size_t length)
+{
+    constexpr auto label_prefix = "tls13 "sv;
+
+    ByteBuffer hkdf_label;
+    TRY(append_u16(hkdf_label, length));
+    TRY(append_u8(hkdf_label, label_prefix.length() + label.length()));
+    TRY(hkdf_label.try_append(label_prefix.bytes()));
+    TRY(hkdf_label.try_append(label.bytes()));
+    TRY(append_u8(hkdf_label, context.size()));
+    TRY(hkdf_label.try_append(context));
+
+    auto output = TRY(ByteBuffer::create_uninitialized(length));
+    TRY(HKDF::expand(secret, hkdf_label, output, hash));
+    return output;
+}
+
+// RFC 8446 section 7.1: Derive-Secret(Secret, Label, Messages), with the messages already hashed.
+static ErrorOr<ByteBuffer> derive_secret(Crypto::Hash::HashKind hash, ReadonlyBytes secret, StringView label, ReadonlyBytes transcript_hash)
+{
+    return hkdf_expand_label(hash, secret, label, transcript_hash, transcript_hash.size());
+}
+
+// RFC 8446 section 4.4.4: Finished messages and PSK binders are an HMAC over the transcript, keyed with a secret derived from a base key.
+static ErrorOr<ByteBuffer> compute_verify_data(Crypto::Hash::HashKind hash, ReadonlyBytes base_key, ReadonlyBytes transcript_hash)
+{
+    auto finished_key = TRY(hkdf_expand_label(hash, base_key, "finished"sv, {}, transcript_hash.size()));
+    Crypto::Authentication::HMAC<Crypto::Hash::Manager> hmac(ReadonlyBytes { finished_key }, hash);
+    auto verify_data = hmac.process(transcript_hash);
+    return ByteBuffer::copy(verify_data.bytes());
+}
+
+// RFC 8446 section 5.3: The per-record nonce is the IV XORed with the sequence number.
+// Our GCM implementation takes a 16 byte IV, with the block counter in the last 4 bytes, ChaCha20-Poly1305 only uses the first 12.
+static void compute_record_nonce(u8 const* iv, u64 sequence_number, Bytes nonce)
+{
+    VERIFY(nonce.size() == 16);
+    __builtin_memcpy(nonce.data(), iv, aead_nonce_size);
+    for (size_t i = 0; i < sizeof(sequence_number); ++i)
+        nonce[aead_nonce_size - 1 - i] ^= (u8)(sequence_number >> (8 * i));
+    __builtin_memset(nonce.offset(aead_nonce_size), 0, nonce.size() - aead_nonce_size);
+}
+
+bool TLSv12::is_offering_tls13() const
+{
+    if (m_context.options.maximum_version != Version::V13)
+        return false;
+
+    for (auto suite : m_context.options.usable_cipher_suites) {
+        if (is_tls13_cipher_suite(suite))
+            return true;
+    }
+    return false;
+}
+
+bool TLSv12::is_hello_retry_request_random() const
+{
+    return memcmp(m_context.remote_random, hello_retry_request_random, sizeof(hello_retry_request_random)) == 0;
+}
+
+bool TLSv12::is_downgraded_from_tls13() const
+{
+    auto sentinel_offset = sizeof(m_context.remote_random) - sizeof(tls12_downgrade_sentinel);
+    return is_offering_tls13() && memcmp(m_context.remote_random + sentinel_offset, tls12_downgrade_sentinel, sizeof(tls12_downgrade_sentinel)) == 0;
+}
+
+ErrorOr<ByteBuffer> TLSv12::build_tls13_hello_extensions()
+{
+    auto& tls13 = m_context.tls13;
+    tls13.is_psk_offered = false;
+
+    // After a HelloRetryRequest, the key share is for whatever group the server asked for.
+    if (!tls13.did_retry_hello) {
+        Optional<NamedCurve> group;
+        for (auto curve : m_context.options.elliptic_curves) {
+            if (create_elliptic_curve(curve)) {
+                group = curve;
+                break;
+            }
+        }
+        if (!group.has_value())
+            return AK::Error::from_string_literal("No supported group to send a key share for");
+        tls13.key_share_group = group.release_value();
+    }
+
+    tls13.key_share_curve = create_elliptic_curve(tls13.key_share_group);
+    tls13.key_share_private_key = TRY(tls13.key_share_curve->generate_private_key());
+    auto public_key = TRY(tls13.key_share_curve->generate_public_key(tls13.key_share_private_key));
+
+    ByteBuffer extensions;
+
+    // RFC 8446 section 4.2.1: supported_versions, in order of preference.
+    TRY(append_u16(extensions, (u16)HandshakeExtension::SupportedVersions));
+    TRY(append_u16(extensions, 5));
+    TRY(append_u8(extensions, 4));
+    TRY(append_u16(extensions, (u16)Version::V13));
+    TRY(append_u16(extensions, (u16)Version::V12));
+
+    // RFC 8446 section 4.2.8: key_share, with a single KeyShareEntry.
+    TRY(append_u16(extensions, (u16)HandshakeExtension::KeyShare));
+    TRY(append_u16(extensions, 2 + 2 + 2 + public_key.size()));
+    TRY(append_u16(extensions, 2 + 2 + public_key.size()));
+    TRY(append_u16(extensions, (u16)tls13.key_share_group));
+    TRY(append_u16(extensions, public_key.size()));
+    TRY(extensions.try_append(public_key));
+
+    // RFC 8446 section 4.2.2: A cookie from a HelloRetryRequest is sent right back.
+    if (!tls13.cookie.is_empty()) {
+        TRY(append_u16(extensions, (u16)HandshakeExtension::Cookie));
+        TRY(append_u16(extensions, 2 + tls13.cookie.size()));
+        TRY(append_u16(extensions, tls13.cookie.size()));
+        TRY(extensions.try_append(tls13.cookie));
+    }
+
+    bool use_session_cache = m_context.options.session_cache && !m_context.options.session_cache_key.is_empty();
+    if (!use_session_cache)
+        return extensions;
+
+    // RFC 8446 section 4.2.9: Servers only send tickets to clients that tell them how they'd like to use them.
+    TRY(append_u16(extensions, (u16)HandshakeExtension::PSKKeyExchangeModes));
+    TRY(append_u16(extensions, 2));
+    TRY(append_u8(extensions, 1));
+    TRY(append_u8(extensions, psk_dhe_ke_mode));
+
+    // Simplification: We don't offer the session again after a HelloRetryRequest.
+    auto& session = m_context.offered_session;
+    if (tls13.did_retry_hello || !session.has_value() || session->version != Version::V13)
+        return extensions;
+
+    // RFC 8446 section 4.2.11: pre_shared_key has to be the last extension, the binder is filled in by write_tls13_psk_binder().
+    auto binder_length = Crypto::Hash::Manager(hash_for_cipher_suite(session->cipher)).digest_size();
+    u32 ticket_age = Time::now_realtime().to_milliseconds() - session->ticket_received_timestamp_ms;
+    u32 obfuscated_ticket_age = ticket_age + session->ticket_age_add;
+
+    TRY(append_u16(extensions, (u16)HandshakeExtension::PreSharedKey));
+    TRY(append_u16(extensions, 2 + 2 + session->ticket.size() + 4 + 2 + 1 + binder_length));
+    TRY(append_u16(extensions, 2 + session->ticket.size() + 4));
+    TRY(append_u16(extensions, session->ticket.size()));
+    TRY(extensions.try_append(session->ticket));
+    TRY(append_u32(extensions, obfuscated_ticket_age));
+    TRY(append_u16(extensions, 1 + binder_length));
+    TRY(append_u8(extensions, binder_length));
+    auto binder_offset = extensions.size();
+    TRY(extensions.try_resize(binder_offset + binder_length));
+    __builtin_memset(extensions.offset_pointer(binder_offset), 0, binder_length);
+
+    dbgln_if(TLS_DEBUG, "Offering a PSK to resume the session for {}", m_context.options.session_cache_key);
+    tls13.is_psk_offered = true;
+    return extensions;
+}
+
+ErrorOr<void> TLSv12::write_tls13_psk_binder(ByteBuffer& client_hello)
+{
+    VERIFY(m_context.offered_session.has_value());
+    auto& session = *m_context.offered_session;
+    auto hash = hash_for_cipher_suite(session.cipher);
+
+    // RFC 8446 section 4.2.11.2: The binder covers the ClientHello up to, but not including, the list of binders,
+    // which is the very last thing in the packet.
+    Crypto::Hash::Manager transcript(hash);
+    auto binder_length = transcript.digest_size();
+    auto binders_size = 2 + 1 + binder_length;
+    VERIFY(client_hello.size() > record_header_size + binders_size);
+    transcript.update(client_hello.bytes().slice(record_header_size, client_hello.size() - record_header_size - binders_size));
+    auto truncated_hello_hash = transcript.digest();
+
+    auto early_secret = TRY(hkdf_extract(hash, {}, session.master_key));
+    auto binder_key = TRY(derive_secret(hash, early_secret, "res binder"sv, hash_of_nothing(hash).bytes()));
+    auto binder = TRY(compute_verify_data(hash, binder_key, truncated_hello_hash.bytes()));
+    client_hello.overwrite(client_hello.size() - binder_length, binder.data(), binder.size());
+    return {};
+}
+
+ssize_t TLSv12::handle_tls13_server_hello_extension(HandshakeExtension type, ReadonlyBytes data, bool is_hello_retry_request)
+{
+    auto& tls13 = m_context.tls13;
+    if (!is_offering_tls13()) {
+        dbgln("Server sent TLS 1.3 extension {} that we didn't offer", (u16)type);
+        return (i8)Error::NotSafe;
+    }
+
+    switch (type) {
+    case HandshakeExtension::SupportedVersions:
+        if (data.size() != 2)
+            return (i8)Error::BrokenPacket;
+        tls13.selected_version = (Version)read_u16(data, 0);
+        break;
+    case HandshakeExtension::KeyShare:
+        // RFC 8446 section 4.2.8: A HelloRetryRequest only names a group, a ServerHello has a KeyShareEntry.
+        if (is_hello_retry_request) {
+            if (data.size() != 2)
+                return (i8)Error::BrokenPacket;
+            tls13.requested_group = (NamedCurve)read_u16(data, 0);
+            break;
+        }
+        if (data.size() < 4 || data.size() != 4u + read_u16(data, 2))
+            return (i8)Error::BrokenPacket;
+        tls13.server_key_share_group = (NamedCurve)read_u16(data, 0);
+        if (auto key_share = ByteBuffer::copy(data.slice(4)); !key_share.is_error()) {
+            tls13.server_key_share = key_share.release_value();
+        } else {
+            return (i8)Error::OutOfMemory;
+        }
+        break;
+    case HandshakeExtension::PreSharedKey:
+        if (data.size() != 2)
+            return (i8)Error::BrokenPacket;
+        tls13.selected_identity = read_u16(data, 0);
+        break;
+    case HandshakeExtension::Cookie:
+        if (!is_hello_retry_request) {
+            dbgln("Server sent a cookie outside of a HelloRetryRequest");
+            return (i8)Error::UnexpectedMessage;
+        }
+        if (data.size() < 3 || data.size() != 2u + read_u16(data, 0))
+            return (i8)Error::BrokenPacket;
+        if (auto cookie = ByteBuffer::copy(data.slice(2)); !cookie.is_error()) {
+            tls13.cookie = cookie.release_value();
+        } else {
+            return (i8)Error::OutOfMemory;
+        }
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    return 0;
+}
+
+ssize_t TLSv12::handle_tls13_server_hello(bool is_hello_retry_request, bool is_session_id_echoed)
+{
+    auto& tls13 = m_context.tls13;
+    if (!tls13.selected_version.has_value() || tls13.selected_version.value() != Version::V13) {
+        dbgln("Server sent a TLS 1.3 ServerHello without picking TLS 1.3");
+        return (i8)Error::NotSafe;
+    }
+
+    // RFC 8446 section 4.1.3: legacy_session_id_echo has to be exactly what we sent.
+    if (!is_session_id_echoed) {
+        dbgln("Server didn't echo our session ID");
+        return (i8)Error::NotSafe;
+    }
+
+    if (!is_tls13_cipher_suite(m_context.cipher) || !m_context.options.usable_cipher_suites.contains_slow(m_context.cipher)) {
+        dbgln("Server picked cipher suite {} for TLS 1.3", (u16)m_context.cipher);
+        return (i8)Error::NoCommonCipher;
+    }
+
+    m_context.is_tls13 = true;
+
+    if (is_hello_retry_request) {
+        if (tls13.did_retry_hello) {
+            dbgln("Server sent a second HelloRetryRequest");
+            return (i8)Error::UnexpectedMessage;
+        }
+
+        // RFC 8446 section 4.1.4: The HelloRetryRequest has to ask for something that changes the ClientHello.
+        if (tls13.requested_group.has_value()) {
+            auto group = tls13.requested_group.value();
+            if (group == tls13.key_share_group || !m_context.options.elliptic_curves.contains_slow(group) || !create_elliptic_curve(group)) {
+                dbgln("Server asked for a key share for group {}, which we can't give it", (u16)group);
+                return (i8)Error::NotSafe;
+            }
+            tls13.key_share_group = group;
+        } else if (tls13.cookie.is_empty()) {
+            dbgln("Server sent a HelloRetryRequest that doesn't ask for anything");
+            return (i8)Error::NotSafe;
+        }
+
+        tls13.did_retry_hello = true;
+        tls13.is_hello_retry_pending = true;
+        tls13.hello_retry_cipher = m_context.cipher;
+
+        // RFC 8446 section 4.4.1: The first ClientHello is replaced by a synthetic message_hash message in the transcript.
+        // The empty update makes sure whatever was hashed before the hash function was picked is part of it.
+        m_context.handshake_hash.update(ReadonlyBytes {});
+        auto client_hello_hash = m_context.handshake_hash.digest();
+        u8 message_hash_header[4] { (u8)HandshakeType::MessageHash, 0, 0, (u8)client_hello_hash.data_length() };
+        m_context.handshake_hash.update(message_hash_header, sizeof(message_hash_header));
+        m_context.handshake_hash.update(client_hello_hash.bytes());
+
+        // The real ServerHello comes next, and has to pick everything all over again.
+        m_context.handshake_messages[2] = 0;
+        m_context.offered_session.clear();
+        tls13.selected_version.clear();
+        tls13.requested_group.clear();
+        return 0;
+    }
+
+    if (tls13.did_retry_hello && m_context.cipher != tls13.hello_retry_cipher) {
+        dbgln("Server picked a different cipher suite after its HelloRetryRequest");
+        return (i8)Error::NotSafe;
+    }
+
+    // Simplification: We only do (EC)DHE key exchanges, also when resuming a session.
+    if (tls13.server_key_share.is_empty()
+        || tls13.server_key_share_group != tls13.key_share_group
+        || tls13.server_key_share.size() != tls13.key_share_curve->key_size()) {
+        dbgln("Server didn't send a usable key share");
+        return (i8)Error::NotSafe;
+    }
+
+    if (tls13.selected_identity.has_value()) {
+        if (!tls13.is_psk_offered || tls13.selected_identity.value() != 0 || hash_for_cipher_suite(m_context.offered_session->cipher) != hmac_hash()) {
+            dbgln("Server picked a PSK that we didn't offer");
+            return (i8)Error::NotSafe;
+        }
+        dbgln_if(TLS_DEBUG, "Resuming the session for {}", m_context.options.session_cache_key);
+        tls13.is_psk_accepted = true;
+        m_context.is_resumed_session = true;
+        m_context.options.session_cache->did_resume_session();
+    } else if (m_context.offered_session.has_value()) {
+        dbgln_if(TLS_DEBUG, "Server turned down the session for {}", m_context.options.session_cache_key);
+        m_context.options.session_cache->did_reject_session(m_context.options.session_cache_key);
+        m_context.offered_session.clear();
+    }
+
+    return 0;
+}
+
+ssize_t TLSv12::handle_tls13_handshake_message(u8 type, ReadonlyBytes buffer)
+{
+    auto& tls13 = m_context.tls13;
+    auto& received = m_context.handshake_messages;
+
+    if (m_context.connection_status == ConnectionStatus::Established) {
+        switch (type) {
+        case NewSessionTicket:
+            return handle_tls13_new_session_ticket(buffer);
+        case KeyUpdate:
+            return handle_tls13_key_update(buffer);
+        default:
+            dbgln("unexpected post-handshake message {}", type);
+            return (i8)Error::UnexpectedMessage;
+        }
+    }
+
+    // RFC 8446 section 2: EncryptedExtensions, then CertificateRequest, Certificate and CertificateVerify unless
+    // we're resuming a session, and then Finished. All of them are encrypted.
+    if (!m_context.cipher_spec_set) {
+        dbgln("unexpected unencrypted handshake message {}", type);
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    switch (type) {
+    case EncryptedExtensions:
+        if (received[12] == 0) {
+            ++received[12];
+            return handle_tls13_encrypted_extensions(buffer);
+        }
+        break;
+    case CertificateRequest:
+        if (received[12] && !received[6] && !received[4] && !tls13.is_psk_accepted) {
+            ++received[6];
+            return handle_tls13_certificate_request(buffer);
+        }
+        break;
+    case CertificateMessage:
+        if (received[12] && !received[4] && !tls13.is_psk_accepted) {
+            ++received[4];
+            return handle_tls13_certificate(buffer);
+        }
+        break;
+    case CertificateVerify:
+        if (received[4] && !received[8]) {
+            ++received[8];
+            return handle_tls13_certificate_verify(buffer);
+        }
+        break;
+    case Finished:
+        if (received[12] && !received[10] && (received[8] || tls13.is_psk_accepted)) {
+            ++received[10];
+            return handle_tls13_finished(buffer);
+        }
+        break;
+    default:
+        break;
+    }
+
+    dbgln("unexpected handshake message {}", type);
+    return (i8)Error::UnexpectedMessage;
+}
+
+ssize_t TLSv12::handle_tls13_encrypted_extensions(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 5)
+        return (i8)Error::BrokenPacket;
+
+    auto size = read_u24(buffer, 0);
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    auto extensions_length = read_u16(buffer, 3);
+    if (extensions_length + 2u != size)
+        return (i8)Error::BrokenPacket;
+
+    // The only thing we ask for that ends up in here is the application protocol.
+    auto extensions = buffer.slice(5, extensions_length);
+    while (!extensions.is_empty()) {
+        if (extensions.size() < 4)
+            return (i8)Error::BrokenPacket;
+        auto extension_type = (HandshakeExtension)read_u16(extensions, 0);
+        auto extension_length = read_u16(extensions, 2);
+        if (extensions.size() - 4 < extension_length)
+            return (i8)Error::BrokenPacket;
+
+        if (extension_type == HandshakeExtension::ApplicationLayerProtocolNegotiation && !m_context.alpn.is_empty()) {
+            if (!handle_alpn_extension(extensions.slice(4, extension_length)))
+                return (i8)Error::BrokenPacket;
+        }
+        extensions = extensions.slice(4 + extension_length);
+    }
+
+    return size + 3;
+}
+
+ssize_t TLSv12::handle_tls13_certificate_request(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 4)
+        return (i8)Error::BrokenPacket;
+
+    auto size = read_u24(buffer, 0);
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    auto context_length = buffer[3];
+    if (size < 1u + context_length + 2)
+        return (i8)Error::BrokenPacket;
+
+    // The certificate_request_context has to be echoed in our Certificate message.
+    auto context = ByteBuffer::copy(buffer.slice(4, context_length));
+    if (context.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.tls13.certificate_request_context = context.release_value();
+    m_context.tls13.is_certificate_requested = true;
+
+    dbgln_if(TLS_DEBUG, "Server asked for a client certificate, we'll send an empty one");
+    return size + 3;
+}
+
+ssize_t TLSv12::handle_tls13_certificate(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 4)
+        return (i8)Error::BrokenPacket;
+
+    auto size = read_u24(buffer, 0);
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    // RFC 8446 section 4.4.2:
+    //     struct {
+    //         opaque certificate_request_context<0..2^8-1>;
+    //         CertificateEntry certificate_list<0..2^24-1>;
+    //     } Certificate;
+    auto message = buffer.slice(3, size);
+    size_t offset = 1 + message[0];
+    if (message.size() < offset + 3)
+        return (i8)Error::BrokenPacket;
+
+    auto list_length = read_u24(message, offset);
+    offset += 3;
+    if (message.size() - offset != list_length)
+        return (i8)Error::BrokenPacket;
+
+    while (offset < message.size()) {
+        // struct {
+        //     opaque cert_data<1..2^24-1>;
+        //     Extension extensions<0..2^16-1>;
+        // } CertificateEntry;
+        if (message.size() - offset < 3)
+            return (i8)Error::BrokenPacket;
+        auto certificate_length = read_u24(message, offset);
+        offset += 3;
+        if (message.size() - offset < certificate_length + 2u)
+            return (i8)Error::BrokenPacket;
+
+        auto certificate = Certificate::parse_asn1(message.slice(offset, certificate_length), false);
+        if (certificate.has_value())
+            m_context.certificates.append(certificate.release_value());
+        offset += certificate_length;
+
+        auto extensions_length = read_u16(message, offset);
+        offset += 2;
+        if (message.size() - offset < extensions_length)
+            return (i8)Error::BrokenPacket;
+        offset += extensions_length;
+    }
+
+    if (m_context.certificates.is_empty()) {
+        dbgln("Server didn't send any certificate we understand");
+        return (i8)Error::UnsupportedCertificate;
+    }
+
+    return size + 3;
+}
+
+ssize_t TLSv12::handle_tls13_certificate_verify(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 7)
+        return (i8)Error::BrokenPacket;
+
+    auto size = read_u24(buffer, 0);
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    SignatureAndHashAlgorithm algorithm { (HashAlgorithm)buffer[3], (SignatureAlgorithm)buffer[4] };
+    auto signature_length = read_u16(buffer, 5);
+    if (size != 4u + signature_length)
+        return (i8)Error::BrokenPacket;
+
+    // RFC 8446 section 4.4.3: RSA signatures have to use RSASSA-PSS, even if the certificates use PKCS#1 v1.5.
+    if (algorithm.hash != HashAlgorithm::INTRINSIC) {
+        dbgln("Server signed its CertificateVerify with {}/{}, which isn't allowed in TLS 1.3", (u8)algorithm.hash, (u8)algorithm.signature);
+        return (i8)Error::NotSafe;
+    }
+
+    if (!m_context.verify_chain(m_context.extensions.SNI)) {
+        dbgln("certificate verification failed :(");
+        return (i8)Error::BadCertificate;
+    }
+
+    // The signature covers 64 spaces, a context string, a zero byte, and the transcript up to the Certificate message.
+    constexpr auto context_string = "TLS 1.3, server CertificateVerify"sv;
+    auto transcript_hash = m_context.handshake_hash.peek();
+    auto content_result = ByteBuffer::create_uninitialized(64 + context_string.length() + 1 + transcript_hash.data_length());
+    if (content_result.is_error())
+        return (i8)Error::OutOfMemory;
+    auto content = content_result.release_value();
+    __builtin_memset(content.data(), 0x20, 64);
+    content.overwrite(64, context_string.characters_without_null_termination(), context_string.length());
+    content[64 + context_string.length()] = 0;
+    content.overwrite(64 + context_string.length() + 1, transcript_hash.immutable_data(), transcript_hash.data_length());
+
+    auto result = verify_rsa_signature(algorithm, content, buffer.slice(7, signature_length));
+    if (result < 0)
+        return result;
+
+    return size + 3;
+}
+
+ssize_t TLSv12::handle_tls13_finished(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 3)
+        return (i8)Error::BrokenPacket;
+
+    auto size = read_u24(buffer, 0);
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    auto expected_verify_data = compute_verify_data(hmac_hash(), m_context.tls13.server_traffic_secret, m_context.handshake_hash.peek().bytes());
+    if (expected_verify_data.is_error())
+        return (i8)Error::OutOfMemory;
+
+    auto& verify_data = expected_verify_data.value();
+    if (size != verify_data.size() || !timing_safe_compare(buffer.offset_pointer(3), verify_data.data(), size)) {
+        dbgln("Server Finished message doesn't match the handshake");
+        return (i8)Error::NotSafe;
+    }
+
+    return size + 3;
+}
+
+ssize_t TLSv12::handle_tls13_new_session_ticket(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 3)
+        return (i8)Error::BrokenPacket;
+
+    auto size = read_u24(buffer, 0);
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    // RFC 8446 section 4.6.1:
+    //     struct {
+    //         uint32 ticket_lifetime;
+    //         uint32 ticket_age_add;
+    //         opaque ticket_nonce<0..255>;
+    //         opaque ticket<1..2^16-1>;
+    //         Extension extensions<0..2^16-2>;
+    //     } NewSessionTicket;
+    auto message = buffer.slice(3, size);
+    if (message.size() < 4 + 4 + 1)
+        return (i8)Error::BrokenPacket;
+
+    auto lifetime = read_u32(message, 0);
+    auto ticket_age_add = read_u32(message, 4);
+    size_t offset = 8;
+    auto nonce_length = message[offset++];
+    if (message.size() - offset < nonce_length + 2u)
+        return (i8)Error::BrokenPacket;
+    auto nonce = message.slice(offset, nonce_length);
+    offset += nonce_length;
+
+    auto ticket_length = read_u16(message, offset);
+    offset += 2;
+    if (ticket_length == 0 || message.size() - offset < ticket_length + 2u)
+        return (i8)Error::BrokenPacket;
+    auto ticket = message.slice(offset, ticket_length);
+    offset += ticket_length;
+
+    auto extensions_length = read_u16(message, offset);
+    offset += 2;
+    if (message.size() - offset != extensions_length)
+        return (i8)Error::BrokenPacket;
+
+    dbgln_if(TLS_DEBUG, "Received a TLS 1.3 session ticket of {} bytes, lifetime {}s", ticket_length, lifetime);
+
+    auto& cache = m_context.options.session_cache;
+    if (!cache || m_context.options.session_cache_key.is_empty() || lifetime == 0)
+        return size + 3;
+
+    auto pre_shared_key = hkdf_expand_label(hmac_hash(), m_context.tls13.resumption_master_secret, "resumption"sv, nonce, mac_length());
+    auto ticket_copy = ByteBuffer::copy(ticket);
+    if (pre_shared_key.is_error() || ticket_copy.is_error())
+        return (i8)Error::OutOfMemory;
+
+    Session session;
+    session.version = Version::V13;
+    session.ticket = ticket_copy.release_value();
+    session.master_key = pre_shared_key.release_value();
+    session.cipher = m_context.cipher;
+    session.ticket_age_add = ticket_age_add;
+    session.ticket_received_timestamp_ms = Time::now_realtime().to_milliseconds();
+    session.expiry_timestamp = Core::DateTime::now().timestamp() + min<time_t>(lifetime, SessionCache::MaximumSessionLifetimeInSeconds);
+    cache->store(m_context.options.session_cache_key, move(session));
+
+    return size + 3;
+}
+
+ssize_t TLSv12::handle_tls13_key_update(ReadonlyBytes buffer)
+{
+    if (buffer.size() != 4 || read_u24(buffer, 0) != 1)
+        return (i8)Error::BrokenPacket;
+
+    // RFC 8446 section 4.6.3: request_update is either update_not_requested(0) or update_requested(1).
+    auto request_update = buffer[3];
+    if (request_update > 1)
+        return (i8)Error::BrokenPacket;
+
+    auto result = [&]() -> ErrorOr<void> {
+        auto& tls13 = m_context.tls13;
+        // RFC 8446 section 7.2: application_traffic_secret_N+1 = HKDF-Expand-Label(application_traffic_secret_N, "traffic upd", "", Hash.length)
+        auto server_secret = TRY(hkdf_expand_label(hmac_hash(), tls13.server_traffic_secret, "traffic upd"sv, {}, mac_length()));
+        TRY(set_tls13_traffic_secret(TrafficDirection::Remote, move(server_secret)));
+        if (request_update == 0)
+            return {};
+
+        // Our KeyUpdate still goes out with the old keys.
+        auto packet = TRY(build_tls13_key_update());
+        write_packet(packet);
+        auto client_secret = TRY(hkdf_expand_label(hmac_hash(), tls13.client_traffic_secret, "traffic upd"sv, {}, mac_length()));
+        TRY(set_tls13_traffic_secret(TrafficDirection::Local, move(client_secret)));
+        return {};
+    }();
+
+    if (result.is_error()) {
+        dbgln("Failed to update the traffic keys: {}", result.error());
+        return (i8)Error::OutOfMemory;
+    }
+
+    return 4;
+}
+
+ssize_t TLSv12::advance_tls13_key_schedule(u8 handshake_type)
+{
+    ErrorOr<void> result = {};
+    switch (handshake_type) {
+    case ServerHello:
+        if (m_context.tls13.is_hello_retry_pending) {
+            m_context.tls13.is_hello_retry_pending = false;
+            dbgln_if(TLS_DEBUG, "> client hello, after a HelloRetryRequest");
+            auto packet = build_hello();
+            if (packet.is_empty())
+                return (i8)Error::OutOfMemory;
+            write_packet(packet);
+            return 0;
+        }
+        result = derive_tls13_handshake_secrets();
+        break;
+    case Finished:
+        result = finish_tls13_handshake();
+        break;
+    default:
+        return 0;
+    }
+
+    if (result.is_error()) {
+        dbgln("TLS 1.3 key schedule failed: {}", result.error());
+        return (i8)Error::NotSafe;
+    }
+    return 0;
+}
+
+ErrorOr<void> TLSv12::derive_tls13_handshake_secrets()
+{
+    auto& tls13 = m_context.tls13;
+    auto hash = hmac_hash();
+
+    auto shared_point = TRY(tls13.key_share_curve->compute_coordinate(tls13.key_share_private_key, tls13.server_key_share));
+    auto shared_secret = TRY(tls13.key_share_curve->derive_premaster_key(shared_point));
+
+    // RFC 8446 section 7.4.2: An all-zero X25519 or X448 output means the server sent us a point of small order.
+    bool is_all_zero = true;
+    for (auto byte : shared_secret.bytes())
+        is_all_zero &= byte == 0;
+    if (is_all_zero)
+        return AK::Error::from_string_literal("Key exchange resulted in an all-zero secret");
+
+    // RFC 8446 section 7.1: The early secret comes from the PSK, if there is one.
+    auto zeros = TRY(ByteBuffer::create_zeroed(mac_length()));
+    ReadonlyBytes pre_shared_key = tls13.is_psk_accepted ? m_context.offered_session->master_key.bytes() : zeros.bytes();
+    auto early_secret = TRY(hkdf_extract(hash, {}, pre_shared_key));
+    auto derived_secret = TRY(derive_secret(hash, early_secret, "derived"sv, hash_of_nothing(hash).bytes()));
+    tls13.handshake_secret = TRY(hkdf_extract(hash, derived_secret, shared_secret));
+
+    auto transcript_hash = m_context.handshake_hash.peek();
+    auto client_secret = TRY(derive_secret(hash, tls13.handshake_secret, "c hs traffic"sv, transcript_hash.bytes()));
+    auto server_secret = TRY(derive_secret(hash, tls13.handshake_secret, "s hs traffic"sv, transcript_hash.bytes()));
+    TRY(set_tls13_traffic_secret(TrafficDirection::Local, move(client_secret)));
+    TRY(set_tls13_traffic_secret(TrafficDirection::Remote, move(server_secret)));
+
+    // Everything from here on is encrypted.
+    m_context.cipher_spec_set = true;
+    return {};
+}
+
+ErrorOr<void> TLSv12::finish_tls13_handshake()
+{
+    auto& tls13 = m_context.tls13;
+    auto hash = hmac_hash();
+
+    auto zeros = TRY(ByteBuffer::create_zeroed(mac_length()));
+    auto derived_secret = TRY(derive_secret(hash, tls13.handshake_secret, "derived"sv, hash_of_nothing(hash).bytes()));
+    auto master_secret = TRY(hkdf_extract(hash, derived_secret, zeros));
+
+    // The application traffic secrets cover the handshake up to the server's Finished.
+    auto transcript_hash = m_context.handshake_hash.peek();
+    auto client_secret = TRY(derive_secret(hash, master_secret, "c ap traffic"sv, transcript_hash.bytes()));
+    auto server_secret = TRY(derive_secret(hash, master_secret, "s ap traffic"sv, transcript_hash.bytes()));
+    TRY(set_tls13_traffic_secret(TrafficDirection::Remote, move(server_secret)));
+
+    {
+        // RFC 8446 appendix D.4: We always send a session ID, so we're in middlebox compatibility mode,
+        // and have to send a ChangeCipherSpec before our first encrypted record.
+        dbgln_if(TLS_DEBUG, "> change cipher spec");
+        PacketBuilder builder { MessageType::ChangeCipher, m_context.options.version, 64 };
+        builder.append((u8)1);
+        auto packet = builder.build();
+        update_packet(packet);
+        write_packet(packet);
+    }
+    if (tls13.is_certificate_requested) {
+        dbgln_if(TLS_DEBUG, "> client certificate");
+        auto packet = build_tls13_certificate();
+        write_packet(packet);
+    }
+    {
+        dbgln_if(TLS_DEBUG, "> client finished");
+        auto packet = TRY(build_tls13_handshake_finished());
+        write_packet(packet);
+    }
+
+    TRY(set_tls13_traffic_secret(TrafficDirection::Local, move(client_secret)));
+    tls13.resumption_master_secret = TRY(derive_secret(hash, master_secret, "res master"sv, m_context.handshake_hash.peek().bytes()));
+    tls13.handshake_secret.clear();
+
+    did_establish_connection();
+    return {};
+}
+
+ByteBuffer TLSv12::build_tls13_certificate()
+{
+    // Simplification: We don't do client authentication with TLS 1.3, and an empty certificate_list tells the server so.
+    auto& context = m_context.tls13.certificate_request_context;
+    PacketBuilder builder { MessageType::Handshake, m_context.options.version, 64 + context.size() };
+    builder.append((u8)HandshakeType::CertificateMessage);
+    builder.append_u24(1 + context.size() + 3);
+    builder.append((u8)context.size());
+    builder.append(context.bytes());
+    builder.append_u24(0);
+    auto packet = builder.build();
+    update_packet(packet);
+    return packet;
+}
+
+ErrorOr<ByteBuffer> TLSv12::build_tls13_handshake_finished()
+{
+    // RFC 8446 section 4.4.4: The client's Finished is keyed with its handshake traffic secret.
+    auto verify_data = TRY(compute_verify_data(hmac_hash(), m_context.tls13.client_traffic_secret, m_context.handshake_hash.peek().bytes()));
+
+    PacketBuilder builder { MessageType::Handshake, m_context.options.version, 64 + verify_data.size() };
+    builder.append((u8)HandshakeType::Finished);
+    builder.append_u24(verify_data.size());
+    builder.append(verify_data.bytes());
+    auto packet = builder.build();
+    update_packet(packet);
+    return packet;
+}
+
+ErrorOr<ByteBuffer> TLSv12::build_tls13_key_update()
+{
+    PacketBuilder builder { MessageType::Handshake, m_context.options.version, 64 };
+    builder.append((u8)HandshakeType::KeyUpdate);
+    builder.append_u24(1);
+    builder.append((u8)0); // update_not_requested
+    auto packet = builder.build();
+    update_packet(packet);
+    return packet;
+}
+
+ErrorOr<void> TLSv12::set_tls13_traffic_secret(TrafficDirection direction, ByteBuffer secret)
+{
+    // RFC 8446 section 7.3: The traffic keys are derived straight from the traffic secret.
+    auto hash = hmac_hash();
+    auto key = TRY(hkdf_expand_label(hash, secret, "key"sv, {}, key_length()));
+    auto iv = TRY(hkdf_expand_label(hash, secret, "iv"sv, {}, aead_nonce_size));
+
+    auto is_chacha = get_cipher_algorithm(m_context.cipher) == CipherAlgorithm::CHACHA20_POLY1305;
+    if (direction == TrafficDirection::Local) {
+        if (is_chacha)
+            m_cipher_local = Crypto::Cipher::ChaCha20Poly1305(key);
+        else
+            m_cipher_local = Crypto::Cipher::AESCipher::GCMMode(key, key.size() * 8, Crypto::Cipher::Intent::Encryption, Crypto::Cipher::PaddingMode::RFC5246);
+        memcpy(m_context.crypto.local_iv, iv.data(), aead_nonce_size);
+        m_context.local_sequence_number = 0;
+        m_context.tls13.client_traffic_secret = move(secret);
+    } else {
+        if (is_chacha)
+            m_cipher_remote = Crypto::Cipher::ChaCha20Poly1305(key);
+        else
+            m_cipher_remote = Crypto::Cipher::AESCipher::GCMMode(key, key.size() * 8, Crypto::Cipher::Intent::Decryption, Crypto::Cipher::PaddingMode::RFC5246);
+        memcpy(m_context.crypto.remote_iv, iv.data(), aead_nonce_size);
+        m_context.remote_sequence_number = 0;
+        m_context.tls13.server_traffic_secret = move(secret);
+    }
+    return {};
+}
+
+void TLSv12::update_tls13_packet(ByteBuffer& packet)
+{
+    auto type = (MessageType)packet[0];
+
+    // RFC 8446 section 5: ChangeCipherSpec records are only there for middleboxes, and are never protected.
+    if (type == MessageType::ChangeCipher)
+        return;
+
+    // Post-handshake messages aren't part of the transcript.
+    if (type == MessageType::Handshake && packet.size() > record_header_size && m_context.connection_status != ConnectionStatus::Established)
+        update_hash(packet.bytes(), record_header_size);
+
+    if (!m_context.cipher_spec_set)
+        return;
+
+    // RFC 8446 section 5.2: The record content is followed by its real type, and the record pretends to be application data.
+    auto content = packet.bytes().slice(record_header_size);
+    auto inner_length = content.size() + 1;
+    auto plaintext_result = ByteBuffer::create_uninitialized(inner_length);
+    auto record_result = ByteBuffer::create_uninitialized(record_header_size + inner_length + aead_tag_size);
+    if (plaintext_result.is_error() || record_result.is_error()) {
+        dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
+        VERIFY_NOT_REACHED();
+    }
+    auto plaintext = plaintext_result.release_value();
+    auto record = record_result.release_value();
+
+    plaintext.overwrite(0, content.data(), content.size());
+    plaintext[content.size()] = (u8)type;
+
+    record[0] = (u8)MessageType::ApplicationData;
+    ByteReader::store(record.offset_pointer(1), AK::convert_between_host_and_network_endian((u16)Version::V12));
+    ByteReader::store(record.offset_pointer(3), AK::convert_between_host_and_network_endian((u16)(inner_length + aead_tag_size)));
+
+    u8 nonce[16];
+    compute_record_nonce(m_context.crypto.local_iv, m_context.local_sequence_number, { nonce, sizeof(nonce) });
+
+    // The record header is the additional data.
+    auto encrypted_content = record.bytes().slice(record_header_size, inner_length);
+    auto additional_data = record.bytes().slice(0, record_header_size);
+    auto tag = record.bytes().slice(record_header_size + inner_length, aead_tag_size);
+    m_cipher_local.visit(
+        [&](Crypto::Cipher::AESCipher::GCMMode& gcm) {
+            gcm.encrypt(plaintext, encrypted_content, { nonce, sizeof(nonce) }, additional_data, tag);
+        },
+        [&](Crypto::Cipher::ChaCha20Poly1305& chacha) {
+            chacha.encrypt(plaintext, encrypted_content, { nonce, aead_nonce_size }, additional_data, tag);
+        },
+        [&](auto&) { VERIFY_NOT_REACHED(); });
+
+    ++m_context.local_sequence_number;
+    packet = move(record);
+}
+
+ssize_t TLSv12::decrypt_tls13_record(ReadonlyBytes record, ByteBuffer& plaintext)
+{
+    auto payload = record.slice(record_header_size);
+    if ((MessageType)record[0] != MessageType::ApplicationData || payload.size() < aead_tag_size + 1) {
+        dbgln("Invalid encrypted record of type {} and length {}", record[0], payload.size());
+        auto packet = build_alert(true, (u8)AlertDescription::DecodeError);
+        write_packet(packet);
+        return (i8)Error::BrokenPacket;
+    }
+
+    auto ciphertext = payload.slice(0, payload.size() - aead_tag_size);
+    auto tag = payload.slice(ciphertext.size());
+    auto decrypted_result = ByteBuffer::create_uninitialized(ciphertext.size());
+    if (decrypted_result.is_error()) {
+        dbgln("Failed to allocate memory for the packet");
+        return (i8)Error::DecryptionFailed;
+    }
+    auto decrypted = decrypted_result.release_value();
+
+    u8 nonce[16];
+    compute_record_nonce(m_context.crypto.remote_iv, m_context.remote_sequence_number, { nonce, sizeof(nonce) });
+
+    auto consistency = m_cipher_remote.visit(
+        [&](Crypto::Cipher::AESCipher::GCMMode& gcm) {
+            return gcm.decrypt(ciphertext, decrypted, { nonce, sizeof(nonce) }, record.slice(0, record_header_size), tag);
+        },
+        [&](Crypto::Cipher::ChaCha20Poly1305& chacha) {
+            return chacha.decrypt(ciphertext, decrypted, { nonce, aead_nonce_size }, record.slice(0, record_header_size), tag);
+        },
+        [&](auto&) -> Crypto::VerificationConsistency { VERIFY_NOT_REACHED(); });
+
+    if (consistency != Crypto::VerificationConsistency::Consistent) {
+        dbgln("integrity check failed (tag length {})", tag.size());
+        auto packet = build_alert(true, (u8)AlertDescription::BadRecordMAC);
+        write_packet(packet);
+        return (i8)Error::IntegrityCheckFailed;
+    }
+
+    // RFC 8446 section 5.4: Strip the padding, the last non-zero byte is the real content type.
+    auto length = decrypted.size();
+    while (length > 0 && decrypted[length - 1] == 0)
+        --length;
+    if (length == 0) {
+        dbgln("Encrypted record doesn't have a content type");
+        auto packet = build_alert(true, (u8)AlertDescription::UnexpectedMessage);
+        write_packet(packet);
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    auto type = decrypted[length - 1];
+    decrypted.resize(length - 1);
+    plaintext = move(decrypted);
+    return type;
+}
+
+}
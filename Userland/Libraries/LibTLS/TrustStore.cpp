@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCore/DateTime.h>
+#include <LibTLS/TrustStore.h>
+
+namespace TLS {
+
+NonnullRefPtr<TrustStore> TrustStore::create(Vector<Certificate> const& certificates)
+{
+    auto store = adopt_ref(*new TrustStore);
+    for (auto& certificate : certificates) {
+        if (!certificate.is_valid())
+            dbgln("Certificate for {} by {} is invalid, things may or may not work!", certificate.subject.subject, certificate.issuer.subject);
+        // FIXME: Figure out what we should do when our root certs are invalid.
+
+        store->m_certificates.set(certificate.subject_identifier_string(), certificate);
+    }
+    return store;
+}
+
+Certificate const* TrustStore::find_by_subject(String const& subject_identifier) const
+{
+    auto it = m_certificates.find(subject_identifier);
+    if (it == m_certificates.end())
+        return nullptr;
+    return &it->value;
+}
+
+bool TrustStore::has_verified_chain_for(Certificate const& leaf)
+{
+    auto it = m_verified_chains.find(leaf.fingerprint);
+    if (it != m_verified_chains.end() && it->value <= Core::DateTime::now().timestamp()) {
+        dbgln_if(TLS_DEBUG, "Verified chain for {} expired", leaf.subject.subject);
+        m_verified_chains.remove(it);
+        it = m_verified_chains.end();
+    }
+
+    if (it == m_verified_chains.end()) {
+        ++m_verified_chain_misses;
+        return false;
+    }
+
+    ++m_verified_chain_hits;
+    return true;
+}
+
+void TrustStore::did_verify_chain_for(Certificate const& leaf, Core::DateTime const& expiry)
+{
+    if (leaf.fingerprint.is_empty())
+        return;
+
+    if (!m_verified_chains.contains(leaf.fingerprint) && m_verified_chains.size() >= MaximumVerifiedChainCount) {
+        // Make room by throwing out the chain that would have expired first.
+        auto oldest = m_verified_chains.begin();
+        for (auto it = m_verified_chains.begin(); it != m_verified_chains.end(); ++it) {
+            if (it->value < oldest->value)
+                oldest = it;
+        }
+        m_verified_chains.remove(oldest);
+    }
+
+    m_verified_chains.set(leaf.fingerprint, expiry.timestamp());
+}
+
+}
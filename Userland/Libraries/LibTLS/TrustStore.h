@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibTLS/Certificate.h>
+
+namespace TLS {
+
+// A set of trusted root certificates, indexed by their subject so that finding the issuer of a certificate
+// is a single lookup. The default store is parsed once per process and shared by every connection using it.
+//
+// It also remembers the leaf certificates (by SHA-256 fingerprint) whose chains have been verified against it,
+// so that connecting to the same server again doesn't have to check all the signatures in its chain every time.
+class TrustStore : public RefCounted<TrustStore> {
+public:
+    static constexpr size_t MaximumVerifiedChainCount = 256;
+
+    static NonnullRefPtr<TrustStore> create(Vector<Certificate> const&);
+
+    Certificate const* find_by_subject(String const& subject_identifier) const;
+    size_t size() const { return m_certificates.size(); }
+    bool is_empty() const { return m_certificates.is_empty(); }
+
+    // Whether a chain ending in this leaf certificate was verified before, and none of its certificates expired since.
+    bool has_verified_chain_for(Certificate const& leaf);
+    // The chain ending in this leaf certificate is good until the earliest expiry date of its certificates.
+    void did_verify_chain_for(Certificate const& leaf, Core::DateTime const& expiry);
+
+    size_t verified_chain_hits() const { return m_verified_chain_hits; }
+    size_t verified_chain_misses() const { return m_verified_chain_misses; }
+
+private:
+    TrustStore() = default;
+
+    HashMap<String, Certificate> m_certificates;
+    HashMap<ByteBuffer, time_t> m_verified_chains;
+    size_t m_verified_chain_hits { 0 };
+    size_t m_verified_chain_misses { 0 };
+};
+
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/Macros.h> // intentionally first -- we redefine VERIFY and friends in here
+
+#include <AK/Math.h>
+#include <AK/QuickSort.h>
+#include <AK/Time.h>
+#include <LibTest/Benchmark.h>
+
+namespace Test {
+
+namespace {
+
+struct Sample {
+    double nanoseconds_per_iteration { 0 };
+    Optional<double> cycles_per_iteration;
+};
+
+Sample take_sample(Function<void()> const& body, Function<bool()> const& should_stop, size_t iterations)
+{
+    auto start_cycles = read_cycle_counter();
+    auto start = Time::now_monotonic();
+    for (size_t i = 0; i < iterations; ++i) {
+        body();
+        clobber_memory();
+        if (should_stop())
+            break;
+    }
+    auto nanoseconds = (Time::now_monotonic() - start).to_nanoseconds();
+    auto end_cycles = read_cycle_counter();
+
+    Sample sample;
+    sample.nanoseconds_per_iteration = static_cast<double>(nanoseconds) / iterations;
+    if (start_cycles.has_value() && end_cycles.has_value())
+        sample.cycles_per_iteration = static_cast<double>(end_cycles.value() - start_cycles.value()) / iterations;
+    return sample;
+}
+
+// Linearly interpolates between the two closest ranks, so that percentiles of small sample sets stay meaningful.
+double percentile(Vector<double> const& sorted_values, double fraction)
+{
+    VERIFY(!sorted_values.is_empty());
+    auto rank = fraction * (sorted_values.size() - 1);
+    auto lower = static_cast<size_t>(rank);
+    if (lower + 1 >= sorted_values.size())
+        return sorted_values.last();
+    auto weight = rank - lower;
+    return sorted_values[lower] * (1 - weight) + sorted_values[lower + 1] * weight;
+}
+
+}
+
+Optional<BenchmarkResult> run_benchmark(String const& name, Function<void()> const& body, Function<bool()> const& should_stop, BenchmarkOptions const& options)
+{
+    // Keep growing the number of iterations per sample until a sample takes long enough to time accurately.
+    // The first of these runs also warms up caches and any lazily initialized state.
+    auto minimum_sample_time_ns = static_cast<double>(options.minimum_sample_time_in_microseconds) * 1000;
+    size_t iterations_per_sample = 1;
+    for (;;) {
+        auto sample = take_sample(body, should_stop, iterations_per_sample);
+        if (should_stop())
+            return {};
+        auto sample_time_ns = sample.nanoseconds_per_iteration * iterations_per_sample;
+        if (sample_time_ns >= minimum_sample_time_ns)
+            break;
+        // Short samples are noisy, so don't trust them to predict more than a tenfold increase.
+        auto factor = clamp(minimum_sample_time_ns * 1.2 / max(sample_time_ns, 1.0), 2.0, 10.0);
+        iterations_per_sample = static_cast<size_t>(AK::ceil(iterations_per_sample * factor));
+    }
+
+    auto target_time_ns = static_cast<i64>(options.target_time_in_milliseconds) * 1'000'000;
+    auto has_enough_samples = [&](size_t count, i64 elapsed_ns) {
+        if (options.samples.has_value())
+            return count >= options.samples.value();
+        if (count < options.minimum_samples)
+            return false;
+        return count >= options.maximum_samples || elapsed_ns >= target_time_ns;
+    };
+
+    Vector<double> times;
+    Vector<double> cycles;
+    auto start = Time::now_monotonic();
+    while (!has_enough_samples(times.size(), (Time::now_monotonic() - start).to_nanoseconds())) {
+        auto sample = take_sample(body, should_stop, iterations_per_sample);
+        if (should_stop())
+            return {};
+        times.append(sample.nanoseconds_per_iteration);
+        if (sample.cycles_per_iteration.has_value())
+            cycles.append(sample.cycles_per_iteration.value());
+    }
+
+    BenchmarkResult result;
+    result.name = name;
+    result.samples = times.size();
+    result.iterations_per_sample = iterations_per_sample;
+    if (times.is_empty())
+        return result;
+
+    double sum = 0;
+    for (auto time : times)
+        sum += time;
+    result.mean_ns = sum / times.size();
+
+    double squared_deviations = 0;
+    for (auto time : times)
+        squared_deviations += (time - result.mean_ns) * (time - result.mean_ns);
+    if (times.size() > 1)
+        result.standard_deviation_ns = AK::sqrt(squared_deviations / (times.size() - 1));
+
+    quick_sort(times);
+    result.minimum_ns = times.first();
+    result.median_ns = percentile(times, 0.5);
+    result.p99_ns = percentile(times, 0.99);
+
+    if (!cycles.is_empty()) {
+        quick_sort(cycles);
+        result.median_cycles = percentile(cycles, 0.5);
+    }
+    return result;
+}
+
+JsonObject BenchmarkResult::to_json() const
+{
+    JsonObject object;
+    object.set("samples", samples);
+    object.set("iterations_per_sample", iterations_per_sample);
+    object.set("min_ns", minimum_ns);
+    object.set("median_ns", median_ns);
+    object.set("p99_ns", p99_ns);
+    object.set("mean_ns", mean_ns);
+    object.set("stddev_ns", standard_deviation_ns);
+    if (median_cycles.has_value())
+        object.set("median_cycles", median_cycles.value());
+    return object;
+}
+
+Optional<BenchmarkResult> BenchmarkResult::from_json(String const& name, JsonObject const& object)
+{
+    if (!object.has_number("median_ns"sv))
+        return {};
+
+    BenchmarkResult result;
+    result.name = name;
+    result.samples = object.get("samples"sv).to_u64();
+    result.iterations_per_sample = object.get("iterations_per_sample"sv).to_u64();
+    result.minimum_ns = object.get("min_ns"sv).to_double();
+    result.median_ns = object.get("median_ns"sv).to_double();
+    result.p99_ns = object.get("p99_ns"sv).to_double();
+    result.mean_ns = object.get("mean_ns"sv).to_double();
+    result.standard_deviation_ns = object.get("stddev_ns"sv).to_double();
+    if (object.has_number("median_cycles"sv))
+        result.median_cycles = object.get("median_cycles"sv).to_double();
+    return result;
+}
+
+String format_duration(double nanoseconds)
+{
+    if (nanoseconds < 1'000)
+        return String::formatted("{:.1}ns", nanoseconds);
+    if (nanoseconds < 1'000'000)
+        return String::formatted("{:.2}us", nanoseconds / 1'000);
+    if (nanoseconds < 1'000'000'000)
+        return String::formatted("{:.2}ms", nanoseconds / 1'000'000);
+    return String::formatted("{:.3}s", nanoseconds / 1'000'000'000);
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/JsonObject.h>
+#include <AK/Optional.h>
+#include <AK/Platform.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+namespace Test {
+
+// Keeps the compiler from optimizing away the computation of `value`, without otherwise affecting the generated code.
+template<typename T>
+ALWAYS_INLINE void do_not_optimize(T const& value)
+{
+    asm volatile(""
+                 :
+                 : "r,m"(value)
+                 : "memory");
+}
+
+template<typename T>
+ALWAYS_INLINE void do_not_optimize(T& value)
+{
+#if defined(__clang__)
+    asm volatile(""
+                 : "+r,m"(value)
+                 :
+                 : "memory");
+#else
+    asm volatile(""
+                 : "+m,r"(value)
+                 :
+                 : "memory");
+#endif
+}
+
+// Forces all pending memory writes to be performed, and all memory to be re-read afterwards.
+ALWAYS_INLINE void clobber_memory()
+{
+    asm volatile(""
+                 :
+                 :
+                 : "memory");
+}
+
+// Reads the CPU timestamp counter where the architecture provides one that userspace may read.
+ALWAYS_INLINE Optional<u64> read_cycle_counter()
+{
+#if ARCH(I386) || ARCH(X86_64)
+    return __builtin_ia32_rdtsc();
+#else
+    return {};
+#endif
+}
+
+struct BenchmarkOptions {
+    // How long to keep sampling a single benchmark for, which decides the number of samples taken.
+    u64 target_time_in_milliseconds { 1000 };
+    // Each sample runs the benchmark body often enough to take at least this long, so that timer resolution doesn't matter.
+    u64 minimum_sample_time_in_microseconds { 1000 };
+    size_t minimum_samples { 5 };
+    size_t maximum_samples { 1000 };
+    // If set, take exactly this many samples instead of calibrating.
+    Optional<size_t> samples;
+};
+
+struct BenchmarkResult {
+    String name;
+    size_t samples { 0 };
+    size_t iterations_per_sample { 0 };
+
+    // All times are per iteration of the benchmark body.
+    double minimum_ns { 0 };
+    double median_ns { 0 };
+    double p99_ns { 0 };
+    double mean_ns { 0 };
+    double standard_deviation_ns { 0 };
+    Optional<double> median_cycles;
+
+    JsonObject to_json() const;
+    static Optional<BenchmarkResult> from_json(String const& name, JsonObject const&);
+};
+
+// Calibrates how many iterations of `body` make up one sample, then takes as many samples as `options` asks for.
+// Returns an empty Optional if `should_stop` ever returns true, which is how a failing EXPECT() ends the benchmark.
+Optional<BenchmarkResult> run_benchmark(String const& name, Function<void()> const& body, Function<bool()> const& should_stop, BenchmarkOptions const&);
+
+String format_duration(double nanoseconds);
+
+}
@@ -8,7 +8,9 @@
 #include <LibTest/Macros.h> // intentionally first -- we redefine VERIFY and friends in here
 
 #include <AK/Function.h>
+#include <AK/JsonParser.h>
 #include <LibCore/ArgsParser.h>
+#include <LibCore/Stream.h>
 #include <LibTest/TestSuite.h>
 #include <stdlib.h>
 #include <sys/time.h>
@@ -66,10 +68,17 @@ int TestSuite::main(String const& suite_name, int argc, char** argv)
     bool do_benchmarks_only = false;
     bool do_list_cases = false;
     char const* search_string = "*";
+    StringView benchmark_output_path;
+    StringView benchmark_baseline_path;
 
     args_parser.add_option(do_tests_only, "Only run tests.", "tests", 0);
     args_parser.add_option(do_benchmarks_only, "Only run benchmarks.", "bench", 0);
     args_parser.add_option(do_list_cases, "List available test cases.", "list", 0);
+    args_parser.add_option(m_benchmark_options.target_time_in_milliseconds, "How long to sample each benchmark for (default: 1000).", "bench-time", 0, "milliseconds");
+    args_parser.add_option(m_benchmark_options.samples, "Take exactly this many samples of each benchmark.", "bench-samples", 0, "count");
+    args_parser.add_option(benchmark_output_path, "Write benchmark results as JSON to this file.", "bench-json", 0, "path");
+    args_parser.add_option(benchmark_baseline_path, "Compare benchmark results against a JSON file written by --bench-json.", "bench-baseline", 0, "path");
+    args_parser.add_option(m_benchmark_regression_threshold, "Fail benchmarks whose median is this much slower than the baseline (default: 5).", "bench-threshold", 0, "percent");
     args_parser.add_positional_argument(search_string, "Only run matching cases.", "pattern", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -86,9 +95,25 @@ int TestSuite::main(String const& suite_name, int argc, char** argv)
         return 0;
     }
 
+    if (!benchmark_baseline_path.is_empty()) {
+        if (auto result = load_benchmark_baseline(benchmark_baseline_path); result.is_error()) {
+            warnln("Failed to load benchmark baseline from {}: {}", benchmark_baseline_path, result.error());
+            return 1;
+        }
+    }
+
     outln("Running {} cases out of {}.", matching_tests.size(), m_cases.size());
 
-    return run(matching_tests);
+    auto failed_count = run(matching_tests);
+
+    if (!benchmark_output_path.is_empty()) {
+        if (auto result = write_benchmark_results(benchmark_output_path); result.is_error()) {
+            warnln("Failed to write benchmark results to {}: {}", benchmark_output_path, result.error());
+            return 1;
+        }
+    }
+
+    return failed_count + (int)report_benchmark_regressions();
 }
 
 NonnullRefPtrVector<TestCase> TestSuite::find_cases(String const& search, bool find_tests, bool find_benchmarks)
@@ -125,7 +150,10 @@ int TestSuite::run(NonnullRefPtrVector<TestCase> const& tests)
         m_current_test_case_passed = true;
 
         TestElapsedTimer timer;
-        t.func()();
+        if (t.is_benchmark())
+            run_benchmark(t);
+        else
+            t.func()();
         auto const time = timer.elapsed_milliseconds();
 
         dbgln("{} {} '{}' in {}ms", m_current_test_case_passed ? "Completed" : "Failed", test_type, t.name(), time);
@@ -155,4 +183,83 @@ int TestSuite::run(NonnullRefPtrVector<TestCase> const& tests)
     return (int)test_failed_count;
 }
 
+void TestSuite::run_benchmark(TestCase const& test_case)
+{
+    auto result = Test::run_benchmark(
+        test_case.name(), test_case.func(), [this] { return !m_current_test_case_passed; }, m_benchmark_options);
+    if (!result.has_value())
+        return;
+
+    String cycles;
+    if (result->median_cycles.has_value())
+        cycles = String::formatted(", {:.0} cycles", result->median_cycles.value());
+    warnln("    {} samples of {} iterations: median {}, p99 {}, min {}, stddev {}{}",
+        result->samples,
+        result->iterations_per_sample,
+        format_duration(result->median_ns),
+        format_duration(result->p99_ns),
+        format_duration(result->minimum_ns),
+        format_duration(result->standard_deviation_ns),
+        cycles);
+
+    if (auto baseline = m_benchmark_baseline.get(test_case.name()); baseline.has_value() && baseline->median_ns > 0) {
+        auto change = (result->median_ns / baseline->median_ns - 1) * 100;
+        warnln("    {}{:.1}% against the baseline median of {}", change >= 0 ? "+" : "", change, format_duration(baseline->median_ns));
+    }
+
+    m_benchmark_results.append(result.release_value());
+}
+
+ErrorOr<void> TestSuite::load_benchmark_baseline(StringView path)
+{
+    auto file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Read));
+    auto contents = TRY(file->read_all());
+    auto json = TRY(JsonParser(contents).parse());
+    if (!json.is_object() || !json.as_object().has_object("benchmarks"sv))
+        return Error::from_string_literal("Not a benchmark results file");
+
+    json.as_object().get("benchmarks"sv).as_object().for_each_member([&](auto& name, auto& value) {
+        if (!value.is_object())
+            return;
+        if (auto result = BenchmarkResult::from_json(name, value.as_object()); result.has_value())
+            m_benchmark_baseline.set(name, result.release_value());
+    });
+    return {};
+}
+
+ErrorOr<void> TestSuite::write_benchmark_results(StringView path) const
+{
+    JsonObject benchmarks;
+    for (auto const& result : m_benchmark_results)
+        benchmarks.set(result.name, result.to_json());
+
+    JsonObject root;
+    root.set("suite", m_suite_name);
+    root.set("benchmarks", move(benchmarks));
+
+    auto file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate));
+    if (!file->write_or_error(root.to_string().bytes()))
+        return Error::from_string_literal("Failed to write the results");
+    return {};
+}
+
+size_t TestSuite::report_benchmark_regressions() const
+{
+    size_t regression_count = 0;
+    for (auto const& result : m_benchmark_results) {
+        auto baseline = m_benchmark_baseline.get(result.name);
+        if (!baseline.has_value() || baseline->median_ns <= 0)
+            continue;
+        auto change = (result.median_ns / baseline->median_ns - 1) * 100;
+        if (change <= m_benchmark_regression_threshold)
+            continue;
+        warnln("Benchmark '{}' regressed by {:.1}%: median {} against {} in the baseline.",
+            result.name, change, format_duration(result.median_ns), format_duration(baseline->median_ns));
+        ++regression_count;
+    }
+    if (regression_count > 0)
+        warnln("{} benchmarks regressed by more than {}%.", regression_count, m_benchmark_regression_threshold);
+    return regression_count;
+}
+
 }
@@ -11,8 +11,11 @@
 
 #include <AK/Format.h>
 #include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibTest/Benchmark.h>
 #include <LibTest/TestCase.h>
 
 namespace Test {
@@ -46,6 +49,11 @@ public:
     void set_suite_setup(Function<void()> setup) { m_setup = move(setup); }
 
 private:
+    void run_benchmark(TestCase const&);
+    ErrorOr<void> load_benchmark_baseline(StringView path);
+    ErrorOr<void> write_benchmark_results(StringView path) const;
+    size_t report_benchmark_regressions() const;
+
     static TestSuite* s_global;
     NonnullRefPtrVector<TestCase> m_cases;
     u64 m_testtime = 0;
@@ -53,6 +61,11 @@ private:
     String m_suite_name;
     bool m_current_test_case_passed = true;
     Function<void()> m_setup;
+
+    BenchmarkOptions m_benchmark_options;
+    Vector<BenchmarkResult> m_benchmark_results;
+    HashMap<String, BenchmarkResult> m_benchmark_baseline;
+    double m_benchmark_regression_threshold { 5 };
 };
 
 }
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <LibThreading/ThreadPool.h>
+#include <unistd.h>
+
+namespace Threading {
+
+static thread_local ThreadPool* s_current_pool { nullptr };
+static thread_local size_t s_current_worker_index { 0 };
+
+struct SharedThreadPool {
+    SharedThreadPool()
+    {
+        auto processor_count = static_cast<size_t>(max(1l, sysconf(_SC_NPROCESSORS_ONLN)));
+        pool = MUST(ThreadPool::try_create(processor_count, "Thread pool"sv));
+    }
+
+    OwnPtr<ThreadPool> pool;
+};
+
+static Singleton<SharedThreadPool> s_shared_pool;
+
+ThreadPool& ThreadPool::the()
+{
+    return *s_shared_pool->pool;
+}
+
+ErrorOr<NonnullOwnPtr<ThreadPool>> ThreadPool::try_create(size_t thread_count, StringView thread_name)
+{
+    VERIFY(thread_count > 0);
+    auto pool = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ThreadPool));
+    TRY(pool->m_workers.try_ensure_capacity(thread_count));
+    TRY(pool->m_threads.try_ensure_capacity(thread_count));
+
+    // All of the workers have to exist before any of them starts stealing from the others.
+    for (size_t i = 0; i < thread_count; ++i)
+        pool->m_workers.unchecked_append(TRY(adopt_nonnull_own_or_enomem(new (nothrow) Worker)));
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto thread = TRY(Thread::try_create([pool = pool.ptr(), i]() -> intptr_t {
+            pool->worker_loop(i);
+            return 0;
+        },
+            thread_name));
+        thread->start();
+        pool->m_threads.unchecked_append(move(thread));
+    }
+
+    return pool;
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        MutexLocker locker(m_sleep_mutex);
+        m_should_exit = true;
+        ++m_epoch;
+        m_sleep_condition.broadcast();
+    }
+    for (auto& thread : m_threads)
+        (void)thread.join();
+}
+
+void ThreadPool::worker_loop(size_t worker_index)
+{
+    s_current_pool = this;
+    s_current_worker_index = worker_index;
+
+    // NOTE: Workers only leave once there is nothing left to do, so every submitted task runs.
+    while (true) {
+        auto epoch = current_epoch();
+        if (try_run_one_task())
+            continue;
+        if (!sleep_until_notified(epoch))
+            break;
+    }
+
+    s_current_pool = nullptr;
+}
+
+void ThreadPool::submit(Task task)
+{
+    if (s_current_pool == this) {
+        auto& worker = m_workers[s_current_worker_index];
+        MutexLocker locker(worker.mutex);
+        worker.tasks.append(move(task));
+    } else {
+        MutexLocker locker(m_submitted_tasks_mutex);
+        m_submitted_tasks.enqueue(move(task));
+    }
+    m_queued_task_count.fetch_add(1, AK::MemoryOrder::memory_order_release);
+    notify(false);
+}
+
+Optional<ThreadPool::Task> ThreadPool::take_task()
+{
+    if (m_queued_task_count.load(AK::MemoryOrder::memory_order_acquire) == 0)
+        return {};
+
+    // Our own tasks are taken newest first, as whatever they need is most likely still in the cache.
+    bool is_worker = s_current_pool == this;
+    if (is_worker) {
+        auto& worker = m_workers[s_current_worker_index];
+        MutexLocker locker(worker.mutex);
+        if (!worker.tasks.is_empty())
+            return worker.tasks.take_last();
+    }
+
+    {
+        MutexLocker locker(m_submitted_tasks_mutex);
+        if (!m_submitted_tasks.is_empty())
+            return m_submitted_tasks.dequeue();
+    }
+
+    // Others' tasks are taken oldest first, as those tend to be the ones that split into the most work.
+    size_t first_victim = is_worker ? s_current_worker_index + 1 : 0;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        auto& victim = m_workers[(first_victim + i) % m_workers.size()];
+        MutexLocker locker(victim.mutex);
+        if (!victim.tasks.is_empty())
+            return victim.tasks.take_first();
+    }
+    return {};
+}
+
+bool ThreadPool::try_run_one_task()
+{
+    auto task = take_task();
+    if (!task.has_value())
+        return false;
+    m_queued_task_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+    (*task)();
+    return true;
+}
+
+u64 ThreadPool::current_epoch()
+{
+    MutexLocker locker(m_sleep_mutex);
+    return m_epoch;
+}
+
+bool ThreadPool::sleep_until_notified(u64 epoch)
+{
+    MutexLocker locker(m_sleep_mutex);
+    ++m_sleeping_thread_count;
+    m_sleep_condition.wait_while([&] {
+        return m_epoch == epoch && !m_should_exit;
+    });
+    --m_sleeping_thread_count;
+    return !m_should_exit;
+}
+
+void ThreadPool::notify(bool everyone)
+{
+    MutexLocker locker(m_sleep_mutex);
+    ++m_epoch;
+    if (m_sleeping_thread_count == 0)
+        return;
+    if (everyone)
+        m_sleep_condition.broadcast();
+    else
+        m_sleep_condition.signal();
+}
+
+void ThreadPool::parallel_for(size_t count, Function<void(size_t)> const& body)
+{
+    // A few chunks per thread, so that threads that are done early can take over some of the work of the others.
+    size_t chunk_count = min(count, (thread_count() + 1) * 4);
+    if (chunk_count < 2) {
+        for (size_t i = 0; i < count; ++i)
+            body(i);
+        return;
+    }
+
+    TaskGroup group(*this);
+    for (size_t chunk = 1; chunk < chunk_count; ++chunk) {
+        group.spawn([&body, begin = count * chunk / chunk_count, end = count * (chunk + 1) / chunk_count] {
+            for (size_t i = begin; i < end; ++i)
+                body(i);
+        });
+    }
+    for (size_t i = 0; i < count / chunk_count; ++i)
+        body(i);
+    group.wait();
+}
+
+void TaskGroup::spawn(ThreadPool::Task task)
+{
+    m_pending_task_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    // NOTE: The group may be gone as soon as the last task is done, so that must be the last time it is touched.
+    m_pool.submit([&pool = m_pool, pending_task_count = &m_pending_task_count, task = move(task)] {
+        task();
+        if (pending_task_count->fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel) == 1)
+            pool.notify(true);
+    });
+}
+
+void TaskGroup::wait()
+{
+    while (m_pending_task_count.load(AK::MemoryOrder::memory_order_acquire) != 0) {
+        auto epoch = m_pool.current_epoch();
+        if (m_pending_task_count.load(AK::MemoryOrder::memory_order_acquire) == 0)
+            break;
+        if (m_pool.try_run_one_task())
+            continue;
+        m_pool.sleep_until_notified(epoch);
+    }
+}
+
+ErrorOr<TaskGraph::TaskID> TaskGraph::try_add_task(ThreadPool::Task task, Span<TaskID const> dependencies)
+{
+    TaskID id = m_nodes.size();
+    auto node = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Node));
+    node->task = move(task);
+    node->dependency_count = dependencies.size();
+
+    // Allocate everything up front, so that a failure leaves the graph as it was.
+    TRY(m_nodes.try_ensure_capacity(m_nodes.size() + 1));
+    for (auto dependency : dependencies) {
+        VERIFY(dependency < id);
+        auto& dependents = m_nodes[dependency].dependents;
+        TRY(dependents.try_ensure_capacity(dependents.size() + dependencies.size()));
+    }
+    for (auto dependency : dependencies)
+        m_nodes[dependency].dependents.unchecked_append(id);
+    m_nodes.unchecked_append(move(node));
+    return id;
+}
+
+void TaskGraph::run(ThreadPool& pool)
+{
+    for (auto& node : m_nodes)
+        node.remaining_dependency_count.store(node.dependency_count, AK::MemoryOrder::memory_order_relaxed);
+
+    TaskGroup group(pool);
+    for (TaskID id = 0; id < m_nodes.size(); ++id) {
+        if (m_nodes[id].dependency_count == 0)
+            schedule(group, id);
+    }
+    group.wait();
+}
+
+void TaskGraph::schedule(TaskGroup& group, TaskID id)
+{
+    group.spawn([this, &group, id] {
+        auto& node = m_nodes[id];
+        node.task();
+        for (auto dependent : node.dependents) {
+            if (m_nodes[dependent].remaining_dependency_count.fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel) == 1)
+                schedule(group, dependent);
+        }
+    });
+}
+
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/QuickSort.h>
+#include <AK/Queue.h>
+#include <AK/Span.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Promise.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+
+namespace Threading {
+
+class TaskGroup;
+
+// A set of threads that run short tasks, shared by everyone in the process through ThreadPool::the().
+// Every worker has a queue of its own, to which the tasks it submits go, and workers that run out of
+// tasks take the oldest ones from the others. Threads that wait for tasks run queued tasks in the
+// meantime, so that tasks can wait for other tasks without tying up a worker.
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+    friend class TaskGroup;
+
+public:
+    using Task = Function<void()>;
+
+    // The pool that all users in the process share, with one thread per core.
+    static ThreadPool& the();
+
+    static ErrorOr<NonnullOwnPtr<ThreadPool>> try_create(size_t thread_count, StringView thread_name);
+    ~ThreadPool();
+
+    size_t thread_count() const { return m_threads.size(); }
+
+    void submit(Task);
+
+    // Runs `function` on the pool, and resolves the promise with its result on the event loop of the calling thread.
+    template<typename Result>
+    NonnullRefPtr<Core::Promise<Result>> run_async(Function<Result()> function)
+    {
+        auto promise = Core::Promise<Result>::construct();
+        submit([promise, function = move(function), origin_event_loop = &Core::EventLoop::current()]() mutable {
+            auto result = function();
+            origin_event_loop->deferred_invoke([promise = move(promise), result = move(result)]() mutable {
+                promise->resolve(move(result));
+            });
+            origin_event_loop->wake();
+        });
+        return promise;
+    }
+
+    // Calls `body` once for each index in [0, count), and returns once all of the calls are done.
+    void parallel_for(size_t count, Function<void(size_t)> const& body);
+
+    template<typename T, typename Callback>
+    void parallel_for_each(Span<T> span, Callback callback)
+    {
+        parallel_for(span.size(), [&](size_t index) { callback(span[index]); });
+    }
+
+    template<typename T, typename LessThan>
+    void parallel_sort(Span<T> span, LessThan less_than);
+
+    template<typename T>
+    void parallel_sort(Span<T> span)
+    {
+        parallel_sort(span, [](auto& a, auto& b) { return a < b; });
+    }
+
+private:
+    struct Worker {
+        Mutex mutex;
+        Vector<Task> tasks;
+    };
+
+    ThreadPool() = default;
+
+    void worker_loop(size_t worker_index);
+
+    Optional<Task> take_task();
+    bool try_run_one_task();
+
+    u64 current_epoch();
+    // Sleeps until something was submitted or finished since `epoch` was read, returns false when the pool is going away.
+    bool sleep_until_notified(u64 epoch);
+    void notify(bool everyone);
+
+    template<typename T, typename LessThan>
+    static void parallel_sort_step(TaskGroup&, Span<T>, LessThan const&);
+
+    NonnullRefPtrVector<Thread> m_threads;
+    NonnullOwnPtrVector<Worker> m_workers;
+
+    // Tasks that were submitted from outside of the pool.
+    Mutex m_submitted_tasks_mutex;
+    Queue<Task> m_submitted_tasks;
+
+    Atomic<size_t> m_queued_task_count { 0 };
+
+    Mutex m_sleep_mutex;
+    ConditionVariable m_sleep_condition { m_sleep_mutex };
+    // These are guarded by m_sleep_mutex.
+    u64 m_epoch { 0 };
+    size_t m_sleeping_thread_count { 0 };
+    bool m_should_exit { false };
+};
+
+// Tasks that run on a pool and can be waited for together. Tasks can add more tasks to the group they belong to.
+class TaskGroup {
+    AK_MAKE_NONCOPYABLE(TaskGroup);
+    AK_MAKE_NONMOVABLE(TaskGroup);
+
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::the())
+        : m_pool(pool)
+    {
+    }
+
+    ~TaskGroup() { wait(); }
+
+    void spawn(ThreadPool::Task);
+    void wait();
+
+private:
+    ThreadPool& m_pool;
+    Atomic<size_t> m_pending_task_count { 0 };
+};
+
+// A set of tasks that may each have to wait for some of the others. Tasks can only depend on tasks that were added
+// before them, which keeps the graph free of cycles.
+class TaskGraph {
+public:
+    using TaskID = size_t;
+
+    ErrorOr<TaskID> try_add_task(ThreadPool::Task, Span<TaskID const> dependencies = {});
+    TaskID add_task(ThreadPool::Task task, Span<TaskID const> dependencies = {}) { return MUST(try_add_task(move(task), dependencies)); }
+
+    // Runs every task once all of the tasks it depends on are done, and returns when all of them are.
+    void run(ThreadPool& = ThreadPool::the());
+
+private:
+    struct Node {
+        ThreadPool::Task task;
+        Vector<TaskID> dependents;
+        size_t dependency_count { 0 };
+        Atomic<size_t> remaining_dependency_count { 0 };
+    };
+
+    void schedule(TaskGroup&, TaskID);
+
+    NonnullOwnPtrVector<Node> m_nodes;
+};
+
+template<typename T, typename LessThan>
+void ThreadPool::parallel_sort(Span<T> span, LessThan less_than)
+{
+    TaskGroup group(*this);
+    parallel_sort_step(group, span, less_than);
+    group.wait();
+}
+
+template<typename T, typename LessThan>
+void ThreadPool::parallel_sort_step(TaskGroup& group, Span<T> span, LessThan const& less_than)
+{
+    // Below this, handing the work to another thread costs more than it saves.
+    static constexpr size_t serial_sort_threshold = 2048;
+
+    while (span.size() > serial_sort_threshold) {
+        swap(span[span.size() / 2], span.last());
+        size_t pivot_index = 0;
+        for (size_t i = 0; i + 1 < span.size(); ++i) {
+            if (less_than(span[i], span.last()))
+                swap(span[i], span[pivot_index++]);
+        }
+        swap(span[pivot_index], span.last());
+
+        auto left = span.slice(0, pivot_index);
+        auto right = span.slice(pivot_index + 1);
+        // Lots of equal elements all end up on one side, which the serial sort copes with better.
+        if (min(left.size(), right.size()) < span.size() / 16)
+            break;
+
+        group.spawn([&group, left, &less_than] {
+            parallel_sort_step(group, left, less_than);
+        });
+        span = right;
+    }
+    quick_sort(span, less_than);
+}
+
+}
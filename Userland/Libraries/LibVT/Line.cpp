@@ -6,6 +6,10 @@
  */
 
 #include <LibVT/Line.h>
+#ifndef KERNEL
+#    include <AK/UnicodeUtils.h>
+#    include <AK/Utf8View.h>
+#endif
 
 namespace VT {
 
@@ -14,8 +18,65 @@ Line::Line(size_t length)
     set_length(length);
 }
 
+#ifndef KERNEL
+void Line::compact()
+{
+    if (m_compact_line || m_cells.is_empty())
+        return;
+
+    // NOTE: Anything that doesn't encode to UTF-8 (and back) as a single code point would throw off the columns.
+    auto encodable_code_point = [](u32 code_point) -> u32 {
+        if (code_point > 0x10ffff || (code_point >= 0xd800 && code_point <= 0xdfff))
+            return 0xfffd;
+        return code_point;
+    };
+
+    size_t text_size = 0;
+    for (auto& cell : m_cells)
+        text_size += AK::UnicodeUtils::code_point_to_utf8(encodable_code_point(cell.code_point), [](char) {});
+
+    auto compact_line = make<CompactLine>();
+    compact_line->length = m_cells.size();
+    compact_line->text.ensure_capacity(text_size);
+    auto& runs = compact_line->attribute_runs;
+    for (auto& cell : m_cells) {
+        (void)AK::UnicodeUtils::code_point_to_utf8(encodable_code_point(cell.code_point), [&](char byte) { compact_line->text.unchecked_append(static_cast<u8>(byte)); });
+
+        auto& attribute = cell.attribute;
+        if (!runs.is_empty() && runs.last().attribute == attribute && runs.last().attribute.href == attribute.href && runs.last().attribute.href_id == attribute.href_id)
+            ++runs.last().length;
+        else
+            runs.append({ 1, attribute });
+    }
+
+    m_cells.clear();
+    m_compact_line = move(compact_line);
+}
+
+void Line::expand() const
+{
+    auto compact_line = m_compact_line.release_nonnull();
+    m_cells.ensure_capacity(compact_line->length);
+
+    auto runs = compact_line->attribute_runs.span();
+    size_t run_index = 0;
+    size_t cells_left_in_run = runs[0].length;
+    for (auto code_point : Utf8View(StringView(compact_line->text.span()))) {
+        while (cells_left_in_run == 0)
+            cells_left_in_run = runs[++run_index].length;
+        m_cells.unchecked_append({ .code_point = code_point, .attribute = runs[run_index].attribute });
+        --cells_left_in_run;
+    }
+    VERIFY(m_cells.size() == compact_line->length);
+}
+#endif
+
 void Line::rewrap(size_t new_length, Line* next_line, CursorPosition* cursor, bool cursor_is_on_next_line)
 {
+    ensure_expanded();
+    if (next_line)
+        next_line->ensure_expanded();
+
     size_t old_length = length();
     if (old_length == new_length)
         return;
@@ -35,6 +96,7 @@ void Line::rewrap(size_t new_length, Line* next_line, CursorPosition* cursor, bo
 
 void Line::set_length(size_t new_length)
 {
+    ensure_expanded();
     m_cells.resize(new_length);
     if (m_terminated_at.has_value())
         m_terminated_at = min(*m_terminated_at, new_length);
@@ -119,6 +181,7 @@ void Line::take_cells_from_next_line(size_t new_length, Line* next_line, bool cu
 
 void Line::clear_range(size_t first_column, size_t last_column, Attribute const& attribute)
 {
+    ensure_expanded();
     VERIFY(first_column <= last_column);
     VERIFY(last_column < m_cells.size());
     for (size_t i = first_column; i <= last_column; ++i) {
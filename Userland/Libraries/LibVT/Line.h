@@ -9,6 +9,7 @@
 
 #include <AK/AnyOf.h>
 #include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
 #include <AK/Vector.h>
 #include <LibVT/Attribute.h>
 #include <LibVT/Position.h>
@@ -31,14 +32,31 @@ public:
         bool operator!=(Cell const& other) const { return code_point != other.code_point || attribute != other.attribute; }
     };
 
-    Attribute const& attribute_at(size_t index) const { return m_cells[index].attribute; }
-    Attribute& attribute_at(size_t index) { return m_cells[index].attribute; }
+    Attribute const& attribute_at(size_t index) const
+    {
+        ensure_expanded();
+        return m_cells[index].attribute;
+    }
+    Attribute& attribute_at(size_t index)
+    {
+        ensure_expanded();
+        return m_cells[index].attribute;
+    }
 
-    Cell& cell_at(size_t index) { return m_cells[index]; }
-    Cell const& cell_at(size_t index) const { return m_cells[index]; }
+    Cell& cell_at(size_t index)
+    {
+        ensure_expanded();
+        return m_cells[index];
+    }
+    Cell const& cell_at(size_t index) const
+    {
+        ensure_expanded();
+        return m_cells[index];
+    }
 
     void clear(Attribute const& attribute = Attribute())
     {
+        ensure_expanded();
         m_terminated_at.clear();
         clear_range(0, m_cells.size() - 1, attribute);
     }
@@ -47,11 +65,16 @@ public:
 
     bool is_empty() const
     {
+        ensure_expanded();
         return !any_of(m_cells, [](auto& cell) { return cell != Cell(); });
     }
 
     size_t length() const
     {
+#ifndef KERNEL
+        if (m_compact_line)
+            return m_compact_line->length;
+#endif
         return m_cells.size();
     }
     void set_length(size_t);
@@ -59,11 +82,13 @@ public:
 
     u32 code_point(size_t index) const
     {
+        ensure_expanded();
         return m_cells[index].code_point;
     }
 
     void set_code_point(size_t index, u32 code_point)
     {
+        ensure_expanded();
         if (m_terminated_at.has_value()) {
             if (index > *m_terminated_at) {
                 m_terminated_at = index + 1;
@@ -79,11 +104,41 @@ public:
     Optional<u16> termination_column() const { return m_terminated_at; }
     void set_terminated(u16 column) { m_terminated_at = column; }
 
+#ifndef KERNEL
+    // Lines in the history are seldom looked at again, so they are kept as UTF-8 and runs of attributes rather than
+    // a cell per column, which takes a fraction of the memory. Looking at the cells expands the line again.
+    void compact();
+#endif
+
 private:
+    void ensure_expanded() const
+    {
+#ifndef KERNEL
+        if (m_compact_line)
+            expand();
+#endif
+    }
+
+
     void take_cells_from_next_line(size_t new_length, Line* next_line, bool cursor_is_on_next_line, CursorPosition* cursor);
     void push_cells_into_next_line(size_t new_length, Line* next_line, bool cursor_is_on_next_line, CursorPosition* cursor);
 
-    Vector<Cell> m_cells;
+#ifndef KERNEL
+    void expand() const;
+
+    struct AttributeRun {
+        size_t length { 0 };
+        Attribute attribute;
+    };
+    struct CompactLine {
+        Vector<u8> text;
+        Vector<AttributeRun, 1> attribute_runs;
+        size_t length { 0 };
+    };
+    mutable OwnPtr<CompactLine> m_compact_line;
+#endif
+
+    mutable Vector<Cell> m_cells;
     bool m_dirty { false };
     // Note: The alignment is 8, so this member lives in the padding (that already existed before it was introduced)
     [[no_unique_address]] Optional<u16> m_terminated_at;
@@ -1575,6 +1575,10 @@ void Terminal::set_size(u16 columns, u16 rows)
 
     cursor_tracker.row -= m_history.size();
 
+    // Rewrapping expanded all of the history again.
+    for (auto& line : m_history)
+        line.compact();
+
     if (m_history.size() != old_history_size) {
         m_client.terminal_history_changed(-old_history_size);
         m_client.terminal_history_changed(m_history.size());
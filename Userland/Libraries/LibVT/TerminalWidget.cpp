@@ -50,7 +50,7 @@ void TerminalWidget::set_pty_master_fd(int fd)
     }
     m_notifier = Core::Notifier::construct(m_ptm_fd, Core::Notifier::Read);
     m_notifier->on_ready_to_read = [this] {
-        u8 buffer[BUFSIZ];
+        u8 buffer[16 * KiB];
         ssize_t nread = read(m_ptm_fd, buffer, sizeof(buffer));
         if (nread < 0) {
             dbgln("Terminal read error: {}", strerror(errno));
@@ -71,7 +71,7 @@ void TerminalWidget::set_pty_master_fd(int fd)
         }
         for (ssize_t i = 0; i < nread; ++i)
             m_terminal.on_input(buffer[i]);
-        flush_dirty_lines();
+        schedule_flush_of_dirty_lines();
     };
 }
 
@@ -93,6 +93,7 @@ TerminalWidget::TerminalWidget(int ptm_fd, bool automatic_size_policy)
     m_cursor_blink_timer = add<Core::Timer>();
     m_visual_beep_timer = add<Core::Timer>();
     m_auto_scroll_timer = add<Core::Timer>();
+    m_flush_timer = add<Core::Timer>();
 
     m_scrollbar = add<GUI::Scrollbar>(Orientation::Vertical);
     m_scrollbar->set_scroll_animation(GUI::Scrollbar::Animation::CoarseScroll);
@@ -116,6 +117,13 @@ TerminalWidget::TerminalWidget(int ptm_fd, bool automatic_size_policy)
     };
     m_auto_scroll_timer->start();
 
+    m_flush_timer->set_single_shot(true);
+    m_flush_timer->set_interval(flush_interval_ms);
+    m_flush_timer->on_timeout = [this] {
+        flush_dirty_lines();
+    };
+    m_time_since_flush.start();
+
     auto font_entry = Config::read_string("Terminal"sv, "Text"sv, "Font"sv, "default"sv);
     if (font_entry == "default")
         set_font(Gfx::FontDatabase::default_fixed_width_font());
@@ -480,8 +488,22 @@ void TerminalWidget::invalidate_cursor()
     m_terminal.invalidate_cursor();
 }
 
+void TerminalWidget::schedule_flush_of_dirty_lines()
+{
+    // When a program floods us with output, only repaint once per frame instead of after every read.
+    if (m_time_since_flush.elapsed() >= flush_interval_ms) {
+        flush_dirty_lines();
+        return;
+    }
+    if (!m_flush_timer->is_active())
+        m_flush_timer->start();
+}
+
 void TerminalWidget::flush_dirty_lines()
 {
+    m_flush_timer->stop();
+    m_time_since_flush.start();
+
     // FIXME: Update smarter when scrolled
     if (m_terminal.m_need_full_flush || m_scrollbar->value() != m_scrollbar->max()) {
         update();
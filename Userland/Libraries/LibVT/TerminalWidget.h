@@ -214,12 +214,18 @@ private:
 
     void set_auto_scroll_direction(AutoScrollDirection);
 
+    void schedule_flush_of_dirty_lines();
+
     AutoScrollDirection m_auto_scroll_direction { AutoScrollDirection::None };
 
     RefPtr<Core::Timer> m_cursor_blink_timer;
     RefPtr<Core::Timer> m_visual_beep_timer;
     RefPtr<Core::Timer> m_auto_scroll_timer;
 
+    static constexpr int flush_interval_ms = 16;
+    RefPtr<Core::Timer> m_flush_timer;
+    Core::ElapsedTimer m_time_since_flush;
+
     RefPtr<GUI::Scrollbar> m_scrollbar;
 
     RefPtr<GUI::Action> m_copy_action;
@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BitCast.h>
 #include <AK/Format.h>
 #include <AK/Math.h>
+#include <AK/SIMDExtras.h>
 #include <AK/StdLibExtras.h>
 #include <LibGfx/Matrix4x4.h>
 #include <LibVideo/Color/ColorPrimaries.h>
@@ -193,7 +195,40 @@ DecoderErrorOr<ColorConverter> ColorConverter::create(u8 bit_depth, CodingIndepe
     bool should_skip_color_remapping = output_cp == cicp.color_primaries() && output_tc == cicp.transfer_characteristics();
     FloatMatrix4x4 input_conversion_matrix = color_conversion_matrix * range_scaling_matrix * integer_scaling_matrix;
 
-    return ColorConverter(bit_depth, cicp, should_skip_color_remapping, should_tonemap, input_conversion_matrix, to_linear_lookup_table, color_primaries_matrix_4x4, to_non_linear_lookup_table);
+    auto lookup_tables = should_skip_color_remapping ? TRY(create_lookup_tables(bit_depth, input_conversion_matrix)) : FixedArray<AK::SIMD::i32x4> {};
+
+    return ColorConverter(bit_depth, cicp, should_skip_color_remapping, should_tonemap, input_conversion_matrix, to_linear_lookup_table, color_primaries_matrix_4x4, to_non_linear_lookup_table, move(lookup_tables));
+}
+
+DecoderErrorOr<FixedArray<AK::SIMD::i32x4>> ColorConverter::create_lookup_tables(u8 bit_depth, FloatMatrix4x4 const& input_conversion_matrix)
+{
+    size_t sample_count = 1u << bit_depth;
+    auto lookup_tables = DECODER_TRY_ALLOC(FixedArray<AK::SIMD::i32x4>::try_create(3 * sample_count));
+
+    // The output is scaled to 0..255 here, so that the sum only has to be clamped and shifted.
+    auto const& matrix = input_conversion_matrix.elements();
+    constexpr float scale = 255.0f * (1 << lookup_table_fraction_bits);
+    auto to_fixed_point = [&](float value) { return round_to<i32>(value * scale); };
+
+    for (size_t component = 0; component < 3; component++) {
+        for (size_t sample = 0; sample < sample_count; sample++) {
+            auto contribution = [&](size_t channel) {
+                float value = matrix[channel][component] * sample;
+                // The constant terms of the conversion go into the Y table.
+                if (component == 0)
+                    value += matrix[channel][3];
+                return to_fixed_point(value);
+            };
+            lookup_tables[component * sample_count + sample] = AK::SIMD::i32x4 {
+                contribution(2),
+                contribution(1),
+                contribution(0),
+                component == 0 ? to_fixed_point(1.0f) : 0,
+            };
+        }
+    }
+
+    return lookup_tables;
 }
 
 ALWAYS_INLINE FloatVector4 max_zero(FloatVector4 vector)
@@ -245,4 +280,31 @@ Gfx::Color ColorConverter::convert_yuv_to_full_range_rgb(u16 y, u16 u, u16 v)
     return Gfx::Color(r, g, b);
 }
 
+void ColorConverter::convert_yuv_row_to_full_range_rgb(Span<u16 const> y_row, Span<u16 const> u_row, Span<u16 const> v_row, Span<Gfx::ARGB32> output)
+{
+    VERIFY(y_row.size() >= output.size() && u_row.size() >= output.size() && v_row.size() >= output.size());
+
+    if (m_lookup_tables.is_empty()) {
+        for (size_t i = 0; i < output.size(); i++)
+            output[i] = convert_yuv_to_full_range_rgb(y_row[i], u_row[i], v_row[i]).value();
+        return;
+    }
+
+    using namespace AK::SIMD;
+    u16 maximum_sample = (1u << m_bit_depth) - 1;
+    auto const* y_lookup = m_lookup_tables.data();
+    auto const* u_lookup = y_lookup + maximum_sample + 1;
+    auto const* v_lookup = u_lookup + maximum_sample + 1;
+    auto const minimum = expand4(0);
+    auto const maximum = expand4(255 << lookup_table_fraction_bits);
+
+    for (size_t i = 0; i < output.size(); i++) {
+        auto color = y_lookup[min(y_row[i], maximum_sample)] + u_lookup[min(u_row[i], maximum_sample)] + v_lookup[min(v_row[i], maximum_sample)];
+        color = color < minimum ? minimum : color;
+        color = color > maximum ? maximum : color;
+        // The lanes are in the byte order of BGRx8888.
+        output[i] = bit_cast<Gfx::ARGB32>(to_u8x4(color >> lookup_table_fraction_bits));
+    }
+}
+
 }
@@ -7,7 +7,10 @@
 #pragma once
 
 #include <AK/Array.h>
+#include <AK/FixedArray.h>
 #include <AK/Function.h>
+#include <AK/SIMD.h>
+#include <AK/Span.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/Matrix4x4.h>
 #include <LibVideo/Color/CodingIndependentCodePoints.h>
@@ -64,12 +67,21 @@ public:
     static DecoderErrorOr<ColorConverter> create(u8 bit_depth, CodingIndependentCodePoints cicp);
 
     Gfx::Color convert_yuv_to_full_range_rgb(u16 y, u16 u, u16 v);
+    // Converts a row of pixels that each have their own Y, U and V samples to BGRx8888.
+    void convert_yuv_row_to_full_range_rgb(Span<u16 const> y_row, Span<u16 const> u_row, Span<u16 const> v_row, Span<Gfx::ARGB32> output);
 
 private:
     static constexpr size_t to_linear_size = 64;
     static constexpr size_t to_non_linear_size = 64;
 
-    ColorConverter(u8 bit_depth, CodingIndependentCodePoints cicp, bool should_skip_color_remapping, bool should_tonemap, FloatMatrix4x4 input_conversion_matrix, InterpolatedLookupTable<to_linear_size> to_linear_lookup, FloatMatrix4x4 color_space_conversion_matrix, InterpolatedLookupTable<to_non_linear_size> to_non_linear_lookup)
+    // If no color remapping is needed (which is the case for all SDR video), each output channel is an affine function of
+    // Y, U and V. The lookup tables hold the contribution of every possible sample value of each of them to all channels,
+    // in BGRA order and in fixed point with this many fractional bits.
+    static constexpr u8 lookup_table_fraction_bits = 16;
+
+    static DecoderErrorOr<FixedArray<AK::SIMD::i32x4>> create_lookup_tables(u8 bit_depth, FloatMatrix4x4 const& input_conversion_matrix);
+
+    ColorConverter(u8 bit_depth, CodingIndependentCodePoints cicp, bool should_skip_color_remapping, bool should_tonemap, FloatMatrix4x4 input_conversion_matrix, InterpolatedLookupTable<to_linear_size> to_linear_lookup, FloatMatrix4x4 color_space_conversion_matrix, InterpolatedLookupTable<to_non_linear_size> to_non_linear_lookup, FixedArray<AK::SIMD::i32x4> lookup_tables)
         : m_bit_depth(bit_depth)
         , m_cicp(cicp)
         , m_should_skip_color_remapping(should_skip_color_remapping)
@@ -78,6 +90,7 @@ private:
         , m_to_linear_lookup(move(to_linear_lookup))
         , m_color_space_conversion_matrix(color_space_conversion_matrix)
         , m_to_non_linear_lookup(move(to_non_linear_lookup))
+        , m_lookup_tables(move(lookup_tables))
     {
     }
     u8 m_bit_depth;
@@ -88,6 +101,8 @@ private:
     InterpolatedLookupTable<to_linear_size> m_to_linear_lookup;
     FloatMatrix4x4 m_color_space_conversion_matrix;
     InterpolatedLookupTable<to_non_linear_size> m_to_non_linear_lookup;
+    // The tables for Y, U and V follow each other, with 1 << bit_depth entries each. Empty if color remapping is needed.
+    FixedArray<AK::SIMD::i32x4> m_lookup_tables;
 };
 
 }
@@ -150,6 +150,21 @@ ErrorOr<i8> BitStream::read_s(size_t n)
     return sign ? -value : value;
 }
 
+ErrorOr<BitStream> BitStream::read_sub_stream(size_t bytes)
+{
+    VERIFY(m_reservoir_bits_remaining % 8 == 0);
+    if (bytes > bytes_remaining())
+        return Error::from_string_literal("Stream is out of data");
+
+    // The bytes that are left in the reservoir directly precede m_data_ptr.
+    auto const* start = m_data_ptr - (m_reservoir_bits_remaining / 8);
+    m_data_ptr = start + bytes;
+    m_reservoir = 0;
+    m_reservoir_bits_remaining = 0;
+    m_bits_read += bytes * 8;
+    return BitStream(start, bytes);
+}
+
 u64 BitStream::get_position()
 {
     return m_bits_read;
@@ -38,6 +38,9 @@ public:
     /* (4.9.2) */
     ErrorOr<i8> read_s(size_t n);
 
+    // Returns a stream over the next `bytes` bytes and skips past them. Must be called at a byte boundary.
+    ErrorOr<BitStream> read_sub_stream(size_t bytes);
+
     u64 get_position();
     size_t bytes_remaining();
     size_t bits_remaining();
@@ -7,8 +7,13 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Vector.h>
+
+#include "BitStream.h"
 #include "Enums.h"
 #include "MotionVector.h"
+#include "SyntaxElementCounter.h"
 
 namespace Video::VP9 {
 
@@ -38,4 +43,109 @@ struct TokensContext {
     u8 m_context_index;
 };
 
+// The state that is needed to decode a single tile. Tiles within a tile row only depend on the frame headers and the
+// above contexts, which they access at disjoint columns, so each tile column can be decoded on its own thread with
+// its own TileContext.
+struct TileContext {
+    TileContext(BitStream bit_stream, u32 mi_row_start, u32 mi_row_end, u32 mi_col_start, u32 mi_col_end)
+        : m_bit_stream(bit_stream)
+        , m_mi_row_start(mi_row_start)
+        , m_mi_row_end(mi_row_end)
+        , m_mi_col_start(mi_col_start)
+        , m_mi_col_end(mi_col_end)
+    {
+        m_syntax_element_counter.clear_counts();
+    }
+
+    BitStream m_bit_stream;
+    // The counts are summed into the frame's counts once all tiles are decoded.
+    SyntaxElementCounter m_syntax_element_counter;
+
+    u32 m_mi_row_start { 0 };
+    u32 m_mi_row_end { 0 };
+    u32 m_mi_col_start { 0 };
+    u32 m_mi_col_end { 0 };
+
+    Array<Vector<bool>, 3> m_left_nonzero_context;
+    Vector<u8> m_left_seg_pred_context;
+    Vector<u8> m_left_partition_context;
+
+    // FIXME: Move (some?) mi_.. to an array of struct since they are usually used together.
+    u32 m_mi_row { 0 };
+    u32 m_mi_col { 0 };
+    BlockSubsize m_mi_size { 0 };
+    bool m_available_u { false };
+    bool m_available_l { false };
+    u8 m_segment_id { 0 };
+    // FIXME: Should this be an enum?
+    // skip equal to 0 indicates that there may be some transform coefficients to read for this block; skip equal to 1
+    // indicates that there are no transform coefficients.
+    //
+    // skip may be set to 0 even if transform blocks contain immediate end of block markers.
+    bool m_skip { false };
+    u8 m_num_8x8 { 0 };
+    bool m_has_rows { false };
+    bool m_has_cols { false };
+    TXSize m_max_tx_size { TX_4x4 };
+    BlockSubsize m_block_subsize { BlockSubsize::Block_4x4 };
+    // The row to use for getting partition tree probability lookups.
+    u32 m_row { 0 };
+    // The column to use for getting partition tree probability lookups.
+    u32 m_col { 0 };
+    TXSize m_tx_size { TX_4x4 };
+    ReferenceFramePair m_ref_frame;
+    bool m_is_inter { false };
+    bool m_is_compound { false };
+    PredictionMode m_default_intra_mode { PredictionMode::DcPred };
+    PredictionMode m_y_mode { 0 };
+    PredictionMode m_block_sub_modes[4];
+    u8 m_num_4x4_w { 0 };
+    u8 m_num_4x4_h { 0 };
+    PredictionMode m_uv_mode { 0 }; // FIXME: Is u8 the right size?
+    ReferenceFramePair m_left_ref_frame;
+    ReferenceFramePair m_above_ref_frame;
+    bool m_left_intra { false };
+    bool m_above_intra { false };
+    bool m_left_single { false };
+    bool m_above_single { false };
+    // The current block's interpolation filter.
+    InterpolationFilter m_interp_filter { EightTap };
+    MotionVectorPair m_mv;
+    MotionVectorPair m_near_mv;
+    MotionVectorPair m_nearest_mv;
+    MotionVectorPair m_best_mv;
+    u32 m_eob_total { 0 };
+    u8 m_tx_type { 0 };
+    u8 m_token_cache[1024];
+    i32 m_tokens[1024];
+    bool m_use_hp { false };
+    MotionVector m_block_mvs[2][4];
+    MotionVectorPair m_candidate_mv;
+    ReferenceFramePair m_candidate_frame;
+    u8 m_ref_mv_count { 0 };
+    MotionVectorPair m_ref_list_mv;
+    // Indexed by ReferenceFrame enum.
+    u8 m_mode_context[4] { INVALID_CASE };
+
+    // Scratch buffers for the prediction and reconstruction processes in Decoder.
+    struct {
+        Vector<i32> dequantized;
+        Vector<i32> row_or_column;
+
+        // predict_intra
+        Vector<i32> above_row;
+        Vector<i32> left_column;
+        Vector<i32> predicted_samples;
+
+        // transforms (dct, adst)
+        Vector<i32> transform_temp;
+        Vector<i64> adst_temp;
+
+        // predict_inter
+        Vector<u16> inter_horizontal;
+        Vector<u16> inter_predicted;
+        Vector<u16> inter_predicted_compound;
+    } m_decoder_buffers;
+};
+
 }
@@ -6,6 +6,7 @@
  */
 
 #include <AK/IntegralMath.h>
+#include <AK/SIMDExtras.h>
 #include <LibGfx/Size.h>
 #include <LibVideo/Color/CodingIndependentCodePoints.h>
 
@@ -349,7 +350,7 @@ u8 Decoder::adapt_prob(u8 prob, u8 counts[2])
     return merge_prob(prob, counts[0], counts[1], COUNT_SAT, MAX_UPDATE_FACTOR);
 }
 
-DecoderErrorOr<void> Decoder::predict_intra(u8 plane, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TXSize tx_size, u32 block_index)
+DecoderErrorOr<void> Decoder::predict_intra(TileContext& tile, u8 plane, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TXSize tx_size, u32 block_index)
 {
     auto& frame_buffer = get_output_buffer(plane);
 
@@ -365,11 +366,11 @@ DecoderErrorOr<void> Decoder::predict_intra(u8 plane, u32 x, u32 y, bool have_le
     //     3. Otherwise, mode is set equal to sub_modes[ blockIdx ].
     PredictionMode mode;
     if (plane > 0)
-        mode = m_parser->m_uv_mode;
-    else if (m_parser->m_mi_size >= Block_8x8)
-        mode = m_parser->m_y_mode;
+        mode = tile.m_uv_mode;
+    else if (tile.m_mi_size >= Block_8x8)
+        mode = tile.m_y_mode;
     else
-        mode = m_parser->m_block_sub_modes[block_index];
+        mode = tile.m_block_sub_modes[block_index];
 
     // The variable log2Size specifying the base 2 logarithm of the width of the transform block is set equal to txSz + 2.
     u8 log2_of_block_size = tx_size + 2;
@@ -404,7 +405,7 @@ DecoderErrorOr<void> Decoder::predict_intra(u8 plane, u32 x, u32 y, bool have_le
     //           - [1 .. block_size]
     //           - [block_size + 1 .. block_size * 2]
     //       The array indices must be offset by 1 to accommodate index -1.
-    Vector<Intermediate>& above_row = m_buffers.above_row;
+    Vector<Intermediate>& above_row = tile.m_decoder_buffers.above_row;
     DECODER_TRY_ALLOC(above_row.try_resize_and_keep_capacity(block_size * 2 + 1));
     auto above_row_at = [&](i32 index) -> Intermediate& {
         return above_row[index + 1];
@@ -452,7 +453,7 @@ DecoderErrorOr<void> Decoder::predict_intra(u8 plane, u32 x, u32 y, bool have_le
     }
 
     // The array leftCol[ i ] for i = 0..size-1 is specified by:
-    Vector<Intermediate>& left_column = m_buffers.left_column;
+    Vector<Intermediate>& left_column = tile.m_decoder_buffers.left_column;
     DECODER_TRY_ALLOC(left_column.try_resize_and_keep_capacity(block_size));
     if (have_left) {
         // − If haveLeft is equal to 1, leftCol[ i ] is set equal to CurrFrame[ plane ][ Min(maxY, y+i) ][ x-1 ].
@@ -465,7 +466,7 @@ DecoderErrorOr<void> Decoder::predict_intra(u8 plane, u32 x, u32 y, bool have_le
     }
 
     // A 2D array named pred containing the intra predicted samples is constructed as follows:
-    Vector<Intermediate>& predicted_samples = m_buffers.predicted_samples;
+    Vector<Intermediate>& predicted_samples = tile.m_decoder_buffers.predicted_samples;
     DECODER_TRY_ALLOC(predicted_samples.try_resize_and_keep_capacity(block_size * block_size));
     auto const predicted_sample_at = [&](u32 row, u32 column) -> Intermediate& {
         return predicted_samples[index_from_row_and_column(row, column, block_size)];
@@ -689,7 +690,7 @@ DecoderErrorOr<void> Decoder::predict_intra(u8 plane, u32 x, u32 y, bool have_le
     return {};
 }
 
-MotionVector Decoder::select_motion_vector(u8 plane, u8 ref_list, u32 block_index)
+MotionVector Decoder::select_motion_vector(TileContext& tile, u8 plane, u8 ref_list, u32 block_index)
 {
     // The inputs to this process are:
     // − a variable plane specifying which plane is being predicted,
@@ -721,31 +722,31 @@ MotionVector Decoder::select_motion_vector(u8 plane, u8 ref_list, u32 block_inde
     // The motion vector array mv is derived as follows:
     // − If plane is equal to 0, or MiSize is greater than or equal to BLOCK_8X8, mv is set equal to
     // BlockMvs[ refList ][ blockIdx ].
-    if (plane == 0 || m_parser->m_mi_size >= Block_8x8)
-        return m_parser->m_block_mvs[ref_list][block_index];
+    if (plane == 0 || tile.m_mi_size >= Block_8x8)
+        return tile.m_block_mvs[ref_list][block_index];
     // − Otherwise, if subsampling_x is equal to 0 and subsampling_y is equal to 0, mv is set equal to
     // BlockMvs[ refList ][ blockIdx ].
     if (!m_parser->m_subsampling_x && !m_parser->m_subsampling_y)
-        return m_parser->m_block_mvs[ref_list][block_index];
+        return tile.m_block_mvs[ref_list][block_index];
     // − Otherwise, if subsampling_x is equal to 0 and subsampling_y is equal to 1, mv[ comp ] is set equal to
     // round_mv_comp_q2( BlockMvs[ refList ][ blockIdx ][ comp ] + BlockMvs[ refList ][ blockIdx + 2 ][ comp ] )
     // for comp = 0..1.
     if (!m_parser->m_subsampling_x && m_parser->m_subsampling_y)
-        return round_mv_comp_q2(m_parser->m_block_mvs[ref_list][block_index] + m_parser->m_block_mvs[ref_list][block_index + 2]);
+        return round_mv_comp_q2(tile.m_block_mvs[ref_list][block_index] + tile.m_block_mvs[ref_list][block_index + 2]);
     // − Otherwise, if subsampling_x is equal to 1 and subsampling_y is equal to 0, mv[ comp ] is set equal to
     // round_mv_comp_q2( BlockMvs[ refList ][ blockIdx ][ comp ] + BlockMvs[ refList ][ blockIdx + 1 ][ comp ] )
     // for comp = 0..1.
     if (m_parser->m_subsampling_x && !m_parser->m_subsampling_y)
-        return round_mv_comp_q2(m_parser->m_block_mvs[ref_list][block_index] + m_parser->m_block_mvs[ref_list][block_index + 1]);
+        return round_mv_comp_q2(tile.m_block_mvs[ref_list][block_index] + tile.m_block_mvs[ref_list][block_index + 1]);
     // − Otherwise, (subsampling_x is equal to 1 and subsampling_y is equal to 1), mv[ comp ] is set equal to
     // round_mv_comp_q4( BlockMvs[ refList ][ 0 ][ comp ] + BlockMvs[ refList ][ 1 ][ comp ] +
     // BlockMvs[ refList ][ 2 ][ comp ] + BlockMvs[ refList ][ 3 ][ comp ] ) for comp = 0..1.
     VERIFY(m_parser->m_subsampling_x && m_parser->m_subsampling_y);
-    return round_mv_comp_q4(m_parser->m_block_mvs[ref_list][0] + m_parser->m_block_mvs[ref_list][1]
-        + m_parser->m_block_mvs[ref_list][2] + m_parser->m_block_mvs[ref_list][3]);
+    return round_mv_comp_q4(tile.m_block_mvs[ref_list][0] + tile.m_block_mvs[ref_list][1]
+        + tile.m_block_mvs[ref_list][2] + tile.m_block_mvs[ref_list][3]);
 }
 
-MotionVector Decoder::clamp_motion_vector(u8 plane, MotionVector vector)
+MotionVector Decoder::clamp_motion_vector(TileContext& tile, u8 plane, MotionVector vector)
 {
     // FIXME: This function is named very similarly to Parser::clamp_mv. Rename one or the other?
 
@@ -758,14 +759,14 @@ MotionVector Decoder::clamp_motion_vector(u8 plane, MotionVector vector)
     bool subsampling_y = plane > 0 ? m_parser->m_subsampling_y : false;
 
     // The output array clampedMv is specified by the following steps:
-    i32 blocks_high = num_8x8_blocks_high_lookup[m_parser->m_mi_size];
+    i32 blocks_high = num_8x8_blocks_high_lookup[tile.m_mi_size];
     // Casts must be done here to prevent subtraction underflow from wrapping the values.
-    i32 mb_to_top_edge = -(static_cast<i32>(m_parser->m_mi_row * MI_SIZE) * 16) >> subsampling_y;
-    i32 mb_to_bottom_edge = (((static_cast<i32>(m_parser->m_mi_rows) - blocks_high - static_cast<i32>(m_parser->m_mi_row)) * MI_SIZE) * 16) >> subsampling_y;
+    i32 mb_to_top_edge = -(static_cast<i32>(tile.m_mi_row * MI_SIZE) * 16) >> subsampling_y;
+    i32 mb_to_bottom_edge = (((static_cast<i32>(m_parser->m_mi_rows) - blocks_high - static_cast<i32>(tile.m_mi_row)) * MI_SIZE) * 16) >> subsampling_y;
 
-    i32 blocks_wide = num_8x8_blocks_wide_lookup[m_parser->m_mi_size];
-    i32 mb_to_left_edge = -(static_cast<i32>(m_parser->m_mi_col * MI_SIZE) * 16) >> subsampling_x;
-    i32 mb_to_right_edge = (((static_cast<i32>(m_parser->m_mi_cols) - blocks_wide - static_cast<i32>(m_parser->m_mi_col)) * MI_SIZE) * 16) >> subsampling_x;
+    i32 blocks_wide = num_8x8_blocks_wide_lookup[tile.m_mi_size];
+    i32 mb_to_left_edge = -(static_cast<i32>(tile.m_mi_col * MI_SIZE) * 16) >> subsampling_x;
+    i32 mb_to_right_edge = (((static_cast<i32>(m_parser->m_mi_cols) - blocks_wide - static_cast<i32>(tile.m_mi_col)) * MI_SIZE) * 16) >> subsampling_x;
 
     i32 subpel_left = (INTERP_EXTEND + ((blocks_wide * MI_SIZE) >> subsampling_x)) << SUBPEL_BITS;
     i32 subpel_right = subpel_left - SUBPEL_SHIFTS;
@@ -777,15 +778,37 @@ MotionVector Decoder::clamp_motion_vector(u8 plane, MotionVector vector)
     };
 }
 
-DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, u8 ref_list, u32 x, u32 y, u32 width, u32 height, u32 block_index, Vector<u16>& block_buffer)
+// Computes Round2( sum of filter[ t ] * source[ t * tap_stride ], 7 ) clipped to the bit depth for the four consecutive
+// positions starting at source, and stores the results to destination.
+static ALWAYS_INLINE void filter_four_samples(u16 const* source, size_t tap_stride, i32 const* filter, u8 bit_depth, u16* destination)
+{
+    using namespace AK::SIMD;
+
+    auto accumulated_samples = expand4(0);
+    for (auto t = 0u; t < 8u; t++) {
+        u16x4 samples;
+        __builtin_memcpy(&samples, source + (t * tap_stride), sizeof(samples));
+        accumulated_samples += filter[t] * to_i32x4(samples);
+    }
+
+    auto rounded = (accumulated_samples + 64) >> 7;
+    auto maximum = expand4((1 << bit_depth) - 1);
+    rounded = rounded < 0 ? expand4(0) : rounded;
+    rounded = rounded > maximum ? maximum : rounded;
+
+    auto result = to_u16x4(rounded);
+    __builtin_memcpy(destination, &result, sizeof(result));
+}
+
+DecoderErrorOr<void> Decoder::predict_inter_block(TileContext& tile, u8 plane, u8 ref_list, u32 x, u32 y, u32 width, u32 height, u32 block_index, Vector<u16>& block_buffer)
 {
     // 2. The motion vector selection process in section 8.5.2.1 is invoked with plane, refList, blockIdx as inputs
     // and the output being the motion vector mv.
-    auto motion_vector = select_motion_vector(plane, ref_list, block_index);
+    auto motion_vector = select_motion_vector(tile, plane, ref_list, block_index);
 
     // 3. The motion vector clamping process in section 8.5.2.2 is invoked with plane, mv as inputs and the output
     // being the clamped motion vector clampedMv
-    auto clamped_vector = clamp_motion_vector(plane, motion_vector);
+    auto clamped_vector = clamp_motion_vector(tile, plane, motion_vector);
 
     // 4. The motion vector scaling process in section 8.5.2.3 is invoked with plane, refList, x, y, clampedMv as
     // inputs and the output being the initial location startX, startY, and the step sizes stepX, stepY.
@@ -804,7 +827,7 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, u8 ref_list, u32 x,
 
     // A variable refIdx specifying which reference frame is being used is set equal to
     // ref_frame_idx[ ref_frame[ refList ] - LAST_FRAME ].
-    auto reference_frame_index = m_parser->m_ref_frame_idx[m_parser->m_ref_frame[ref_list] - LastFrame];
+    auto reference_frame_index = m_parser->m_ref_frame_idx[tile.m_ref_frame[ref_list] - LastFrame];
 
     // It is a requirement of bitstream conformance that all the following conditions are satisfied:
     // − 2 * FrameWidth >= RefFrameWidth[ refIdx ]
@@ -908,14 +931,28 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, u8 ref_list, u32 x,
     // The filtering is applied as follows:
     // The array intermediate is specified as follows:
     // Note: Height is specified by `intermediate_height`, width is specified by `width`
-    Vector<u16>& intermediate_buffer = m_buffers.inter_horizontal;
+    Vector<u16>& intermediate_buffer = tile.m_decoder_buffers.inter_horizontal;
     intermediate_buffer.clear_with_capacity();
     intermediate_buffer.resize_and_keep_capacity(intermediate_height * width);
     auto intermediate_buffer_at = [&](u32 row, u32 column) -> u16& {
         return intermediate_buffer[row * width + column];
     };
 
-    for (auto row = 0u; row < intermediate_height; row++) {
+    // Without scaling, every sample in the block uses the same filter, so four of them can be filtered at once as long
+    // as the block doesn't read past the edges of the reference frame.
+    bool can_filter_rows_four_at_a_time = scaled_step_x == 16 && (width % 4) == 0
+        && (offset_scaled_block_x >> 4) - 3 >= 0 && (offset_scaled_block_x >> 4) + static_cast<i32>(width) + 3 <= scaled_right
+        && (offset_scaled_block_y >> 4) - 3 >= 0 && (offset_scaled_block_y >> 4) + static_cast<i32>(intermediate_height) - 4 <= scaled_bottom;
+    if (can_filter_rows_four_at_a_time) {
+        auto const* filter = subpel_filters[tile.m_interp_filter][offset_scaled_block_x & 15];
+        for (auto row = 0u; row < intermediate_height; row++) {
+            auto const* source_row = &reference_frame_buffer_at((offset_scaled_block_y >> 4) + row - 3, (offset_scaled_block_x >> 4) - 3);
+            for (auto column = 0u; column < width; column += 4)
+                filter_four_samples(source_row + column, 1, filter, m_parser->m_bit_depth, &intermediate_buffer_at(row, column));
+        }
+    }
+
+    for (auto row = 0u; row < intermediate_height && !can_filter_rows_four_at_a_time; row++) {
         for (auto column = 0u; column < width; column++) {
             auto samples_start = offset_scaled_block_x + static_cast<i32>(scaled_step_x * column);
 
@@ -924,12 +961,22 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, u8 ref_list, u32 x,
                 auto sample = reference_frame_buffer_at(
                     clip_3(0, scaled_bottom, (offset_scaled_block_y >> 4) + static_cast<i32>(row) - 3),
                     clip_3(0, scaled_right, (samples_start >> 4) + static_cast<i32>(t) - 3));
-                accumulated_samples += subpel_filters[m_parser->m_interp_filter][samples_start & 15][t] * sample;
+                accumulated_samples += subpel_filters[tile.m_interp_filter][samples_start & 15][t] * sample;
             }
             intermediate_buffer_at(row, column) = clip_1(m_parser->m_bit_depth, round_2(accumulated_samples, 7));
         }
     }
 
+    // The vertical filter only reads from the intermediate array, so it never has to clip its positions.
+    if (scaled_step_y == 16 && (width % 4) == 0) {
+        auto const* filter = subpel_filters[tile.m_interp_filter][offset_scaled_block_y & 15];
+        for (auto row = 0u; row < height; row++) {
+            for (auto column = 0u; column < width; column += 4)
+                filter_four_samples(&intermediate_buffer_at(row, column), width, filter, m_parser->m_bit_depth, &block_buffer_at(row, column));
+        }
+        return {};
+    }
+
     for (auto row = 0u; row < height; row++) {
         for (auto column = 0u; column < width; column++) {
             auto samples_start = (offset_scaled_block_y & 15) + static_cast<i32>(scaled_step_y * row);
@@ -937,7 +984,7 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, u8 ref_list, u32 x,
             i32 accumulated_samples = 0;
             for (auto t = 0u; t < 8u; t++) {
                 auto sample = intermediate_buffer_at((samples_start >> 4) + t, column);
-                accumulated_samples += subpel_filters[m_parser->m_interp_filter][samples_start & 15][t] * sample;
+                accumulated_samples += subpel_filters[tile.m_interp_filter][samples_start & 15][t] * sample;
             }
             block_buffer_at(row, column) = clip_1(m_parser->m_bit_depth, round_2(accumulated_samples, 7));
         }
@@ -946,7 +993,7 @@ DecoderErrorOr<void> Decoder::predict_inter_block(u8 plane, u8 ref_list, u32 x,
     return {};
 }
 
-DecoderErrorOr<void> Decoder::predict_inter(u8 plane, u32 x, u32 y, u32 width, u32 height, u32 block_index)
+DecoderErrorOr<void> Decoder::predict_inter(TileContext& tile, u8 plane, u32 x, u32 y, u32 width, u32 height, u32 block_index)
 {
     // The inter prediction process is invoked for inter coded blocks. When MiSize is smaller than BLOCK_8X8, the
     // prediction is done with a granularity of 4x4 samples, otherwise the whole plane is predicted at the same time.
@@ -959,12 +1006,12 @@ DecoderErrorOr<void> Decoder::predict_inter(u8 plane, u32 x, u32 y, u32 width, u
     // The outputs of this process are inter predicted samples in the current frame CurrFrame.
 
     // The variable isCompound is set equal to ref_frame[ 1 ] > NONE.
-    auto is_compound = m_parser->m_ref_frame[1] > None;
+    auto is_compound = tile.m_ref_frame[1] > None;
     // The prediction arrays are formed by the following ordered steps:
     // 1. The variable refList is set equal to 0.
     // 2. through 5.
-    auto predicted_buffer = m_buffers.inter_predicted;
-    TRY(predict_inter_block(plane, 0, x, y, width, height, block_index, predicted_buffer));
+    auto& predicted_buffer = tile.m_decoder_buffers.inter_predicted;
+    TRY(predict_inter_block(tile, plane, 0, x, y, width, height, block_index, predicted_buffer));
     auto predicted_buffer_at = [&](Vector<u16>& buffer, u32 row, u32 column) -> u16& {
         return buffer[row * width + column];
     };
@@ -996,8 +1043,8 @@ DecoderErrorOr<void> Decoder::predict_inter(u8 plane, u32 x, u32 y, u32 width, u
 
     // − Otherwise, CurrFrame[ plane ][ y + i ][ x + j ] is set equal to Round2( preds[ 0 ][ i ][ j ] + preds[ 1 ][ i ][ j ], 1 )
     // for i = 0..h-1 and j = 0..w-1.
-    auto second_predicted_buffer = m_buffers.inter_predicted_compound;
-    TRY(predict_inter_block(plane, 1, x, y, width, height, block_index, second_predicted_buffer));
+    auto& second_predicted_buffer = tile.m_decoder_buffers.inter_predicted_compound;
+    TRY(predict_inter_block(tile, plane, 1, x, y, width, height, block_index, second_predicted_buffer));
 
     for (auto i = 0u; i < height_in_frame_buffer; i++) {
         for (auto j = 0u; j < width_in_frame_buffer; j++)
@@ -1033,13 +1080,13 @@ u16 Decoder::ac_q(u8 b)
     return ac_qlookup[(m_parser->m_bit_depth - 8) >> 1][clip_3<u8>(0, 255, b)];
 }
 
-u8 Decoder::get_qindex()
+u8 Decoder::get_qindex(TileContext& tile)
 {
-    // The function get_qindex( ) returns the quantizer index for the current block and is specified by the following:
+    // The function get_qindex(tile,  ) returns the quantizer index for the current block and is specified by the following:
     // − If seg_feature_active( SEG_LVL_ALT_Q ) is equal to 1 the following ordered steps apply:
-    if (m_parser->seg_feature_active(SEG_LVL_ALT_Q)) {
+    if (m_parser->seg_feature_active(tile, SEG_LVL_ALT_Q)) {
         // 1. Set the variable data equal to FeatureData[ segment_id ][ SEG_LVL_ALT_Q ].
-        auto data = m_parser->m_feature_data[m_parser->m_segment_id][SEG_LVL_ALT_Q];
+        auto data = m_parser->m_feature_data[tile.m_segment_id][SEG_LVL_ALT_Q];
 
         // 2. If segmentation_abs_or_delta_update is equal to 0, set data equal to base_q_idx + data
         if (!m_parser->m_segmentation_abs_or_delta_update) {
@@ -1054,29 +1101,29 @@ u8 Decoder::get_qindex()
     return m_parser->m_base_q_idx;
 }
 
-u16 Decoder::get_dc_quant(u8 plane)
+u16 Decoder::get_dc_quant(TileContext& tile, u8 plane)
 {
-    // The function get_dc_quant( plane ) returns the quantizer value for the dc coefficient for a particular plane and
+    // The function get_dc_quant(tile,  plane ) returns the quantizer value for the dc coefficient for a particular plane and
     // is derived as follows:
-    // − If plane is equal to 0, return dc_q( get_qindex( ) + delta_q_y_dc ).
-    // − Otherwise, return dc_q( get_qindex( ) + delta_q_uv_dc ).
+    // − If plane is equal to 0, return dc_q( get_qindex(tile,  ) + delta_q_y_dc ).
+    // − Otherwise, return dc_q( get_qindex(tile,  ) + delta_q_uv_dc ).
     // Instead of if { return }, select the value to add and return.
     i8 offset = plane == 0 ? m_parser->m_delta_q_y_dc : m_parser->m_delta_q_uv_dc;
-    return dc_q(static_cast<u8>(get_qindex() + offset));
+    return dc_q(static_cast<u8>(get_qindex(tile) + offset));
 }
 
-u16 Decoder::get_ac_quant(u8 plane)
+u16 Decoder::get_ac_quant(TileContext& tile, u8 plane)
 {
-    // The function get_ac_quant( plane ) returns the quantizer value for the ac coefficient for a particular plane and
+    // The function get_ac_quant(tile,  plane ) returns the quantizer value for the ac coefficient for a particular plane and
     // is derived as follows:
-    // − If plane is equal to 0, return ac_q( get_qindex( ) ).
-    // − Otherwise, return ac_q( get_qindex( ) + delta_q_uv_ac ).
+    // − If plane is equal to 0, return ac_q( get_qindex(tile,  ) ).
+    // − Otherwise, return ac_q( get_qindex(tile,  ) + delta_q_uv_ac ).
     // Instead of if { return }, select the value to add and return.
     i8 offset = plane == 0 ? 0 : m_parser->m_delta_q_uv_ac;
-    return ac_q(static_cast<u8>(get_qindex() + offset));
+    return ac_q(static_cast<u8>(get_qindex(tile) + offset));
 }
 
-DecoderErrorOr<void> Decoder::reconstruct(u8 plane, u32 transform_block_x, u32 transform_block_y, TXSize transform_block_size)
+DecoderErrorOr<void> Decoder::reconstruct(TileContext& tile, u8 plane, u32 transform_block_x, u32 transform_block_y, TXSize transform_block_size)
 {
     // 8.6.2 Reconstruct process
 
@@ -1087,22 +1134,22 @@ DecoderErrorOr<void> Decoder::reconstruct(u8 plane, u32 transform_block_x, u32 t
     // The variable n0 (specifying the width of the transform block) is set equal to 1 << n.
     auto block_size = 1u << log2_of_block_size;
 
-    // 1. Dequant[ i ][ j ] is set equal to ( Tokens[ i * n0 + j ] * get_ac_quant( plane ) ) / dqDenom
+    // 1. Dequant[ i ][ j ] is set equal to ( Tokens[ i * n0 + j ] * get_ac_quant(tile,  plane ) ) / dqDenom
     //    for i = 0..(n0-1), for j = 0..(n0-1)
-    Vector<Intermediate>& dequantized = m_buffers.dequantized;
+    Vector<Intermediate>& dequantized = tile.m_decoder_buffers.dequantized;
     DECODER_TRY_ALLOC(dequantized.try_resize_and_keep_capacity(buffer_size(block_size, block_size)));
-    Intermediate ac_quant = get_ac_quant(plane);
+    Intermediate ac_quant = get_ac_quant(tile, plane);
     for (auto i = 0u; i < block_size; i++) {
         for (auto j = 0u; j < block_size; j++) {
             auto index = index_from_row_and_column(i, j, block_size);
             if (index == 0)
                 continue;
-            dequantized[index] = (m_parser->m_tokens[index] * ac_quant) / dq_denominator;
+            dequantized[index] = (tile.m_tokens[index] * ac_quant) / dq_denominator;
         }
     }
 
-    // 2. Dequant[ 0 ][ 0 ] is set equal to ( Tokens[ 0 ] * get_dc_quant( plane ) ) / dqDenom
-    dequantized[0] = (m_parser->m_tokens[0] * get_dc_quant(plane)) / dq_denominator;
+    // 2. Dequant[ 0 ][ 0 ] is set equal to ( Tokens[ 0 ] * get_dc_quant(tile,  plane ) ) / dqDenom
+    dequantized[0] = (tile.m_tokens[0] * get_dc_quant(tile, plane)) / dq_denominator;
 
     // It is a requirement of bitstream conformance that the values written into the Dequant array in steps 1 and 2
     // are representable by a signed integer with 8 + BitDepth bits.
@@ -1111,7 +1158,7 @@ DecoderErrorOr<void> Decoder::reconstruct(u8 plane, u32 transform_block_x, u32 t
 
     // 3. Invoke the 2D inverse transform block process defined in section 8.7.2 with the variable n as input.
     //    The inverse transform outputs are stored back to the Dequant buffer.
-    TRY(inverse_transform_2d(dequantized, log2_of_block_size));
+    TRY(inverse_transform_2d(tile, dequantized, log2_of_block_size));
 
     // 4. CurrFrame[ plane ][ y + i ][ x + j ] is set equal to Clip1( CurrFrame[ plane ][ y + i ][ x + j ] + Dequant[ i ][ j ] )
     //    for i = 0..(n0-1) and j = 0..(n0-1).
@@ -1179,6 +1226,11 @@ inline i32 Decoder::round_2(T value, u8 bits)
     return static_cast<i32>(value);
 }
 
+inline AK::SIMD::i32x4 Decoder::round_2(AK::SIMD::i32x4 values, u8 bits)
+{
+    return (values + static_cast<i32>(1u << (bits - 1u))) >> bits;
+}
+
 inline bool check_bounds(i64 value, u8 bits)
 {
     i64 const maximum = (1ll << (bits - 1ll)) - 1ll;
@@ -1191,15 +1243,25 @@ inline bool Decoder::check_intermediate_bounds(Intermediate value)
     return value >= ~maximum && value <= maximum;
 }
 
+inline bool Decoder::check_intermediate_bounds(AK::SIMD::i32x4 values)
+{
+    auto maximum = AK::SIMD::expand4((1 << (8 + m_parser->m_bit_depth - 1)) - 1);
+    return AK::SIMD::all((values >= ~maximum) & (values <= maximum));
+}
+
 // (8.7.1.1) The function B( a, b, angle, 0 ) performs a butterfly rotation.
-inline void Decoder::butterfly_rotation_in_place(Vector<Intermediate>& data, size_t index_a, size_t index_b, u8 angle, bool flip)
+template<typename T>
+inline void Decoder::butterfly_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, u8 angle, bool flip)
 {
+    // Vectors are only used for 8-bit video, where the products of the 16-bit intermediates and the 15-bit constants
+    // can't overflow their 32-bit lanes.
+    using Product = Conditional<IsSame<T, Intermediate>, i64, T>;
     auto cos = cos64(angle);
     auto sin = sin64(angle);
     // 1. The variable x is set equal to T[ a ] * cos64( angle ) - T[ b ] * sin64( angle ).
-    i64 rotated_a = data[index_a] * cos - data[index_b] * sin;
+    Product rotated_a = data[index_a] * cos - data[index_b] * sin;
     // 2. The variable y is set equal to T[ a ] * sin64( angle ) + T[ b ] * cos64( angle ).
-    i64 rotated_b = data[index_a] * sin + data[index_b] * cos;
+    Product rotated_b = data[index_a] * sin + data[index_b] * cos;
     // 3. T[ a ] is set equal to Round2( x, 14 ).
     data[index_a] = round_2(rotated_a, 14);
     // 4. T[ b ] is set equal to Round2( y, 14 ).
@@ -1218,7 +1280,8 @@ inline void Decoder::butterfly_rotation_in_place(Vector<Intermediate>& data, siz
 }
 
 // (8.7.1.1) The function H( a, b, 0 ) performs a Hadamard rotation.
-inline void Decoder::hadamard_rotation_in_place(Vector<Intermediate>& data, size_t index_a, size_t index_b, bool flip)
+template<typename T>
+inline void Decoder::hadamard_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, bool flip)
 {
     // The function H( a, b, 1 ) performs a Hadamard rotation with flipped indices and is specified as follows:
     // 1. The function H( b, a, 0 ) is invoked.
@@ -1242,7 +1305,7 @@ inline void Decoder::hadamard_rotation_in_place(Vector<Intermediate>& data, size
     VERIFY(check_intermediate_bounds(data[index_b]));
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_permutation(Vector<Intermediate>& data, u8 log2_of_block_size)
+inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_permutation(TileContext& tile, Vector<Intermediate>& data, u8 log2_of_block_size)
 {
     u8 block_size = 1 << log2_of_block_size;
 
@@ -1252,10 +1315,10 @@ inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_per
         return DecoderError::corrupted("Block size was out of range"sv);
 
     // 1.1. A temporary array named copyT is set equal to T.
-    Vector<Intermediate>& data_copy = m_buffers.transform_temp;
-    data_copy.clear_with_capacity();
-    DECODER_TRY_ALLOC(data_copy.try_resize_and_keep_capacity(buffer_size(block_size, block_size)));
-    data_copy = data;
+    Vector<Intermediate>& data_copy = tile.m_decoder_buffers.transform_temp;
+    DECODER_TRY_ALLOC(data_copy.try_resize_and_keep_capacity(block_size));
+    for (auto i = 0u; i < block_size; i++)
+        data_copy[i] = data[i];
 
     // 1.2. T[ i ] is set equal to copyT[ brev( n, i ) ] for i = 0..((1<<n) - 1).
     for (auto i = 0u; i < block_size; i++)
@@ -1264,7 +1327,8 @@ inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_per
     return {};
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform(Vector<Intermediate>& data, u8 log2_of_block_size)
+template<typename T>
+inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform(Span<T> data, u8 log2_of_block_size)
 {
     // 2.1. The variable n0 is set equal to 1<<n.
     u8 block_size = 1 << log2_of_block_size;
@@ -1370,7 +1434,9 @@ inline void Decoder::inverse_asymmetric_discrete_sine_transform_input_array_perm
     // We can iterate by 2 at a time instead of taking half block size.
 
     // A temporary array named copyT is set equal to T.
-    temp = data;
+    temp.resize_and_keep_capacity(data.size());
+    for (auto i = 0u; i < data.size(); i++)
+        temp[i] = data[i];
 
     // The values at even locations T[ 2 * i ] are set equal to copyT[ n0 - 1 - 2 * i ] for i = 0..(n1-1).
     // The values at odd locations T[ 2 * i + 1 ] are set equal to copyT[ 2 * i ] for i = 0..(n1-1).
@@ -1383,7 +1449,9 @@ inline void Decoder::inverse_asymmetric_discrete_sine_transform_input_array_perm
 inline void Decoder::inverse_asymmetric_discrete_sine_transform_output_array_permutation(Vector<Intermediate>& data, Vector<Intermediate>& temp, u8 log2_of_block_size)
 {
     // A temporary array named copyT is set equal to T.
-    temp = data;
+    temp.resize_and_keep_capacity(data.size());
+    for (auto i = 0u; i < data.size(); i++)
+        temp[i] = data[i];
 
     // The permutation depends on n as follows:
     if (log2_of_block_size == 4) {
@@ -1508,14 +1576,14 @@ inline void Decoder::hadamard_rotation(Vector<S>& source, Vector<D>& destination
     destination[index_b] = round_2(a - b, 14);
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_8(Vector<Intermediate>& data)
+inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_8(TileContext& tile, Vector<Intermediate>& data)
 {
     VERIFY(data.size() == 8);
 
     // This process does an in-place transform of the array T using:
 
     // A higher precision array S for intermediate results.
-    Vector<i64>& high_precision_temp = m_buffers.adst_temp;
+    Vector<i64>& high_precision_temp = tile.m_decoder_buffers.adst_temp;
     high_precision_temp.clear_with_capacity();
     DECODER_TRY_ALLOC(high_precision_temp.try_resize_and_keep_capacity(8));
 
@@ -1523,7 +1591,7 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
 
     // 1. Invoke the ADST input array permutation process specified in section 8.7.1.4 with the input variable n set
     //    equal to 3.
-    inverse_asymmetric_discrete_sine_transform_input_array_permutation(data, m_buffers.transform_temp, 3);
+    inverse_asymmetric_discrete_sine_transform_input_array_permutation(data, tile.m_decoder_buffers.transform_temp, 3);
 
     // 2. Invoke SB( 2*i, 1+2*i, 30-8*i, 1 ) for i = 0..3.
     for (auto i = 0u; i < 4; i++)
@@ -1549,15 +1617,15 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
 
     // 6. Invoke H( i, 2+i, 0 ) for i = 0..1.
     for (auto i = 0u; i < 2; i++)
-        hadamard_rotation_in_place(data, i, 2 + i, false);
+        hadamard_rotation_in_place(data.span(), i, 2 + i, false);
 
     // 7. Invoke B( 2+4*i, 3+4*i, 16, 1 ) for i = 0..1.
     for (auto i = 0u; i < 2; i++)
-        butterfly_rotation_in_place(data, 2 + (4 * i), 3 + (4 * i), 16, true);
+        butterfly_rotation_in_place(data.span(), 2 + (4 * i), 3 + (4 * i), 16, true);
 
     // 8. Invoke the ADST output array permutation process specified in section 8.7.1.5 with the input variable n
     //    set equal to 3.
-    inverse_asymmetric_discrete_sine_transform_output_array_permutation(data, m_buffers.transform_temp, 3);
+    inverse_asymmetric_discrete_sine_transform_output_array_permutation(data, tile.m_decoder_buffers.transform_temp, 3);
 
     // 9. Set T[ 1+2*i ] equal to -T[ 1+2*i ] for i = 0..3.
     for (auto i = 0u; i < 4; i++) {
@@ -1567,13 +1635,13 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
     return {};
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_16(Vector<Intermediate>& data)
+inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_16(TileContext& tile, Vector<Intermediate>& data)
 {
     VERIFY(data.size() == 16);
     // This process does an in-place transform of the array T using:
 
     // A higher precision array S for intermediate results.
-    Vector<i64>& high_precision_temp = m_buffers.adst_temp;
+    Vector<i64>& high_precision_temp = tile.m_decoder_buffers.adst_temp;
     high_precision_temp.clear_with_capacity();
     DECODER_TRY_ALLOC(high_precision_temp.try_resize_and_keep_capacity(16));
 
@@ -1581,7 +1649,7 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
 
     // 1. Invoke the ADST input array permutation process specified in section 8.7.1.4 with the input variable n set
     // equal to 4.
-    inverse_asymmetric_discrete_sine_transform_input_array_permutation(data, m_buffers.transform_temp, 4);
+    inverse_asymmetric_discrete_sine_transform_input_array_permutation(data, tile.m_decoder_buffers.transform_temp, 4);
 
     // 2. Invoke SB( 2*i, 1+2*i, 31-4*i, 1 ) for i = 0..7.
     for (auto i = 0u; i < 8; i++)
@@ -1608,7 +1676,7 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
 
     // 6. Invoke H( i, 4+i, 0 ) for i = 0..3.
     for (auto i = 0u; i < 4; i++)
-        hadamard_rotation_in_place(data, i, 4 + i, false);
+        hadamard_rotation_in_place(data.span(), i, 4 + i, false);
 
     // 7. Invoke SB( 4+8*i+3*j, 5+8*i+j, 24-16*j, 1 ) for i = 0..1, for j = 0..1.
     for (auto i = 0u; i < 2; i++)
@@ -1625,15 +1693,15 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
     // 9. Invoke H( 8*j+i, 2+8*j+i, 0 ) for i = 0..1, for j = 0..1.
     for (auto i = 0u; i < 2; i++)
         for (auto j = 0u; j < 2; j++)
-            hadamard_rotation_in_place(data, (8 * j) + i, 2 + (8 * j) + i, false);
+            hadamard_rotation_in_place(data.span(), (8 * j) + i, 2 + (8 * j) + i, false);
     // 10. Invoke B( 2+4*j+8*i, 3+4*j+8*i, 48+64*(i^j), 0 ) for i = 0..1, for j = 0..1.
     for (auto i = 0u; i < 2; i++)
         for (auto j = 0u; j < 2; j++)
-            butterfly_rotation_in_place(data, 2 + (4 * j) + (8 * i), 3 + (4 * j) + (8 * i), 48 + (64 * (i ^ j)), false);
+            butterfly_rotation_in_place(data.span(), 2 + (4 * j) + (8 * i), 3 + (4 * j) + (8 * i), 48 + (64 * (i ^ j)), false);
 
     // 11. Invoke the ADST output array permutation process specified in section 8.7.1.5 with the input variable n
     // set equal to 4.
-    inverse_asymmetric_discrete_sine_transform_output_array_permutation(data, m_buffers.transform_temp, 4);
+    inverse_asymmetric_discrete_sine_transform_output_array_permutation(data, tile.m_decoder_buffers.transform_temp, 4);
 
     // 12. Set T[ 1+12*j+2*i ] equal to -T[ 1+12*j+2*i ] for i = 0..1, for j = 0..1.
     for (auto i = 0u; i < 2; i++) {
@@ -1645,7 +1713,7 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform_
     return {};
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform(Vector<Intermediate>& data, u8 log2_of_block_size)
+inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform(TileContext& tile, Vector<Intermediate>& data, u8 log2_of_block_size)
 {
     // 8.7.1.9 Inverse ADST Process
 
@@ -1660,13 +1728,54 @@ inline DecoderErrorOr<void> Decoder::inverse_asymmetric_discrete_sine_transform(
         return {};
     } else if (log2_of_block_size == 3) {
         // − Otherwise if n is equal to 3, invoke the Inverse ADST8 process specified in section 8.7.1.7.
-        return inverse_asymmetric_discrete_sine_transform_8(data);
+        return inverse_asymmetric_discrete_sine_transform_8(tile, data);
     }
     // − Otherwise (n is equal to 4), invoke the Inverse ADST16 process specified in section 8.7.1.8.
-    return inverse_asymmetric_discrete_sine_transform_16(data);
+    return inverse_asymmetric_discrete_sine_transform_16(tile, data);
+}
+
+DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_four_at_a_time(Vector<Intermediate>& dequantized, u8 log2_of_block_size, TransformDirection direction)
+{
+    if (log2_of_block_size < 2 || log2_of_block_size > 5)
+        return DecoderError::corrupted("Block size was out of range"sv);
+
+    auto block_size = 1u << log2_of_block_size;
+    // Lane k of T[ i ] holds the i-th value of the k-th row or column of the group.
+    auto element_index = [&](u32 group, u32 lane, u32 position) {
+        if (direction == TransformDirection::Rows)
+            return index_from_row_and_column(group + lane, position, block_size);
+        return index_from_row_and_column(position, group + lane, block_size);
+    };
+
+    Array<AK::SIMD::i32x4, 32> lanes;
+    auto data = lanes.span().trim(block_size);
+    for (auto group = 0u; group < block_size; group += 4) {
+        // 1. Set T[ i ] equal to the i-th value of each row or column, and invoke the inverse DCT permutation process
+        //    as specified in section 8.7.1.2 by reading them in the permuted order.
+        for (auto i = 0u; i < block_size; i++) {
+            auto position = brev(log2_of_block_size, i);
+            data[i] = AK::SIMD::i32x4 {
+                dequantized[element_index(group, 0, position)],
+                dequantized[element_index(group, 1, position)],
+                dequantized[element_index(group, 2, position)],
+                dequantized[element_index(group, 3, position)],
+            };
+        }
+
+        // 2. Invoke the inverse DCT process as specified in section 8.7.1.3 with the input variable n.
+        TRY(inverse_discrete_cosine_transform(data, log2_of_block_size));
+
+        // 3. Store each lane of T back to its row or column.
+        for (auto i = 0u; i < block_size; i++) {
+            for (auto lane = 0u; lane < 4; lane++)
+                dequantized[element_index(group, lane, i)] = data[i][lane];
+        }
+    }
+
+    return {};
 }
 
-DecoderErrorOr<void> Decoder::inverse_transform_2d(Vector<Intermediate>& dequantized, u8 log2_of_block_size)
+DecoderErrorOr<void> Decoder::inverse_transform_2d(TileContext& tile, Vector<Intermediate>& dequantized, u8 log2_of_block_size)
 {
     // This process performs a 2D inverse transform for an array of size 2^n by 2^n stored in the 2D array Dequant.
     // The input to this process is a variable n (log2_of_block_size) that specifies the base 2 logarithm of the width of the transform.
@@ -1674,92 +1783,101 @@ DecoderErrorOr<void> Decoder::inverse_transform_2d(Vector<Intermediate>& dequant
     // 1. Set the variable n0 (block_size) equal to 1 << n.
     auto block_size = 1u << log2_of_block_size;
 
-    Vector<Intermediate>& row_or_column = m_buffers.row_or_column;
+    Vector<Intermediate>& row_or_column = tile.m_decoder_buffers.row_or_column;
     DECODER_TRY_ALLOC(row_or_column.try_resize_and_keep_capacity(block_size));
 
+    // The inverse DCT can run on four rows or columns at once for 8-bit video, see butterfly_rotation_in_place().
+    bool can_use_vectors = m_parser->m_bit_depth == 8 && !m_parser->m_lossless;
+
     // 2. The row transforms with i = 0..(n0-1) are applied as follows:
-    for (auto i = 0u; i < block_size; i++) {
-        // 1. Set T[ j ] equal to Dequant[ i ][ j ] for j = 0..(n0-1).
-        for (auto j = 0u; j < block_size; j++)
-            row_or_column[j] = dequantized[index_from_row_and_column(i, j, block_size)];
+    if (can_use_vectors && (tile.m_tx_type == DCT_DCT || tile.m_tx_type == ADST_DCT)) {
+        TRY(inverse_discrete_cosine_transform_four_at_a_time(dequantized, log2_of_block_size, TransformDirection::Rows));
+    } else {
+        for (auto i = 0u; i < block_size; i++) {
+            // 1. Set T[ j ] equal to Dequant[ i ][ j ] for j = 0..(n0-1).
+            for (auto j = 0u; j < block_size; j++)
+                row_or_column[j] = dequantized[index_from_row_and_column(i, j, block_size)];
 
-        // 2. If Lossless is equal to 1, invoke the Inverse WHT process as specified in section 8.7.1.10 with shift equal
-        //    to 2.
-        if (m_parser->m_lossless) {
-            TRY(inverse_walsh_hadamard_transform(row_or_column, log2_of_block_size, 2));
-            continue;
-        }
-        switch (m_parser->m_tx_type) {
-        case DCT_DCT:
-        case ADST_DCT:
-            // Otherwise, if TxType is equal to DCT_DCT or TxType is equal to ADST_DCT, apply an inverse DCT as
-            // follows:
-            // 1. Invoke the inverse DCT permutation process as specified in section 8.7.1.2 with the input variable n.
-            TRY(inverse_discrete_cosine_transform_array_permutation(row_or_column, log2_of_block_size));
-            // 2. Invoke the inverse DCT process as specified in section 8.7.1.3 with the input variable n.
-            TRY(inverse_discrete_cosine_transform(row_or_column, log2_of_block_size));
-            break;
-        case DCT_ADST:
-        case ADST_ADST:
-            // 4. Otherwise (TxType is equal to DCT_ADST or TxType is equal to ADST_ADST), invoke the inverse ADST
-            //    process as specified in section 8.7.1.9 with input variable n.
-            TRY(inverse_asymmetric_discrete_sine_transform(row_or_column, log2_of_block_size));
-            break;
-        default:
-            return DecoderError::corrupted("Unknown tx_type"sv);
-        }
+            // 2. If Lossless is equal to 1, invoke the Inverse WHT process as specified in section 8.7.1.10 with shift equal
+            //    to 2.
+            if (m_parser->m_lossless) {
+                TRY(inverse_walsh_hadamard_transform(row_or_column, log2_of_block_size, 2));
+                continue;
+            }
+            switch (tile.m_tx_type) {
+            case DCT_DCT:
+            case ADST_DCT:
+                // Otherwise, if TxType is equal to DCT_DCT or TxType is equal to ADST_DCT, apply an inverse DCT as
+                // follows:
+                // 1. Invoke the inverse DCT permutation process as specified in section 8.7.1.2 with the input variable n.
+                TRY(inverse_discrete_cosine_transform_array_permutation(tile, row_or_column, log2_of_block_size));
+                // 2. Invoke the inverse DCT process as specified in section 8.7.1.3 with the input variable n.
+                TRY(inverse_discrete_cosine_transform(row_or_column.span(), log2_of_block_size));
+                break;
+            case DCT_ADST:
+            case ADST_ADST:
+                // 4. Otherwise (TxType is equal to DCT_ADST or TxType is equal to ADST_ADST), invoke the inverse ADST
+                //    process as specified in section 8.7.1.9 with input variable n.
+                TRY(inverse_asymmetric_discrete_sine_transform(tile, row_or_column, log2_of_block_size));
+                break;
+            default:
+                return DecoderError::corrupted("Unknown tx_type"sv);
+            }
 
-        // 5. Set Dequant[ i ][ j ] equal to T[ j ] for j = 0..(n0-1).
-        for (auto j = 0u; j < block_size; j++)
-            dequantized[index_from_row_and_column(i, j, block_size)] = row_or_column[j];
+            // 5. Set Dequant[ i ][ j ] equal to T[ j ] for j = 0..(n0-1).
+            for (auto j = 0u; j < block_size; j++)
+                dequantized[index_from_row_and_column(i, j, block_size)] = row_or_column[j];
+        }
     }
 
     // 3. The column transforms with j = 0..(n0-1) are applied as follows:
-    for (auto j = 0u; j < block_size; j++) {
-        // 1. Set T[ i ] equal to Dequant[ i ][ j ] for i = 0..(n0-1).
-        for (auto i = 0u; i < block_size; i++)
-            row_or_column[i] = dequantized[index_from_row_and_column(i, j, block_size)];
-
-        // 2. If Lossless is equal to 1, invoke the Inverse WHT process as specified in section 8.7.1.10 with shift equal
-        //    to 0.
-        if (m_parser->m_lossless) {
-            TRY(inverse_walsh_hadamard_transform(row_or_column, log2_of_block_size, 2));
-            continue;
-        }
-        switch (m_parser->m_tx_type) {
-        case DCT_DCT:
-        case DCT_ADST:
-            // Otherwise, if TxType is equal to DCT_DCT or TxType is equal to DCT_ADST, apply an inverse DCT as
-            // follows:
-            // 1. Invoke the inverse DCT permutation process as specified in section 8.7.1.2 with the input variable n.
-            TRY(inverse_discrete_cosine_transform_array_permutation(row_or_column, log2_of_block_size));
-            // 2. Invoke the inverse DCT process as specified in section 8.7.1.3 with the input variable n.
-            TRY(inverse_discrete_cosine_transform(row_or_column, log2_of_block_size));
-            break;
-        case ADST_DCT:
-        case ADST_ADST:
-            // 4. Otherwise (TxType is equal to ADST_DCT or TxType is equal to ADST_ADST), invoke the inverse ADST
-            //    process as specified in section 8.7.1.9 with input variable n.
-            TRY(inverse_asymmetric_discrete_sine_transform(row_or_column, log2_of_block_size));
-            break;
-        default:
-            VERIFY_NOT_REACHED();
-        }
+    if (can_use_vectors && (tile.m_tx_type == DCT_DCT || tile.m_tx_type == DCT_ADST)) {
+        TRY(inverse_discrete_cosine_transform_four_at_a_time(dequantized, log2_of_block_size, TransformDirection::Columns));
+    } else {
+        for (auto j = 0u; j < block_size; j++) {
+            // 1. Set T[ i ] equal to Dequant[ i ][ j ] for i = 0..(n0-1).
+            for (auto i = 0u; i < block_size; i++)
+                row_or_column[i] = dequantized[index_from_row_and_column(i, j, block_size)];
 
-        // 5. If Lossless is equal to 1, set Dequant[ i ][ j ] equal to T[ i ] for i = 0..(n0-1).
-        for (auto i = 0u; i < block_size; i++)
-            dequantized[index_from_row_and_column(i, j, block_size)] = row_or_column[i];
-
-        // 6. Otherwise (Lossless is equal to 0), set Dequant[ i ][ j ] equal to Round2( T[ i ], Min( 6, n + 2 ) )
-        //    for i = 0..(n0-1).
-        if (!m_parser->m_lossless) {
-            for (auto i = 0u; i < block_size; i++) {
-                auto index = index_from_row_and_column(i, j, block_size);
-                dequantized[index] = round_2(dequantized[index], min(6, log2_of_block_size + 2));
+            // 2. If Lossless is equal to 1, invoke the Inverse WHT process as specified in section 8.7.1.10 with shift equal
+            //    to 0.
+            if (m_parser->m_lossless) {
+                TRY(inverse_walsh_hadamard_transform(row_or_column, log2_of_block_size, 2));
+                continue;
+            }
+            switch (tile.m_tx_type) {
+            case DCT_DCT:
+            case DCT_ADST:
+                // Otherwise, if TxType is equal to DCT_DCT or TxType is equal to DCT_ADST, apply an inverse DCT as
+                // follows:
+                // 1. Invoke the inverse DCT permutation process as specified in section 8.7.1.2 with the input variable n.
+                TRY(inverse_discrete_cosine_transform_array_permutation(tile, row_or_column, log2_of_block_size));
+                // 2. Invoke the inverse DCT process as specified in section 8.7.1.3 with the input variable n.
+                TRY(inverse_discrete_cosine_transform(row_or_column.span(), log2_of_block_size));
+                break;
+            case ADST_DCT:
+            case ADST_ADST:
+                // 4. Otherwise (TxType is equal to ADST_DCT or TxType is equal to ADST_ADST), invoke the inverse ADST
+                //    process as specified in section 8.7.1.9 with input variable n.
+                TRY(inverse_asymmetric_discrete_sine_transform(tile, row_or_column, log2_of_block_size));
+                break;
+            default:
+                VERIFY_NOT_REACHED();
             }
+
+            // 5. If Lossless is equal to 1, set Dequant[ i ][ j ] equal to T[ i ] for i = 0..(n0-1).
+            for (auto i = 0u; i < block_size; i++)
+                dequantized[index_from_row_and_column(i, j, block_size)] = row_or_column[i];
         }
     }
 
+    // 6. Otherwise (Lossless is equal to 0), set Dequant[ i ][ j ] equal to Round2( T[ i ], Min( 6, n + 2 ) )
+    //    for i = 0..(n0-1).
+    if (!m_parser->m_lossless) {
+        for (auto i = 0u; i < buffer_size(block_size, block_size); i++)
+            dequantized[i] = round_2(dequantized[i], min(6, log2_of_block_size + 2));
+    }
+
     return {};
 }
 
@@ -11,6 +11,7 @@
 #include <AK/Error.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Queue.h>
+#include <AK/SIMD.h>
 #include <AK/Span.h>
 #include <LibVideo/Color/CodingIndependentCodePoints.h>
 #include <LibVideo/DecoderError.h>
@@ -53,18 +54,18 @@ private:
 
     /* (8.5) Prediction Processes */
     // (8.5.1) Intra prediction process
-    DecoderErrorOr<void> predict_intra(u8 plane, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TXSize tx_size, u32 block_index);
+    DecoderErrorOr<void> predict_intra(TileContext&, u8 plane, u32 x, u32 y, bool have_left, bool have_above, bool not_on_right, TXSize tx_size, u32 block_index);
 
     // (8.5.1) Inter prediction process
-    DecoderErrorOr<void> predict_inter(u8 plane, u32 x, u32 y, u32 width, u32 height, u32 block_index);
+    DecoderErrorOr<void> predict_inter(TileContext&, u8 plane, u32 x, u32 y, u32 width, u32 height, u32 block_index);
     // (8.5.2.1) Motion vector selection process
-    MotionVector select_motion_vector(u8 plane, u8 ref_list, u32 block_index);
+    MotionVector select_motion_vector(TileContext&, u8 plane, u8 ref_list, u32 block_index);
     // (8.5.2.2) Motion vector clamping process
-    MotionVector clamp_motion_vector(u8 plane, MotionVector vector);
+    MotionVector clamp_motion_vector(TileContext&, u8 plane, MotionVector vector);
     // (8.5.2.3) Motion vector scaling process
     DecoderErrorOr<MotionVector> scale_motion_vector(u8 plane, u8 ref_list, u32 x, u32 y, MotionVector vector);
     // From (8.5.1) Inter prediction process, steps 2-5
-    DecoderErrorOr<void> predict_inter_block(u8 plane, u8 ref_list, u32 x, u32 y, u32 width, u32 height, u32 block_index, Vector<u16>& buffer);
+    DecoderErrorOr<void> predict_inter_block(TileContext&, u8 plane, u8 ref_list, u32 x, u32 y, u32 width, u32 height, u32 block_index, Vector<u16>& buffer);
 
     /* (8.6) Reconstruction and Dequantization */
 
@@ -72,17 +73,23 @@ private:
     u16 dc_q(u8 b);
     u16 ac_q(u8 b);
     // Returns the quantizer index for the current block
-    u8 get_qindex();
+    u8 get_qindex(TileContext&);
     // Returns the quantizer value for the dc coefficient for a particular plane
-    u16 get_dc_quant(u8 plane);
+    u16 get_dc_quant(TileContext&, u8 plane);
     // Returns the quantizer value for the ac coefficient for a particular plane
-    u16 get_ac_quant(u8 plane);
+    u16 get_ac_quant(TileContext&, u8 plane);
 
     // (8.6.2) Reconstruct process
-    DecoderErrorOr<void> reconstruct(u8 plane, u32 transform_block_x, u32 transform_block_y, TXSize transform_block_size);
+    DecoderErrorOr<void> reconstruct(TileContext&, u8 plane, u32 transform_block_x, u32 transform_block_y, TXSize transform_block_size);
 
     // (8.7) Inverse transform process
-    DecoderErrorOr<void> inverse_transform_2d(Vector<Intermediate>& dequantized, u8 log2_of_block_size);
+    DecoderErrorOr<void> inverse_transform_2d(TileContext&, Vector<Intermediate>& dequantized, u8 log2_of_block_size);
+    enum class TransformDirection {
+        Rows,
+        Columns,
+    };
+    // Applies the inverse DCT (including its permutation) to all rows or columns of Dequant, four of them at a time.
+    DecoderErrorOr<void> inverse_discrete_cosine_transform_four_at_a_time(Vector<Intermediate>& dequantized, u8 log2_of_block_size, TransformDirection);
 
     // (8.7.1) 1D Transforms
     // (8.7.1.1) Butterfly functions
@@ -90,9 +97,12 @@ private:
     inline i32 cos64(u8 angle);
     inline i32 sin64(u8 angle);
     // The function B( a, b, angle, 0 ) performs a butterfly rotation.
-    inline void butterfly_rotation_in_place(Vector<Intermediate>& data, size_t index_a, size_t index_b, u8 angle, bool flip);
+    // The in-place rotations and the inverse DCT also take vectors of four intermediates, see inverse_transform_2d().
+    template<typename T>
+    inline void butterfly_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, u8 angle, bool flip);
     // The function H( a, b, 0 ) performs a Hadamard rotation.
-    inline void hadamard_rotation_in_place(Vector<Intermediate>& data, size_t index_a, size_t index_b, bool flip);
+    template<typename T>
+    inline void hadamard_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, bool flip);
     // The function SB( a, b, angle, 0 ) performs a butterfly rotation.
     // Spec defines the source as array T, and the destination array as S.
     template<typename S, typename D>
@@ -104,17 +114,20 @@ private:
 
     template<typename T>
     inline i32 round_2(T value, u8 bits);
+    inline AK::SIMD::i32x4 round_2(AK::SIMD::i32x4 values, u8 bits);
 
     // Checks whether the value is representable by a signed integer with (8 + bit_depth) bits.
     inline bool check_intermediate_bounds(Intermediate value);
+    inline bool check_intermediate_bounds(AK::SIMD::i32x4 values);
 
     // (8.7.1.10) This process does an in-place Walsh-Hadamard transform of the array T (of length 4).
     inline DecoderErrorOr<void> inverse_walsh_hadamard_transform(Vector<Intermediate>& data, u8 log2_of_block_size, u8 shift);
 
     // (8.7.1.2) Inverse DCT array permutation process
-    inline DecoderErrorOr<void> inverse_discrete_cosine_transform_array_permutation(Vector<Intermediate>& data, u8 log2_of_block_size);
+    inline DecoderErrorOr<void> inverse_discrete_cosine_transform_array_permutation(TileContext&, Vector<Intermediate>& data, u8 log2_of_block_size);
     // (8.7.1.3) Inverse DCT process
-    inline DecoderErrorOr<void> inverse_discrete_cosine_transform(Vector<Intermediate>& data, u8 log2_of_block_size);
+    template<typename T>
+    inline DecoderErrorOr<void> inverse_discrete_cosine_transform(Span<T> data, u8 log2_of_block_size);
 
     // (8.7.1.4) This process performs the in-place permutation of the array T of length 2 n which is required as the first step of
     // the inverse ADST.
@@ -127,12 +140,12 @@ private:
     inline void inverse_asymmetric_discrete_sine_transform_4(Vector<Intermediate>& data);
     // (8.7.1.7) This process does an in-place transform of the array T using a higher precision array S for intermediate
     // results.
-    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform_8(Vector<Intermediate>& data);
+    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform_8(TileContext&, Vector<Intermediate>& data);
     // (8.7.1.8) This process does an in-place transform of the array T using a higher precision array S for intermediate
     // results.
-    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform_16(Vector<Intermediate>& data);
+    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform_16(TileContext&, Vector<Intermediate>& data);
     // (8.7.1.9) This process performs an in-place inverse ADST process on the array T of size 2 n for 2 ≤ n ≤ 4.
-    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform(Vector<Intermediate>& data, u8 log2_of_block_size);
+    inline DecoderErrorOr<void> inverse_asymmetric_discrete_sine_transform(TileContext&, Vector<Intermediate>& data, u8 log2_of_block_size);
 
     /* (8.10) Reference Frame Update Process */
     DecoderErrorOr<void> update_reference_frames();
@@ -149,23 +162,7 @@ private:
         //        functions in Decoder.cpp and functions returning row * width + column
         //        should be replaced if possible.
 
-        Vector<Intermediate> dequantized;
-        Vector<Intermediate> row_or_column;
-
-        // predict_intra
-        Vector<Intermediate> above_row;
-        Vector<Intermediate> left_column;
-        Vector<Intermediate> predicted_samples;
-
-        // transforms (dct, adst)
-        Vector<Intermediate> transform_temp;
-        Vector<i64> adst_temp;
-
-        // predict_inter
-        Vector<u16> inter_horizontal;
-        Vector<u16> inter_predicted;
-        Vector<u16> inter_predicted_compound;
-
+        // The per-block scratch buffers are in TileContext, so that tiles can be decoded in parallel.
         Vector<Intermediate> intermediate[3];
         Vector<u16> output[3];
     } m_buffers;
@@ -8,6 +8,7 @@
 #include <AK/String.h>
 #include <LibGfx/Point.h>
 #include <LibGfx/Size.h>
+#include <LibThreading/ThreadPool.h>
 
 #include "Decoder.h"
 #include "Parser.h"
@@ -597,8 +598,8 @@ u8 Parser::inv_recenter_nonneg(u8 v, u8 m)
 
 DecoderErrorOr<void> Parser::read_coef_probs()
 {
-    m_max_tx_size = tx_mode_to_biggest_tx_size[m_tx_mode];
-    for (u8 tx_size = 0; tx_size <= m_max_tx_size; tx_size++) {
+    auto max_tx_size = tx_mode_to_biggest_tx_size[m_tx_mode];
+    for (u8 tx_size = 0; tx_size <= max_tx_size; tx_size++) {
         auto update_probs = TRY_READ(m_bit_stream->read_literal(1));
         if (update_probs == 1) {
             for (auto i = 0; i < 2; i++) {
@@ -833,7 +834,11 @@ DecoderErrorOr<void> Parser::decode_tiles()
     auto tile_rows = 1 << m_tile_rows_log2;
     TRY(allocate_tile_data());
     clear_above_context();
+
+    Vector<TileContext> tiles;
+    DECODER_TRY_ALLOC(tiles.try_ensure_capacity(tile_cols));
     for (auto tile_row = 0; tile_row < tile_rows; tile_row++) {
+        tiles.clear_with_capacity();
         for (auto tile_col = 0; tile_col < tile_cols; tile_col++) {
             auto last_tile = (tile_row == tile_rows - 1) && (tile_col == tile_cols - 1);
             u64 tile_size;
@@ -842,14 +847,39 @@ DecoderErrorOr<void> Parser::decode_tiles()
             else
                 tile_size = TRY_READ(m_bit_stream->read_bits(32));
 
-            m_mi_row_start = get_tile_offset(tile_row, m_mi_rows, m_tile_rows_log2);
-            m_mi_row_end = get_tile_offset(tile_row + 1, m_mi_rows, m_tile_rows_log2);
-            m_mi_col_start = get_tile_offset(tile_col, m_mi_cols, m_tile_cols_log2);
-            m_mi_col_end = get_tile_offset(tile_col + 1, m_mi_cols, m_tile_cols_log2);
-            TRY_READ(m_bit_stream->init_bool(tile_size));
-            TRY(decode_tile());
-            TRY_READ(m_bit_stream->exit_bool());
+            auto mi_row_start = get_tile_offset(tile_row, m_mi_rows, m_tile_rows_log2);
+            auto mi_row_end = get_tile_offset(tile_row + 1, m_mi_rows, m_tile_rows_log2);
+            auto mi_col_start = get_tile_offset(tile_col, m_mi_cols, m_tile_cols_log2);
+            auto mi_col_end = get_tile_offset(tile_col + 1, m_mi_cols, m_tile_cols_log2);
+            auto tile_bit_stream = TRY_READ(m_bit_stream->read_sub_stream(tile_size));
+            DECODER_TRY_ALLOC(tiles.try_empend(tile_bit_stream, mi_row_start, mi_row_end, mi_col_start, mi_col_end));
         }
+
+        TRY(decode_tile_row(tiles));
+        for (auto& tile : tiles)
+            *m_syntax_element_counter += tile.m_syntax_element_counter;
+    }
+    return {};
+}
+
+DecoderErrorOr<void> Parser::decode_tile_row(Vector<TileContext>& tiles)
+{
+    if (tiles.size() == 1)
+        return decode_tile(tiles.first());
+
+    // The tiles of a row only share the above contexts, which each of them accesses at its own columns, so they can
+    // all be decoded at the same time.
+    Vector<Optional<DecoderError>> errors;
+    DECODER_TRY_ALLOC(errors.try_resize(tiles.size()));
+    Threading::ThreadPool::the().parallel_for(tiles.size(), [&](size_t index) {
+        auto result = decode_tile(tiles[index]);
+        if (result.is_error())
+            errors[index] = result.release_error();
+    });
+
+    for (auto& error : errors) {
+        if (error.has_value())
+            return error.release_value();
     }
     return {};
 }
@@ -885,61 +915,63 @@ u32 Parser::get_tile_offset(u32 tile_num, u32 mis, u32 tile_size_log2)
     return min(offset, mis);
 }
 
-DecoderErrorOr<void> Parser::decode_tile()
+DecoderErrorOr<void> Parser::decode_tile(TileContext& tile)
 {
-    for (auto row = m_mi_row_start; row < m_mi_row_end; row += 8) {
-        clear_left_context();
-        for (auto col = m_mi_col_start; col < m_mi_col_end; col += 8) {
-            TRY(decode_partition(row, col, Block_64x64));
+    TRY_READ(tile.m_bit_stream.init_bool(tile.m_bit_stream.bytes_remaining()));
+    for (auto row = tile.m_mi_row_start; row < tile.m_mi_row_end; row += 8) {
+        clear_left_context(tile);
+        for (auto col = tile.m_mi_col_start; col < tile.m_mi_col_end; col += 8) {
+            TRY(decode_partition(tile, row, col, Block_64x64));
         }
     }
+    TRY_READ(tile.m_bit_stream.exit_bool());
     return {};
 }
 
-void Parser::clear_left_context()
+void Parser::clear_left_context(TileContext& tile)
 {
-    for (auto i = 0u; i < m_left_nonzero_context.size(); i++)
-        clear_context(m_left_nonzero_context[i], 2 * m_mi_rows);
-    clear_context(m_left_seg_pred_context, m_mi_rows);
-    clear_context(m_left_partition_context, m_sb64_rows * 8);
+    for (auto i = 0u; i < tile.m_left_nonzero_context.size(); i++)
+        clear_context(tile.m_left_nonzero_context[i], 2 * m_mi_rows);
+    clear_context(tile.m_left_seg_pred_context, m_mi_rows);
+    clear_context(tile.m_left_partition_context, m_sb64_rows * 8);
 }
 
-DecoderErrorOr<void> Parser::decode_partition(u32 row, u32 col, BlockSubsize block_subsize)
+DecoderErrorOr<void> Parser::decode_partition(TileContext& tile, u32 row, u32 col, BlockSubsize block_subsize)
 {
     if (row >= m_mi_rows || col >= m_mi_cols)
         return {};
-    m_block_subsize = block_subsize;
-    m_num_8x8 = num_8x8_blocks_wide_lookup[block_subsize];
-    auto half_block_8x8 = m_num_8x8 >> 1;
-    m_has_rows = (row + half_block_8x8) < m_mi_rows;
-    m_has_cols = (col + half_block_8x8) < m_mi_cols;
-    m_row = row;
-    m_col = col;
-    auto partition = TRY_READ(TreeParser::parse_partition(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, m_has_rows, m_has_cols, m_block_subsize, m_num_8x8, m_above_partition_context, m_left_partition_context, row, col, m_frame_is_intra));
+    tile.m_block_subsize = block_subsize;
+    tile.m_num_8x8 = num_8x8_blocks_wide_lookup[block_subsize];
+    auto half_block_8x8 = tile.m_num_8x8 >> 1;
+    tile.m_has_rows = (row + half_block_8x8) < m_mi_rows;
+    tile.m_has_cols = (col + half_block_8x8) < m_mi_cols;
+    tile.m_row = row;
+    tile.m_col = col;
+    auto partition = TRY_READ(TreeParser::parse_partition(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, tile.m_has_rows, tile.m_has_cols, tile.m_block_subsize, tile.m_num_8x8, m_above_partition_context, tile.m_left_partition_context, row, col, m_frame_is_intra));
 
     auto subsize = subsize_lookup[partition][block_subsize];
     if (subsize < Block_8x8 || partition == PartitionNone) {
-        TRY(decode_block(row, col, subsize));
+        TRY(decode_block(tile, row, col, subsize));
     } else if (partition == PartitionHorizontal) {
-        TRY(decode_block(row, col, subsize));
-        if (m_has_rows)
-            TRY(decode_block(row + half_block_8x8, col, subsize));
+        TRY(decode_block(tile, row, col, subsize));
+        if (tile.m_has_rows)
+            TRY(decode_block(tile, row + half_block_8x8, col, subsize));
     } else if (partition == PartitionVertical) {
-        TRY(decode_block(row, col, subsize));
-        if (m_has_cols)
-            TRY(decode_block(row, col + half_block_8x8, subsize));
+        TRY(decode_block(tile, row, col, subsize));
+        if (tile.m_has_cols)
+            TRY(decode_block(tile, row, col + half_block_8x8, subsize));
     } else {
-        TRY(decode_partition(row, col, subsize));
-        TRY(decode_partition(row, col + half_block_8x8, subsize));
-        TRY(decode_partition(row + half_block_8x8, col, subsize));
-        TRY(decode_partition(row + half_block_8x8, col + half_block_8x8, subsize));
+        TRY(decode_partition(tile, row, col, subsize));
+        TRY(decode_partition(tile, row, col + half_block_8x8, subsize));
+        TRY(decode_partition(tile, row + half_block_8x8, col, subsize));
+        TRY(decode_partition(tile, row + half_block_8x8, col + half_block_8x8, subsize));
     }
     if (block_subsize == Block_8x8 || partition != PartitionSplit) {
         auto above_context = 15 >> b_width_log2_lookup[subsize];
         auto left_context = 15 >> b_height_log2_lookup[subsize];
-        for (size_t i = 0; i < m_num_8x8; i++) {
+        for (size_t i = 0; i < tile.m_num_8x8; i++) {
             m_above_partition_context[col + i] = above_context;
-            m_left_partition_context[row + i] = left_context;
+            tile.m_left_partition_context[row + i] = left_context;
         }
     }
     return {};
@@ -951,18 +983,18 @@ size_t Parser::get_image_index(u32 row, u32 column)
     return row * m_mi_cols + column;
 }
 
-DecoderErrorOr<void> Parser::decode_block(u32 row, u32 col, BlockSubsize subsize)
+DecoderErrorOr<void> Parser::decode_block(TileContext& tile, u32 row, u32 col, BlockSubsize subsize)
 {
-    m_mi_row = row;
-    m_mi_col = col;
-    m_mi_size = subsize;
-    m_available_u = row > 0;
-    m_available_l = col > m_mi_col_start;
-    TRY(mode_info());
-    m_eob_total = 0;
-    TRY(residual());
-    if (m_is_inter && subsize >= Block_8x8 && m_eob_total == 0)
-        m_skip = true;
+    tile.m_mi_row = row;
+    tile.m_mi_col = col;
+    tile.m_mi_size = subsize;
+    tile.m_available_u = row > 0;
+    tile.m_available_l = col > tile.m_mi_col_start;
+    TRY(mode_info(tile));
+    tile.m_eob_total = 0;
+    TRY(residual(tile));
+    if (tile.m_is_inter && subsize >= Block_8x8 && tile.m_eob_total == 0)
+        tile.m_skip = true;
 
     // Spec doesn't specify whether it might index outside the frame here, but it seems that it can. Ensure that we don't
     // write out of bounds. This check seems consistent with libvpx.
@@ -974,286 +1006,286 @@ DecoderErrorOr<void> Parser::decode_block(u32 row, u32 col, BlockSubsize subsize
     for (size_t y = 0; y < maximum_block_y; y++) {
         for (size_t x = 0; x < maximum_block_x; x++) {
             auto pos = get_image_index(row + y, col + x);
-            m_skips[pos] = m_skip;
-            m_tx_sizes[pos] = m_tx_size;
-            m_mi_sizes[pos] = m_mi_size;
-            m_y_modes[pos] = m_y_mode;
-            m_segment_ids[pos] = m_segment_id;
+            m_skips[pos] = tile.m_skip;
+            m_tx_sizes[pos] = tile.m_tx_size;
+            m_mi_sizes[pos] = tile.m_mi_size;
+            m_y_modes[pos] = tile.m_y_mode;
+            m_segment_ids[pos] = tile.m_segment_id;
             for (size_t ref_list = 0; ref_list < 2; ref_list++)
-                m_ref_frames[pos][ref_list] = m_ref_frame[ref_list];
-            if (m_is_inter) {
-                m_interp_filters[pos] = m_interp_filter;
+                m_ref_frames[pos][ref_list] = tile.m_ref_frame[ref_list];
+            if (tile.m_is_inter) {
+                m_interp_filters[pos] = tile.m_interp_filter;
                 for (size_t ref_list = 0; ref_list < 2; ref_list++) {
                     // FIXME: Can we just store all the sub_mvs and then look up
                     //        the main one by index 3?
-                    m_mvs[pos][ref_list] = m_block_mvs[ref_list][3];
+                    m_mvs[pos][ref_list] = tile.m_block_mvs[ref_list][3];
                     for (size_t b = 0; b < 4; b++)
-                        m_sub_mvs[pos][ref_list][b] = m_block_mvs[ref_list][b];
+                        m_sub_mvs[pos][ref_list][b] = tile.m_block_mvs[ref_list][b];
                 }
             } else {
                 for (size_t b = 0; b < 4; b++)
-                    m_sub_modes[pos][b] = static_cast<PredictionMode>(m_block_sub_modes[b]);
+                    m_sub_modes[pos][b] = static_cast<PredictionMode>(tile.m_block_sub_modes[b]);
             }
         }
     }
     return {};
 }
 
-DecoderErrorOr<void> Parser::mode_info()
+DecoderErrorOr<void> Parser::mode_info(TileContext& tile)
 {
     if (m_frame_is_intra)
-        TRY(intra_frame_mode_info());
+        TRY(intra_frame_mode_info(tile));
     else
-        TRY(inter_frame_mode_info());
+        TRY(inter_frame_mode_info(tile));
     return {};
 }
 
-DecoderErrorOr<void> Parser::intra_frame_mode_info()
+DecoderErrorOr<void> Parser::intra_frame_mode_info(TileContext& tile)
 {
-    TRY(intra_segment_id());
-    TRY(read_skip());
-    TRY(read_tx_size(true));
-    m_ref_frame[0] = IntraFrame;
-    m_ref_frame[1] = None;
-    m_is_inter = false;
+    TRY(intra_segment_id(tile));
+    TRY(read_skip(tile));
+    TRY(read_tx_size(tile, true));
+    tile.m_ref_frame[0] = IntraFrame;
+    tile.m_ref_frame[1] = None;
+    tile.m_is_inter = false;
     // FIXME: This if statement is also present in parse_default_intra_mode. The selection of parameters for
     //        the probability table lookup should be inlined here.
-    if (m_mi_size >= Block_8x8) {
+    if (tile.m_mi_size >= Block_8x8) {
         // FIXME: This context should be available in the block setup. Make a struct to store the context
-        //        that is needed to call the tree parses and set it in decode_block().
+        //        that is needed to call the tree parses and set it in decode_block(tile).
         auto above_context = Optional<Array<PredictionMode, 4> const&>();
         auto left_context = Optional<Array<PredictionMode, 4> const&>();
-        if (m_available_u)
-            above_context = m_sub_modes[get_image_index(m_mi_row - 1, m_mi_col)];
-        if (m_available_l)
-            left_context = m_sub_modes[get_image_index(m_mi_row, m_mi_col - 1)];
-        m_default_intra_mode = TRY_READ(TreeParser::parse_default_intra_mode(*m_bit_stream, *m_probability_tables, m_mi_size, above_context, left_context, m_block_sub_modes, 0, 0));
-
-        m_y_mode = m_default_intra_mode;
-        for (auto& block_sub_mode : m_block_sub_modes)
-            block_sub_mode = m_y_mode;
+        if (tile.m_available_u)
+            above_context = m_sub_modes[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)];
+        if (tile.m_available_l)
+            left_context = m_sub_modes[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)];
+        tile.m_default_intra_mode = TRY_READ(TreeParser::parse_default_intra_mode(tile.m_bit_stream, *m_probability_tables, tile.m_mi_size, above_context, left_context, tile.m_block_sub_modes, 0, 0));
+
+        tile.m_y_mode = tile.m_default_intra_mode;
+        for (auto& block_sub_mode : tile.m_block_sub_modes)
+            block_sub_mode = tile.m_y_mode;
     } else {
-        m_num_4x4_w = num_4x4_blocks_wide_lookup[m_mi_size];
-        m_num_4x4_h = num_4x4_blocks_high_lookup[m_mi_size];
-        for (auto idy = 0; idy < 2; idy += m_num_4x4_h) {
-            for (auto idx = 0; idx < 2; idx += m_num_4x4_w) {
+        tile.m_num_4x4_w = num_4x4_blocks_wide_lookup[tile.m_mi_size];
+        tile.m_num_4x4_h = num_4x4_blocks_high_lookup[tile.m_mi_size];
+        for (auto idy = 0; idy < 2; idy += tile.m_num_4x4_h) {
+            for (auto idx = 0; idx < 2; idx += tile.m_num_4x4_w) {
                 // FIXME: See the FIXME above.
                 auto above_context = Optional<Array<PredictionMode, 4> const&>();
                 auto left_context = Optional<Array<PredictionMode, 4> const&>();
-                if (m_available_u)
-                    above_context = m_sub_modes[get_image_index(m_mi_row - 1, m_mi_col)];
-                if (m_available_l)
-                    left_context = m_sub_modes[get_image_index(m_mi_row, m_mi_col - 1)];
-                m_default_intra_mode = TRY_READ(TreeParser::parse_default_intra_mode(*m_bit_stream, *m_probability_tables, m_mi_size, above_context, left_context, m_block_sub_modes, idx, idy));
-
-                for (auto y = 0; y < m_num_4x4_h; y++) {
-                    for (auto x = 0; x < m_num_4x4_w; x++) {
+                if (tile.m_available_u)
+                    above_context = m_sub_modes[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)];
+                if (tile.m_available_l)
+                    left_context = m_sub_modes[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)];
+                tile.m_default_intra_mode = TRY_READ(TreeParser::parse_default_intra_mode(tile.m_bit_stream, *m_probability_tables, tile.m_mi_size, above_context, left_context, tile.m_block_sub_modes, idx, idy));
+
+                for (auto y = 0; y < tile.m_num_4x4_h; y++) {
+                    for (auto x = 0; x < tile.m_num_4x4_w; x++) {
                         auto index = (idy + y) * 2 + idx + x;
-                        m_block_sub_modes[index] = m_default_intra_mode;
+                        tile.m_block_sub_modes[index] = tile.m_default_intra_mode;
                     }
                 }
             }
         }
-        m_y_mode = m_default_intra_mode;
+        tile.m_y_mode = tile.m_default_intra_mode;
     }
-    m_uv_mode = TRY_READ(TreeParser::parse_default_uv_mode(*m_bit_stream, *m_probability_tables, m_y_mode));
+    tile.m_uv_mode = TRY_READ(TreeParser::parse_default_uv_mode(tile.m_bit_stream, *m_probability_tables, tile.m_y_mode));
     return {};
 }
 
-DecoderErrorOr<void> Parser::intra_segment_id()
+DecoderErrorOr<void> Parser::intra_segment_id(TileContext& tile)
 {
     if (m_segmentation_enabled && m_segmentation_update_map)
-        m_segment_id = TRY_READ(TreeParser::parse_segment_id(*m_bit_stream, m_segmentation_tree_probs));
+        tile.m_segment_id = TRY_READ(TreeParser::parse_segment_id(tile.m_bit_stream, m_segmentation_tree_probs));
     else
-        m_segment_id = 0;
+        tile.m_segment_id = 0;
     return {};
 }
 
-DecoderErrorOr<void> Parser::read_skip()
+DecoderErrorOr<void> Parser::read_skip(TileContext& tile)
 {
-    if (seg_feature_active(SEG_LVL_SKIP)) {
-        m_skip = true;
+    if (seg_feature_active(tile, SEG_LVL_SKIP)) {
+        tile.m_skip = true;
     } else {
-        Optional<bool> above_skip = m_available_u ? m_skips[get_image_index(m_mi_row - 1, m_mi_col)] : Optional<bool>();
-        Optional<bool> left_skip = m_available_l ? m_skips[get_image_index(m_mi_row, m_mi_col - 1)] : Optional<bool>();
-        m_skip = TRY_READ(TreeParser::parse_skip(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, above_skip, left_skip));
+        Optional<bool> above_skip = tile.m_available_u ? m_skips[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)] : Optional<bool>();
+        Optional<bool> left_skip = tile.m_available_l ? m_skips[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)] : Optional<bool>();
+        tile.m_skip = TRY_READ(TreeParser::parse_skip(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, above_skip, left_skip));
     }
     return {};
 }
 
-bool Parser::seg_feature_active(u8 feature)
+bool Parser::seg_feature_active(TileContext& tile, u8 feature)
 {
-    return m_segmentation_enabled && m_feature_enabled[m_segment_id][feature];
+    return m_segmentation_enabled && m_feature_enabled[tile.m_segment_id][feature];
 }
 
-DecoderErrorOr<void> Parser::read_tx_size(bool allow_select)
+DecoderErrorOr<void> Parser::read_tx_size(TileContext& tile, bool allow_select)
 {
-    m_max_tx_size = max_txsize_lookup[m_mi_size];
-    if (allow_select && m_tx_mode == TXModeSelect && m_mi_size >= Block_8x8) {
-        Optional<bool> above_skip = m_available_u ? m_skips[get_image_index(m_mi_row - 1, m_mi_col)] : Optional<bool>();
-        Optional<bool> left_skip = m_available_l ? m_skips[get_image_index(m_mi_row, m_mi_col - 1)] : Optional<bool>();
-        Optional<TXSize> above_tx_size = m_available_u ? m_tx_sizes[get_image_index(m_mi_row - 1, m_mi_col)] : Optional<TXSize>();
-        Optional<TXSize> left_tx_size = m_available_l ? m_tx_sizes[get_image_index(m_mi_row, m_mi_col - 1)] : Optional<TXSize>();
-        m_tx_size = TRY_READ(TreeParser::parse_tx_size(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, m_max_tx_size, above_skip, left_skip, above_tx_size, left_tx_size));
+    tile.m_max_tx_size = max_txsize_lookup[tile.m_mi_size];
+    if (allow_select && m_tx_mode == TXModeSelect && tile.m_mi_size >= Block_8x8) {
+        Optional<bool> above_skip = tile.m_available_u ? m_skips[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)] : Optional<bool>();
+        Optional<bool> left_skip = tile.m_available_l ? m_skips[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)] : Optional<bool>();
+        Optional<TXSize> above_tx_size = tile.m_available_u ? m_tx_sizes[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)] : Optional<TXSize>();
+        Optional<TXSize> left_tx_size = tile.m_available_l ? m_tx_sizes[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)] : Optional<TXSize>();
+        tile.m_tx_size = TRY_READ(TreeParser::parse_tx_size(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, tile.m_max_tx_size, above_skip, left_skip, above_tx_size, left_tx_size));
     } else {
-        m_tx_size = min(m_max_tx_size, tx_mode_to_biggest_tx_size[m_tx_mode]);
+        tile.m_tx_size = min(tile.m_max_tx_size, tx_mode_to_biggest_tx_size[m_tx_mode]);
     }
     return {};
 }
 
-DecoderErrorOr<void> Parser::inter_frame_mode_info()
-{
-    m_left_ref_frame[0] = m_available_l ? m_ref_frames[get_image_index(m_mi_row, m_mi_col - 1)][0] : IntraFrame;
-    m_above_ref_frame[0] = m_available_u ? m_ref_frames[get_image_index(m_mi_row - 1, m_mi_col)][0] : IntraFrame;
-    m_left_ref_frame[1] = m_available_l ? m_ref_frames[get_image_index(m_mi_row, m_mi_col - 1)][1] : None;
-    m_above_ref_frame[1] = m_available_u ? m_ref_frames[get_image_index(m_mi_row - 1, m_mi_col)][1] : None;
-    m_left_intra = m_left_ref_frame[0] <= IntraFrame;
-    m_above_intra = m_above_ref_frame[0] <= IntraFrame;
-    m_left_single = m_left_ref_frame[1] <= None;
-    m_above_single = m_above_ref_frame[1] <= None;
-    TRY(inter_segment_id());
-    TRY(read_skip());
-    TRY(read_is_inter());
-    TRY(read_tx_size(!m_skip || !m_is_inter));
-    if (m_is_inter) {
-        TRY(inter_block_mode_info());
+DecoderErrorOr<void> Parser::inter_frame_mode_info(TileContext& tile)
+{
+    tile.m_left_ref_frame[0] = tile.m_available_l ? m_ref_frames[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)][0] : IntraFrame;
+    tile.m_above_ref_frame[0] = tile.m_available_u ? m_ref_frames[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)][0] : IntraFrame;
+    tile.m_left_ref_frame[1] = tile.m_available_l ? m_ref_frames[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)][1] : None;
+    tile.m_above_ref_frame[1] = tile.m_available_u ? m_ref_frames[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)][1] : None;
+    tile.m_left_intra = tile.m_left_ref_frame[0] <= IntraFrame;
+    tile.m_above_intra = tile.m_above_ref_frame[0] <= IntraFrame;
+    tile.m_left_single = tile.m_left_ref_frame[1] <= None;
+    tile.m_above_single = tile.m_above_ref_frame[1] <= None;
+    TRY(inter_segment_id(tile));
+    TRY(read_skip(tile));
+    TRY(read_is_inter(tile));
+    TRY(read_tx_size(tile, !tile.m_skip || !tile.m_is_inter));
+    if (tile.m_is_inter) {
+        TRY(inter_block_mode_info(tile));
     } else {
-        TRY(intra_block_mode_info());
+        TRY(intra_block_mode_info(tile));
     }
     return {};
 }
 
-DecoderErrorOr<void> Parser::inter_segment_id()
+DecoderErrorOr<void> Parser::inter_segment_id(TileContext& tile)
 {
     if (!m_segmentation_enabled) {
-        m_segment_id = 0;
+        tile.m_segment_id = 0;
         return {};
     }
-    auto predicted_segment_id = get_segment_id();
+    auto predicted_segment_id = get_segment_id(tile);
     if (!m_segmentation_update_map) {
-        m_segment_id = predicted_segment_id;
+        tile.m_segment_id = predicted_segment_id;
         return {};
     }
     if (!m_segmentation_temporal_update) {
-        m_segment_id = TRY_READ(TreeParser::parse_segment_id(*m_bit_stream, m_segmentation_tree_probs));
+        tile.m_segment_id = TRY_READ(TreeParser::parse_segment_id(tile.m_bit_stream, m_segmentation_tree_probs));
         return {};
     }
 
-    auto seg_id_predicted = TRY_READ(TreeParser::parse_segment_id_predicted(*m_bit_stream, m_segmentation_pred_prob, m_left_seg_pred_context[m_mi_row], m_above_seg_pred_context[m_mi_col]));
+    auto seg_id_predicted = TRY_READ(TreeParser::parse_segment_id_predicted(tile.m_bit_stream, m_segmentation_pred_prob, tile.m_left_seg_pred_context[tile.m_mi_row], m_above_seg_pred_context[tile.m_mi_col]));
     if (seg_id_predicted)
-        m_segment_id = predicted_segment_id;
+        tile.m_segment_id = predicted_segment_id;
     else
-        m_segment_id = TRY_READ(TreeParser::parse_segment_id(*m_bit_stream, m_segmentation_tree_probs));
+        tile.m_segment_id = TRY_READ(TreeParser::parse_segment_id(tile.m_bit_stream, m_segmentation_tree_probs));
 
-    for (size_t i = 0; i < num_8x8_blocks_wide_lookup[m_mi_size]; i++) {
-        auto index = m_mi_col + i;
+    for (size_t i = 0; i < num_8x8_blocks_wide_lookup[tile.m_mi_size]; i++) {
+        auto index = tile.m_mi_col + i;
         // (7.4.1) AboveSegPredContext[ i ] only needs to be set to 0 for i = 0..MiCols-1.
         if (index < m_above_seg_pred_context.size())
             m_above_seg_pred_context[index] = seg_id_predicted;
     }
-    for (size_t i = 0; i < num_8x8_blocks_high_lookup[m_mi_size]; i++) {
-        auto index = m_mi_row + i;
+    for (size_t i = 0; i < num_8x8_blocks_high_lookup[tile.m_mi_size]; i++) {
+        auto index = tile.m_mi_row + i;
         // (7.4.1) LeftSegPredContext[ i ] only needs to be set to 0 for i = 0..MiRows-1.
         if (index < m_above_seg_pred_context.size())
-            m_left_seg_pred_context[m_mi_row + i] = seg_id_predicted;
+            tile.m_left_seg_pred_context[tile.m_mi_row + i] = seg_id_predicted;
     }
     return {};
 }
 
-u8 Parser::get_segment_id()
+u8 Parser::get_segment_id(TileContext& tile)
 {
-    auto bw = num_8x8_blocks_wide_lookup[m_mi_size];
-    auto bh = num_8x8_blocks_high_lookup[m_mi_size];
-    auto xmis = min(m_mi_cols - m_mi_col, (u32)bw);
-    auto ymis = min(m_mi_rows - m_mi_row, (u32)bh);
+    auto bw = num_8x8_blocks_wide_lookup[tile.m_mi_size];
+    auto bh = num_8x8_blocks_high_lookup[tile.m_mi_size];
+    auto xmis = min(m_mi_cols - tile.m_mi_col, (u32)bw);
+    auto ymis = min(m_mi_rows - tile.m_mi_row, (u32)bh);
     u8 segment = 7;
     for (size_t y = 0; y < ymis; y++) {
         for (size_t x = 0; x < xmis; x++) {
-            segment = min(segment, m_prev_segment_ids[(m_mi_row + y) + (m_mi_col + x)]);
+            segment = min(segment, m_prev_segment_ids[(tile.m_mi_row + y) + (tile.m_mi_col + x)]);
         }
     }
     return segment;
 }
 
-DecoderErrorOr<void> Parser::read_is_inter()
+DecoderErrorOr<void> Parser::read_is_inter(TileContext& tile)
 {
-    if (seg_feature_active(SEG_LVL_REF_FRAME)) {
-        m_is_inter = m_feature_data[m_segment_id][SEG_LVL_REF_FRAME] != IntraFrame;
+    if (seg_feature_active(tile, SEG_LVL_REF_FRAME)) {
+        tile.m_is_inter = m_feature_data[tile.m_segment_id][SEG_LVL_REF_FRAME] != IntraFrame;
     } else {
-        Optional<bool> above_intra = m_available_u ? m_above_intra : Optional<bool>();
-        Optional<bool> left_intra = m_available_l ? m_left_intra : Optional<bool>();
-        m_is_inter = TRY_READ(TreeParser::parse_is_inter(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, above_intra, left_intra));
+        Optional<bool> above_intra = tile.m_available_u ? tile.m_above_intra : Optional<bool>();
+        Optional<bool> left_intra = tile.m_available_l ? tile.m_left_intra : Optional<bool>();
+        tile.m_is_inter = TRY_READ(TreeParser::parse_is_inter(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, above_intra, left_intra));
     }
     return {};
 }
 
-DecoderErrorOr<void> Parser::intra_block_mode_info()
+DecoderErrorOr<void> Parser::intra_block_mode_info(TileContext& tile)
 {
-    m_ref_frame[0] = IntraFrame;
-    m_ref_frame[1] = None;
-    if (m_mi_size >= Block_8x8) {
-        m_y_mode = TRY_READ(TreeParser::parse_intra_mode(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, m_mi_size));
-        for (auto& block_sub_mode : m_block_sub_modes)
-            block_sub_mode = m_y_mode;
+    tile.m_ref_frame[0] = IntraFrame;
+    tile.m_ref_frame[1] = None;
+    if (tile.m_mi_size >= Block_8x8) {
+        tile.m_y_mode = TRY_READ(TreeParser::parse_intra_mode(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, tile.m_mi_size));
+        for (auto& block_sub_mode : tile.m_block_sub_modes)
+            block_sub_mode = tile.m_y_mode;
     } else {
-        m_num_4x4_w = num_4x4_blocks_wide_lookup[m_mi_size];
-        m_num_4x4_h = num_4x4_blocks_high_lookup[m_mi_size];
+        tile.m_num_4x4_w = num_4x4_blocks_wide_lookup[tile.m_mi_size];
+        tile.m_num_4x4_h = num_4x4_blocks_high_lookup[tile.m_mi_size];
         PredictionMode sub_intra_mode;
-        for (auto idy = 0; idy < 2; idy += m_num_4x4_h) {
-            for (auto idx = 0; idx < 2; idx += m_num_4x4_w) {
-                sub_intra_mode = TRY_READ(TreeParser::parse_sub_intra_mode(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter));
-                for (auto y = 0; y < m_num_4x4_h; y++) {
-                    for (auto x = 0; x < m_num_4x4_w; x++)
-                        m_block_sub_modes[(idy + y) * 2 + idx + x] = sub_intra_mode;
+        for (auto idy = 0; idy < 2; idy += tile.m_num_4x4_h) {
+            for (auto idx = 0; idx < 2; idx += tile.m_num_4x4_w) {
+                sub_intra_mode = TRY_READ(TreeParser::parse_sub_intra_mode(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter));
+                for (auto y = 0; y < tile.m_num_4x4_h; y++) {
+                    for (auto x = 0; x < tile.m_num_4x4_w; x++)
+                        tile.m_block_sub_modes[(idy + y) * 2 + idx + x] = sub_intra_mode;
                 }
             }
         }
-        m_y_mode = sub_intra_mode;
+        tile.m_y_mode = sub_intra_mode;
     }
-    m_uv_mode = TRY_READ(TreeParser::parse_uv_mode(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, m_y_mode));
+    tile.m_uv_mode = TRY_READ(TreeParser::parse_uv_mode(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, tile.m_y_mode));
     return {};
 }
 
-DecoderErrorOr<void> Parser::inter_block_mode_info()
+DecoderErrorOr<void> Parser::inter_block_mode_info(TileContext& tile)
 {
-    TRY(read_ref_frames());
+    TRY(read_ref_frames(tile));
     for (auto j = 0; j < 2; j++) {
-        if (m_ref_frame[j] > IntraFrame) {
-            find_mv_refs(m_ref_frame[j], -1);
-            find_best_ref_mvs(j);
+        if (tile.m_ref_frame[j] > IntraFrame) {
+            find_mv_refs(tile, tile.m_ref_frame[j], -1);
+            find_best_ref_mvs(tile, j);
         }
     }
-    auto is_compound = m_ref_frame[1] > IntraFrame;
-    if (seg_feature_active(SEG_LVL_SKIP)) {
-        m_y_mode = PredictionMode::ZeroMv;
-    } else if (m_mi_size >= Block_8x8) {
-        m_y_mode = TRY_READ(TreeParser::parse_inter_mode(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, m_mode_context[m_ref_frame[0]]));
+    auto is_compound = tile.m_ref_frame[1] > IntraFrame;
+    if (seg_feature_active(tile, SEG_LVL_SKIP)) {
+        tile.m_y_mode = PredictionMode::ZeroMv;
+    } else if (tile.m_mi_size >= Block_8x8) {
+        tile.m_y_mode = TRY_READ(TreeParser::parse_inter_mode(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, tile.m_mode_context[tile.m_ref_frame[0]]));
     }
     if (m_interpolation_filter == Switchable) {
-        Optional<ReferenceFrameType> above_ref_frame = m_available_u ? m_ref_frames[get_image_index(m_mi_row - 1, m_mi_col)][0] : Optional<ReferenceFrameType>();
-        Optional<ReferenceFrameType> left_ref_frame = m_available_l ? m_ref_frames[get_image_index(m_mi_row, m_mi_col - 1)][0] : Optional<ReferenceFrameType>();
-        Optional<InterpolationFilter> above_interpolation_filter = m_available_u ? m_interp_filters[get_image_index(m_mi_row - 1, m_mi_col)] : Optional<InterpolationFilter>();
-        Optional<InterpolationFilter> left_interpolation_filter = m_available_l ? m_interp_filters[get_image_index(m_mi_row, m_mi_col - 1)] : Optional<InterpolationFilter>();
-        m_interp_filter = TRY_READ(TreeParser::parse_interpolation_filter(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, above_ref_frame, left_ref_frame, above_interpolation_filter, left_interpolation_filter));
+        Optional<ReferenceFrameType> above_ref_frame = tile.m_available_u ? m_ref_frames[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)][0] : Optional<ReferenceFrameType>();
+        Optional<ReferenceFrameType> left_ref_frame = tile.m_available_l ? m_ref_frames[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)][0] : Optional<ReferenceFrameType>();
+        Optional<InterpolationFilter> above_interpolation_filter = tile.m_available_u ? m_interp_filters[get_image_index(tile.m_mi_row - 1, tile.m_mi_col)] : Optional<InterpolationFilter>();
+        Optional<InterpolationFilter> left_interpolation_filter = tile.m_available_l ? m_interp_filters[get_image_index(tile.m_mi_row, tile.m_mi_col - 1)] : Optional<InterpolationFilter>();
+        tile.m_interp_filter = TRY_READ(TreeParser::parse_interpolation_filter(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, above_ref_frame, left_ref_frame, above_interpolation_filter, left_interpolation_filter));
     } else {
-        m_interp_filter = m_interpolation_filter;
-    }
-    if (m_mi_size < Block_8x8) {
-        m_num_4x4_w = num_4x4_blocks_wide_lookup[m_mi_size];
-        m_num_4x4_h = num_4x4_blocks_high_lookup[m_mi_size];
-        for (auto idy = 0; idy < 2; idy += m_num_4x4_h) {
-            for (auto idx = 0; idx < 2; idx += m_num_4x4_w) {
-                m_y_mode = TRY_READ(TreeParser::parse_inter_mode(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, m_mode_context[m_ref_frame[0]]));
-                if (m_y_mode == PredictionMode::NearestMv || m_y_mode == PredictionMode::NearMv) {
+        tile.m_interp_filter = m_interpolation_filter;
+    }
+    if (tile.m_mi_size < Block_8x8) {
+        tile.m_num_4x4_w = num_4x4_blocks_wide_lookup[tile.m_mi_size];
+        tile.m_num_4x4_h = num_4x4_blocks_high_lookup[tile.m_mi_size];
+        for (auto idy = 0; idy < 2; idy += tile.m_num_4x4_h) {
+            for (auto idx = 0; idx < 2; idx += tile.m_num_4x4_w) {
+                tile.m_y_mode = TRY_READ(TreeParser::parse_inter_mode(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, tile.m_mode_context[tile.m_ref_frame[0]]));
+                if (tile.m_y_mode == PredictionMode::NearestMv || tile.m_y_mode == PredictionMode::NearMv) {
                     for (auto j = 0; j < 1 + is_compound; j++)
-                        append_sub8x8_mvs(idy * 2 + idx, j);
+                        append_sub8x8_mvs(tile, idy * 2 + idx, j);
                 }
-                TRY(assign_mv(is_compound));
-                for (auto y = 0; y < m_num_4x4_h; y++) {
-                    for (auto x = 0; x < m_num_4x4_w; x++) {
+                TRY(assign_mv(tile, is_compound));
+                for (auto y = 0; y < tile.m_num_4x4_h; y++) {
+                    for (auto x = 0; x < tile.m_num_4x4_w; x++) {
                         auto block = (idy + y) * 2 + idx + x;
                         for (auto ref_list = 0; ref_list < 1 + is_compound; ref_list++) {
-                            m_block_mvs[ref_list][block] = m_mv[ref_list];
+                            tile.m_block_mvs[ref_list][block] = tile.m_mv[ref_list];
                         }
                     }
                 }
@@ -1261,33 +1293,33 @@ DecoderErrorOr<void> Parser::inter_block_mode_info()
         }
         return {};
     }
-    TRY(assign_mv(is_compound));
+    TRY(assign_mv(tile, is_compound));
     for (auto ref_list = 0; ref_list < 1 + is_compound; ref_list++) {
         for (auto block = 0; block < 4; block++) {
-            m_block_mvs[ref_list][block] = m_mv[ref_list];
+            tile.m_block_mvs[ref_list][block] = tile.m_mv[ref_list];
         }
     }
     return {};
 }
 
-DecoderErrorOr<void> Parser::read_ref_frames()
+DecoderErrorOr<void> Parser::read_ref_frames(TileContext& tile)
 {
-    if (seg_feature_active(SEG_LVL_REF_FRAME)) {
-        m_ref_frame[0] = static_cast<ReferenceFrameType>(m_feature_data[m_segment_id][SEG_LVL_REF_FRAME]);
-        m_ref_frame[1] = None;
+    if (seg_feature_active(tile, SEG_LVL_REF_FRAME)) {
+        tile.m_ref_frame[0] = static_cast<ReferenceFrameType>(m_feature_data[tile.m_segment_id][SEG_LVL_REF_FRAME]);
+        tile.m_ref_frame[1] = None;
         return {};
     }
     ReferenceMode comp_mode;
-    Optional<bool> above_single = m_available_u ? m_above_single : Optional<bool>();
-    Optional<bool> left_single = m_available_l ? m_left_single : Optional<bool>();
-    Optional<bool> above_intra = m_available_u ? m_above_intra : Optional<bool>();
-    Optional<bool> left_intra = m_available_l ? m_left_intra : Optional<bool>();
-    Optional<ReferenceFrameType> above_ref_frame_0 = m_available_u ? m_above_ref_frame[0] : Optional<ReferenceFrameType>();
-    Optional<ReferenceFrameType> left_ref_frame_0 = m_available_l ? m_left_ref_frame[0] : Optional<ReferenceFrameType>();
-    Optional<ReferenceFramePair> above_ref_frame = m_available_u ? m_above_ref_frame : Optional<ReferenceFramePair>();
-    Optional<ReferenceFramePair> left_ref_frame = m_available_l ? m_left_ref_frame : Optional<ReferenceFramePair>();
+    Optional<bool> above_single = tile.m_available_u ? tile.m_above_single : Optional<bool>();
+    Optional<bool> left_single = tile.m_available_l ? tile.m_left_single : Optional<bool>();
+    Optional<bool> above_intra = tile.m_available_u ? tile.m_above_intra : Optional<bool>();
+    Optional<bool> left_intra = tile.m_available_l ? tile.m_left_intra : Optional<bool>();
+    Optional<ReferenceFrameType> above_ref_frame_0 = tile.m_available_u ? tile.m_above_ref_frame[0] : Optional<ReferenceFrameType>();
+    Optional<ReferenceFrameType> left_ref_frame_0 = tile.m_available_l ? tile.m_left_ref_frame[0] : Optional<ReferenceFrameType>();
+    Optional<ReferenceFramePair> above_ref_frame = tile.m_available_u ? tile.m_above_ref_frame : Optional<ReferenceFramePair>();
+    Optional<ReferenceFramePair> left_ref_frame = tile.m_available_l ? tile.m_left_ref_frame : Optional<ReferenceFramePair>();
     if (m_reference_mode == ReferenceModeSelect) {
-        comp_mode = TRY_READ(TreeParser::parse_comp_mode(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, m_comp_fixed_ref, above_single, left_single, above_intra, left_intra, above_ref_frame_0, left_ref_frame_0));
+        comp_mode = TRY_READ(TreeParser::parse_comp_mode(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, m_comp_fixed_ref, above_single, left_single, above_intra, left_intra, above_ref_frame_0, left_ref_frame_0));
     } else {
         comp_mode = m_reference_mode;
     }
@@ -1295,79 +1327,79 @@ DecoderErrorOr<void> Parser::read_ref_frames()
         auto biased_reference_index = m_ref_frame_sign_bias[m_comp_fixed_ref];
         auto inverse_biased_reference_index = biased_reference_index == 0 ? 1 : 0;
 
-        Optional<ReferenceFrameType> above_ref_frame_biased = m_available_u ? m_above_ref_frame[inverse_biased_reference_index] : Optional<ReferenceFrameType>();
-        Optional<ReferenceFrameType> left_ref_frame_biased = m_available_l ? m_left_ref_frame[inverse_biased_reference_index] : Optional<ReferenceFrameType>();
+        Optional<ReferenceFrameType> above_ref_frame_biased = tile.m_available_u ? tile.m_above_ref_frame[inverse_biased_reference_index] : Optional<ReferenceFrameType>();
+        Optional<ReferenceFrameType> left_ref_frame_biased = tile.m_available_l ? tile.m_left_ref_frame[inverse_biased_reference_index] : Optional<ReferenceFrameType>();
         // FIXME: Create an enum for compound frame references using names Primary and Secondary.
-        auto comp_ref = TRY_READ(TreeParser::parse_comp_ref(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, m_comp_fixed_ref, m_comp_var_ref, above_single, left_single, above_intra, left_intra, above_ref_frame_0, left_ref_frame_0, above_ref_frame_biased, left_ref_frame_biased));
+        auto comp_ref = TRY_READ(TreeParser::parse_comp_ref(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, m_comp_fixed_ref, m_comp_var_ref, above_single, left_single, above_intra, left_intra, above_ref_frame_0, left_ref_frame_0, above_ref_frame_biased, left_ref_frame_biased));
 
-        m_ref_frame[biased_reference_index] = m_comp_fixed_ref;
-        m_ref_frame[inverse_biased_reference_index] = m_comp_var_ref[comp_ref];
+        tile.m_ref_frame[biased_reference_index] = m_comp_fixed_ref;
+        tile.m_ref_frame[inverse_biased_reference_index] = m_comp_var_ref[comp_ref];
         return {};
     }
     // FIXME: Maybe consolidate this into a tree. Context is different between part 1 and 2 but still, it would look nice here.
-    auto single_ref_p1 = TRY_READ(TreeParser::parse_single_ref_part_1(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, above_single, left_single, above_intra, left_intra, above_ref_frame, left_ref_frame));
+    auto single_ref_p1 = TRY_READ(TreeParser::parse_single_ref_part_1(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, above_single, left_single, above_intra, left_intra, above_ref_frame, left_ref_frame));
     if (single_ref_p1) {
-        auto single_ref_p2 = TRY_READ(TreeParser::parse_single_ref_part_2(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, above_single, left_single, above_intra, left_intra, above_ref_frame, left_ref_frame));
-        m_ref_frame[0] = single_ref_p2 ? AltRefFrame : GoldenFrame;
+        auto single_ref_p2 = TRY_READ(TreeParser::parse_single_ref_part_2(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, above_single, left_single, above_intra, left_intra, above_ref_frame, left_ref_frame));
+        tile.m_ref_frame[0] = single_ref_p2 ? AltRefFrame : GoldenFrame;
     } else {
-        m_ref_frame[0] = LastFrame;
+        tile.m_ref_frame[0] = LastFrame;
     }
-    m_ref_frame[1] = None;
+    tile.m_ref_frame[1] = None;
     return {};
 }
 
-DecoderErrorOr<void> Parser::assign_mv(bool is_compound)
+DecoderErrorOr<void> Parser::assign_mv(TileContext& tile, bool is_compound)
 {
-    m_mv[1] = {};
+    tile.m_mv[1] = {};
     for (auto i = 0; i < 1 + is_compound; i++) {
-        if (m_y_mode == PredictionMode::NewMv) {
-            TRY(read_mv(i));
-        } else if (m_y_mode == PredictionMode::NearestMv) {
-            m_mv[i] = m_nearest_mv[i];
-        } else if (m_y_mode == PredictionMode::NearMv) {
-            m_mv[i] = m_near_mv[i];
+        if (tile.m_y_mode == PredictionMode::NewMv) {
+            TRY(read_mv(tile, i));
+        } else if (tile.m_y_mode == PredictionMode::NearestMv) {
+            tile.m_mv[i] = tile.m_nearest_mv[i];
+        } else if (tile.m_y_mode == PredictionMode::NearMv) {
+            tile.m_mv[i] = tile.m_near_mv[i];
         } else {
-            m_mv[i] = {};
+            tile.m_mv[i] = {};
         }
     }
     return {};
 }
 
-DecoderErrorOr<void> Parser::read_mv(u8 ref)
+DecoderErrorOr<void> Parser::read_mv(TileContext& tile, u8 ref)
 {
-    m_use_hp = m_allow_high_precision_mv && use_mv_hp(m_best_mv[ref]);
+    tile.m_use_hp = m_allow_high_precision_mv && use_mv_hp(tile.m_best_mv[ref]);
     MotionVector diff_mv;
-    auto mv_joint = TRY_READ(TreeParser::parse_motion_vector_joint(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter));
+    auto mv_joint = TRY_READ(TreeParser::parse_motion_vector_joint(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter));
     if (mv_joint == MvJointHzvnz || mv_joint == MvJointHnzvnz)
-        diff_mv.set_row(TRY(read_mv_component(0)));
+        diff_mv.set_row(TRY(read_mv_component(tile, 0)));
     if (mv_joint == MvJointHnzvz || mv_joint == MvJointHnzvnz)
-        diff_mv.set_column(TRY(read_mv_component(1)));
+        diff_mv.set_column(TRY(read_mv_component(tile, 1)));
 
     // FIXME: We probably don't need to assign MVs to a field, these can just
     //        be returned and assigned where they are requested.
-    m_mv[ref] = m_best_mv[ref] + diff_mv;
+    tile.m_mv[ref] = tile.m_best_mv[ref] + diff_mv;
     return {};
 }
 
-DecoderErrorOr<i32> Parser::read_mv_component(u8 component)
+DecoderErrorOr<i32> Parser::read_mv_component(TileContext& tile, u8 component)
 {
-    auto mv_sign = TRY_READ(TreeParser::parse_motion_vector_sign(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, component));
-    auto mv_class = TRY_READ(TreeParser::parse_motion_vector_class(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, component));
+    auto mv_sign = TRY_READ(TreeParser::parse_motion_vector_sign(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, component));
+    auto mv_class = TRY_READ(TreeParser::parse_motion_vector_class(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, component));
     u32 magnitude;
     if (mv_class == MvClass0) {
-        auto mv_class0_bit = TRY_READ(TreeParser::parse_motion_vector_class0_bit(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, component));
-        auto mv_class0_fr = TRY_READ(TreeParser::parse_motion_vector_class0_fr(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, component, mv_class0_bit));
-        auto mv_class0_hp = TRY_READ(TreeParser::parse_motion_vector_class0_hp(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, component, m_use_hp));
+        auto mv_class0_bit = TRY_READ(TreeParser::parse_motion_vector_class0_bit(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, component));
+        auto mv_class0_fr = TRY_READ(TreeParser::parse_motion_vector_class0_fr(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, component, mv_class0_bit));
+        auto mv_class0_hp = TRY_READ(TreeParser::parse_motion_vector_class0_hp(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, component, tile.m_use_hp));
         magnitude = ((mv_class0_bit << 3) | (mv_class0_fr << 1) | mv_class0_hp) + 1;
     } else {
         u32 bits = 0;
         for (u8 i = 0; i < mv_class; i++) {
-            auto mv_bit = TRY_READ(TreeParser::parse_motion_vector_bit(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, component, i));
+            auto mv_bit = TRY_READ(TreeParser::parse_motion_vector_bit(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, component, i));
             bits |= mv_bit << i;
         }
         magnitude = CLASS0_SIZE << (mv_class + 2);
-        auto mv_fr = TRY_READ(TreeParser::parse_motion_vector_fr(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, component));
-        auto mv_hp = TRY_READ(TreeParser::parse_motion_vector_hp(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, component, m_use_hp));
+        auto mv_fr = TRY_READ(TreeParser::parse_motion_vector_fr(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, component));
+        auto mv_hp = TRY_READ(TreeParser::parse_motion_vector_hp(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, component, tile.m_use_hp));
         magnitude += ((bits << 3) | (mv_fr << 1) | mv_hp) + 1;
     }
     return (mv_sign ? -1 : 1) * static_cast<i32>(magnitude);
@@ -1386,28 +1418,28 @@ Gfx::Size<size_t> Parser::get_decoded_size_for_plane(u8 plane)
     return { point.x(), point.y() };
 }
 
-DecoderErrorOr<void> Parser::residual()
+DecoderErrorOr<void> Parser::residual(TileContext& tile)
 {
-    auto block_size = m_mi_size < Block_8x8 ? Block_8x8 : static_cast<BlockSubsize>(m_mi_size);
+    auto block_size = tile.m_mi_size < Block_8x8 ? Block_8x8 : static_cast<BlockSubsize>(tile.m_mi_size);
     for (u8 plane = 0; plane < 3; plane++) {
-        auto tx_size = (plane > 0) ? get_uv_tx_size() : m_tx_size;
+        auto tx_size = (plane > 0) ? get_uv_tx_size(tile) : tile.m_tx_size;
         auto step = 1 << tx_size;
         auto plane_size = get_plane_block_size(block_size, plane);
         auto num_4x4_w = num_4x4_blocks_wide_lookup[plane_size];
         auto num_4x4_h = num_4x4_blocks_high_lookup[plane_size];
         auto sub_x = (plane > 0) ? m_subsampling_x : 0;
         auto sub_y = (plane > 0) ? m_subsampling_y : 0;
-        auto base_x = (m_mi_col * 8) >> sub_x;
-        auto base_y = (m_mi_row * 8) >> sub_y;
-        if (m_is_inter) {
-            if (m_mi_size < Block_8x8) {
+        auto base_x = (tile.m_mi_col * 8) >> sub_x;
+        auto base_y = (tile.m_mi_row * 8) >> sub_y;
+        if (tile.m_is_inter) {
+            if (tile.m_mi_size < Block_8x8) {
                 for (auto y = 0; y < num_4x4_h; y++) {
                     for (auto x = 0; x < num_4x4_w; x++) {
-                        TRY(m_decoder.predict_inter(plane, base_x + (4 * x), base_y + (4 * y), 4, 4, (y * num_4x4_w) + x));
+                        TRY(m_decoder.predict_inter(tile, plane, base_x + (4 * x), base_y + (4 * y), 4, 4, (y * num_4x4_w) + x));
                     }
                 }
             } else {
-                TRY(m_decoder.predict_inter(plane, base_x, base_y, num_4x4_w * 4, num_4x4_h * 4, 0));
+                TRY(m_decoder.predict_inter(tile, plane, base_x, base_y, num_4x4_w * 4, num_4x4_h * 4, 0));
             }
         }
         auto max_x = (m_mi_cols * 8) >> sub_x;
@@ -1419,11 +1451,11 @@ DecoderErrorOr<void> Parser::residual()
                 auto start_y = base_y + (4 * y);
                 auto non_zero = false;
                 if (start_x < max_x && start_y < max_y) {
-                    if (!m_is_inter)
-                        TRY(m_decoder.predict_intra(plane, start_x, start_y, m_available_l || x > 0, m_available_u || y > 0, (x + step) < num_4x4_w, tx_size, block_index));
-                    if (!m_skip) {
-                        non_zero = TRY(tokens(plane, start_x, start_y, tx_size, block_index));
-                        TRY(m_decoder.reconstruct(plane, start_x, start_y, tx_size));
+                    if (!tile.m_is_inter)
+                        TRY(m_decoder.predict_intra(tile, plane, start_x, start_y, tile.m_available_l || x > 0, tile.m_available_u || y > 0, (x + step) < num_4x4_w, tx_size, block_index));
+                    if (!tile.m_skip) {
+                        non_zero = TRY(tokens(tile, plane, start_x, start_y, tx_size, block_index));
+                        TRY(m_decoder.reconstruct(tile, plane, start_x, start_y, tx_size));
                     }
                 }
 
@@ -1433,7 +1465,7 @@ DecoderErrorOr<void> Parser::residual()
                 for (; above_sub_context_index < above_sub_context_end; above_sub_context_index++)
                     above_sub_context[above_sub_context_index] = non_zero;
 
-                auto& left_sub_context = m_left_nonzero_context[plane];
+                auto& left_sub_context = tile.m_left_nonzero_context[plane];
                 auto left_sub_context_index = start_y >> 2;
                 auto left_sub_context_end = min(left_sub_context_index + step, left_sub_context.size());
                 for (; left_sub_context_index < left_sub_context_end; left_sub_context_index++)
@@ -1446,11 +1478,11 @@ DecoderErrorOr<void> Parser::residual()
     return {};
 }
 
-TXSize Parser::get_uv_tx_size()
+TXSize Parser::get_uv_tx_size(TileContext& tile)
 {
-    if (m_mi_size < Block_8x8)
+    if (tile.m_mi_size < Block_8x8)
         return TX_4x4;
-    return min(m_tx_size, max_txsize_lookup[get_plane_block_size(m_mi_size, 1)]);
+    return min(tile.m_tx_size, max_txsize_lookup[get_plane_block_size(tile.m_mi_size, 1)]);
 }
 
 BlockSubsize Parser::get_plane_block_size(u32 subsize, u8 plane)
@@ -1460,95 +1492,95 @@ BlockSubsize Parser::get_plane_block_size(u32 subsize, u8 plane)
     return ss_size_lookup[subsize][sub_x][sub_y];
 }
 
-DecoderErrorOr<bool> Parser::tokens(size_t plane, u32 start_x, u32 start_y, TXSize tx_size, u32 block_index)
+DecoderErrorOr<bool> Parser::tokens(TileContext& tile, size_t plane, u32 start_x, u32 start_y, TXSize tx_size, u32 block_index)
 {
     u32 segment_eob = 16 << (tx_size << 1);
-    auto scan = get_scan(plane, tx_size, block_index);
+    auto scan = get_scan(tile, plane, tx_size, block_index);
     auto check_eob = true;
     u32 c = 0;
     for (; c < segment_eob; c++) {
         auto pos = scan[c];
         auto band = (tx_size == TX_4x4) ? coefband_4x4[c] : coefband_8x8plus[c];
-        auto tokens_context = TreeParser::get_tokens_context(m_subsampling_x, m_subsampling_y, m_mi_rows, m_mi_cols, m_above_nonzero_context, m_left_nonzero_context, m_token_cache, tx_size, m_tx_type, plane, start_x, start_y, pos, m_is_inter, band, c);
+        auto tokens_context = TreeParser::get_tokens_context(m_subsampling_x, m_subsampling_y, m_mi_rows, m_mi_cols, m_above_nonzero_context, tile.m_left_nonzero_context, tile.m_token_cache, tx_size, tile.m_tx_type, plane, start_x, start_y, pos, tile.m_is_inter, band, c);
         if (check_eob) {
-            auto more_coefs = TRY_READ(TreeParser::parse_more_coefficients(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, tokens_context));
+            auto more_coefs = TRY_READ(TreeParser::parse_more_coefficients(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, tokens_context));
             if (!more_coefs)
                 break;
         }
-        auto token = TRY_READ(TreeParser::parse_token(*m_bit_stream, *m_probability_tables, *m_syntax_element_counter, tokens_context));
-        m_token_cache[pos] = energy_class[token];
+        auto token = TRY_READ(TreeParser::parse_token(tile.m_bit_stream, *m_probability_tables, tile.m_syntax_element_counter, tokens_context));
+        tile.m_token_cache[pos] = energy_class[token];
         if (token == ZeroToken) {
-            m_tokens[pos] = 0;
+            tile.m_tokens[pos] = 0;
             check_eob = false;
         } else {
-            i32 coef = TRY(read_coef(token));
-            auto sign_bit = TRY_READ(m_bit_stream->read_literal(1));
-            m_tokens[pos] = sign_bit ? -coef : coef;
+            i32 coef = TRY(read_coef(tile, token));
+            auto sign_bit = TRY_READ(tile.m_bit_stream.read_literal(1));
+            tile.m_tokens[pos] = sign_bit ? -coef : coef;
             check_eob = true;
         }
     }
     auto non_zero = c > 0;
-    m_eob_total += non_zero;
+    tile.m_eob_total += non_zero;
     for (u32 i = c; i < segment_eob; i++)
-        m_tokens[scan[i]] = 0;
+        tile.m_tokens[scan[i]] = 0;
     return non_zero;
 }
 
-u32 const* Parser::get_scan(size_t plane, TXSize tx_size, u32 block_index)
+u32 const* Parser::get_scan(TileContext& tile, size_t plane, TXSize tx_size, u32 block_index)
 {
     if (plane > 0 || tx_size == TX_32x32) {
-        m_tx_type = DCT_DCT;
+        tile.m_tx_type = DCT_DCT;
     } else if (tx_size == TX_4x4) {
-        if (m_lossless || m_is_inter)
-            m_tx_type = DCT_DCT;
+        if (m_lossless || tile.m_is_inter)
+            tile.m_tx_type = DCT_DCT;
         else
-            m_tx_type = mode_to_txfm_map[to_underlying(m_mi_size < Block_8x8 ? m_block_sub_modes[block_index] : m_y_mode)];
+            tile.m_tx_type = mode_to_txfm_map[to_underlying(tile.m_mi_size < Block_8x8 ? tile.m_block_sub_modes[block_index] : tile.m_y_mode)];
     } else {
-        m_tx_type = mode_to_txfm_map[to_underlying(m_y_mode)];
+        tile.m_tx_type = mode_to_txfm_map[to_underlying(tile.m_y_mode)];
     }
     if (tx_size == TX_4x4) {
-        if (m_tx_type == ADST_DCT)
+        if (tile.m_tx_type == ADST_DCT)
             return row_scan_4x4;
-        if (m_tx_type == DCT_ADST)
+        if (tile.m_tx_type == DCT_ADST)
             return col_scan_4x4;
         return default_scan_4x4;
     }
     if (tx_size == TX_8x8) {
-        if (m_tx_type == ADST_DCT)
+        if (tile.m_tx_type == ADST_DCT)
             return row_scan_8x8;
-        if (m_tx_type == DCT_ADST)
+        if (tile.m_tx_type == DCT_ADST)
             return col_scan_8x8;
         return default_scan_8x8;
     }
     if (tx_size == TX_16x16) {
-        if (m_tx_type == ADST_DCT)
+        if (tile.m_tx_type == ADST_DCT)
             return row_scan_16x16;
-        if (m_tx_type == DCT_ADST)
+        if (tile.m_tx_type == DCT_ADST)
             return col_scan_16x16;
         return default_scan_16x16;
     }
     return default_scan_32x32;
 }
 
-DecoderErrorOr<i32> Parser::read_coef(Token token)
+DecoderErrorOr<i32> Parser::read_coef(TileContext& tile, Token token)
 {
     auto cat = extra_bits[token][0];
     auto num_extra = extra_bits[token][1];
     u32 coef = extra_bits[token][2];
     if (token == DctValCat6) {
         for (size_t e = 0; e < (u8)(m_bit_depth - 8); e++) {
-            auto high_bit = TRY_READ(m_bit_stream->read_bool(255));
+            auto high_bit = TRY_READ(tile.m_bit_stream.read_bool(255));
             coef += high_bit << (5 + m_bit_depth - e);
         }
     }
     for (size_t e = 0; e < num_extra; e++) {
-        auto coef_bit = TRY_READ(m_bit_stream->read_bool(cat_probs[cat][e]));
+        auto coef_bit = TRY_READ(tile.m_bit_stream.read_bool(cat_probs[cat][e]));
         coef += coef_bit << (num_extra - 1 - e);
     }
     return coef;
 }
 
-bool Parser::is_inside(i32 row, i32 column)
+bool Parser::is_inside(TileContext& tile, i32 row, i32 column)
 {
     if (row < 0)
         return false;
@@ -1556,75 +1588,75 @@ bool Parser::is_inside(i32 row, i32 column)
         return false;
     u32 row_positive = row;
     u32 column_positive = column;
-    return row_positive < m_mi_rows && column_positive >= m_mi_col_start && column_positive < m_mi_col_end;
+    return row_positive < m_mi_rows && column_positive >= tile.m_mi_col_start && column_positive < tile.m_mi_col_end;
 }
 
-void Parser::add_mv_ref_list(u8 ref_list)
+void Parser::add_mv_ref_list(TileContext& tile, u8 ref_list)
 {
-    if (m_ref_mv_count >= 2)
+    if (tile.m_ref_mv_count >= 2)
         return;
-    if (m_ref_mv_count > 0 && m_candidate_mv[ref_list] == m_ref_list_mv[0])
+    if (tile.m_ref_mv_count > 0 && tile.m_candidate_mv[ref_list] == tile.m_ref_list_mv[0])
         return;
 
-    m_ref_list_mv[m_ref_mv_count] = m_candidate_mv[ref_list];
-    m_ref_mv_count++;
+    tile.m_ref_list_mv[tile.m_ref_mv_count] = tile.m_candidate_mv[ref_list];
+    tile.m_ref_mv_count++;
 }
 
-void Parser::get_block_mv(u32 candidate_row, u32 candidate_column, u8 ref_list, bool use_prev)
+void Parser::get_block_mv(TileContext& tile, u32 candidate_row, u32 candidate_column, u8 ref_list, bool use_prev)
 {
     auto index = get_image_index(candidate_row, candidate_column);
     if (use_prev) {
-        m_candidate_mv[ref_list] = m_prev_mvs[index][ref_list];
-        m_candidate_frame[ref_list] = m_prev_ref_frames[index][ref_list];
+        tile.m_candidate_mv[ref_list] = m_prev_mvs[index][ref_list];
+        tile.m_candidate_frame[ref_list] = m_prev_ref_frames[index][ref_list];
     } else {
-        m_candidate_mv[ref_list] = m_mvs[index][ref_list];
-        m_candidate_frame[ref_list] = m_ref_frames[index][ref_list];
+        tile.m_candidate_mv[ref_list] = m_mvs[index][ref_list];
+        tile.m_candidate_frame[ref_list] = m_ref_frames[index][ref_list];
     }
 }
 
-void Parser::if_same_ref_frame_add_mv(u32 candidate_row, u32 candidate_column, ReferenceFrameType ref_frame, bool use_prev)
+void Parser::if_same_ref_frame_add_mv(TileContext& tile, u32 candidate_row, u32 candidate_column, ReferenceFrameType ref_frame, bool use_prev)
 {
     for (auto ref_list = 0u; ref_list < 2; ref_list++) {
-        get_block_mv(candidate_row, candidate_column, ref_list, use_prev);
-        if (m_candidate_frame[ref_list] == ref_frame) {
-            add_mv_ref_list(ref_list);
+        get_block_mv(tile, candidate_row, candidate_column, ref_list, use_prev);
+        if (tile.m_candidate_frame[ref_list] == ref_frame) {
+            add_mv_ref_list(tile, ref_list);
             return;
         }
     }
 }
 
-void Parser::scale_mv(u8 ref_list, ReferenceFrameType ref_frame)
+void Parser::scale_mv(TileContext& tile, u8 ref_list, ReferenceFrameType ref_frame)
 {
-    auto candidate_frame = m_candidate_frame[ref_list];
+    auto candidate_frame = tile.m_candidate_frame[ref_list];
     if (m_ref_frame_sign_bias[candidate_frame] != m_ref_frame_sign_bias[ref_frame])
-        m_candidate_mv[ref_list] *= -1;
+        tile.m_candidate_mv[ref_list] *= -1;
 }
 
-void Parser::if_diff_ref_frame_add_mv(u32 candidate_row, u32 candidate_column, ReferenceFrameType ref_frame, bool use_prev)
+void Parser::if_diff_ref_frame_add_mv(TileContext& tile, u32 candidate_row, u32 candidate_column, ReferenceFrameType ref_frame, bool use_prev)
 {
     for (auto ref_list = 0u; ref_list < 2; ref_list++)
-        get_block_mv(candidate_row, candidate_column, ref_list, use_prev);
-    auto mvs_are_same = m_candidate_mv[0] == m_candidate_mv[1];
-    if (m_candidate_frame[0] > ReferenceFrameType::IntraFrame && m_candidate_frame[0] != ref_frame) {
-        scale_mv(0, ref_frame);
-        add_mv_ref_list(0);
+        get_block_mv(tile, candidate_row, candidate_column, ref_list, use_prev);
+    auto mvs_are_same = tile.m_candidate_mv[0] == tile.m_candidate_mv[1];
+    if (tile.m_candidate_frame[0] > ReferenceFrameType::IntraFrame && tile.m_candidate_frame[0] != ref_frame) {
+        scale_mv(tile, 0, ref_frame);
+        add_mv_ref_list(tile, 0);
     }
-    if (m_candidate_frame[1] > ReferenceFrameType::IntraFrame && m_candidate_frame[1] != ref_frame && !mvs_are_same) {
-        scale_mv(1, ref_frame);
-        add_mv_ref_list(1);
+    if (tile.m_candidate_frame[1] > ReferenceFrameType::IntraFrame && tile.m_candidate_frame[1] != ref_frame && !mvs_are_same) {
+        scale_mv(tile, 1, ref_frame);
+        add_mv_ref_list(tile, 1);
     }
 }
 
-MotionVector Parser::clamp_mv(MotionVector vector, i32 border)
+MotionVector Parser::clamp_mv(TileContext& tile, MotionVector vector, i32 border)
 {
-    i32 blocks_high = num_8x8_blocks_high_lookup[m_mi_size];
+    i32 blocks_high = num_8x8_blocks_high_lookup[tile.m_mi_size];
     // Casts must be done here to prevent subtraction underflow from wrapping the values.
-    i32 mb_to_top_edge = -8 * (static_cast<i32>(m_mi_row) * MI_SIZE);
-    i32 mb_to_bottom_edge = 8 * ((static_cast<i32>(m_mi_rows) - blocks_high - static_cast<i32>(m_mi_row)) * MI_SIZE);
+    i32 mb_to_top_edge = -8 * (static_cast<i32>(tile.m_mi_row) * MI_SIZE);
+    i32 mb_to_bottom_edge = 8 * ((static_cast<i32>(m_mi_rows) - blocks_high - static_cast<i32>(tile.m_mi_row)) * MI_SIZE);
 
-    i32 blocks_wide = num_8x8_blocks_wide_lookup[m_mi_size];
-    i32 mb_to_left_edge = -8 * (static_cast<i32>(m_mi_col) * MI_SIZE);
-    i32 mb_to_right_edge = 8 * ((static_cast<i32>(m_mi_cols) - blocks_wide - static_cast<i32>(m_mi_col)) * MI_SIZE);
+    i32 blocks_wide = num_8x8_blocks_wide_lookup[tile.m_mi_size];
+    i32 mb_to_left_edge = -8 * (static_cast<i32>(tile.m_mi_col) * MI_SIZE);
+    i32 mb_to_right_edge = 8 * ((static_cast<i32>(m_mi_cols) - blocks_wide - static_cast<i32>(tile.m_mi_col)) * MI_SIZE);
 
     return {
         clip_3(mb_to_top_edge - border, mb_to_bottom_edge + border, vector.row()),
@@ -1632,29 +1664,29 @@ MotionVector Parser::clamp_mv(MotionVector vector, i32 border)
     };
 }
 
-void Parser::clamp_mv_ref(u8 i)
+void Parser::clamp_mv_ref(TileContext& tile, u8 i)
 {
-    MotionVector& vector = m_ref_list_mv[i];
-    vector = clamp_mv(vector, MV_BORDER);
+    MotionVector& vector = tile.m_ref_list_mv[i];
+    vector = clamp_mv(tile, vector, MV_BORDER);
 }
 
 // 6.5.1 Find MV refs syntax
-void Parser::find_mv_refs(ReferenceFrameType reference_frame, i32 block)
+void Parser::find_mv_refs(TileContext& tile, ReferenceFrameType reference_frame, i32 block)
 {
-    m_ref_mv_count = 0;
+    tile.m_ref_mv_count = 0;
     bool different_ref_found = false;
     u8 context_counter = 0;
 
-    m_ref_list_mv[0] = {};
-    m_ref_list_mv[1] = {};
+    tile.m_ref_list_mv[0] = {};
+    tile.m_ref_list_mv[1] = {};
 
-    MotionVector base_coordinates = MotionVector(m_mi_row, m_mi_col);
+    MotionVector base_coordinates = MotionVector(tile.m_mi_row, tile.m_mi_col);
 
     for (auto i = 0u; i < 2; i++) {
-        auto offset_vector = mv_ref_blocks[m_mi_size][i];
+        auto offset_vector = mv_ref_blocks[tile.m_mi_size][i];
         auto candidate = base_coordinates + offset_vector;
 
-        if (is_inside(candidate.row(), candidate.column())) {
+        if (is_inside(tile, candidate.row(), candidate.column())) {
             auto candidate_index = get_image_index(candidate.row(), candidate.column());
             auto index = get_image_index(candidate.row(), candidate.column());
             different_ref_found = true;
@@ -1662,7 +1694,7 @@ void Parser::find_mv_refs(ReferenceFrameType reference_frame, i32 block)
 
             for (auto ref_list = 0u; ref_list < 2; ref_list++) {
                 if (m_ref_frames[candidate_index][ref_list] == reference_frame) {
-                    // This section up until add_mv_ref_list() is defined in spec as get_sub_block_mv().
+                    // This section up until add_mv_ref_list(tile) is defined in spec as get_sub_block_mv().
                     constexpr u8 idx_n_column_to_subblock[4][2] = {
                         { 1, 2 },
                         { 1, 3 },
@@ -1670,9 +1702,9 @@ void Parser::find_mv_refs(ReferenceFrameType reference_frame, i32 block)
                         { 3, 3 }
                     };
                     auto index = block >= 0 ? idx_n_column_to_subblock[block][offset_vector.column() == 0] : 3;
-                    m_candidate_mv[ref_list] = m_sub_mvs[candidate_index][ref_list][index];
+                    tile.m_candidate_mv[ref_list] = m_sub_mvs[candidate_index][ref_list][index];
 
-                    add_mv_ref_list(ref_list);
+                    add_mv_ref_list(tile, ref_list);
                     break;
                 }
             }
@@ -1680,28 +1712,28 @@ void Parser::find_mv_refs(ReferenceFrameType reference_frame, i32 block)
     }
 
     for (auto i = 2u; i < MVREF_NEIGHBOURS; i++) {
-        MotionVector candidate = base_coordinates + mv_ref_blocks[m_mi_size][i];
-        if (is_inside(candidate.row(), candidate.column())) {
+        MotionVector candidate = base_coordinates + mv_ref_blocks[tile.m_mi_size][i];
+        if (is_inside(tile, candidate.row(), candidate.column())) {
             different_ref_found = true;
-            if_same_ref_frame_add_mv(candidate.row(), candidate.column(), reference_frame, false);
+            if_same_ref_frame_add_mv(tile, candidate.row(), candidate.column(), reference_frame, false);
         }
     }
     if (m_use_prev_frame_mvs)
-        if_same_ref_frame_add_mv(m_mi_row, m_mi_col, reference_frame, true);
+        if_same_ref_frame_add_mv(tile, tile.m_mi_row, tile.m_mi_col, reference_frame, true);
 
     if (different_ref_found) {
         for (auto i = 0u; i < MVREF_NEIGHBOURS; i++) {
-            MotionVector candidate = base_coordinates + mv_ref_blocks[m_mi_size][i];
-            if (is_inside(candidate.row(), candidate.column()))
-                if_diff_ref_frame_add_mv(candidate.row(), candidate.column(), reference_frame, false);
+            MotionVector candidate = base_coordinates + mv_ref_blocks[tile.m_mi_size][i];
+            if (is_inside(tile, candidate.row(), candidate.column()))
+                if_diff_ref_frame_add_mv(tile, candidate.row(), candidate.column(), reference_frame, false);
         }
     }
     if (m_use_prev_frame_mvs)
-        if_diff_ref_frame_add_mv(m_mi_row, m_mi_col, reference_frame, true);
+        if_diff_ref_frame_add_mv(tile, tile.m_mi_row, tile.m_mi_col, reference_frame, true);
 
-    m_mode_context[reference_frame] = counter_to_context[context_counter];
+    tile.m_mode_context[reference_frame] = counter_to_context[context_counter];
     for (auto i = 0u; i < MAX_MV_REF_CANDIDATES; i++)
-        clamp_mv_ref(i);
+        clamp_mv_ref(tile, i);
 }
 
 bool Parser::use_mv_hp(MotionVector const& vector)
@@ -1709,10 +1741,10 @@ bool Parser::use_mv_hp(MotionVector const& vector)
     return (abs(vector.row()) >> 3) < COMPANDED_MVREF_THRESH && (abs(vector.column()) >> 3) < COMPANDED_MVREF_THRESH;
 }
 
-void Parser::find_best_ref_mvs(u8 ref_list)
+void Parser::find_best_ref_mvs(TileContext& tile, u8 ref_list)
 {
     for (auto i = 0u; i < MAX_MV_REF_CANDIDATES; i++) {
-        auto delta = m_ref_list_mv[i];
+        auto delta = tile.m_ref_list_mv[i];
         auto delta_row = delta.row();
         auto delta_column = delta.column();
         if (!m_allow_high_precision_mv || !use_mv_hp(delta)) {
@@ -1722,43 +1754,43 @@ void Parser::find_best_ref_mvs(u8 ref_list)
                 delta_column += delta_column > 0 ? -1 : 1;
         }
         delta = { delta_row, delta_column };
-        m_ref_list_mv[i] = clamp_mv(delta, (BORDERINPIXELS - INTERP_EXTEND) << 3);
+        tile.m_ref_list_mv[i] = clamp_mv(tile, delta, (BORDERINPIXELS - INTERP_EXTEND) << 3);
     }
 
-    m_nearest_mv[ref_list] = m_ref_list_mv[0];
-    m_near_mv[ref_list] = m_ref_list_mv[1];
-    m_best_mv[ref_list] = m_ref_list_mv[0];
+    tile.m_nearest_mv[ref_list] = tile.m_ref_list_mv[0];
+    tile.m_near_mv[ref_list] = tile.m_ref_list_mv[1];
+    tile.m_best_mv[ref_list] = tile.m_ref_list_mv[0];
 }
 
-void Parser::append_sub8x8_mvs(i32 block, u8 ref_list)
+void Parser::append_sub8x8_mvs(TileContext& tile, i32 block, u8 ref_list)
 {
     MotionVector sub_8x8_mvs[2];
-    find_mv_refs(m_ref_frame[ref_list], block);
+    find_mv_refs(tile, tile.m_ref_frame[ref_list], block);
     auto destination_index = 0;
     if (block == 0) {
         for (auto i = 0u; i < 2; i++)
-            sub_8x8_mvs[destination_index++] = m_ref_list_mv[i];
+            sub_8x8_mvs[destination_index++] = tile.m_ref_list_mv[i];
     } else if (block <= 2) {
-        sub_8x8_mvs[destination_index++] = m_block_mvs[ref_list][0];
+        sub_8x8_mvs[destination_index++] = tile.m_block_mvs[ref_list][0];
     } else {
-        sub_8x8_mvs[destination_index++] = m_block_mvs[ref_list][2];
+        sub_8x8_mvs[destination_index++] = tile.m_block_mvs[ref_list][2];
         for (auto index = 1; index >= 0 && destination_index < 2; index--) {
-            auto block_vector = m_block_mvs[ref_list][index];
+            auto block_vector = tile.m_block_mvs[ref_list][index];
             if (block_vector != sub_8x8_mvs[0])
                 sub_8x8_mvs[destination_index++] = block_vector;
         }
     }
 
     for (auto n = 0u; n < 2 && destination_index < 2; n++) {
-        auto ref_list_vector = m_ref_list_mv[n];
+        auto ref_list_vector = tile.m_ref_list_mv[n];
         if (ref_list_vector != sub_8x8_mvs[0])
             sub_8x8_mvs[destination_index++] = ref_list_vector;
     }
 
     if (destination_index < 2)
         sub_8x8_mvs[destination_index++] = {};
-    m_nearest_mv[ref_list] = sub_8x8_mvs[0];
-    m_near_mv[ref_list] = sub_8x8_mvs[1];
+    tile.m_nearest_mv[ref_list] = sub_8x8_mvs[0];
+    tile.m_near_mv[ref_list] = sub_8x8_mvs[1];
 }
 
 void Parser::dump_info()
@@ -102,47 +102,48 @@ private:
     DecoderErrorOr<void> decode_tiles();
     void clear_above_context();
     u32 get_tile_offset(u32 tile_num, u32 mis, u32 tile_size_log2);
-    DecoderErrorOr<void> decode_tile();
-    void clear_left_context();
-    DecoderErrorOr<void> decode_partition(u32 row, u32 col, BlockSubsize block_subsize);
-    DecoderErrorOr<void> decode_block(u32 row, u32 col, BlockSubsize subsize);
-    DecoderErrorOr<void> mode_info();
-    DecoderErrorOr<void> intra_frame_mode_info();
-    DecoderErrorOr<void> intra_segment_id();
-    DecoderErrorOr<void> read_skip();
-    bool seg_feature_active(u8 feature);
-    DecoderErrorOr<void> read_tx_size(bool allow_select);
-    DecoderErrorOr<void> inter_frame_mode_info();
-    DecoderErrorOr<void> inter_segment_id();
-    u8 get_segment_id();
-    DecoderErrorOr<void> read_is_inter();
-    DecoderErrorOr<void> intra_block_mode_info();
-    DecoderErrorOr<void> inter_block_mode_info();
-    DecoderErrorOr<void> read_ref_frames();
-    DecoderErrorOr<void> assign_mv(bool is_compound);
-    DecoderErrorOr<void> read_mv(u8 ref);
-    DecoderErrorOr<i32> read_mv_component(u8 component);
-    DecoderErrorOr<void> residual();
-    TXSize get_uv_tx_size();
+    DecoderErrorOr<void> decode_tile_row(Vector<TileContext>&);
+    DecoderErrorOr<void> decode_tile(TileContext&);
+    void clear_left_context(TileContext&);
+    DecoderErrorOr<void> decode_partition(TileContext&, u32 row, u32 col, BlockSubsize block_subsize);
+    DecoderErrorOr<void> decode_block(TileContext&, u32 row, u32 col, BlockSubsize subsize);
+    DecoderErrorOr<void> mode_info(TileContext&);
+    DecoderErrorOr<void> intra_frame_mode_info(TileContext&);
+    DecoderErrorOr<void> intra_segment_id(TileContext&);
+    DecoderErrorOr<void> read_skip(TileContext&);
+    bool seg_feature_active(TileContext&, u8 feature);
+    DecoderErrorOr<void> read_tx_size(TileContext&, bool allow_select);
+    DecoderErrorOr<void> inter_frame_mode_info(TileContext&);
+    DecoderErrorOr<void> inter_segment_id(TileContext&);
+    u8 get_segment_id(TileContext&);
+    DecoderErrorOr<void> read_is_inter(TileContext&);
+    DecoderErrorOr<void> intra_block_mode_info(TileContext&);
+    DecoderErrorOr<void> inter_block_mode_info(TileContext&);
+    DecoderErrorOr<void> read_ref_frames(TileContext&);
+    DecoderErrorOr<void> assign_mv(TileContext&, bool is_compound);
+    DecoderErrorOr<void> read_mv(TileContext&, u8 ref);
+    DecoderErrorOr<i32> read_mv_component(TileContext&, u8 component);
+    DecoderErrorOr<void> residual(TileContext&);
+    TXSize get_uv_tx_size(TileContext&);
     BlockSubsize get_plane_block_size(u32 subsize, u8 plane);
-    DecoderErrorOr<bool> tokens(size_t plane, u32 x, u32 y, TXSize tx_size, u32 block_index);
-    u32 const* get_scan(size_t plane, TXSize tx_size, u32 block_index);
-    DecoderErrorOr<i32> read_coef(Token token);
+    DecoderErrorOr<bool> tokens(TileContext&, size_t plane, u32 x, u32 y, TXSize tx_size, u32 block_index);
+    u32 const* get_scan(TileContext&, size_t plane, TXSize tx_size, u32 block_index);
+    DecoderErrorOr<i32> read_coef(TileContext&, Token token);
 
     /* (6.5) Motion Vector Prediction */
-    void find_mv_refs(ReferenceFrameType, i32 block);
-    void find_best_ref_mvs(u8 ref_list);
+    void find_mv_refs(TileContext&, ReferenceFrameType, i32 block);
+    void find_best_ref_mvs(TileContext&, u8 ref_list);
     bool use_mv_hp(MotionVector const& delta_mv);
-    void append_sub8x8_mvs(i32 block, u8 ref_list);
-    bool is_inside(i32 row, i32 column);
-    void clamp_mv_ref(u8 i);
-    MotionVector clamp_mv(MotionVector mvec, i32 border);
+    void append_sub8x8_mvs(TileContext&, i32 block, u8 ref_list);
+    bool is_inside(TileContext&, i32 row, i32 column);
+    void clamp_mv_ref(TileContext&, u8 i);
+    MotionVector clamp_mv(TileContext&, MotionVector mvec, i32 border);
     size_t get_image_index(u32 row, u32 column);
-    void get_block_mv(u32 candidate_row, u32 candidate_column, u8 ref_list, bool use_prev);
-    void if_same_ref_frame_add_mv(u32 candidate_row, u32 candidate_column, ReferenceFrameType ref_frame, bool use_prev);
-    void if_diff_ref_frame_add_mv(u32 candidate_row, u32 candidate_column, ReferenceFrameType ref_frame, bool use_prev);
-    void scale_mv(u8 ref_list, ReferenceFrameType ref_frame);
-    void add_mv_ref_list(u8 ref_list);
+    void get_block_mv(TileContext&, u32 candidate_row, u32 candidate_column, u8 ref_list, bool use_prev);
+    void if_same_ref_frame_add_mv(TileContext&, u32 candidate_row, u32 candidate_column, ReferenceFrameType ref_frame, bool use_prev);
+    void if_diff_ref_frame_add_mv(TileContext&, u32 candidate_row, u32 candidate_column, ReferenceFrameType ref_frame, bool use_prev);
+    void scale_mv(TileContext&, u8 ref_list, ReferenceFrameType ref_frame);
+    void add_mv_ref_list(TileContext&, u8 ref_list);
 
     Gfx::Point<size_t> get_decoded_point_for_plane(u32 row, u32 column, u8 plane);
     Gfx::Size<size_t> get_decoded_size_for_plane(u8 plane);
@@ -199,66 +200,15 @@ private:
     i8 m_loop_filter_ref_deltas[MAX_REF_FRAMES];
     i8 m_loop_filter_mode_deltas[2];
 
-    // FIXME: Move above and left contexts to structs
+    // The left contexts are kept per tile in TileContext.
     Array<Vector<bool>, 3> m_above_nonzero_context;
-    Array<Vector<bool>, 3> m_left_nonzero_context;
     Vector<u8> m_above_seg_pred_context;
-    Vector<u8> m_left_seg_pred_context;
     Vector<u8> m_above_partition_context;
-    Vector<u8> m_left_partition_context;
 
-    // FIXME: Move (some?) mi_.. to an array of struct since they are usually used together.
-    u32 m_mi_row_start { 0 };
-    u32 m_mi_row_end { 0 };
-    u32 m_mi_col_start { 0 };
-    u32 m_mi_col_end { 0 };
-    u32 m_mi_row { 0 };
-    u32 m_mi_col { 0 };
-    BlockSubsize m_mi_size { 0 };
-    bool m_available_u { false };
-    bool m_available_l { false };
-    u8 m_segment_id { 0 };
-    // FIXME: Should this be an enum?
-    // skip equal to 0 indicates that there may be some transform coefficients to read for this block; skip equal to 1
-    // indicates that there are no transform coefficients.
-    //
-    // skip may be set to 0 even if transform blocks contain immediate end of block markers.
-    bool m_skip { false };
-    u8 m_num_8x8 { 0 };
-    bool m_has_rows { false };
-    bool m_has_cols { false };
-    TXSize m_max_tx_size { TX_4x4 };
-    BlockSubsize m_block_subsize { BlockSubsize::Block_4x4 };
-    // The row to use for getting partition tree probability lookups.
-    u32 m_row { 0 };
-    // The column to use for getting partition tree probability lookups.
-    u32 m_col { 0 };
-    TXSize m_tx_size { TX_4x4 };
-    ReferenceFramePair m_ref_frame;
-    bool m_is_inter { false };
-    bool m_is_compound { false };
-    PredictionMode m_default_intra_mode { PredictionMode::DcPred };
-    PredictionMode m_y_mode { 0 };
-    PredictionMode m_block_sub_modes[4];
-    u8 m_num_4x4_w { 0 };
-    u8 m_num_4x4_h { 0 };
-    PredictionMode m_uv_mode { 0 }; // FIXME: Is u8 the right size?
     // FIXME: From spec: NOTE – We are using a 2D array to store the SubModes for clarity. It is possible to reduce memory
     // consumption by only storing one intra mode for each 8x8 horizontal and vertical position, i.e. to use two 1D
     // arrays instead.
     Vector<Array<PredictionMode, 4>> m_sub_modes;
-    ReferenceFramePair m_left_ref_frame;
-    ReferenceFramePair m_above_ref_frame;
-    bool m_left_intra { false };
-    bool m_above_intra { false };
-    bool m_left_single { false };
-    bool m_above_single { false };
-    // The current block's interpolation filter.
-    InterpolationFilter m_interp_filter { EightTap };
-    MotionVectorPair m_mv;
-    MotionVectorPair m_near_mv;
-    MotionVectorPair m_nearest_mv;
-    MotionVectorPair m_best_mv;
     // FIXME: Move these to a struct to store together in one array.
     Gfx::Size<u32> m_ref_frame_size[NUM_REF_FRAMES];
     bool m_ref_subsampling_x[NUM_REF_FRAMES];
@@ -267,16 +217,10 @@ private:
 
     Vector<u16> m_frame_store[NUM_REF_FRAMES][3];
 
-    u32 m_eob_total { 0 };
-    u8 m_tx_type { 0 };
-    u8 m_token_cache[1024];
-    i32 m_tokens[1024];
-    bool m_use_hp { false };
     TXMode m_tx_mode;
     ReferenceMode m_reference_mode;
     ReferenceFrameType m_comp_fixed_ref;
     ReferenceFramePair m_comp_var_ref;
-    MotionVector m_block_mvs[2][4];
     Vector<u8> m_prev_segment_ids;
 
     Vector<bool> m_skips;
@@ -288,15 +232,9 @@ private:
     Vector<ReferenceFramePair> m_prev_ref_frames;
     Vector<MotionVectorPair> m_mvs;
     Vector<MotionVectorPair> m_prev_mvs;
-    MotionVectorPair m_candidate_mv;
-    ReferenceFramePair m_candidate_frame;
     Vector<Array<Array<MotionVector, 4>, 2>> m_sub_mvs;
-    u8 m_ref_mv_count { 0 };
-    MotionVectorPair m_ref_list_mv;
     bool m_use_prev_frame_mvs;
     Vector<InterpolationFilter> m_interp_filters;
-    // Indexed by ReferenceFrame enum.
-    u8 m_mode_context[4] { INVALID_CASE };
 
     OwnPtr<BitStream> m_bit_stream;
     OwnPtr<ProbabilityTables> m_probability_tables;
@@ -34,4 +34,15 @@ void SyntaxElementCounter::clear_counts()
     __builtin_memset(m_counts_more_coefs, 0, TX_SIZES * BLOCK_TYPES * REF_TYPES * COEF_BANDS * PREV_COEF_CONTEXTS * 2);
 }
 
+SyntaxElementCounter& SyntaxElementCounter::operator+=(SyntaxElementCounter const& other)
+{
+    // All of the counts are u8 arrays, so the counters can be added up as flat arrays of bytes. The counts wrap around
+    // the same way they would if all of their syntax elements had been counted by one counter.
+    auto* counts = reinterpret_cast<u8*>(this);
+    auto const* other_counts = reinterpret_cast<u8 const*>(&other);
+    for (size_t i = 0; i < sizeof(SyntaxElementCounter); i++)
+        counts[i] += other_counts[i];
+    return *this;
+}
+
 }
@@ -16,6 +16,9 @@ public:
     /* (8.3) Clear Counts Process */
     void clear_counts();
 
+    // Adds the counts of another counter, e.g. one that was used to decode a single tile.
+    SyntaxElementCounter& operator+=(SyntaxElementCounter const&);
+
     u8 m_counts_intra_mode[BLOCK_SIZE_GROUPS][INTRA_MODES];
     u8 m_counts_uv_mode[INTRA_MODES][INTRA_MODES];
     u8 m_counts_partition[PARTITION_CONTEXTS][PARTITION_TYPES];
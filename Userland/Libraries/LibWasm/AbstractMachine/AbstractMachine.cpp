@@ -10,9 +10,101 @@
 #include <LibWasm/AbstractMachine/Interpreter.h>
 #include <LibWasm/AbstractMachine/Validator.h>
 #include <LibWasm/Types.h>
+#include <sys/mman.h>
 
 namespace Wasm {
 
+#if ARCH(X86_64)
+static size_t guarded_memory_reservation_size_for(MemoryType const& type)
+{
+#    ifdef AK_OS_SERENITY
+    // Note: Our kernel keeps a slot for every page of an anonymous mapping, reserved or not, so reserving all 8 GiB
+    //       would cost ~16 MiB of kernel memory per memory. Instead, the reservation only covers what the memory can
+    //       grow to, and that only if it states a small enough maximum. Accesses that end past it are bounds-checked.
+    auto max = type.limits().max();
+    if (!max.has_value() || max.value() == 0)
+        return 0;
+    u64 max_size = static_cast<u64>(max.value()) * Constants::page_size;
+    if (max_size > Constants::max_capped_guarded_memory_reservation_size)
+        return 0;
+    return max_size;
+#    else
+    (void)type;
+    return Constants::guarded_memory_reservation_size;
+#    endif
+}
+#endif
+
+ErrorOr<MemoryInstance> MemoryInstance::create(MemoryType const& type, Backing backing)
+{
+    MemoryInstance instance { type };
+
+#if ARCH(X86_64)
+    if (backing == Backing::GuardedReservation) {
+        if (auto reservation_size = guarded_memory_reservation_size_for(type); reservation_size != 0) {
+            // Note: If the address space can't be had, the memory simply ends up bounds-checked like any other.
+            auto* reservation = mmap(nullptr, reservation_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (reservation != MAP_FAILED) {
+                instance.m_reservation = static_cast<u8*>(reservation);
+                instance.m_reservation_size = reservation_size;
+            } else {
+                dbgln("LibWasm: Failed to reserve address space for a memory, falling back to bounds checks: {}", Error::from_errno(errno));
+            }
+        }
+    }
+#else
+    (void)backing;
+#endif
+
+    if (!instance.grow(type.limits().min() * Constants::page_size))
+        return Error::from_string_literal("Failed to grow to requested size");
+
+    return { move(instance) };
+}
+
+MemoryInstance::MemoryInstance(MemoryInstance&& other)
+    : m_type(other.m_type)
+    , m_size(exchange(other.m_size, 0))
+    , m_reservation(exchange(other.m_reservation, nullptr))
+    , m_reservation_size(exchange(other.m_reservation_size, 0))
+    , m_buffer(move(other.m_buffer))
+{
+}
+
+MemoryInstance::~MemoryInstance()
+{
+    if (m_reservation)
+        munmap(m_reservation, m_reservation_size);
+}
+
+bool MemoryInstance::grow(size_t size_to_grow)
+{
+    if (size_to_grow == 0)
+        return true;
+    u64 new_size = m_size + size_to_grow;
+    // Can't grow past 2^16 pages.
+    if (new_size >= Constants::page_size * 65536)
+        return false;
+    if (auto max = m_type.limits().max(); max.has_value()) {
+        if (max.value() * Constants::page_size < new_size)
+            return false;
+    }
+    auto previous_size = m_size;
+    if (m_reservation) {
+        // Note: Pages that were never accessible are still untouched, and so read as zero like the spec requires.
+        if (mprotect(m_reservation + previous_size, size_to_grow, PROT_READ | PROT_WRITE) < 0)
+            return false;
+        m_size = new_size;
+        return true;
+    }
+    if (m_buffer.try_resize(new_size).is_error())
+        return false;
+    m_size = new_size;
+    // The spec requires that we zero out everything on grow
+    __builtin_memset(m_buffer.offset_pointer(previous_size), 0, size_to_grow);
+    return true;
+}
+
 Optional<FunctionAddress> Store::allocate(ModuleInstance& module, Module::Function const& function)
 {
     FunctionAddress address { m_functions.size() };
@@ -43,7 +135,7 @@ Optional<TableAddress> Store::allocate(TableType const& type)
 Optional<MemoryAddress> Store::allocate(MemoryType const& type)
 {
     MemoryAddress address { m_memories.size() };
-    auto instance = MemoryInstance::create(type);
+    auto instance = MemoryInstance::create(type, m_memory_backing);
     if (instance.is_error())
         return {};
 
@@ -323,6 +415,7 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
                     size_t offset = 0;
                     result.values().first().value().visit(
                         [&](auto const& value) { offset = value; },
+                        [&](u128 const&) { instantiation_result = InstantiationError { "Data segment offset returned a vector"sv }; },
                         [&](Reference const&) { instantiation_result = InstantiationError { "Data segment offset returned a reference"sv }; });
                     if (instantiation_result.has_value() && instantiation_result->is_error())
                         return;
@@ -70,7 +70,7 @@ public:
     {
     }
 
-    using AnyValueType = Variant<i32, i64, float, double, Reference>;
+    using AnyValueType = Variant<i32, i64, float, double, u128, Reference>;
     explicit Value(AnyValueType value)
         : m_value(move(value))
     {
@@ -99,6 +99,9 @@ public:
         case ValueType::Kind::F64:
             m_value = bit_cast<double>(raw_value);
             break;
+        case ValueType::Kind::V128:
+            m_value = u128(bit_cast<u64>(raw_value), 0u);
+            break;
         case ValueType::Kind::NullFunctionReference:
             VERIFY(raw_value == 0);
             m_value = Reference { Reference::Null { ValueType(ValueType::Kind::FunctionReference) } };
@@ -152,6 +155,7 @@ public:
             [](i64) { return ValueType::Kind::I64; },
             [](float) { return ValueType::Kind::F32; },
             [](double) { return ValueType::Kind::F64; },
+            [](u128) { return ValueType::Kind::V128; },
             [&](Reference const& type) {
                 return type.ref().visit(
                     [](Reference::Func const&) { return ValueType::Kind::FunctionReference; },
@@ -331,41 +335,32 @@ private:
 
 class MemoryInstance {
 public:
-    static ErrorOr<MemoryInstance> create(MemoryType const& type)
-    {
-        MemoryInstance instance { type };
+    enum class Backing {
+        ByteBuffer,
+        // The space that addresses can reach is reserved up front and made accessible as the memory grows, so accesses
+        // the memory doesn't cover fault rather than needing to be checked. Where the reservation can't cover every
+        // address plus offset, only the accesses that end past it are checked.
+        GuardedReservation,
+    };
 
-        if (!instance.grow(type.limits().min() * Constants::page_size))
-            return Error::from_string_literal("Failed to grow to requested size");
+    static ErrorOr<MemoryInstance> create(MemoryType const& type, Backing backing = Backing::GuardedReservation);
 
-        return { move(instance) };
-    }
+    MemoryInstance(MemoryInstance&&);
+    MemoryInstance& operator=(MemoryInstance&&) = delete;
+    ~MemoryInstance();
 
     auto& type() const { return m_type; }
     auto size() const { return m_size; }
-    auto& data() const { return m_data; }
-    auto& data() { return m_data; }
+    Bytes data() { return { base(), m_size }; }
+    ReadonlyBytes data() const { return { base(), m_size }; }
+    u8* base() { return m_reservation ? m_reservation : m_buffer.data(); }
+    u8 const* base() const { return m_reservation ? m_reservation : m_buffer.data(); }
 
-    bool grow(size_t size_to_grow)
-    {
-        if (size_to_grow == 0)
-            return true;
-        u64 new_size = m_data.size() + size_to_grow;
-        // Can't grow past 2^16 pages.
-        if (new_size >= Constants::page_size * 65536)
-            return false;
-        if (auto max = m_type.limits().max(); max.has_value()) {
-            if (max.value() * Constants::page_size < new_size)
-                return false;
-        }
-        auto previous_size = m_size;
-        if (m_data.try_resize(new_size).is_error())
-            return false;
-        m_size = new_size;
-        // The spec requires that we zero out everything on grow
-        __builtin_memset(m_data.offset_pointer(previous_size), 0, size_to_grow);
-        return true;
-    }
+    bool has_guard_pages() const { return m_reservation != nullptr; }
+    size_t reservation_size() const { return m_reservation_size; }
+    u8 const* reservation_end() const { return m_reservation + m_reservation_size; }
+
+    bool grow(size_t size_to_grow);
 
 private:
     explicit MemoryInstance(MemoryType const& type)
@@ -375,7 +370,9 @@ private:
 
     MemoryType const& m_type;
     size_t m_size { 0 };
-    ByteBuffer m_data;
+    u8* m_reservation { nullptr };
+    size_t m_reservation_size { 0 };
+    ByteBuffer m_buffer;
 };
 
 class GlobalInstance {
@@ -444,6 +441,8 @@ public:
     Optional<GlobalAddress> allocate(GlobalType const&, Value);
     Optional<ElementAddress> allocate(ValueType const&, Vector<Reference>);
 
+    void disable_guard_pages() { m_memory_backing = MemoryInstance::Backing::ByteBuffer; }
+
     FunctionInstance* get(FunctionAddress);
     TableInstance* get(TableAddress);
     MemoryInstance* get(MemoryAddress);
@@ -458,6 +457,7 @@ private:
     Vector<GlobalInstance> m_globals;
     Vector<ElementInstance> m_elements;
     Vector<DataInstance> m_datas;
+    MemoryInstance::Backing m_memory_backing { MemoryInstance::Backing::GuardedReservation };
 };
 
 class Label {
@@ -535,6 +535,8 @@ public:
     auto& store() { return m_store; }
 
     void enable_instruction_count_limit() { m_should_limit_instruction_count = true; }
+    // Memories allocated from now on live in a ByteBuffer, for users that need to hand their contents out as one.
+    void disable_guard_pages() { m_store.disable_guard_pages(); }
 
 private:
     Optional<InstantiationError> allocate_all_initial_phase(Module const&, ModuleInstance&, Vector<ExternValue>&, Vector<Value>& global_values);
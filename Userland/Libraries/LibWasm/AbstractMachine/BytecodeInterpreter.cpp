@@ -5,15 +5,21 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/TemporaryChange.h>
 #include <LibWasm/AbstractMachine/AbstractMachine.h>
 #include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Operators.h>
+#include <LibWasm/AbstractMachine/RegisterBytecode.h>
 #include <LibWasm/Opcode.h>
 #include <LibWasm/Printer/Printer.h>
+#include <setjmp.h>
+#include <signal.h>
 
 namespace Wasm {
 
+using namespace AK::SIMD;
+
 #define TRAP_IF_NOT(x)                                                                         \
     do {                                                                                       \
         if (trap_if_not(x, #x##sv)) {                                                          \
@@ -32,6 +38,9 @@ namespace Wasm {
 void BytecodeInterpreter::interpret(Configuration& configuration)
 {
     m_trap.clear();
+    if (auto* compiled = configuration.frame().expression().compiled(); compiled && can_run_compiled_code())
+        return interpret_compiled(configuration, *compiled);
+
     auto& instructions = configuration.frame().expression().instructions();
     auto max_ip_value = InstructionPointer { instructions.size() };
     auto& current_ip_value = configuration.ip();
@@ -55,6 +64,458 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
     }
 }
 
+template<typename T>
+ALWAYS_INLINE static T from_raw(u64 raw)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<float>(static_cast<u32>(raw));
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<double>(raw);
+    else
+        return static_cast<T>(raw);
+}
+
+template<typename T>
+ALWAYS_INLINE static u64 to_raw(T value)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<u32>(value);
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<u64>(value);
+    else if constexpr (sizeof(T) == sizeof(u32))
+        return static_cast<u32>(value);
+    else
+        return static_cast<u64>(value);
+}
+
+// Stores what an operator returned, unless it failed, in which case the reason is returned instead.
+template<typename PushType, typename T>
+ALWAYS_INLINE static Optional<StringView> store_result(u64& destination, T result)
+{
+    if constexpr (IsSpecializationOf<T, AK::Result>) {
+        if (result.is_error())
+            return result.error();
+        destination = to_raw<PushType>(static_cast<PushType>(result.release_value()));
+    } else {
+        destination = to_raw<PushType>(static_cast<PushType>(result));
+    }
+    return {};
+}
+
+static u64 to_raw(Value const& value)
+{
+    return value.value().visit(
+        [](Reference const&) -> u64 { VERIFY_NOT_REACHED(); },
+        [](u128) -> u64 { VERIFY_NOT_REACHED(); },
+        [](auto value) { return to_raw(value); });
+}
+
+static Value from_raw(ValueType type, u64 raw)
+{
+    switch (type.kind()) {
+    case ValueType::I32:
+        return Value(from_raw<i32>(raw));
+    case ValueType::I64:
+        return Value(from_raw<i64>(raw));
+    case ValueType::F32:
+        return Value(from_raw<float>(raw));
+    case ValueType::F64:
+        return Value(from_raw<double>(raw));
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE static T read_little_endian(u8 const* data)
+{
+    if constexpr (IsSame<T, float>) {
+        return bit_cast<float>(read_little_endian<u32>(data));
+    } else if constexpr (IsSame<T, double>) {
+        return bit_cast<double>(read_little_endian<u64>(data));
+    } else {
+        LittleEndian<T> value;
+        __builtin_memcpy(&value, data, sizeof(T));
+        return value;
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE static void write_little_endian(u8* data, T value)
+{
+    if constexpr (IsSame<T, float>) {
+        write_little_endian(data, bit_cast<u32>(value));
+    } else if constexpr (IsSame<T, double>) {
+        write_little_endian(data, bit_cast<u64>(value));
+    } else {
+        LittleEndian<T> little_endian_value { value };
+        __builtin_memcpy(data, &little_endian_value, sizeof(T));
+    }
+}
+
+// Compiled code doesn't bounds-check accesses to memories with guard pages; an access past the end of one faults, and
+// the handler below turns that fault into a trap by jumping back to run_compiled(), which is running the access.
+struct BytecodeInterpreter::MemoryFaultHandler {
+    sigjmp_buf jump_buffer;
+    u8 const* reservation_start { nullptr };
+    u8 const* reservation_end { nullptr };
+};
+
+static thread_local BytecodeInterpreter::MemoryFaultHandler* s_memory_fault_handler { nullptr };
+static struct sigaction s_previous_segv_action;
+
+static void handle_memory_fault(int signal, siginfo_t* info, void* context)
+{
+    auto* handler = s_memory_fault_handler;
+    auto const* address = static_cast<u8 const*>(info->si_addr);
+    // Note: Not every kernel reports the faulting address, if there's none it's assumed to be the memory access.
+    if (handler && handler->reservation_start && (!address || (address >= handler->reservation_start && address < handler->reservation_end)))
+        siglongjmp(handler->jump_buffer, 1);
+
+    // The fault isn't ours, so it goes to whoever handled faults before us. Our handler stays installed, as later
+    // faults in compiled code still have to trap.
+    if (s_previous_segv_action.sa_flags & SA_SIGINFO) {
+        s_previous_segv_action.sa_sigaction(signal, info, context);
+        return;
+    }
+    if (s_previous_segv_action.sa_handler != SIG_DFL && s_previous_segv_action.sa_handler != SIG_IGN) {
+        s_previous_segv_action.sa_handler(signal);
+        return;
+    }
+    // Note: Nothing handled faults before us, so this one kills the process as usual once the access is retried.
+    struct sigaction default_action {};
+    default_action.sa_handler = SIG_DFL;
+    sigemptyset(&default_action.sa_mask);
+    sigaction(signal, &default_action, nullptr);
+}
+
+static bool install_memory_fault_handler()
+{
+    static bool const installed = [] {
+        struct sigaction action {};
+        action.sa_sigaction = handle_memory_fault;
+        // Note: The handler jumps away instead of returning, so SIGSEGV mustn't be blocked while it runs.
+        action.sa_flags = SA_SIGINFO | SA_NODEFER;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGSEGV, &action, &s_previous_segv_action) < 0) {
+            dbgln("LibWasm: Failed to install the memory fault handler, falling back to bounds checks");
+            return false;
+        }
+        return true;
+    }();
+    return installed;
+}
+
+void BytecodeInterpreter::interpret_compiled(Configuration& configuration, CompiledFunction const& function)
+{
+    // Note: The frame is on the stack of the configuration, which calls made by the function can grow, so it must not
+    //       be used after running the function.
+    auto& frame = configuration.frame();
+    Vector<u64, 64> registers;
+    registers.resize(function.register_count());
+    for (size_t i = 0; i < frame.locals().size(); ++i)
+        registers[i] = to_raw(frame.locals()[i]);
+
+    run_compiled(configuration, frame.module(), function, registers.data());
+    if (m_trap.has_value())
+        return;
+
+    auto& result_types = function.result_types();
+    for (size_t i = 0; i < result_types.size(); ++i)
+        configuration.stack().push(from_raw(result_types[i], registers[i]));
+}
+
+bool BytecodeInterpreter::call_from_compiled(Configuration& configuration, FunctionAddress address, u64* arguments)
+{
+    if (m_stack_info.size_free() < Constants::minimum_stack_space_to_keep_free) {
+        m_trap = Trap { "Call stack exhausted" };
+        return false;
+    }
+
+    auto* instance = configuration.store().get(address);
+    if (!instance) {
+        m_trap = Trap { "Nonexistent function" };
+        return false;
+    }
+
+    // Calls between compiled functions don't have to go through the stack of the configuration at all.
+    if (auto* wasm_function = instance->get_pointer<WasmFunction>()) {
+        if (auto* compiled = wasm_function->code().body().compiled()) {
+            Vector<u64, 64> registers;
+            registers.resize(compiled->register_count());
+            auto parameter_count = wasm_function->type().parameters().size();
+            for (size_t i = 0; i < parameter_count; ++i)
+                registers[i] = arguments[i];
+
+            run_compiled(configuration, wasm_function->module(), *compiled, registers.data());
+            if (m_trap.has_value())
+                return false;
+
+            auto result_count = compiled->result_types().size();
+            for (size_t i = 0; i < result_count; ++i)
+                arguments[i] = registers[i];
+            return true;
+        }
+    }
+
+    FunctionType const* type { nullptr };
+    instance->visit([&](auto const& function) { type = &function.type(); });
+    Vector<Value> args;
+    args.ensure_capacity(type->parameters().size());
+    for (size_t i = 0; i < type->parameters().size(); ++i)
+        args.unchecked_append(from_raw(type->parameters()[i], arguments[i]));
+
+    Result result { Trap { ""sv } };
+    {
+        // Whatever runs here isn't compiled code, so none of its faults are memory accesses that should trap.
+        TemporaryChange no_fault_handler { s_memory_fault_handler, static_cast<MemoryFaultHandler*>(nullptr) };
+        CallFrameHandle handle { *this, configuration };
+        result = configuration.call(*this, address, move(args));
+    }
+
+    if (result.is_trap()) {
+        m_trap = move(result.trap());
+        return false;
+    }
+
+    // Note: The results come out of the call in reverse, see call_address().
+    auto& results = result.values();
+    for (size_t i = 0; i < results.size(); ++i)
+        arguments[i] = to_raw(results[results.size() - i - 1]);
+    return true;
+}
+
+void BytecodeInterpreter::run_compiled(Configuration& configuration, ModuleInstance const& module, CompiledFunction const& function, u64* registers)
+{
+    MemoryFaultHandler fault_handler;
+    auto* previous_fault_handler = s_memory_fault_handler;
+    // Note: Nothing between here and the faulting access needs destructing, which is what makes jumping back safe.
+    if (sigsetjmp(fault_handler.jump_buffer, 0) != 0) {
+        s_memory_fault_handler = previous_fault_handler;
+        m_trap = Trap { "Memory access out of bounds" };
+        return;
+    }
+    s_memory_fault_handler = &fault_handler;
+    run_compiled_instructions(configuration, module, function, registers, fault_handler);
+    s_memory_fault_handler = previous_fault_handler;
+}
+
+NEVER_INLINE void BytecodeInterpreter::run_compiled_instructions(Configuration& configuration, ModuleInstance const& module, CompiledFunction const& function, u64* registers, MemoryFaultHandler& fault_handler)
+{
+    static void* const handlers[] = {
+#define M(name, ...) &&handle_##name,
+        ENUMERATE_REGISTER_CONTROL_OPCODES(M)
+        ENUMERATE_REGISTER_LOAD_OPERATIONS(M)
+        ENUMERATE_REGISTER_STORE_OPERATIONS(M)
+        ENUMERATE_REGISTER_BINARY_OPERATIONS(M)
+        ENUMERATE_REGISTER_UNARY_OPERATIONS(M)
+#undef M
+    };
+
+    auto const* instructions = function.instructions().data();
+    auto const* instruction = instructions;
+    auto const should_limit_instruction_count = configuration.should_limit_instruction_count();
+    u64 executed_instructions = 0;
+
+    // Only calls can make the memory go away, so it's looked up again after every call.
+    MemoryInstance* memory = nullptr;
+    // Accesses that end within the reservation can't get anywhere but the memory or its guard pages, so they aren't checked.
+    u64 unchecked_access_limit = 0;
+    auto look_up_memory = [&] {
+        if (memory)
+            return;
+        memory = configuration.store().get(module.memories().first());
+        unchecked_access_limit = 0;
+        if (memory->has_guard_pages() && install_memory_fault_handler()) {
+            fault_handler.reservation_start = memory->base();
+            fault_handler.reservation_end = memory->reservation_end();
+            unchecked_access_limit = memory->reservation_size();
+        }
+    };
+    auto access_memory = [&](u32 base, size_t size) -> u8* {
+        look_up_memory();
+        u64 instance_address = static_cast<u64>(base) + instruction->immediate;
+        if (instance_address + size <= unchecked_access_limit) [[likely]]
+            return memory->base() + instance_address;
+        if (instance_address + size > memory->size()) {
+            m_trap = Trap { "Memory access out of bounds" };
+            dbgln("LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", instance_address + size, memory->size());
+            return nullptr;
+        }
+        return memory->base() + instance_address;
+    };
+
+#define DISPATCH() goto* handlers[to_underlying(instruction->opcode)]
+
+#define NEXT()         \
+    do {               \
+        ++instruction; \
+        DISPATCH();    \
+    } while (false)
+
+    // Only loops can go on forever, so the instruction count limit is checked when jumping back to their start.
+#define JUMP_TO(target)                                                                                             \
+    do {                                                                                                            \
+        auto const* destination = instructions + (target);                                                          \
+        if (destination <= instruction && should_limit_instruction_count) {                                        \
+            executed_instructions += instruction - destination + 1;                                                 \
+            if (executed_instructions >= Constants::max_allowed_executed_instructions_per_call) [[unlikely]] {     \
+                m_trap = Trap { "Exceeded maximum allowed number of instructions" };                                \
+                return;                                                                                             \
+            }                                                                                                       \
+        }                                                                                                           \
+        instruction = destination;                                                                                  \
+        DISPATCH();                                                                                                 \
+    } while (false)
+
+    DISPATCH();
+
+handle_move:
+    registers[instruction->destination] = registers[instruction->lhs];
+    NEXT();
+handle_constant:
+    registers[instruction->destination] = instruction->immediate;
+    NEXT();
+handle_jump:
+    JUMP_TO(instruction->immediate);
+handle_jump_if_zero:
+    if (static_cast<u32>(registers[instruction->lhs]) == 0)
+        JUMP_TO(instruction->immediate);
+    NEXT();
+handle_jump_if_not_zero:
+    if (static_cast<u32>(registers[instruction->lhs]) != 0)
+        JUMP_TO(instruction->immediate);
+    NEXT();
+handle_jump_table: {
+    auto& table = function.branch_table(instruction->immediate);
+    auto index = min(static_cast<size_t>(static_cast<u32>(registers[instruction->lhs])), table.size() - 1);
+    JUMP_TO(table[index]);
+}
+handle_return_:
+    for (size_t i = 0; i < function.result_types().size(); ++i)
+        registers[i] = registers[instruction->lhs + i];
+    return;
+handle_unreachable:
+    m_trap = Trap { "Unreachable" };
+    return;
+handle_call: {
+    auto address = module.functions()[instruction->immediate];
+    dbgln_if(WASM_TRACE_DEBUG, "call({})", address.value());
+    if (!call_from_compiled(configuration, address, registers + instruction->lhs))
+        return;
+    memory = nullptr;
+    NEXT();
+}
+handle_call_indirect: {
+    auto table_address = module.tables()[instruction->destination];
+    auto table_instance = configuration.store().get(table_address);
+    auto index = from_raw<i32>(registers[instruction->rhs]);
+    TRAP_IF_NOT(index >= 0);
+    TRAP_IF_NOT(static_cast<size_t>(index) < table_instance->elements().size());
+    auto element = table_instance->elements()[index];
+    TRAP_IF_NOT(element.has_value());
+    TRAP_IF_NOT(element->ref().has<Reference::Func>());
+    auto address = element->ref().get<Reference::Func>().address;
+
+    // The arguments and results were laid out for the type the call expected, so that had better be the callee's.
+    auto& expected_type = module.types()[instruction->immediate];
+    FunctionType const* type { nullptr };
+    configuration.store().get(address)->visit([&](auto const& function) { type = &function.type(); });
+    TRAP_IF_NOT(type->parameters() == expected_type.parameters() && type->results() == expected_type.results());
+
+    dbgln_if(WASM_TRACE_DEBUG, "call_indirect({} -> {})", index, address.value());
+    if (!call_from_compiled(configuration, address, registers + instruction->lhs))
+        return;
+    memory = nullptr;
+    NEXT();
+}
+handle_select:
+    registers[instruction->destination] = static_cast<u32>(registers[instruction->immediate]) != 0 ? registers[instruction->lhs] : registers[instruction->rhs];
+    NEXT();
+handle_global_get: {
+    auto address = module.globals()[instruction->immediate];
+    registers[instruction->destination] = to_raw(configuration.store().get(address)->value());
+    NEXT();
+}
+handle_global_set: {
+    auto address = module.globals()[instruction->immediate];
+    auto type = ValueType { static_cast<ValueType::Kind>(instruction->rhs) };
+    configuration.store().get(address)->set_value(from_raw(type, registers[instruction->lhs]));
+    NEXT();
+}
+handle_memory_size:
+    look_up_memory();
+    registers[instruction->destination] = static_cast<u32>(memory->size() / Constants::page_size);
+    NEXT();
+handle_memory_grow: {
+    look_up_memory();
+    auto old_pages = static_cast<u32>(memory->size() / Constants::page_size);
+    auto new_pages = static_cast<u32>(registers[instruction->lhs]);
+    dbgln_if(WASM_TRACE_DEBUG, "memory.grow({}), previously {} pages...", new_pages, old_pages);
+    if (memory->grow(static_cast<size_t>(new_pages) * Constants::page_size))
+        registers[instruction->destination] = old_pages;
+    else
+        registers[instruction->destination] = NumericLimits<u32>::max();
+    NEXT();
+}
+
+#define M(name, ReadType, PushType)                                                                 \
+    handle_##name:                                                                                  \
+    {                                                                                               \
+        auto* data = access_memory(static_cast<u32>(registers[instruction->lhs]), sizeof(ReadType)); \
+        if (!data)                                                                                  \
+            return;                                                                                 \
+        auto value = static_cast<PushType>(read_little_endian<ReadType>(data));                    \
+        registers[instruction->destination] = to_raw<PushType>(value);                              \
+        NEXT();                                                                                     \
+    }
+    ENUMERATE_REGISTER_LOAD_OPERATIONS(M)
+#undef M
+
+#define M(name, PopType, StoreType)                                                                  \
+    handle_##name:                                                                                   \
+    {                                                                                                \
+        auto value = static_cast<StoreType>(from_raw<PopType>(registers[instruction->rhs]));        \
+        auto* data = access_memory(static_cast<u32>(registers[instruction->lhs]), sizeof(StoreType)); \
+        if (!data)                                                                                   \
+            return;                                                                                  \
+        write_little_endian<StoreType>(data, value);                                                 \
+        NEXT();                                                                                      \
+    }
+    ENUMERATE_REGISTER_STORE_OPERATIONS(M)
+#undef M
+
+#define M(name, PopType, PushType, Operator)                                                                     \
+    handle_##name:                                                                                               \
+    {                                                                                                            \
+        auto result = Operator {}(from_raw<PopType>(registers[instruction->lhs]), from_raw<PopType>(registers[instruction->rhs])); \
+        if (auto error = store_result<PushType>(registers[instruction->destination], move(result)); error.has_value()) { \
+            m_trap = Trap { *error };                                                                            \
+            return;                                                                                              \
+        }                                                                                                        \
+        NEXT();                                                                                                  \
+    }
+    ENUMERATE_REGISTER_BINARY_OPERATIONS(M)
+#undef M
+
+#define M(name, PopType, PushType, Operator)                                                                     \
+    handle_##name:                                                                                               \
+    {                                                                                                            \
+        auto result = Operator {}(from_raw<PopType>(registers[instruction->lhs]));                               \
+        if (auto error = store_result<PushType>(registers[instruction->destination], move(result)); error.has_value()) { \
+            m_trap = Trap { *error };                                                                            \
+            return;                                                                                              \
+        }                                                                                                        \
+        NEXT();                                                                                                  \
+    }
+    ENUMERATE_REGISTER_UNARY_OPERATIONS(M)
+#undef M
+
+#undef JUMP_TO
+#undef NEXT
+#undef DISPATCH
+}
+
 void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
@@ -103,7 +564,7 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
-    auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
+    auto slice = memory->data().slice(instance_address, sizeof(ReadType));
     configuration.stack().peek() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
 }
 
@@ -142,17 +603,17 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
         configuration.stack().entries().unchecked_append(move(entry));
 }
 
-template<typename PopType, typename PushType, typename Operator>
-void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration)
+template<typename PopType, typename PushType, typename Operator, typename RhsPopType, typename... Args>
+void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration, Args&&... args)
 {
     auto rhs_entry = configuration.stack().pop();
     auto& lhs_entry = configuration.stack().peek();
     auto rhs_ptr = rhs_entry.get_pointer<Value>();
     auto lhs_ptr = lhs_entry.get_pointer<Value>();
-    auto rhs = rhs_ptr->to<PopType>();
+    auto rhs = rhs_ptr->to<RhsPopType>();
     auto lhs = lhs_ptr->to<PopType>();
     PushType result;
-    auto call_result = Operator {}(lhs.value(), rhs.value());
+    auto call_result = Operator { forward<Args>(args)... }(lhs.value(), rhs.value());
     if constexpr (IsSpecializationOf<decltype(call_result), AK::Result>) {
         if (call_result.is_error()) {
             trap_if_not(false, call_result.error());
@@ -166,13 +627,13 @@ void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration)
     lhs_entry = Value(result);
 }
 
-template<typename PopType, typename PushType, typename Operator>
-void BytecodeInterpreter::unary_operation(Configuration& configuration)
+template<typename PopType, typename PushType, typename Operator, typename... Args>
+void BytecodeInterpreter::unary_operation(Configuration& configuration, Args&&... args)
 {
     auto& entry = configuration.stack().peek();
     auto entry_ptr = entry.get_pointer<Value>();
     auto value = entry_ptr->to<PopType>();
-    auto call_result = Operator {}(*value);
+    auto call_result = Operator { forward<Args>(args)... }(*value);
     PushType result;
     if constexpr (IsSpecializationOf<decltype(call_result), AK::Result>) {
         if (call_result.is_error()) {
@@ -229,14 +690,65 @@ void BytecodeInterpreter::pop_and_store(Configuration& configuration, Instructio
     dbgln_if(WASM_TRACE_DEBUG, "stack({}) -> temporary({}b)", value, sizeof(StoreT));
     auto base_entry = configuration.stack().pop();
     auto base = base_entry.get<Value>().to<i32>();
-    store_to_memory(configuration, instruction, { &value, sizeof(StoreT) }, *base);
+    store_to_memory(configuration, instruction.arguments().get<Instruction::MemoryArgument>(), { &value, sizeof(StoreT) }, *base);
 }
 
-void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruction const& instruction, ReadonlyBytes data, i32 base)
+template<typename ReadT, typename Operator>
+void BytecodeInterpreter::load_and_push_vector(Configuration& configuration, Instruction const& instruction)
+{
+    auto& arg = instruction.arguments().get<Instruction::MemoryArgument>();
+    auto base = *configuration.stack().peek().get<Value>().to<i32>();
+    ReadT value;
+    load_from_memory(configuration, arg, { &value, sizeof(ReadT) }, base);
+    if (m_trap.has_value())
+        return;
+    configuration.stack().peek() = Value(Operator {}(value));
+}
+
+template<typename VectorType>
+void BytecodeInterpreter::load_lane(Configuration& configuration, Instruction const& instruction)
+{
+    auto& arg = instruction.arguments().get<Instruction::MemoryAndLaneArgument>();
+    auto vector = bit_cast<VectorType>(*configuration.stack().pop().get<Value>().to<u128>());
+    auto base = *configuration.stack().peek().get<Value>().to<i32>();
+    Operators::LaneType<VectorType> lane;
+    load_from_memory(configuration, arg.memory, { &lane, sizeof(lane) }, base);
+    if (m_trap.has_value())
+        return;
+    vector[arg.lane] = lane;
+    configuration.stack().peek() = Value(bit_cast<u128>(vector));
+}
+
+template<typename VectorType>
+void BytecodeInterpreter::pop_and_store_lane(Configuration& configuration, Instruction const& instruction)
+{
+    auto& arg = instruction.arguments().get<Instruction::MemoryAndLaneArgument>();
+    auto vector = bit_cast<VectorType>(*configuration.stack().pop().get<Value>().to<u128>());
+    auto base = *configuration.stack().pop().get<Value>().to<i32>();
+    Operators::LaneType<VectorType> lane = vector[arg.lane];
+    store_to_memory(configuration, arg.memory, { &lane, sizeof(lane) }, base);
+}
+
+void BytecodeInterpreter::load_from_memory(Configuration& configuration, Instruction::MemoryArgument const& arg, Bytes data, i32 base)
+{
+    auto& address = configuration.frame().module().memories().first();
+    auto memory = configuration.store().get(address);
+    u64 instance_address = static_cast<u64>(bit_cast<u32>(base)) + arg.offset;
+    Checked addition { instance_address };
+    addition += data.size();
+    if (addition.has_overflow() || addition.value() > memory->size()) {
+        m_trap = Trap { "Memory access out of bounds" };
+        dbgln("LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", instance_address + data.size(), memory->size());
+        return;
+    }
+    dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> temporary", instance_address, data.size());
+    memory->data().slice(instance_address, data.size()).copy_to(data);
+}
+
+void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruction::MemoryArgument const& arg, ReadonlyBytes data, i32 base)
 {
     auto& address = configuration.frame().module().memories().first();
     auto memory = configuration.store().get(address);
-    auto& arg = instruction.arguments().get<Instruction::MemoryArgument>();
     u64 instance_address = static_cast<u64>(bit_cast<u32>(base)) + arg.offset;
     Checked addition { instance_address };
     addition += data.size();
@@ -246,7 +758,7 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "temporary({}b) -> store({})", data.size(), instance_address);
-    data.copy_to(memory->data().bytes().slice(instance_address, data.size()));
+    data.copy_to(memory->data().slice(instance_address, data.size()));
 }
 
 template<typename T>
@@ -938,17 +1450,498 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         TRAP_IF_NOT(source_offset + count > 0);
         TRAP_IF_NOT(static_cast<size_t>(source_offset + count) <= data.size());
 
-        Instruction synthetic_store_instruction {
-            Instructions::i32_store8,
-            Instruction::MemoryArgument { 0, 0 }
-        };
-
+        Instruction::MemoryArgument memory_argument { 0, 0 };
         for (size_t i = 0; i < (size_t)count; ++i) {
             auto value = data.data()[source_offset + i];
-            store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset + i);
+            store_to_memory(configuration, memory_argument, { &value, sizeof(value) }, destination_offset + i);
         }
         return;
     }
+    case Instructions::v128_load.value():
+        return load_and_push_vector<u128, Operators::VectorZeroExtend>(configuration, instruction);
+    case Instructions::v128_load8x8_s.value():
+        return load_and_push_vector<i8x8, Operators::VectorWiden<i16x8>>(configuration, instruction);
+    case Instructions::v128_load8x8_u.value():
+        return load_and_push_vector<u8x8, Operators::VectorWiden<u16x8>>(configuration, instruction);
+    case Instructions::v128_load16x4_s.value():
+        return load_and_push_vector<i16x4, Operators::VectorWiden<i32x4>>(configuration, instruction);
+    case Instructions::v128_load16x4_u.value():
+        return load_and_push_vector<u16x4, Operators::VectorWiden<u32x4>>(configuration, instruction);
+    case Instructions::v128_load32x2_s.value():
+        return load_and_push_vector<i32x2, Operators::VectorWiden<i64x2>>(configuration, instruction);
+    case Instructions::v128_load32x2_u.value():
+        return load_and_push_vector<u32x2, Operators::VectorWiden<u64x2>>(configuration, instruction);
+    case Instructions::v128_load8_splat.value():
+        return load_and_push_vector<u8, Operators::VectorSplat<u8x16>>(configuration, instruction);
+    case Instructions::v128_load16_splat.value():
+        return load_and_push_vector<u16, Operators::VectorSplat<u16x8>>(configuration, instruction);
+    case Instructions::v128_load32_splat.value():
+        return load_and_push_vector<u32, Operators::VectorSplat<u32x4>>(configuration, instruction);
+    case Instructions::v128_load64_splat.value():
+        return load_and_push_vector<u64, Operators::VectorSplat<u64x2>>(configuration, instruction);
+    case Instructions::v128_load32_zero.value():
+        return load_and_push_vector<u32, Operators::VectorZeroExtend>(configuration, instruction);
+    case Instructions::v128_load64_zero.value():
+        return load_and_push_vector<u64, Operators::VectorZeroExtend>(configuration, instruction);
+    case Instructions::v128_load8_lane.value():
+        return load_lane<u8x16>(configuration, instruction);
+    case Instructions::v128_load16_lane.value():
+        return load_lane<u16x8>(configuration, instruction);
+    case Instructions::v128_load32_lane.value():
+        return load_lane<u32x4>(configuration, instruction);
+    case Instructions::v128_load64_lane.value():
+        return load_lane<u64x2>(configuration, instruction);
+    case Instructions::v128_store.value(): {
+        auto value = *configuration.stack().pop().get<Value>().to<u128>();
+        auto base = *configuration.stack().pop().get<Value>().to<i32>();
+        dbgln_if(WASM_TRACE_DEBUG, "stack({}) -> temporary(16b)", value);
+        store_to_memory(configuration, instruction.arguments().get<Instruction::MemoryArgument>(), { &value, sizeof(value) }, base);
+        return;
+    }
+    case Instructions::v128_store8_lane.value():
+        return pop_and_store_lane<u8x16>(configuration, instruction);
+    case Instructions::v128_store16_lane.value():
+        return pop_and_store_lane<u16x8>(configuration, instruction);
+    case Instructions::v128_store32_lane.value():
+        return pop_and_store_lane<u32x4>(configuration, instruction);
+    case Instructions::v128_store64_lane.value():
+        return pop_and_store_lane<u64x2>(configuration, instruction);
+    case Instructions::v128_const.value():
+        configuration.stack().push(Value(instruction.arguments().get<u128>()));
+        return;
+    case Instructions::i8x16_shuffle.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShuffle>(configuration, instruction.arguments().get<Instruction::ShuffleArgument>().lanes.data());
+    case Instructions::i8x16_swizzle.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorSwizzle>(configuration);
+    case Instructions::i8x16_splat.value():
+        return unary_operation<i32, u128, Operators::VectorSplat<i8x16>>(configuration);
+    case Instructions::i16x8_splat.value():
+        return unary_operation<i32, u128, Operators::VectorSplat<i16x8>>(configuration);
+    case Instructions::i32x4_splat.value():
+        return unary_operation<i32, u128, Operators::VectorSplat<i32x4>>(configuration);
+    case Instructions::i64x2_splat.value():
+        return unary_operation<i64, u128, Operators::VectorSplat<i64x2>>(configuration);
+    case Instructions::f32x4_splat.value():
+        return unary_operation<float, u128, Operators::VectorSplat<f32x4>>(configuration);
+    case Instructions::f64x2_splat.value():
+        return unary_operation<double, u128, Operators::VectorSplat<f64x2>>(configuration);
+    case Instructions::i8x16_extract_lane_s.value():
+        return unary_operation<u128, i32, Operators::VectorExtractLane<i8x16, i32>>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i8x16_extract_lane_u.value():
+        return unary_operation<u128, i32, Operators::VectorExtractLane<u8x16, i32>>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i8x16_replace_lane.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorReplaceLane<i8x16>, i32>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i16x8_extract_lane_s.value():
+        return unary_operation<u128, i32, Operators::VectorExtractLane<i16x8, i32>>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i16x8_extract_lane_u.value():
+        return unary_operation<u128, i32, Operators::VectorExtractLane<u16x8, i32>>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i16x8_replace_lane.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorReplaceLane<i16x8>, i32>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i32x4_extract_lane.value():
+        return unary_operation<u128, i32, Operators::VectorExtractLane<i32x4, i32>>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i32x4_replace_lane.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorReplaceLane<i32x4>, i32>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i64x2_extract_lane.value():
+        return unary_operation<u128, i64, Operators::VectorExtractLane<i64x2, i64>>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i64x2_replace_lane.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorReplaceLane<i64x2>, i64>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::f32x4_extract_lane.value():
+        return unary_operation<u128, float, Operators::VectorExtractLane<f32x4, float>>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::f32x4_replace_lane.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorReplaceLane<f32x4>, float>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::f64x2_extract_lane.value():
+        return unary_operation<u128, double, Operators::VectorExtractLane<f64x2, double>>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::f64x2_replace_lane.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorReplaceLane<f64x2>, double>(configuration, instruction.arguments().get<Instruction::LaneIndex>().lane);
+    case Instructions::i8x16_eq.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i8x16, Operators::Equals>>(configuration);
+    case Instructions::i8x16_ne.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i8x16, Operators::NotEquals>>(configuration);
+    case Instructions::i8x16_lt_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i8x16, Operators::LessThan>>(configuration);
+    case Instructions::i8x16_lt_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u8x16, Operators::LessThan>>(configuration);
+    case Instructions::i8x16_gt_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i8x16, Operators::GreaterThan>>(configuration);
+    case Instructions::i8x16_gt_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u8x16, Operators::GreaterThan>>(configuration);
+    case Instructions::i8x16_le_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i8x16, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::i8x16_le_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u8x16, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::i8x16_ge_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i8x16, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::i8x16_ge_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u8x16, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::i16x8_eq.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i16x8, Operators::Equals>>(configuration);
+    case Instructions::i16x8_ne.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i16x8, Operators::NotEquals>>(configuration);
+    case Instructions::i16x8_lt_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i16x8, Operators::LessThan>>(configuration);
+    case Instructions::i16x8_lt_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u16x8, Operators::LessThan>>(configuration);
+    case Instructions::i16x8_gt_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i16x8, Operators::GreaterThan>>(configuration);
+    case Instructions::i16x8_gt_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u16x8, Operators::GreaterThan>>(configuration);
+    case Instructions::i16x8_le_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i16x8, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::i16x8_le_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u16x8, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::i16x8_ge_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i16x8, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::i16x8_ge_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u16x8, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::i32x4_eq.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i32x4, Operators::Equals>>(configuration);
+    case Instructions::i32x4_ne.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i32x4, Operators::NotEquals>>(configuration);
+    case Instructions::i32x4_lt_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i32x4, Operators::LessThan>>(configuration);
+    case Instructions::i32x4_lt_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u32x4, Operators::LessThan>>(configuration);
+    case Instructions::i32x4_gt_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i32x4, Operators::GreaterThan>>(configuration);
+    case Instructions::i32x4_gt_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u32x4, Operators::GreaterThan>>(configuration);
+    case Instructions::i32x4_le_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i32x4, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::i32x4_le_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u32x4, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::i32x4_ge_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i32x4, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::i32x4_ge_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u32x4, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::f32x4_eq.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::Equals>>(configuration);
+    case Instructions::f32x4_ne.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::NotEquals>>(configuration);
+    case Instructions::f32x4_lt.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::LessThan>>(configuration);
+    case Instructions::f32x4_gt.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::GreaterThan>>(configuration);
+    case Instructions::f32x4_le.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::f32x4_ge.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::f64x2_eq.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::Equals>>(configuration);
+    case Instructions::f64x2_ne.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::NotEquals>>(configuration);
+    case Instructions::f64x2_lt.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::LessThan>>(configuration);
+    case Instructions::f64x2_gt.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::GreaterThan>>(configuration);
+    case Instructions::f64x2_le.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::f64x2_ge.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::v128_not.value():
+        return unary_operation<u128, u128, Operators::VectorWise<u64x2, Operators::BitNot>>(configuration);
+    case Instructions::v128_and.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u64x2, Operators::BitAnd>>(configuration);
+    case Instructions::v128_andnot.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u64x2, Operators::BitAndNot>>(configuration);
+    case Instructions::v128_or.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u64x2, Operators::BitOr>>(configuration);
+    case Instructions::v128_xor.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u64x2, Operators::BitXor>>(configuration);
+    case Instructions::v128_bitselect.value(): {
+        auto mask = *configuration.stack().pop().get<Value>().to<u128>();
+        auto false_vector = *configuration.stack().pop().get<Value>().to<u128>();
+        auto true_vector = *configuration.stack().peek().get<Value>().to<u128>();
+        auto result = (true_vector & mask) | (false_vector & ~mask);
+        dbgln_if(WASM_TRACE_DEBUG, "bitselect({}, {}, {}) = {}", true_vector, false_vector, mask, result);
+        configuration.stack().peek() = Value(result);
+        return;
+    }
+    case Instructions::v128_any_true.value():
+        return unary_operation<u128, i32, Operators::VectorAnyTrue>(configuration);
+    case Instructions::f32x4_demote_f64x2_zero.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<f64x2, f32x4, Operators::Demote>>(configuration);
+    case Instructions::f64x2_promote_low_f32x4.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<f32x4, f64x2, Operators::Promote>>(configuration);
+    case Instructions::i8x16_abs.value():
+        return unary_operation<u128, u128, Operators::LaneWise<i8x16, Operators::WrappingAbsolute>>(configuration);
+    case Instructions::i8x16_neg.value():
+        return unary_operation<u128, u128, Operators::VectorWise<u8x16, Operators::Negate>>(configuration);
+    case Instructions::i8x16_popcnt.value():
+        return unary_operation<u128, u128, Operators::LaneWise<u8x16, Operators::PopCount>>(configuration);
+    case Instructions::i8x16_all_true.value():
+        return unary_operation<u128, i32, Operators::VectorAllTrue<i8x16>>(configuration);
+    case Instructions::i8x16_bitmask.value():
+        return unary_operation<u128, i32, Operators::VectorBitmask<i8x16>>(configuration);
+    case Instructions::i8x16_narrow_i16x8_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorNarrow<i16x8, i8x16>>(configuration);
+    case Instructions::i8x16_narrow_i16x8_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorNarrow<i16x8, u8x16>>(configuration);
+    case Instructions::i8x16_shl.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<u8x16, Operators::BitShiftLeft>, i32>(configuration);
+    case Instructions::i8x16_shr_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<i8x16, Operators::BitShiftRight>, i32>(configuration);
+    case Instructions::i8x16_shr_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<u8x16, Operators::BitShiftRight>, i32>(configuration);
+    case Instructions::i8x16_add.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u8x16, Operators::Add>>(configuration);
+    case Instructions::i8x16_add_sat_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i8x16, Operators::SaturatingAdd>>(configuration);
+    case Instructions::i8x16_add_sat_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u8x16, Operators::SaturatingAdd>>(configuration);
+    case Instructions::i8x16_sub.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u8x16, Operators::Subtract>>(configuration);
+    case Instructions::i8x16_sub_sat_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i8x16, Operators::SaturatingSubtract>>(configuration);
+    case Instructions::i8x16_sub_sat_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u8x16, Operators::SaturatingSubtract>>(configuration);
+    case Instructions::i8x16_min_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i8x16, Operators::Minimum>>(configuration);
+    case Instructions::i8x16_min_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u8x16, Operators::Minimum>>(configuration);
+    case Instructions::i8x16_max_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i8x16, Operators::Maximum>>(configuration);
+    case Instructions::i8x16_max_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u8x16, Operators::Maximum>>(configuration);
+    case Instructions::i8x16_avgr_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u8x16, Operators::RoundingAverage>>(configuration);
+    case Instructions::i16x8_abs.value():
+        return unary_operation<u128, u128, Operators::LaneWise<i16x8, Operators::WrappingAbsolute>>(configuration);
+    case Instructions::i16x8_neg.value():
+        return unary_operation<u128, u128, Operators::VectorWise<u16x8, Operators::Negate>>(configuration);
+    case Instructions::i16x8_q15mulr_sat_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i16x8, Operators::Q15MultiplyRoundSaturating>>(configuration);
+    case Instructions::i16x8_all_true.value():
+        return unary_operation<u128, i32, Operators::VectorAllTrue<i16x8>>(configuration);
+    case Instructions::i16x8_bitmask.value():
+        return unary_operation<u128, i32, Operators::VectorBitmask<i16x8>>(configuration);
+    case Instructions::i16x8_narrow_i32x4_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorNarrow<i32x4, i16x8>>(configuration);
+    case Instructions::i16x8_narrow_i32x4_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorNarrow<i32x4, u16x8>>(configuration);
+    case Instructions::i16x8_extend_low_i8x16_s.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<i8x16, i16x8, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i16x8_extend_low_i8x16_u.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<u8x16, u16x8, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i16x8_extend_high_i8x16_s.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<i8x16, i16x8, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i16x8_extend_high_i8x16_u.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<u8x16, u16x8, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i16x8_shl.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<u16x8, Operators::BitShiftLeft>, i32>(configuration);
+    case Instructions::i16x8_shr_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<i16x8, Operators::BitShiftRight>, i32>(configuration);
+    case Instructions::i16x8_shr_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<u16x8, Operators::BitShiftRight>, i32>(configuration);
+    case Instructions::i16x8_add.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u16x8, Operators::Add>>(configuration);
+    case Instructions::i16x8_add_sat_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i16x8, Operators::SaturatingAdd>>(configuration);
+    case Instructions::i16x8_add_sat_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u16x8, Operators::SaturatingAdd>>(configuration);
+    case Instructions::i16x8_sub.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u16x8, Operators::Subtract>>(configuration);
+    case Instructions::i16x8_sub_sat_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i16x8, Operators::SaturatingSubtract>>(configuration);
+    case Instructions::i16x8_sub_sat_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u16x8, Operators::SaturatingSubtract>>(configuration);
+    case Instructions::i16x8_mul.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u16x8, Operators::Multiply>>(configuration);
+    case Instructions::i16x8_min_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i16x8, Operators::Minimum>>(configuration);
+    case Instructions::i16x8_min_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u16x8, Operators::Minimum>>(configuration);
+    case Instructions::i16x8_max_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i16x8, Operators::Maximum>>(configuration);
+    case Instructions::i16x8_max_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u16x8, Operators::Maximum>>(configuration);
+    case Instructions::i16x8_avgr_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u16x8, Operators::RoundingAverage>>(configuration);
+    case Instructions::i16x8_extadd_pairwise_i8x16_s.value():
+        return unary_operation<u128, u128, Operators::VectorExtendAddPairwise<i8x16, i16x8>>(configuration);
+    case Instructions::i16x8_extadd_pairwise_i8x16_u.value():
+        return unary_operation<u128, u128, Operators::VectorExtendAddPairwise<u8x16, u16x8>>(configuration);
+    case Instructions::i16x8_extmul_low_i8x16_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<i8x16, i16x8, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i16x8_extmul_low_i8x16_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<u8x16, u16x8, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i16x8_extmul_high_i8x16_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<i8x16, i16x8, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i16x8_extmul_high_i8x16_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<u8x16, u16x8, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i32x4_abs.value():
+        return unary_operation<u128, u128, Operators::LaneWise<i32x4, Operators::WrappingAbsolute>>(configuration);
+    case Instructions::i32x4_neg.value():
+        return unary_operation<u128, u128, Operators::VectorWise<u32x4, Operators::Negate>>(configuration);
+    case Instructions::i32x4_all_true.value():
+        return unary_operation<u128, i32, Operators::VectorAllTrue<i32x4>>(configuration);
+    case Instructions::i32x4_bitmask.value():
+        return unary_operation<u128, i32, Operators::VectorBitmask<i32x4>>(configuration);
+    case Instructions::i32x4_extend_low_i16x8_s.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<i16x8, i32x4, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i32x4_extend_low_i16x8_u.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<u16x8, u32x4, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i32x4_extend_high_i16x8_s.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<i16x8, i32x4, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i32x4_extend_high_i16x8_u.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<u16x8, u32x4, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i32x4_shl.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<u32x4, Operators::BitShiftLeft>, i32>(configuration);
+    case Instructions::i32x4_shr_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<i32x4, Operators::BitShiftRight>, i32>(configuration);
+    case Instructions::i32x4_shr_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<u32x4, Operators::BitShiftRight>, i32>(configuration);
+    case Instructions::i32x4_add.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u32x4, Operators::Add>>(configuration);
+    case Instructions::i32x4_sub.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u32x4, Operators::Subtract>>(configuration);
+    case Instructions::i32x4_mul.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u32x4, Operators::Multiply>>(configuration);
+    case Instructions::i32x4_min_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i32x4, Operators::Minimum>>(configuration);
+    case Instructions::i32x4_min_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u32x4, Operators::Minimum>>(configuration);
+    case Instructions::i32x4_max_s.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<i32x4, Operators::Maximum>>(configuration);
+    case Instructions::i32x4_max_u.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<u32x4, Operators::Maximum>>(configuration);
+    case Instructions::i32x4_extadd_pairwise_i16x8_s.value():
+        return unary_operation<u128, u128, Operators::VectorExtendAddPairwise<i16x8, i32x4>>(configuration);
+    case Instructions::i32x4_extadd_pairwise_i16x8_u.value():
+        return unary_operation<u128, u128, Operators::VectorExtendAddPairwise<u16x8, u32x4>>(configuration);
+    case Instructions::i32x4_dot_i16x8_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorDot>(configuration);
+    case Instructions::i32x4_extmul_low_i16x8_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<i16x8, i32x4, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i32x4_extmul_low_i16x8_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<u16x8, u32x4, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i32x4_extmul_high_i16x8_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<i16x8, i32x4, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i32x4_extmul_high_i16x8_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<u16x8, u32x4, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i64x2_abs.value():
+        return unary_operation<u128, u128, Operators::LaneWise<i64x2, Operators::WrappingAbsolute>>(configuration);
+    case Instructions::i64x2_neg.value():
+        return unary_operation<u128, u128, Operators::VectorWise<u64x2, Operators::Negate>>(configuration);
+    case Instructions::i64x2_all_true.value():
+        return unary_operation<u128, i32, Operators::VectorAllTrue<i64x2>>(configuration);
+    case Instructions::i64x2_bitmask.value():
+        return unary_operation<u128, i32, Operators::VectorBitmask<i64x2>>(configuration);
+    case Instructions::i64x2_extend_low_i32x4_s.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<i32x4, i64x2, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i64x2_extend_low_i32x4_u.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<u32x4, u64x2, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i64x2_extend_high_i32x4_s.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<i32x4, i64x2, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i64x2_extend_high_i32x4_u.value():
+        return unary_operation<u128, u128, Operators::VectorExtend<u32x4, u64x2, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i64x2_shl.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<u64x2, Operators::BitShiftLeft>, i32>(configuration);
+    case Instructions::i64x2_shr_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<i64x2, Operators::BitShiftRight>, i32>(configuration);
+    case Instructions::i64x2_shr_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorShift<u64x2, Operators::BitShiftRight>, i32>(configuration);
+    case Instructions::i64x2_add.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u64x2, Operators::Add>>(configuration);
+    case Instructions::i64x2_sub.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u64x2, Operators::Subtract>>(configuration);
+    case Instructions::i64x2_mul.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<u64x2, Operators::Multiply>>(configuration);
+    case Instructions::i64x2_eq.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i64x2, Operators::Equals>>(configuration);
+    case Instructions::i64x2_ne.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i64x2, Operators::NotEquals>>(configuration);
+    case Instructions::i64x2_lt_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i64x2, Operators::LessThan>>(configuration);
+    case Instructions::i64x2_gt_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i64x2, Operators::GreaterThan>>(configuration);
+    case Instructions::i64x2_le_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i64x2, Operators::LessThanOrEquals>>(configuration);
+    case Instructions::i64x2_ge_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<i64x2, Operators::GreaterThanOrEquals>>(configuration);
+    case Instructions::i64x2_extmul_low_i32x4_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<i32x4, i64x2, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i64x2_extmul_low_i32x4_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<u32x4, u64x2, Operators::VectorHalf::Low>>(configuration);
+    case Instructions::i64x2_extmul_high_i32x4_s.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<i32x4, i64x2, Operators::VectorHalf::High>>(configuration);
+    case Instructions::i64x2_extmul_high_i32x4_u.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorExtendMultiply<u32x4, u64x2, Operators::VectorHalf::High>>(configuration);
+    case Instructions::f32x4_ceil.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f32x4, Operators::Ceil>>(configuration);
+    case Instructions::f32x4_floor.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f32x4, Operators::Floor>>(configuration);
+    case Instructions::f32x4_trunc.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f32x4, Operators::Truncate>>(configuration);
+    case Instructions::f32x4_nearest.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f32x4, Operators::NearbyIntegral>>(configuration);
+    case Instructions::f32x4_abs.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f32x4, Operators::Absolute>>(configuration);
+    case Instructions::f32x4_neg.value():
+        return unary_operation<u128, u128, Operators::VectorWise<f32x4, Operators::Negate>>(configuration);
+    case Instructions::f32x4_sqrt.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f32x4, Operators::SquareRoot>>(configuration);
+    case Instructions::f32x4_add.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::Add>>(configuration);
+    case Instructions::f32x4_sub.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::Subtract>>(configuration);
+    case Instructions::f32x4_mul.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f32x4, Operators::Multiply>>(configuration);
+    case Instructions::f32x4_div.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f32x4, Operators::Divide>>(configuration);
+    case Instructions::f32x4_min.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f32x4, Operators::Minimum>>(configuration);
+    case Instructions::f32x4_max.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f32x4, Operators::Maximum>>(configuration);
+    case Instructions::f32x4_pmin.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f32x4, Operators::PseudoMinimum>>(configuration);
+    case Instructions::f32x4_pmax.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f32x4, Operators::PseudoMaximum>>(configuration);
+    case Instructions::f64x2_ceil.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f64x2, Operators::Ceil>>(configuration);
+    case Instructions::f64x2_floor.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f64x2, Operators::Floor>>(configuration);
+    case Instructions::f64x2_trunc.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f64x2, Operators::Truncate>>(configuration);
+    case Instructions::f64x2_nearest.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f64x2, Operators::NearbyIntegral>>(configuration);
+    case Instructions::f64x2_abs.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f64x2, Operators::Absolute>>(configuration);
+    case Instructions::f64x2_neg.value():
+        return unary_operation<u128, u128, Operators::VectorWise<f64x2, Operators::Negate>>(configuration);
+    case Instructions::f64x2_sqrt.value():
+        return unary_operation<u128, u128, Operators::LaneWise<f64x2, Operators::SquareRoot>>(configuration);
+    case Instructions::f64x2_add.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::Add>>(configuration);
+    case Instructions::f64x2_sub.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::Subtract>>(configuration);
+    case Instructions::f64x2_mul.value():
+        return binary_numeric_operation<u128, u128, Operators::VectorWise<f64x2, Operators::Multiply>>(configuration);
+    case Instructions::f64x2_div.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f64x2, Operators::Divide>>(configuration);
+    case Instructions::f64x2_min.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f64x2, Operators::Minimum>>(configuration);
+    case Instructions::f64x2_max.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f64x2, Operators::Maximum>>(configuration);
+    case Instructions::f64x2_pmin.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f64x2, Operators::PseudoMinimum>>(configuration);
+    case Instructions::f64x2_pmax.value():
+        return binary_numeric_operation<u128, u128, Operators::LaneWise<f64x2, Operators::PseudoMaximum>>(configuration);
+    case Instructions::i32x4_trunc_sat_f32x4_s.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<f32x4, i32x4, Operators::SaturatingTruncate<i32>>>(configuration);
+    case Instructions::i32x4_trunc_sat_f32x4_u.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<f32x4, u32x4, Operators::SaturatingTruncate<u32>>>(configuration);
+    case Instructions::f32x4_convert_i32x4_s.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<i32x4, f32x4, Operators::LaneCast<float>>>(configuration);
+    case Instructions::f32x4_convert_i32x4_u.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<u32x4, f32x4, Operators::LaneCast<float>>>(configuration);
+    case Instructions::i32x4_trunc_sat_f64x2_s_zero.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<f64x2, i32x4, Operators::SaturatingTruncate<i32>>>(configuration);
+    case Instructions::i32x4_trunc_sat_f64x2_u_zero.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<f64x2, u32x4, Operators::SaturatingTruncate<u32>>>(configuration);
+    case Instructions::f64x2_convert_low_i32x4_s.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<i32x4, f64x2, Operators::LaneCast<double>>>(configuration);
+    case Instructions::f64x2_convert_low_i32x4_u.value():
+        return unary_operation<u128, u128, Operators::VectorConvert<u32x4, f64x2, Operators::LaneCast<double>>>(configuration);
     case Instructions::data_drop.value():
     case Instructions::memory_copy.value():
     case Instructions::memory_fill.value():
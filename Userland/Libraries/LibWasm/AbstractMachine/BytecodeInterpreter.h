@@ -19,6 +19,8 @@ struct BytecodeInterpreter : public Interpreter {
     virtual String trap_reason() const override { return m_trap.value().reason; }
     virtual void clear_trap() override { m_trap.clear(); }
 
+    struct MemoryFaultHandler;
+
     struct CallFrameHandle {
         explicit CallFrameHandle(BytecodeInterpreter& interpreter, Configuration& configuration)
             : m_configuration_handle(configuration)
@@ -34,19 +36,33 @@ struct BytecodeInterpreter : public Interpreter {
 
 protected:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&);
+    // Whether function bodies that were translated to register bytecode may be run as such, instead of one wasm
+    // instruction at a time.
+    virtual bool can_run_compiled_code() const { return true; }
+    void interpret_compiled(Configuration&, CompiledFunction const&);
+    void run_compiled(Configuration&, ModuleInstance const&, CompiledFunction const&, u64* registers);
+    void run_compiled_instructions(Configuration&, ModuleInstance const&, CompiledFunction const&, u64* registers, MemoryFaultHandler&);
+    bool call_from_compiled(Configuration&, FunctionAddress, u64* arguments);
     void branch_to_label(Configuration&, LabelIndex);
     template<typename ReadT, typename PushT>
     void load_and_push(Configuration&, Instruction const&);
     template<typename PopT, typename StoreT>
     void pop_and_store(Configuration&, Instruction const&);
-    void store_to_memory(Configuration&, Instruction const&, ReadonlyBytes data, i32 base);
+    template<typename ReadT, typename Operator>
+    void load_and_push_vector(Configuration&, Instruction const&);
+    template<typename VectorType>
+    void load_lane(Configuration&, Instruction const&);
+    template<typename VectorType>
+    void pop_and_store_lane(Configuration&, Instruction const&);
+    void load_from_memory(Configuration&, Instruction::MemoryArgument const&, Bytes data, i32 base);
+    void store_to_memory(Configuration&, Instruction::MemoryArgument const&, ReadonlyBytes data, i32 base);
     void call_address(Configuration&, FunctionAddress);
 
-    template<typename PopType, typename PushType, typename Operator>
-    void binary_numeric_operation(Configuration&);
+    template<typename PopType, typename PushType, typename Operator, typename RhsPopType = PopType, typename... Args>
+    void binary_numeric_operation(Configuration&, Args&&...);
 
-    template<typename PopType, typename PushType, typename Operator>
-    void unary_operation(Configuration&);
+    template<typename PopType, typename PushType, typename Operator, typename... Args>
+    void unary_operation(Configuration&, Args&&...);
 
     template<typename V, typename T>
     MakeUnsigned<T> checked_unsigned_truncate(V);
@@ -77,6 +93,7 @@ struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
 
 private:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&) override;
+    virtual bool can_run_compiled_code() const override { return false; }
 };
 
 }
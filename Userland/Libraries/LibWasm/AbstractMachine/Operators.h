@@ -9,8 +9,10 @@
 #include <AK/BitCast.h>
 #include <AK/BuiltinWrappers.h>
 #include <AK/Result.h>
+#include <AK/SIMD.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
+#include <AK/UFixedBigInt.h>
 #include <limits.h>
 #include <math.h>
 
@@ -71,6 +73,12 @@ struct Modulo {
 
     static StringView name() { return "%"sv; }
 };
+struct BitAndNot {
+    template<typename Lhs, typename Rhs>
+    auto operator()(Lhs lhs, Rhs rhs) const { return lhs & ~rhs; }
+
+    static StringView name() { return "&~"sv; }
+};
 struct BitShiftLeft {
     template<typename Lhs, typename Rhs>
     auto operator()(Lhs lhs, Rhs rhs) const { return lhs << (rhs % (sizeof(lhs) * 8)); }
@@ -164,6 +172,12 @@ struct CopySign {
 
 // Unary
 
+struct BitNot {
+    template<typename Lhs>
+    auto operator()(Lhs lhs) const { return ~lhs; }
+
+    static StringView name() { return "~"sv; }
+};
 struct EqualsZero {
     template<typename Lhs>
     auto operator()(Lhs lhs) const { return lhs == 0; }
@@ -204,7 +218,7 @@ struct PopCount {
     template<typename Lhs>
     auto operator()(Lhs lhs) const
     {
-        if constexpr (sizeof(Lhs) == 4 || sizeof(Lhs) == 8)
+        if constexpr (sizeof(Lhs) == 1 || sizeof(Lhs) == 4 || sizeof(Lhs) == 8)
             return popcount(MakeUnsigned<Lhs>(lhs));
         else
             VERIFY_NOT_REACHED();
@@ -442,4 +456,382 @@ struct SaturatingTruncate {
     static StringView name() { return "truncate.saturating"sv; }
 };
 
+// Vector operations
+// These work on the bits of a v128 value, which they see as the lanes of the vector type they're given, so the same
+// operation on signed and unsigned lanes only differs in the vector type.
+
+template<typename VectorType>
+using LaneType = RemoveCVReference<decltype(declval<VectorType>()[0])>;
+
+template<typename VectorType>
+static constexpr size_t lane_count = sizeof(VectorType) / sizeof(LaneType<VectorType>);
+
+template<typename T>
+ALWAYS_INLINE static T unwrap_lane_result(T value)
+{
+    return value;
+}
+
+template<typename T>
+ALWAYS_INLINE static T unwrap_lane_result(AK::Result<T, StringView> value)
+{
+    // Lanes are only given to operators that can't fail.
+    return value.release_value();
+}
+
+// Applies an operator the vector types have built in to all of the lanes at once.
+template<typename VectorType, typename Operator>
+struct VectorWise {
+    u128 operator()(u128 lhs, u128 rhs) const
+    {
+        return bit_cast<u128>(Operator {}(bit_cast<VectorType>(lhs), bit_cast<VectorType>(rhs)));
+    }
+    u128 operator()(u128 value) const
+    {
+        return bit_cast<u128>(Operator {}(bit_cast<VectorType>(value)));
+    }
+
+    static StringView name() { return Operator::name(); }
+};
+
+// Applies a scalar operator to each lane in turn.
+template<typename VectorType, typename Operator>
+struct LaneWise {
+    u128 operator()(u128 lhs, u128 rhs) const
+    {
+        auto lhs_vector = bit_cast<VectorType>(lhs);
+        auto rhs_vector = bit_cast<VectorType>(rhs);
+        VectorType result;
+        for (size_t i = 0; i < lane_count<VectorType>; ++i)
+            result[i] = static_cast<LaneType<VectorType>>(unwrap_lane_result(Operator {}(lhs_vector[i], rhs_vector[i])));
+        return bit_cast<u128>(result);
+    }
+    u128 operator()(u128 value) const
+    {
+        auto vector = bit_cast<VectorType>(value);
+        VectorType result;
+        for (size_t i = 0; i < lane_count<VectorType>; ++i)
+            result[i] = static_cast<LaneType<VectorType>>(unwrap_lane_result(Operator {}(vector[i])));
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return Operator::name(); }
+};
+
+template<typename VectorType, typename Operator>
+struct VectorShift {
+    u128 operator()(u128 lhs, i32 rhs) const
+    {
+        auto shift = static_cast<u32>(rhs) % (sizeof(LaneType<VectorType>) * 8);
+        return bit_cast<u128>(Operator {}(bit_cast<VectorType>(lhs), static_cast<LaneType<VectorType>>(shift)));
+    }
+
+    static StringView name() { return Operator::name(); }
+};
+
+struct WrappingAbsolute {
+    template<typename Lhs>
+    Lhs operator()(Lhs lhs) const
+    {
+        if (lhs >= 0)
+            return lhs;
+        return static_cast<Lhs>(-static_cast<MakeUnsigned<Lhs>>(lhs));
+    }
+
+    static StringView name() { return "abs"sv; }
+};
+struct SaturatingAdd {
+    template<typename Lhs>
+    Lhs operator()(Lhs lhs, Lhs rhs) const
+    {
+        static_assert(sizeof(Lhs) <= sizeof(u16));
+        return clamp<i32>(static_cast<i32>(lhs) + static_cast<i32>(rhs), NumericLimits<Lhs>::min(), NumericLimits<Lhs>::max());
+    }
+
+    static StringView name() { return "+.saturating"sv; }
+};
+struct SaturatingSubtract {
+    template<typename Lhs>
+    Lhs operator()(Lhs lhs, Lhs rhs) const
+    {
+        static_assert(sizeof(Lhs) <= sizeof(u16));
+        return clamp<i32>(static_cast<i32>(lhs) - static_cast<i32>(rhs), NumericLimits<Lhs>::min(), NumericLimits<Lhs>::max());
+    }
+
+    static StringView name() { return "-.saturating"sv; }
+};
+struct RoundingAverage {
+    template<typename Lhs>
+    Lhs operator()(Lhs lhs, Lhs rhs) const
+    {
+        static_assert(IsUnsigned<Lhs> && sizeof(Lhs) <= sizeof(u16));
+        return (static_cast<u32>(lhs) + static_cast<u32>(rhs) + 1) / 2;
+    }
+
+    static StringView name() { return "avgr"sv; }
+};
+struct Q15MultiplyRoundSaturating {
+    i16 operator()(i16 lhs, i16 rhs) const
+    {
+        return clamp<i32>((static_cast<i32>(lhs) * static_cast<i32>(rhs) + 0x4000) >> 15, NumericLimits<i16>::min(), NumericLimits<i16>::max());
+    }
+
+    static StringView name() { return "q15mulr"sv; }
+};
+struct PseudoMinimum {
+    template<typename Lhs>
+    Lhs operator()(Lhs lhs, Lhs rhs) const { return rhs < lhs ? rhs : lhs; }
+
+    static StringView name() { return "pmin"sv; }
+};
+struct PseudoMaximum {
+    template<typename Lhs>
+    Lhs operator()(Lhs lhs, Lhs rhs) const { return lhs < rhs ? rhs : lhs; }
+
+    static StringView name() { return "pmax"sv; }
+};
+
+template<typename VectorType>
+struct VectorSplat {
+    template<typename Lhs>
+    u128 operator()(Lhs lhs) const
+    {
+        VectorType result;
+        for (size_t i = 0; i < lane_count<VectorType>; ++i)
+            result[i] = static_cast<LaneType<VectorType>>(lhs);
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return "splat"sv; }
+};
+
+template<typename VectorType, typename ResultT>
+struct VectorExtractLane {
+    size_t lane;
+
+    ResultT operator()(u128 lhs) const { return static_cast<ResultT>(bit_cast<VectorType>(lhs)[lane]); }
+
+    static StringView name() { return "extract_lane"sv; }
+};
+
+template<typename VectorType>
+struct VectorReplaceLane {
+    size_t lane;
+
+    template<typename Rhs>
+    u128 operator()(u128 lhs, Rhs rhs) const
+    {
+        auto vector = bit_cast<VectorType>(lhs);
+        vector[lane] = static_cast<LaneType<VectorType>>(rhs);
+        return bit_cast<u128>(vector);
+    }
+
+    static StringView name() { return "replace_lane"sv; }
+};
+
+struct VectorAnyTrue {
+    i32 operator()(u128 lhs) const { return (lhs.low() | lhs.high()) != 0; }
+
+    static StringView name() { return "any_true"sv; }
+};
+
+template<typename VectorType>
+struct VectorAllTrue {
+    i32 operator()(u128 lhs) const
+    {
+        auto vector = bit_cast<VectorType>(lhs);
+        for (size_t i = 0; i < lane_count<VectorType>; ++i) {
+            if (vector[i] == 0)
+                return 0;
+        }
+        return 1;
+    }
+
+    static StringView name() { return "all_true"sv; }
+};
+
+template<typename VectorType>
+struct VectorBitmask {
+    i32 operator()(u128 lhs) const
+    {
+        static_assert(IsSigned<LaneType<VectorType>>);
+        auto vector = bit_cast<VectorType>(lhs);
+        u32 result = 0;
+        for (size_t i = 0; i < lane_count<VectorType>; ++i)
+            result |= static_cast<u32>(vector[i] < 0) << i;
+        return static_cast<i32>(result);
+    }
+
+    static StringView name() { return "bitmask"sv; }
+};
+
+// Converts the lanes of the lower half of the source vector, or all of them if there are as many as in the result.
+// If there are fewer lanes to convert than the result has, the rest of them are zero.
+template<typename SourceVectorType, typename ResultVectorType, typename Operator>
+struct VectorConvert {
+    u128 operator()(u128 lhs) const
+    {
+        auto vector = bit_cast<SourceVectorType>(lhs);
+        ResultVectorType result {};
+        for (size_t i = 0; i < min(lane_count<SourceVectorType>, lane_count<ResultVectorType>); ++i)
+            result[i] = unwrap_lane_result(Operator {}(vector[i]));
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return Operator::name(); }
+};
+
+template<typename ResultT>
+struct LaneCast {
+    template<typename Lhs>
+    ResultT operator()(Lhs lhs) const { return static_cast<ResultT>(lhs); }
+
+    static StringView name() { return "convert"sv; }
+};
+
+enum class VectorHalf {
+    Low,
+    High,
+};
+
+template<typename SourceVectorType, typename ResultVectorType, VectorHalf half>
+struct VectorExtend {
+    u128 operator()(u128 lhs) const
+    {
+        auto vector = bit_cast<SourceVectorType>(lhs);
+        constexpr size_t offset = half == VectorHalf::Low ? 0 : lane_count<ResultVectorType>;
+        ResultVectorType result;
+        for (size_t i = 0; i < lane_count<ResultVectorType>; ++i)
+            result[i] = vector[i + offset];
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return "extend"sv; }
+};
+
+template<typename SourceVectorType, typename ResultVectorType, VectorHalf half>
+struct VectorExtendMultiply {
+    u128 operator()(u128 lhs, u128 rhs) const
+    {
+        auto lhs_vector = bit_cast<SourceVectorType>(lhs);
+        auto rhs_vector = bit_cast<SourceVectorType>(rhs);
+        constexpr size_t offset = half == VectorHalf::Low ? 0 : lane_count<ResultVectorType>;
+        using ResultLane = LaneType<ResultVectorType>;
+        ResultVectorType result;
+        for (size_t i = 0; i < lane_count<ResultVectorType>; ++i)
+            result[i] = static_cast<ResultLane>(static_cast<ResultLane>(lhs_vector[i + offset]) * static_cast<ResultLane>(rhs_vector[i + offset]));
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return "extmul"sv; }
+};
+
+template<typename SourceVectorType, typename ResultVectorType>
+struct VectorExtendAddPairwise {
+    u128 operator()(u128 lhs) const
+    {
+        auto vector = bit_cast<SourceVectorType>(lhs);
+        using ResultLane = LaneType<ResultVectorType>;
+        ResultVectorType result;
+        for (size_t i = 0; i < lane_count<ResultVectorType>; ++i)
+            result[i] = static_cast<ResultLane>(vector[2 * i]) + static_cast<ResultLane>(vector[2 * i + 1]);
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return "extadd_pairwise"sv; }
+};
+
+struct VectorDot {
+    u128 operator()(u128 lhs, u128 rhs) const
+    {
+        auto lhs_vector = bit_cast<AK::SIMD::i16x8>(lhs);
+        auto rhs_vector = bit_cast<AK::SIMD::i16x8>(rhs);
+        AK::SIMD::i32x4 result;
+        for (size_t i = 0; i < 4; ++i) {
+            auto sum = static_cast<i64>(lhs_vector[2 * i]) * rhs_vector[2 * i] + static_cast<i64>(lhs_vector[2 * i + 1]) * rhs_vector[2 * i + 1];
+            result[i] = static_cast<i32>(sum);
+        }
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return "dot"sv; }
+};
+
+// Both operands are read as signed lanes, and saturated to the range of the narrower (signed or unsigned) result lanes.
+template<typename SourceVectorType, typename ResultVectorType>
+struct VectorNarrow {
+    u128 operator()(u128 lhs, u128 rhs) const
+    {
+        auto lhs_vector = bit_cast<SourceVectorType>(lhs);
+        auto rhs_vector = bit_cast<SourceVectorType>(rhs);
+        using ResultLane = LaneType<ResultVectorType>;
+        constexpr auto half = lane_count<SourceVectorType>;
+        ResultVectorType result;
+        for (size_t i = 0; i < half; ++i) {
+            result[i] = static_cast<ResultLane>(clamp<i64>(lhs_vector[i], NumericLimits<ResultLane>::min(), NumericLimits<ResultLane>::max()));
+            result[i + half] = static_cast<ResultLane>(clamp<i64>(rhs_vector[i], NumericLimits<ResultLane>::min(), NumericLimits<ResultLane>::max()));
+        }
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return "narrow"sv; }
+};
+
+struct VectorSwizzle {
+    u128 operator()(u128 lhs, u128 rhs) const
+    {
+        auto vector = bit_cast<AK::SIMD::u8x16>(lhs);
+        auto indices = bit_cast<AK::SIMD::u8x16>(rhs);
+        AK::SIMD::u8x16 result;
+        for (size_t i = 0; i < 16; ++i)
+            result[i] = indices[i] < 16 ? vector[indices[i]] : 0;
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return "swizzle"sv; }
+};
+
+struct VectorShuffle {
+    u8 const* lanes;
+
+    u128 operator()(u128 lhs, u128 rhs) const
+    {
+        auto lhs_vector = bit_cast<AK::SIMD::u8x16>(lhs);
+        auto rhs_vector = bit_cast<AK::SIMD::u8x16>(rhs);
+        AK::SIMD::u8x16 result;
+        for (size_t i = 0; i < 16; ++i)
+            result[i] = lanes[i] < 16 ? lhs_vector[lanes[i]] : rhs_vector[lanes[i] - 16];
+        return bit_cast<u128>(result);
+    }
+
+    static StringView name() { return "shuffle"sv; }
+};
+
+// Puts a value read from memory into the lowest bits of a vector, so a whole vector is left as is.
+struct VectorZeroExtend {
+    template<typename Lhs>
+    u128 operator()(Lhs lhs) const
+    {
+        if constexpr (IsSame<Lhs, u128>)
+            return lhs;
+        else
+            return u128 { static_cast<u64>(lhs) };
+    }
+
+    static StringView name() { return "zero_extend"sv; }
+};
+
+// Extends each half-width lane read from memory to a full-width one.
+template<typename ResultVectorType>
+struct VectorWiden {
+    template<typename Lhs>
+    u128 operator()(Lhs lhs) const
+    {
+        static_assert(sizeof(Lhs) == sizeof(u64));
+        return bit_cast<u128>(__builtin_convertvector(lhs, ResultVectorType));
+    }
+
+    static StringView name() { return "widen"sv; }
+};
+
 }
@@ -0,0 +1,662 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AllOf.h>
+#include <AK/HashMap.h>
+#include <LibWasm/AbstractMachine/RegisterBytecode.h>
+#include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWasm/Opcode.h>
+#include <LibWasm/Types.h>
+
+namespace Wasm {
+
+// References and vectors don't fit in a register, so anything that touches them is left to the stack interpreter.
+static bool fits_in_register(ValueType const& type)
+{
+    return !type.is_reference() && type.kind() != ValueType::V128;
+}
+
+static bool fits_in_registers(Vector<ValueType> const& types)
+{
+    return all_of(types, [](auto& type) { return fits_in_register(type); });
+}
+
+static bool fits_in_registers(FunctionType const& type)
+{
+    return fits_in_registers(type.parameters()) && fits_in_registers(type.results());
+}
+
+static u32 offset_of(Instruction const& instruction)
+{
+    return instruction.arguments().get<Instruction::MemoryArgument>().offset;
+}
+
+class RegisterCompiler {
+public:
+    RegisterCompiler(Context const& context, FunctionType const& type, size_t local_count)
+        : m_context(context)
+        , m_local_count(local_count)
+    {
+        m_control.append({ FrameKind::Function, 0, 0, type.results().size() });
+    }
+
+    bool compile(Expression const&);
+    NonnullRefPtr<CompiledFunction> take();
+
+private:
+    enum class FrameKind {
+        Function,
+        Block,
+        Loop,
+        If,
+    };
+
+    // A branch to the end of a block, which isn't known yet when the branch is emitted.
+    struct Fixup {
+        size_t instruction_or_table;
+        Optional<size_t> table_entry;
+    };
+
+    struct ControlFrame {
+        FrameKind kind;
+        // The height of the stack below the parameters of the block.
+        size_t base;
+        size_t parameter_count;
+        size_t result_count;
+        size_t loop_start { 0 };
+        Vector<Fixup> fixups {};
+        // Where an if goes if its condition is false, once there's an else or end to go to.
+        Optional<size_t> else_jump {};
+        bool is_unreachable { false };
+
+        size_t branch_arity() const { return kind == FrameKind::Loop ? parameter_count : result_count; }
+    };
+
+    bool compile(Instruction const&);
+    bool block_arity(BlockType const&, size_t& parameter_count, size_t& result_count) const;
+
+    u32 slot(size_t height) const { return m_local_count + height; }
+    u32 operand(size_t height) const { return m_stack[height].value_or(slot(height)); }
+    size_t height() const { return m_stack.size(); }
+    bool has_operands(size_t count) const { return m_stack.size() >= count; }
+    u32 push();
+    void push_local(u32 local);
+    u32 pop();
+    bool set_local(u32 local);
+
+    void materialize(size_t height);
+    void materialize_from(size_t height);
+    void materialize_local(u32 local);
+
+    void emit(RegisterOpcode opcode, u32 destination = 0, u32 lhs = 0, u32 rhs = 0, u64 immediate = 0);
+    void emit_result(RegisterOpcode opcode, u32 destination, u32 lhs = 0, u32 rhs = 0, u64 immediate = 0);
+    size_t mark_target();
+    void patch(Fixup const&, size_t target);
+
+    ControlFrame* label(LabelIndex);
+    void mark_unreachable() { m_control.last().is_unreachable = true; }
+    void emit_return();
+    void emit_jump(ControlFrame&, RegisterOpcode, u32 condition = 0);
+    bool needs_moves_for_branch(ControlFrame const&) const;
+    void emit_moves_for_branch(ControlFrame const&);
+
+    Context const& m_context;
+    size_t m_local_count { 0 };
+
+    Vector<RegisterInstruction> m_instructions;
+    Vector<Vector<u32>> m_branch_tables;
+
+    // The operand stack at the current instruction. A value that was pushed by local.get and hasn't been copied into
+    // its own register yet is still read out of the register of the local.
+    Vector<Optional<u32>> m_stack;
+    size_t m_max_height { 0 };
+
+    Vector<ControlFrame> m_control;
+    // How many blocks deep into unreachable code we are, past the one that became unreachable.
+    size_t m_unreachable_depth { 0 };
+
+    // The last instruction, if it stored its result into the register of the top of the stack, so a local.set right
+    // after it can store into the local instead.
+    Optional<size_t> m_retargetable_instruction;
+};
+
+u32 RegisterCompiler::push()
+{
+    m_stack.append({});
+    m_max_height = max(m_max_height, m_stack.size());
+    return slot(m_stack.size() - 1);
+}
+
+void RegisterCompiler::push_local(u32 local)
+{
+    m_stack.append(local);
+    m_max_height = max(m_max_height, m_stack.size());
+}
+
+u32 RegisterCompiler::pop()
+{
+    auto reg = operand(m_stack.size() - 1);
+    m_stack.remove(m_stack.size() - 1);
+    return reg;
+}
+
+void RegisterCompiler::materialize(size_t height)
+{
+    if (auto local = m_stack[height]; local.has_value()) {
+        emit(RegisterOpcode::move, slot(height), *local);
+        m_stack[height] = {};
+    }
+}
+
+void RegisterCompiler::materialize_from(size_t height)
+{
+    for (; height < m_stack.size(); ++height)
+        materialize(height);
+}
+
+void RegisterCompiler::materialize_local(u32 local)
+{
+    for (size_t height = 0; height < m_stack.size(); ++height) {
+        if (m_stack[height] == local)
+            materialize(height);
+    }
+}
+
+bool RegisterCompiler::set_local(u32 local)
+{
+    if (local >= m_local_count || !has_operands(1))
+        return false;
+    auto value_height = height() - 1;
+    auto value = pop();
+    if (value == local)
+        return true;
+
+    // Whatever still reads the old value of the local has to get a copy of it first.
+    materialize_local(local);
+
+    if (m_retargetable_instruction.has_value() && value == slot(value_height)) {
+        auto& instruction = m_instructions[*m_retargetable_instruction];
+        if (instruction.destination == value) {
+            instruction.destination = local;
+            m_retargetable_instruction.clear();
+            return true;
+        }
+    }
+    emit(RegisterOpcode::move, local, value);
+    return true;
+}
+
+void RegisterCompiler::emit(RegisterOpcode opcode, u32 destination, u32 lhs, u32 rhs, u64 immediate)
+{
+    m_instructions.append({ opcode, destination, lhs, rhs, immediate });
+    m_retargetable_instruction.clear();
+}
+
+void RegisterCompiler::emit_result(RegisterOpcode opcode, u32 destination, u32 lhs, u32 rhs, u64 immediate)
+{
+    emit(opcode, destination, lhs, rhs, immediate);
+    m_retargetable_instruction = m_instructions.size() - 1;
+}
+
+size_t RegisterCompiler::mark_target()
+{
+    m_retargetable_instruction.clear();
+    return m_instructions.size();
+}
+
+void RegisterCompiler::patch(Fixup const& fixup, size_t target)
+{
+    if (fixup.table_entry.has_value())
+        m_branch_tables[fixup.instruction_or_table][*fixup.table_entry] = target;
+    else
+        m_instructions[fixup.instruction_or_table].immediate = target;
+}
+
+RegisterCompiler::ControlFrame* RegisterCompiler::label(LabelIndex index)
+{
+    if (index.value() >= m_control.size())
+        return nullptr;
+    return &m_control[m_control.size() - index.value() - 1];
+}
+
+void RegisterCompiler::emit_return()
+{
+    auto result_count = m_control.first().result_count;
+    materialize_from(height() - result_count);
+    emit(RegisterOpcode::return_, 0, slot(height() - result_count));
+}
+
+void RegisterCompiler::emit_jump(ControlFrame& target, RegisterOpcode opcode, u32 condition)
+{
+    if (target.kind == FrameKind::Loop) {
+        emit(opcode, 0, condition, 0, target.loop_start);
+        return;
+    }
+    target.fixups.append({ m_instructions.size(), {} });
+    emit(opcode, 0, condition);
+}
+
+bool RegisterCompiler::needs_moves_for_branch(ControlFrame const& target) const
+{
+    auto arity = target.branch_arity();
+    for (size_t i = 0; i < arity; ++i) {
+        if (operand(height() - arity + i) != slot(target.base + i))
+            return true;
+    }
+    return false;
+}
+
+void RegisterCompiler::emit_moves_for_branch(ControlFrame const& target)
+{
+    // The label expects the values at the bottom of its block, which is never above where they are now, so moving
+    // them in order doesn't overwrite any that haven't been moved yet.
+    auto arity = target.branch_arity();
+    for (size_t i = 0; i < arity; ++i) {
+        auto source = operand(height() - arity + i);
+        auto destination = slot(target.base + i);
+        if (source != destination)
+            emit(RegisterOpcode::move, destination, source);
+    }
+}
+
+bool RegisterCompiler::block_arity(BlockType const& type, size_t& parameter_count, size_t& result_count) const
+{
+    switch (type.kind()) {
+    case BlockType::Empty:
+        parameter_count = 0;
+        result_count = 0;
+        return true;
+    case BlockType::Type:
+        parameter_count = 0;
+        result_count = 1;
+        return fits_in_register(type.value_type());
+    case BlockType::Index: {
+        if (type.type_index().value() >= m_context.types.size())
+            return false;
+        auto& function_type = m_context.types[type.type_index().value()];
+        parameter_count = function_type.parameters().size();
+        result_count = function_type.results().size();
+        return fits_in_registers(function_type);
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+bool RegisterCompiler::compile(Expression const& expression)
+{
+    for (auto& instruction : expression.instructions()) {
+        if (m_control.last().is_unreachable) {
+            // Nothing can get here, so skip ahead to the end of the block, or to the else of an if.
+            auto opcode = instruction.opcode();
+            if (opcode == Instructions::block || opcode == Instructions::loop || opcode == Instructions::if_) {
+                ++m_unreachable_depth;
+                continue;
+            }
+            if (opcode == Instructions::structured_end && m_unreachable_depth > 0) {
+                --m_unreachable_depth;
+                continue;
+            }
+            if (m_unreachable_depth > 0 || (opcode != Instructions::structured_end && opcode != Instructions::structured_else))
+                continue;
+        }
+        if (!compile(instruction))
+            return false;
+    }
+
+    if (m_control.size() != 1)
+        return false;
+    if (!m_control.last().is_unreachable) {
+        if (!has_operands(m_control.last().result_count))
+            return false;
+        emit_return();
+    }
+    return true;
+}
+
+bool RegisterCompiler::compile(Instruction const& instruction)
+{
+    switch (instruction.opcode().value()) {
+    case Instructions::unreachable.value():
+        emit(RegisterOpcode::unreachable);
+        mark_unreachable();
+        return true;
+    case Instructions::nop.value():
+        return true;
+    case Instructions::block.value():
+    case Instructions::loop.value():
+    case Instructions::if_.value(): {
+        auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
+        size_t parameter_count;
+        size_t result_count;
+        if (!block_arity(args.block_type, parameter_count, result_count))
+            return false;
+
+        auto kind = FrameKind::Block;
+        u32 condition = 0;
+        if (instruction.opcode() == Instructions::loop) {
+            kind = FrameKind::Loop;
+        } else if (instruction.opcode() == Instructions::if_) {
+            kind = FrameKind::If;
+            // FIXME: The then branch overwrites the parameters an else branch would need.
+            if (parameter_count > 0 && args.else_ip.has_value())
+                return false;
+            if (!has_operands(1))
+                return false;
+            condition = pop();
+        }
+        if (!has_operands(parameter_count))
+            return false;
+
+        // Values inside a block can come from more than one place, so they're never left in a local across its edges.
+        materialize_from(0);
+        ControlFrame frame { kind, height() - parameter_count, parameter_count, result_count };
+        if (kind == FrameKind::Loop)
+            frame.loop_start = mark_target();
+        if (kind == FrameKind::If) {
+            frame.else_jump = m_instructions.size();
+            emit(RegisterOpcode::jump_if_zero, 0, condition);
+        }
+        m_control.append(move(frame));
+        return true;
+    }
+    case Instructions::structured_else.value(): {
+        auto& frame = m_control.last();
+        if (frame.kind != FrameKind::If || !frame.else_jump.has_value())
+            return false;
+        if (!frame.is_unreachable) {
+            materialize_from(frame.base);
+            emit_jump(frame, RegisterOpcode::jump);
+        }
+        patch({ frame.else_jump.release_value(), {} }, mark_target());
+        m_stack.resize(frame.base);
+        for (size_t i = 0; i < frame.parameter_count; ++i)
+            push();
+        frame.is_unreachable = false;
+        return true;
+    }
+    case Instructions::structured_end.value(): {
+        if (m_control.size() == 1)
+            return false;
+        auto frame = m_control.take_last();
+        if (!frame.is_unreachable)
+            materialize_from(frame.base);
+        auto target = mark_target();
+        for (auto& fixup : frame.fixups)
+            patch(fixup, target);
+        if (frame.else_jump.has_value())
+            patch({ *frame.else_jump, {} }, target);
+        m_stack.resize(frame.base);
+        for (size_t i = 0; i < frame.result_count; ++i)
+            push();
+        return true;
+    }
+    case Instructions::return_.value():
+        if (!has_operands(m_control.first().result_count))
+            return false;
+        emit_return();
+        mark_unreachable();
+        return true;
+    case Instructions::br.value(): {
+        auto* target = label(instruction.arguments().get<LabelIndex>());
+        if (!target || !has_operands(target->branch_arity()))
+            return false;
+        if (target->kind == FrameKind::Function) {
+            emit_return();
+        } else {
+            emit_moves_for_branch(*target);
+            emit_jump(*target, RegisterOpcode::jump);
+        }
+        mark_unreachable();
+        return true;
+    }
+    case Instructions::br_if.value(): {
+        auto* target = label(instruction.arguments().get<LabelIndex>());
+        if (!target || !has_operands(target->branch_arity() + 1))
+            return false;
+        auto condition = pop();
+        // The values are copied out of any locals on both paths, so what's on the stack is the same on either.
+        materialize_from(height() - target->branch_arity());
+        if (target->kind != FrameKind::Function && !needs_moves_for_branch(*target)) {
+            emit_jump(*target, RegisterOpcode::jump_if_not_zero, condition);
+            return true;
+        }
+        auto skip = m_instructions.size();
+        emit(RegisterOpcode::jump_if_zero, 0, condition);
+        if (target->kind == FrameKind::Function) {
+            emit_return();
+        } else {
+            emit_moves_for_branch(*target);
+            emit_jump(*target, RegisterOpcode::jump);
+        }
+        patch({ skip, {} }, mark_target());
+        return true;
+    }
+    case Instructions::br_table.value(): {
+        auto& args = instruction.arguments().get<Instruction::TableBranchArgs>();
+        auto* default_target = label(args.default_);
+        if (!default_target || !has_operands(default_target->branch_arity() + 1))
+            return false;
+        auto index = pop();
+        materialize_from(height() - default_target->branch_arity());
+
+        auto table_index = m_branch_tables.size();
+        m_branch_tables.append({});
+        m_branch_tables.last().resize(args.labels.size() + 1);
+        emit(RegisterOpcode::jump_table, 0, index, 0, table_index);
+
+        // Branches that have to move their values first go through a stub that does it, one per label.
+        HashMap<u32, u32> stubs;
+        for (size_t entry = 0; entry <= args.labels.size(); ++entry) {
+            auto label_index = entry < args.labels.size() ? args.labels[entry] : args.default_;
+            auto* target = label(label_index);
+            if (!target || target->branch_arity() != default_target->branch_arity())
+                return false;
+            if (auto stub = stubs.get(label_index.value()); stub.has_value()) {
+                m_branch_tables[table_index][entry] = *stub;
+                continue;
+            }
+            if (target->kind == FrameKind::Loop && !needs_moves_for_branch(*target)) {
+                m_branch_tables[table_index][entry] = target->loop_start;
+                continue;
+            }
+            if (target->kind == FrameKind::Block || target->kind == FrameKind::If) {
+                if (!needs_moves_for_branch(*target)) {
+                    target->fixups.append({ table_index, entry });
+                    continue;
+                }
+            }
+            auto stub = mark_target();
+            stubs.set(label_index.value(), stub);
+            m_branch_tables[table_index][entry] = stub;
+            if (target->kind == FrameKind::Function) {
+                emit_return();
+            } else {
+                emit_moves_for_branch(*target);
+                emit_jump(*target, RegisterOpcode::jump);
+            }
+        }
+        mark_unreachable();
+        return true;
+    }
+    case Instructions::call.value(): {
+        auto index = instruction.arguments().get<FunctionIndex>();
+        if (index.value() >= m_context.functions.size())
+            return false;
+        auto& type = m_context.functions[index.value()];
+        if (!fits_in_registers(type) || !has_operands(type.parameters().size()))
+            return false;
+        auto arguments_height = height() - type.parameters().size();
+        materialize_from(arguments_height);
+        m_stack.resize(arguments_height);
+        for (size_t i = 0; i < type.results().size(); ++i)
+            push();
+        emit(RegisterOpcode::call, 0, slot(arguments_height), 0, index.value());
+        return true;
+    }
+    case Instructions::call_indirect.value(): {
+        auto& args = instruction.arguments().get<Instruction::IndirectCallArgs>();
+        if (args.type.value() >= m_context.types.size())
+            return false;
+        auto& type = m_context.types[args.type.value()];
+        if (!fits_in_registers(type) || !has_operands(type.parameters().size() + 1))
+            return false;
+        auto element = pop();
+        auto arguments_height = height() - type.parameters().size();
+        materialize_from(arguments_height);
+        m_stack.resize(arguments_height);
+        for (size_t i = 0; i < type.results().size(); ++i)
+            push();
+        emit(RegisterOpcode::call_indirect, args.table.value(), slot(arguments_height), element, args.type.value());
+        return true;
+    }
+    case Instructions::drop.value():
+        if (!has_operands(1))
+            return false;
+        pop();
+        return true;
+    case Instructions::select_typed.value():
+        if (!fits_in_registers(instruction.arguments().get<Vector<ValueType>>()))
+            return false;
+        [[fallthrough]];
+    case Instructions::select.value(): {
+        if (!has_operands(3))
+            return false;
+        auto condition = pop();
+        auto rhs = pop();
+        auto lhs = pop();
+        emit_result(RegisterOpcode::select, push(), lhs, rhs, condition);
+        return true;
+    }
+    case Instructions::local_get.value(): {
+        auto local = instruction.arguments().get<LocalIndex>().value();
+        if (local >= m_local_count)
+            return false;
+        push_local(local);
+        return true;
+    }
+    case Instructions::local_set.value():
+        return set_local(instruction.arguments().get<LocalIndex>().value());
+    case Instructions::local_tee.value(): {
+        auto local = instruction.arguments().get<LocalIndex>().value();
+        if (!set_local(local))
+            return false;
+        push_local(local);
+        return true;
+    }
+    case Instructions::global_get.value(): {
+        auto index = instruction.arguments().get<GlobalIndex>().value();
+        if (index >= m_context.globals.size() || !fits_in_register(m_context.globals[index].type()))
+            return false;
+        emit_result(RegisterOpcode::global_get, push(), 0, 0, index);
+        return true;
+    }
+    case Instructions::global_set.value(): {
+        auto index = instruction.arguments().get<GlobalIndex>().value();
+        if (index >= m_context.globals.size() || !fits_in_register(m_context.globals[index].type()) || !has_operands(1))
+            return false;
+        auto value = pop();
+        emit(RegisterOpcode::global_set, 0, value, m_context.globals[index].type().kind(), index);
+        return true;
+    }
+    case Instructions::memory_size.value():
+        emit_result(RegisterOpcode::memory_size, push());
+        return true;
+    case Instructions::memory_grow.value(): {
+        if (!has_operands(1))
+            return false;
+        auto pages = pop();
+        emit_result(RegisterOpcode::memory_grow, push(), pages);
+        return true;
+    }
+    case Instructions::i32_const.value():
+        emit_result(RegisterOpcode::constant, push(), 0, 0, bit_cast<u32>(instruction.arguments().get<i32>()));
+        return true;
+    case Instructions::i64_const.value():
+        emit_result(RegisterOpcode::constant, push(), 0, 0, bit_cast<u64>(instruction.arguments().get<i64>()));
+        return true;
+    case Instructions::f32_const.value():
+        emit_result(RegisterOpcode::constant, push(), 0, 0, bit_cast<u32>(instruction.arguments().get<float>()));
+        return true;
+    case Instructions::f64_const.value():
+        emit_result(RegisterOpcode::constant, push(), 0, 0, bit_cast<u64>(instruction.arguments().get<double>()));
+        return true;
+
+#define M(name, ...)                                                                \
+    case Instructions::name.value(): {                                              \
+        if (!has_operands(1))                                                       \
+            return false;                                                           \
+        auto address = pop();                                                       \
+        emit_result(RegisterOpcode::name, push(), address, 0, offset_of(instruction)); \
+        return true;                                                                \
+    }
+        ENUMERATE_REGISTER_LOAD_OPERATIONS(M)
+#undef M
+
+#define M(name, ...)                                                          \
+    case Instructions::name.value(): {                                        \
+        if (!has_operands(2))                                                 \
+            return false;                                                     \
+        auto value = pop();                                                   \
+        auto address = pop();                                                 \
+        emit(RegisterOpcode::name, 0, address, value, offset_of(instruction)); \
+        return true;                                                          \
+    }
+        ENUMERATE_REGISTER_STORE_OPERATIONS(M)
+#undef M
+
+#define M(name, ...)                                         \
+    case Instructions::name.value(): {                       \
+        if (!has_operands(2))                                \
+            return false;                                    \
+        auto rhs = pop();                                    \
+        auto lhs = pop();                                    \
+        emit_result(RegisterOpcode::name, push(), lhs, rhs); \
+        return true;                                         \
+    }
+        ENUMERATE_REGISTER_BINARY_OPERATIONS(M)
+#undef M
+
+#define M(name, ...)                                      \
+    case Instructions::name.value(): {                    \
+        if (!has_operands(1))                             \
+            return false;                                 \
+        auto value = pop();                               \
+        emit_result(RegisterOpcode::name, push(), value); \
+        return true;                                      \
+    }
+        ENUMERATE_REGISTER_UNARY_OPERATIONS(M)
+#undef M
+
+    default:
+        // Reference types, tables, bulk memory and vector instructions are left to the stack-based interpreter.
+        return false;
+    }
+}
+
+NonnullRefPtr<CompiledFunction> RegisterCompiler::take()
+{
+    auto function = adopt_ref(*new CompiledFunction);
+    function->m_instructions = move(m_instructions);
+    function->m_branch_tables = move(m_branch_tables);
+    function->m_local_count = m_local_count;
+    function->m_register_count = m_local_count + m_max_height;
+    return function;
+}
+
+RefPtr<CompiledFunction> CompiledFunction::try_compile(Context const& context, FunctionType const& type, Vector<ValueType> const& locals, Expression const& body)
+{
+    if (!fits_in_registers(type) || !fits_in_registers(locals))
+        return nullptr;
+
+    RegisterCompiler compiler { context, type, type.parameters().size() + locals.size() };
+    if (!compiler.compile(body))
+        return nullptr;
+    auto function = compiler.take();
+    function->m_result_types = type.results();
+    return function;
+}
+
+}
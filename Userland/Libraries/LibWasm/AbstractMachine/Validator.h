@@ -219,6 +219,14 @@ public:
             return result;
         }
 
+        template<auto... kinds>
+        ErrorOr<void, ValidationError> take_and_put(Wasm::ValueType::Kind kind, SourceLocation location = SourceLocation::current())
+        {
+            TRY(take<kinds...>(location));
+            append(Wasm::ValueType(kind));
+            return {};
+        }
+
         size_t actual_size() const { return Vector<StackEntry>::size(); }
         size_t size() const { return m_did_insert_unknown_entry ? static_cast<size_t>(-1) : actual_size(); }
 
@@ -15,6 +15,7 @@ static constexpr auto i32_tag = 0x7f;
 static constexpr auto i64_tag = 0x7e;
 static constexpr auto f32_tag = 0x7d;
 static constexpr auto f64_tag = 0x7c;
+static constexpr auto v128_tag = 0x7b;
 static constexpr auto function_reference_tag = 0x70;
 static constexpr auto extern_reference_tag = 0x6f;
 
@@ -42,5 +43,9 @@ static constexpr auto minimum_stack_space_to_keep_free = 256 * KiB; // Note: Val
 static constexpr auto max_allowed_executed_instructions_per_call = 256 * 1024 * 1024;
 static constexpr auto max_allowed_vector_size = 500 * MiB;
 static constexpr auto max_allowed_function_locals_per_type = 42069; // Note: VERY arbitrary.
+// A u32 address plus a u32 offset reaches up to 8 GiB, and the widest access can start at the very end of that.
+static constexpr auto guarded_memory_reservation_size = 8 * GiB + page_size;
+// Where reserving all of that is too expensive, the reservation only covers what a memory can grow to, if it's at most this.
+static constexpr auto max_capped_guarded_memory_reservation_size = 1 * GiB;
 
 }
@@ -9,7 +9,12 @@
 namespace Wasm {
 
 class AbstractMachine;
+class CompiledFunction;
+struct Context;
+class Expression;
+class FunctionType;
 class Validator;
 struct ValidationError;
+class ValueType;
 
 }
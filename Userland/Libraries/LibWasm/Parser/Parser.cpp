@@ -131,6 +131,8 @@ ParseResult<ValueType> ValueType::parse(InputStream& stream)
         return ValueType(F32);
     case Constants::f64_tag:
         return ValueType(F64);
+    case Constants::v128_tag:
+        return ValueType(V128);
     case Constants::function_reference_tag:
         return ValueType(FunctionReference);
     case Constants::extern_reference_tag:
@@ -726,6 +728,302 @@ ParseResult<Vector<Instruction>> Instruction::parse(InputStream& stream, Instruc
             return ParseError::UnknownInstruction;
         }
     }
+    case 0xfd: {
+        // These are vector instructions.
+        u32 selector;
+        if (!LEB128::read_unsigned(stream, selector))
+            return with_eof_check(stream, ParseError::InvalidInput);
+        if (selector > 0xff)
+            return ParseError::UnknownInstruction;
+        OpCode vector_opcode { 0xfd00 | selector };
+        switch (vector_opcode.value()) {
+        case Instructions::v128_load.value():
+        case Instructions::v128_load8x8_s.value():
+        case Instructions::v128_load8x8_u.value():
+        case Instructions::v128_load16x4_s.value():
+        case Instructions::v128_load16x4_u.value():
+        case Instructions::v128_load32x2_s.value():
+        case Instructions::v128_load32x2_u.value():
+        case Instructions::v128_load8_splat.value():
+        case Instructions::v128_load16_splat.value():
+        case Instructions::v128_load32_splat.value():
+        case Instructions::v128_load64_splat.value():
+        case Instructions::v128_store.value():
+        case Instructions::v128_load32_zero.value():
+        case Instructions::v128_load64_zero.value(): {
+            // op (align offset)
+            size_t align, offset;
+            if (!LEB128::read_unsigned(stream, align))
+                return with_eof_check(stream, ParseError::InvalidInput);
+            if (!LEB128::read_unsigned(stream, offset))
+                return with_eof_check(stream, ParseError::InvalidInput);
+
+            return Vector { Instruction { vector_opcode, MemoryArgument { static_cast<u32>(align), static_cast<u32>(offset) } } };
+        }
+        case Instructions::v128_load8_lane.value():
+        case Instructions::v128_load16_lane.value():
+        case Instructions::v128_load32_lane.value():
+        case Instructions::v128_load64_lane.value():
+        case Instructions::v128_store8_lane.value():
+        case Instructions::v128_store16_lane.value():
+        case Instructions::v128_store32_lane.value():
+        case Instructions::v128_store64_lane.value(): {
+            // op (align offset) lane
+            size_t align, offset;
+            if (!LEB128::read_unsigned(stream, align))
+                return with_eof_check(stream, ParseError::InvalidInput);
+            if (!LEB128::read_unsigned(stream, offset))
+                return with_eof_check(stream, ParseError::InvalidInput);
+            u8 lane;
+            stream >> lane;
+            if (stream.has_any_error())
+                return with_eof_check(stream, ParseError::InvalidInput);
+
+            return Vector { Instruction { vector_opcode, MemoryAndLaneArgument { { static_cast<u32>(align), static_cast<u32>(offset) }, lane } } };
+        }
+        case Instructions::i8x16_extract_lane_s.value():
+        case Instructions::i8x16_extract_lane_u.value():
+        case Instructions::i8x16_replace_lane.value():
+        case Instructions::i16x8_extract_lane_s.value():
+        case Instructions::i16x8_extract_lane_u.value():
+        case Instructions::i16x8_replace_lane.value():
+        case Instructions::i32x4_extract_lane.value():
+        case Instructions::i32x4_replace_lane.value():
+        case Instructions::i64x2_extract_lane.value():
+        case Instructions::i64x2_replace_lane.value():
+        case Instructions::f32x4_extract_lane.value():
+        case Instructions::f32x4_replace_lane.value():
+        case Instructions::f64x2_extract_lane.value():
+        case Instructions::f64x2_replace_lane.value(): {
+            u8 lane;
+            stream >> lane;
+            if (stream.has_any_error())
+                return with_eof_check(stream, ParseError::InvalidInput);
+
+            return Vector { Instruction { vector_opcode, LaneIndex { lane } } };
+        }
+        case Instructions::v128_const.value(): {
+            // op literal
+            LittleEndian<u64> low, high;
+            stream >> low >> high;
+            if (stream.has_any_error())
+                return with_eof_check(stream, ParseError::InvalidImmediate);
+
+            return Vector { Instruction { vector_opcode, u128 { static_cast<u64>(low), static_cast<u64>(high) } } };
+        }
+        case Instructions::i8x16_shuffle.value(): {
+            // op lane*16
+            ShuffleArgument argument;
+            for (auto& lane : argument.lanes)
+                stream >> lane;
+            if (stream.has_any_error())
+                return with_eof_check(stream, ParseError::InvalidInput);
+
+            return Vector { Instruction { vector_opcode, argument } };
+        }
+        case Instructions::i8x16_swizzle.value():
+        case Instructions::i8x16_splat.value():
+        case Instructions::i16x8_splat.value():
+        case Instructions::i32x4_splat.value():
+        case Instructions::i64x2_splat.value():
+        case Instructions::f32x4_splat.value():
+        case Instructions::f64x2_splat.value():
+        case Instructions::i8x16_eq.value():
+        case Instructions::i8x16_ne.value():
+        case Instructions::i8x16_lt_s.value():
+        case Instructions::i8x16_lt_u.value():
+        case Instructions::i8x16_gt_s.value():
+        case Instructions::i8x16_gt_u.value():
+        case Instructions::i8x16_le_s.value():
+        case Instructions::i8x16_le_u.value():
+        case Instructions::i8x16_ge_s.value():
+        case Instructions::i8x16_ge_u.value():
+        case Instructions::i16x8_eq.value():
+        case Instructions::i16x8_ne.value():
+        case Instructions::i16x8_lt_s.value():
+        case Instructions::i16x8_lt_u.value():
+        case Instructions::i16x8_gt_s.value():
+        case Instructions::i16x8_gt_u.value():
+        case Instructions::i16x8_le_s.value():
+        case Instructions::i16x8_le_u.value():
+        case Instructions::i16x8_ge_s.value():
+        case Instructions::i16x8_ge_u.value():
+        case Instructions::i32x4_eq.value():
+        case Instructions::i32x4_ne.value():
+        case Instructions::i32x4_lt_s.value():
+        case Instructions::i32x4_lt_u.value():
+        case Instructions::i32x4_gt_s.value():
+        case Instructions::i32x4_gt_u.value():
+        case Instructions::i32x4_le_s.value():
+        case Instructions::i32x4_le_u.value():
+        case Instructions::i32x4_ge_s.value():
+        case Instructions::i32x4_ge_u.value():
+        case Instructions::f32x4_eq.value():
+        case Instructions::f32x4_ne.value():
+        case Instructions::f32x4_lt.value():
+        case Instructions::f32x4_gt.value():
+        case Instructions::f32x4_le.value():
+        case Instructions::f32x4_ge.value():
+        case Instructions::f64x2_eq.value():
+        case Instructions::f64x2_ne.value():
+        case Instructions::f64x2_lt.value():
+        case Instructions::f64x2_gt.value():
+        case Instructions::f64x2_le.value():
+        case Instructions::f64x2_ge.value():
+        case Instructions::v128_not.value():
+        case Instructions::v128_and.value():
+        case Instructions::v128_andnot.value():
+        case Instructions::v128_or.value():
+        case Instructions::v128_xor.value():
+        case Instructions::v128_bitselect.value():
+        case Instructions::v128_any_true.value():
+        case Instructions::f32x4_demote_f64x2_zero.value():
+        case Instructions::f64x2_promote_low_f32x4.value():
+        case Instructions::i8x16_abs.value():
+        case Instructions::i8x16_neg.value():
+        case Instructions::i8x16_popcnt.value():
+        case Instructions::i8x16_all_true.value():
+        case Instructions::i8x16_bitmask.value():
+        case Instructions::i8x16_narrow_i16x8_s.value():
+        case Instructions::i8x16_narrow_i16x8_u.value():
+        case Instructions::f32x4_ceil.value():
+        case Instructions::f32x4_floor.value():
+        case Instructions::f32x4_trunc.value():
+        case Instructions::f32x4_nearest.value():
+        case Instructions::i8x16_shl.value():
+        case Instructions::i8x16_shr_s.value():
+        case Instructions::i8x16_shr_u.value():
+        case Instructions::i8x16_add.value():
+        case Instructions::i8x16_add_sat_s.value():
+        case Instructions::i8x16_add_sat_u.value():
+        case Instructions::i8x16_sub.value():
+        case Instructions::i8x16_sub_sat_s.value():
+        case Instructions::i8x16_sub_sat_u.value():
+        case Instructions::f64x2_ceil.value():
+        case Instructions::f64x2_floor.value():
+        case Instructions::i8x16_min_s.value():
+        case Instructions::i8x16_min_u.value():
+        case Instructions::i8x16_max_s.value():
+        case Instructions::i8x16_max_u.value():
+        case Instructions::f64x2_trunc.value():
+        case Instructions::i8x16_avgr_u.value():
+        case Instructions::i16x8_extadd_pairwise_i8x16_s.value():
+        case Instructions::i16x8_extadd_pairwise_i8x16_u.value():
+        case Instructions::i32x4_extadd_pairwise_i16x8_s.value():
+        case Instructions::i32x4_extadd_pairwise_i16x8_u.value():
+        case Instructions::i16x8_abs.value():
+        case Instructions::i16x8_neg.value():
+        case Instructions::i16x8_q15mulr_sat_s.value():
+        case Instructions::i16x8_all_true.value():
+        case Instructions::i16x8_bitmask.value():
+        case Instructions::i16x8_narrow_i32x4_s.value():
+        case Instructions::i16x8_narrow_i32x4_u.value():
+        case Instructions::i16x8_extend_low_i8x16_s.value():
+        case Instructions::i16x8_extend_high_i8x16_s.value():
+        case Instructions::i16x8_extend_low_i8x16_u.value():
+        case Instructions::i16x8_extend_high_i8x16_u.value():
+        case Instructions::i16x8_shl.value():
+        case Instructions::i16x8_shr_s.value():
+        case Instructions::i16x8_shr_u.value():
+        case Instructions::i16x8_add.value():
+        case Instructions::i16x8_add_sat_s.value():
+        case Instructions::i16x8_add_sat_u.value():
+        case Instructions::i16x8_sub.value():
+        case Instructions::i16x8_sub_sat_s.value():
+        case Instructions::i16x8_sub_sat_u.value():
+        case Instructions::f64x2_nearest.value():
+        case Instructions::i16x8_mul.value():
+        case Instructions::i16x8_min_s.value():
+        case Instructions::i16x8_min_u.value():
+        case Instructions::i16x8_max_s.value():
+        case Instructions::i16x8_max_u.value():
+        case Instructions::i16x8_avgr_u.value():
+        case Instructions::i16x8_extmul_low_i8x16_s.value():
+        case Instructions::i16x8_extmul_high_i8x16_s.value():
+        case Instructions::i16x8_extmul_low_i8x16_u.value():
+        case Instructions::i16x8_extmul_high_i8x16_u.value():
+        case Instructions::i32x4_abs.value():
+        case Instructions::i32x4_neg.value():
+        case Instructions::i32x4_all_true.value():
+        case Instructions::i32x4_bitmask.value():
+        case Instructions::i32x4_extend_low_i16x8_s.value():
+        case Instructions::i32x4_extend_high_i16x8_s.value():
+        case Instructions::i32x4_extend_low_i16x8_u.value():
+        case Instructions::i32x4_extend_high_i16x8_u.value():
+        case Instructions::i32x4_shl.value():
+        case Instructions::i32x4_shr_s.value():
+        case Instructions::i32x4_shr_u.value():
+        case Instructions::i32x4_add.value():
+        case Instructions::i32x4_sub.value():
+        case Instructions::i32x4_mul.value():
+        case Instructions::i32x4_min_s.value():
+        case Instructions::i32x4_min_u.value():
+        case Instructions::i32x4_max_s.value():
+        case Instructions::i32x4_max_u.value():
+        case Instructions::i32x4_dot_i16x8_s.value():
+        case Instructions::i32x4_extmul_low_i16x8_s.value():
+        case Instructions::i32x4_extmul_high_i16x8_s.value():
+        case Instructions::i32x4_extmul_low_i16x8_u.value():
+        case Instructions::i32x4_extmul_high_i16x8_u.value():
+        case Instructions::i64x2_abs.value():
+        case Instructions::i64x2_neg.value():
+        case Instructions::i64x2_all_true.value():
+        case Instructions::i64x2_bitmask.value():
+        case Instructions::i64x2_extend_low_i32x4_s.value():
+        case Instructions::i64x2_extend_high_i32x4_s.value():
+        case Instructions::i64x2_extend_low_i32x4_u.value():
+        case Instructions::i64x2_extend_high_i32x4_u.value():
+        case Instructions::i64x2_shl.value():
+        case Instructions::i64x2_shr_s.value():
+        case Instructions::i64x2_shr_u.value():
+        case Instructions::i64x2_add.value():
+        case Instructions::i64x2_sub.value():
+        case Instructions::i64x2_mul.value():
+        case Instructions::i64x2_eq.value():
+        case Instructions::i64x2_ne.value():
+        case Instructions::i64x2_lt_s.value():
+        case Instructions::i64x2_gt_s.value():
+        case Instructions::i64x2_le_s.value():
+        case Instructions::i64x2_ge_s.value():
+        case Instructions::i64x2_extmul_low_i32x4_s.value():
+        case Instructions::i64x2_extmul_high_i32x4_s.value():
+        case Instructions::i64x2_extmul_low_i32x4_u.value():
+        case Instructions::i64x2_extmul_high_i32x4_u.value():
+        case Instructions::f32x4_abs.value():
+        case Instructions::f32x4_neg.value():
+        case Instructions::f32x4_sqrt.value():
+        case Instructions::f32x4_add.value():
+        case Instructions::f32x4_sub.value():
+        case Instructions::f32x4_mul.value():
+        case Instructions::f32x4_div.value():
+        case Instructions::f32x4_min.value():
+        case Instructions::f32x4_max.value():
+        case Instructions::f32x4_pmin.value():
+        case Instructions::f32x4_pmax.value():
+        case Instructions::f64x2_abs.value():
+        case Instructions::f64x2_neg.value():
+        case Instructions::f64x2_sqrt.value():
+        case Instructions::f64x2_add.value():
+        case Instructions::f64x2_sub.value():
+        case Instructions::f64x2_mul.value():
+        case Instructions::f64x2_div.value():
+        case Instructions::f64x2_min.value():
+        case Instructions::f64x2_max.value():
+        case Instructions::f64x2_pmin.value():
+        case Instructions::f64x2_pmax.value():
+        case Instructions::i32x4_trunc_sat_f32x4_s.value():
+        case Instructions::i32x4_trunc_sat_f32x4_u.value():
+        case Instructions::f32x4_convert_i32x4_s.value():
+        case Instructions::f32x4_convert_i32x4_u.value():
+        case Instructions::i32x4_trunc_sat_f64x2_s_zero.value():
+        case Instructions::i32x4_trunc_sat_f64x2_u_zero.value():
+        case Instructions::f64x2_convert_low_i32x4_s.value():
+        case Instructions::f64x2_convert_low_i32x4_u.value():
+            return Vector { Instruction { vector_opcode } };
+        default:
+            return ParseError::UnknownInstruction;
+        }
+    }
     }
 
     return ParseError::UnknownInstruction;
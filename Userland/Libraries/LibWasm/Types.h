@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/Debug.h>
 #include <AK/DistinctNumeric.h>
@@ -13,7 +14,9 @@
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Result.h>
 #include <AK/String.h>
+#include <AK/UFixedBigInt.h>
 #include <AK/Variant.h>
+#include <LibWasm/AbstractMachine/RegisterBytecode.h>
 #include <LibWasm/Constants.h>
 #include <LibWasm/Forward.h>
 #include <LibWasm/Opcode.h>
@@ -171,6 +174,7 @@ public:
         I64,
         F32,
         F64,
+        V128,
         FunctionReference,
         ExternReference,
         NullFunctionReference,
@@ -186,6 +190,7 @@ public:
 
     auto is_reference() const { return m_kind == ExternReference || m_kind == FunctionReference || m_kind == NullExternReference || m_kind == NullFunctionReference; }
     auto is_numeric() const { return !is_reference(); }
+    auto is_vector() const { return m_kind == V128; }
     auto kind() const { return m_kind; }
 
     static ParseResult<ValueType> parse(InputStream& stream);
@@ -201,6 +206,8 @@ public:
             return "f32";
         case F64:
             return "f64";
+        case V128:
+            return "v128";
         case FunctionReference:
             return "funcref";
         case ExternReference:
@@ -422,6 +429,19 @@ public:
         u32 offset;
     };
 
+    struct MemoryAndLaneArgument {
+        MemoryArgument memory;
+        u8 lane;
+    };
+
+    struct LaneIndex {
+        u8 lane;
+    };
+
+    struct ShuffleArgument {
+        Array<u8, 16> lanes;
+    };
+
     template<typename T>
     explicit Instruction(OpCode opcode, T argument)
         : m_opcode(opcode)
@@ -445,8 +465,11 @@ private:
         GlobalIndex,
         IndirectCallArgs,
         LabelIndex,
+        LaneIndex,
         LocalIndex,
+        MemoryAndLaneArgument,
         MemoryArgument,
+        ShuffleArgument,
         StructuredInstructionArgs,
         TableBranchArgs,
         TableElementArgs,
@@ -458,6 +481,7 @@ private:
         float,
         i32,
         i64,
+        u128,
         u8 // Empty state
     > m_arguments;
     // clang-format on
@@ -641,10 +665,15 @@ public:
 
     auto& instructions() const { return m_instructions; }
 
+    // The register bytecode this expression was translated to, if it's the body of a function that could be.
+    CompiledFunction const* compiled() const { return m_compiled.ptr(); }
+    void set_compiled(RefPtr<CompiledFunction> compiled) { m_compiled = move(compiled); }
+
     static ParseResult<Expression> parse(InputStream& stream);
 
 private:
     Vector<Instruction> m_instructions;
+    RefPtr<CompiledFunction> m_compiled;
 };
 
 class GlobalSection {
@@ -975,6 +1004,7 @@ public:
         auto& type() const { return m_type; }
         auto& locals() const { return m_local_types; }
         auto& body() const { return m_body; }
+        auto& body() { return m_body; }
 
     private:
         TypeIndex m_type;
@@ -1011,6 +1041,7 @@ public:
 
     auto& sections() const { return m_sections; }
     auto& functions() const { return m_functions; }
+    auto& functions() { return m_functions; }
     auto& type(TypeIndex index) const
     {
         FunctionType const* type = nullptr;
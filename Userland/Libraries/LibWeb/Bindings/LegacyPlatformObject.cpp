@@ -13,6 +13,7 @@ namespace Web::Bindings {
 LegacyPlatformObject::LegacyPlatformObject(JS::Object& prototype)
     : PlatformObject(prototype)
 {
+    set_has_exotic_property_access();
 }
 
 LegacyPlatformObject::~LegacyPlatformObject() = default;
@@ -25,6 +25,7 @@ LocationObject::LocationObject(JS::Realm& realm)
     : PlatformObject(realm)
 {
     set_prototype(&cached_web_prototype(realm, "Location"));
+    set_has_exotic_property_access();
 }
 
 LocationObject::~LocationObject() = default;
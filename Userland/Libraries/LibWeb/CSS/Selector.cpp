@@ -6,6 +6,7 @@
  */
 
 #include "Selector.h"
+#include <AK/StringHash.h>
 #include <LibWeb/CSS/Serialize.h>
 
 namespace Web::CSS {
@@ -23,6 +24,55 @@ Selector::Selector(Vector<CompoundSelector>&& compound_selectors)
             }
         }
     }
+
+    collect_ancestor_hashes();
+}
+
+void Selector::collect_ancestor_hashes()
+{
+    // NOTE: Checking a handful of hashes is enough to reject almost everything, and keeps the check cheap.
+    static constexpr size_t max_ancestor_hashes = 8;
+
+    // A compound is matched against an ancestor of the subject if the combinator after it is a descendant or child combinator.
+    // (If it's a sibling combinator, the compound after it may still be an ancestor, but this one is only its sibling.)
+    for (size_t i = 0; i + 1 < m_compound_selectors.size(); ++i) {
+        auto combinator = m_compound_selectors[i + 1].combinator;
+        if (combinator != Combinator::Descendant && combinator != Combinator::ImmediateChild)
+            continue;
+        for (auto const& simple_selector : m_compound_selectors[i].simple_selectors) {
+            switch (simple_selector.type) {
+            case SimpleSelector::Type::TagName:
+            case SimpleSelector::Type::Id:
+            case SimpleSelector::Type::Class:
+                m_ancestor_hashes.append(ancestor_filter_hash(simple_selector.type, simple_selector.name()));
+                if (m_ancestor_hashes.size() == max_ancestor_hashes)
+                    return;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+u32 ancestor_filter_hash(Selector::SimpleSelector::Type type, StringView name)
+{
+    // Salt the hashes, so that e.g. a class and a tag name with the same name don't collide.
+    u32 salt = 0;
+    switch (type) {
+    case Selector::SimpleSelector::Type::TagName:
+        salt = 13;
+        break;
+    case Selector::SimpleSelector::Type::Id:
+        salt = 17;
+        break;
+    case Selector::SimpleSelector::Type::Class:
+        salt = 19;
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    return AK::case_insensitive_string_hash(name.characters_without_null_termination(), name.length(), salt);
 }
 
 // https://www.w3.org/TR/selectors-4/#specificity-rules
@@ -200,10 +200,17 @@ public:
     u32 specificity() const;
     String serialize() const;
 
+    // Hashes of tag names, IDs and classes that some ancestor of a matching element is guaranteed to have.
+    // StyleComputer checks them against a Bloom filter of the actual ancestors to reject the selector without matching it.
+    Vector<u32> const& ancestor_hashes() const { return m_ancestor_hashes; }
+
 private:
     explicit Selector(Vector<CompoundSelector>&&);
 
+    void collect_ancestor_hashes();
+
     Vector<CompoundSelector> m_compound_selectors;
+    Vector<u32> m_ancestor_hashes;
     mutable Optional<u32> m_specificity;
     Optional<Selector::PseudoElement> m_pseudo_element;
 };
@@ -292,6 +299,9 @@ constexpr StringView pseudo_class_name(Selector::SimpleSelector::PseudoClass::Ty
 
 String serialize_a_group_of_selectors(NonnullRefPtrVector<Selector> const& selectors);
 
+// Hashes a tag name, ID or class for the ancestor Bloom filter. Hashing ignores case, so quirks mode matching is covered too.
+u32 ancestor_filter_hash(Selector::SimpleSelector::Type, StringView);
+
 }
 
 namespace AK {
@@ -25,7 +25,9 @@
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/FontCache.h>
+#include <LibWeb/HTML/AttributeNames.h>
 #include <LibWeb/HTML/HTMLHtmlElement.h>
+#include <LibWeb/HTML/HTMLInputElement.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Platform/FontPlugin.h>
 #include <stdio.h>
@@ -169,8 +171,11 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
 
         Vector<MatchingRule> matching_rules;
         matching_rules.ensure_capacity(rules_to_run.size());
+        bool use_ancestor_filter = can_use_ancestor_filter_for(element);
         for (auto const& rule_to_run : rules_to_run) {
             auto const& selector = rule_to_run.rule->selectors()[rule_to_run.selector_index];
+            if (use_ancestor_filter && ancestor_filter_rejects(selector))
+                continue;
             if (SelectorEngine::matches(selector, element, pseudo_element))
                 matching_rules.append(rule_to_run);
         }
@@ -178,12 +183,17 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
     }
 
     Vector<MatchingRule> matching_rules;
+    bool use_ancestor_filter = can_use_ancestor_filter_for(element);
     size_t style_sheet_index = 0;
     for_each_stylesheet(cascade_origin, [&](auto& sheet) {
         size_t rule_index = 0;
         sheet.for_each_effective_style_rule([&](auto const& rule) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
+                if (use_ancestor_filter && ancestor_filter_rejects(selector)) {
+                    ++selector_index;
+                    continue;
+                }
                 if (SelectorEngine::matches(selector, element, pseudo_element)) {
                     matching_rules.append({ &rule, style_sheet_index, rule_index, selector_index, selector.specificity() });
                     break;
@@ -1289,6 +1299,14 @@ NonnullRefPtr<StyleProperties> StyleComputer::compute_style(DOM::Element& elemen
 {
     build_rule_cache_if_needed();
 
+    if (!pseudo_element.has_value()) {
+        if (auto shared_style = find_shareable_style(element)) {
+            m_document.timings().did_share_style();
+            return shared_style.release_nonnull();
+        }
+    }
+
+    m_document.timings().did_compute_style();
     auto style = StyleProperties::create();
     // 1. Perform the cascade. This produces the "specified style"
     compute_cascaded_values(style, element, pseudo_element);
@@ -1345,6 +1363,243 @@ void StyleComputer::build_rule_cache_if_needed() const
     const_cast<StyleComputer&>(*this).build_rule_cache();
 }
 
+void StyleComputer::InvalidationSet::include(InvalidationSet const& other)
+{
+    invalidates_self |= other.invalidates_self;
+    invalidates_descendants |= other.invalidates_descendants;
+    invalidates_subsequent_siblings |= other.invalidates_subsequent_siblings;
+}
+
+// A class, ID or attribute in the subject compound selector can only affect the element that has it.
+// Anywhere else, the first combinator to its right says whether it affects descendants or later siblings
+// (and everything below those). Selectors nested in :is(), :not() and :where() affect whatever their
+// enclosing compound selector does.
+void StyleComputer::collect_invalidation_sets(Selector const& selector, InvalidationSet const& invalidation_set_for_subject)
+{
+    auto const& compound_selectors = selector.compound_selectors();
+    for (size_t i = 0; i < compound_selectors.size(); ++i) {
+        InvalidationSet invalidation_set = invalidation_set_for_subject;
+        if (i + 1 < compound_selectors.size()) {
+            switch (compound_selectors[i + 1].combinator) {
+            case Selector::Combinator::ImmediateChild:
+            case Selector::Combinator::Descendant:
+                invalidation_set.invalidates_descendants = true;
+                break;
+            case Selector::Combinator::NextSibling:
+            case Selector::Combinator::SubsequentSibling:
+                invalidation_set.invalidates_subsequent_siblings = true;
+                m_rule_cache->has_structural_selectors = true;
+                break;
+            case Selector::Combinator::None:
+            case Selector::Combinator::Column:
+                invalidation_set.invalidates_descendants = true;
+                invalidation_set.invalidates_subsequent_siblings = true;
+                break;
+            }
+        }
+
+        auto add_to = [&](HashMap<FlyString, InvalidationSet>& invalidation_sets, FlyString const& key, InvalidationSet const& set) {
+            invalidation_sets.ensure(key).include(set);
+        };
+
+        for (auto const& simple_selector : compound_selectors[i].simple_selectors) {
+            switch (simple_selector.type) {
+            case Selector::SimpleSelector::Type::Id:
+                add_to(m_rule_cache->invalidation_sets_by_id, simple_selector.name(), invalidation_set);
+                break;
+            case Selector::SimpleSelector::Type::Class:
+                add_to(m_rule_cache->invalidation_sets_by_class, simple_selector.name(), invalidation_set);
+                break;
+            case Selector::SimpleSelector::Type::Attribute:
+                add_to(m_rule_cache->invalidation_sets_by_attribute, simple_selector.attribute().name, invalidation_set);
+                break;
+            case Selector::SimpleSelector::Type::PseudoClass: {
+                auto const& pseudo_class = simple_selector.pseudo_class();
+                switch (pseudo_class.type) {
+                case Selector::SimpleSelector::PseudoClass::Type::Is:
+                case Selector::SimpleSelector::PseudoClass::Type::Not:
+                case Selector::SimpleSelector::PseudoClass::Type::Where:
+                    for (auto const& argument_selector : pseudo_class.argument_selector_list)
+                        collect_invalidation_sets(argument_selector, invalidation_set);
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Link:
+                case Selector::SimpleSelector::PseudoClass::Type::Visited:
+                    add_to(m_rule_cache->invalidation_sets_by_attribute, HTML::AttributeNames::href, invalidation_set);
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Checked:
+                    add_to(m_rule_cache->invalidation_sets_by_attribute, HTML::AttributeNames::checked, invalidation_set);
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Disabled:
+                case Selector::SimpleSelector::PseudoClass::Type::Enabled: {
+                    // NOTE: Form controls are also disabled by a disabled <fieldset> ancestor.
+                    auto disabled_invalidation_set = invalidation_set;
+                    disabled_invalidation_set.invalidates_descendants = true;
+                    add_to(m_rule_cache->invalidation_sets_by_attribute, HTML::AttributeNames::disabled, disabled_invalidation_set);
+                    break;
+                }
+                case Selector::SimpleSelector::PseudoClass::Type::Lang: {
+                    // NOTE: The language of an element is inherited from its ancestors.
+                    auto lang_invalidation_set = invalidation_set;
+                    lang_invalidation_set.invalidates_descendants = true;
+                    add_to(m_rule_cache->invalidation_sets_by_attribute, HTML::AttributeNames::lang, lang_invalidation_set);
+                    break;
+                }
+                case Selector::SimpleSelector::PseudoClass::Type::FirstChild:
+                case Selector::SimpleSelector::PseudoClass::Type::LastChild:
+                case Selector::SimpleSelector::PseudoClass::Type::OnlyChild:
+                case Selector::SimpleSelector::PseudoClass::Type::NthChild:
+                case Selector::SimpleSelector::PseudoClass::Type::NthLastChild:
+                case Selector::SimpleSelector::PseudoClass::Type::Empty:
+                case Selector::SimpleSelector::PseudoClass::Type::FirstOfType:
+                case Selector::SimpleSelector::PseudoClass::Type::LastOfType:
+                case Selector::SimpleSelector::PseudoClass::Type::OnlyOfType:
+                case Selector::SimpleSelector::PseudoClass::Type::NthOfType:
+                case Selector::SimpleSelector::PseudoClass::Type::NthLastOfType:
+                    m_rule_cache->has_structural_selectors = true;
+                    break;
+                default:
+                    break;
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+}
+
+StyleComputer::InvalidationSet StyleComputer::invalidation_set_for_class(FlyString const& class_name) const
+{
+    build_rule_cache_if_needed();
+    return m_rule_cache->invalidation_sets_by_class.get(class_name).value_or({});
+}
+
+StyleComputer::InvalidationSet StyleComputer::invalidation_set_for_id(FlyString const& id) const
+{
+    build_rule_cache_if_needed();
+    return m_rule_cache->invalidation_sets_by_id.get(id).value_or({});
+}
+
+StyleComputer::InvalidationSet StyleComputer::invalidation_set_for_attribute(FlyString const& attribute_name) const
+{
+    build_rule_cache_if_needed();
+    return m_rule_cache->invalidation_sets_by_attribute.get(attribute_name).value_or({});
+}
+
+bool StyleComputer::has_structural_selectors() const
+{
+    build_rule_cache_if_needed();
+    return m_rule_cache->has_structural_selectors;
+}
+
+static bool has_inline_style(DOM::Element const& element)
+{
+    return element.inline_style() && element.inline_style()->length() != 0;
+}
+
+static bool has_dynamic_state(DOM::Element const& element)
+{
+    // NOTE: These match pseudo-classes based on something other than the element's attributes and its parent.
+    if (element.is_focused() || element.is_active())
+        return true;
+    if (auto const* focused_element = element.document().focused_element(); focused_element && element.is_inclusive_ancestor_of(*focused_element))
+        return true;
+    if (auto const* hovered_node = element.document().hovered_node(); hovered_node && element.is_inclusive_ancestor_of(*hovered_node))
+        return true;
+    return is<HTML::HTMLInputElement>(element);
+}
+
+static bool can_share_style_with(DOM::Element const& element, DOM::Element const& candidate)
+{
+    if (!candidate.computed_css_values() || candidate.needs_style_update())
+        return false;
+    if (element.local_name() != candidate.local_name() || element.namespace_() != candidate.namespace_())
+        return false;
+    if (element.class_names() != candidate.class_names())
+        return false;
+    if (has_inline_style(candidate) || has_dynamic_state(candidate))
+        return false;
+
+    // NOTE: Comparing all the attributes covers attribute selectors, IDs, :link, :lang and presentational hints in one go.
+    if (element.attribute_list_size() != candidate.attribute_list_size())
+        return false;
+    for (size_t i = 0; i < element.attribute_list_size(); ++i) {
+        auto const* attribute = element.attributes()->item(i);
+        auto const* candidate_attribute = candidate.attributes()->item(i);
+        if (attribute->name() != candidate_attribute->name() || attribute->value() != candidate_attribute->value())
+            return false;
+    }
+    return true;
+}
+
+// Siblings that look the same to every selector end up with the same style, so we can hand out the same (immutable) StyleProperties.
+// This is very common with long lists and tables.
+RefPtr<StyleProperties> StyleComputer::find_shareable_style(DOM::Element& element) const
+{
+    // NOTE: Looking further back would find more candidates, but a mismatch this close usually means the siblings differ on purpose.
+    static constexpr size_t max_candidates_to_check = 8;
+
+    // Structural selectors (e.g. :nth-child() or sibling combinators) can tell siblings apart even if they look the same.
+    if (m_rule_cache->has_structural_selectors)
+        return nullptr;
+    if (has_inline_style(element) || has_dynamic_state(element))
+        return nullptr;
+
+    size_t candidates_checked = 0;
+    for (auto* candidate = element.previous_element_sibling(); candidate && candidates_checked < max_candidates_to_check; candidate = candidate->previous_element_sibling(), ++candidates_checked) {
+        if (can_share_style_with(element, *candidate))
+            return candidate->computed_css_values();
+    }
+    return nullptr;
+}
+
+void StyleComputer::push_ancestor(DOM::Element const& element)
+{
+    size_t hash_count = 0;
+    auto add_hash = [&](Selector::SimpleSelector::Type type, StringView name) {
+        auto hash = ancestor_filter_hash(type, name);
+        m_ancestor_filter.add(hash);
+        m_ancestor_filter_hashes.append(hash);
+        ++hash_count;
+    };
+
+    add_hash(Selector::SimpleSelector::Type::TagName, element.local_name());
+    if (auto id = element.get_attribute(HTML::AttributeNames::id); !id.is_empty())
+        add_hash(Selector::SimpleSelector::Type::Id, id);
+    for (auto const& class_name : element.class_names())
+        add_hash(Selector::SimpleSelector::Type::Class, class_name);
+
+    m_ancestor_stack.append({ &element, hash_count });
+}
+
+void StyleComputer::pop_ancestor(DOM::Element const& element)
+{
+    // NOTE: The element's ID and classes may have changed since it was pushed, so we remove exactly the hashes we added.
+    auto ancestor = m_ancestor_stack.take_last();
+    VERIFY(ancestor.element == &element);
+    for (size_t i = 0; i < ancestor.hash_count; ++i)
+        m_ancestor_filter.remove(m_ancestor_filter_hashes.take_last());
+}
+
+bool StyleComputer::can_use_ancestor_filter_for(DOM::Element const& element) const
+{
+    // The filter is only trustworthy if it was built by walking down to this very element.
+    // Style computed from anywhere else (e.g. getComputedStyle()) just matches every selector.
+    if (m_ancestor_stack.is_empty())
+        return false;
+    return element.parent_element() == m_ancestor_stack.last().element;
+}
+
+bool StyleComputer::ancestor_filter_rejects(Selector const& selector) const
+{
+    for (auto hash : selector.ancestor_hashes()) {
+        if (!m_ancestor_filter.may_contain(hash))
+            return true;
+    }
+    return false;
+}
+
 void StyleComputer::build_rule_cache()
 {
     // FIXME: Make a rule cache for UA style as well.
@@ -1406,6 +1661,18 @@ void StyleComputer::build_rule_cache()
         ++style_sheet_index;
     });
 
+    // NOTE: Unlike the buckets above, invalidation has to know about the user agent rules as well.
+    InvalidationSet invalidation_set_for_subject;
+    invalidation_set_for_subject.invalidates_self = true;
+    for (auto cascade_origin : { CascadeOrigin::UserAgent, CascadeOrigin::Author }) {
+        for_each_stylesheet(cascade_origin, [&](auto& sheet) {
+            sheet.for_each_effective_style_rule([&](auto const& rule) {
+                for (CSS::Selector const& selector : rule.selectors())
+                    collect_invalidation_sets(selector, invalidation_set_for_subject);
+            });
+        });
+    }
+
     if constexpr (LIBWEB_CSS_DEBUG) {
         dbgln("Built rule cache!");
         dbgln("           ID: {}", num_id_rules);
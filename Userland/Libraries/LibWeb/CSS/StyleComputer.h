@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/CountingBloomFilter.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Optional.h>
@@ -71,6 +72,28 @@ public:
 
     void invalidate_rule_cache();
 
+    // Describes which elements may have to recompute their style when a class, ID or attribute of an element changes.
+    struct InvalidationSet {
+        bool invalidates_self { false };
+        bool invalidates_descendants { false };
+        bool invalidates_subsequent_siblings { false };
+
+        bool is_empty() const { return !invalidates_self && !invalidates_descendants && !invalidates_subsequent_siblings; }
+        void include(InvalidationSet const&);
+    };
+
+    InvalidationSet invalidation_set_for_class(FlyString const&) const;
+    InvalidationSet invalidation_set_for_id(FlyString const&) const;
+    InvalidationSet invalidation_set_for_attribute(FlyString const&) const;
+
+    // Whether any selector depends on the position of an element among its siblings, e.g. through sibling combinators or :nth-child().
+    bool has_structural_selectors() const;
+
+    // While walking down the tree to compute style, the ancestors of the current element are pushed here,
+    // which lets collect_matching_rules() reject selectors that need an ancestor this element doesn't have.
+    void push_ancestor(DOM::Element const&);
+    void pop_ancestor(DOM::Element const&);
+
     Gfx::Font const& initial_font() const;
 
     void did_load_font(FlyString const& family_name);
@@ -105,6 +128,12 @@ private:
 
     void build_rule_cache();
     void build_rule_cache_if_needed() const;
+    void collect_invalidation_sets(Selector const&, InvalidationSet const& invalidation_set_for_subject);
+
+    RefPtr<StyleProperties> find_shareable_style(DOM::Element&) const;
+
+    bool can_use_ancestor_filter_for(DOM::Element const&) const;
+    bool ancestor_filter_rejects(Selector const&) const;
 
     DOM::Document& m_document;
 
@@ -114,9 +143,22 @@ private:
         HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
         HashMap<Selector::PseudoElement, Vector<MatchingRule>> rules_by_pseudo_element;
         Vector<MatchingRule> other_rules;
+
+        HashMap<FlyString, InvalidationSet> invalidation_sets_by_id;
+        HashMap<FlyString, InvalidationSet> invalidation_sets_by_class;
+        HashMap<FlyString, InvalidationSet> invalidation_sets_by_attribute;
+        bool has_structural_selectors { false };
     };
     OwnPtr<RuleCache> m_rule_cache;
 
+    struct Ancestor {
+        DOM::Element const* element { nullptr };
+        size_t hash_count { 0 };
+    };
+    CountingBloomFilter<> m_ancestor_filter;
+    Vector<Ancestor> m_ancestor_stack;
+    Vector<u32> m_ancestor_filter_hashes;
+
     class FontLoader;
     HashMap<String, NonnullOwnPtr<FontLoader>> m_loaded_fonts;
 };
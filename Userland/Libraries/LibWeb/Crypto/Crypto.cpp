@@ -56,7 +56,7 @@ WebIDL::ExceptionOr<JS::Value> Crypto::get_random_values(JS::Value array) const
     // FIXME: Handle SharedArrayBuffers
 
     // 3. Overwrite all elements of array with cryptographically strong random values of the appropriate type.
-    fill_with_random(typed_array.viewed_array_buffer()->buffer().data(), typed_array.viewed_array_buffer()->buffer().size());
+    fill_with_random(typed_array.viewed_array_buffer()->bytes().data(), typed_array.viewed_array_buffer()->bytes().size());
 
     // 4. Return array.
     return array;
@@ -7,6 +7,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/CharacterTypes.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
@@ -63,6 +64,8 @@
 #include <LibWeb/HighResolutionTime/TimeOrigin.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
 #include <LibWeb/Layout/InitialContainingBlock.h>
+#include <LibWeb/Layout/LayoutState.h>
+#include <LibWeb/Layout/ListItemBox.h>
 #include <LibWeb/Layout/TreeBuilder.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/Page/Page.h>
@@ -357,6 +360,8 @@ void Document::visit_edges(Cell::Visitor& visitor)
         visitor.visit(target.ptr());
     for (auto& target : m_pending_scrollend_event_targets)
         visitor.visit(target.ptr());
+    for (auto& element : m_elements_needing_layout_subtree_rebuild)
+        visitor.visit(element.ptr());
 }
 
 // https://w3c.github.io/selection-api/#dom-document-getselection
@@ -705,9 +710,13 @@ void Document::tear_down_layout_tree()
     for (auto& layout_node : layout_nodes) {
         if (layout_node->parent())
             layout_node->parent()->remove_child(*layout_node);
+        // NOTE: Don't leave DOM nodes pointing at layout nodes that aren't part of any layout tree anymore.
+        if (auto* dom_node = layout_node->dom_node(); dom_node && !layout_node->is_anonymous() && dom_node->layout_node() == layout_node.ptr())
+            dom_node->detach_layout_node(Badge<Document> {});
     }
 
     m_layout_root = nullptr;
+    m_elements_needing_layout_subtree_rebuild.clear();
 }
 
 Color Document::background_color(Gfx::Palette const& palette) const
@@ -813,6 +822,171 @@ void Document::invalidate_layout()
     schedule_layout_update();
 }
 
+void Document::invalidate_layout_subtree(Node& node)
+{
+    // NOTE: If there's no layout tree, the next layout update will build all of it anyway.
+    //       Nodes that aren't in the document don't have any layout nodes to begin with.
+    if (!m_layout_root || !node.is_connected())
+        return;
+
+    // Rebuilding lots of separate subtrees quickly gets more expensive than rebuilding the whole tree.
+    static constexpr size_t max_layout_subtrees_to_rebuild = 16;
+
+    for (auto* ancestor = &node; ancestor; ancestor = ancestor->parent_or_shadow_host()) {
+        if (!is<Element>(*ancestor) || !ancestor->layout_node())
+            continue;
+        auto& element = static_cast<Element&>(*ancestor);
+
+        for (auto& pending_element : m_elements_needing_layout_subtree_rebuild) {
+            if (pending_element->is_shadow_including_inclusive_ancestor_of(element))
+                return;
+        }
+        m_elements_needing_layout_subtree_rebuild.remove_all_matching([&](auto& pending_element) {
+            return element.is_shadow_including_inclusive_ancestor_of(*pending_element);
+        });
+
+        if (m_elements_needing_layout_subtree_rebuild.size() >= max_layout_subtrees_to_rebuild)
+            break;
+
+        m_elements_needing_layout_subtree_rebuild.append(element);
+        schedule_layout_update();
+        return;
+    }
+
+    invalidate_layout();
+}
+
+// A relayout root is a box whose size doesn't depend on its contents, and whose contents can't affect anything outside of it.
+// Changes inside of it can be laid out again without touching the rest of the tree.
+static bool is_relayout_root(Layout::Node const& node)
+{
+    if (!is<Layout::BlockContainer>(node) || node.is_anonymous() || node.is_initial_containing_block_box() || is<Layout::ListItemBox>(node))
+        return false;
+    auto const& box = static_cast<Layout::BlockContainer const&>(node);
+
+    // We reuse the geometry from the last layout, so there has to be one.
+    if (!box.paint_box())
+        return false;
+
+    auto display = box.display();
+    if (!display.is_block_outside() || !(display.is_flow_inside() || display.is_flow_root_inside()))
+        return false;
+
+    auto const& computed_values = box.computed_values();
+    auto is_fixed_size = [](CSS::Size const& size) {
+        return size.is_length() && !size.length().is_calculated();
+    };
+    auto is_content_independent = [](CSS::Size const& size) {
+        return !size.is_min_content() && !size.is_max_content() && !size.is_fit_content();
+    };
+    if (!is_fixed_size(computed_values.width()) || !is_fixed_size(computed_values.height()))
+        return false;
+    if (!is_content_independent(computed_values.min_width()) || !is_content_independent(computed_values.max_width())
+        || !is_content_independent(computed_values.min_height()) || !is_content_independent(computed_values.max_height()))
+        return false;
+
+    // Clipping the overflow establishes a block formatting context, and keeps the contents from being painted outside the box.
+    if (computed_values.overflow_x() == CSS::Overflow::Visible || computed_values.overflow_y() == CSS::Overflow::Visible)
+        return false;
+
+    // Absolutely positioned descendants may be laid out by a formatting context further up the tree.
+    bool has_absolutely_positioned_descendant = false;
+    box.for_each_in_subtree_of_type<Layout::Box>([&](auto& descendant) {
+        if (descendant.is_absolutely_positioned()) {
+            has_absolutely_positioned_descendant = true;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    return !has_absolutely_positioned_descendant;
+}
+
+// Finds the relayout roots that contain all the nodes that need layout. Returns false if some of them aren't inside one.
+static bool collect_relayout_roots(Layout::Node& node, Layout::BlockContainer* enclosing_relayout_root, Vector<Layout::BlockContainer&>& relayout_roots)
+{
+    if (!node.needs_layout() && !node.child_needs_layout())
+        return true;
+
+    if (is_relayout_root(node))
+        enclosing_relayout_root = &static_cast<Layout::BlockContainer&>(node);
+
+    if (node.needs_layout()) {
+        if (!enclosing_relayout_root)
+            return false;
+        // NOTE: Everything below the relayout root is going to be laid out again anyway.
+        if (!any_of(relayout_roots, [&](auto& relayout_root) { return &relayout_root == enclosing_relayout_root; }))
+            relayout_roots.append(*enclosing_relayout_root);
+        return true;
+    }
+
+    bool success = true;
+    node.for_each_child([&](auto& child) {
+        if (success)
+            success = collect_relayout_roots(child, enclosing_relayout_root, relayout_roots);
+    });
+    return success;
+}
+
+static void copy_committed_geometry(Layout::Box const& box, Layout::LayoutState::UsedValues& used_values)
+{
+    auto const& box_model = box.box_model();
+    used_values.margin_left = box_model.margin.left;
+    used_values.margin_right = box_model.margin.right;
+    used_values.margin_top = box_model.margin.top;
+    used_values.margin_bottom = box_model.margin.bottom;
+    used_values.border_left = box_model.border.left;
+    used_values.border_right = box_model.border.right;
+    used_values.border_top = box_model.border.top;
+    used_values.border_bottom = box_model.border.bottom;
+    used_values.padding_left = box_model.padding.left;
+    used_values.padding_right = box_model.padding.right;
+    used_values.padding_top = box_model.padding.top;
+    used_values.padding_bottom = box_model.padding.bottom;
+    used_values.inset_left = box_model.inset.left;
+    used_values.inset_right = box_model.inset.right;
+    used_values.inset_top = box_model.inset.top;
+    used_values.inset_bottom = box_model.inset.bottom;
+
+    auto const& paint_box = *box.paint_box();
+    used_values.offset = paint_box.offset();
+    used_values.set_content_width(paint_box.content_width());
+    used_values.set_content_height(paint_box.content_height());
+}
+
+void Document::relayout_subtree(Layout::BlockContainer& relayout_root)
+{
+    Layout::LayoutState layout_state;
+    layout_state.used_values_per_layout_node.resize(layout_node_count());
+
+    // The relayout root and its containing blocks keep the geometry they were given by the last layout.
+    // The containing blocks have to be seeded outermost first, as each one looks at its own containing block.
+    Vector<Layout::Box const&> containing_blocks;
+    for (auto const* containing_block = relayout_root.containing_block(); containing_block; containing_block = containing_block->containing_block())
+        containing_blocks.append(*containing_block);
+    for (auto& containing_block : containing_blocks.in_reverse())
+        copy_committed_geometry(containing_block, layout_state.get_mutable(containing_block));
+    auto& root_state = layout_state.get_mutable(relayout_root);
+    copy_committed_geometry(relayout_root, root_state);
+
+    {
+        Layout::BlockFormattingContext formatting_context(layout_state, relayout_root, nullptr);
+        formatting_context.run(
+            relayout_root,
+            Layout::LayoutMode::Normal,
+            Layout::AvailableSpace(
+                Layout::AvailableSize::make_definite(root_state.content_width()),
+                Layout::AvailableSize::make_definite(root_state.content_height())));
+        formatting_context.parent_context_did_dimension_child_root_box();
+    }
+
+    // Only commit what's inside the relayout root, everything else already has what it needs.
+    for (auto& used_values : layout_state.used_values_per_layout_node) {
+        if (used_values && !relayout_root.is_inclusive_ancestor_of(used_values->node()))
+            used_values = nullptr;
+    }
+    layout_state.commit();
+}
+
 void Document::update_layout()
 {
     // NOTE: If our parent document needs a relayout, we must do that *first*.
@@ -822,7 +996,7 @@ void Document::update_layout()
 
     update_style();
 
-    if (!m_needs_layout && m_layout_root)
+    if (!m_needs_layout && m_layout_root && m_elements_needing_layout_subtree_rebuild.is_empty() && !m_layout_root->needs_layout() && !m_layout_root->child_needs_layout())
         return;
 
     // NOTE: If this is a document hosting <template> contents, layout is unnecessary.
@@ -832,34 +1006,78 @@ void Document::update_layout()
     if (!browsing_context())
         return;
 
+    TimingScope timing_scope(*this, TimingPhase::Layout);
+
     auto viewport_rect = browsing_context()->viewport_rect();
 
+    auto elements_needing_layout_subtree_rebuild = move(m_elements_needing_layout_subtree_rebuild);
+    if (m_layout_root) {
+        Layout::TreeBuilder tree_builder;
+        for (auto& element : elements_needing_layout_subtree_rebuild) {
+            if (!tree_builder.rebuild_subtree(*element)) {
+                tear_down_layout_tree();
+                break;
+            }
+        }
+    }
+
+    // NOTE: Layout nodes get new serial IDs when their subtree is rebuilt, and the LayoutState has a slot for every ID ever handed out.
+    //       Rebuilding everything once in a while keeps that from growing without bounds.
+    if (m_layout_root && layout_node_count() > 4 * m_layout_node_count_after_full_rebuild)
+        tear_down_layout_tree();
+
+    bool needs_full_layout = m_needs_layout;
+
+    // NOTE: Nobody told us what changed, so none of the intrinsic sizes from the last layout can be trusted.
+    if (m_needs_layout && m_layout_root) {
+        m_layout_root->for_each_in_inclusive_subtree_of_type<Layout::Box>([](auto& box) {
+            box.invalidate_cached_intrinsic_sizes();
+            return IterationDecision::Continue;
+        });
+    }
+
     if (!m_layout_root) {
         m_next_layout_node_serial_id = 0;
         Layout::TreeBuilder tree_builder;
         m_layout_root = verify_cast<Layout::InitialContainingBlock>(*tree_builder.build(*this));
+        m_layout_node_count_after_full_rebuild = layout_node_count();
+        needs_full_layout = true;
     }
 
-    Layout::LayoutState layout_state;
-    layout_state.used_values_per_layout_node.resize(layout_node_count());
+    Vector<Layout::BlockContainer&> relayout_roots;
+    if (!needs_full_layout)
+        needs_full_layout = !collect_relayout_roots(*m_layout_root, nullptr, relayout_roots);
 
-    {
-        Layout::BlockFormattingContext root_formatting_context(layout_state, *m_layout_root, nullptr);
+    if (needs_full_layout) {
+        Layout::LayoutState layout_state;
+        layout_state.used_values_per_layout_node.resize(layout_node_count());
 
-        auto& icb = static_cast<Layout::InitialContainingBlock&>(*m_layout_root);
-        auto& icb_state = layout_state.get_mutable(icb);
-        icb_state.set_content_width(viewport_rect.width());
-        icb_state.set_content_height(viewport_rect.height());
+        {
+            Layout::BlockFormattingContext root_formatting_context(layout_state, *m_layout_root, nullptr);
 
-        root_formatting_context.run(
-            *m_layout_root,
-            Layout::LayoutMode::Normal,
-            Layout::AvailableSpace(
-                Layout::AvailableSize::make_definite(viewport_rect.width()),
-                Layout::AvailableSize::make_definite(viewport_rect.height())));
+            auto& icb = static_cast<Layout::InitialContainingBlock&>(*m_layout_root);
+            auto& icb_state = layout_state.get_mutable(icb);
+            icb_state.set_content_width(viewport_rect.width());
+            icb_state.set_content_height(viewport_rect.height());
+
+            root_formatting_context.run(
+                *m_layout_root,
+                Layout::LayoutMode::Normal,
+                Layout::AvailableSpace(
+                    Layout::AvailableSize::make_definite(viewport_rect.width()),
+                    Layout::AvailableSize::make_definite(viewport_rect.height())));
+        }
+
+        layout_state.commit();
+    } else {
+        for (auto& relayout_root : relayout_roots)
+            relayout_subtree(relayout_root);
+
+        // The stacking contexts belong to the paintables, some of which have just been replaced.
+        invalidate_stacking_context_tree();
     }
 
-    layout_state.commit();
+    m_layout_root->clear_needs_layout_in_subtree();
 
     browsing_context()->set_needs_display();
 
@@ -872,13 +1090,26 @@ void Document::update_layout()
     m_layout_update_timer->stop();
 }
 
-[[nodiscard]] static bool update_style_recursively(DOM::Node& node)
+static void update_style_recursively(DOM::Node& node)
 {
     bool const needs_full_style_update = node.document().needs_full_style_update();
-    bool needs_relayout = false;
 
     if (is<Element>(node)) {
-        needs_relayout |= static_cast<Element&>(node).recompute_style() == Element::NeedsRelayout::Yes;
+        auto& element = static_cast<Element&>(node);
+        auto const* old_computed_css_values = element.computed_css_values();
+        // NOTE: An element's box depends on its own style, so we rebuild the layout tree starting at its parent.
+        if (element.recompute_style() == Element::NeedsRelayout::Yes)
+            node.document().invalidate_layout_subtree(*node.parent_or_shadow_host());
+
+        // NOTE: Style invalidation may only have marked this element, but its children inherit from it.
+        if (!needs_full_style_update && element.computed_css_values() != old_computed_css_values) {
+            if (auto* shadow_root = element.shadow_root())
+                shadow_root->set_needs_style_update(true);
+            element.for_each_child([&](auto& child) {
+                child.set_needs_style_update(true);
+                return IterationDecision::Continue;
+            });
+        }
     }
     node.set_needs_style_update(false);
 
@@ -886,18 +1117,24 @@ void Document::update_layout()
         if (node.is_element()) {
             if (auto* shadow_root = static_cast<DOM::Element&>(node).shadow_root()) {
                 if (needs_full_style_update || shadow_root->needs_style_update() || shadow_root->child_needs_style_update())
-                    needs_relayout |= update_style_recursively(*shadow_root);
+                    update_style_recursively(*shadow_root);
             }
         }
+
+        // NOTE: This lets the style computer skip selectors that need an ancestor the children don't have.
+        auto& style_computer = node.document().style_computer();
+        if (is<Element>(node))
+            style_computer.push_ancestor(static_cast<Element const&>(node));
         node.for_each_child([&](auto& child) {
             if (needs_full_style_update || child.needs_style_update() || child.child_needs_style_update())
-                needs_relayout |= update_style_recursively(child);
+                update_style_recursively(child);
             return IterationDecision::Continue;
         });
+        if (is<Element>(node))
+            style_computer.pop_ancestor(static_cast<Element const&>(node));
     }
 
     node.set_child_needs_style_update(false);
-    return needs_relayout;
 }
 
 void Document::update_style()
@@ -911,9 +1148,10 @@ void Document::update_style()
     if (m_created_for_appropriate_template_contents)
         return;
 
+    TimingScope timing_scope(*this, TimingPhase::Style);
+
     evaluate_media_rules();
-    if (update_style_recursively(*this))
-        invalidate_layout();
+    update_style_recursively(*this);
     m_needs_full_style_update = false;
     m_style_update_timer->stop();
 }
@@ -21,6 +21,7 @@
 #include <LibWeb/CSS/StyleComputer.h>
 #include <LibWeb/CSS/StyleSheetList.h>
 #include <LibWeb/Cookie/Cookie.h>
+#include <LibWeb/DOM/DocumentTimings.h>
 #include <LibWeb/DOM/NonElementParentNode.h>
 #include <LibWeb/DOM/ParentNode.h>
 #include <LibWeb/HTML/BrowsingContext.h>
@@ -94,6 +95,9 @@ public:
     size_t next_layout_node_serial_id(Badge<Layout::Node>) { return m_next_layout_node_serial_id++; }
     size_t layout_node_count() const { return m_next_layout_node_serial_id; }
 
+    DocumentTimings& timings() { return m_timings; }
+    DocumentTimings const& timings() const { return m_timings; }
+
     String cookie(Cookie::Source = Cookie::Source::NonHttp);
     void set_cookie(String const&, Cookie::Source = Cookie::Source::NonHttp);
 
@@ -195,6 +199,7 @@ public:
     void set_needs_layout();
 
     void invalidate_layout();
+    void invalidate_layout_subtree(Node&);
     void invalidate_stacking_context_tree();
 
     virtual bool is_child_allowed(Node const&) const override;
@@ -458,6 +463,7 @@ private:
     virtual EventTarget& global_event_handlers_to_event_target(FlyString const&) final { return *this; }
 
     void tear_down_layout_tree();
+    void relayout_subtree(Layout::BlockContainer&);
 
     void evaluate_media_rules();
 
@@ -476,6 +482,10 @@ private:
     JS::GCPtr<HTML::Window> m_window;
 
     JS::GCPtr<Layout::InitialContainingBlock> m_layout_root;
+    Vector<JS::NonnullGCPtr<Element>> m_elements_needing_layout_subtree_rebuild;
+    size_t m_layout_node_count_after_full_rebuild { 0 };
+
+    DocumentTimings m_timings;
 
     Optional<Color> m_link_color;
     Optional<Color> m_active_link_color;
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/DOM/DocumentTimings.h>
+
+namespace Web::DOM {
+
+// NOTE: All documents live on the same thread, so there is only ever one stack of scopes.
+static TimingScope* s_current_scope { nullptr };
+
+StringView timing_phase_name(TimingPhase phase)
+{
+    switch (phase) {
+    case TimingPhase::Parse:
+        return "parse"sv;
+    case TimingPhase::Style:
+        return "style"sv;
+    case TimingPhase::Layout:
+        return "layout"sv;
+    case TimingPhase::Paint:
+        return "paint"sv;
+    case TimingPhase::JavaScript:
+        return "javascript"sv;
+    case TimingPhase::__Count:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void DocumentTimings::add(DocumentTimings const& other)
+{
+    for (size_t i = 0; i < m_phases.size(); ++i) {
+        m_phases[i].total_time += other.m_phases[i].total_time;
+        m_phases[i].runs += other.m_phases[i].runs;
+    }
+    m_computed_style_count += other.m_computed_style_count;
+    m_shared_style_count += other.m_shared_style_count;
+    m_committed_layout_node_count += other.m_committed_layout_node_count;
+}
+
+TimingScope::TimingScope(Document& document, TimingPhase phase)
+    : m_timings(document.timings())
+    , m_phase(phase)
+    , m_start(Time::now_monotonic())
+    , m_outer_scope(s_current_scope)
+{
+    if (m_outer_scope)
+        m_outer_scope->m_timings.add_to_phase(m_outer_scope->m_phase, m_start - m_outer_scope->m_start);
+    m_timings.count_run_of_phase(m_phase);
+    s_current_scope = this;
+}
+
+TimingScope::~TimingScope()
+{
+    VERIFY(s_current_scope == this);
+    auto now = Time::now_monotonic();
+    m_timings.add_to_phase(m_phase, now - m_start);
+    if (m_outer_scope)
+        m_outer_scope->m_start = now;
+    s_current_scope = m_outer_scope;
+}
+
+}
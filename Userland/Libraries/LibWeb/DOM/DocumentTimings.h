@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Noncopyable.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <LibWeb/Forward.h>
+
+namespace Web::DOM {
+
+enum class TimingPhase {
+    Parse,
+    Style,
+    Layout,
+    Paint,
+    JavaScript,
+    __Count,
+};
+
+StringView timing_phase_name(TimingPhase);
+
+// Adds up how much time a document has spent in each phase of turning markup into pixels, for benchmarking.
+class DocumentTimings {
+public:
+    struct Phase {
+        Time total_time;
+        size_t runs { 0 };
+    };
+
+    Phase const& phase(TimingPhase phase) const { return m_phases[to_underlying(phase)]; }
+    void add_to_phase(TimingPhase phase, Time time) { m_phases[to_underlying(phase)].total_time += time; }
+    void count_run_of_phase(TimingPhase phase) { ++m_phases[to_underlying(phase)].runs; }
+
+    size_t computed_style_count() const { return m_computed_style_count; }
+    size_t shared_style_count() const { return m_shared_style_count; }
+    size_t committed_layout_node_count() const { return m_committed_layout_node_count; }
+
+    void did_compute_style() { ++m_computed_style_count; }
+    void did_share_style() { ++m_shared_style_count; }
+    void did_commit_layout_nodes(size_t count) { m_committed_layout_node_count += count; }
+
+    void add(DocumentTimings const&);
+
+private:
+    Array<Phase, to_underlying(TimingPhase::__Count)> m_phases {};
+    size_t m_computed_style_count { 0 };
+    size_t m_shared_style_count { 0 };
+    size_t m_committed_layout_node_count { 0 };
+};
+
+// Charges the time until it goes out of scope to one phase of a document.
+// If another scope is entered in the meantime (e.g. a script run by the parser), that time is charged to the inner phase only.
+class TimingScope {
+    AK_MAKE_NONCOPYABLE(TimingScope);
+    AK_MAKE_NONMOVABLE(TimingScope);
+
+public:
+    TimingScope(Document&, TimingPhase);
+    ~TimingScope();
+
+private:
+    DocumentTimings& m_timings;
+    TimingPhase m_phase;
+    Time m_start;
+    TimingScope* m_outer_scope { nullptr };
+};
+
+}
@@ -114,6 +114,7 @@ WebIDL::ExceptionOr<void> Element::set_attribute(FlyString const& name, String c
 
     // 3. Let attribute be the first attribute in this’s attribute list whose qualified name is qualifiedName, and null otherwise.
     auto* attribute = m_attributes->get_attribute(name);
+    auto old_value = attribute ? attribute->value() : String {};
 
     // 4. If attribute is null, create an attribute whose local name is qualifiedName, value is value, and node document is this’s node document, then append this attribute to this, and then return.
     if (!attribute) {
@@ -130,7 +131,7 @@ WebIDL::ExceptionOr<void> Element::set_attribute(FlyString const& name, String c
 
     parse_attribute(attribute->local_name(), value);
 
-    invalidate_style_after_attribute_change(name);
+    invalidate_style_after_attribute_change(name, old_value);
 
     return {};
 }
@@ -193,11 +194,15 @@ WebIDL::ExceptionOr<void> Element::set_attribute_ns(FlyString const& namespace_,
 // https://dom.spec.whatwg.org/#dom-element-removeattribute
 void Element::remove_attribute(FlyString const& name)
 {
+    auto old_value = get_attribute(name);
+    if (old_value.is_null())
+        return;
+
     m_attributes->remove_attribute(name);
 
     did_remove_attribute(name);
 
-    invalidate_style_after_attribute_change(name);
+    invalidate_style_after_attribute_change(name, old_value);
 }
 
 // https://dom.spec.whatwg.org/#dom-element-hasattribute
@@ -230,7 +235,7 @@ WebIDL::ExceptionOr<bool> Element::toggle_attribute(FlyString const& name, Optio
 
             parse_attribute(new_attribute->local_name(), "");
 
-            invalidate_style_after_attribute_change(name);
+            invalidate_style_after_attribute_change(name, {});
 
             return true;
         }
@@ -241,11 +246,12 @@ WebIDL::ExceptionOr<bool> Element::toggle_attribute(FlyString const& name, Optio
 
     // 5. Otherwise, if force is not given or is false, remove an attribute given qualifiedName and this, and then return false.
     if (!force.has_value() || !force.value()) {
+        auto old_value = attribute->value();
         m_attributes->remove_attribute(name);
 
         did_remove_attribute(name);
 
-        invalidate_style_after_attribute_change(name);
+        invalidate_style_after_attribute_change(name, old_value);
     }
 
     // 6. Return true.
@@ -352,7 +358,11 @@ void Element::parse_attribute(FlyString const& name, String const& value)
 
 void Element::did_remove_attribute(FlyString const& name)
 {
-    if (name == HTML::AttributeNames::style) {
+    if (name == HTML::AttributeNames::class_) {
+        m_classes.clear();
+        if (m_class_list)
+            m_class_list->associated_attribute_changed({});
+    } else if (name == HTML::AttributeNames::style) {
         if (m_inline_style) {
             m_inline_style = nullptr;
             set_needs_style_update(true);
@@ -369,6 +379,9 @@ enum class RequiredInvalidation {
 
 static RequiredInvalidation compute_required_invalidation(CSS::StyleProperties const& old_style, CSS::StyleProperties const& new_style)
 {
+    // NOTE: Siblings may share their computed style, so recomputing it may give us the very same object.
+    if (&old_style == &new_style)
+        return RequiredInvalidation::None;
     if (&old_style.computed_font() != &new_style.computed_font())
         return RequiredInvalidation::Relayout;
     bool requires_repaint = false;
@@ -1252,13 +1265,43 @@ void Element::scroll_into_view(Optional<Variant<bool, ScrollIntoViewOptions>> ar
     // FIXME: 8. Optionally perform some other action that brings the element to the user’s attention.
 }
 
-void Element::invalidate_style_after_attribute_change(FlyString const& attribute_name)
+void Element::invalidate_style_after_attribute_change(FlyString const& attribute_name, String const& old_value)
 {
-    // FIXME: Only invalidate if the attribute can actually affect style.
-    (void)attribute_name;
+    auto const& style_computer = document().style_computer();
 
     // FIXME: This will need to become smarter when we implement the :has() selector.
-    invalidate_style();
+    auto invalidation_set = style_computer.invalidation_set_for_attribute(attribute_name);
+
+    if (attribute_name == HTML::AttributeNames::class_) {
+        // Only the classes that were added or removed can change which rules match.
+        auto old_classes = old_value.split_view(Infra::is_ascii_whitespace);
+        for (auto const& class_name : old_classes) {
+            if (!m_classes.contains_slow(class_name))
+                invalidation_set.include(style_computer.invalidation_set_for_class(class_name));
+        }
+        for (auto const& class_name : m_classes) {
+            if (!old_classes.contains_slow(class_name.view()))
+                invalidation_set.include(style_computer.invalidation_set_for_class(class_name));
+        }
+    } else if (attribute_name == HTML::AttributeNames::id) {
+        if (!old_value.is_null())
+            invalidation_set.include(style_computer.invalidation_set_for_id(old_value));
+        if (auto new_value = get_attribute(HTML::AttributeNames::id); !new_value.is_null())
+            invalidation_set.include(style_computer.invalidation_set_for_id(new_value));
+    } else if (!attribute_name.starts_with("data-"sv) && !attribute_name.starts_with("aria-"sv)) {
+        // NOTE: Other attributes may be presentational hints, which only affect the element itself.
+        invalidation_set.invalidates_self = true;
+    }
+
+    if (invalidation_set.invalidates_descendants)
+        invalidate_style();
+    else if (invalidation_set.invalidates_self)
+        set_needs_style_update(true);
+
+    if (invalidation_set.invalidates_subsequent_siblings) {
+        for (auto* sibling = next_sibling(); sibling; sibling = sibling->next_sibling())
+            sibling->invalidate_style();
+    }
 }
 
 }
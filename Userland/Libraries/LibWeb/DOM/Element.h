@@ -112,6 +112,7 @@ public:
     String name() const { return attribute(HTML::AttributeNames::name); }
 
     CSS::StyleProperties const* computed_css_values() const { return m_computed_css_values.ptr(); }
+    CSS::StyleProperties* computed_css_values() { return m_computed_css_values.ptr(); }
     void set_computed_css_values(RefPtr<CSS::StyleProperties> style) { m_computed_css_values = move(style); }
     NonnullRefPtr<CSS::StyleProperties> resolved_css_values();
 
@@ -189,7 +190,7 @@ protected:
 private:
     void make_html_uppercased_qualified_name();
 
-    void invalidate_style_after_attribute_change(FlyString const& attribute_name);
+    void invalidate_style_after_attribute_change(FlyString const& attribute_name, String const& old_value);
 
     WebIDL::ExceptionOr<JS::GCPtr<Node>> insert_adjacent(String const& where, JS::NonnullGCPtr<Node> node);
 
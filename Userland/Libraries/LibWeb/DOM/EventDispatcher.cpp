@@ -109,7 +109,12 @@ bool EventDispatcher::inner_invoke(Event& event, Vector<JS::Handle<DOM::DOMEvent
         // FIXME: These should be wrapped for us in call_user_object_operation, but it currently doesn't do that.
         auto* this_value = event.current_target().ptr();
         auto* wrapped_event = &event;
-        auto result = WebIDL::call_user_object_operation(callback, "handleEvent", this_value, wrapped_event);
+        auto result = [&] {
+            Optional<TimingScope> timing_scope;
+            if (auto document = callback.callback_context.responsible_document())
+                timing_scope.emplace(*document, TimingPhase::JavaScript);
+            return WebIDL::call_user_object_operation(callback, "handleEvent", this_value, wrapped_event);
+        }();
 
         // If this throws an exception, then:
         if (result.is_error()) {
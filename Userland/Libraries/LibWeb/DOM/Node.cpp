@@ -13,6 +13,7 @@
 #include <LibJS/Runtime/FunctionObject.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
 #include <LibWeb/Bindings/NodePrototype.h>
+#include <LibWeb/CSS/StyleComputer.h>
 #include <LibWeb/DOM/Comment.h>
 #include <LibWeb/DOM/DocumentType.h>
 #include <LibWeb/DOM/Element.h>
@@ -458,8 +459,13 @@ void Node::insert_before(JS::NonnullGCPtr<Node> node, JS::GCPtr<Node> child, boo
     // 9. Run the children changed steps for parent.
     children_changed();
 
+    // NOTE: The inserted nodes have already been marked as needing a style update.
+    //       Their new siblings only need one if some selector looks at the position of elements among their siblings.
     // FIXME: This will need to become smarter when we implement the :has() selector.
-    invalidate_style();
+    if (document().style_computer().has_structural_selectors())
+        invalidate_style();
+
+    document().invalidate_layout_subtree(*this);
 }
 
 // https://dom.spec.whatwg.org/#concept-node-pre-insert
@@ -611,7 +617,10 @@ void Node::remove(bool suppress_observers)
     // 21. Run the children changed steps for parent.
     parent->children_changed();
 
-    document().invalidate_layout();
+    if (document().style_computer().has_structural_selectors())
+        parent->invalidate_style();
+
+    document().invalidate_layout_subtree(*parent);
 }
 
 // https://dom.spec.whatwg.org/#concept-node-replace
@@ -840,6 +849,11 @@ void Node::detach_layout_node(Badge<DOM::Document>)
     m_layout_node = nullptr;
 }
 
+void Node::detach_layout_node(Badge<Layout::TreeBuilder>)
+{
+    m_layout_node = nullptr;
+}
+
 EventTarget* Node::get_parent(Event const&)
 {
     // FIXME: returns the node’s assigned slot, if node is assigned, and node’s parent otherwise.
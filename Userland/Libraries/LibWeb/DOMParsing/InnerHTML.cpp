@@ -52,9 +52,8 @@ WebIDL::ExceptionOr<void> inner_html_setter(JS::NonnullGCPtr<DOM::Node> context_
     if (!is<HTML::HTMLTemplateElement>(*context_object)) {
         context_object->set_needs_style_update(true);
 
-        // NOTE: Since the DOM has changed, we have to rebuild the layout tree.
-        context_object->document().invalidate_layout();
-        context_object->document().set_needs_layout();
+        // NOTE: Since the DOM has changed, we have to rebuild the layout tree below the context object.
+        context_object->document().invalidate_layout_subtree(*context_object);
     }
 
     return {};
@@ -451,6 +451,7 @@ class NodeWithStyleAndBoxModelMetrics;
 class RadioButton;
 class ReplacedBox;
 class TextNode;
+class TreeBuilder;
 }
 
 namespace Web {
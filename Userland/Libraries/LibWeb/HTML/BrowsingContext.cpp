@@ -370,15 +370,16 @@ void BrowsingContext::set_needs_display()
 
 void BrowsingContext::set_needs_display(Gfx::IntRect const& rect)
 {
-    if (!viewport_rect().intersects(rect))
-        return;
-
+    // NOTE: The page client may hold on to painted content outside the viewport, so it gets to hear about everything.
     if (is_top_level()) {
         if (m_page)
             m_page->client().page_did_invalidate(to_top_level_rect(rect));
         return;
     }
 
+    if (!viewport_rect().intersects(rect))
+        return;
+
     if (container() && container()->layout_node())
         container()->layout_node()->set_needs_display();
 }
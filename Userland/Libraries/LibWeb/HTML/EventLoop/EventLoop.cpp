@@ -214,6 +214,9 @@ void EventLoop::process()
         //    perform the start an idle period algorithm for win with computeDeadline. [REQUESTIDLECALLBACK]
         for (auto& win : same_loop_windows())
             win->start_an_idle_period();
+
+        // NOTE: Nothing is waiting on us right now, so this is a good time to collect garbage instead of in the middle of the next task.
+        vm().heap().collect_garbage_if_idle_collection_is_worthwhile();
     }
 
     // FIXME: 14. If this is a worker event loop, then:
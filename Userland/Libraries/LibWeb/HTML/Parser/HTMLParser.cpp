@@ -27,10 +27,12 @@
 #include <LibWeb/HTML/Parser/HTMLEncodingDetection.h>
 #include <LibWeb/HTML/Parser/HTMLParser.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
+#include <LibWeb/HTML/Parser/PreloadScanner.h>
 #include <LibWeb/HTML/Window.h>
 #include <LibWeb/HighResolutionTime/TimeOrigin.h>
 #include <LibWeb/Infra/CharacterTypes.h>
 #include <LibWeb/Namespace.h>
+#include <LibWeb/Platform/Timer.h>
 #include <LibWeb/SVG/TagNames.h>
 
 namespace Web::HTML {
@@ -162,11 +164,23 @@ void HTMLParser::visit_edges(Cell::Visitor& visitor)
 
 void HTMLParser::run()
 {
+    DOM::TimingScope timing_scope(*m_document, DOM::TimingPhase::Parse);
+
+    size_t tokens_until_deadline_check = 0;
     for (;;) {
         // FIXME: Find a better way to say that we come from Document::close() and want to process EOF.
         if (!m_tokenizer.is_eof_inserted() && m_tokenizer.is_insertion_point_reached())
             return;
 
+        // NOTE: Looking at the clock for every token would be a waste of time, most of them are processed very quickly.
+        if (m_slice_deadline.has_value() && tokens_until_deadline_check-- == 0) {
+            tokens_until_deadline_check = 64;
+            if (should_yield_to_event_loop()) {
+                m_yielded_to_event_loop = true;
+                break;
+            }
+        }
+
         auto optional_token = m_tokenizer.next_token();
         if (!optional_token.has_value())
             break;
@@ -216,6 +230,52 @@ void HTMLParser::run(const AK::URL& url)
     m_document->detach_parser({});
 }
 
+// NOTE: This is long enough to get through most documents in one go, and short enough to get something on screen early for the rest.
+static constexpr i64 parsing_slice_duration_in_milliseconds = 25;
+
+void HTMLParser::run_in_slices(const AK::URL& url, Function<void()> on_finished)
+{
+    m_document->set_url(url);
+    m_document->set_source(m_tokenizer.source());
+    m_on_finished_parsing_in_slices = move(on_finished);
+    m_continue_parsing_timer = Platform::Timer::create_single_shot(0, [this] {
+        continue_parsing_in_slices();
+    });
+    continue_parsing_in_slices();
+}
+
+void HTMLParser::continue_parsing_in_slices()
+{
+    // NOTE: If a script (e.g. in a timer) aborted us while we weren't looking, the document has moved on without us.
+    if (m_aborted)
+        return;
+
+    m_yielded_to_event_loop = false;
+    m_slice_deadline = Time::now_monotonic() + Time::from_milliseconds(parsing_slice_duration_in_milliseconds);
+    run();
+    m_slice_deadline = {};
+
+    if (m_yielded_to_event_loop) {
+        m_continue_parsing_timer->start();
+        return;
+    }
+
+    the_end();
+    m_document->detach_parser({});
+
+    if (auto on_finished = move(m_on_finished_parsing_in_slices))
+        on_finished();
+}
+
+bool HTMLParser::should_yield_to_event_loop() const
+{
+    // We can only leave at points where nobody further up the stack expects us to be done, e.g. not while running a script,
+    // and not while processing a document.write().
+    if (m_parsing_fragment || m_invoked_via_document_write || m_script_nesting_level > 0 || m_stop_parsing)
+        return false;
+    return Time::now_monotonic() >= m_slice_deadline.value();
+}
+
 // https://html.spec.whatwg.org/multipage/parsing.html#the-end
 void HTMLParser::the_end()
 {
@@ -2282,6 +2342,13 @@ void HTMLParser::handle_text(HTMLToken& token)
                 // that is blocking scripts and the script's "ready to be parser-executed"
                 // flag is set.
                 if (m_document->has_a_style_sheet_that_is_blocking_scripts() || !script->is_ready_to_be_parser_executed()) {
+                    // NOTE: We can't get anywhere until the script has loaded, so let's start loading what comes after it.
+                    if (!m_has_run_preload_scanner && !m_parsing_fragment) {
+                        m_has_run_preload_scanner = true;
+                        PreloadScanner preload_scanner(*m_document, m_tokenizer.remaining_input());
+                        preload_scanner.scan();
+                    }
+
                     main_thread_event_loop().spin_until([&] {
                         return !m_document->has_a_style_sheet_that_is_blocking_scripts() && script->is_ready_to_be_parser_executed();
                     });
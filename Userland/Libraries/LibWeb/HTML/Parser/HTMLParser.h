@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Function.h>
+#include <AK/Time.h>
 #include <LibJS/Heap/Cell.h>
 #include <LibWeb/DOM/Node.h>
 #include <LibWeb/HTML/Parser/HTMLTokenizer.h>
@@ -54,6 +56,11 @@ public:
     void run();
     void run(const AK::URL&);
 
+    // Like run(), but every now and then the parser returns to the event loop and picks up where it left off afterwards,
+    // so that big documents can be styled, laid out and painted (and stay responsive) before they've been parsed completely.
+    // on_finished is called once the whole document has been parsed, unless the parser was aborted on the way.
+    void run_in_slices(const AK::URL&, Function<void()> on_finished);
+
     DOM::Document& document();
 
     static Vector<JS::Handle<DOM::Node>> parse_html_fragment(DOM::Element& context_element, StringView);
@@ -114,6 +121,8 @@ private:
     void handle_after_after_frameset(HTMLToken&);
 
     void the_end();
+    void continue_parsing_in_slices();
+    bool should_yield_to_event_loop() const;
 
     void stop_parsing() { m_stop_parsing = true; }
 
@@ -183,6 +192,12 @@ private:
     bool m_aborted { false };
     bool m_parser_pause_flag { false };
     bool m_stop_parsing { false };
+    bool m_has_run_preload_scanner { false };
+
+    Optional<Time> m_slice_deadline;
+    bool m_yielded_to_event_loop { false };
+    RefPtr<Platform::Timer> m_continue_parsing_timer;
+    Function<void()> m_on_finished_parsing_in_slices;
     size_t m_script_nesting_level { 0 };
 
     JS::Realm& realm();
@@ -124,6 +124,7 @@ public:
     bool is_blocked() const { return m_blocked; }
 
     String source() const { return m_decoded_input; }
+    StringView remaining_input() const { return m_decoded_input.substring_view(m_utf8_view.byte_offset_of(m_utf8_iterator)); }
 
     void insert_input_at_insertion_point(String const& input);
     void insert_eof();
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/PreloadScanner.h>
+#include <LibWeb/HTML/TagNames.h>
+#include <LibWeb/Infra/CharacterTypes.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWeb/MimeSniff/MimeType.h>
+
+namespace Web::HTML {
+
+PreloadScanner::PreloadScanner(DOM::Document& document, StringView input)
+    : m_document(document)
+    , m_tokenizer(input, "utf-8"sv)
+{
+}
+
+void PreloadScanner::scan()
+{
+    for (;;) {
+        auto token = m_tokenizer.next_token();
+        if (!token.has_value() || token->is_end_of_file())
+            break;
+        if (token->is_start_tag())
+            process_start_tag(*token);
+    }
+    dbgln_if(HTML_PARSER_DEBUG, "PreloadScanner: Started {} preload(s)", m_preload_count);
+}
+
+void PreloadScanner::process_start_tag(HTMLToken& token)
+{
+    auto const& tag_name = token.tag_name();
+
+    if (tag_name == TagNames::script) {
+        // NOTE: Without the tree builder, nobody switches the tokenizer to the right state for the contents of these elements.
+        m_tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+
+        if (!m_document.is_scripting_enabled())
+            return;
+        auto src = token.attribute(AttributeNames::src);
+        if (src.is_empty())
+            return;
+        // FIXME: Preload module scripts too, they are fetched differently.
+        auto type = token.attribute(AttributeNames::type).trim(Infra::ASCII_WHITESPACE);
+        if (!type.is_empty() && !MimeSniff::is_javascript_mime_type_essence_match(type))
+            return;
+        preload(src, false);
+        return;
+    }
+
+    if (tag_name.is_one_of(TagNames::style, TagNames::xmp, TagNames::iframe, TagNames::noembed, TagNames::noframes)
+        || (tag_name == TagNames::noscript && m_document.is_scripting_enabled())) {
+        m_tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        return;
+    }
+
+    if (tag_name.is_one_of(TagNames::textarea, TagNames::title)) {
+        m_tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+        return;
+    }
+
+    if (tag_name == TagNames::plaintext) {
+        m_tokenizer.switch_to(HTMLTokenizer::State::PLAINTEXT);
+        return;
+    }
+
+    if (tag_name == TagNames::link) {
+        auto href = token.attribute(AttributeNames::href);
+        if (href.is_empty())
+            return;
+        bool is_stylesheet = false;
+        bool is_alternate = false;
+        for (auto part : token.attribute(AttributeNames::rel).split_view_if(Infra::is_ascii_whitespace)) {
+            if (part.equals_ignoring_case("stylesheet"sv))
+                is_stylesheet = true;
+            else if (part.equals_ignoring_case("alternate"sv))
+                is_alternate = true;
+        }
+        if (is_stylesheet && !is_alternate)
+            preload(href, false);
+        return;
+    }
+
+    if (tag_name == TagNames::img) {
+        // FIXME: Pick a source from srcset, like the image element would.
+        auto src = token.attribute(AttributeNames::src);
+        if (!src.is_empty())
+            preload(src, true);
+        return;
+    }
+}
+
+void PreloadScanner::preload(StringView url_string, bool is_image)
+{
+    // FIXME: Take <base> elements we come across into account.
+    auto url = m_document.parse_url(url_string);
+    if (!url.is_valid())
+        return;
+
+    // NOTE: ResourceLoader doesn't cache file:// resources, so we'd only end up loading them twice.
+    if (url.scheme().is_one_of("file"sv, "data"sv))
+        return;
+
+    auto request = LoadRequest::create_for_url_on_page(url, m_document.page());
+    // NOTE: The resource cache holds on to the resource, which is how the element will find it.
+    (void)ResourceLoader::the().load_resource(is_image ? Resource::Type::Image : Resource::Type::Generic, request);
+    ++m_preload_count;
+}
+
+}
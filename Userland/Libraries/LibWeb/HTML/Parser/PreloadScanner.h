@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/StringView.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+
+namespace Web::HTML {
+
+// While the parser waits for a parser-blocking script, this looks ahead at the input it hasn't parsed yet,
+// and starts loading the scripts, style sheets and images it finds. When the parser gets to those elements,
+// ResourceLoader hands out the resources that are already (being) loaded instead of starting from scratch.
+// NOTE: This only looks at tokens, so it can't know about anything a script might do to the document.
+class PreloadScanner {
+public:
+    PreloadScanner(DOM::Document&, StringView input);
+
+    void scan();
+
+private:
+    void process_start_tag(HTMLToken&);
+    void preload(StringView url, bool is_image);
+
+    DOM::Document& m_document;
+    HTMLTokenizer m_tokenizer;
+    size_t m_preload_count { 0 };
+};
+
+}
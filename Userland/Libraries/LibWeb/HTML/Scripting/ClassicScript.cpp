@@ -8,6 +8,7 @@
 #include <LibCore/ElapsedTimer.h>
 #include <LibJS/Interpreter.h>
 #include <LibWeb/Bindings/ExceptionOrUtils.h>
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/HTML/Scripting/ClassicScript.h>
 #include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/HTML/Scripting/ExceptionReporter.h>
@@ -93,6 +94,9 @@ JS::Completion ClassicScript::run(RethrowErrors rethrow_errors)
         evaluation_status = vm.throw_completion<JS::SyntaxError>(m_error_to_rethrow.value().to_string());
     } else {
         auto timer = Core::ElapsedTimer::start_new();
+        Optional<DOM::TimingScope> timing_scope;
+        if (auto document = settings.responsible_document())
+            timing_scope.emplace(*document, DOM::TimingPhase::JavaScript);
 
         // 6. Otherwise, set evaluationStatus to ScriptEvaluation(script's record).
         auto interpreter = JS::Interpreter::create_with_existing_realm(m_script_record->realm());
@@ -5,6 +5,7 @@
  */
 
 #include <LibJS/Interpreter.h>
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/HTML/Scripting/Fetching.h>
 #include <LibWeb/HTML/Scripting/ModuleScript.h>
@@ -132,6 +133,10 @@ JS::Promise* JavaScriptModuleScript::run(PreventErrorReporting)
         auto interpreter = JS::Interpreter::create_with_existing_realm(settings.realm());
         JS::VM::InterpreterExecutionScope scope(*interpreter);
 
+        Optional<DOM::TimingScope> timing_scope;
+        if (auto document = settings.responsible_document())
+            timing_scope.emplace(*document, DOM::TimingPhase::JavaScript);
+
         // 2. Set evaluationPromise to record.Evaluate().
         auto elevation_promise_or_error = record->evaluate(vm());
 
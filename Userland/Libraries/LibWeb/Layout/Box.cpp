@@ -29,6 +29,13 @@ Box::~Box()
 {
 }
 
+IntrinsicSizes& Box::cached_intrinsic_sizes() const
+{
+    if (!m_cached_intrinsic_sizes)
+        m_cached_intrinsic_sizes = make<IntrinsicSizes>();
+    return *m_cached_intrinsic_sizes;
+}
+
 void Box::set_needs_display()
 {
     if (paint_box())
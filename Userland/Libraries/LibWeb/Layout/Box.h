@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Layout/Node.h>
@@ -17,6 +18,22 @@ struct LineBoxFragmentCoordinate {
     size_t fragment_index { 0 };
 };
 
+// Intrinsic sizes only depend on the contents of a box, so they are kept around across layouts until something in the box's
+// subtree needs layout again. This avoids computing them over and over when flex and grid layouts nest.
+struct IntrinsicSizes {
+    Optional<float> min_content_width;
+    Optional<float> max_content_width;
+
+    // NOTE: Since intrinsic heights depend on the amount of available width, we have to cache
+    //       three separate kinds of results, depending on the available width at the time of calculation.
+    HashMap<float, Optional<float>> min_content_height_with_definite_available_width;
+    HashMap<float, Optional<float>> max_content_height_with_definite_available_width;
+    Optional<float> min_content_height_with_min_content_available_width;
+    Optional<float> max_content_height_with_min_content_available_width;
+    Optional<float> min_content_height_with_max_content_available_width;
+    Optional<float> max_content_height_with_max_content_available_width;
+};
+
 class Box : public NodeWithStyleAndBoxModelMetrics {
     JS_CELL(Box, NodeWithStyleAndBoxModelMetrics);
 
@@ -35,6 +52,9 @@ public:
     bool has_intrinsic_height() const { return intrinsic_height().has_value(); }
     bool has_intrinsic_aspect_ratio() const { return intrinsic_aspect_ratio().has_value(); }
 
+    IntrinsicSizes& cached_intrinsic_sizes() const;
+    void invalidate_cached_intrinsic_sizes() const { m_cached_intrinsic_sizes = nullptr; }
+
     virtual ~Box() override;
 
     virtual void did_set_rect() { }
@@ -47,6 +67,8 @@ protected:
 
 private:
     virtual bool is_box() const final { return true; }
+
+    mutable OwnPtr<IntrinsicSizes> m_cached_intrinsic_sizes;
 };
 
 template<>
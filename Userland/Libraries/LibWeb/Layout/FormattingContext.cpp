@@ -1102,14 +1102,14 @@ float FormattingContext::calculate_fit_content_height(Layout::Box const& box, Av
     return calculate_max_content_height(box, available_space.width);
 }
 
+static constexpr size_t max_cached_heights_per_box = 16;
+
 float FormattingContext::calculate_min_content_width(Layout::Box const& box) const
 {
     if (box.has_intrinsic_width())
         return *box.intrinsic_width();
 
-    auto& root_state = m_state.m_root;
-
-    auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
+    auto& cache = box.cached_intrinsic_sizes();
     if (cache.min_content_width.has_value())
         return *cache.min_content_width;
 
@@ -1145,9 +1145,7 @@ float FormattingContext::calculate_max_content_width(Layout::Box const& box) con
     if (box.has_intrinsic_width())
         return *box.intrinsic_width();
 
-    auto& root_state = m_state.m_root;
-
-    auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
+    auto& cache = box.cached_intrinsic_sizes();
     if (cache.max_content_width.has_value())
         return *cache.max_content_width;
 
@@ -1186,9 +1184,11 @@ float FormattingContext::calculate_min_content_height(Layout::Box const& box, Av
     bool is_cacheable = available_width.is_definite() || available_width.is_intrinsic_sizing_constraint();
     Optional<float>* cache_slot = nullptr;
     if (is_cacheable) {
-        auto& root_state = m_state.m_root;
-        auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
+        auto& cache = box.cached_intrinsic_sizes();
         if (available_width.is_definite()) {
+            // NOTE: The cache lives across layouts now, so don't let it collect every width the box has ever been given.
+            if (cache.min_content_height_with_definite_available_width.size() >= max_cached_heights_per_box)
+                cache.min_content_height_with_definite_available_width.clear();
             cache_slot = &cache.min_content_height_with_definite_available_width.ensure(available_width.to_px());
         } else if (available_width.is_min_content()) {
             cache_slot = &cache.min_content_height_with_min_content_available_width;
@@ -1231,9 +1231,11 @@ float FormattingContext::calculate_max_content_height(Layout::Box const& box, Av
     bool is_cacheable = available_width.is_definite() || available_width.is_intrinsic_sizing_constraint();
     Optional<float>* cache_slot = nullptr;
     if (is_cacheable) {
-        auto& root_state = m_state.m_root;
-        auto& cache = *root_state.intrinsic_sizes.ensure(&box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); });
+        auto& cache = box.cached_intrinsic_sizes();
         if (available_width.is_definite()) {
+            // NOTE: The cache lives across layouts now, so don't let it collect every width the box has ever been given.
+            if (cache.max_content_height_with_definite_available_width.size() >= max_cached_heights_per_box)
+                cache.max_content_height_with_definite_available_width.clear();
             cache_slot = &cache.max_content_height_with_definite_available_width.ensure(available_width.to_px());
         } else if (available_width.is_min_content()) {
             cache_slot = &cache.max_content_height_with_min_content_available_width;
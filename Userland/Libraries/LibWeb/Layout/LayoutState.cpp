@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/Layout/AvailableSpace.h>
 #include <LibWeb/Layout/BlockContainer.h>
 #include <LibWeb/Layout/LayoutState.h>
@@ -57,12 +58,16 @@ void LayoutState::commit()
     VERIFY(!m_parent);
 
     HashTable<Layout::TextNode*> text_nodes;
+    DOM::Document* document = nullptr;
+    size_t committed_node_count = 0;
 
     for (auto& used_values_ptr : used_values_per_layout_node) {
         if (!used_values_ptr)
             continue;
         auto& used_values = *used_values_ptr;
         auto& node = const_cast<NodeWithStyleAndBoxModelMetrics&>(used_values.node());
+        document = &node.document();
+        ++committed_node_count;
 
         // Transfer box model metrics.
         node.box_model().inset = { used_values.inset_top, used_values.inset_right, used_values.inset_bottom, used_values.inset_left };
@@ -95,6 +100,9 @@ void LayoutState::commit()
 
     for (auto* text_node : text_nodes)
         text_node->set_paintable(text_node->create_paintable());
+
+    if (document)
+        document->timings().did_commit_layout_nodes(committed_node_count + text_nodes.size());
 }
 
 Gfx::FloatRect margin_box_rect(Box const& box, LayoutState const& state)
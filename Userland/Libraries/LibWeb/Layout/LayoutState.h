@@ -155,24 +155,6 @@ struct LayoutState {
 
     Vector<OwnPtr<UsedValues>> used_values_per_layout_node;
 
-    // We cache intrinsic sizes once determined, as they will not change over the course of a full layout.
-    // This avoids computing them several times while performing flex layout.
-    struct IntrinsicSizes {
-        Optional<float> min_content_width;
-        Optional<float> max_content_width;
-
-        // NOTE: Since intrinsic heights depend on the amount of available width, we have to cache
-        //       three separate kinds of results, depending on the available width at the time of calculation.
-        HashMap<float, Optional<float>> min_content_height_with_definite_available_width;
-        HashMap<float, Optional<float>> max_content_height_with_definite_available_width;
-        Optional<float> min_content_height_with_min_content_available_width;
-        Optional<float> max_content_height_with_min_content_available_width;
-        Optional<float> min_content_height_with_max_content_available_width;
-        Optional<float> max_content_height_with_max_content_available_width;
-    };
-
-    HashMap<NodeWithStyleAndBoxModelMetrics const*, NonnullOwnPtr<IntrinsicSizes>> mutable intrinsic_sizes;
-
     LayoutState const* m_parent { nullptr };
     LayoutState const& m_root;
 };
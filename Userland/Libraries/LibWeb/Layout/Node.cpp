@@ -14,6 +14,7 @@
 #include <LibWeb/Layout/InitialContainingBlock.h>
 #include <LibWeb/Layout/Node.h>
 #include <LibWeb/Layout/TextNode.h>
+#include <LibWeb/Painting/PaintableBox.h>
 #include <LibWeb/Platform/FontPlugin.h>
 
 namespace Web::Layout {
@@ -151,6 +152,14 @@ InitialContainingBlock& Node::root()
 
 void Node::set_needs_display()
 {
+    // NOTE: Block-level boxes don't have fragments in their containing block, so we go by what their own paintable covers.
+    if (is<Box>(*this)) {
+        if (auto const* paint_box = static_cast<Box const&>(*this).paint_box()) {
+            browsing_context().set_needs_display(enclosing_int_rect(paint_box->absolute_paint_rect()));
+            return;
+        }
+    }
+
     auto* containing_block = this->containing_block();
     if (!containing_block)
         return;
@@ -164,6 +173,32 @@ void Node::set_needs_display()
     });
 }
 
+void Node::set_needs_layout()
+{
+    m_needs_layout = true;
+    // NOTE: The intrinsic sizes of all our ancestors may depend on us. Ancestors that already knew about a change below them
+    //       have had their caches dropped back then, and nothing could have filled them again without a layout in between.
+    if (is<Box>(*this))
+        static_cast<Box const&>(*this).invalidate_cached_intrinsic_sizes();
+    for (auto* ancestor = parent(); ancestor && !ancestor->m_child_needs_layout; ancestor = ancestor->parent()) {
+        ancestor->m_child_needs_layout = true;
+        if (is<Box>(*ancestor))
+            static_cast<Box const&>(*ancestor).invalidate_cached_intrinsic_sizes();
+    }
+    document().schedule_layout_update();
+}
+
+void Node::clear_needs_layout_in_subtree()
+{
+    if (m_child_needs_layout) {
+        for_each_child([](auto& child) {
+            child.clear_needs_layout_in_subtree();
+        });
+    }
+    m_needs_layout = false;
+    m_child_needs_layout = false;
+}
+
 Gfx::FloatPoint Node::box_type_agnostic_position() const
 {
     if (is<Box>(*this))
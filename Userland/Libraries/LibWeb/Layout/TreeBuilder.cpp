@@ -236,10 +236,18 @@ void TreeBuilder::create_layout_tree(DOM::Node& dom_node, TreeBuilder::Context&
         insert_node_into_inline_or_block_ancestor(*layout_node, display, AppendOrPrepend::Append);
     }
 
+    create_layout_tree_for_contents(dom_node, *layout_node, context);
+}
+
+void TreeBuilder::create_layout_tree_for_contents(DOM::Node& dom_node, Layout::Node& layout_node, TreeBuilder::Context& context)
+{
+    auto& document = dom_node.document();
+    auto& style_computer = document.style_computer();
+
     auto* shadow_root = is<DOM::Element>(dom_node) ? verify_cast<DOM::Element>(dom_node).shadow_root() : nullptr;
 
-    if ((dom_node.has_children() || shadow_root) && layout_node->can_have_children()) {
-        push_parent(verify_cast<NodeWithStyle>(*layout_node));
+    if ((dom_node.has_children() || shadow_root) && layout_node.can_have_children()) {
+        push_parent(verify_cast<NodeWithStyle>(layout_node));
         if (shadow_root)
             create_layout_tree(*shadow_root, context);
         verify_cast<DOM::ParentNode>(dom_node).for_each_child([&](auto& dom_child) {
@@ -251,20 +259,20 @@ void TreeBuilder::create_layout_tree(DOM::Node& dom_node, TreeBuilder::Context&
     // Add nodes for the ::before and ::after pseudo-elements.
     if (is<DOM::Element>(dom_node)) {
         auto& element = static_cast<DOM::Element&>(dom_node);
-        push_parent(verify_cast<NodeWithStyle>(*layout_node));
+        push_parent(verify_cast<NodeWithStyle>(layout_node));
         create_pseudo_element_if_needed(element, CSS::Selector::PseudoElement::Before, AppendOrPrepend::Prepend);
         create_pseudo_element_if_needed(element, CSS::Selector::PseudoElement::After, AppendOrPrepend::Append);
         pop_parent();
     }
 
-    if (is<ListItemBox>(*layout_node)) {
+    if (is<ListItemBox>(layout_node)) {
         auto& element = static_cast<DOM::Element&>(dom_node);
-        int child_index = layout_node->parent()->index_of_child<ListItemBox>(*layout_node).value();
+        int child_index = layout_node.parent()->index_of_child<ListItemBox>(layout_node).value();
         auto marker_style = style_computer.compute_style(element, CSS::Selector::PseudoElement::Marker);
-        auto list_item_marker = document.heap().allocate_without_realm<ListItemMarkerBox>(document, layout_node->computed_values().list_style_type(), child_index + 1, *marker_style);
-        static_cast<ListItemBox&>(*layout_node).set_marker(list_item_marker);
+        auto list_item_marker = document.heap().allocate_without_realm<ListItemMarkerBox>(document, layout_node.computed_values().list_style_type(), child_index + 1, *marker_style);
+        static_cast<ListItemBox&>(layout_node).set_marker(list_item_marker);
         element.set_pseudo_element_node({}, CSS::Selector::PseudoElement::Marker, list_item_marker);
-        layout_node->append_child(*list_item_marker);
+        layout_node.append_child(*list_item_marker);
     }
 
     if (is<HTML::HTMLProgressElement>(dom_node)) {
@@ -280,7 +288,7 @@ void TreeBuilder::create_layout_tree(DOM::Node& dom_node, TreeBuilder::Context&
             auto value_display = value_style->display();
             auto progress_bar = DOM::Element::create_layout_node_for_display_type(document, bar_display, bar_style, nullptr);
             auto progress_value = DOM::Element::create_layout_node_for_display_type(document, value_display, value_style, nullptr);
-            push_parent(verify_cast<NodeWithStyle>(*layout_node));
+            push_parent(verify_cast<NodeWithStyle>(layout_node));
             push_parent(verify_cast<NodeWithStyle>(*progress_bar));
             insert_node_into_inline_or_block_ancestor(*progress_value, value_display, AppendOrPrepend::Append);
             pop_parent();
@@ -305,6 +313,68 @@ JS::GCPtr<Layout::Node> TreeBuilder::build(DOM::Node& dom_node)
     return move(m_layout_root);
 }
 
+static bool can_rebuild_subtree_in_place(Layout::Node const& layout_node)
+{
+    // NOTE: The children of a flow block don't affect how it is itself inserted into its parent,
+    //       so its box can stay where it is while everything inside it is regenerated.
+    if (!is<BlockContainer>(layout_node) || layout_node.is_anonymous() || !layout_node.parent())
+        return false;
+
+    auto display = layout_node.display();
+    if (!display.is_block_outside() || !(display.is_flow_inside() || display.is_flow_root_inside()))
+        return false;
+
+    // SVG subtrees are built with knowledge of their SVG root, which we don't bother recovering here.
+    for (auto const* ancestor = layout_node.parent(); ancestor; ancestor = ancestor->parent()) {
+        if (ancestor->is_svg_box())
+            return false;
+    }
+    return true;
+}
+
+bool TreeBuilder::rebuild_subtree(DOM::Element& element)
+{
+    // If the element isn't rendered (anymore), there is nothing to rebuild.
+    if (!element.is_connected())
+        return true;
+    auto* layout_node = element.layout_node();
+    if (!layout_node)
+        return true;
+    auto* root = element.document().layout_node();
+    for (auto* ancestor = layout_node->parent(); ancestor != root; ancestor = ancestor->parent()) {
+        if (!ancestor)
+            return true;
+    }
+
+    if (!can_rebuild_subtree_in_place(*layout_node))
+        return false;
+
+    auto& block_container = verify_cast<BlockContainer>(*layout_node);
+
+    // Detach the old contents, making sure that no DOM node keeps pointing into them.
+    Vector<JS::Handle<Layout::Node>> old_children;
+    for (auto* child = block_container.first_child(); child; child = child->next_sibling())
+        old_children.append(*child);
+    for (auto& child : old_children) {
+        block_container.remove_child(*child);
+        child->for_each_in_inclusive_subtree([&](auto& old_layout_node) {
+            if (auto* dom_node = old_layout_node.dom_node(); dom_node && !old_layout_node.is_anonymous() && dom_node->layout_node() == &old_layout_node)
+                dom_node->detach_layout_node(Badge<TreeBuilder> {});
+            return IterationDecision::Continue;
+        });
+    }
+    block_container.set_children_are_inline(false);
+    element.clear_pseudo_element_nodes({});
+
+    Context context;
+    create_layout_tree_for_contents(element, block_container, context);
+
+    fixup_tables(block_container);
+
+    block_container.set_needs_layout();
+    return true;
+}
+
 template<CSS::Display::Internal internal, typename Callback>
 void TreeBuilder::for_each_in_tree_with_internal_display(NodeWithStyle& root, Callback callback)
 {
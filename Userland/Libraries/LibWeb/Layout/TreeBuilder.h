@@ -19,12 +19,17 @@ public:
 
     JS::GCPtr<Layout::Node> build(DOM::Node&);
 
+    // Regenerates the contents of the element's layout box, leaving the box itself in place.
+    // Returns false if that isn't possible, in which case the whole tree has to be rebuilt.
+    bool rebuild_subtree(DOM::Element&);
+
 private:
     struct Context {
         bool has_svg_root = false;
     };
 
     void create_layout_tree(DOM::Node&, Context&);
+    void create_layout_tree_for_contents(DOM::Node&, Layout::Node&, Context&);
 
     void push_parent(Layout::NodeWithStyle& node) { m_ancestor_stack.append(node); }
     void pop_parent() { m_ancestor_stack.take_last(); }
@@ -179,26 +179,34 @@ static bool build_xml_document(DOM::Document& document, ByteBuffer const& data)
     return !result.is_error() && !builder.has_error();
 }
 
-bool FrameLoader::parse_document(DOM::Document& document, ByteBuffer const& data)
+bool FrameLoader::parse_document(DOM::Document& document, ByteBuffer const& data, Function<void()> on_finished)
 {
     auto& mime_type = document.content_type();
     if (mime_type == "text/html" || mime_type == "image/svg+xml") {
+        // NOTE: The parser yields to the event loop every now and then, so the page can be painted while it's still being parsed.
         auto parser = HTML::HTMLParser::create_with_uncertain_encoding(document, data);
-        parser->run(document.url());
+        parser->run_in_slices(document.url(), move(on_finished));
         return true;
     }
-    if (mime_type.ends_with("+xml"sv) || mime_type.is_one_of("text/xml", "application/xml"))
-        return build_xml_document(document, data);
-    if (mime_type.starts_with("image/"sv))
-        return build_image_document(document, data);
-    if (mime_type == "text/plain" || mime_type == "application/json")
-        return build_text_document(document, data);
-    if (mime_type == "text/markdown")
-        return build_markdown_document(document, data);
-    if (mime_type == "text/gemini")
-        return build_gemini_document(document, data);
-
-    return false;
+
+    auto build_document = [&] {
+        if (mime_type.ends_with("+xml"sv) || mime_type.is_one_of("text/xml", "application/xml"))
+            return build_xml_document(document, data);
+        if (mime_type.starts_with("image/"sv))
+            return build_image_document(document, data);
+        if (mime_type == "text/plain" || mime_type == "application/json")
+            return build_text_document(document, data);
+        if (mime_type == "text/markdown")
+            return build_markdown_document(document, data);
+        if (mime_type == "text/gemini")
+            return build_gemini_document(document, data);
+        return false;
+    };
+
+    if (!build_document())
+        return false;
+    on_finished();
+    return true;
 }
 
 bool FrameLoader::load(LoadRequest& request, Type type)
@@ -233,6 +241,8 @@ bool FrameLoader::load(LoadRequest& request, Type type)
     if (!request.headers().contains("Accept"))
         request.set_header("Accept", "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8");
 
+    // Nothing else on the page can load before the document itself does.
+    request.set_priority(LoadRequest::Priority::High);
     set_resource(ResourceLoader::the().load_resource(Resource::Type::Generic, request));
 
     if (type == Type::IFrame)
@@ -448,18 +458,24 @@ void FrameLoader::resource_did_load()
     if (auto* page = browsing_context().page())
         page->client().page_did_create_main_document();
 
-    if (!parse_document(*document, resource()->encoded_data())) {
+    auto on_finished_parsing = [url, document = JS::make_handle(*document), browsing_context = JS::make_handle(browsing_context())]() mutable {
+        // The browsing context may have navigated somewhere else while we were parsing.
+        if (browsing_context->active_document() != document.ptr())
+            return;
+
+        if (!url.fragment().is_empty())
+            browsing_context->scroll_to_anchor(url.fragment());
+        else
+            browsing_context->scroll_to({ 0, 0 });
+
+        if (auto* page = browsing_context->page())
+            page->client().page_did_finish_loading(url);
+    };
+
+    if (!parse_document(*document, resource()->encoded_data(), move(on_finished_parsing))) {
         load_error_page(url, "Failed to parse content.");
         return;
     }
-
-    if (!url.fragment().is_empty())
-        browsing_context().scroll_to_anchor(url.fragment());
-    else
-        browsing_context().scroll_to({ 0, 0 });
-
-    if (auto* page = browsing_context().page())
-        page->client().page_did_finish_loading(url);
 }
 
 void FrameLoader::resource_did_fail()
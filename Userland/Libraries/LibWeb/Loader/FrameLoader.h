@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Forward.h>
+#include <AK/Function.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/Loader/Resource.h>
 
@@ -44,7 +45,7 @@ private:
 
     void load_error_page(const AK::URL& failed_url, String const& error_message);
     void load_favicon(RefPtr<Gfx::Bitmap> bitmap = nullptr);
-    bool parse_document(DOM::Document&, ByteBuffer const& data);
+    bool parse_document(DOM::Document&, ByteBuffer const& data, Function<void()> on_finished);
 
     void store_response_cookies(AK::URL const& url, String const& cookies);
 
@@ -18,6 +18,13 @@ namespace Web {
 
 class LoadRequest {
 public:
+    // Decides which requests go first when more of them are waiting for a connection to a host than it can take at once.
+    enum class Priority {
+        Low,
+        Normal,
+        High,
+    };
+
     LoadRequest()
     {
     }
@@ -35,6 +42,9 @@ public:
     ByteBuffer const& body() const { return m_body; }
     void set_body(ByteBuffer body) { m_body = move(body); }
 
+    Priority priority() const { return m_priority; }
+    void set_priority(Priority priority) { m_priority = priority; }
+
     void start_timer() { m_load_timer.start(); };
     Time load_time() const { return m_load_timer.elapsed_time(); }
 
@@ -73,6 +83,7 @@ private:
     String m_method { "GET" };
     HashMap<String, String, CaseInsensitiveStringTraits> m_headers;
     ByteBuffer m_body;
+    Priority m_priority { Priority::Normal };
     Core::ElapsedTimer m_load_timer;
     Optional<Page&> m_page;
 };
@@ -28,6 +28,17 @@ ResourceLoaderConnectorRequest::ResourceLoaderConnectorRequest() = default;
 
 ResourceLoaderConnectorRequest::~ResourceLoaderConnectorRequest() = default;
 
+void ResourceLoaderConnectorRequest::set_unbuffered_request_callbacks(HeadersReceived on_headers_received, DataReceived on_data_received, RequestFinished on_finish)
+{
+    on_buffered_request_finish = [on_headers_received = move(on_headers_received), on_data_received = move(on_data_received), on_finish = move(on_finish)](bool success, u32 total_size, auto& response_headers, auto response_code, ReadonlyBytes payload) {
+        on_headers_received(response_headers, response_code);
+        if (!payload.is_empty())
+            on_data_received(payload);
+        on_finish(success, total_size);
+    };
+    set_should_buffer_all_input(true);
+}
+
 ResourceLoaderConnector::ResourceLoaderConnector() = default;
 
 ResourceLoaderConnector::~ResourceLoaderConnector() = default;
@@ -101,6 +112,10 @@ RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, LoadRequest&
         }
     }
 
+    // Images are usually not needed to lay out the page, so anything else that's waiting for a connection goes first.
+    if (type == Resource::Type::Image && request.priority() == LoadRequest::Priority::Normal)
+        request.set_priority(LoadRequest::Priority::Low);
+
     auto resource = Resource::create({}, type, request);
 
     if (use_cache)
@@ -264,17 +279,7 @@ void ResourceLoader::load(LoadRequest& request, Function<void(ReadonlyBytes, Has
     }
 
     if (url.scheme() == "http" || url.scheme() == "https" || url.scheme() == "gemini") {
-        auto proxy = ProxyMappings::the().proxy_for_url(url);
-
-        HashMap<String, String> headers;
-        headers.set("User-Agent", m_user_agent);
-        headers.set("Accept-Encoding", "gzip, deflate, br");
-
-        for (auto& it : request.headers()) {
-            headers.set(it.key, it.value);
-        }
-
-        auto protocol_request = m_connector->start_request(request.method(), url, headers, request.body(), proxy);
+        auto protocol_request = start_network_request(request);
         if (!protocol_request) {
             auto start_request_failure_msg = "Failed to initiate load"sv;
             log_failure(request, start_request_failure_msg);
@@ -332,6 +337,104 @@ void ResourceLoader::load(LoadRequest& request, Function<void(ReadonlyBytes, Has
         error_callback(not_implemented_error, {});
 }
 
+void ResourceLoader::load_unbuffered(LoadRequest& request, OnHeadersReceived on_headers_received, OnDataReceived on_data_received, OnComplete on_complete)
+{
+    auto& url = request.url();
+    request.start_timer();
+
+    auto id = resource_id++;
+    auto url_for_logging = sanitized_url_for_logging(url);
+    emit_signpost(String::formatted("Starting unbuffered load: {}", url_for_logging), id);
+    dbgln("ResourceLoader: Starting unbuffered load of: \"{}\"", url_for_logging);
+
+    auto const log_success = [url_for_logging, id](auto const& request) {
+        auto load_time_ms = request.load_time().to_milliseconds();
+        emit_signpost(String::formatted("Finished unbuffered load: {}", url_for_logging), id);
+        dbgln("ResourceLoader: Finished unbuffered load of: \"{}\", Duration: {}ms", url_for_logging, load_time_ms);
+    };
+
+    auto const log_failure = [url_for_logging, id](auto const& request, auto const error_message) {
+        auto load_time_ms = request.load_time().to_milliseconds();
+        emit_signpost(String::formatted("Failed unbuffered load: {}", url_for_logging), id);
+        dbgln("ResourceLoader: Failed unbuffered load of: \"{}\", \033[31;1mError: {}\033[0m, Duration: {}ms", url_for_logging, error_message, load_time_ms);
+    };
+
+    if (!url.scheme().is_one_of("http"sv, "https"sv, "gemini"sv)) {
+        // Anything that isn't coming from the network is small or local enough to not be worth streaming.
+        auto not_implemented_error = "Unbuffered loads are only supported for network requests"sv;
+        log_failure(request, not_implemented_error);
+        on_complete(false, not_implemented_error);
+        return;
+    }
+
+    if (is_port_blocked(url.port_or_default())) {
+        auto port_blocked_error = String::formatted("The port #{} is blocked", url.port_or_default());
+        log_failure(request, port_blocked_error);
+        on_complete(false, port_blocked_error.view());
+        return;
+    }
+
+    if (ContentFilter::the().is_filtered(url)) {
+        auto filter_message = "URL was filtered"sv;
+        log_failure(request, filter_message);
+        on_complete(false, filter_message);
+        return;
+    }
+
+    auto protocol_request = start_network_request(request);
+    if (!protocol_request) {
+        auto start_request_failure_msg = "Failed to initiate load"sv;
+        log_failure(request, start_request_failure_msg);
+        on_complete(false, start_request_failure_msg);
+        return;
+    }
+
+    m_active_requests.set(*protocol_request);
+
+    auto on_request_finished = [this, log_success, log_failure, request, &protocol_request = *protocol_request, on_complete = move(on_complete)](bool success, u32) {
+        --m_pending_loads;
+        if (on_load_counter_change)
+            on_load_counter_change();
+
+        if (success) {
+            log_success(request);
+            on_complete(true, {});
+        } else {
+            auto load_failed_msg = "Load failed"sv;
+            log_failure(request, load_failed_msg);
+            on_complete(false, load_failed_msg);
+        }
+
+        Platform::EventLoopPlugin::the().deferred_invoke([this, &protocol_request] {
+            m_active_requests.remove(protocol_request);
+        });
+    };
+
+    protocol_request->set_unbuffered_request_callbacks(move(on_headers_received), move(on_data_received), move(on_request_finished));
+    protocol_request->on_certificate_requested = []() -> ResourceLoaderConnectorRequest::CertificateAndKey {
+        return {};
+    };
+
+    ++m_pending_loads;
+    if (on_load_counter_change)
+        on_load_counter_change();
+}
+
+RefPtr<ResourceLoaderConnectorRequest> ResourceLoader::start_network_request(LoadRequest const& request)
+{
+    auto proxy = ProxyMappings::the().proxy_for_url(request.url());
+
+    HashMap<String, String> headers;
+    headers.set("User-Agent", m_user_agent);
+    headers.set("Accept-Encoding", "gzip, deflate, br");
+
+    for (auto& it : request.headers()) {
+        headers.set(it.key, it.value);
+    }
+
+    return m_connector->start_request(request.method(), request.url(), headers, request.body(), proxy, request.priority());
+}
+
 void ResourceLoader::load(const AK::URL& url, Function<void(ReadonlyBytes, HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> status_code)> success_callback, Function<void(String const&, Optional<u32> status_code)> error_callback, Optional<u32> timeout, Function<void()> timeout_callback)
 {
     LoadRequest request;
@@ -13,6 +13,7 @@
 #include <AK/URL.h>
 #include <LibCore/Object.h>
 #include <LibCore/Proxy.h>
+#include <LibWeb/Loader/LoadRequest.h>
 #include <LibWeb/Loader/Resource.h>
 #include <LibWeb/Page/Page.h>
 
@@ -58,11 +59,19 @@ public:
         String key;
     };
 
+    using HeadersReceived = Function<void(HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code)>;
+    using DataReceived = Function<void(ReadonlyBytes data)>;
+    using RequestFinished = Function<void(bool success, u32 total_size)>;
+
     virtual void set_should_buffer_all_input(bool) = 0;
     virtual bool stop() = 0;
 
     virtual void stream_into(Core::Stream::Stream&) = 0;
 
+    // Hands the body over piece by piece as it arrives. Connectors that can't do that deliver it in one piece once it's complete.
+    // Note: Will override `on_buffered_request_finish' and `on_finish'.
+    virtual void set_unbuffered_request_callbacks(HeadersReceived, DataReceived, RequestFinished);
+
     Function<void(bool success, u32 total_size, HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code, ReadonlyBytes payload)> on_buffered_request_finish;
     Function<void(bool success, u32 total_size)> on_finish;
     Function<void(Optional<u32> total_size, u32 downloaded_size)> on_progress;
@@ -79,7 +88,10 @@ public:
     virtual void prefetch_dns(AK::URL const&) = 0;
     virtual void preconnect(AK::URL const&) = 0;
 
-    virtual RefPtr<ResourceLoaderConnectorRequest> start_request(String const& method, AK::URL const&, HashMap<String, String> const& request_headers = {}, ReadonlyBytes request_body = {}, Core::ProxyData const& = {}) = 0;
+    virtual RefPtr<ResourceLoaderConnectorRequest> start_request(String const& method, AK::URL const&, HashMap<String, String> const& request_headers = {}, ReadonlyBytes request_body = {}, Core::ProxyData const& = {}, LoadRequest::Priority = LoadRequest::Priority::Normal) = 0;
+
+    // A description of what the connections to each host are busy with, and why requests had to wait for them.
+    virtual String connection_pool_statistics() = 0;
 
 protected:
     explicit ResourceLoaderConnector();
@@ -96,6 +108,13 @@ public:
     void load(LoadRequest&, Function<void(ReadonlyBytes, HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> status_code)> success_callback, Function<void(String const&, Optional<u32> status_code)> error_callback = nullptr, Optional<u32> timeout = {}, Function<void()> timeout_callback = nullptr);
     void load(const AK::URL&, Function<void(ReadonlyBytes, HashMap<String, String, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> status_code)> success_callback, Function<void(String const&, Optional<u32> status_code)> error_callback = nullptr, Optional<u32> timeout = {}, Function<void()> timeout_callback = nullptr);
 
+    using OnHeadersReceived = ResourceLoaderConnectorRequest::HeadersReceived;
+    using OnDataReceived = ResourceLoaderConnectorRequest::DataReceived;
+    using OnComplete = Function<void(bool success, Optional<StringView> error_message)>;
+
+    // Like load(), but without ever holding on to the whole body. Only works for network requests.
+    void load_unbuffered(LoadRequest&, OnHeadersReceived, OnDataReceived, OnComplete);
+
     ResourceLoaderConnector& connector() { return *m_connector; }
 
     void prefetch_dns(AK::URL const&);
@@ -117,6 +136,8 @@ private:
 
     static bool is_port_blocked(int port);
 
+    RefPtr<ResourceLoaderConnectorRequest> start_network_request(LoadRequest const&);
+
     int m_pending_loads { 0 };
 
     HashTable<NonnullRefPtr<ResourceLoaderConnectorRequest>> m_active_requests;
@@ -6,6 +6,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/HashMap.h>
 #include <AK/NumericLimits.h>
 #include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
@@ -18,6 +20,80 @@
 
 namespace Web::Painting {
 
+// Pages tend to use the same few box-shadows over and over (every button, card or menu), so we keep the blurred bitmaps around.
+// They only depend on the shape of the shadow, its color and how much it is blurred, not on where it ends up being painted.
+class BoxShadowBitmapCache {
+public:
+    struct Key {
+        Gfx::IntSize size;
+        Gfx::Color color;
+        int blur_radius { 0 };
+        Array<int, 8> corner_radii {};
+
+        bool operator==(Key const&) const = default;
+    };
+
+    static BoxShadowBitmapCache& the()
+    {
+        static BoxShadowBitmapCache s_the;
+        return s_the;
+    }
+
+    RefPtr<Gfx::Bitmap> get(Key const& key)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return nullptr;
+        it->value.last_used = ++m_use_counter;
+        return it->value.bitmap;
+    }
+
+    void set(Key const& key, NonnullRefPtr<Gfx::Bitmap> bitmap)
+    {
+        auto size_in_bytes = bitmap->size_in_bytes();
+        if (size_in_bytes > max_size_in_bytes / 4)
+            return;
+        while (!m_entries.is_empty() && (m_entries.size() >= max_entry_count || m_size_in_bytes + size_in_bytes > max_size_in_bytes))
+            evict_least_recently_used();
+        m_size_in_bytes += size_in_bytes;
+        m_entries.set(key, { move(bitmap), ++m_use_counter });
+    }
+
+private:
+    static constexpr size_t max_entry_count = 64;
+    static constexpr size_t max_size_in_bytes = 16 * MiB;
+
+    struct KeyTraits : public GenericTraits<Key> {
+        static unsigned hash(Key const& key)
+        {
+            auto hash = pair_int_hash(pair_int_hash(key.size.width(), key.size.height()), pair_int_hash(key.color.value(), key.blur_radius));
+            for (auto radius : key.corner_radii)
+                hash = pair_int_hash(hash, radius);
+            return hash;
+        }
+    };
+
+    struct Entry {
+        NonnullRefPtr<Gfx::Bitmap> bitmap;
+        u64 last_used { 0 };
+    };
+
+    void evict_least_recently_used()
+    {
+        auto least_recently_used = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->value.last_used < least_recently_used->value.last_used)
+                least_recently_used = it;
+        }
+        m_size_in_bytes -= least_recently_used->value.bitmap->size_in_bytes();
+        m_entries.remove(least_recently_used);
+    }
+
+    HashMap<Key, Entry, KeyTraits> m_entries;
+    size_t m_size_in_bytes { 0 };
+    u64 m_use_counter { 0 };
+};
+
 void paint_box_shadow(PaintContext& context, Gfx::IntRect const& content_rect, BorderRadiiData const& border_radii, Vector<ShadowData> const& box_shadow_layers)
 {
     if (box_shadow_layers.is_empty())
@@ -156,18 +232,33 @@ void paint_box_shadow(PaintContext& context, Gfx::IntRect const& content_rect, B
         Gfx::IntRect top_edge_rect { top_left_corner_rect.width(), 0, 1, horizontal_top_edge_width };
         Gfx::IntRect bottom_edge_rect { bottom_left_corner_rect.width(), shadow_bitmap_rect.height() - horizontal_edge_width, 1, horizontal_edge_width };
 
-        auto shadows_bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, shadow_bitmap_rect.size());
-        if (shadows_bitmap.is_error()) {
-            dbgln("Unable to allocate temporary bitmap {} for box-shadow rendering: {}", shadow_bitmap_rect, shadows_bitmap.error());
-            return;
-        }
-        auto shadow_bitmap = shadows_bitmap.release_value();
-        Gfx::Painter corner_painter { *shadow_bitmap };
-        Gfx::AntiAliasingPainter aa_corner_painter { corner_painter };
+        BoxShadowBitmapCache::Key cache_key {
+            .size = shadow_bitmap_rect.size(),
+            .color = box_shadow_data.color,
+            .blur_radius = blur_radius,
+            .corner_radii = {
+                top_left_shadow_corner.horizontal_radius, top_left_shadow_corner.vertical_radius,
+                top_right_shadow_corner.horizontal_radius, top_right_shadow_corner.vertical_radius,
+                bottom_right_shadow_corner.horizontal_radius, bottom_right_shadow_corner.vertical_radius,
+                bottom_left_shadow_corner.horizontal_radius, bottom_left_shadow_corner.vertical_radius },
+        };
 
-        aa_corner_painter.fill_rect_with_rounded_corners(shadow_bitmap_rect.shrunken(double_radius, double_radius, double_radius, double_radius), box_shadow_data.color, top_left_shadow_corner, top_right_shadow_corner, bottom_right_shadow_corner, bottom_left_shadow_corner);
-        Gfx::StackBlurFilter filter(*shadow_bitmap);
-        filter.process_rgba(blur_radius, box_shadow_data.color);
+        auto shadow_bitmap = BoxShadowBitmapCache::the().get(cache_key);
+        if (!shadow_bitmap) {
+            auto shadows_bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, shadow_bitmap_rect.size());
+            if (shadows_bitmap.is_error()) {
+                dbgln("Unable to allocate temporary bitmap {} for box-shadow rendering: {}", shadow_bitmap_rect, shadows_bitmap.error());
+                return;
+            }
+            shadow_bitmap = shadows_bitmap.release_value();
+            Gfx::Painter corner_painter { *shadow_bitmap };
+            Gfx::AntiAliasingPainter aa_corner_painter { corner_painter };
+
+            aa_corner_painter.fill_rect_with_rounded_corners(shadow_bitmap_rect.shrunken(double_radius, double_radius, double_radius, double_radius), box_shadow_data.color, top_left_shadow_corner, top_right_shadow_corner, bottom_right_shadow_corner, bottom_left_shadow_corner);
+            Gfx::StackBlurFilter filter(*shadow_bitmap);
+            filter.process_rgba(blur_radius, box_shadow_data.color);
+            BoxShadowBitmapCache::the().set(cache_key, *shadow_bitmap);
+        }
 
         auto paint_shadow_infill = [&] {
             if (!border_radii.has_any_radius())
@@ -238,22 +329,22 @@ void paint_box_shadow(PaintContext& context, Gfx::IntRect const& content_rect, B
             paint_shadow_infill();
 
             // Corners
-            painter.blit(top_left_corner_blit_pos, shadow_bitmap, top_left_corner_rect);
-            painter.blit(top_right_corner_blit_pos, shadow_bitmap, top_right_corner_rect);
-            painter.blit(bottom_left_corner_blit_pos, shadow_bitmap, bottom_left_corner_rect);
-            painter.blit(bottom_right_corner_blit_pos, shadow_bitmap, bottom_right_corner_rect);
+            painter.blit(top_left_corner_blit_pos, *shadow_bitmap, top_left_corner_rect);
+            painter.blit(top_right_corner_blit_pos, *shadow_bitmap, top_right_corner_rect);
+            painter.blit(bottom_left_corner_blit_pos, *shadow_bitmap, bottom_left_corner_rect);
+            painter.blit(bottom_right_corner_blit_pos, *shadow_bitmap, bottom_right_corner_rect);
 
             // Horizontal edges
             for (auto x = inner_bounding_rect.left() + (bottom_left_corner_size.width() - double_radius); x <= inner_bounding_rect.right() - (bottom_right_corner_size.width() - double_radius); ++x)
-                painter.blit({ x, bottom_start }, shadow_bitmap, bottom_edge_rect);
+                painter.blit({ x, bottom_start }, *shadow_bitmap, bottom_edge_rect);
             for (auto x = inner_bounding_rect.left() + (top_left_corner_size.width() - double_radius); x <= inner_bounding_rect.right() - (top_right_corner_size.width() - double_radius); ++x)
-                painter.blit({ x, top_start }, shadow_bitmap, top_edge_rect);
+                painter.blit({ x, top_start }, *shadow_bitmap, top_edge_rect);
 
             // Vertical edges
             for (auto y = inner_bounding_rect.top() + (top_right_corner_size.height() - double_radius); y <= inner_bounding_rect.bottom() - (bottom_right_corner_size.height() - double_radius); ++y)
-                painter.blit({ right_start, y }, shadow_bitmap, right_edge_rect);
+                painter.blit({ right_start, y }, *shadow_bitmap, right_edge_rect);
             for (auto y = inner_bounding_rect.top() + (top_left_corner_size.height() - double_radius); y <= inner_bounding_rect.bottom() - (bottom_left_corner_size.height() - double_radius); ++y)
-                painter.blit({ left_start, y }, shadow_bitmap, left_edge_rect);
+                painter.blit({ left_start, y }, *shadow_bitmap, left_edge_rect);
         };
 
         // FIXME: Painter only lets us define a clip-rect which discards drawing outside of it, whereas here we want
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibGfx/Painter.h>
+#include <LibWeb/Painting/TileCache.h>
+
+namespace Web::Painting {
+
+static int tile_index_for_coordinate(int coordinate)
+{
+    // NOTE: Rounds towards negative infinity, so content at negative coordinates ends up in the right tile too.
+    if (coordinate < 0)
+        return (coordinate - TileCache::tile_size + 1) / TileCache::tile_size;
+    return coordinate / TileCache::tile_size;
+}
+
+Gfx::IntRect TileCache::rect_for_tile(Gfx::IntPoint const& tile_index)
+{
+    return { tile_index.x() * tile_size, tile_index.y() * tile_size, tile_size, tile_size };
+}
+
+void TileCache::paint(Gfx::Bitmap& target, Gfx::IntRect const& content_rect, PaintCallback const& paint_content)
+{
+    if (content_rect.is_empty())
+        return;
+
+    Gfx::Painter painter(target);
+    size_t reused_tile_count = 0;
+    size_t painted_tile_count = 0;
+    Vector<CompositeJob> composite_jobs;
+    Vector<Gfx::IntRect> repainted_tile_rects;
+
+    auto first_column = tile_index_for_coordinate(content_rect.left());
+    auto last_column = tile_index_for_coordinate(content_rect.right());
+    auto first_row = tile_index_for_coordinate(content_rect.top());
+    auto last_row = tile_index_for_coordinate(content_rect.bottom());
+
+    for (int row = first_row; row <= last_row; ++row) {
+        for (int column = first_column; column <= last_column; ++column) {
+            Gfx::IntPoint tile_index { column, row };
+            auto tile_rect = rect_for_tile(tile_index);
+            auto destination_rect = tile_rect.translated(-content_rect.location());
+
+            auto& tile = m_tiles.ensure(tile_index);
+            if (!tile.bitmap) {
+                auto bitmap_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { tile_size, tile_size });
+                if (bitmap_or_error.is_error()) {
+                    // We can still paint this part of the page, just not keep it around.
+                    m_tiles.remove(tile_index);
+                    Gfx::PainterStateSaver saver(painter);
+                    painter.add_clip_rect(destination_rect);
+                    painter.translate(destination_rect.location());
+                    paint_content(painter, tile_rect);
+                    ++painted_tile_count;
+                    continue;
+                }
+                tile.bitmap = bitmap_or_error.release_value();
+                tile.needs_repaint = true;
+            }
+
+            if (tile.needs_repaint) {
+                Gfx::Painter tile_painter(*tile.bitmap);
+                paint_content(tile_painter, tile_rect);
+                tile.needs_repaint = false;
+                repainted_tile_rects.append(destination_rect);
+                ++painted_tile_count;
+            } else {
+                ++reused_tile_count;
+            }
+
+            composite_jobs.append({ destination_rect.location(), tile.bitmap.ptr() });
+        }
+    }
+
+    // The compositor copies pixels as they are, which only works if the target looks just like our tiles.
+    bool can_use_compositor = m_compositor && target.format() == Gfx::BitmapFormat::BGRx8888 && target.scale() == 1;
+    if (can_use_compositor) {
+        m_compositor(target, composite_jobs);
+    } else {
+        for (auto const& job : composite_jobs)
+            painter.blit(job.destination, *job.tile, job.tile->rect());
+    }
+
+    if (m_should_show_debug_overlay) {
+        for (auto const& job : composite_jobs)
+            painter.draw_rect({ job.destination, job.tile->size() }, Color::Green);
+        for (auto const& rect : repainted_tile_rects)
+            painter.draw_rect(rect, Color::Red);
+    }
+
+    dbgln_if(TILE_CACHE_DEBUG, "TileCache: Painted {}, reused {} tile(s) for {}", painted_tile_count, reused_tile_count, content_rect);
+
+    evict_tiles_outside(content_rect);
+}
+
+void TileCache::invalidate(Gfx::IntRect const& content_rect)
+{
+    for (auto& it : m_tiles) {
+        if (rect_for_tile(it.key).intersects(content_rect))
+            it.value.needs_repaint = true;
+    }
+}
+
+void TileCache::evict_tiles_outside(Gfx::IntRect const& content_rect)
+{
+    // NOTE: Tiles within one viewport of the one we just painted are kept for when the user scrolls back and forth.
+    auto rect_to_keep = content_rect.inflated(content_rect.width() * 2, content_rect.height() * 2);
+    m_tiles.remove_all_matching([&](auto const& tile_index, auto const&) {
+        return !rect_for_tile(tile_index).intersects(rect_to_keep);
+    });
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Forward.h>
+#include <LibGfx/Point.h>
+#include <LibGfx/Rect.h>
+
+namespace Web::Painting {
+
+// Keeps the page rasterized in fixed-size tiles (in content coordinates), so that a repaint only has to paint the tiles
+// that were invalidated since the last time. When scrolling, most of the new viewport is made up of tiles we already have.
+class TileCache {
+public:
+    static constexpr int tile_size = 256;
+
+    // Paints the content in the given rect (in content coordinates) into the painter, whose translation must be zero.
+    using PaintCallback = Function<void(Gfx::Painter&, Gfx::IntRect const& content_rect)>;
+
+    void paint(Gfx::Bitmap& target, Gfx::IntRect const& content_rect, PaintCallback const&);
+
+    struct CompositeJob {
+        Gfx::IntPoint destination;
+        Gfx::Bitmap const* tile { nullptr };
+    };
+
+    // Copies finished tiles into the target bitmap. The jobs never overlap, so they can be carried out in parallel.
+    // NOTE: Painting the tiles has to happen on the main thread, since it looks at the layout tree.
+    using Compositor = Function<void(Gfx::Bitmap& target, Vector<CompositeJob> const&)>;
+    void set_compositor(Compositor compositor) { m_compositor = move(compositor); }
+
+    void invalidate(Gfx::IntRect const& content_rect);
+    void invalidate_all() { m_tiles.clear(); }
+
+    // Outlines the tiles of each painted frame: green ones were reused, red ones had to be painted.
+    void set_should_show_debug_overlay(bool value) { m_should_show_debug_overlay = value; }
+
+    size_t tile_count() const { return m_tiles.size(); }
+
+private:
+    struct Tile {
+        RefPtr<Gfx::Bitmap> bitmap;
+        bool needs_repaint { true };
+    };
+
+    static Gfx::IntRect rect_for_tile(Gfx::IntPoint const& tile_index);
+    void evict_tiles_outside(Gfx::IntRect const& content_rect);
+
+    HashMap<Gfx::IntPoint, Tile> m_tiles;
+    Compositor m_compositor;
+    bool m_should_show_debug_overlay { false };
+};
+
+}
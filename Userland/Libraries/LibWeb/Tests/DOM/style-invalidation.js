@@ -0,0 +1,92 @@
+describe("style invalidation", () => {
+    loadLocalPage("/res/html/misc/blank.html");
+
+    afterInitialPageLoad(page => {
+        const document = page.document;
+        const style = document.createElement("style");
+        style.textContent = `
+            .hidden { display: none; }
+            #hidden-by-id { display: none; }
+            [data-hidden] { display: none; }
+            .hides-children > div { display: none; }
+            .hides-next + div { display: none; }
+            .hides-later ~ div { display: none; }
+            div:first-child.first-is-hidden { display: none; }
+        `;
+        document.head.appendChild(style);
+
+        const display = element => page.getComputedStyle(element).display;
+
+        test("changing the class of an element", () => {
+            const div = document.createElement("div");
+            document.body.appendChild(div);
+            expect(display(div)).toBe("block");
+            div.className = "hidden";
+            expect(display(div)).toBe("none");
+            div.classList.remove("hidden");
+            expect(display(div)).toBe("block");
+            div.className = "hidden";
+            div.removeAttribute("class");
+            expect(display(div)).toBe("block");
+            div.remove();
+        });
+
+        test("changing the id and other attributes of an element", () => {
+            const div = document.createElement("div");
+            document.body.appendChild(div);
+            div.id = "hidden-by-id";
+            expect(display(div)).toBe("none");
+            div.id = "not-hidden";
+            expect(display(div)).toBe("block");
+            div.setAttribute("data-hidden", "");
+            expect(display(div)).toBe("none");
+            div.toggleAttribute("data-hidden");
+            expect(display(div)).toBe("block");
+            div.remove();
+        });
+
+        test("descendant and sibling combinators", () => {
+            const parent = document.createElement("div");
+            const first = document.createElement("div");
+            const second = document.createElement("div");
+            const third = document.createElement("div");
+            parent.append(first, second, third);
+            document.body.appendChild(parent);
+
+            parent.className = "hides-children";
+            expect(display(parent)).toBe("block");
+            expect(display(first)).toBe("none");
+            expect(display(third)).toBe("none");
+            parent.className = "";
+            expect(display(first)).toBe("block");
+
+            first.className = "hides-next";
+            expect(display(second)).toBe("none");
+            expect(display(third)).toBe("block");
+            first.className = "hides-later";
+            expect(display(second)).toBe("none");
+            expect(display(third)).toBe("none");
+            first.className = "";
+            expect(display(third)).toBe("block");
+            parent.remove();
+        });
+
+        test("inserting and removing siblings", () => {
+            const parent = document.createElement("div");
+            const child = document.createElement("div");
+            child.className = "first-is-hidden";
+            parent.appendChild(child);
+            document.body.appendChild(parent);
+            expect(display(child)).toBe("none");
+
+            const new_first_child = document.createElement("div");
+            parent.insertBefore(new_first_child, child);
+            expect(display(child)).toBe("block");
+            new_first_child.remove();
+            expect(display(child)).toBe("none");
+            parent.remove();
+        });
+    });
+
+    waitForPageToLoad();
+});
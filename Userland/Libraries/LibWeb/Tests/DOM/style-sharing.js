@@ -0,0 +1,54 @@
+describe("style sharing between siblings", () => {
+    loadLocalPage("/res/html/misc/blank.html");
+
+    afterInitialPageLoad(page => {
+        const document = page.document;
+        const style = document.createElement("style");
+        style.textContent = `
+            .item { display: inline; }
+            .item.hidden { display: none; }
+            [data-block] { display: block; }
+        `;
+        document.head.appendChild(style);
+
+        const display = element => page.getComputedStyle(element).display;
+
+        test("siblings that look alike", () => {
+            const list = document.createElement("div");
+            for (let i = 0; i < 4; ++i) {
+                const item = document.createElement("span");
+                item.className = "item";
+                list.appendChild(item);
+            }
+            document.body.appendChild(list);
+            for (const item of list.children) expect(display(item)).toBe("inline");
+
+            list.children[1].classList.add("hidden");
+            expect(display(list.children[0])).toBe("inline");
+            expect(display(list.children[1])).toBe("none");
+            expect(display(list.children[2])).toBe("inline");
+            list.remove();
+        });
+
+        test("siblings that differ in attributes or inline style", () => {
+            const list = document.createElement("div");
+            const first = document.createElement("span");
+            const second = document.createElement("span");
+            const third = document.createElement("span");
+            first.className = "item";
+            second.className = "item";
+            second.setAttribute("data-block", "");
+            third.className = "item";
+            third.style.display = "flex";
+            list.append(first, second, third);
+            document.body.appendChild(list);
+
+            expect(display(first)).toBe("inline");
+            expect(display(second)).toBe("block");
+            expect(display(third)).toBe("flex");
+            list.remove();
+        });
+    });
+
+    waitForPageToLoad();
+});
@@ -49,7 +49,13 @@ JS_DEFINE_NATIVE_FUNCTION(WebAssemblyMemoryPrototype::buffer_getter)
     if (!memory)
         return JS::js_undefined();
 
-    auto* array_buffer = JS::ArrayBuffer::create(realm, &memory->data());
+    // Note: The memory may move around in the store, or (when it isn't guard paged) within its ByteBuffer as it grows,
+    //       so it's looked up again whenever the buffer is accessed.
+    auto* array_buffer = JS::ArrayBuffer::create(realm, [address] {
+        auto* memory = WebAssemblyObject::s_abstract_machine.store().get(address);
+        VERIFY(memory);
+        return memory->data();
+    });
     array_buffer->set_detach_key(JS::js_string(vm, "WebAssembly.Memory"));
     return array_buffer;
 }
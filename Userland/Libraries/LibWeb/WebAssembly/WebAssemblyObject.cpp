@@ -11,6 +11,7 @@
 #include "WebAssemblyModulePrototype.h"
 #include "WebAssemblyTableObject.h"
 #include "WebAssemblyTablePrototype.h"
+#include <AK/AnyOf.h>
 #include <AK/ScopeGuard.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/ArrayBuffer.h>
@@ -120,13 +121,13 @@ JS::ThrowCompletionOr<size_t> parse_module(JS::VM& vm, JS::Object* buffer_object
     ReadonlyBytes data;
     if (is<JS::ArrayBuffer>(buffer_object)) {
         auto& buffer = static_cast<JS::ArrayBuffer&>(*buffer_object);
-        data = buffer.buffer();
+        data = buffer.bytes();
     } else if (is<JS::TypedArrayBase>(buffer_object)) {
         auto& buffer = static_cast<JS::TypedArrayBase&>(*buffer_object);
-        data = buffer.viewed_array_buffer()->buffer().span().slice(buffer.byte_offset(), buffer.byte_length());
+        data = buffer.viewed_array_buffer()->bytes().slice(buffer.byte_offset(), buffer.byte_length());
     } else if (is<JS::DataView>(buffer_object)) {
         auto& buffer = static_cast<JS::DataView&>(*buffer_object);
-        data = buffer.viewed_array_buffer()->buffer().span().slice(buffer.byte_offset(), buffer.byte_length());
+        data = buffer.viewed_array_buffer()->bytes().slice(buffer.byte_offset(), buffer.byte_length());
     } else {
         return vm.throw_completion<JS::TypeError>("Not a BufferSource");
     }
@@ -175,6 +176,14 @@ JS_DEFINE_NATIVE_FUNCTION(WebAssemblyObject::compile)
     return promise;
 }
 
+// https://webassembly.github.io/spec/js-api/#exported-function-exotic-objects
+// Functions that take or return vectors can't be called from JavaScript, nor call into it.
+static bool has_vector_type(Wasm::FunctionType const& type)
+{
+    auto is_vector = [](auto& type) { return type.is_vector(); };
+    return any_of(type.parameters(), is_vector) || any_of(type.results(), is_vector);
+}
+
 JS::ThrowCompletionOr<size_t> WebAssemblyObject::instantiate_module(JS::VM& vm, Wasm::Module const& module)
 {
     Wasm::Linker linker { module };
@@ -209,6 +218,9 @@ JS::ThrowCompletionOr<size_t> WebAssemblyObject::instantiate_module(JS::VM& vm,
                     //        just extract its address and resolve to that.
                     Wasm::HostFunction host_function {
                         [&](auto&, auto& arguments) -> Wasm::Result {
+                            if (has_vector_type(type))
+                                return Wasm::Trap();
+
                             JS::MarkedVector<JS::Value> argument_values { vm.heap() };
                             for (auto& entry : arguments)
                                 argument_values.append(to_js_value(vm, entry));
@@ -381,6 +393,9 @@ JS::Value to_js_value(JS::VM& vm, Wasm::Value& wasm_value)
         return create_native_function(vm, wasm_value.to<Wasm::Reference::Func>().value().address, "FIXME_IHaveNoIdeaWhatThisShouldBeCalled");
     case Wasm::ValueType::NullFunctionReference:
         return JS::js_null();
+    case Wasm::ValueType::V128:
+        // Callers make sure no vectors are passed to JavaScript, see has_vector_type().
+        VERIFY_NOT_REACHED();
     case Wasm::ValueType::ExternReference:
     case Wasm::ValueType::NullExternReference:
         TODO();
@@ -429,6 +444,8 @@ JS::ThrowCompletionOr<Wasm::Value> to_webassembly_value(JS::VM& vm, JS::Value va
 
         return vm.throw_completion<JS::TypeError>(JS::ErrorType::NotAnObjectOfType, "Exported function");
     }
+    case Wasm::ValueType::V128:
+        return vm.throw_completion<JS::TypeError>("Cannot convert a value to v128");
     case Wasm::ValueType::ExternReference:
     case Wasm::ValueType::NullExternReference:
         TODO();
@@ -450,6 +467,9 @@ JS::NativeFunction* create_native_function(JS::VM& vm, Wasm::FunctionAddress add
         name,
         [address, type = type.release_value()](JS::VM& vm) -> JS::ThrowCompletionOr<JS::Value> {
             auto& realm = *vm.current_realm();
+            if (has_vector_type(type))
+                return vm.throw_completion<JS::TypeError>("Exported function takes or returns a v128");
+
             Vector<Wasm::Value> values;
             values.ensure_capacity(type.parameters().size());
 
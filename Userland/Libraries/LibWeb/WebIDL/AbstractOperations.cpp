@@ -12,6 +12,8 @@
 #include <LibJS/Runtime/DataView.h>
 #include <LibJS/Runtime/PropertyKey.h>
 #include <LibJS/Runtime/TypedArray.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/WebIDL/AbstractOperations.h>
 
 namespace Web::WebIDL {
@@ -124,7 +126,12 @@ JS::Completion invoke_callback(WebIDL::CallbackType& callback, Optional<JS::Valu
 
     // 11. Let callResult be Call(F, thisArg, esArgs).
     auto& vm = function_object.vm();
-    auto call_result = JS::call(vm, verify_cast<JS::FunctionObject>(function_object), this_argument.value(), move(args));
+    auto call_result = [&] {
+        Optional<DOM::TimingScope> timing_scope;
+        if (auto document = relevant_settings.responsible_document())
+            timing_scope.emplace(*document, DOM::TimingPhase::JavaScript);
+        return JS::call(vm, verify_cast<JS::FunctionObject>(function_object), this_argument.value(), move(args));
+    }();
 
     // 12. If callResult is an abrupt completion, set completion to callResult and jump to the step labeled return.
     if (call_result.is_throw_completion()) {
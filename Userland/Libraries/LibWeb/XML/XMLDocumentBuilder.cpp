@@ -123,7 +123,7 @@ void XMLDocumentBuilder::element_end(const XML::Name& name)
     m_current_node = m_current_node->parent_node();
 }
 
-void XMLDocumentBuilder::text(String const& data)
+void XMLDocumentBuilder::text(StringView data)
 {
     if (m_has_error)
         return;
@@ -140,7 +140,7 @@ void XMLDocumentBuilder::text(String const& data)
     }
 }
 
-void XMLDocumentBuilder::comment(String const& data)
+void XMLDocumentBuilder::comment(StringView data)
 {
     if (m_has_error)
         return;
@@ -32,8 +32,8 @@ private:
     virtual void set_source(String) override;
     virtual void element_start(XML::Name const& name, HashMap<XML::Name, String> const& attributes) override;
     virtual void element_end(XML::Name const& name) override;
-    virtual void text(String const& data) override;
-    virtual void comment(String const& data) override;
+    virtual void text(StringView data) override;
+    virtual void comment(StringView data) override;
     virtual void document_end() override;
 
     DOM::Document& m_document;
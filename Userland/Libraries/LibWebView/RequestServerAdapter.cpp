@@ -69,6 +69,11 @@ void RequestServerRequestAdapter::stream_into(Core::Stream::Stream& stream)
     m_request->stream_into(stream);
 }
 
+void RequestServerRequestAdapter::set_unbuffered_request_callbacks(HeadersReceived on_headers_received, DataReceived on_data_received, RequestFinished on_finish)
+{
+    m_request->set_unbuffered_request_callbacks(move(on_headers_received), move(on_data_received), move(on_finish));
+}
+
 ErrorOr<NonnullRefPtr<RequestServerAdapter>> RequestServerAdapter::try_create()
 {
     auto protocol_client = TRY(Protocol::RequestClient::try_create());
@@ -82,9 +87,22 @@ RequestServerAdapter::RequestServerAdapter(NonnullRefPtr<Protocol::RequestClient
 
 RequestServerAdapter::~RequestServerAdapter() = default;
 
-RefPtr<Web::ResourceLoaderConnectorRequest> RequestServerAdapter::start_request(String const& method, URL const& url, HashMap<String, String> const& headers, ReadonlyBytes body, Core::ProxyData const& proxy)
+static RequestServer::RequestPriority to_request_priority(Web::LoadRequest::Priority priority)
 {
-    auto protocol_request = m_protocol_client->start_request(method, url, headers, body, proxy);
+    switch (priority) {
+    case Web::LoadRequest::Priority::Low:
+        return RequestServer::RequestPriority::Low;
+    case Web::LoadRequest::Priority::Normal:
+        return RequestServer::RequestPriority::Normal;
+    case Web::LoadRequest::Priority::High:
+        return RequestServer::RequestPriority::High;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+RefPtr<Web::ResourceLoaderConnectorRequest> RequestServerAdapter::start_request(String const& method, URL const& url, HashMap<String, String> const& headers, ReadonlyBytes body, Core::ProxyData const& proxy, Web::LoadRequest::Priority priority)
+{
+    auto protocol_request = m_protocol_client->start_request(method, url, headers, body, proxy, to_request_priority(priority));
     if (!protocol_request)
         return {};
     return RequestServerRequestAdapter::try_create(protocol_request.release_nonnull()).release_value_but_fixme_should_propagate_errors();
@@ -100,4 +118,9 @@ void RequestServerAdapter::preconnect(AK::URL const& url)
     m_protocol_client->ensure_connection(url, RequestServer::CacheLevel::CreateConnection);
 }
 
+String RequestServerAdapter::connection_pool_statistics()
+{
+    return m_protocol_client->connection_pool_statistics();
+}
+
 }
@@ -28,6 +28,7 @@ public:
     virtual bool stop() override;
 
     virtual void stream_into(Core::Stream::Stream&) override;
+    virtual void set_unbuffered_request_callbacks(HeadersReceived, DataReceived, RequestFinished) override;
 
 private:
     RequestServerRequestAdapter(NonnullRefPtr<Protocol::Request>);
@@ -42,7 +43,9 @@ public:
     virtual void prefetch_dns(AK::URL const& url) override;
     virtual void preconnect(AK::URL const& url) override;
 
-    virtual RefPtr<Web::ResourceLoaderConnectorRequest> start_request(String const& method, URL const&, HashMap<String, String> const& request_headers = {}, ReadonlyBytes request_body = {}, Core::ProxyData const& = {}) override;
+    virtual RefPtr<Web::ResourceLoaderConnectorRequest> start_request(String const& method, URL const&, HashMap<String, String> const& request_headers = {}, ReadonlyBytes request_body = {}, Core::ProxyData const& = {}, Web::LoadRequest::Priority = Web::LoadRequest::Priority::Normal) override;
+
+    virtual String connection_pool_statistics() override;
 
 private:
     RequestServerAdapter(NonnullRefPtr<Protocol::RequestClient> protocol_client);
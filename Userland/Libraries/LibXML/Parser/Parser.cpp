@@ -78,8 +78,12 @@ void Parser::append_node(NonnullOwnPtr<Node> node)
     }
 }
 
-void Parser::append_text(String text)
+void Parser::append_text(StringView text)
 {
+    // Character data is often empty, e.g. between two tags.
+    if (text.is_empty())
+        return;
+
     if (m_listener) {
         m_listener->text(text);
         return;
@@ -111,7 +115,7 @@ void Parser::append_text(String text)
         });
 }
 
-void Parser::append_comment(String text)
+void Parser::append_comment(StringView text)
 {
     if (m_listener) {
         m_listener->comment(text);
@@ -125,7 +129,7 @@ void Parser::append_comment(String text)
 
     m_entered_node->content.visit(
         [&](Node::Element& node) {
-            node.children.append(make<Node>(Node::Comment { move(text) }));
+            node.children.append(make<Node>(Node::Comment { text }));
         },
         [&](auto&) {
             // Can't enter a text or comment node.
@@ -542,12 +546,10 @@ ErrorOr<Name, ParseError> Parser::parse_name()
     auto accept = accept_rule();
 
     auto rest = m_lexer.consume_while(s_name_characters);
-    StringBuilder builder;
-    builder.append(start);
-    builder.append(rest);
 
+    // The rest of the name directly follows its first character in the source.
     rollback.disarm();
-    return builder.to_string();
+    return Name { StringView { start.characters_without_null_termination(), start.length() + rest.length() } };
 }
 
 // 2.8.28. doctypedecl, https://www.w3.org/TR/2006/REC-xml11-20060816/#NT-doctypedecl
@@ -611,7 +613,13 @@ ErrorOr<void, ParseError> Parser::parse_element()
     // element ::= EmptyElemTag
     //           | STag content ETag
     if (auto result = parse_empty_element_tag(); !result.is_error()) {
-        append_node(result.release_value());
+        auto node = result.release_value();
+        if (m_listener) {
+            enter_node(*node);
+            leave_node();
+        } else {
+            append_node(move(node));
+        }
         rollback.disarm();
         return {};
     }
@@ -619,7 +627,14 @@ ErrorOr<void, ParseError> Parser::parse_element()
     auto start_tag = TRY(parse_start_tag());
     auto& node = *start_tag;
     auto& tag = node.content.get<Node::Element>();
-    append_node(move(start_tag));
+
+    // NOTE: When parsing with a listener, nodes are not kept in a tree. Elements only live on until their end tag,
+    //       so that the elements that are still open can be walked through their parents.
+    OwnPtr<Node> streamed_node;
+    if (m_listener)
+        streamed_node = move(start_tag);
+    else
+        append_node(move(start_tag));
     enter_node(node);
     ScopeGuard quit {
         [&] {
@@ -714,6 +729,11 @@ ErrorOr<String, ParseError> Parser::parse_attribute_value_inner(StringView disal
 {
     StringBuilder builder;
     while (true) {
+        // Take runs of plain characters in one go, as that's what most attribute values consist of entirely.
+        builder.append(m_lexer.consume_while([&](char ch) {
+            return ch != '<' && ch != '&' && !disallow.contains(ch);
+        }));
+
         if (m_lexer.next_is(is_any_of(disallow)) || m_lexer.is_eof())
             break;
 
@@ -34,8 +34,9 @@ struct Listener {
     virtual void document_end() { }
     virtual void element_start(Name const&, HashMap<Name, String> const&) { }
     virtual void element_end(Name const&) { }
-    virtual void text(String const&) { }
-    virtual void comment(String const&) { }
+    // NOTE: Text and comments point into the source, so they are only valid until these return.
+    virtual void text(StringView) { }
+    virtual void comment(StringView) { }
     virtual void error(ParseError const&) { }
 };
 
@@ -73,8 +74,8 @@ private:
 
     ErrorOr<void, ParseError> parse_internal();
     void append_node(NonnullOwnPtr<Node>);
-    void append_text(String);
-    void append_comment(String);
+    void append_text(StringView);
+    void append_comment(StringView);
     void enter_node(Node&);
     void leave_node();
 
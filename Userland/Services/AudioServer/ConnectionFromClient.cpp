@@ -44,7 +44,11 @@ void ConnectionFromClient::set_buffer(Audio::AudioQueue const& buffer)
         m_queue = m_mixer.create_queue(*this);
 
     // This is ugly but we know nobody uses the buffer afterwards anyways.
-    m_queue->set_buffer(make<Audio::AudioQueue>(move(const_cast<Audio::AudioQueue&>(buffer))));
+    auto queue = make<Audio::AudioQueue>(move(const_cast<Audio::AudioQueue&>(buffer)));
+    // The limit lives in the shared queue, so the client's enqueueing blocks before it gets too far ahead of the mixer.
+    if (m_mixer.is_low_latency())
+        queue->set_producer_limit(LOW_LATENCY_CLIENT_QUEUE_LENGTH);
+    m_queue->set_buffer(move(queue));
 }
 
 void ConnectionFromClient::did_change_main_mix_muted_state(Badge<Mixer>, bool muted)
@@ -77,6 +81,11 @@ Messages::AudioServer::GetSampleRateResponse ConnectionFromClient::get_sample_ra
     return { m_mixer.audiodevice_get_sample_rate() };
 }
 
+Messages::AudioServer::GetOutputLatencyResponse ConnectionFromClient::get_output_latency()
+{
+    return { m_mixer.output_latency_in_microseconds() };
+}
+
 void ConnectionFromClient::set_sample_rate(u32 sample_rate)
 {
     m_mixer.audiodevice_set_sample_rate(sample_rate);
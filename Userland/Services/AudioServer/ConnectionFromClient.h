@@ -48,6 +48,7 @@ private:
     virtual void set_self_muted(bool) override;
     virtual void set_sample_rate(u32 sample_rate) override;
     virtual Messages::AudioServer::GetSampleRateResponse get_sample_rate() override;
+    virtual Messages::AudioServer::GetOutputLatencyResponse get_output_latency() override;
 
     Mixer& m_mixer;
     RefPtr<ClientAudioStream> m_queue;
@@ -8,18 +8,23 @@
 #include "Mixer.h"
 #include <AK/Array.h>
 #include <AK/Format.h>
-#include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDMath.h>
 #include <AudioServer/ConnectionFromClient.h>
 #include <AudioServer/Mixer.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/Timer.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <sys/ioctl.h>
 
 namespace AudioServer {
 
+using AK::SIMD::f32x4;
+using AK::SIMD::i16x8;
+
 Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config)
     // FIXME: Allow AudioServer to use other audio channels as well
     : m_device(Core::File::construct("/dev/audio/0", this))
@@ -39,6 +44,15 @@ Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config)
     m_muted = m_config->read_bool_entry("Master", "Mute", false);
     m_main_volume = static_cast<double>(m_config->read_num_entry("Master", "Volume", 100)) / 100.0;
 
+    m_low_latency = m_config->read_bool_entry("Mixer", "LowLatency", false);
+    if (m_low_latency) {
+        m_period_size = LOW_LATENCY_HARDWARE_BUFFER_SIZE;
+        if (ioctl(m_device->fd(), SOUNDCARD_IOCTL_SET_OUTPUT_BUFFER_COUNT, LOW_LATENCY_DEVICE_BUFFER_COUNT) != 0)
+            dbgln("Error while setting output buffer count: ioctl error: {}", strerror(errno));
+    }
+    if (ioctl(m_device->fd(), SOUNDCARD_IOCTL_GET_OUTPUT_BUFFER_COUNT, &m_device_buffer_count) != 0)
+        dbgln("Error while getting output buffer count: ioctl error: {}", strerror(errno));
+
     m_sound_thread->start();
 }
 
@@ -59,6 +73,13 @@ void Mixer::mix()
 {
     decltype(m_pending_mixing) active_mix_queues;
 
+    // Every period that the mixer thread runs late is directly audible when there are only a few device buffers left.
+    if (m_low_latency) {
+        sched_param scheduling_parameters { .sched_priority = sched_get_priority_max(SCHED_FIFO) };
+        if (auto result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &scheduling_parameters); result != 0)
+            dbgln("Failed to raise mixer thread priority: {}", strerror(result));
+    }
+
     for (;;) {
         {
             Threading::MutexLocker const locker(m_pending_mutex);
@@ -72,7 +93,8 @@ void Mixer::mix()
 
         active_mix_queues.remove_all_matching([&](auto& entry) { return !entry->client(); });
 
-        Array<Audio::Sample, HARDWARE_BUFFER_SIZE> mixed_buffer;
+        m_mixed_left.span().trim(m_period_size).fill(0);
+        m_mixed_right.span().trim(m_period_size).fill(0);
 
         m_main_volume.advance_time();
 
@@ -84,40 +106,71 @@ void Mixer::mix()
             }
             queue->volume().advance_time();
 
-            for (auto& mixed_sample : mixed_buffer) {
-                Audio::Sample sample;
-                if (!queue->get_next_sample(sample))
-                    break;
-                if (queue->is_muted())
-                    continue;
-                sample.log_multiply(SAMPLE_HEADROOM);
-                sample.log_multiply(static_cast<float>(queue->volume()));
-                mixed_sample += sample;
-            }
+            auto sample_count = queue->get_next_samples(m_client_left.span().trim(m_period_size), m_client_right.span().trim(m_period_size));
+            if (queue->is_muted())
+                continue;
+            // Volumes only change between periods, so that the logarithmic scaling has to be computed once per period.
+            auto gain = Audio::Sample::linear_to_log(SAMPLE_HEADROOM) * Audio::Sample::linear_to_log(static_cast<float>(queue->volume()));
+            mix_client_samples(sample_count, gain);
         }
 
         // Even though it's not realistic, the user expects no sound at 0%.
         if (m_muted || m_main_volume < 0.01) {
-            m_device->write(m_zero_filled_buffer.data(), static_cast<int>(m_zero_filled_buffer.size()));
+            m_device->write(m_zero_filled_buffer.data(), static_cast<int>(m_period_size * 2 * sizeof(i16)));
         } else {
-            OutputMemoryStream stream { m_stream_buffer };
+            convert_mixed_samples_to_device_format(Audio::Sample::linear_to_log(static_cast<float>(m_main_volume)));
+            m_device->write(m_stream_buffer.data(), static_cast<int>(m_period_size * 2 * sizeof(i16)));
+        }
+    }
+}
 
-            for (auto& mixed_sample : mixed_buffer) {
-                mixed_sample.log_multiply(static_cast<float>(m_main_volume));
-                mixed_sample.clip();
+void Mixer::mix_client_samples(size_t count, float gain)
+{
+    // The client buffers are filled up to a multiple of four, so that the tail doesn't need to be handled on its own.
+    auto padded_count = (count + 3) / 4 * 4;
+    for (size_t i = count; i < padded_count; ++i) {
+        m_client_left[i] = 0;
+        m_client_right[i] = 0;
+    }
 
-                LittleEndian<i16> out_sample;
-                out_sample = static_cast<i16>(mixed_sample.left * NumericLimits<i16>::max());
-                stream << out_sample;
+    auto gains = AK::SIMD::expand4(gain);
+    for (size_t i = 0; i < padded_count; i += 4) {
+        f32x4 left;
+        f32x4 right;
+        f32x4 mixed_left;
+        f32x4 mixed_right;
+        __builtin_memcpy(&left, &m_client_left[i], sizeof(left));
+        __builtin_memcpy(&right, &m_client_right[i], sizeof(right));
+        __builtin_memcpy(&mixed_left, &m_mixed_left[i], sizeof(mixed_left));
+        __builtin_memcpy(&mixed_right, &m_mixed_right[i], sizeof(mixed_right));
+        mixed_left += left * gains;
+        mixed_right += right * gains;
+        __builtin_memcpy(&m_mixed_left[i], &mixed_left, sizeof(mixed_left));
+        __builtin_memcpy(&m_mixed_right[i], &mixed_right, sizeof(mixed_right));
+    }
+}
 
-                out_sample = static_cast<i16>(mixed_sample.right * NumericLimits<i16>::max());
-                stream << out_sample;
-            }
+// The sound card wants little-endian samples, which is what the vector stores below produce.
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);
 
-            VERIFY(stream.is_end());
-            VERIFY(!stream.has_any_error());
-            m_device->write(stream.data(), static_cast<int>(stream.size()));
-        }
+void Mixer::convert_mixed_samples_to_device_format(float gain)
+{
+    // Applies the main volume, clips, converts to 16 bits, and interleaves the two channels all in one go.
+    auto gains = AK::SIMD::expand4(gain * NumericLimits<i16>::max());
+    auto limit = static_cast<float>(NumericLimits<i16>::max());
+    auto* output = m_stream_buffer.data();
+    for (size_t i = 0; i < m_period_size; i += 4) {
+        f32x4 left;
+        f32x4 right;
+        __builtin_memcpy(&left, &m_mixed_left[i], sizeof(left));
+        __builtin_memcpy(&right, &m_mixed_right[i], sizeof(right));
+        left = AK::SIMD::clamp(left * gains, -limit, limit);
+        right = AK::SIMD::clamp(right * gains, -limit, limit);
+
+        auto interleaved = __builtin_shufflevector(left, right, 0, 4, 1, 5, 2, 6, 3, 7);
+        auto samples = __builtin_convertvector(interleaved, i16x8);
+        __builtin_memcpy(output, &samples, sizeof(samples));
+        output += sizeof(samples);
     }
 }
 
@@ -169,6 +222,21 @@ u32 Mixer::audiodevice_get_sample_rate() const
     return sample_rate;
 }
 
+u32 Mixer::output_latency_in_microseconds() const
+{
+    auto sample_rate = audiodevice_get_sample_rate();
+    if (sample_rate == 0)
+        return 0;
+
+    // A full client queue, the period that is currently being mixed, and the periods queued up in the sound card.
+    u64 latency_in_samples = m_period_size * (m_device_buffer_count + 1);
+    if (m_low_latency)
+        latency_in_samples += LOW_LATENCY_CLIENT_QUEUE_LENGTH * Audio::AUDIO_BUFFER_SIZE;
+    else
+        latency_in_samples += (Audio::AUDIO_BUFFERS_COUNT - 1) * Audio::AUDIO_BUFFER_SIZE;
+    return static_cast<u32>(latency_in_samples * 1'000'000 / sample_rate);
+}
+
 void Mixer::request_setting_sync()
 {
     if (m_config_write_timer.is_null() || !m_config_write_timer->is_active()) {
@@ -15,6 +15,7 @@
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Queue.h>
 #include <AK/RefCounted.h>
+#include <AK/Span.h>
 #include <AK/WeakPtr.h>
 #include <LibAudio/Queue.h>
 #include <LibCore/File.h>
@@ -33,6 +34,12 @@ constexpr double SAMPLE_HEADROOM = 0.95;
 constexpr size_t HARDWARE_BUFFER_SIZE = 512;
 // The hardware buffer size in bytes; there's two channels of 16-bit samples.
 constexpr size_t HARDWARE_BUFFER_SIZE_BYTES = HARDWARE_BUFFER_SIZE * 2 * sizeof(i16);
+// In low-latency mode, the mixer writes smaller buffers and the sound card queues fewer of them.
+constexpr size_t LOW_LATENCY_HARDWARE_BUFFER_SIZE = 256;
+static_assert(HARDWARE_BUFFER_SIZE % 4 == 0 && LOW_LATENCY_HARDWARE_BUFFER_SIZE % 4 == 0, "The mixer processes four samples at a time");
+constexpr u32 LOW_LATENCY_DEVICE_BUFFER_COUNT = 2;
+// How many buffers a client may have queued up in low-latency mode, before its enqueueing blocks.
+constexpr size_t LOW_LATENCY_CLIENT_QUEUE_LENGTH = 8;
 
 class ConnectionFromClient;
 
@@ -41,28 +48,39 @@ public:
     explicit ClientAudioStream(ConnectionFromClient&);
     ~ClientAudioStream() = default;
 
-    bool get_next_sample(Audio::Sample& sample)
+    // Fills the planar buffers with the next samples of the stream, and returns how many samples there were.
+    size_t get_next_samples(Span<float> left, Span<float> right)
     {
+        VERIFY(left.size() == right.size());
         if (m_paused)
-            return false;
-
-        if (m_in_chunk_location >= m_current_audio_chunk.size()) {
-            // FIXME: We should send a did_misbehave to the client if the queue is empty,
-            //        but the lifetimes involved mean that we segfault if we try to do that.
-            auto result = m_buffer->try_dequeue();
-            if (result.is_error()) {
-                if (result.error() == Audio::AudioQueue::QueueStatus::Empty)
-                    dbgln("Audio client can't keep up!");
+            return 0;
+
+        size_t count = 0;
+        while (count < left.size()) {
+            if (m_in_chunk_location >= m_current_audio_chunk.size()) {
+                // FIXME: We should send a did_misbehave to the client if the queue is empty,
+                //        but the lifetimes involved mean that we segfault if we try to do that.
+                auto result = m_buffer->try_dequeue();
+                if (result.is_error()) {
+                    if (result.error() == Audio::AudioQueue::QueueStatus::Empty)
+                        dbgln("Audio client can't keep up!");
+
+                    return count;
+                }
+                m_current_audio_chunk = result.release_value();
+                m_in_chunk_location = 0;
+            }
 
-                return false;
+            auto samples_from_chunk = min(left.size() - count, m_current_audio_chunk.size() - m_in_chunk_location);
+            for (size_t i = 0; i < samples_from_chunk; ++i) {
+                auto const& sample = m_current_audio_chunk[m_in_chunk_location++];
+                left[count] = sample.left;
+                right[count] = sample.right;
+                ++count;
             }
-            m_current_audio_chunk = result.release_value();
-            m_in_chunk_location = 0;
         }
 
-        sample = m_current_audio_chunk[m_in_chunk_location++];
-
-        return true;
+        return count;
     }
 
     ConnectionFromClient* client() { return m_client.ptr(); }
@@ -114,6 +132,10 @@ public:
     int audiodevice_set_sample_rate(u32 sample_rate);
     u32 audiodevice_get_sample_rate() const;
 
+    bool is_low_latency() const { return m_low_latency; }
+    // The longest time audio that a client has just enqueued spends waiting in the client queue, the mixer and the sound card.
+    u32 output_latency_in_microseconds() const;
+
 private:
     Mixer(NonnullRefPtr<Core::ConfigFile> config);
 
@@ -128,15 +150,27 @@ private:
     NonnullRefPtr<Threading::Thread> m_sound_thread;
 
     bool m_muted { false };
+    bool m_low_latency { false };
+    // How many samples are mixed and written to the device at once.
+    size_t m_period_size { HARDWARE_BUFFER_SIZE };
+    u32 m_device_buffer_count { 0 };
     FadingProperty<double> m_main_volume { 1 };
 
     NonnullRefPtr<Core::ConfigFile> m_config;
     RefPtr<Core::Timer> m_config_write_timer;
 
+    // Planar buffers for mixing, so that the mixing loops can work on several samples at once.
+    Array<float, HARDWARE_BUFFER_SIZE> m_mixed_left;
+    Array<float, HARDWARE_BUFFER_SIZE> m_mixed_right;
+    Array<float, HARDWARE_BUFFER_SIZE> m_client_left;
+    Array<float, HARDWARE_BUFFER_SIZE> m_client_right;
+
     Array<u8, HARDWARE_BUFFER_SIZE_BYTES> m_stream_buffer;
     Array<u8, HARDWARE_BUFFER_SIZE_BYTES> const m_zero_filled_buffer {};
 
     void mix();
+    void mix_client_samples(size_t count, float gain);
+    void convert_mixed_samples_to_device_format(float gain);
 };
 
 // Interval in ms when the server tries to save its configuration to disk.
@@ -6,8 +6,10 @@
 
 #include "ChessEngine.h"
 #include "MCTSTree.h"
-#include <AK/Random.h>
+#include <AK/Atomic.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <LibCore/ElapsedTimer.h>
+#include <LibThreading/Thread.h>
 
 using namespace Chess::UCI;
 
@@ -34,8 +36,6 @@ void ChessEngine::handle_go(GoCommand const& command)
     // FIXME: Add different ways to terminate search.
     VERIFY(command.movetime.has_value());
 
-    srand(get_random<u32>());
-
     auto elapsed_time = Core::ElapsedTimer::start_new();
 
     auto mcts = [this]() -> MCTSTree {
@@ -47,17 +47,55 @@ void ChessEngine::handle_go(GoCommand const& command)
         return { m_board };
     }();
 
-    int rounds = 0;
+    Atomic<int> rounds { 0 };
+    auto search = [&] {
+        while (elapsed_time.elapsed() <= command.movetime.value()) {
+            mcts.do_round();
+            rounds.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        }
+    };
+
+    auto send_info = [&] {
+        InfoCommand info;
+        info.time = elapsed_time.elapsed();
+        info.nodes = rounds.load(AK::MemoryOrder::memory_order_relaxed);
+        info.nps = static_cast<int>(static_cast<i64>(info.nodes.value()) * 1000 / max(info.time.value(), 1));
+        send_command(info);
+    };
+
+    // The main thread searches as well, so we only need to start thread_count - 1 more.
+    NonnullRefPtrVector<Threading::Thread> threads;
+    for (int i = 1; i < m_thread_count; ++i) {
+        auto thread = Threading::Thread::construct([&] {
+            search();
+            return 0;
+        },
+            "ChessEngine[search]"sv);
+        thread->start();
+        threads.append(move(thread));
+    }
+
+    // Let the GUI know how the search is going about once a second.
+    int next_info_time = 1000;
     while (elapsed_time.elapsed() <= command.movetime.value()) {
         mcts.do_round();
-        ++rounds;
+        rounds.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        if (elapsed_time.elapsed() >= next_info_time) {
+            send_info();
+            next_info_time += 1000;
+        }
     }
-    dbgln("MCTS finished {} rounds.", rounds);
+    for (auto& thread : threads)
+        (void)thread.join();
+    send_info();
+
+    dbgln("MCTS finished {} rounds on {} threads.", rounds.load(), m_thread_count);
     dbgln("MCTS evaluation {}", mcts.expected_value());
     auto& best_node = mcts.best_node();
     auto const& best_move = best_node.last_move();
     dbgln("MCTS best move {}", best_move.to_long_algebraic());
     send_command(BestMoveCommand(best_move));
 
+    best_node.release_expanded_boards();
     m_last_tree = move(best_node);
 }
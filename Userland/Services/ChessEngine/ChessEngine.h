@@ -9,6 +9,7 @@
 #include "MCTSTree.h"
 #include <LibChess/Chess.h>
 #include <LibChess/UCIEndpoint.h>
+#include <unistd.h>
 
 class ChessEngine : public Chess::UCI::Endpoint {
     C_OBJECT(ChessEngine)
@@ -28,4 +29,5 @@ private:
 
     Chess::Board m_board;
     Optional<MCTSTree> m_last_tree;
+    int m_thread_count { static_cast<int>(max(1l, sysconf(_SC_NPROCESSORS_ONLN))) };
 };
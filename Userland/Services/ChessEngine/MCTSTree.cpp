@@ -5,9 +5,77 @@
  */
 
 #include "MCTSTree.h"
+#include <AK/Random.h>
 #include <AK/String.h>
+#include <LibThreading/Mutex.h>
 #include <stdlib.h>
 
+// Nodes are carved out of large chunks and recycled through a free list once their tree is thrown away.
+// NOTE: Chunks are never given back to malloc, since the next search is going to need about as many nodes again.
+class NodePool {
+public:
+    void* allocate()
+    {
+        Threading::MutexLocker locker(m_mutex);
+        if (auto* node = m_first_free_node) {
+            m_first_free_node = node->next;
+            return node;
+        }
+        if (m_nodes_left_in_chunk == 0) {
+            m_chunk = static_cast<u8*>(malloc(nodes_per_chunk * sizeof(MCTSTree)));
+            VERIFY(m_chunk);
+            m_nodes_left_in_chunk = nodes_per_chunk;
+        }
+        --m_nodes_left_in_chunk;
+        return m_chunk + m_nodes_left_in_chunk * sizeof(MCTSTree);
+    }
+
+    void deallocate(void* node)
+    {
+        Threading::MutexLocker locker(m_mutex);
+        auto* free_node = static_cast<FreeNode*>(node);
+        free_node->next = m_first_free_node;
+        m_first_free_node = free_node;
+    }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+    static_assert(sizeof(MCTSTree) >= sizeof(FreeNode));
+
+    static constexpr size_t nodes_per_chunk = 4096;
+
+    Threading::Mutex m_mutex;
+    FreeNode* m_first_free_node { nullptr };
+    u8* m_chunk { nullptr };
+    size_t m_nodes_left_in_chunk { 0 };
+};
+
+static NodePool s_node_pool;
+
+// rand() shares its state between all threads, so every search thread gets a generator of its own.
+static u32 random_u32()
+{
+    // Xorshift, by George Marsaglia.
+    thread_local u32 state = get_random<u32>() | 1;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void* MCTSTree::operator new(size_t size)
+{
+    VERIFY(size == sizeof(MCTSTree));
+    return s_node_pool.allocate();
+}
+
+void MCTSTree::operator delete(void* node)
+{
+    s_node_pool.deallocate(node);
+}
+
 MCTSTree::MCTSTree(Chess::Board const& board, MCTSTree* parent)
     : m_parent(parent)
     , m_board(make<Chess::Board>(board))
@@ -18,15 +86,16 @@ MCTSTree::MCTSTree(Chess::Board const& board, MCTSTree* parent)
 
 MCTSTree::MCTSTree(MCTSTree&& other)
     : m_children(move(other.m_children))
-    , m_parent(other.m_parent)
-    , m_white_points(other.m_white_points)
-    , m_simulations(other.m_simulations)
+    , m_white_points(other.m_white_points.load())
+    , m_simulations(other.m_simulations.load())
     , m_board(move(other.m_board))
     , m_last_move(move(other.m_last_move))
     , m_turn(other.m_turn)
-    , m_moves_generated(other.m_moves_generated)
+    , m_move_generation(other.m_move_generation.load())
 {
     other.m_parent = nullptr;
+    for (auto& child : m_children)
+        child.m_parent = this;
 }
 
 MCTSTree& MCTSTree::select_leaf()
@@ -44,35 +113,36 @@ MCTSTree& MCTSTree::select_leaf()
         }
     }
     VERIFY(node);
+    node->m_virtual_losses.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
     return node->select_leaf();
 }
 
 MCTSTree& MCTSTree::expand()
 {
-    VERIFY(!expanded() || m_children.size() == 0);
+    if (!moves_generated()) {
+        // Only one thread gets to generate the moves, the others evaluate this node once more in the meantime.
+        auto expected = MoveGeneration::NotStarted;
+        if (!m_move_generation.compare_exchange_strong(expected, MoveGeneration::InProgress, AK::MemoryOrder::memory_order_acq_rel))
+            return *this;
 
-    if (!m_moves_generated) {
+        NonnullOwnPtrVector<MCTSTree> children;
         m_board->generate_moves([&](Chess::Move chess_move) {
             auto clone = m_board->clone_without_history();
             clone.apply_move(chess_move);
-            m_children.append(make<MCTSTree>(move(clone), this));
+            children.append(make<MCTSTree>(move(clone), this));
             return IterationDecision::Continue;
         });
-        m_moves_generated = true;
-        if (m_children.size() != 0)
-            m_board = nullptr; // Release the board to save memory.
-    }
-
-    if (m_children.size() == 0) {
-        return *this;
+        m_children = move(children);
+        m_move_generation.store(MoveGeneration::Done, AK::MemoryOrder::memory_order_release);
     }
 
     for (auto& child : m_children) {
-        if (child.m_simulations == 0) {
+        if (child.try_claim_first_visit())
             return child;
-        }
     }
-    VERIFY_NOT_REACHED();
+
+    // Either the game is over, or other threads got to all of the children first.
+    return *this;
 }
 
 int MCTSTree::simulate_game() const
@@ -91,7 +161,7 @@ int MCTSTree::heuristic() const
 
     double winchance = max(min(double(m_board->material_imbalance()) / 6, 1.0), -1.0);
 
-    double random = double(rand()) / RAND_MAX;
+    double random = double(random_u32()) / NumericLimits<u32>::max();
     if (winchance >= random)
         return 1;
     if (winchance <= -random)
@@ -102,11 +172,14 @@ int MCTSTree::heuristic() const
 
 void MCTSTree::apply_result(int game_score)
 {
-    m_simulations++;
-    m_white_points += game_score;
+    m_simulations.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    m_white_points.fetch_add(game_score, AK::MemoryOrder::memory_order_relaxed);
 
-    if (m_parent)
+    // The root is never picked by anyone, so it's the only node on the way up that doesn't have a virtual loss to undo.
+    if (m_parent) {
+        m_virtual_losses.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
         m_parent->apply_result(game_score);
+    }
 }
 
 void MCTSTree::do_round()
@@ -116,8 +189,8 @@ void MCTSTree::do_round()
     //       Efficient Selectivity and Backup Operators in Monte-Carlo Tree Search.
     //       Rémi Coulom.
     auto* node_ptr = &select_leaf();
-    if (node_ptr->m_simulations > s_number_of_visit_parameter)
-        node_ptr = &select_leaf().expand();
+    if (node_ptr->simulations() > s_number_of_visit_parameter)
+        node_ptr = &node_ptr->expand();
 
     auto& node = *node_ptr;
 
@@ -130,8 +203,21 @@ void MCTSTree::do_round()
     node.apply_result(result);
 }
 
+void MCTSTree::release_expanded_boards()
+{
+    if (!moves_generated() || m_children.size() == 0)
+        return;
+
+    m_board = nullptr;
+    for (auto& child : m_children)
+        child.release_expanded_boards();
+}
+
 Optional<MCTSTree&> MCTSTree::child_with_move(Chess::Move chess_move)
 {
+    if (!moves_generated())
+        return {};
+
     for (auto& node : m_children) {
         if (node.last_move() == chess_move)
             return node;
@@ -165,10 +251,24 @@ Chess::Move MCTSTree::last_move() const
 
 double MCTSTree::expected_value() const
 {
-    if (m_simulations == 0)
+    auto simulations = this->simulations();
+    if (simulations == 0)
         return 0;
 
-    return double(m_white_points) / m_simulations;
+    return double(m_white_points.load(AK::MemoryOrder::memory_order_relaxed)) / simulations;
+}
+
+int MCTSTree::visits() const
+{
+    return simulations() + m_virtual_losses.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+bool MCTSTree::try_claim_first_visit()
+{
+    if (simulations() != 0)
+        return false;
+    int expected = 0;
+    return m_virtual_losses.compare_exchange_strong(expected, 1, AK::MemoryOrder::memory_order_relaxed);
 }
 
 double MCTSTree::uct(Chess::Color color) const
@@ -177,17 +277,20 @@ double MCTSTree::uct(Chess::Color color) const
     //      Kocsis, Levente; Szepesvári, Csaba (2006). "Bandit based Monte-Carlo Planning"
 
     // Fun fact: Szepesvári was my data structures professor.
-    double expected = expected_value() * ((color == Chess::Color::White) ? 1 : -1);
-    return expected + s_exploration_parameter * sqrt(log(m_parent->m_simulations) / m_simulations);
+    int sign = (color == Chess::Color::White) ? 1 : -1;
+    int visits = this->visits();
+    double points = m_white_points.load(AK::MemoryOrder::memory_order_relaxed) * sign - m_virtual_losses.load(AK::MemoryOrder::memory_order_relaxed);
+    double expected = points / visits;
+    return expected + s_exploration_parameter * sqrt(log(m_parent->visits()) / visits);
 }
 
 bool MCTSTree::expanded() const
 {
-    if (!m_moves_generated)
+    if (!moves_generated())
         return false;
 
     for (auto& child : m_children) {
-        if (child.m_simulations == 0)
+        if (child.visits() == 0)
             return false;
     }
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Function.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/OwnPtr.h>
@@ -20,15 +21,25 @@ public:
     };
 
     MCTSTree(Chess::Board const& board, MCTSTree* parent = nullptr);
+    // NOTE: The moved-to node becomes the root of its own tree.
     MCTSTree(MCTSTree&&);
 
+    // A search creates nodes from all of its threads at a high rate, so they come from a pool rather than from malloc.
+    static void* operator new(size_t);
+    static void* operator new(size_t, void* where) { return where; }
+    static void operator delete(void*);
+
     MCTSTree& select_leaf();
     MCTSTree& expand();
     int simulate_game() const;
     int heuristic() const;
     void apply_result(int game_score);
+    // Any number of threads may do rounds on the same tree at once.
     void do_round();
 
+    // Expanded nodes keep their board while a search may still be evaluating them, call this once it's over.
+    void release_expanded_boards();
+
     Optional<MCTSTree&> child_with_move(Chess::Move);
 
     MCTSTree& best_node();
@@ -37,8 +48,19 @@ public:
     double expected_value() const;
     double uct(Chess::Color color) const;
     bool expanded() const;
+    int simulations() const { return m_simulations.load(AK::MemoryOrder::memory_order_relaxed); }
 
 private:
+    enum class MoveGeneration : u8 {
+        NotStarted,
+        InProgress,
+        Done,
+    };
+
+    bool moves_generated() const { return m_move_generation.load(AK::MemoryOrder::memory_order_acquire) == MoveGeneration::Done; }
+    int visits() const;
+    bool try_claim_first_visit();
+
     // While static parameters are less configurable, they don't take up any
     // memory in the tree, which I believe to be a worthy tradeoff.
     static constexpr double s_exploration_parameter { M_SQRT2 };
@@ -48,10 +70,13 @@ private:
 
     NonnullOwnPtrVector<MCTSTree> m_children;
     MCTSTree* m_parent { nullptr };
-    int m_white_points { 0 };
-    int m_simulations { 0 };
+    Atomic<int> m_white_points { 0 };
+    Atomic<int> m_simulations { 0 };
+    // Rounds that went through this node and haven't applied their result yet. These count as lost for the side that
+    // picked this node, which makes other threads look elsewhere instead of all piling onto the same path.
+    Atomic<int> m_virtual_losses { 0 };
     OwnPtr<Chess::Board> m_board;
     Optional<Chess::Move> m_last_move;
     Chess::Color m_turn : 2;
-    bool m_moves_generated : 1 { false };
+    Atomic<MoveGeneration> m_move_generation { MoveGeneration::NotStarted };
 };
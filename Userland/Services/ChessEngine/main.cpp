@@ -12,7 +12,7 @@
 
 ErrorOr<int> serenity_main(Main::Arguments)
 {
-    TRY(Core::System::pledge("stdio recvfd sendfd unix"));
+    TRY(Core::System::pledge("stdio recvfd sendfd unix thread"));
     Core::EventLoop loop;
     TRY(Core::System::unveil(nullptr, nullptr));
 
@@ -4,11 +4,14 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteBuffer.h>
 #include <AK/LexicalPath.h>
 #include <Kernel/API/InodeWatcherEvent.h>
+#include <LibCompress/Gzip.h>
+#include <LibCore/FileStream.h>
 #include <LibCore/FileWatcher.h>
-#include <LibCore/MappedFile.h>
 #include <LibCore/Process.h>
+#include <LibCore/Stream.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <serenity.h>
@@ -17,19 +20,56 @@
 #include <time.h>
 #include <unistd.h>
 
-static void wait_until_coredump_is_ready(String const& coredump_path)
+// The kernel creates coredumps readable by their owner, and makes them writable once it has finished writing them.
+static bool coredump_is_complete(String const& coredump_path)
 {
+    struct stat statbuf;
+    if (stat(coredump_path.characters(), &statbuf) < 0) {
+        perror("stat");
+        VERIFY_NOT_REACHED();
+    }
+    return statbuf.st_mode & 0200;
+}
+
+static void wait_until_coredump_is_complete(String const& coredump_path)
+{
+    while (!coredump_is_complete(coredump_path))
+        usleep(10000); // sleep for 10ms
+}
+
+// Compresses the coredump while the kernel is still writing it, a chunk at a time, so that it's done about as soon as
+// the coredump is, and there is never more than one chunk of it in memory.
+static ErrorOr<String> compress_coredump(String const& coredump_path)
+{
+    auto input = TRY(Core::Stream::File::open(coredump_path, Core::Stream::OpenMode::Read));
+    auto compressed_path = String::formatted("{}.gz", coredump_path);
+    auto output = TRY(Core::OutputFileStream::open(compressed_path, Core::OpenMode::WriteOnly | Core::OpenMode::MustBeNew, 0600));
+    // NOTE: Every chunk becomes a gzip member of its own, which decompressors read back as one stream.
+    Compress::GzipCompressor compressor { output };
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(1 * MiB));
+    size_t buffered_size = 0;
+    bool is_complete = false;
     while (true) {
-        struct stat statbuf;
-        if (stat(coredump_path.characters(), &statbuf) < 0) {
-            perror("stat");
-            VERIFY_NOT_REACHED();
+        auto nread = TRY(input->read(buffer.bytes().slice(buffered_size))).size();
+        buffered_size += nread;
+        if (buffered_size == buffer.size() || (nread == 0 && is_complete && buffered_size > 0)) {
+            if (!compressor.write_or_error(buffer.bytes().trim(buffered_size)))
+                return Error::from_string_literal("Failed to write compressed coredump");
+            buffered_size = 0;
         }
-        if (statbuf.st_mode & 0400) // Check if readable
+        if (nread != 0)
+            continue;
+        if (is_complete)
             break;
 
-        usleep(10000); // sleep for 10ms
+        // Whatever was written until the kernel was done gets read on the next time around.
+        is_complete = coredump_is_complete(coredump_path);
+        if (!is_complete)
+            usleep(10000); // sleep for 10ms
     }
+
+    return compressed_path;
 }
 
 static void launch_crash_reporter(String const& coredump_path, bool unlink_on_exit)
@@ -55,15 +95,22 @@ ErrorOr<int> serenity_main(Main::Arguments)
         if (event.value().type != Core::FileWatcherEvent::Type::ChildCreated)
             continue;
         auto& coredump_path = event.value().event_path;
+        // These are the ones we create ourselves.
+        if (coredump_path.ends_with(".gz"sv))
+            continue;
         dbgln("New coredump file: {}", coredump_path);
-        wait_until_coredump_is_ready(coredump_path);
 
-        auto file_or_error = Core::MappedFile::map(coredump_path);
-        if (file_or_error.is_error()) {
-            dbgln("Unable to map coredump {}: {}", coredump_path, file_or_error.error());
+        auto compressed_path_or_error = compress_coredump(coredump_path);
+        if (compressed_path_or_error.is_error()) {
+            dbgln("Unable to compress coredump {}: {}", coredump_path, compressed_path_or_error.error());
+            (void)Core::System::unlink(String::formatted("{}.gz", coredump_path));
+            wait_until_coredump_is_complete(coredump_path);
+            launch_crash_reporter(coredump_path, true);
             continue;
         }
 
-        launch_crash_reporter(coredump_path, true);
+        if (auto result = Core::System::unlink(coredump_path); result.is_error())
+            dbgln("Unable to remove coredump {}: {}", coredump_path, result.error());
+        launch_crash_reporter(compressed_path_or_error.release_value(), true);
     }
 }
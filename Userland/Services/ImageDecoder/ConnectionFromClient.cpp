@@ -22,40 +22,170 @@ void ConnectionFromClient::die()
     Core::EventLoop::current().quit(0);
 }
 
-Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer)
+// Shrinks the bitmap by the largest whole factor that still leaves it at least as big as ideal_size, averaging each
+// block of pixels. The client does the remaining (less than 2x) scaling when painting, so nothing is lost that would
+// have been visible, but the bitmap that is kept around and handed out is a fraction of the size.
+static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> downsampled(NonnullRefPtr<Gfx::Bitmap> bitmap, Gfx::IntSize const& ideal_size)
 {
-    if (!encoded_buffer.is_valid()) {
-        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
-        return nullptr;
+    if (ideal_size.is_empty() || bitmap->scale() != 1)
+        return bitmap;
+    if (bitmap->format() != Gfx::BitmapFormat::BGRA8888 && bitmap->format() != Gfx::BitmapFormat::BGRx8888)
+        return bitmap;
+
+    int factor = min(bitmap->width() / ideal_size.width(), bitmap->height() / ideal_size.height());
+    if (factor < 2)
+        return bitmap;
+
+    bool has_alpha = bitmap->has_alpha_channel();
+    auto result = TRY(Gfx::Bitmap::try_create(bitmap->format(), { bitmap->width() / factor, bitmap->height() / factor }));
+    u32 block_area = factor * factor;
+
+    for (int y = 0; y < result->height(); ++y) {
+        auto* destination = result->scanline(y);
+        for (int x = 0; x < result->width(); ++x) {
+            // Color channels are weighted by alpha so that transparent pixels don't bleed their (arbitrary) color.
+            u32 red = 0, green = 0, blue = 0, alpha = 0;
+            for (int block_y = 0; block_y < factor; ++block_y) {
+                auto const* source = bitmap->scanline(y * factor + block_y) + x * factor;
+                for (int block_x = 0; block_x < factor; ++block_x) {
+                    auto color = Color::from_argb(source[block_x]);
+                    u32 weight = has_alpha ? color.alpha() : 255;
+                    red += color.red() * weight;
+                    green += color.green() * weight;
+                    blue += color.blue() * weight;
+                    alpha += weight;
+                }
+            }
+            if (alpha == 0) {
+                destination[x] = 0;
+                continue;
+            }
+            destination[x] = Color(red / alpha, green / alpha, blue / alpha, alpha / block_area).value();
+        }
     }
+    return result;
+}
+
+DecodedImageCache::Entry* ConnectionFromClient::ensure_cache_entry(OpenImage& image)
+{
+    if (auto* entry = DecodedImageCache::the().get(image.key))
+        return entry;
 
-    auto decoder = Gfx::ImageDecoder::try_create(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() });
+    if (!image.decoder)
+        image.decoder = Gfx::ImageDecoder::try_create(ReadonlyBytes { image.encoded_buffer.data<u8>(), image.encoded_buffer.size() });
 
-    if (!decoder) {
+    if (!image.decoder) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Could not find suitable image decoder plugin for data");
-        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+        return nullptr;
     }
 
-    if (!decoder->frame_count()) {
+    if (!image.decoder->frame_count()) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from encoded data");
-        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+        return nullptr;
+    }
+
+    return &DecodedImageCache::the().add(image.key, image.decoder->is_animated(), image.decoder->loop_count(), image.decoder->frame_count());
+}
+
+DecodedImageCache::Frame ConnectionFromClient::ensure_frame(OpenImage& image, DecodedImageCache::Entry& entry, size_t index)
+{
+    if (entry.frames[index].has_value())
+        return *entry.frames[index];
+
+    if (!image.decoder)
+        image.decoder = Gfx::ImageDecoder::try_create(ReadonlyBytes { image.encoded_buffer.data<u8>(), image.encoded_buffer.size() });
+
+    DecodedImageCache::Frame frame;
+    if (image.decoder) {
+        auto frame_or_error = image.decoder->frame(index);
+        if (!frame_or_error.is_error() && frame_or_error.value().image) {
+            auto decoded_frame = frame_or_error.release_value();
+            NonnullRefPtr<Gfx::Bitmap> bitmap = *decoded_frame.image;
+            if (image.key.ideal_size.has_value()) {
+                auto downsampled_or_error = downsampled(bitmap, *image.key.ideal_size);
+                if (!downsampled_or_error.is_error())
+                    bitmap = downsampled_or_error.release_value();
+            }
+            frame.bitmap = bitmap->to_shareable_bitmap();
+            frame.duration = decoded_frame.duration;
+        }
+    }
+
+    DecodedImageCache::the().set_frame(entry, index, frame);
+    return frame;
+}
+
+Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer, Optional<Gfx::IntSize> const& ideal_size)
+{
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        return nullptr;
     }
 
+    OpenImage image {
+        encoded_buffer,
+        DecodedImageCache::key_for(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() }, ideal_size),
+        nullptr,
+    };
+
+    auto* entry = ensure_cache_entry(image);
+    if (!entry)
+        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+
     Vector<Gfx::ShareableBitmap> bitmaps;
     Vector<u32> durations;
-    for (size_t i = 0; i < decoder->frame_count(); ++i) {
-        auto frame_or_error = decoder->frame(i);
-        if (frame_or_error.is_error()) {
-            bitmaps.append(Gfx::ShareableBitmap {});
-            durations.append(0);
-        } else {
-            auto frame = frame_or_error.release_value();
-            bitmaps.append(frame.image->to_shareable_bitmap());
-            durations.append(frame.duration);
-        }
+    for (size_t i = 0; i < entry->frames.size(); ++i) {
+        auto frame = ensure_frame(image, *entry, i);
+        bitmaps.append(move(frame.bitmap));
+        durations.append(frame.duration);
+    }
+
+    return { entry->is_animated, entry->loop_count, bitmaps, durations };
+}
+
+Messages::ImageDecoderServer::OpenImageResponse ConnectionFromClient::open_image(Core::AnonymousBuffer const& encoded_buffer, Optional<Gfx::IntSize> const& ideal_size)
+{
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        return { -1, false, 0, 0 };
     }
 
-    return { decoder->is_animated(), static_cast<u32>(decoder->loop_count()), bitmaps, durations };
+    OpenImage image {
+        encoded_buffer,
+        DecodedImageCache::key_for(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() }, ideal_size),
+        nullptr,
+    };
+
+    auto* entry = ensure_cache_entry(image);
+    if (!entry)
+        return { -1, false, 0, 0 };
+
+    auto image_id = m_next_image_id++;
+    auto response = Messages::ImageDecoderServer::OpenImageResponse { image_id, entry->is_animated, entry->loop_count, static_cast<u32>(entry->frames.size()) };
+    m_open_images.set(image_id, move(image));
+    return response;
+}
+
+Messages::ImageDecoderServer::DecodeFrameResponse ConnectionFromClient::decode_frame(i32 image_id, u32 frame_index)
+{
+    auto it = m_open_images.find(image_id);
+    if (it == m_open_images.end()) {
+        did_misbehave("ImageDecoder::decode_frame: Bad image ID");
+        return { Gfx::ShareableBitmap {}, 0 };
+    }
+
+    auto& image = it->value;
+    auto* entry = ensure_cache_entry(image);
+    if (!entry || frame_index >= entry->frames.size())
+        return { Gfx::ShareableBitmap {}, 0 };
+
+    auto frame = ensure_frame(image, *entry, frame_index);
+    return { move(frame.bitmap), frame.duration };
+}
+
+void ConnectionFromClient::close_image(i32 image_id)
+{
+    m_open_images.remove(image_id);
 }
 
 }
@@ -7,9 +7,11 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <ImageDecoder/DecodedImageCache.h>
 #include <ImageDecoder/Forward.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <ImageDecoder/ImageDecoderServerEndpoint.h>
+#include <LibGfx/ImageDecoder.h>
 #include <LibIPC/ConnectionFromClient.h>
 #include <LibWeb/Forward.h>
 
@@ -27,7 +29,24 @@ public:
 private:
     explicit ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSocket>);
 
-    virtual Messages::ImageDecoderServer::DecodeImageResponse decode_image(Core::AnonymousBuffer const&) override;
+    virtual Messages::ImageDecoderServer::DecodeImageResponse decode_image(Core::AnonymousBuffer const&, Optional<Gfx::IntSize> const& ideal_size) override;
+    virtual Messages::ImageDecoderServer::OpenImageResponse open_image(Core::AnonymousBuffer const&, Optional<Gfx::IntSize> const& ideal_size) override;
+    virtual Messages::ImageDecoderServer::DecodeFrameResponse decode_frame(i32 image_id, u32 frame_index) override;
+    virtual void close_image(i32 image_id) override;
+
+    // An image the client is decoding, possibly one frame at a time. The encoded data is kept so that frames which
+    // aren't in the cache (anymore) can still be decoded, but the decoder itself is only created once that happens.
+    struct OpenImage {
+        Core::AnonymousBuffer encoded_buffer;
+        DecodedImageCache::Key key;
+        RefPtr<Gfx::ImageDecoder> decoder;
+    };
+
+    DecodedImageCache::Entry* ensure_cache_entry(OpenImage&);
+    DecodedImageCache::Frame ensure_frame(OpenImage&, DecodedImageCache::Entry&, size_t index);
+
+    HashMap<i32, OpenImage> m_open_images;
+    i32 m_next_image_id { 1 };
 };
 
 }
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringHash.h>
+#include <ImageDecoder/DecodedImageCache.h>
+#include <LibGfx/Bitmap.h>
+
+namespace ImageDecoder {
+
+bool DecodedImageCache::Key::operator==(Key const& other) const
+{
+    return digest.bytes() == other.digest.bytes() && ideal_size == other.ideal_size;
+}
+
+unsigned DecodedImageCache::KeyTraits::hash(Key const& key)
+{
+    auto digest_hash = string_hash(reinterpret_cast<char const*>(key.digest.immutable_data()), key.digest.data_length());
+    if (!key.ideal_size.has_value())
+        return digest_hash;
+    return pair_int_hash(digest_hash, pair_int_hash(key.ideal_size->width(), key.ideal_size->height()));
+}
+
+DecodedImageCache& DecodedImageCache::the()
+{
+    static DecodedImageCache s_the;
+    return s_the;
+}
+
+DecodedImageCache::Key DecodedImageCache::key_for(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size)
+{
+    return { Crypto::Hash::SHA256::hash(encoded_data.data(), encoded_data.size()), ideal_size };
+}
+
+DecodedImageCache::Entry* DecodedImageCache::get(Key const& key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return nullptr;
+
+    auto& entry = *it->value;
+    m_lru.remove(entry);
+    m_lru.append(entry);
+    return &entry;
+}
+
+DecodedImageCache::Entry& DecodedImageCache::add(Key const& key, bool is_animated, u32 loop_count, size_t frame_count)
+{
+    VERIFY(!m_entries.contains(key));
+
+    auto entry = make<Entry>();
+    entry->key = key;
+    entry->is_animated = is_animated;
+    entry->loop_count = loop_count;
+    entry->frames.resize(frame_count);
+
+    auto& entry_ref = *entry;
+    m_lru.append(entry_ref);
+    m_entries.set(key, move(entry));
+    return entry_ref;
+}
+
+void DecodedImageCache::set_frame(Entry& entry, size_t index, Frame frame)
+{
+    VERIFY(!entry.frames[index].has_value());
+
+    if (auto const* bitmap = frame.bitmap.bitmap()) {
+        entry.size_in_bytes += bitmap->size_in_bytes();
+        m_size_in_bytes += bitmap->size_in_bytes();
+    }
+    entry.frames[index] = move(frame);
+
+    evict_until_below_budget(entry);
+}
+
+void DecodedImageCache::evict_until_below_budget(Entry const& keep)
+{
+    // The entry that is being filled in is never thrown out, even if it alone is over budget.
+    auto it = m_lru.begin();
+    while (m_size_in_bytes > max_size_in_bytes && it != m_lru.end()) {
+        auto& entry = *it;
+        ++it;
+        if (&entry == &keep)
+            continue;
+        m_size_in_bytes -= entry.size_in_bytes;
+        m_lru.remove(entry);
+        auto key = entry.key;
+        m_entries.remove(key);
+    }
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibGfx/ShareableBitmap.h>
+#include <LibGfx/Size.h>
+
+namespace ImageDecoder {
+
+// Keeps decoded frames around, keyed by a hash of the encoded data and the size the client asked for, so that decoding
+// the same image again only has to hand out the bitmaps. Frames are filled in as they are requested, which lets animated
+// images be decoded one frame at a time. Once more than max_size_in_bytes of bitmaps are held, the least recently used
+// images are thrown out.
+class DecodedImageCache {
+public:
+    static constexpr size_t max_size_in_bytes = 64 * MiB;
+
+    using Digest = Crypto::Hash::SHA256::DigestType;
+
+    struct Key {
+        Digest digest;
+        Optional<Gfx::IntSize> ideal_size;
+
+        bool operator==(Key const&) const;
+    };
+
+    struct Frame {
+        Gfx::ShareableBitmap bitmap;
+        u32 duration { 0 };
+    };
+
+    struct Entry {
+        Key key;
+        bool is_animated { false };
+        u32 loop_count { 0 };
+        Vector<Optional<Frame>> frames;
+        size_t size_in_bytes { 0 };
+        IntrusiveListNode<Entry> lru_node;
+    };
+
+    static DecodedImageCache& the();
+
+    static Key key_for(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size);
+
+    Entry* get(Key const&);
+    Entry& add(Key const&, bool is_animated, u32 loop_count, size_t frame_count);
+    void set_frame(Entry&, size_t index, Frame);
+
+private:
+    DecodedImageCache() = default;
+
+    struct KeyTraits : public GenericTraits<Key> {
+        static unsigned hash(Key const&);
+    };
+
+    void evict_until_below_budget(Entry const& keep);
+
+    HashMap<Key, NonnullOwnPtr<Entry>, KeyTraits> m_entries;
+    IntrusiveList<&Entry::lru_node> m_lru;
+    size_t m_size_in_bytes { 0 };
+};
+
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "LookupCache.h"
+#include <AK/Base64.h>
+#include <AK/Debug.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+
+namespace LookupServer {
+
+Optional<LookupCache::Result> LookupCache::find(Name const& name, RecordType record_type)
+{
+    auto it = m_entries.find({ name, record_type });
+    if (it == m_entries.end())
+        return {};
+
+    auto& entry = it->value;
+    auto now = time(nullptr);
+    bool is_stale = now >= entry.expiry_time;
+    // There's no point in pretending a name still doesn't exist, asking again is just as quick as asking the first time.
+    if (is_stale && entry.is_negative())
+        return {};
+
+    ++entry.hit_count;
+    entry.last_used = ++m_use_counter;
+
+    Result result { .answers = {}, .is_stale = is_stale };
+    // The TTL counts down from when we got the answer, so that whoever we hand it to doesn't keep it for longer than they should.
+    u32 ttl = is_stale ? stale_ttl : static_cast<u32>(entry.expiry_time - now);
+    for (auto& record : entry.records)
+        result.answers.empend(name, record_type, RecordClass::IN, ttl, record, false);
+
+    dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} ({}), {} records, {}", name.as_string(), record_type, entry.records.size(), is_stale ? "stale" : "fresh");
+    return result;
+}
+
+void LookupCache::insert(Name const& name, RecordType record_type, Vector<Answer> const& answers)
+{
+    if (answers.is_empty())
+        return;
+
+    Entry entry;
+    u32 ttl = maximum_ttl;
+    for (auto& answer : answers) {
+        ttl = min(ttl, answer.ttl());
+        entry.records.append(answer.record_data());
+    }
+    if (ttl == 0)
+        return;
+
+    entry.original_ttl = ttl;
+    entry.expiry_time = time(nullptr) + ttl;
+    set({ name, record_type }, move(entry));
+}
+
+void LookupCache::insert_negative(Name const& name, RecordType record_type)
+{
+    Entry entry;
+    entry.original_ttl = negative_ttl;
+    entry.expiry_time = time(nullptr) + negative_ttl;
+    set({ name, record_type }, move(entry));
+}
+
+void LookupCache::set(Key key, Entry entry)
+{
+    auto now = time(nullptr);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        // A name stays as popular as it was when it gets refreshed.
+        entry.hit_count = it->value.hit_count;
+        entry.last_used = it->value.last_used;
+    } else {
+        if (m_entries.size() >= maximum_entry_count)
+            evict_one_entry(now);
+        entry.last_used = ++m_use_counter;
+    }
+    m_entries.set(move(key), move(entry));
+    m_is_dirty = true;
+}
+
+void LookupCache::evict_one_entry(time_t now)
+{
+    VERIFY(!m_entries.is_empty());
+
+    // Anything that's expired is worth less than anything that isn't, regardless of how recently it was used.
+    auto victim = m_entries.begin();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        bool is_expired = now >= it->value.expiry_time;
+        bool victim_is_expired = now >= victim->value.expiry_time;
+        if (is_expired != victim_is_expired) {
+            if (is_expired)
+                victim = it;
+            continue;
+        }
+        if (it->value.last_used < victim->value.last_used)
+            victim = it;
+    }
+    dbgln_if(LOOKUPSERVER_DEBUG, "Evicting cache entry: {} ({})", victim->key.name.as_string(), victim->key.record_type);
+    m_entries.remove(victim);
+}
+
+Vector<LookupCache::Key> LookupCache::keys_to_prefetch()
+{
+    auto now = time(nullptr);
+    Vector<Key> keys;
+    for (auto& it : m_entries) {
+        auto& entry = it.value;
+        if (entry.is_negative() || entry.has_been_prefetched || entry.hit_count < prefetch_minimum_hit_count)
+            continue;
+        // Look it up again during the last tenth of its lifetime, but no sooner than a few seconds before it expires.
+        auto prefetch_window = max<time_t>(entry.original_ttl / 10, 5);
+        if (now < entry.expiry_time - prefetch_window)
+            continue;
+        entry.has_been_prefetched = true;
+        keys.append(it.key);
+    }
+    return keys;
+}
+
+void LookupCache::remove_expired_entries()
+{
+    auto now = time(nullptr);
+    auto removed = m_entries.remove_all_matching([&](auto&, auto& entry) {
+        auto usable_until = entry.expiry_time + (entry.is_negative() ? 0 : maximum_stale_duration);
+        return now >= usable_until;
+    });
+    if (removed)
+        m_is_dirty = true;
+}
+
+ErrorOr<void> LookupCache::load_from_file(StringView path)
+{
+    auto file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Read));
+    auto contents = TRY(file->read_all());
+    auto json = TRY(JsonValue::from_string(contents));
+    if (!json.is_array())
+        return Error::from_string_literal("Expected the cache to be an array");
+
+    auto now = time(nullptr);
+    for (auto& value : json.as_array().values()) {
+        if (!value.is_object())
+            continue;
+        auto& object = value.as_object();
+
+        Entry entry;
+        entry.expiry_time = object.get("expires"sv).to_i64();
+        entry.original_ttl = min(object.get("ttl"sv).to_u32(), maximum_ttl);
+        entry.hit_count = object.get("hits"sv).to_u32();
+        auto records = object.get("records"sv);
+        if (records.is_array()) {
+            for (auto& record : records.as_array().values()) {
+                auto data = decode_base64(record.as_string_or(""sv));
+                if (data.is_error())
+                    continue;
+                entry.records.append(String::copy(data.value()));
+            }
+        }
+
+        // Don't bring back anything we wouldn't have kept around if we'd never gone away.
+        auto usable_until = entry.expiry_time + (entry.is_negative() ? 0 : maximum_stale_duration);
+        if (now >= usable_until || entry.expiry_time > now + maximum_ttl)
+            continue;
+
+        Key key { object.get("name"sv).as_string_or(""sv), static_cast<RecordType>(object.get("type"sv).to_u32()) };
+        if (key.name.as_string().is_empty() || m_entries.size() >= maximum_entry_count)
+            continue;
+        entry.last_used = ++m_use_counter;
+        m_entries.set(move(key), move(entry));
+    }
+
+    dbgln_if(LOOKUPSERVER_DEBUG, "Loaded {} cache entries from {}", m_entries.size(), path);
+    return {};
+}
+
+ErrorOr<void> LookupCache::save_to_file(StringView path)
+{
+    JsonArray json;
+    for (auto& it : m_entries) {
+        auto& entry = it.value;
+        JsonObject object;
+        object.set("name", it.key.name.as_string());
+        object.set("type", to_underlying(it.key.record_type));
+        object.set("expires", static_cast<i64>(entry.expiry_time));
+        object.set("ttl", entry.original_ttl);
+        object.set("hits", static_cast<u64>(entry.hit_count));
+        JsonArray records;
+        for (auto& record : entry.records)
+            records.append(encode_base64(record.bytes()));
+        object.set("records", move(records));
+        json.append(move(object));
+    }
+
+    // Write it next to the old one first, so that we never leave a half-written cache behind.
+    auto temporary_path = String::formatted("{}.new", path);
+    {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate));
+        if (!file->write_or_error(json.to_string().bytes()))
+            return Error::from_string_literal("Failed to write the cache");
+    }
+    TRY(Core::System::rename(temporary_path, path));
+
+    m_is_dirty = false;
+    dbgln_if(LOOKUPSERVER_DEBUG, "Saved {} cache entries to {}", m_entries.size(), path);
+    return {};
+}
+
+}
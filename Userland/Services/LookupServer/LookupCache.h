@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibDNS/Answer.h>
+#include <LibDNS/Name.h>
+#include <time.h>
+
+namespace LookupServer {
+
+using namespace DNS;
+
+// Remembers the answers to the questions we've asked upstream, for as long as their TTL allows.
+// Names that don't exist are remembered too (RFC 2308), and answers that have just expired are still
+// handed out for a while, so that one slow lookup doesn't hold up everyone who asks for the same name (RFC 8767).
+class LookupCache {
+public:
+    static constexpr size_t maximum_entry_count = 1024;
+
+    // Nobody should have to wait a whole day to see a changed record.
+    static constexpr u32 maximum_ttl = 86400;
+
+    // We don't parse the authority section, so the SOA record that would tell us how long to remember
+    // that a name doesn't exist is not available to us.
+    static constexpr u32 negative_ttl = 300;
+
+    // How long after expiring an answer may still be used while a fresh one is being looked up,
+    // and what TTL we give it in the meantime.
+    static constexpr time_t maximum_stale_duration = 86400;
+    static constexpr u32 stale_ttl = 30;
+
+    // Names that were asked for at least this often are looked up again shortly before they expire.
+    static constexpr size_t prefetch_minimum_hit_count = 3;
+
+    struct Key {
+        Name name;
+        RecordType record_type;
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public AK::Traits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(Name::Traits::hash(key.name), to_underlying(key.record_type)); }
+        static bool equals(Key const& a, Key const& b) { return Name::Traits::equals(a.name, b.name) && a.record_type == b.record_type; }
+    };
+
+    struct Result {
+        // Empty if the name (or this type of record for it) is known not to exist.
+        Vector<Answer> answers;
+        bool is_stale { false };
+    };
+
+    // Returns nothing if we know nothing about the name, or only a negative answer that has expired.
+    Optional<Result> find(Name const&, RecordType);
+
+    // Answers with a TTL of zero are not meant to be cached, and aren't.
+    void insert(Name const&, RecordType, Vector<Answer> const&);
+    void insert_negative(Name const&, RecordType);
+
+    // The names that are popular enough to be worth looking up again before they expire.
+    Vector<Key> keys_to_prefetch();
+
+    // Throws out whatever is too old to be served even as a stale answer.
+    void remove_expired_entries();
+
+    ErrorOr<void> load_from_file(StringView path);
+    ErrorOr<void> save_to_file(StringView path);
+
+    bool is_dirty() const { return m_is_dirty; }
+    size_t size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        // Just the record data, the name and type are in the key.
+        Vector<String> records;
+        time_t expiry_time { 0 };
+        u32 original_ttl { 0 };
+        size_t hit_count { 0 };
+        u64 last_used { 0 };
+        bool has_been_prefetched { false };
+
+        bool is_negative() const { return records.is_empty(); }
+    };
+
+    void set(Key, Entry);
+    void evict_one_entry(time_t now);
+
+    HashMap<Key, Entry, KeyTraits> m_entries;
+    u64 m_use_counter { 0 };
+    bool m_is_dirty { false };
+};
+
+}
@@ -9,14 +9,21 @@
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
 #include <AK/Random.h>
+#include <AK/ScopeGuard.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
+#include <AK/Time.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/SocketAddress.h>
 #include <LibCore/Stream.h>
+#include <LibCore/System.h>
 #include <LibDNS/Packet.h>
+#include <errno.h>
+#include <poll.h>
 #include <stdio.h>
+#include <sys/socket.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -25,6 +32,8 @@ namespace LookupServer {
 static LookupServer* s_the;
 // NOTE: This is the TTL we return for the hostname or answers from /etc/hosts.
 static constexpr u32 s_static_ttl = 86400;
+// NOTE: Keeping the cache around means that we don't have to start from scratch when we get restarted.
+static constexpr StringView s_cache_path = "/var/cache/LookupServer/cache.json"sv;
 
 LookupServer& LookupServer::the()
 {
@@ -72,6 +81,11 @@ LookupServer::LookupServer()
     }
     m_mdns = MulticastDNS::construct(this);
 
+    if (auto result = m_cache.load_from_file(s_cache_path); result.is_error() && !(result.error().is_errno() && result.error().code() == ENOENT))
+        dbgln("Failed to load the cache from '{}': {}", s_cache_path, result.error());
+    m_maintenance_timer = Core::Timer::create_repeating(15'000, [this] { do_maintenance(); }, this);
+    m_maintenance_timer->start();
+
     m_server = MUST(IPC::MultiServer<ConnectionFromClient>::try_create());
 }
 
@@ -169,107 +183,136 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
     }
 
     // Third, try our cache.
-    if (auto cached_answers = m_lookup_cache.find(name); cached_answers != m_lookup_cache.end()) {
-        for (auto& answer : cached_answers->value) {
-            // TODO: Actually remove expired answers from the cache.
-            if (answer.type() == record_type && !answer.has_expired()) {
-                dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", name.as_string(), answer.record_data());
-                add_answer(answer);
-            }
-        }
-        if (!answers.is_empty())
-            return answers;
+    if (auto cached = m_cache.find(name, record_type); cached.has_value()) {
+        // Whoever asked gets the answer we have right away, and the next one to ask gets a fresh one.
+        if (cached->is_stale)
+            schedule_refresh(name, record_type);
+        for (auto& answer : cached->answers)
+            add_answer(answer);
+        return answers;
     }
 
     // Fourth, look up .local names using mDNS instead of DNS nameservers.
     if (name.as_string().ends_with(".local"sv)) {
         answers = m_mdns->lookup(name, record_type);
-        for (auto& answer : answers)
-            put_in_cache(answer);
+        m_cache.insert(name, record_type, answers);
         return answers;
     }
 
     // Fifth, ask the upstream nameservers.
-    for (auto& nameserver : m_nameservers) {
-        dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}'", nameserver);
-        bool did_get_response = false;
-        int retries = 3;
-        Vector<Answer> upstream_answers;
-        do {
-            auto upstream_answers_or_error = lookup(name, nameserver, did_get_response, record_type);
-            if (upstream_answers_or_error.is_error())
-                continue;
-            upstream_answers = upstream_answers_or_error.release_value();
-            if (did_get_response)
-                break;
-        } while (--retries);
-        if (!upstream_answers.is_empty()) {
-            for (auto& answer : upstream_answers)
-                add_answer(answer);
-            break;
-        } else {
-            if (!did_get_response)
-                dbgln("Never got a response from '{}', trying next nameserver", nameserver);
-            else
-                dbgln("Received response from '{}' but no result(s), trying next nameserver", nameserver);
-        }
+    auto upstream_answers = lookup_upstream_and_cache(name, record_type);
+    if (upstream_answers.is_error()) {
+        // Sixth, fail.
+        dbgln("Tried all nameservers but never got a response :( ({})", upstream_answers.error());
+        return Vector<Answer> {};
     }
 
-    // Sixth, fail.
-    if (answers.is_empty()) {
-        dbgln("Tried all nameservers but never got a response :(");
+    for (auto& answer : upstream_answers.value())
+        add_answer(answer);
+    return answers;
+}
+
+ErrorOr<Vector<Answer>> LookupServer::lookup_upstream_and_cache(Name const& name, RecordType record_type)
+{
+    auto response = TRY(lookup_upstream(name, record_type));
+    if (response.answers.is_empty()) {
+        dbgln_if(LOOKUPSERVER_DEBUG, "'{}' has no {} records ({})", name.as_string(), record_type, response.code == Packet::Code::NXDOMAIN ? "NXDOMAIN" : "NODATA");
+        m_cache.insert_negative(name, record_type);
         return Vector<Answer> {};
     }
 
-    return answers;
+    m_cache.insert(name, record_type, response.answers);
+    return response.answers;
 }
 
-ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, String const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase should_randomize_case)
+void LookupServer::schedule_refresh(Name const& name, RecordType record_type)
 {
-    Packet request;
-    request.set_is_query();
-    request.set_id(get_random_uniform(UINT16_MAX));
-    Name name_in_question = name;
-    if (should_randomize_case == ShouldRandomizeCase::Yes)
-        name_in_question.randomize_case();
-    request.add_question({ name_in_question, record_type, RecordClass::IN, false });
+    LookupCache::Key key { name, record_type };
+    if (m_pending_refreshes.contains(key))
+        return;
+    m_pending_refreshes.set(key);
+
+    deferred_invoke([this, key = move(key)] {
+        m_pending_refreshes.remove(key);
+        dbgln_if(LOOKUPSERVER_DEBUG, "Refreshing cache entry for '{}' ({})", key.name.as_string(), key.record_type);
+        // If none of the nameservers answer, we keep the answer we have for as long as we're allowed to use it.
+        if (auto result = lookup_upstream_and_cache(key.name, key.record_type); result.is_error())
+            dbgln("Failed to refresh '{}': {}", key.name.as_string(), result.error());
+    });
+}
 
-    auto buffer = request.to_byte_buffer();
+void LookupServer::do_maintenance()
+{
+    m_cache.remove_expired_entries();
 
-    auto udp_socket = TRY(Core::Stream::UDPSocket::connect(nameserver, 53, Time::from_seconds(1)));
-    TRY(udp_socket->set_blocking(true));
+    for (auto& key : m_cache.keys_to_prefetch())
+        schedule_refresh(key.name, key.record_type);
 
-    TRY(udp_socket->write(buffer));
+    if (m_cache.is_dirty()) {
+        if (auto result = m_cache.save_to_file(s_cache_path); result.is_error())
+            dbgln("Failed to save the cache to '{}': {}", s_cache_path, result.error());
+    }
+}
 
-    u8 response_buffer[4096];
-    int nrecv = TRY(udp_socket->read({ response_buffer, sizeof(response_buffer) })).size();
-    if (udp_socket->is_eof())
-        return Vector<Answer> {};
+// Happy Eyeballs (RFC 8305) for nameservers: the first one gets a head start, and whoever answers first wins.
+static constexpr i64 s_nameserver_stagger_delay_ms = 200;
+static constexpr auto s_retransmit_timeout = Time::from_seconds(1);
+static constexpr int s_max_attempts_per_nameserver = 3;
 
-    did_get_response = true;
+struct UpstreamQuery {
+    String nameserver;
+    int fd { -1 };
+    Packet request;
+    ShouldRandomizeCase should_randomize_case { ShouldRandomizeCase::Yes };
+    int attempts { 0 };
+    Time last_sent;
+    bool has_given_up { false };
+};
 
-    auto o_response = Packet::from_raw_packet(response_buffer, nrecv);
-    if (!o_response.has_value())
-        return Vector<Answer> {};
+static ErrorOr<void> send_upstream_query(UpstreamQuery& query, Name const& name, RecordType record_type)
+{
+    if (query.fd < 0) {
+        auto address = IPv4Address::from_string(query.nameserver);
+        if (!address.has_value())
+            return Error::from_string_literal("Nameserver is not an IPv4 address");
+        query.fd = TRY(Core::System::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+        auto sockaddr = Core::SocketAddress(address.value(), 53).to_sockaddr_in();
+        // A connected socket only hears from the nameserver, and tells us right away if it's unreachable.
+        TRY(Core::System::connect(query.fd, bit_cast<struct sockaddr const*>(&sockaddr), sizeof(sockaddr)));
+    }
 
-    auto& response = o_response.value();
+    // Retransmissions reuse the request, so that a late answer to an earlier one still counts.
+    if (query.attempts == 0 || query.request.question_count() == 0) {
+        query.request = {};
+        query.request.set_is_query();
+        query.request.set_id(get_random_uniform(UINT16_MAX));
+        Name name_in_question = name;
+        if (query.should_randomize_case == ShouldRandomizeCase::Yes)
+            name_in_question.randomize_case();
+        query.request.add_question({ name_in_question, record_type, RecordClass::IN, false });
+    }
 
+    auto buffer = query.request.to_byte_buffer();
+    ++query.attempts;
+    query.last_sent = Time::now_monotonic();
+    TRY(Core::System::send(query.fd, buffer.data(), buffer.size(), 0));
+    return {};
+}
+
+static bool response_matches_request(Packet const& response, Packet const& request)
+{
     if (response.id() != request.id()) {
         dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), request.id());
-        return Vector<Answer> {};
+        return false;
     }
 
-    if (response.code() == Packet::Code::REFUSED) {
-        if (should_randomize_case == ShouldRandomizeCase::Yes) {
-            // Retry with 0x20 case randomization turned off.
-            return lookup(name, nameserver, did_get_response, record_type, ShouldRandomizeCase::No);
-        }
-        return Vector<Answer> {};
-    }
+    // FIXME: Packet doesn't parse anything past the header of error responses, so all we can check for those is the ID.
+    if (response.code() != Packet::Code::NOERROR)
+        return true;
 
     if (response.question_count() != request.question_count()) {
         dbgln("LookupServer: Question count ({} vs {}) :(", response.question_count(), request.question_count());
-        return Vector<Answer> {};
+        return false;
     }
 
     // Verify the questions in our request and in their response match, ignoring case.
@@ -283,55 +326,125 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, String const& nam
             dbgln("Request and response questions do not match");
             dbgln("   Request: name=_{}_, type={}, class={}", request_question.name().as_string(), response_question.record_type(), response_question.class_code());
             dbgln("  Response: name=_{}_, type={}, class={}", response_question.name().as_string(), response_question.record_type(), response_question.class_code());
-            return Vector<Answer> {};
+            return false;
         }
     }
+    return true;
+}
 
-    if (response.answer_count() < 1) {
-        dbgln("LookupServer: No answers :(");
-        return Vector<Answer> {};
+ErrorOr<LookupServer::UpstreamResponse> LookupServer::lookup_upstream(Name const& name, RecordType record_type)
+{
+    Vector<UpstreamQuery> queries;
+    for (auto& nameserver : m_nameservers) {
+        UpstreamQuery query;
+        query.nameserver = nameserver;
+        queries.append(move(query));
     }
 
-    Vector<Answer, 8> answers;
-    for (auto& answer : response.answers()) {
-        put_in_cache(answer);
-        if (answer.type() != record_type)
-            continue;
-        answers.append(answer);
-    }
+    ScopeGuard close_sockets = [&] {
+        for (auto& query : queries) {
+            if (query.fd >= 0)
+                (void)Core::System::close(query.fd);
+        }
+    };
 
-    return answers;
-}
+    auto start_time = Time::now_monotonic();
+    while (true) {
+        auto now = Time::now_monotonic();
+        Optional<Time> next_wakeup;
+        auto wake_up_at = [&](Time time) {
+            if (!next_wakeup.has_value() || time < *next_wakeup)
+                next_wakeup = time;
+        };
 
-void LookupServer::put_in_cache(Answer const& answer)
-{
-    if (answer.has_expired())
-        return;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            auto& query = queries[i];
+            if (query.has_given_up)
+                continue;
 
-    // Prevent the cache from growing too big.
-    // TODO: Evict least used entries.
-    if (m_lookup_cache.size() >= 256)
-        m_lookup_cache.remove(m_lookup_cache.begin());
+            auto query_start_time = start_time + Time::from_milliseconds(s_nameserver_stagger_delay_ms * static_cast<i64>(i));
+            if (query.attempts == 0 && now < query_start_time) {
+                wake_up_at(query_start_time);
+                continue;
+            }
 
-    auto it = m_lookup_cache.find(answer.name());
-    if (it == m_lookup_cache.end())
-        m_lookup_cache.set(answer.name(), { answer });
-    else {
-        if (answer.mdns_cache_flush()) {
-            auto now = time(nullptr);
+            if (query.attempts == 0 || now >= query.last_sent + s_retransmit_timeout) {
+                if (query.attempts == s_max_attempts_per_nameserver) {
+                    dbgln("Never got a response from '{}'", query.nameserver);
+                    query.has_given_up = true;
+                    continue;
+                }
+                dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}' (attempt {})", query.nameserver, query.attempts + 1);
+                if (auto result = send_upstream_query(query, name, record_type); result.is_error()) {
+                    dbgln("Failed to send query to '{}': {}", query.nameserver, result.error());
+                    query.has_given_up = true;
+                    continue;
+                }
+            }
+            wake_up_at(query.last_sent + s_retransmit_timeout);
+        }
 
-            it->value.remove_all_matching([&](Answer const& other_answer) {
-                if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
-                    return false;
+        if (!next_wakeup.has_value())
+            return Error::from_string_literal("None of the nameservers gave us an answer");
 
-                if (other_answer.received_time() >= now - 1)
-                    return false;
+        Vector<pollfd> fds;
+        Vector<size_t> query_indices;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            if (queries[i].has_given_up || queries[i].attempts == 0)
+                continue;
+            fds.append({ queries[i].fd, POLLIN, 0 });
+            query_indices.append(i);
+        }
+
+        auto timeout = max<i64>(0, (*next_wakeup - Time::now_monotonic()).to_milliseconds());
+        int rc = poll(fds.data(), fds.size(), static_cast<int>(timeout));
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            return Error::from_syscall("poll"sv, -errno);
+        }
+
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (!fds[i].revents)
+                continue;
+            auto& query = queries[query_indices[i]];
+
+            u8 response_buffer[4096];
+            auto nrecv = Core::System::recv(query.fd, response_buffer, sizeof(response_buffer), 0);
+            if (nrecv.is_error()) {
+                dbgln("Failed to receive a response from '{}': {}", query.nameserver, nrecv.error());
+                query.has_given_up = true;
+                continue;
+            }
+
+            auto o_response = Packet::from_raw_packet(response_buffer, nrecv.value());
+            if (!o_response.has_value() || !response_matches_request(o_response.value(), query.request))
+                continue;
+            auto& response = o_response.value();
+
+            if (response.code() == Packet::Code::REFUSED && query.should_randomize_case == ShouldRandomizeCase::Yes) {
+                // Retry with 0x20 case randomization turned off.
+                query.should_randomize_case = ShouldRandomizeCase::No;
+                query.attempts = 0;
+                if (auto result = send_upstream_query(query, name, record_type); result.is_error())
+                    query.has_given_up = true;
+                continue;
+            }
 
-                dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
-                return true;
-            });
+            if (response.code() != Packet::Code::NOERROR && response.code() != Packet::Code::NXDOMAIN) {
+                dbgln("Received response from '{}' but no result(s), trying the other nameservers", query.nameserver);
+                query.has_given_up = true;
+                continue;
+            }
+
+            UpstreamResponse upstream_response { .code = response.code(), .answers = {} };
+            for (auto& answer : response.answers()) {
+                if (answer.type() == record_type)
+                    upstream_response.answers.append(answer);
+            }
+            dbgln_if(LOOKUPSERVER_DEBUG, "'{}' answered first, after {}ms", query.nameserver, (Time::now_monotonic() - start_time).to_milliseconds());
+            return upstream_response;
         }
-        it->value.append(answer);
     }
 }
 
@@ -8,9 +8,12 @@
 
 #include "ConnectionFromClient.h"
 #include "DNSServer.h"
+#include "LookupCache.h"
 #include "MulticastDNS.h"
+#include <AK/HashTable.h>
 #include <LibCore/FileWatcher.h>
 #include <LibCore/Object.h>
+#include <LibCore/Timer.h>
 #include <LibDNS/Name.h>
 #include <LibDNS/Packet.h>
 #include <LibIPC/MultiServer.h>
@@ -30,9 +33,19 @@ private:
     LookupServer();
 
     void load_etc_hosts();
-    void put_in_cache(Answer const&);
 
-    ErrorOr<Vector<Answer>> lookup(Name const& hostname, String const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase = ShouldRandomizeCase::Yes);
+    struct UpstreamResponse {
+        Packet::Code code { Packet::Code::NOERROR };
+        Vector<Answer> answers;
+    };
+
+    // Asks all the nameservers, one after the other in quick succession, and goes with whoever answers first.
+    ErrorOr<UpstreamResponse> lookup_upstream(Name const&, RecordType);
+    ErrorOr<Vector<Answer>> lookup_upstream_and_cache(Name const&, RecordType);
+
+    // Looks the name up again without making anyone wait for it.
+    void schedule_refresh(Name const&, RecordType);
+    void do_maintenance();
 
     OwnPtr<IPC::MultiServer<ConnectionFromClient>> m_server;
     RefPtr<DNSServer> m_dns_server;
@@ -40,7 +53,9 @@ private:
     Vector<String> m_nameservers;
     RefPtr<Core::FileWatcher> m_file_watcher;
     HashMap<Name, Vector<Answer>, Name::Traits> m_etc_hosts;
-    HashMap<Name, Vector<Answer>, Name::Traits> m_lookup_cache;
+    LookupCache m_cache;
+    HashTable<LookupCache::Key, LookupCache::KeyTraits> m_pending_refreshes;
+    RefPtr<Core::Timer> m_maintenance_timer;
 };
 
 }
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <serenity.h>
+#include <unistd.h>
+
+static ErrorOr<void> drain_continuous_profile(StringView directory)
+{
+    auto profile_file = TRY(Core::Stream::File::open("/sys/kernel/continuous_profile"sv, Core::Stream::OpenMode::Read));
+    auto profile = TRY(profile_file->read_all());
+
+    // The name says when the profile was drained, it covers the time since the previous one.
+    auto path = String::formatted("{}/{}.perfcore", directory, Core::DateTime::now().to_string("%Y-%m-%d-%H-%M-%S"sv));
+    auto output_file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Write, 0600));
+    if (!output_file->write_or_error(profile))
+        return Error::from_string_literal("Failed to write the profile");
+    return {};
+}
+
+static ErrorOr<void> remove_old_profiles(StringView directory, size_t profiles_to_keep)
+{
+    Core::DirIterator iterator(directory, Core::DirIterator::SkipDots);
+    if (iterator.has_error())
+        return Error::from_errno(iterator.error());
+
+    Vector<String> profiles;
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        if (path.ends_with(".perfcore"sv))
+            profiles.append(move(path));
+    }
+    if (profiles.size() <= profiles_to_keep)
+        return {};
+
+    // The timestamps in the names sort them from old to new.
+    quick_sort(profiles);
+    for (size_t i = 0; i < profiles.size() - profiles_to_keep; ++i)
+        TRY(Core::System::unlink(profiles[i]));
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    StringView directory = "/tmp/profiles"sv;
+    unsigned interval_in_seconds = 60;
+    size_t profiles_to_keep = 60;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Continuously profile the whole system at a low rate, keeping the most recent profiles on disk.");
+    args_parser.add_option(directory, "Directory to write the profiles to", "directory", 'd', "directory");
+    args_parser.add_option(interval_in_seconds, "Seconds between two profiles", "interval", 'i', "seconds");
+    args_parser.add_option(profiles_to_keep, "Number of profiles to keep", "keep", 'k', "count");
+    args_parser.parse(arguments);
+
+    if (interval_in_seconds == 0 || profiles_to_keep == 0) {
+        warnln("The interval and the number of profiles to keep must not be zero");
+        return 1;
+    }
+
+    // Enabling the profiler requires not having any promises, so we have to do it before pledging.
+    TRY(Core::System::profiling_enable(PROFILING_CONTINUOUS_PID, PERF_EVENT_SAMPLE));
+
+    TRY(Core::System::pledge("stdio rpath wpath cpath"));
+
+    if (auto result = Core::System::mkdir(directory, 0700); result.is_error() && result.error().code() != EEXIST)
+        return result.release_error();
+
+    TRY(Core::System::unveil("/sys/kernel/continuous_profile"sv, "r"sv));
+    TRY(Core::System::unveil(directory, "rwc"sv));
+    TRY(Core::System::unveil(nullptr, nullptr));
+
+    while (true) {
+        sleep(interval_in_seconds);
+
+        if (auto result = drain_continuous_profile(directory); result.is_error()) {
+            warnln("Failed to write the continuous profile: {}", result.error());
+            continue;
+        }
+        if (auto result = remove_old_profiles(directory, profiles_to_keep); result.is_error())
+            warnln("Failed to remove old profiles: {}", result.error());
+    }
+}
@@ -1,5 +1,6 @@
 /*
  * Copyright (c) 2021-2022, Ali Mohammad Pur <mpfard@serenityos.org>
+ * Copyright (c) 2022, the SerenityOS developers.
  *
  * SPDX-License-Identifier: BSD-2-Clause
  */
@@ -7,12 +8,50 @@
 #include "ConnectionCache.h"
 #include <AK/Debug.h>
 #include <AK/Find.h>
+#include <AK/HashTable.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
 #include <LibCore/EventLoop.h>
 
 namespace RequestServer::ConnectionCache {
 
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::Stream::TCPSocket, Core::Stream::Socket>>>> g_tcp_connection_cache {};
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache {};
+NonnullRefPtr<TLS::SessionCache> g_tls_session_cache = TLS::SessionCache::create();
+Limits g_limits {};
+Statistics g_statistics {};
+
+static constexpr size_t MaxPreconnectHintedHosts = 256;
+static HashTable<String> s_preconnect_hinted_hosts;
+
+static String preconnect_hint_key(URL const& url)
+{
+    return String::formatted("{}://{}:{}", url.scheme(), url.host(), url.port_or_default());
+}
+
+void did_hint_preconnect_to(URL const& url)
+{
+    // Hints are only useful for the pages that are currently being loaded, so start over rather than growing forever.
+    if (s_preconnect_hinted_hosts.size() >= MaxPreconnectHintedHosts)
+        s_preconnect_hinted_hosts.clear();
+    s_preconnect_hinted_hosts.set(preconnect_hint_key(url));
+}
+
+bool was_hinted_for_preconnect(URL const& url)
+{
+    return s_preconnect_hinted_hosts.contains(preconnect_hint_key(url));
+}
+
+TLS::Options create_tls_options(URL const& url)
+{
+    TLS::Options options;
+    options.set_session_cache(g_tls_session_cache);
+    options.set_session_cache_key(String::formatted("{}:{}", url.host(), url.port_or_default()));
+    // Anything else that runs over TLS (like Gemini) has nothing to negotiate.
+    if (url.scheme() == "https"sv)
+        options.set_alpn_protocols({ "h2", "http/1.1" });
+    return options;
+}
 
 void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
 {
@@ -37,36 +76,27 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
         }
 
         auto& connection = *connection_it;
+        if (connection->http2_connection) {
+            // Streams come and go on their own, so queued requests can start as soon as the server lets us open another one.
+            while (!connection->request_queue.is_empty() && connection->http2_connection->can_open_stream())
+                start_next_queued_job(*connection);
+            if (connection->http2_connection->active_stream_count() > 0)
+                return;
+            // Otherwise, the connection is either idle now, or the rest of the queue needs a new one.
+        }
+
         if (connection->request_queue.is_empty()) {
-            Core::deferred_invoke([&connection, &cache_entry = *it->value, key = it->key, &cache] {
-                connection->socket->set_notifications_enabled(false);
-                connection->has_started = false;
-                connection->current_url = {};
-                connection->job_data = {};
-                connection->removal_timer->on_timeout = [ptr = connection.ptr(), &cache_entry, key = move(key), &cache]() mutable {
-                    Core::deferred_invoke([&, key = move(key), ptr] {
-                        dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", ptr, ptr->socket);
-                        auto did_remove = cache_entry.remove_first_matching([&](auto& entry) { return entry == ptr; });
-                        VERIFY(did_remove);
-                        if (cache_entry.is_empty())
-                            cache.remove(key);
-                    });
-                };
-                connection->removal_timer->start();
+            Core::deferred_invoke([&connection, key = it->key, &cache] {
+                did_become_idle(cache, key, *connection);
             });
+        } else if (needs_new_socket(*connection)) {
+            dbgln_if(REQUESTSERVER_DEBUG, "Reconnecting {} for the next job in its queue", connection.ptr());
+            start_connecting(cache, it->key, *connection, url);
         } else {
-            if (auto result = recreate_socket_if_needed(*connection, url); result.is_error()) {
-                dbgln("ConnectionCache request finish handler, reconnection failed with {}", result.error());
-                connection->job_data.fail(Core::NetworkJob::Error::ConnectionFailed);
-                return;
-            }
-            Core::deferred_invoke([&, url] {
-                dbgln_if(REQUESTSERVER_DEBUG, "Running next job in queue for connection {} @{}", &connection, connection->socket);
-                connection->timer.start();
-                connection->current_url = url;
-                connection->job_data = connection->request_queue.take_first();
-                connection->socket->set_notifications_enabled(true);
-                connection->job_data.start(*connection->socket);
+            Core::deferred_invoke([&] {
+                dbgln_if(REQUESTSERVER_DEBUG, "Running next job in queue for connection {} @{}", &connection, connection->socket.ptr());
+                ++g_statistics.connections_reused;
+                start_queued_jobs(*connection);
             });
         }
     };
@@ -82,27 +112,102 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
 void dump_jobs()
 {
     dbgln("=========== TLS Connection Cache ==========");
+    dbgln(" Session cache: {} hits, {} misses, {} resumed, {} rejected by the server",
+        g_tls_session_cache->hits(), g_tls_session_cache->misses(), g_tls_session_cache->resumptions(), g_tls_session_cache->rejections());
     for (auto& connection : g_tls_connection_cache) {
         dbgln(" - {}:{}", connection.key.hostname, connection.key.port);
         for (auto& entry : *connection.value) {
-            dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
+            dbgln("  - Connection {} (started={}) (connecting={}) (socket={})", &entry, entry.has_started, entry.is_connecting(), entry.socket.ptr());
+            if (entry.http2_connection)
+                dbgln("    HTTP/2 with {} active streams (going away={})", entry.http2_connection->active_stream_count(), entry.http2_connection->is_going_away());
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
-                dbgln("    - {}", &job);
+                dbgln("    - {} ({} priority)", job.url, to_string(job.priority));
         }
     }
     dbgln("=========== TCP Connection Cache ==========");
     for (auto& connection : g_tcp_connection_cache) {
         dbgln(" - {}:{}", connection.key.hostname, connection.key.port);
         for (auto& entry : *connection.value) {
-            dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
+            dbgln("  - Connection {} (started={}) (connecting={}) (socket={})", &entry, entry.has_started, entry.is_connecting(), entry.socket.ptr());
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
-                dbgln("    - {}", &job);
+                dbgln("    - {} ({} priority)", job.url, to_string(job.priority));
+        }
+    }
+}
+
+template<typename CacheType>
+static void append_pools_as_json(JsonArray& pools, StringView protocol, CacheType const& cache)
+{
+    for (auto& pool : cache) {
+        JsonArray connections;
+        for (auto& connection : *pool.value) {
+            JsonArray queue;
+            for (auto& job : connection.request_queue) {
+                JsonObject queued_request;
+                queued_request.set("url", job.url.to_string());
+                queued_request.set("priority", to_string(job.priority));
+                queued_request.set("waiting_milliseconds", job.queued_timer.is_valid() ? job.queued_timer.elapsed() : 0);
+                queue.append(move(queued_request));
+            }
+
+            JsonObject connection_object;
+            connection_object.set("busy", connection.has_started);
+            connection_object.set("connecting", connection.is_connecting());
+            if (connection.has_started) {
+                connection_object.set("current_url", connection.current_url.to_string());
+                connection_object.set("elapsed_milliseconds", connection.timer.is_valid() ? connection.timer.elapsed() : 0);
+            }
+            connection_object.set("requests_served_by_socket", connection.requests_served_by_socket);
+            connection_object.set("http2", !connection.http2_connection.is_null());
+            if (connection.http2_connection)
+                connection_object.set("http2_active_streams", connection.http2_connection->active_stream_count());
+            connection_object.set("queue", move(queue));
+            connections.append(move(connection_object));
         }
+
+        JsonObject pool_object;
+        pool_object.set("protocol", protocol);
+        pool_object.set("host", pool.key.hostname);
+        pool_object.set("port", pool.key.port);
+        pool_object.set("connections", move(connections));
+        pools.append(move(pool_object));
     }
 }
 
+String statistics_as_json()
+{
+    JsonObject limits;
+    limits.set("max_connections_per_host", g_limits.max_connections_per_host);
+    limits.set("max_requests_per_connection", g_limits.max_requests_per_connection);
+    limits.set("idle_timeout_milliseconds", g_limits.idle_timeout_milliseconds);
+
+    JsonObject statistics;
+    statistics.set("connections_created", g_statistics.connections_created);
+    statistics.set("connections_reused", g_statistics.connections_reused);
+    statistics.set("connections_closed_after_idle_timeout", g_statistics.connections_closed_after_idle_timeout);
+    statistics.set("sockets_replaced_after_request_limit", g_statistics.sockets_replaced_after_request_limit);
+    statistics.set("preconnects", g_statistics.preconnects);
+    statistics.set("requests_started_immediately", g_statistics.requests_started_immediately);
+    statistics.set("requests_queued", g_statistics.requests_queued);
+    statistics.set("total_queued_milliseconds", g_statistics.total_queued_milliseconds);
+    statistics.set("longest_queued_milliseconds", g_statistics.longest_queued_milliseconds);
+    statistics.set("http2_connections_created", g_statistics.http2_connections_created);
+    statistics.set("http2_streams_started", g_statistics.http2_streams_started);
+    statistics.set("connection_failures", g_statistics.connection_failures);
+
+    JsonArray pools;
+    append_pools_as_json(pools, "https"sv, g_tls_connection_cache);
+    append_pools_as_json(pools, "http"sv, g_tcp_connection_cache);
+
+    JsonObject object;
+    object.set("limits", move(limits));
+    object.set("statistics", move(statistics));
+    object.set("pools", move(pools));
+    return object.to_string();
+}
+
 }
@@ -16,8 +16,11 @@
 #include <LibCore/EventLoop.h>
 #include <LibCore/NetworkJob.h>
 #include <LibCore/SOCKSProxyClient.h>
+#include <LibCore/TCPConnector.h>
 #include <LibCore/Timer.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibTLS/TLSv12.h>
+#include <RequestServer/RequestPriority.h>
 
 namespace RequestServer {
 
@@ -58,15 +61,20 @@ template<typename Socket, typename SocketStorageType = Socket>
 struct Connection {
     struct JobData {
         Function<void(Core::Stream::Socket&)> start {};
+        // Only set for jobs that know how to run as a stream on an HTTP/2 connection.
+        Function<void(HTTP::Http2Connection&)> start_http2_stream {};
         Function<void(Core::NetworkJob::Error)> fail {};
         Function<Vector<TLS::Certificate>()> provide_client_certificates {};
+        URL url {};
+        RequestPriority priority { RequestPriority::Normal };
+        Core::ElapsedTimer queued_timer {};
 
         template<typename T>
-        static JobData create(T& job)
+        static JobData create(T& job, URL const& url, RequestPriority priority)
         {
             // Clang-format _really_ messes up formatting this, so just format it manually.
             // clang-format off
-            return JobData {
+            auto job_data = JobData {
                 .start = [&job](auto& socket) {
                     job.start(socket);
                 },
@@ -83,15 +91,24 @@ struct Connection {
                     }
                     return Vector<TLS::Certificate> {};
                 },
+                .url = url,
+                .priority = priority,
             };
             // clang-format on
+            if constexpr (requires { job.start_on_http2_connection(declval<HTTP::Http2Connection&>(), u16 {}); }) {
+                job_data.start_http2_stream = [&job, priority](auto& connection) {
+                    job.start_on_http2_connection(connection, http2_stream_weight(priority));
+                };
+            }
+            return job_data;
         }
     };
     using QueueType = Vector<JobData>;
     using SocketType = Socket;
     using StorageType = SocketStorageType;
 
-    NonnullOwnPtr<Core::Stream::BufferedSocket<SocketStorageType>> socket;
+    // Null until the first socket has connected.
+    OwnPtr<Core::Stream::BufferedSocket<SocketStorageType>> socket;
     QueueType request_queue;
     NonnullRefPtr<Core::Timer> removal_timer;
     bool has_started { false };
@@ -99,6 +116,23 @@ struct Connection {
     Core::ElapsedTimer timer {};
     JobData job_data {};
     Proxy proxy {};
+    size_t requests_served_by_socket { 0 };
+    // Set when the server picked HTTP/2, all requests on the connection then run at the same time as streams on it.
+    // Declared after the socket, so that it goes away first.
+    RefPtr<HTTP::Http2Connection> http2_connection {};
+    // Set while a new socket is being connected in the background, the requests in the queue start once it's ready.
+    RefPtr<Core::Stream::TCPConnector> connector {};
+    OwnPtr<SocketStorageType> socket_in_handshake {};
+
+    bool is_connecting() const { return connector || socket_in_handshake; }
+    bool has_usable_socket() const { return socket && socket->is_open() && !socket->is_eof(); }
+
+    void enqueue(JobData job)
+    {
+        job.queued_timer.start();
+        auto it = request_queue.find_if([&](auto& queued_job) { return queued_job.priority < job.priority; });
+        request_queue.insert(it.index(), move(job));
+    }
 };
 
 struct ConnectionKey {
@@ -124,107 +158,339 @@ namespace RequestServer::ConnectionCache {
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::Stream::TCPSocket, Core::Stream::Socket>>>> g_tcp_connection_cache;
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache;
 
+// Shared by all TLS connections, so that any new connection to a server we've talked to before can resume that session.
+extern NonnullRefPtr<TLS::SessionCache> g_tls_session_cache;
+
+TLS::Options create_tls_options(URL const&);
+
 void request_did_finish(URL const&, Core::Stream::Socket const*);
 void dump_jobs();
 
-constexpr static size_t MaxConcurrentConnectionsPerURL = 4;
-constexpr static size_t ConnectionKeepAliveTimeMilliseconds = 10'000;
+struct Limits {
+    size_t max_connections_per_host { 4 };
+    // Sockets are closed and replaced after this many requests, since some servers stop honoring keep-alive after a while.
+    size_t max_requests_per_connection { 100 };
+    // Connections with nothing left to do are closed after being idle for this long.
+    u64 idle_timeout_milliseconds { 10'000 };
+};
+
+extern Limits g_limits;
+
+struct Statistics {
+    u64 connections_created { 0 };
+    u64 connections_reused { 0 };
+    u64 connections_closed_after_idle_timeout { 0 };
+    u64 sockets_replaced_after_request_limit { 0 };
+    u64 preconnects { 0 };
+    u64 requests_started_immediately { 0 };
+    // Every connection to the host was busy, and there were already as many of them as allowed.
+    u64 requests_queued { 0 };
+    u64 total_queued_milliseconds { 0 };
+    u64 longest_queued_milliseconds { 0 };
+    u64 http2_connections_created { 0 };
+    u64 http2_streams_started { 0 };
+    u64 connection_failures { 0 };
+};
+
+extern Statistics g_statistics;
+
+// Describes every pool, its connections and what is queued on them, along with the limits and counters above.
+String statistics_as_json();
+
+// Hosts that a page asked to preconnect to. Any later DNS prefetch for them goes on to create a connection as well.
+void did_hint_preconnect_to(URL const&);
+bool was_hinted_for_preconnect(URL const&);
 
 template<typename T>
-ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
+void attach_http2_connection_if_negotiated(T& connection)
+{
+    if constexpr (IsSame<TLS::TLSv12, typename T::SocketType>) {
+        if (connection.socket->underlying_stream().alpn() != "h2"sv)
+            return;
+
+        auto http2_connection = HTTP::Http2Connection::try_create(*connection.socket);
+        if (http2_connection.is_error()) {
+            dbgln("ConnectionCache: Failed to set up HTTP/2 on {}: {}", connection.socket.ptr(), http2_connection.error());
+            connection.socket->close();
+            return;
+        }
+        dbgln_if(REQUESTSERVER_DEBUG, "Using HTTP/2 on {}", connection.socket.ptr());
+        connection.http2_connection = http2_connection.release_value();
+        ++g_statistics.http2_connections_created;
+    } else {
+        (void)connection;
+    }
+}
+
+template<typename T>
+void start_job(T& connection, typename T::JobData job_data)
+{
+    connection.has_started = true;
+    connection.removal_timer->stop();
+    connection.timer.start();
+    connection.current_url = job_data.url;
+    ++connection.requests_served_by_socket;
+    connection.socket->set_notifications_enabled(true);
+
+    if (connection.http2_connection && job_data.start_http2_stream) {
+        ++g_statistics.http2_streams_started;
+        job_data.start_http2_stream(*connection.http2_connection);
+        return;
+    }
+
+    connection.job_data = move(job_data);
+    connection.job_data.start(*connection.socket);
+}
+
+template<typename T>
+void start_next_queued_job(T& connection)
+{
+    auto job_data = connection.request_queue.take_first();
+    u64 queued_milliseconds = job_data.queued_timer.elapsed();
+    g_statistics.total_queued_milliseconds += queued_milliseconds;
+    g_statistics.longest_queued_milliseconds = max(g_statistics.longest_queued_milliseconds, queued_milliseconds);
+    dbgln_if(REQUESTSERVER_DEBUG, "Request for {} waited {}ms for a connection", job_data.url, queued_milliseconds);
+    start_job(connection, move(job_data));
+}
+
+template<typename T>
+void start_queued_jobs(T& connection)
+{
+    start_next_queued_job(connection);
+    // On HTTP/2, the rest of the queue can come along.
+    while (connection.http2_connection && !connection.request_queue.is_empty() && connection.http2_connection->can_open_stream())
+        start_next_queued_job(connection);
+}
+
+template<typename CacheType, typename T>
+void did_become_idle(CacheType& cache, ConnectionKey const& key, T& connection)
+{
+    if (connection.socket)
+        connection.socket->set_notifications_enabled(false);
+    connection.has_started = false;
+    connection.current_url = {};
+    connection.job_data = {};
+    connection.removal_timer->on_timeout = [ptr = &connection, &cache, key]() mutable {
+        Core::deferred_invoke([&, key = move(key), ptr] {
+            auto it = cache.find(key);
+            if (it == cache.end())
+                return;
+            dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", ptr, ptr->socket.ptr());
+            ++g_statistics.connections_closed_after_idle_timeout;
+            auto did_remove = it->value->remove_first_matching([&](auto& entry) { return entry == ptr; });
+            VERIFY(did_remove);
+            if (it->value->is_empty())
+                cache.remove(it);
+        });
+    };
+    connection.removal_timer->start(static_cast<int>(g_limits.idle_timeout_milliseconds));
+}
+
+// Closes the connection's socket if it shouldn't take any more requests, and returns whether it needs a new one.
+template<typename T>
+bool needs_new_socket(T& connection)
+{
+    if (!connection.socket)
+        return true;
+
+    if (connection.http2_connection) {
+        // HTTP/2 has no keep-alive to wear out, the server tells us with a GOAWAY when it's done with the connection.
+        if (connection.http2_connection->is_going_away())
+            connection.socket->close();
+    } else if (connection.requests_served_by_socket >= g_limits.max_requests_per_connection) {
+        dbgln_if(REQUESTSERVER_DEBUG, "Replacing socket {} after {} requests", connection.socket.ptr(), connection.requests_served_by_socket);
+        connection.socket->close();
+        ++g_statistics.sockets_replaced_after_request_limit;
+    }
+
+    return !connection.has_usable_socket();
+}
+
+template<typename T>
+TLS::Options create_tls_options(T& connection, URL const& url)
+{
+    auto options = create_tls_options(url);
+    options.set_alert_handler([&connection](TLS::AlertDescription alert) {
+        Core::NetworkJob::Error reason;
+        if (alert == TLS::AlertDescription::HandshakeFailure)
+            reason = Core::NetworkJob::Error::ProtocolFailed;
+        else if (alert == TLS::AlertDescription::DecryptError)
+            reason = Core::NetworkJob::Error::ConnectionFailed;
+        else
+            reason = Core::NetworkJob::Error::TransmissionFailed;
+
+        if (connection.job_data.fail)
+            connection.job_data.fail(reason);
+    });
+    options.set_certificate_provider([&connection]() -> Vector<TLS::Certificate> {
+        if (connection.job_data.provide_client_certificates)
+            return connection.job_data.provide_client_certificates();
+        return {};
+    });
+    return options;
+}
+
+template<typename CacheType, typename T>
+void did_finish_connecting(CacheType& cache, ConnectionKey const& key, T& connection, URL const& url, ErrorOr<NonnullOwnPtr<typename T::StorageType>> socket_or_error)
+{
+    using StorageType = typename T::StorageType;
+
+    auto buffered_socket_or_error = [&]() -> ErrorOr<NonnullOwnPtr<Core::Stream::BufferedSocket<StorageType>>> {
+        return Core::Stream::BufferedSocket<StorageType>::create(TRY(move(socket_or_error)));
+    }();
+    if (buffered_socket_or_error.is_error()) {
+        dbgln("ConnectionCache: Connection to {} failed: {}", url, buffered_socket_or_error.error());
+        ++g_statistics.connection_failures;
+        auto queue = move(connection.request_queue);
+        did_become_idle(cache, key, connection);
+        for (auto& job_data : queue)
+            job_data.fail(Core::NetworkJob::Error::ConnectionFailed);
+        return;
+    }
+
+    // The HTTP/2 connection is built on top of the old socket, so it has to go first.
+    connection.http2_connection = nullptr;
+    connection.socket = buffered_socket_or_error.release_value();
+    connection.requests_served_by_socket = 0;
+    dbgln_if(REQUESTSERVER_DEBUG, "Connected a new socket for {} -> {}", url, connection.socket.ptr());
+    attach_http2_connection_if_negotiated(connection);
+
+    if (connection.request_queue.is_empty()) {
+        did_become_idle(cache, key, connection);
+        return;
+    }
+    start_queued_jobs(connection);
+}
+
+// Gets the connection a new socket in the background, without holding up anything else while the host is looked up
+// and connected to. The requests in the connection's queue start once that's done, or all fail if it can't be.
+template<typename CacheType, typename T>
+void start_connecting(CacheType& cache, ConnectionKey const& key, T& connection, URL const& url)
 {
     using SocketType = typename T::SocketType;
-    using SocketStorageType = typename T::StorageType;
+    using StorageType = typename T::StorageType;
+
+    connection.has_started = true;
+    connection.removal_timer->stop();
+
+    auto did_connect = [&cache, key, &connection, url](ErrorOr<NonnullOwnPtr<StorageType>> socket_or_error) {
+        did_finish_connecting(cache, key, connection, url, move(socket_or_error));
+    };
+
+    if (connection.proxy.data.type != Core::ProxyData::Direct) {
+        // FIXME: Talk to proxies without blocking as well.
+        auto socket_or_error = [&]() -> ErrorOr<NonnullOwnPtr<StorageType>> {
+            if constexpr (IsSame<TLS::TLSv12, SocketType>)
+                return connection.proxy.template tunnel<SocketType, StorageType>(url, create_tls_options(connection, url));
+            else
+                return connection.proxy.template tunnel<SocketType, StorageType>(url);
+        }();
+        Core::deferred_invoke([did_connect, socket_or_error = move(socket_or_error)]() mutable {
+            did_connect(move(socket_or_error));
+        });
+        return;
+    }
 
-    if (!connection.socket->is_open() || connection.socket->is_eof()) {
-        // Create another socket for the connection.
-        auto set_socket = [&](auto socket) -> ErrorOr<void> {
-            connection.socket = TRY(Core::Stream::BufferedSocket<SocketStorageType>::create(move(socket)));
-            return {};
-        };
+    auto connector_or_error = Core::Stream::TCPSocket::connect_async(url.host(), url.port_or_default(), [&connection, url, did_connect](auto tcp_socket_or_error) mutable {
+        connection.connector = nullptr;
+        if (tcp_socket_or_error.is_error()) {
+            did_connect(tcp_socket_or_error.release_error());
+            return;
+        }
 
         if constexpr (IsSame<TLS::TLSv12, SocketType>) {
-            TLS::Options options;
-            options.set_alert_handler([&connection](TLS::AlertDescription alert) {
-                Core::NetworkJob::Error reason;
-                if (alert == TLS::AlertDescription::HandshakeFailure)
-                    reason = Core::NetworkJob::Error::ProtocolFailed;
-                else if (alert == TLS::AlertDescription::DecryptError)
-                    reason = Core::NetworkJob::Error::ConnectionFailed;
-                else
-                    reason = Core::NetworkJob::Error::TransmissionFailed;
-
-                if (connection.job_data.fail)
-                    connection.job_data.fail(reason);
-            });
-            options.set_certificate_provider([&connection]() -> Vector<TLS::Certificate> {
-                if (connection.job_data.provide_client_certificates)
-                    return connection.job_data.provide_client_certificates();
-                return {};
+            auto tls_socket_or_error = TLS::TLSv12::connect_async(url.host(), tcp_socket_or_error.release_value(), create_tls_options(connection, url), [&connection, did_connect](ErrorOr<void> result) mutable {
+                // We're inside the TLS socket's own callbacks here, so it has to be left alone until they've returned.
+                Core::deferred_invoke([&connection, did_connect, result = move(result)]() mutable {
+                    auto tls_socket = connection.socket_in_handshake.release_nonnull();
+                    if (result.is_error())
+                        did_connect(result.release_error());
+                    else
+                        did_connect(move(tls_socket));
+                });
             });
-            TRY(set_socket(TRY((connection.proxy.template tunnel<SocketType, SocketStorageType>(url, move(options))))));
+            if (tls_socket_or_error.is_error()) {
+                did_connect(tls_socket_or_error.release_error());
+                return;
+            }
+            connection.socket_in_handshake = tls_socket_or_error.release_value();
         } else {
-            TRY(set_socket(TRY((connection.proxy.template tunnel<SocketType, SocketStorageType>(url)))));
+            did_connect(NonnullOwnPtr<StorageType> { tcp_socket_or_error.release_value() });
         }
-        dbgln_if(REQUESTSERVER_DEBUG, "Creating a new socket for {} -> {}", url, connection.socket);
+    });
+    if (connector_or_error.is_error()) {
+        Core::deferred_invoke([did_connect, error = connector_or_error.release_error()]() mutable {
+            did_connect(move(error));
+        });
+        return;
     }
-    return {};
+    connection.connector = connector_or_error.release_value();
 }
 
-decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job, Core::ProxyData proxy_data = {})
+decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job, Core::ProxyData proxy_data = {}, RequestPriority priority = RequestPriority::Normal)
 {
     using CacheEntryType = RemoveCVReference<decltype(*cache.begin()->value)>;
-    auto& sockets_for_url = *cache.ensure({ url.host(), url.port_or_default(), proxy_data }, [] { return make<CacheEntryType>(); });
+    ConnectionKey key { url.host(), url.port_or_default(), proxy_data };
+    auto& sockets_for_url = *cache.ensure(key, [] { return make<CacheEntryType>(); });
 
     Proxy proxy { proxy_data };
 
     using ReturnType = decltype(&sockets_for_url[0]);
-    auto it = sockets_for_url.find_if([](auto& connection) { return connection->request_queue.is_empty(); });
-    auto did_add_new_connection = false;
-    auto failed_to_find_a_socket = it.is_end();
-    if (failed_to_find_a_socket && sockets_for_url.size() < ConnectionCache::MaxConcurrentConnectionsPerURL) {
-        using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
-        auto connection_result = proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
-        if (connection_result.is_error()) {
-            dbgln("ConnectionCache: Connection to {} failed: {}", url, connection_result.error());
-            Core::deferred_invoke([&job] {
-                job.fail(Core::NetworkJob::Error::ConnectionFailed);
-            });
-            return ReturnType { nullptr };
+
+    // Once there's an HTTP/2 connection to the host, everything goes over it, as long as it's in a state to take more.
+    for (auto& connection : sockets_for_url) {
+        if (!connection.http2_connection || connection.http2_connection->is_going_away() || connection.is_connecting() || !connection.has_usable_socket())
+            continue;
+
+        if (connection.http2_connection->can_open_stream()) {
+            dbgln_if(REQUESTSERVER_DEBUG, "Start request for url {} as an HTTP/2 stream in {} - {}", url, &connection, connection.socket.ptr());
+            ++g_statistics.requests_started_immediately;
+            start_job(connection, decltype(connection.job_data)::create(job, url, priority));
+            return &connection;
         }
-        auto socket_result = Core::Stream::BufferedSocket<typename ConnectionType::StorageType>::create(connection_result.release_value());
-        if (socket_result.is_error()) {
-            dbgln("ConnectionCache: Failed to make a buffered socket for {}: {}", url, socket_result.error());
-            Core::deferred_invoke([&job] {
-                job.fail(Core::NetworkJob::Error::ConnectionFailed);
-            });
-            return ReturnType { nullptr };
+
+        // It's at the server's limit of concurrent streams, one of them finishing will let the next one in.
+        if (connection.http2_connection->active_stream_count() > 0) {
+            dbgln_if(REQUESTSERVER_DEBUG, "Enqueue request for URL {} behind the HTTP/2 streams in {} - {}", url, &connection, connection.socket.ptr());
+            ++g_statistics.requests_queued;
+            connection.enqueue(decltype(connection.job_data)::create(job, url, priority));
+            return &connection;
         }
+    }
+    // Prefer an idle connection, then a new one, and only queue the request behind others once the host is at its limit.
+    auto it = sockets_for_url.find_if([](auto& connection) { return !connection->has_started; });
+    if (it.is_end() && sockets_for_url.size() < g_limits.max_connections_per_host) {
+        using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
         sockets_for_url.append(make<ConnectionType>(
-            socket_result.release_value(),
+            nullptr,
             typename ConnectionType::QueueType {},
-            Core::Timer::create_single_shot(ConnectionKeepAliveTimeMilliseconds, nullptr)));
-        sockets_for_url.last().proxy = move(proxy);
-        did_add_new_connection = true;
+            Core::Timer::create_single_shot(static_cast<int>(g_limits.idle_timeout_milliseconds), nullptr)));
+        auto& connection = sockets_for_url.last();
+        connection.proxy = move(proxy);
+        ++g_statistics.connections_created;
+
+        // The request waits in the queue until the connection is ready, along with any others for the host that come in meanwhile.
+        dbgln_if(REQUESTSERVER_DEBUG, "Connecting {} for request {}", &connection, url);
+        connection.enqueue(decltype(connection.job_data)::create(job, url, priority));
+        start_connecting(cache, key, connection, url);
+        return &connection;
     }
-    size_t index;
-    if (failed_to_find_a_socket) {
-        if (did_add_new_connection) {
-            index = sockets_for_url.size() - 1;
-        } else {
-            // Find the least backed-up connection (based on how many entries are in their request queue).
-            index = 0;
-            auto min_queue_size = (size_t)-1;
-            for (auto it = sockets_for_url.begin(); it != sockets_for_url.end(); ++it) {
-                if (auto queue_size = it->request_queue.size(); min_queue_size > queue_size) {
-                    index = it.index();
-                    min_queue_size = queue_size;
-                }
-            }
+
+    if (!it.is_end()) {
+        auto& connection = sockets_for_url[it.index()];
+        if (needs_new_socket(connection)) {
+            dbgln_if(REQUESTSERVER_DEBUG, "Reconnecting {} for request {}", &connection, url);
+            connection.enqueue(decltype(connection.job_data)::create(job, url, priority));
+            start_connecting(cache, key, connection, url);
+            return &connection;
         }
-    } else {
-        index = it.index();
+        dbgln_if(REQUESTSERVER_DEBUG, "Immediately start request for url {} in {} - {}", url, &connection, connection.socket.ptr());
+        ++g_statistics.connections_reused;
+        ++g_statistics.requests_started_immediately;
+        start_job(connection, decltype(connection.job_data)::create(job, url, priority));
+        return &connection;
     }
+
     if (sockets_for_url.is_empty()) {
         Core::deferred_invoke([&job] {
             job.fail(Core::NetworkJob::Error::ConnectionFailed);
@@ -232,27 +498,19 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
         return ReturnType { nullptr };
     }
 
-    auto& connection = sockets_for_url[index];
-    if (!connection.has_started) {
-        if (auto result = recreate_socket_if_needed(connection, url); result.is_error()) {
-            dbgln("ConnectionCache: request failed to start, failed to make a socket: {}", result.error());
-            Core::deferred_invoke([&job] {
-                job.fail(Core::NetworkJob::Error::ConnectionFailed);
-            });
-            return ReturnType { nullptr };
+    // Find the least backed-up connection (based on how many entries are in their request queue).
+    size_t index = 0;
+    auto min_queue_size = (size_t)-1;
+    for (auto it = sockets_for_url.begin(); it != sockets_for_url.end(); ++it) {
+        if (auto queue_size = it->request_queue.size(); min_queue_size > queue_size) {
+            index = it.index();
+            min_queue_size = queue_size;
         }
-        dbgln_if(REQUESTSERVER_DEBUG, "Immediately start request for url {} in {} - {}", url, &connection, connection.socket);
-        connection.has_started = true;
-        connection.removal_timer->stop();
-        connection.timer.start();
-        connection.current_url = url;
-        connection.job_data = decltype(connection.job_data)::create(job);
-        connection.socket->set_notifications_enabled(true);
-        connection.job_data.start(*connection.socket);
-    } else {
-        dbgln_if(REQUESTSERVER_DEBUG, "Enqueue request for URL {} in {} - {}", url, &connection, connection.socket);
-        connection.request_queue.append(decltype(connection.job_data)::create(job));
     }
+    auto& connection = sockets_for_url[index];
+    dbgln_if(REQUESTSERVER_DEBUG, "Enqueue request for URL {} in {} - {}", url, &connection, connection.socket.ptr());
+    ++g_statistics.requests_queued;
+    connection.enqueue(decltype(connection.job_data)::create(job, url, priority));
     return &connection;
 }
 
@@ -6,16 +6,17 @@
 
 #include <AK/Badge.h>
 #include <AK/NonnullOwnPtr.h>
+#include <LibCore/HostLookup.h>
 #include <LibCore/Proxy.h>
 #include <RequestServer/ConnectionFromClient.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
 #include <RequestServer/RequestClientEndpoint.h>
-#include <netdb.h>
 
 namespace RequestServer {
 
 static HashMap<int, RefPtr<ConnectionFromClient>> s_connections;
+static HashMap<URL, NonnullRefPtr<Core::HostLookup>> s_dns_preloads;
 
 ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSocket> socket)
     : IPC::ConnectionFromClient<RequestClientEndpoint, RequestServerEndpoint>(*this, move(socket), 1)
@@ -36,7 +37,7 @@ Messages::RequestServer::IsSupportedProtocolResponse ConnectionFromClient::is_su
     return supported;
 }
 
-Messages::RequestServer::StartRequestResponse ConnectionFromClient::start_request(String const& method, URL const& url, IPC::Dictionary const& request_headers, ByteBuffer const& request_body, Core::ProxyData const& proxy_data)
+Messages::RequestServer::StartRequestResponse ConnectionFromClient::start_request(String const& method, URL const& url, IPC::Dictionary const& request_headers, ByteBuffer const& request_body, Core::ProxyData const& proxy_data, ::RequestServer::RequestPriority const& priority)
 {
     if (!url.is_valid()) {
         dbgln("StartRequest: Invalid URL requested: '{}'", url);
@@ -47,7 +48,7 @@ Messages::RequestServer::StartRequestResponse ConnectionFromClient::start_reques
         dbgln("StartRequest: No protocol handler for URL: '{}'", url);
         return { -1, Optional<IPC::File> {} };
     }
-    auto request = protocol->start_request(*this, method, url, request_headers.entries(), request_body, proxy_data);
+    auto request = protocol->start_request(*this, method, url, request_headers.entries(), request_body, proxy_data, priority);
     if (!request) {
         dbgln("StartRequest: Protocol handler failed to start request: '{}'", url);
         return { -1, Optional<IPC::File> {} };
@@ -149,27 +150,66 @@ void ConnectionFromClient::ensure_connection(URL const& url, ::RequestServer::Ca
         return;
     }
 
-    if (cache_level == CacheLevel::ResolveOnly) {
-        return Core::deferred_invoke([host = url.host()] {
-            dbgln("EnsureConnection: DNS-preload for {}", host);
-            (void)gethostbyname(host.characters());
-        });
+    if (url.scheme() != "http"sv && url.scheme() != "https"sv) {
+        dbgln("EnsureConnection: Invalid URL scheme: '{}'", url.scheme());
+        return;
     }
 
-    auto& job = Job::ensure(url);
-    dbgln("EnsureConnection: Pre-connect to {}", url);
+    if (cache_level == CacheLevel::CreateConnection)
+        ConnectionCache::did_hint_preconnect_to(url);
+
+    if (s_dns_preloads.contains(url))
+        return;
+
+    // Connecting would resolve the host anyway, but doing it on its own first warms up LookupServer's cache for everyone.
+    dbgln("EnsureConnection: DNS-preload for {}", url.host());
+    auto lookup = Core::HostLookup::construct(url.host(), [url](auto addresses_or_error) {
+        s_dns_preloads.remove(url);
+        if (addresses_or_error.is_error()) {
+            dbgln("EnsureConnection: DNS-preload for {} failed: {}", url.host(), addresses_or_error.error());
+            return;
+        }
+        if (ConnectionCache::was_hinted_for_preconnect(url))
+            preconnect(url);
+    });
+    s_dns_preloads.set(url, move(lookup));
+}
+
+void ConnectionFromClient::preconnect(URL const& url)
+{
     auto do_preconnect = [&](auto& cache) {
         auto it = cache.find({ url.host(), url.port_or_default() });
-        if (it == cache.end() || it->value->is_empty())
-            ConnectionCache::get_or_create_connection(cache, url, job);
+        if (it != cache.end() && !it->value->is_empty())
+            return;
+        dbgln("EnsureConnection: Pre-connect to {}", url);
+        ++ConnectionCache::g_statistics.preconnects;
+        ConnectionCache::get_or_create_connection(cache, url, Job::ensure(url));
     };
 
     if (url.scheme() == "http"sv)
         do_preconnect(ConnectionCache::g_tcp_connection_cache);
-    else if (url.scheme() == "https"sv)
-        do_preconnect(ConnectionCache::g_tls_connection_cache);
     else
-        dbgln("EnsureConnection: Invalid URL scheme: '{}'", url.scheme());
+        do_preconnect(ConnectionCache::g_tls_connection_cache);
+}
+
+void ConnectionFromClient::set_connection_limits(u32 max_connections_per_host, u32 max_requests_per_connection, u32 idle_timeout_milliseconds)
+{
+    if (max_connections_per_host == 0 || max_requests_per_connection == 0) {
+        dbgln("SetConnectionLimits: Connections need to be allowed at least one socket and one request");
+        return;
+    }
+
+    // Existing connections keep going, the new limits apply whenever a connection is created, reused or becomes idle.
+    ConnectionCache::g_limits = {
+        .max_connections_per_host = max_connections_per_host,
+        .max_requests_per_connection = max_requests_per_connection,
+        .idle_timeout_milliseconds = idle_timeout_milliseconds,
+    };
+}
+
+Messages::RequestServer::ConnectionPoolStatisticsResponse ConnectionFromClient::connection_pool_statistics()
+{
+    return ConnectionCache::statistics_as_json();
 }
 
 }
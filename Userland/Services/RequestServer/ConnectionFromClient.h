@@ -31,11 +31,15 @@ public:
 private:
     explicit ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSocket>);
 
+    static void preconnect(URL const&);
+
     virtual Messages::RequestServer::IsSupportedProtocolResponse is_supported_protocol(String const&) override;
-    virtual Messages::RequestServer::StartRequestResponse start_request(String const&, URL const&, IPC::Dictionary const&, ByteBuffer const&, Core::ProxyData const&) override;
+    virtual Messages::RequestServer::StartRequestResponse start_request(String const&, URL const&, IPC::Dictionary const&, ByteBuffer const&, Core::ProxyData const&, ::RequestServer::RequestPriority const&) override;
     virtual Messages::RequestServer::StopRequestResponse stop_request(i32) override;
     virtual Messages::RequestServer::SetCertificateResponse set_certificate(i32, String const&, String const&) override;
     virtual void ensure_connection(URL const& url, ::RequestServer::CacheLevel const& cache_level) override;
+    virtual void set_connection_limits(u32 max_connections_per_host, u32 max_requests_per_connection, u32 idle_timeout_milliseconds) override;
+    virtual Messages::RequestServer::ConnectionPoolStatisticsResponse connection_pool_statistics() override;
 
     HashMap<i32, OwnPtr<Request>> m_requests;
 };
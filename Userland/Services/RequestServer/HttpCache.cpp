@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <AK/JsonObject.h>
+#include <AK/QuickSort.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/Directory.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <LibCrypto/Hash/SHA1.h>
+#include <RequestServer/HttpCache.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+static constexpr size_t memory_budget = 32 * MiB;
+static constexpr size_t disk_budget = 256 * MiB;
+
+// https://www.rfc-editor.org/rfc/rfc9111#section-4.2.2
+static constexpr i64 max_heuristic_freshness_lifetime = 24 * 60 * 60;
+
+struct CacheControl {
+    bool no_store { false };
+    bool no_cache { false };
+    Optional<i64> max_age;
+};
+
+// https://www.rfc-editor.org/rfc/rfc9111#section-5.2
+static CacheControl parse_cache_control(StringView value)
+{
+    CacheControl cache_control;
+    for (auto directive : value.split_view(',')) {
+        directive = directive.trim_whitespace();
+        auto name = directive;
+        StringView argument;
+        if (auto equals = directive.find('='); equals.has_value()) {
+            name = directive.substring_view(0, *equals).trim_whitespace();
+            argument = directive.substring_view(*equals + 1).trim_whitespace().trim("\""sv);
+        }
+
+        if (name.equals_ignoring_case("no-store"sv)) {
+            cache_control.no_store = true;
+        } else if (name.equals_ignoring_case("no-cache"sv)) {
+            // NOTE: "no-cache" with a list of fields only asks us to revalidate those, doing it for the whole response is fine too.
+            cache_control.no_cache = true;
+        } else if (name.equals_ignoring_case("max-age"sv)) {
+            if (auto max_age = argument.to_uint(); max_age.has_value())
+                cache_control.max_age = *max_age;
+        }
+    }
+    return cache_control;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9110#section-5.6.7
+static Optional<i64> parse_http_date(String const& value)
+{
+    // FIXME: Support the obsolete RFC 850 and asctime() formats as well.
+    auto date_time = Core::DateTime::parse("%a, %d %b %Y %H:%M:%S GMT"sv, value);
+    if (!date_time.has_value())
+        return {};
+    return date_time->timestamp();
+}
+
+static Optional<String> find_request_header(HashMap<String, String> const& headers, StringView name)
+{
+    for (auto& it : headers) {
+        if (it.key.equals_ignoring_case(name))
+            return it.value;
+    }
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9110#section-15.1
+static bool is_heuristically_cacheable(u32 status_code)
+{
+    switch (status_code) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 405:
+    case 410:
+    case 414:
+    case 501:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111#section-3
+static bool is_storable(u32 status_code, HttpCache::Headers const& headers, CacheControl const& cache_control)
+{
+    if (cache_control.no_store || status_code < 200)
+        return false;
+
+    // NOTE: Entries are only keyed by their URL, so we can't tell responses apart that vary by some request header.
+    //       Accept-Encoding is fine, since we always send the same one.
+    if (auto vary = headers.get("Vary"); vary.has_value()) {
+        for (auto field : vary->split_view(',')) {
+            if (!field.trim_whitespace().equals_ignoring_case("Accept-Encoding"sv))
+                return false;
+        }
+    }
+
+    if (is_heuristically_cacheable(status_code))
+        return true;
+    return cache_control.max_age.has_value() || headers.contains("Expires");
+}
+
+static String cache_key(URL const& url)
+{
+    return url.serialize(URL::ExcludeFragment::Yes);
+}
+
+HttpCache& HttpCache::the()
+{
+    static HttpCache cache;
+    return cache;
+}
+
+void HttpCache::initialize()
+{
+    (void)the();
+}
+
+String HttpCache::directory()
+{
+    return String::formatted("{}/.cache/RequestServer", Core::StandardPaths::home_directory());
+}
+
+HttpCache::HttpCache()
+{
+    if (auto result = Core::Directory::create(directory(), Core::Directory::CreateDirectories::Yes); result.is_error()) {
+        dbgln("HttpCache: Unable to create {}, only caching in memory: {}", directory(), result.error());
+        return;
+    }
+    m_disk_is_usable = true;
+
+    Core::DirIterator iterator(directory(), Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        if (!path.ends_with(".body"sv))
+            continue;
+        if (auto stat = Core::System::stat(path); !stat.is_error())
+            m_disk_size += stat.value().st_size;
+    }
+}
+
+bool HttpCache::can_use_cache_for_request(StringView method, HashMap<String, String> const& request_headers)
+{
+    if (!method.equals_ignoring_case("GET"sv))
+        return false;
+
+    // NOTE: We leave conditional and partial requests made by the client alone, the responses are meant for it and not for us.
+    for (auto name : { "Authorization"sv, "Range"sv, "If-Match"sv, "If-None-Match"sv, "If-Modified-Since"sv, "If-Unmodified-Since"sv, "If-Range"sv }) {
+        if (find_request_header(request_headers, name).has_value())
+            return false;
+    }
+
+    if (auto cache_control = find_request_header(request_headers, "Cache-Control"sv); cache_control.has_value())
+        return !parse_cache_control(*cache_control).no_store;
+    return true;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111#section-5.2.1
+bool HttpCache::request_requires_revalidation(HashMap<String, String> const& request_headers)
+{
+    if (auto cache_control = find_request_header(request_headers, "Cache-Control"sv); cache_control.has_value()) {
+        auto directives = parse_cache_control(*cache_control);
+        if (directives.no_cache || directives.max_age == 0)
+            return true;
+    }
+    if (auto pragma = find_request_header(request_headers, "Pragma"sv); pragma.has_value())
+        return pragma->contains("no-cache"sv, CaseSensitivity::CaseInsensitive);
+    return false;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111#section-4.4
+bool HttpCache::method_invalidates_cache(StringView method)
+{
+    for (auto safe_method : { "GET"sv, "HEAD"sv, "OPTIONS"sv, "TRACE"sv }) {
+        if (method.equals_ignoring_case(safe_method))
+            return false;
+    }
+    return true;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111#section-4.2.3
+i64 HttpCache::Entry::current_age() const
+{
+    auto resident_time = Time::now_realtime().to_seconds() - m_response_time;
+    return m_initial_age + max(resident_time, 0);
+}
+
+bool HttpCache::Entry::is_fresh() const
+{
+    return current_age() < m_freshness_lifetime;
+}
+
+bool HttpCache::Entry::has_validators() const
+{
+    return m_response_headers.contains("ETag") || m_response_headers.contains("Last-Modified");
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111#section-4.2.1
+void HttpCache::compute_freshness(Entry& entry, Time request_time, Time response_time)
+{
+    auto const& headers = entry.m_response_headers;
+    auto cache_control = parse_cache_control(headers.get("Cache-Control").value_or({}));
+
+    auto date = [&]() -> i64 {
+        if (auto value = headers.get("Date"); value.has_value()) {
+            if (auto date = parse_http_date(*value); date.has_value())
+                return *date;
+        }
+        return response_time.to_seconds();
+    };
+
+    i64 freshness_lifetime = 0;
+    if (cache_control.no_cache) {
+        freshness_lifetime = 0;
+    } else if (cache_control.max_age.has_value()) {
+        freshness_lifetime = *cache_control.max_age;
+    } else if (auto expires = headers.get("Expires"); expires.has_value()) {
+        // NOTE: Invalid dates (like "0") mean that the response has already expired.
+        if (auto expiry_time = parse_http_date(*expires); expiry_time.has_value())
+            freshness_lifetime = *expiry_time - date();
+    } else if (auto last_modified = headers.get("Last-Modified"); last_modified.has_value() && is_heuristically_cacheable(entry.m_status_code)) {
+        // https://www.rfc-editor.org/rfc/rfc9111#section-4.2.2
+        if (auto last_modified_time = parse_http_date(*last_modified); last_modified_time.has_value())
+            freshness_lifetime = min((date() - *last_modified_time) / 10, max_heuristic_freshness_lifetime);
+    }
+    entry.m_freshness_lifetime = max(freshness_lifetime, 0);
+
+    i64 age_value = 0;
+    if (auto age = headers.get("Age"); age.has_value())
+        age_value = age->to_uint().value_or(0);
+    auto response_delay = max(response_time.to_seconds() - request_time.to_seconds(), 0);
+
+    entry.m_initial_age = age_value + response_delay;
+    entry.m_response_time = response_time.to_seconds();
+}
+
+RefPtr<HttpCache::Entry> HttpCache::find(URL const& url)
+{
+    auto key = cache_key(url);
+    if (auto entry = m_memory_entries.get(key); entry.has_value()) {
+        dbgln_if(HTTP_CACHE_DEBUG, "HttpCache: Found {} in memory", key);
+        // Move it to the back of the LRU list.
+        m_memory_lru.remove(*entry.value());
+        m_memory_lru.append(*entry.value());
+        return entry.value();
+    }
+
+    auto entry = find_on_disk(key);
+    if (!entry)
+        return {};
+    dbgln_if(HTTP_CACHE_DEBUG, "HttpCache: Found {} on disk", key);
+    add_to_memory(*entry);
+    return entry;
+}
+
+void HttpCache::store(URL const& url, u32 status_code, Headers const& response_headers, ByteBuffer body, Time request_time, Time response_time)
+{
+    auto key = cache_key(url);
+    remove(url);
+
+    auto cache_control = parse_cache_control(response_headers.get("Cache-Control").value_or({}));
+    if (!is_storable(status_code, response_headers, cache_control) || body.size() > max_entry_size)
+        return;
+
+    auto entry = adopt_ref(*new Entry);
+    entry->m_url = key;
+    entry->m_status_code = status_code;
+    entry->m_response_headers = response_headers;
+    entry->m_body = move(body);
+    compute_freshness(*entry, request_time, response_time);
+
+    // An entry that is never fresh and that we can't revalidate would never be used.
+    if (entry->m_freshness_lifetime == 0 && !entry->has_validators())
+        return;
+
+    dbgln_if(HTTP_CACHE_DEBUG, "HttpCache: Storing {} ({} bytes, fresh for {}s)", key, entry->body().size(), entry->m_freshness_lifetime);
+    add_to_memory(entry);
+    if (auto result = write_to_disk(*entry, true); result.is_error())
+        dbgln("HttpCache: Failed to write {} to disk: {}", key, result.error());
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111#section-4.3.4
+RefPtr<HttpCache::Entry> HttpCache::update_after_revalidation(Entry& entry, Headers const& headers_from_304, Time request_time, Time response_time)
+{
+    for (auto& it : headers_from_304) {
+        // NOTE: These describe the (empty) body of the 304 response, and not the one we have stored.
+        if (it.key.equals_ignoring_case("Content-Length"sv) || it.key.equals_ignoring_case("Content-Encoding"sv) || it.key.equals_ignoring_case("Transfer-Encoding"sv))
+            continue;
+        entry.m_response_headers.set(it.key, it.value);
+    }
+    compute_freshness(entry, request_time, response_time);
+
+    dbgln_if(HTTP_CACHE_DEBUG, "HttpCache: Revalidated {} (fresh for {}s)", entry.url(), entry.m_freshness_lifetime);
+    if (auto result = write_to_disk(entry, false); result.is_error())
+        dbgln("HttpCache: Failed to update {} on disk: {}", entry.url(), result.error());
+    return entry;
+}
+
+void HttpCache::remove(URL const& url)
+{
+    auto key = cache_key(url);
+    remove_from_memory(key);
+    remove_from_disk(key);
+}
+
+void HttpCache::add_to_memory(NonnullRefPtr<Entry> entry)
+{
+    remove_from_memory(entry->url());
+
+    m_memory_size += entry->body().size();
+    m_memory_lru.append(*entry);
+    m_memory_entries.set(entry->url(), move(entry));
+
+    while (m_memory_size > memory_budget && !m_memory_lru.is_empty())
+        remove_from_memory(m_memory_lru.first()->url());
+}
+
+void HttpCache::remove_from_memory(String const& url)
+{
+    auto it = m_memory_entries.find(url);
+    if (it == m_memory_entries.end())
+        return;
+    m_memory_lru.remove(*it->value);
+    m_memory_size -= it->value->body().size();
+    m_memory_entries.remove(it);
+}
+
+String HttpCache::file_name_for(String const& url)
+{
+    return encode_hex(Crypto::Hash::SHA1::hash(url).bytes());
+}
+
+static ErrorOr<void> write_file_atomically(String const& path, ReadonlyBytes bytes)
+{
+    // NOTE: Other RequestServers may be reading the same file, so it has to be replaced in one go.
+    auto temporary_path = String::formatted("{}.tmp-{}", path, getpid());
+    {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate, 0600));
+        if (!file->write_or_error(bytes))
+            return Error::from_string_literal("Failed to write cache file");
+    }
+    TRY(Core::System::rename(temporary_path, path));
+    return {};
+}
+
+ErrorOr<void> HttpCache::write_to_disk(Entry const& entry, bool write_body)
+{
+    if (!m_disk_is_usable)
+        return {};
+
+    auto base_path = String::formatted("{}/{}", directory(), file_name_for(entry.url()));
+
+    JsonObject headers;
+    for (auto& it : entry.response_headers())
+        headers.set(it.key, it.value);
+
+    JsonObject metadata;
+    metadata.set("url", entry.url());
+    metadata.set("status_code", entry.status_code());
+    metadata.set("response_time", entry.m_response_time);
+    metadata.set("initial_age", entry.m_initial_age);
+    metadata.set("freshness_lifetime", entry.m_freshness_lifetime);
+    metadata.set("body_size", entry.body().size());
+    metadata.set("headers", move(headers));
+
+    // The body goes first, so nobody sees metadata that describes a body that isn't there yet.
+    if (write_body) {
+        TRY(write_file_atomically(String::formatted("{}.body", base_path), entry.body()));
+        m_disk_size += entry.body().size();
+    }
+    TRY(write_file_atomically(String::formatted("{}.meta", base_path), metadata.to_string().bytes()));
+
+    evict_from_disk_if_needed();
+    return {};
+}
+
+RefPtr<HttpCache::Entry> HttpCache::find_on_disk(String const& url)
+{
+    if (!m_disk_is_usable)
+        return {};
+
+    auto base_path = String::formatted("{}/{}", directory(), file_name_for(url));
+    auto meta_path = String::formatted("{}.meta", base_path);
+
+    auto file = Core::Stream::File::open(meta_path, Core::Stream::OpenMode::Read);
+    if (file.is_error())
+        return {};
+    auto contents = file.value()->read_all();
+    if (contents.is_error())
+        return {};
+    auto json = JsonValue::from_string(contents.value());
+    if (json.is_error() || !json.value().is_object())
+        return {};
+    auto const& metadata = json.value().as_object();
+
+    // NOTE: Two URLs might share a file name, so make sure it's actually ours.
+    if (metadata.get("url"sv).as_string_or({}) != url)
+        return {};
+
+    auto body_file = Core::MappedFile::map(String::formatted("{}.body", base_path));
+    if (body_file.is_error() || body_file.value()->size() != metadata.get("body_size"sv).to_u64())
+        return {};
+
+    auto entry = adopt_ref(*new Entry);
+    entry->m_url = url;
+    entry->m_status_code = metadata.get("status_code"sv).to_u32();
+    entry->m_response_time = metadata.get("response_time"sv).to_i64();
+    entry->m_initial_age = metadata.get("initial_age"sv).to_i64();
+    entry->m_freshness_lifetime = metadata.get("freshness_lifetime"sv).to_i64();
+    entry->m_body_file = body_file.release_value();
+    if (auto const* headers = metadata.get_ptr("headers"sv); headers && headers->is_object()) {
+        headers->as_object().for_each_member([&](auto& name, auto& value) {
+            entry->m_response_headers.set(name, value.as_string_or({}));
+        });
+    }
+
+    // The modification time of the metadata is what we evict by, so it should say when the entry was last used.
+    (void)Core::System::utime(meta_path, {});
+    return entry;
+}
+
+void HttpCache::remove_from_disk(String const& url)
+{
+    if (!m_disk_is_usable)
+        return;
+
+    auto base_path = String::formatted("{}/{}", directory(), file_name_for(url));
+    (void)Core::System::unlink(String::formatted("{}.meta", base_path));
+    if (auto stat = Core::System::stat(String::formatted("{}.body", base_path)); !stat.is_error()) {
+        m_disk_size -= min<size_t>(m_disk_size, stat.value().st_size);
+        (void)Core::System::unlink(String::formatted("{}.body", base_path));
+    }
+}
+
+void HttpCache::evict_from_disk_if_needed()
+{
+    if (m_disk_size <= disk_budget)
+        return;
+
+    // NOTE: Other RequestServers write into the same directory, so we take a fresh look at what's in there.
+    struct DiskEntry {
+        String base_path;
+        time_t last_used { 0 };
+        size_t size { 0 };
+    };
+    Vector<DiskEntry> disk_entries;
+    size_t total_size = 0;
+
+    Core::DirIterator iterator(directory(), Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        if (!path.ends_with(".meta"sv))
+            continue;
+        auto base_path = path.substring(0, path.length() - 5);
+        auto meta_stat = Core::System::stat(path);
+        auto body_stat = Core::System::stat(String::formatted("{}.body", base_path));
+        if (meta_stat.is_error() || body_stat.is_error())
+            continue;
+        disk_entries.append({ move(base_path), meta_stat.value().st_mtime, static_cast<size_t>(body_stat.value().st_size) });
+        total_size += body_stat.value().st_size;
+    }
+
+    quick_sort(disk_entries, [](auto& a, auto& b) { return a.last_used < b.last_used; });
+
+    // Make some room while we're at it, so that we don't have to do this again for every response.
+    for (auto& disk_entry : disk_entries) {
+        if (total_size <= disk_budget * 3 / 4)
+            break;
+        dbgln_if(HTTP_CACHE_DEBUG, "HttpCache: Evicting {} ({} bytes) from disk", disk_entry.base_path, disk_entry.size);
+        (void)Core::System::unlink(String::formatted("{}.meta", disk_entry.base_path));
+        (void)Core::System::unlink(String::formatted("{}.body", disk_entry.base_path));
+        total_size -= disk_entry.size;
+    }
+    m_disk_size = total_size;
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/String.h>
+#include <AK/Time.h>
+#include <AK/URL.h>
+#include <LibCore/MappedFile.h>
+
+namespace RequestServer {
+
+// A private HTTP cache (RFC 9111) for GET requests, keyed by URL.
+// Recently used responses are kept in memory, and every response is also written to disk, where the RequestServers of
+// other clients can find it. Bodies that come from disk are memory-mapped instead of being read in.
+class HttpCache {
+public:
+    using Headers = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+    class Entry : public RefCounted<Entry> {
+        friend class HttpCache;
+
+    public:
+        String const& url() const { return m_url; }
+        u32 status_code() const { return m_status_code; }
+        Headers const& response_headers() const { return m_response_headers; }
+        ReadonlyBytes body() const { return m_body_file ? m_body_file->bytes() : m_body.bytes(); }
+
+        bool is_fresh() const;
+        bool has_validators() const;
+
+    private:
+        Entry() = default;
+
+        i64 current_age() const;
+
+        String m_url;
+        u32 m_status_code { 0 };
+        Headers m_response_headers;
+        ByteBuffer m_body;
+        RefPtr<Core::MappedFile> m_body_file;
+
+        // All of these are in seconds, the times are since the epoch.
+        i64 m_response_time { 0 };
+        i64 m_initial_age { 0 };
+        i64 m_freshness_lifetime { 0 };
+
+        IntrusiveListNode<Entry, RawPtr<Entry>> m_lru_node;
+    };
+
+    static HttpCache& the();
+
+    // Has to be called before unveil(), since it creates the cache directory.
+    static void initialize();
+    static String directory();
+
+    static bool can_use_cache_for_request(StringView method, HashMap<String, String> const& request_headers);
+    static bool request_requires_revalidation(HashMap<String, String> const& request_headers);
+    static bool method_invalidates_cache(StringView method);
+
+    RefPtr<Entry> find(URL const&);
+    void store(URL const&, u32 status_code, Headers const& response_headers, ByteBuffer body, Time request_time, Time response_time);
+    RefPtr<Entry> update_after_revalidation(Entry&, Headers const& headers_from_304, Time request_time, Time response_time);
+    void remove(URL const&);
+
+    static constexpr size_t max_entry_size = 8 * MiB;
+
+private:
+    HttpCache();
+
+    RefPtr<Entry> find_on_disk(String const& url);
+    ErrorOr<void> write_to_disk(Entry const&, bool write_body);
+    void remove_from_disk(String const& url);
+    void evict_from_disk_if_needed();
+
+    void add_to_memory(NonnullRefPtr<Entry>);
+    void remove_from_memory(String const& url);
+
+    static void compute_freshness(Entry&, Time request_time, Time response_time);
+    static String file_name_for(String const& url);
+
+    HashMap<String, NonnullRefPtr<Entry>> m_memory_entries;
+    IntrusiveList<&Entry::m_lru_node> m_memory_lru;
+    size_t m_memory_size { 0 };
+    size_t m_disk_size { 0 };
+    bool m_disk_is_usable { false };
+};
+
+}
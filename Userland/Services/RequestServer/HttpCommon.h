@@ -14,8 +14,10 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibHTTP/HttpRequest.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ConnectionCache.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
 
 namespace RequestServer::Detail {
@@ -24,15 +26,36 @@ template<typename TSelf, typename TJob>
 void init(TSelf* self, TJob job)
 {
     job->on_headers_received = [self](auto& headers, auto response_code) {
+        // NOTE: A 304 is for us, the client gets the response we have cached instead once the job is done.
+        if (self->was_not_modified())
+            return;
+        if (self->is_revalidating_cache_entry() && response_code.has_value() && response_code.value() == 304) {
+            self->did_receive_not_modified(headers);
+            return;
+        }
+
         if (response_code.has_value())
             self->set_status_code(response_code.value());
         self->set_response_headers(headers);
     };
 
+    job->on_body_data_written = [self](ReadonlyBytes bytes) {
+        self->did_write_body_data(bytes);
+    };
+
     job->on_finish = [self](bool success) {
         Core::deferred_invoke([url = self->job().url(), socket = self->job().socket()] {
             ConnectionCache::request_did_finish(url, socket);
         });
+
+        if (self->was_not_modified()) {
+            if (success)
+                self->use_revalidated_cache_entry();
+            else
+                self->did_finish(false);
+            return;
+        }
+
         if (auto* response = self->job().response()) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
@@ -44,6 +67,7 @@ void init(TSelf* self, TJob job)
         if (!self->total_size().has_value())
             self->did_progress(self->downloaded_size(), self->downloaded_size());
 
+        self->did_finish_network_request(success);
         self->did_finish(success);
     };
     job->on_progress = [self](Optional<u32> total, u32 current) {
@@ -61,7 +85,7 @@ void init(TSelf* self, TJob job)
 }
 
 template<typename TBadgedProtocol, typename TPipeResult>
-OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient& client, String const& method, const URL& url, HashMap<String, String> const& headers, ReadonlyBytes body, TPipeResult&& pipe_result, Core::ProxyData proxy_data = {})
+OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient& client, String const& method, const URL& url, HashMap<String, String> const& headers, ReadonlyBytes body, TPipeResult&& pipe_result, Core::ProxyData proxy_data = {}, RequestPriority priority = RequestPriority::Normal)
 {
     using TJob = typename TBadgedProtocol::Type::JobType;
     using TRequest = typename TBadgedProtocol::Type::RequestType;
@@ -90,7 +114,33 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
+
+    auto cache_mode = Request::CacheMode::Bypass;
+    RefPtr<HttpCache::Entry> cache_entry_to_revalidate;
+    auto request_headers = headers;
+    if (HttpCache::can_use_cache_for_request(method, headers)) {
+        cache_mode = Request::CacheMode::Store;
+        if (auto cache_entry = HttpCache::the().find(url)) {
+            if (cache_entry->is_fresh() && !HttpCache::request_requires_revalidation(headers)) {
+                auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
+                auto cached_request = CachedRequest::create(client, url, cache_entry.release_nonnull(), move(output_stream));
+                cached_request->set_request_fd(pipe_result.value().read_fd);
+                return cached_request;
+            }
+
+            // https://www.rfc-editor.org/rfc/rfc9111#section-4.3.1
+            if (cache_entry->has_validators()) {
+                if (auto etag = cache_entry->response_headers().get("ETag"); etag.has_value())
+                    request_headers.set("If-None-Match", etag.value());
+                if (auto last_modified = cache_entry->response_headers().get("Last-Modified"); last_modified.has_value())
+                    request_headers.set("If-Modified-Since", last_modified.value());
+                cache_entry_to_revalidate = move(cache_entry);
+            }
+        }
+    } else if (HttpCache::method_invalidates_cache(method)) {
+        cache_mode = Request::CacheMode::Invalidate;
+    }
+    request.set_headers(request_headers);
 
     auto allocated_body_result = ByteBuffer::copy(body);
     if (allocated_body_result.is_error())
@@ -101,11 +151,14 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     auto job = TJob::construct(move(request), *output_stream);
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     protocol_request->set_request_fd(pipe_result.value().read_fd);
+    protocol_request->set_cache_mode(cache_mode);
+    if (cache_entry_to_revalidate)
+        protocol_request->set_cache_entry_to_revalidate(cache_entry_to_revalidate.release_nonnull());
 
     if constexpr (IsSame<typename TBadgedProtocol::Type, HttpsProtocol>)
-        ConnectionCache::get_or_create_connection(ConnectionCache::g_tls_connection_cache, url, *job, proxy_data);
+        ConnectionCache::get_or_create_connection(ConnectionCache::g_tls_connection_cache, url, *job, proxy_data, priority);
     else
-        ConnectionCache::get_or_create_connection(ConnectionCache::g_tcp_connection_cache, url, *job, proxy_data);
+        ConnectionCache::get_or_create_connection(ConnectionCache::g_tcp_connection_cache, url, *job, proxy_data, priority);
 
     return protocol_request;
 }
@@ -22,6 +22,7 @@ HttpRequest::~HttpRequest()
 {
     m_job->on_finish = nullptr;
     m_job->on_progress = nullptr;
+    m_job->on_body_data_written = nullptr;
     m_job->cancel();
 }
 
@@ -10,6 +10,7 @@
 #include <AK/URL.h>
 #include <LibCore/Proxy.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/RequestPriority.h>
 
 namespace RequestServer {
 
@@ -18,7 +19,7 @@ public:
     virtual ~Protocol();
 
     String const& name() const { return m_name; }
-    virtual OwnPtr<Request> start_request(ConnectionFromClient&, String const& method, const URL&, HashMap<String, String> const& headers, ReadonlyBytes body, Core::ProxyData proxy_data = {}) = 0;
+    virtual OwnPtr<Request> start_request(ConnectionFromClient&, String const& method, const URL&, HashMap<String, String> const& headers, ReadonlyBytes body, Core::ProxyData proxy_data = {}, RequestPriority = RequestPriority::Normal) = 0;
 
     static Protocol* find_by_name(String const&);
 
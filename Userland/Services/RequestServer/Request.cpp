@@ -16,6 +16,7 @@ Request::Request(ConnectionFromClient& client, NonnullOwnPtr<Core::Stream::File>
     : m_client(client)
     , m_id(s_next_id++)
     , m_output_stream(move(output_stream))
+    , m_request_time(Time::now_realtime())
 {
 }
 
@@ -46,6 +47,94 @@ void Request::did_progress(Optional<u32> total_size, u32 downloaded_size)
     m_client.did_progress_request({}, *this);
 }
 
+void Request::did_receive_not_modified(HashMap<String, String, CaseInsensitiveStringTraits> const& headers)
+{
+    VERIFY(m_cache_entry_to_revalidate);
+    m_was_not_modified = true;
+    m_not_modified_headers = headers;
+}
+
+void Request::use_revalidated_cache_entry()
+{
+    VERIFY(m_was_not_modified);
+    auto entry = HttpCache::the().update_after_revalidation(*m_cache_entry_to_revalidate, m_not_modified_headers, m_request_time, Time::now_realtime());
+    serve_from_cache(entry.release_nonnull());
+}
+
+void Request::did_write_body_data(ReadonlyBytes bytes)
+{
+    if (m_cache_mode != CacheMode::Store)
+        return;
+    if (!m_body_for_cache.has_value())
+        m_body_for_cache = ByteBuffer {};
+
+    // NOTE: There's no point in holding on to data that is too big to be cached anyway.
+    if (m_body_for_cache->size() + bytes.size() > HttpCache::max_entry_size || m_body_for_cache->try_append(bytes).is_error()) {
+        m_cache_mode = CacheMode::Bypass;
+        m_body_for_cache.clear();
+    }
+}
+
+void Request::did_finish_network_request(bool success)
+{
+    if (!success)
+        return;
+
+    if (m_cache_mode == CacheMode::Invalidate) {
+        if (m_status_code.has_value() && m_status_code.value() < 400)
+            HttpCache::the().remove(url());
+        return;
+    }
+
+    if (m_cache_mode != CacheMode::Store || !m_status_code.has_value())
+        return;
+
+    auto body = m_body_for_cache.has_value() ? m_body_for_cache.release_value() : ByteBuffer {};
+    HttpCache::the().store(url(), m_status_code.value(), m_response_headers, move(body), m_request_time, Time::now_realtime());
+}
+
+void Request::serve_from_cache(NonnullRefPtr<HttpCache::Entry> entry)
+{
+    m_cached_entry = move(entry);
+
+    // NOTE: We wait until the pipe is writable before saying anything, which also makes sure that the client knows
+    //       about this request by the time the headers arrive.
+    m_cached_body_notifier = Core::Notifier::construct(m_output_stream->fd(), Core::Notifier::Write);
+    m_cached_body_notifier->on_ready_to_write = [this] {
+        write_cached_body();
+    };
+}
+
+void Request::write_cached_body()
+{
+    auto body = m_cached_entry->body();
+
+    if (!m_did_send_cached_headers) {
+        m_did_send_cached_headers = true;
+        set_status_code(m_cached_entry->status_code());
+        set_response_headers(m_cached_entry->response_headers());
+    }
+
+    while (m_cached_body_offset < body.size()) {
+        auto result = m_output_stream->write(body.slice(m_cached_body_offset));
+        if (result.is_error()) {
+            if (result.error().is_errno() && (result.error().code() == EAGAIN || result.error().code() == EINTR))
+                return;
+            dbgln("Request: Failed to write cached body for {}: {}", url(), result.error());
+            m_cached_body_notifier->set_enabled(false);
+            did_finish(false);
+            return;
+        }
+        m_cached_body_offset += result.value();
+    }
+
+    m_cached_body_notifier->set_enabled(false);
+    set_downloaded_size(body.size());
+    did_progress(body.size(), body.size());
+    // NOTE: This destroys us.
+    did_finish(true);
+}
+
 void Request::did_request_certificates()
 {
     m_client.did_request_certificates({}, *this);
@@ -11,8 +11,11 @@
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
 #include <AK/RefCounted.h>
+#include <AK/Time.h>
 #include <AK/URL.h>
+#include <LibCore/Notifier.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/HttpCache.h>
 
 namespace RequestServer {
 
@@ -43,6 +46,27 @@ public:
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     Core::Stream::File const& output_stream() const { return *m_output_stream; }
 
+    enum class CacheMode {
+        Bypass,
+        Store,
+        Invalidate,
+    };
+    void set_cache_mode(CacheMode cache_mode) { m_cache_mode = cache_mode; }
+    CacheMode cache_mode() const { return m_cache_mode; }
+
+    // While revalidating, a 304 response means that the stale entry can be used after all.
+    void set_cache_entry_to_revalidate(NonnullRefPtr<HttpCache::Entry> entry) { m_cache_entry_to_revalidate = move(entry); }
+    bool is_revalidating_cache_entry() const { return m_cache_entry_to_revalidate; }
+    void did_receive_not_modified(HashMap<String, String, CaseInsensitiveStringTraits> const& headers);
+    bool was_not_modified() const { return m_was_not_modified; }
+    void use_revalidated_cache_entry();
+
+    void did_write_body_data(ReadonlyBytes);
+    void did_finish_network_request(bool success);
+
+    // Sends the entry's response to the client as if it had come from the network. Reports the request as finished when done.
+    void serve_from_cache(NonnullRefPtr<HttpCache::Entry>);
+
 protected:
     explicit Request(ConnectionFromClient&, NonnullOwnPtr<Core::Stream::File>&&);
 
@@ -55,6 +79,20 @@ private:
     size_t m_downloaded_size { 0 };
     NonnullOwnPtr<Core::Stream::File> m_output_stream;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
+
+    void write_cached_body();
+
+    Time m_request_time;
+    CacheMode m_cache_mode { CacheMode::Bypass };
+    Optional<ByteBuffer> m_body_for_cache;
+    RefPtr<HttpCache::Entry> m_cache_entry_to_revalidate;
+    HashMap<String, String, CaseInsensitiveStringTraits> m_not_modified_headers;
+    bool m_was_not_modified { false };
+
+    RefPtr<HttpCache::Entry> m_cached_entry;
+    size_t m_cached_body_offset { 0 };
+    bool m_did_send_cached_headers { false };
+    RefPtr<Core::Notifier> m_cached_body_notifier;
 };
 
 }
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace RequestServer {
+
+// Requests that have to wait for a connection are started in order of priority, and in the order they came in otherwise.
+enum class RequestPriority : u8 {
+    Low,
+    Normal,
+    High,
+};
+
+constexpr StringView to_string(RequestPriority priority)
+{
+    switch (priority) {
+    case RequestPriority::Low:
+        return "Low"sv;
+    case RequestPriority::Normal:
+        return "Normal"sv;
+    case RequestPriority::High:
+        return "High"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// Requests multiplexed over one HTTP/2 connection share its bandwidth by weight instead, from 1 to 256.
+constexpr u16 http2_stream_weight(RequestPriority priority)
+{
+    switch (priority) {
+    case RequestPriority::Low:
+        return 8;
+    case RequestPriority::Normal:
+        return 32;
+    case RequestPriority::High:
+        return 256;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+}
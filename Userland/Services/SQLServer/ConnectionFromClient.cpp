@@ -65,12 +65,12 @@ Messages::SQLServer::SqlStatementResponse ConnectionFromClient::sql_statement(in
     }
 }
 
-void ConnectionFromClient::statement_execute(int statement_id)
+void ConnectionFromClient::statement_execute(int statement_id, Vector<SQL::Value> const& placeholder_values)
 {
     dbgln_if(SQLSERVER_DEBUG, "ConnectionFromClient::statement_execute_query(statement_id: {})", statement_id);
     auto statement = SQLStatement::statement_for(statement_id);
     if (statement && statement->connection()->client_id() == client_id()) {
-        statement->execute();
+        statement->execute(placeholder_values);
     } else {
         dbgln_if(SQLSERVER_DEBUG, "Statement has disappeared");
         async_execution_error(statement_id, (int)SQL::SQLErrorCode::StatementUnavailable, String::formatted("{}", statement_id));
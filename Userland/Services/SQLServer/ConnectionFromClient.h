@@ -29,7 +29,7 @@ private:
 
     virtual Messages::SQLServer::ConnectResponse connect(String const&) override;
     virtual Messages::SQLServer::SqlStatementResponse sql_statement(int, String const&) override;
-    virtual void statement_execute(int) override;
+    virtual void statement_execute(int, Vector<SQL::Value> const&) override;
     virtual void disconnect(int) override;
 };
 
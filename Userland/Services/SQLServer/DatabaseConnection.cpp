@@ -5,6 +5,7 @@
  */
 
 #include <AK/LexicalPath.h>
+#include <LibSQL/AST/Parser.h>
 #include <SQLServer/ConnectionFromClient.h>
 #include <SQLServer/DatabaseConnection.h>
 #include <SQLServer/SQLStatement.h>
@@ -23,6 +24,23 @@ RefPtr<DatabaseConnection> DatabaseConnection::connection_for(int connection_id)
 
 static int s_next_connection_id = 0;
 
+// All the connections to a database share the one Database object, so that they see each other's changes right away,
+// and their commits can be made together.
+static HashMap<String, WeakPtr<SQL::Database>> s_databases;
+
+static ErrorOr<NonnullRefPtr<SQL::Database>> find_or_open_database(String const& database_name)
+{
+    if (auto database = s_databases.get(database_name); database.has_value()) {
+        if (auto strong_database = database->strong_ref())
+            return strong_database.release_nonnull();
+    }
+
+    auto database = SQL::Database::construct(String::formatted("/home/anon/sql/{}.db", database_name));
+    TRY(database->open());
+    s_databases.set(database_name, database);
+    return database;
+}
+
 DatabaseConnection::DatabaseConnection(String database_name, int client_id)
     : Object()
     , m_database_name(move(database_name))
@@ -38,12 +56,13 @@ DatabaseConnection::DatabaseConnection(String database_name, int client_id)
     dbgln_if(SQLSERVER_DEBUG, "DatabaseConnection {} initiating connection with database '{}'", connection_id(), m_database_name);
     s_connections.set(m_connection_id, *this);
     deferred_invoke([this]() {
-        m_database = SQL::Database::construct(String::formatted("/home/anon/sql/{}.db", m_database_name));
         auto client_connection = ConnectionFromClient::client_connection_for(m_client_id);
-        if (auto maybe_error = m_database->open(); maybe_error.is_error()) {
-            client_connection->async_connection_error(m_connection_id, (int)SQL::SQLErrorCode::InternalError, maybe_error.error().string_literal());
+        auto database_or_error = find_or_open_database(m_database_name);
+        if (database_or_error.is_error()) {
+            client_connection->async_connection_error(m_connection_id, (int)SQL::SQLErrorCode::InternalError, database_or_error.error().string_literal());
             return;
         }
+        m_database = database_or_error.release_value();
         m_accept_statements = true;
         if (client_connection)
             client_connection->async_connected(m_connection_id, m_database_name);
@@ -83,4 +102,21 @@ int DatabaseConnection::sql_statement(String const& sql)
     return statement->statement_id();
 }
 
+SQL::ResultOr<NonnullRefPtr<SQL::AST::Statement>> DatabaseConnection::prepared_statement(String const& sql)
+{
+    if (auto statement = m_prepared_statements.get(sql); statement.has_value())
+        return *statement.value();
+
+    auto parser = SQL::AST::Parser(SQL::AST::Lexer(sql));
+    auto statement = parser.next_statement();
+    if (parser.has_errors())
+        return SQL::Result { SQL::SQLCommand::Unknown, SQL::SQLErrorCode::SyntaxError, parser.errors()[0].to_string() };
+
+    // Rather than keeping track of which statements were used last, the cache simply starts over once it's full.
+    if (m_prepared_statements.size() >= max_prepared_statements)
+        m_prepared_statements.clear();
+    m_prepared_statements.set(sql, statement);
+    return statement;
+}
+
 }
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <LibCore/Object.h>
+#include <LibSQL/AST/AST.h>
 #include <LibSQL/Database.h>
+#include <LibSQL/Result.h>
 #include <SQLServer/Forward.h>
 
 namespace SQLServer {
@@ -25,7 +28,13 @@ public:
     void disconnect();
     int sql_statement(String const& sql);
 
+    // Statements are only parsed the first time the connection sees their SQL. Statements that are prepared again, with
+    // placeholders for the values that change between them, get the statement that was parsed then.
+    SQL::ResultOr<NonnullRefPtr<SQL::AST::Statement>> prepared_statement(String const& sql);
+
 private:
+    static constexpr size_t max_prepared_statements = 64;
+
     DatabaseConnection(String database_name, int client_id);
 
     RefPtr<SQL::Database> m_database { nullptr };
@@ -33,6 +42,7 @@ private:
     int m_connection_id;
     int m_client_id;
     bool m_accept_statements { false };
+    HashMap<String, NonnullRefPtr<SQL::AST::Statement>> m_prepared_statements;
 };
 
 }
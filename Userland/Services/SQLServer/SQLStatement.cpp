@@ -4,8 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/TypeCasts.h>
 #include <LibCore/Object.h>
-#include <LibSQL/AST/Parser.h>
+#include <LibSQL/AST/Operators.h>
 #include <SQLServer/ConnectionFromClient.h>
 #include <SQLServer/DatabaseConnection.h>
 #include <SQLServer/SQLStatement.h>
@@ -48,10 +49,11 @@ void SQLStatement::report_error(SQL::Result result)
         warnln("Cannot return execution error. Client disconnected");
 
     m_statement = nullptr;
+    m_cursor = nullptr;
     m_result = {};
 }
 
-void SQLStatement::execute()
+void SQLStatement::execute(Vector<SQL::Value> placeholder_values)
 {
     dbgln_if(SQLSERVER_DEBUG, "SQLStatement::execute(statement_id {}", statement_id());
     auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
@@ -60,7 +62,7 @@ void SQLStatement::execute()
         return;
     }
 
-    deferred_invoke([this]() mutable {
+    deferred_invoke([this, placeholder_values = move(placeholder_values)]() mutable {
         auto parse_result = parse();
         if (parse_result.is_error()) {
             report_error(parse_result.release_error());
@@ -69,7 +71,28 @@ void SQLStatement::execute()
 
         VERIFY(!connection()->database().is_null());
 
-        auto execution_result = m_statement->execute(connection()->database().release_nonnull());
+        // The rows of a SELECT are read from the database as they're sent, rather than all of them up front.
+        if (is<SQL::AST::Select>(*m_statement)) {
+            auto cursor = static_cast<SQL::AST::Select const&>(*m_statement).open_cursor(connection()->database().release_nonnull(), placeholder_values);
+            if (cursor.is_error()) {
+                report_error(cursor.release_error());
+                return;
+            }
+
+            auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
+            if (!client_connection) {
+                warnln("Cannot return statement execution results. Client disconnected");
+                return;
+            }
+
+            m_cursor = cursor.release_value();
+            client_connection->async_execution_success(statement_id(), true, 0, 0, 0);
+            m_index = 0;
+            next();
+            return;
+        }
+
+        auto execution_result = m_statement->execute(connection()->database().release_nonnull(), placeholder_values);
         if (execution_result.is_error()) {
             report_error(execution_result.release_error());
             return;
@@ -87,19 +110,30 @@ void SQLStatement::execute()
             client_connection->async_execution_success(statement_id(), true, 0, 0, 0);
             m_index = 0;
             next();
-        } else {
-            client_connection->async_execution_success(statement_id(), false, 0, m_result->size(), 0);
+            return;
         }
+
+        // The client doesn't hear that the statement went through until it's committed. Statements from other connections
+        // that get executed before the commit is made are committed along with it.
+        connection()->database()->commit_soon([this, strong_this = NonnullRefPtr(*this)](ErrorOr<void> commit_result) {
+            if (commit_result.is_error()) {
+                report_error(commit_result.release_error());
+                return;
+            }
+
+            auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
+            if (!client_connection) {
+                warnln("Cannot return statement execution results. Client disconnected");
+                return;
+            }
+            client_connection->async_execution_success(statement_id(), false, 0, m_result->size(), 0);
+        });
     });
 }
 
 SQL::ResultOr<void> SQLStatement::parse()
 {
-    auto parser = SQL::AST::Parser(SQL::AST::Lexer(m_sql));
-    m_statement = parser.next_statement();
-
-    if (parser.has_errors())
-        return SQL::Result { SQL::SQLCommand::Unknown, SQL::SQLErrorCode::SyntaxError, parser.errors()[0].to_string() };
+    m_statement = TRY(connection()->prepared_statement(m_sql));
     return {};
 }
 
@@ -112,6 +146,7 @@ bool SQLStatement::should_send_result_rows() const
 
     switch (m_result->command()) {
     case SQL::SQLCommand::Describe:
+    case SQL::SQLCommand::Explain:
     case SQL::SQLCommand::Select:
         return true;
     default:
@@ -119,23 +154,56 @@ bool SQLStatement::should_send_result_rows() const
     }
 }
 
+SQL::ResultOr<Optional<SQL::Tuple>> SQLStatement::next_row()
+{
+    if (m_cursor) {
+        auto row = TRY(m_cursor->next());
+        if (row.has_value())
+            m_index++;
+        return row;
+    }
+
+    if (m_index >= m_result->size())
+        return Optional<SQL::Tuple> {};
+    return Optional<SQL::Tuple> { m_result->at(m_index++).row };
+}
+
 void SQLStatement::next()
 {
-    VERIFY(!m_result->is_empty());
     auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
     if (!client_connection) {
         warnln("Cannot yield next result. Client disconnected");
         return;
     }
-    if (m_index < m_result->size()) {
-        auto& tuple = m_result->at(m_index++).row;
-        client_connection->async_next_result(statement_id(), tuple.to_string_vector());
-        deferred_invoke([this]() {
-            next();
-        });
-    } else {
+
+    Vector<Vector<String>> rows;
+    bool is_exhausted = false;
+    while (rows.size() < rows_per_batch) {
+        auto row = next_row();
+        if (row.is_error()) {
+            report_error(row.release_error());
+            return;
+        }
+        if (!row.value().has_value()) {
+            is_exhausted = true;
+            break;
+        }
+        rows.append(row.value()->to_string_vector());
+    }
+
+    if (!rows.is_empty())
+        client_connection->async_next_results(statement_id(), move(rows));
+
+    if (is_exhausted) {
+        m_cursor = nullptr;
         client_connection->async_results_exhausted(statement_id(), (int)m_index);
+        return;
     }
+
+    // Whatever else the server has to do gets a turn between batches.
+    deferred_invoke([this]() {
+        next();
+    });
 }
 
 }
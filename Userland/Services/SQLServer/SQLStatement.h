@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/NonnullRefPtr.h>
+#include <AK/OwnPtr.h>
 #include <AK/String.h>
 #include <LibCore/Object.h>
 #include <LibSQL/AST/AST.h>
@@ -27,12 +28,16 @@ public:
     int statement_id() const { return m_statement_id; }
     String const& sql() const { return m_sql; }
     DatabaseConnection* connection() { return dynamic_cast<DatabaseConnection*>(parent()); }
-    void execute();
+    void execute(Vector<SQL::Value> placeholder_values);
 
 private:
+    // Rows are sent to the client a few at a time, so that the one message for every row doesn't cost more than the row itself.
+    static constexpr size_t rows_per_batch = 64;
+
     SQLStatement(DatabaseConnection&, String sql);
     SQL::ResultOr<void> parse();
     bool should_send_result_rows() const;
+    SQL::ResultOr<Optional<SQL::Tuple>> next_row();
     void next();
     void report_error(SQL::Result);
 
@@ -40,6 +45,7 @@ private:
     String m_sql;
     size_t m_index { 0 };
     RefPtr<SQL::AST::Statement> m_statement { nullptr };
+    OwnPtr<SQL::AST::Cursor> m_cursor;
     Optional<SQL::ResultSet> m_result {};
 };
 
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "ConnectionFromClient.h"
+#include <LibSymbolication/Symbolication.h>
+
+namespace SymbolServer {
+
+static HashMap<int, RefPtr<ConnectionFromClient>> s_connections;
+
+ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSocket> client_socket, int client_id)
+    : IPC::ConnectionFromClient<SymbolClientEndpoint, SymbolServerEndpoint>(*this, move(client_socket), client_id)
+{
+    s_connections.set(client_id, *this);
+}
+
+void ConnectionFromClient::die()
+{
+    s_connections.remove(client_id());
+}
+
+Messages::SymbolServer::SymbolicateResponse ConnectionFromClient::symbolicate(Vector<String> const& paths, Vector<FlatPtr> const& addresses, bool include_source_positions)
+{
+    if (paths.size() != addresses.size()) {
+        did_misbehave("Different number of paths and addresses");
+        return Vector<Optional<Symbolication::Symbol>> {};
+    }
+
+    Vector<Symbolication::SymbolRequest> requests;
+    requests.ensure_capacity(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i)
+        requests.unchecked_append({ paths[i], addresses[i] });
+
+    // NOTE: The objects stay loaded after this, so that the next client doesn't have to parse them again.
+    return Symbolication::symbolicate_in_process(requests, include_source_positions ? Symbolication::IncludeSourcePosition::Yes : Symbolication::IncludeSourcePosition::No);
+}
+
+}
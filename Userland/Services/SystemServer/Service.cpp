@@ -24,6 +24,8 @@
 
 static HashMap<pid_t, Service*> s_service_map;
 
+extern Core::ElapsedTimer g_boot_timer;
+
 Service* Service::find_by_pid(pid_t pid)
 {
     auto it = s_service_map.find(pid);
@@ -118,12 +120,26 @@ void Service::activate()
 {
     VERIFY(m_pid < 0);
 
+    if (!m_was_activated)
+        dbgln("SystemServer: [{:6}ms] Activating {}", g_boot_timer.elapsed(), name());
+    m_was_activated = true;
+
     if (m_lazy)
         setup_notifier();
     else
         spawn();
 }
 
+bool Service::is_ready() const
+{
+    if (!m_was_activated)
+        return false;
+    // Services that neither stay around nor serve sockets are expected to set something up and then exit.
+    if (!m_keep_alive && m_sockets.is_empty())
+        return m_pid < 0;
+    return true;
+}
+
 void Service::spawn(int socket_fd)
 {
     if (!Core::File::exists(m_executable_path)) {
@@ -236,6 +252,7 @@ void Service::spawn(int socket_fd)
         VERIFY_NOT_REACHED();
     } else if (!m_multi_instance) {
         // We are the parent.
+        dbgln("SystemServer: [{:6}ms] Spawned {} (pid {})", g_boot_timer.elapsed(), name(), pid);
         m_pid = pid;
         s_service_map.set(pid, this);
     }
@@ -246,7 +263,7 @@ void Service::did_exit(int exit_code)
     VERIFY(m_pid > 0);
     VERIFY(!m_multi_instance);
 
-    dbgln("Service {} has exited with exit code {}", name(), exit_code);
+    dbgln("SystemServer: [{:6}ms] Service {} has exited with exit code {}", g_boot_timer.elapsed(), name(), exit_code);
 
     s_service_map.remove(m_pid);
     m_pid = -1;
@@ -313,6 +330,15 @@ Service::Service(Core::ConfigFile const& config, StringView name)
     m_multi_instance = config.read_bool_entry(name, "MultiInstance");
     m_accept_socket_connections = config.read_bool_entry(name, "AcceptSocketConnections");
 
+    for (auto& required_service : config.read_entry(name, "Requires").split(',')) {
+        m_required_services.append(required_service);
+        m_services_to_start_after.append(required_service);
+    }
+    for (auto& service_to_start_after : config.read_entry(name, "After").split(',')) {
+        if (!m_services_to_start_after.contains_slow(service_to_start_after))
+            m_services_to_start_after.append(service_to_start_after);
+    }
+
     String socket_entry = config.read_entry(name, "Socket");
     String socket_permissions_entry = config.read_entry(name, "SocketPermissions", "0600");
 
@@ -24,6 +24,14 @@ public:
     void activate();
     void did_exit(int exit_code);
 
+    bool was_activated() const { return m_was_activated; }
+    // Whether the services that are to be started after this one can be activated now.
+    bool is_ready() const;
+
+    Vector<String> const& services_to_start_after() const { return m_services_to_start_after; }
+    void forget_services_to_start_after() { m_services_to_start_after.clear(); }
+    Vector<String> const& required_services() const { return m_required_services; }
+
     static Service* find_by_pid(pid_t);
 
     // FIXME: Port to Core::Property
@@ -74,12 +82,17 @@ private:
     Vector<String> m_environment;
     // Socket descriptors for this service.
     Vector<SocketDescriptor> m_sockets;
+    // Services that have to be ready before this one is activated, including the required ones.
+    Vector<String> m_services_to_start_after;
+    // Services without which this one is not started at all.
+    Vector<String> m_required_services;
 
     // The resolved user account to run this service as.
     Optional<Core::Account> m_account;
 
     // For single-instance services, PID of the running instance of this service.
     pid_t m_pid { -1 };
+    bool m_was_activated { false };
     RefPtr<Core::Notifier> m_socket_notifier;
 
     // Timer since we last spawned the service.
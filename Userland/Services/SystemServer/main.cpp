@@ -8,7 +8,9 @@
 #include "Service.h"
 #include <AK/Assertions.h>
 #include <AK/ByteBuffer.h>
+#include <AK/AllOf.h>
 #include <AK/Debug.h>
+#include <AK/HashTable.h>
 #include <Kernel/API/DeviceEvent.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ConfigFile.h>
@@ -31,6 +33,9 @@
 
 String g_system_mode = "graphical";
 NonnullRefPtrVector<Service> g_services;
+Core::ElapsedTimer g_boot_timer;
+
+static void activate_services_that_are_ready_to_start();
 
 // NOTE: This handler ensures that the destructor of g_services is called.
 static void sigterm_handler(int)
@@ -60,6 +65,8 @@ static void sigchld_handler(int)
 
         service->did_exit(status);
     }
+
+    activate_services_that_are_ready_to_start();
 }
 
 static ErrorOr<void> determine_system_mode()
@@ -478,8 +485,84 @@ static ErrorOr<void> create_tmp_semaphore_directory()
     return {};
 }
 
+static Service* find_service_by_name(StringView name)
+{
+    for (auto& service : g_services) {
+        if (service.name() == name)
+            return &service;
+    }
+    return nullptr;
+}
+
+static void drop_services_with_missing_requirements()
+{
+    // Dropping one service can leave others without their requirements, so keep going until nothing changes.
+    for (bool did_drop_service = true; did_drop_service;) {
+        did_drop_service = false;
+        for (size_t i = 0; i < g_services.size(); ++i) {
+            auto& service = g_services[i];
+            for (auto& required_service : service.required_services()) {
+                if (find_service_by_name(required_service))
+                    continue;
+                dbgln("Not starting {}, as it requires {}, which is not enabled", service.name(), required_service);
+                g_services.remove(i--);
+                did_drop_service = true;
+                break;
+            }
+        }
+    }
+}
+
+static void break_start_order_cycles()
+{
+    for (auto& service : g_services) {
+        HashTable<Service const*> visited_services;
+        Vector<Service const*> services_to_visit;
+        services_to_visit.append(&service);
+        bool starts_after_itself = false;
+        while (!services_to_visit.is_empty() && !starts_after_itself) {
+            auto const* current = services_to_visit.take_last();
+            for (auto& name : current->services_to_start_after()) {
+                auto const* dependency = find_service_by_name(name);
+                if (dependency == &service) {
+                    starts_after_itself = true;
+                    break;
+                }
+                if (dependency && visited_services.set(dependency) == AK::HashSetResult::InsertedNewEntry)
+                    services_to_visit.append(dependency);
+            }
+        }
+        if (starts_after_itself) {
+            dbgln("{} would have to start after itself, ignoring when it should be started", service.name());
+            service.forget_services_to_start_after();
+        }
+    }
+}
+
+static void activate_services_that_are_ready_to_start()
+{
+    // NOTE: Services are spawned without waiting for them, so everything that doesn't have to wait for others starts right away.
+    for (bool did_activate_service = true; did_activate_service;) {
+        did_activate_service = false;
+        for (auto& service : g_services) {
+            if (service.was_activated())
+                continue;
+            bool can_start = all_of(service.services_to_start_after(), [](auto& name) {
+                auto* dependency = find_service_by_name(name);
+                return !dependency || dependency->is_ready();
+            });
+            if (!can_start)
+                continue;
+            service.activate();
+            did_activate_service = true;
+        }
+    }
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
+    g_boot_timer.start();
+
     bool user = false;
     Core::ArgsParser args_parser;
     args_parser.add_option(user, "Run in user-mode", "user", 'u');
@@ -514,10 +597,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             g_services.append(move(service));
     }
 
+    drop_services_with_missing_requirements();
+    break_start_order_cycles();
+
     // After we've set them all up, activate them!
     dbgln("Activating {} services...", g_services.size());
-    for (auto& service : g_services)
-        service.activate();
+    activate_services_that_are_ready_to_start();
 
     return event_loop.exec();
 }
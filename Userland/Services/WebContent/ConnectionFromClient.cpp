@@ -222,6 +222,10 @@ void ConnectionFromClient::debug_request(String const& request, String const& ar
         }
     }
 
+    if (request == "dump-connection-pool") {
+        dbgln("{}", Web::ResourceLoader::the().connector().connection_pool_statistics());
+    }
+
     if (request == "collect-garbage") {
         Web::Bindings::main_thread_vm().heap().collect_garbage(JS::Heap::CollectionType::CollectGarbage, true);
     }
@@ -232,6 +236,11 @@ void ConnectionFromClient::debug_request(String const& request, String const& ar
         page().top_level_browsing_context().set_needs_display(page().top_level_browsing_context().viewport_rect());
     }
 
+    if (request == "set-tile-cache-overlay") {
+        m_page_host->set_should_show_tile_cache_overlay(argument == "on");
+        page().top_level_browsing_context().set_needs_display(page().top_level_browsing_context().viewport_rect());
+    }
+
     if (request == "clear-cache") {
         Web::ResourceLoader::the().clear_cache();
     }
@@ -460,7 +469,7 @@ Messages::WebContentServer::TakeDocumentScreenshotResponse ConnectionFromClient:
     Gfx::IntRect rect { { 0, 0 }, content_size };
 
     auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, rect.size()).release_value_but_fixme_should_propagate_errors();
-    m_page_host->paint(rect, *bitmap);
+    m_page_host->paint(rect, *bitmap, PageHost::UseTileCache::No);
 
     return { bitmap->to_shareable_bitmap() };
 }
@@ -11,6 +11,7 @@ namespace WebContent {
 class ConnectionFromClient;
 class ConsoleGlobalObject;
 class PageHost;
+class TileCompositor;
 class WebContentConsoleClient;
 class WebDriverConnection;
 
@@ -19,6 +19,7 @@
 #include <LibWeb/Painting/PaintableBox.h>
 #include <LibWeb/Platform/EventLoopPlugin.h>
 #include <LibWeb/Platform/Timer.h>
+#include <WebContent/TileCompositor.h>
 #include <WebContent/WebContentClientEndpoint.h>
 #include <WebContent/WebDriverConnection.h>
 
@@ -29,6 +30,17 @@ PageHost::PageHost(ConnectionFromClient& client)
     , m_page(make<Web::Page>(*this))
 {
     setup_palette();
+
+    // NOTE: Without worker threads, the tile cache just blits the tiles itself.
+    if (auto compositor_or_error = TileCompositor::try_create(); !compositor_or_error.is_error()) {
+        m_tile_compositor = compositor_or_error.release_value();
+        m_tile_cache.set_compositor([this](auto& target, auto const& jobs) {
+            m_tile_compositor->composite(target, jobs);
+        });
+    } else {
+        dbgln("Failed to create tile compositor: {}", compositor_or_error.error());
+    }
+
     m_invalidation_coalescing_timer = Web::Platform::Timer::create_single_shot(0, [this] {
         m_client.async_did_invalidate_content_rect(m_invalidation_rect);
         m_invalidation_rect = {};
@@ -39,6 +51,8 @@ PageHost::~PageHost() = default;
 
 void PageHost::set_has_focus(bool has_focus)
 {
+    if (m_has_focus != has_focus)
+        m_tile_cache.invalidate_all();
     m_has_focus = has_focus;
 }
 
@@ -62,6 +76,7 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(Gfx::PaletteImpl const& impl)
 {
     m_palette_impl = impl;
+    m_tile_cache.invalidate_all();
     if (auto* document = page().top_level_browsing_context().active_document())
         document->invalidate_style();
 }
@@ -108,7 +123,7 @@ Web::Layout::InitialContainingBlock* PageHost::layout_root()
     return document->layout_node();
 }
 
-void PageHost::paint(Gfx::IntRect const& content_rect, Gfx::Bitmap& target)
+void PageHost::paint(Gfx::IntRect const& content_rect, Gfx::Bitmap& target, UseTileCache use_tile_cache)
 {
     Gfx::Painter painter(target);
     Gfx::IntRect bitmap_rect { {}, content_rect.size() };
@@ -122,11 +137,47 @@ void PageHost::paint(Gfx::IntRect const& content_rect, Gfx::Bitmap& target)
         return;
     }
 
+    if (use_tile_cache == UseTileCache::No || !can_use_tile_cache()) {
+        m_tile_cache.invalidate_all();
+        paint_content(painter, content_rect, *layout_root);
+        return;
+    }
+
+    m_tile_cache.paint(target, content_rect, [&](Gfx::Painter& tile_painter, Gfx::IntRect const& tile_rect) {
+        paint_content(tile_painter, tile_rect, *layout_root);
+    });
+}
+
+void PageHost::paint_content(Gfx::Painter& painter, Gfx::IntRect const& content_rect, Web::Layout::InitialContainingBlock& layout_root)
+{
     Web::PaintContext context(painter, palette(), content_rect.top_left());
     context.set_should_show_line_box_borders(m_should_show_line_box_borders);
     context.set_viewport_rect(content_rect);
     context.set_has_focus(m_has_focus);
-    layout_root->paint_all_phases(context);
+    layout_root.paint_all_phases(context);
+}
+
+bool PageHost::can_use_tile_cache()
+{
+    // Things that are painted relative to the viewport look different in every tile, and would have to be
+    // repainted on every scroll anyway. This walk is cheap compared to painting everything.
+    bool has_viewport_relative_content = false;
+    page().top_level_browsing_context().for_each_in_inclusive_subtree([&](Web::HTML::BrowsingContext& browsing_context) {
+        auto* document = browsing_context.active_document();
+        if (!document || !document->layout_node())
+            return IterationDecision::Continue;
+        document->layout_node()->for_each_in_inclusive_subtree_of_type<Web::Layout::NodeWithStyle>([&](Web::Layout::NodeWithStyle& node) {
+            if (node.is_fixed_position())
+                has_viewport_relative_content = true;
+            for (auto const& layer : node.computed_values().background_layers()) {
+                if (layer.attachment == Web::CSS::BackgroundAttachment::Fixed)
+                    has_viewport_relative_content = true;
+            }
+            return has_viewport_relative_content ? IterationDecision::Break : IterationDecision::Continue;
+        });
+        return has_viewport_relative_content ? IterationDecision::Break : IterationDecision::Continue;
+    });
+    return !has_viewport_relative_content;
 }
 
 void PageHost::set_viewport_rect(Gfx::IntRect const& rect)
@@ -136,7 +187,14 @@ void PageHost::set_viewport_rect(Gfx::IntRect const& rect)
 
 void PageHost::page_did_invalidate(Gfx::IntRect const& content_rect)
 {
-    m_invalidation_rect = m_invalidation_rect.united(content_rect);
+    m_tile_cache.invalidate(content_rect);
+
+    // NOTE: We hear about invalidations outside the viewport too, but the client only has to repaint what it can see.
+    auto visible_content_rect = content_rect.intersected(page().top_level_browsing_context().viewport_rect());
+    if (visible_content_rect.is_empty())
+        return;
+
+    m_invalidation_rect = m_invalidation_rect.united(visible_content_rect);
     if (!m_invalidation_coalescing_timer->is_active())
         m_invalidation_coalescing_timer->start();
 }
@@ -153,6 +211,9 @@ void PageHost::page_did_request_cursor_change(Gfx::StandardCursor cursor)
 
 void PageHost::page_did_layout()
 {
+    // FIXME: Only invalidate the parts of the page whose layout actually changed.
+    m_tile_cache.invalidate_all();
+
     auto* layout_root = this->layout_root();
     VERIFY(layout_root);
     if (layout_root->paint_box()->has_overflow())
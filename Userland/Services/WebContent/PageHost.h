@@ -9,6 +9,7 @@
 
 #include <LibGfx/Rect.h>
 #include <LibWeb/Page/Page.h>
+#include <LibWeb/Painting/TileCache.h>
 #include <WebContent/Forward.h>
 
 namespace WebContent {
@@ -26,13 +27,22 @@ public:
     Web::Page& page() { return *m_page; }
     Web::Page const& page() const { return *m_page; }
 
-    void paint(Gfx::IntRect const& content_rect, Gfx::Bitmap&);
+    enum class UseTileCache {
+        No,
+        Yes,
+    };
+    void paint(Gfx::IntRect const& content_rect, Gfx::Bitmap&, UseTileCache = UseTileCache::Yes);
 
     void set_palette_impl(Gfx::PaletteImpl const&);
     void set_viewport_rect(Gfx::IntRect const&);
     void set_screen_rects(Vector<Gfx::IntRect, 4> const& rects, size_t main_screen_index) { m_screen_rect = rects[main_screen_index]; };
     void set_preferred_color_scheme(Web::CSS::PreferredColorScheme);
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool b)
+    {
+        m_should_show_line_box_borders = b;
+        m_tile_cache.invalidate_all();
+    }
+    void set_should_show_tile_cache_overlay(bool b) { m_tile_cache.set_should_show_debug_overlay(b); }
     void set_has_focus(bool);
     void set_is_scripting_enabled(bool);
     void set_is_webdriver_active(bool);
@@ -97,6 +107,8 @@ private:
 
     Web::Layout::InitialContainingBlock* layout_root();
     void setup_palette();
+    void paint_content(Gfx::Painter&, Gfx::IntRect const& content_rect, Web::Layout::InitialContainingBlock&);
+    bool can_use_tile_cache();
 
     ConnectionFromClient& m_client;
     NonnullOwnPtr<Web::Page> m_page;
@@ -106,6 +118,9 @@ private:
     bool m_should_show_line_box_borders { false };
     bool m_has_focus { false };
 
+    Web::Painting::TileCache m_tile_cache;
+    OwnPtr<TileCompositor> m_tile_compositor;
+
     RefPtr<Web::Platform::Timer> m_invalidation_coalescing_timer;
     Gfx::IntRect m_invalidation_rect;
     Web::CSS::PreferredColorScheme m_preferred_color_scheme { Web::CSS::PreferredColorScheme::Auto };
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StdLibExtras.h>
+#include <LibGfx/Bitmap.h>
+#include <WebContent/TileCompositor.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace WebContent {
+
+ErrorOr<NonnullOwnPtr<TileCompositor>> TileCompositor::try_create()
+{
+    auto compositor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) TileCompositor));
+
+    // NOTE: The main thread works on jobs as well, so it counts as one of the threads.
+    auto processor_count = max(1l, sysconf(_SC_NPROCESSORS_ONLN));
+    for (long i = 1; i < min(processor_count, 8l); ++i) {
+        auto thread = TRY(Threading::Thread::try_create([compositor = compositor.ptr()]() -> intptr_t {
+            compositor->m_mutex.lock();
+            while (true) {
+                compositor->m_work_available.wait_while([&] {
+                    return !compositor->m_should_exit && (!compositor->m_jobs || compositor->m_next_job == compositor->m_jobs->size());
+                });
+                if (compositor->m_should_exit)
+                    break;
+                compositor->m_mutex.unlock();
+                compositor->run_jobs_until_done();
+                compositor->m_mutex.lock();
+            }
+            compositor->m_mutex.unlock();
+            return 0;
+        },
+            "Tile compositor"sv));
+        thread->start();
+        compositor->m_threads.append(move(thread));
+    }
+
+    return compositor;
+}
+
+TileCompositor::~TileCompositor()
+{
+    {
+        Threading::MutexLocker locker(m_mutex);
+        m_should_exit = true;
+        m_work_available.broadcast();
+    }
+    for (auto& thread : m_threads)
+        (void)thread.join();
+}
+
+void TileCompositor::composite(Gfx::Bitmap& target, Vector<Web::Painting::TileCache::CompositeJob> const& jobs)
+{
+    // Waking up the workers isn't free, and a couple of tiles are copied quicker than that.
+    if (m_threads.is_empty() || jobs.size() < 4) {
+        for (auto const& job : jobs)
+            copy_tile(target, job);
+        return;
+    }
+
+    {
+        Threading::MutexLocker locker(m_mutex);
+        m_target = &target;
+        m_jobs = &jobs;
+        m_next_job = 0;
+        m_work_available.broadcast();
+    }
+
+    run_jobs_until_done();
+
+    Threading::MutexLocker locker(m_mutex);
+    m_work_finished.wait_while([&] {
+        return m_next_job < jobs.size() || m_jobs_in_progress > 0;
+    });
+    m_target = nullptr;
+    m_jobs = nullptr;
+}
+
+void TileCompositor::run_jobs_until_done()
+{
+    while (true) {
+        Gfx::Bitmap* target = nullptr;
+        Web::Painting::TileCache::CompositeJob const* job = nullptr;
+        {
+            Threading::MutexLocker locker(m_mutex);
+            if (!m_jobs || m_next_job == m_jobs->size())
+                return;
+            target = m_target;
+            job = &m_jobs->at(m_next_job++);
+            ++m_jobs_in_progress;
+        }
+
+        copy_tile(*target, *job);
+
+        Threading::MutexLocker locker(m_mutex);
+        if (--m_jobs_in_progress == 0 && m_next_job == m_jobs->size())
+            m_work_finished.signal();
+    }
+}
+
+void TileCompositor::copy_tile(Gfx::Bitmap& target, Web::Painting::TileCache::CompositeJob const& job)
+{
+    // NOTE: The tile cache only hands us tiles that have the same pixel format as the target, so we can copy them row by row.
+    auto const& tile = *job.tile;
+    auto destination_rect = Gfx::IntRect { job.destination, tile.size() }.intersected(target.rect());
+    if (destination_rect.is_empty())
+        return;
+    auto source_location = destination_rect.location() - job.destination;
+
+    for (int y = 0; y < destination_rect.height(); ++y) {
+        auto* destination = target.scanline(destination_rect.y() + y) + destination_rect.x();
+        auto const* source = tile.scanline(source_location.y() + y) + source_location.x();
+        memcpy(destination, source, destination_rect.width() * sizeof(Gfx::ARGB32));
+    }
+}
+
+}
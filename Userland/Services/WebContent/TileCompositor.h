@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+#include <LibWeb/Painting/TileCache.h>
+
+namespace WebContent {
+
+// Copies painted tiles into the backing store on a handful of worker threads, with the main thread helping out.
+// A big (or high-DPI) viewport is mostly tiles that didn't change, so this is where a repaint spends its time.
+class TileCompositor {
+    AK_MAKE_NONCOPYABLE(TileCompositor);
+    AK_MAKE_NONMOVABLE(TileCompositor);
+
+public:
+    static ErrorOr<NonnullOwnPtr<TileCompositor>> try_create();
+    ~TileCompositor();
+
+    void composite(Gfx::Bitmap& target, Vector<Web::Painting::TileCache::CompositeJob> const&);
+
+private:
+    TileCompositor() = default;
+
+    void run_jobs_until_done();
+    static void copy_tile(Gfx::Bitmap& target, Web::Painting::TileCache::CompositeJob const&);
+
+    Threading::Mutex m_mutex;
+    Threading::ConditionVariable m_work_available { m_mutex };
+    Threading::ConditionVariable m_work_finished { m_mutex };
+    NonnullRefPtrVector<Threading::Thread> m_threads;
+
+    // The current batch, guarded by m_mutex.
+    Gfx::Bitmap* m_target { nullptr };
+    Vector<Web::Painting::TileCache::CompositeJob> const* m_jobs { nullptr };
+    size_t m_next_job { 0 };
+    size_t m_jobs_in_progress { 0 };
+    bool m_should_exit { false };
+};
+
+}
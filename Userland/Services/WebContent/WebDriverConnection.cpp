@@ -615,23 +615,29 @@ Messages::WebDriverClient::MaximizeWindowResponse WebDriverConnection::maximize_
 }
 
 // 11.8.4 Minimize Window, https://w3c.github.io/webdriver/#minimize-window
-Messages::WebDriverClient::MinimizeWindowResponse WebDriverConnection::minimize_window()
+void WebDriverConnection::minimize_window(IPC::ResponsePromise<Messages::WebDriverClient::MinimizeWindowResponse> promise)
 {
     // 1. If the remote end does not support the Minimize Window command for the current top-level browsing context for any reason, return error with error code unsupported operation.
 
     // 2. If the current top-level browsing context is no longer open, return error with error code no such window.
-    TRY(ensure_open_top_level_browsing_context());
+    if (auto result = ensure_open_top_level_browsing_context(); result.is_error()) {
+        promise.resolve(result.release_error());
+        return;
+    }
 
     // 3. Handle any user prompts and return its value if it is an error.
-    TRY(handle_any_user_prompts());
+    if (auto result = handle_any_user_prompts(); result.is_error()) {
+        promise.resolve(result.release_error());
+        return;
+    }
 
     // FIXME: 4. Fully exit fullscreen.
 
     // 5. Iconify the window.
-    auto window_rect = iconify_the_window();
-
-    // 6. Return success with data set to the WindowRect object for the current top-level browsing context.
-    return serialize_rect(window_rect);
+    iconify_the_window([promise = move(promise)](Gfx::IntRect window_rect) mutable {
+        // 6. Return success with data set to the WindowRect object for the current top-level browsing context.
+        promise.resolve(serialize_rect(window_rect));
+    });
 }
 
 // 11.8.5 Fullscreen Window, https://w3c.github.io/webdriver/#dfn-fullscreen-window
@@ -1476,7 +1482,7 @@ Messages::WebDriverClient::TakeScreenshotResponse WebDriverConnection::take_scre
     auto root_rect = calculate_absolute_rect_of_element(m_page_host.page(), *document->document_element());
 
     auto encoded_string = TRY(Web::WebDriver::capture_element_screenshot(
-        [&](auto const& rect, auto& bitmap) { m_page_host.paint(rect, bitmap); },
+        [&](auto const& rect, auto& bitmap) { m_page_host.paint(rect, bitmap, PageHost::UseTileCache::No); },
         m_page_host.page(),
         *document->document_element(),
         root_rect));
@@ -1509,7 +1515,7 @@ Messages::WebDriverClient::TakeElementScreenshotResponse WebDriverConnection::ta
     auto element_rect = calculate_absolute_rect_of_element(m_page_host.page(), *element);
 
     auto encoded_string = TRY(Web::WebDriver::capture_element_screenshot(
-        [&](auto const& rect, auto& bitmap) { m_page_host.paint(rect, bitmap); },
+        [&](auto const& rect, auto& bitmap) { m_page_host.paint(rect, bitmap, PageHost::UseTileCache::No); },
         m_page_host.page(),
         *element,
         element_rect));
@@ -1599,19 +1605,35 @@ Gfx::IntRect WebDriverConnection::maximize_the_window()
 }
 
 // https://w3c.github.io/webdriver/#dfn-iconify-the-window
-Gfx::IntRect WebDriverConnection::iconify_the_window()
+void WebDriverConnection::iconify_the_window(Function<void(Gfx::IntRect)> on_complete)
 {
     // To iconify the window, given an operating system level window with an associated top-level browsing context, run implementation-specific steps to iconify, minimize, or hide the window from the visible screen.
     auto rect = m_web_content_client.did_request_minimize_window();
 
     // Do not return from this operation until the visibility state of the top-level browsing context’s active document has reached the hidden state, or until the operation times out.
+    // NOTE: The browser tells us about the new visibility state through its own message, so we check back on it from the
+    //       event loop instead of spinning a nested one in here. The response to WebDriver is sent once it's hidden.
     // FIXME: Implement timeouts.
-    Web::Platform::EventLoopPlugin::the().spin_until([this]() {
+    auto is_hidden = [this]() {
         auto state = m_page_host.page().top_level_browsing_context().system_visibility_state();
         return state == Web::HTML::VisibilityState::Hidden;
-    });
+    };
+    if (is_hidden()) {
+        on_complete(rect);
+        return;
+    }
 
-    return rect;
+    m_on_window_iconified = [rect, on_complete = move(on_complete)]() mutable { on_complete(rect); };
+    if (!m_visibility_state_timer) {
+        m_visibility_state_timer = Web::Platform::Timer::create_repeating(10, [this, is_hidden = move(is_hidden)]() {
+            if (!is_hidden())
+                return;
+            m_visibility_state_timer->stop();
+            auto on_window_iconified = move(m_on_window_iconified);
+            on_window_iconified();
+        });
+    }
+    m_visibility_state_timer->start();
 }
 
 // https://w3c.github.io/webdriver/#dfn-find
@@ -8,12 +8,15 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/String.h>
 #include <LibIPC/ConnectionToServer.h>
+#include <LibIPC/ResponsePromise.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/MarkedVector.h>
 #include <LibWeb/Forward.h>
+#include <LibWeb/Platform/Timer.h>
 #include <LibWeb/WebDriver/ElementLocationStrategies.h>
 #include <LibWeb/WebDriver/Response.h>
 #include <LibWeb/WebDriver/TimeoutsConfiguration.h>
@@ -55,7 +58,7 @@ private:
     virtual Messages::WebDriverClient::GetWindowRectResponse get_window_rect() override;
     virtual Messages::WebDriverClient::SetWindowRectResponse set_window_rect(JsonValue const& payload) override;
     virtual Messages::WebDriverClient::MaximizeWindowResponse maximize_window() override;
-    virtual Messages::WebDriverClient::MinimizeWindowResponse minimize_window() override;
+    virtual void minimize_window(IPC::ResponsePromise<Messages::WebDriverClient::MinimizeWindowResponse>) override;
     virtual Messages::WebDriverClient::FullscreenWindowResponse fullscreen_window() override;
     virtual Messages::WebDriverClient::FindElementResponse find_element(JsonValue const& payload) override;
     virtual Messages::WebDriverClient::FindElementsResponse find_elements(JsonValue const& payload) override;
@@ -92,7 +95,7 @@ private:
     ErrorOr<void, Web::WebDriver::Error> handle_any_user_prompts();
     void restore_the_window();
     Gfx::IntRect maximize_the_window();
-    Gfx::IntRect iconify_the_window();
+    void iconify_the_window(Function<void(Gfx::IntRect)> on_complete);
     ErrorOr<JsonArray, Web::WebDriver::Error> find(Web::DOM::ParentNode& start_node, Web::WebDriver::LocationStrategy using_, StringView value);
 
     struct ScriptArguments {
@@ -123,6 +126,9 @@ private:
     };
     HashMap<String, Window> m_windows;
     String m_current_window_handle;
+
+    RefPtr<Web::Platform::Timer> m_visibility_state_timer;
+    Function<void()> m_on_window_iconified;
 };
 
 }
@@ -18,10 +18,12 @@
 #include <LibCore/FileStream.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/MimeData.h>
+#include <LibCore/System.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <WebServer/FileCache.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -36,15 +38,26 @@ Client::Client(NonnullOwnPtr<Core::Stream::BufferedTCPSocket> socket, Core::Obje
 
 void Client::die()
 {
+    if (m_is_dying)
+        return;
+    m_is_dying = true;
+    if (m_idle_timer)
+        m_idle_timer->stop();
     m_socket->close();
     deferred_invoke([this] { remove_from_parent(); });
 }
 
 void Client::start()
 {
-    m_socket->on_ready_to_read = [this] {
-        StringBuilder builder;
+    m_idle_timer = Core::Timer::create_single_shot(
+        keep_alive_timeout_seconds * 1000, [this] {
+            dbgln_if(WEBSERVER_DEBUG, "Closing idle connection");
+            die();
+        },
+        this);
+    m_idle_timer->start();
 
+    m_socket->on_ready_to_read = [this] {
         auto maybe_buffer = ByteBuffer::create_uninitialized(m_socket->buffer_size());
         if (maybe_buffer.is_error()) {
             warnln("Could not create buffer for client: {}", maybe_buffer.error());
@@ -64,32 +77,125 @@ void Client::start()
             if (!maybe_can_read.value())
                 break;
 
-            auto maybe_bytes_read = m_socket->read_until_any_of(buffer, Array { "\r"sv, "\n"sv, "\r\n"sv });
+            auto maybe_bytes_read = m_socket->read(buffer);
             if (maybe_bytes_read.is_error()) {
-                warnln("Failed to read a line from the request: {}", maybe_bytes_read.error());
+                warnln("Failed to read the request: {}", maybe_bytes_read.error());
                 die();
                 return;
             }
 
-            if (m_socket->is_eof()) {
+            if (maybe_bytes_read.value().is_empty() && m_socket->is_eof()) {
                 die();
-                break;
+                return;
             }
 
-            builder.append(StringView { maybe_bytes_read.value() });
-            builder.append("\r\n"sv);
+            if (m_pending_input.try_append(maybe_bytes_read.value()).is_error() || m_pending_input.size() > maximum_pending_request_size) {
+                warnln("Dropping a client that sent more than {} bytes without finishing a request", maximum_pending_request_size);
+                die();
+                return;
+            }
+        }
+
+        handle_pending_requests();
+        // Sending a large response can take a while, the connection was only idle after it was done.
+        if (!m_is_dying)
+            m_idle_timer->restart();
+    };
+}
+
+// Looks for a complete header block at the start of `input`, and returns its size.
+// `normalized_request` receives the header block with every line ending turned into CRLF, as HTTP::HttpRequest expects.
+static Optional<size_t> find_end_of_request(ReadonlyBytes input, StringBuilder& normalized_request)
+{
+    size_t line_start = 0;
+    for (size_t i = 0; i < input.size(); ++i) {
+        if (input[i] != '\n')
+            continue;
+        auto line = StringView { input.slice(line_start, i - line_start) };
+        if (line.ends_with('\r'))
+            line = line.substring_view(0, line.length() - 1);
+        normalized_request.append(line);
+        normalized_request.append("\r\n"sv);
+        line_start = i + 1;
+        if (line.is_empty())
+            return line_start;
+    }
+    return {};
+}
+
+void Client::handle_pending_requests()
+{
+    // With pipelining, clients may send further requests before they've seen a response to the first one.
+    // We answer them in the order they came in, which is the only thing HTTP/1.1 requires of us.
+    while (!m_is_dying) {
+        StringBuilder builder;
+        auto request_size = find_end_of_request(m_pending_input, builder);
+        if (!request_size.has_value()) {
+            // Responses to a whole pipeline of requests go out together.
+            if (auto result = flush_output(); result.is_error()) {
+                warnln("Failed to send the response: {}", result.error());
+                die();
+            }
+            return;
         }
 
         auto request = builder.to_byte_buffer();
         dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", String::copy(request));
 
+        m_keep_alive = false;
         auto maybe_did_handle = handle_request(request);
         if (maybe_did_handle.is_error()) {
             warnln("Failed to handle the request: {}", maybe_did_handle.error());
+            m_keep_alive = false;
         }
 
-        die();
-    };
+        if (!m_keep_alive) {
+            (void)flush_output();
+            die();
+            return;
+        }
+
+        // FIXME: This moves everything that came after the request to the front, which is fine as long as pipelines are short.
+        auto remaining = m_pending_input.bytes().slice(request_size.value());
+        if (remaining.is_empty()) {
+            m_pending_input.clear();
+        } else {
+            auto maybe_remaining = ByteBuffer::copy(remaining);
+            if (maybe_remaining.is_error()) {
+                die();
+                return;
+            }
+            m_pending_input = maybe_remaining.release_value();
+        }
+    }
+}
+
+// https://www.rfc-editor.org/rfc/rfc9112#section-9.3
+static bool should_keep_connection_alive(ReadonlyBytes raw_request, HTTP::HttpRequest const& request)
+{
+    auto request_line = StringView { raw_request };
+    if (auto end_of_line = request_line.find("\r\n"sv); end_of_line.has_value())
+        request_line = request_line.substring_view(0, *end_of_line);
+
+    // HTTP/1.1 connections persist unless someone says otherwise, HTTP/1.0 ones only if the client asks for it.
+    bool keep_alive = request_line.ends_with("HTTP/1.1"sv);
+    for (auto& header : request.headers()) {
+        if (header.name.equals_ignoring_case("Connection"sv)) {
+            for (auto option : header.value.split_view(',')) {
+                auto trimmed_option = option.trim_whitespace();
+                if (trimmed_option.equals_ignoring_case("close"sv))
+                    return false;
+                if (trimmed_option.equals_ignoring_case("keep-alive"sv))
+                    keep_alive = true;
+            }
+        }
+        // We never read request bodies, so we'd take whatever follows the headers as the next request.
+        if (header.name.equals_ignoring_case("Transfer-Encoding"sv))
+            return false;
+        if (header.name.equals_ignoring_case("Content-Length"sv) && header.value.trim_whitespace() != "0"sv)
+            return false;
+    }
+    return keep_alive;
 }
 
 ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
@@ -99,6 +205,7 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
         return false;
     auto& request = request_or_error.value();
     auto resource_decoded = URL::percent_decode(request.resource());
+    m_keep_alive = should_keep_connection_alive(raw_request, request);
 
     if constexpr (WEBSERVER_DEBUG) {
         dbgln("Got HTTP request: {} {}", request.method_name(), request.resource());
@@ -108,6 +215,8 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
     }
 
     if (request.method() != HTTP::HttpRequest::Method::GET) {
+        // There may be a body we don't know what to do with, so this connection is done.
+        m_keep_alive = false;
         TRY(send_error_response(501, request));
         return false;
     }
@@ -152,6 +261,15 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
         real_path = index_html_path;
     }
 
+    auto& file_cache = FileCache::the();
+    auto maybe_stat = Core::System::stat(real_path);
+    if (!maybe_stat.is_error()) {
+        if (auto const* entry = file_cache.find(real_path, maybe_stat.value())) {
+            TRY(send_memory_response(entry->contents, request, { .type = entry->mime_type, .length = entry->contents.size() }));
+            return true;
+        }
+    }
+
     auto file = Core::File::construct(real_path);
     if (!file->open(Core::OpenMode::ReadOnly)) {
         TRY(send_error_response(404, request));
@@ -163,16 +281,71 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
         return false;
     }
 
-    Core::InputFileStream stream { file };
+    auto st = TRY(Core::System::fstat(file->fd()));
+    auto mime_type = Core::guess_mime_type_based_on_filename(real_path);
+    if (FileCache::should_cache(st)) {
+        auto contents = file->read_all();
+        auto length = contents.size();
+        file_cache.insert(real_path, st, move(contents), mime_type);
+        if (auto const* entry = file_cache.find(real_path, st)) {
+            TRY(send_memory_response(entry->contents, request, { .type = entry->mime_type, .length = entry->contents.size() }));
+            return true;
+        }
+        // The file changed while we were reading it, so let's just send whatever is there now.
+        dbgln_if(WEBSERVER_DEBUG, "Could not cache '{}' ({} bytes read, {} expected)", real_path, length, st.st_size);
+        st = TRY(Core::System::fstat(file->fd()));
+    }
 
-    TRY(send_response(stream, request, { .type = Core::guess_mime_type_based_on_filename(real_path), .length = TRY(Core::File::size(real_path)) }));
+    TRY(send_file_response(file->fd(), request, { .type = move(mime_type), .length = static_cast<size_t>(st.st_size) }));
     return true;
 }
 
-ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+ErrorOr<void> Client::write_to_socket(ReadonlyBytes bytes)
+{
+    // Collect small writes, so that the client gets full packets instead of one for every header block and body.
+    if (m_output.size() + bytes.size() <= maximum_buffered_output_size)
+        return m_output.try_append(bytes);
+
+    TRY(flush_output());
+    if (bytes.size() <= maximum_buffered_output_size)
+        return m_output.try_append(bytes);
+    return write_directly_to_socket(bytes);
+}
+
+ErrorOr<void> Client::flush_output()
+{
+    if (m_output.is_empty())
+        return {};
+    auto result = write_directly_to_socket(m_output);
+    m_output.clear();
+    return result;
+}
+
+ErrorOr<void> Client::write_directly_to_socket(ReadonlyBytes bytes)
+{
+    while (!bytes.is_empty()) {
+        auto nwritten = TRY(m_socket->write(bytes));
+        if (nwritten == 0)
+            return Error::from_errno(EPIPE);
+        bytes = bytes.slice(nwritten);
+    }
+    return {};
+}
+
+void Client::append_connection_header(StringBuilder& builder) const
+{
+    if (m_keep_alive) {
+        builder.append("Connection: keep-alive\r\n"sv);
+        builder.appendff("Keep-Alive: timeout={}\r\n", keep_alive_timeout_seconds);
+    } else {
+        builder.append("Connection: close\r\n"sv);
+    }
+}
+
+ErrorOr<void> Client::send_response_headers(HTTP::HttpRequest const& request, ContentInfo const& content_info)
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 200 OK\r\n"sv);
+    builder.append("HTTP/1.1 200 OK\r\n"sv);
     builder.append("Server: WebServer (SerenityOS)\r\n"sv);
     builder.append("X-Frame-Options: SAMEORIGIN\r\n"sv);
     builder.append("X-Content-Type-Options: nosniff\r\n"sv);
@@ -182,11 +355,17 @@ ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest con
     else
         builder.appendff("Content-Type: {}\r\n", content_info.type);
     builder.appendff("Content-Length: {}\r\n", content_info.length);
+    append_connection_header(builder);
     builder.append("\r\n"sv);
 
-    auto builder_contents = builder.to_byte_buffer();
-    TRY(m_socket->write(builder_contents));
+    TRY(write_to_socket(builder.string_view().bytes()));
     log_response(200, request);
+    return {};
+}
+
+ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_headers(request, content_info));
 
     char buffer[PAGE_SIZE];
     do {
@@ -194,25 +373,37 @@ ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest con
         if (response.unreliable_eof() && size == 0)
             break;
 
-        ReadonlyBytes write_buffer { buffer, size };
-        while (!write_buffer.is_empty()) {
-            auto nwritten = TRY(m_socket->write(write_buffer));
+        TRY(write_to_socket({ buffer, size }));
+    } while (true);
+
+    return {};
+}
 
-            if (nwritten == 0) {
-                dbgln("EEEEEE got 0 bytes written!");
-            }
+ErrorOr<void> Client::send_memory_response(ReadonlyBytes contents, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    VERIFY(contents.size() == content_info.length);
+    TRY(send_response_headers(request, content_info));
+    return write_to_socket(contents);
+}
 
-            write_buffer = write_buffer.slice(nwritten);
+ErrorOr<void> Client::send_file_response(int file_fd, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_headers(request, content_info));
+    TRY(flush_output());
+
+    // Let the kernel move the file contents into the socket, instead of bouncing them through a buffer of our own.
+    auto socket_fd = m_socket->fd();
+    VERIFY(socket_fd.has_value());
+    off_t offset = 0;
+    while (static_cast<size_t>(offset) < content_info.length) {
+        auto nsent = TRY(Core::System::sendfile(socket_fd.value(), file_fd, &offset, content_info.length - offset));
+        // The file got truncated while we were sending it, there's nothing more we can do.
+        if (nsent == 0) {
+            // We promised the client more bytes than we have, so the connection can't be reused.
+            m_keep_alive = false;
+            break;
         }
-    } while (true);
-
-    auto keep_alive = false;
-    if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_case("Connection"sv); }); !it.is_end()) {
-        if (it->value.trim_whitespace().equals_ignoring_case("keep-alive"sv))
-            keep_alive = true;
     }
-    if (!keep_alive)
-        m_socket->close();
 
     return {};
 }
@@ -220,14 +411,15 @@ ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest con
 ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 301 Moved Permanently\r\n"sv);
+    builder.append("HTTP/1.1 301 Moved Permanently\r\n"sv);
     builder.append("Location: "sv);
     builder.append(redirect_path);
     builder.append("\r\n"sv);
+    builder.append("Content-Length: 0\r\n"sv);
+    append_connection_header(builder);
     builder.append("\r\n"sv);
 
-    auto builder_contents = builder.to_byte_buffer();
-    TRY(m_socket->write(builder_contents));
+    TRY(write_to_socket(builder.string_view().bytes()));
 
     log_response(301, request);
     return {};
@@ -235,7 +427,7 @@ ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest
 
 static String folder_image_data()
 {
-    static String cache;
+    static thread_local String cache;
     if (cache.is_empty()) {
         auto file = Core::MappedFile::map("/res/icons/16x16/filetype-folder.png"sv).release_value_but_fixme_should_propagate_errors();
         cache = encode_base64(file->bytes());
@@ -245,7 +437,7 @@ static String folder_image_data()
 
 static String file_image_data()
 {
-    static String cache;
+    static thread_local String cache;
     if (cache.is_empty()) {
         auto file = Core::MappedFile::map("/res/icons/16x16/filetype-unknown.png"sv).release_value_but_fixme_should_propagate_errors();
         cache = encode_base64(file->bytes());
@@ -343,7 +535,7 @@ ErrorOr<void> Client::send_error_response(unsigned code, HTTP::HttpRequest const
     content_builder.append("</h1></body></html>"sv);
 
     StringBuilder header_builder;
-    header_builder.appendff("HTTP/1.0 {} ", code);
+    header_builder.appendff("HTTP/1.1 {} ", code);
     header_builder.append(reason_phrase);
     header_builder.append("\r\n"sv);
 
@@ -353,9 +545,10 @@ ErrorOr<void> Client::send_error_response(unsigned code, HTTP::HttpRequest const
     }
     header_builder.append("Content-Type: text/html; charset=UTF-8\r\n"sv);
     header_builder.appendff("Content-Length: {}\r\n", content_builder.length());
+    append_connection_header(header_builder);
     header_builder.append("\r\n"sv);
-    TRY(m_socket->write(header_builder.to_byte_buffer()));
-    TRY(m_socket->write(content_builder.to_byte_buffer()));
+    TRY(write_to_socket(header_builder.string_view().bytes()));
+    TRY(write_to_socket(content_builder.string_view().bytes()));
 
     log_response(code, request);
     return {};
@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <LibCore/Object.h>
 #include <LibCore/Stream.h>
+#include <LibCore/Timer.h>
 #include <LibHTTP/Forward.h>
 #include <LibHTTP/HttpRequest.h>
 
@@ -17,6 +19,12 @@ class Client final : public Core::Object {
     C_OBJECT(Client);
 
 public:
+    // How long an idle keep-alive connection is kept open for.
+    static constexpr int keep_alive_timeout_seconds = 10;
+    // Unparsed request data beyond this is a client that isn't playing nice.
+    static constexpr size_t maximum_pending_request_size = 64 * KiB;
+    static constexpr size_t maximum_buffered_output_size = 64 * KiB;
+
     void start();
 
 private:
@@ -27,8 +35,16 @@ private:
         size_t length {};
     };
 
+    void handle_pending_requests();
     ErrorOr<bool> handle_request(ReadonlyBytes);
+    ErrorOr<void> write_to_socket(ReadonlyBytes);
+    ErrorOr<void> flush_output();
+    ErrorOr<void> write_directly_to_socket(ReadonlyBytes);
+    void append_connection_header(StringBuilder&) const;
+    ErrorOr<void> send_response_headers(HTTP::HttpRequest const&, ContentInfo const&);
     ErrorOr<void> send_response(InputStream&, HTTP::HttpRequest const&, ContentInfo);
+    ErrorOr<void> send_memory_response(ReadonlyBytes, HTTP::HttpRequest const&, ContentInfo);
+    ErrorOr<void> send_file_response(int file_fd, HTTP::HttpRequest const&, ContentInfo);
     ErrorOr<void> send_redirect(StringView redirect, HTTP::HttpRequest const&);
     ErrorOr<void> send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<String> const& headers = {});
     void die();
@@ -37,6 +53,13 @@ private:
     bool verify_credentials(Vector<HTTP::HttpRequest::Header> const&);
 
     NonnullOwnPtr<Core::Stream::BufferedTCPSocket> m_socket;
+    RefPtr<Core::Timer> m_idle_timer;
+
+    // Requests that arrived but haven't been answered yet. With pipelining, this can hold several of them.
+    ByteBuffer m_pending_input;
+    ByteBuffer m_output;
+    bool m_keep_alive { false };
+    bool m_is_dying { false };
 };
 
 }
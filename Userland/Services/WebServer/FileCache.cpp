@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <WebServer/FileCache.h>
+
+namespace WebServer {
+
+FileCache& FileCache::the()
+{
+    static thread_local FileCache cache;
+    return cache;
+}
+
+bool FileCache::Entry::is_current_for(struct stat const& st) const
+{
+    return device == st.st_dev
+        && inode == st.st_ino
+        && size == st.st_size
+        && modification_time.tv_sec == st.st_mtim.tv_sec
+        && modification_time.tv_nsec == st.st_mtim.tv_nsec;
+}
+
+FileCache::Entry const* FileCache::find(String const& path, struct stat const& st)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    if (!it->value.is_current_for(st)) {
+        dbgln_if(WEBSERVER_DEBUG, "FileCache: '{}' changed on disk, dropping it", path);
+        remove(path);
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    it->value.last_used = ++m_use_counter;
+    return &it->value;
+}
+
+void FileCache::insert(String const& path, struct stat const& st, ByteBuffer contents, String mime_type)
+{
+    VERIFY(should_cache(st));
+    // The file might have grown between the stat() and reading it, don't trust anything but what we actually have.
+    if (contents.size() != static_cast<size_t>(st.st_size))
+        return;
+
+    remove(path);
+    while (!m_entries.is_empty() && m_total_size + contents.size() > maximum_total_size)
+        evict_least_recently_used();
+
+    m_total_size += contents.size();
+    m_entries.set(path,
+        Entry {
+            .contents = move(contents),
+            .mime_type = move(mime_type),
+            .device = st.st_dev,
+            .inode = st.st_ino,
+            .size = st.st_size,
+            .modification_time = st.st_mtim,
+            .last_used = ++m_use_counter,
+        });
+}
+
+void FileCache::remove(String const& path)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+        return;
+    m_total_size -= it->value.contents.size();
+    m_entries.remove(it);
+}
+
+void FileCache::evict_least_recently_used()
+{
+    auto least_recently_used = m_entries.begin();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->value.last_used < least_recently_used->value.last_used)
+            least_recently_used = it;
+    }
+    dbgln_if(WEBSERVER_DEBUG, "FileCache: Evicting '{}'", least_recently_used->key);
+    m_total_size -= least_recently_used->value.contents.size();
+    m_entries.remove(least_recently_used);
+}
+
+}
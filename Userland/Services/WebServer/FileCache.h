@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/String.h>
+#include <sys/stat.h>
+
+namespace WebServer {
+
+// Keeps the contents of small static files in memory, so that serving them again only costs a stat().
+// An entry is used for as long as the file's inode, size and modification time stay the same.
+// Every worker thread has its own cache, which means that we never have to take a lock to look something up.
+class FileCache {
+public:
+    static constexpr size_t maximum_file_size = 64 * KiB;
+    static constexpr size_t maximum_total_size = 4 * MiB;
+
+    struct Entry {
+        ByteBuffer contents;
+        String mime_type;
+        dev_t device { 0 };
+        ino_t inode { 0 };
+        off_t size { 0 };
+        timespec modification_time {};
+        u64 last_used { 0 };
+
+        bool is_current_for(struct stat const&) const;
+    };
+
+    static FileCache& the();
+
+    static bool should_cache(struct stat const& st) { return S_ISREG(st.st_mode) && static_cast<size_t>(st.st_size) <= maximum_file_size; }
+
+    // Returns the cached entry for `path`, unless the file has changed since it was cached.
+    Entry const* find(String const& path, struct stat const&);
+    void insert(String const& path, struct stat const&, ByteBuffer contents, String mime_type);
+
+    size_t total_size() const { return m_total_size; }
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+
+private:
+    FileCache() = default;
+
+    void remove(String const& path);
+    void evict_least_recently_used();
+
+    HashMap<String, Entry> m_entries;
+    size_t m_total_size { 0 };
+    u64 m_use_counter { 0 };
+    size_t m_hits { 0 };
+    size_t m_misses { 0 };
+};
+
+}
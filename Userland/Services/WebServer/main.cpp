@@ -5,19 +5,48 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NonnullRefPtrVector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
+#include <LibCore/Notifier.h>
 #include <LibCore/System.h>
 #include <LibCore/TCPServer.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibMain/Main.h>
+#include <LibThreading/Thread.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
 #include <stdio.h>
 #include <unistd.h>
 
+// Accepts every connection that's waiting on the listening socket, and runs its client on the calling thread's event loop.
+static void accept_clients(Core::TCPServer& server, Core::Object& parent)
+{
+    for (;;) {
+        auto maybe_client_socket = server.accept();
+        if (maybe_client_socket.is_error()) {
+            // EAGAIN means that another worker got there first, or that we've taken everything there was.
+            auto const& error = maybe_client_socket.error();
+            if (!error.is_errno() || (error.code() != EAGAIN && error.code() != EWOULDBLOCK))
+                warnln("Failed to accept the client: {}", error);
+            return;
+        }
+
+        auto maybe_buffered_socket = Core::Stream::BufferedTCPSocket::create(maybe_client_socket.release_value());
+        if (maybe_buffered_socket.is_error()) {
+            warnln("Could not obtain a buffered socket for the client: {}", maybe_buffered_socket.error());
+            continue;
+        }
+
+        // FIXME: Propagate errors
+        MUST(maybe_buffered_socket.value()->set_blocking(true));
+        auto client = WebServer::Client::construct(maybe_buffered_socket.release_value(), &parent);
+        client->start();
+    }
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     String default_listen_address = "0.0.0.0";
@@ -28,12 +57,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     int port = default_port;
     String username;
     String password;
+    int thread_count = max(1l, sysconf(_SC_NPROCESSORS_ONLN));
 
     Core::ArgsParser args_parser;
     args_parser.add_option(listen_address, "IP address to listen on", "listen-address", 'l', "listen_address");
     args_parser.add_option(port, "Port to listen on", "port", 'p', "port");
     args_parser.add_option(username, "HTTP basic authentication username", "user", 'U', "username");
     args_parser.add_option(password, "HTTP basic authentication password", "pass", 'P', "password");
+    args_parser.add_option(thread_count, "Number of threads serving clients (defaults to the number of CPUs)", "threads", 't', "count");
     args_parser.add_positional_argument(root_path, "Path to serve the contents of", "path", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -48,6 +79,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
+    if (thread_count < 1) {
+        warnln("Invalid thread count: {}", thread_count);
+        return 1;
+    }
+
     if (username.is_empty() != password.is_empty()) {
         warnln("Both username and password are required for HTTP basic authentication.");
         return 1;
@@ -60,7 +96,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
-    TRY(Core::System::pledge("stdio accept rpath inet unix"));
+    TRY(Core::System::pledge("stdio accept rpath inet unix thread"));
 
     WebServer::Configuration configuration(real_root_path);
 
@@ -72,26 +108,29 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto server = TRY(Core::TCPServer::try_create());
 
     server->on_ready_to_accept = [&] {
-        auto maybe_client_socket = server->accept();
-        if (maybe_client_socket.is_error()) {
-            warnln("Failed to accept the client: {}", maybe_client_socket.error());
-            return;
-        }
-
-        auto maybe_buffered_socket = Core::Stream::BufferedTCPSocket::create(maybe_client_socket.release_value());
-        if (maybe_buffered_socket.is_error()) {
-            warnln("Could not obtain a buffered socket for the client: {}", maybe_buffered_socket.error());
-            return;
-        }
-
-        // FIXME: Propagate errors
-        MUST(maybe_buffered_socket.value()->set_blocking(true));
-        auto client = WebServer::Client::construct(maybe_buffered_socket.release_value(), server);
-        client->start();
+        accept_clients(*server, *server);
     };
 
     TRY(server->listen(ipv4_address.value(), port));
 
+    // Every worker thread watches the listening socket with its own event loop and accepts connections for itself.
+    // The listening socket is non-blocking, so the workers that lose the race for a connection simply go back to waiting.
+    // The main thread's event loop serves clients as well, so we only need to start thread_count - 1 more.
+    NonnullRefPtrVector<Threading::Thread> workers;
+    for (int i = 1; i < thread_count; ++i) {
+        auto worker = Threading::Thread::construct([&server] {
+            Core::EventLoop worker_loop;
+            auto notifier = Core::Notifier::construct(server->fd(), Core::Notifier::Event::Read);
+            notifier->on_ready_to_read = [&] {
+                accept_clients(*server, *notifier);
+            };
+            return static_cast<intptr_t>(worker_loop.exec());
+        },
+            "WebServer[worker]"sv);
+        worker->start();
+        workers.append(move(worker));
+    }
+
     out("Listening on ");
     out("\033]8;;http://{}:{}\033\\", ipv4_address.value(), port);
     out("{}:{}", ipv4_address.value(), port);
@@ -102,6 +141,6 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::unveil(real_root_path, "r"sv));
     TRY(Core::System::unveil(nullptr, nullptr));
 
-    TRY(Core::System::pledge("stdio accept rpath"));
+    TRY(Core::System::pledge("stdio accept rpath thread"));
     return loop.exec();
 }
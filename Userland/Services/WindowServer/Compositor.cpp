@@ -51,13 +51,6 @@ Compositor::Compositor()
     m_display_link_notify_timer->stop();
 
     m_compose_timer = Core::Timer::create_single_shot(
-        1000 / 60,
-        [this] {
-            compose();
-        },
-        this);
-
-    m_immediate_compose_timer = Core::Timer::create_single_shot(
         0,
         [this] {
             compose();
@@ -102,6 +95,7 @@ void CompositorScreenData::init_bitmaps(Compositor& compositor, Screen& screen)
     m_flush_rects.clear_with_capacity();
     m_flush_transparent_rects.clear_with_capacity();
     m_flush_special_rects.clear_with_capacity();
+    m_back_buffer_damage.clear_with_capacity();
 
     auto size = screen.size();
     m_front_bitmap = nullptr;
@@ -132,9 +126,23 @@ void Compositor::init_bitmaps()
         return IterationDecision::Continue;
     });
 
+    update_refresh_interval();
     invalidate_screen();
 }
 
+void Compositor::update_refresh_interval()
+{
+    // We compose all screens at once, so keep up with the fastest one.
+    Optional<Time> refresh_interval;
+    Screen::for_each([&](auto& screen) {
+        if (!refresh_interval.has_value() || screen.refresh_interval() < *refresh_interval)
+            refresh_interval = screen.refresh_interval();
+        return IterationDecision::Continue;
+    });
+    m_frame_timings.refresh_interval = refresh_interval.value_or(Time::from_microseconds(1'000'000 / 60));
+    m_display_link_notify_timer->set_interval(max(1, static_cast<int>(m_frame_timings.refresh_interval.to_milliseconds())));
+}
+
 void Compositor::did_construct_window_manager(Badge<WindowManager>)
 {
     auto& wm = WindowManager::the();
@@ -177,6 +185,8 @@ void Compositor::compose()
         return;
     }
 
+    auto compose_start_time = Time::now_monotonic();
+
     if (m_occlusions_dirty) {
         m_occlusions_dirty = false;
         recompute_occlusions();
@@ -242,6 +252,43 @@ void Compositor::compose()
             dbgln("dirty screen: {}", r);
     }
 
+    bool have_back_buffer_damage = false;
+    Screen::for_each([&](auto& screen) {
+        if (screen.compositor_screen_data().m_back_buffer_damage.is_empty())
+            return IterationDecision::Continue;
+        have_back_buffer_damage = true;
+        return IterationDecision::Break;
+    });
+    Gfx::DisjointIntRectSet repainted_rects;
+    if (have_back_buffer_damage) {
+        // Figure out what we're going to paint in this frame, so that we only bring over the rest of what changed
+        // in the last one into the back buffers.
+        repainted_rects.add(m_opaque_wallpaper_rects.intersected(dirty_screen_rects));
+        repainted_rects.add(m_transparent_wallpaper_rects.intersected(dirty_screen_rects));
+        if (m_invalidated_window) {
+            auto add_repainted_window_rects = [&](Window& window) {
+                auto& dirty_rects = window.dirty_rects();
+                if (dirty_rects.is_empty())
+                    return;
+                repainted_rects.add(window.opaque_rects().intersected(dirty_rects));
+                repainted_rects.add(window.transparency_rects().intersected(dirty_rects));
+            };
+            auto* fullscreen_window = wm.active_fullscreen_window();
+            if (fullscreen_window && fullscreen_window->is_opaque()) {
+                add_repainted_window_rects(*fullscreen_window);
+            } else {
+                wm.for_each_visible_window_from_back_to_front([&](Window& window) {
+                    add_repainted_window_rects(window);
+                    return IterationDecision::Continue;
+                });
+            }
+        }
+    }
+    Screen::for_each([&](auto& screen) {
+        screen.compositor_screen_data().repair_back_buffer(screen, repainted_rects);
+        return IterationDecision::Continue;
+    });
+
     auto& cursor_screen = ScreenInput::the().cursor_location_screen();
 
     Screen::for_each([&](auto& screen) {
@@ -586,7 +633,8 @@ void Compositor::compose()
     m_invalidated_window = false;
     m_invalidated_cursor = false;
 
-    if (!m_animations.is_empty()) {
+    bool animations_are_running = !m_animations.is_empty();
+    if (animations_are_running) {
         Screen::for_each([&](auto& screen) {
             auto& screen_data = screen.compositor_screen_data();
             update_animations(screen, screen_data.m_flush_special_rects);
@@ -594,9 +642,6 @@ void Compositor::compose()
                 screen_data.m_have_flush_rects = true;
             return IterationDecision::Continue;
         });
-        // As long as animations are running make sure we keep rendering frames
-        m_invalidated_any = true;
-        start_compose_async_timer();
     }
 
     if (need_to_draw_cursor) {
@@ -608,6 +653,49 @@ void Compositor::compose()
         flush(screen);
         return IterationDecision::Continue;
     });
+
+    did_compose_frame(compose_start_time);
+
+    if (animations_are_running) {
+        // As long as animations are running make sure we keep rendering frames
+        m_invalidated_any = true;
+        start_compose_async_timer();
+    }
+}
+
+void Compositor::did_compose_frame(Time const& compose_start_time)
+{
+    auto now = Time::now_monotonic();
+    auto compose_time = now - compose_start_time;
+
+    auto& timings = m_frame_timings;
+    timings.frame_count++;
+    timings.last_compose_time = compose_time;
+    if (m_next_frame_deadline.has_value() && now > *m_next_frame_deadline)
+        timings.missed_frame_count++;
+    m_next_frame_deadline.clear();
+    if (m_first_pending_invalidation.has_value()) {
+        timings.last_latency = now - *m_first_pending_invalidation;
+        m_first_pending_invalidation.clear();
+    }
+
+    // Take slower frames into account right away, but only slowly trust faster ones, so that a single cheap frame
+    // doesn't make us start the next expensive one too late.
+    auto compose_time_us = compose_time.to_microseconds();
+    auto predicted_compose_time_us = timings.predicted_compose_time.to_microseconds();
+    if (compose_time_us > predicted_compose_time_us)
+        predicted_compose_time_us = compose_time_us;
+    else
+        predicted_compose_time_us = (predicted_compose_time_us * 7 + compose_time_us) / 8;
+    timings.predicted_compose_time = Time::from_microseconds(min(predicted_compose_time_us, timings.refresh_interval.to_microseconds()));
+
+    m_last_frame_presented_at = now;
+
+    if (m_compose_timer->is_active()) {
+        // Something was invalidated while we were composing, and it was scheduled against the previous frame.
+        m_compose_timer->stop();
+        start_compose_async_timer();
+    }
 }
 
 void Compositor::flush(Screen& screen)
@@ -621,6 +709,23 @@ void Compositor::flush(Screen& screen)
     }
     screen_data.m_have_flush_rects = false;
 
+    {
+        u64 pixels_composed = 0;
+        auto count_pixels = [&](Gfx::DisjointIntRectSet const& rects) {
+            for (auto& rect : rects.rects())
+                pixels_composed += rect.size().area();
+        };
+        count_pixels(screen_data.m_flush_rects);
+        count_pixels(screen_data.m_flush_transparent_rects);
+        count_pixels(screen_data.m_flush_special_rects);
+        pixels_composed *= screen.scale_factor() * screen.scale_factor();
+
+        auto& statistics = screen_data.m_statistics;
+        statistics.frame_count++;
+        statistics.last_frame_pixels_composed = pixels_composed;
+        statistics.total_pixels_composed += pixels_composed;
+    }
+
     auto screen_rect = screen.rect();
     if (m_flash_flush) {
         Gfx::IntRect bounding_flash;
@@ -668,67 +773,74 @@ void Compositor::flush(Screen& screen)
     if (screen_data.m_screen_can_set_buffer) {
         screen_data.flip_buffers(screen);
         screen_data.m_has_flipped = true;
-    }
 
-    auto do_flush = [&](Gfx::IntRect rect) {
-        VERIFY(screen_rect.contains(rect));
-        rect.translate_by(-screen_rect.location());
-
-        // Almost everything in Compositor is in logical coordinates, with the painters having
-        // a scale applied. But this routine accesses the backbuffer pixels directly, so it
-        // must work in physical coordinates.
-        auto scaled_rect = rect * screen.scale_factor();
-        Gfx::ARGB32* front_ptr = screen_data.m_front_bitmap->scanline(scaled_rect.y()) + scaled_rect.x();
-        Gfx::ARGB32* back_ptr = screen_data.m_back_bitmap->scanline(scaled_rect.y()) + scaled_rect.x();
-        size_t pitch = screen_data.m_back_bitmap->pitch();
-
-        // NOTE: The meaning of a flush depends on whether we can flip buffers or not.
-        //
-        //       If flipping is supported, flushing means that we've flipped, and now we
-        //       copy the changed bits from the front buffer to the back buffer, to keep
-        //       them in sync.
-        //
-        //       If flipping is not supported, flushing means that we copy the changed
-        //       rects from the backing bitmap to the display framebuffer.
-
-        Gfx::ARGB32* to_ptr;
-        const Gfx::ARGB32* from_ptr;
-
-        if (screen_data.m_screen_can_set_buffer) {
-            to_ptr = back_ptr;
-            from_ptr = front_ptr;
-        } else {
-            to_ptr = front_ptr;
-            from_ptr = back_ptr;
-        }
+        // The buffer we just flipped away from is now missing everything that changed in this frame. We only bring
+        // that over once we know what the next frame is going to paint, see CompositorScreenData::repair_back_buffer().
+        screen_data.m_back_buffer_damage.add(screen_data.m_flush_rects);
+        screen_data.m_back_buffer_damage.add(screen_data.m_flush_transparent_rects);
+        screen_data.m_back_buffer_damage.add(screen_data.m_flush_special_rects);
+        return;
+    }
 
-        for (int y = 0; y < scaled_rect.height(); ++y) {
-            fast_u32_copy(to_ptr, from_ptr, scaled_rect.width());
-            from_ptr = (const Gfx::ARGB32*)((const u8*)from_ptr + pitch);
-            to_ptr = (Gfx::ARGB32*)((u8*)to_ptr + pitch);
-        }
-        if (device_can_flush_buffers) {
-            // Whether or not we need to flush buffers, we need to at least track what we modified
-            // so that we can flush these areas next time before we flip buffers. Or, if we don't
-            // support buffer flipping then we will flush them shortly.
-            screen.queue_flush_display_rect(rect);
-        }
-    };
+    // If flipping is not supported, flushing means that we copy the changed
+    // rects from the backing bitmap to the display framebuffer.
     for (auto& rect : screen_data.m_flush_rects.rects())
-        do_flush(rect);
+        screen_data.copy_between_buffers(screen, *screen_data.m_front_bitmap, *screen_data.m_back_bitmap, rect);
     for (auto& rect : screen_data.m_flush_transparent_rects.rects())
-        do_flush(rect);
+        screen_data.copy_between_buffers(screen, *screen_data.m_front_bitmap, *screen_data.m_back_bitmap, rect);
     for (auto& rect : screen_data.m_flush_special_rects.rects())
-        do_flush(rect);
-    if (device_can_flush_buffers && !screen_data.m_screen_can_set_buffer) {
-        // If we also support flipping buffers we don't really need to flush these areas right now.
-        // Instead, we skip this step and just keep track of them until shortly before the next flip.
-        // If we however don't support flipping buffers then we need to flush the changed areas right
-        // now so that they can be sent to the device.
+        screen_data.copy_between_buffers(screen, *screen_data.m_front_bitmap, *screen_data.m_back_bitmap, rect);
+    if (device_can_flush_buffers) {
+        // We need to flush the changed areas right now so that they can be sent to the device.
         screen.flush_display(screen_data.m_buffers_are_flipped ? 1 : 0);
     }
 }
 
+void CompositorScreenData::copy_between_buffers(Screen& screen, Gfx::Bitmap& to, Gfx::Bitmap const& from, Gfx::IntRect const& rect)
+{
+    auto screen_rect = screen.rect();
+    VERIFY(screen_rect.contains(rect));
+    auto rect_in_screen = rect.translated(-screen_rect.location());
+
+    // Almost everything in Compositor is in logical coordinates, with the painters having
+    // a scale applied. But this routine accesses the buffer pixels directly, so it
+    // must work in physical coordinates.
+    auto scaled_rect = rect_in_screen * screen.scale_factor();
+    Gfx::ARGB32* to_ptr = to.scanline(scaled_rect.y()) + scaled_rect.x();
+    Gfx::ARGB32 const* from_ptr = from.scanline(scaled_rect.y()) + scaled_rect.x();
+    size_t to_pitch = to.pitch();
+    size_t from_pitch = from.pitch();
+
+    for (int y = 0; y < scaled_rect.height(); ++y) {
+        fast_u32_copy(to_ptr, from_ptr, scaled_rect.width());
+        from_ptr = (Gfx::ARGB32 const*)((u8 const*)from_ptr + from_pitch);
+        to_ptr = (Gfx::ARGB32*)((u8*)to_ptr + to_pitch);
+    }
+
+    // Whether or not we need to flush buffers, we need to at least track what we modified
+    // so that we can flush these areas next time before we flip buffers. Or, if we don't
+    // support buffer flipping then we will flush them shortly.
+    if (screen.can_device_flush_buffers())
+        screen.queue_flush_display_rect(rect_in_screen);
+}
+
+void CompositorScreenData::repair_back_buffer(Screen& screen, Gfx::DisjointIntRectSet const& repainted_rects)
+{
+    m_statistics.last_frame_pixels_copied = 0;
+    if (m_back_buffer_damage.is_empty())
+        return;
+
+    // Anything that is about to be repainted would just be overwritten again, so there's no need to copy it.
+    auto stale_rects = m_back_buffer_damage.shatter(repainted_rects);
+    m_back_buffer_damage.clear_with_capacity();
+
+    auto scale_factor = screen.scale_factor();
+    for (auto& rect : stale_rects.rects()) {
+        copy_between_buffers(screen, *m_back_bitmap, *m_front_bitmap, rect);
+        m_statistics.last_frame_pixels_copied += rect.size().area() * scale_factor * scale_factor;
+    }
+}
+
 void Compositor::invalidate_screen()
 {
     invalidate_screen(Screen::bounding_rect());
@@ -770,13 +882,25 @@ void Compositor::invalidate_window()
 
 void Compositor::start_compose_async_timer()
 {
-    // We delay composition by a timer interval, but to not affect latency too
-    // much, if a pending compose is not already scheduled, we also schedule an
-    // immediate compose the next spin of the event loop.
-    if (!m_compose_timer->is_active()) {
-        m_compose_timer->start();
-        m_immediate_compose_timer->start();
-    }
+    // We compose at most one frame per refresh interval. If the last frame was presented a while ago we compose
+    // right away, otherwise we wait until we can just barely finish the next frame by the time the display is due
+    // to show it, going by how long the last frames took to compose.
+    if (m_compose_timer->is_active())
+        return;
+
+    static constexpr auto compose_safety_margin = Time::from_milliseconds(2);
+
+    auto now = Time::now_monotonic();
+    if (!m_first_pending_invalidation.has_value())
+        m_first_pending_invalidation = now;
+
+    auto lead_time = m_frame_timings.predicted_compose_time + compose_safety_margin;
+    auto start_time = m_last_frame_presented_at + m_frame_timings.refresh_interval - lead_time;
+    if (start_time < now)
+        start_time = now;
+    m_next_frame_deadline = start_time + lead_time;
+
+    m_compose_timer->start(static_cast<int>((start_time - now).to_truncated_milliseconds()));
 }
 
 bool Compositor::set_background_color(String const& background_color)
@@ -1213,6 +1337,10 @@ void Compositor::recompute_occlusions()
         Gfx::DisjointIntRectSet remaining_visible_screen_rects;
         remaining_visible_screen_rects.add_many(Screen::rects());
         bool have_transparent = false;
+        // Everything the windows we've already visited cover, so that we don't have to walk all windows above
+        // each window again. The transparent areas don't include anything that is hidden by an opaque area.
+        Gfx::DisjointIntRectSet opaque_above;
+        Gfx::DisjointIntRectSet transparent_above;
         wm.for_each_visible_window_from_front_to_back([&](Window& w) {
             VERIFY(!w.is_minimized());
             w.transparency_wallpaper_rects().clear();
@@ -1264,60 +1392,34 @@ void Compositor::recompute_occlusions()
 
             auto render_rect_on_screen = w.frame().render_rect().translated(transition_offset);
             auto visible_window_rects = remaining_visible_screen_rects.intersected(w.rect().translated(transition_offset));
-            Gfx::DisjointIntRectSet opaque_covering;
-            Gfx::DisjointIntRectSet transparent_covering;
-            bool found_this_window = false;
-            wm.for_each_visible_window_from_back_to_front([&](Window& w2) {
-                if (!found_this_window) {
-                    if (&w == &w2)
-                        found_this_window = true;
-                    return IterationDecision::Continue;
+            auto opaque_covering = opaque_above.intersected(render_rect_on_screen);
+            auto transparent_covering = transparent_above.intersected(render_rect_on_screen);
+            if (!opaque_covering.is_empty()) {
+                if (!visible_window_rects.is_empty())
+                    visible_window_rects = visible_window_rects.shatter(opaque_covering);
+                if (!visible_opaque.is_empty()) {
+                    auto uncovered_opaque = visible_opaque.shatter(opaque_covering);
+                    visible_opaque = move(uncovered_opaque);
                 }
-
-                VERIFY(!w2.is_minimized());
-
-                auto w2_render_rect = w2.frame().render_rect();
-                auto w2_render_rect_on_screen = w2_render_rect;
-                auto w2_transition_offset = window_transition_offset(w2);
-                if (window_stack_transition_in_progress)
-                    w2_render_rect_on_screen.translate_by(w2_transition_offset);
-                if (!render_rect_on_screen.intersects(w2_render_rect_on_screen))
-                    return IterationDecision::Continue;
-
-                auto opaque_rects = w2.frame().opaque_render_rects();
-                auto transparent_rects = w2.frame().transparent_render_rects();
-                if (window_stack_transition_in_progress) {
-                    auto transition_offset_2 = window_transition_offset(w2);
-                    opaque_rects.translate_by(transition_offset_2);
-                    transparent_rects.translate_by(transition_offset_2);
+                if (!transparency_rects.is_empty()) {
+                    auto uncovered_transparency = transparency_rects.shatter(opaque_covering);
+                    transparency_rects = move(uncovered_transparency);
                 }
-                opaque_rects = opaque_rects.intersected(render_rect_on_screen);
-                transparent_rects = transparent_rects.intersected(render_rect_on_screen);
-                if (opaque_rects.is_empty() && transparent_rects.is_empty())
-                    return IterationDecision::Continue;
-                VERIFY(!opaque_rects.intersects(transparent_rects));
-                for (auto& covering : opaque_rects.rects()) {
-                    opaque_covering.add(covering);
-                    if (!visible_window_rects.is_empty())
-                        visible_window_rects = visible_window_rects.shatter(covering);
-                    if (!visible_opaque.is_empty()) {
-                        auto uncovered_opaque = visible_opaque.shatter(covering);
-                        visible_opaque = move(uncovered_opaque);
-                    }
-                    if (!transparency_rects.is_empty()) {
-                        auto uncovered_transparency = transparency_rects.shatter(covering);
-                        transparency_rects = move(uncovered_transparency);
-                    }
-                    if (!transparent_covering.is_empty()) {
-                        auto uncovered_transparency = transparent_covering.shatter(covering);
-                        transparent_covering = move(uncovered_transparency);
-                    }
+            }
+            VERIFY(!transparent_covering.intersects(opaque_covering));
+
+            // Anything this window covers also covers all windows below it
+            VERIFY(!opaque_frame_render_rects.intersects(transparent_frame_render_rects));
+            if (!transparent_frame_render_rects.is_empty())
+                transparent_above.add(transparent_frame_render_rects.shatter(opaque_above));
+            if (!opaque_frame_render_rects.is_empty()) {
+                if (!transparent_above.is_empty()) {
+                    auto uncovered_transparent_above = transparent_above.shatter(opaque_frame_render_rects);
+                    transparent_above = move(uncovered_transparent_above);
                 }
-                if (!transparent_rects.is_empty())
-                    transparent_covering.add(transparent_rects.shatter(opaque_covering));
-                VERIFY(!transparent_covering.intersects(opaque_covering));
-                return IterationDecision::Continue;
-            });
+                opaque_above.add(opaque_frame_render_rects);
+            }
+
             VERIFY(opaque_covering.is_empty() || render_rect_on_screen.contains(opaque_covering.rects()));
             if (!m_overlay_rects.is_empty() && m_overlay_rects.intersects(visible_opaque)) {
                 // In order to render overlays flicker-free we need to force this area into the
@@ -1336,7 +1438,7 @@ void Compositor::recompute_occlusions()
                 // figure out what windows they belong to and add them to the affected transparency rects.
                 // We can't do the same with the windows below as we haven't gotten to those yet. These
                 // will be determined after we're done with this pass.
-                found_this_window = false;
+                bool found_this_window = false;
                 wm.for_each_visible_window_from_back_to_front([&](Window& w2) {
                     if (!found_this_window) {
                         if (&w == &w2)
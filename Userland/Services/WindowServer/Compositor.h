@@ -8,6 +8,7 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Time.h>
 #include <LibCore/Object.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
@@ -56,10 +57,25 @@ struct CompositorScreenData {
     Gfx::DisjointIntRectSet m_flush_transparent_rects;
     Gfx::DisjointIntRectSet m_flush_special_rects;
 
+    // When we can flip buffers, the back buffer is always one frame behind the front buffer. Instead of copying
+    // everything that changed over right after flipping, we remember it here and only bring over what the next
+    // frame isn't going to paint over anyway.
+    Gfx::DisjointIntRectSet m_back_buffer_damage;
+
+    struct Statistics {
+        u64 frame_count { 0 };
+        u64 total_pixels_composed { 0 };
+        u64 last_frame_pixels_composed { 0 };
+        u64 last_frame_pixels_copied { 0 };
+    };
+    Statistics m_statistics;
+
     Gfx::Painter& overlay_painter() { return *m_temp_painter; }
 
     void init_bitmaps(Compositor&, Screen&);
     void flip_buffers(Screen&);
+    void repair_back_buffer(Screen&, Gfx::DisjointIntRectSet const& repainted_rects);
+    void copy_between_buffers(Screen&, Gfx::Bitmap& to, Gfx::Bitmap const& from, Gfx::IntRect const&);
     void draw_cursor(Screen&, Gfx::IntRect const&);
     bool restore_cursor_back(Screen&, Gfx::IntRect&);
     void init_wallpaper_bitmap(Screen&);
@@ -187,6 +203,16 @@ public:
 
     void set_flash_flush(bool b) { m_flash_flush = b; }
 
+    struct FrameTimings {
+        Time refresh_interval;
+        u64 frame_count { 0 };
+        u64 missed_frame_count { 0 };
+        Time last_compose_time;
+        Time predicted_compose_time;
+        Time last_latency;
+    };
+    FrameTimings const& frame_timings() const { return m_frame_timings; }
+
     static NonnullOwnPtr<CompositorScreenData> create_screen_data(Badge<Screen>)
     {
         return adopt_own(*new CompositorScreenData());
@@ -204,6 +230,8 @@ private:
     void update_fonts();
     void notify_display_links();
     void start_compose_async_timer();
+    void update_refresh_interval();
+    void did_compose_frame(Time const& compose_start_time);
     void recompute_overlay_rects();
     void recompute_occlusions();
     void change_cursor(Cursor const*);
@@ -218,7 +246,6 @@ private:
     void update_wallpaper_bitmap();
 
     RefPtr<Core::Timer> m_compose_timer;
-    RefPtr<Core::Timer> m_immediate_compose_timer;
     bool m_flash_flush { false };
     bool m_occlusions_dirty { true };
     bool m_invalidated_any { true };
@@ -252,6 +279,11 @@ private:
     Optional<Gfx::Color> m_custom_background_color;
 
     HashTable<Animation*> m_animations;
+
+    FrameTimings m_frame_timings;
+    Time m_last_frame_presented_at;
+    Optional<Time> m_next_frame_deadline;
+    Optional<Time> m_first_pending_invalidation;
 };
 
 }
@@ -760,6 +760,22 @@ void ConnectionFromClient::set_window_backing_store(i32 window_id, [[maybe_unuse
         window.invalidate(false);
 }
 
+Messages::WindowServer::FlipWindowBackingStoreResponse ConnectionFromClient::flip_window_backing_store(i32 window_id, i32 serial, Vector<Gfx::IntRect> const& damage_rects)
+{
+    auto it = m_windows.find(window_id);
+    if (it == m_windows.end()) {
+        did_misbehave("FlipWindowBackingStore: Bad window ID");
+        return false;
+    }
+    auto& window = *(*it).value;
+    // We can only flip back to the backing store we had before, anything else has to go through set_window_backing_store.
+    if (!window.last_backing_store() || window.last_backing_store_serial() != serial)
+        return false;
+    window.swap_backing_stores();
+    did_finish_painting(window_id, damage_rects);
+    return true;
+}
+
 void ConnectionFromClient::set_global_mouse_tracking(bool enabled)
 {
     m_does_global_mouse_tracking = enabled;
@@ -1295,6 +1311,24 @@ void ConnectionFromClient::set_flash_flush(bool enabled)
     Compositor::the().set_flash_flush(enabled);
 }
 
+Messages::WindowServer::GetCompositorStatisticsResponse ConnectionFromClient::get_compositor_statistics(u32 screen_index)
+{
+    auto* screen = Screen::find_by_index(screen_index);
+    if (!screen) {
+        dbgln("GetCompositorStatistics: Screen {} does not exist", screen_index);
+        return { 0, 0, 0, 0 };
+    }
+    auto& statistics = screen->compositor_screen_data().m_statistics;
+    return { statistics.frame_count, statistics.total_pixels_composed, statistics.last_frame_pixels_composed, statistics.last_frame_pixels_copied };
+}
+
+Messages::WindowServer::GetCompositorFrameTimingsResponse ConnectionFromClient::get_compositor_frame_timings()
+{
+    auto& timings = Compositor::the().frame_timings();
+    auto to_microseconds = [](Time const& time) { return static_cast<u32>(min(time.to_microseconds(), NumericLimits<u32>::max())); };
+    return { to_microseconds(timings.refresh_interval), timings.frame_count, timings.missed_frame_count, to_microseconds(timings.last_compose_time), to_microseconds(timings.predicted_compose_time), to_microseconds(timings.last_latency) };
+}
+
 void ConnectionFromClient::set_window_parent_from_client(i32 client_id, i32 parent_id, i32 child_id)
 {
     auto* child_window = window_from_id(child_id);
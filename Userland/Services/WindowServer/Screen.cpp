@@ -10,12 +10,14 @@
 #include "Event.h"
 #include "EventLoop.h"
 #include "ScreenBackend.h"
+#include "VirGLScreenBackend.h"
 #include "VirtualScreenBackend.h"
 #include "WindowManager.h"
 #include <AK/Debug.h>
 #include <AK/Format.h>
 #include <Kernel/API/Graphics.h>
 #include <Kernel/API/MousePacket.h>
+#include <LibCore/System.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <sys/mman.h>
@@ -231,7 +233,11 @@ bool Screen::open_device()
 
     switch (info.mode) {
     case ScreenLayout::Screen::Mode::Device: {
-        m_backend = make<HardwareScreenBackend>(info.device.value());
+        // Present through the GPU when the VM gives us VirGL, which falls back to the display connector by itself.
+        if (Core::System::access("/dev/gpu/render0"sv, R_OK | W_OK).is_error())
+            m_backend = make<HardwareScreenBackend>(info.device.value());
+        else
+            m_backend = make<VirGLScreenBackend>(info.device.value());
         auto return_value = m_backend->open();
         if (return_value.is_error()) {
             dbgln("Screen #{}: Failed to open backend: {}", index(), return_value.error());
@@ -352,6 +358,12 @@ bool Screen::set_resolution(bool initial)
         auto mode_setting = TRY(m_backend->get_head_mode_setting());
         info.resolution = { mode_setting.horizontal_active, mode_setting.vertical_active };
 
+        u64 total_pixels_per_frame = static_cast<u64>(mode_setting.horizontal_active + mode_setting.horizontal_blank_pixels) * (mode_setting.vertical_active + mode_setting.vertical_blank_lines);
+        if (mode_setting.pixel_clock_in_khz > 0 && total_pixels_per_frame > 0)
+            m_refresh_interval = Time::from_microseconds(total_pixels_per_frame * 1000 / mode_setting.pixel_clock_in_khz);
+        else
+            m_refresh_interval = Time::from_microseconds(1'000'000 / 60);
+
         update_virtual_and_physical_rects();
 
         // Since pending flush rects are affected by the scale factor
@@ -12,6 +12,7 @@
 #include "ScreenLayout.h"
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
+#include <AK/Time.h>
 #include <Kernel/API/KeyCode.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Color.h>
@@ -167,6 +168,9 @@ public:
     Gfx::IntSize size() const { return { m_virtual_rect.width(), m_virtual_rect.height() }; }
     Gfx::IntRect rect() const { return m_virtual_rect; }
 
+    // How long the display takes to scan out one frame. Devices that don't report their timings are assumed to run at 60 Hz.
+    Time refresh_interval() const { return m_refresh_interval; }
+
     bool can_device_flush_buffers() const { return m_backend->m_can_device_flush_buffers; }
     bool can_device_flush_entire_buffer() const { return m_backend->m_can_device_flush_entire_framebuffer; }
     void queue_flush_display_rect(Gfx::IntRect const& rect);
@@ -210,6 +214,7 @@ private:
 
     Gfx::IntRect m_virtual_rect;
     Gfx::IntRect m_physical_rect;
+    Time m_refresh_interval { Time::from_microseconds(1'000'000 / 60) };
 
     NonnullOwnPtr<FlushRectData> m_flush_rects;
     NonnullOwnPtr<CompositorScreenData> m_compositor_screen_data;
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "VirGLScreenBackend.h"
+#include <AK/Try.h>
+#include <Kernel/API/Graphics.h>
+#include <Kernel/API/VirGL.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace WindowServer {
+
+// These come from virglrenderer's virgl_protocol.h and virgl_hw.h.
+static constexpr u32 virgl_command_transfer3d = 43;
+static constexpr u32 virgl_command_end_transfers = 44;
+static constexpr u32 pipe_texture_2d = 2;
+static constexpr u32 pipe_map_write = 1 << 1;
+static constexpr u32 virgl_format_b8g8r8x8_unorm = 2;
+static constexpr u32 virgl_bind_render_target = 1 << 1;
+static constexpr u32 virgl_bind_sampler_view = 1 << 3;
+static constexpr u32 virgl_bind_scanout = 1 << 18;
+
+static constexpr u32 encode_command_header(u32 command, u32 length)
+{
+    return (length << 16) | (command & 0xff);
+}
+
+VirGLScreenBackend::VirGLScreenBackend(String device)
+    : HardwareScreenBackend(move(device))
+{
+}
+
+VirGLScreenBackend::~VirGLScreenBackend()
+{
+    if (m_using_gpu && m_framebuffer) {
+        MUST(Core::System::munmap(m_framebuffer, m_transfer_region_size));
+
+        m_framebuffer = nullptr;
+        m_size_in_bytes = 0;
+    }
+    destroy_scanout_resource();
+    if (m_gpu_fd >= 0) {
+        close(m_gpu_fd);
+        m_gpu_fd = -1;
+    }
+}
+
+ErrorOr<void> VirGLScreenBackend::open()
+{
+    TRY(HardwareScreenBackend::open());
+
+    m_connector_can_flush_buffers = m_can_device_flush_buffers;
+    m_connector_can_flush_entire_framebuffer = m_can_device_flush_entire_framebuffer;
+    m_connector_can_set_head_buffer = m_can_set_head_buffer;
+
+    if (auto result = open_gpu_context(); result.is_error())
+        fall_back_to_display_connector(result.error());
+    return {};
+}
+
+ErrorOr<void> VirGLScreenBackend::open_gpu_context()
+{
+    m_gpu_fd = TRY(Core::System::open("/dev/gpu/render0"sv, O_RDWR | O_CLOEXEC));
+
+    // A single buffer is enough, as the displayed resource only changes when we flush it.
+    m_transfer_region_size = m_connector_can_set_head_buffer ? m_max_size_in_bytes / 2 : m_max_size_in_bytes;
+    VirGLContextSpec context_spec { .transfer_region_size = m_transfer_region_size };
+    TRY(Core::System::ioctl(m_gpu_fd, VIRGL_IOCTL_CREATE_CONTEXT, &context_spec));
+
+    // This fails if the 3D device isn't on the same adapter as our display connector.
+    VirGLScanoutDescriptor scanout_descriptor { .display_connector_fd = m_display_connector_fd, .resource_id = 0 };
+    TRY(Core::System::ioctl(m_gpu_fd, VIRGL_IOCTL_SET_SCANOUT, &scanout_descriptor));
+
+    m_using_gpu = true;
+    m_can_set_head_buffer = false;
+    m_can_device_flush_buffers = true;
+    m_can_device_flush_entire_framebuffer = false;
+    return {};
+}
+
+void VirGLScreenBackend::fall_back_to_display_connector(Error const& error)
+{
+    dbgln("VirGLScreenBackend: Can't present through the GPU, using {} directly: {}", m_device, error);
+    destroy_scanout_resource();
+    // Closing the context gives the display back to the connector's framebuffer.
+    if (m_gpu_fd >= 0) {
+        close(m_gpu_fd);
+        m_gpu_fd = -1;
+    }
+    m_using_gpu = false;
+    m_can_device_flush_buffers = m_connector_can_flush_buffers;
+    m_can_device_flush_entire_framebuffer = m_connector_can_flush_entire_framebuffer;
+    m_can_set_head_buffer = m_connector_can_set_head_buffer;
+}
+
+ErrorOr<void> VirGLScreenBackend::display_scanout_resource()
+{
+    // Setting a mode gives the scanout back to the connector's framebuffer, and the resource is sized for the old mode.
+    destroy_scanout_resource();
+
+    auto mode_setting = TRY(get_head_mode_setting());
+    VirGL3DResourceSpec resource_spec {
+        .target = pipe_texture_2d,
+        .format = virgl_format_b8g8r8x8_unorm,
+        .bind = virgl_bind_render_target | virgl_bind_sampler_view | virgl_bind_scanout,
+        .width = static_cast<u32>(mode_setting.horizontal_active),
+        .height = static_cast<u32>(mode_setting.vertical_active),
+        .depth = 1,
+        .array_size = 1,
+        .last_level = 0,
+        .nr_samples = 0,
+        .flags = 0,
+        .created_resource_id = 0,
+    };
+    TRY(Core::System::ioctl(m_gpu_fd, VIRGL_IOCTL_CREATE_RESOURCE, &resource_spec));
+    m_scanout_resource_id = resource_spec.created_resource_id;
+
+    VirGLScanoutDescriptor scanout_descriptor { .display_connector_fd = m_display_connector_fd, .resource_id = m_scanout_resource_id };
+    TRY(Core::System::ioctl(m_gpu_fd, VIRGL_IOCTL_SET_SCANOUT, &scanout_descriptor));
+    return {};
+}
+
+void VirGLScreenBackend::destroy_scanout_resource()
+{
+    if (m_scanout_resource_id == 0)
+        return;
+    if (auto result = Core::System::ioctl(m_gpu_fd, VIRGL_IOCTL_DESTROY_RESOURCE, static_cast<FlatPtr>(m_scanout_resource_id)); result.is_error())
+        dbgln("VirGLScreenBackend: Failed to destroy the scanout resource: {}", result.error());
+    m_scanout_resource_id = 0;
+}
+
+ErrorOr<void> VirGLScreenBackend::set_head_mode_setting(GraphicsHeadModeSetting mode_setting)
+{
+    if (!m_using_gpu)
+        return HardwareScreenBackend::set_head_mode_setting(mode_setting);
+
+    if (static_cast<size_t>(mode_setting.horizontal_stride) * mode_setting.vertical_active > m_transfer_region_size)
+        return Error::from_errno(EOVERFLOW);
+    TRY(HardwareScreenBackend::set_head_mode_setting(mode_setting));
+
+    if (auto result = display_scanout_resource(); result.is_error()) {
+        // Once the screen draws into the transfer region, there's no going back to the connector's framebuffer.
+        if (m_framebuffer)
+            return result.release_error();
+        fall_back_to_display_connector(result.error());
+    }
+    return {};
+}
+
+ErrorOr<void> VirGLScreenBackend::set_safe_head_mode_setting()
+{
+    TRY(HardwareScreenBackend::set_safe_head_mode_setting());
+    if (!m_using_gpu)
+        return {};
+
+    if (auto result = display_scanout_resource(); result.is_error()) {
+        if (m_framebuffer)
+            return result.release_error();
+        fall_back_to_display_connector(result.error());
+    }
+    return {};
+}
+
+ErrorOr<void> VirGLScreenBackend::unmap_framebuffer()
+{
+    if (!m_using_gpu)
+        return HardwareScreenBackend::unmap_framebuffer();
+
+    if (m_framebuffer) {
+        TRY(Core::System::munmap(m_framebuffer, m_transfer_region_size));
+        m_framebuffer = nullptr;
+    }
+    return {};
+}
+
+ErrorOr<void> VirGLScreenBackend::map_framebuffer()
+{
+    if (!m_using_gpu)
+        return HardwareScreenBackend::map_framebuffer();
+
+    auto mode_setting = TRY(get_head_mode_setting());
+    m_size_in_bytes = static_cast<size_t>(mode_setting.horizontal_stride) * mode_setting.vertical_active;
+    if (m_transfer_region_size < m_size_in_bytes)
+        return Error::from_errno(EOVERFLOW);
+    m_framebuffer = (Gfx::ARGB32*)TRY(Core::System::mmap(nullptr, m_transfer_region_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_gpu_fd, 0));
+    m_back_buffer_offset = 0;
+    return {};
+}
+
+ErrorOr<void> VirGLScreenBackend::submit_command_buffer(Vector<u32> const& command_buffer)
+{
+    VirGLCommandBuffer command_buffer_descriptor {
+        .data = command_buffer.data(),
+        .num_elems = static_cast<u32>(command_buffer.size()),
+    };
+    TRY(Core::System::ioctl(m_gpu_fd, VIRGL_IOCTL_SUBMIT_CMD, &command_buffer_descriptor));
+    return {};
+}
+
+ErrorOr<void> VirGLScreenBackend::flush_framebuffer_rects(int buffer_index, Span<FBRect const> flush_rects)
+{
+    if (!m_using_gpu)
+        return HardwareScreenBackend::flush_framebuffer_rects(buffer_index, flush_rects);
+    VERIFY(buffer_index == 0);
+
+    // Upload what was drawn into the damaged rects of the transfer region, then have the host show them.
+    Vector<u32> command_buffer;
+    TRY(command_buffer.try_ensure_capacity(flush_rects.size() * 14 + 1));
+    for (auto& rect : flush_rects) {
+        command_buffer.unchecked_append(encode_command_header(virgl_command_transfer3d, 13));
+        command_buffer.unchecked_append(m_scanout_resource_id);
+        command_buffer.unchecked_append(0); // level
+        command_buffer.unchecked_append(pipe_map_write);
+        command_buffer.unchecked_append(m_pitch);
+        command_buffer.unchecked_append(0); // layer_stride
+        command_buffer.unchecked_append(rect.x);
+        command_buffer.unchecked_append(rect.y);
+        command_buffer.unchecked_append(0); // z
+        command_buffer.unchecked_append(rect.width);
+        command_buffer.unchecked_append(rect.height);
+        command_buffer.unchecked_append(1); // depth
+        command_buffer.unchecked_append(rect.y * m_pitch + rect.x * sizeof(Gfx::ARGB32));
+        command_buffer.unchecked_append(VIRGL_DATA_DIR_GUEST_TO_HOST);
+    }
+    command_buffer.unchecked_append(encode_command_header(virgl_command_end_transfers, 0));
+    TRY(submit_command_buffer(command_buffer));
+
+    for (auto& rect : flush_rects) {
+        VirGLFlushDescriptor flush_descriptor {
+            .resource_id = m_scanout_resource_id,
+            .x = rect.x,
+            .y = rect.y,
+            .width = rect.width,
+            .height = rect.height,
+        };
+        TRY(Core::System::ioctl(m_gpu_fd, VIRGL_IOCTL_FLUSH_RESOURCE, &flush_descriptor));
+    }
+    return {};
+}
+
+ErrorOr<void> VirGLScreenBackend::flush_framebuffer()
+{
+    if (!m_using_gpu)
+        return HardwareScreenBackend::flush_framebuffer();
+
+    auto mode_setting = TRY(get_head_mode_setting());
+    FBRect rect {
+        .head_index = 0,
+        .x = 0,
+        .y = 0,
+        .width = static_cast<unsigned>(mode_setting.horizontal_active),
+        .height = static_cast<unsigned>(mode_setting.vertical_active),
+    };
+    return flush_framebuffer_rects(0, { &rect, 1 });
+}
+
+}
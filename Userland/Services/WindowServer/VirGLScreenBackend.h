@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "HardwareScreenBackend.h"
+#include <AK/Error.h>
+#include <AK/Span.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+namespace WindowServer {
+
+// Presents the screen through the VirtIO-GPU 3D device (/dev/gpu/render0) instead of the display connector's framebuffer.
+// The screen is drawn into the mapped transfer region of a VirGL context, damaged rectangles are uploaded into a 3D
+// resource that's displayed on the connector's scanout, and the host flushes that resource to the display.
+// Mode setting still goes through the display connector. If the 3D device is missing, doesn't drive this display, or
+// fails while setting up, this behaves exactly like a HardwareScreenBackend.
+class VirGLScreenBackend final : public HardwareScreenBackend {
+public:
+    virtual ~VirGLScreenBackend();
+
+    explicit VirGLScreenBackend(String device);
+
+    virtual ErrorOr<void> open() override;
+
+    virtual ErrorOr<void> flush_framebuffer_rects(int buffer_index, Span<FBRect const> rects) override;
+
+    virtual ErrorOr<void> flush_framebuffer() override;
+
+    virtual ErrorOr<void> unmap_framebuffer() override;
+    virtual ErrorOr<void> map_framebuffer() override;
+
+    virtual ErrorOr<void> set_safe_head_mode_setting() override;
+
+    virtual ErrorOr<void> set_head_mode_setting(GraphicsHeadModeSetting) override;
+
+private:
+    ErrorOr<void> open_gpu_context();
+    ErrorOr<void> display_scanout_resource();
+    void destroy_scanout_resource();
+    void fall_back_to_display_connector(Error const&);
+    ErrorOr<void> submit_command_buffer(Vector<u32> const&);
+
+    bool m_using_gpu { false };
+    int m_gpu_fd { -1 };
+    u32 m_scanout_resource_id { 0 };
+    size_t m_transfer_region_size { 0 };
+
+    // What the display connector supports, in case we have to fall back to it.
+    bool m_connector_can_flush_buffers { false };
+    bool m_connector_can_flush_entire_framebuffer { false };
+    bool m_connector_can_set_head_buffer { false };
+};
+
+}
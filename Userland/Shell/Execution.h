@@ -23,6 +23,8 @@ public:
     void collect();
     void add(int fd);
 
+    Vector<int, 32> const& fds() const { return m_fds; }
+
 private:
     Vector<int, 32> m_fds;
 };
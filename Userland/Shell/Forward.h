@@ -65,6 +65,7 @@ class WriteRedirection;
 
 namespace Shell {
 
+class FileDescriptionCollector;
 class Shell;
 
 }
@@ -32,6 +32,7 @@
 #include <inttypes.h>
 #include <pwd.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -742,6 +743,16 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
 
     argv.append(nullptr);
 
+    bool is_first = !command.pipeline || (command.pipeline && command.pipeline->pgid == -1);
+
+    if (auto child = spawn_process(command, rewirings, fds, argv, is_first); child.has_value()) {
+        if (command.pipeline && is_first)
+            command.pipeline->pgid = *child;
+        auto job = create_job(command, *child, is_first ? *child : command.pipeline->pgid);
+        fds.collect();
+        return *job;
+    }
+
     auto sync_pipe = TRY(Core::System::pipe2(0));
     auto child = TRY(Core::System::fork());
 
@@ -804,8 +815,6 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
 
     close(sync_pipe[0]);
 
-    bool is_first = !command.pipeline || (command.pipeline && command.pipeline->pgid == -1);
-
     if (command.pipeline) {
         if (is_first) {
             command.pipeline->pgid = child;
@@ -838,6 +847,74 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
 
     close(sync_pipe[1]);
 
+    auto job = create_job(command, child, pgid);
+    fds.collect();
+
+    return *job;
+}
+
+// Starts an external program without forking the shell first, which saves copying its whole address space just to
+// throw it away again. Anything that needs code to run in the child, like builtins or pledges, still goes through fork().
+Optional<pid_t> Shell::spawn_process(const AST::Command& command, NonnullRefPtrVector<AST::Rewiring> const& rewirings, FileDescriptionCollector const& fds, Vector<char const*>& argv, bool is_first_in_pipeline)
+{
+    if (command.should_immediately_execute_next || command.argv.is_empty() || !m_active_promises.is_empty())
+        return {};
+    if (has_builtin(command.argv.first()) || has_function(command.argv.first()))
+        return {};
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    ScopeGuard destroy_file_actions = [&] { posix_spawn_file_actions_destroy(&file_actions); };
+
+    // This mirrors what the forked child does in run_command(): apply the rewirings, then close everything the collector holds.
+    for (auto& rewiring : rewirings) {
+        posix_spawn_file_actions_adddup2(&file_actions, rewiring.old_fd, rewiring.new_fd);
+        if (!rewiring.other_pipe_end)
+            continue;
+        if (rewiring.fd_action == AST::Rewiring::Close::RefreshNew)
+            posix_spawn_file_actions_addclose(&file_actions, rewiring.other_pipe_end->new_fd);
+        else if (rewiring.fd_action == AST::Rewiring::Close::RefreshOld)
+            posix_spawn_file_actions_addclose(&file_actions, rewiring.other_pipe_end->old_fd);
+    }
+    for (auto fd : fds.fds())
+        posix_spawn_file_actions_addclose(&file_actions, fd);
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    ScopeGuard destroy_attr = [&] { posix_spawnattr_destroy(&attr); };
+
+    short flags = 0;
+    if (!m_is_subshell || command.pipeline) {
+        flags |= POSIX_SPAWN_SETPGROUP;
+        posix_spawnattr_setpgroup(&attr, is_first_in_pipeline ? 0 : command.pipeline->pgid);
+        if (!m_is_subshell) {
+#ifdef AK_OS_SERENITY
+            // The terminal is handed over before the child gets to run, so there's no need to sync up with it.
+            // As with tcsetpgrp() in run_command(), this simply doesn't happen if we're not on a terminal.
+            flags |= POSIX_SPAWN_TCSETPGROUP;
+            posix_spawnattr_tcsetpgrp_np(&attr, STDIN_FILENO);
+#else
+            // Elsewhere the child can't be handed the terminal before it runs, so it has to wait for us after fork().
+            return {};
+#endif
+        }
+    }
+    posix_spawnattr_setflags(&attr, flags);
+
+    if (!m_is_subshell && command.should_wait)
+        tcsetattr(0, TCSANOW, &default_termios);
+
+    auto child = Core::System::posix_spawnp(StringView { argv[0], strlen(argv[0]) }, &file_actions, &attr, const_cast<char* const*>(argv.data()), environ);
+    if (child.is_error()) {
+        // Leave it to the fork() path to figure out what went wrong and to tell the user about it.
+        dbgln_if(SH_DEBUG, "Failed to spawn {}: {}", argv[0], child.error());
+        return {};
+    }
+    return child.release_value();
+}
+
+NonnullRefPtr<Job> Shell::create_job(const AST::Command& command, pid_t child, pid_t pgid)
+{
     StringBuilder cmd;
     cmd.join(' ', command.argv);
 
@@ -870,9 +947,7 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
         run_tail(job);
     };
 
-    fds.collect();
-
-    return *job;
+    return job;
 }
 
 void Shell::execute_process(Vector<char const*>&& argv)
@@ -401,6 +401,8 @@ private:
     void run_tail(RefPtr<Job>);
     void run_tail(const AST::Command&, const AST::NodeWithAction&, int head_exit_code);
 
+    Optional<pid_t> spawn_process(const AST::Command&, NonnullRefPtrVector<AST::Rewiring> const&, FileDescriptionCollector const&, Vector<char const*>& argv, bool is_first_in_pipeline);
+    NonnullRefPtr<Job> create_job(const AST::Command&, pid_t child, pid_t pgid);
     [[noreturn]] void execute_process(Vector<char const*>&& argv);
 
     virtual void custom_event(Core::CustomEvent&) override;
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/FixedArray.h>
 #include <AK/NumericLimits.h>
+#include <AK/Random.h>
 #include <AK/Types.h>
 #include <LibAudio/Loader.h>
 #include <LibCore/ArgsParser.h>
@@ -21,11 +23,13 @@ ErrorOr<int> serenity_main(Main::Arguments args)
 {
     StringView path {};
     int sample_count = -1;
+    int seek_count = 0;
 
     Core::ArgsParser args_parser;
     args_parser.set_general_help("Benchmark audio loading");
     args_parser.add_positional_argument(path, "Path to audio file", "path");
     args_parser.add_option(sample_count, "How many samples to load at maximum", "sample-count", 's', "samples");
+    args_parser.add_option(seek_count, "How many random seeks to benchmark after loading", "seeks", 'S', "seeks");
     args_parser.parse(args);
 
     TRY(Core::System::unveil(Core::File::absolute_path(path), "r"sv));
@@ -39,34 +43,49 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     }
     auto loader = maybe_loader.release_value();
 
+    // Decoding into the same buffer over and over keeps allocations out of the measurement.
+    auto buffer = TRY(FixedArray<Audio::Sample>::try_create(MAX_CHUNK_SIZE));
+
     Core::ElapsedTimer sample_timer { true };
     u64 total_loader_time = 0;
     int remaining_samples = sample_count > 0 ? sample_count : NumericLimits<int>::max();
     unsigned total_loaded_samples = 0;
 
-    for (;;) {
-        if (remaining_samples > 0) {
-            sample_timer = sample_timer.start_new();
-            auto samples = loader->get_more_samples(min(MAX_CHUNK_SIZE, remaining_samples));
-            auto elapsed = static_cast<u64>(sample_timer.elapsed());
-            total_loader_time += static_cast<u64>(elapsed);
-            if (!samples.is_error()) {
-                remaining_samples -= samples.value().size();
-                total_loaded_samples += samples.value().size();
-                if (samples.value().size() == 0)
-                    break;
-            } else {
-                warnln("Error while loading audio: {}", samples.error().description);
-                return 1;
-            }
-        } else
+    while (remaining_samples > 0) {
+        sample_timer = sample_timer.start_new();
+        auto loaded_samples = loader->load_samples(buffer.span().trim(min(MAX_CHUNK_SIZE, remaining_samples)));
+        total_loader_time += static_cast<u64>(sample_timer.elapsed());
+        if (loaded_samples.is_error()) {
+            warnln("Error while loading audio: {}", loaded_samples.error().description);
+            return 1;
+        }
+        if (loaded_samples.value() == 0)
             break;
+        remaining_samples -= loaded_samples.value();
+        total_loaded_samples += loaded_samples.value();
     }
 
     auto time_per_sample = static_cast<double>(total_loader_time) / static_cast<double>(total_loaded_samples) * 1000.;
     auto playback_time_per_sample = (1. / static_cast<double>(loader->sample_rate())) * 1000'000.;
 
+    outln("Codec: {}", loader->format_name());
     outln("Loaded {:10d} samples in {:06.3f} s, {:9.3f} µs/sample, {:6.1f}% speed (realtime {:9.3f} µs/sample)", total_loaded_samples, static_cast<double>(total_loader_time) / 1000., time_per_sample, playback_time_per_sample / time_per_sample * 100., playback_time_per_sample);
+    outln("Real-time factor: {:.1f}x", playback_time_per_sample / time_per_sample);
+
+    if (seek_count > 0 && loader->total_samples() > 0) {
+        u64 total_seek_time = 0;
+        for (int i = 0; i < seek_count; ++i) {
+            auto target = static_cast<int>(get_random_uniform(static_cast<u32>(loader->total_samples())));
+            sample_timer = sample_timer.start_new();
+            auto result = loader->seek(target);
+            total_seek_time += static_cast<u64>(sample_timer.elapsed());
+            if (result.is_error()) {
+                warnln("Error while seeking to sample {}: {}", target, result.error().description);
+                return 1;
+            }
+        }
+        outln("Seeked {} times, {:9.3f} ms/seek", seek_count, static_cast<double>(total_seek_time) / seek_count);
+    }
 
     return 0;
 }
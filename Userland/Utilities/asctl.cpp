@@ -21,7 +21,8 @@
 enum AudioVariable : u32 {
     Volume,
     Mute,
-    SampleRate
+    SampleRate,
+    Latency,
 };
 
 // asctl: audio server control utility
@@ -38,7 +39,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Core::ArgsParser args_parser;
     args_parser.set_general_help("Send control signals to the audio server and hardware.");
     args_parser.add_option(human_mode, "Print human-readable output", "human-readable", 'h');
-    args_parser.add_positional_argument(command, "Command, either (g)et or (s)et\n\n\tThe get command accepts a list of variables to print.\n\tThey are printed in the given order.\n\tIf no value is specified, all are printed.\n\n\tThe set command accepts a any number of variables\n\tfollowed by the value they should be set to.\n\n\tPossible variables are (v)olume, (m)ute, sample(r)ate.\n", "command");
+    args_parser.add_positional_argument(command, "Command, either (g)et or (s)et\n\n\tThe get command accepts a list of variables to print.\n\tThey are printed in the given order.\n\tIf no value is specified, all are printed.\n\n\tThe set command accepts a any number of variables\n\tfollowed by the value they should be set to.\n\n\tPossible variables are (v)olume, (m)ute, sample(r)ate, and (l)atency.\n\tThe latency can only be read.\n", "command");
     args_parser.add_positional_argument(command_arguments, "Arguments for the command", "args", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -52,6 +53,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             values_to_print.append(AudioVariable::Volume);
             values_to_print.append(AudioVariable::Mute);
             values_to_print.append(AudioVariable::SampleRate);
+            values_to_print.append(AudioVariable::Latency);
         } else {
             for (auto& variable : command_arguments) {
                 if (variable.is_one_of("v"sv, "volume"sv))
@@ -60,6 +62,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                     values_to_print.append(AudioVariable::Mute);
                 else if (variable.is_one_of("r"sv, "samplerate"sv))
                     values_to_print.append(AudioVariable::SampleRate);
+                else if (variable.is_one_of("l"sv, "latency"sv))
+                    values_to_print.append(AudioVariable::Latency);
                 else {
                     warnln("Error: Unrecognized variable {}", variable);
                     return 1;
@@ -93,6 +97,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                     out("{} ", sample_rate);
                 break;
             }
+            case AudioVariable::Latency: {
+                u32 latency_in_microseconds = audio_client->get_output_latency();
+                if (human_mode)
+                    outln("Latency: {:.1} ms", static_cast<double>(latency_in_microseconds) / 1000.0);
+                else
+                    out("{} ", latency_in_microseconds);
+                break;
+            }
             }
         }
         if (!human_mode)
@@ -159,6 +171,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 audio_client->set_sample_rate(sample_rate);
                 break;
             }
+            case AudioVariable::Latency:
+                VERIFY_NOT_REACHED();
             }
         }
     }
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/LexicalPath.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/System.h>
+#include <LibGfx/Font/FontCatalog.h>
+#include <LibGfx/Font/FontDatabase.h>
+#include <LibMain/Main.h>
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath wpath cpath"));
+
+    String root = Gfx::FontDatabase::default_fonts_lookup_path();
+    bool force = false;
+    bool verbose = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Write the catalog of a font directory, if it's out of date.");
+    args_parser.add_option(force, "Write the catalog even if it's up to date", "force", 'f');
+    args_parser.add_option(verbose, "List the fonts in the catalog", "verbose", 'v');
+    args_parser.add_positional_argument(root, "Font directory (defaults to /res/fonts)", "path", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    auto catalog_path = Gfx::FontCatalog::path_for_directory(root);
+    TRY(Core::System::unveil(root, "r"sv));
+    TRY(Core::System::unveil(LexicalPath::dirname(catalog_path), "rwc"sv));
+    TRY(Core::System::unveil(nullptr, nullptr));
+
+    if (!force && !Gfx::FontCatalog::load_from_file(root, Gfx::FontCatalog::Validation::DirectoriesAndFiles).is_error()) {
+        if (verbose)
+            outln("{} is up to date", catalog_path);
+        return 0;
+    }
+
+    auto catalog = TRY(Gfx::FontCatalog::create_by_scanning(root));
+    if (verbose) {
+        for (auto& font : catalog.fonts())
+            outln("{}: {} {} {} {}", font.path, font.family, font.variant, font.weight, font.slope);
+    }
+    TRY(catalog.write_to_file());
+    if (verbose)
+        outln("Wrote {} fonts to {}", catalog.fonts().size(), catalog_path);
+    return 0;
+}
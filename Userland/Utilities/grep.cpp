@@ -5,16 +5,23 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
 #include <AK/LexicalPath.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <AK/ScopeGuard.h>
 #include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <LibRegex/Regex.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
 #include <stdio.h>
 #include <unistd.h>
 
@@ -33,9 +40,16 @@ void fail(StringView format, Ts... args)
     abort();
 }
 
+// What searching a file printed, kept until the files before it are done when they are searched at the same time.
+struct FileResult {
+    StringBuilder output;
+    Optional<String> error;
+    bool did_match { false };
+};
+
 ErrorOr<int> serenity_main(Main::Arguments args)
 {
-    TRY(Core::System::pledge("stdio rpath"));
+    TRY(Core::System::pledge("stdio rpath thread"));
 
     String program_name = AK::LexicalPath::basename(args.strings[0]);
 
@@ -52,8 +66,7 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     bool suppress_errors = false;
     bool colored_output = isatty(STDOUT_FILENO);
     bool count_lines = false;
-
-    size_t matched_line_count = 0;
+    int job_count = max(1l, sysconf(_SC_NPROCESSORS_ONLN));
 
     Core::ArgsParser args_parser;
     args_parser.add_option(recursive, "Recursively scan files", "recursive", 'r');
@@ -127,9 +140,13 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         },
     });
     args_parser.add_option(count_lines, "Output line count instead of line contents", "count", 'c');
+    args_parser.add_option(job_count, "Number of files to search at the same time when searching recursively", "jobs", 'j', "count");
     args_parser.add_positional_argument(files, "File(s) to process", "file", Core::ArgsParser::Required::No);
     args_parser.parse(args);
 
+    if (!recursive || job_count <= 1)
+        TRY(Core::System::pledge("stdio rpath"));
+
     // mock grep behavior: if -e is omitted, use first positional argument as pattern
     if (patterns.size() == 0 && files.size())
         patterns.append(files.take_first());
@@ -141,14 +158,23 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     if (case_insensitive)
         options |= PosixFlags::Insensitive;
 
-    auto grep_logic = [&](auto&& regular_expressions) {
+    auto grep_logic = [&]<typename Parser>() -> int {
+        // Matching changes the state a Regex keeps, so every thread that searches at the same time needs its own ones.
+        auto compile_patterns = [&] {
+            Vector<Regex<Parser>> regular_expressions;
+            for (auto& pattern : patterns)
+                regular_expressions.append(Regex<Parser>(pattern, options));
+            return regular_expressions;
+        };
+
+        auto regular_expressions = compile_patterns();
         for (auto& re : regular_expressions) {
             if (re.parser_result.error != regex::Error::NoError) {
                 return 1;
             }
         }
 
-        auto matches = [&](StringView str, StringView filename, size_t line_number, bool print_filename, bool is_binary) {
+        auto matches = [&](auto& regular_expressions, StringBuilder& output, size_t& matched_line_count, StringView str, StringView filename, size_t line_number, bool print_filename, bool is_binary) {
             size_t last_printed_char_pos { 0 };
             if (is_binary && binary_mode == BinaryFileMode::Skip)
                 return false;
@@ -167,22 +193,22 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                 }
 
                 if (is_binary && binary_mode == BinaryFileMode::Binary) {
-                    outln(colored_output ? "binary file \x1B[34m{}\x1B[0m matches"sv : "binary file {} matches"sv, filename);
+                    output.appendff(colored_output ? "binary file \x1B[34m{}\x1B[0m matches\n"sv : "binary file {} matches\n"sv, filename);
                 } else {
                     if ((result.matches.size() || invert_match) && print_filename)
-                        out(colored_output ? "\x1B[34m{}:\x1B[0m"sv : "{}:"sv, filename);
+                        output.appendff(colored_output ? "\x1B[34m{}:\x1B[0m"sv : "{}:"sv, filename);
                     if ((result.matches.size() || invert_match) && line_numbers)
-                        out(colored_output ? "\x1B[35m{}:\x1B[0m"sv : "{}:"sv, line_number);
+                        output.appendff(colored_output ? "\x1B[35m{}:\x1B[0m"sv : "{}:"sv, line_number);
 
                     for (auto& match : result.matches) {
                         auto pre_match_length = match.global_offset - last_printed_char_pos;
-                        out(colored_output ? "{}\x1B[32m{}\x1B[0m"sv : "{}{}"sv,
+                        output.appendff(colored_output ? "{}\x1B[32m{}\x1B[0m"sv : "{}{}"sv,
                             pre_match_length > 0 ? StringView(&str[last_printed_char_pos], pre_match_length) : ""sv,
                             match.view.to_string());
                         last_printed_char_pos = match.global_offset + match.view.length();
                     }
                     auto remaining_length = str.length() - last_printed_char_pos;
-                    outln("{}", remaining_length > 0 ? StringView(&str[last_printed_char_pos], remaining_length) : ""sv);
+                    output.appendff("{}\n", remaining_length > 0 ? StringView(&str[last_printed_char_pos], remaining_length) : ""sv);
                 }
 
                 return true;
@@ -191,56 +217,170 @@ ErrorOr<int> serenity_main(Main::Arguments args)
             return false;
         };
 
-        bool did_match_something = false;
-
-        auto handle_file = [&matches, binary_mode, suppress_errors, count_lines, quiet_mode,
-                               user_specified_multiple_files, &matched_line_count, &did_match_something](StringView filename, bool print_filename) -> bool {
-            auto file = Core::File::construct(filename);
-            if (!file->open(Core::OpenMode::ReadOnly)) {
-                if (!suppress_errors)
-                    warnln("Failed to open {}: {}", filename, file->error_string());
-                return false;
-            }
-
-            auto file_size_or_error = Core::File::size(filename);
-            if (file_size_or_error.is_error()) {
-                if (!suppress_errors)
-                    warnln("Failed to retrieve size of {}: {}", filename, strerror(file_size_or_error.error().code()));
-                return false;
+        // Searches the whole contents of a file at once. If every pattern has some text in it that all of its matches
+        // contain, the lines are only split out around where that text is, and all the others are never looked at.
+        auto search_buffer = [&](auto& regular_expressions, StringView buffer, StringView filename, bool print_filename, FileResult& result) {
+            struct Literal {
+                StringView text;
+                Optional<size_t> next_occurrence;
+                bool is_exhausted { false };
+            };
+            Vector<Literal> literals;
+            if (!invert_match && !case_insensitive) {
+                for (auto& re : regular_expressions) {
+                    auto const& optimization_data = re.parser_result.optimization_data;
+                    auto text = optimization_data.required_literal.is_empty() ? optimization_data.required_prefix.view() : optimization_data.required_literal.view();
+                    if (text.is_empty()) {
+                        literals.clear();
+                        break;
+                    }
+                    literals.append({ text, {} });
+                }
             }
 
-            auto file_size = file_size_or_error.release_value();
+            auto next_candidate = [&](size_t position) {
+                Optional<size_t> candidate;
+                for (auto& literal : literals) {
+                    if (!literal.is_exhausted && (!literal.next_occurrence.has_value() || *literal.next_occurrence < position)) {
+                        literal.next_occurrence = buffer.find(literal.text, position);
+                        literal.is_exhausted = !literal.next_occurrence.has_value();
+                    }
+                    if (literal.next_occurrence.has_value() && (!candidate.has_value() || *literal.next_occurrence < *candidate))
+                        candidate = literal.next_occurrence;
+                }
+                return candidate;
+            };
+
+            size_t matched_line_count = 0;
+            size_t line_number = 1;
+            size_t position = 0;
+            while (position < buffer.length()) {
+                if (!literals.is_empty()) {
+                    auto candidate = next_candidate(position);
+                    if (!candidate.has_value())
+                        break;
+                    auto line_start = position;
+                    if (auto newline = buffer.substring_view(position, *candidate - position).find_last('\n'); newline.has_value())
+                        line_start = position + *newline + 1;
+                    if (line_numbers) {
+                        for (auto ch : buffer.substring_view(position, line_start - position)) {
+                            if (ch == '\n')
+                                ++line_number;
+                        }
+                    }
+                    position = line_start;
+                }
 
-            for (size_t line_number = 1; file->can_read_line(); ++line_number) {
-                auto line = file->read_line(file_size);
-                auto is_binary = memchr(line.characters(), 0, line.length()) != nullptr;
+                auto line_end = buffer.find('\n', position).value_or(buffer.length());
+                auto line = buffer.substring_view(position, line_end - position);
+                auto is_binary = line.contains('\0');
 
-                auto matched = matches(line, filename, line_number, print_filename, is_binary);
-                did_match_something = did_match_something || matched;
+                auto matched = matches(regular_expressions, result.output, matched_line_count, line, filename, line_number, print_filename, is_binary);
+                result.did_match = result.did_match || matched;
                 if (matched && is_binary && binary_mode == BinaryFileMode::Binary)
                     break;
+
+                position = line_end + 1;
+                ++line_number;
             }
 
             if (count_lines && !quiet_mode) {
                 if (user_specified_multiple_files)
-                    outln("{}:{}", filename, matched_line_count);
+                    result.output.appendff("{}:{}\n", filename, matched_line_count);
                 else
-                    outln("{}", matched_line_count);
-                matched_line_count = 0;
+                    result.output.appendff("{}\n", matched_line_count);
             }
+        };
 
-            return true;
+        auto search_file = [&](auto& regular_expressions, String const& path, StringView filename, bool print_filename, FileResult& result) {
+            // Files that can't be mapped, like the ones in /proc, are read into memory instead.
+            if (auto mapped_file = Core::MappedFile::map(path); !mapped_file.is_error()) {
+                search_buffer(regular_expressions, StringView { mapped_file.value()->bytes() }, filename, print_filename, result);
+                return;
+            }
+
+            auto file = Core::File::construct(path);
+            if (!file->open(Core::OpenMode::ReadOnly)) {
+                result.error = String::formatted("Failed to open {}: {}", path, file->error_string());
+                return;
+            }
+            auto contents = file->read_all();
+            search_buffer(regular_expressions, StringView { contents.bytes() }, filename, print_filename, result);
         };
 
-        auto add_directory = [&handle_file, user_has_specified_files](String base, Optional<String> recursive, auto handle_directory) -> void {
+        bool did_match_something = false;
+
+        auto print_result = [&](FileResult const& result) {
+            if (result.error.has_value() && !suppress_errors)
+                warnln("{}", *result.error);
+            out("{}", result.output.string_view());
+            did_match_something = did_match_something || result.did_match;
+        };
+
+        // The files are searched by a pool of threads, but what is found in them is still printed in the order the
+        // files were found in.
+        auto search_files = [&](Vector<String> const& paths, Vector<String> const& filenames) {
+            auto thread_count = min(static_cast<size_t>(job_count), paths.size());
+            if (thread_count <= 1) {
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    FileResult result;
+                    search_file(regular_expressions, paths[i], filenames[i], true, result);
+                    print_result(result);
+                }
+                return;
+            }
+
+            Vector<Optional<FileResult>> results;
+            results.resize(paths.size());
+            Atomic<size_t> next_file { 0 };
+            Threading::Mutex mutex;
+            Threading::ConditionVariable result_ready { mutex };
+
+            NonnullRefPtrVector<Threading::Thread> threads;
+            for (size_t i = 0; i < thread_count; ++i) {
+                auto thread = Threading::Thread::construct([&] {
+                    auto regular_expressions = compile_patterns();
+                    while (true) {
+                        auto index = next_file++;
+                        if (index >= paths.size())
+                            break;
+                        FileResult result;
+                        search_file(regular_expressions, paths[index], filenames[index], true, result);
+                        Threading::MutexLocker locker(mutex);
+                        results[index] = move(result);
+                        result_ready.broadcast();
+                    }
+                    return 0;
+                },
+                    "grep"sv);
+                thread->start();
+                threads.append(move(thread));
+            }
+
+            for (size_t i = 0; i < paths.size(); ++i) {
+                FileResult result;
+                {
+                    Threading::MutexLocker locker(mutex);
+                    result_ready.wait_while([&] { return !results[i].has_value(); });
+                    result = results[i].release_value();
+                }
+                print_result(result);
+            }
+
+            for (auto& thread : threads)
+                (void)thread.join();
+        };
+
+        auto add_directory = [user_has_specified_files](Vector<String>& paths, Vector<String>& filenames, String base, Optional<String> recursive, auto handle_directory) -> void {
             Core::DirIterator it(recursive.value_or(base), Core::DirIterator::Flags::SkipDots);
             while (it.has_next()) {
                 auto path = it.next_full_path();
                 if (!Core::File::is_directory(path)) {
-                    auto key = user_has_specified_files ? path.view() : path.substring_view(base.length() + 1, path.length() - base.length() - 1);
-                    handle_file(key, true);
+                    auto key = user_has_specified_files ? path : path.substring(base.length() + 1, path.length() - base.length() - 1);
+                    paths.append(move(path));
+                    filenames.append(move(key));
                 } else {
-                    handle_directory(base, path, handle_directory);
+                    handle_directory(paths, filenames, base, path, handle_directory);
                 }
             }
         };
@@ -251,6 +391,7 @@ ErrorOr<int> serenity_main(Main::Arguments args)
             ssize_t nread = 0;
             ScopeGuard free_line = [line] { free(line); };
             size_t line_number = 0;
+            size_t matched_line_count = 0;
             while ((nread = getline(&line, &line_len, stdin)) != -1) {
                 VERIFY(nread > 0);
                 if (line[nread - 1] == '\n')
@@ -263,7 +404,9 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                 if (is_binary && binary_mode == BinaryFileMode::Skip)
                     return 1;
 
-                auto matched = matches(line_view, "stdin"sv, line_number, false, is_binary);
+                StringBuilder output;
+                auto matched = matches(regular_expressions, output, matched_line_count, line_view, "stdin"sv, line_number, false, is_binary);
+                out("{}", output.string_view());
                 did_match_something = did_match_something || matched;
                 if (matched && is_binary && binary_mode == BinaryFileMode::Binary)
                     break;
@@ -273,18 +416,24 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                 outln("{}", matched_line_count);
         } else {
             if (recursive) {
+                Vector<String> paths;
+                Vector<String> filenames;
                 if (user_has_specified_files) {
                     for (auto& filename : files) {
-                        add_directory(filename, {}, add_directory);
+                        add_directory(paths, filenames, filename, {}, add_directory);
                     }
                 } else {
-                    add_directory(".", {}, add_directory);
+                    add_directory(paths, filenames, ".", {}, add_directory);
                 }
+                search_files(paths, filenames);
 
             } else {
                 bool print_filename { files.size() > 1 };
                 for (auto& filename : files) {
-                    if (!handle_file(filename, print_filename))
+                    FileResult result;
+                    search_file(regular_expressions, filename, filename, print_filename, result);
+                    print_result(result);
+                    if (result.error.has_value())
                         return 1;
                 }
             }
@@ -293,17 +442,7 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         return did_match_something ? 0 : 1;
     };
 
-    if (use_ere) {
-        Vector<Regex<PosixExtended>> regular_expressions;
-        for (auto pattern : patterns) {
-            regular_expressions.append(Regex<PosixExtended>(pattern, options));
-        }
-        return grep_logic(regular_expressions);
-    }
-
-    Vector<Regex<PosixBasic>> regular_expressions;
-    for (auto pattern : patterns) {
-        regular_expressions.append(Regex<PosixBasic>(pattern, options));
-    }
-    return grep_logic(regular_expressions);
+    if (use_ere)
+        return grep_logic.operator()<PosixExtended>();
+    return grep_logic.operator()<PosixBasic>();
 }
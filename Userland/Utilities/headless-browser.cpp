@@ -8,12 +8,16 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Format.h>
 #include <AK/HashTable.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/QuickSort.h>
 #include <AK/LexicalPath.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/StringBuilder.h>
 #include <AK/Types.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ConfigFile.h>
+#include <LibCore/DirIterator.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCore/IODevice.h>
@@ -36,6 +40,7 @@
 #include <LibMain/Main.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
 #include <LibWeb/DOM/Document.h>
+#include <LibWeb/DOM/DocumentTimings.h>
 #include <LibWeb/HTML/BrowsingContext.h>
 #include <LibWeb/Layout/InitialContainingBlock.h>
 #include <LibWeb/Loader/ResourceLoader.h>
@@ -134,6 +139,8 @@ public:
 
     virtual void page_did_finish_loading(AK::URL const&) override
     {
+        if (on_finish_loading)
+            on_finish_loading();
     }
 
     virtual void page_did_change_selection() override
@@ -225,6 +232,8 @@ public:
         request->on_file_request_finish(file);
     }
 
+    Function<void()> on_finish_loading;
+
 private:
     HeadlessBrowserPageClient()
         : m_page(make<Web::Page>(*this))
@@ -513,7 +522,9 @@ public:
     virtual void prefetch_dns(AK::URL const&) override { }
     virtual void preconnect(AK::URL const&) override { }
 
-    virtual RefPtr<Web::ResourceLoaderConnectorRequest> start_request(String const& method, AK::URL const& url, HashMap<String, String> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const& proxy) override
+    virtual String connection_pool_statistics() override { return {}; }
+
+    virtual RefPtr<Web::ResourceLoaderConnectorRequest> start_request(String const& method, AK::URL const& url, HashMap<String, String> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const& proxy, Web::LoadRequest::Priority) override
     {
         RefPtr<Web::ResourceLoaderConnectorRequest> request;
         if (url.scheme().equals_ignoring_case("http"sv)) {
@@ -543,6 +554,101 @@ private:
     HeadlessRequestServer() { }
 };
 
+// Serves http(s)://host/path from <corpus>/host/path, so that a benchmark run never touches the network.
+class CorpusRequestServer : public Web::ResourceLoaderConnector {
+public:
+    class CorpusRequest
+        : public Web::ResourceLoaderConnectorRequest
+        , public Weakable<CorpusRequest> {
+    public:
+        static NonnullRefPtr<CorpusRequest> create(String path)
+        {
+            return adopt_ref(*new CorpusRequest(move(path)));
+        }
+
+        virtual ~CorpusRequest() override
+        {
+        }
+
+        virtual void set_should_buffer_all_input(bool) override
+        {
+        }
+
+        virtual bool stop() override
+        {
+            return false;
+        }
+
+        virtual void stream_into(Core::Stream::Stream&) override
+        {
+        }
+
+    private:
+        explicit CorpusRequest(String path)
+        {
+            // NOTE: The loader only hooks up its callbacks once we've been returned to it.
+            Core::deferred_invoke([weak_this = make_weak_ptr(), path = move(path)] {
+                auto strong_this = weak_this.strong_ref();
+                if (!strong_this || !strong_this->on_buffered_request_finish)
+                    return;
+
+                auto data_or_error = [&]() -> ErrorOr<ByteBuffer> {
+                    if (path.is_null())
+                        return Error::from_errno(ENOENT);
+                    auto file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Read));
+                    return file->read_all();
+                }();
+                if (data_or_error.is_error()) {
+                    dbgln("CorpusRequestServer: Failed to load {}: {}", path, data_or_error.error());
+                    strong_this->on_buffered_request_finish(false, 0, {}, 404, {});
+                    return;
+                }
+                auto data = data_or_error.release_value();
+                strong_this->on_buffered_request_finish(true, data.size(), {}, 200, data);
+            });
+        }
+    };
+
+    static NonnullRefPtr<CorpusRequestServer> create(String corpus_path)
+    {
+        return adopt_ref(*new CorpusRequestServer(move(corpus_path)));
+    }
+
+    virtual ~CorpusRequestServer() override { }
+
+    virtual void prefetch_dns(AK::URL const&) override { }
+    virtual void preconnect(AK::URL const&) override { }
+
+    virtual String connection_pool_statistics() override { return {}; }
+
+    virtual RefPtr<Web::ResourceLoaderConnectorRequest> start_request(String const&, AK::URL const& url, HashMap<String, String> const&, ReadonlyBytes, Core::ProxyData const&, Web::LoadRequest::Priority) override
+    {
+        auto request = CorpusRequest::create(path_in_corpus(url));
+        s_all_requests.set(request);
+        return request;
+    }
+
+private:
+    explicit CorpusRequestServer(String corpus_path)
+        : m_corpus_path(LexicalPath::canonicalized_path(move(corpus_path)))
+    {
+    }
+
+    String path_in_corpus(AK::URL const& url) const
+    {
+        auto path = url.path();
+        if (path.is_empty() || path.ends_with('/'))
+            path = String::formatted("{}index.html", path);
+        auto full_path = LexicalPath::join(m_corpus_path, url.host(), path).string();
+        // Don't let a page wander out of the corpus with "..".
+        if (!full_path.starts_with(String::formatted("{}/", m_corpus_path)))
+            return {};
+        return full_path;
+    }
+
+    String m_corpus_path;
+};
+
 class HeadlessWebSocketClientManager : public Web::WebSockets::WebSocketClientManager {
 public:
     class HeadlessWebSocket
@@ -655,6 +761,134 @@ private:
     HeadlessWebSocketClientManager() { }
 };
 
+// Loads every page of a corpus a number of times, and prints how long LibWeb spent in each phase as JSON.
+class PageLoadBenchmark {
+public:
+    PageLoadBenchmark(HeadlessBrowserPageClient& page_client, Vector<String> pages, int iterations)
+        : m_page_client(page_client)
+        , m_pages(move(pages))
+        , m_iterations(iterations)
+    {
+        m_page_client.on_finish_loading = [this] {
+            m_finished_loading = true;
+        };
+        m_poll_timer = Core::Timer::create_repeating(poll_interval_in_milliseconds, [this] {
+            poll();
+        });
+    }
+
+    void start()
+    {
+        load_next_page();
+    }
+
+private:
+    static constexpr int poll_interval_in_milliseconds = 10;
+    static constexpr i64 load_timeout_in_seconds = 30;
+
+    void load_next_page()
+    {
+        if (m_page_index == m_pages.size()) {
+            JsonObject result;
+            result.set("iterations", m_iterations);
+            result.set("pages", move(m_results));
+            outln("{}", result.to_string());
+            exit(0);
+        }
+
+        m_finished_loading = false;
+        m_load_deadline = Time::now_monotonic() + Time::from_seconds(load_timeout_in_seconds);
+        m_page_client.load(AK::URL::create_with_file_scheme(m_pages[m_page_index]));
+        m_poll_timer->start();
+    }
+
+    // Waits until the document, and everything it asked for while loading, is done.
+    void poll()
+    {
+        auto* document = m_page_client.page().top_level_browsing_context().active_document();
+        bool timed_out = Time::now_monotonic() >= m_load_deadline;
+        bool settled = m_finished_loading && document && document->ready_state() == "complete" && Web::ResourceLoader::the().pending_loads() == 0;
+        if (!settled && !timed_out)
+            return;
+
+        m_poll_timer->stop();
+        finish_run(timed_out);
+    }
+
+    void finish_run(bool timed_out)
+    {
+        auto output_rect = m_page_client.screen_rect();
+        auto output_bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, output_rect.size()));
+        m_page_client.paint(output_rect, output_bitmap);
+
+        // The documents of nested browsing contexts keep their own timings, so we add them all up.
+        Web::DOM::DocumentTimings timings;
+        m_page_client.page().top_level_browsing_context().for_each_in_inclusive_subtree([&](auto& browsing_context) {
+            if (auto* document = browsing_context.active_document())
+                timings.add(document->timings());
+            return IterationDecision::Continue;
+        });
+
+        JsonObject run;
+        run.set("timed_out", timed_out);
+        double total_milliseconds = 0;
+        for (size_t i = 0; i < to_underlying(Web::DOM::TimingPhase::__Count); ++i) {
+            auto phase = static_cast<Web::DOM::TimingPhase>(i);
+            auto milliseconds = timings.phase(phase).total_time.to_nanoseconds() / 1'000'000.0;
+            run.set(String::formatted("{}_ms", Web::DOM::timing_phase_name(phase)), milliseconds);
+            run.set(String::formatted("{}_count", Web::DOM::timing_phase_name(phase)), timings.phase(phase).runs);
+            total_milliseconds += milliseconds;
+        }
+        run.set("total_ms", total_milliseconds);
+        run.set("styles_computed", timings.computed_style_count());
+        run.set("styles_shared", timings.shared_style_count());
+        run.set("layout_nodes_committed", timings.committed_layout_node_count());
+        m_runs.append(move(run));
+
+        if (++m_iteration == m_iterations) {
+            JsonObject page;
+            page.set("page", LexicalPath::basename(m_pages[m_page_index]));
+            page.set("runs", move(m_runs));
+            m_results.append(move(page));
+            m_runs = {};
+            m_iteration = 0;
+            ++m_page_index;
+        }
+
+        // NOTE: Let the event loop unwind before loading the next page, we may be deep inside one of the old document's callbacks.
+        Core::deferred_invoke([this] {
+            load_next_page();
+        });
+    }
+
+    HeadlessBrowserPageClient& m_page_client;
+    Vector<String> m_pages;
+    int m_iterations { 1 };
+    size_t m_page_index { 0 };
+    int m_iteration { 0 };
+    bool m_finished_loading { false };
+    Time m_load_deadline;
+    RefPtr<Core::Timer> m_poll_timer;
+    JsonArray m_runs;
+    JsonArray m_results;
+};
+
+static ErrorOr<Vector<String>> pages_in_corpus(StringView corpus_path)
+{
+    Vector<String> pages;
+    auto current_working_directory = TRY(Core::System::getcwd());
+    Core::DirIterator iterator(corpus_path, Core::DirIterator::SkipDots);
+    if (iterator.has_error())
+        return Error::from_errno(iterator.error());
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        if (path.ends_with(".html"sv) || path.ends_with(".htm"sv))
+            TRY(pages.try_append(LexicalPath::absolute_path(current_working_directory, path)));
+    }
+    quick_sort(pages);
+    return pages;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     int take_screenshot_after = 1;
@@ -662,6 +896,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     StringView resources_folder;
     StringView error_page_url;
     StringView ca_certs_path;
+    StringView benchmark_corpus_path;
+    int benchmark_iterations = 1;
 
     Core::EventLoop event_loop;
     Core::ArgsParser args_parser;
@@ -670,13 +906,27 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(resources_folder, "Path of the base resources folder (defaults to /res)", "resources", 'r', "resources-root-path");
     args_parser.add_option(error_page_url, "URL for the error page (defaults to file:///res/html/error.html)", "error-page", 'e', "error-page-url");
     args_parser.add_option(ca_certs_path, "The bundled ca certificates file", "certs", 'c', "ca-certs-path");
-    args_parser.add_positional_argument(url, "URL to open", "url", Core::ArgsParser::Required::Yes);
+    args_parser.add_option(benchmark_corpus_path, "Time loading every .html file in a directory, and print the results as JSON", "benchmark", 'b', "corpus-path");
+    args_parser.add_option(benchmark_iterations, "How many times to load each page when benchmarking (default: 1)", "iterations", 'n', "n");
+    args_parser.add_positional_argument(url, "URL to open", "url", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+    if (url.is_empty() == benchmark_corpus_path.is_empty()) {
+        warnln("Either a URL or a benchmark corpus is required, but not both");
+        return 1;
+    }
+    if (benchmark_iterations < 1) {
+        warnln("At least one iteration is required");
+        return 1;
+    }
+
     Web::Platform::EventLoopPlugin::install(*new Web::Platform::EventLoopPluginSerenity);
     Web::Platform::FontPlugin::install(*new Web::Platform::FontPluginSerenity);
     Web::Platform::ImageCodecPlugin::install(*new ImageCodecPluginHeadless);
-    Web::ResourceLoader::initialize(HeadlessRequestServer::create());
+    if (!benchmark_corpus_path.is_empty())
+        Web::ResourceLoader::initialize(CorpusRequestServer::create(benchmark_corpus_path));
+    else
+        Web::ResourceLoader::initialize(HeadlessRequestServer::create());
     Web::WebSockets::WebSocketClientManager::initialize(HeadlessWebSocketClientManager::create());
 
     if (!resources_folder.is_empty()) {
@@ -707,13 +957,24 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     else
         page_client->setup_palette(Gfx::load_system_theme("/res/themes/Default.ini"));
 
-    dbgln("Loading {}", url);
-    page_client->load(AK::URL(url));
-
     // FIXME: Allow passing these values as arguments
     page_client->set_viewport_rect({ 0, 0, 800, 600 });
     page_client->set_screen_rect({ 0, 0, 800, 600 });
 
+    if (!benchmark_corpus_path.is_empty()) {
+        auto pages = TRY(pages_in_corpus(benchmark_corpus_path));
+        if (pages.is_empty()) {
+            warnln("There are no pages in {}", benchmark_corpus_path);
+            return 1;
+        }
+        PageLoadBenchmark benchmark(*page_client, move(pages), benchmark_iterations);
+        benchmark.start();
+        return event_loop.exec();
+    }
+
+    dbgln("Loading {}", url);
+    page_client->load(AK::URL(url));
+
     dbgln("Taking screenshot after {} seconds !", take_screenshot_after);
     auto timer = Core::Timer::create_single_shot(
         take_screenshot_after * 1000,
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/ByteBuffer.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/String.h>
+#include <AK/StringBuilder.h>
+#include <AK/URL.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <LibThreading/Thread.h>
+#include <unistd.h>
+
+struct Statistics {
+    Atomic<u64> responses { 0 };
+    Atomic<u64> successful_responses { 0 };
+    Atomic<u64> bytes_received { 0 };
+    Atomic<u64> connections_opened { 0 };
+    Atomic<u64> errors { 0 };
+};
+
+struct Response {
+    unsigned status_code { 0 };
+    size_t size { 0 };
+};
+
+class Connection {
+public:
+    Connection(String host, u16 port, ByteBuffer requests, size_t pipeline_depth, bool keep_alive)
+        : m_host(move(host))
+        , m_port(port)
+        , m_requests(move(requests))
+        , m_pipeline_depth(pipeline_depth)
+        , m_keep_alive(keep_alive)
+    {
+    }
+
+    ErrorOr<void> run_once(Statistics& statistics)
+    {
+        if (!m_socket) {
+            m_socket = TRY(Core::Stream::TCPSocket::connect(m_host, m_port));
+            m_pending.clear();
+            ++statistics.connections_opened;
+        }
+
+        ReadonlyBytes requests = m_requests;
+        while (!requests.is_empty())
+            requests = requests.slice(TRY(m_socket->write(requests)));
+
+        for (size_t i = 0; i < m_pipeline_depth; ++i) {
+            auto response = TRY(read_response());
+            ++statistics.responses;
+            statistics.bytes_received += response.size;
+            if (response.status_code >= 200 && response.status_code < 300)
+                ++statistics.successful_responses;
+        }
+
+        if (!m_keep_alive)
+            m_socket = nullptr;
+        return {};
+    }
+
+    void reset() { m_socket = nullptr; }
+
+private:
+    ErrorOr<void> read_more()
+    {
+        u8 buffer[16 * KiB];
+        auto bytes = TRY(m_socket->read({ buffer, sizeof(buffer) }));
+        if (bytes.is_empty())
+            return Error::from_string_literal("Server closed the connection");
+        TRY(m_pending.try_append(bytes));
+        return {};
+    }
+
+    ErrorOr<Response> read_response()
+    {
+        Optional<size_t> end_of_headers;
+        for (;;) {
+            end_of_headers = StringView { m_pending }.find("\r\n\r\n"sv);
+            if (end_of_headers.has_value())
+                break;
+            TRY(read_more());
+        }
+
+        auto headers = StringView { m_pending.bytes().trim(*end_of_headers) };
+        auto lines = headers.split_view("\r\n"sv);
+        if (lines.is_empty())
+            return Error::from_string_literal("Empty response");
+
+        Response response;
+        auto status_line = lines[0].split_view(' ');
+        if (status_line.size() < 2)
+            return Error::from_string_literal("Invalid status line");
+        response.status_code = status_line[1].to_uint().value_or(0);
+
+        Optional<size_t> content_length;
+        for (size_t i = 1; i < lines.size(); ++i) {
+            auto colon = lines[i].find(':');
+            if (!colon.has_value())
+                continue;
+            if (lines[i].substring_view(0, *colon).equals_ignoring_case("Content-Length"sv))
+                content_length = lines[i].substring_view(*colon + 1).trim_whitespace().to_uint<size_t>();
+        }
+        if (!content_length.has_value())
+            return Error::from_string_literal("Response has no Content-Length, can't tell where it ends");
+
+        response.size = *end_of_headers + 4 + *content_length;
+        while (m_pending.size() < response.size)
+            TRY(read_more());
+
+        auto remaining = TRY(ByteBuffer::copy(m_pending.bytes().slice(response.size)));
+        m_pending = move(remaining);
+        return response;
+    }
+
+    String m_host;
+    u16 m_port { 0 };
+    ByteBuffer m_requests;
+    size_t m_pipeline_depth { 1 };
+    bool m_keep_alive { true };
+    OwnPtr<Core::Stream::TCPSocket> m_socket;
+    ByteBuffer m_pending;
+};
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    StringView url_string;
+    int connection_count = 8;
+    int duration_seconds = 10;
+    int pipeline_depth = 1;
+    bool no_keep_alive = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how many requests per second an HTTP server can answer.");
+    args_parser.add_option(connection_count, "Number of concurrent connections", "connections", 'c', "count");
+    args_parser.add_option(duration_seconds, "How long to run for, in seconds", "duration", 'd', "seconds");
+    args_parser.add_option(pipeline_depth, "Number of requests to send before waiting for responses", "pipeline", 'p', "depth");
+    args_parser.add_option(no_keep_alive, "Open a new connection for every round of requests", "no-keep-alive", 'n');
+    args_parser.add_positional_argument(url_string, "URL to request", "url");
+    args_parser.parse(arguments);
+
+    URL url(url_string);
+    if (!url.is_valid() || url.scheme() != "http"sv) {
+        warnln("Invalid URL: {} (only http:// is supported)", url_string);
+        return 1;
+    }
+    if (connection_count < 1 || duration_seconds < 1 || pipeline_depth < 1) {
+        warnln("Connection count, duration and pipeline depth have to be positive");
+        return 1;
+    }
+
+    auto path = url.path();
+    if (!url.query().is_empty())
+        path = String::formatted("{}?{}", path, url.query());
+
+    StringBuilder request_builder;
+    for (int i = 0; i < pipeline_depth; ++i) {
+        request_builder.appendff("GET {} HTTP/1.1\r\n", path);
+        request_builder.appendff("Host: {}\r\n", url.host());
+        request_builder.append("User-Agent: http_benchmark\r\n"sv);
+        // Only the last request of a round can ask for the connection to be closed.
+        if (no_keep_alive && i == pipeline_depth - 1)
+            request_builder.append("Connection: close\r\n"sv);
+        request_builder.append("\r\n"sv);
+    }
+    auto requests = request_builder.to_byte_buffer();
+
+    outln("Benchmarking {} with {} connections for {}s (pipeline depth {}, {})", url, connection_count, duration_seconds, pipeline_depth, no_keep_alive ? "no keep-alive" : "keep-alive");
+
+    Statistics statistics;
+    Atomic<bool> should_stop { false };
+    NonnullRefPtrVector<Threading::Thread> threads;
+    for (int i = 0; i < connection_count; ++i) {
+        auto thread = Threading::Thread::construct([&, requests] {
+            // Sockets want an event loop to register their notifiers with, even though we only ever block on them.
+            Core::EventLoop loop;
+            Connection connection(url.host(), url.port_or_default(), requests, pipeline_depth, !no_keep_alive);
+            while (!should_stop) {
+                if (auto result = connection.run_once(statistics); result.is_error()) {
+                    if (!should_stop && statistics.errors++ == 0)
+                        warnln("First error: {}", result.error());
+                    connection.reset();
+                }
+            }
+            return 0;
+        },
+            "http_benchmark"sv);
+        thread->start();
+        threads.append(move(thread));
+    }
+
+    auto timer = Core::ElapsedTimer::start_new();
+    sleep(duration_seconds);
+    should_stop = true;
+
+    // Every connection finishes the round of requests it's in the middle of, which we count as well.
+    for (auto& thread : threads)
+        (void)thread.join();
+    auto elapsed_milliseconds = max(1, timer.elapsed());
+    u64 responses = statistics.responses;
+
+    outln("{} responses in {}ms ({} successful, {} errors)", responses, elapsed_milliseconds, statistics.successful_responses.load(), statistics.errors.load());
+    outln("{} connections opened, {} KiB received", statistics.connections_opened.load(), statistics.bytes_received.load() / KiB);
+    outln("Requests per second: {:.1}", static_cast<double>(responses) * 1000 / elapsed_milliseconds);
+    return 0;
+}
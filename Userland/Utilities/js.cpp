@@ -17,6 +17,7 @@
 #include <LibCore/System.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/CodeCache.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/PassManager.h>
@@ -76,6 +77,7 @@
 #include <LibJS/Runtime/WeakMap.h>
 #include <LibJS/Runtime/WeakRef.h>
 #include <LibJS/Runtime/WeakSet.h>
+#include <LibJS/SamplingProfiler.h>
 #include <LibJS/SourceTextModule.h>
 #include <LibLine/Editor.h>
 #include <LibMain/Main.h>
@@ -130,6 +132,7 @@ private:
 static bool s_dump_ast = false;
 static bool s_run_bytecode = false;
 static bool s_opt_bytecode = false;
+static bool s_dump_bytecode_stats = false;
 static bool s_as_module = false;
 static bool s_print_last_result = false;
 static bool s_strip_ansi = false;
@@ -469,7 +472,7 @@ static void print_promise(JS::Promise const& promise, HashTable<JS::Object*>& se
 
 static void print_array_buffer(JS::ArrayBuffer const& array_buffer, HashTable<JS::Object*>& seen_objects)
 {
-    auto& buffer = array_buffer.buffer();
+    auto buffer = array_buffer.bytes();
     auto byte_length = array_buffer.byte_length();
     print_type("ArrayBuffer");
     js_out("\n  byteLength: ");
@@ -1156,19 +1159,30 @@ static bool parse_and_run(JS::Interpreter& interpreter, StringView source, Strin
             script_or_module->parse_node().dump(0);
 
         if (JS::Bytecode::g_dump_bytecode || s_run_bytecode) {
-            auto executable_result = JS::Bytecode::Generator::generate(script_or_module->parse_node());
-            if (executable_result.is_error()) {
-                result = g_vm->throw_completion<JS::InternalError>(executable_result.error().to_string());
-                return ReturnEarly::No;
-            }
+            // NOTE: Modules aren't cached, as they may compile differently than a script with the same source text.
+            auto& code_cache = JS::Bytecode::CodeCache::the();
+            auto is_strict_mode = script_or_module->parse_node().is_strict_mode();
+            OwnPtr<JS::Bytecode::Executable> executable;
+            if (!s_as_module)
+                executable = code_cache.load(source, JS::FunctionKind::Normal, is_strict_mode);
+
+            if (!executable) {
+                auto executable_result = JS::Bytecode::Generator::generate(script_or_module->parse_node());
+                if (executable_result.is_error()) {
+                    result = g_vm->throw_completion<JS::InternalError>(executable_result.error().to_string());
+                    return ReturnEarly::No;
+                }
 
-            auto executable = executable_result.release_value();
-            executable->name = source_name;
-            if (s_opt_bytecode) {
-                auto& passes = JS::Bytecode::Interpreter::optimization_pipeline();
-                passes.perform(*executable);
-                dbgln("Optimisation passes took {}us", passes.elapsed());
+                executable = executable_result.release_value();
+                if (s_opt_bytecode) {
+                    auto& passes = JS::Bytecode::Interpreter::optimization_pipeline();
+                    passes.perform(*executable);
+                    dbgln("Optimisation passes took {}us", passes.elapsed());
+                }
+                if (!s_as_module)
+                    code_cache.store(source, JS::FunctionKind::Normal, is_strict_mode, *executable);
             }
+            executable->name = source_name;
 
             if (JS::Bytecode::g_dump_bytecode)
                 executable->dump();
@@ -1507,11 +1521,13 @@ private:
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction prot_exec thread"));
 
     bool gc_on_every_allocation = false;
     bool disable_syntax_highlight = false;
     StringView evaluate_script;
+    StringView bytecode_cache_directory;
+    StringView profile_path;
     Vector<StringView> script_paths;
 
     Core::ArgsParser args_parser;
@@ -1520,6 +1536,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
     args_parser.add_option(s_opt_bytecode, "Optimize the bytecode", "optimize-bytecode", 'p');
+    args_parser.add_option(s_dump_bytecode_stats, "Print the effect of the optimization passes on the bytecode (implies --optimize-bytecode)", "dump-bytecode-stats", 0);
+    args_parser.add_option(bytecode_cache_directory, "Keep the bytecode of scripts and functions in a directory, to reuse it the next time they run", "bytecode-cache", 0, "directory");
+    args_parser.add_option(JS::Bytecode::g_use_jit, "Compile the bytecode to native code (implies --run-bytecode)", "jit", 'j');
+    args_parser.add_option(JS::Bytecode::g_count_opcodes, "Print how often each bytecode instruction ran (implies --run-bytecode)", "count-opcodes", 0);
+    args_parser.add_option(profile_path, "Sample where the script spends its time, and write the samples to a file that Profiler can open", "profile", 0, "path");
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
@@ -1530,6 +1551,24 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_positional_argument(script_paths, "Path to script files", "scripts", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+    if (s_dump_bytecode_stats)
+        s_opt_bytecode = true;
+    if (s_opt_bytecode)
+        JS::Bytecode::Interpreter::set_optimization_level(JS::Bytecode::Interpreter::OptimizationLevel::Optimize);
+
+    if (!bytecode_cache_directory.is_empty())
+        JS::Bytecode::CodeCache::the().set_directory(bytecode_cache_directory);
+
+    if (JS::Bytecode::g_count_opcodes)
+        s_run_bytecode = true;
+
+    if (JS::Bytecode::g_use_jit)
+        s_run_bytecode = true;
+    else if (!profile_path.is_empty())
+        TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction thread"));
+    else
+        TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction"));
+
     bool syntax_highlight = !disable_syntax_highlight;
 
     g_vm = JS::VM::create();
@@ -1813,7 +1852,29 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         // We resolve modules as if it is the first file
 
-        if (!parse_and_run(*interpreter, builder.string_view(), source_name))
+        OwnPtr<JS::SamplingProfiler> profiler;
+        if (!profile_path.is_empty())
+            profiler = TRY(JS::SamplingProfiler::create(*g_vm));
+
+        auto success = parse_and_run(*interpreter, builder.string_view(), source_name);
+
+        if (profiler) {
+            TRY(profiler->write_perfcore_file(profile_path));
+            warnln("Wrote {} samples to {}", profiler->sample_count(), profile_path);
+        }
+
+        if (JS::Bytecode::g_count_opcodes)
+            JS::Bytecode::Interpreter::dump_opcode_counters();
+
+        if (s_dump_bytecode_stats) {
+            auto const& statistics = JS::Bytecode::Interpreter::optimization_pipeline().statistics();
+            warnln("Optimized {} executables:", statistics.executable_count);
+            warnln("    Basic blocks: {} -> {}", statistics.before.basic_block_count, statistics.after.basic_block_count);
+            warnln("    Instructions: {} -> {}", statistics.before.instruction_count, statistics.after.instruction_count);
+            warnln("    Registers:    {} -> {}", statistics.before.number_of_registers, statistics.after.number_of_registers);
+        }
+
+        if (!success)
             return 1;
     }
 
@@ -4,16 +4,65 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibMain/Main.h>
 #include <LibVideo/MatroskaReader.h>
+#include <LibVideo/VP9/Decoder.h>
 
-ErrorOr<int> serenity_main(Main::Arguments)
+static ErrorOr<int> benchmark_decoding(Video::MatroskaDocument& document)
 {
-    auto document = Video::MatroskaReader::parse_matroska_from_file("/home/anon/Videos/test-webm.webm"sv);
+    auto track = document.track_for_track_type(Video::TrackEntry::TrackType::Video);
+    if (!track.has_value())
+        return Error::from_string_literal("Document has no video track");
+    if (track->codec_id() != "V_VP9"sv) {
+        warnln("Can't decode video with CodecID \"{}\"", track->codec_id());
+        return 1;
+    }
+
+    Video::VP9::Decoder decoder;
+    size_t frame_count = 0;
+    Core::ElapsedTimer timer { true };
+    for (auto const& cluster : document.clusters()) {
+        for (auto const& block : cluster.blocks()) {
+            if (block.track_number() != track->track_number())
+                continue;
+            for (auto const& frame : block.frames()) {
+                auto result = decoder.receive_sample(frame);
+                if (result.is_error()) {
+                    warnln("Failed to decode frame {}: {}", frame_count, result.error().string_literal());
+                    return 1;
+                }
+                if (!decoder.get_decoded_frame().is_error())
+                    frame_count++;
+            }
+        }
+    }
+    auto elapsed_milliseconds = max(timer.elapsed(), 1);
+
+    outln("Decoded {} frames in {} ms ({:.2} frames per second)", frame_count, elapsed_milliseconds, frame_count * 1000.0 / elapsed_milliseconds);
+    return 0;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    StringView path = "/home/anon/Videos/test-webm.webm"sv;
+    bool benchmark = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Print the structure of a Matroska file, or benchmark decoding its video track");
+    args_parser.add_option(benchmark, "Decode all frames of the video track and print how long that took", "benchmark", 'b');
+    args_parser.add_positional_argument(path, "Path to the Matroska file", "path", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    auto document = Video::MatroskaReader::parse_matroska_from_file(path);
     if (!document) {
         return Error::from_string_literal("Failed to parse :(");
     }
 
+    if (benchmark)
+        return benchmark_decoding(*document);
+
     outln("DocType is {}", document->header().doc_type.characters());
     outln("DocTypeVersion is {}", document->header().doc_type_version);
     auto segment_information = document->segment_information();
@@ -22,6 +22,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool enable = false;
     bool disable = false;
     bool all_processes = false;
+    bool continuous = false;
     u64 event_mask = PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
         | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT
         | PERF_EVENT_SIGNPOST;
@@ -29,6 +30,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     args_parser.add_option(pid_argument, "Target PID", nullptr, 'p', "PID");
     args_parser.add_option(all_processes, "Profile all processes (super-user only), result at /sys/kernel/profile", nullptr, 'a');
+    args_parser.add_option(continuous, "Continuously sample all processes at a low rate (super-user only), drained from /sys/kernel/continuous_profile", nullptr, 'C');
     args_parser.add_option(enable, "Enable", nullptr, 'e');
     args_parser.add_option(disable, "Disable", nullptr, 'd');
     args_parser.add_option(free, "Free the profiling buffer for the associated process(es).", nullptr, 'f');
@@ -53,6 +55,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 event_mask |= PERF_EVENT_SYSCALL;
             else if (event_type == "read")
                 event_mask |= PERF_EVENT_READ;
+            else if (event_type == "lock_wait")
+                event_mask |= PERF_EVENT_LOCK_WAIT;
+            else if (event_type == "cycles")
+                event_mask |= PERF_EVENT_CPU_CYCLES;
+            else if (event_type == "instructions")
+                event_mask |= PERF_EVENT_INSTRUCTIONS_RETIRED;
+            else if (event_type == "cache_misses")
+                event_mask |= PERF_EVENT_CACHE_MISSES;
+            else if (event_type == "branch_misses")
+                event_mask |= PERF_EVENT_BRANCH_MISSES;
             else {
                 warnln("Unknown event type '{}' specified.", event_type);
                 exit(1);
@@ -62,7 +74,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     auto print_types = [] {
         outln();
-        outln("Event type can be one of: sample, context_switch, page_fault, syscall, read, kmalloc and kfree.");
+        outln("Event type can be one of: sample, context_switch, page_fault, syscall, read, lock_wait, kmalloc and kfree.");
+        outln("These are sampled from the processor's performance counters: cycles, instructions, cache_misses and branch_misses.");
     };
 
     if (!args_parser.parse(arguments, Core::ArgsParser::FailureBehavior::PrintUsage)) {
@@ -70,7 +83,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         exit(0);
     }
 
-    if (pid_argument.is_empty() && cmd_argument.is_empty() && !all_processes) {
+    if (pid_argument.is_empty() && cmd_argument.is_empty() && !all_processes && !continuous) {
         args_parser.print_usage(stdout, arguments.argv[0]);
         print_types();
         return 0;
@@ -79,14 +92,22 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     if (!seen_event_type_arg)
         event_mask |= PERF_EVENT_SAMPLE;
 
-    if (!pid_argument.is_empty() || all_processes) {
+    if (continuous) {
+        if (seen_event_type_arg) {
+            warnln("The continuous profiler only collects samples.");
+            return 1;
+        }
+        event_mask = PERF_EVENT_SAMPLE;
+    }
+
+    if (!pid_argument.is_empty() || all_processes || continuous) {
         if (!(enable ^ disable ^ wait ^ free)) {
             warnln("-p <PID> requires -e xor -d xor -w xor -f.");
             return 1;
         }
 
         // FIXME: Handle error case.
-        pid_t pid = all_processes ? -1 : pid_argument.to_int().release_value();
+        pid_t pid = continuous ? PROFILING_CONTINUOUS_PID : all_processes ? -1 : pid_argument.to_int().release_value();
 
         if (wait || enable) {
             TRY(Core::System::profiling_enable(pid, event_mask));
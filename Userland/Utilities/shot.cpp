@@ -150,7 +150,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 0;
     }
 
-    auto encoded_bitmap = Gfx::PNGWriter::encode(*bitmap);
+    auto encoded_bitmap = Gfx::PNGWriter::encode(*bitmap, { .thread_count = static_cast<size_t>(max(1l, sysconf(_SC_NPROCESSORS_ONLN))) });
     if (encoded_bitmap.is_empty()) {
         warnln("Failed to encode PNG");
         return 1;
@@ -279,7 +279,7 @@ private:
                 });
         } else {
             auto statement_id = m_sql_client->sql_statement(m_connection_id, piece);
-            m_sql_client->async_statement_execute(statement_id);
+            m_sql_client->async_statement_execute(statement_id, {});
         }
 
         // ...But m_keep_running can also be set to false by a command handler.
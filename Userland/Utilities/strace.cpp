@@ -10,6 +10,7 @@
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 #include <Kernel/API/SyscallString.h>
+#include <Kernel/API/SyscallTrace.h>
 #include <LibC/sys/arch/i386/regs.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
@@ -209,6 +210,8 @@ HANDLE(CLOCK_MONOTONIC_COARSE)
 END_VALUES_TO_NAMES()
 
 static int g_pid = -1;
+static bool g_use_trace_buffer = false;
+static volatile sig_atomic_t g_interrupted = false;
 
 #if ARCH(I386)
 using syscall_arg_t = u32;
@@ -221,6 +224,13 @@ static void handle_sigint(int)
     if (g_pid == -1)
         return;
 
+    // The tracee keeps on running while we read from the trace buffer, so it can't be detached from here.
+    // Exiting makes the kernel stop tracing it.
+    if (g_use_trace_buffer) {
+        g_interrupted = true;
+        return;
+    }
+
     if (ptrace(PT_DETACH, g_pid, 0, 0) == -1) {
         perror("detach");
     }
@@ -806,6 +816,93 @@ static void format_syscall(FormattedSyscallBuilder& builder, Syscall::Function s
     }
 }
 
+static bool should_trace(StringView syscall_name, HashTable<StringView> const& exclude_syscalls, HashTable<StringView> const& include_syscalls)
+{
+    if (exclude_syscalls.contains(syscall_name))
+        return false;
+    return include_syscalls.is_empty() || include_syscalls.contains(syscall_name);
+}
+
+// The tracee isn't stopped for its syscalls here, so there is no way to look at the memory their arguments point to.
+// Only the raw arguments are shown, together with how long each syscall took.
+static ErrorOr<int> trace_from_buffer(Core::File& trace_file, HashTable<StringView> const& exclude_syscalls, HashTable<StringView> const& include_syscalls)
+{
+    constexpr u32 record_count = 16384;
+    auto fd = TRY(Core::System::ptrace(PT_SYSCALL_TRACE_BUFFER, g_pid, reinterpret_cast<void*>(static_cast<FlatPtr>(record_count)), 0));
+    auto* mapping = TRY(Core::System::mmap(nullptr, syscall_trace_mapping_size(record_count), PROT_READ, MAP_SHARED, fd, 0, 0, "strace trace buffer"sv));
+    auto& header = *reinterpret_cast<SyscallTraceHeader const*>(mapping);
+    auto const* records = reinterpret_cast<SyscallTraceRecord const*>(reinterpret_cast<u8 const*>(mapping) + syscall_trace_records_offset());
+
+    u32 tail = 0;
+    u32 lost_records = 0;
+
+    auto read_records = [&]() -> ErrorOr<void> {
+        auto head = AK::atomic_load(&header.head, AK::MemoryOrder::memory_order_acquire);
+        if (head - tail > record_count) {
+            lost_records += head - tail - record_count;
+            tail = head - record_count;
+        }
+        while (tail != head) {
+            auto const& slot = records[tail & (record_count - 1)];
+            auto sequence = AK::atomic_load(&slot.sequence, AK::MemoryOrder::memory_order_acquire);
+            if (sequence != tail + 1) {
+                // The thread that claimed this record is still writing it, try again later.
+                if (static_cast<i32>(sequence - (tail + 1)) < 0)
+                    break;
+                // It has been overwritten by a newer record already.
+                ++lost_records;
+                ++tail;
+                continue;
+            }
+
+            auto record = slot;
+            AK::atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+            if (AK::atomic_load(&slot.sequence, AK::MemoryOrder::memory_order_relaxed) != sequence) {
+                ++lost_records;
+                ++tail;
+                continue;
+            }
+            ++tail;
+
+            auto syscall_name = to_string(static_cast<Syscall::Function>(record.function));
+            if (!should_trace(syscall_name, exclude_syscalls, include_syscalls))
+                continue;
+
+            FormattedSyscallBuilder builder(syscall_name);
+            for (auto argument : record.arguments)
+                builder.add_argument("{:#x}", argument);
+            builder.format_result(record.result);
+
+            auto line = String::formatted("[{}] {} <{:.3} us>\n", record.tid, builder.string_view().trim_whitespace(TrimMode::Right), static_cast<double>(record.duration_ns) / 1000);
+            if (!trace_file.write(line))
+                return Error::from_errno(trace_file.error());
+        }
+        return {};
+    };
+
+    TRY(Core::System::ptrace(PT_CONTINUE, g_pid, 0, 0));
+
+    while (!g_interrupted) {
+        TRY(read_records());
+
+        int status;
+        auto pid = waitpid(g_pid, &status, WSTOPPED | WEXITED | WNOHANG);
+        if (pid == g_pid && WIFSTOPPED(status)) {
+            // Traced threads are stopped by every signal they receive.
+            TRY(Core::System::ptrace(PT_CONTINUE, g_pid, 0, 0));
+        } else if (pid == g_pid || pid < 0) {
+            break;
+        } else {
+            usleep(10'000);
+        }
+    }
+    TRY(read_records());
+
+    if (lost_records)
+        warnln("strace: lost {} records that weren't read in time", lost_records);
+    return 0;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     TRY(Core::System::pledge("stdio rpath wpath cpath proc exec ptrace sigaction"));
@@ -827,6 +924,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     parser.add_option(output_filename, "Filename to write output to", "output", 'o', "output");
     parser.add_option(exclude_syscalls_option, "Comma-delimited syscalls to exclude", "exclude", 'e', "exclude");
     parser.add_option(include_syscalls_option, "Comma-delimited syscalls to include", "include", 'i', "include");
+    parser.add_option(g_use_trace_buffer, "Read syscalls from a buffer the kernel fills, without stopping the tracee", "buffered", 'b');
     parser.add_positional_argument(child_argv, "Arguments to exec", "argument", Core::ArgsParser::Required::No);
 
     parser.parse(arguments);
@@ -875,6 +973,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
+    if (g_use_trace_buffer)
+        return trace_from_buffer(*trace_file, exclude_syscalls, include_syscalls);
+
     for (;;) {
         TRY(Core::System::ptrace(PT_SYSCALL, g_pid, 0, 0));
 
@@ -925,9 +1026,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         auto syscall_function = (Syscall::Function)syscall_index;
         auto syscall_name = to_string(syscall_function);
-        if (exclude_syscalls.contains(syscall_name))
-            continue;
-        if (!include_syscalls.is_empty() && !include_syscalls.contains(syscall_name))
+        if (!should_trace(syscall_name, exclude_syscalls, include_syscalls))
             continue;
 
         FormattedSyscallBuilder builder(syscall_name);
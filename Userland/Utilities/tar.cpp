@@ -6,6 +6,7 @@
 
 #include "LibCore/Directory.h"
 #include <AK/Assertions.h>
+#include <AK/Buffered.h>
 #include <AK/LexicalPath.h>
 #include <AK/Span.h>
 #include <AK/Vector.h>
@@ -22,7 +23,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
-constexpr size_t buffer_size = 4096;
+constexpr size_t buffer_size = 64 * KiB;
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -69,7 +70,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         if (!directory.is_empty())
             TRY(Core::System::chdir(directory));
 
-        Core::InputFileStream file_stream(file);
+        // NOTE: Headers and small members are read in pieces of 512 bytes, so read the archive in larger chunks.
+        Buffered<Core::InputFileStream, buffer_size> file_stream(file);
         Compress::GzipDecompressor gzip_stream(file_stream);
 
         InputStream& file_input_stream = file_stream;
@@ -171,6 +173,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                     MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
 
                     int fd = TRY(Core::System::open(absolute_path, O_CREAT | O_WRONLY, header_mode));
+                    // Allocating the whole file up front keeps it from being fragmented, failing to do so is fine though.
+                    if (auto size = header.size(); !size.is_error() && size.value() > 0)
+                        (void)Core::System::posix_fallocate(fd, 0, size.value());
 
                     Array<u8, buffer_size> buffer;
                     size_t bytes_read;
@@ -208,7 +213,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             if (maybe_error.is_error())
                 return maybe_error.error();
         }
-        file_stream.close();
+        file_stream.underlying_stream().close();
 
         return 0;
     }
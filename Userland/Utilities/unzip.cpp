@@ -5,6 +5,7 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
 #include <AK/NumberFormat.h>
 #include <AK/StringUtils.h>
 #include <LibArchive/Zip.h>
@@ -14,28 +15,37 @@
 #include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
+#include <LibThreading/ThreadPool.h>
+#include <errno.h>
 #include <sys/stat.h>
 
-static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
+static bool create_zip_member_directory(Archive::ZipMember const& zip_member)
 {
-    if (zip_member.is_directory) {
-        if (mkdir(zip_member.name.characters(), 0755) < 0) {
-            perror("mkdir");
-            return false;
-        }
-        if (!quiet)
-            outln(" extracting: {}", zip_member.name);
-        return true;
+    VERIFY(zip_member.is_directory);
+    if (mkdir(zip_member.name.characters(), 0755) < 0 && errno != EEXIST) {
+        perror("mkdir");
+        return false;
+    }
+    return true;
+}
+
+// NOTE: This runs on the thread pool, so it must not touch anything that other members are extracted into.
+static bool unpack_zip_member(Archive::ZipMember const& zip_member)
+{
+    VERIFY(!zip_member.is_directory);
+    if (Core::Directory::create(LexicalPath(zip_member.name).parent(), Core::Directory::CreateDirectories::Yes).is_error()) {
+        warnln("Can't create the parent directory of {}", zip_member.name);
+        return false;
     }
-    MUST(Core::Directory::create(LexicalPath(zip_member.name).parent(), Core::Directory::CreateDirectories::Yes));
     auto new_file = Core::File::construct(zip_member.name);
     if (!new_file->open(Core::OpenMode::WriteOnly)) {
         warnln("Can't write file {}: {}", zip_member.name, new_file->error_string());
         return false;
     }
 
-    if (!quiet)
-        outln(" extracting: {}", zip_member.name);
+    // Allocating the whole file up front keeps it from being fragmented, failing to do so is fine though.
+    if (zip_member.uncompressed_size > 0)
+        (void)Core::System::posix_fallocate(new_file->fd(), 0, zip_member.uncompressed_size);
 
     // TODO: verify CRC32s match!
     switch (zip_member.compression_method) {
@@ -116,7 +126,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         TRY(Core::System::chdir(output_directory_path));
     }
 
-    auto success = zip_file->for_each_member([&](auto zip_member) {
+    // NOTE: The members are only collected here, they still point into the mapped file.
+    Vector<Archive::ZipMember> members_to_extract;
+    zip_file->for_each_member([&](auto zip_member) {
         bool keep_file = false;
 
         if (!file_filters.is_empty()) {
@@ -132,13 +144,29 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             keep_file = true;
         }
 
-        if (keep_file) {
-            if (!unpack_zip_member(zip_member, quiet))
-                return IterationDecision::Break;
-        }
+        if (keep_file)
+            members_to_extract.append(move(zip_member));
 
         return IterationDecision::Continue;
     });
 
-    return success ? 0 : 1;
+    // Directories are created in archive order, so that they exist before anything is extracted into them.
+    for (auto& zip_member : members_to_extract) {
+        if (!quiet)
+            outln(" extracting: {}", zip_member.name);
+        if (zip_member.is_directory && !create_zip_member_directory(zip_member))
+            return 1;
+    }
+
+    // Members are compressed independently of each other, so they can be inflated and written out in parallel.
+    Atomic<bool> success { true };
+    Threading::ThreadPool::the().parallel_for(members_to_extract.size(), [&](size_t index) {
+        auto& zip_member = members_to_extract[index];
+        if (zip_member.is_directory || !success.load(AK::MemoryOrder::memory_order_relaxed))
+            return;
+        if (!unpack_zip_member(zip_member))
+            success.store(false, AK::MemoryOrder::memory_order_relaxed);
+    });
+
+    return success.load() ? 0 : 1;
 }
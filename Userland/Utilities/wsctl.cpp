@@ -7,17 +7,38 @@
 #include <LibCore/ArgsParser.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/ConnectionToWindowServer.h>
+#include <LibGUI/Desktop.h>
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     auto app = TRY(GUI::Application::try_create(arguments));
 
     int flash_flush = -1;
+    bool show_statistics = false;
     Core::ArgsParser args_parser;
     args_parser.add_option(flash_flush, "Flash flush (repaint) rectangles", "flash-flush", 'f', "0/1");
+    args_parser.add_option(show_statistics, "Show how many pixels the compositor composes per frame", "statistics", 's');
     args_parser.parse(arguments);
 
     if (flash_flush != -1)
         GUI::ConnectionToWindowServer::the().async_set_flash_flush(flash_flush);
+
+    if (show_statistics) {
+        auto timings = GUI::ConnectionToWindowServer::the().get_compositor_frame_timings();
+        outln("Refresh interval:         {} us", timings.refresh_interval_us());
+        outln("Frames composed:          {} ({} missed their deadline)", timings.frame_count(), timings.missed_frame_count());
+        outln("Last frame:               {} us to compose, {} us since it was invalidated", timings.last_compose_time_us(), timings.last_latency_us());
+        outln("Predicted compose time:   {} us", timings.predicted_compose_time_us());
+
+        auto& screen_rects = GUI::Desktop::the().rects();
+        for (size_t screen_index = 0; screen_index < screen_rects.size(); ++screen_index) {
+            auto statistics = GUI::ConnectionToWindowServer::the().get_compositor_statistics(screen_index);
+            auto average_pixels_composed = statistics.frame_count() > 0 ? statistics.total_pixels_composed() / statistics.frame_count() : 0;
+            outln("Screen #{} ({}):", screen_index, screen_rects[screen_index]);
+            outln("  Frames composed:        {}", statistics.frame_count());
+            outln("  Pixels composed:        {} total, {} per frame on average", statistics.total_pixels_composed(), average_pixels_composed);
+            outln("  Last frame:             {} pixels composed, {} pixels copied to the back buffer", statistics.last_frame_pixels_composed(), statistics.last_frame_pixels_copied());
+        }
+    }
     return 0;
 }
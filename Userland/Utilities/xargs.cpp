@@ -11,6 +11,7 @@
 #include <LibCore/System.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -201,25 +202,25 @@ bool run_command(Vector<char*>&& child_argv, bool verbose, bool is_stdin, int de
         warnln("xargs: {}", builder.to_string());
     }
 
-    auto pid = fork();
-    if (pid < 0) {
-        perror("fork");
-        return false;
-    }
-
-    if (pid == 0) {
-        if (is_stdin)
-            dup2(devnull_fd, STDIN_FILENO);
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    if (is_stdin)
+        posix_spawn_file_actions_adddup2(&file_actions, devnull_fd, STDIN_FILENO);
 
-        execvp(child_argv[0], child_argv.data());
-        exit(1);
-    }
+    pid_t pid;
+    int rc = posix_spawnp(&pid, child_argv[0], &file_actions, nullptr, child_argv.data(), environ);
+    posix_spawn_file_actions_destroy(&file_actions);
+    if (rc != 0)
+        warnln("xargs: {}: {}", child_argv[0], strerror(rc));
 
     for (auto* ptr : child_argv)
         free(ptr);
 
     child_argv.clear_with_capacity();
 
+    if (rc != 0)
+        return false;
+
     int wstatus = 0;
     if (waitpid(pid, &wstatus, 0) < 0) {
         perror("waitpid");
@@ -10,6 +10,7 @@
 #include <AK/URLParser.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
 #include <LibMain/Main.h>
 #include <LibXML/DOM/Document.h>
 #include <LibXML/DOM/Node.h>
@@ -505,8 +506,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     parser.parse(arguments);
 
     s_path = Core::File::real_path_for(filename);
-    auto file = TRY(Core::File::open(s_path, Core::OpenMode::ReadOnly));
-    auto contents = file->read_all();
+    // The parser works on the mapped file directly, so large documents are not copied into memory first.
+    auto file = TRY(Core::MappedFile::map(s_path));
+    StringView contents { file->bytes() };
 
     auto xml_parser = parse(contents);
     auto result = xml_parser.parse();